@@ -3,7 +3,6 @@
 
 #include "precomp.h"
 #include "MidiAudio.hpp"
-#include "../terminal/parser/stateMachine.hpp"
 
 #include <dsound.h>
 
@@ -11,7 +10,6 @@
 #pragma comment(lib, "dsound.lib")
 
 using Microsoft::WRL::ComPtr;
-using namespace std::chrono_literals;
 
 // The WAVE_DATA below is an 8-bit PCM encoding of a triangle wave form.
 // We just play this on repeat at varying frequencies to produce our notes.
@@ -31,81 +29,157 @@ MidiAudio::MidiAudio(HWND windowHandle)
 
 MidiAudio::~MidiAudio() noexcept
 {
-    try
+    Shutdown();
+    if (_thread.joinable())
     {
-#pragma warning(suppress : 26447)
-        // We acquire the lock here so the class isn't destroyed while in use.
-        // If this throws, we'll catch it, so the C26447 warning is bogus.
-        const auto lock = std::unique_lock{ _inUseMutex };
+        _thread.join();
     }
-    catch (...)
+}
+
+void MidiAudio::Initialize()
+{
+    _queueEvent.create(wil::EventOptions::None);
+    _shutdownEvent.create(wil::EventOptions::ManualReset);
+
+    // High resolution timers are only supported since Windows 10 1803. Without them we're limited to the
+    // system timer resolution (usually 15.6ms), which is still better than nothing for the note durations.
+    _timer.reset(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS));
+    if (!_timer)
     {
-        // If the lock fails, we'll just have to live with the consequences.
+        _timer.reset(CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS));
+        THROW_LAST_ERROR_IF(!_timer);
     }
+
+    _thread = std::thread{ [this]() noexcept { _audioThread(); } };
 }
 
-void MidiAudio::Initialize()
+void MidiAudio::Shutdown() noexcept
 {
-    _shutdownFuture = _shutdownPromise.get_future();
+    // Any queued notes are discarded and a note that is
+    // currently playing will be stopped immediately.
+    {
+        const auto lock = std::scoped_lock{ _queueMutex };
+        _shutdown = true;
+        _queue.clear();
+        _queuedDuration = {};
+    }
+    if (_shutdownEvent)
+    {
+        _shutdownEvent.SetEvent();
+    }
 }
 
-void MidiAudio::Shutdown()
+void MidiAudio::PlayNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration) noexcept
+try
 {
-    // Once the shutdown promise is set, any note that is playing will stop
-    // immediately, and the Unlock call will exit the thread ASAP.
-    _shutdownPromise.set_value();
+    {
+        const auto lock = std::scoped_lock{ _queueMutex };
+        if (_shutdown || _queuedDuration + duration > _maxQueuedDuration)
+        {
+            return;
+        }
+        _queue.emplace_back(Note{ noteNumber, velocity, duration });
+        _queuedDuration += duration;
+    }
+    _queueEvent.SetEvent();
 }
+CATCH_LOG()
 
-void MidiAudio::Lock()
+void MidiAudio::_audioThread() noexcept
 {
-    _inUseMutex.lock();
+    LOG_IF_FAILED(SetThreadDescription(GetCurrentThread(), L"MIDI Audio Thread"));
+    // Notes need to start on time even if the rest of the process is busy.
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+    auto deadline = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        Note note{};
+        {
+            auto lock = std::unique_lock{ _queueMutex };
+            if (_shutdown)
+            {
+                return;
+            }
+            if (_queue.empty())
+            {
+                lock.unlock();
+                const std::array handles{ _shutdownEvent.get(), _queueEvent.get() };
+                WaitForMultipleObjects(gsl::narrow_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+                continue;
+            }
+            note = _queue.front();
+            _queue.pop_front();
+            _queuedDuration -= note.duration;
+        }
+
+        // Consecutive notes are timed relative to the end of the previous one, instead of the time the
+        // previous wait finished, so that the wake-up latency doesn't accumulate over a long sequence.
+        // If we fell behind (or the queue was empty) the next note simply starts right away.
+        deadline = std::max(deadline, std::chrono::steady_clock::now()) + note.duration;
+
+        _startNote(note);
+        const auto completed = _waitUntil(deadline);
+        _stopNote(note);
+
+        if (!completed)
+        {
+            return;
+        }
+    }
 }
 
-void MidiAudio::Unlock()
+// Routine Description:
+// - Waits until the given time, or until we're shut down.
+// Return Value:
+// - false if we've been shut down in the meantime.
+bool MidiAudio::_waitUntil(const std::chrono::steady_clock::time_point deadline) noexcept
 {
-    // We need to check the shutdown status before releasing the mutex,
-    // because after that the class could be destroyed.
-    const auto shutdownStatus = _shutdownFuture.wait_for(0s);
-    _inUseMutex.unlock();
-    // If the wait didn't timeout, that means the shutdown promise was set,
-    // so we need to exit the thread ASAP by throwing an exception.
-    if (shutdownStatus != std::future_status::timeout)
+    const auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining > std::chrono::steady_clock::duration::zero())
     {
-        throw Microsoft::Console::VirtualTerminal::StateMachine::ShutdownException{};
+        // A negative due time is relative and in 100ns units.
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(remaining).count());
+        if (SetWaitableTimer(_timer.get(), &dueTime, 0, nullptr, nullptr, FALSE))
+        {
+            const std::array handles{ _shutdownEvent.get(), _timer.get() };
+            return WaitForMultipleObjects(gsl::narrow_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE) != WAIT_OBJECT_0;
+        }
     }
+    return WaitForSingleObject(_shutdownEvent.get(), 0) != WAIT_OBJECT_0;
 }
 
-void MidiAudio::PlayNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration) noexcept
-try
+void MidiAudio::_startNote(const Note& note) noexcept
 {
-    const auto& buffer = _buffers.at(_activeBufferIndex);
-    if (velocity && buffer)
+    const auto& buffer = til::at(_buffers, _activeBufferIndex);
+    if (note.velocity && buffer)
     {
         // The formula for frequency is 2^(n/12) * 440Hz, where n is zero for
         // the A above middle C (A4). In MIDI terms, A4 is note number 69,
         // which is why we subtract 69. We also need to multiply by the size
         // of the wave form to determine the frequency that the sound buffer
         // has to be played to achieve the equivalent note frequency.
-        const auto frequency = std::pow(2.0, (noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
+        const auto frequency = std::pow(2.0, (note.noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
         buffer->SetFrequency(gsl::narrow_cast<DWORD>(frequency));
         // For the volume, we're using the formula defined in the General
         // MIDI Level 2 specification: Gain in dB = 40 * log10(v/127). We need
         // to multiply by 4000, though, because the SetVolume method expects
         // the volume to be in hundredths of a decibel.
-        const auto volume = 4000.0 * std::log10(velocity / 127.0);
+        const auto volume = 4000.0 * std::log10(note.velocity / 127.0);
         buffer->SetVolume(gsl::narrow_cast<LONG>(volume));
         // Resetting the buffer to a position that is slightly off from the
         // last position will help to produce a clearer separation between
         // tones when repeating sequences of the same note.
         buffer->SetCurrentPosition((_lastBufferPosition + 12) % WAVE_SIZE);
     }
+}
 
-    // By waiting on the shutdown future with the duration of the note, we'll
-    // either be paused for the appropriate amount of time, or we'll break out
-    // of the wait early if we've been shutdown.
-    _shutdownFuture.wait_for(duration);
-
-    if (velocity && buffer)
+void MidiAudio::_stopNote(const Note& note) noexcept
+{
+    const auto& buffer = til::at(_buffers, _activeBufferIndex);
+    if (note.velocity && buffer)
     {
         // When the note ends, we just turn the volume down instead of stopping
         // the sound buffer. This helps reduce unwanted static between notes.
@@ -116,7 +190,6 @@ try
     // Cycling between multiple buffers can also help reduce the static.
     _activeBufferIndex = (_activeBufferIndex + 1) % _buffers.size();
 }
-CATCH_LOG()
 
 void MidiAudio::_createBuffers() noexcept
 {
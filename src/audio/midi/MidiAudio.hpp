@@ -6,14 +6,16 @@ Module Name:
 - MidiAudio.hpp
 
 Abstract:
-  This modules provide basic MIDI support with blocking sound output.
+  This modules provide basic MIDI support with asynchronous sound output.
+  Notes are queued by PlayNote() and played back to back on a dedicated thread.
   */
 
 #pragma once
 
 #include <array>
-#include <future>
+#include <deque>
 #include <mutex>
+#include <thread>
 
 struct IDirectSound8;
 struct IDirectSoundBuffer;
@@ -28,19 +30,38 @@ public:
     MidiAudio& operator=(MidiAudio&&) = delete;
     ~MidiAudio() noexcept;
     void Initialize();
-    void Shutdown();
-    void Lock();
-    void Unlock();
+    void Shutdown() noexcept;
     void PlayNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration) noexcept;
 
 private:
+    struct Note
+    {
+        int noteNumber;
+        int velocity;
+        std::chrono::microseconds duration;
+    };
+
+    // Notes beyond this much queued playback time are dropped,
+    // so that an endless stream of DECPS can't exhaust our memory.
+    static constexpr std::chrono::microseconds _maxQueuedDuration = std::chrono::minutes{ 1 };
+
     void _createBuffers() noexcept;
+    void _audioThread() noexcept;
+    bool _waitUntil(const std::chrono::steady_clock::time_point deadline) noexcept;
+    void _startNote(const Note& note) noexcept;
+    void _stopNote(const Note& note) noexcept;
 
     Microsoft::WRL::ComPtr<IDirectSound8> _directSound;
     std::array<Microsoft::WRL::ComPtr<IDirectSoundBuffer>, 2> _buffers;
     size_t _activeBufferIndex = 0;
     DWORD _lastBufferPosition = 0;
-    std::promise<void> _shutdownPromise;
-    std::future<void> _shutdownFuture;
-    std::mutex _inUseMutex;
+
+    std::mutex _queueMutex;
+    std::deque<Note> _queue;
+    std::chrono::microseconds _queuedDuration{};
+    bool _shutdown = false;
+    wil::unique_event _queueEvent;
+    wil::unique_event _shutdownEvent;
+    wil::unique_handle _timer;
+    std::thread _thread;
 };
@@ -9,10 +9,96 @@
 // Arguments:
 // - cchRowWidth - the length of the default text attribute
 // - attr - the default text attribute
+// - table - the attribute table of the buffer the row belongs to
 // Return Value:
 // - constructed object
-ATTR_ROW::ATTR_ROW(const til::CoordType width, const TextAttribute attr) :
-    _data(gsl::narrow_cast<uint16_t>(width), attr) {}
+ATTR_ROW::ATTR_ROW(const til::CoordType width, const TextAttribute attr, TextAttributeTable& table) :
+    _data(gsl::narrow_cast<uint16_t>(width), table.Intern(attr)),
+    _table{ &table }
+{
+    if (attr.IsHyperlink())
+    {
+        _UpdateHyperlinks();
+    }
+}
+
+ATTR_ROW::~ATTR_ROW()
+{
+    _ReleaseHyperlinks();
+}
+
+ATTR_ROW::ATTR_ROW(const ATTR_ROW& other) :
+    _data{ other._data },
+    _table{ other._table },
+    _hyperlinks{ other._hyperlinks }
+{
+    for (const auto id : _hyperlinks)
+    {
+        _table->AddHyperlinkReference(id);
+    }
+}
+
+// Routine Description:
+// - Takes over the attributes of another row, along with its hyperlink references.
+//   The other row is left without any and has to be assigned to before it's used again.
+ATTR_ROW::ATTR_ROW(ATTR_ROW&& other) noexcept :
+    _data{ std::move(other._data) },
+    _table{ other._table },
+    _hyperlinks{ std::move(other._hyperlinks) }
+{
+    other._hyperlinks.clear();
+}
+
+// Routine Description:
+// - Copies the attributes of another row. The row keeps using its own table,
+//   so if the other row belongs to another buffer, its attributes are interned into it.
+ATTR_ROW& ATTR_ROW::operator=(const ATTR_ROW& other)
+{
+    _AssignFrom(other);
+    return *this;
+}
+
+ATTR_ROW& ATTR_ROW::operator=(ATTR_ROW&& other)
+{
+    if (_table != other._table)
+    {
+        _AssignFrom(other);
+    }
+    else if (const auto& runs = other._data.runs(); runs.size() == 1)
+    {
+        _SetUniform(runs.front().length, runs.front().value);
+    }
+    else if (this != &other)
+    {
+        _ReleaseHyperlinks();
+        _data = std::move(other._data);
+        _hyperlinks = std::move(other._hyperlinks);
+        other._hyperlinks.clear();
+    }
+    return *this;
+}
+
+void ATTR_ROW::_AssignFrom(const ATTR_ROW& other)
+{
+    if (const auto& runs = other._data.runs(); runs.size() == 1)
+    {
+        const auto index = _table == other._table ? runs.front().value : _table->Intern(other._table->Get(runs.front().value));
+        _SetUniform(runs.front().length, index);
+        return;
+    }
+
+    _data = other._data;
+    if (_table != other._table)
+    {
+        _data.transform_values([&](const TextAttributeTable::Index index) {
+            return _table->Intern(other._table->Get(index));
+        });
+    }
+    if (!_hyperlinks.empty() || !other._hyperlinks.empty())
+    {
+        _UpdateHyperlinks();
+    }
+}
 
 // Routine Description:
 // - Sets all properties of the ATTR_ROW to default values
@@ -20,7 +106,79 @@ ATTR_ROW::ATTR_ROW(const til::CoordType width, const TextAttribute attr) :
 // - attr - The default text attributes to use on text in this row.
 void ATTR_ROW::Reset(const TextAttribute attr)
 {
-    _data.replace(0, _data.size(), attr);
+    _SetUniform(_data.size(), _table->Intern(attr));
+}
+
+// Routine Description:
+// - Checks whether the entire row has the given attribute.
+bool ATTR_ROW::_IsUniform(const TextAttributeTable::Index index) const noexcept
+{
+    const auto& runs = _data.runs();
+    return runs.size() == 1 && runs.front().value == index;
+}
+
+// Routine Description:
+// - Sets the entire row to a single run of the given attribute.
+// - Almost all rows consist of a single run, which fits into the inline storage of the rle_vector.
+//   But once a row had more runs, the small_vector holding them keeps its heap storage when it's
+//   assigned fewer runs, and it even allocates for a single run after its storage was moved into
+//   another row (as when scrolling). Rebuilding the rle_vector lets the row use its inline storage again.
+// Arguments:
+// - length - the width of the row
+// - index - the attribute of the row, as an index into the attribute table
+void ATTR_ROW::_SetUniform(const uint16_t length, const TextAttributeTable::Index index)
+{
+    // Moving from a vector that uses its inline storage copies the runs, which can't allocate here.
+    rle_vector uniform{ length, index };
+    std::destroy_at(&_data);
+    std::construct_at(&_data, std::move(uniform));
+
+    if (!_hyperlinks.empty() || _IsHyperlink(index))
+    {
+        _UpdateHyperlinks();
+    }
+}
+
+bool ATTR_ROW::_IsHyperlink(const TextAttributeTable::Index index) const noexcept
+{
+    return _table->Get(index).IsHyperlink();
+}
+
+// Routine Description:
+// - Updates _hyperlinks after _data changed, and the references to them in the table.
+//   Few rows contain hyperlinks, so the callers skip this unless the row had some or gained one.
+void ATTR_ROW::_UpdateHyperlinks()
+{
+    decltype(_hyperlinks) hyperlinks;
+    for (const auto& run : _data.runs())
+    {
+        const auto& attr = _table->Get(run.value);
+        if (attr.IsHyperlink())
+        {
+            hyperlinks.emplace_back(attr.GetHyperlinkId());
+        }
+    }
+    std::sort(hyperlinks.begin(), hyperlinks.end());
+    hyperlinks.erase(std::unique(hyperlinks.begin(), hyperlinks.end()), hyperlinks.end());
+
+    // The new references are added before the old ones are released, so that the hyperlinks that
+    // stay in the row never drop to 0 references. If this throws, some hyperlinks are counted
+    // too often, which only keeps them in the buffer's hyperlink map for longer.
+    for (const auto id : hyperlinks)
+    {
+        _table->AddHyperlinkReference(id);
+    }
+    _ReleaseHyperlinks();
+    _hyperlinks = std::move(hyperlinks);
+}
+
+void ATTR_ROW::_ReleaseHyperlinks() noexcept
+{
+    for (const auto id : _hyperlinks)
+    {
+        _table->ReleaseHyperlinkReference(id);
+    }
+    _hyperlinks.clear();
 }
 
 // Routine Description:
@@ -35,6 +193,10 @@ void ATTR_ROW::Reset(const TextAttribute attr)
 void ATTR_ROW::Resize(const til::CoordType newWidth)
 {
     _data.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
+    if (!_hyperlinks.empty())
+    {
+        _UpdateHyperlinks();
+    }
 }
 
 // Routine Description:
@@ -47,24 +209,16 @@ void ATTR_ROW::Resize(const til::CoordType newWidth)
 // - will throw on error
 TextAttribute ATTR_ROW::GetAttrByColumn(const til::CoordType column) const
 {
-    return _data.at(gsl::narrow<uint16_t>(column));
+    return _table->Get(_data.at(gsl::narrow<uint16_t>(column)));
 }
 
 // Routine Description:
-// - Finds the hyperlink IDs present in this row and returns them
+// - Returns the hyperlink IDs present in this row
 // Return value:
-// - The hyperlink IDs present in this row
-std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
+// - The hyperlink IDs present in this row, sorted and without duplicates
+gsl::span<const uint16_t> ATTR_ROW::GetHyperlinks() const noexcept
 {
-    std::vector<uint16_t> ids;
-    for (const auto& run : _data.runs())
-    {
-        if (run.value.IsHyperlink())
-        {
-            ids.emplace_back(run.value.GetHyperlinkId());
-        }
-    }
-    return ids;
+    return { _hyperlinks.data(), _hyperlinks.size() };
 }
 
 // Routine Description:
@@ -76,7 +230,15 @@ std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
 // - <none>
 bool ATTR_ROW::SetAttrToEnd(const til::CoordType beginIndex, const TextAttribute attr)
 {
-    _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), attr);
+    const auto index = _table->Intern(attr);
+    if (!_IsUniform(index))
+    {
+        _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), index);
+        if (!_hyperlinks.empty() || _IsHyperlink(index))
+        {
+            _UpdateHyperlinks();
+        }
+    }
     return true;
 }
 
@@ -90,7 +252,27 @@ bool ATTR_ROW::SetAttrToEnd(const til::CoordType beginIndex, const TextAttribute
 // - <none>
 void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith)
 {
-    _data.replace_values(toBeReplacedAttr, replaceWith);
+    // An attribute that isn't in the table can't be in the row either.
+    if (const auto index = _table->Find(toBeReplacedAttr))
+    {
+        const auto replacement = _table->Intern(replaceWith);
+        _data.replace_values(*index, replacement);
+        if (!_hyperlinks.empty() || _IsHyperlink(replacement))
+        {
+            _UpdateHyperlinks();
+        }
+    }
+}
+
+// Routine Description:
+// - Replaces the indices into the attribute table after the table has been compacted.
+// Arguments:
+// - remap - the new index of each index into the table, as returned by TextAttributeTable::Compact
+void ATTR_ROW::RemapAttributes(const std::vector<TextAttributeTable::Index>& remap)
+{
+    _data.transform_values([&](const TextAttributeTable::Index index) {
+        return til::at(remap, index);
+    });
 }
 
 // Routine Description:
@@ -105,30 +287,59 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
 // - <none>
 void ATTR_ROW::Replace(const til::CoordType beginIndex, const til::CoordType endIndex, const TextAttribute& newAttr)
 {
-    _data.replace(gsl::narrow<uint16_t>(beginIndex), gsl::narrow<uint16_t>(endIndex), newAttr);
+    const auto index = _table->Intern(newAttr);
+    if (!_IsUniform(index))
+    {
+        _data.replace(gsl::narrow<uint16_t>(beginIndex), gsl::narrow<uint16_t>(endIndex), index);
+        if (!_hyperlinks.empty() || _IsHyperlink(index))
+        {
+            _UpdateHyperlinks();
+        }
+    }
+}
+
+// Routine Description:
+// - Replaces the range [beginIndex, endIndex) with the given runs in a single step,
+//   instead of moving all the runs behind the range once for every one of them.
+// Arguments:
+// - beginIndex, endIndex: The [beginIndex, endIndex) range that's to be replaced.
+// - runs: The new runs, with values returned by Intern(). Their lengths must add up to the size of the range.
+// Return Value:
+// - <none>
+void ATTR_ROW::ReplaceRuns(const til::CoordType beginIndex, const til::CoordType endIndex, const gsl::span<const run_type> runs)
+{
+    _data.replace(gsl::narrow<uint16_t>(beginIndex), gsl::narrow<uint16_t>(endIndex), runs);
+    if (!_hyperlinks.empty() || std::any_of(runs.begin(), runs.end(), [&](const run_type& run) { return _IsHyperlink(run.value); }))
+    {
+        _UpdateHyperlinks();
+    }
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::begin() const noexcept
 {
-    return _data.begin();
+    return { _data.begin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::end() const noexcept
 {
-    return _data.end();
+    return { _data.end(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cbegin() const noexcept
 {
-    return _data.cbegin();
+    return { _data.cbegin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cend() const noexcept
 {
-    return _data.cend();
+    return { _data.cend(), _table };
 }
 
 bool operator==(const ATTR_ROW& a, const ATTR_ROW& b) noexcept
 {
-    return a._data == b._data;
+    if (a._table == b._table)
+    {
+        return a._data == b._data;
+    }
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
 }
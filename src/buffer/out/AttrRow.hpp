@@ -22,31 +22,96 @@ Revision History:
 
 #include "til/rle.h"
 #include "TextAttribute.hpp"
+#include "TextAttributeTable.hpp"
 
 class ATTR_ROW final
 {
-    using rle_vector = til::small_rle<TextAttribute, uint16_t, 1>;
+    using rle_vector = til::small_rle<TextAttributeTable::Index, uint16_t, 1>;
 
 public:
-    using const_iterator = rle_vector::const_iterator;
-
-    ATTR_ROW(til::CoordType width, TextAttribute attr);
-
-    ~ATTR_ROW() = default;
-
-    ATTR_ROW(const ATTR_ROW&) = default;
-    ATTR_ROW& operator=(const ATTR_ROW&) = default;
-    ATTR_ROW(ATTR_ROW&&)
-    noexcept = default;
-    ATTR_ROW& operator=(ATTR_ROW&&) noexcept = default;
+    // Iterates over the attributes of the row's columns.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = TextAttribute;
+        using pointer = const TextAttribute*;
+        using reference = const TextAttribute&;
+        using difference_type = rle_vector::const_iterator::difference_type;
+
+        const_iterator(rle_vector::const_iterator it, const TextAttributeTable* table) noexcept :
+            _it{ it },
+            _table{ table }
+        {
+        }
+
+        reference operator*() const noexcept { return _table->Get(*_it); }
+        pointer operator->() const noexcept { return &operator*(); }
+
+        const_iterator& operator++() noexcept
+        {
+            ++_it;
+            return *this;
+        }
+
+        const_iterator& operator--() noexcept
+        {
+            --_it;
+            return *this;
+        }
+
+        const_iterator& operator+=(const difference_type offset) noexcept
+        {
+            _it += offset;
+            return *this;
+        }
+
+        const_iterator& operator-=(const difference_type offset) noexcept
+        {
+            _it -= offset;
+            return *this;
+        }
+
+        const_iterator operator+(const difference_type offset) const noexcept { return { _it + offset, _table }; }
+        const_iterator operator-(const difference_type offset) const noexcept { return { _it - offset, _table }; }
+        difference_type operator-(const const_iterator& other) const noexcept { return _it - other._it; }
+
+        bool operator==(const const_iterator& other) const noexcept { return _it == other._it; }
+        bool operator!=(const const_iterator& other) const noexcept { return _it != other._it; }
+
+    private:
+        rle_vector::const_iterator _it;
+        const TextAttributeTable* _table;
+    };
+
+    using run_type = rle_vector::rle_type;
+
+    ATTR_ROW(til::CoordType width, TextAttribute attr, TextAttributeTable& table);
+
+    ~ATTR_ROW();
+
+    ATTR_ROW(const ATTR_ROW& other);
+    ATTR_ROW& operator=(const ATTR_ROW& other);
+    ATTR_ROW(ATTR_ROW&& other) noexcept;
+    ATTR_ROW& operator=(ATTR_ROW&& other);
 
     TextAttribute GetAttrByColumn(til::CoordType column) const;
-    std::vector<uint16_t> GetHyperlinks() const;
+    gsl::span<const uint16_t> GetHyperlinks() const noexcept;
 
     bool SetAttrToEnd(til::CoordType beginIndex, TextAttribute attr);
     void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith);
     void Resize(til::CoordType newWidth);
     void Replace(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
+    void ReplaceRuns(til::CoordType beginIndex, til::CoordType endIndex, gsl::span<const run_type> runs);
+
+    // Calls func(attr, length) for each run of identical attributes in [beginIndex, endIndex).
+    template<typename F>
+    void ForEachRun(const til::CoordType beginIndex, const til::CoordType endIndex, F&& func) const
+    {
+        _data.for_each_run(gsl::narrow<uint16_t>(beginIndex), gsl::narrow<uint16_t>(endIndex), [&](const TextAttributeTable::Index index, const uint16_t length) {
+            func(_table->Get(index), length);
+        });
+    }
 
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
@@ -54,13 +119,30 @@ public:
     const_iterator cbegin() const noexcept;
     const_iterator cend() const noexcept;
 
+    // The runs of identical attributes, for callers that convert a whole run at once.
+    // Their values are indices, which Resolve() turns into attributes.
+    const auto& Runs() const noexcept { return _data.runs(); }
+    const TextAttribute& Resolve(const TextAttributeTable::Index index) const noexcept { return _table->Get(index); }
+    TextAttributeTable::Index Intern(const TextAttribute& attr) { return _table->Intern(attr); }
+
+    void RemapAttributes(const std::vector<TextAttributeTable::Index>& remap);
+
     friend bool operator==(const ATTR_ROW& a, const ATTR_ROW& b) noexcept;
     friend class ROW;
 
 private:
     void Reset(const TextAttribute attr);
+    void _AssignFrom(const ATTR_ROW& other);
+    bool _IsUniform(const TextAttributeTable::Index index) const noexcept;
+    void _SetUniform(const uint16_t length, const TextAttributeTable::Index index);
+    bool _IsHyperlink(const TextAttributeTable::Index index) const noexcept;
+    void _UpdateHyperlinks();
+    void _ReleaseHyperlinks() noexcept;
 
     rle_vector _data;
+    TextAttributeTable* _table; // non ownership pointer, shared by all rows of a buffer
+    // The sorted IDs of the hyperlinks in _data, each of which is counted once in _table.
+    boost::container::small_vector<uint16_t, 1> _hyperlinks;
 
 #ifdef UNIT_TESTING
     friend class CommonState;
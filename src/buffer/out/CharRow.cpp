@@ -5,22 +5,84 @@
 
 #include "CharRow.hpp"
 #include "unicode.hpp"
-#include "Row.hpp"
+
+// The offsets into _chars are stored as uint16_t to keep the per-column
+// overhead at 5 bytes in total. A row's text can thus be at most this long.
+static constexpr size_t MaxCharCount = std::numeric_limits<uint16_t>::max();
+
+// The frozen copy of a row (see CharRow::Freeze) starts with these fields.
+static constexpr size_t FrozenColumnCount = 0; // the number of stored columns
+static constexpr size_t FrozenTextLength = 1; // the number of stored code units
+static constexpr size_t FrozenHasLayout = 2; // whether _charOffsets and _dbcsAttrs are stored as well
+static constexpr size_t FrozenHeaderLength = 3;
+
+static_assert(sizeof(uint16_t) == sizeof(wchar_t));
+static_assert(std::is_trivially_copyable_v<DbcsAttribute>);
+
+// Frozen rows which don't consist of one code unit per column store
+// their _charOffsets and _dbcsAttrs after the text. This many wchar_t.
+static constexpr size_t FrozenLayoutLength(const size_t columns) noexcept
+{
+    return columns + 1 + (columns * sizeof(DbcsAttribute) + sizeof(wchar_t) - 1) / sizeof(wchar_t);
+}
+
+// Routine Description:
+// - calculates how many bytes of the TextBuffer slab a row of the given width occupies
+// Arguments:
+// - rowWidth - the size (in cells) of the row
+// Return Value:
+// - the size of the row's slice in bytes, aligned to keep the next slice's arrays aligned
+size_t CharRow::CalculateBufferStride(const til::CoordType rowWidth) noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(rowWidth);
+    const auto bytes = width * sizeof(wchar_t) + (width + 1) * sizeof(uint16_t) + width * sizeof(DbcsAttribute);
+    constexpr auto alignment = std::max(alignof(wchar_t), alignof(uint16_t));
+    return (bytes + alignment - 1) & ~(alignment - 1);
+}
 
 // Routine Description:
 // - constructor
 // Arguments:
+// - buffer - the row's slice of the TextBuffer slab, at least CalculateBufferStride(rowWidth) bytes large
 // - rowWidth - the size (in wchar_t) of the char and attribute rows
-// - pParent - the parent ROW
+// - frozen - if true, the row starts out frozen and blank and won't touch the slice until it's thawed
 // Return Value:
 // - instantiated object
-// Note: will through if unable to allocate char/attribute buffers
+CharRow::CharRow(std::byte* const buffer, til::CoordType rowWidth, const bool frozen) noexcept :
+    _charsBuffer{ nullptr },
+    _chars{ nullptr },
+    _charOffsets{ nullptr },
+    _dbcsAttrs{ nullptr },
+    _charsCapacity{ 0 },
+    _columnCount{ 0 },
+    _rightBound{ 0 },
+    _isFrozen{ frozen }
+{
+    _AssignBuffer(buffer, rowWidth);
+    if (!frozen)
+    {
+        Reset();
+    }
+}
+
+// Routine Description:
+// - points the arrays of this row at the given slice of the TextBuffer slab
+// Arguments:
+// - buffer - the row's slice of the TextBuffer slab
+// - rowWidth - the size (in cells) of the row
 #pragma warning(push)
-#pragma warning(disable : 26447) // small_vector's constructor says it can throw but it should not given how we use it.  This suppresses this error for the AuditMode build.
-CharRow::CharRow(til::CoordType rowWidth, ROW* const pParent) noexcept :
-    _data(rowWidth, value_type()),
-    _pParent{ FAIL_FAST_IF_NULL(pParent) }
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+void CharRow::_AssignBuffer(std::byte* const buffer, const til::CoordType rowWidth) noexcept
 {
+    const auto width = gsl::narrow_cast<size_t>(rowWidth);
+    _charsBuffer = reinterpret_cast<wchar_t*>(buffer);
+    _charOffsets = reinterpret_cast<uint16_t*>(buffer + width * sizeof(wchar_t));
+    _dbcsAttrs = reinterpret_cast<DbcsAttribute*>(buffer + width * sizeof(wchar_t) + (width + 1) * sizeof(uint16_t));
+    _chars = _charsBuffer;
+    _charsHeap.reset();
+    _charsCapacity = width;
+    _columnCount = rowWidth;
 }
 #pragma warning(pop)
 
@@ -32,7 +94,22 @@ CharRow::CharRow(til::CoordType rowWidth, ROW* const pParent) noexcept :
 // - the size of the row
 til::CoordType CharRow::size() const noexcept
 {
-    return gsl::narrow_cast<til::CoordType>(_data.size());
+    return _columnCount;
+}
+
+// Routine Description:
+// - checks whether the contents of this row have been moved out of its slice, see Freeze()
+// Arguments:
+// - <none>
+// Return Value:
+// - true if the row must be thawed before it's accessed
+bool CharRow::IsFrozen() const noexcept
+{
+    // The Terminal lets several readers access the buffer at once, which might race to thaw this row.
+    // TextBuffer::GetRowByOffset checks this without holding its lock, which is why it's an acquire
+    // load that pairs with the release store in Thaw(), once the contents have been restored.
+#pragma warning(suppress : 26492) // Don't use const_cast to cast away const or volatile (type.3).
+    return std::atomic_ref{ const_cast<bool&>(_isFrozen) }.load(std::memory_order_acquire);
 }
 
 // Routine Description:
@@ -41,51 +118,120 @@ til::CoordType CharRow::size() const noexcept
 // - sRowWidth - The width of the row.
 // Return Value:
 // - <none>
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
 void CharRow::Reset() noexcept
 {
-    for (auto& cell : _data)
+    // The slice of a frozen row might not be committed. Dropping its contents is all it takes.
+    if (_isFrozen)
     {
-        cell.Reset();
+        _frozen.reset();
+        _spillHandle.reset();
+        return;
     }
+
+    _ResetThawed();
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - Sets all properties of a row that isn't frozen to default values, see Reset()
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::_ResetThawed() noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(_columnCount);
+
+    // Resetting a row is the only point at which a row gives up its spill storage.
+    _charsHeap.reset();
+    _chars = _charsBuffer;
+    _charsCapacity = width;
+
+    std::fill_n(_chars, width, UNICODE_SPACE);
+    std::iota(_charOffsets, _charOffsets + width + 1, uint16_t{ 0 });
+    std::fill_n(_dbcsAttrs, width, DbcsAttribute{});
+    _rightBound = 0;
 }
+#pragma warning(pop)
 
 // Routine Description:
 // - resizes the width of the CharRowBase
 // Arguments:
+// - buffer - the row's new slice of the TextBuffer slab. The contents of the
+//   current slice are copied into it, so it must not overlap the current one.
 // - newSize - the new width of the character and attributes rows
 // Return Value:
 // - S_OK on success, otherwise relevant error code
-[[nodiscard]] HRESULT CharRow::Resize(const til::CoordType newSize) noexcept
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+[[nodiscard]] HRESULT CharRow::Resize(std::byte* const buffer, const til::CoordType newSize) noexcept
+try
 {
-    try
+    // Frozen rows only need to learn about their new slice. Thaw() truncates their contents if needed.
+    if (_isFrozen)
     {
-        const value_type insertVals;
-        _data.resize(newSize, insertVals);
+        _AssignBuffer(buffer, newSize);
+        return S_OK;
     }
-    CATCH_RETURN();
 
-    return S_OK;
-}
+    const auto oldWidth = gsl::narrow_cast<size_t>(_columnCount);
+    const auto newWidth = gsl::narrow_cast<size_t>(newSize);
+    const auto copiedColumns = std::min(oldWidth, newWidth);
+    const size_t copiedChars = til::at(_charOffsets, copiedColumns);
+    const auto charCount = copiedChars + (newWidth - copiedColumns);
 
-typename CharRow::iterator CharRow::begin() noexcept
-{
-    return _data.begin();
-}
+    const auto newOffsets = reinterpret_cast<uint16_t*>(buffer + newWidth * sizeof(wchar_t));
+    const auto newDbcsAttrs = reinterpret_cast<DbcsAttribute*>(buffer + newWidth * sizeof(wchar_t) + (newWidth + 1) * sizeof(uint16_t));
 
-typename CharRow::const_iterator CharRow::cbegin() const noexcept
-{
-    return _data.cbegin();
-}
+    // Allocate the spill storage (if any) first, so that we fail before touching anything.
+    std::unique_ptr<wchar_t[]> newHeap;
+    auto newChars = reinterpret_cast<wchar_t*>(buffer);
+    auto newCapacity = newWidth;
+    if (charCount > newWidth)
+    {
+        RETURN_HR_IF(E_OUTOFMEMORY, charCount > MaxCharCount);
+        newHeap = std::make_unique<wchar_t[]>(charCount);
+        newChars = newHeap.get();
+        newCapacity = charCount;
+    }
 
-typename CharRow::iterator CharRow::end() noexcept
-{
-    return _data.end();
+    std::copy_n(_chars, copiedChars, newChars);
+    std::fill_n(newChars + copiedChars, newWidth - copiedColumns, UNICODE_SPACE);
+    std::copy_n(_charOffsets, copiedColumns + 1, newOffsets);
+    std::iota(newOffsets + copiedColumns, newOffsets + newWidth + 1, gsl::narrow_cast<uint16_t>(copiedChars));
+    std::copy_n(_dbcsAttrs, copiedColumns, newDbcsAttrs);
+    std::fill_n(newDbcsAttrs + copiedColumns, newWidth - copiedColumns, DbcsAttribute{});
+
+    _charsBuffer = reinterpret_cast<wchar_t*>(buffer);
+    _chars = newChars;
+    _charOffsets = newOffsets;
+    _dbcsAttrs = newDbcsAttrs;
+    _charsHeap = std::move(newHeap);
+    _charsCapacity = newCapacity;
+    _columnCount = newSize;
+    _rightBound = std::min(_rightBound, newSize);
+
+    return S_OK;
 }
+CATCH_RETURN();
+#pragma warning(pop)
 
-typename CharRow::const_iterator CharRow::cend() const noexcept
+// Routine Description:
+// - checks if the given column contains a single space glyph
+// Arguments:
+// - column - the column to check
+// Return Value:
+// - true if the column contains a space, false otherwise
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+bool CharRow::_IsSpaceAt(const til::CoordType column) const noexcept
 {
-    return _data.cend();
+    const auto beg = _charOffsets[column];
+    const auto end = _charOffsets[column + 1];
+    return end - beg == 1 && _chars[beg] == UNICODE_SPACE;
 }
+#pragma warning(pop)
 
 // Routine Description:
 // - Inspects the current internal string to find the left edge of it
@@ -95,12 +241,12 @@ typename CharRow::const_iterator CharRow::cend() const noexcept
 // - The calculated left boundary of the internal string.
 til::CoordType CharRow::MeasureLeft() const noexcept
 {
-    auto it = _data.cbegin();
-    while (it != _data.cend() && it->IsSpace())
+    til::CoordType column = 0;
+    while (column < _rightBound && _IsSpaceAt(column))
     {
-        ++it;
+        ++column;
     }
-    return gsl::narrow_cast<til::CoordType>(it - _data.cbegin());
+    return column == _rightBound ? _columnCount : column;
 }
 
 // Routine Description:
@@ -109,19 +255,21 @@ til::CoordType CharRow::MeasureLeft() const noexcept
 // - <none>
 // Return Value:
 // - The calculated right boundary of the internal string.
-til::CoordType CharRow::MeasureRight() const
+til::CoordType CharRow::MeasureRight() const noexcept
 {
-    auto it = _data.crbegin();
-    while (it != _data.crend() && it->IsSpace())
+    auto column = _rightBound;
+    while (column > 0 && _IsSpaceAt(column - 1))
     {
-        ++it;
+        --column;
     }
-    return gsl::narrow_cast<til::CoordType>(_data.crend() - it);
+    return column;
 }
 
 void CharRow::ClearCell(const til::CoordType column)
 {
-    _data.at(column).Reset();
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
+    ClearGlyph(column);
+    til::at(_dbcsAttrs, column).Reset();
 }
 
 // Routine Description:
@@ -132,14 +280,7 @@ void CharRow::ClearCell(const til::CoordType column)
 // - True if there is valid text in this row. False otherwise.
 bool CharRow::ContainsText() const noexcept
 {
-    for (const auto& cell : _data)
-    {
-        if (!cell.IsSpace())
-        {
-            return true;
-        }
-    }
-    return false;
+    return _rightBound != 0 && MeasureRight() != 0;
 }
 
 // Routine Description:
@@ -151,7 +292,8 @@ bool CharRow::ContainsText() const noexcept
 // Note: will throw exception if column is out of bounds
 const DbcsAttribute& CharRow::DbcsAttrAt(const til::CoordType column) const
 {
-    return _data.at(column).DbcsAttr();
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
+    return til::at(_dbcsAttrs, column);
 }
 
 // Routine Description:
@@ -163,7 +305,8 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const til::CoordType column) const
 // Note: will throw exception if column is out of bounds
 DbcsAttribute& CharRow::DbcsAttrAt(const til::CoordType column)
 {
-    return _data.at(column).DbcsAttr();
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
+    return til::at(_dbcsAttrs, column);
 }
 
 // Routine Description:
@@ -175,7 +318,9 @@ DbcsAttribute& CharRow::DbcsAttrAt(const til::CoordType column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const til::CoordType column)
 {
-    _data.at(column).EraseChars();
+    static constexpr wchar_t space = UNICODE_SPACE;
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
+    _SetGlyph(column, { &space, 1 });
 }
 
 // Routine Description:
@@ -187,7 +332,7 @@ void CharRow::ClearGlyph(const til::CoordType column)
 // - Note: will throw exception if column is out of bounds
 const CharRow::reference CharRow::GlyphAt(const til::CoordType column) const
 {
-    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= gsl::narrow_cast<til::CoordType>(_data.size()));
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
     return { const_cast<CharRow&>(*this), column };
 }
 
@@ -200,24 +345,275 @@ const CharRow::reference CharRow::GlyphAt(const til::CoordType column) const
 // - Note: will throw exception if column is out of bounds
 CharRow::reference CharRow::GlyphAt(const til::CoordType column)
 {
-    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= gsl::narrow_cast<til::CoordType>(_data.size()));
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
     return { *this, column };
 }
 
+// Routine Description:
+// - returns text data at column as a view into the row's text.
+// - The view is invalidated by the next write to this row.
+// Arguments:
+// - column - column to get text data for
+// Return Value:
+// - text data at column
+// - Note: will throw exception if column is out of bounds
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+std::wstring_view CharRow::GlyphViewAt(const til::CoordType column) const
+{
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= _columnCount);
+    const size_t beg = _charOffsets[column];
+    const size_t end = _charOffsets[column + 1];
+    return { _chars + beg, end - beg };
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - returns the text of all columns back to back as a view into the row's text.
+//   Trailing halves of wide glyphs repeat their leading half, just like GlyphViewAt() does.
+// - The view is invalidated by the next write to this row.
+// Return Value:
+// - text data of the entire row
+std::wstring_view CharRow::GetChars() const noexcept
+{
+    return { _chars, til::at(_charOffsets, _columnCount) };
+}
+
+// Routine Description:
+// - returns the offset of the first code unit of a column in the text returned by GetChars()
+// Arguments:
+// - column - column to get the offset for. size() returns the length of the entire text.
+// Return Value:
+// - the offset
+// - Note: will throw exception if column is out of bounds
+size_t CharRow::GetCharOffset(const til::CoordType column) const
+{
+    THROW_HR_IF(E_INVALIDARG, column < 0 || column > _columnCount);
+    return til::at(_charOffsets, column);
+}
+
+// Routine Description:
+// - returns the column that the given code unit of the text returned by GetChars() belongs to
+// Arguments:
+// - offset - offset of the code unit. Must be less than the length of the text.
+// Return Value:
+// - the column
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+til::CoordType CharRow::GetColumnAtCharOffset(const size_t offset) const noexcept
+{
+    // The offsets are sorted, so the column is the last one starting at or before the offset.
+    const auto it = std::upper_bound(_charOffsets, _charOffsets + _columnCount, offset);
+    return gsl::narrow_cast<til::CoordType>(it - _charOffsets - 1);
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - replaces the glyph of a column, moving the text of the following columns
+//   around and spilling into _charsHeap if the glyph doesn't fit.
+// Arguments:
+// - column - column to write the glyph to
+// - chars - the glyph, containing at least 1 code unit
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::_SetGlyph(const til::CoordType column, const std::wstring_view chars)
+{
+    const size_t beg = _charOffsets[column];
+    const size_t end = _charOffsets[column + 1];
+    const auto oldLength = end - beg;
+    const auto newLength = chars.size();
+
+    if (newLength != 1 || chars.front() != UNICODE_SPACE)
+    {
+        _rightBound = std::max(_rightBound, column + 1);
+    }
+    else if (column + 1 == _rightBound)
+    {
+        _rightBound = column;
+    }
+
+    // Hot path: most glyphs replace a glyph of the same length (usually 1 code unit).
+    if (newLength == oldLength)
+    {
+        std::copy_n(chars.data(), newLength, _chars + beg);
+        return;
+    }
+
+    const size_t total = _charOffsets[_columnCount];
+    const auto newTotal = total - oldLength + newLength;
+    THROW_HR_IF(E_OUTOFMEMORY, newTotal > MaxCharCount);
+
+    if (newTotal > _charsCapacity)
+    {
+        // Grow geometrically so that a row full of emoji doesn't reallocate on every column.
+        _ReserveChars(std::min(MaxCharCount, std::max(newTotal, _charsCapacity + _charsCapacity / 2)));
+    }
+
+    // Move the text of the following columns and fix up their offsets.
+    if (newLength > oldLength)
+    {
+        std::copy_backward(_chars + end, _chars + total, _chars + newTotal);
+    }
+    else
+    {
+        std::copy(_chars + end, _chars + total, _chars + beg + newLength);
+    }
+    std::copy_n(chars.data(), newLength, _chars + beg);
+
+    const auto delta = gsl::narrow_cast<uint16_t>(newLength - oldLength);
+    for (auto it = _charOffsets + column + 1, last = _charOffsets + _columnCount + 1; it != last; ++it)
+    {
+        // unsigned wraparound takes care of shrinking glyphs
+        *it = gsl::narrow_cast<uint16_t>(*it + delta);
+    }
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - replaces the glyphs of a range of columns with a single narrow character.
+//   Since every column holds at least one code unit, the text can only shrink,
+//   so this never has to allocate.
+// Arguments:
+// - beginColumn - the first column to fill
+// - endColumn - the column after the last one to fill
+// - wch - the character, which must not be a surrogate or full width
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::_FillGlyphs(const til::CoordType beginColumn, const til::CoordType endColumn, const wchar_t wch) noexcept
+{
+    const size_t beg = _charOffsets[beginColumn];
+    const size_t end = _charOffsets[endColumn];
+    const auto count = gsl::narrow_cast<size_t>(endColumn - beginColumn);
+
+    // Hot path: the range only holds glyphs that are 1 code unit long.
+    if (end - beg != count)
+    {
+        const size_t total = _charOffsets[_columnCount];
+        std::copy(_chars + end, _chars + total, _chars + beg + count);
+
+        const auto delta = gsl::narrow_cast<uint16_t>(end - beg - count);
+        for (auto it = _charOffsets + endColumn, last = _charOffsets + _columnCount + 1; it != last; ++it)
+        {
+            *it = gsl::narrow_cast<uint16_t>(*it - delta);
+        }
+        std::iota(_charOffsets + beginColumn, _charOffsets + endColumn, gsl::narrow_cast<uint16_t>(beg));
+    }
+
+    std::fill_n(_chars + beg, count, wch);
+    std::fill_n(_dbcsAttrs + beginColumn, count, DbcsAttribute{});
+
+    if (wch != UNICODE_SPACE)
+    {
+        _rightBound = std::max(_rightBound, endColumn);
+    }
+    else if (endColumn >= _rightBound)
+    {
+        _rightBound = std::min(_rightBound, beginColumn);
+    }
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - copies the glyphs of a range of columns to another, possibly overlapping,
+//   range of the same row. The columns that are only part of the source are left as is.
+// Arguments:
+// - beginColumn - the first column to copy
+// - endColumn - the column after the last one to copy
+// - targetColumn - the column the glyph of beginColumn is copied to
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::_MoveGlyphs(const til::CoordType beginColumn, const til::CoordType endColumn, const til::CoordType targetColumn)
+{
+    const auto count = gsl::narrow_cast<size_t>(endColumn - beginColumn);
+    // The copy of the source columns up to _rightBound might hold text, the rest are spaces.
+    const auto targetRight = targetColumn + std::clamp(_rightBound, beginColumn, endColumn) - beginColumn;
+    const auto lo = std::min(beginColumn, targetColumn);
+    const auto hi = std::max(endColumn, gsl::narrow_cast<til::CoordType>(targetColumn + count));
+
+    const auto moveRange = [](auto* const data, const size_t from, const size_t to, const size_t length) noexcept {
+        if (to < from)
+        {
+            std::copy_n(data + from, length, data + to);
+        }
+        else
+        {
+            std::copy_backward(data + from, data + from + length, data + to + length);
+        }
+    };
+
+    // Hot path: if all glyphs involved are 1 code unit long, the offsets stay the
+    // same and the text can be moved just like the DBCS attributes below.
+    if (gsl::narrow_cast<til::CoordType>(_charOffsets[hi] - _charOffsets[lo]) == hi - lo)
+    {
+        moveRange(_chars, _charOffsets[beginColumn], _charOffsets[targetColumn], count);
+    }
+    else
+    {
+        const std::wstring text{ _chars + _charOffsets[beginColumn], _chars + _charOffsets[endColumn] };
+        const std::vector<uint16_t> offsets{ _charOffsets + beginColumn, _charOffsets + endColumn + 1 };
+        const auto base = offsets.front();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto glyph = std::wstring_view{ text }.substr(til::at(offsets, i) - base, til::at(offsets, i + 1) - til::at(offsets, i));
+            _SetGlyph(gsl::narrow_cast<til::CoordType>(targetColumn + i), glyph);
+        }
+    }
+
+    moveRange(_dbcsAttrs, gsl::narrow_cast<size_t>(beginColumn), gsl::narrow_cast<size_t>(targetColumn), count);
+    _rightBound = std::max(_rightBound, targetRight);
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - moves the text of this row into a heap allocation with the given capacity
+// Arguments:
+// - capacity - the new capacity in code units. Must not be smaller than the current text length.
+void CharRow::_ReserveChars(const size_t capacity)
+{
+    auto heap = std::make_unique<wchar_t[]>(capacity);
+    std::copy_n(_chars, til::at(_charOffsets, _columnCount), heap.get());
+    _charsHeap = std::move(heap);
+    _chars = _charsHeap.get();
+    _charsCapacity = capacity;
+}
+
+// Routine Description:
+// - replaces the contents of this row with those of another row of the same width
+// Arguments:
+// - other - the row to copy from. Neither row may be frozen.
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::CopyFrom(const CharRow& other)
+{
+    FAIL_FAST_IF(other._columnCount != _columnCount);
+
+    const auto width = gsl::narrow_cast<size_t>(_columnCount);
+    const size_t textLength = other._charOffsets[width];
+    if (textLength > _charsCapacity)
+    {
+        _charsHeap = std::make_unique<wchar_t[]>(textLength);
+        _chars = _charsHeap.get();
+        _charsCapacity = textLength;
+    }
+
+    std::copy_n(other._chars, textLength, _chars);
+    std::copy_n(other._charOffsets, width + 1, _charOffsets);
+    std::copy_n(other._dbcsAttrs, width, _dbcsAttrs);
+    _rightBound = other._rightBound;
+}
+#pragma warning(pop)
+
 std::wstring CharRow::GetText() const
 {
     std::wstring wstr;
-    wstr.reserve(_data.size());
+    wstr.reserve(til::at(_charOffsets, _columnCount));
 
-    for (til::CoordType i = 0; i < gsl::narrow_cast<til::CoordType>(_data.size()); ++i)
+    // Trailing halves of wide glyphs repeat their leading half and must be skipped.
+    for (til::CoordType i = 0; i < _columnCount; ++i)
     {
-        const auto glyph = GlyphAt(i);
-        if (!DbcsAttrAt(i).IsTrailing())
+        if (!til::at(_dbcsAttrs, i).IsTrailing())
         {
-            for (const auto wch : glyph)
-            {
-                wstr.push_back(wch);
-            }
+            wstr.append(GlyphViewAt(i));
         }
     }
     return wstr;
@@ -233,9 +629,7 @@ std::wstring CharRow::GetText() const
 // - the delimiter class for the given char
 const DelimiterClass CharRow::DelimiterClassAt(const til::CoordType column, const std::wstring_view wordDelimiters) const
 {
-    THROW_HR_IF(E_INVALIDARG, column < 0 || column >= gsl::narrow_cast<til::CoordType>(_data.size()));
-
-    const auto glyph = *GlyphAt(column).begin();
+    const auto glyph = GlyphViewAt(column).front();
     if (glyph <= UNICODE_SPACE)
     {
         return DelimiterClass::ControlChar;
@@ -250,32 +644,329 @@ const DelimiterClass CharRow::DelimiterClassAt(const til::CoordType column, cons
     }
 }
 
-UnicodeStorage& CharRow::GetUnicodeStorage() noexcept
+// Routine Description:
+// - gets the delimiter class of every column in the row at once
+// Arguments:
+// - classifier: classifies characters based on the current word delimiters
+// - classes: receives the delimiter class of each column
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::GetDelimiterClasses(const DelimiterClassifier& classifier, std::vector<DelimiterClass>& classes) const
+{
+    const auto columns = gsl::narrow_cast<size_t>(_columnCount);
+    const auto text = GetChars();
+    classes.resize(columns);
+
+    // Most rows have exactly one code unit per column, so we can skip looking up the offsets.
+    if (text.size() == columns)
+    {
+        std::transform(text.begin(), text.end(), classes.begin(), std::cref(classifier));
+    }
+    else
+    {
+        for (size_t x = 0; x < columns; ++x)
+        {
+            til::at(classes, x) = classifier(til::at(text, _charOffsets[x]));
+        }
+    }
+}
+#pragma warning(pop)
+
+DelimiterClassifier::DelimiterClassifier() :
+    DelimiterClassifier(std::wstring_view{})
+{
+}
+
+DelimiterClassifier::DelimiterClassifier(const std::wstring_view wordDelimiters)
+{
+    _ascii.fill(DelimiterClass::RegularChar);
+
+    for (const auto wch : wordDelimiters)
+    {
+        if (wch < _ascii.size())
+        {
+            til::at(_ascii, wch) = DelimiterClass::DelimiterChar;
+        }
+        else
+        {
+            _nonAsciiDelimiters.emplace_back(wch);
+        }
+    }
+
+    // Control characters take precedence over delimiters, just like in DelimiterClassAt.
+    std::fill_n(_ascii.begin(), UNICODE_SPACE + 1, DelimiterClass::ControlChar);
+
+    std::sort(_nonAsciiDelimiters.begin(), _nonAsciiDelimiters.end());
+}
+
+DelimiterClass DelimiterClassifier::operator()(const wchar_t wch) const noexcept
+{
+    if (wch < _ascii.size())
+    {
+        return til::at(_ascii, wch);
+    }
+    return std::binary_search(_nonAsciiDelimiters.begin(), _nonAsciiDelimiters.end(), wch) ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+}
+
+// Routine Description:
+// - moves the contents of this row into a compact heap allocation, after which
+//   the TextBuffer may decommit the row's slice. Trailing blank columns aren't
+//   stored and for rows with one code unit per column (which is most of them)
+//   only the text is stored. Blank rows don't allocate anything.
+// - Nothing but Thaw(), Reset() and Resize() may be called on a frozen row.
+void CharRow::Freeze()
+{
+    _frozen = _Pack();
+    _charsHeap.reset();
+    _chars = _charsBuffer;
+    _charsCapacity = gsl::narrow_cast<size_t>(_columnCount);
+    _isFrozen = true;
+}
+
+// Routine Description:
+// - creates the compact copy of this row's contents that Freeze() stores
+// Return Value:
+// - the copy, or nullptr if the row is blank
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+std::unique_ptr<wchar_t[]> CharRow::_Pack() const
+{
+    auto columns = _columnCount;
+    while (columns > 0 && _IsSpaceAt(columns - 1) && _dbcsAttrs[columns - 1].IsSingle())
+    {
+        --columns;
+    }
+
+    std::unique_ptr<wchar_t[]> frozen;
+    if (columns > 0)
+    {
+        const auto width = gsl::narrow_cast<size_t>(columns);
+        const size_t textLength = _charOffsets[width];
+        // Every column holds at least 1 code unit, so if there are as many code units as columns, each holds exactly 1.
+        const auto hasLayout = textLength != width || !std::all_of(_dbcsAttrs, _dbcsAttrs + width, [](const auto& attr) { return attr.IsSingle(); });
+        const auto layoutLength = hasLayout ? FrozenLayoutLength(width) : 0;
+
+        frozen = std::make_unique_for_overwrite<wchar_t[]>(FrozenHeaderLength + textLength + layoutLength);
+        frozen[FrozenColumnCount] = gsl::narrow_cast<wchar_t>(width);
+        frozen[FrozenTextLength] = gsl::narrow_cast<wchar_t>(textLength);
+        frozen[FrozenHasLayout] = hasLayout;
+
+        const auto text = frozen.get() + FrozenHeaderLength;
+        std::copy_n(_chars, textLength, text);
+        if (hasLayout)
+        {
+            memcpy(text + textLength, _charOffsets, (width + 1) * sizeof(uint16_t));
+            memcpy(text + textLength + width + 1, _dbcsAttrs, width * sizeof(DbcsAttribute));
+        }
+    }
+
+    return frozen;
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - returns the length of a compact copy created by _Pack()
+size_t CharRow::_PackedLength(const wchar_t* const packed) noexcept
+{
+    const size_t columns = til::at(packed, FrozenColumnCount);
+    const size_t textLength = til::at(packed, FrozenTextLength);
+    const auto layoutLength = til::at(packed, FrozenHasLayout) ? FrozenLayoutLength(columns) : 0;
+    return FrozenHeaderLength + textLength + layoutLength;
+}
+
+// Routine Description:
+// - appends the same compact copy of this row's contents that Freeze() stores to a
+//   snapshot of the buffer. Nothing is appended for blank rows. See TextBuffer::Serialize().
+// - Frozen rows are copied as they are, without thawing them.
+// Arguments:
+// - snapshot - the snapshot to append to
+// - spilled - the contents of a frozen row that have been spilled, see GetSpillHandle()
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::AppendSnapshot(std::vector<wchar_t>& snapshot, const wchar_t* const spilled) const
+{
+    std::unique_ptr<wchar_t[]> packed;
+    const wchar_t* data;
+    if (_isFrozen)
+    {
+        data = _spillHandle ? spilled : _frozen.get();
+    }
+    else
+    {
+        packed = _Pack();
+        data = packed.get();
+    }
+
+    if (data)
+    {
+        snapshot.insert(snapshot.end(), data, data + _PackedLength(data));
+    }
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - replaces the contents of this row with a copy created by AppendSnapshot().
+//   Since snapshots are read back from disk, they're validated first.
+// Arguments:
+// - snapshot - the copy, or an empty span for a blank row
+// Return Value:
+// - false if the snapshot is malformed, in which case the row is left blank
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+bool CharRow::RestoreSnapshot(const std::span<const wchar_t> snapshot)
 {
-    return _pParent->GetUnicodeStorage();
+    if (snapshot.empty())
+    {
+        _ResetThawed();
+        return true;
+    }
+
+    const auto valid = [&]() noexcept {
+        if (snapshot.size() < FrozenHeaderLength)
+        {
+            return false;
+        }
+
+        const size_t columns = snapshot[FrozenColumnCount];
+        const size_t textLength = snapshot[FrozenTextLength];
+        const auto hasLayout = snapshot[FrozenHasLayout] != 0;
+        if (columns == 0 || snapshot.size() != _PackedLength(snapshot.data()))
+        {
+            return false;
+        }
+        if (!hasLayout)
+        {
+            return textLength == columns;
+        }
+
+        // Every column has to hold at least 1 code unit and the last offset is the length of the text.
+        const auto offsets = snapshot.data() + FrozenHeaderLength + textLength;
+        if (offsets[0] != 0 || offsets[columns] != textLength)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < columns; ++i)
+        {
+            if (offsets[i] >= offsets[i + 1])
+            {
+                return false;
+            }
+        }
+        return true;
+    }();
+
+    if (!valid)
+    {
+        _ResetThawed();
+        return false;
+    }
+
+    _Thaw(snapshot.data());
+    return true;
 }
+#pragma warning(pop)
 
-const UnicodeStorage& CharRow::GetUnicodeStorage() const noexcept
+// Routine Description:
+// - gets the compact copy of a frozen row's contents, so that it can be moved elsewhere
+// Return Value:
+// - the contents, or an empty span if the row is blank or has been spilled already
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+std::span<const wchar_t> CharRow::GetFrozenData() const noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    if (!_frozen)
+    {
+        return {};
+    }
+
+    return { _frozen.get(), _PackedLength(_frozen.get()) };
 }
+#pragma warning(pop)
 
 // Routine Description:
-// - calculates the key used by the given column of the char row to store glyph data in UnicodeStorage
+// - drops the compact copy of a frozen row's contents after it has been moved elsewhere
 // Arguments:
-// - column - the column to generate the key for
+// - handle - identifies the new location of the contents to the owner of the row, see GetSpillHandle()
+void CharRow::SpillFrozenData(const uint64_t handle) noexcept
+{
+    _frozen.reset();
+    _spillHandle = handle;
+}
+
+// Routine Description:
+// - gets the location of a frozen row's contents given to SpillFrozenData()
 // Return Value:
-// - the til::point key for data access from UnicodeStorage for the column
-til::point CharRow::GetStorageKey(const til::CoordType column) const noexcept
+// - the handle, or nullopt if the contents haven't been spilled
+std::optional<uint64_t> CharRow::GetSpillHandle() const noexcept
+{
+    return _spillHandle;
+}
+
+// Routine Description:
+// - restores the contents of a frozen row into its (committed) slice
+void CharRow::Thaw()
 {
-    return { column, _pParent->GetId() };
+    const auto frozen = std::move(_frozen);
+    _Thaw(frozen.get());
+    // Only now may readers that don't hold the TextBuffer's thaw lock use the row, see IsFrozen().
+    std::atomic_ref{ _isFrozen }.store(false, std::memory_order_release);
 }
 
 // Routine Description:
-// - Updates the pointer to the parent row (which might change if we shuffle the rows around)
+// - restores the contents of a frozen row, whose contents have been spilled, into its (committed) slice
 // Arguments:
-// - pParent - Pointer to the parent row
-void CharRow::UpdateParent(ROW* const pParent)
+// - spilled - the data that was returned by GetFrozenData() before it was spilled
+void CharRow::Thaw(const wchar_t* const spilled)
 {
-    _pParent = FAIL_FAST_IF_NULL(pParent);
+    _spillHandle.reset();
+    _Thaw(spilled);
+    std::atomic_ref{ _isFrozen }.store(false, std::memory_order_release);
 }
+
+// Routine Description:
+// - restores the contents of a frozen row from the given copy into its (committed) slice
+// - If the row was made narrower while it was frozen, its contents are truncated like Resize() would.
+// Arguments:
+// - frozen - the contents as stored by Freeze() or nullptr if the row is blank
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void CharRow::_Thaw(const wchar_t* const frozen)
+{
+    _ResetThawed();
+
+    if (!frozen)
+    {
+        return;
+    }
+
+    const auto width = gsl::narrow_cast<size_t>(_columnCount);
+    const size_t storedColumns = frozen[FrozenColumnCount];
+    const size_t storedLength = frozen[FrozenTextLength];
+    const auto columns = std::min(storedColumns, width);
+    const auto text = frozen + FrozenHeaderLength;
+    _rightBound = gsl::narrow_cast<til::CoordType>(columns);
+
+    // Reset() already filled in the layout of a row with one code unit per column.
+    if (!frozen[FrozenHasLayout])
+    {
+        std::copy_n(text, columns, _chars);
+        return;
+    }
+
+    memcpy(_charOffsets, text + storedLength, (columns + 1) * sizeof(uint16_t));
+    memcpy(_dbcsAttrs, text + storedLength + storedColumns + 1, columns * sizeof(DbcsAttribute));
+
+    const size_t textLength = _charOffsets[columns];
+    const auto charCount = textLength + (width - columns);
+    if (charCount > _charsCapacity)
+    {
+        _charsHeap = std::make_unique<wchar_t[]>(charCount);
+        _chars = _charsHeap.get();
+        _charsCapacity = charCount;
+    }
+
+    std::copy_n(text, textLength, _chars);
+    std::fill_n(_chars + textLength, width - columns, UNICODE_SPACE);
+    std::iota(_charOffsets + columns, _charOffsets + width + 1, gsl::narrow_cast<uint16_t>(textLength));
+}
+#pragma warning(pop)
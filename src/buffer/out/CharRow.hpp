@@ -6,7 +6,7 @@ Module Name:
 - CharRow.hpp
 
 Abstract:
-- contains data structure for UCS2 encoded character data of a row
+- contains data structure for UTF-16 encoded character data of a row
 
 Author(s):
 - Michael Niksa (miniksa) 10-Apr-2014
@@ -16,24 +16,39 @@ Revision History:
 - From components of output.h/.c
   by Therese Stowell (ThereseS) 1990-1991
 - Pulled into its own file from textBuffer.hpp/cpp (AustDi, 2017)
+- Turned into a structure of arrays backed by the TextBuffer's row slab
 --*/
 
 #pragma once
 
 #include "DbcsAttribute.hpp"
 #include "CharRowCellReference.hpp"
-#include "CharRowCell.hpp"
-#include "UnicodeStorage.hpp"
 
 class ROW;
 
-enum class DelimiterClass
+enum class DelimiterClass : uint8_t
 {
     ControlChar,
     DelimiterChar,
     RegularChar
 };
 
+// Classifies characters the same way CharRow::DelimiterClassAt does, but without
+// searching the word delimiters each time: ASCII is looked up in a table and the
+// few other delimiters there may be are binary searched.
+class DelimiterClassifier
+{
+public:
+    DelimiterClassifier();
+    explicit DelimiterClassifier(const std::wstring_view wordDelimiters);
+
+    DelimiterClass operator()(const wchar_t wch) const noexcept;
+
+private:
+    std::array<DelimiterClass, 128> _ascii;
+    std::vector<wchar_t> _nonAsciiDelimiters;
+};
+
 // the characters of one row of screen buffer
 // we keep the following values so that we don't write
 // more pixels to the screen than we have to:
@@ -44,47 +59,55 @@ enum class DelimiterClass
 //       ^    ^                  ^                     ^
 //       |    |                  |                     |
 //     Chars Left               Right                end of Chars buffer
+//
+// The text is stored as a structure of arrays:
+// * _chars holds the UTF-16 text of all columns back to back.
+// * _charOffsets holds size() + 1 offsets into _chars. The glyph of column i
+//   spans [_charOffsets[i], _charOffsets[i + 1]) and the last entry is the
+//   length of the text. Most columns hold exactly one code unit.
+// * _dbcsAttrs holds the leading/trailing information of each column.
+// All three arrays live in a slice of a slab allocated by the TextBuffer
+// (see CalculateBufferStride). If a row's text outgrows its slice
+// (surrogate pairs, combining marks, ...) _chars moves into _charsHeap
+// until the row is reset again. Since the text never leaves the row,
+// rows can be moved around freely without any bookkeeping.
+//
+// Rows far away from the output can be frozen by the TextBuffer (see
+// TextBuffer::_FreezeRow). A frozen row moves its contents into a compact
+// copy in _frozen and leaves its slice alone, so that the slab's memory can
+// be returned to the OS. It must be thawed before anything else is done
+// with it, which TextBuffer::GetRowByOffset takes care of.
 class CharRow final
 {
 public:
     using glyph_type = typename wchar_t;
-    using value_type = typename CharRowCell;
-    using iterator = typename boost::container::small_vector_base<value_type>::iterator;
-    using const_iterator = typename boost::container::small_vector_base<value_type>::const_iterator;
-    using const_reverse_iterator = typename boost::container::small_vector_base<value_type>::const_reverse_iterator;
     using reference = typename CharRowCellReference;
 
-    CharRow(til::CoordType rowWidth, ROW* const pParent) noexcept;
+    static size_t CalculateBufferStride(const til::CoordType rowWidth) noexcept;
+
+    CharRow(std::byte* const buffer, til::CoordType rowWidth, const bool frozen) noexcept;
 
     til::CoordType size() const noexcept;
-    [[nodiscard]] HRESULT Resize(const til::CoordType newSize) noexcept;
+    bool IsFrozen() const noexcept;
+    [[nodiscard]] HRESULT Resize(std::byte* const buffer, const til::CoordType newSize) noexcept;
     til::CoordType MeasureLeft() const noexcept;
-    til::CoordType MeasureRight() const;
+    til::CoordType MeasureRight() const noexcept;
     bool ContainsText() const noexcept;
     const DbcsAttribute& DbcsAttrAt(const til::CoordType column) const;
     DbcsAttribute& DbcsAttrAt(const til::CoordType column);
     void ClearGlyph(const til::CoordType column);
 
     const DelimiterClass DelimiterClassAt(const til::CoordType column, const std::wstring_view wordDelimiters) const;
+    void GetDelimiterClasses(const DelimiterClassifier& classifier, std::vector<DelimiterClass>& classes) const;
 
     // working with glyphs
     const reference GlyphAt(const til::CoordType column) const;
     reference GlyphAt(const til::CoordType column);
+    std::wstring_view GlyphViewAt(const til::CoordType column) const;
+    std::wstring_view GetChars() const noexcept;
+    size_t GetCharOffset(const til::CoordType column) const;
+    til::CoordType GetColumnAtCharOffset(const size_t offset) const noexcept;
 
-    // iterators
-    iterator begin() noexcept;
-    const_iterator cbegin() const noexcept;
-    const_iterator begin() const noexcept { return cbegin(); }
-
-    iterator end() noexcept;
-    const_iterator cend() const noexcept;
-    const_iterator end() const noexcept { return cend(); }
-
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    til::point GetStorageKey(const til::CoordType column) const noexcept;
-
-    void UpdateParent(ROW* const pParent);
 
     friend CharRowCellReference;
     friend class ROW;
@@ -93,23 +116,55 @@ private:
     void Reset() noexcept;
     void ClearCell(const til::CoordType column);
     std::wstring GetText() const;
-
-protected:
-    // storage for glyph data and dbcs attributes
-    boost::container::small_vector<value_type, 120> _data;
-
-    // ROW that this CharRow belongs to
-    ROW* _pParent;
+    void CopyFrom(const CharRow& other);
+    void Freeze();
+    std::span<const wchar_t> GetFrozenData() const noexcept;
+    void SpillFrozenData(const uint64_t handle) noexcept;
+    std::optional<uint64_t> GetSpillHandle() const noexcept;
+    void Thaw();
+    void Thaw(const wchar_t* const spilled);
+    void AppendSnapshot(std::vector<wchar_t>& snapshot, const wchar_t* const spilled) const;
+    bool RestoreSnapshot(const std::span<const wchar_t> snapshot);
+
+    std::unique_ptr<wchar_t[]> _Pack() const;
+    static size_t _PackedLength(const wchar_t* const packed) noexcept;
+    bool _IsSpaceAt(const til::CoordType column) const noexcept;
+    void _SetGlyph(const til::CoordType column, const std::wstring_view chars);
+    void _FillGlyphs(const til::CoordType beginColumn, const til::CoordType endColumn, const wchar_t wch) noexcept;
+    void _MoveGlyphs(const til::CoordType beginColumn, const til::CoordType endColumn, const til::CoordType targetColumn);
+    void _ReserveChars(const size_t capacity);
+    void _AssignBuffer(std::byte* const buffer, const til::CoordType rowWidth) noexcept;
+    void _ResetThawed() noexcept;
+    void _Thaw(const wchar_t* const frozen);
+
+    // the row's slice of the TextBuffer slab
+    wchar_t* _charsBuffer;
+    // either _charsBuffer or _charsHeap.get()
+    wchar_t* _chars;
+    uint16_t* _charOffsets;
+    DbcsAttribute* _dbcsAttrs;
+    // spill storage for rows whose text doesn't fit into _charsBuffer
+    std::unique_ptr<wchar_t[]> _charsHeap;
+    size_t _charsCapacity;
+    til::CoordType _columnCount;
+    // All columns starting at this one hold a single space. It's kept up to date by every write to
+    // the text, so that MeasureRight() & co. don't have to scan the blank end of most rows.
+    // It's only an upper bound: a row that was cleared in its middle might end earlier.
+    til::CoordType _rightBound;
+    // the contents of a frozen row, see Freeze(). nullptr if the row is blank.
+    std::unique_ptr<wchar_t[]> _frozen;
+    // set instead of _frozen if the contents were moved elsewhere, see SpillFrozenData()
+    std::optional<uint64_t> _spillHandle;
+    bool _isFrozen;
 };
 
 template<typename InputIt1, typename InputIt2>
-void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow::iterator outIt)
+void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow& charRow, til::CoordType column)
 {
-    std::transform(startChars,
-                   endChars,
-                   startAttrs,
-                   outIt,
-                   [](const wchar_t wch, const DbcsAttribute attr) {
-                       return CharRow::value_type{ wch, attr };
-                   });
+    for (; startChars != endChars; ++startChars, ++startAttrs, ++column)
+    {
+        const wchar_t wch = *startChars;
+        charRow.GlyphAt(column) = { &wch, 1 };
+        charRow.DbcsAttrAt(column) = *startAttrs;
+    }
 }
@@ -15,7 +15,6 @@ Author(s):
 #pragma once
 
 #include "DbcsAttribute.hpp"
-#include "CharRowCell.hpp"
 #include <utility>
 
 class CharRow;
@@ -53,9 +52,6 @@ private:
     // the index of the cell in the parent char row
     til::CoordType _index;
 
-    CharRowCell& _cellData();
-    const CharRowCell& _cellData() const;
-
     std::wstring_view _glyphData() const;
 };
 
@@ -6,6 +6,7 @@
 #include "OutputCellIterator.hpp"
 
 #include "../../types/inc/convert.hpp"
+#include "../../types/inc/GraphemeBreak.hpp"
 #include "../../types/inc/Utf16Parser.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
 #include "../../inc/conattrs.hpp"
@@ -398,7 +399,16 @@ OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view,
                                                   const TextAttribute attr,
                                                   const TextAttributeBehavior behavior)
 {
-    const auto glyph = Utf16Parser::ParseNext(view);
+    std::wstring_view glyph;
+    if constexpr (Feature_GraphemeClusterSegmentation::IsEnabled())
+    {
+        glyph = GraphemeBreak::ParseNextCluster(view);
+    }
+    else
+    {
+        glyph = Utf16Parser::ParseNext(view);
+    }
+
     DbcsAttribute dbcsAttr;
     if (IsGlyphFullWidth(glyph))
     {
@@ -0,0 +1,953 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "RegexMatcher.hpp"
+
+namespace
+{
+    // The syntax tree a pattern is parsed into, before it's compiled into instructions.
+    struct Node
+    {
+        enum class Kind : uint8_t
+        {
+            Empty,
+            Char,
+            Any,
+            Class,
+            Assert,
+            Concat,
+            Alternate,
+            Repeat,
+        };
+
+        Kind kind = Kind::Empty;
+        wchar_t ch = 0;
+        // The class index for Class and the assertion for Assert.
+        uint32_t index = 0;
+        uint32_t min = 0;
+        uint32_t max = 0;
+        bool greedy = true;
+        std::vector<Node> children;
+    };
+
+    constexpr uint32_t Unbounded = UINT32_MAX;
+    // Counted repetitions are compiled by repeating their operand, so they're limited.
+    constexpr uint32_t MaxRepeat = 1000;
+    constexpr size_t MaxDepth = 256;
+
+    using Ranges = std::vector<std::pair<wchar_t, wchar_t>>;
+
+    constexpr bool isWordChar(const wchar_t ch) noexcept
+    {
+        return (ch >= L'0' && ch <= L'9') || (ch >= L'A' && ch <= L'Z') || (ch >= L'a' && ch <= L'z') || ch == L'_';
+    }
+
+    constexpr bool isLineTerminator(const wchar_t ch) noexcept
+    {
+        return ch == L'\n' || ch == L'\r' || ch == 0x2028 || ch == 0x2029;
+    }
+
+    constexpr int hexValue(const wchar_t ch) noexcept
+    {
+        if (ch >= L'0' && ch <= L'9')
+        {
+            return ch - L'0';
+        }
+        if (ch >= L'a' && ch <= L'f')
+        {
+            return ch - L'a' + 10;
+        }
+        if (ch >= L'A' && ch <= L'F')
+        {
+            return ch - L'A' + 10;
+        }
+        return -1;
+    }
+
+    // Appends the ranges of \d, \w, \s or, for the uppercase escapes, their complements.
+    void appendBuiltinClass(const wchar_t escape, Ranges& ranges)
+    {
+        static constexpr std::pair<wchar_t, wchar_t> digit[]{ { L'0', L'9' } };
+        static constexpr std::pair<wchar_t, wchar_t> word[]{ { L'0', L'9' }, { L'A', L'Z' }, { L'_', L'_' }, { L'a', L'z' } };
+        static constexpr std::pair<wchar_t, wchar_t> space[]{
+            { L'\t', L'\r' },
+            { L' ', L' ' },
+            { 0x00a0, 0x00a0 },
+            { 0x1680, 0x1680 },
+            { 0x2000, 0x200a },
+            { 0x2028, 0x2029 },
+            { 0x202f, 0x202f },
+            { 0x205f, 0x205f },
+            { 0x3000, 0x3000 },
+            { 0xfeff, 0xfeff },
+        };
+
+        std::span<const std::pair<wchar_t, wchar_t>> set;
+        switch (escape)
+        {
+        case L'd':
+        case L'D':
+            set = digit;
+            break;
+        case L'w':
+        case L'W':
+            set = word;
+            break;
+        default:
+            set = space;
+            break;
+        }
+
+        if (escape >= L'a')
+        {
+            ranges.insert(ranges.end(), set.begin(), set.end());
+            return;
+        }
+
+        uint32_t next = 0;
+        for (const auto& [lo, hi] : set)
+        {
+            if (lo > next)
+            {
+                ranges.emplace_back(gsl::narrow_cast<wchar_t>(next), gsl::narrow_cast<wchar_t>(lo - 1));
+            }
+            next = hi + 1u;
+        }
+        if (next <= 0xffff)
+        {
+            ranges.emplace_back(gsl::narrow_cast<wchar_t>(next), L'\xffff');
+        }
+    }
+
+    // Sorts the ranges and merges the ones that overlap or touch.
+    void normalizeRanges(Ranges& ranges)
+    {
+        std::sort(ranges.begin(), ranges.end());
+
+        size_t out = 0;
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            const auto range = til::at(ranges, i);
+            if (out != 0 && range.first <= til::at(ranges, out - 1).second + 1u)
+            {
+                auto& last = til::at(ranges, out - 1).second;
+                last = std::max(last, range.second);
+            }
+            else
+            {
+                til::at(ranges, out++) = range;
+            }
+        }
+        ranges.resize(out);
+    }
+}
+
+// Parses a pattern into a syntax tree and compiles that into the program of a RegexMatcher.
+// The Parse functions return false for syntax errors and unsupported features.
+struct RegexMatcher::Compiler
+{
+    Compiler(const std::wstring_view pattern, RegexMatcher& matcher) noexcept :
+        pattern{ pattern },
+        matcher{ matcher }
+    {
+    }
+
+    bool AtEnd() const noexcept
+    {
+        return pos >= pattern.size();
+    }
+
+    wchar_t Peek() const noexcept
+    {
+        return AtEnd() ? L'\0' : til::at(pattern, pos);
+    }
+
+    bool Consume(const wchar_t ch) noexcept
+    {
+        if (!AtEnd() && til::at(pattern, pos) == ch)
+        {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseAlternation(Node& out)
+    {
+        if (++depth > MaxDepth)
+        {
+            return false;
+        }
+
+        Node alternation;
+        alternation.kind = Node::Kind::Alternate;
+        do
+        {
+            if (!ParseSequence(alternation.children.emplace_back()))
+            {
+                return false;
+            }
+        } while (Consume(L'|'));
+
+        --depth;
+        if (alternation.children.size() == 1)
+        {
+            out = std::move(alternation.children.front());
+        }
+        else
+        {
+            out = std::move(alternation);
+        }
+        return true;
+    }
+
+    bool ParseSequence(Node& out)
+    {
+        out.kind = Node::Kind::Concat;
+        while (!AtEnd() && Peek() != L'|' && Peek() != L')')
+        {
+            auto& atom = out.children.emplace_back();
+            if (!ParseAtom(atom) || !ParseQuantifier(atom))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ParseAtom(Node& out)
+    {
+        const auto ch = til::at(pattern, pos++);
+        switch (ch)
+        {
+        case L'(':
+            // (?:...) is the only supported group extension. The
+            // others are lookarounds and named groups.
+            if (Consume(L'?') && !Consume(L':'))
+            {
+                return false;
+            }
+            return ParseAlternation(out) && Consume(L')');
+        case L'[':
+            return ParseClass(out);
+        case L'.':
+            out.kind = Node::Kind::Any;
+            return true;
+        case L'^':
+            out.kind = Node::Kind::Assert;
+            out.index = static_cast<uint32_t>(Assertion::Begin);
+            return true;
+        case L'$':
+            out.kind = Node::Kind::Assert;
+            out.index = static_cast<uint32_t>(Assertion::End);
+            return true;
+        case L'\\':
+            return ParseEscape(out);
+        case L'*':
+        case L'+':
+        case L'?':
+            // A quantifier without anything to repeat.
+            return false;
+        case L'{':
+        {
+            --pos;
+            uint32_t min;
+            uint32_t max;
+            if (TryParseBraces(min, max))
+            {
+                return false;
+            }
+            ++pos;
+            break;
+        }
+        default:
+            break;
+        }
+
+        // Like in ECMAScript, "]", "}" and a "{" that doesn't start a quantifier are literals.
+        out.kind = Node::Kind::Char;
+        out.ch = ch;
+        return true;
+    }
+
+    bool ParseQuantifier(Node& atom)
+    {
+        uint32_t min = 0;
+        uint32_t max = Unbounded;
+        switch (Peek())
+        {
+        case L'*':
+            ++pos;
+            break;
+        case L'+':
+            ++pos;
+            min = 1;
+            break;
+        case L'?':
+            ++pos;
+            max = 1;
+            break;
+        case L'{':
+            if (!TryParseBraces(min, max))
+            {
+                return true;
+            }
+            if (min > MaxRepeat || (max != Unbounded && (max > MaxRepeat || max < min)))
+            {
+                return false;
+            }
+            break;
+        default:
+            return true;
+        }
+
+        if (atom.kind == Node::Kind::Assert)
+        {
+            return false;
+        }
+
+        Node repeat;
+        repeat.kind = Node::Kind::Repeat;
+        repeat.min = min;
+        repeat.max = max;
+        repeat.greedy = !Consume(L'?');
+        repeat.children.emplace_back(std::move(atom));
+        atom = std::move(repeat);
+
+        // "a**" and the like are syntax errors.
+        const auto next = Peek();
+        return next != L'*' && next != L'+' && next != L'?';
+    }
+
+    // Parses "{n}", "{n,}" or "{n,m}" at the current position. Leaves the position
+    // untouched and returns false if the text there isn't such a quantifier.
+    bool TryParseBraces(uint32_t& min, uint32_t& max) noexcept
+    {
+        const auto start = pos;
+        const auto parseNumber = [&](uint32_t& value) noexcept {
+            const auto begin = pos;
+            value = 0;
+            for (; !AtEnd() && Peek() >= L'0' && Peek() <= L'9'; ++pos)
+            {
+                // Values past MaxRepeat are clamped. They're rejected either way.
+                value = std::min(value * 10 + (Peek() - L'0'), MaxRepeat + 1);
+            }
+            return pos != begin;
+        };
+
+        if (Consume(L'{') && parseNumber(min))
+        {
+            max = min;
+            if (Consume(L','))
+            {
+                max = Unbounded;
+                if (Peek() != L'}' && !parseNumber(max))
+                {
+                    pos = start;
+                    return false;
+                }
+            }
+            if (Consume(L'}'))
+            {
+                return true;
+            }
+        }
+
+        pos = start;
+        return false;
+    }
+
+    bool ParseEscape(Node& out)
+    {
+        if (AtEnd())
+        {
+            return false;
+        }
+
+        const auto ch = til::at(pattern, pos++);
+        switch (ch)
+        {
+        case L'b':
+        case L'B':
+            out.kind = Node::Kind::Assert;
+            out.index = static_cast<uint32_t>(ch == L'b' ? Assertion::WordBoundary : Assertion::NotWordBoundary);
+            return true;
+        case L'd':
+        case L'D':
+        case L'w':
+        case L'W':
+        case L's':
+        case L'S':
+        {
+            CharClass charClass;
+            appendBuiltinClass(ch, charClass.ranges);
+            out.kind = Node::Kind::Class;
+            out.index = AddClass(std::move(charClass));
+            return true;
+        }
+        default:
+            out.kind = Node::Kind::Char;
+            return ParseCharEscape(ch, out.ch);
+        }
+    }
+
+    // Parses the escapes that stand for a single code unit, given the character after the "\".
+    bool ParseCharEscape(const wchar_t ch, wchar_t& value) noexcept
+    {
+        switch (ch)
+        {
+        case L't':
+            value = L'\t';
+            return true;
+        case L'n':
+            value = L'\n';
+            return true;
+        case L'v':
+            value = L'\v';
+            return true;
+        case L'f':
+            value = L'\f';
+            return true;
+        case L'r':
+            value = L'\r';
+            return true;
+        case L'0':
+            value = L'\0';
+            return Peek() < L'0' || Peek() > L'9';
+        case L'x':
+            return ParseHex(2, value);
+        case L'u':
+            return ParseHex(4, value);
+        default:
+            // Backreferences (\1, \k<name>) aren't supported and
+            // neither are the remaining escapes of letters and digits.
+            if (isWordChar(ch))
+            {
+                return false;
+            }
+            value = ch;
+            return true;
+        }
+    }
+
+    bool ParseHex(const size_t digits, wchar_t& value) noexcept
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < digits; ++i)
+        {
+            const auto digit = hexValue(Peek());
+            if (digit < 0)
+            {
+                return false;
+            }
+            ++pos;
+            result = result * 16 + digit;
+        }
+        value = gsl::narrow_cast<wchar_t>(result);
+        return true;
+    }
+
+    bool ParseClass(Node& out)
+    {
+        CharClass charClass;
+        charClass.negated = Consume(L'^');
+
+        while (!Consume(L']'))
+        {
+            if (AtEnd())
+            {
+                return false;
+            }
+
+            wchar_t lo;
+            auto builtin = false;
+            if (!ParseClassAtom(charClass.ranges, lo, builtin))
+            {
+                return false;
+            }
+            if (builtin)
+            {
+                // \d, \w, \s or their complements, which can't start a range.
+                continue;
+            }
+
+            auto hi = lo;
+            if (Peek() == L'-' && pos + 1 < pattern.size() && til::at(pattern, pos + 1) != L']')
+            {
+                ++pos;
+                if (!ParseClassAtom(charClass.ranges, hi, builtin) || builtin || hi < lo)
+                {
+                    return false;
+                }
+            }
+            charClass.ranges.emplace_back(lo, hi);
+        }
+
+        normalizeRanges(charClass.ranges);
+        out.kind = Node::Kind::Class;
+        out.index = AddClass(std::move(charClass));
+        return true;
+    }
+
+    // Parses a single member of a class. For \d, \w, \s and their
+    // complements, the ranges are appended and builtin is set instead.
+    bool ParseClassAtom(Ranges& ranges, wchar_t& value, bool& builtin)
+    {
+        const auto ch = til::at(pattern, pos++);
+        if (ch != L'\\')
+        {
+            value = ch;
+            return true;
+        }
+        if (AtEnd())
+        {
+            return false;
+        }
+
+        const auto escape = til::at(pattern, pos++);
+        switch (escape)
+        {
+        case L'b':
+            value = L'\b';
+            return true;
+        case L'd':
+        case L'D':
+        case L'w':
+        case L'W':
+        case L's':
+        case L'S':
+            appendBuiltinClass(escape, ranges);
+            builtin = true;
+            return true;
+        default:
+            return ParseCharEscape(escape, value);
+        }
+    }
+
+    uint32_t AddClass(CharClass&& charClass)
+    {
+        matcher._classes.emplace_back(std::move(charClass));
+        return gsl::narrow_cast<uint32_t>(matcher._classes.size() - 1);
+    }
+
+    uint32_t Here() const noexcept
+    {
+        return gsl::narrow_cast<uint32_t>(matcher._program.size());
+    }
+
+    void SetTargets(const uint32_t split, const uint32_t body, const uint32_t next, const bool greedy)
+    {
+        auto& instruction = til::at(matcher._program, split);
+        instruction.x = greedy ? body : next;
+        instruction.y = greedy ? next : body;
+    }
+
+    bool Emit(const Node& node)
+    {
+        auto& program = matcher._program;
+        if (program.size() > _maxInstructions)
+        {
+            return false;
+        }
+
+        switch (node.kind)
+        {
+        case Node::Kind::Empty:
+            return true;
+        case Node::Kind::Char:
+            program.push_back({ Opcode::Char, matcher._ignoreCase ? gsl::narrow_cast<wchar_t>(towlower(node.ch)) : node.ch });
+            return true;
+        case Node::Kind::Any:
+            program.push_back({ Opcode::Any });
+            return true;
+        case Node::Kind::Class:
+            program.push_back({ Opcode::Class, L'\0', node.index });
+            return true;
+        case Node::Kind::Assert:
+            program.push_back({ Opcode::Assert, L'\0', node.index });
+            return true;
+        case Node::Kind::Concat:
+            for (const auto& child : node.children)
+            {
+                if (!Emit(child))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case Node::Kind::Alternate:
+        {
+            // Each alternative but the last is tried first: Split(alternative, rest).
+            std::vector<uint32_t> jumps;
+            const auto last = node.children.size() - 1;
+            for (size_t i = 0; i < last; ++i)
+            {
+                const auto split = Here();
+                program.push_back({ Opcode::Split });
+                if (!Emit(til::at(node.children, i)))
+                {
+                    return false;
+                }
+                jumps.push_back(Here());
+                program.push_back({ Opcode::Jump });
+                SetTargets(split, split + 1, Here(), true);
+            }
+            if (!Emit(til::at(node.children, last)))
+            {
+                return false;
+            }
+            for (const auto jump : jumps)
+            {
+                til::at(program, jump).x = Here();
+            }
+            return true;
+        }
+        case Node::Kind::Repeat:
+        {
+            const auto& child = node.children.front();
+            for (uint32_t i = 0; i < node.min; ++i)
+            {
+                if (!Emit(child))
+                {
+                    return false;
+                }
+            }
+
+            if (node.max == Unbounded)
+            {
+                const auto split = Here();
+                program.push_back({ Opcode::Split });
+                if (!Emit(child))
+                {
+                    return false;
+                }
+                program.push_back({ Opcode::Jump, L'\0', split });
+                SetTargets(split, split + 1, Here(), node.greedy);
+                return true;
+            }
+
+            for (auto i = node.min; i < node.max; ++i)
+            {
+                const auto split = Here();
+                program.push_back({ Opcode::Split });
+                if (!Emit(child))
+                {
+                    return false;
+                }
+                SetTargets(split, split + 1, Here(), node.greedy);
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    std::wstring_view pattern;
+    size_t pos = 0;
+    size_t depth = 0;
+    RegexMatcher& matcher;
+};
+
+// Routine Description:
+// - Compiles a pattern for matching.
+// Arguments:
+// - pattern - the ECMAScript regular expression, see the header for the supported subset
+// - ignoreCase - whether letters match regardless of their case
+// Return Value:
+// - The matcher, or nullopt if the pattern is invalid or uses unsupported features.
+std::optional<RegexMatcher> RegexMatcher::Compile(const std::wstring_view pattern, const bool ignoreCase)
+{
+    RegexMatcher matcher;
+    matcher._ignoreCase = ignoreCase;
+
+    Compiler compiler{ pattern, matcher };
+    Node root;
+    // ParseAlternation() stops at an unbalanced ")", which AtEnd() catches.
+    if (!compiler.ParseAlternation(root) || !compiler.AtEnd() || !compiler.Emit(root))
+    {
+        return std::nullopt;
+    }
+
+    matcher._program.push_back({ Opcode::Match });
+    matcher._firstChar = matcher._GetFirstChar();
+    return matcher;
+}
+
+// Routine Description:
+// - Finds the leftmost match in the text.
+// - Assertions like ^ and \b look at the entire text, not just past the offset.
+// Arguments:
+// - text - the text to search
+// - offset - the position at which the search starts
+// Return Value:
+// - The [begin, end) offsets of the match, or nullopt if there's none. Matches may be empty.
+std::optional<std::pair<size_t, size_t>> RegexMatcher::Find(const std::wstring_view text, const size_t offset) const
+{
+    return _Find(text, offset, false);
+}
+
+// Routine Description:
+// - Finds all non-overlapping matches in the text, like std::wcregex_iterator would.
+// Arguments:
+// - text - the text to search
+// - matches - receives the [begin, end) offsets of each match. Matches may be empty.
+void RegexMatcher::FindAll(const std::wstring_view text, std::vector<std::pair<size_t, size_t>>& matches) const
+{
+    auto match = _Find(text, 0, false);
+    while (match)
+    {
+        matches.emplace_back(*match);
+
+        const auto end = match->second;
+        if (end != match->first)
+        {
+            match = _Find(text, end, false);
+            continue;
+        }
+
+        // Like std::wcregex_iterator, after an empty match a non-empty one starting at
+        // the same position is preferred. Otherwise the search continues past the match.
+        match = _Find(text, end, true);
+        if (!match && end < text.size())
+        {
+            match = _Find(text, end + 1, false);
+        }
+    }
+}
+
+// Routine Description:
+// - Finds the leftmost match at or past the offset.
+// Arguments:
+// - text - the text to search
+// - offset - the position at which the search starts
+// - anchoredNonEmpty - only look for non-empty matches that start right at the offset
+// Return Value:
+// - The [begin, end) offsets of the match, or nullopt if there's none.
+std::optional<std::pair<size_t, size_t>> RegexMatcher::_Find(const std::wstring_view text, const size_t offset, const bool anchoredNonEmpty) const
+{
+    std::optional<std::pair<size_t, size_t>> match;
+
+    _current.clear();
+    _marks.assign(_program.size(), SIZE_MAX);
+
+    for (auto pos = offset; pos <= text.size(); ++pos)
+    {
+        if (!match && (!anchoredNonEmpty || pos == offset))
+        {
+            if (_current.empty() && _firstChar && !anchoredNonEmpty)
+            {
+                pos = _FindFirstChar(text, pos);
+                if (pos == std::wstring_view::npos)
+                {
+                    break;
+                }
+            }
+            // A match may start at every position. These paths have the lowest
+            // priority, since matches that start further left take precedence.
+            _AddThread(_current, 0, pos, text, pos);
+        }
+
+        if ((match || anchoredNonEmpty) && _current.empty())
+        {
+            break;
+        }
+
+        _next.clear();
+        for (const auto& thread : _current)
+        {
+            const auto& instruction = til::at(_program, thread.pc);
+            if (instruction.op == Opcode::Match)
+            {
+                if (anchoredNonEmpty && pos == thread.start)
+                {
+                    continue;
+                }
+                // The remaining paths have a lower priority. Any match they
+                // would find is discarded in favor of this one anyways.
+                match.emplace(thread.start, pos);
+                break;
+            }
+            if (pos < text.size() && _Matches(instruction, til::at(text, pos)))
+            {
+                _AddThread(_next, thread.pc + 1, thread.start, text, pos + 1);
+            }
+        }
+        std::swap(_current, _next);
+    }
+
+    return match;
+}
+
+bool RegexMatcher::CharClass::Contains(const wchar_t ch, const bool ignoreCase) const noexcept
+{
+    const auto inRanges = [&](const wchar_t c) noexcept {
+        const auto it = std::upper_bound(ranges.begin(), ranges.end(), c, [](const wchar_t value, const auto& range) {
+            return value < range.first;
+        });
+        return it != ranges.begin() && c <= std::prev(it)->second;
+    };
+
+    auto found = inRanges(ch);
+    if (!found && ignoreCase)
+    {
+        found = inRanges(gsl::narrow_cast<wchar_t>(towlower(ch))) || inRanges(gsl::narrow_cast<wchar_t>(towupper(ch)));
+    }
+    return found != negated;
+}
+
+bool RegexMatcher::_Matches(const Instruction& instruction, const wchar_t ch) const noexcept
+{
+    switch (instruction.op)
+    {
+    case Opcode::Char:
+        return (_ignoreCase ? gsl::narrow_cast<wchar_t>(towlower(ch)) : ch) == instruction.ch;
+    case Opcode::Any:
+        return !isLineTerminator(ch);
+    case Opcode::Class:
+        return til::at(_classes, instruction.x).Contains(ch, _ignoreCase);
+    default:
+        return false;
+    }
+}
+
+bool RegexMatcher::s_Asserts(const Assertion assertion, const std::wstring_view text, const size_t pos) noexcept
+{
+    switch (assertion)
+    {
+    case Assertion::Begin:
+        return pos == 0;
+    case Assertion::End:
+        return pos == text.size();
+    default:
+    {
+        const auto before = pos > 0 && isWordChar(til::at(text, pos - 1));
+        const auto after = pos < text.size() && isWordChar(til::at(text, pos));
+        return (before != after) == (assertion == Assertion::WordBoundary);
+    }
+    }
+}
+
+// Routine Description:
+// - Adds the paths that start at the given instruction to the list. Jumps, splits and
+//   assertions are followed right away, so that the list only holds the instructions
+//   that consume a code unit, and Match.
+// - The paths are followed depth-first in order of preference, which keeps the list
+//   sorted by priority. A path that reaches an instruction another path reached before
+//   at this position is dropped: both would behave the same from here on.
+// Arguments:
+// - list - the list of the paths at pos
+// - pc - the instruction to start at
+// - start - the start of the match the paths belong to
+// - text - the text being searched
+// - pos - the current position in the text
+void RegexMatcher::_AddThread(std::vector<Thread>& list, const uint32_t pc, const size_t start, const std::wstring_view text, const size_t pos) const
+{
+    _stack.push_back(pc);
+    while (!_stack.empty())
+    {
+        const auto current = _stack.back();
+        _stack.pop_back();
+
+        auto& mark = til::at(_marks, current);
+        if (mark == pos)
+        {
+            continue;
+        }
+        mark = pos;
+
+        const auto& instruction = til::at(_program, current);
+        switch (instruction.op)
+        {
+        case Opcode::Jump:
+            _stack.push_back(instruction.x);
+            break;
+        case Opcode::Split:
+            _stack.push_back(instruction.y);
+            _stack.push_back(instruction.x);
+            break;
+        case Opcode::Assert:
+            if (s_Asserts(static_cast<Assertion>(instruction.x), text, pos))
+            {
+                _stack.push_back(current + 1);
+            }
+            break;
+        default:
+            list.push_back({ current, start });
+            break;
+        }
+    }
+}
+
+// Routine Description:
+// - Determines whether every match starts with the same code unit, see _firstChar.
+std::optional<wchar_t> RegexMatcher::_GetFirstChar() const
+{
+    std::optional<wchar_t> first;
+    std::vector<bool> visited(_program.size());
+    std::vector<uint32_t> stack{ 0 };
+
+    while (!stack.empty())
+    {
+        const auto pc = stack.back();
+        stack.pop_back();
+        if (visited.at(pc))
+        {
+            continue;
+        }
+        visited.at(pc) = true;
+
+        const auto& instruction = til::at(_program, pc);
+        switch (instruction.op)
+        {
+        case Opcode::Jump:
+            stack.push_back(instruction.x);
+            break;
+        case Opcode::Split:
+            stack.push_back(instruction.x);
+            stack.push_back(instruction.y);
+            break;
+        case Opcode::Assert:
+            // Assertions don't consume anything, so skipping them is fine.
+            stack.push_back(pc + 1);
+            break;
+        case Opcode::Char:
+            if (first && *first != instruction.ch)
+            {
+                return std::nullopt;
+            }
+            first = instruction.ch;
+            break;
+        default:
+            // Classes match more than one code unit and a reachable Match means
+            // that the pattern matches the empty string, which can start anywhere.
+            return std::nullopt;
+        }
+    }
+
+    return first;
+}
+
+// Routine Description:
+// - Finds the next position at or past the offset that holds _firstChar.
+// Return Value:
+// - The position, or npos if there's none.
+size_t RegexMatcher::_FindFirstChar(const std::wstring_view text, const size_t offset) const noexcept
+{
+    const auto first = *_firstChar;
+    if (!_ignoreCase || gsl::narrow_cast<wchar_t>(towupper(first)) == first)
+    {
+        return text.find(first, offset);
+    }
+
+    for (auto pos = offset; pos < text.size(); ++pos)
+    {
+        if (gsl::narrow_cast<wchar_t>(towlower(til::at(text, pos))) == first)
+        {
+            return pos;
+        }
+    }
+    return std::wstring_view::npos;
+}
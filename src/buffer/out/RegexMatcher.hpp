@@ -0,0 +1,108 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RegexMatcher.hpp
+
+Abstract:
+- A regular expression matcher for searching the text buffer. Unlike std::wregex
+  it never backtracks: the pattern is compiled into an NFA, which is simulated
+  along all of its paths at once (a "Pike VM"). Matching thus takes time linear
+  in the length of the text, no matter how pathological the pattern is.
+- It supports the commonly used subset of the ECMAScript grammar std::wregex uses
+  by default: literals, ".", character classes, \d \w \s and their negations,
+  ^ $ \b \B, groups, alternations and greedy as well as lazy quantifiers.
+  Backreferences and lookarounds can't be matched in linear time. Patterns
+  using them are rejected by Compile().
+- Matches are leftmost-first, like with std::wregex: of all matches starting
+  at the leftmost position, the one an ECMAScript backtracking matcher would
+  have found first is returned.
+--*/
+
+#pragma once
+
+class RegexMatcher final
+{
+public:
+    static std::optional<RegexMatcher> Compile(const std::wstring_view pattern, const bool ignoreCase);
+
+    std::optional<std::pair<size_t, size_t>> Find(const std::wstring_view text, const size_t offset) const;
+    void FindAll(const std::wstring_view text, std::vector<std::pair<size_t, size_t>>& matches) const;
+
+private:
+    enum class Opcode : uint8_t
+    {
+        Char,
+        Any,
+        Class,
+        Assert,
+        Split,
+        Jump,
+        Match,
+    };
+
+    enum class Assertion : uint32_t
+    {
+        Begin,
+        End,
+        WordBoundary,
+        NotWordBoundary,
+    };
+
+    struct Instruction
+    {
+        Opcode op;
+        // The code unit to match for Char. Lowercase if _ignoreCase is set.
+        wchar_t ch = 0;
+        // The class index for Class, the Assertion for Assert,
+        // and the (preferred) target for Jump and Split.
+        uint32_t x = 0;
+        // The other target of Split.
+        uint32_t y = 0;
+    };
+
+    struct CharClass
+    {
+        bool Contains(const wchar_t ch, const bool ignoreCase) const noexcept;
+
+        // Sorted, non-overlapping and inclusive.
+        std::vector<std::pair<wchar_t, wchar_t>> ranges;
+        bool negated = false;
+    };
+
+    // A path through the NFA: the instruction it's at and where its match started.
+    struct Thread
+    {
+        uint32_t pc;
+        size_t start;
+    };
+
+    struct Compiler;
+
+    // Patterns whose program would exceed this are rejected, since
+    // every instruction costs time for every code unit of the text.
+    static constexpr size_t _maxInstructions = 20000;
+
+    std::optional<std::pair<size_t, size_t>> _Find(const std::wstring_view text, const size_t offset, const bool anchoredNonEmpty) const;
+    bool _Matches(const Instruction& instruction, const wchar_t ch) const noexcept;
+    static bool s_Asserts(const Assertion assertion, const std::wstring_view text, const size_t pos) noexcept;
+    void _AddThread(std::vector<Thread>& list, const uint32_t pc, const size_t start, const std::wstring_view text, const size_t pos) const;
+    std::optional<wchar_t> _GetFirstChar() const;
+    size_t _FindFirstChar(const std::wstring_view text, const size_t offset) const noexcept;
+
+    std::vector<Instruction> _program;
+    std::vector<CharClass> _classes;
+    // If every match starts with this code unit, Find() skips straight to
+    // its next occurrence whenever no match is in progress.
+    std::optional<wchar_t> _firstChar;
+    bool _ignoreCase = false;
+
+    // Scratch space for Find(), so that it doesn't allocate for every line
+    // of the buffer. A RegexMatcher must not be used by multiple threads at once.
+    mutable std::vector<Thread> _current;
+    mutable std::vector<Thread> _next;
+    mutable std::vector<uint32_t> _stack;
+    // The position of the text at which each instruction was last added to a thread list.
+    mutable std::vector<size_t> _marks;
+};
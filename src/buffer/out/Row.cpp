@@ -6,6 +6,12 @@
 #include "CharRow.hpp"
 #include "textBuffer.hpp"
 #include "../types/inc/convert.hpp"
+#include "unicode.hpp"
+
+// Every modification of a row, in any text buffer, draws a new value from this counter.
+// The rows of all buffers share it, so that a generation remembered for one buffer
+// can never be mistaken for a newer one after the buffer has been replaced.
+static std::atomic<uint64_t> s_generation{ 0 };
 
 // Routine Description:
 // - constructor
@@ -14,18 +20,67 @@
 // - rowWidth - the width of the row, cell elements
 // - fillAttribute - the default text attribute
 // - pParent - the text buffer that this row belongs to
+// - charBuffer - the row's slice of the text buffer's character slab (see CharRow::CalculateBufferStride)
+// - frozen - whether the row starts out frozen, see CharRow::Freeze()
 // Return Value:
 // - constructed object
-ROW::ROW(const til::CoordType rowId, const til::CoordType rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent) :
+ROW::ROW(const til::CoordType rowId, const til::CoordType rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent, std::byte* const charBuffer, const bool frozen) :
     _id{ rowId },
     _rowWidth{ rowWidth },
-    _charRow{ rowWidth, this },
-    _attrRow{ rowWidth, fillAttribute },
+    _charRow{ charBuffer, rowWidth, frozen },
+    _attrRow{ rowWidth, fillAttribute, pParent->GetAttributeTable() },
     _lineRendition{ LineRendition::SingleWidth },
     _wrapForced{ false },
     _doubleBytePadded{ false },
-    _pParent{ pParent }
+    _pParent{ pParent },
+    _generation{ s_generation.fetch_add(1, std::memory_order_relaxed) + 1 },
+    _dirtyLeft{ 0 },
+    _dirtyRight{ rowWidth }
+{
+}
+
+// Routine Description:
+// - Returns the generation of the most recently modified row of all text buffers.
+// Arguments:
+// - <none>
+// Return Value:
+// - the generation, compare it with ROW::GetGeneration()
+uint64_t ROW::s_GetLatestGeneration() noexcept
+{
+    return s_generation.load(std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Records that the given columns of the row were modified, so that the renderer
+//   invalidates them the next time it paints, see TextBuffer::ConsumeDirtyRows().
+// Arguments:
+// - left - the first modified column
+// - right - the column after the last modified column
+// Return Value:
+// - <none>
+void ROW::MarkDirty(const til::CoordType left, const til::CoordType right) noexcept
+{
+    // If the renderer has seen the previous modification already, start a new range.
+    if (!_pParent || _generation <= _pParent->GetPaintedGeneration())
+    {
+        _dirtyLeft = left;
+        _dirtyRight = right;
+    }
+    else
+    {
+        _dirtyLeft = std::min(_dirtyLeft, left);
+        _dirtyRight = std::max(_dirtyRight, right);
+    }
+    _generation = s_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void ROW::SetLineRendition(const LineRendition lineRendition) noexcept
 {
+    if (_lineRendition != lineRendition)
+    {
+        _lineRendition = lineRendition;
+        MarkDirty(0, _rowWidth);
+    }
 }
 
 // Routine Description:
@@ -40,6 +95,7 @@ bool ROW::Reset(const TextAttribute Attr)
     _wrapForced = false;
     _doubleBytePadded = false;
     _charRow.Reset();
+    MarkDirty(0, _rowWidth);
     try
     {
         _attrRow.Reset(Attr);
@@ -55,12 +111,13 @@ bool ROW::Reset(const TextAttribute Attr)
 // Routine Description:
 // - resizes ROW to new width
 // Arguments:
+// - charBuffer - the row's new slice of the text buffer's character slab
 // - width - the new width, in cells
 // Return Value:
 // - S_OK if successful, otherwise relevant error
-[[nodiscard]] HRESULT ROW::Resize(const til::CoordType width)
+[[nodiscard]] HRESULT ROW::Resize(std::byte* const charBuffer, const til::CoordType width)
 {
-    RETURN_IF_FAILED(_charRow.Resize(width));
+    RETURN_IF_FAILED(_charRow.Resize(charBuffer, width));
     try
     {
         _attrRow.Resize(width);
@@ -68,9 +125,32 @@ bool ROW::Reset(const TextAttribute Attr)
     CATCH_RETURN();
 
     _rowWidth = width;
+    MarkDirty(0, _rowWidth);
+
+    return S_OK;
+}
+
+// Routine Description:
+// - replaces the contents of this ROW with those of another ROW of the same width
+// Arguments:
+// - other - the row to copy from
+// Return Value:
+// - S_OK if successful, otherwise relevant error
+[[nodiscard]] HRESULT ROW::CopyFrom(const ROW& other)
+try
+{
+    RETURN_HR_IF(E_INVALIDARG, other._rowWidth != _rowWidth);
+
+    _attrRow = other._attrRow;
+    _charRow.CopyFrom(other._charRow);
+    _lineRendition = other._lineRendition;
+    _wrapForced = other._wrapForced;
+    _doubleBytePadded = other._doubleBytePadded;
+    MarkDirty(0, _rowWidth);
 
     return S_OK;
 }
+CATCH_RETURN();
 
 // Routine Description:
 // - clears char data in column in row
@@ -82,16 +162,84 @@ void ROW::ClearColumn(const til::CoordType column)
 {
     THROW_HR_IF(E_INVALIDARG, column >= _charRow.size());
     _charRow.ClearCell(column);
+    MarkDirty(column, column + 1);
 }
 
-UnicodeStorage& ROW::GetUnicodeStorage() noexcept
+// Routine Description:
+// - fills a range of cells with the same narrow character and/or attributes. This is
+//   the equivalent of WriteCells() with a repeating iterator and wrap set to false,
+//   but it replaces the text and the attributes in a single step each.
+// Arguments:
+// - beginIndex - the first column to fill
+// - endIndex - the column after the last one to fill
+// - wch - the character, which must not be a surrogate or full width.
+//   If it's empty, the text is kept as is.
+// - attr - the attributes of the filled cells. If it's empty, they're kept as is.
+// Return Value:
+// - <none>
+void ROW::FillCells(const til::CoordType beginIndex, const til::CoordType endIndex, const std::optional<wchar_t> wch, const std::optional<TextAttribute>& attr)
 {
-    return _pParent->GetUnicodeStorage();
+    THROW_HR_IF(E_INVALIDARG, beginIndex < 0 || beginIndex >= endIndex || endIndex > _charRow.size());
+
+    // Filling an entire row with spaces is what erasing the screen does all the time,
+    // and resetting the char row also gives up its spill storage.
+    if (beginIndex == 0 && endIndex == _rowWidth && wch == UNICODE_SPACE && attr)
+    {
+        _charRow.Reset();
+        _attrRow.Reset(*attr);
+    }
+    else
+    {
+        if (wch)
+        {
+            _charRow._FillGlyphs(beginIndex, endIndex, *wch);
+        }
+        if (attr)
+        {
+            _attrRow.Replace(beginIndex, endIndex, *attr);
+        }
+    }
+
+    // Just like in WriteCells(), only writing text affects the wrap status.
+    if (wch && endIndex == _rowWidth)
+    {
+        _wrapForced = false;
+        _doubleBytePadded = false;
+    }
+
+    MarkDirty(beginIndex, endIndex);
 }
 
-const UnicodeStorage& ROW::GetUnicodeStorage() const noexcept
+// Routine Description:
+// - moves a range of cells to the left or right within the row, including their
+//   attributes. The cells that are vacated keep their contents, since callers
+//   usually want to erase them with their own attributes afterwards.
+// Arguments:
+// - beginIndex - the first column to move
+// - endIndex - the column after the last one to move
+// - delta - the number of columns to move the cells by. Negative values move them to the left.
+// Return Value:
+// - <none>
+void ROW::ShiftCells(const til::CoordType beginIndex, const til::CoordType endIndex, const til::CoordType delta)
 {
-    return _pParent->GetUnicodeStorage();
+    THROW_HR_IF(E_INVALIDARG, beginIndex < 0 || beginIndex > endIndex || endIndex > _charRow.size());
+    THROW_HR_IF(E_INVALIDARG, beginIndex + delta < 0 || endIndex + delta > _charRow.size());
+
+    if (delta == 0 || beginIndex == endIndex)
+    {
+        return;
+    }
+
+    _charRow._MoveGlyphs(beginIndex, endIndex, beginIndex + delta);
+
+    // The runs are collected first, since the replacement may overlap with them.
+    boost::container::small_vector<ATTR_ROW::run_type, 8> runs;
+    _attrRow._data.for_each_run(gsl::narrow<uint16_t>(beginIndex), gsl::narrow<uint16_t>(endIndex), [&](const TextAttributeTable::Index index, const uint16_t length) {
+        runs.emplace_back(index, length);
+    });
+    _attrRow.ReplaceRuns(beginIndex + delta, endIndex + delta, { runs.data(), runs.size() });
+
+    MarkDirty(std::min(beginIndex, beginIndex + delta), std::max(endIndex, endIndex + delta));
 }
 
 // Routine Description:
@@ -116,6 +264,23 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType i
     auto colorStarts = gsl::narrow_cast<uint16_t>(index);
     auto currentIndex = colorStarts;
 
+    // The color runs are collected and committed into the attr row all at once at the end,
+    // since every single replacement would have to move all the runs that follow it.
+    boost::container::small_vector<ATTR_ROW::run_type, 8> colorRuns;
+    const auto commitColor = [&]() {
+        const auto value = _attrRow.Intern(currentColor);
+        const auto length = gsl::narrow_cast<uint16_t>(currentIndex - colorStarts);
+        if (!colorRuns.empty() && colorRuns.back().value == value)
+        {
+            colorRuns.back().length += length;
+        }
+        else
+        {
+            colorRuns.emplace_back(value, length);
+        }
+        colorStarts = currentIndex;
+    };
+
     while (it && currentIndex <= finalColumnInRow)
     {
         // Fill the color if the behavior isn't set to keeping the current color.
@@ -130,11 +295,9 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType i
             else
             {
                 // Otherwise, commit this color into the run and save off the new one.
-                // Now commit the new color runs into the attr row.
-                _attrRow.Replace(colorStarts, currentIndex, currentColor);
+                commitColor();
                 currentColor = it->TextAttr();
                 colorUses = 1;
-                colorStarts = currentIndex;
             }
         }
 
@@ -163,8 +326,12 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType i
             // Otherwise, copy the data given and increment the iterator.
             else
             {
-                _charRow.DbcsAttrAt(currentIndex) = it->DbcsAttr();
-                _charRow.GlyphAt(currentIndex) = it->Chars();
+                // currentIndex was already validated against the row width above,
+                // so we can write straight into the char row's arrays.
+                const auto chars = it->Chars();
+                THROW_HR_IF(E_INVALIDARG, chars.empty());
+                til::at(_charRow._dbcsAttrs, currentIndex) = it->DbcsAttr();
+                _charRow._SetGlyph(currentIndex, chars);
                 ++it;
             }
 
@@ -188,10 +355,19 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType i
         ++currentIndex;
     }
 
-    // Now commit the final color into the attr row
+    // Now commit the final color and all the runs into the attr row
     if (colorUses)
     {
-        _attrRow.Replace(colorStarts, currentIndex, currentColor);
+        commitColor();
+    }
+    if (!colorRuns.empty())
+    {
+        _attrRow.ReplaceRuns(index, colorStarts, { colorRuns.data(), colorRuns.size() });
+    }
+
+    if (currentIndex > index)
+    {
+        MarkDirty(index, currentIndex);
     }
 
     return it;
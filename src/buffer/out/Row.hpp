@@ -25,14 +25,13 @@ Revision History:
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
 #include "CharRow.hpp"
-#include "UnicodeStorage.hpp"
 
 class TextBuffer;
 
 class ROW final
 {
 public:
-    ROW(const til::CoordType rowId, const til::CoordType rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent);
+    ROW(const til::CoordType rowId, const til::CoordType rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent, std::byte* const charBuffer, const bool frozen);
 
     til::CoordType size() const noexcept { return _rowWidth; }
 
@@ -48,21 +47,42 @@ public:
     const ATTR_ROW& GetAttrRow() const noexcept { return _attrRow; }
     ATTR_ROW& GetAttrRow() noexcept { return _attrRow; }
 
+    // see CharRow::Freeze()
+    bool IsFrozen() const noexcept { return _charRow.IsFrozen(); }
+    void Freeze() { _charRow.Freeze(); }
+    std::span<const wchar_t> GetFrozenData() const noexcept { return _charRow.GetFrozenData(); }
+    void SpillFrozenData(const uint64_t handle) noexcept { _charRow.SpillFrozenData(handle); }
+    std::optional<uint64_t> GetSpillHandle() const noexcept { return _charRow.GetSpillHandle(); }
+    void Thaw() { _charRow.Thaw(); }
+    void Thaw(const wchar_t* const spilled) { _charRow.Thaw(spilled); }
+    // see TextBuffer::Serialize()
+    void AppendSnapshot(std::vector<wchar_t>& snapshot, const wchar_t* const spilled) const { _charRow.AppendSnapshot(snapshot, spilled); }
+    bool RestoreSnapshot(const std::span<const wchar_t> snapshot) { return _charRow.RestoreSnapshot(snapshot); }
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+    const std::byte* GetCharBuffer() const noexcept { return reinterpret_cast<const std::byte*>(_charRow._charsBuffer); }
+
     LineRendition GetLineRendition() const noexcept { return _lineRendition; }
-    void SetLineRendition(const LineRendition lineRendition) noexcept { _lineRendition = lineRendition; }
+    void SetLineRendition(const LineRendition lineRendition) noexcept;
 
     til::CoordType GetId() const noexcept { return _id; }
     void SetId(const til::CoordType id) noexcept { _id = id; }
 
+    // see TextBuffer::ConsumeDirtyRows()
+    uint64_t GetGeneration() const noexcept { return _generation; }
+    til::CoordType GetDirtyLeft() const noexcept { return _dirtyLeft; }
+    til::CoordType GetDirtyRight() const noexcept { return _dirtyRight; }
+    void MarkDirty(const til::CoordType left, const til::CoordType right) noexcept;
+    static uint64_t s_GetLatestGeneration() noexcept;
+
     bool Reset(const TextAttribute Attr);
-    [[nodiscard]] HRESULT Resize(const til::CoordType width);
+    [[nodiscard]] HRESULT Resize(std::byte* const charBuffer, const til::CoordType width);
+    [[nodiscard]] HRESULT CopyFrom(const ROW& other);
 
     void ClearColumn(const til::CoordType column);
     std::wstring GetText() const { return _charRow.GetText(); }
 
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-
+    void FillCells(const til::CoordType beginIndex, const til::CoordType endIndex, const std::optional<wchar_t> wch, const std::optional<TextAttribute>& attr);
+    void ShiftCells(const til::CoordType beginIndex, const til::CoordType endIndex, const til::CoordType delta);
     OutputCellIterator WriteCells(OutputCellIterator it, const til::CoordType index, const std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
 
 #ifdef UNIT_TESTING
@@ -76,6 +96,11 @@ private:
     LineRendition _lineRendition;
     til::CoordType _id;
     til::CoordType _rowWidth;
+    // The value of the generation counter when the row was last modified and
+    // the columns [_dirtyLeft, _dirtyRight) modified since it was last painted.
+    uint64_t _generation;
+    til::CoordType _dirtyLeft;
+    til::CoordType _dirtyRight;
     // Occurs when the user runs out of text in a given row and we're forced to wrap the cursor to the next line
     bool _wrapForced;
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ScrollbackSpill.hpp"
+
+// Routine Description:
+// - constructor. Creates the temporary file, which is deleted once it's closed.
+// Arguments:
+// - <none>
+// Return Value:
+// - instantiated object
+// Note: will throw exception if the file can't be created
+ScrollbackSpill::ScrollbackSpill() :
+    _end{ 0 }
+{
+    wchar_t directory[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(GetTempPathW(ARRAYSIZE(directory), &directory[0]) == 0);
+
+    wchar_t path[MAX_PATH];
+    THROW_LAST_ERROR_IF(GetTempFileNameW(&directory[0], L"wt", 0, &path[0]) == 0);
+
+    // Nobody else gets to open the file and it's deleted once our handle is closed, even if we crash.
+    _file.reset(CreateFileW(&path[0], GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+}
+
+// Routine Description:
+// - copies the given data into a block of the file
+// Arguments:
+// - data - the data to store
+// Return Value:
+// - a handle to the block holding the data, or nullopt if the data is too large to be stored.
+std::optional<ScrollbackSpill::Handle> ScrollbackSpill::Store(const std::span<const wchar_t> data)
+{
+    const auto bytes = data.size_bytes();
+    size_t sizeClass = 0;
+    while ((MinBlockSize << sizeClass) < bytes)
+    {
+        if (++sizeClass == SizeClassCount)
+        {
+            return std::nullopt;
+        }
+    }
+
+    const uint64_t blockSize = MinBlockSize << sizeClass;
+    auto& freeBlocks = til::at(_freeBlocks, sizeClass);
+    uint64_t offset;
+
+    if (!freeBlocks.empty())
+    {
+        offset = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+    else
+    {
+        // Blocks are aligned to their size, which ensures that they never straddle two segments.
+        offset = (_end + blockSize - 1) & ~(blockSize - 1);
+        if (offset + blockSize > _segments.size() * SegmentSize)
+        {
+            _AddSegment();
+        }
+        _end = offset + blockSize;
+    }
+
+    memcpy(_GetAddress(offset), data.data(), bytes);
+    return offset | sizeClass;
+}
+
+// Routine Description:
+// - gets the data stored in the given block. Reading it pages it in from the file if necessary.
+// Arguments:
+// - handle - a handle returned by Store()
+// Return Value:
+// - the data in the block. Valid until Release() is called with the handle.
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+const wchar_t* ScrollbackSpill::Load(const Handle handle) const noexcept
+{
+    return reinterpret_cast<const wchar_t*>(_GetAddress(handle & ~SizeClassMask));
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - marks the given block as unused, so that Store() can reuse it
+// Arguments:
+// - handle - a handle returned by Store()
+void ScrollbackSpill::Release(const Handle handle) noexcept
+try
+{
+    const auto sizeClass = gsl::narrow_cast<size_t>(handle & SizeClassMask);
+    til::at(_freeBlocks, sizeClass).emplace_back(handle & ~SizeClassMask);
+}
+// If we run out of memory here the block is simply never reused.
+CATCH_LOG()
+
+// Routine Description:
+// - gets the address of the given offset into the file in our views of it
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+std::byte* ScrollbackSpill::_GetAddress(const uint64_t offset) const noexcept
+{
+    const auto& segment = til::at(_segments, gsl::narrow_cast<size_t>(offset / SegmentSize));
+    return segment.view.get() + offset % SegmentSize;
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - grows the file by another segment and maps it
+void ScrollbackSpill::_AddSegment()
+{
+    const auto offset = uint64_t{ _segments.size() } * SegmentSize;
+    const auto end = offset + SegmentSize;
+
+    // Creating a mapping larger than the file extends the file.
+    Segment segment;
+    segment.mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READWRITE, gsl::narrow_cast<DWORD>(end >> 32), gsl::narrow_cast<DWORD>(end), nullptr));
+    THROW_LAST_ERROR_IF(!segment.mapping);
+    segment.view.reset(static_cast<std::byte*>(MapViewOfFile(segment.mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, gsl::narrow_cast<DWORD>(offset >> 32), gsl::narrow_cast<DWORD>(offset), SegmentSize)));
+    THROW_LAST_ERROR_IF(!segment.view);
+
+    _segments.emplace_back(std::move(segment));
+}
@@ -0,0 +1,51 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollbackSpill.hpp
+
+Abstract:
+- A store for the contents of frozen rows (see CharRow::Freeze) that lives in
+  a memory-mapped temporary file instead of the heap. This bounds the memory
+  a large scrollback needs to the rows near the output: thawing a spilled row
+  pages its contents back in, but doesn't allocate anything.
+- The file is split into segments of SegmentSize bytes which are mapped as
+  they're needed. Within them, contents are stored in blocks whose size is a
+  power of two, and each block size has its own list of released blocks.
+--*/
+
+#pragma once
+
+class ScrollbackSpill final
+{
+public:
+    // Identifies a block in the file. The low bits hold the block's size class.
+    using Handle = uint64_t;
+
+    ScrollbackSpill();
+
+    std::optional<Handle> Store(const std::span<const wchar_t> data);
+    const wchar_t* Load(const Handle handle) const noexcept;
+    void Release(const Handle handle) noexcept;
+
+private:
+    static constexpr size_t MinBlockSize = 64;
+    static constexpr size_t SizeClassCount = 12; // up to 128 KiB, see CharRow::Freeze for what's stored
+    static constexpr size_t SegmentSize = 4 * 1024 * 1024;
+    static constexpr uint64_t SizeClassMask = MinBlockSize - 1;
+
+    struct Segment
+    {
+        wil::unique_handle mapping;
+        wil::unique_mapview_ptr<std::byte> view;
+    };
+
+    std::byte* _GetAddress(const uint64_t offset) const noexcept;
+    void _AddSegment();
+
+    wil::unique_hfile _file;
+    std::vector<Segment> _segments;
+    std::array<std::vector<uint64_t>, SizeClassCount> _freeBlocks;
+    uint64_t _end;
+};
@@ -0,0 +1,93 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SnapshotStream.hpp
+
+Abstract:
+- Helpers for writing and reading the binary snapshots of a buffer that are
+  persisted across restarts (see TextBuffer::Serialize). Values are stored as
+  their raw bytes, arrays are prefixed with their length. Since snapshots are
+  read back from disk, the reader bounds checks everything and fails instead.
+--*/
+
+#pragma once
+
+class SnapshotWriter final
+{
+public:
+    explicit SnapshotWriter(std::vector<std::byte>& data) noexcept :
+        _data{ data }
+    {
+    }
+
+    template<typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto bytes = std::as_bytes(std::span{ &value, 1 });
+        _data.insert(_data.end(), bytes.begin(), bytes.end());
+    }
+
+    template<typename T>
+    void WriteArray(const std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(gsl::narrow<uint32_t>(values.size()));
+        const auto bytes = std::as_bytes(values);
+        _data.insert(_data.end(), bytes.begin(), bytes.end());
+    }
+
+private:
+    std::vector<std::byte>& _data;
+};
+
+class SnapshotReader final
+{
+public:
+    explicit SnapshotReader(const std::span<const std::byte> data) noexcept :
+        _data{ data }
+    {
+    }
+
+    template<typename T>
+    bool Read(T& value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (_data.size() < sizeof(T))
+        {
+            return false;
+        }
+        memcpy(&value, _data.data(), sizeof(T));
+        _data = _data.subspan(sizeof(T));
+        return true;
+    }
+
+    // The values are copied out, since the data generally isn't aligned to T.
+    template<typename T>
+    bool ReadArray(std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint32_t count = 0;
+        if (!Read(count) || _data.size() / sizeof(T) < count)
+        {
+            return false;
+        }
+        values.resize(count);
+        if (count != 0)
+        {
+            memcpy(values.data(), _data.data(), count * sizeof(T));
+        }
+        _data = _data.subspan(count * sizeof(T));
+        return true;
+    }
+
+    std::span<const std::byte> Remaining() const noexcept
+    {
+        return _data;
+    }
+
+private:
+    std::span<const std::byte> _data;
+};
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "TextAttributeTable.hpp"
+
+// Routine Description:
+// - returns the index of the given attribute, adding it to the table if it isn't there yet.
+// Arguments:
+// - attr - the attribute to look up
+// Return Value:
+// - the index of the attribute. If the table is full, the index of the last attribute returned,
+//   so that the text is shown like the text before it until the buffer compacts the table.
+// Note: will throw exception if the table can't grow
+TextAttributeTable::Index TextAttributeTable::Intern(const TextAttribute& attr)
+{
+    if (_lastIndex && Get(*_lastIndex) == attr)
+    {
+        return *_lastIndex;
+    }
+
+    if (const auto it = _indices.find(attr); it != _indices.end())
+    {
+        _lastIndex = it->second;
+        return it->second;
+    }
+
+    if (_attributes.size() == Capacity)
+    {
+        ++_overflowCount;
+        return _lastIndex.value_or(0);
+    }
+
+    const auto index = gsl::narrow_cast<Index>(_attributes.size());
+    _attributes.emplace_back(attr);
+    _indices.emplace(attr, index);
+    _lastIndex = index;
+    return index;
+}
+
+// Routine Description:
+// - returns the index of the given attribute, if it's in the table.
+// Arguments:
+// - attr - the attribute to look up
+// Return Value:
+// - the index of the attribute, or nullopt if no row can be using it.
+std::optional<TextAttributeTable::Index> TextAttributeTable::Find(const TextAttribute& attr) const noexcept
+{
+    const auto it = _indices.find(attr);
+    if (it == _indices.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+// Routine Description:
+// - drops the attributes that aren't used anymore and moves the rest to the front of the table.
+// Arguments:
+// - used - for each index in the table, whether a row still refers to it
+// Return Value:
+// - for each index in the table, the index the attribute moved to. Callers must replace
+//   the indices they hold with these before they look anything up in the table again.
+std::vector<TextAttributeTable::Index> TextAttributeTable::Compact(const std::vector<bool>& used)
+{
+    std::vector<Index> remap(_attributes.size());
+    std::vector<TextAttribute> attributes;
+    _indices.clear();
+
+    for (size_t i = 0; i < _attributes.size(); ++i)
+    {
+        if (i < used.size() && used[i])
+        {
+            const auto index = gsl::narrow_cast<Index>(attributes.size());
+            attributes.emplace_back(til::at(_attributes, i));
+            _indices.emplace(attributes.back(), index);
+            til::at(remap, i) = index;
+        }
+    }
+
+    _attributes = std::move(attributes);
+    _lastIndex.reset();
+    _overflowCount = 0;
+
+    // Leave room for half of the remaining capacity before compacting again, so that the cost of
+    // compacting is spread out over the attributes added. If that's too little room, only
+    // overflowing the table can trigger the next compaction (see OverflowsBeforeCompaction).
+    const auto live = _attributes.size();
+    _compactionThreshold = live + std::max((Capacity - live) / 2, OverflowsBeforeCompaction);
+    return remap;
+}
+
+// Routine Description:
+// - records that another row uses the given hyperlink ID. See ATTR_ROW::_UpdateHyperlinks.
+// Arguments:
+// - id - the hyperlink ID
+// Note: will throw exception if the ID is new and the map can't grow
+void TextAttributeTable::AddHyperlinkReference(const uint16_t id)
+{
+    ++_hyperlinkReferences[id];
+}
+
+// Routine Description:
+// - records that a row stopped using the given hyperlink ID.
+// Arguments:
+// - id - the hyperlink ID, which must have been passed to AddHyperlinkReference before
+void TextAttributeTable::ReleaseHyperlinkReference(const uint16_t id) noexcept
+{
+    if (const auto it = _hyperlinkReferences.find(id); it != _hyperlinkReferences.end() && --it->second == 0)
+    {
+        _hyperlinkReferences.erase(it);
+    }
+}
+
+// Routine Description:
+// - returns the number of rows using the given hyperlink ID.
+// Arguments:
+// - id - the hyperlink ID
+// Return Value:
+// - the number of rows, 0 if no row uses the ID
+uint32_t TextAttributeTable::HyperlinkReferences(const uint16_t id) const noexcept
+{
+    const auto it = _hyperlinkReferences.find(id);
+    return it != _hyperlinkReferences.end() ? it->second : 0;
+}
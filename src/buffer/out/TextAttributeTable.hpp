@@ -0,0 +1,81 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeTable.hpp
+
+Abstract:
+- The distinct attributes used in a text buffer. Rows store indices into it
+  instead of whole TextAttributes (see ATTR_ROW), as most of a buffer shares
+  a handful of attributes.
+- Indices are never reused on their own, since the table doesn't know which
+  of them are still referenced. Instead the buffer calls Compact() with the
+  indices its rows use, once NeedsCompaction() says the table is filling up.
+- It also counts the rows that use each hyperlink ID, so that the buffer can tell
+  whether a row that scrolls out holds the last reference to a hyperlink.
+--*/
+
+#pragma once
+
+#include <til/hash.h>
+
+#include "TextAttribute.hpp"
+
+class TextAttributeTable final
+{
+public:
+    using Index = uint16_t;
+    static constexpr size_t Capacity = size_t{ std::numeric_limits<Index>::max() } + 1;
+
+    TextAttributeTable() noexcept = default;
+
+    Index Intern(const TextAttribute& attr);
+    std::optional<Index> Find(const TextAttribute& attr) const noexcept;
+
+    // Returns the attribute stored at the given index. The reference is valid until the next call to Intern().
+    const TextAttribute& Get(const Index index) const noexcept
+    {
+        return til::at(_attributes, index);
+    }
+
+    size_t size() const noexcept
+    {
+        return _attributes.size();
+    }
+
+    bool NeedsCompaction() const noexcept
+    {
+        return _attributes.size() >= _compactionThreshold || _overflowCount >= OverflowsBeforeCompaction;
+    }
+
+    std::vector<Index> Compact(const std::vector<bool>& used);
+
+    void AddHyperlinkReference(const uint16_t id);
+    void ReleaseHyperlinkReference(const uint16_t id) noexcept;
+    uint32_t HyperlinkReferences(const uint16_t id) const noexcept;
+
+private:
+    // Once the table is full, this many attributes get approximated before it's compacted again.
+    static constexpr size_t OverflowsBeforeCompaction = Capacity / 16;
+
+    struct AttributeHash
+    {
+        size_t operator()(const TextAttribute& attr) const noexcept
+        {
+            return til::hasher{}.write(static_cast<const void*>(&attr), sizeof(attr)).finalize();
+        }
+    };
+
+    std::vector<TextAttribute> _attributes;
+    std::unordered_map<TextAttribute, Index, AttributeHash> _indices;
+
+    // Rows are mostly written with the same attribute over and over, which skips the hash lookup.
+    std::optional<Index> _lastIndex;
+
+    size_t _compactionThreshold = Capacity * 3 / 4;
+    size_t _overflowCount = 0;
+
+    // The number of rows using each hyperlink ID. IDs that no row uses aren't stored.
+    std::unordered_map<uint16_t, uint32_t> _hyperlinkReferences;
+};
@@ -7,6 +7,7 @@
 
 #include "CharRow.hpp"
 #include "textBuffer.hpp"
+#include "../types/inc/GraphemeBreak.hpp"
 #include "../types/inc/Utf16Parser.hpp"
 #include "../types/inc/GlyphWidth.hpp"
 
@@ -22,17 +23,21 @@ using namespace Microsoft::Console::Types;
 // - str - The search term you want to find (the "needle")
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
+// - mode - Whether str is plain text or a regular expression, see RegexMatcher.
+//   An invalid regular expression doesn't match anything, see IsValid().
 Search::Search(IUiaData& uiaData,
                const std::wstring& str,
                const Direction direction,
-               const Sensitivity sensitivity) :
+               const Sensitivity sensitivity,
+               const Mode mode) :
     _direction(direction),
     _sensitivity(sensitivity),
-    _needle(s_CreateNeedleFromString(str)),
+    _needle(mode == Mode::Regex ? str : s_CreateNeedleFromString(str, sensitivity)),
+    _regex(mode == Mode::Regex ? RegexMatcher::Compile(str, sensitivity == Sensitivity::CaseInsensitive) : std::nullopt),
+    _mode(mode),
     _uiaData(uiaData),
     _coordAnchor(s_GetInitialAnchor(uiaData, direction))
 {
-    _coordNext = _coordAnchor;
 }
 
 // Routine Description:
@@ -53,15 +58,17 @@ Search::Search(IUiaData& uiaData,
                const til::point anchor) :
     _direction(direction),
     _sensitivity(sensitivity),
-    _needle(s_CreateNeedleFromString(str)),
+    _needle(s_CreateNeedleFromString(str, sensitivity)),
+    _mode(Mode::PlainText),
     _coordAnchor(anchor),
     _uiaData(uiaData)
 {
-    _coordNext = _coordAnchor;
 }
 
 // Routine Description
 // - Locates the next instance of the search term within the screen buffer.
+// - All instances that haven't been located by FindMatchesInNextRows() yet
+//   are located on the first call, after which this merely steps through them.
 // Arguments:
 // - <none> - Uses internal state from constructor
 // Return Value:
@@ -69,28 +76,32 @@ Search::Search(IUiaData& uiaData,
 // - NOTE: You can FindNext() again after False to go around the buffer again.
 bool Search::FindNext()
 {
-    if (_reachedEnd)
+    const auto& matches = GetAllMatches();
+    const auto count = matches.size();
+
+    if (_matchesVisited == count)
     {
-        _reachedEnd = false;
+        _matchesVisited = 0;
+        _currentMatch.reset();
         return false;
     }
 
-    do
+    if (!_currentMatch.has_value())
     {
-        if (_FindNeedleInHaystackAt(_coordNext, _coordSelStart, _coordSelEnd))
-        {
-            _UpdateNextPosition();
-            _reachedEnd = _coordNext == _coordAnchor;
-            return true;
-        }
-        else
-        {
-            _UpdateNextPosition();
-        }
-
-    } while (_coordNext != _coordAnchor);
+        _currentMatch = _GetFirstMatchIndex();
+    }
+    else if (_direction == Direction::Forward)
+    {
+        _currentMatch = (*_currentMatch + 1) % count;
+    }
+    else
+    {
+        _currentMatch = (*_currentMatch + count - 1) % count;
+    }
 
-    return false;
+    std::tie(_coordSelStart, _coordSelEnd) = til::at(matches, *_currentMatch);
+    ++_matchesVisited;
+    return true;
 }
 
 // Routine Description:
@@ -129,6 +140,25 @@ std::pair<til::point, til::point> Search::GetFoundLocation() const noexcept
     return { _coordSelStart, _coordSelEnd };
 }
 
+// Routine Description:
+// - gets the start and end positions of all instances of the search term in the buffer
+// Return Value:
+// - the [start, end] coord positions of every instance, sorted by their start
+const std::vector<std::pair<til::point, til::point>>& Search::GetAllMatches()
+{
+    FindMatchesInNextRows(std::numeric_limits<til::CoordType>::max());
+    return _matches;
+}
+
+// Routine Description:
+// - gets the index of the instance found by the last call to FindNext() in GetAllMatches()
+// Return Value:
+// - the index, or nullopt if FindNext() hasn't found anything (yet)
+std::optional<size_t> Search::GetCurrentMatchIndex() const noexcept
+{
+    return _currentMatch;
+}
+
 // Routine Description:
 // - Finds the anchor position where we will start searches from.
 // - This position will represent the "wrap around" point in the buffer or where
@@ -178,149 +208,298 @@ til::point Search::s_GetInitialAnchor(const IUiaData& uiaData, const Direction d
 }
 
 // Routine Description:
-// - Attempts to compare the search term (the needle) to the screen buffer (the haystack)
-//   at the given coordinate position of the screen buffer.
-// - Performs one comparison. Call again with new positions to check other spots.
+// - Finds the instances of the search term (the needle) in the next batch of
+//   rows of the screen buffer (the haystack), which haven't been searched yet.
+// - This allows callers to search the buffer piece by piece, so that they
+//   don't need to hold on to the buffer for the entire search. Rows that have
+//   been searched already aren't searched again if the buffer changes.
+// - Rather than comparing the needle cell by cell, the text of each line is
+//   searched as a whole. A line is a row plus all the rows it wrapped into, so
+//   that instances that got wrapped are found as well.
+// - In Mode::Regex the line's text leaves out the trailing halves of wide glyphs,
+//   so that the pattern sees each glyph once. Matches don't overlap then.
 // Arguments:
-// - pos - The position in the haystack (screen buffer) to compare
-// - start - If we found it, this is filled with the coordinate of the first character of the needle.
-// - end - If we found it, this is filled with the coordinate of the last character of the needle.
+// - rowCount - the number of rows to search. The batch is extended to the end
+//   of its last line, if that line wrapped.
 // Return Value:
-// - True if we found it. False if not.
-bool Search::_FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const
+// - True if the entire buffer has been searched. False otherwise.
+bool Search::FindMatchesInNextRows(const til::CoordType rowCount)
 {
-    start = {};
-    end = {};
+    if (_allMatchesFound)
+    {
+        return true;
+    }
 
-    auto bufferPos = pos;
+    std::optional<std::boyer_moore_horspool_searcher<std::wstring::const_iterator>> searcher;
+    if (_mode == Mode::PlainText && _needle.size() >= _boyerMooreMinLength)
+    {
+        searcher.emplace(_needle.cbegin(), _needle.cend());
+    }
+
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    const auto lastRow = _uiaData.GetTextBufferEndPosition().Y;
 
-    for (const auto& needleCell : _needle)
+    std::wstring line;
+    // The offset of each row's text in line and the row it belongs to.
+    std::vector<std::pair<size_t, til::CoordType>> lineRows;
+    std::vector<std::pair<size_t, size_t>> regexMatches;
+
+    auto y = _nextRow;
+    for (; IsValid() && y <= lastRow; ++y)
     {
-        // Haystack is the buffer. Needle is the string we were given.
-        const auto hayIter = _uiaData.GetTextBuffer().GetTextDataAt(bufferPos);
-        const auto hayChars = *hayIter;
-        const auto needleChars = std::wstring_view(needleCell.data(), needleCell.size());
+        const auto& row = textBuffer.GetRowByOffset(y);
+        const auto& charRow = row.GetCharRow();
+        const auto wrapped = row.WasWrapForced() && y < lastRow;
+
+        // Leave out the padding that pushed a wide glyph into the next row.
+        const auto columns = wrapped && row.WasDoubleBytePadded() ? charRow.size() - 1 : charRow.size();
 
-        // If we didn't match at any point of the needle, return false.
-        if (!_CompareChars(hayChars, needleChars))
+        lineRows.emplace_back(line.size(), y);
+        if (_regex)
         {
-            return false;
+            s_AppendRowText(line, charRow, columns);
+        }
+        else
+        {
+            line.append(charRow.GetChars().substr(0, charRow.GetCharOffset(columns)));
         }
 
-        _IncrementCoord(bufferPos);
+        if (wrapped)
+        {
+            continue;
+        }
+
+        if (_regex)
+        {
+            // The matcher ignores case by itself, since folding
+            // the text would break classes like [A-Z].
+            regexMatches.clear();
+            _regex->FindAll(line, regexMatches);
+            for (const auto& [begin, end] : regexMatches)
+            {
+                til::point start;
+                til::point last;
+                // Empty matches can't be selected.
+                if (begin != end && _TryGetRegexCellAt(lineRows, begin, false, start) && _TryGetRegexCellAt(lineRows, end, true, last))
+                {
+                    _matches.emplace_back(start, last);
+                }
+            }
+        }
+        else
+        {
+            s_ApplySensitivity(line, _sensitivity);
+
+            // Instances may overlap, so the next one is searched for right after the start of the previous one.
+            for (size_t pos = 0; pos < line.size(); ++pos)
+            {
+                if (searcher.has_value())
+                {
+                    pos = gsl::narrow_cast<size_t>(std::search(line.cbegin() + pos, line.cend(), *searcher) - line.cbegin());
+                }
+                else
+                {
+                    pos = std::wstring_view{ line }.find(_needle, pos);
+                }
+
+                if (pos >= line.size())
+                {
+                    break;
+                }
+
+                til::point start;
+                til::point end;
+                if (_TryGetCellAt(lineRows, pos, false, start) && _TryGetCellAt(lineRows, pos + _needle.size(), true, end))
+                {
+                    _matches.emplace_back(start, end);
+                }
+            }
+        }
+
+        line.clear();
+        lineRows.clear();
+
+        if (y + 1 - _nextRow >= rowCount)
+        {
+            ++y;
+            break;
+        }
     }
 
-    _DecrementCoord(bufferPos);
+    _nextRow = y;
+    _allMatchesFound = _nextRow > lastRow || !IsValid();
+    return _allMatchesFound;
+}
 
-    // If we made it the whole way through the needle, then it was in the haystack.
-    // Fill out the span that we found the result at and return true.
-    start = pos;
-    end = bufferPos;
+// Routine Description:
+// - gets the number of instances of the search term found so far, see FindMatchesInNextRows()
+// Return Value:
+// - the number of instances
+size_t Search::GetMatchCount() const noexcept
+{
+    return _matches.size();
+}
 
-    return true;
+// Routine Description:
+// - Checks whether there's anything to search for.
+// Return Value:
+// - False if the search term is empty or, in Mode::Regex, isn't a supported regular expression.
+bool Search::IsValid() const noexcept
+{
+    return !_needle.empty() && (_mode == Mode::PlainText || _regex.has_value());
 }
 
 // Routine Description:
-// - Provides an abstraction for comparing two spans of text.
-// - Internally handles case sensitivity based on object construction.
+// - Converts an offset into the text of a line into the buffer position of its cell.
+// - The cell must be the first (or last) of a glyph, since the needle's cells
+//   always hold whole glyphs. It can't be the trailing half of a wide glyph
+//   either, as that repeats the leading half.
 // Arguments:
-// - one - String view representing the first string of text
-// - two - String view representing the second string of text
+// - lineRows - the offsets of the rows of the line, see FindMatchesInNextRows()
+// - offset - the offset of the first code unit of the instance, or if isEnd
+//   is set, the offset past its last code unit
+// - isEnd - whether the position of the last cell of the instance is requested
+// - cell - receives the position of the cell
 // Return Value:
-// - True if they are the same. False otherwise.
-bool Search::_CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept
+// - True if the offset is at a boundary of a glyph. False if not.
+bool Search::_TryGetCellAt(const std::vector<std::pair<size_t, til::CoordType>>& lineRows,
+                           const size_t offset,
+                           const bool isEnd,
+                           til::point& cell) const
 {
-    if (one.size() != two.size())
-    {
-        return false;
-    }
+    const auto unit = isEnd ? offset - 1 : offset;
+    const auto rowIt = std::prev(std::upper_bound(lineRows.begin(), lineRows.end(), unit, [](const size_t value, const auto& lineRow) {
+        return value < lineRow.first;
+    }));
+    const auto local = unit - rowIt->first;
+
+    const auto& charRow = _uiaData.GetTextBuffer().GetRowByOffset(rowIt->second).GetCharRow();
+    const auto column = charRow.GetColumnAtCharOffset(local);
 
-    for (size_t i = 0; i < one.size(); i++)
+    if (isEnd)
     {
-        if (_ApplySensitivity(one.at(i)) != _ApplySensitivity(two.at(i)))
+        if (charRow.GetCharOffset(column + 1) != local + 1)
         {
             return false;
         }
     }
+    else if (charRow.GetCharOffset(column) != local || charRow.DbcsAttrAt(column).IsTrailing())
+    {
+        return false;
+    }
 
+    cell = { column, rowIt->second };
     return true;
 }
 
 // Routine Description:
-// - Provides an abstraction for conditionally applying case sensitivity
-//   based on object construction
+// - Like _TryGetCellAt, but for the text of a line in Mode::Regex, which doesn't
+//   hold the trailing halves of wide glyphs (see s_AppendRowText). The last cell
+//   of a wide glyph is its trailing half.
 // Arguments:
-// - wch - Character to adjust if necessary
+// - lineRows - the offsets of the rows of the line, see FindMatchesInNextRows()
+// - offset - the offset of the first code unit of the match, or if isEnd
+//   is set, the offset past its last code unit
+// - isEnd - whether the position of the last cell of the match is requested
+// - cell - receives the position of the cell
 // Return Value:
-// - Adjusted value (or not).
-wchar_t Search::_ApplySensitivity(const wchar_t wch) const noexcept
+// - True if the offset is at a boundary of a glyph. False if not.
+bool Search::_TryGetRegexCellAt(const std::vector<std::pair<size_t, til::CoordType>>& lineRows,
+                                const size_t offset,
+                                const bool isEnd,
+                                til::point& cell) const
 {
-    if (_sensitivity == Sensitivity::CaseInsensitive)
+    const auto unit = isEnd ? offset - 1 : offset;
+    const auto rowIt = std::prev(std::upper_bound(lineRows.begin(), lineRows.end(), unit, [](const size_t value, const auto& lineRow) {
+        return value < lineRow.first;
+    }));
+    const auto local = unit - rowIt->first;
+
+    const auto& charRow = _uiaData.GetTextBuffer().GetRowByOffset(rowIt->second).GetCharRow();
+    size_t glyphOffset = 0;
+    for (til::CoordType column = 0; column < charRow.size(); ++column)
     {
-        return ::towlower(wch);
-    }
-    else
-    {
-        return wch;
-    }
-}
+        const auto attr = charRow.DbcsAttrAt(column);
+        if (attr.IsTrailing())
+        {
+            continue;
+        }
 
-// Routine Description:
-// - Helper to increment a coordinate in respect to the associated screen buffer
-// Arguments
-// - coord - Updated by function to increment one position (will wrap X and Y direction)
-void Search::_IncrementCoord(til::point& coord) const noexcept
-{
-    _uiaData.GetTextBuffer().GetSize().IncrementInBoundsCircular(coord);
-}
+        const auto glyphEnd = glyphOffset + charRow.GetCharOffset(column + 1) - charRow.GetCharOffset(column);
+        if (local < glyphEnd)
+        {
+            if (isEnd ? local + 1 != glyphEnd : local != glyphOffset)
+            {
+                return false;
+            }
+            cell = { isEnd && attr.IsLeading() ? column + 1 : column, rowIt->second };
+            return true;
+        }
+        glyphOffset = glyphEnd;
+    }
 
-// Routine Description:
-// - Helper to decrement a coordinate in respect to the associated screen buffer
-// Arguments
-// - coord - Updated by function to decrement one position (will wrap X and Y direction)
-void Search::_DecrementCoord(til::point& coord) const noexcept
-{
-    _uiaData.GetTextBuffer().GetSize().DecrementInBoundsCircular(coord);
+    return false;
 }
 
 // Routine Description:
-// - Helper to update the coordinate position to the next point to be searched
+// - Finds the instance FindNext() starts at: the first one at or past the
+//   anchor in the direction of the search, wrapping around the buffer if needed.
 // Return Value:
-// - True if we haven't reached the end of the buffer. False otherwise.
-void Search::_UpdateNextPosition()
+// - the index of the instance in GetAllMatches(). Must not be empty.
+size_t Search::_GetFirstMatchIndex() const noexcept
 {
+    const auto& matches = _matches;
+
     if (_direction == Direction::Forward)
     {
-        _IncrementCoord(_coordNext);
-    }
-    else if (_direction == Direction::Backward)
-    {
-        _DecrementCoord(_coordNext);
+        const auto it = std::lower_bound(matches.begin(), matches.end(), _coordAnchor, [](const auto& match, const til::point anchor) {
+            return match.first < anchor;
+        });
+        return it == matches.end() ? 0 : gsl::narrow_cast<size_t>(it - matches.begin());
     }
     else
     {
-        THROW_HR(E_NOTIMPL);
+        const auto it = std::upper_bound(matches.begin(), matches.end(), _coordAnchor, [](const til::point anchor, const auto& match) {
+            return anchor < match.first;
+        });
+        return it == matches.begin() ? matches.size() - 1 : gsl::narrow_cast<size_t>(it - matches.begin() - 1);
     }
+}
 
-    // To reduce wrap-around time, if the next position is larger than
-    // the end position of the written text
-    // We put the next position to:
-    // Forward: (0, 0)
-    // Backward: the position of the end of the text buffer
-    const auto bufferEndPosition = _uiaData.GetTextBufferEndPosition();
+// Routine Description:
+// - Provides an abstraction for conditionally applying case sensitivity
+//   based on object construction
+// Arguments:
+// - str - Text to adjust if necessary
+// - sensitivity - Whether or not we care about case
+void Search::s_ApplySensitivity(std::wstring& str, const Sensitivity sensitivity) noexcept
+{
+    if (sensitivity == Sensitivity::CaseInsensitive)
+    {
+        std::transform(str.begin(), str.end(), str.begin(), ::towlower);
+    }
+}
 
-    if (_coordNext.Y > bufferEndPosition.Y ||
-        (_coordNext.Y == bufferEndPosition.Y && _coordNext.X > bufferEndPosition.X))
+// Routine Description:
+// - Appends the text of a row to a line for Mode::Regex. Unlike CharRow::GetChars()
+//   it holds each wide glyph once, by leaving out their trailing halves.
+// Arguments:
+// - line - the text of the line to append to
+// - charRow - the row
+// - columns - the number of columns of the row to append
+void Search::s_AppendRowText(std::wstring& line, const CharRow& charRow, const til::CoordType columns)
+{
+    const auto chars = charRow.GetChars();
+    size_t runStart = 0;
+    for (til::CoordType column = 0; column < columns; ++column)
     {
-        if (_direction == Direction::Forward)
+        if (charRow.DbcsAttrAt(column).IsTrailing())
         {
-            _coordNext = {};
-        }
-        else
-        {
-            _coordNext = bufferEndPosition;
+            line.append(chars.substr(runStart, charRow.GetCharOffset(column) - runStart));
+            runStart = charRow.GetCharOffset(column + 1);
         }
     }
+    line.append(chars.substr(runStart, charRow.GetCharOffset(columns) - runStart));
 }
 
 // Routine Description:
@@ -328,19 +507,43 @@ void Search::_UpdateNextPosition()
 //   that we can use for our search
 // Arguments:
 // - wstr - String that will be our search term
+// - sensitivity - Whether or not we care about case
 // Return Value:
-// - Structured text data for comparison to screen buffer text data.
-std::vector<std::vector<wchar_t>> Search::s_CreateNeedleFromString(const std::wstring& wstr)
+// - The text of the cells the search term would occupy in the buffer.
+//   Wide glyphs occupy two cells, which both hold the glyph.
+std::wstring Search::s_CreateNeedleFromString(const std::wstring& wstr, const Sensitivity sensitivity)
+{
+    std::wstring needle;
+    needle.reserve(wstr.size());
+
+    // The needle has to be split into glyphs the same way OutputCellIterator splits text into cells.
+    if constexpr (Feature_GraphemeClusterSegmentation::IsEnabled())
+    {
+        s_AppendCells<&GraphemeBreak::ParseNextCluster>(needle, wstr);
+    }
+    else
+    {
+        s_AppendCells<&Utf16Parser::ParseNext>(needle, wstr);
+    }
+
+    s_ApplySensitivity(needle, sensitivity);
+    return needle;
+}
+
+// Routine Description:
+// - Appends the text of the cells the given text occupies in the buffer to the needle.
+// Arguments:
+// - needle - The needle to append to
+// - wstr - The text to append
+template<std::wstring_view (*ParseNextGlyph)(std::wstring_view) noexcept>
+void Search::s_AppendCells(std::wstring& needle, const std::wstring_view wstr)
 {
-    const auto charData = Utf16Parser::Parse(wstr);
-    std::vector<std::vector<wchar_t>> cells;
-    for (const auto chars : charData)
+    for (const auto glyph : Utf16Parser::Range<ParseNextGlyph>{ wstr })
     {
-        if (IsGlyphFullWidth(std::wstring_view{ chars.data(), chars.size() }))
+        if (IsGlyphFullWidth(glyph))
         {
-            cells.emplace_back(chars);
+            needle.append(glyph);
         }
-        cells.emplace_back(chars);
+        needle.append(glyph);
     }
-    return cells;
 }
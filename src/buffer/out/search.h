@@ -20,6 +20,7 @@ Revision History:
 #include <WinConTypes.h>
 #include "TextAttribute.hpp"
 #include "textBuffer.hpp"
+#include "RegexMatcher.hpp"
 #include "../types/IUiaData.h"
 
 // This used to be in find.h.
@@ -40,10 +41,17 @@ public:
         CaseSensitive
     };
 
+    enum class Mode
+    {
+        PlainText,
+        Regex
+    };
+
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring& str,
            const Direction dir,
-           const Sensitivity sensitivity);
+           const Sensitivity sensitivity,
+           const Mode mode = Mode::PlainText);
 
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring& str,
@@ -56,29 +64,55 @@ public:
     void Color(const TextAttribute attr) const;
 
     std::pair<til::point, til::point> GetFoundLocation() const noexcept;
+    const std::vector<std::pair<til::point, til::point>>& GetAllMatches();
+    std::optional<size_t> GetCurrentMatchIndex() const noexcept;
 
-private:
-    wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
-    bool _FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const;
-    bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept;
-    void _UpdateNextPosition();
+    bool FindMatchesInNextRows(const til::CoordType rowCount);
+    size_t GetMatchCount() const noexcept;
+    bool IsValid() const noexcept;
 
-    void _IncrementCoord(til::point& coord) const noexcept;
-    void _DecrementCoord(til::point& coord) const noexcept;
+private:
+    bool _TryGetCellAt(const std::vector<std::pair<size_t, til::CoordType>>& lineRows,
+                       const size_t offset,
+                       const bool isEnd,
+                       til::point& cell) const;
+    bool _TryGetRegexCellAt(const std::vector<std::pair<size_t, til::CoordType>>& lineRows,
+                            const size_t offset,
+                            const bool isEnd,
+                            til::point& cell) const;
+    size_t _GetFirstMatchIndex() const noexcept;
 
     static til::point s_GetInitialAnchor(const Microsoft::Console::Types::IUiaData& uiaData, const Direction dir);
 
-    static std::vector<std::vector<wchar_t>> s_CreateNeedleFromString(const std::wstring& wstr);
+    static std::wstring s_CreateNeedleFromString(const std::wstring& wstr, const Sensitivity sensitivity);
+    template<std::wstring_view (*ParseNextGlyph)(std::wstring_view) noexcept>
+    static void s_AppendCells(std::wstring& needle, const std::wstring_view wstr);
+    static void s_ApplySensitivity(std::wstring& str, const Sensitivity sensitivity) noexcept;
+    static void s_AppendRowText(std::wstring& line, const CharRow& charRow, const til::CoordType columns);
+
+    // Needles at least this long are matched with a Boyer-Moore-Horspool
+    // searcher. Shorter ones are matched with wstring_view::find, which scans
+    // for the first code unit with wmemchr and beats building the searcher's tables.
+    static constexpr size_t _boyerMooreMinLength = 8;
 
-    bool _reachedEnd = false;
-    til::point _coordNext;
     til::point _coordSelStart;
     til::point _coordSelEnd;
 
+    // All matches sorted by their start. They're searched for in batches of
+    // rows (see FindMatchesInNextRows), at the latest on the first call to FindNext().
+    std::vector<std::pair<til::point, til::point>> _matches;
+    til::CoordType _nextRow = 0;
+    bool _allMatchesFound = false;
+    std::optional<size_t> _currentMatch;
+    size_t _matchesVisited = 0;
+
     const til::point _coordAnchor;
-    const std::vector<std::vector<wchar_t>> _needle;
+    const std::wstring _needle;
     const Direction _direction;
     const Sensitivity _sensitivity;
+    // Set in Mode::Regex, if the pattern compiled. The _needle is the pattern then.
+    const std::optional<RegexMatcher> _regex;
+    const Mode _mode;
     Microsoft::Console::Types::IUiaData& _uiaData;
 
 #ifdef UNIT_TESTING
@@ -5,6 +5,7 @@
 
 #include "textBuffer.hpp"
 #include "CharRow.hpp"
+#include "textBufferRowCursor.hpp"
 
 #include "../renderer/base/renderer.hpp"
 #include "../types/inc/utils.hpp"
@@ -38,19 +39,25 @@ TextBuffer::TextBuffer(const til::size screenBufferSize,
     _firstRow{ 0 },
     _currentAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
+    _charBuffer{},
+    _attributeTable{},
     _storage{},
-    _unicodeStorage{},
+    _spillScrollback{ false },
+    _scrollbackSpill{},
     _isActiveBuffer{ isActiveBuffer },
+    _paintedGeneration{ 0 },
     _renderer{ renderer },
     _size{},
     _currentHyperlinkId{ 1 },
     _currentPatternId{ 0 }
 {
     // initialize ROWs
+    // They start out frozen (and blank) so that nothing is committed for rows that never get used.
+    _charBuffer = _AllocateCharBuffer(screenBufferSize);
     _storage.reserve(gsl::narrow<size_t>(screenBufferSize.Y));
     for (til::CoordType i = 0; i < screenBufferSize.Y; ++i)
     {
-        _storage.emplace_back(i, screenBufferSize.X, _currentAttributes, this);
+        _storage.emplace_back(i, screenBufferSize.X, _currentAttributes, this, _GetRowCharBuffer(_charBuffer, i), true);
     }
 
     _UpdateSize();
@@ -88,9 +95,9 @@ til::CoordType TextBuffer::TotalRowCount() const noexcept
 // - const reference to the requested row. Asserts if out of bounds.
 const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const noexcept
 {
-    // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
-    const auto offsetIndex = gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size();
-    return til::at(_storage, offsetIndex);
+    // Thawing a row doesn't change its contents, which is what constness is about here.
+#pragma warning(suppress : 26492) // Don't use const_cast to cast away const or volatile (type.3).
+    return const_cast<TextBuffer*>(this)->GetRowByOffset(index);
 }
 
 // Routine Description:
@@ -104,7 +111,24 @@ ROW& TextBuffer::GetRowByOffset(const til::CoordType index) noexcept
 {
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     const auto offsetIndex = gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size();
-    return til::at(_storage, offsetIndex);
+    auto& row = til::at(_storage, offsetIndex);
+    if (row.IsFrozen())
+    {
+        // Readers can share the Terminal's lock, so two of them might try to thaw the same row.
+        const std::scoped_lock lock{ _thawLock };
+        if (row.IsFrozen())
+        {
+            _ThawRow(row);
+        }
+    }
+    return row;
+}
+
+// Routine Description:
+// - Retrieves the table of attributes that the rows of this buffer refer to
+TextAttributeTable& TextBuffer::GetAttributeTable() noexcept
+{
+    return _attributeTable;
 }
 
 // Routine Description:
@@ -380,18 +404,138 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
         return givenIt;
     }
 
+    if (_attributeTable.NeedsCompaction())
+    {
+        _CompactAttributes();
+    }
+
     //  Get the row and write the cells
     auto& row = GetRowByOffset(target.Y);
     const auto newIt = row.WriteCells(givenIt, target.X, wrap, limitRight);
 
-    // Take the cell distance written and notify that it needs to be repainted.
-    const auto written = newIt.GetCellDistance(givenIt);
-    const auto paint = Viewport::FromDimensions(target, { written, 1 });
-    TriggerRedraw(paint);
+    // The row tracks which of its cells need to be repainted (see ConsumeDirtyRows),
+    // so all that's left to do is to let the renderer know that there's something to paint.
+    if (_isActiveBuffer)
+    {
+        _renderer.NotifyPaintFrame();
+    }
 
     return newIt;
 }
 
+// Routine Description:
+// - Fills a rectangular area of the buffer with the same character and attributes,
+//   without going through the generic OutputCellIterator path of WriteLine.
+// Arguments:
+// - rect - the area to fill. It's clipped to the bounds of the buffer.
+// - fillChar - the character, which must not be a surrogate or full width
+// - fillAttrs - the attributes of the filled cells
+// Return Value:
+// - <none>
+void TextBuffer::FillRect(const til::rect& rect, const wchar_t fillChar, const TextAttribute& fillAttrs)
+{
+    const auto size = GetSize().Dimensions();
+    const auto left = std::max(0, rect.left);
+    const auto right = std::min(size.X, rect.right);
+    const auto top = std::max(0, rect.top);
+    const auto bottom = std::min(size.Y, rect.bottom);
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    if (_attributeTable.NeedsCompaction())
+    {
+        _CompactAttributes();
+    }
+
+    for (auto y = top; y < bottom; ++y)
+    {
+        GetRowByOffset(y).FillCells(left, right, fillChar, fillAttrs);
+    }
+
+    if (_isActiveBuffer)
+    {
+        _renderer.NotifyPaintFrame();
+    }
+}
+
+// Routine Description:
+// - Fills a run of cells with the same character and/or attributes, starting at
+//   the given position and continuing in the following rows, like a stream of
+//   text would. It's the fast path of the FillConsoleOutput* APIs.
+// Arguments:
+// - target - the first cell to fill. It must be within the bounds of the buffer.
+// - count - the number of cells to fill. The run is clipped to the end of the buffer.
+// - fillChar - the character, which must not be a surrogate or full width.
+//   If it's empty, the text is kept as is.
+// - fillAttrs - the attributes of the filled cells. If it's empty, they're kept as is.
+// Return Value:
+// - The number of cells that were filled.
+size_t TextBuffer::FillCells(const til::point target, const size_t count, const std::optional<wchar_t> fillChar, const std::optional<TextAttribute>& fillAttrs)
+{
+    const auto size = GetSize();
+    THROW_HR_IF(E_INVALIDARG, !size.IsInBounds(target));
+
+    const auto width = gsl::narrow_cast<size_t>(size.Width());
+    const auto available = (gsl::narrow_cast<size_t>(size.Height()) - target.Y) * width - target.X;
+    const auto filled = std::min(count, available);
+    if (filled == 0)
+    {
+        return 0;
+    }
+
+    if (fillAttrs && _attributeTable.NeedsCompaction())
+    {
+        _CompactAttributes();
+    }
+
+    auto remaining = filled;
+    auto x = gsl::narrow_cast<size_t>(target.X);
+    for (auto y = target.Y; remaining != 0; ++y)
+    {
+        const auto end = std::min(width, x + remaining);
+        GetRowByOffset(y).FillCells(gsl::narrow_cast<til::CoordType>(x), gsl::narrow_cast<til::CoordType>(end), fillChar, fillAttrs);
+        remaining -= end - x;
+        x = 0;
+    }
+
+    if (_isActiveBuffer)
+    {
+        _renderer.NotifyPaintFrame();
+    }
+
+    return filled;
+}
+
+// Routine Description:
+// - Moves the cells of a rectangular area of the buffer to the left or right,
+//   one row at a time, without reading them out and writing them back in.
+// - The area and its destination must be within the bounds of the buffer.
+//   The cells it vacates keep their contents, see ROW::ShiftCells.
+// Arguments:
+// - rect - the area to move
+// - delta - the number of columns to move it by. Negative values move it to the left.
+// Return Value:
+// - <none>
+void TextBuffer::ShiftCells(const til::rect& rect, const til::CoordType delta)
+{
+    if (delta == 0 || rect.left >= rect.right)
+    {
+        return;
+    }
+
+    for (auto y = rect.top; y < rect.bottom; ++y)
+    {
+        GetRowByOffset(y).ShiftCells(rect.left, rect.right, delta);
+    }
+
+    if (_isActiveBuffer)
+    {
+        _renderer.NotifyPaintFrame();
+    }
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -564,6 +708,11 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
     // Prune hyperlinks to delete obsolete references
     _PruneHyperlinks();
 
+    if (_attributeTable.NeedsCompaction())
+    {
+        _CompactAttributes();
+    }
+
     // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     auto fillAttributes = _currentAttributes;
     if (inVtMode)
@@ -572,7 +721,9 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         // the current background color, but with no meta attributes set.
         fillAttributes.SetStandardErase();
     }
-    const auto fSuccess = _storage.at(_firstRow).Reset(fillAttributes);
+    auto& firstRow = _storage.at(_firstRow);
+    _ReleaseSpilledRow(firstRow);
+    const auto fSuccess = firstRow.Reset(fillAttributes);
     if (fSuccess)
     {
         // Now proceed to increment.
@@ -584,6 +735,15 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         {
             _firstRow = 0;
         }
+
+        // The row that just scrolled _hotRowDistance rows away from the bottom
+        // is unlikely to be looked at again anytime soon. Freeze it to make
+        // scrollback cost a fraction of the memory of the visible rows.
+        const auto coldRow = TotalRowCount() - 1 - _hotRowDistance;
+        if (coldRow >= 0)
+        {
+            _FreezeRow(til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + coldRow) % _storage.size()));
+        }
     }
     return fSuccess;
 }
@@ -694,15 +854,8 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
 
     // OK. We're about to play games by moving rows around within the deque to
     // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
-    {
-        // Rotate the buffer to put the first row at the front.
-        std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
-
-        // The first row is now at the top.
-        _firstRow = 0;
-    }
+    // The rows are stored circularly, so only the rows in the affected region
+    // are rotated, without touching the rest of the buffer (see _RotateRows).
 
     // Rotate just the subsection specified
     if (delta < 0)
@@ -740,7 +893,7 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+        _RotateRows(firstRow + delta, firstRow, firstRow + size);
     }
     else
     {
@@ -777,12 +930,25 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
+        _RotateRows(firstRow, firstRow + size, firstRow + size + delta);
+    }
+
+    // Every row in the scrolled region ended up somewhere else and needs to be
+    // renumbered and repainted. The IDs of the rows outside of it are unchanged.
+    const auto dirtyTop = std::min(firstRow, firstRow + delta);
+    const auto dirtyBottom = std::max(firstRow + size, firstRow + size + delta);
+    for (auto y = dirtyTop; y < dirtyBottom; ++y)
+    {
+        const auto index = gsl::narrow_cast<size_t>(_firstRow + y) % _storage.size();
+        auto& row = til::at(_storage, index);
+        row.SetId(gsl::narrow_cast<til::CoordType>(index));
+        row.MarkDirty(0, row.size());
     }
 
-    // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
-    // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+    if (_isActiveBuffer)
+    {
+        _renderer.NotifyPaintFrame();
+    }
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -840,6 +1006,21 @@ void TextBuffer::ResetLineRenditionRange(const til::CoordType startRow, const ti
     }
 }
 
+// Routine Description:
+// - Moves the given rows into compact storage, like rows that scrolled far into
+//   the scrollback. Used to release the memory of rows that were just cleared
+//   and won't be written to for a while. They're thawed again when accessed.
+// Arguments:
+// - startRow - the first row to freeze
+// - endRow - the row after the last one to freeze
+void TextBuffer::FreezeRows(const til::CoordType startRow, const til::CoordType endRow) noexcept
+{
+    for (auto row = startRow; row < endRow; row++)
+    {
+        _FreezeRow(til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + row) % _storage.size()));
+    }
+}
+
 LineRendition TextBuffer::GetLineRendition(const til::CoordType row) const noexcept
 {
     return GetRowByOffset(row).GetLineRendition();
@@ -886,6 +1067,7 @@ void TextBuffer::Reset()
 
     for (auto& row : _storage)
     {
+        _ReleaseSpilledRow(row);
         row.Reset(attr);
     }
 }
@@ -925,18 +1107,37 @@ void TextBuffer::Reset()
         // remove rows if we're shrinking
         while (_storage.size() > static_cast<size_t>(newSize.Y))
         {
+            _ReleaseSpilledRow(_storage.back());
             _storage.pop_back();
         }
+
+        // The character data of all rows lives in a single slab, so resizing in
+        // either dimension means moving every remaining row into a new one.
+        // The old slab has to stay alive until all rows have been copied out of it.
+        // Frozen rows don't have anything in their slice and stay frozen.
+        auto newCharBuffer = _AllocateCharBuffer(newSize);
+        til::CoordType i = 0;
+        for (auto& row : _storage)
+        {
+            const auto slice = _GetRowCharBuffer(newCharBuffer, i);
+            if (!row.IsFrozen())
+            {
+                _CommitRowCharBuffer(newCharBuffer, slice);
+            }
+            THROW_IF_FAILED(row.Resize(slice, newSize.X));
+            ++i;
+        }
+
         // add rows if we're growing
-        while (_storage.size() < static_cast<size_t>(newSize.Y))
+        for (; i < newSize.Y; ++i)
         {
-            _storage.emplace_back(gsl::narrow_cast<til::CoordType>(_storage.size()), newSize.X, attributes, this);
+            _storage.emplace_back(i, newSize.X, attributes, this, _GetRowCharBuffer(newCharBuffer, i), true);
         }
 
+        _charBuffer = std::move(newCharBuffer);
+
         // Now that we've tampered with the row placement, refresh all the row IDs.
-        // Also take advantage of the row ID refresh loop to resize the rows in the X dimension
-        // and cleanup the UnicodeStorage characters that might fall outside the resized buffer.
-        _RefreshRowIDs(newSize.X);
+        _RefreshRowIDs();
 
         // Update the cached size value
         _UpdateSize();
@@ -946,14 +1147,42 @@ void TextBuffer::Reset()
     return S_OK;
 }
 
-const UnicodeStorage& TextBuffer::GetUnicodeStorage() const noexcept
+// Routine Description:
+// - Enables or disables moving the contents of frozen rows into a memory-mapped
+//   temporary file instead of keeping them on the heap. This bounds the memory
+//   use of a large scrollback to the rows close to the output.
+// - Only affects rows that are frozen from now on.
+// Arguments:
+// - enabled - whether to spill frozen rows to disk
+void TextBuffer::SetScrollbackSpill(const bool enabled) noexcept
 {
-    return _unicodeStorage;
+    _spillScrollback = enabled;
 }
 
-UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
+// Routine Description:
+// - Estimates how much memory the text of this buffer occupies: the committed
+//   chunks of the character slab and the compact storage of frozen rows.
+//   Spilled rows and the attribute table aren't counted.
+// Return Value:
+// - the footprint in bytes
+size_t TextBuffer::GetMemoryFootprint() const noexcept
 {
-    return _unicodeStorage;
+    // We access the rows directly instead of through GetRowByOffset, which would thaw them.
+    const std::scoped_lock lock{ _thawLock };
+
+    auto bytes = _storage.size() * sizeof(ROW);
+    for (const auto hotRows : _charBuffer.hotRows)
+    {
+        if (hotRows != 0)
+        {
+            bytes += _charBuffer.chunkBytes;
+        }
+    }
+    for (const auto& row : _storage)
+    {
+        bytes += row.GetFrozenData().size_bytes();
+    }
+    return bytes;
 }
 
 void TextBuffer::SetAsActiveBuffer(const bool isActiveBuffer) noexcept
@@ -1011,6 +1240,14 @@ void TextBuffer::TriggerScroll(const til::point delta)
     }
 }
 
+void TextBuffer::TriggerScrollRegion(const Viewport& region, const til::CoordType delta)
+{
+    if (_isActiveBuffer)
+    {
+        _renderer.TriggerScrollRegion(region, delta);
+    }
+}
+
 void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
 {
     if (_isActiveBuffer)
@@ -1019,40 +1256,289 @@ void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
     }
 }
 
+// Routine Description:
+// - Returns the parts of the given rows that were modified since the last call
+//   and marks them as painted. Called by the renderer when it starts a frame,
+//   so that it only has to invalidate what actually changed.
+// - Rows outside of the given range are marked as painted as well. Rows that
+//   scroll into view are invalidated by the renderer's scrolling anyway.
+// Arguments:
+// - firstRow - the first row to look at
+// - lastRow - the last row to look at (inclusive)
+// Return Value:
+// - the modified regions, one per row, exclusive
+std::vector<til::rect> TextBuffer::ConsumeDirtyRows(const til::CoordType firstRow, const til::CoordType lastRow) const
+{
+    std::vector<til::rect> dirty;
+    const auto latest = ROW::s_GetLatestGeneration();
+    if (latest != _paintedGeneration)
+    {
+        const auto top = std::max(firstRow, 0);
+        const auto bottom = std::min(lastRow, TotalRowCount() - 1);
+        for (auto y = top; y <= bottom; ++y)
+        {
+            // Don't use GetRowByOffset here, this doesn't need to thaw the row.
+            const auto& row = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + y) % _storage.size());
+            if (row.GetGeneration() > _paintedGeneration)
+            {
+                dirty.emplace_back(row.GetDirtyLeft(), y, row.GetDirtyRight(), y + 1);
+            }
+        }
+        _paintedGeneration = latest;
+    }
+    return dirty;
+}
+
+// Routine Description:
+// - Returns the latest ROW generation the renderer has seen, see ROW::MarkDirty.
+uint64_t TextBuffer::GetPaintedGeneration() const noexcept
+{
+    return _paintedGeneration;
+}
+
+// Routine Description:
+// - Checks whether any of the given rows was modified after the given generation.
+// Arguments:
+// - firstRow - the first row to look at
+// - lastRow - the last row to look at (inclusive)
+// - generation - a value of ROW::s_GetLatestGeneration()
+// Return Value:
+// - true if any of the rows was modified since
+bool TextBuffer::WereRowsModifiedSince(const til::CoordType firstRow, const til::CoordType lastRow, const uint64_t generation) const noexcept
+{
+    const auto top = std::max(firstRow, 0);
+    const auto bottom = std::min(lastRow, TotalRowCount() - 1);
+    for (auto y = top; y <= bottom; ++y)
+    {
+        if (til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + y) % _storage.size()).GetGeneration() > generation)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Routine Description:
+// - Rotates the rows in [first, last) such that the row at middle becomes the first one.
+// - The arguments are offsets from the first row of the buffer, like for GetRowByOffset.
+//   Since the storage is circular, the range may wrap around its end, in which case
+//   the rotation is done by reversing both halves and then the entire range.
+// - Row IDs are left untouched, see ScrollRows.
+void TextBuffer::_RotateRows(const til::CoordType first, const til::CoordType middle, const til::CoordType last) noexcept
+{
+    const auto count = _storage.size();
+    const auto begin = gsl::narrow_cast<size_t>(_firstRow + first) % count;
+    const auto length = gsl::narrow_cast<size_t>(last - first);
+
+    if (begin + length <= count)
+    {
+        const auto it = _storage.begin() + begin;
+        std::rotate(it, it + (middle - first), it + length);
+        return;
+    }
+
+    const auto reverse = [&](size_t lo, size_t hi) noexcept {
+        while (lo + 1 < hi)
+        {
+            --hi;
+            std::swap(til::at(_storage, (begin + lo) % count), til::at(_storage, (begin + hi) % count));
+            ++lo;
+        }
+    };
+    const auto split = gsl::narrow_cast<size_t>(middle - first);
+    reverse(0, split);
+    reverse(split, length);
+    reverse(0, length);
+}
+
 // Routine Description:
 // - Method to help refresh all the Row IDs after manipulating the row
 //   by shuffling pointers around.
-// - This will also update parent pointers that are stored in depth within the buffer
-//   (e.g. it will update CharRow parents pointing at Rows that might have been moved around)
-// - Optionally takes a new row width if we're resizing to perform a resize operation and cleanup
-//   any high unicode (UnicodeStorage) runs while we're already looping through the rows.
 // Arguments:
-// - newRowWidth - Optional new value for the row width.
-void TextBuffer::_RefreshRowIDs(std::optional<til::CoordType> newRowWidth)
+// - <none>
+void TextBuffer::_RefreshRowIDs() noexcept
 {
-    std::unordered_map<til::CoordType, til::CoordType> rowMap;
     til::CoordType i = 0;
     for (auto& it : _storage)
     {
-        // Build a map so we can update Unicode Storage
-        rowMap.emplace(it.GetId(), i);
-
-        // Update the IDs
         it.SetId(i++);
+    }
+}
+
+// Routine Description:
+// - Reserves the slab holding the character data of all rows of a buffer of the given size.
+// - Nothing is committed yet: the rows start out frozen and _CommitRowCharBuffer
+//   has to be called for a row's slice before the row is thawed.
+// Arguments:
+// - size - the dimensions of the buffer
+// Return Value:
+// - the slab. Each row's slice is retrieved with _GetRowCharBuffer.
+TextBuffer::CharBuffer TextBuffer::_AllocateCharBuffer(const til::size size)
+{
+    // Chunks are the unit in which the slab is (de)committed. They're kept
+    // page aligned and large enough for a couple dozen rows at common widths.
+    static constexpr size_t pageSize = 4096;
+    static constexpr size_t chunkSize = 64 * 1024;
+
+    CharBuffer buffer;
+    buffer.stride = CharRow::CalculateBufferStride(size.X);
+    buffer.chunkRows = std::max<size_t>(1, chunkSize / buffer.stride);
+    buffer.chunkBytes = (buffer.chunkRows * buffer.stride + pageSize - 1) & ~(pageSize - 1);
+
+    const auto chunks = (gsl::narrow<size_t>(size.Y) + buffer.chunkRows - 1) / buffer.chunkRows;
+    size_t bytes = 0;
+    THROW_HR_IF(E_OUTOFMEMORY, !base::CheckMul(buffer.chunkBytes, chunks).AssignIfValid(&bytes));
+    if (bytes != 0)
+    {
+        buffer.slab.reset(static_cast<std::byte*>(VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_READWRITE)));
+        THROW_LAST_ERROR_IF_NULL(buffer.slab.get());
+    }
+    buffer.hotRows.resize(chunks);
+    return buffer;
+}
+
+// Routine Description:
+// - Retrieves the slice of a character slab belonging to the row at the given storage index.
+// Arguments:
+// - buffer - a slab allocated by _AllocateCharBuffer
+// - index - the storage index of the row
+// Return Value:
+// - pointer to the row's slice
+std::byte* TextBuffer::_GetRowCharBuffer(const CharBuffer& buffer, const til::CoordType index) noexcept
+{
+    const auto i = gsl::narrow_cast<size_t>(index);
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    return buffer.slab.get() + i / buffer.chunkRows * buffer.chunkBytes + i % buffer.chunkRows * buffer.stride;
+}
+
+// Routine Description:
+// - Accounts for a row of the given slab becoming thawed and commits its chunk if it's the first such row.
+// Arguments:
+// - buffer - a slab allocated by _AllocateCharBuffer
+// - slice - the row's slice within the slab
+void TextBuffer::_CommitRowCharBuffer(CharBuffer& buffer, const std::byte* const slice) noexcept
+{
+    const auto chunk = gsl::narrow_cast<size_t>(slice - buffer.slab.get()) / buffer.chunkBytes;
+    if (til::at(buffer.hotRows, chunk)++ == 0)
+    {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        const auto address = buffer.slab.get() + chunk * buffer.chunkBytes;
+        // We can't show a row we can't store and the row accessors can't fail.
+        FAIL_FAST_LAST_ERROR_IF_NULL(VirtualAlloc(address, buffer.chunkBytes, MEM_COMMIT, PAGE_READWRITE));
+    }
+}
+
+// Routine Description:
+// - Accounts for a row of the given slab becoming frozen and decommits its chunk if it was the last thawed one.
+// Arguments:
+// - buffer - a slab allocated by _AllocateCharBuffer
+// - slice - the row's slice within the slab
+void TextBuffer::_DecommitRowCharBuffer(CharBuffer& buffer, const std::byte* const slice) noexcept
+{
+    const auto chunk = gsl::narrow_cast<size_t>(slice - buffer.slab.get()) / buffer.chunkBytes;
+    if (--til::at(buffer.hotRows, chunk) == 0)
+    {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        const auto address = buffer.slab.get() + chunk * buffer.chunkBytes;
+        // The address space stays reserved for when the rows thaw again.
+#pragma warning(suppress : 6250) // Calling 'VirtualFree' without the MEM_RELEASE flag might free memory but not address descriptors (VADs).
+        LOG_IF_WIN32_BOOL_FALSE(VirtualFree(address, buffer.chunkBytes, MEM_DECOMMIT));
+    }
+}
 
-        // Also update the char row parent pointers as they can get shuffled up in the rotates.
-        it.GetCharRow().UpdateParent(&it);
+// Routine Description:
+// - Restores the contents of a frozen row, see CharRow::Thaw().
+// Arguments:
+// - row - a frozen row of this buffer
+void TextBuffer::_ThawRow(ROW& row) noexcept
+{
+    _CommitRowCharBuffer(_charBuffer, row.GetCharBuffer());
+    // Thawing only allocates for rows full of surrogate pairs or combining marks.
+    // Like running out of memory for the slab itself, that's fatal.
+    if (const auto handle = row.GetSpillHandle())
+    {
+        row.Thaw(_scrollbackSpill->Load(*handle));
+        _scrollbackSpill->Release(*handle);
+    }
+    else
+    {
+        row.Thaw();
+    }
+}
+
+// Routine Description:
+// - Moves the contents of a row into compact storage and decommits its slice
+//   if possible, see CharRow::Freeze(). This is purely an optimization and
+//   the row simply stays thawed if anything goes wrong.
+// Arguments:
+// - row - a row of this buffer
+void TextBuffer::_FreezeRow(ROW& row) noexcept
+{
+    if (row.IsFrozen())
+    {
+        return;
+    }
+
+    try
+    {
+        row.Freeze();
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return;
+    }
+
+    _DecommitRowCharBuffer(_charBuffer, row.GetCharBuffer());
+
+    if (_spillScrollback)
+    {
+        _SpillRow(row);
+    }
+}
+
+// Routine Description:
+// - Moves the contents of a frozen row into the scrollback spill file.
+//   If that fails, the contents simply stay where they are.
+// Arguments:
+// - row - a frozen row of this buffer
+void TextBuffer::_SpillRow(ROW& row) noexcept
+{
+    const auto data = row.GetFrozenData();
+    if (data.empty())
+    {
+        return;
+    }
 
-        // Resize the rows in the X dimension if we have a new width
-        if (newRowWidth.has_value())
+    try
+    {
+        if (!_scrollbackSpill)
+        {
+            _scrollbackSpill = std::make_unique<ScrollbackSpill>();
+        }
+        if (const auto handle = _scrollbackSpill->Store(data))
         {
-            // Realloc in the X direction
-            THROW_IF_FAILED(it.Resize(newRowWidth.value()));
+            row.SpillFrozenData(*handle);
         }
     }
+    catch (...)
+    {
+        // Most likely the disk is full or the temp directory is unusable. Don't keep trying.
+        LOG_CAUGHT_EXCEPTION();
+        _spillScrollback = false;
+    }
+}
 
-    // Give the new mapping to Unicode Storage
-    _unicodeStorage.Remap(rowMap, newRowWidth);
+// Routine Description:
+// - Releases the spill file's copy of the contents of a row that's about to be reset or removed.
+// Arguments:
+// - row - a row of this buffer
+void TextBuffer::_ReleaseSpilledRow(ROW& row) noexcept
+{
+    if (const auto handle = row.GetSpillHandle())
+    {
+        _scrollbackSpill->Release(*handle);
+    }
 }
 
 // Routine Description:
@@ -1084,7 +1570,12 @@ ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
     }
 
     THROW_HR_IF(E_FAIL, Row.GetId() == _firstRow);
-    return _storage.at(prevRowIndex);
+    auto& prevRow = _storage.at(prevRowIndex);
+    if (prevRow.IsFrozen())
+    {
+        _ThawRow(prevRow);
+    }
+    return prevRow;
 }
 
 // Method Description:
@@ -1097,20 +1588,64 @@ ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
 // - the delimiter class for the given char
 DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const
 {
+    {
+        // UIA clients may navigate by word concurrently, as they only need a read lock.
+        const std::scoped_lock lock{ _delimiterClassCacheLock };
+        const auto& classes = _GetDelimiterClasses(pos.Y, wordDelimiters);
+        const auto x = gsl::narrow_cast<size_t>(pos.X);
+        if (x < classes.size())
+        {
+            return til::at(classes, x);
+        }
+    }
     return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, wordDelimiters);
 }
 
 // Method Description:
-// - Get the til::point for the beginning of the word you are on
+// - Gets the delimiter class of every cell of the given row. Word navigation asks for
+//   the class of one cell after another, mostly within the same row, so we classify
+//   the whole row once and reuse the result until the row is modified.
 // Arguments:
-// - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
-// - accessibilityMode - when enabled, we continue expanding left until we are at the beginning of a readable word.
-//                        Otherwise, expand left until a character of a new delimiter class is found
-//                        (or a row boundary is encountered)
-// - limitOptional - (optional) the last possible position in the buffer that can be explored. This can be used to improve performance.
+// - y: the row under observation
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
 // Return Value:
-// - The til::point for the first character on the "word" (inclusive)
+// - the delimiter classes of the row's cells. Valid until the next call.
+const std::vector<DelimiterClass>& TextBuffer::_GetDelimiterClasses(const til::CoordType y, const std::wstring_view wordDelimiters) const
+{
+    auto& cache = _delimiterClassCache;
+    // Look at the row without thawing it, so that cache hits don't have to.
+    const auto& row = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + y) % _storage.size());
+
+    if (cache.wordDelimiters != wordDelimiters)
+    {
+        // The delimiters only change with the settings, so it's worth building a lookup table.
+        cache.row = nullptr;
+        cache.classifier = DelimiterClassifier{ wordDelimiters };
+        cache.wordDelimiters = wordDelimiters;
+    }
+
+    if (cache.row != &row || cache.generation != row.GetGeneration())
+    {
+        cache.row = nullptr;
+        GetRowByOffset(y).GetCharRow().GetDelimiterClasses(cache.classifier, cache.classes);
+        cache.row = &row;
+        cache.generation = row.GetGeneration();
+    }
+
+    return cache.classes;
+}
+
+// Method Description:
+// - Get the til::point for the beginning of the word you are on
+// Arguments:
+// - target - a til::point on the word you are currently on
+// - wordDelimiters - what characters are we considering for the separation of words
+// - accessibilityMode - when enabled, we continue expanding left until we are at the beginning of a readable word.
+//                        Otherwise, expand left until a character of a new delimiter class is found
+//                        (or a row boundary is encountered)
+// - limitOptional - (optional) the last possible position in the buffer that can be explored. This can be used to improve performance.
+// Return Value:
+// - The til::point for the first character on the "word" (inclusive)
 til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode, std::optional<til::point> limitOptional) const
 {
     // Consider a buffer with this text in it:
@@ -1208,24 +1743,20 @@ til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, co
 // - The til::point for the first character on the current word or delimiter run (stopped by the left margin)
 til::point TextBuffer::_GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const
 {
-    auto result = target;
-    const auto bufferSize = GetSize();
-
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
-
-    // expand left until we hit the left boundary or a different delimiter class
-    while (result.X > bufferSize.Left() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.DecrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    // The word can't leave the row, so we can scan the row's delimiter classes directly.
+    const std::scoped_lock lock{ _delimiterClassCacheLock };
+    const auto& classes = _GetDelimiterClasses(target.Y, wordDelimiters);
+    const auto x = gsl::narrow_cast<size_t>(target.X);
+    if (x >= classes.size())
     {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
+        return target;
     }
 
-    return result;
+    // expand left until we hit the left boundary or a different delimiter class
+    const auto initialDelimiter = til::at(classes, x);
+    const auto rend = classes.rend();
+    const auto it = std::find_if(rend - (x + 1), rend, [=](const auto c) { return c != initialDelimiter; });
+    return { gsl::narrow_cast<til::CoordType>(rend - it), target.Y };
 }
 
 // Method Description:
@@ -1337,68 +1868,57 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
         return target;
     }
 
-    auto result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
-
-    // expand right until we hit the right boundary or a different delimiter class
-    while (result.X < bufferSize.RightInclusive() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
+    // The word can't leave the row, so we can scan the row's delimiter classes directly.
+    const std::scoped_lock lock{ _delimiterClassCacheLock };
+    const auto& classes = _GetDelimiterClasses(target.Y, wordDelimiters);
+    const auto x = gsl::narrow_cast<size_t>(target.X);
+    if (x >= classes.size())
     {
-        bufferSize.IncrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
+        return target;
     }
 
-    return result;
+    // expand right until we hit the right boundary or a different delimiter class
+    const auto initialDelimiter = til::at(classes, x);
+    const auto begin = classes.begin();
+    const auto it = std::find_if(begin + x, classes.end(), [=](const auto c) { return c != initialDelimiter; });
+    return { gsl::narrow_cast<til::CoordType>(it - begin - 1), target.Y };
 }
 
 void TextBuffer::_PruneHyperlinks()
 {
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
+    // Check the old first row for hyperlink references. The attribute table counts the rows that
+    // use each hyperlink (see ATTR_ROW::_UpdateHyperlinks), so if the row we're erasing is the only
+    // one left, the hyperlink is gone from the buffer and we can remove it from our map.
     // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = _storage.at(_firstRow).GetAttrRow().GetHyperlinks();
-
-    if (!hyperlinks.empty())
+    for (const auto id : _storage.at(_firstRow).GetAttrRow().GetHyperlinks())
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
-
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (til::CoordType i = 1; i < total; ++i)
+        if (_attributeTable.HyperlinkReferences(id) == 1)
         {
-            const auto nextRowRefs = GetRowByOffset(i).GetAttrRow().GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
+            RemoveHyperlinkFromMap(id);
         }
+    }
+}
 
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
+// Routine Description:
+// - Drops the attributes no row uses anymore from the attribute table, which only
+//   ever grows otherwise. Must not be called while a caller holds on to an index
+//   into the table, as the indices of the remaining attributes change.
+void TextBuffer::_CompactAttributes()
+{
+    std::vector<bool> used(_attributeTable.size());
+    for (const auto& row : _storage)
+    {
+        for (const auto& run : row.GetAttrRow().Runs())
         {
-            RemoveHyperlinkFromMap(hyperlinkReference);
+            used[run.value] = true;
         }
     }
+
+    const auto remap = _attributeTable.Compact(used);
+    for (auto& row : _storage)
+    {
+        row.GetAttrRow().RemapAttributes(remap);
+    }
 }
 
 // Method Description:
@@ -1613,6 +2133,16 @@ bool TextBuffer::MoveToPreviousGlyph(til::point& pos, std::optional<til::point>
 // Return Value:
 // - the delimiter class for the given char
 const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const
+{
+    return GetTextRects(start, end, blockSelection, bufferCoordinates, std::min(start.Y, end.Y), std::max(start.Y, end.Y));
+}
+
+// Method Description:
+// - Same as above, but only returns the rectangles for the rows from firstRow
+//   to lastRow (inclusive), for instance those visible in the viewport.
+//   This keeps the cost proportional to the number of visible rows,
+//   even if the region of interest spans the entire buffer.
+const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, til::CoordType firstRow, til::CoordType lastRow) const
 {
     std::vector<til::inclusive_rect> textRects;
 
@@ -1625,9 +2155,16 @@ const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start
                                                std::make_tuple(start, end) :
                                                std::make_tuple(end, start);
 
-    const auto textRectSize = 1 + lowerCoord.Y - higherCoord.Y;
+    firstRow = std::max(firstRow, higherCoord.Y);
+    lastRow = std::min(lastRow, lowerCoord.Y);
+    if (firstRow > lastRow)
+    {
+        return textRects;
+    }
+
+    const auto textRectSize = 1 + lastRow - firstRow;
     textRects.reserve(textRectSize);
-    for (auto row = higherCoord.Y; row <= lowerCoord.Y; row++)
+    for (auto row = firstRow; row <= lastRow; row++)
     {
         til::inclusive_rect textRow;
 
@@ -1726,8 +2263,7 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
     data.text.reserve(rows);
     if (copyTextColor)
     {
-        data.FgAttr.reserve(rows);
-        data.BkAttr.reserve(rows);
+        data.ColorRuns.reserve(rows);
     }
 
     // for each row in the selection
@@ -1737,46 +2273,48 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
 
         const auto highlight = Viewport::FromInclusive(selectionRects.at(i));
 
-        // retrieve the data from the screen buffer
-        auto it = GetCellDataAt(highlight.Origin(), highlight);
-
         // allocate a string buffer
         std::wstring selectionText;
-        std::vector<COLORREF> selectionFgAttr;
-        std::vector<COLORREF> selectionBkAttr;
+        std::vector<TextAndColor::ColorRun> selectionRuns;
 
         // preallocate to avoid reallocs
         selectionText.reserve(gsl::narrow<size_t>(highlight.Width()) + 2); // + 2 for \r\n if we munged it
-        if (copyTextColor)
-        {
-            selectionFgAttr.reserve(gsl::narrow<size_t>(highlight.Width()) + 2);
-            selectionBkAttr.reserve(gsl::narrow<size_t>(highlight.Width()) + 2);
-        }
 
-        // copy char data into the string buffer, skipping trailing bytes
-        while (it)
-        {
-            const auto& cell = *it;
+        const auto appendRun = [&](const size_t length, const COLORREF fg, const COLORREF bk) {
+            if (!selectionRuns.empty() && selectionRuns.back().fg == fg && selectionRuns.back().bk == bk)
+            {
+                selectionRuns.back().length += length;
+            }
+            else if (length)
+            {
+                selectionRuns.push_back({ length, fg, bk });
+            }
+        };
 
-            if (!cell.DbcsAttr().IsTrailing())
+        // copy char data into the string buffer, skipping trailing bytes.
+        // The colors are looked up once per run of identical attributes instead of once per cell.
+        TextBufferRowCursor cursor{ GetRowByOffset(iRow), highlight.Left(), highlight.RightExclusive() };
+        while (cursor)
+        {
+            std::pair<COLORREF, COLORREF> colors{};
+            if (copyTextColor)
             {
-                const auto chars = cell.Chars();
-                selectionText.append(chars);
+                colors = GetAttributeColors(cursor.TextAttr());
+            }
 
-                if (copyTextColor)
+            const auto runStart = selectionText.size();
+            for (const auto runEnd = cursor.RunEnd(); cursor.Column() < runEnd; ++cursor)
+            {
+                if (!cursor.DbcsAttr().IsTrailing())
                 {
-                    const auto cellData = cell.TextAttr();
-                    const auto [CellFgAttr, CellBkAttr] = GetAttributeColors(cellData);
-                    for (size_t j = 0; j < chars.size(); ++j)
-                    {
-                        selectionFgAttr.push_back(CellFgAttr);
-                        selectionBkAttr.push_back(CellBkAttr);
-                    }
+                    selectionText.append(cursor.Chars());
                 }
             }
-#pragma warning(suppress : 26444)
-            // TODO GH 2675: figure out why there's custom construction/destruction happening here
-            it++;
+
+            if (copyTextColor)
+            {
+                appendRun(selectionText.size() - runStart, colors.first, colors.second);
+            }
         }
 
         // We apply formatting to rows if the row was NOT wrapped or formatting of wrapped rows is allowed
@@ -1790,10 +2328,9 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
                 while (!selectionText.empty() && selectionText.back() == UNICODE_SPACE)
                 {
                     selectionText.pop_back();
-                    if (copyTextColor)
+                    if (copyTextColor && --selectionRuns.back().length == 0)
                     {
-                        selectionFgAttr.pop_back();
-                        selectionBkAttr.pop_back();
+                        selectionRuns.pop_back();
                     }
                 }
             }
@@ -1813,10 +2350,7 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
                 {
                     // can't see CR/LF so just use black FG & BK
                     const auto Blackness = RGB(0x00, 0x00, 0x00);
-                    selectionFgAttr.push_back(Blackness);
-                    selectionFgAttr.push_back(Blackness);
-                    selectionBkAttr.push_back(Blackness);
-                    selectionBkAttr.push_back(Blackness);
+                    appendRun(2, Blackness, Blackness);
                 }
             }
         }
@@ -1824,8 +2358,7 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
         data.text.emplace_back(std::move(selectionText));
         if (copyTextColor)
         {
-            data.FgAttr.emplace_back(std::move(selectionFgAttr));
-            data.BkAttr.emplace_back(std::move(selectionBkAttr));
+            data.ColorRuns.emplace_back(std::move(selectionRuns));
         }
     }
 
@@ -1848,171 +2381,115 @@ std::string TextBuffer::GenHTML(const TextAndColor& rows,
 {
     try
     {
-        std::ostringstream htmlBuilder;
+        // once filled with values, there will be exactly 157 bytes in the clipboard header
+        constexpr size_t ClipboardHeaderSize = 157;
 
         // First we have to add some standard
         // HTML boiler plate required for CF_HTML
         // as part of the HTML Clipboard format
-        const std::string htmlHeader =
-            "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
-        htmlBuilder << htmlHeader;
-
-        htmlBuilder << "<!--StartFragment -->";
-
-        // apply global style in div element
-        {
-            htmlBuilder << "<DIV STYLE=\"";
-            htmlBuilder << "display:inline-block;";
-            htmlBuilder << "white-space:pre;";
-
-            htmlBuilder << "background-color:";
-            htmlBuilder << Utils::ColorToHexString(backgroundColor);
-            htmlBuilder << ";";
-
-            htmlBuilder << "font-family:";
-            htmlBuilder << "'";
-            htmlBuilder << ConvertToA(CP_UTF8, fontFaceName);
-            htmlBuilder << "',";
-            // even with different font, add monospace as fallback
-            htmlBuilder << "monospace;";
+        constexpr std::string_view HtmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
+        constexpr std::string_view HtmlFooter = "</BODY></HTML>";
 
-            htmlBuilder << "font-size:";
-            htmlBuilder << fontHeightPoints;
-            htmlBuilder << "pt;";
+        // The clipboard header goes in front of the HTML, but references offsets
+        // within it. We leave room for it and fill it in once we know them.
+        std::string htmlBuilder;
+        htmlBuilder.reserve(ClipboardHeaderSize + 512 + _GetClipboardTextSize(rows));
+        htmlBuilder.append(ClipboardHeaderSize, ' ');
+        htmlBuilder.append(HtmlHeader);
 
-            // note: MS Word doesn't support padding (in this way at least)
-            htmlBuilder << "padding:";
-            htmlBuilder << 4; // todo: customizable padding
-            htmlBuilder << "px;";
+        htmlBuilder.append("<!--StartFragment -->");
 
-            htmlBuilder << "\">";
-        }
+        // apply global style in div element
+        // note: MS Word doesn't support padding (in this way at least)
+        // todo: customizable padding
+        fmt::format_to(std::back_inserter(htmlBuilder),
+                       FMT_COMPILE("<DIV STYLE=\"display:inline-block;white-space:pre;background-color:{};font-family:'{}',monospace;font-size:{}pt;padding:4px;\">"),
+                       Utils::ColorToHexString(backgroundColor),
+                       til::u16u8(fontFaceName), // even with different font, add monospace as fallback
+                       fontHeightPoints);
 
         // copy text and info color from buffer
-        auto hasWrittenAnyText = false;
-        std::optional<COLORREF> fgColor = std::nullopt;
-        std::optional<COLORREF> bkColor = std::nullopt;
+        std::string utf8;
+        std::optional<TextAndColor::ColorRun> currentColors;
         for (size_t row = 0; row < rows.text.size(); row++)
         {
-            size_t startOffset = 0;
-
             if (row != 0)
             {
-                htmlBuilder << "<BR>";
+                htmlBuilder.append("<BR>");
             }
 
-            for (size_t col = 0; col < rows.text.at(row).length(); col++)
-            {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
+            _ForEachClipboardRun(rows, row, [&](const std::wstring_view text, const TextAndColor::ColorRun& run) {
+                if (!currentColors || currentColors->fg != run.fg || currentColors->bk != run.bk)
+                {
+                    if (currentColors)
                     {
-                        const auto unescapedText = ConvertToA(CP_UTF8, std::wstring_view(rows.text.at(row)).substr(startOffset, col - startOffset + includeCurrent));
-                        for (const auto c : unescapedText)
-                        {
-                            switch (c)
-                            {
-                            case '<':
-                                htmlBuilder << "&lt;";
-                                break;
-                            case '>':
-                                htmlBuilder << "&gt;";
-                                break;
-                            case '&':
-                                htmlBuilder << "&amp;";
-                                break;
-                            default:
-                                htmlBuilder << c;
-                            }
-                        }
-
-                        startOffset = col;
+                        htmlBuilder.append("</SPAN>");
                     }
-                };
+                    currentColors = run;
 
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
-                {
-                    // do not include \r nor \n as they don't have color attributes
-                    // and are not HTML friendly. For line break use '<BR>' instead.
-                    writeAccumulatedChars(false);
-                    break;
+                    fmt::format_to(std::back_inserter(htmlBuilder),
+                                   FMT_COMPILE("<SPAN STYLE=\"color:{};background-color:{};\">"),
+                                   Utils::ColorToHexString(run.fg),
+                                   Utils::ColorToHexString(run.bk));
                 }
 
-                auto colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
+                THROW_IF_FAILED(til::u16u8(text, utf8));
+                for (const auto c : utf8)
                 {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
-                }
-
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
-
-                if (colorChanged)
-                {
-                    writeAccumulatedChars(false);
-
-                    if (hasWrittenAnyText)
+                    switch (c)
                     {
-                        htmlBuilder << "</SPAN>";
+                    case '<':
+                        htmlBuilder.append("&lt;");
+                        break;
+                    case '>':
+                        htmlBuilder.append("&gt;");
+                        break;
+                    case '&':
+                        htmlBuilder.append("&amp;");
+                        break;
+                    default:
+                        htmlBuilder.push_back(c);
                     }
-
-                    htmlBuilder << "<SPAN STYLE=\"";
-                    htmlBuilder << "color:";
-                    htmlBuilder << Utils::ColorToHexString(fgColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "background-color:";
-                    htmlBuilder << Utils::ColorToHexString(bkColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "\">";
-                }
-
-                hasWrittenAnyText = true;
-
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
-                {
-                    writeAccumulatedChars(true);
                 }
-            }
+            });
         }
 
-        if (hasWrittenAnyText)
+        if (currentColors)
         {
             // last opened span wasn't closed in loop above, so close it now
-            htmlBuilder << "</SPAN>";
+            htmlBuilder.append("</SPAN>");
         }
 
-        htmlBuilder << "</DIV>";
+        htmlBuilder.append("</DIV>");
 
-        htmlBuilder << "<!--EndFragment -->";
+        htmlBuilder.append("<!--EndFragment -->");
 
-        constexpr std::string_view HtmlFooter = "</BODY></HTML>";
-        htmlBuilder << HtmlFooter;
-
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
+        htmlBuilder.append(HtmlFooter);
 
         // these values are byte offsets from start of clipboard
         const auto htmlStartPos = ClipboardHeaderSize;
-        const auto htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.tellp());
-        const auto fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
-        const auto fragEndPos = htmlEndPos - HtmlFooter.length();
+        const auto htmlEndPos = htmlBuilder.size();
+        const auto fragStartPos = ClipboardHeaderSize + HtmlHeader.size();
+        const auto fragEndPos = htmlEndPos - HtmlFooter.size();
 
         // header required by HTML 0.9 format
-        std::ostringstream clipHeaderBuilder;
-        clipHeaderBuilder << "Version:0.9\r\n";
-        clipHeaderBuilder << std::setfill('0');
-        clipHeaderBuilder << "StartHTML:" << std::setw(10) << htmlStartPos << "\r\n";
-        clipHeaderBuilder << "EndHTML:" << std::setw(10) << htmlEndPos << "\r\n";
-        clipHeaderBuilder << "StartFragment:" << std::setw(10) << fragStartPos << "\r\n";
-        clipHeaderBuilder << "EndFragment:" << std::setw(10) << fragEndPos << "\r\n";
-        clipHeaderBuilder << "StartSelection:" << std::setw(10) << fragStartPos << "\r\n";
-        clipHeaderBuilder << "EndSelection:" << std::setw(10) << fragEndPos << "\r\n";
-
-        return clipHeaderBuilder.str() + htmlBuilder.str();
+        const auto clipHeader = fmt::format(FMT_COMPILE("Version:0.9\r\n"
+                                                        "StartHTML:{:010}\r\n"
+                                                        "EndHTML:{:010}\r\n"
+                                                        "StartFragment:{:010}\r\n"
+                                                        "EndFragment:{:010}\r\n"
+                                                        "StartSelection:{:010}\r\n"
+                                                        "EndSelection:{:010}\r\n"),
+                                            htmlStartPos,
+                                            htmlEndPos,
+                                            fragStartPos,
+                                            fragEndPos,
+                                            fragStartPos,
+                                            fragEndPos);
+        THROW_HR_IF(E_UNEXPECTED, clipHeader.size() != ClipboardHeaderSize);
+        htmlBuilder.replace(0, ClipboardHeaderSize, clipHeader);
+
+        return htmlBuilder;
     }
     catch (...)
     {
@@ -2036,22 +2513,6 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
 {
     try
     {
-        std::ostringstream rtfBuilder;
-
-        // start rtf
-        rtfBuilder << "{";
-
-        // Standard RTF header.
-        // This is similar to the header generated by WordPad.
-        // \ansi - specifies that the ANSI char set is used in the current doc
-        // \ansicpg1252 - represents the ANSI code page which is used to perform the Unicode to ANSI conversion when writing RTF text
-        // \deff0 - specifies that the default font for the document is the one at index 0 in the font table
-        // \nouicompat - ?
-        rtfBuilder << "\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
-
-        // font table
-        rtfBuilder << "{\\fonttbl{\\f0\\fmodern\\fcharset0 " << ConvertToA(CP_UTF8, fontFaceName) << ";}}";
-
         // map to keep track of colors:
         // keys are colors represented by COLORREF
         // values are indices of the corresponding colors in the color table
@@ -2059,133 +2520,88 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
         auto nextColorIndex = 1; // leave 0 for the default color and start from 1.
 
         // RTF color table
-        std::ostringstream colorTableBuilder;
-        colorTableBuilder << "{\\colortbl ;";
-        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(backgroundColor))
-                          << "\\green" << static_cast<int>(GetGValue(backgroundColor))
-                          << "\\blue" << static_cast<int>(GetBValue(backgroundColor))
-                          << ";";
-        colorMap[backgroundColor] = nextColorIndex++;
+        std::string colorTableBuilder;
+        colorTableBuilder.append("{\\colortbl ;");
+
+        const auto getColorIndex = [&](const COLORREF color) {
+            const auto [it, inserted] = colorMap.emplace(color, nextColorIndex);
+            if (inserted)
+            {
+                // color not present in the map, so add it
+                fmt::format_to(std::back_inserter(colorTableBuilder),
+                               FMT_COMPILE("\\red{}\\green{}\\blue{};"),
+                               static_cast<int>(GetRValue(color)),
+                               static_cast<int>(GetGValue(color)),
+                               static_cast<int>(GetBValue(color)));
+                nextColorIndex++;
+            }
+            return it->second;
+        };
+        getColorIndex(backgroundColor);
 
         // content
-        std::ostringstream contentBuilder;
-        contentBuilder << "\\viewkind4\\uc4";
+        std::string contentBuilder;
+        contentBuilder.reserve(256 + _GetClipboardTextSize(rows));
+        contentBuilder.append("\\viewkind4\\uc4");
 
         // paragraph styles
         // \fs specifies font size in half-points i.e. \fs20 results in a font size
         // of 10 pts. That's why, font size is multiplied by 2 here.
-        contentBuilder << "\\pard\\slmult1\\f0\\fs" << std::to_string(2 * fontHeightPoints)
-                       << "\\highlight1"
-                       << " ";
+        fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\pard\\slmult1\\f0\\fs{}\\highlight1 "), 2 * fontHeightPoints);
 
-        std::optional<COLORREF> fgColor = std::nullopt;
-        std::optional<COLORREF> bkColor = std::nullopt;
+        std::optional<TextAndColor::ColorRun> currentColors;
         for (size_t row = 0; row < rows.text.size(); ++row)
         {
-            size_t startOffset = 0;
-
             if (row != 0)
             {
-                contentBuilder << "\\line "; // new line
+                contentBuilder.append("\\line "); // new line
             }
 
-            for (size_t col = 0; col < rows.text.at(row).length(); ++col)
-            {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
-                    {
-                        const auto text = std::wstring_view{ rows.text.at(row) }.substr(startOffset, col - startOffset + includeCurrent);
-                        _AppendRTFText(contentBuilder, text);
-
-                        startOffset = col;
-                    }
-                };
-
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
+            _ForEachClipboardRun(rows, row, [&](const std::wstring_view text, const TextAndColor::ColorRun& run) {
+                if (!currentColors || currentColors->fg != run.fg || currentColors->bk != run.bk)
                 {
-                    // do not include \r nor \n as they don't have color attributes.
-                    // For line break use \line instead.
-                    writeAccumulatedChars(false);
-                    break;
-                }
+                    currentColors = run;
 
-                auto colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
-                {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
+                    const auto bkColorIndex = getColorIndex(run.bk);
+                    const auto fgColorIndex = getColorIndex(run.fg);
+                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\highlight{}\\cf{} "), bkColorIndex, fgColorIndex);
                 }
 
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
-
-                if (colorChanged)
-                {
-                    writeAccumulatedChars(false);
+                _AppendRTFText(contentBuilder, text);
+            });
+        }
 
-                    auto bkColorIndex = 0;
-                    if (colorMap.find(bkColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        bkColorIndex = colorMap[bkColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(bkColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(bkColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(bkColor.value()))
-                                          << ";";
-                        colorMap[bkColor.value()] = nextColorIndex;
-                        bkColorIndex = nextColorIndex++;
-                    }
+        // end colortbl
+        colorTableBuilder.append("}");
 
-                    auto fgColorIndex = 0;
-                    if (colorMap.find(fgColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        fgColorIndex = colorMap[fgColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(fgColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(fgColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(fgColor.value()))
-                                          << ";";
-                        colorMap[fgColor.value()] = nextColorIndex;
-                        fgColorIndex = nextColorIndex++;
-                    }
+        // Standard RTF header.
+        // This is similar to the header generated by WordPad.
+        // \ansi - specifies that the ANSI char set is used in the current doc
+        // \ansicpg1252 - represents the ANSI code page which is used to perform the Unicode to ANSI conversion when writing RTF text
+        // \deff0 - specifies that the default font for the document is the one at index 0 in the font table
+        // \nouicompat - ?
+        const auto fontTable = fmt::format(FMT_COMPILE("{{\\fonttbl{{\\f0\\fmodern\\fcharset0 {};}}}}"), til::u16u8(fontFaceName));
+        constexpr std::string_view RtfHeader = "{\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
 
-                    contentBuilder << "\\highlight" << bkColorIndex
-                                   << "\\cf" << fgColorIndex
-                                   << " ";
-                }
+        std::string rtfBuilder;
+        rtfBuilder.reserve(RtfHeader.size() + fontTable.size() + colorTableBuilder.size() + contentBuilder.size() + 1);
 
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
-                {
-                    writeAccumulatedChars(true);
-                }
-            }
-        }
+        // start rtf
+        rtfBuilder.append(RtfHeader);
 
-        // end colortbl
-        colorTableBuilder << "}";
+        // font table
+        rtfBuilder.append(fontTable);
 
         // add color table to the final RTF
-        rtfBuilder << colorTableBuilder.str();
+        rtfBuilder.append(colorTableBuilder);
 
         // add the text content to the final RTF
-        rtfBuilder << contentBuilder.str();
+        rtfBuilder.append(contentBuilder);
 
         // end rtf
-        rtfBuilder << "}";
+        rtfBuilder.append("}");
 
-        return rtfBuilder.str();
+        return rtfBuilder;
     }
     catch (...)
     {
@@ -2194,7 +2610,48 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
     }
 }
 
-void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::wstring_view& text)
+// Routine Description:
+// - Returns the total number of characters in the given rows, which
+//   the clipboard formats use to size their buffers up front.
+size_t TextBuffer::_GetClipboardTextSize(const TextAndColor& rows) noexcept
+{
+    size_t size = 0;
+    for (const auto& text : rows.text)
+    {
+        size += text.size();
+    }
+    return size;
+}
+
+// Routine Description:
+// - Calls func with each run of identically colored text in the given row.
+//   CR and LF don't have color attributes and aren't included: the row ends
+//   before the first of them. The formats use their own line breaks instead.
+// Arguments:
+// - rows - the text and color data
+// - row - the index of the row in rows
+// - func - called with the text of the run and its colors
+template<typename T>
+void TextBuffer::_ForEachClipboardRun(const TextAndColor& rows, const size_t row, T&& func)
+{
+    const std::wstring_view text{ rows.text.at(row) };
+    const auto rowLength = std::min(text.size(), text.find_first_of(L"\r\n"));
+
+    size_t offset = 0;
+    for (const auto& run : rows.ColorRuns.at(row))
+    {
+        if (offset >= rowLength)
+        {
+            break;
+        }
+
+        const auto length = std::min(run.length, rowLength - offset);
+        func(text.substr(offset, length), run);
+        offset += length;
+    }
+}
+
+void TextBuffer::_AppendRTFText(std::string& contentBuilder, const std::wstring_view& text)
 {
     for (const auto codeUnit : text)
     {
@@ -2205,16 +2662,17 @@ void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::w
             case L'\\':
             case L'{':
             case L'}':
-                contentBuilder << "\\" << gsl::narrow<char>(codeUnit);
+                contentBuilder.push_back('\\');
+                contentBuilder.push_back(gsl::narrow<char>(codeUnit));
                 break;
             default:
-                contentBuilder << gsl::narrow<char>(codeUnit);
+                contentBuilder.push_back(gsl::narrow<char>(codeUnit));
             }
         }
         else
         {
             // Windows uses unsigned wchar_t - RTF uses signed ones.
-            contentBuilder << "\\u" << std::to_string(til::bit_cast<int16_t>(codeUnit)) << "?";
+            fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\u{}?"), til::bit_cast<int16_t>(codeUnit));
         }
     }
 }
@@ -2233,6 +2691,8 @@ void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::w
 // - positionInfo - Optional. The caller can provide a pair of rows in this
 //   parameter and we'll calculate the position of the _end_ of those rows in
 //   the new buffer. The rows's new value is placed back into this parameter.
+//   The same goes for the positions it holds, which end up on the same
+//   character in the new buffer.
 // Return Value:
 // - S_OK if we successfully copied the contents to the new buffer, otherwise an appropriate HRESULT.
 HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
@@ -2240,6 +2700,12 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                            const std::optional<Viewport> lastCharacterViewport,
                            std::optional<std::reference_wrapper<PositionInformation>> positionInfo)
 {
+    // If only the height changes, nothing needs to be rewrapped.
+    if (oldBuffer.GetSize().Width() == newBuffer.GetSize().Width())
+    {
+        return _ReflowSameWidth(oldBuffer, newBuffer, lastCharacterViewport, positionInfo);
+    }
+
     const auto& oldCursor = oldBuffer.GetCursor();
     auto& newCursor = newBuffer.GetCursor();
 
@@ -2256,6 +2722,41 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
     auto foundOldMutable = false;
     auto foundOldVisible = false;
     auto hr = S_OK;
+
+    // The positions of positionInfo in the order they're encountered while copying the cells.
+    // Their Y is placed relative to the number of rows the new buffer circled by at that point,
+    // so that the positions that were pushed out of it can be told apart in the end.
+    std::vector<til::point*> positions;
+    if (positionInfo.has_value())
+    {
+        for (auto& pos : positionInfo.value().get().positions)
+        {
+            positions.emplace_back(&pos);
+        }
+        std::stable_sort(positions.begin(), positions.end(), [](const til::point* a, const til::point* b) {
+            return *a < *b;
+        });
+    }
+    auto nextPosition = positions.begin();
+    til::CoordType newRowsCircled = 0;
+    auto newFirstRow = newBuffer._firstRow;
+    const auto newBufferHeight = newBuffer.GetSize().Height();
+    const auto countNewRowsCircled = [&]() noexcept {
+        // Every character or newline printed into the new buffer circles it by one row at most.
+        if (newBuffer._firstRow != newFirstRow)
+        {
+            newRowsCircled += (newBuffer._firstRow - newFirstRow + newBufferHeight) % newBufferHeight;
+            newFirstRow = newBuffer._firstRow;
+        }
+    };
+    // Places the positions before the given one in the old buffer at newPos in the new buffer.
+    const auto placePositions = [&](const til::point oldPos, const til::point newPos) noexcept {
+        for (; nextPosition != positions.end() && **nextPosition <= oldPos; ++nextPosition)
+        {
+            **nextPosition = { newPos.x, newPos.y + newRowsCircled };
+        }
+    };
+
     // Loop through all the rows of the old buffer and reprint them into the new buffer
     til::CoordType iOldRow = 0;
     for (; iOldRow < cOldRowsTotal; iOldRow++)
@@ -2311,6 +2812,7 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                 cNewCursorPos = newCursor.GetPosition();
                 fFoundCursorPos = true;
             }
+            placePositions({ iOldCol, iOldRow }, newCursor.GetPosition());
 
             try
             {
@@ -2324,10 +2826,19 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                     hr = E_OUTOFMEMORY;
                     break;
                 }
+                countNewRowsCircled();
             }
             CATCH_RETURN();
         }
 
+        // The positions past the text of the row keep their distance from the end of the text.
+        for (; nextPosition != positions.end() && (*nextPosition)->y == iOldRow; ++nextPosition)
+        {
+            const auto newPos = newCursor.GetPosition();
+            const auto newX = std::min(newPos.x + (*nextPosition)->x - copyRight, newBuffer.GetLineWidth(newPos.y) - 1);
+            **nextPosition = { newX, newPos.y + newRowsCircled };
+        }
+
         // GH#32: Copy the attributes from the rest of the row into this new buffer.
         // From where we are in the old buffer, to the end of the row, copy the
         // remaining attributes.
@@ -2415,6 +2926,7 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                 if (iOldRow < cOldRowsTotal - 1)
                 {
                     hr = newBuffer.NewlineCursor() ? hr : E_OUTOFMEMORY;
+                    countNewRowsCircled();
                 }
                 else
                 {
@@ -2448,6 +2960,7 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                         if (newBuffer.GetRowByOffset(coordNewCursor.Y - 1).WasWrapForced())
                         {
                             hr = newBuffer.NewlineCursor() ? hr : E_OUTOFMEMORY;
+                            countNewRowsCircled();
                         }
                     }
                 }
@@ -2479,9 +2992,20 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         newRow.GetAttrRow() = row.GetAttrRow();
         newRow.GetAttrRow().Resize(newWidth);
 
+        for (; nextPosition != positions.end() && (*nextPosition)->y == iOldRow; ++nextPosition)
+        {
+            **nextPosition = { std::min((*nextPosition)->x, newWidth - 1), newRowY + newRowsCircled };
+        }
+
         newRowY++;
     }
 
+    // Whatever is left was below the bottom of the new buffer.
+    for (; nextPosition != positions.end(); ++nextPosition)
+    {
+        **nextPosition = { std::min((*nextPosition)->x, newBuffer.GetSize().Width() - 1), newBufferHeight - 1 + newRowsCircled };
+    }
+
     if (SUCCEEDED(hr))
     {
         // Finish copying remaining parameters from the old text buffer to the new one
@@ -2542,6 +3066,13 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         }
     }
 
+    // Advancing the cursor may have circled the buffer as well.
+    countNewRowsCircled();
+    for (const auto pos : positions)
+    {
+        pos->y -= newRowsCircled;
+    }
+
     if (SUCCEEDED(hr))
     {
         // Save old cursor size before we delete it
@@ -2554,6 +3085,61 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
     return hr;
 }
 
+// Function Description:
+// - Reflow() for buffers of the same width. Since no row needs to be
+//   rewrapped, the rows are copied over one by one. If the new buffer is
+//   shorter, the topmost rows are dropped, as if they had scrolled out of the
+//   new buffer while being printed into it.
+// Arguments:
+// - See Reflow()
+// Return Value:
+// - S_OK if we successfully copied the contents to the new buffer, otherwise an appropriate HRESULT.
+HRESULT TextBuffer::_ReflowSameWidth(const TextBuffer& oldBuffer,
+                                     TextBuffer& newBuffer,
+                                     const std::optional<Viewport> lastCharacterViewport,
+                                     std::optional<std::reference_wrapper<PositionInformation>> positionInfo)
+{
+    const auto& oldCursor = oldBuffer.GetCursor();
+    auto& newCursor = newBuffer.GetCursor();
+
+    const auto cOldCursorPos = oldCursor.GetPosition();
+    const auto cOldLastChar = oldBuffer.GetLastNonSpaceCharacter(lastCharacterViewport);
+    const auto oldHeight = oldBuffer.GetSize().Height();
+    const auto newHeight = newBuffer.GetSize().Height();
+
+    // Keep everything up to the last character and the cursor, whichever comes last.
+    const auto cOldRowsUsed = std::max(cOldLastChar.Y, cOldCursorPos.Y) + 1;
+    const auto shift = std::max(0, cOldRowsUsed - newHeight);
+
+    // The rows below the used ones are copied too, since they might still carry attributes. See GH #12567
+    const auto cRowsCopied = std::min(oldHeight - shift, newHeight);
+    for (til::CoordType y = 0; y < cRowsCopied; ++y)
+    {
+        RETURN_IF_FAILED(newBuffer.GetRowByOffset(y).CopyFrom(oldBuffer.GetRowByOffset(y + shift)));
+    }
+
+    if (positionInfo.has_value())
+    {
+        auto& info = positionInfo.value().get();
+        info.mutableViewportTop = std::max(0, info.mutableViewportTop - shift);
+        info.visibleViewportTop = std::max(0, info.visibleViewportTop - shift);
+        for (auto& pos : info.positions)
+        {
+            pos.y = std::min(pos.y - shift, newHeight - 1);
+        }
+    }
+
+    // Finish copying remaining parameters from the old text buffer to the new one
+    newBuffer.CopyProperties(oldBuffer);
+    newBuffer.CopyHyperlinkMaps(oldBuffer);
+    newBuffer.CopyPatterns(oldBuffer);
+
+    newCursor.SetPosition({ cOldCursorPos.X, cOldCursorPos.Y - shift });
+    newCursor.SetSize(oldCursor.GetSize());
+
+    return S_OK;
+}
+
 // Method Description:
 // - Adds or updates a hyperlink in our hyperlink table
 // Arguments:
@@ -2591,17 +3177,23 @@ uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
     }
     else
     {
-        // assign _currentHyperlinkId if the custom id does not already exist
-        std::wstring newId{ id };
         // hash the URL and add it to the custom ID - GH#7698
-        newId += L"%" + std::to_wstring(til::hash(uri));
-        const auto result = _hyperlinkCustomIdMap.emplace(newId, _currentHyperlinkId);
-        if (result.second)
+        fmt::basic_memory_buffer<wchar_t, 128> buffer;
+        fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"{}%{}"), id, til::hash(uri));
+        const std::wstring_view customId{ buffer.data(), buffer.size() };
+
+        if (const auto it = _hyperlinkCustomIdMap.find(customId); it != _hyperlinkCustomIdMap.end())
         {
-            // the custom id did not already exist
+            numericId = it->second;
+        }
+        else
+        {
+            // the custom id did not already exist, assign _currentHyperlinkId
+            const auto result = _hyperlinkCustomIdMap.emplace(customId, _currentHyperlinkId);
+            _hyperlinkCustomIds.insert_or_assign(_currentHyperlinkId, result.first->first);
+            numericId = _currentHyperlinkId;
             ++_currentHyperlinkId;
         }
-        numericId = (*(result.first)).second;
     }
     // _currentHyperlinkId could overflow, make sure its not 0
     if (_currentHyperlinkId == 0)
@@ -2619,13 +3211,13 @@ uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
 void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
 {
     _hyperlinkMap.erase(id);
-    for (const auto& customIdPair : _hyperlinkCustomIdMap)
+    if (const auto it = _hyperlinkCustomIds.find(id); it != _hyperlinkCustomIds.end())
     {
-        if (customIdPair.second == id)
+        if (const auto customIt = _hyperlinkCustomIdMap.find(it->second); customIt != _hyperlinkCustomIdMap.end())
         {
-            _hyperlinkCustomIdMap.erase(customIdPair.first);
-            break;
+            _hyperlinkCustomIdMap.erase(customIt);
         }
+        _hyperlinkCustomIds.erase(it);
     }
 }
 
@@ -2638,14 +3230,207 @@ void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
 // - The custom ID if there was one, empty string otherwise
 std::wstring TextBuffer::GetCustomIdFromId(uint16_t id) const
 {
-    for (auto customIdPair : _hyperlinkCustomIdMap)
+    if (const auto it = _hyperlinkCustomIds.find(id); it != _hyperlinkCustomIds.end())
     {
-        if (customIdPair.second == id)
+        return std::wstring{ it->second };
+    }
+    return {};
+}
+
+// Snapshots start with these, see Serialize(). Snapshots of other versions are ignored.
+static constexpr uint32_t SnapshotMagic = 0x42535457; // "WTSB"
+static constexpr uint32_t SnapshotVersion = 1;
+
+// Method Description:
+// - Appends a binary snapshot of the first rows of this buffer to the given
+//   vector, so that it can be restored with Deserialize() after a restart.
+//   It contains the rows' text and attribute runs, the hyperlinks and the cursor position.
+// - Frozen rows are stored without thawing them, in the same compact form they already have.
+// Arguments:
+// - snapshot - the vector to append the snapshot to
+// - rowCount - the number of rows to store, starting at the top of the buffer
+void TextBuffer::Serialize(std::vector<std::byte>& snapshot, til::CoordType rowCount) const
+{
+    rowCount = std::clamp(rowCount, 0, TotalRowCount());
+
+    SnapshotWriter writer{ snapshot };
+    writer.Write(SnapshotMagic);
+    writer.Write(SnapshotVersion);
+    writer.Write(rowCount);
+    writer.Write(_cursor.GetPosition().x);
+    writer.Write(_cursor.GetPosition().y);
+
+    // The rows refer to the attributes by their index in the table, so we
+    // simply store the entire table, just like the rows' runs.
+    std::vector<TextAttribute> attributes;
+    attributes.reserve(_attributeTable.size());
+    for (size_t i = 0; i < _attributeTable.size(); ++i)
+    {
+        attributes.emplace_back(_attributeTable.Get(gsl::narrow_cast<TextAttributeTable::Index>(i)));
+    }
+    writer.WriteArray(std::span<const TextAttribute>{ attributes });
+
+    writer.Write(gsl::narrow<uint32_t>(_hyperlinkMap.size()));
+    for (const auto& [id, uri] : _hyperlinkMap)
+    {
+        const auto customId = GetCustomIdFromId(id);
+        writer.Write(id);
+        writer.WriteArray(std::span<const wchar_t>{ uri });
+        writer.WriteArray(std::span<const wchar_t>{ customId });
+    }
+
+    // We access the rows directly instead of through GetRowByOffset, which would thaw them.
+    const std::scoped_lock lock{ _thawLock };
+    std::vector<wchar_t> text;
+    for (til::CoordType y = 0; y < rowCount; ++y)
+    {
+        const auto& row = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + y) % _storage.size());
+        const auto handle = row.GetSpillHandle();
+
+        text.clear();
+        row.AppendSnapshot(text, handle ? _scrollbackSpill->Load(*handle) : nullptr);
+
+        const auto& runs = row.GetAttrRow().Runs();
+        const uint8_t flags = (row.WasWrapForced() ? 1 : 0) | (row.WasDoubleBytePadded() ? 2 : 0);
+        writer.Write(row.GetLineRendition());
+        writer.Write(flags);
+        writer.WriteArray(std::span<const wchar_t>{ text });
+        writer.WriteArray(std::span<const ATTR_ROW::run_type>{ runs.data(), runs.size() });
+    }
+}
+
+// Method Description:
+// - Restores a snapshot created by Serialize() into the top rows of this buffer,
+//   which is expected to be blank. The snapshot may have been taken from a buffer
+//   of another size: rows are truncated to our width and if there are more than
+//   maxRows rows, only the last maxRows of them are restored.
+// Arguments:
+// - reader - the snapshot. Receives the data that follows the snapshot, if any.
+// - maxRows - the maximum number of rows to restore
+// Return Value:
+// - A description of what was restored, or nullopt if the snapshot is malformed
+//   or of another version. Some rows might have been restored regardless.
+std::optional<TextBuffer::SnapshotInfo> TextBuffer::Deserialize(SnapshotReader& reader, const til::CoordType maxRows)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    til::CoordType rowCount = 0;
+    til::point cursor;
+    if (!reader.Read(magic) || magic != SnapshotMagic ||
+        !reader.Read(version) || version != SnapshotVersion ||
+        !reader.Read(rowCount) || rowCount < 0 ||
+        !reader.Read(cursor.x) || !reader.Read(cursor.y))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<TextAttribute> attributes;
+    if (!reader.ReadArray(attributes))
+    {
+        return std::nullopt;
+    }
+
+    // The hyperlinks get new IDs, so that they don't collide with any we might already have.
+    uint32_t hyperlinkCount = 0;
+    if (!reader.Read(hyperlinkCount))
+    {
+        return std::nullopt;
+    }
+
+    std::unordered_map<uint16_t, uint16_t> hyperlinkIds;
+    std::vector<wchar_t> uri;
+    std::vector<wchar_t> customId;
+    for (uint32_t i = 0; i < hyperlinkCount; ++i)
+    {
+        uint16_t id = 0;
+        if (!reader.Read(id) || !reader.ReadArray(uri) || !reader.ReadArray(customId))
+        {
+            return std::nullopt;
+        }
+
+        uint16_t newId = 0;
+        std::wstring custom{ customId.begin(), customId.end() };
+        if (custom.empty())
+        {
+            newId = _currentHyperlinkId++;
+        }
+        else if (const auto it = _hyperlinkCustomIdMap.find(custom); it != _hyperlinkCustomIdMap.end())
+        {
+            newId = it->second;
+        }
+        else
         {
-            return customIdPair.first;
+            newId = _currentHyperlinkId++;
+            const auto result = _hyperlinkCustomIdMap.emplace(std::move(custom), newId);
+            _hyperlinkCustomIds.insert_or_assign(newId, result.first->first);
         }
+
+        _hyperlinkMap.insert_or_assign(newId, std::wstring{ uri.begin(), uri.end() });
+        hyperlinkIds.emplace(id, newId);
     }
-    return {};
+
+    std::vector<TextAttributeTable::Index> remap;
+    remap.reserve(attributes.size());
+    for (auto attr : attributes)
+    {
+        if (attr.IsHyperlink())
+        {
+            const auto it = hyperlinkIds.find(attr.GetHyperlinkId());
+            attr.SetHyperlinkId(it != hyperlinkIds.end() ? it->second : 0);
+        }
+        remap.emplace_back(_attributeTable.Intern(attr));
+    }
+
+    const auto width = GetSize().Width();
+    const auto skippedRows = std::max(0, rowCount - std::max(0, maxRows));
+    std::vector<wchar_t> text;
+    std::vector<ATTR_ROW::run_type> runs;
+    std::vector<ATTR_ROW::run_type> restoredRuns;
+
+    for (til::CoordType y = 0; y < rowCount; ++y)
+    {
+        auto lineRendition = LineRendition::SingleWidth;
+        uint8_t flags = 0;
+        if (!reader.Read(lineRendition) || !reader.Read(flags) || !reader.ReadArray(text) || !reader.ReadArray(runs))
+        {
+            return std::nullopt;
+        }
+        if (y < skippedRows)
+        {
+            continue;
+        }
+
+        auto& row = GetRowByOffset(y - skippedRows);
+        row.Reset(_currentAttributes);
+        if (!row.RestoreSnapshot(text) || static_cast<unsigned int>(lineRendition) > static_cast<unsigned int>(LineRendition::DoubleHeightBottom))
+        {
+            return std::nullopt;
+        }
+        row.SetLineRendition(lineRendition);
+        row.SetWrapForced(WI_IsFlagSet(flags, 1));
+        row.SetDoubleBytePadded(WI_IsFlagSet(flags, 2));
+
+        // The runs have to be truncated to our width as well.
+        til::CoordType column = 0;
+        restoredRuns.clear();
+        for (const auto& run : runs)
+        {
+            if (run.value >= remap.size())
+            {
+                return std::nullopt;
+            }
+            const auto length = std::min<til::CoordType>(run.length, width - column);
+            if (length <= 0)
+            {
+                break;
+            }
+            restoredRuns.emplace_back(til::at(remap, run.value), gsl::narrow_cast<uint16_t>(length));
+            column += length;
+        }
+        row.GetAttrRow().ReplaceRuns(0, column, restoredRuns);
+    }
+
+    return SnapshotInfo{ rowCount - skippedRows, skippedRows, cursor };
 }
 
 // Method Description:
@@ -2658,19 +3443,40 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
     _hyperlinkMap = other._hyperlinkMap;
     _hyperlinkCustomIdMap = other._hyperlinkCustomIdMap;
     _currentHyperlinkId = other._currentHyperlinkId;
+
+    // _hyperlinkCustomIds has to refer to the keys of our own copy of the map.
+    _hyperlinkCustomIds.clear();
+    for (const auto& [customId, id] : _hyperlinkCustomIdMap)
+    {
+        _hyperlinkCustomIds.insert_or_assign(id, customId);
+    }
 }
 
 // Method Description:
 // - Adds a regex pattern we should search for
 // - The searching does not happen here, we only search when asked to by TerminalCore
+// - The regex is compiled right away, so that it doesn't need to be compiled for every search.
+//   It's matched in linear time by a RegexMatcher, unless it uses features only std::wregex supports.
 // Arguments:
 // - The regex pattern
 // Return value:
 // - An ID that the caller should associate with the given pattern
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
+    PatternRecognizer recognizer;
+    recognizer.isUrlPattern = regexString == UrlPattern;
+    if (!recognizer.isUrlPattern)
+    {
+        recognizer.matcher = RegexMatcher::Compile(regexString, false);
+        if (!recognizer.matcher)
+        {
+            recognizer.regex.assign(regexString.data(), regexString.size());
+        }
+    }
+
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(_currentPatternId, std::move(recognizer));
+    _patternCache.clear();
     return _currentPatternId;
 }
 
@@ -2680,6 +3486,7 @@ void TextBuffer::ClearPatternRecognizers() noexcept
 {
     _idsAndPatterns.clear();
     _currentPatternId = 0;
+    _patternCache.clear();
 }
 
 // Method Description:
@@ -2690,10 +3497,15 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 {
     _idsAndPatterns = OtherBuffer._idsAndPatterns;
     _currentPatternId = OtherBuffer._currentPatternId;
+    _patternCache.clear();
 }
 
 // Method Description:
 // - Finds patterns within the requested region of the text buffer
+// - The text of each line (a row and the rows it wrapped into) is matched on
+//   its own, so that patterns can continue into the next row if it wrapped.
+//   The results are cached per line (see _GetLinePatterns), which makes
+//   calling this again for lines that didn't change cheap.
 // Arguments:
 // - The firstRow to start searching from
 // - The lastRow to search
@@ -2702,62 +3514,216 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::CoordType lastRow) const
 {
     PointTree::interval_vector intervals;
-
-    std::wstring concatAll;
-    const auto rowSize = GetRowByOffset(0).size();
-    concatAll.reserve(gsl::narrow_cast<size_t>(rowSize) * gsl::narrow_cast<size_t>(lastRow - firstRow + 1));
-
-    // to deal with text that spans multiple lines, we will first concatenate
-    // all the text into one string and find the patterns in that string
-    for (til::CoordType i = firstRow; i <= lastRow; ++i)
+    if (_idsAndPatterns.empty())
     {
-        auto& row = GetRowByOffset(i);
-        concatAll += row.GetText();
+        return PointTree{};
     }
 
-    // for each pattern we know of, iterate through the string
-    for (const auto& idAndPattern : _idsAndPatterns)
+    // A line that wrapped into the region might have started above it.
+    auto lineStart = std::max(firstRow, 0);
+    while (lineStart > 0 && GetRowByOffset(lineStart - 1).WasWrapForced())
     {
-        std::wregex regexObj{ idAndPattern.second };
+        --lineStart;
+    }
+
+    const auto totalRows = TotalRowCount();
+    const auto lastLineRow = std::min(lastRow, totalRows - 1);
 
-        // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
-        auto words_end = std::wsregex_iterator();
+    std::wstring line;
+    // The offset of each row's text in line and the row.
+    std::vector<std::pair<size_t, const ROW*>> lineRows;
 
-        til::CoordType lenUpToThis = 0;
-        for (auto i = words_begin; i != words_end; ++i)
+    while (lineStart <= lastLineRow)
+    {
+        line.clear();
+        lineRows.clear();
+
+        auto y = lineStart;
+        for (;;)
         {
-            // record the locations -
-            // when we find a match, the prefix is text that is between this
-            // match and the previous match, so we use the size of the prefix
-            // along with the size of the match to determine the locations
-            til::CoordType prefixSize = 0;
-            for (const auto parsedGlyph : Utf16Parser::Parse(i->prefix().str()))
+            const auto& row = GetRowByOffset(y++);
+            const auto& charRow = row.GetCharRow();
+            const auto wrapped = row.WasWrapForced() && y < totalRows;
+
+            auto chars = charRow.GetChars();
+            // Leave out the padding that pushed a wide glyph into the next row.
+            if (wrapped && row.WasDoubleBytePadded())
             {
-                const std::wstring_view glyph{ parsedGlyph.data(), parsedGlyph.size() };
-                prefixSize += IsGlyphFullWidth(glyph) ? 2 : 1;
+                chars = chars.substr(0, charRow.GetCharOffset(charRow.size() - 1));
             }
-            const auto start = lenUpToThis + prefixSize;
-            til::CoordType matchSize = 0;
-            for (const auto parsedGlyph : Utf16Parser::Parse(i->str()))
+
+            lineRows.emplace_back(line.size(), &row);
+            line.append(chars);
+
+            if (!wrapped)
             {
-                const std::wstring_view glyph{ parsedGlyph.data(), parsedGlyph.size() };
-                matchSize += IsGlyphFullWidth(glyph) ? 2 : 1;
+                break;
             }
-            const auto end = start + matchSize;
-            lenUpToThis = end;
-
-            const til::point startCoord{ start % rowSize, start / rowSize };
-            const til::point endCoord{ end % rowSize, end / rowSize };
+        }
 
-            // store the intervals
+        for (const auto& match : _GetLinePatterns(*lineRows.front().second, line, lineRows))
+        {
             // NOTE: these intervals are relative to the VIEWPORT not the buffer
             // Keeping these relative to the viewport for now because its the renderer
             // that actually uses these locations and the renderer works relative to
             // the viewport
-            intervals.push_back(PointTree::interval(startCoord, endCoord, idAndPattern.first));
+            const til::point start{ match.start.X, match.start.Y + lineStart - firstRow };
+            const til::point end{ match.end.X, match.end.Y + lineStart - firstRow };
+            if (end.Y >= 0 && start.Y <= lastRow - firstRow)
+            {
+                intervals.push_back(PointTree::interval(start, end, match.id));
+            }
         }
+
+        lineStart = y;
     }
+
     PointTree result(std::move(intervals));
     return result;
 }
+
+// Method Description:
+// - Finds the patterns in the text of a line, or returns the ones found the
+//   last time if the text hasn't changed since.
+// Arguments:
+// - firstRow - the first row of the line
+// - line - the text of the line. Trailing halves of wide glyphs repeat their
+//   leading half, see CharRow::GetChars().
+// - lineRows - the offset of the text of each row of the line in line and the row
+// Return value:
+// - The patterns found, relative to the start of the line. End positions are exclusive.
+const std::vector<TextBuffer::PatternMatch>& TextBuffer::_GetLinePatterns(const ROW& firstRow,
+                                                                          const std::wstring_view line,
+                                                                          const std::vector<std::pair<size_t, const ROW*>>& lineRows) const
+{
+    const auto hash = til::hasher{ lineRows.size() }.write(line.data(), line.size()).finalize();
+
+    auto& entry = _patternCache[firstRow.GetId()];
+    if (entry.hash == hash)
+    {
+        return entry.matches;
+    }
+
+    entry.hash = hash;
+    entry.matches.clear();
+
+    // Returns the position of the cell holding the given code unit of line.
+    const auto cellAt = [&](const size_t offset) {
+        const auto it = std::prev(std::upper_bound(lineRows.begin(), lineRows.end(), offset, [](const size_t value, const auto& lineRow) {
+            return value < lineRow.first;
+        }));
+        const auto column = it->second->GetCharRow().GetColumnAtCharOffset(offset - it->first);
+        return til::point{ column, gsl::narrow_cast<til::CoordType>(it - lineRows.begin()) };
+    };
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const auto& [id, recognizer] : _idsAndPatterns)
+    {
+        ranges.clear();
+        if (recognizer.isUrlPattern)
+        {
+            _FindUrls(line, ranges);
+        }
+        else if (recognizer.matcher)
+        {
+            recognizer.matcher->FindAll(line, ranges);
+            std::erase_if(ranges, [](const auto& range) { return range.first == range.second; });
+        }
+        else
+        {
+            const auto end = std::wcregex_iterator{};
+            for (auto it = std::wcregex_iterator{ line.data(), line.data() + line.size(), recognizer.regex }; it != end; ++it)
+            {
+                if (it->length() > 0)
+                {
+                    const auto begin = gsl::narrow_cast<size_t>(it->position());
+                    ranges.emplace_back(begin, begin + gsl::narrow_cast<size_t>(it->length()));
+                }
+            }
+        }
+
+        for (const auto& [begin, end] : ranges)
+        {
+            const auto start = cellAt(begin);
+            auto last = cellAt(end - 1);
+            // The end is exclusive. Past the end of a row it's the start of the next one.
+            if (++last.X >= lineRows.at(last.Y).second->size())
+            {
+                last = { 0, last.Y + 1 };
+            }
+            entry.matches.push_back({ start, last, id });
+        }
+    }
+
+    return entry.matches;
+}
+
+// Method Description:
+// - Finds URLs the same way matching UrlPattern with a std::wregex would,
+//   but an order of magnitude faster: "://" is searched for with
+//   wstring_view::find and only then the scheme before and the rest of the
+//   URL after it are checked.
+// Arguments:
+// - text - the text to search
+// - matches - receives the [begin, end) offsets of each URL in text
+void TextBuffer::_FindUrls(const std::wstring_view text, std::vector<std::pair<size_t, size_t>>& matches)
+{
+    static constexpr std::array<std::wstring_view, 4> schemes{ L"https", L"http", L"ftp", L"file" };
+    static constexpr std::wstring_view separator{ L"://" };
+
+    const auto isAlphanumeric = [](const wchar_t ch) noexcept {
+        return (ch >= L'0' && ch <= L'9') || (ch >= L'A' && ch <= L'Z') || (ch >= L'a' && ch <= L'z');
+    };
+    // \w
+    const auto isWordChar = [&](const wchar_t ch) noexcept {
+        return isAlphanumeric(ch) || ch == L'_';
+    };
+    // [-A-Za-z0-9+&@#/%?=~_|$!:,.;]
+    const auto isUrlChar = [&](const wchar_t ch) noexcept {
+        return isAlphanumeric(ch) || std::wstring_view{ L"-+&@#/%?=~_|$!:,.;" }.find(ch) != std::wstring_view::npos;
+    };
+    // [A-Za-z0-9+&@#/%=~_|$]
+    const auto isUrlEndChar = [&](const wchar_t ch) noexcept {
+        return isAlphanumeric(ch) || std::wstring_view{ L"+&@#/%=~_|$" }.find(ch) != std::wstring_view::npos;
+    };
+
+    // Matches can't overlap, so the scheme of the next URL has to start past the previous URL.
+    size_t searchStart = 0;
+    for (auto pos = text.find(separator); pos != std::wstring_view::npos; pos = text.find(separator, pos + 1))
+    {
+        size_t begin = 0;
+        const auto scheme = std::find_if(schemes.begin(), schemes.end(), [&](const auto& candidate) {
+            if (pos < searchStart + candidate.size() || text.substr(pos - candidate.size(), candidate.size()) != candidate)
+            {
+                return false;
+            }
+            // The scheme has to start at a word boundary (\b).
+            begin = pos - candidate.size();
+            return begin == 0 || !isWordChar(til::at(text, begin - 1));
+        });
+        if (scheme == schemes.end())
+        {
+            continue;
+        }
+
+        // [...]*[...] is greedy: the URL is the longest run of URL characters,
+        // cut back to the last character the URL may end with.
+        auto end = pos + separator.size();
+        auto runEnd = end;
+        while (runEnd < text.size() && isUrlChar(til::at(text, runEnd)))
+        {
+            if (isUrlEndChar(til::at(text, runEnd)))
+            {
+                end = runEnd + 1;
+            }
+            ++runEnd;
+        }
+
+        if (end > pos + separator.size())
+        {
+            matches.emplace_back(begin, end);
+            searchStart = end;
+            pos = end - 1;
+        }
+    }
+}
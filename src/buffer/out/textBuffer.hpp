@@ -51,10 +51,15 @@ filling in the last row, and updating the screen.
 
 #include <vector>
 
+#include <til/hash.h>
+#include <til/ticket_lock.h>
+
 #include "cursor.h"
+#include "RegexMatcher.hpp"
 #include "Row.hpp"
+#include "ScrollbackSpill.hpp"
+#include "SnapshotStream.hpp"
 #include "TextAttribute.hpp"
-#include "UnicodeStorage.hpp"
 #include "../types/inc/Viewport.hpp"
 
 #include "../buffer/out/textBufferCellIterator.hpp"
@@ -82,6 +87,8 @@ public:
     const ROW& GetRowByOffset(const til::CoordType index) const noexcept;
     ROW& GetRowByOffset(const til::CoordType index) noexcept;
 
+    TextAttributeTable& GetAttributeTable() noexcept;
+
     TextBufferCellIterator GetCellDataAt(const til::point at) const;
     TextBufferCellIterator GetCellLineDataAt(const til::point at) const;
     TextBufferCellIterator GetCellDataAt(const til::point at, const Microsoft::Console::Types::Viewport limit) const;
@@ -101,6 +108,10 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    void FillRect(const til::rect& rect, const wchar_t fillChar, const TextAttribute& fillAttrs);
+    size_t FillCells(const til::point target, const size_t count, const std::optional<wchar_t> fillChar, const std::optional<TextAttribute>& fillAttrs);
+    void ShiftCells(const til::rect& rect, const til::CoordType delta);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -128,6 +139,7 @@ public:
 
     void SetCurrentLineRendition(const LineRendition lineRendition);
     void ResetLineRenditionRange(const til::CoordType startRow, const til::CoordType endRow) noexcept;
+    void FreezeRows(const til::CoordType startRow, const til::CoordType endRow) noexcept;
     LineRendition GetLineRendition(const til::CoordType row) const noexcept;
     bool IsDoubleWidthLine(const til::CoordType row) const noexcept;
 
@@ -140,8 +152,8 @@ public:
 
     [[nodiscard]] HRESULT ResizeTraditional(const til::size newSize) noexcept;
 
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    UnicodeStorage& GetUnicodeStorage() noexcept;
+    void SetScrollbackSpill(const bool enabled) noexcept;
+    size_t GetMemoryFootprint() const noexcept;
 
     void SetAsActiveBuffer(const bool isActiveBuffer) noexcept;
     bool IsActiveBuffer() const noexcept;
@@ -153,8 +165,13 @@ public:
     void TriggerRedrawAll();
     void TriggerScroll();
     void TriggerScroll(const til::point delta);
+    void TriggerScrollRegion(const Microsoft::Console::Types::Viewport& region, const til::CoordType delta);
     void TriggerNewTextNotification(const std::wstring_view newText);
 
+    std::vector<til::rect> ConsumeDirtyRows(const til::CoordType firstRow, const til::CoordType lastRow) const;
+    uint64_t GetPaintedGeneration() const noexcept;
+    bool WereRowsModifiedSince(const til::CoordType firstRow, const til::CoordType lastRow, const uint64_t generation) const noexcept;
+
     til::point GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
     til::point GetWordEnd(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
     bool MoveToNextWord(til::point& pos, const std::wstring_view wordDelimiters, std::optional<til::point> limitOptional = std::nullopt) const;
@@ -166,6 +183,7 @@ public:
     bool MoveToPreviousGlyph(til::point& pos, std::optional<til::point> limitOptional = std::nullopt) const;
 
     const std::vector<til::inclusive_rect> GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const;
+    const std::vector<til::inclusive_rect> GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, til::CoordType firstRow, til::CoordType lastRow) const;
 
     void AddHyperlinkToMap(std::wstring_view uri, uint16_t id);
     std::wstring GetHyperlinkUriFromId(uint16_t id) const;
@@ -174,12 +192,34 @@ public:
     std::wstring GetCustomIdFromId(uint16_t id) const;
     void CopyHyperlinkMaps(const TextBuffer& OtherBuffer);
 
+    // Describes what Deserialize() restored.
+    struct SnapshotInfo
+    {
+        // the number of rows restored, starting at the top of the buffer
+        til::CoordType rows = 0;
+        // the number of rows at the top of the snapshot that didn't fit into the buffer
+        til::CoordType skippedRows = 0;
+        // the position of the cursor when the snapshot was taken
+        til::point cursor;
+    };
+
+    void Serialize(std::vector<std::byte>& snapshot, const til::CoordType rowCount) const;
+    std::optional<SnapshotInfo> Deserialize(SnapshotReader& reader, const til::CoordType maxRows);
+
     class TextAndColor
     {
     public:
+        // A run of consecutive characters with the same colors.
+        struct ColorRun
+        {
+            size_t length;
+            COLORREF fg;
+            COLORREF bk;
+        };
+
         std::vector<std::wstring> text;
-        std::vector<std::vector<COLORREF>> FgAttr;
-        std::vector<std::vector<COLORREF>> BkAttr;
+        // The colors of each row in text, as runs that add up to its length. Empty if no colors were requested.
+        std::vector<std::vector<ColorRun>> ColorRuns;
     };
 
     const TextAndColor GetText(const bool includeCRLF,
@@ -202,6 +242,9 @@ public:
     {
         til::CoordType mutableViewportTop{ 0 };
         til::CoordType visibleViewportTop{ 0 };
+        // Any other positions in the old buffer, which are replaced with the same
+        // positions in the new buffer. Positions that didn't fit get a negative Y.
+        std::span<til::point> positions{};
     };
 
     static HRESULT Reflow(TextBuffer& oldBuffer,
@@ -209,6 +252,10 @@ public:
                           const std::optional<Microsoft::Console::Types::Viewport> lastCharacterViewport,
                           std::optional<std::reference_wrapper<PositionInformation>> positionInfo);
 
+    // The pattern of the URLs Terminal detects. Rather than with a std::wregex
+    // it is matched with a hand-written scanner, see _FindUrls.
+    static constexpr std::wstring_view UrlPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
+
     const size_t AddPatternRecognizer(const std::wstring_view regexString);
     void ClearPatternRecognizers() noexcept;
     void CopyPatterns(const TextBuffer& OtherBuffer);
@@ -217,24 +264,82 @@ public:
 private:
     void _UpdateSize();
     Microsoft::Console::Types::Viewport _size;
+    // The character data of all rows, see CharRow. Each ROW in _storage
+    // points at its own stride sized slice of the slab. The slab is only
+    // reserved up front and committed in chunks of chunkRows rows while any
+    // of the rows in a chunk is thawed (see _ThawRow and _FreezeRow).
+    struct CharBuffer
+    {
+        wil::unique_virtualalloc_ptr<std::byte> slab;
+        size_t stride = 0;
+        size_t chunkRows = 0;
+        size_t chunkBytes = 0;
+        // the number of thawed rows in each chunk
+        std::vector<til::CoordType> hotRows;
+    };
+    CharBuffer _charBuffer;
+    // The attributes the ATTR_ROWs of _storage refer to. See _CompactAttributes.
+    TextAttributeTable _attributeTable;
     std::vector<ROW> _storage;
     Cursor _cursor;
 
     til::CoordType _firstRow; // indexes top row (not necessarily 0)
 
-    TextAttribute _currentAttributes;
+    // Rows that scroll this far away from the bottom of the buffer get frozen, see IncrementCircularBuffer.
+    static constexpr til::CoordType _hotRowDistance = 1024;
 
-    // storage location for glyphs that can't fit into the buffer normally
-    UnicodeStorage _unicodeStorage;
+    // If enabled, frozen rows are moved into a temporary file, see SetScrollbackSpill.
+    bool _spillScrollback;
+    std::unique_ptr<ScrollbackSpill> _scrollbackSpill;
+
+    // The Terminal lets several readers access the buffer at once (see Terminal::LockForReading).
+    // Everything those readers may modify behind the scenes is guarded by these:
+    // _thawLock serializes thawing rows in GetRowByOffset (including _charBuffer and _scrollbackSpill),
+    // _delimiterClassCacheLock guards _delimiterClassCache. ConsumeDirtyRows is only called by the
+    // renderer and GetPatterns only under a write lock, so they don't need one.
+    mutable til::ticket_lock _thawLock;
+    mutable til::ticket_lock _delimiterClassCacheLock;
+
+    TextAttribute _currentAttributes;
 
     bool _isActiveBuffer;
     Microsoft::Console::Render::Renderer& _renderer;
 
+    // The latest ROW generation the renderer has invalidated, see ConsumeDirtyRows.
+    mutable uint64_t _paintedGeneration;
+
+    // The delimiter classes of the row that word navigation looked at last, see _GetDelimiterClassAt.
+    // Since ROW generations are unique, the row identity plus its generation tell whether it's stale.
+    struct DelimiterClassCache
+    {
+        const ROW* row = nullptr;
+        uint64_t generation = 0;
+        std::wstring wordDelimiters;
+        DelimiterClassifier classifier;
+        std::vector<DelimiterClass> classes;
+    };
+    mutable DelimiterClassCache _delimiterClassCache;
+
     std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
-    std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
+    // Allows looking up custom IDs without turning them into a std::wstring first.
+    std::unordered_map<std::wstring, uint16_t, til::transparent_string_hash<wchar_t>, std::equal_to<>> _hyperlinkCustomIdMap;
+    // The keys of _hyperlinkCustomIdMap by their hyperlink ID, so that removing
+    // a hyperlink doesn't have to search the entire map for its custom ID.
+    std::unordered_map<uint16_t, std::wstring_view> _hyperlinkCustomIds;
     uint16_t _currentHyperlinkId;
 
-    void _RefreshRowIDs(std::optional<til::CoordType> newRowWidth);
+    void _RefreshRowIDs() noexcept;
+    void _RotateRows(const til::CoordType first, const til::CoordType middle, const til::CoordType last) noexcept;
+
+    static CharBuffer _AllocateCharBuffer(const til::size size);
+    static std::byte* _GetRowCharBuffer(const CharBuffer& buffer, const til::CoordType index) noexcept;
+    static void _CommitRowCharBuffer(CharBuffer& buffer, const std::byte* const slice) noexcept;
+    static void _DecommitRowCharBuffer(CharBuffer& buffer, const std::byte* const slice) noexcept;
+
+    void _ThawRow(ROW& row) noexcept;
+    void _FreezeRow(ROW& row) noexcept;
+    void _SpillRow(ROW& row) noexcept;
+    void _ReleaseSpilledRow(ROW& row) noexcept;
 
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
 
@@ -253,17 +358,60 @@ private:
     void _ExpandTextRow(til::inclusive_rect& selectionRow) const;
 
     DelimiterClass _GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const;
+    const std::vector<DelimiterClass>& _GetDelimiterClasses(const til::CoordType y, const std::wstring_view wordDelimiters) const;
     til::point _GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
     til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
 
     void _PruneHyperlinks();
+    void _CompactAttributes();
+
+    static size_t _GetClipboardTextSize(const TextAndColor& rows) noexcept;
+    template<typename T>
+    static void _ForEachClipboardRun(const TextAndColor& rows, const size_t row, T&& func);
+    static void _AppendRTFText(std::string& contentBuilder, const std::wstring_view& text);
+
+    static HRESULT _ReflowSameWidth(const TextBuffer& oldBuffer,
+                                    TextBuffer& newBuffer,
+                                    const std::optional<Microsoft::Console::Types::Viewport> lastCharacterViewport,
+                                    std::optional<std::reference_wrapper<PositionInformation>> positionInfo);
+
+    struct PatternRecognizer
+    {
+        // compiled once by AddPatternRecognizer. Unused for UrlPattern.
+        // The regex is only used for patterns the RegexMatcher doesn't support.
+        std::optional<RegexMatcher> matcher;
+        std::wregex regex;
+        bool isUrlPattern;
+    };
+
+    // A pattern found by GetPatterns, relative to the start of its line.
+    struct PatternMatch
+    {
+        til::point start;
+        til::point end;
+        size_t id;
+    };
+
+    // The patterns found in a line the last time GetPatterns looked at it,
+    // keyed by the ID of the line's first row. The entry is only reused if
+    // the hash of the line's text still matches, so that GetPatterns doesn't
+    // need to run the (slow) pattern matching again unless the line changed.
+    struct PatternCacheEntry
+    {
+        size_t hash;
+        std::vector<PatternMatch> matches;
+    };
 
-    static void _AppendRTFText(std::ostringstream& contentBuilder, const std::wstring_view& text);
+    const std::vector<PatternMatch>& _GetLinePatterns(const ROW& firstRow,
+                                                      const std::wstring_view line,
+                                                      const std::vector<std::pair<size_t, const ROW*>>& lineRows) const;
+    static void _FindUrls(const std::wstring_view text, std::vector<std::pair<size_t, size_t>>& matches);
 
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    std::unordered_map<size_t, PatternRecognizer> _idsAndPatterns;
     size_t _currentPatternId;
+    mutable std::unordered_map<til::CoordType, PatternCacheEntry> _patternCache;
 
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
@@ -166,7 +166,7 @@ TextBufferCellIterator& TextBufferCellIterator::operator+=(const ptrdiff_t& move
         _view.UpdateTextAttribute(*_attrIter);
 
         const auto& charRow = _pRow->GetCharRow();
-        _view.UpdateText(charRow.GlyphAt(newX));
+        _view.UpdateText(charRow.GlyphViewAt(newX));
         _view.UpdateDbcsAttribute(charRow.DbcsAttrAt(newX));
         _pos.X = newX;
     }
@@ -326,7 +326,7 @@ const ROW* TextBufferCellIterator::s_GetRow(const TextBuffer& buffer, const til:
 // - Updates the internal view. Call after updating row, attribute, or positions.
 void TextBufferCellIterator::_GenerateView()
 {
-    _view = OutputCellView(_pRow->GetCharRow().GlyphAt(_pos.X),
+    _view = OutputCellView(_pRow->GetCharRow().GlyphViewAt(_pos.X),
                            _pRow->GetCharRow().DbcsAttrAt(_pos.X),
                            *_attrIter,
                            TextAttributeBehavior::Stored);
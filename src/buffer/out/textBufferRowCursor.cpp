@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "textBufferRowCursor.hpp"
+
+#pragma hdrstop
+
+// Routine Description:
+// - Creates a new read-only cursor over the columns [beginColumn, endColumn) of a row
+// Arguments:
+// - row - the row to walk through. It must not be modified while the cursor is in use.
+// - beginColumn - the first column to visit
+// - endColumn - the column past the last one to visit. It's clamped to the width of the row.
+TextBufferRowCursor::TextBufferRowCursor(const ROW& row, const til::CoordType beginColumn, const til::CoordType endColumn) :
+    _row{ row },
+    _column{ beginColumn },
+    _end{ std::min(endColumn, row.size()) },
+    _runBegin{ 0 }
+{
+    THROW_HR_IF(E_INVALIDARG, beginColumn < 0);
+
+    const auto& runs = row.GetAttrRow().Runs();
+    _run = runs.data();
+    _runsEnd = runs.data() + runs.size();
+    _attr = &row.GetAttrRow().Resolve(_run->value);
+
+    _SeekRun();
+}
+
+// Routine Description:
+// - Tells if the cursor still points at a column within its range
+TextBufferRowCursor::operator bool() const noexcept
+{
+    return _column < _end;
+}
+
+// Routine Description:
+// - Moves to the next column
+TextBufferRowCursor& TextBufferRowCursor::operator++()
+{
+    return *this += 1;
+}
+
+// Routine Description:
+// - Moves forward by the given number of columns
+TextBufferRowCursor& TextBufferRowCursor::operator+=(const til::CoordType columns)
+{
+    _column += columns;
+    _SeekRun();
+    return *this;
+}
+
+// Routine Description:
+// - Moves to the first column of the next run of identical attributes
+void TextBufferRowCursor::NextRun()
+{
+    _column = RunEnd();
+    _SeekRun();
+}
+
+// Routine Description:
+// - Returns the column the cursor points at
+til::CoordType TextBufferRowCursor::Column() const noexcept
+{
+    return _column;
+}
+
+// Routine Description:
+// - Returns the glyph in the current column. Trailing halves of wide glyphs repeat their leading half.
+std::wstring_view TextBufferRowCursor::Chars() const
+{
+    return _row.GetCharRow().GlyphViewAt(_column);
+}
+
+// Routine Description:
+// - Returns the DBCS attribute of the current column
+DbcsAttribute TextBufferRowCursor::DbcsAttr() const
+{
+    return _row.GetCharRow().DbcsAttrAt(_column);
+}
+
+// Routine Description:
+// - Returns the number of columns the glyph in the current column takes up,
+//   the same way OutputCellView::Columns() does.
+til::CoordType TextBufferRowCursor::Columns() const
+{
+    return DbcsAttr().IsLeading() ? 2 : 1;
+}
+
+// Routine Description:
+// - Returns the attribute of the current column, which is the same for all columns up to RunEnd()
+const TextAttribute& TextBufferRowCursor::TextAttr() const noexcept
+{
+    return *_attr;
+}
+
+// Routine Description:
+// - Returns the column past the last one that has the same attribute as the current column,
+//   limited to the range of the cursor.
+til::CoordType TextBufferRowCursor::RunEnd() const noexcept
+{
+    return std::min(_runBegin + til::CoordType{ _run->length }, _end);
+}
+
+// Routine Description:
+// - Returns the text of the columns from the current one up to RunEnd() as a view into the row,
+//   with trailing halves of wide glyphs repeating their leading half just like CharRow::GetChars().
+std::wstring_view TextBufferRowCursor::RunText() const
+{
+    const auto& charRow = _row.GetCharRow();
+    const auto beg = charRow.GetCharOffset(_column);
+    const auto end = charRow.GetCharOffset(RunEnd());
+    return charRow.GetChars().substr(beg, end - beg);
+}
+
+// Routine Description:
+// - Moves the current run forward until it contains the current column
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void TextBufferRowCursor::_SeekRun() noexcept
+{
+    auto moved = false;
+    while (_column >= _runBegin + til::CoordType{ _run->length } && _run + 1 < _runsEnd)
+    {
+        _runBegin += _run->length;
+        ++_run;
+        moved = true;
+    }
+    if (moved)
+    {
+        _attr = &_row.GetAttrRow().Resolve(_run->value);
+    }
+}
+#pragma warning(pop)
@@ -0,0 +1,51 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- textBufferRowCursor.hpp
+
+Abstract:
+- This module walks through the columns of a single row of the text buffer
+- Unlike TextBufferCellIterator it reads straight out of the row's storage
+  instead of building an OutputCellView for every cell, and it tells where the
+  current run of identical attributes ends, so that callers can process an
+  entire run at once.
+- It is intended for read-only operations
+--*/
+
+#pragma once
+
+#include "Row.hpp"
+
+class TextBufferRowCursor
+{
+public:
+    TextBufferRowCursor(const ROW& row, til::CoordType beginColumn, til::CoordType endColumn);
+
+    explicit operator bool() const noexcept;
+
+    TextBufferRowCursor& operator++();
+    TextBufferRowCursor& operator+=(til::CoordType columns);
+    void NextRun();
+
+    til::CoordType Column() const noexcept;
+    std::wstring_view Chars() const;
+    DbcsAttribute DbcsAttr() const;
+    til::CoordType Columns() const;
+    const TextAttribute& TextAttr() const noexcept;
+
+    til::CoordType RunEnd() const noexcept;
+    std::wstring_view RunText() const;
+
+private:
+    void _SeekRun() noexcept;
+
+    const ROW& _row;
+    const ATTR_ROW::run_type* _run;
+    const ATTR_ROW::run_type* _runsEnd;
+    const TextAttribute* _attr;
+    til::CoordType _column;
+    til::CoordType _end;
+    til::CoordType _runBegin;
+};
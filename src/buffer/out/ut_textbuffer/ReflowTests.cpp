@@ -635,6 +635,49 @@ namespace
                     { 0, 4 } },
             },
         },
+        TestCase{
+            L"SBCS, only the height changes, with original wrap",
+            {
+                TestBuffer{
+                    { 6, 5 },
+                    {
+                        { L"ABCDEF", true },
+                        { L"GH    ", false },
+                        { L"$     ", false },
+                        { L"      ", false },
+                        { L"      ", false },
+                    },
+                    { 0, 2 } // cursor on $
+                },
+                TestBuffer{
+                    { 6, 3 }, // reduce height down to the cursor
+                    {
+                        { L"ABCDEF", true }, // the wrap survives, since nothing is rewrapped
+                        { L"GH    ", false },
+                        { L"$     ", false },
+                    },
+                    { 0, 2 } // cursor on $
+                },
+                TestBuffer{
+                    { 6, 2 }, // reduce height further, pushing the first row out
+                    {
+                        { L"GH    ", false },
+                        { L"$     ", false },
+                    },
+                    { 0, 1 } // cursor on $
+                },
+                TestBuffer{
+                    { 6, 4 }, // grow height again
+                    {
+                        { L"GH    ", false },
+                        { L"$     ", false },
+                        { L"      ", false },
+                        { L"      ", false },
+                    },
+                    { 0, 1 } // cursor on $
+                },
+            },
+        },
     };
 
 #pragma region TAEF hookup for the test case array above
@@ -746,21 +789,21 @@ class ReflowTests
             row.SetWrapForced(testRow.wrap);
 
             til::CoordType j{};
-            for (auto it{ charRow.begin() }; it != charRow.end(); ++it)
+            for (til::CoordType column{}; column < charRow.size(); ++column)
             {
                 // Yes, we're about to manually create a buffer. It is unpleasant.
                 const auto ch{ til::at(testRow.text, j) };
-                it->Char() = ch;
+                charRow.GlyphAt(column) = { &ch, 1 };
                 if (IsGlyphFullWidth(ch))
                 {
-                    it->DbcsAttr().SetLeading();
-                    it++;
-                    it->Char() = ch;
-                    it->DbcsAttr().SetTrailing();
+                    charRow.DbcsAttrAt(column).SetLeading();
+                    column++;
+                    charRow.GlyphAt(column) = { &ch, 1 };
+                    charRow.DbcsAttrAt(column).SetTrailing();
                 }
                 else
                 {
-                    it->DbcsAttr().SetSingle();
+                    charRow.DbcsAttrAt(column).SetSingle();
                 }
                 j++;
             }
@@ -795,27 +838,27 @@ class ReflowTests
             VERIFY_ARE_EQUAL(testRow.wrap, row.WasWrapForced(), indexString);
 
             til::CoordType j{};
-            for (auto it{ charRow.begin() }; it != charRow.end(); ++it)
+            for (til::CoordType column{}; column < charRow.size(); ++column)
             {
-                indexString.Format(L"[Cell %d, %d; Text line index %d]", it - charRow.begin(), i, j);
+                indexString.Format(L"[Cell %d, %d; Text line index %d]", column, i, j);
                 // Yes, we're about to manually create a buffer. It is unpleasant.
                 const auto ch{ til::at(testRow.text, j) };
                 if (IsGlyphFullWidth(ch))
                 {
                     // Char is full width in test buffer, so
                     // ensure that real buffer is LEAD, TRAIL (ch)
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsLeading(), indexString);
-                    VERIFY_ARE_EQUAL(ch, it->Char(), indexString);
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsLeading(), indexString);
+                    VERIFY_ARE_EQUAL(ch, charRow.GlyphViewAt(column).front(), indexString);
 
-                    it++;
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsTrailing(), indexString);
+                    column++;
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsTrailing(), indexString);
                 }
                 else
                 {
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsSingle(), indexString);
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsSingle(), indexString);
                 }
 
-                VERIFY_ARE_EQUAL(ch, it->Char(), indexString);
+                VERIFY_ARE_EQUAL(ch, charRow.GlyphViewAt(column).front(), indexString);
                 j++;
             }
             i++;
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../RegexMatcher.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using Matches = std::vector<std::pair<size_t, size_t>>;
+
+class RegexMatcherTests
+{
+    TEST_CLASS(RegexMatcherTests);
+
+    TEST_METHOD(MatchesLikeStdRegex);
+    TEST_METHOD(IgnoresCase);
+    TEST_METHOD(RejectsUnsupportedPatterns);
+    TEST_METHOD(PathologicalPatternIsLinear);
+
+    static Matches _findAll(const std::wstring_view pattern, const std::wstring_view text, const bool ignoreCase)
+    {
+        const auto matcher = RegexMatcher::Compile(pattern, ignoreCase);
+        VERIFY_IS_TRUE(matcher.has_value(), pattern.data());
+
+        Matches matches;
+        matcher->FindAll(text, matches);
+        return matches;
+    }
+};
+
+void RegexMatcherTests::MatchesLikeStdRegex()
+{
+    static constexpr std::wstring_view patterns[]{
+        L"a|ab",
+        L"ab|a",
+        L"(a|b)*c",
+        L"a*?b",
+        L"x{2,3}",
+        L"x{2,}?",
+        L"colou?r",
+        L"\\bcat\\b",
+        L"^\\w+",
+        L"\\d+$",
+        L"[^a-c ]+",
+        L"[\\d.-]+",
+        L"(?:ab)+",
+        L"e.*r",
+        L"e.*?r",
+        L"a*",
+        L"(a*)*b",
+        L"\\x41\\u0042",
+    };
+    static constexpr std::wstring_view texts[]{
+        L"",
+        L"ab aab abc cat concat",
+        L"xx xxx xxxx color colour",
+        L"error: 1.5-2 warning err",
+        L"a{ AB 42",
+    };
+
+    for (const auto pattern : patterns)
+    {
+        const std::wregex regex{ pattern.data(), pattern.size() };
+        for (const auto text : texts)
+        {
+            Matches expected;
+            for (auto it = std::wcregex_iterator{ text.data(), text.data() + text.size(), regex }; it != std::wcregex_iterator{}; ++it)
+            {
+                const auto begin = gsl::narrow_cast<size_t>(it->position());
+                expected.emplace_back(begin, begin + gsl::narrow_cast<size_t>(it->length()));
+            }
+
+            Log::Comment(NoThrowString().Format(L"/%.*s/ on \"%.*s\"", gsl::narrow_cast<int>(pattern.size()), pattern.data(), gsl::narrow_cast<int>(text.size()), text.data()));
+            VERIFY_IS_TRUE(expected == _findAll(pattern, text, false));
+        }
+    }
+}
+
+void RegexMatcherTests::IgnoresCase()
+{
+    VERIFY_IS_TRUE((Matches{ { 0, 5 }, { 6, 11 } }) == _findAll(L"error", L"ERROR Error", true));
+    VERIFY_IS_TRUE((Matches{ { 0, 2 }, { 3, 5 } }) == _findAll(L"[A-C]+", L"ab BC de", true));
+    // Negated classes must not match the other case of their members either.
+    VERIFY_IS_TRUE((Matches{ { 2, 3 } }) == _findAll(L"[^a]", L"Aab", true));
+    VERIFY_IS_TRUE(_findAll(L"error", L"ERROR", false).empty());
+}
+
+void RegexMatcherTests::RejectsUnsupportedPatterns()
+{
+    static constexpr std::wstring_view patterns[]{
+        L"(a",
+        L"a)",
+        L"*a",
+        L"a**",
+        L"[a",
+        L"[z-a]",
+        L"a{3,2}",
+        L"a{1001}",
+        L"(a)\\1",
+        L"a(?=b)",
+        L"a(?!b)",
+        L"(?<name>a)",
+    };
+
+    for (const auto pattern : patterns)
+    {
+        VERIFY_IS_FALSE(RegexMatcher::Compile(pattern, false).has_value(), pattern.data());
+    }
+}
+
+void RegexMatcherTests::PathologicalPatternIsLinear()
+{
+    // A backtracking matcher takes exponential time for this, which
+    // std::wregex reports by throwing error_complexity (or a stack overflow).
+    const std::wstring text(100000, L'a');
+    const auto matcher = RegexMatcher::Compile(L"(a*)*b", false);
+    VERIFY_IS_TRUE(matcher.has_value());
+
+    Matches matches;
+    matcher->FindAll(text, matches);
+    VERIFY_IS_TRUE(matches.empty());
+}
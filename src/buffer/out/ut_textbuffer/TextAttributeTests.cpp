@@ -25,6 +25,7 @@ class TextAttributeTests
     TEST_METHOD(TestReverseDefaultColors);
     TEST_METHOD(TestRoundtripDefaultColors);
     TEST_METHOD(TestIntenseAsBright);
+    TEST_METHOD(TestAttributeColorIndices);
 
     RenderSettings _renderSettings;
     const COLORREF _defaultFg = RGB(1, 2, 3);
@@ -325,3 +326,62 @@ void TextAttributeTests::TestIntenseAsBright()
     // Restore the default IntenseIsBright mode.
     _renderSettings.SetRenderMode(RenderSettings::Mode::IntenseIsBright, true);
 }
+
+void TextAttributeTests::TestAttributeColorIndices()
+{
+    const auto& colorTable = _renderSettings.GetColorTable();
+    const auto resolve = [&](const std::optional<size_t> index) {
+        switch (index.value())
+        {
+        case RenderSettings::DefaultForegroundIndex:
+            return _defaultFg;
+        case RenderSettings::DefaultBackgroundIndex:
+            return _defaultBg;
+        default:
+            return til::at(colorTable, *index);
+        }
+    };
+
+    Log::Comment(L"Indexed and default colors should resolve to the colors GetAttributeColors returns.");
+    const TextColor colors[]{ {}, TextColor{ TextColor::DARK_RED, false }, TextColor{ TextColor::BRIGHT_BLUE, false }, TextColor{ 123, true } };
+    for (const auto& fg : colors)
+    {
+        for (const auto& bg : colors)
+        {
+            for (auto meta = 0; meta < 8; meta++)
+            {
+                TextAttribute attr{};
+                attr.SetForeground(fg);
+                attr.SetBackground(bg);
+                attr.SetIntense(WI_IsFlagSet(meta, 1));
+                attr.SetReverseVideo(WI_IsFlagSet(meta, 2));
+                attr.SetInvisible(WI_IsFlagSet(meta, 4));
+
+                const auto [fgIndex, bgIndex] = _renderSettings.GetAttributeColorIndices(attr);
+                const auto [fgColor, bgColor] = _renderSettings.GetAttributeColors(attr);
+                if (fgIndex)
+                {
+                    VERIFY_ARE_EQUAL(fgColor, resolve(fgIndex));
+                }
+                if (bgIndex)
+                {
+                    VERIFY_ARE_EQUAL(bgColor, resolve(bgIndex));
+                }
+            }
+        }
+    }
+
+    Log::Comment(L"Intense default foregrounds depend on the table's contents and can't be indexed.");
+    TextAttribute attr{};
+    attr.SetIntense(true);
+    VERIFY_IS_FALSE(_renderSettings.GetAttributeColorIndices(attr).first.has_value());
+
+    Log::Comment(L"Neither can RGB or faint colors.");
+    attr = TextAttribute{ RGB(1, 1, 1), RGB(2, 2, 2) };
+    VERIFY_IS_FALSE(_renderSettings.GetAttributeColorIndices(attr).first.has_value());
+    VERIFY_IS_FALSE(_renderSettings.GetAttributeColorIndices(attr).second.has_value());
+    attr = TextAttribute{};
+    attr.SetFaint(true);
+    VERIFY_IS_FALSE(_renderSettings.GetAttributeColorIndices(attr).first.has_value());
+    VERIFY_IS_TRUE(_renderSettings.GetAttributeColorIndices(attr).second.has_value());
+}
@@ -52,6 +52,7 @@ namespace SettingsModelLocalTests
         TEST_METHOD(TestMoveTabArgs);
         TEST_METHOD(TestGetKeyBindingForAction);
         TEST_METHOD(KeybindingsWithoutVkey);
+        TEST_METHOD(FrozenKeyChordLookup);
     };
 
     void KeyBindingsTests::KeyChords()
@@ -795,4 +796,61 @@ namespace SettingsModelLocalTests
         const auto action = actionMap->GetActionByKeyChord({ VirtualKeyModifiers::Shift, 0, 255 });
         VERIFY_IS_NOT_NULL(action);
     }
+
+    void KeyBindingsTests::FrozenKeyChordLookup()
+    {
+        const auto parent = winrt::make_self<implementation::ActionMap>();
+        parent->LayerJson(VerifyParseSucceeded(R"!([
+            { "command": "copy", "keys": ["ctrl+c"] },
+            { "command": "paste", "keys": ["ctrl+v"] },
+            { "command": "quakeMode", "keys": ["shift+sc(255)"] }
+        ])!"));
+
+        const auto child = winrt::make_self<implementation::ActionMap>();
+        child->LayerJson(VerifyParseSucceeded(R"([
+            { "command": "unbound", "keys": ["ctrl+c"] },
+            { "command": "newTab", "keys": ["ctrl+t"] }
+        ])"));
+        child->AddLeastImportantParent(parent);
+
+        const std::array<KeyChord, 6> chords{
+            KeyChord{ VirtualKeyModifiers::Control, static_cast<int32_t>('C'), 0 },
+            KeyChord{ VirtualKeyModifiers::Control, static_cast<int32_t>('V'), 0 },
+            KeyChord{ VirtualKeyModifiers::Control, static_cast<int32_t>('T'), 0 },
+            KeyChord{ VirtualKeyModifiers::Control, static_cast<int32_t>('X'), 0 },
+            KeyChord{ VirtualKeyModifiers::Shift, 0, 255 },
+            KeyChord{ VirtualKeyModifiers::Shift, 255, 0 },
+        };
+
+        std::vector<Command> expectedActions;
+        std::vector<bool> expectedUnbound;
+        for (const auto& chord : chords)
+        {
+            expectedActions.emplace_back(child->GetActionByKeyChord(chord));
+            expectedUnbound.emplace_back(child->IsKeyChordExplicitlyUnbound(chord));
+        }
+
+        Log::Comment(L"Freezing the key bindings must not change the result of any lookup.");
+        child->FinalizeKeyBindings();
+        VERIFY_IS_TRUE(child->_KeyChordLookupCache.has_value());
+        for (size_t i = 0; i < chords.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expectedActions.at(i), child->GetActionByKeyChord(chords.at(i)));
+            VERIFY_ARE_EQUAL(expectedUnbound.at(i), child->IsKeyChordExplicitlyUnbound(chords.at(i)));
+        }
+
+        VERIFY_IS_NULL(child->GetActionByKeyChord(chords.at(0)));
+        VERIFY_IS_TRUE(child->IsKeyChordExplicitlyUnbound(chords.at(0)));
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, child->GetActionByKeyChord(chords.at(1)).ActionAndArgs().Action());
+        VERIFY_ARE_EQUAL(ShortcutAction::NewTab, child->GetActionByKeyChord(chords.at(2)).ActionAndArgs().Action());
+        VERIFY_IS_NULL(child->GetActionByKeyChord(chords.at(3)));
+        VERIFY_IS_FALSE(child->IsKeyChordExplicitlyUnbound(chords.at(3)));
+        VERIFY_ARE_EQUAL(ShortcutAction::QuakeMode, child->GetActionByKeyChord(chords.at(4)).ActionAndArgs().Action());
+        VERIFY_IS_NULL(child->GetActionByKeyChord(chords.at(5)));
+
+        Log::Comment(L"Modifying the map must drop the frozen lookup.");
+        child->LayerJson(VerifyParseSucceeded(R"([ { "command": "copy", "keys": ["ctrl+x"] } ])"));
+        VERIFY_IS_FALSE(child->_KeyChordLookupCache.has_value());
+        VERIFY_ARE_EQUAL(ShortcutAction::CopyText, child->GetActionByKeyChord(chords.at(3)).ActionAndArgs().Action());
+    }
 }
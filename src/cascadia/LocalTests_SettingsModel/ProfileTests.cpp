@@ -41,6 +41,9 @@ namespace SettingsModelLocalTests
         TEST_METHOD(DuplicateProfileTest);
         TEST_METHOD(TestGenGuidsForProfiles);
         TEST_METHOD(TestCorrectOldDefaultShellPaths);
+        TEST_METHOD(TestProfilesChangedSince);
+        TEST_METHOD(TestFrozenProfilesThaw);
+        TEST_METHOD(TestLayerJsonReportsInvalidKey);
     };
 
     void ProfileTests::ProfileGeneratesGuid()
@@ -415,4 +418,113 @@ namespace SettingsModelLocalTests
         VERIFY_ARE_EQUAL(L"%SystemRoot%\\System32\\cmd.exe", allProfiles.GetAt(2).Commandline());
         VERIFY_ARE_EQUAL(L"cmd.exe", allProfiles.GetAt(3).Commandline());
     }
+
+    void ProfileTests::TestProfilesChangedSince()
+    {
+        const winrt::guid profile1Guid = Utils::GuidFromString(L"{6239a42c-1111-49a3-80bd-e8fdd045185c}");
+        const winrt::guid profile2Guid = Utils::GuidFromString(L"{6239a42c-2222-49a3-80bd-e8fdd045185c}");
+
+        const auto makeSettings = [](const std::string_view& globals, const std::string_view& profile1, const std::string_view& extraProfile = {}) {
+            const auto json = fmt::format(R"({{
+                {}
+                "profiles": [
+                    {{ "guid": "{{6239a42c-0000-49a3-80bd-e8fdd045185c}}", "name": "profile0" }},
+                    {{ "guid": "{{6239a42c-1111-49a3-80bd-e8fdd045185c}}", "name": "profile1", {} }}
+                    {}
+                ]
+            }})",
+                                          globals,
+                                          profile1,
+                                          extraProfile);
+            return winrt::make_self<implementation::CascadiaSettings>(json);
+        };
+
+        const auto original = makeSettings(R"("copyOnSelect": false,)", R"("font": { "size": 12 })");
+
+        Log::Comment(L"Identical settings don't change any profile.");
+        {
+            const auto changed = makeSettings(R"("copyOnSelect": false,)", R"("font": { "size": 12 })")->ProfilesChangedSince(*original);
+            VERIFY_IS_NOT_NULL(changed);
+            VERIFY_ARE_EQUAL(0u, changed.Size());
+        }
+
+        Log::Comment(L"Only the profile that was edited or added is reported.");
+        {
+            const auto changed = makeSettings(R"("copyOnSelect": false,)",
+                                              R"("font": { "size": 14 })",
+                                              R"(, { "guid": "{6239a42c-2222-49a3-80bd-e8fdd045185c}", "name": "profile2" })")
+                                     ->ProfilesChangedSince(*original);
+            VERIFY_IS_NOT_NULL(changed);
+            VERIFY_ARE_EQUAL(2u, changed.Size());
+            VERIFY_ARE_EQUAL(profile1Guid, changed.GetAt(0));
+            VERIFY_ARE_EQUAL(profile2Guid, changed.GetAt(1));
+        }
+
+        Log::Comment(L"Actions don't affect any profile.");
+        {
+            const auto changed = makeSettings(R"("copyOnSelect": false, "actions": [ { "command": "copy", "keys": "ctrl+shift+c" } ],)", R"("font": { "size": 12 })")->ProfilesChangedSince(*original);
+            VERIFY_IS_NOT_NULL(changed);
+            VERIFY_ARE_EQUAL(0u, changed.Size());
+        }
+
+        Log::Comment(L"Changing a global setting affects all profiles.");
+        {
+            const auto changed = makeSettings(R"("copyOnSelect": true,)", R"("font": { "size": 12 })")->ProfilesChangedSince(*original);
+            VERIFY_IS_NULL(changed);
+        }
+    }
+
+    void ProfileTests::TestFrozenProfilesThaw()
+    {
+        static constexpr std::string_view userSettings{ R"({
+            "profiles": {
+                "defaults": {
+                    "historySize": 123,
+                    "font": { "size": 14 }
+                },
+                "list": [
+                    { "name": "profile0" }
+                ]
+            }
+        })" };
+
+        const auto settings = winrt::make_self<implementation::CascadiaSettings>(userSettings);
+        const auto profile = winrt::get_self<implementation::Profile>(settings->AllProfiles().GetAt(0));
+
+        Log::Comment(L"Loaded settings are frozen and resolve inherited values.");
+        VERIFY_IS_TRUE(profile->_IsFrozen());
+        VERIFY_ARE_EQUAL(123, profile->HistorySize());
+        VERIFY_ARE_EQUAL(14, profile->FontInfo().FontSize());
+
+        Log::Comment(L"Modifying a parent thaws its children, which see the new value.");
+        settings->ProfileDefaults().HistorySize(456);
+        VERIFY_IS_FALSE(profile->_IsFrozen());
+        VERIFY_ARE_EQUAL(456, profile->HistorySize());
+
+        Log::Comment(L"Copies aren't frozen.");
+        const auto copy = winrt::get_self<implementation::CascadiaSettings>(settings->Copy());
+        VERIFY_IS_FALSE(winrt::get_self<implementation::Profile>(copy->AllProfiles().GetAt(0))->_IsFrozen());
+    }
+
+    void ProfileTests::TestLayerJsonReportsInvalidKey()
+    {
+        const auto profile = winrt::make_self<implementation::Profile>();
+        profile->LayerJson(VerifyParseSucceeded(R"({ "name": "profile0", "historySize": 42, "cursorShape": "vintage", "unknownKey": true })"));
+        VERIFY_ARE_EQUAL(L"profile0", profile->Name());
+        VERIFY_ARE_EQUAL(42, profile->HistorySize());
+        VERIFY_ARE_EQUAL(winrt::Microsoft::Terminal::Core::CursorStyle::Vintage, profile->DefaultAppearance().CursorShape());
+
+        Log::Comment(L"A value of the wrong type is reported with its key.");
+        std::optional<std::string> key;
+        try
+        {
+            profile->LayerJson(VerifyParseSucceeded(R"({ "historySize": "many" })"));
+        }
+        catch (const ::Microsoft::Terminal::Settings::Model::JsonUtils::DeserializationError& e)
+        {
+            key = e.key;
+        }
+        VERIFY_IS_TRUE(key == "historySize");
+        VERIFY_ARE_EQUAL(42, profile->HistorySize());
+    }
 }
@@ -26,6 +26,7 @@ namespace TerminalAppLocalTests
         TEST_METHOD(VerifyWeight);
         TEST_METHOD(VerifyCompare);
         TEST_METHOD(VerifyCompareIgnoreCase);
+        TEST_METHOD(VerifyUpdateFilter);
     };
 
     void FilteredCommandTests::VerifyHighlighting()
@@ -229,4 +230,40 @@ namespace TerminalAppLocalTests
 
         VERIFY_SUCCEEDED(result);
     }
+
+    void FilteredCommandTests::VerifyUpdateFilter()
+    {
+        auto result = RunOnUIThread([]() {
+            const auto paletteItem{ winrt::make<winrt::TerminalApp::implementation::CommandLinePaletteItem>(L"AAAAAABBBBBBCCC") };
+            const auto filteredCommand = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(paletteItem);
+            {
+                Log::Comment(L"Testing a matching filter");
+                filteredCommand->UpdateFilter(L"ab");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 3);
+                VERIFY_ARE_EQUAL(filteredCommand->HighlightedName().Segments().Size(), 4u);
+            }
+            {
+                Log::Comment(L"Testing a filter with characters out of order");
+                filteredCommand->UpdateFilter(L"ba");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 0);
+                const auto segments = filteredCommand->HighlightedName().Segments();
+                VERIFY_ARE_EQUAL(segments.Size(), 1u);
+                VERIFY_ARE_EQUAL(segments.GetAt(0).TextSegment(), L"AAAAAABBBBBBCCC");
+                VERIFY_IS_FALSE(segments.GetAt(0).IsHighlighted());
+            }
+            {
+                Log::Comment(L"Testing a filter that was extended to match again");
+                filteredCommand->UpdateFilter(L"abC");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 4);
+            }
+            {
+                Log::Comment(L"Testing an empty filter");
+                filteredCommand->UpdateFilter(L"");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 0);
+                VERIFY_ARE_EQUAL(filteredCommand->HighlightedName().Segments().Size(), 1u);
+            }
+        });
+
+        VERIFY_SUCCEEDED(result);
+    }
 }
@@ -378,6 +378,34 @@ void HwndTerminal::SendOutput(std::wstring_view data)
     _terminal->Write(data);
 }
 
+// Method Description:
+// - Decodes the given UTF-8 chunks and writes them to the terminal in a single
+//   Write(), so that the terminal is only locked once for all of them.
+//   A code point may be split across chunks and across calls.
+// Arguments:
+// - chunks - the UTF-8 output to write
+// Return Value:
+// - S_OK, or the error that occurred while decoding
+HRESULT HwndTerminal::SendOutputUtf8(std::span<const std::string_view> chunks)
+try
+{
+    const std::lock_guard guard{ _utf8OutputMutex };
+
+    _utf8Output.clear();
+    for (const auto& chunk : chunks)
+    {
+        RETURN_IF_FAILED(til::u8u16(chunk, _utf8Chunk, _utf8State));
+        _utf8Output.append(_utf8Chunk);
+    }
+
+    if (!_utf8Output.empty())
+    {
+        _terminal->Write(_utf8Output);
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
 HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal)
 {
     // In order for UIA to hook up properly there needs to be a "static" window hosting the
@@ -426,6 +454,48 @@ void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data)
     publicTerminal->SendOutput(data);
 }
 
+/// <summary>
+/// Writes UTF-8 output to the terminal without requiring it to be converted to a null-terminated UTF-16 string first.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="data">UTF-8 output. A code point may be split across calls.</param>
+/// <param name="length">Length of data in bytes.</param>
+/// <returns>HRESULT of the attempted write.</returns>
+HRESULT _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length)
+{
+    RETURN_HR_IF(E_INVALIDARG, !data && length);
+
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    const std::string_view chunk{ data, length };
+    return publicTerminal->SendOutputUtf8({ &chunk, 1 });
+}
+
+/// <summary>
+/// Writes many chunks of UTF-8 output to the terminal at once, locking the terminal only once for all of them.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="chunks">Array of count pointers to UTF-8 output.</param>
+/// <param name="lengths">Array of count lengths in bytes, one per chunk.</param>
+/// <param name="count">Number of chunks.</param>
+/// <returns>HRESULT of the attempted write.</returns>
+HRESULT _stdcall TerminalSendOutputUtf8Batch(void* terminal, const char* const* chunks, const size_t* lengths, size_t count)
+try
+{
+    RETURN_HR_IF(E_INVALIDARG, (!chunks || !lengths) && count);
+
+    std::vector<std::string_view> views;
+    views.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        RETURN_HR_IF(E_INVALIDARG, !chunks[i] && lengths[i]);
+        views.emplace_back(chunks[i], lengths[i]);
+    }
+
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    return publicTerminal->SendOutputUtf8(views);
+}
+CATCH_RETURN()
+
 /// <summary>
 /// Triggers a terminal resize using the new width and height in pixel.
 /// </summary>
@@ -632,7 +702,7 @@ const wchar_t* _stdcall TerminalGetSelection(void* terminal)
 {
     auto publicTerminal = static_cast<HwndTerminal*>(terminal);
 
-    const auto bufferData = publicTerminal->_terminal->RetrieveSelectedTextFromBuffer(false);
+    const auto bufferData = publicTerminal->_terminal->RetrieveSelectedTextFromBuffer(false, false);
     publicTerminal->_ClearSelection();
 
     // convert text: vector<string> --> string
@@ -26,6 +26,8 @@ typedef struct _TerminalTheme
 extern "C" {
 __declspec(dllexport) HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal);
 __declspec(dllexport) void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data);
+__declspec(dllexport) HRESULT _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length);
+__declspec(dllexport) HRESULT _stdcall TerminalSendOutputUtf8Batch(void* terminal, const char* const* chunks, const size_t* lengths, size_t count);
 __declspec(dllexport) void _stdcall TerminalRegisterScrollCallback(void* terminal, void __stdcall callback(int, int, int));
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResize(_In_ void* terminal, _In_ til::CoordType width, _In_ til::CoordType height, _Out_ til::size* dimensions);
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResizeWithDimension(_In_ void* terminal, _In_ til::size dimensions, _Out_ til::size* dimensionsInPixels);
@@ -60,6 +62,7 @@ public:
     HRESULT Initialize();
     void Teardown() noexcept;
     void SendOutput(std::wstring_view data);
+    HRESULT SendOutputUtf8(std::span<const std::string_view> chunks);
     HRESULT Refresh(const til::size windowSize, _Out_ til::size* dimensions);
     void RegisterScrollCallback(std::function<void(int, int, int)> callback);
     void RegisterWriteCallback(const void _stdcall callback(wchar_t*));
@@ -81,6 +84,12 @@ private:
     std::unique_ptr<::Microsoft::Console::Render::Renderer> _renderer;
     std::unique_ptr<::Microsoft::Console::Render::DxEngine> _renderEngine;
 
+    // Guards the UTF-8 decoder state, which carries partial code points across SendOutputUtf8() calls.
+    std::mutex _utf8OutputMutex;
+    til::u8state _utf8State;
+    std::wstring _utf8Chunk;
+    std::wstring _utf8Output;
+
     bool _focused{ false };
     bool _uiaProviderInitialized{ false };
 
@@ -95,14 +95,25 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             peasant.WindowActivated({ this, &Monarch::_peasantWindowActivated });
             peasant.IdentifyWindowsRequested({ this, &Monarch::_identifyWindows });
             peasant.RenameRequested({ this, &Monarch::_renameRequested });
+            peasant.WindowNameChanged([this, newPeasantsId](auto&&, const winrt::hstring& name) { _peasantWindowNameChanged(newPeasantsId, name); });
 
             peasant.ShowNotificationIconRequested([this](auto&&, auto&&) { _ShowNotificationIconRequestedHandlers(*this, nullptr); });
             peasant.HideNotificationIconRequested([this](auto&&, auto&&) { _HideNotificationIconRequestedHandlers(*this, nullptr); });
             peasant.QuitAllRequested({ this, &Monarch::_handleQuitAll });
 
+            // Get the name only after we've subscribed to WindowNameChanged,
+            // so that we don't miss any renames.
+            const auto windowName = peasant.WindowName();
             {
                 std::unique_lock lock{ _peasantsMutex };
                 _peasants[newPeasantsId] = peasant;
+                _peasantNames[newPeasantsId] = windowName;
+            }
+
+            // A preloaded window registers itself with each new monarch.
+            if (peasant.Preloaded())
+            {
+                SetPreloadedPeasant(newPeasantsId);
             }
 
             TraceLoggingWrite(g_hRemotingProvider,
@@ -206,13 +217,94 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         _clearOldMruEntries({ peasantId });
         {
             std::unique_lock lock{ _peasantsMutex };
-            _peasants.erase(peasantId);
+            _erasePeasant(peasantId);
         }
         _WindowClosedHandlers(nullptr, nullptr);
     }
 
+    // Method Description:
+    // - Removes the given peasant from our list of peasants.
+    // - NB: the caller must hold a unique lock on _peasantsMutex.
+    // Arguments:
+    // - peasantID: the id of the peasant
+    // Return Value:
+    // - <none>
+    void Monarch::_erasePeasant(const uint64_t peasantID)
+    {
+        _peasants.erase(peasantID);
+        _peasantNames.erase(peasantID);
+    }
+
+    // Method Description:
+    // - Remembers the given peasant as the preloaded window: a window that
+    //   stays hidden until ProposeCommandline hands it the next commandline,
+    //   which would otherwise require a whole new window process.
+    // - There's only ever one preloaded window. If another living peasant
+    //   already is the preloaded one, the given peasant is told to quit.
+    // Arguments:
+    // - peasantId: the id of the preloaded peasant
+    // Return Value:
+    // - <none>
+    void Monarch::SetPreloadedPeasant(const uint64_t peasantId)
+    {
+        const auto currentId = _preloadedPeasantId.load();
+        if (currentId != 0 && currentId != peasantId && _getPeasant(currentId))
+        {
+            if (auto peasant{ _getPeasant(peasantId) })
+            {
+                peasant.Quit();
+            }
+            return;
+        }
+
+        _preloadedPeasantId.store(peasantId);
+
+        TraceLoggingWrite(g_hRemotingProvider,
+                          "Monarch_SetPreloadedPeasant",
+                          TraceLoggingUInt64(peasantId, "peasantID", "the ID of the preloaded peasant"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    // Method Description:
+    // - Checks whether there's a living preloaded peasant.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - true if the next new window can be handed to a preloaded peasant.
+    bool Monarch::HasPreloadedPeasant()
+    {
+        const auto id = _preloadedPeasantId.load();
+        return id != 0 && _getPeasant(id) != nullptr;
+    }
+
+    // Method Description:
+    // - Forgets about the given peasant being the preloaded window, if it still
+    //   is. That's the case if it became a regular window without us handing it
+    //   a commandline, because it received a default terminal handoff instead.
+    // Arguments:
+    // - peasantId: the id of the formerly preloaded peasant
+    // Return Value:
+    // - <none>
+    void Monarch::ClearPreloadedPeasant(const uint64_t peasantId)
+    {
+        auto expected = peasantId;
+        if (_preloadedPeasantId.compare_exchange_strong(expected, 0))
+        {
+            // As far as everyone else is concerned, a window was just created.
+            _WindowCreatedHandlers(nullptr, nullptr);
+
+            TraceLoggingWrite(g_hRemotingProvider,
+                              "Monarch_ClearPreloadedPeasant",
+                              TraceLoggingUInt64(peasantId, "peasantID", "the ID of the formerly preloaded peasant"),
+                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                              TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+        }
+    }
+
     // Method Description:
     // - Counts the number of living peasants.
+    // - The preloaded peasant isn't counted, as it doesn't have a visible window.
     // Arguments:
     // - <none>
     // Return Value:
@@ -220,7 +312,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     uint64_t Monarch::GetNumberOfPeasants()
     {
         std::shared_lock lock{ _peasantsMutex };
-        return _peasants.size();
+        return _peasants.size() - _peasants.count(_preloadedPeasantId.load());
     }
 
     // Method Description:
@@ -275,7 +367,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             // Remove the peasant from the list of peasants
             {
                 std::unique_lock lock{ _peasantsMutex };
-                _peasants.erase(peasantID);
+                _erasePeasant(peasantID);
             }
 
             if (clearMruPeasantOnFailure)
@@ -290,8 +382,10 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
     // Method Description:
     // - Find the ID of the peasant with the given name. If no such peasant
-    //   exists, then we'll return 0. If we encounter any peasants who have died
-    //   during this process, then we'll remove them from the set of _peasants
+    //   exists, then we'll return 0. If the peasant with that name has died,
+    //   then we'll remove it from the set of _peasants and return 0.
+    // - The names come from _peasantNames, so this only ever talks to the
+    //   peasant we found, to make sure it's still alive.
     // Arguments:
     // - name: The window name to look for
     // Return Value:
@@ -305,26 +399,27 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         }
 
         uint64_t result = 0;
-
-        const auto callback = [&](const auto& id, const auto& p) {
-            auto otherName = p.WindowName();
-            if (otherName == name)
+        {
+            std::shared_lock lock{ _peasantsMutex };
+            for (const auto& [id, peasantName] : _peasantNames)
             {
-                result = id;
-                return false;
+                if (peasantName == name)
+                {
+                    result = id;
+                    break;
+                }
             }
-            return true;
-        };
+        }
 
-        const auto onError = [&](const auto& id) {
+        if (result != 0 && !_getPeasant(result))
+        {
             TraceLoggingWrite(g_hRemotingProvider,
                               "Monarch_lookupPeasantIdForName_Failed",
-                              TraceLoggingInt64(id, "peasantID", "The ID of the peasant which we could not get the name of"),
+                              TraceLoggingInt64(result, "peasantID", "The ID of the peasant with that name, which was dead"),
                               TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                               TraceLoggingKeyword(TIL_KEYWORD_TRACE));
-        };
-
-        _forEachPeasant(callback, onError);
+            result = 0;
+        }
 
         TraceLoggingWrite(g_hRemotingProvider,
                           "Monarch_lookupPeasantIdForName",
@@ -335,6 +430,38 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         return result;
     }
 
+    // Method Description:
+    // - Gets the name of the given peasant, as far as we know it. This doesn't
+    //   talk to the peasant at all.
+    // - NB: this takes a shared lock on _peasantsMutex.
+    // Arguments:
+    // - peasantID: The ID of the peasant
+    // Return Value:
+    // - the name of the peasant, or an empty string if we don't know it.
+    winrt::hstring Monarch::_getPeasantName(const uint64_t peasantID)
+    {
+        std::shared_lock lock{ _peasantsMutex };
+        const auto search = _peasantNames.find(peasantID);
+        return search == _peasantNames.end() ? winrt::hstring{} : search->second;
+    }
+
+    // Method Description:
+    // - Handler for the `Peasant::WindowNameChanged` event. Updates our copy
+    //   of that peasant's name.
+    // Arguments:
+    // - peasantID: The ID of the peasant that was renamed
+    // - name: its new name
+    // Return Value:
+    // - <none>
+    void Monarch::_peasantWindowNameChanged(const uint64_t peasantID, const winrt::hstring& name)
+    {
+        std::unique_lock lock{ _peasantsMutex };
+        if (_peasants.find(peasantID) != _peasants.end())
+        {
+            _peasantNames[peasantID] = name;
+        }
+    }
+
     // Method Description:
     // - Handler for the `Peasant::WindowActivated` event. We'll make a in-proc
     //   copy of the WindowActivatedArgs from the peasant. That way, we won't
@@ -552,7 +679,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                 continue;
             }
 
-            if (ignoreQuakeWindow && peasant.WindowName() == QuakeWindowName)
+            if (ignoreQuakeWindow && _getPeasantName(mruWindowArgs.PeasantID()) == QuakeWindowName)
             {
                 // The _quake window should never be treated as the MRU window.
                 // Skip it if we see it. Users can still target it with `wt -w
@@ -639,6 +766,14 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     //   to another window in this case.
     Remoting::ProposeCommandlineResult Monarch::ProposeCommandline(const Remoting::CommandlineArgs& args)
     {
+        // Each step of this is timed, so that slow window lookups can be
+        // diagnosed from the traces.
+        const auto start = std::chrono::high_resolution_clock::now();
+        const auto elapsed = [&start]() {
+            const std::chrono::duration<double> delta = std::chrono::high_resolution_clock::now() - start;
+            return delta.count();
+        };
+
         // Raise an event, to ask how to handle this commandline. We can't ask
         // the app ourselves - we exist isolated from that knowledge (and
         // dependency hell). The WindowManager will raise this up to the app
@@ -657,6 +792,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         TraceLoggingWrite(g_hRemotingProvider,
                           "Monarch_ProposeCommandline",
                           TraceLoggingInt64(targetWindow, "targetWindow", "The window ID the args specified"),
+                          TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent finding the target window"),
                           TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                           TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
@@ -699,6 +835,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                               TraceLoggingInt64(windowID,
                                                 "windowID",
                                                 "The actual peasant ID we evaluated the window ID as"),
+                              TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent looking up the peasant"),
                               TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                               TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
@@ -739,6 +876,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                                   TraceLoggingBoolean(!result->ShouldCreateWindow(),
                                                       "succeeded",
                                                       "true if we successfully dispatched the commandline to the peasant"),
+                                  TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent handling the commandline"),
                                   TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                                   TraceLoggingKeyword(TIL_KEYWORD_TRACE));
                 return *result;
@@ -755,6 +893,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                                                      "peasantID",
                                                      "the ID of the peasant the commandline waws intended for"),
                                   TraceLoggingBoolean(false, "foundMatch", "true if we found a peasant with that ID"),
+                                  TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent handling the commandline"),
                                   TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                                   TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
@@ -765,10 +904,50 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             }
         }
 
+        // If we get here, we couldn't find an existing window. If there's a
+        // preloaded one, we'll hand the commandline to it instead of making the
+        // caller create a whole new window. Named windows are left to the
+        // caller, because the preloaded window already has its (empty) name.
+        if (targetWindowName.empty())
+        {
+            const auto preloadedId = _preloadedPeasantId.exchange(0);
+            if (auto preloadedPeasant{ _getPeasant(preloadedId) })
+            {
+                try
+                {
+                    // This will raise the peasant's ExecuteCommandlineRequested
+                    // event, which makes AppHost show the preloaded window.
+                    preloadedPeasant.ExecuteCommandline(args);
+
+                    // As far as everyone else is concerned, a window was just created.
+                    _WindowCreatedHandlers(nullptr, nullptr);
+
+                    TraceLoggingWrite(g_hRemotingProvider,
+                                      "Monarch_ProposeCommandline_Preloaded",
+                                      TraceLoggingUInt64(preloadedId,
+                                                         "peasantID",
+                                                         "the ID of the preloaded peasant the commandline was handed to"),
+                                      TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent handling the commandline"),
+                                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
+                    auto result{ winrt::make_self<Remoting::implementation::ProposeCommandlineResult>(false) };
+                    return *result;
+                }
+                catch (...)
+                {
+                    // If the preloaded window died in the meantime, the caller
+                    // will simply create a new window like it always did.
+                    LOG_CAUGHT_EXCEPTION();
+                }
+            }
+        }
+
         // If we get here, we couldn't find an existing window. Make a new one.
         TraceLoggingWrite(g_hRemotingProvider,
                           "Monarch_ProposeCommandline_NewWindow",
                           TraceLoggingInt64(targetWindow, "targetWindow", "The provided ID"),
+                          TraceLoggingFloat64(elapsed(), "Duration", "Seconds spent handling the commandline"),
                           TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                           TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
@@ -954,7 +1133,12 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         }
 
         const auto func = [&](const auto& id, const auto& p) -> void {
-            names.push_back({ id, p.WindowName(), p.ActiveTabTitle() });
+            if (id != _preloadedPeasantId.load())
+            {
+                // _forEachPeasant already holds a shared lock on _peasantsMutex.
+                const auto name = _peasantNames.find(id);
+                names.push_back({ id, name == _peasantNames.end() ? winrt::hstring{} : name->second, p.ActiveTabTitle() });
+            }
         };
 
         const auto onError = [&](const auto& id) {
@@ -972,31 +1156,18 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
     bool Monarch::DoesQuakeWindowExist()
     {
-        auto result = false;
-        const auto func = [&](const auto& /*id*/, const auto& p) {
-            if (p.WindowName() == QuakeWindowName)
-            {
-                result = true;
-            }
-            // continue if we didn't get a positive result
-            return !result;
-        };
-
-        const auto onError = [&](const auto& id) {
-            TraceLoggingWrite(g_hRemotingProvider,
-                              "Monarch_DoesQuakeWindowExist_Failed",
-                              TraceLoggingInt64(id, "peasantID", "The ID of the peasant which we could not ask for its name"),
-                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
-                              TraceLoggingKeyword(TIL_KEYWORD_TRACE));
-        };
-
-        _forEachPeasant(func, onError);
-        return result;
+        return _lookupPeasantIdForName(QuakeWindowName) != 0;
     }
 
     void Monarch::SummonAllWindows()
     {
-        const auto func = [&](const auto& /*id*/, const auto& p) {
+        const auto func = [&](const auto& id, const auto& p) {
+            // The preloaded window stays hidden until it receives a commandline.
+            if (id == _preloadedPeasantId.load())
+            {
+                return;
+            }
+
             SummonWindowBehavior args{};
             args.ToggleVisibility(false);
             p.Summon(args);
@@ -1022,8 +1193,12 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     Windows::Foundation::Collections::IVector<winrt::hstring> Monarch::GetAllWindowLayouts()
     {
         std::vector<winrt::hstring> vec;
-        auto callback = [&](const auto& /*id*/, const auto& p) {
-            vec.emplace_back(p.GetWindowLayout());
+        auto callback = [&](const auto& id, const auto& p) {
+            // The preloaded window doesn't have any tabs worth restoring.
+            if (id != _preloadedPeasantId.load())
+            {
+                vec.emplace_back(p.GetWindowLayout());
+            }
         };
         auto onError = [](auto&& id) {
             TraceLoggingWrite(g_hRemotingProvider,
@@ -48,6 +48,9 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
         uint64_t AddPeasant(winrt::Microsoft::Terminal::Remoting::IPeasant peasant);
         void SignalClose(const uint64_t peasantId);
+        void SetPreloadedPeasant(const uint64_t peasantId);
+        bool HasPreloadedPeasant();
+        void ClearPreloadedPeasant(const uint64_t peasantId);
 
         uint64_t GetNumberOfPeasants();
 
@@ -72,6 +75,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
         std::atomic<uint64_t> _nextPeasantID{ 1 };
         uint64_t _ourPeasantId{ 0 };
+        // The hidden window that ProposeCommandline hands the next new window to.
+        std::atomic<uint64_t> _preloadedPeasantId{ 0 };
 
         // When we're quitting we do not care as much about handling some events that we know will be triggered
         std::atomic<bool> _quitting{ false };
@@ -79,6 +84,10 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         winrt::com_ptr<IVirtualDesktopManager> _desktopManager{ nullptr };
 
         std::unordered_map<uint64_t, winrt::Microsoft::Terminal::Remoting::IPeasant> _peasants;
+        // The names of the windows in _peasants, kept up to date by the
+        // peasants themselves. Looking up a window by name would otherwise
+        // need one cross-process call per window. Guarded by _peasantsMutex.
+        std::unordered_map<uint64_t, winrt::hstring> _peasantNames;
         std::vector<Remoting::WindowActivatedArgs> _mruPeasants;
         // These should not be locked at the same time to prevent deadlocks
         // unless they are both shared_locks.
@@ -88,6 +97,9 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         winrt::Microsoft::Terminal::Remoting::IPeasant _getPeasant(uint64_t peasantID, bool clearMruPeasantOnFailure = true);
         uint64_t _getMostRecentPeasantID(bool limitToCurrentDesktop, const bool ignoreQuakeWindow);
         uint64_t _lookupPeasantIdForName(std::wstring_view name);
+        winrt::hstring _getPeasantName(const uint64_t peasantID);
+        void _peasantWindowNameChanged(const uint64_t peasantID, const winrt::hstring& name);
+        void _erasePeasant(const uint64_t peasantID);
 
         void _peasantWindowActivated(const winrt::Windows::Foundation::IInspectable& sender,
                                      const winrt::Microsoft::Terminal::Remoting::WindowActivatedArgs& args);
@@ -173,7 +185,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                     std::unique_lock lock{ _peasantsMutex };
                     for (const auto& id : peasantsToErase)
                     {
-                        _peasants.erase(id);
+                        _erasePeasant(id);
                     }
                 }
                 _clearOldMruEntries(peasantsToErase);
@@ -45,6 +45,37 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         return _ourPID;
     }
 
+    winrt::hstring Peasant::WindowName() const
+    {
+        return _windowName;
+    }
+
+    // Method Description:
+    // - Sets our window name, and tells the monarch about it. The monarch
+    //   keeps track of all the window names, so that it doesn't need to ask
+    //   every peasant for theirs whenever it's looking for a window by name.
+    // Arguments:
+    // - name: our new window name
+    // Return Value:
+    // - <none>
+    void Peasant::WindowName(const winrt::hstring& name)
+    {
+        if (_windowName == name)
+        {
+            return;
+        }
+        _windowName = name;
+
+        try
+        {
+            // The monarch might have died. If they have, this will throw an
+            // exception. Just eat it, we'll tell the next monarch our name
+            // when we're added to it.
+            _WindowNameChangedHandlers(*this, name);
+        }
+        CATCH_LOG();
+    }
+
     bool Peasant::ExecuteCommandline(const Remoting::CommandlineArgs& args)
     {
         // If this is the first set of args we were ever told about, stash them
@@ -198,7 +229,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     void Peasant::RequestRename(const winrt::Microsoft::Terminal::Remoting::RenameRequestArgs& args)
     {
         auto successfullyNotified = false;
-        const auto oldName{ _WindowName };
+        const auto oldName{ _windowName };
         try
         {
             // Try/catch this, because the other side of this event is handled
@@ -208,7 +239,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             _RenameRequestedHandlers(*this, args);
             if (args.Succeeded())
             {
-                _WindowName = args.NewName();
+                WindowName(args.NewName());
             }
             successfullyNotified = true;
         }
@@ -38,14 +38,18 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
         winrt::hstring GetWindowLayout();
 
-        WINRT_PROPERTY(winrt::hstring, WindowName);
+        winrt::hstring WindowName() const;
+        void WindowName(const winrt::hstring& name);
+
         WINRT_PROPERTY(winrt::hstring, ActiveTabTitle);
+        WINRT_PROPERTY(bool, Preloaded, false);
 
         TYPED_EVENT(WindowActivated, winrt::Windows::Foundation::IInspectable, winrt::Microsoft::Terminal::Remoting::WindowActivatedArgs);
         TYPED_EVENT(ExecuteCommandlineRequested, winrt::Windows::Foundation::IInspectable, winrt::Microsoft::Terminal::Remoting::CommandlineArgs);
         TYPED_EVENT(IdentifyWindowsRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(DisplayWindowIdRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(RenameRequested, winrt::Windows::Foundation::IInspectable, winrt::Microsoft::Terminal::Remoting::RenameRequestArgs);
+        TYPED_EVENT(WindowNameChanged, winrt::Windows::Foundation::IInspectable, winrt::hstring);
         TYPED_EVENT(SummonRequested, winrt::Windows::Foundation::IInspectable, winrt::Microsoft::Terminal::Remoting::SummonWindowBehavior);
         TYPED_EVENT(ShowNotificationIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(HideNotificationIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
@@ -58,6 +62,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         uint64_t _ourPID;
 
         uint64_t _id{ 0 };
+        winrt::hstring _windowName;
 
         winrt::Microsoft::Terminal::Remoting::CommandlineArgs _initialArgs{ nullptr };
         winrt::Microsoft::Terminal::Remoting::WindowActivatedArgs _lastActivatedArgs{ nullptr };
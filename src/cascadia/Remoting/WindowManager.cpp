@@ -23,6 +23,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     {
         _monarchWaitInterrupt.create();
 
+        const auto start = std::chrono::high_resolution_clock::now();
+
         // Register with COM as a server for the Monarch class
         _registerAsMonarch();
         // Instantiate an instance of the Monarch. This may or may not be in-proc!
@@ -45,6 +47,14 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                                   TraceLoggingKeyword(TIL_KEYWORD_TRACE));
             }
         }
+
+        const std::chrono::duration<double> delta = std::chrono::high_resolution_clock::now() - start;
+        TraceLoggingWrite(g_hRemotingProvider,
+                          "WindowManager_FoundMonarch",
+                          TraceLoggingBoolean(_isKing, "isKing", "true if we are the monarch"),
+                          TraceLoggingFloat64(delta.count(), "Duration", "Seconds spent finding the monarch"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
     }
 
     WindowManager::~WindowManager()
@@ -101,6 +111,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         // starting a defterm, and when that BP gets hit, kill the original
         // monarch, and see what happens here.
 
+        const auto start = std::chrono::high_resolution_clock::now();
         auto proposedCommandline = false;
         Remoting::ProposeCommandlineResult result{ nullptr };
         auto attempts = 0;
@@ -203,6 +214,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         }
         givenName = result.WindowName();
 
+        const std::chrono::duration<double> delta = std::chrono::high_resolution_clock::now() - start;
+
         // TraceLogging doesn't have a good solution for logging an
         // optional. So we have to repeat the calls here:
         if (givenID)
@@ -212,6 +225,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                               TraceLoggingBoolean(_shouldCreateWindow, "CreateWindow", "true iff we should create a new window"),
                               TraceLoggingUInt64(givenID.value(), "Id", "The ID we should assign our peasant"),
                               TraceLoggingWideString(givenName.c_str(), "Name", "The name we should assign this window"),
+                              TraceLoggingInt32(attempts, "attempts", "How many times we failed to reach the monarch"),
+                              TraceLoggingFloat64(delta.count(), "Duration", "Seconds spent proposing the commandline"),
                               TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                               TraceLoggingKeyword(TIL_KEYWORD_TRACE));
         }
@@ -222,6 +237,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                               TraceLoggingBoolean(_shouldCreateWindow, "CreateWindow", "true iff we should create a new window"),
                               TraceLoggingPointer(nullptr, "Id", "No ID provided"),
                               TraceLoggingWideString(givenName.c_str(), "Name", "The name we should assign this window"),
+                              TraceLoggingInt32(attempts, "attempts", "How many times we failed to reach the monarch"),
+                              TraceLoggingFloat64(delta.count(), "Duration", "Seconds spent proposing the commandline"),
                               TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                               TraceLoggingKeyword(TIL_KEYWORD_TRACE));
         }
@@ -526,11 +543,25 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     // NOTE: This can throw!
     bool WindowManager::_performElection()
     {
+        const auto start = std::chrono::high_resolution_clock::now();
+
         _createMonarchAndCallbacks();
 
+        const auto elected = std::chrono::high_resolution_clock::now();
+
         // Tell the new monarch who we are. We might be that monarch!
         _monarch.AddPeasant(_peasant);
 
+        const std::chrono::duration<double> electionDelta = elected - start;
+        const std::chrono::duration<double> addPeasantDelta = std::chrono::high_resolution_clock::now() - elected;
+        TraceLoggingWrite(g_hRemotingProvider,
+                          "WindowManager_PerformElection",
+                          TraceLoggingBoolean(_isKing, "isKing", "true if we are the new monarch"),
+                          TraceLoggingFloat64(electionDelta.count(), "ElectionDuration", "Seconds spent finding the new monarch"),
+                          TraceLoggingFloat64(addPeasantDelta.count(), "AddPeasantDuration", "Seconds spent registering with the new monarch"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
         // This method is only called when a _new_ monarch is elected. So
         // don't do anything here that needs to be done for all monarch
         // windows. This should only be for work that's done when a window
@@ -784,6 +815,60 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         return _monarch.DoesQuakeWindowExist();
     }
 
+    // Method Description:
+    // - Marks our window as the preloaded one. The monarch will hand the next
+    //   commandline that needs a new window to it. See Monarch::SetPreloadedPeasant.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void WindowManager::RegisterPreloadedWindow()
+    {
+        winrt::get_self<implementation::Peasant>(_peasant)->Preloaded(true);
+        if (_monarch)
+        {
+            try
+            {
+                _monarch.SetPreloadedPeasant(_peasant.GetID());
+            }
+            CATCH_LOG()
+        }
+    }
+
+    // Method Description:
+    // - Turns our preloaded window into a regular one, once it was handed a
+    //   commandline or a default terminal handoff. In the former case the
+    //   monarch already forgot about it, in the latter we have to tell it.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void WindowManager::UnregisterPreloadedWindow()
+    {
+        winrt::get_self<implementation::Peasant>(_peasant)->Preloaded(false);
+        if (_monarch)
+        {
+            try
+            {
+                _monarch.ClearPreloadedPeasant(_peasant.GetID());
+            }
+            CATCH_LOG()
+        }
+    }
+
+    bool WindowManager::HasPreloadedWindow()
+    {
+        if (_monarch)
+        {
+            try
+            {
+                return _monarch.HasPreloadedPeasant();
+            }
+            CATCH_LOG()
+        }
+        return false;
+    }
+
     void WindowManager::UpdateActiveTabTitle(winrt::hstring title)
     {
         winrt::get_self<implementation::Peasant>(_peasant)->ActiveTabTitle(title);
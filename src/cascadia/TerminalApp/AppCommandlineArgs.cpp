@@ -863,6 +863,18 @@ bool AppCommandlineArgs::IsHandoffListener() const noexcept
     return _isHandoffListener;
 }
 
+// Method Description:
+// - Returns whether we were started as a preloaded window, which stays hidden
+//   and empty until the monarch hands it the commandline of a new window.
+// Arguments:
+// - <none>
+// Return Value:
+// - True if this is a preloaded window. False otherwise.
+bool AppCommandlineArgs::IsPreloadedWindow() const noexcept
+{
+    return _isPreloadedWindow;
+}
+
 // Method Description:
 // - Get the string of text that should be displayed to the user on exit. This
 //   is usually helpful for cases where the user entered some sort of invalid
@@ -907,8 +919,8 @@ void AppCommandlineArgs::ValidateStartupCommands()
 {
     // Only check over the actions list for the potential to add a new-tab
     // command if we are not starting for the purposes of receiving an inbound
-    // handoff connection from the operating system.
-    if (!_isHandoffListener)
+    // handoff connection from the operating system, or as a preloaded window.
+    if (!_isHandoffListener && !_isPreloadedWindow)
     {
         // If we parsed no commands, or the first command we've parsed is not a new
         // tab action, prepend a new-tab command to the front of the list.
@@ -958,6 +970,11 @@ int AppCommandlineArgs::ParseArgs(winrt::array_view<const winrt::hstring>& args)
             _isHandoffListener = true;
             return 0;
         }
+        if (arg == L"-Preload")
+        {
+            _isPreloadedWindow = true;
+            return 0;
+        }
     }
 
     auto commands = ::TerminalApp::AppCommandlineArgs::BuildCommands(args);
@@ -1065,6 +1082,7 @@ void AppCommandlineArgs::FullResetState()
     _exitMessage = "";
     _shouldExitEarly = false;
     _isHandoffListener = false;
+    _isPreloadedWindow = false;
 
     _windowTarget = {};
 }
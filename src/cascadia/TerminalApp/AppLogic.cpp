@@ -1130,6 +1130,21 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - Used to tell the controls that the user started or stopped dragging
+    //   the border of the window (WM_ENTERSIZEMOVE / WM_EXITSIZEMOVE).
+    // Arguments:
+    // - inProgress - True when the resize started; false when it ended.
+    // Return Value:
+    // - <none>
+    void AppLogic::InteractiveResizeChanged(const bool inProgress)
+    {
+        if (_root)
+        {
+            _root->InteractiveResizeChanged(inProgress);
+        }
+    }
+
     // Method Description:
     // - Implements the F7 handler (per GH#638)
     // - Implements the Alt handler (per GH#6421)
@@ -1249,6 +1264,13 @@ namespace winrt::TerminalApp::implementation
     //   or 0. (see AppLogic::_ParseArgs)
     int32_t AppLogic::SetStartupCommandline(array_view<const winrt::hstring> args)
     {
+        // A preloaded window gets its real commandline later on. Forget
+        // everything we remembered from the -Preload one.
+        if (_appArgs.IsPreloadedWindow())
+        {
+            _appArgs.FullResetState();
+        }
+
         const auto result = _appArgs.ParseArgs(args);
         if (result == 0)
         {
@@ -1272,11 +1294,54 @@ namespace winrt::TerminalApp::implementation
             {
                 _root->SetInboundListener(true);
             }
+
+            if (_appArgs.IsPreloadedWindow())
+            {
+                _root->SetPreloadedWindow();
+            }
         }
 
         return result;
     }
 
+    // Method Description:
+    // - Returns true if this window was started with -Preload, and hasn't been
+    //   handed a real commandline yet.
+    bool AppLogic::IsPreloadedWindow() const noexcept
+    {
+        return _appArgs.IsPreloadedWindow();
+    }
+
+    // Method Description:
+    // - Turns this preloaded window into a regular one. The commandline it
+    //   should run must already have been passed to SetStartupCommandline.
+    // Arguments:
+    // - cwd: the directory the commandline should be run in
+    // Return Value:
+    // - <none>
+    void AppLogic::LaunchPreloadedWindow(const winrt::hstring& cwd)
+    {
+        if (!_hasCommandLineArguments && _hasSettingsStartupActions)
+        {
+            _root->SetStartupActions(_settingsAppArgs.GetStartupActions());
+        }
+
+        _root->LaunchPreloadedWindow(cwd);
+    }
+
+    // Method Description:
+    // - Turns this preloaded window into a regular one without a commandline,
+    //   because it received a default terminal handoff instead. The page already
+    //   created the tab for it. See TerminalPage::_OnNewConnection.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void AppLogic::ClaimPreloadedWindow()
+    {
+        _appArgs.FullResetState();
+    }
+
     // Method Description:
     // - Triggers the setup of the listener for incoming console connections
     //   from the operating system.
@@ -1362,7 +1427,7 @@ namespace winrt::TerminalApp::implementation
         const auto result = appArgs.ParseArgs(args);
         if (result == 0)
         {
-            if (!appArgs.GetExitMessage().empty())
+            if (!appArgs.GetExitMessage().empty() || appArgs.IsPreloadedWindow())
             {
                 return winrt::make<FindTargetWindowResult>(WindowingBehaviorUseNew);
             }
@@ -1656,6 +1721,17 @@ namespace winrt::TerminalApp::implementation
         return _settings.GlobalSettings().AlwaysShowNotificationIcon();
     }
 
+    bool AppLogic::GetPreloadWindow()
+    {
+        if (!_loadedInitialSettings)
+        {
+            // Load settings if we haven't already
+            LoadSettings();
+        }
+
+        return _settings.GlobalSettings().PreloadWindow();
+    }
+
     bool AppLogic::GetShowTitleInTitlebar()
     {
         return _settings.GlobalSettings().ShowTitleInTitlebar();
@@ -70,6 +70,9 @@ namespace winrt::TerminalApp::implementation
         bool HasCommandlineArguments() const noexcept;
         bool HasSettingsStartupActions() const noexcept;
         int32_t SetStartupCommandline(array_view<const winrt::hstring> actions);
+        bool IsPreloadedWindow() const noexcept;
+        void LaunchPreloadedWindow(const winrt::hstring& cwd);
+        void ClaimPreloadedWindow();
         int32_t ExecuteCommandline(array_view<const winrt::hstring> actions, const winrt::hstring& cwd);
         TerminalApp::FindTargetWindowResult FindTargetWindow(array_view<const winrt::hstring> actions);
         winrt::hstring ParseCommandlineMessage();
@@ -116,6 +119,7 @@ namespace winrt::TerminalApp::implementation
 
         void CloseWindow(Microsoft::Terminal::Settings::Model::LaunchPosition position);
         void WindowVisibilityChanged(const bool showOrHide);
+        void InteractiveResizeChanged(const bool inProgress);
 
         winrt::TerminalApp::TaskbarState TaskbarState();
         winrt::Windows::UI::Xaml::Media::Brush TitlebarBrush();
@@ -123,6 +127,7 @@ namespace winrt::TerminalApp::implementation
 
         bool GetMinimizeToNotificationArea();
         bool GetAlwaysShowNotificationIcon();
+        bool GetPreloadWindow();
         bool GetShowTitleInTitlebar();
 
         winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::UI::Xaml::Controls::ContentDialogResult> ShowDialog(winrt::Windows::UI::Xaml::Controls::ContentDialog dialog);
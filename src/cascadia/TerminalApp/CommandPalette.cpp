@@ -916,6 +916,7 @@ namespace winrt::TerminalApp::implementation
 
     void CommandPalette::SetCommands(const Collections::IVector<Command>& actions)
     {
+        _resetFilterCandidates();
         _allCommands.Clear();
         for (const auto& action : actions)
         {
@@ -945,6 +946,7 @@ namespace winrt::TerminalApp::implementation
         const Windows::Foundation::Collections::IObservableVector<winrt::TerminalApp::TabBase>& source,
         const Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand>& target)
     {
+        _resetFilterCandidates();
         target.Clear();
         for (const auto& tab : source)
         {
@@ -1033,6 +1035,7 @@ namespace winrt::TerminalApp::implementation
         // modes because of the sheer amount of remove/adds. So, let's just
         // clear + append when switching between modes.
         _filteredActions.Clear();
+        _resetFilterCandidates();
         _updateFilteredActions();
     }
 
@@ -1047,7 +1050,8 @@ namespace winrt::TerminalApp::implementation
     {
         std::vector<winrt::TerminalApp::FilteredCommand> actions;
 
-        winrt::hstring searchText{ _getTrimmedInput() };
+        const auto trimmedInput{ _getTrimmedInput() };
+        winrt::hstring searchText{ trimmedInput };
 
         auto commandsToFilter = _commandsToFilter();
 
@@ -1057,8 +1061,7 @@ namespace winrt::TerminalApp::implementation
         }
         else if (_currentMode == CommandPaletteMode::TabSearchMode || _currentMode == CommandPaletteMode::ActionMode || _currentMode == CommandPaletteMode::CommandlineMode)
         {
-            for (const auto& action : commandsToFilter)
-            {
+            const auto filterCommand = [&](const auto& action) {
                 // Update filter for all commands
                 // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
                 // Pay attention that it already updates the highlighting in the UI
@@ -1069,7 +1072,34 @@ namespace winrt::TerminalApp::implementation
                 {
                     actions.push_back(action);
                 }
+            };
+
+            // A command only matches if all the characters of the search text appear in its name in order.
+            // If the search text merely grew, the new matches are therefore a subset of the previous ones.
+            // The commands outside of that subset keep a stale filter, but they're updated
+            // once the search text shrinks again and we go back to filtering everything.
+            const auto refine = commandsToFilter == _filterCandidatesSource &&
+                                commandsToFilter.Size() == _filterCandidatesSourceSize &&
+                                til::starts_with(trimmedInput, _filterCandidatesText);
+            if (refine)
+            {
+                for (const auto& action : _filterCandidates)
+                {
+                    filterCommand(action);
+                }
+            }
+            else
+            {
+                for (const auto& action : commandsToFilter)
+                {
+                    filterCommand(action);
+                }
             }
+
+            _filterCandidatesSource = commandsToFilter;
+            _filterCandidatesSourceSize = commandsToFilter.Size();
+            _filterCandidatesText = trimmedInput;
+            _filterCandidates = actions;
         }
 
         // We want to present the commands sorted
@@ -1081,6 +1111,18 @@ namespace winrt::TerminalApp::implementation
         return actions;
     }
 
+    // Method Description:
+    // - Forgets the matches of the last filter text. This needs to be called
+    //   whenever the commands we filter are replaced, so that the next filter
+    //   pass looks at all of them again.
+    void CommandPalette::_resetFilterCandidates() noexcept
+    {
+        _filterCandidatesSource = nullptr;
+        _filterCandidatesSourceSize = 0;
+        _filterCandidatesText.clear();
+        _filterCandidates.clear();
+    }
+
     // Method Description:
     // - Update our list of filtered actions to reflect the current contents of
     //   the input box.
@@ -1136,6 +1178,7 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void CommandPalette::_updateCurrentNestedCommands(const winrt::Microsoft::Terminal::Settings::Model::Command& parentCommand)
     {
+        _resetFilterCandidates();
         _currentNestedCommands.Clear();
         for (const auto& nameAndCommand : parentCommand.NestedCommands())
         {
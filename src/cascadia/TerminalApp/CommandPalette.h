@@ -99,6 +99,14 @@ namespace winrt::TerminalApp::implementation
         void _updateCurrentNestedCommands(const winrt::Microsoft::Terminal::Settings::Model::Command& parentCommand);
 
         std::vector<winrt::TerminalApp::FilteredCommand> _collectFilteredActions();
+        void _resetFilterCandidates() noexcept;
+
+        // The matches of the last filter text. If the user only appends to the
+        // filter text, only these can still match and we don't need to rescan the entire list.
+        Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> _filterCandidatesSource{ nullptr };
+        uint32_t _filterCandidatesSourceSize{ 0 };
+        std::wstring _filterCandidatesText;
+        std::vector<winrt::TerminalApp::FilteredCommand> _filterCandidates;
 
         void _close();
 
@@ -4,6 +4,8 @@
 #include "pch.h"
 #include "DebugTapConnection.h"
 
+#include <ReplayRecording.h>
+
 using namespace ::winrt::Microsoft::Terminal::TerminalConnection;
 using namespace ::winrt::Windows::Foundation;
 namespace winrt::Microsoft::TerminalApp::implementation
@@ -57,8 +59,16 @@ namespace winrt::Microsoft::TerminalApp::implementation
         ITerminalConnection _wrappedConnection;
     };
 
-    DebugTapConnection::DebugTapConnection(ITerminalConnection wrappedConnection)
+    DebugTapConnection::DebugTapConnection(ITerminalConnection wrappedConnection, std::wstring recordingPath) :
+        _recordingPath{ std::move(recordingPath) }
     {
+        if (!_recordingPath.empty())
+        {
+            _recording.reset(CreateFileW(_recordingPath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+            LOG_LAST_ERROR_IF(!_recording);
+            _recordingStart = std::chrono::steady_clock::now();
+        }
+
         _outputRevoker = wrappedConnection.TerminalOutput(winrt::auto_revoke, { this, &DebugTapConnection::_OutputHandler });
         _stateChangedRevoker = wrappedConnection.StateChanged(winrt::auto_revoke, [this](auto&& /*s*/, auto&& /*e*/) {
             _StateChangedHandlers(*this, nullptr);
@@ -76,6 +86,13 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
         // This is explained in the comment for GH#11282 above.
         _start.count_down();
+
+        if (!_recordingPath.empty())
+        {
+            const auto message = _recording ? wil::str_printf<std::wstring>(L"\x1b[93mRecording output to %ls\x1b[m\r\n", _recordingPath.c_str()) :
+                                              wil::str_printf<std::wstring>(L"\x1b[91mFailed to create %ls\x1b[m\r\n", _recordingPath.c_str());
+            _TerminalOutputHandlers(message);
+        }
     }
 
     void DebugTapConnection::WriteInput(const hstring& data)
@@ -98,6 +115,7 @@ namespace winrt::Microsoft::TerminalApp::implementation
         _outputRevoker.revoke();
         _stateChangedRevoker.revoke();
         _wrappedConnection = nullptr;
+        _recording.reset();
     }
 
     ConnectionState DebugTapConnection::State() const noexcept
@@ -111,6 +129,21 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
     void DebugTapConnection::_OutputHandler(const hstring str)
     {
+        if (_recording)
+        {
+            try
+            {
+                const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _recordingStart);
+                ::Microsoft::Terminal::ReplayRecording::WriteChunk(_recording.get(), timestamp, str);
+            }
+            catch (...)
+            {
+                // Stop recording instead of writing a recording with gaps.
+                LOG_CAUGHT_EXCEPTION();
+                _recording.reset();
+            }
+        }
+
         auto output = til::visualize_control_codes(str);
         // To make the output easier to read, we introduce a line break whenever
         // an LF control is encountered. But at this point, the LF would have
@@ -141,10 +174,12 @@ namespace winrt::Microsoft::TerminalApp::implementation
 // - Takes one connection and returns two connections:
 //   1. One that can be used in place of the original connection (wrapped)
 //   2. One that will print raw VT sequences sent into and received _from_ the original connection.
-std::tuple<ITerminalConnection, ITerminalConnection> OpenDebugTapConnection(ITerminalConnection baseConnection)
+// - If recordingPath isn't empty, the output of the original connection is also
+//   recorded to that file, with timestamps, so that ReplayConnection can play it back.
+std::tuple<ITerminalConnection, ITerminalConnection> OpenDebugTapConnection(ITerminalConnection baseConnection, std::wstring recordingPath)
 {
     using namespace winrt::Microsoft::TerminalApp::implementation;
-    auto debugSide{ winrt::make_self<DebugTapConnection>(baseConnection) };
+    auto debugSide{ winrt::make_self<DebugTapConnection>(baseConnection, std::move(recordingPath)) };
     auto inputSide{ winrt::make_self<DebugInputTapConnection>(debugSide, baseConnection) };
     debugSide->SetInputTap(*inputSide);
     std::tuple<ITerminalConnection, ITerminalConnection> p{ *inputSide, *debugSide };
@@ -12,7 +12,7 @@ namespace winrt::Microsoft::TerminalApp::implementation
     class DebugTapConnection : public winrt::implements<DebugTapConnection, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection>
     {
     public:
-        explicit DebugTapConnection(Microsoft::Terminal::TerminalConnection::ITerminalConnection wrappedConnection);
+        explicit DebugTapConnection(Microsoft::Terminal::TerminalConnection::ITerminalConnection wrappedConnection, std::wstring recordingPath = {});
         void Initialize(const Windows::Foundation::Collections::ValueSet& /*settings*/){};
         ~DebugTapConnection();
         void Start();
@@ -38,8 +38,14 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
         til::latch _start{ 1 };
 
+        // If we're recording, the wrapped connection's output is also written
+        // to this file, in the format ReplayConnection plays back.
+        std::wstring _recordingPath;
+        wil::unique_hfile _recording;
+        std::chrono::steady_clock::time_point _recordingStart;
+
         friend class DebugInputTapConnection;
     };
 }
 
-std::tuple<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection> OpenDebugTapConnection(winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection baseConnection);
+std::tuple<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection> OpenDebugTapConnection(winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection baseConnection, std::wstring recordingPath = {});
@@ -26,13 +26,15 @@ namespace winrt::TerminalApp::implementation
         _Filter(L""),
         _Weight(0)
     {
-        _HighlightedName = _computeHighlightedName();
+        _updateFoldedName();
+        _HighlightedName = _unmatchedName;
 
         // Recompute the highlighted name if the item name changes
         _itemChangedRevoker = _Item.PropertyChanged(winrt::auto_revoke, [weakThis{ get_weak() }](auto& /*sender*/, auto& e) {
             auto filteredCommand{ weakThis.get() };
             if (filteredCommand && e.PropertyName() == L"Name")
             {
+                filteredCommand->_updateFoldedName();
                 filteredCommand->HighlightedName(filteredCommand->_computeHighlightedName());
                 filteredCommand->Weight(filteredCommand->_computeWeight());
             }
@@ -46,11 +48,73 @@ namespace winrt::TerminalApp::implementation
         if (filter != _Filter)
         {
             Filter(filter);
+
+            // Most items don't match a non-empty filter. Reject those with a cheap scan of the
+            // folded name, without building any highlighted segments.
+            if (filter.empty() || !_matchesFilter(_foldCase(filter)))
+            {
+                HighlightedName(_unmatchedName);
+                Weight(0);
+                return;
+            }
+
             HighlightedName(_computeHighlightedName());
             Weight(_computeWeight());
         }
     }
 
+    // Method Description:
+    // - Returns a lowercase copy of the given text, using the user's locale
+    //   (GH#9941). Character offsets in the result match those of the input.
+    std::wstring FilteredCommand::_foldCase(const std::wstring_view text)
+    {
+        std::wstring folded{ text };
+        if (!folded.empty())
+        {
+            const auto size = gsl::narrow<int>(folded.size());
+            const auto result = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, LCMAP_LOWERCASE | LCMAP_LINGUISTIC_CASING, text.data(), size, folded.data(), size, nullptr, nullptr, 0);
+            // Fall back to comparing the text as is, if it couldn't be mapped 1:1.
+            if (result != size)
+            {
+                folded = text;
+            }
+        }
+        return folded;
+    }
+
+    // Method Description:
+    // - Recomputes the folded name and the unmatched highlighted name.
+    //   Called whenever the name of the item changes.
+    void FilteredCommand::_updateFoldedName()
+    {
+        const auto name = _Item.Name();
+        _foldedName = _foldCase(name);
+
+        const auto segments = winrt::single_threaded_observable_vector<winrt::TerminalApp::HighlightedTextSegment>();
+        if (!name.empty())
+        {
+            segments.Append(winrt::make<HighlightedTextSegment>(name, false));
+        }
+        _unmatchedName = winrt::make<HighlightedText>(segments);
+    }
+
+    // Method Description:
+    // - Checks whether all the characters of the (folded) filter appear in order in the folded name.
+    bool FilteredCommand::_matchesFilter(const std::wstring_view foldedFilter) const noexcept
+    {
+        size_t offset = 0;
+        for (const auto searchChar : foldedFilter)
+        {
+            offset = _foldedName.find(searchChar, offset);
+            if (offset == std::wstring::npos)
+            {
+                return false;
+            }
+            offset++;
+        }
+        return true;
+    }
+
     // Method Description:
     // - Looks up the filter characters within the item name.
     // Iterating through the filter and the item name it tries to associate the next filter character
@@ -74,13 +138,13 @@ namespace winrt::TerminalApp::implementation
     {
         const auto segments = winrt::single_threaded_observable_vector<winrt::TerminalApp::HighlightedTextSegment>();
         auto commandName = _Item.Name();
+        const auto filter = _foldCase(_Filter);
         auto isProcessingMatchedSegment = false;
         uint32_t nextOffsetToReport = 0;
         uint32_t currentOffset = 0;
 
-        for (const auto searchChar : _Filter)
+        for (const auto searchChar : filter)
         {
-            const WCHAR searchCharAsString[] = { searchChar, L'\0' };
             while (true)
             {
                 if (currentOffset == commandName.size())
@@ -94,9 +158,8 @@ namespace winrt::TerminalApp::implementation
                 }
 
                 // GH#9941: search should be locale-aware as well
-                // We use the same comparison method as upon sorting to guarantee consistent behavior
-                const WCHAR currentCharAsString[] = { commandName[currentOffset], L'\0' };
-                auto isCurrentCharMatched = lstrcmpi(searchCharAsString, currentCharAsString) == 0;
+                // Both the filter and the name are folded using the user's locale
+                auto isCurrentCharMatched = til::at(_foldedName, currentOffset) == searchChar;
                 if (isProcessingMatchedSegment != isCurrentCharMatched)
                 {
                     // We reached the end of the region (matched character came after a series of unmatched or vice versa).
@@ -32,6 +32,16 @@ namespace winrt::TerminalApp::implementation
     private:
         winrt::TerminalApp::HighlightedText _computeHighlightedName();
         int _computeWeight();
+        bool _matchesFilter(const std::wstring_view foldedFilter) const noexcept;
+        void _updateFoldedName();
+
+        static std::wstring _foldCase(const std::wstring_view text);
+
+        // The case-folded item name. Matching against this is much cheaper than
+        // comparing every character pair with lstrcmpi on each keystroke.
+        std::wstring _foldedName;
+        // The highlighted name of a non-matching item, which never changes for a given name.
+        winrt::TerminalApp::HighlightedText _unmatchedName{ nullptr };
         Windows::UI::Xaml::Data::INotifyPropertyChanged::PropertyChanged_revoker _itemChangedRevoker;
 
         friend class TerminalAppLocalTests::FilteredCommandTests;
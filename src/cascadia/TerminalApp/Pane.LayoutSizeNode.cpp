@@ -68,6 +68,6 @@ void Pane::LayoutSizeNode::_AssignChildNode(std::unique_ptr<LayoutSizeNode>& nod
     }
     else
     {
-        nodeField.release();
+        nodeField.reset();
     }
 }
@@ -5,6 +5,10 @@
 #include "Pane.h"
 #include "AppLogic.h"
 
+#include <filesystem>
+
+#include "../../types/inc/utils.hpp"
+
 #include <Mmsystem.h>
 
 using namespace winrt::Windows::Foundation;
@@ -119,7 +123,7 @@ Pane::Pane(std::shared_ptr<Pane> first,
 // - <none>
 // Return Value:
 // - Arguments appropriate for a SplitPane or NewTab action
-NewTerminalArgs Pane::GetTerminalArgsForPane() const
+NewTerminalArgs Pane::GetTerminalArgsForPane(const bool persistBuffer) const
 {
     // Leaves are the only things that have controls
     assert(_IsLeaf());
@@ -156,6 +160,19 @@ NewTerminalArgs Pane::GetTerminalArgsForPane() const
         args.TabColor(winrt::Windows::Foundation::IReference<winrt::Windows::UI::Color>(c));
     }
 
+    // The buffer is stored under a new session ID, which the
+    // restored pane then uses to pick the contents back up.
+    if (persistBuffer)
+    {
+        try
+        {
+            const winrt::hstring sessionId{ ::Microsoft::Console::Utils::GuidToString(::Microsoft::Console::Utils::CreateGuid()) };
+            _control.PersistBuffer(BufferSnapshotPath(sessionId));
+            args.SessionId(sessionId);
+        }
+        CATCH_LOG();
+    }
+
     // TODO:GH#9800 - we used to be able to persist the color scheme that a
     // TermControl was initialized with, by name. With the change to having the
     // control own its own copy of its settings, this isn't possible anymore.
@@ -167,6 +184,19 @@ NewTerminalArgs Pane::GetTerminalArgsForPane() const
     return args;
 }
 
+// Method Description:
+// - Gets the path of the file the buffer of the given session is persisted to.
+// Arguments:
+// - sessionId: the session ID, see GetTerminalArgsForPane()
+// Return Value:
+// - the path, next to the settings file
+winrt::hstring Pane::BufferSnapshotPath(const winrt::hstring& sessionId)
+{
+    const auto directory = std::filesystem::path{ std::wstring_view{ CascadiaSettings::SettingsPath() } }.parent_path();
+    const auto fileName = L"buffer_" + std::wstring{ sessionId } + L".bin";
+    return winrt::hstring{ (directory / fileName).native() };
+}
+
 // Method Description:
 // - Serializes the state of this tab as a series of commands that can be
 //   executed to recreate it.
@@ -175,11 +205,13 @@ NewTerminalArgs Pane::GetTerminalArgsForPane() const
 // Arguments:
 // - currentId: the id to use for the current/first pane
 // - nextId: the id to use for a new pane if we split
+// - persistBuffers: if true, the panes' buffers are persisted so that the
+//   commands restore them, see GetTerminalArgsForPane()
 // Return Value:
 // - The state from building the startup actions, includes a vector of commands,
 //   the original root pane, the id of the focused pane, and the number of panes
 //   created.
-Pane::BuildStartupState Pane::BuildStartupActions(uint32_t currentId, uint32_t nextId)
+Pane::BuildStartupState Pane::BuildStartupActions(uint32_t currentId, uint32_t nextId, const bool persistBuffers)
 {
     // if we are a leaf then all there is to do is defer to the parent.
     if (_IsLeaf())
@@ -195,7 +227,7 @@ Pane::BuildStartupState Pane::BuildStartupActions(uint32_t currentId, uint32_t n
     auto buildSplitPane = [&](auto newPane) {
         ActionAndArgs actionAndArgs;
         actionAndArgs.Action(ShortcutAction::SplitPane);
-        const auto terminalArgs{ newPane->GetTerminalArgsForPane() };
+        const auto terminalArgs{ newPane->GetTerminalArgsForPane(persistBuffers) };
         // When creating a pane the split size is the size of the new pane
         // and not position.
         const auto splitDirection = _splitState == SplitState::Horizontal ? SplitDirection::Down : SplitDirection::Right;
@@ -237,10 +269,10 @@ Pane::BuildStartupState Pane::BuildStartupActions(uint32_t currentId, uint32_t n
     // We now need to execute the commands for each side of the tree
     // We've done one split, so the first-most child will have currentId, and the
     // one after it will be incremented.
-    auto firstState = _firstChild->BuildStartupActions(currentId, nextId + 1);
+    auto firstState = _firstChild->BuildStartupActions(currentId, nextId + 1, persistBuffers);
     // the next id for the second branch depends on how many splits were in the
     // first child.
-    auto secondState = _secondChild->BuildStartupActions(nextId, nextId + firstState.panesCreated + 1);
+    auto secondState = _secondChild->BuildStartupActions(nextId, nextId + firstState.panesCreated + 1, persistBuffers);
 
     std::vector<ActionAndArgs> actions{};
     actions.reserve(firstState.args.size() + secondState.args.size() + 3);
@@ -1441,7 +1473,9 @@ void Pane::_FocusFirstChild()
 // Method Description:
 // - Updates the settings of this pane, presuming that it is a leaf.
 // Arguments:
-// - settings: The new TerminalSettings to apply to any matching controls
+// - settings: The new TerminalSettings to apply to any matching controls, or
+//   nullptr if the profile's settings didn't change. The control is left
+//   alone in that case, which saves it from rebuilding its fonts and such.
 // - profile: The profile from which these settings originated.
 // Return Value:
 // - <none>
@@ -1451,7 +1485,10 @@ void Pane::UpdateSettings(const TerminalSettingsCreateResult& settings, const Pr
 
     _profile = profile;
 
-    _control.UpdateControlSettings(settings.DefaultSettings(), settings.UnfocusedSettings());
+    if (settings)
+    {
+        _control.UpdateControlSettings(settings.DefaultSettings(), settings.UnfocusedSettings());
+    }
 }
 
 // Method Description:
@@ -2747,22 +2784,35 @@ Pane::SnapChildrenSizeResult Pane::_CalcSnappedChildrenSizes(const bool widthOrH
     // only just stop at various moments when the built sizes reaches it.  Eventually, this could
     // be optimized for simple cases like when both children are both leaves with the same character
     // size, but it doesn't seem to be beneficial.
+    //   Since the sequence is always the same, we remember where we stopped. As long as nothing
+    // in our subtree changed, a request for a size beyond the last good one (which is what
+    // happens continuously while the user drags the window larger) continues from there.
+
+    std::vector<float> inputs;
+    _GetLayoutInputs(widthOrHeight, inputs);
 
-    auto sizeTree = _CreateMinSizeTree(widthOrHeight);
-    auto lastSizeTree{ sizeTree };
+    auto& cache = til::at(_layoutCache, widthOrHeight ? 0 : 1);
+    if (!cache || cache->inputs != inputs || cache->lastSizeTree.size >= fullSize)
+    {
+        auto minSizeTree = _CreateMinSizeTree(widthOrHeight);
+        cache = std::make_unique<LayoutCache>(LayoutCache{ std::move(inputs), minSizeTree, minSizeTree });
+    }
+
+    auto& sizeTree = cache->sizeTree;
+    auto& lastSizeTree = cache->lastSizeTree;
 
     while (sizeTree.size < fullSize)
     {
         lastSizeTree = sizeTree;
         _AdvanceSnappedDimension(widthOrHeight, sizeTree);
+    }
 
-        if (sizeTree.size == fullSize)
-        {
-            // If we just hit exactly the requested value, then just return the
-            // current state of children.
-            return { { sizeTree.firstChild->size, sizeTree.secondChild->size },
-                     { sizeTree.firstChild->size, sizeTree.secondChild->size } };
-        }
+    if (sizeTree.size == fullSize)
+    {
+        // If we just hit exactly the requested value, then just return the
+        // current state of children.
+        return { { sizeTree.firstChild->size, sizeTree.secondChild->size },
+                 { sizeTree.firstChild->size, sizeTree.secondChild->size } };
     }
 
     // We exceeded the requested size in the loop above, so lastSizeTree will have
@@ -3034,17 +3084,53 @@ Size Pane::_GetMinSize() const
 // - Root node of built tree that matches this pane.
 Pane::LayoutSizeNode Pane::_CreateMinSizeTree(const bool widthOrHeight) const
 {
-    const auto size = _GetMinSize();
-    LayoutSizeNode node(widthOrHeight ? size.Width : size.Height);
-    if (!_IsLeaf())
+    if (_IsLeaf())
     {
-        node.firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
-        node.secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+        const auto size = _GetMinSize();
+        return LayoutSizeNode(widthOrHeight ? size.Width : size.Height);
     }
 
+    // Derive our minimum size from our children's, which is what _GetMinSize() does
+    // as well, instead of calling it again for every level of the tree.
+    auto firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
+    auto secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+    const auto alongSeparator = _splitState == (widthOrHeight ? SplitState::Horizontal : SplitState::Vertical);
+
+    LayoutSizeNode node(alongSeparator ? std::max(firstChild->size, secondChild->size) : firstChild->size + secondChild->size);
+    node.firstChild = std::move(firstChild);
+    node.secondChild = std::move(secondChild);
     return node;
 }
 
+// Method Description:
+// - Collects everything the layout of our subtree in the given direction
+//   depends on: the structure of the tree, the split positions and the
+//   borders, minimum sizes and cell sizes of the leaves.
+// Arguments:
+// - widthOrHeight: if true operates on width, otherwise on height
+// - inputs: the vector to append the values to
+// Return Value:
+// - <none>
+void Pane::_GetLayoutInputs(const bool widthOrHeight, std::vector<float>& inputs) const
+{
+    if (_IsLeaf())
+    {
+        const auto minSize = _GetMinSize();
+        const auto cellSize = _control.CharacterDimensions();
+        inputs.push_back(static_cast<float>(_borders));
+        inputs.push_back(widthOrHeight ? minSize.Width : minSize.Height);
+        inputs.push_back(widthOrHeight ? cellSize.Width : cellSize.Height);
+    }
+    else
+    {
+        // Sizes are never negative, which makes this distinguishable from a leaf.
+        inputs.push_back(-1.0f - static_cast<float>(_splitState));
+        inputs.push_back(_desiredSplitPosition);
+        _firstChild->_GetLayoutInputs(widthOrHeight, inputs);
+        _secondChild->_GetLayoutInputs(widthOrHeight, inputs);
+    }
+}
+
 // Method Description:
 // - Adjusts split position so that no child pane is smaller then its
 //   minimum size
@@ -91,8 +91,9 @@ public:
         std::optional<uint32_t> focusedPaneId;
         uint32_t panesCreated;
     };
-    BuildStartupState BuildStartupActions(uint32_t currentId, uint32_t nextId);
-    winrt::Microsoft::Terminal::Settings::Model::NewTerminalArgs GetTerminalArgsForPane() const;
+    BuildStartupState BuildStartupActions(uint32_t currentId, uint32_t nextId, const bool persistBuffers = false);
+    winrt::Microsoft::Terminal::Settings::Model::NewTerminalArgs GetTerminalArgsForPane(const bool persistBuffer = false) const;
+    static winrt::hstring BufferSnapshotPath(const winrt::hstring& sessionId);
 
     void UpdateSettings(const winrt::Microsoft::Terminal::Settings::Model::TerminalSettingsCreateResult& settings,
                         const winrt::Microsoft::Terminal::Settings::Model::Profile& profile);
@@ -210,6 +211,7 @@ private:
     struct SnapSizeResult;
     struct SnapChildrenSizeResult;
     struct LayoutSizeNode;
+    struct LayoutCache;
 
     winrt::Windows::UI::Xaml::Controls::Grid _root{};
     winrt::Windows::UI::Xaml::Controls::Border _borderFirst{};
@@ -232,6 +234,8 @@ private:
     std::weak_ptr<Pane> _parentChildPath{};
 
     bool _lastActive{ false };
+    // The last state of _CalcSnappedChildrenSizes, for widths and heights respectively.
+    mutable std::array<std::unique_ptr<LayoutCache>, 2> _layoutCache;
     winrt::event_token _connectionStateChangedToken{ 0 };
     winrt::event_token _firstClosedToken{ 0 };
     winrt::event_token _secondClosedToken{ 0 };
@@ -296,6 +300,7 @@ private:
     void _AdvanceSnappedDimension(const bool widthOrHeight, LayoutSizeNode& sizeNode) const;
     winrt::Windows::Foundation::Size _GetMinSize() const;
     LayoutSizeNode _CreateMinSizeTree(const bool widthOrHeight) const;
+    void _GetLayoutInputs(const bool widthOrHeight, std::vector<float>& inputs) const;
     float _ClampSplitPosition(const bool widthOrHeight, const float requestedValue, const float totalSize) const;
 
     SplitState _convertAutomaticOrDirectionalSplitState(const winrt::Microsoft::Terminal::Settings::Model::SplitDirection& splitType) const;
@@ -390,6 +395,18 @@ private:
         void _AssignChildNode(std::unique_ptr<LayoutSizeNode>& nodeField, const LayoutSizeNode* const newNode);
     };
 
+    // Remembers where the last call to _CalcSnappedChildrenSizes stopped
+    // advancing the size tree. The sizes are always advanced in the same
+    // sequence, so a request for a larger size can continue from there
+    // instead of starting over from the minimum sizes.
+    struct LayoutCache
+    {
+        // Everything the sequence depends on, see _GetLayoutInputs().
+        std::vector<float> inputs;
+        LayoutSizeNode lastSizeTree;
+        LayoutSizeNode sizeTree;
+    };
+
     friend struct winrt::TerminalApp::implementation::TerminalTab;
     friend class ::TerminalAppLocalTests::TabTests;
 };
@@ -111,6 +111,15 @@ namespace winrt::TerminalApp::implementation
         flyout.Items().Append(_closeTabsAfterMenuItem);
         flyout.Items().Append(_closeOtherTabsMenuItem);
         flyout.Items().Append(closeTabMenuItem);
+
+        // Only update the close menu items when the menu is actually shown, instead
+        // of touching the menu of every tab whenever a tab is added or removed.
+        flyout.Opening([weakThis](auto&&, auto&&) {
+            if (auto tab{ weakThis.get() })
+            {
+                tab->_EnableCloseMenuItems();
+            }
+        });
     }
 
     // Method Description:
@@ -145,10 +154,15 @@ namespace winrt::TerminalApp::implementation
 
     void TabBase::UpdateTabViewIndex(const uint32_t idx, const uint32_t numTabs)
     {
+        const auto indexChanged = idx != _TabViewIndex;
         TabViewIndex(idx);
         TabViewNumTabs(numTabs);
-        _EnableCloseMenuItems();
-        _UpdateSwitchToTabKeyChord();
+
+        // The key chord only depends on our index.
+        if (indexChanged)
+        {
+            _UpdateSwitchToTabKeyChord();
+        }
     }
 
     void TabBase::SetDispatch(const winrt::TerminalApp::ShortcutActionDispatch& dispatch)
@@ -210,8 +224,18 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void TabBase::_UpdateToolTip()
     {
+        // Building the tool tip is comparatively expensive and titles might change very often.
+        auto title = _CreateToolTipTitle();
+        if (_hasToolTip && title == _toolTipTitle && _keyChord == _toolTipKeyChord)
+        {
+            return;
+        }
+        _hasToolTip = true;
+        _toolTipTitle = title;
+        _toolTipKeyChord = _keyChord;
+
         auto titleRun = WUX::Documents::Run();
-        titleRun.Text(_CreateToolTipTitle());
+        titleRun.Text(title);
 
         auto textBlock = WUX::Controls::TextBlock{};
         textBlock.TextWrapping(WUX::TextWrapping::Wrap);
@@ -23,7 +23,7 @@ namespace winrt::TerminalApp::implementation
 
         void UpdateTabViewIndex(const uint32_t idx, const uint32_t numTabs);
         void SetActionMap(const Microsoft::Terminal::Settings::Model::IActionMapView& actionMap);
-        virtual std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs> BuildStartupActions() const = 0;
+        virtual std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs> BuildStartupActions(const bool persistBuffers = false) const = 0;
 
         WINRT_CALLBACK(RequestFocusActiveControl, winrt::delegate<void()>);
 
@@ -50,6 +50,9 @@ namespace winrt::TerminalApp::implementation
         winrt::TerminalApp::ShortcutActionDispatch _dispatch;
         Microsoft::Terminal::Settings::Model::IActionMapView _actionMap{ nullptr };
         winrt::hstring _keyChord{};
+        winrt::hstring _toolTipTitle{};
+        winrt::hstring _toolTipKeyChord{};
+        bool _hasToolTip{ false };
 
         virtual void _CreateContextMenu();
         virtual winrt::hstring _CreateToolTipTitle();
@@ -144,7 +144,7 @@ namespace winrt::TerminalApp::implementation
         newTabImpl->SetActionMap(_settings.ActionMap());
 
         // Give the tab its index in the _tabs vector so it can manage its own SwitchToTab command.
-        _UpdateTabIndices();
+        _UpdateTabIndices(insertPosition);
 
         // Hookup our event handlers to the new terminal
         _RegisterTabEvents(*newTabImpl);
@@ -450,8 +450,7 @@ namespace winrt::TerminalApp::implementation
 
                 if (!path.empty())
                 {
-                    const auto buffer = control.ReadEntireBuffer();
-                    CascadiaSettings::ExportFile(path, buffer);
+                    co_await control.ExportBufferAsync(path);
                 }
             }
         }
@@ -534,7 +533,7 @@ namespace winrt::TerminalApp::implementation
 
         _tabs.RemoveAt(tabIndex);
         _tabView.TabItems().RemoveAt(tabIndex);
-        _UpdateTabIndices();
+        _UpdateTabIndices(tabIndex);
 
         // To close the window here, we need to close the hosting window.
         if (_tabs.Size() == 0)
@@ -986,13 +985,19 @@ namespace winrt::TerminalApp::implementation
     // Method Description:
     // - Updates all tabs with their current index in _tabs.
     // Arguments:
-    // - <none>
+    // - startIndex: the index of the first tab that might have moved. The tabs
+    //   before it only learn about the new number of tabs.
     // Return Value:
     // - <none>
-    void TerminalPage::_UpdateTabIndices()
+    void TerminalPage::_UpdateTabIndices(const uint32_t startIndex)
     {
         const auto size = _tabs.Size();
-        for (uint32_t i = 0; i < size; ++i)
+        for (uint32_t i = 0; i < std::min(startIndex, size); ++i)
+        {
+            auto tabImpl{ winrt::get_self<TabBase>(_tabs.GetAt(i)) };
+            tabImpl->TabViewNumTabs(size);
+        }
+        for (auto i = startIndex; i < size; ++i)
         {
             auto tab{ _tabs.GetAt(i) };
             auto tabImpl{ winrt::get_self<TabBase>(tab) };
@@ -1035,7 +1040,7 @@ namespace winrt::TerminalApp::implementation
             auto tabViewItem = tab.TabViewItem();
             _tabs.RemoveAt(currentTabIndex);
             _tabs.InsertAt(newTabIndex, tab);
-            _UpdateTabIndices();
+            _UpdateTabIndices(std::min(currentTabIndex, newTabIndex));
 
             _tabView.TabItems().RemoveAt(currentTabIndex);
             _tabView.TabItems().InsertAt(newTabIndex, tabViewItem);
@@ -1063,7 +1068,7 @@ namespace winrt::TerminalApp::implementation
             auto tab = tabs.GetAt(from.value());
             tabs.RemoveAt(from.value());
             tabs.InsertAt(to.value(), tab);
-            _UpdateTabIndices();
+            _UpdateTabIndices(gsl::narrow_cast<uint32_t>(std::min(from.value(), to.value())));
         }
 
         _rearranging = false;
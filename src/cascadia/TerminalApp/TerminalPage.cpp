@@ -17,6 +17,7 @@
 #include "../../types/inc/utils.hpp"
 #include "ColorHelper.h"
 #include "DebugTapConnection.h"
+#include <ReplayRecording.h>
 #include "SettingsTab.h"
 #include "TabRowControl.h"
 
@@ -128,7 +129,7 @@ namespace winrt::TerminalApp::implementation
 
     void TerminalPage::SetSettings(CascadiaSettings settings, bool needRefreshUI)
     {
-        _settings = settings;
+        const auto previousSettings = std::exchange(_settings, settings);
 
         // Make sure to _UpdateCommandsForPalette before
         // _RefreshUIForSettingsReload. _UpdateCommandsForPalette will make
@@ -140,12 +141,20 @@ namespace winrt::TerminalApp::implementation
 
         if (needRefreshUI)
         {
-            _RefreshUIForSettingsReload();
+            _RefreshUIForSettingsReload(previousSettings);
         }
 
         // Upon settings update we reload the system settings for scrolling as well.
         // TODO: consider reloading this value periodically.
         _systemRowsToScroll = _ReadSystemRowsToScroll();
+
+        // The pool is shared by all windows of this process, which all have the same settings.
+        try
+        {
+            const auto pooledConsoleHosts = std::clamp(_settings.GlobalSettings().PooledConsoleHosts(), 0, 4);
+            winrt::Microsoft::Terminal::TerminalConnection::ConptyConnection::SetConsoleHostPoolSize(gsl::narrow_cast<uint32_t>(pooledConsoleHosts));
+        }
+        CATCH_LOG();
     }
 
     bool TerminalPage::IsElevated() const noexcept
@@ -688,6 +697,13 @@ namespace winrt::TerminalApp::implementation
     {
         _startupState = StartupState::Initialized;
 
+        // A preloaded window stays empty until it's launched. It must neither
+        // close itself for lack of tabs nor apply its launch mode yet.
+        if (_isPreloadedWindow)
+        {
+            return;
+        }
+
         // GH#632 - It's possible that the user tried to create the terminal
         // with only one tab, with only an elevated profile. If that happens,
         // we'll create _another_ process to host the elevated version of that
@@ -1112,6 +1128,28 @@ namespace winrt::TerminalApp::implementation
             connection.Initialize(valueSet);
         }
 
+        else if (connectionType == TerminalConnection::ReplayConnection::ConnectionType())
+        {
+            // The commandline of a replay profile is the path to the recording,
+            // optionally followed by the playback speed (0 plays it as fast as possible).
+            auto path{ settings.Commandline() };
+            auto speed = 1.0;
+
+            auto argc = 0;
+            wil::unique_hlocal_ptr<PWSTR[]> argv{ CommandLineToArgvW(path.c_str(), &argc) };
+            if (argv && argc >= 1)
+            {
+                path = argv[0];
+                if (argc >= 2)
+                {
+                    speed = std::wcstod(argv[1], nullptr);
+                }
+            }
+
+            connection = TerminalConnection::ReplayConnection();
+            connection.Initialize(TerminalConnection::ReplayConnection::CreateSettings(path, speed));
+        }
+
         else
         {
             // profile is guaranteed to exist here
@@ -1645,7 +1683,9 @@ namespace winrt::TerminalApp::implementation
         for (auto tab : _tabs)
         {
             auto t = winrt::get_self<implementation::TabBase>(tab);
-            auto tabActions = t->BuildStartupActions();
+            // The layout is only ever requested when the window is closing,
+            // so it's a good time to persist the buffers for the next session.
+            auto tabActions = t->BuildStartupActions(true);
             actions.insert(actions.end(), std::make_move_iterator(tabActions.begin()), std::make_move_iterator(tabActions.end()));
         }
 
@@ -2468,6 +2508,11 @@ namespace winrt::TerminalApp::implementation
             term.WindowVisibilityChanged(_visible);
         }
 
+        if (_interactiveResizeInProgress)
+        {
+            term.InteractiveResizeChanged(true);
+        }
+
         if (_hostingHwnd.has_value())
         {
             term.OwningHwnd(reinterpret_cast<uint64_t>(*_hostingHwnd));
@@ -2546,13 +2591,29 @@ namespace winrt::TerminalApp::implementation
                                          WI_IsFlagSet(rAltState, CoreVirtualKeyStates::Down);
             if (bothAltsPressed)
             {
-                std::tie(connection, debugConnection) = OpenDebugTapConnection(connection);
+                // Holding shift as well records the output of the connection as
+                // it's tapped, so that it can be played back with a ReplayConnection.
+                std::wstring recordingPath;
+                if (WI_IsFlagSet(window.GetKeyState(VirtualKey::Shift), CoreVirtualKeyStates::Down))
+                {
+                    SYSTEMTIME time;
+                    GetLocalTime(&time);
+                    const auto filename = fmt::format(L"WindowsTerminal-{:04}{:02}{:02}-{:02}{:02}{:02}{}", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, ::Microsoft::Terminal::ReplayRecording::FileExtension);
+                    recordingPath = (std::filesystem::temp_directory_path() / filename).wstring();
+                }
+
+                std::tie(connection, debugConnection) = OpenDebugTapConnection(connection, std::move(recordingPath));
             }
         }
 
         const auto control = _InitControl(controlSettings, connection);
         _RegisterTerminalEvents(control);
 
+        if (newTerminalArgs && !newTerminalArgs.SessionId().empty())
+        {
+            control.RestoreBuffer(Pane::BufferSnapshotPath(newTerminalArgs.SessionId()));
+        }
+
         auto resultPane = std::make_shared<Pane>(profile, control);
 
         if (debugConnection) // this will only be set if global debugging is on and tap is active
@@ -2634,7 +2695,11 @@ namespace winrt::TerminalApp::implementation
     //   This includes update the settings of all the tabs according
     //   to their profiles, update the title and icon of each tab, and
     //   finally create the tab flyout
-    void TerminalPage::_RefreshUIForSettingsReload()
+    // - Only the controls whose profiles changed compared to previousSettings
+    //   get new settings, as updating a control isn't cheap.
+    // Arguments:
+    // - previousSettings: the settings we had before the reload, if any
+    void TerminalPage::_RefreshUIForSettingsReload(const CascadiaSettings& previousSettings)
     {
         // Re-wire the keybindings to their handlers, as we'll have created a
         // new AppKeyBindings object.
@@ -2648,6 +2713,9 @@ namespace winrt::TerminalApp::implementation
         const auto profileDefaults{ _settings.ProfileDefaults() };
         const auto allProfiles{ _settings.AllProfiles() };
 
+        // If this is null, settings that all profiles depend on changed and every control needs updating.
+        const auto changedProfiles{ _settings.ProfilesChangedSince(previousSettings) };
+
         profileGuidSettingsMap.reserve(allProfiles.Size() + 1);
 
         // Include the Defaults profile for consideration
@@ -2690,6 +2758,13 @@ namespace winrt::TerminalApp::implementation
                         if (found != profileGuidSettingsMap.cend())
                         {
                             auto& pair{ found->second };
+                            uint32_t index;
+                            if (changedProfiles && !changedProfiles.IndexOf(profile.Guid(), index))
+                            {
+                                pane->UpdateSettings(nullptr, pair.first);
+                                return;
+                            }
+
                             if (!pair.second)
                             {
                                 pair.second = TerminalSettings::CreateWithProfile(_settings, pair.first, *_bindings);
@@ -2892,6 +2967,67 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Routine Description:
+    // - Notifies this Terminal Page that it belongs to a window that was
+    //   started ahead of time, before anyone asked for it. It won't create any
+    //   tabs until LaunchPreloadedWindow is called.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TerminalPage::SetPreloadedWindow()
+    {
+        _isPreloadedWindow = true;
+
+        // The preloaded window also serves as a warm default terminal: its handoff
+        // server is registered ahead of time, which saves the handoff the start
+        // of a whole new window process. Defterm doesn't work elevated though.
+        if (!IsElevated())
+        {
+            _isPreloadedHandoffListener = true;
+            SetInboundListener(false);
+        }
+    }
+
+    // Routine Description:
+    // - Turns a preloaded window into a regular one, by processing the startup
+    //   actions it was given via SetStartupActions in the meantime.
+    // Arguments:
+    // - cwd - The directory to process the startup actions in.
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget TerminalPage::LaunchPreloadedWindow(const winrt::hstring cwd)
+    {
+        auto weakThis{ get_weak() };
+
+        // Let the (empty) initial ProcessStartupActions finish first, if it's
+        // still pending. It needs to see that we're still preloaded.
+        co_await wil::resume_foreground(Dispatcher(), CoreDispatcherPriority::Normal);
+
+        if (auto page{ weakThis.get() })
+        {
+            _isPreloadedWindow = false;
+
+            // We're not the spare window anymore, so the next handoff
+            // should go to the preloaded window replacing us instead.
+            if (std::exchange(_isPreloadedHandoffListener, false))
+            {
+                try
+                {
+                    winrt::Microsoft::Terminal::TerminalConnection::ConptyConnection::StopInboundListener();
+                }
+                CATCH_LOG();
+            }
+
+            // If the page hasn't been laid out yet, _OnFirstLayout will
+            // process the startup actions once it is.
+            if (_startupState != StartupState::NotInitialized)
+            {
+                ProcessStartupActions(_startupActions, true, cwd);
+            }
+        }
+    }
+
     winrt::TerminalApp::IDialogPresenter TerminalPage::DialogPresenter() const
     {
         return _dialogPresenter.get();
@@ -2977,6 +3113,31 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - Notifies all attached controls that the user started or stopped
+    //   dragging the border of the hosting window, so that they can defer
+    //   reflowing their buffers until the size settles.
+    // Arguments:
+    // - inProgress: True when the resize started; false when it ended.
+    // Return Value:
+    // - <none>
+    void TerminalPage::InteractiveResizeChanged(const bool inProgress)
+    {
+        _interactiveResizeInProgress = inProgress;
+        for (const auto& tab : _tabs)
+        {
+            if (auto terminalTab{ _GetTerminalTabImpl(tab) })
+            {
+                terminalTab->GetRootPane()->WalkTree([&](auto&& pane) {
+                    if (auto control = pane->GetTerminalControl())
+                    {
+                        control.InteractiveResizeChanged(inProgress);
+                    }
+                });
+            }
+        }
+    }
+
     // Method Description:
     // - Called when the user tries to do a search using keybindings.
     //   This will tell the current focused terminal control to create
@@ -3250,20 +3411,23 @@ namespace winrt::TerminalApp::implementation
     {
         // We need to be on the UI thread in order for _OpenNewTab to run successfully.
         // HasThreadAccess will return true if we're currently on a UI thread and false otherwise.
-        // When we're on a COM thread, we'll need to dispatch the calls to the UI thread
-        // and wait on it hence the locking mechanism.
+        // When we're on a COM thread, we'll need to dispatch the calls to the UI thread.
+        // We don't wait for them: the connection already drains the client's output
+        // (see ConptyConnection::NewHandoff), so neither the client nor the console
+        // host that handed it to us need to wait for the tab to be built.
         if (!Dispatcher().HasThreadAccess())
         {
-            til::latch latch{ 1 };
-            auto finalVal = S_OK;
-
-            Dispatcher().RunAsync(CoreDispatcherPriority::Normal, [&]() {
-                finalVal = _OnNewConnection(connection);
-                latch.count_down();
+            Dispatcher().RunAsync(CoreDispatcherPriority::Normal, [weakThis{ get_weak() }, connection]() {
+                if (const auto page{ weakThis.get() })
+                {
+                    if (FAILED(page->_OnNewConnection(connection)))
+                    {
+                        // Nobody would ever close the connection otherwise.
+                        connection.Close();
+                    }
+                }
             });
-
-            latch.wait();
-            return finalVal;
+            return S_OK;
         }
 
         try
@@ -3282,6 +3446,20 @@ namespace winrt::TerminalApp::implementation
             });
             _CreateNewTabFromPane(newPane);
 
+            // A preloaded window that receives a handoff becomes a regular window. Its
+            // registration as the handoff server was single-use, so it's gone already.
+            // The summon below lets AppHost show the window.
+            if (std::exchange(_isPreloadedWindow, false))
+            {
+                _isPreloadedHandoffListener = false;
+
+                // Our (empty) startup skipped this, because we were preloaded.
+                if (_startupState == StartupState::Initialized)
+                {
+                    _CompleteInitialization();
+                }
+            }
+
             // Request a summon of this window to the foreground
             _SummonWindowRequestedHandlers(*this, nullptr);
 
@@ -3330,7 +3508,7 @@ namespace winrt::TerminalApp::implementation
             newTabImpl->SetActionMap(_settings.ActionMap());
 
             // Give the tab its index in the _tabs vector so it can manage its own SwitchToTab command.
-            _UpdateTabIndices();
+            _UpdateTabIndices(_tabs.Size() - 1);
 
             // Don't capture a strong ref to the tab. If the tab is removed as this
             // is called, we don't really care anymore about handling the event.
@@ -76,6 +76,7 @@ namespace winrt::TerminalApp::implementation
 
         void TitlebarClicked();
         void WindowVisibilityChanged(const bool showOrHide);
+        void InteractiveResizeChanged(const bool inProgress);
 
         float CalcSnappedDimension(const bool widthOrHeight, const float dimension) const;
 
@@ -99,6 +100,8 @@ namespace winrt::TerminalApp::implementation
         void SetStartupActions(std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs>& actions);
 
         void SetInboundListener(bool isEmbedding);
+        void SetPreloadedWindow();
+        winrt::fire_and_forget LaunchPreloadedWindow(const winrt::hstring cwd);
         static std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs> ConvertExecuteCommandlineToActions(const Microsoft::Terminal::Settings::Model::ExecuteCommandlineArgs& args);
 
         winrt::TerminalApp::IDialogPresenter DialogPresenter() const;
@@ -182,7 +185,7 @@ namespace winrt::TerminalApp::implementation
         Windows::Foundation::Collections::IObservableVector<TerminalApp::TabBase> _mruTabs;
         static winrt::com_ptr<TerminalTab> _GetTerminalTabImpl(const TerminalApp::TabBase& tab);
 
-        void _UpdateTabIndices();
+        void _UpdateTabIndices(const uint32_t startIndex = 0);
 
         TerminalApp::SettingsTab _settingsTab{ nullptr };
 
@@ -203,6 +206,7 @@ namespace winrt::TerminalApp::implementation
 
         bool _activated{ false };
         bool _visible{ true };
+        bool _interactiveResizeInProgress{ false };
 
         std::vector<std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs>> _previouslyClosedPanesAndTabs{};
 
@@ -220,6 +224,8 @@ namespace winrt::TerminalApp::implementation
         Windows::Foundation::Collections::IVector<Microsoft::Terminal::Settings::Model::ActionAndArgs> _startupActions;
         bool _shouldStartInboundListener{ false };
         bool _isEmbeddingInboundListener{ false };
+        bool _isPreloadedWindow{ false };
+        bool _isPreloadedHandoffListener{ false };
 
         std::shared_ptr<Toast> _windowIdToast{ nullptr };
         std::shared_ptr<Toast> _windowRenameFailedToast{ nullptr };
@@ -388,7 +394,7 @@ namespace winrt::TerminalApp::implementation
                                         const bool duplicate = false,
                                         winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection existingConnection = nullptr);
 
-        void _RefreshUIForSettingsReload();
+        void _RefreshUIForSettingsReload(const Microsoft::Terminal::Settings::Model::CascadiaSettings& previousSettings);
 
         void _SetNewTabButtonColor(const Windows::UI::Color& color, const Windows::UI::Color& accentColor);
         void _ClearNewTabButtonColor();
@@ -10,6 +10,8 @@
 #include "ColorHelper.h"
 #include "AppLogic.h"
 
+constexpr const auto TitleUpdateInterval = std::chrono::milliseconds(50);
+
 using namespace winrt;
 using namespace winrt::Windows::UI::Xaml;
 using namespace winrt::Windows::UI::Core;
@@ -71,6 +73,19 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void TerminalTab::_Setup()
     {
+        if (const auto dispatcher = winrt::Windows::System::DispatcherQueue::GetForCurrentThread())
+        {
+            _updateTitle = std::make_shared<ThrottledFuncTrailing<>>(
+                dispatcher,
+                TitleUpdateInterval,
+                [weakThis = get_weak()]() {
+                    if (auto tab{ weakThis.get() })
+                    {
+                        tab->UpdateTitle();
+                    }
+                });
+        }
+
         _rootClosedToken = _rootPane->Closed([=](auto&& /*s*/, auto&& /*e*/) {
             _ClosedHandlers(nullptr, nullptr);
         });
@@ -402,12 +417,16 @@ namespace winrt::TerminalApp::implementation
         if (auto tab{ weakThis.get() })
         {
             const auto activeTitle = _GetActiveTitle();
+            const auto titleChanged = activeTitle != _Title;
             // Bubble our current tab text to anyone who's listening for changes.
             Title(activeTitle);
 
             // Update the control to reflect the changed title
             _headerControl.Title(activeTitle);
-            Automation::AutomationProperties::SetName(tab->TabViewItem(), activeTitle);
+            if (titleChanged)
+            {
+                Automation::AutomationProperties::SetName(tab->TabViewItem(), activeTitle);
+            }
             _UpdateToolTip();
         }
     }
@@ -434,19 +453,20 @@ namespace winrt::TerminalApp::implementation
     // - Serializes the state of this tab as a series of commands that can be
     //   executed to recreate it.
     // Arguments:
-    // - <none>
+    // - persistBuffers: if true, the panes' buffers are persisted so that
+    //   the commands restore them
     // Return Value:
     // - A vector of commands
-    std::vector<ActionAndArgs> TerminalTab::BuildStartupActions() const
+    std::vector<ActionAndArgs> TerminalTab::BuildStartupActions(const bool persistBuffers) const
     {
         // Give initial ids (0 for the child created with this tab,
         // 1 for the child after the first split.
-        auto state = _rootPane->BuildStartupActions(0, 1);
+        auto state = _rootPane->BuildStartupActions(0, 1, persistBuffers);
 
         {
             ActionAndArgs newTabAction{};
             newTabAction.Action(ShortcutAction::NewTab);
-            NewTabArgs newTabArgs{ state.firstPane->GetTerminalArgsForPane() };
+            NewTabArgs newTabArgs{ state.firstPane->GetTerminalArgsForPane(persistBuffers) };
             newTabAction.Args(newTabArgs);
 
             state.args.emplace(state.args.begin(), std::move(newTabAction));
@@ -890,7 +910,14 @@ namespace winrt::TerminalApp::implementation
             {
                 // The title of the control changed, but not necessarily the title of the tab.
                 // Set the tab's text to the active panes' text.
-                tab->UpdateTitle();
+                if (tab->_updateTitle)
+                {
+                    tab->_updateTitle->Run();
+                }
+                else
+                {
+                    tab->UpdateTitle();
+                }
             }
         });
 
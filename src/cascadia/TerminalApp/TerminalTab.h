@@ -7,6 +7,8 @@
 #include "TabBase.h"
 #include "TerminalTab.g.h"
 
+#include <ThrottledFunc.h>
+
 static constexpr double HeaderRenameBoxWidthDefault{ 165 };
 static constexpr double HeaderRenameBoxWidthTitleLength{ std::numeric_limits<double>::infinity() };
 
@@ -84,7 +86,7 @@ namespace winrt::TerminalApp::implementation
         void EnterZoom();
         void ExitZoom();
 
-        std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs> BuildStartupActions() const override;
+        std::vector<Microsoft::Terminal::Settings::Model::ActionAndArgs> BuildStartupActions(const bool persistBuffers = false) const override;
 
         int GetLeafPaneCount() const noexcept;
 
@@ -151,6 +153,11 @@ namespace winrt::TerminalApp::implementation
 
         winrt::TerminalApp::ShortcutActionDispatch _dispatch;
 
+        // Coalesces title changes of our controls. Programs may change
+        // their title many times per second and with hundreds of tabs this
+        // would otherwise keep the UI thread busy updating our headers.
+        std::shared_ptr<ThrottledFuncTrailing<>> _updateTitle;
+
         void _Setup();
 
         std::optional<Windows::UI::Xaml::DispatcherTimer> _bellIndicatorTimer;
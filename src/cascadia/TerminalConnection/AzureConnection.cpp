@@ -184,11 +184,19 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         if (_state == AzureState::TermConnected)
         {
             // If we're connected, we don't need to do any fun input shenanigans.
-            websocket_outgoing_message msg;
-            const auto str = winrt::to_string(data);
-            msg.set_utf8_message(str);
+            // The first keystroke is sent right away. Anything typed while it's still
+            // in flight, which takes a round trip on high-latency links, is coalesced.
+            {
+                std::lock_guard<std::mutex> lock{ _sendMutex };
+                _pendingSend.append(winrt::to_string(data));
+                if (_sending)
+                {
+                    return;
+                }
+                _sending = true;
+            }
 
-            _cloudShellSocket.send(msg).get();
+            _SendPendingInput();
             return;
         }
 
@@ -223,6 +231,37 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
     }
 
+    // Method description:
+    // - sends all of the input that's been collected by WriteInput in one message
+    //   and calls itself again once that's done, until there's no input left.
+    void AzureConnection::_SendPendingInput()
+    {
+        websocket_outgoing_message msg;
+        {
+            std::lock_guard<std::mutex> lock{ _sendMutex };
+            if (_pendingSend.empty())
+            {
+                _sending = false;
+                return;
+            }
+            msg.set_utf8_message(std::move(_pendingSend));
+            _pendingSend.clear();
+        }
+
+        _cloudShellSocket.send(msg).then([weakThis = get_weak()](pplx::task<void> sent) {
+            try
+            {
+                sent.get();
+            }
+            CATCH_LOG();
+
+            if (const auto self = weakThis.get())
+            {
+                self->_SendPendingInput();
+            }
+        });
+    }
+
     // Method description:
     // - ascribes to the ITerminalConnection interface
     // - resizes the terminal
@@ -382,14 +421,21 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 case AzureState::TermConnected:
                 {
                     _transitionToState(ConnectionState::Connected);
+
+                    // At most this much output is dispatched at once, so that
+                    // the terminal gets to show something during a flood.
+                    static constexpr size_t maxBatchSize = 128 * 1024;
+
+                    // The next receive is always posted before the current message is
+                    // dispatched, so that the next message can arrive in the meantime.
+                    auto nextMsg = _cloudShellSocket.receive();
                     while (true)
                     {
                         // Read from websocket
-                        pplx::task<websocket_incoming_message> msgT;
+                        websocket_incoming_message msg;
                         try
                         {
-                            msgT = _cloudShellSocket.receive();
-                            msgT.wait();
+                            msg = nextMsg.get();
                         }
                         catch (...)
                         {
@@ -400,17 +446,32 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                                 // End the output thread.
                                 return S_FALSE;
                             }
+                            throw;
                         }
+                        nextMsg = _cloudShellSocket.receive();
 
-                        auto msg = msgT.get();
-                        auto msgStringTask = msg.extract_string();
-                        auto msgString = msgStringTask.get();
+                        _receiveBuffer.clear();
+                        _receiveBuffer.append(msg.extract_string().get());
 
-                        // Convert to hstring
-                        const auto hstr = winrt::to_hstring(msgString);
+                        // Collect any messages that have already arrived, so that
+                        // the terminal processes them in one go. A failed receive
+                        // is dealt with by the next iteration of the outer loop.
+                        while (nextMsg.is_done() && _receiveBuffer.size() < maxBatchSize)
+                        {
+                            try
+                            {
+                                msg = nextMsg.get();
+                            }
+                            catch (...)
+                            {
+                                break;
+                            }
+                            nextMsg = _cloudShellSocket.receive();
+                            _receiveBuffer.append(msg.extract_string().get());
+                        }
 
                         // Pass the output to our registered event handlers
-                        _TerminalOutputHandlers(hstr);
+                        _TerminalOutputHandlers(winrt::to_hstring(_receiveBuffer));
                     }
                     return S_OK;
                 }
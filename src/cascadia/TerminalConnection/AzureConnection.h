@@ -97,6 +97,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         web::websockets::client::websocket_client _cloudShellSocket;
 
+        // Input that's typed while a previous send is still in flight is
+        // collected here and sent in one message once that send completes.
+        std::mutex _sendMutex;
+        std::string _pendingSend;
+        bool _sending{ false };
+        void _SendPendingInput();
+
+        // Output of consecutive messages, which are dispatched together.
+        std::string _receiveBuffer;
+
         static std::optional<utility::string_t> _ParsePreferredShellType(const web::json::value& settingsResponse);
     };
 }
@@ -288,12 +288,59 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return _commandline;
     }
 
+    // Method Description:
+    // - Starts connecting on a background thread. Creating the pseudoconsole and
+    //   the client process can take a long time, for instance if antivirus software
+    //   hooks process creation, and we mustn't block the UI thread meanwhile.
+    //   Until we're connected, input, resizes etc. are stashed and applied later.
     void ConptyConnection::Start()
-    try
     {
         _transitionToState(ConnectionState::Connecting);
 
-        const til::size dimensions{ gsl::narrow<til::CoordType>(_initialCols), gsl::narrow<til::CoordType>(_initialRows) };
+        _hConnectThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                const auto pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    try
+                    {
+                        // Keep us alive until we're done connecting.
+                        auto strongThis{ pInstance->get_strong() };
+                        pInstance->_Connect();
+                        return DWORD{ 0 };
+                    }
+                    CATCH_LOG();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        if (!_hConnectThread)
+        {
+            // We can still connect, just not in the background.
+            LOG_LAST_ERROR();
+            _Connect();
+            return;
+        }
+
+        LOG_IF_FAILED(SetThreadDescription(_hConnectThread.get(), L"ConptyConnection Connect Thread"));
+    }
+
+    // Method Description:
+    // - Creates the pseudoconsole and launches the client (unless this is an
+    //   inbound handoff), then starts reading their output. Runs on its own thread.
+    void ConptyConnection::_Connect()
+    try
+    {
+        til::size dimensions;
+        {
+            const std::lock_guard lock{ _connectMutex };
+            dimensions = { gsl::narrow<til::CoordType>(_initialCols), gsl::narrow<til::CoordType>(_initialRows) };
+        }
 
         // If we do not have pipes already, then this is a fresh connection... not an inbound one that is a received
         // handoff from an already-started PTY process.
@@ -347,29 +394,17 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             }
         }
 
-        _startTime = std::chrono::high_resolution_clock::now();
-
-        // Create our own output handling thread
-        // This must be done after the pipes are populated.
-        // Each connection needs to make sure to drain the output from its backing host.
-        _hOutputThread.reset(CreateThread(
-            nullptr,
-            0,
-            [](LPVOID lpParameter) noexcept {
-                const auto pInstance = static_cast<ConptyConnection*>(lpParameter);
-                if (pInstance)
-                {
-                    return pInstance->_OutputThread();
-                }
-                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
-            },
-            this,
-            0,
-            nullptr));
-
-        THROW_LAST_ERROR_IF_NULL(_hOutputThread);
-
-        LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
+        // Inbound handoffs are already being drained (see _startDraining).
+        // Whatever was read so far goes to whoever's listening now.
+        if (_hOutputThread)
+        {
+            _flushDrainedOutput();
+        }
+        else
+        {
+            _startTime = std::chrono::high_resolution_clock::now();
+            _startOutputThread();
+        }
 
         _clientExitWait.reset(CreateThreadpoolWait(
             [](PTP_CALLBACK_INSTANCE /*callbackInstance*/, PVOID context, PTP_WAIT /*wait*/, TP_WAIT_RESULT /*waitResult*/) noexcept {
@@ -384,7 +419,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         SetThreadpoolWait(_clientExitWait.get(), _piClient.hProcess, nullptr);
 
-        _transitionToState(ConnectionState::Connected);
+        _applyPendingRequests();
     }
     catch (...)
     {
@@ -412,6 +447,110 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _hPC.reset();
     }
 
+    // Method Description:
+    // - Creates our own output handling thread.
+    //   This must be done after the pipes are populated.
+    //   Each connection needs to make sure to drain the output from its backing host.
+    void ConptyConnection::_startOutputThread()
+    {
+        _hOutputThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                const auto pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_OutputThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hOutputThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
+    }
+
+    // Method Description:
+    // - Starts reading the output of an inbound handoff right away, before
+    //   anyone called Start() on us. Building the tab (or even the window) for
+    //   the connection takes a while, and until then the client would block
+    //   as soon as it filled the output pipe. The output is collected in
+    //   _drainedOutput instead, until Start() passes it on.
+    void ConptyConnection::_startDraining()
+    {
+        _draining.store(true, std::memory_order_relaxed);
+        _startTime = std::chrono::high_resolution_clock::now();
+        _startOutputThread();
+    }
+
+    // Method Description:
+    // - Collects the output that was just read while we're draining.
+    // Return Value:
+    // - false if we stopped draining in the meantime and the output should be passed on.
+    bool ConptyConnection::_appendDrainedOutput()
+    {
+        const std::lock_guard lock{ _drainMutex };
+        if (!_draining.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        _drainedOutput.append(_u16Str);
+        return true;
+    }
+
+    // Method Description:
+    // - Passes the output collected while draining to our handlers and stops draining.
+    //   The output thread waits for the lock meanwhile, so that its next output can't overtake it.
+    void ConptyConnection::_flushDrainedOutput()
+    {
+        const std::lock_guard lock{ _drainMutex };
+        if (!_drainedOutput.empty())
+        {
+            _TerminalOutputHandlers(_drainedOutput);
+        }
+        _drainedOutput = {};
+        _draining.store(false, std::memory_order_relaxed);
+    }
+
+    // Method Description:
+    // - Applies everything that was requested while we were connecting and then
+    //   transitions into the Connected state. Resizes and such were stashed in
+    //   the _initial* members and might differ from what we launched with.
+    void ConptyConnection::_applyPendingRequests()
+    {
+        {
+            const std::lock_guard lock{ _connectMutex };
+
+            if (_isStateAtOrBeyond(ConnectionState::Closing))
+            {
+                // We were closed in the meantime.
+                return;
+            }
+
+            const auto hPC = _hPC.get();
+            LOG_IF_FAILED(ConptyResizePseudoConsole(hPC, { Utils::ClampToShortMax(_initialCols, 1), Utils::ClampToShortMax(_initialRows, 1) }));
+            LOG_IF_FAILED(ConptyShowHidePseudoConsole(hPC, _initialVisibility));
+            if (_initialParentHwnd != 0)
+            {
+                LOG_IF_FAILED(ConptyReparentPseudoConsole(hPC, reinterpret_cast<HWND>(_initialParentHwnd)));
+            }
+
+            if (!_pendingInput.empty())
+            {
+                LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), _pendingInput.data(), gsl::narrow<DWORD>(_pendingInput.size()), nullptr, nullptr));
+                _pendingInput = {};
+            }
+
+            _launched = true;
+        }
+
+        // The state change handlers may call back into us, so do this outside of the lock.
+        _transitionToState(ConnectionState::Connected);
+    }
+
     // Method Description:
     // - prints out the "process exited" message formatted with the exit code
     // Arguments:
@@ -463,28 +602,42 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
     void ConptyConnection::WriteInput(const hstring& data)
     {
-        if (!_isConnected())
+        // convert from UTF-16LE to UTF-8 as ConPty expects UTF-8
+        // TODO GH#3378 reconcile and unify UTF-8 converters
+        auto str = winrt::to_string(data);
+
+        const std::lock_guard lock{ _connectMutex };
+
+        if (!_launched)
+        {
+            // Input that's typed while the client is still being launched is sent once it's running.
+            if (_isStateOneOf(ConnectionState::Connecting))
+            {
+                _pendingInput.append(str);
+            }
+            return;
+        }
+        if (_isStateAtOrBeyond(ConnectionState::Closing))
         {
             return;
         }
 
-        // convert from UTF-16LE to UTF-8 as ConPty expects UTF-8
-        // TODO GH#3378 reconcile and unify UTF-8 converters
-        auto str = winrt::to_string(data);
         LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), str.c_str(), (DWORD)str.length(), nullptr, nullptr));
     }
 
     void ConptyConnection::Resize(uint32_t rows, uint32_t columns)
     {
-        // If we haven't started connecting at all, it's still fair to update
-        // the initial rows and columns before we set things up.
-        if (!_isStateAtOrBeyond(ConnectionState::Connecting))
+        const std::lock_guard lock{ _connectMutex };
+
+        // If we haven't launched the client yet, it's still fair to update the initial
+        // rows and columns. If we're connecting, _applyPendingRequests() applies them.
+        if (!_launched)
         {
             _initialRows = rows;
             _initialCols = columns;
         }
-        // Otherwise, we can really only dispatch a resize if we're already connected.
-        else if (_isConnected())
+        // Otherwise, we can really only dispatch a resize if we're still connected.
+        else if (!_isStateAtOrBeyond(ConnectionState::Closing))
         {
             THROW_IF_FAILED(ConptyResizePseudoConsole(_hPC.get(), { Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) }));
         }
@@ -502,28 +655,41 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
     void ConptyConnection::ShowHide(const bool show)
     {
+        const std::lock_guard lock{ _connectMutex };
+
         // If we haven't connected yet, then stash for when we do connect.
-        if (_isConnected())
+        if (!_launched)
         {
-            THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), show));
+            _initialVisibility = show;
         }
-        else
+        else if (!_isStateAtOrBeyond(ConnectionState::Closing))
         {
-            _initialVisibility = show;
+            THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), show));
         }
     }
 
+    // Method Description:
+    // - Lowers the priority of the output thread while nobody can see the
+    //   terminal, see Utils::SetThreadBackgroundMode. The output thread picks
+    //   the change up, before it reads from the pipe again.
+    void ConptyConnection::SetBackgroundMode(const bool background) noexcept
+    {
+        _backgroundMode.store(background, std::memory_order_relaxed);
+    }
+
     void ConptyConnection::ReparentWindow(const uint64_t newParent)
     {
-        // If we haven't started connecting at all, stash this HWND to use once we have started.
-        if (!_isStateAtOrBeyond(ConnectionState::Connecting))
+        const std::lock_guard lock{ _connectMutex };
+
+        // If we haven't connected yet, stash this HWND to use once we have.
+        if (!_launched)
         {
             _initialParentHwnd = newParent;
         }
         // Otherwise, just inform the conpty of the new owner window handle.
         // This shouldn't be hittable until GH#5000 / GH#1256, when it's
         // possible to reparent terminals to different windows.
-        else if (_isConnected())
+        else if (!_isStateAtOrBeyond(ConnectionState::Closing))
         {
             THROW_IF_FAILED(ConptyReparentPseudoConsole(_hPC.get(), reinterpret_cast<HWND>(newParent)));
         }
@@ -535,6 +701,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         if (_transitionToState(ConnectionState::Closing))
         {
             // EXIT POINT
+            if (_hConnectThread)
+            {
+                // Let the client finish launching, so that we can tear it down below.
+                LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hConnectThread.get(), INFINITE));
+                _hConnectThread.reset();
+            }
+
             _clientExitWait.reset(); // immediately stop waiting for the client to exit.
 
             _hPC.reset(); // tear down the pseudoconsole (this is like clicking X on a console window)
@@ -594,18 +767,61 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return commandline.to_hstring();
     }
 
+    // Method Description:
+    // - Appends any output that's already waiting in the pipe to the chunk that
+    //   was just read into _buffer, until the pipe is drained or _buffer is full.
+    //   This way bursts of output, like a build log, are passed to the terminal
+    //   in a single TerminalOutput event, which means a single Terminal::Write,
+    //   a single LockForWriting() and a single render notification for the batch.
+    //   This never blocks: it only reads what PeekNamedPipe() says is available.
+    // Arguments:
+    // - read: The number of bytes that are already in _buffer.
+    // Return Value:
+    // - The total number of bytes in _buffer.
+    DWORD ConptyConnection::_coalescePendingOutput(DWORD read) noexcept
+    {
+        while (read < _bufferSize)
+        {
+            DWORD available{};
+            if (!PeekNamedPipe(_outPipe.get(), nullptr, 0, nullptr, &available, nullptr) || available == 0)
+            {
+                break;
+            }
+
+            const auto remaining = gsl::narrow_cast<DWORD>(_bufferSize - read);
+            DWORD more{};
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+            if (!ReadFile(_outPipe.get(), _buffer.get() + read, std::min(available, remaining), &more, nullptr))
+            {
+                // The next ReadFile() in _OutputThread will run into the same error and handle it.
+                break;
+            }
+
+            read += more;
+        }
+        return read;
+    }
+
     DWORD ConptyConnection::_OutputThread()
     {
         // Keep us alive until the output thread terminates; the destructor
         // won't wait for us, and the known exit points _do_.
         auto strongThis{ get_strong() };
 
+        auto backgroundMode = false;
+
         // process the data of the output pipe in a loop
         while (true)
         {
+            if (const auto background = _backgroundMode.load(std::memory_order_relaxed); background != backgroundMode)
+            {
+                backgroundMode = background;
+                Utils::SetThreadBackgroundMode(GetCurrentThread(), background);
+            }
+
             DWORD read{};
 
-            const auto readFail{ !ReadFile(_outPipe.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), &read, nullptr) };
+            const auto readFail{ !ReadFile(_outPipe.get(), _buffer.get(), gsl::narrow_cast<DWORD>(_bufferSize), &read, nullptr) };
             if (readFail) // reading failed (we must check this first, because read will also be 0.)
             {
                 const auto lastError = GetLastError();
@@ -618,8 +834,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 }
                 // else we call convertUTF8ChunkToUTF16 with an empty string_view to convert possible remaining partials to U+FFFD
             }
+            else
+            {
+                read = _coalescePendingOutput(read);
+            }
 
-            const auto result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
+            const auto result{ til::u8u16(std::string_view{ _buffer.get(), read }, _u16Str, _u8State) };
             if (FAILED(result))
             {
                 if (_isStateAtOrBeyond(ConnectionState::Closing))
@@ -655,8 +875,25 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _receivedFirstByte = true;
             }
 
-            // Pass the output to our registered event handlers
-            _TerminalOutputHandlers(_u16Str);
+            // Pass the output to our registered event handlers.
+            // The String parameter is a winrt::param::hstring, which wraps _u16Str in a
+            // fast-pass HSTRING reference instead of copying it. Since _u16Str is reused for
+            // the next read, handlers that hold on to the output (like ControlCore's output
+            // queue) need to copy it.
+            if (!_draining.load(std::memory_order_relaxed) || !_appendDrainedOutput())
+            {
+                _TerminalOutputHandlers(_u16Str);
+            }
+
+            // If the batch filled the buffer, the pipe most likely holds even more output (`cat` of a
+            // large file, etc.). Grow the buffer, so that bulk output gets converted and parsed in fewer,
+            // larger chunks, amortizing the per-chunk cost of the event, the terminal lock and invalidation.
+            // ReadFile() on a pipe returns as soon as any data is available, so this doesn't add latency.
+            if (read == _bufferSize && _bufferSize < _maxReadSize)
+            {
+                _bufferSize = std::min(_bufferSize * 2, _maxReadSize);
+                _buffer = std::make_unique_for_overwrite<char[]>(_bufferSize);
+            }
         }
 
         return 0;
@@ -670,7 +907,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     HRESULT ConptyConnection::NewHandoff(HANDLE in, HANDLE out, HANDLE signal, HANDLE ref, HANDLE server, HANDLE client) noexcept
     try
     {
-        _newConnectionHandlers(winrt::make<ConptyConnection>(signal, in, out, ref, server, client));
+        const auto connection = winrt::make_self<ConptyConnection>(signal, in, out, ref, server, client);
+        connection->_startDraining();
+        _newConnectionHandlers(*connection);
 
         return S_OK;
     }
@@ -686,6 +925,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         THROW_IF_FAILED(CTerminalHandoff::s_StopListening());
     }
 
+    // Method Description:
+    // - Sets the number of console hosts that are started ahead of time for this
+    //   process, so that Start() doesn't have to wait for one to be started.
+    // Arguments:
+    // - count: the number of console hosts to keep ready. 0 disables the pool.
+    void ConptyConnection::SetConsoleHostPoolSize(const uint32_t count)
+    {
+        THROW_IF_FAILED(ConptySetPseudoConsolePoolSize(count));
+    }
+
     // Function Description:
     // - This function will be called (by C++/WinRT) after the final outstanding reference to
     //   any given connection instance is released.
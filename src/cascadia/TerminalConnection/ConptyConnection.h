@@ -37,6 +37,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         void ClearBuffer();
 
         void ShowHide(const bool show);
+        void SetBackgroundMode(const bool background) noexcept;
 
         void ReparentWindow(const uint64_t newParent);
 
@@ -45,6 +46,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         static void StartInboundListener();
         static void StopInboundListener();
+        static void SetConsoleHostPoolSize(uint32_t count);
 
         static winrt::event_token NewConnection(const NewConnectionHandler& handler);
         static void NewConnection(const winrt::event_token& token);
@@ -64,6 +66,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         static winrt::hstring _commandlineFromProcess(HANDLE process);
 
         HRESULT _LaunchAttachedClient() noexcept;
+        void _Connect();
+        void _startOutputThread();
+        void _startDraining();
+        bool _appendDrainedOutput();
+        void _flushDrainedOutput();
+        void _applyPendingRequests();
         void _indicateExitWithStatus(unsigned int status) noexcept;
         void _ClientTerminated() noexcept;
 
@@ -84,15 +92,34 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _inPipe; // The pipe for writing input to
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
+        std::atomic<bool> _backgroundMode{ false };
+        wil::unique_handle _hConnectThread;
+        // Protects the _initial* members and _pendingInput while the connect
+        // thread launches the client, see _applyPendingRequests().
+        std::mutex _connectMutex;
+        std::string _pendingInput;
+        bool _launched{ false };
+
+        // Set while the output of an inbound handoff is collected in
+        // _drainedOutput, until Start() is called. See _startDraining().
+        std::atomic<bool> _draining{ false };
+        std::mutex _drainMutex;
+        std::wstring _drainedOutput;
         wil::unique_process_information _piClient;
         wil::unique_static_pseudoconsole_handle _hPC;
         wil::unique_threadpool_wait _clientExitWait;
 
         til::u8state _u8State{};
         std::wstring _u16Str{};
-        std::array<char, 4096> _buffer{};
+        // The read buffer starts small to keep interactive output snappy and
+        // grows whenever a ReadFile() fills it entirely (see _OutputThread).
+        static constexpr size_t _minReadSize{ 4 * 1024 };
+        static constexpr size_t _maxReadSize{ 64 * 1024 };
+        std::unique_ptr<char[]> _buffer{ std::make_unique_for_overwrite<char[]>(_minReadSize) };
+        size_t _bufferSize{ _minReadSize };
         bool _passthroughMode{};
 
+        DWORD _coalescePendingOutput(DWORD read) noexcept;
         DWORD _OutputThread();
     };
 }
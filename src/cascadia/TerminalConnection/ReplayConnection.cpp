@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ReplayConnection.h"
+
+#include "LibraryResources.h"
+#include <ReplayRecording.h>
+
+#include "ReplayConnection.g.cpp"
+
+using namespace ::Microsoft::Terminal;
+
+// {5c1f3ae4-29c3-4c2e-9a5b-7d0c4bb9a1e6}
+static constexpr winrt::guid ReplayConnectionType = { 0x5c1f3ae4, 0x29c3, 0x4c2e, { 0x9a, 0x5b, 0x7d, 0x0c, 0x4b, 0xb9, 0xa1, 0xe6 } };
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    winrt::guid ReplayConnection::ConnectionType() noexcept
+    {
+        return ReplayConnectionType;
+    }
+
+    // Function Description:
+    // - Helper function for constructing a ValueSet that we can use to get our settings from.
+    Windows::Foundation::Collections::ValueSet ReplayConnection::CreateSettings(const winrt::hstring& path, const double speed)
+    {
+        Windows::Foundation::Collections::ValueSet vs{};
+        vs.Insert(L"path", Windows::Foundation::PropertyValue::CreateString(path));
+        vs.Insert(L"speed", Windows::Foundation::PropertyValue::CreateDouble(speed));
+        return vs;
+    }
+
+    void ReplayConnection::Initialize(const Windows::Foundation::Collections::ValueSet& settings)
+    {
+        if (settings)
+        {
+            _path = winrt::unbox_value_or<winrt::hstring>(settings.TryLookup(L"path").try_as<Windows::Foundation::IPropertyValue>(), _path);
+            _speed = winrt::unbox_value_or<double>(settings.TryLookup(L"speed").try_as<Windows::Foundation::IPropertyValue>(), _speed);
+        }
+    }
+
+    void ReplayConnection::Start()
+    try
+    {
+        _transitionToState(ConnectionState::Connecting);
+
+        _file.reset(CreateFileW(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+        THROW_LAST_ERROR_IF(!_file);
+
+        _hOutputThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                const auto pInstance = static_cast<ReplayConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_OutputThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hOutputThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ReplayConnection Output Thread"));
+
+        _transitionToState(ConnectionState::Connected);
+    }
+    catch (...)
+    {
+        // EXIT POINT
+        const auto hr = wil::ResultFromCaughtException();
+
+        winrt::hstring failureText{ fmt::format(std::wstring_view{ RS_(L"ProcessFailedToLaunch") },
+                                                fmt::format(L"0x{:08x}", static_cast<unsigned int>(hr)),
+                                                _path) };
+        _TerminalOutputHandlers(failureText);
+
+        _transitionToState(ConnectionState::Failed);
+
+        _file.reset();
+    }
+
+    void ReplayConnection::WriteInput(const hstring& /*data*/) noexcept
+    {
+    }
+
+    void ReplayConnection::Resize(uint32_t /*rows*/, uint32_t /*columns*/) noexcept
+    {
+    }
+
+    void ReplayConnection::Close() noexcept
+    try
+    {
+        if (_transitionToState(ConnectionState::Closing))
+        {
+            // EXIT POINT
+            _closing.SetEvent();
+
+            if (_hOutputThread)
+            {
+                LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hOutputThread.get(), INFINITE));
+                _hOutputThread.reset();
+            }
+
+            _file.reset();
+
+            _transitionToState(ConnectionState::Closed);
+        }
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Reads the recording chunk by chunk and sends each chunk to the
+    //   terminal once it's due. When the recording ends, we stay connected
+    //   so that the output remains visible.
+    DWORD ReplayConnection::_OutputThread()
+    try
+    {
+        using namespace std::chrono;
+
+        const auto start = steady_clock::now();
+        ReplayRecording::ChunkHeader header{};
+        std::wstring text;
+
+        while (ReplayRecording::ReadChunk(_file.get(), header, text))
+        {
+            if (_speed > 0)
+            {
+                const auto due = start + duration_cast<steady_clock::duration>(microseconds{ header.timestamp } / _speed);
+                const auto now = steady_clock::now();
+                if (due > now)
+                {
+                    const auto timeout = gsl::narrow_cast<DWORD>(ceil<milliseconds>(due - now).count());
+                    if (_closing.wait(timeout))
+                    {
+                        return 0;
+                    }
+                }
+            }
+
+            if (_closing.is_signaled())
+            {
+                return 0;
+            }
+
+            _TerminalOutputHandlers(text);
+        }
+
+        return 0;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        _transitionToState(ConnectionState::Failed);
+        return gsl::narrow_cast<DWORD>(wil::ResultFromCaughtException());
+    }
+}
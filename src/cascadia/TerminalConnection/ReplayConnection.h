@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "ReplayConnection.g.h"
+
+#include "ConnectionStateHolder.h"
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    // Plays back a recording made with the debug tap, with the original
+    // timing, or sped up by the given factor. A speed of 0 plays the output
+    // back as fast as the terminal consumes it. Input and resizes are ignored.
+    struct ReplayConnection : ReplayConnectionT<ReplayConnection>, ConnectionStateHolder<ReplayConnection>
+    {
+        static winrt::guid ConnectionType() noexcept;
+        static Windows::Foundation::Collections::ValueSet CreateSettings(const winrt::hstring& path, double speed);
+
+        ReplayConnection() = default;
+        void Initialize(const Windows::Foundation::Collections::ValueSet& settings);
+
+        void Start();
+        void WriteInput(const hstring& data) noexcept;
+        void Resize(uint32_t rows, uint32_t columns) noexcept;
+        void Close() noexcept;
+
+        WINRT_CALLBACK(TerminalOutput, TerminalOutputHandler);
+
+    private:
+        DWORD _OutputThread();
+
+        hstring _path;
+        double _speed{ 1.0 };
+
+        wil::unique_hfile _file;
+        wil::unique_handle _hOutputThread;
+        wil::unique_event _closing{ wil::EventOptions::ManualReset };
+    };
+}
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::factory_implementation
+{
+    BASIC_FACTORY(ReplayConnection);
+}
@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "BlinkTimer.h"
+
+using namespace winrt::Windows::UI::Xaml;
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    // The DispatcherTimer shared by all BlinkTimers of a thread. It only runs
+    // while at least one of them is started.
+    class BlinkTimer::Scheduler
+    {
+    public:
+        static std::shared_ptr<Scheduler> GetForCurrentThread(const std::chrono::milliseconds interval)
+        {
+            static thread_local std::weak_ptr<Scheduler> s_scheduler;
+
+            auto scheduler = s_scheduler.lock();
+            if (!scheduler)
+            {
+                scheduler = std::make_shared<Scheduler>();
+                s_scheduler = scheduler;
+            }
+
+            // The blink time is a system setting, so if it changed,
+            // all of the thread's blinking should follow it.
+            scheduler->_timer.Interval(interval);
+            return scheduler;
+        }
+
+        Scheduler()
+        {
+            _tickRevoker = _timer.Tick(winrt::auto_revoke, [this](auto&&, auto&&) { _Tick(); });
+        }
+
+        void Add(BlinkTimer* const timer)
+        {
+            _timers.emplace_back(timer);
+            if (_timers.size() == 1)
+            {
+                _timer.Start();
+            }
+        }
+
+        void Remove(BlinkTimer* const timer) noexcept
+        {
+            const auto it = std::find(_timers.begin(), _timers.end(), timer);
+            if (it == _timers.end())
+            {
+                return;
+            }
+
+            if (_ticking)
+            {
+                // _Tick() is iterating over _timers and compacts them once it's done.
+                *it = nullptr;
+            }
+            else
+            {
+                _timers.erase(it);
+                _StopIfIdle();
+            }
+        }
+
+    private:
+        void _StopIfIdle() noexcept
+        try
+        {
+            if (_timers.empty())
+            {
+                _timer.Stop();
+            }
+        }
+        CATCH_LOG()
+
+        void _Tick()
+        {
+            _ticking = true;
+            auto resetTicking = wil::scope_exit([&]() noexcept {
+                _ticking = false;
+                std::erase(_timers, nullptr);
+                _StopIfIdle();
+            });
+
+            // Timers started by a tick callback get their first tick next time.
+            const auto count = _timers.size();
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto timer = til::at(_timers, i);
+                if (!timer)
+                {
+                    continue;
+                }
+                if (std::exchange(timer->_skipTick, false))
+                {
+                    continue;
+                }
+                try
+                {
+                    timer->_tick();
+                }
+                CATCH_LOG();
+            }
+        }
+
+        DispatcherTimer _timer;
+        DispatcherTimer::Tick_revoker _tickRevoker;
+        std::vector<BlinkTimer*> _timers;
+        bool _ticking = false;
+    };
+
+    BlinkTimer::BlinkTimer(const std::chrono::milliseconds interval, std::function<void()> tick) :
+        _scheduler{ Scheduler::GetForCurrentThread(interval) },
+        _tick{ std::move(tick) }
+    {
+    }
+
+    BlinkTimer::~BlinkTimer()
+    {
+        Stop();
+    }
+
+    // Method Description:
+    // - Starts the timer, or restarts it if it's already running. Either
+    //   way the next tick happens at least one blink interval from now.
+    void BlinkTimer::Start()
+    {
+        if (!_running)
+        {
+            _scheduler->Add(this);
+            _running = true;
+        }
+        _skipTick = true;
+    }
+
+    // Method Description:
+    // - Stops the timer. It doesn't tick until it's started again.
+    void BlinkTimer::Stop() noexcept
+    {
+        if (_running)
+        {
+            _scheduler->Remove(this);
+            _running = false;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- BlinkTimer.h
+
+Abstract:
+- A stand-in for the DispatcherTimers that blink the cursor and the blinking
+  text attributes. All BlinkTimers on a thread are driven by a single shared
+  DispatcherTimer, so that a window with many panes wakes up once per blink
+  interval instead of once per pane and blink kind.
+--*/
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    class BlinkTimer
+    {
+    public:
+        BlinkTimer(const std::chrono::milliseconds interval, std::function<void()> tick);
+        ~BlinkTimer();
+
+        BlinkTimer(const BlinkTimer&) = delete;
+        BlinkTimer& operator=(const BlinkTimer&) = delete;
+        BlinkTimer(BlinkTimer&&) = delete;
+        BlinkTimer& operator=(BlinkTimer&&) = delete;
+
+        void Start();
+        void Stop() noexcept;
+
+    private:
+        class Scheduler;
+
+        std::shared_ptr<Scheduler> _scheduler;
+        std::function<void()> _tick;
+        bool _running = false;
+        // Like DispatcherTimer::Start(), Start() delays the next tick by a full interval.
+        // The shared timer can't be restarted for us alone, so we skip its next tick instead.
+        bool _skipTick = false;
+    };
+}
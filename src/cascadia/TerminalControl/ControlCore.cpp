@@ -11,7 +11,9 @@
 #include <LibraryResources.h>
 
 #include "EventArgs.h"
+#include "ScrollbackGovernor.h"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/utils.hpp"
 #include "../../buffer/out/search.h"
 #include "../../renderer/atlas/AtlasEngine.h"
 #include "../../renderer/dx/DxRenderer.hpp"
@@ -32,9 +34,60 @@ constexpr const auto ScrollBarUpdateInterval = std::chrono::milliseconds(8);
 // The minimum delay between updating the TSF input control.
 constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(100);
 
-// The minimum delay between updating the locations of regex patterns
+// How long a control needs to be hidden before its rendering is suspended.
+constexpr const auto RenderingSuspensionDelay = std::chrono::seconds(5);
+
+// The locations of regex patterns are updated once the output has been quiet for
+// UpdatePatternLocationsQuietTime, but at least every UpdatePatternLocationsInterval.
+constexpr const auto UpdatePatternLocationsQuietTime = std::chrono::milliseconds(100);
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
+// The minimum delay between raising TitleChanged and TaskbarProgressChanged events.
+// Some applications (like build tools) update these for every single file they process.
+constexpr const auto TitleUpdateInterval = std::chrono::milliseconds(50);
+
+// The minimum delay between resizes of the connection. While the window is being
+// dragged, every intermediate size would otherwise reflow and repaint conpty's buffer.
+constexpr const auto ConnectionResizeInterval = std::chrono::milliseconds(16);
+
+// The minimum delay between resizes of the buffer while the window border is being
+// dragged. In between, the swap chain keeps its size and XAML clips or extends it.
+constexpr const auto InteractiveResizeInterval = std::chrono::milliseconds(100);
+
+// The period over which the output rate is measured for flood control.
+constexpr const auto FloodCheckInterval = std::chrono::milliseconds(250);
+
+// The number of rows a background search searches at a time, in between which
+// the terminal is unlocked so that input and output can make progress.
+constexpr const til::CoordType SearchBatchRows = 1000;
+
+// The number of rows that are read from the buffer at a time when it's exported.
+constexpr const til::CoordType ExportBatchRows = 1000;
+
+// Returns true if the two maps (either of which may be null) have the same entries.
+template<typename Map>
+static bool _mapsEqual(const Map& lhs, const Map& rhs)
+{
+    const auto lhsSize = lhs ? lhs.Size() : 0;
+    const auto rhsSize = rhs ? rhs.Size() : 0;
+    if (lhsSize != rhsSize)
+    {
+        return false;
+    }
+    if (lhsSize == 0)
+    {
+        return true;
+    }
+    for (const auto& [key, value] : lhs)
+    {
+        if (!rhs.HasKey(key) || rhs.Lookup(key) != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     static winrt::Microsoft::Terminal::Core::OptionalColor OptionalFromColor(const til::color& c)
@@ -88,6 +141,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _EnsureStaticInitialization();
 
         _settings = winrt::make_self<implementation::ControlSettings>(settings, unfocusedAppearance);
+        _floodThreshold = std::max(0, _settings->FloodControlThreshold());
+        _floodScrollback = std::max(0, _settings->FloodControlScrollback());
 
         _terminal = std::make_unique<::Microsoft::Terminal::Core::Terminal>();
 
@@ -96,6 +151,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _ConnectionStateChangedHandlers(*this, nullptr);
         });
 
+        // ConptyConnection can produce output faster than we can parse it (`cat` of a large file, a build, etc.).
+        // Its output is parsed on a dedicated thread, so that the connection can keep reading from its pipe
+        // in the meantime. Other connections are written synchronously on whatever thread they're raised on.
+        if (_connection.try_as<TerminalConnection::ConptyConnection>())
+        {
+            _startOutputThread();
+        }
+
         // This event is explicitly revoked in the destructor: does not need weak_ref
         _connectionOutputEventToken = _connection.TerminalOutput({ this, &ControlCore::_connectionOutputHandler });
 
@@ -157,6 +220,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+            _renderer->SetFrameTimingsCallback([this](const auto& timings) { _traceFrameTimings(timings); });
+
             THROW_IF_FAILED(localPointerToThread->Initialize(_renderer.get()));
         }
 
@@ -180,11 +245,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // * _updatePatternLocations: When there's new output, or we scroll the
         //   viewport, we should re-check if there are any visible hyperlinks.
         //   But we don't really need to do this every single time text is
-        //   output, we can limit this update to once every 500ms.
+        //   output. It has to hold the write lock, so it's deferred until the
+        //   output and input went quiet and then runs at a low priority,
+        //   but it's still done at least once every 500ms.
         // * _updateScrollBar: Same idea as the TSF update - we don't _really_
         //   need to hop across the process boundary every time text is output.
         //   We can throttle this to once every 8ms, which will get us out of
         //   the way of the main output & rendering threads.
+        // * _updateTitle, _updateTaskbarProgress: Every listener of these
+        //   ends up doing XAML work. Only the last value within 50ms matters.
+        // * _resizeConnection: Our own buffer is resized immediately, but the
+        //   connection only needs to know about the size the user settled on.
+        // * _interactiveResize: While the window border is being dragged, even
+        //   our own buffer is only reflowed (and the swap chain resized) every
+        //   100ms. The final size is applied as soon as the drag ends.
         _tsfTryRedrawCanvas = std::make_shared<ThrottledFuncTrailing<>>(
             _dispatcher,
             TsfRedrawInterval,
@@ -197,7 +271,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // NOTE: Calling UpdatePatternLocations from a background
         // thread is a workaround for us to hit GH#12607 less often.
-        _updatePatternLocations = std::make_unique<til::throttled_func_trailing<>>(
+        _updatePatternLocations = std::make_unique<til::idle_func>(
+            UpdatePatternLocationsQuietTime,
             UpdatePatternLocationsInterval,
             [weakThis = get_weak()]() {
                 if (auto core{ weakThis.get() })
@@ -206,6 +281,39 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+        // As long as the output is flooding, this keeps checking the output
+        // rate, so that we notice when the flood is over, even if there's no
+        // more output at all.
+        _floodCheck = std::make_unique<til::throttled_func_trailing<>>(
+            FloodCheckInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() })
+                {
+                    core->_updateFlooding(0);
+                }
+            });
+
+        _resizeConnection = std::make_unique<til::throttled_func_trailing<til::size>>(
+            ConnectionResizeInterval,
+            [weakThis = get_weak()](const til::size size) {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_connection.Resize(size.height, size.width);
+                }
+            });
+
+        _interactiveResize = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            InteractiveResizeInterval,
+            [weakThis = get_weak()]() {
+                // If the drag already ended, InteractiveResizeChanged applied the final size.
+                if (auto core{ weakThis.get() }; !core->_IsClosing() && core->_interactiveResizeInProgress)
+                {
+                    auto lock = core->_terminal->LockForWriting();
+                    core->_refreshSizeUnderLock();
+                }
+            });
+
         _updateScrollBar = std::make_shared<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>>(
             _dispatcher,
             ScrollBarUpdateInterval,
@@ -216,19 +324,104 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+        _updateTitle = std::make_shared<ThrottledFuncTrailing<winrt::hstring>>(
+            _dispatcher,
+            TitleUpdateInterval,
+            [weakThis = get_weak()](const auto& title) {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_TitleChangedHandlers(*core, winrt::make<TitleChangedEventArgs>(title));
+                }
+            });
+
+        _updateTaskbarProgress = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            TitleUpdateInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_TaskbarProgressChangedHandlers(*core, nullptr);
+                }
+            });
+
+        _suspendRenderingTimer = _dispatcher.CreateTimer();
+        _suspendRenderingTimer.Interval(RenderingSuspensionDelay);
+        _suspendRenderingTimer.IsRepeating(false);
+        _suspendRenderingTimer.Tick([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto core{ weakThis.get() }; !core->_IsClosing())
+            {
+                core->_suspendRendering();
+            }
+        });
+
+        _mouseMoveTimer = _dispatcher.CreateTimer();
+        _mouseMoveTimer.IsRepeating(false);
+        _mouseMoveTimer.Tick([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto core{ weakThis.get() }; !core->_IsClosing())
+            {
+                core->_sendPendingMouseMove();
+            }
+        });
+
         UpdateSettings(settings, unfocusedAppearance);
     }
 
     ControlCore::~ControlCore()
     {
+        ScrollbackGovernor::Instance().Unregister(this);
+
         Close();
 
+        // This stops any MIDI notes that are still playing or queued.
+        _shutdownMidiAudio();
+
+        // The output thread calls into us, so it must be stopped before we're gone.
+        _stopOutputThread();
+
         if (_renderer)
         {
-            _renderer->TriggerTeardown();
+            // Stopping the render thread, destroying the render engine and freeing the text buffer
+            // can take a while, which adds up when many tabs are closed at once. Only the frame
+            // that's currently in flight is waited for here. Once painting is disabled we can
+            // cut all ties to this ControlCore and to the UiaEngine that ControlInteractivity owns.
+            _renderer->WaitForPaintCompletionAndDisable(INFINITE);
+
+            if (const auto uiaEngine = _uiaEngine.exchange(nullptr))
+            {
+                _renderer->RemoveRenderEngine(uiaEngine);
+            }
+
+            _renderer->SetBackgroundColorChangedCallback(nullptr);
+            _renderer->SetFrameColorChangedCallback(nullptr);
+            _renderer->SetRendererEnteredErrorStateCallback(nullptr);
+            _renderer->SetFrameTimingsCallback(nullptr);
+
+            if (_renderEngine)
+            {
+                _renderEngine->SetWarningCallback(nullptr);
+                _renderEngine->SetCallback(nullptr);
+            }
+
+            _atlasEngine = nullptr;
+            _asyncTeardown(std::move(_renderer), std::move(_renderEngine), std::move(_terminal));
         }
+    }
 
-        _shutdownMidiAudio();
+    // Method Description:
+    // - Tears down the renderer and destroys the render engine and terminal on a background thread.
+    //   They must not refer to the ControlCore they came from anymore.
+    winrt::fire_and_forget ControlCore::_asyncTeardown(std::unique_ptr<::Microsoft::Console::Render::Renderer> renderer,
+                                                       std::unique_ptr<::Microsoft::Console::Render::IRenderEngine> renderEngine,
+                                                       std::unique_ptr<::Microsoft::Terminal::Core::Terminal> terminal)
+    {
+        co_await winrt::resume_background();
+
+        renderer->TriggerTeardown();
+        // The renderer refers to the engine and terminal and must be destroyed first.
+        // Destroying it joins the render thread.
+        renderer.reset();
+        renderEngine.reset();
+        terminal.reset();
     }
 
     bool ControlCore::Initialize(const double actualWidth,
@@ -259,7 +452,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             if (_settings->UseAtlasEngine())
             {
-                _renderEngine = std::make_unique<::Microsoft::Console::Render::AtlasEngine>();
+                auto atlasEngine = std::make_unique<::Microsoft::Console::Render::AtlasEngine>();
+                _atlasEngine = atlasEngine.get();
+                _renderEngine = std::move(atlasEngine);
             }
             else
             {
@@ -304,6 +499,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             _terminal->CreateFromSettings(*_settings, *_renderer);
 
+            if (!_restoreBufferPath.empty())
+            {
+                _restoreBuffer();
+            }
+
             // IMPORTANT! Set this callback up sooner than later. If we do it
             // after Enable, then it'll be possible to paint the frame once
             // _before_ the warning handler is set up, and then warnings from
@@ -318,6 +518,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _renderEngine->SetPixelShaderPath(_settings->PixelShaderPath());
             _renderEngine->SetForceFullRepaintRendering(_settings->ForceFullRepaintRendering());
             _renderEngine->SetSoftwareRendering(_settings->SoftwareRendering());
+            _renderer->SetFramePacing(gsl::narrow_cast<uint32_t>(std::max(0, _settings->MaxFrameRate())), _settings->ReduceFrameRateOnBattery());
 
             _updateAntiAliasingMode();
 
@@ -330,6 +531,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _initializedTerminal = true;
         } // scope for TerminalLock
 
+        ScrollbackGovernor::Instance().Register(this, get_weak());
+
         // Start the connection outside of lock, because it could
         // start writing output immediately.
         _connection.Start();
@@ -368,6 +571,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
+            // The echo of this input should be written without waiting for the write lock.
+            _updatePatternLocations->postpone();
             _connection.WriteInput(wstr);
         }
     }
@@ -380,6 +585,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - <none>
     void ControlCore::SendInput(const winrt::hstring& wstr)
     {
+        _predictInput(wstr);
         _sendInputToConnection(wstr);
     }
 
@@ -387,9 +593,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                     const WORD scanCode,
                                     const ::Microsoft::Terminal::Core::ControlKeyStates modifiers)
     {
+        _predictInput({ &ch, 1 });
         return _terminal->SendCharEvent(ch, scanCode, modifiers);
     }
 
+    // Method Description:
+    // - Shows the predicted echo of the given input, if predictive echo is enabled.
+    //   This has to happen before the input is sent, or the echo could beat it.
+    // Arguments:
+    // - wstr: the text the user is about to send to the connection.
+    void ControlCore::_predictInput(std::wstring_view wstr)
+    {
+        if (_settings->PredictiveEcho() && !_isReadOnly)
+        {
+            auto lock = _terminal->LockForWriting();
+            _terminal->PredictInput(wstr);
+        }
+    }
+
     // Method Description:
     // - Send this particular key event to the terminal.
     //   See Terminal::SendKeyEvent for more information.
@@ -485,11 +706,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // If the terminal translated the key, mark the event as handled.
         // This will prevent the system from trying to get the character out
         // of it and sending us a CharacterReceived event.
-        return vkey ? _terminal->SendKeyEvent(vkey,
-                                              scanCode,
-                                              modifiers,
-                                              keyDown) :
-                      true;
+        if (!vkey)
+        {
+            return true;
+        }
+
+        const auto handled = _terminal->SendKeyEvent(vkey, scanCode, modifiers, keyDown);
+
+        // Keys like the arrows move the cursor in ways the predictive echo doesn't anticipate.
+        if (handled && keyDown && _settings->PredictiveEcho())
+        {
+            auto lock = _terminal->LockForWriting();
+            _terminal->CancelPredictions();
+        }
+
+        return handled;
     }
 
     bool ControlCore::SendMouseEvent(const til::point viewportPos,
@@ -498,9 +729,50 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                      const short wheelDelta,
                                      const TerminalInput::MouseButtonState state)
     {
+        if (uiButton == WM_MOUSEMOVE && _mouseMoveInterval.count() > 0)
+        {
+            // Applications tracking every mouse move (DECSET 1003) would otherwise be
+            // flooded with input while the mouse moves quickly. Moves that arrive too
+            // soon after the previous one are merged into the latest position instead.
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = now - _lastMouseMoveSent;
+            if (elapsed < _mouseMoveInterval)
+            {
+                if (!_pendingMouseMove)
+                {
+                    _mouseMoveTimer.Interval(std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(_mouseMoveInterval - elapsed));
+                    _mouseMoveTimer.Start();
+                }
+                _pendingMouseMove = PendingMouseMove{ viewportPos, states, state };
+                return _terminal->IsTrackingMouseInput();
+            }
+
+            _mouseMoveTimer.Stop();
+            _pendingMouseMove.reset();
+            _lastMouseMoveSent = now;
+        }
+        else
+        {
+            // Clicks and wheel events are sent as they are,
+            // but they mustn't overtake the moves preceding them.
+            _sendPendingMouseMove();
+        }
+
         return _terminal->SendMouseEvent(viewportPos, uiButton, states, wheelDelta, state);
     }
 
+    // Method Description:
+    // - Sends the mouse move that SendMouseEvent held back, if any.
+    void ControlCore::_sendPendingMouseMove()
+    {
+        if (const auto pending = std::exchange(_pendingMouseMove, std::nullopt))
+        {
+            _mouseMoveTimer.Stop();
+            _lastMouseMoveSent = std::chrono::steady_clock::now();
+            _terminal->SendMouseEvent(pending->viewportPos, WM_MOUSEMOVE, pending->states, 0, pending->state);
+        }
+    }
+
     void ControlCore::UserScrollViewport(const int viewTop)
     {
         // Clear the regex pattern tree so the renderer does not try to render them while scrolling
@@ -513,6 +785,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         (*_updatePatternLocations)();
     }
 
+    // Method Description:
+    // - Scrolls the contents of the viewport by a fraction of a row, for smooth
+    //   scrolling with precision touchpads. The renderer shifts the rows it already
+    //   painted, so this doesn't need to read anything from the buffer.
+    // - Only the AtlasEngine supports this. With other engines it's a no-op
+    //   and scrolling happens in whole rows, like before.
+    // Arguments:
+    // - rows: The offset in rows in the range (-1, 1). Positive values scroll down.
+    void ControlCore::SetSubRowScrollOffset(const float rows)
+    {
+        const auto offset = _atlasEngine ? rows : 0.0f;
+        if (offset == _subRowScrollOffset.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        auto lock = _terminal->LockForWriting();
+        _subRowScrollOffset.store(offset, std::memory_order_relaxed);
+        _renderer->SetSubRowScrollOffset(offset);
+    }
+
+    float ControlCore::SubRowScrollOffset() const noexcept
+    {
+        return _subRowScrollOffset.load(std::memory_order_relaxed);
+    }
+
     void ControlCore::AdjustOpacity(const double adjustment)
     {
         if (adjustment == 0)
@@ -625,12 +923,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         decltype(_terminal->GetHyperlinkIntervalFromViewportPosition({})) newInterval{ std::nullopt };
         if (terminalPosition.has_value())
         {
+            const auto pos = *terminalPosition;
             auto lock = _terminal->LockForReading(); // Lock for the duration of our reads.
-            newId = _terminal->GetHyperlinkIdAtViewportPosition(*terminalPosition);
-            newInterval = _terminal->GetHyperlinkIntervalFromViewportPosition(*terminalPosition);
+
+            // The spans of the hovered row are cached for as long as neither the
+            // row nor the patterns change, which makes most mouse moves a lookup.
+            const auto stamp = _terminal->GetHyperlinkRowStamp(pos.y);
+            if (pos.y != _hoveredRow || stamp != _hoveredRowStamp)
+            {
+                _hoveredRowSpans = _terminal->GetHyperlinkSpansInViewportRow(pos.y);
+                _hoveredRowStamp = stamp;
+                _hoveredRow = pos.y;
+            }
+
+            const auto span = std::find_if(_hoveredRowSpans.begin(), _hoveredRowSpans.end(), [&](const auto& s) {
+                return s.left <= pos.x && pos.x <= s.right;
+            });
+            if (span != _hoveredRowSpans.end())
+            {
+                newId = span->id;
+                newInterval = span->interval;
+            }
+            else
+            {
+                // Positions outside of the row (if any) are left to the regular queries.
+                newId = _terminal->GetHyperlinkIdAtViewportPosition(pos);
+                newInterval = _terminal->GetHyperlinkIntervalFromViewportPosition(pos);
+            }
         }
 
-        // If the hyperlink ID changed or the interval changed, trigger a redraw all
+        // If the hyperlink ID changed or the interval changed, trigger a redraw
         // (so this will happen both when we move onto a link and when we move off a link)
         if (newId != _lastHoveredId ||
             (newInterval != _lastHoveredInterval))
@@ -642,11 +964,28 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             {
                 auto lock = _terminal->LockForWriting();
 
+                // Cells sharing the hovered hyperlink ID may be anywhere in the viewport,
+                // but a pattern interval only covers its own cells.
+                if (newId != _lastHoveredId)
+                {
+                    _renderer->TriggerRedrawAll();
+                }
+                else
+                {
+                    if (_lastHoveredInterval)
+                    {
+                        _terminal->InvalidatePatternInterval(*_lastHoveredInterval);
+                    }
+                    if (newInterval)
+                    {
+                        _terminal->InvalidatePatternInterval(*newInterval);
+                    }
+                }
+
                 _lastHoveredId = newId;
                 _lastHoveredInterval = newInterval;
                 _renderEngine->UpdateHyperlinkHoveredId(newId);
                 _renderer->UpdateLastHoveredInterval(newInterval);
-                _renderer->TriggerRedrawAll();
             }
 
             _HoveredHyperlinkChangedHandlers(*this, nullptr);
@@ -680,7 +1019,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - INVARIANT: This method can only be called if the caller DOES NOT HAVE writing lock on the terminal.
     void ControlCore::UpdateSettings(const IControlSettings& settings, const IControlAppearance& newAppearance)
     {
-        _settings = winrt::make_self<implementation::ControlSettings>(settings, newAppearance);
+        const auto previousSettings = std::exchange(_settings, winrt::make_self<implementation::ControlSettings>(settings, newAppearance));
+        _floodThreshold = std::max(0, _settings->FloodControlThreshold());
+        _floodScrollback = std::max(0, _settings->FloodControlScrollback());
+        _mouseMoveInterval = std::chrono::milliseconds{ std::max(0, _settings->MouseMoveInterval()) };
 
         auto lock = _terminal->LockForWriting();
 
@@ -695,7 +1037,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _runtimeUseAcrylic = true;
         }
 
-        const auto sizeChanged = _setFontSizeUnderLock(_settings->FontSize());
+        // Recreating the font is by far the most expensive part of a settings update,
+        // so we only do it if any of the font settings actually changed.
+        const auto fontChanged = !_initializedTerminal ||
+                                 !previousSettings ||
+                                 previousSettings->FontFace() != _settings->FontFace() ||
+                                 previousSettings->FontSize() != _settings->FontSize() ||
+                                 previousSettings->FontWeight().Weight != _settings->FontWeight().Weight ||
+                                 !_mapsEqual(previousSettings->FontFeatures(), _settings->FontFeatures()) ||
+                                 !_mapsEqual(previousSettings->FontAxes(), _settings->FontAxes());
+        const auto sizeChanged = fontChanged && _setFontSizeUnderLock(_settings->FontSize());
 
         // Update the terminal core with its new Core settings
         _terminal->UpdateSettings(*_settings);
@@ -709,6 +1060,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _renderEngine->SetForceFullRepaintRendering(_settings->ForceFullRepaintRendering());
         _renderEngine->SetSoftwareRendering(_settings->SoftwareRendering());
+        _renderer->SetFramePacing(gsl::narrow_cast<uint32_t>(std::max(0, _settings->MaxFrameRate())), _settings->ReduceFrameRateOnBattery());
         // Inform the renderer of our opacity
         _renderEngine->EnableTransparentBackground(_isBackgroundTransparent());
 
@@ -917,7 +1269,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto hr = _terminal->UserResize({ vp.Width(), vp.Height() });
         if (SUCCEEDED(hr) && hr != S_FALSE)
         {
-            _connection.Resize(vp.Height(), vp.Width());
+            (*_resizeConnection)(vp.Dimensions());
         }
     }
 
@@ -934,10 +1286,46 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _panelWidth = width;
         _panelHeight = height;
 
+        // While the window is being resized interactively we get one of these for
+        // every mouse move. Reflowing the buffer and recreating the swap chain's
+        // buffers for each of them makes the drag stutter, so we only do it now and then.
+        if (_interactiveResizeInProgress)
+        {
+            _interactiveResize->Run();
+            return;
+        }
+
         auto lock = _terminal->LockForWriting();
         _refreshSizeUnderLock();
     }
 
+    // Method Description:
+    // - Called when the user starts or stops dragging the border of the window
+    //   (WM_ENTERSIZEMOVE / WM_EXITSIZEMOVE). In between, SizeChanged only
+    //   resizes the buffer every InteractiveResizeInterval and the swap chain
+    //   keeps its previous size, which XAML clips or leaves bare at the edges.
+    // Arguments:
+    // - inProgress: True when the resize started; false when it ended.
+    // Return Value:
+    // - <none>
+    void ControlCore::InteractiveResizeChanged(const bool inProgress)
+    {
+        if (_interactiveResizeInProgress == inProgress)
+        {
+            return;
+        }
+
+        _interactiveResizeInProgress = inProgress;
+
+        // Apply whatever size the drag ended with. If nothing changed
+        // since the last throttled resize, this is a cheap no-op.
+        if (!inProgress && _initializedTerminal)
+        {
+            auto lock = _terminal->LockForWriting();
+            _refreshSizeUnderLock();
+        }
+    }
+
     void ControlCore::ScaleChanged(const double scale)
     {
         if (!_renderEngine)
@@ -1038,9 +1426,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return false;
         }
 
+        const auto copyHtml = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML);
+        const auto copyRtf = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF);
+
         // extract text from buffer
         // RetrieveSelectedTextFromBuffer will lock while it's reading
-        const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(singleLine);
+        // The colors are only needed for HTML and RTF.
+        const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(singleLine, copyHtml || copyRtf);
 
         // convert text: vector<string> --> string
         std::wstring textData;
@@ -1055,7 +1447,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // GH#5347 - Don't provide a title for the generated HTML, as many
         // web applications will paste the title first, followed by the HTML
         // content, which is unexpected.
-        const auto htmlData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML) ?
+        const auto htmlData = copyHtml ?
                                   TextBuffer::GenHTML(bufferData,
                                                       _actualFont.GetUnscaledSize().Y,
                                                       _actualFont.GetFaceName(),
@@ -1063,7 +1455,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                   "";
 
         // convert to RTF format
-        const auto rtfData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF) ?
+        const auto rtfData = copyRtf ?
                                  TextBuffer::GenRTF(bufferData,
                                                     _actualFont.GetUnscaledSize().Y,
                                                     _actualFont.GetFaceName(),
@@ -1271,7 +1663,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Since this can only ever be triggered by output from the connection,
         // then the Terminal already has the write lock when calling this
         // callback.
-        _TitleChangedHandlers(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+        winrt::hstring title{ wstr };
+        if (!_inUnitTests)
+        {
+            // If a title is already pending, it's replaced by this one.
+            _updateTitle->Run(std::move(title));
+        }
+        else
+        {
+            _TitleChangedHandlers(*this, winrt::make<TitleChangedEventArgs>(title));
+        }
     }
 
     // Method Description:
@@ -1298,6 +1699,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // TODO GH#9617: refine locking around pattern tree
         _terminal->ClearPatternTree();
 
+        // The viewport moved by itself, so whatever fraction of a row
+        // the user scrolled it by doesn't apply to it anymore.
+        if (_subRowScrollOffset.exchange(0, std::memory_order_relaxed) != 0)
+        {
+            _renderer->SetSubRowScrollOffset(0);
+        }
+
         // Start the throttled update of our scrollbar.
         auto update{ winrt::make<ScrollPositionChangedArgs>(viewTop,
                                                             viewHeight,
@@ -1324,7 +1732,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::_terminalTaskbarProgressChanged()
     {
-        _TaskbarProgressChangedHandlers(*this, nullptr);
+        // The listeners query TaskbarState() and TaskbarProgress() for the latest values.
+        if (!_inUnitTests)
+        {
+            _updateTaskbarProgress->Run();
+        }
+        else
+        {
+            _TaskbarProgressChangedHandlers(*this, nullptr);
+        }
     }
 
     void ControlCore::_terminalShowWindowChanged(bool showOrHide)
@@ -1344,23 +1760,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - duration - How long the note should be sustained (in microseconds).
     void ControlCore::_terminalPlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration)
     {
-        // We create the audio instance on demand, and lock it for the duration
-        // of the note output so it can't be destroyed while in use.
-        auto& midiAudio = _getMidiAudio();
-        midiAudio.Lock();
-
-        // We then unlock the terminal, so the UI doesn't hang while we're busy.
-        auto& terminalLock = _terminal->GetReadWriteLock();
-        terminalLock.unlock();
-
-        // This call will block for the duration, unless shutdown early.
-        midiAudio.PlayNote(noteNumber, velocity, duration);
-
-        // Once complete, we reacquire the terminal lock and unlock the audio.
-        // If the terminal has shutdown in the meantime, the Unlock call
-        // will throw an exception, forcing the thread to exit ASAP.
-        terminalLock.lock();
-        midiAudio.Unlock();
+        // We create the audio instance on demand. The note is only queued and
+        // played on the audio thread, so the output thread keeps on parsing.
+        _getMidiAudio().PlayNote(noteNumber, velocity, duration);
     }
 
     // Method Description:
@@ -1390,8 +1792,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         if (_midiAudio)
         {
-            // We lock the terminal here to make sure the shutdown promise is
-            // set before the audio is unlocked in the thread that is playing.
+            // We lock the terminal here, because the output thread
+            // might be creating the audio instance at the same time.
             auto lock = _terminal->LockForWriting();
             _midiAudio->Shutdown();
         }
@@ -1410,7 +1812,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     Windows::Foundation::Collections::IVector<winrt::hstring> ControlCore::SelectedText(bool trimTrailingWhitespace) const
     {
         // RetrieveSelectedTextFromBuffer will lock while it's reading
-        const auto internalResult{ _terminal->RetrieveSelectedTextFromBuffer(trimTrailingWhitespace).text };
+        const auto internalResult{ _terminal->RetrieveSelectedTextFromBuffer(trimTrailingWhitespace, false).text };
 
         auto result = winrt::single_threaded_vector<winrt::hstring>();
 
@@ -1429,15 +1831,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Method Description:
     // - Search text in text buffer. This is triggered if the user click
     //   search button or press enter.
+    // - The search runs in the background (see _searchAsync) and replaces the
+    //   one that might still be running.
     // Arguments:
     // - text: the text to search
     // - goForward: boolean that represents if the current search direction is forward
     // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if text is a regular expression. Regular
+    //   expressions RegexMatcher doesn't support don't match anything.
     // Return Value:
     // - <none>
     void ControlCore::Search(const winrt::hstring& text,
                              const bool goForward,
-                             const bool caseSensitive)
+                             const bool caseSensitive,
+                             const bool regex)
     {
         if (text.size() == 0)
         {
@@ -1452,25 +1859,127 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                      Search::Sensitivity::CaseSensitive :
                                      Search::Sensitivity::CaseInsensitive;
 
-        ::Search search(*GetUiaData(), text.c_str(), direction, sensitivity);
+        const auto mode = regex ? Search::Mode::Regex : Search::Mode::PlainText;
+
+        std::shared_ptr<::Search> search;
+        {
+            auto lock = _terminal->LockForWriting();
+            search = std::make_shared<::Search>(*GetUiaData(), text.c_str(), direction, sensitivity, mode);
+            _pendingSearch = search;
+        }
+
+        _searchAsync(std::move(search));
+    }
+
+    // Method Description:
+    // - Stops the search that's running in the background, if any. Its
+    //   results are discarded and no FoundMatch event is raised for it.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::CancelSearch()
+    {
         auto lock = _terminal->LockForWriting();
-        const auto foundMatch{ search.FindNext() };
-        if (foundMatch)
+        _pendingSearch.reset();
+        _terminal->SetSearchHighlights({});
+        _renderer->TriggerRedrawAll();
+    }
+
+    // Method Description:
+    // - Searches the buffer on a background thread, SearchBatchRows rows at a
+    //   time. The terminal is only locked while a batch is searched, so that a
+    //   search of a long scrollback doesn't freeze input and output. The
+    //   number of matches found so far is reported with a SearchProgress
+    //   event after each batch.
+    // - Once the entire buffer has been searched, the match is selected on
+    //   the main thread and the FoundMatch event is raised.
+    // - The search is abandoned as soon as it isn't the _pendingSearch
+    //   anymore, because another one was started or CancelSearch() was called.
+    // Arguments:
+    // - search: the search to run
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget ControlCore::_searchAsync(std::shared_ptr<::Search> search)
+    {
+        auto weakThis{ get_weak() };
+
+        co_await winrt::resume_background();
+
+        for (auto searchedAll = false; !searchedAll;)
         {
-            _terminal->SetBlockSelection(false);
-            search.Select();
+            auto core{ weakThis.get() };
+            if (!core)
+            {
+                co_return;
+            }
 
-            // this is used for search,
-            // DO NOT call _updateSelectionUI() here.
-            // We don't want to show the markers so manually tell it to clear it.
-            _renderer->TriggerSelection();
-            _UpdateSelectionMarkersHandlers(*this, winrt::make<implementation::UpdateSelectionMarkersEventArgs>(true));
+            size_t matchCount;
+            {
+                auto lock = core->_terminal->LockForReading();
+                if (core->_pendingSearch != search)
+                {
+                    co_return;
+                }
+                searchedAll = search->FindMatchesInNextRows(SearchBatchRows);
+                matchCount = search->GetMatchCount();
+            }
+
+            if (!searchedAll)
+            {
+                auto progress = winrt::make_self<implementation::FoundResultsArgs>(false, gsl::narrow_cast<int32_t>(matchCount), -1);
+                core->_SearchProgressHandlers(*core, *progress);
+            }
+        }
+
+        if (auto core{ weakThis.get() })
+        {
+            co_await wil::resume_foreground(core->_dispatcher);
+        }
+
+        auto core{ weakThis.get() };
+        if (!core || core->_IsClosing())
+        {
+            co_return;
+        }
+
+        bool foundMatch;
+        int32_t totalMatches;
+        int32_t currentMatch;
+        {
+            auto lock = core->_terminal->LockForWriting();
+            if (core->_pendingSearch != search)
+            {
+                co_return;
+            }
+            core->_pendingSearch.reset();
+
+            // All matches are tinted, not just the selected one.
+            core->_terminal->SetSearchHighlights(search->GetAllMatches());
+            core->_renderer->TriggerRedrawAll();
+
+            foundMatch = search->FindNext();
+            if (foundMatch)
+            {
+                core->_terminal->SetBlockSelection(false);
+                search->Select();
+
+                // this is used for search,
+                // DO NOT call _updateSelectionUI() here.
+                // We don't want to show the markers so manually tell it to clear it.
+                core->_renderer->TriggerSelection();
+                core->_UpdateSelectionMarkersHandlers(*core, winrt::make<implementation::UpdateSelectionMarkersEventArgs>(true));
+            }
+
+            const auto currentMatchIndex = search->GetCurrentMatchIndex();
+            totalMatches = gsl::narrow_cast<int32_t>(search->GetMatchCount());
+            currentMatch = currentMatchIndex.has_value() ? gsl::narrow_cast<int32_t>(*currentMatchIndex) : -1;
         }
 
         // Raise a FoundMatch event, which the control will use to notify
         // narrator if there was any results in the buffer
-        auto foundResults = winrt::make_self<implementation::FoundResultsArgs>(foundMatch);
-        _FoundMatchHandlers(*this, *foundResults);
+        auto foundResults = winrt::make_self<implementation::FoundResultsArgs>(foundMatch, totalMatches, currentMatch);
+        core->_FoundMatchHandlers(*core, *foundResults);
     }
 
     // Method Description:
@@ -1505,6 +2014,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             _closing = true;
 
+            _suspendRenderingTimer.Stop();
+
             // Stop accepting new output and state changes before we disconnect everything.
             _connection.TerminalOutput(_connectionOutputEventToken);
             _connectionStateChangedRevoker.revoke();
@@ -1678,10 +2189,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _UpdateSelectionMarkersHandlers(*this, winrt::make<implementation::UpdateSelectionMarkersEventArgs>(!showMarkers));
     }
 
-    void ControlCore::AttachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine)
+    void ControlCore::AttachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine)
     {
         // _renderer will always exist since it's introduced in the ctor
         _renderer->AddRenderEngine(pEngine);
+        _uiaEngine = pEngine;
     }
 
     bool ControlCore::IsInReadOnlyMode() const
@@ -1694,19 +2206,138 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _isReadOnly = !_isReadOnly;
     }
 
+    // Method Description:
+    // - Estimates how much memory the text buffers of this control use, see Terminal::GetMemoryFootprint.
+    // Return Value:
+    // - the footprint in bytes
+    size_t ControlCore::GetMemoryFootprint() const
+    {
+        const auto lock = _terminal->LockForReading();
+        return _terminal->GetMemoryFootprint();
+    }
+
+    // Method Description:
+    // - Called by the ScrollbackGovernor when the system runs low on memory.
+    //   Discards all but _memoryPressureScrollback rows of scrollback, unless
+    //   the control is visible. The user is told about it once it's shown.
+    // Return Value:
+    // - the number of bytes that were freed
+    size_t ControlCore::TrimScrollbackUnderMemoryPressure()
+    {
+        if (!_backgroundMode.load(std::memory_order_relaxed))
+        {
+            return 0;
+        }
+
+        const auto lock = _terminal->LockForWriting();
+        const auto before = _terminal->GetMemoryFootprint();
+        _terminal->TrimScrollback(_memoryPressureScrollback);
+        const auto after = _terminal->GetMemoryFootprint();
+        if (after >= before)
+        {
+            return 0;
+        }
+
+        _scrollbackTrimmed.store(true, std::memory_order_relaxed);
+        return before - after;
+    }
+
     void ControlCore::_raiseReadOnlyWarning()
     {
         auto noticeArgs = winrt::make<NoticeEventArgs>(NoticeLevel::Info, RS_(L"TermControlReadOnly"));
         _RaiseNoticeHandlers(*this, std::move(noticeArgs));
     }
     void ControlCore::_connectionOutputHandler(const hstring& hstr)
+    {
+        if (_outputProducer)
+        {
+            // The connection reuses the memory behind hstr, so we need to copy it.
+            // If the output thread is more than 16 chunks behind, this blocks the
+            // connection until it caught up, which in turn blocks the client application.
+            _outputProducer->emplace(OutputChunk{ std::wstring{ hstr }, std::chrono::steady_clock::now() });
+            return;
+        }
+
+        _writeToTerminal(hstr, std::chrono::steady_clock::now());
+    }
+
+    // Method Description:
+    // - Starts the thread that drains _outputProducer into the Terminal.
+    //   Each chunk is written under its own LockForWriting(), so the render and
+    //   UI thread get a chance to acquire the (fair) lock between two chunks.
+    void ControlCore::_startOutputThread()
+    {
+        auto [producer, consumer] = til::spsc::channel<OutputChunk>(16);
+        _outputProducer.emplace(std::move(producer));
+        _outputThread = std::thread([this, consumer = std::move(consumer)]() {
+            auto backgroundMode = false;
+
+            // pop() returns std::nullopt once the producer is gone and the queue is empty.
+            while (const auto chunk = consumer.pop())
+            {
+                if (const auto background = _backgroundMode.load(std::memory_order_relaxed); background != backgroundMode)
+                {
+                    backgroundMode = background;
+                    ::Microsoft::Console::Utils::SetThreadBackgroundMode(GetCurrentThread(), background);
+                }
+
+                _writeToTerminal(chunk->text, chunk->received);
+            }
+        });
+    }
+
+    // Method Description:
+    // - Drains any remaining output and joins the output thread.
+    void ControlCore::_stopOutputThread()
+    {
+        _outputProducer.reset();
+
+        if (_outputThread.joinable())
+        {
+            _outputThread.join();
+        }
+    }
+
+    // Method Description:
+    // - Writes output of the connection into the Terminal and keeps track of
+    //   how much of it there was, for the render timings overlay and ETW.
+    // Arguments:
+    // - text: the output
+    // - received: when the output was received from the connection
+    void ControlCore::_writeToTerminal(const std::wstring_view text, const std::chrono::steady_clock::time_point received)
     {
         try
         {
-            _terminal->Write(hstr);
+            // We're the only ones calling Write(), so we may read these without the lock.
+            const auto before = _terminal->GetWriteStatistics();
+            _terminal->Write(text);
+            const auto& after = _terminal->GetWriteStatistics();
+
+            {
+                const std::lock_guard guard{ _outputLatencyMutex };
+                if (!_outputLatency.pending)
+                {
+                    _outputLatency.pending.emplace(received, std::chrono::steady_clock::now());
+                }
+            }
+
+            if (TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, 0))
+            {
+                TraceLoggingWrite(g_hTerminalControlProvider,
+                                  "TerminalOutput",
+                                  TraceLoggingDescription("How much output was written into the Terminal and how long it held the lock for it, in microseconds"),
+                                  TraceLoggingUInt64(after.chars - before.chars, "Chars"),
+                                  TraceLoggingUInt64(after.sequences - before.sequences, "Sequences"),
+                                  TraceLoggingUInt64(after.lockHeldMicroseconds - before.lockHeldMicroseconds, "LockHeld"),
+                                  TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+            }
 
             // Start the throttled update of where our hyperlinks are.
-            (*_updatePatternLocations)();
+            // While the output is flooding, they're updated once it's over.
+            if (!_updateFlooding(text.size()))
+            {
+                (*_updatePatternLocations)();
+            }
         }
         catch (...)
         {
@@ -1715,6 +2346,78 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Measures the output rate over periods of FloodCheckInterval. While it
+    //   exceeds the FloodControlThreshold setting, the output is "flooding":
+    //   * The renderer paints at a low frame rate, showing only the latest state.
+    //   * Detecting patterns and announcing output via UIA are suspended.
+    //   * All but FloodControlScrollback rows of the scrollback are discarded, if set.
+    // - Called on the output thread after each write and by _floodCheck.
+    // Arguments:
+    // - chars: the number of characters that were just written
+    // Return Value:
+    // - true if the output is flooding
+    bool ControlCore::_updateFlooding(const size_t chars)
+    {
+        const auto threshold = _floodThreshold.load(std::memory_order_relaxed);
+        auto flooding = false;
+        auto trim = false;
+
+        {
+            const std::lock_guard guard{ _floodMutex };
+            if (threshold == 0 && !_flood.flooding)
+            {
+                return false;
+            }
+
+            _flood.chars += chars;
+
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = now - _flood.since;
+            if (elapsed >= FloodCheckInterval)
+            {
+                const auto rate = _flood.chars / std::chrono::duration<double>(elapsed).count();
+                flooding = threshold != 0 && rate > threshold;
+                trim = flooding;
+                _flood.since = now;
+                _flood.chars = 0;
+
+                // This happens under the lock, so that two threads
+                // can't apply their changes in the wrong order.
+                if (flooding != _flood.flooding)
+                {
+                    _flood.flooding = flooding;
+                    _renderer->SetFlooding(flooding);
+                    if (const auto uiaEngine = _uiaEngine.load(std::memory_order_relaxed))
+                    {
+                        uiaEngine->Suspend(flooding);
+                    }
+                    if (!flooding)
+                    {
+                        (*_updatePatternLocations)();
+                    }
+                }
+            }
+            else
+            {
+                flooding = _flood.flooding;
+            }
+        }
+
+        if (flooding)
+        {
+            (*_floodCheck)();
+        }
+
+        if (const auto keep = _floodScrollback.load(std::memory_order_relaxed); trim && keep != 0)
+        {
+            auto lock = _terminal->LockForWriting();
+            _terminal->TrimScrollback(keep);
+        }
+
+        return flooding;
+    }
+
     // Method Description:
     // - Clear the contents of the buffer. The region cleared is given by
     //   clearType:
@@ -1748,30 +2451,322 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     hstring ControlCore::ReadEntireBuffer() const
     {
-        auto terminalLock = _terminal->LockForWriting();
+        std::wstring text;
+        _readBufferInBatches([&](const std::wstring_view batch) {
+            text.append(batch);
+        });
+        return hstring{ text };
+    }
 
-        const auto& textBuffer = _terminal->GetTextBuffer();
+    // Method Description:
+    // - Writes the text of the buffer to the given file as UTF-8, on a
+    //   background thread. Unlike ReadEntireBuffer() this never holds more
+    //   than ExportBatchRows rows of text in memory.
+    // Arguments:
+    // - path: the file to write to. It's overwritten if it exists.
+    // Return Value:
+    // - <none>
+    Windows::Foundation::IAsyncAction ControlCore::ExportBufferAsync(const hstring path)
+    {
+        auto strongThis{ get_strong() };
 
-        std::wstringstream ss;
-        const auto lastRow = textBuffer.GetLastNonSpaceCharacter().Y;
-        for (auto rowIndex = 0; rowIndex <= lastRow; rowIndex++)
+        co_await winrt::resume_background();
+
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        std::string utf8;
+        _readBufferInBatches([&](const std::wstring_view batch) {
+            THROW_IF_FAILED(til::u16u8(batch, utf8));
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), utf8.data(), gsl::narrow<DWORD>(utf8.size()), &written, nullptr));
+        });
+    }
+
+    // Method Description:
+    // - Writes a snapshot of the buffer to the given file, which RestoreBuffer()
+    //   can bring back in another session. Unlike ExportBufferAsync() this is
+    //   synchronous, as it's called while the window is being closed.
+    // Arguments:
+    // - path: the file to write to. It's overwritten if it exists.
+    // Return Value:
+    // - <none>
+    void ControlCore::PersistBuffer(const hstring& path) const
+    {
+        std::vector<std::byte> snapshot;
         {
-            const auto& row = textBuffer.GetRowByOffset(rowIndex);
-            auto rowText = row.GetText();
-            const auto strEnd = rowText.find_last_not_of(UNICODE_SPACE);
-            if (strEnd != std::string::npos)
+            auto lock = _terminal->LockForReading();
+            snapshot = _terminal->SerializeBuffer();
+        }
+
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        DWORD written = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), snapshot.data(), gsl::narrow<DWORD>(snapshot.size()), &written, nullptr));
+    }
+
+    // Method Description:
+    // - Makes the control restore the snapshot in the given file, written by
+    //   PersistBuffer(), once the terminal is initialized. The file is deleted
+    //   afterwards, whether it could be restored or not.
+    // Arguments:
+    // - path: the snapshot file
+    // Return Value:
+    // - <none>
+    void ControlCore::RestoreBuffer(const hstring& path)
+    {
+        _restoreBufferPath = path;
+    }
+
+    // Method Description:
+    // - Restores the snapshot at _restoreBufferPath into the freshly created
+    //   terminal. Any failure leaves the terminal blank, which is what it'd
+    //   be without a snapshot anyway.
+    // - The caller must hold the terminal's write lock.
+    void ControlCore::_restoreBuffer()
+    try
+    {
+        const auto path = std::exchange(_restoreBufferPath, {});
+
+        // The snapshot is only good for a single restore: it's deleted as soon as we're done with it.
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ | DELETE, 0, nullptr, OPEN_EXISTING, FILE_FLAG_DELETE_ON_CLOSE, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        LARGE_INTEGER size{};
+        THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &size));
+        if (size.QuadPart == 0)
+        {
+            return;
+        }
+
+        wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+        THROW_LAST_ERROR_IF(!mapping);
+        wil::unique_mapview_ptr<std::byte> view{ static_cast<std::byte*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0)) };
+        THROW_LAST_ERROR_IF(!view);
+
+        LOG_HR_IF(E_UNEXPECTED, !_terminal->RestoreBuffer({ view.get(), gsl::narrow<size_t>(size.QuadPart) }));
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Reads the text of the buffer up to the last non-space character, with
+    //   trailing spaces trimmed and CRLFs after rows that weren't wrapped.
+    // - The terminal is only locked while a batch of ExportBatchRows rows is
+    //   read, so that reading a long scrollback doesn't block output. If output
+    //   scrolls the buffer in the meantime, we follow the rows we haven't read
+    //   yet. Rows that scroll out of the buffer before we get to them are lost.
+    // Arguments:
+    // - sink: called with the text of each batch, without the lock being held.
+    // Return Value:
+    // - <none>
+    void ControlCore::_readBufferInBatches(const std::function<void(const std::wstring_view)>& sink) const
+    {
+        til::CoordType rowIndex = 0;
+        til::CoordType lastRow;
+        til::CoordType firstRowIndex;
+        til::CoordType height;
+        {
+            auto lock = _terminal->LockForReading();
+            const auto& textBuffer = _terminal->GetTextBuffer();
+            lastRow = textBuffer.GetLastNonSpaceCharacter().Y;
+            firstRowIndex = textBuffer.GetFirstRowIndex();
+            height = textBuffer.GetSize().Height();
+        }
+
+        std::wstring text;
+        while (rowIndex <= lastRow)
+        {
+            text.clear();
             {
-                rowText.erase(strEnd + 1);
-                ss << rowText;
+                auto lock = _terminal->LockForReading();
+                const auto& textBuffer = _terminal->GetTextBuffer();
+
+                const auto newFirstRowIndex = textBuffer.GetFirstRowIndex();
+                const auto newHeight = textBuffer.GetSize().Height();
+                if (newHeight == height)
+                {
+                    const auto circled = (newFirstRowIndex - firstRowIndex + height) % height;
+                    rowIndex = std::max(0, rowIndex - circled);
+                    lastRow -= circled;
+                }
+                else
+                {
+                    // The buffer was resized and reflowed. There's no telling where our rows went.
+                    height = newHeight;
+                    lastRow = std::min(lastRow, height - 1);
+                }
+                firstRowIndex = newFirstRowIndex;
+
+                const auto batchEnd = std::min(lastRow + 1, rowIndex + ExportBatchRows);
+                for (; rowIndex < batchEnd; rowIndex++)
+                {
+                    const auto& row = textBuffer.GetRowByOffset(rowIndex);
+                    auto rowText = row.GetText();
+                    const auto strEnd = rowText.find_last_not_of(UNICODE_SPACE);
+                    if (strEnd != std::string::npos)
+                    {
+                        text.append(rowText, 0, strEnd + 1);
+                    }
+
+                    if (!row.WasWrapForced())
+                    {
+                        text.push_back(UNICODE_CARRIAGERETURN);
+                        text.push_back(UNICODE_LINEFEED);
+                    }
+                }
+            }
+
+            if (!text.empty())
+            {
+                sink(text);
             }
+        }
+    }
+
+    // Method Description:
+    // - Emits the timings of a frame as an ETW event, if anyone is listening.
+    // - Records how long it took for output to be presented, if the frame
+    //   contained output that wasn't presented before.
+    // - Called on the render thread after each frame.
+    // Arguments:
+    // - timings: the timings of the frame, see Renderer::GetFrameTimings
+    void ControlCore::_traceFrameTimings(const ::Microsoft::Console::Render::FrameTimings& timings)
+    {
+        using Timings = ::Microsoft::Console::Render::FrameTimings;
 
-            if (!row.WasWrapForced())
+        // The frame captured the buffer contents once it acquired the lock.
+        // Any output written before that point was presented with this frame.
+        const auto now = std::chrono::steady_clock::now();
+        const auto lockAcquired = now - std::chrono::microseconds{ til::at(timings.last, Timings::Total) - til::at(timings.last, Timings::LockWait) };
+        std::optional<std::chrono::microseconds> latency;
+        {
+            const std::lock_guard guard{ _outputLatencyMutex };
+            if (_outputLatency.pending && _outputLatency.pending->second <= lockAcquired)
             {
-                ss << UNICODE_CARRIAGERETURN << UNICODE_LINEFEED;
+                latency = std::chrono::duration_cast<std::chrono::microseconds>(now - _outputLatency.pending->first);
+                Timings::Record(_outputLatency.histogram, gsl::narrow_cast<uint32_t>(std::min<int64_t>(latency->count(), UINT32_MAX)));
+                _outputLatency.count++;
+                _outputLatency.pending.reset();
             }
         }
 
-        return hstring(ss.str());
+        if (latency && TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, 0))
+        {
+            TraceLoggingWrite(g_hTerminalControlProvider,
+                              "OutputLatency",
+                              TraceLoggingDescription("How long it took for output to be presented after it was received, in microseconds"),
+                              TraceLoggingInt64(latency->count(), "Latency"),
+                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+        }
+
+        if (TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, 0))
+        {
+            TraceLoggingWrite(g_hTerminalControlProvider,
+                              "RenderFrameTimings",
+                              TraceLoggingDescription("How long painting a frame took, in microseconds"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::LockWait), "LockWait"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::BufferOutput), "BufferOutput"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::Selection), "Selection"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::Cursor), "Cursor"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::Present), "Present"),
+                              TraceLoggingUInt32(til::at(timings.last, Timings::Total), "Total"),
+                              TraceLoggingUInt32(timings.scratchAllocations, "ScratchAllocations"),
+                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+        }
+    }
+
+    // Method Description:
+    // - Formats how long painting the frames since the last call took, how
+    //   much output was processed in the meantime and how long it took for it
+    //   to be presented, for the render timings overlay. Resets the statistics afterwards.
+    // Return Value:
+    // - one line per phase of painting a frame, followed by the output statistics
+    hstring ControlCore::GetRenderTimingsSummary()
+    {
+        using Timings = ::Microsoft::Console::Render::FrameTimings;
+        static constexpr std::array<std::pair<Timings::Phase, std::wstring_view>, Timings::PhaseCount> phases{ {
+            { Timings::LockWait, L"lock wait" },
+            { Timings::BufferOutput, L"text" },
+            { Timings::Selection, L"selection" },
+            { Timings::Cursor, L"cursor" },
+            { Timings::Present, L"present" },
+            { Timings::Total, L"total" },
+        } };
+
+        if (!_renderer)
+        {
+            return {};
+        }
+
+        const auto timings = _renderer->GetFrameTimings(true);
+        auto summary = fmt::format(L"{} frames", timings.frameCount);
+        for (const auto& [phase, name] : phases)
+        {
+            fmt::format_to(std::back_inserter(summary),
+                           L"\n{:<10}{:>7} us   p50 < {} us   p99 < {} us",
+                           name,
+                           til::at(timings.last, phase),
+                           timings.Percentile(phase, 50),
+                           timings.Percentile(phase, 99));
+        }
+        fmt::format_to(std::back_inserter(summary),
+                       L"\nscratch   {} KB   {} allocations",
+                       timings.scratchBytes / 1024,
+                       timings.scratchAllocations);
+
+        if (_atlasEngine)
+        {
+            const auto glyphs = _atlasEngine->GetGlyphCacheStatistics();
+            const auto lookups = glyphs.hits + glyphs.misses;
+            fmt::format_to(std::back_inserter(summary),
+                           L"\nglyphs    {} cached   {:.1f}% hits   {} evicted",
+                           glyphs.glyphCount,
+                           lookups ? 100.0 * glyphs.hits / lookups : 100.0,
+                           glyphs.evictions);
+
+            const auto lines = glyphs.lineHits + glyphs.lineMisses;
+            fmt::format_to(std::back_inserter(summary),
+                           L"\nshaping   {:.1f}% of lines cached",
+                           lines ? 100.0 * glyphs.lineHits / lines : 100.0);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto statistics = [&]() {
+            auto lock = _terminal->LockForReading();
+            return _terminal->GetWriteStatistics();
+        }();
+        if (_lastWriteStatisticsTime != std::chrono::steady_clock::time_point{})
+        {
+            const auto elapsed = std::chrono::duration<double>(now - _lastWriteStatisticsTime).count();
+            if (elapsed > 0)
+            {
+                fmt::format_to(std::back_inserter(summary),
+                               L"\noutput    {:.2f} M chars/s   {:.0f} sequences/s   {:.1f}% locked",
+                               (statistics.chars - _lastWriteStatistics.chars) / elapsed / 1e6,
+                               (statistics.sequences - _lastWriteStatistics.sequences) / elapsed,
+                               (statistics.lockHeldMicroseconds - _lastWriteStatistics.lockHeldMicroseconds) / elapsed / 1e4);
+            }
+        }
+        _lastWriteStatistics = statistics;
+        _lastWriteStatisticsTime = now;
+
+        OutputLatency latency;
+        {
+            const std::lock_guard guard{ _outputLatencyMutex };
+            latency.histogram = std::exchange(_outputLatency.histogram, {});
+            latency.count = std::exchange(_outputLatency.count, 0);
+        }
+        if (latency.count)
+        {
+            fmt::format_to(std::back_inserter(summary),
+                           L"\nlatency   {} outputs   p50 < {} us   p99 < {} us",
+                           latency.count,
+                           Timings::Percentile(latency.histogram, latency.count, 50),
+                           Timings::Percentile(latency.histogram, latency.count, 99));
+        }
+
+        return hstring{ summary };
     }
 
     // Helper to check if we're on Windows 11 or not. This is used to check if
@@ -1890,7 +2885,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _renderEngine->SetSelectionBackground(til::color{ _settings->SelectionBackground() });
 
-        _renderer->TriggerRedrawAll(true);
+        _renderer->TriggerColorTableChange(true);
     }
 
     bool ControlCore::HasUnfocusedAppearance() const
@@ -1930,6 +2925,99 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 conpty.ShowHide(showOrHide);
             }
         }
+
+        _windowVisible = showOrHide;
+        _updateRenderingSuspension();
+        _updateBackgroundMode();
+    }
+
+    // Method Description:
+    // - Called when the control was added to or removed from the UI tree,
+    //   for instance because its tab got selected or another one did.
+    // Arguments:
+    // - visible: True for visible; false for not visible.
+    // Return Value:
+    // - <none>
+    void ControlCore::ControlVisibilityChanged(const bool showOrHide)
+    {
+        _controlVisible = showOrHide;
+        _updateRenderingSuspension();
+        _updateBackgroundMode();
+
+        if (_windowVisible && _controlVisible && _scrollbackTrimmed.exchange(false, std::memory_order_relaxed))
+        {
+            auto noticeArgs = winrt::make<NoticeEventArgs>(NoticeLevel::Info, RS_(L"ScrollbackTrimmedUnderMemoryPressure"));
+            _RaiseNoticeHandlers(*this, std::move(noticeArgs));
+        }
+    }
+
+    // Method Description:
+    // - Moves the threads that render, parse and read the output of this control into
+    //   the background while it's hidden, so that they don't compete with the ones of
+    //   the terminal the user is looking at. See Utils::SetThreadBackgroundMode.
+    // - Unlike _updateRenderingSuspension() this happens immediately, because it
+    //   doesn't throw away any resources that would be expensive to recreate.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_updateBackgroundMode()
+    {
+        const auto background = !_windowVisible || !_controlVisible;
+
+        _renderer->SetBackgroundMode(background);
+        _backgroundMode.store(background, std::memory_order_relaxed);
+        if (auto conpty{ _connection.try_as<TerminalConnection::ConptyConnection>() })
+        {
+            conpty.SetBackgroundMode(background);
+        }
+    }
+
+    // Method Description:
+    // - Hidden controls don't need to be rendered. Once a control has been hidden for
+    //   RenderingSuspensionDelay, its render thread is parked and the render engine
+    //   releases its swap chain and other GPU resources. Output still goes into the
+    //   text buffer. Once the control is shown again, the engine recreates its
+    //   resources and the entire viewport is repainted.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_updateRenderingSuspension()
+    {
+        if (_windowVisible && _controlVisible)
+        {
+            _suspendRenderingTimer.Stop();
+
+            if (_renderingSuspended)
+            {
+                _renderingSuspended = false;
+                _renderer->EnablePainting();
+                _renderer->TriggerRedrawAll();
+            }
+        }
+        else if (!_renderingSuspended)
+        {
+            // Start() restarts the timer if it's already running.
+            _suspendRenderingTimer.Start();
+        }
+    }
+
+    void ControlCore::_suspendRendering()
+    {
+        if (!_initializedTerminal || _renderingSuspended)
+        {
+            return;
+        }
+
+        _renderingSuspended = true;
+
+        // The render thread holds the terminal lock while painting,
+        // so we must wait for it to finish before acquiring it.
+        _renderer->WaitForPaintCompletionAndDisable(INFINITE);
+
+        auto lock = _terminal->LockForWriting();
+        _renderEngine->ReleaseResources();
     }
 
     // Method Description:
@@ -1944,6 +3032,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - This is related to work done for GH#2988.
     void ControlCore::GotFocus()
     {
+        ScrollbackGovernor::Instance().NotifyFocused(this);
         _focusChanged(true);
     }
 
@@ -2019,6 +3108,55 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return v;
     }
 
+    static std::pair<int32_t, uint32_t> _pipKey(const Control::ScrollMarkPip& pip) noexcept
+    {
+        return { pip.Row, til::color{ pip.Color }.abgr };
+    }
+
+    // Method Description:
+    // - Diffs the current scrollbar pips against the ones we returned last
+    //   time, so that only the pips that changed need to cross over to the
+    //   control. Pip rows are stored offset by rowOffset, which is why they
+    //   don't change when the buffer circles.
+    // Arguments:
+    // - fromScratch: if true, forget what we returned before and return all pips.
+    // - removedCount: receives the number of removed pips at the start of the result.
+    // - rowOffset: receives the offset to subtract from a pip's Row to get its buffer row.
+    // Return Value:
+    // - the removed pips followed by the added pips.
+    com_array<Control::ScrollMarkPip> ControlCore::GetScrollMarkPipChanges(const bool fromScratch, int32_t& removedCount, int32_t& rowOffset)
+    {
+        std::vector<Control::ScrollMarkPip> pips;
+        {
+            const auto lock = _terminal->LockForReading();
+            const auto marks = _terminal->GetScrollMarks();
+            rowOffset = _terminal->GetScrollMarksOffset();
+
+            pips.reserve(marks.size());
+            for (const auto& mark : marks)
+            {
+                pips.push_back({ mark.start.y + rowOffset, _terminal->GetColorForMark(mark) });
+            }
+        }
+
+        const auto less = [](const auto& a, const auto& b) noexcept { return _pipKey(a) < _pipKey(b); };
+        std::sort(pips.begin(), pips.end(), less);
+        pips.erase(std::unique(pips.begin(), pips.end(), [](const auto& a, const auto& b) noexcept { return _pipKey(a) == _pipKey(b); }), pips.end());
+
+        if (fromScratch)
+        {
+            _scrollMarkPips.clear();
+        }
+
+        std::vector<Control::ScrollMarkPip> changes;
+        std::set_difference(_scrollMarkPips.begin(), _scrollMarkPips.end(), pips.begin(), pips.end(), std::back_inserter(changes), less);
+        removedCount = gsl::narrow_cast<int32_t>(changes.size());
+        std::set_difference(pips.begin(), pips.end(), _scrollMarkPips.begin(), _scrollMarkPips.end(), std::back_inserter(changes), less);
+
+        _scrollMarkPips = std::move(pips);
+        return com_array<Control::ScrollMarkPip>{ changes };
+    }
+
     void ControlCore::AddMark(const Control::ScrollMark& mark)
     {
         ::Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark m{};
@@ -2048,7 +3186,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void ControlCore::ScrollToMark(const Control::ScrollToMarkDirection& direction)
     {
         const auto currentOffset = ScrollOffset();
-        const auto& marks{ _terminal->GetScrollMarks() };
 
         std::optional<DispatchTypes::ScrollMark> tgt;
 
@@ -2056,59 +3193,31 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
         case ScrollToMarkDirection::Last:
         {
-            int highest = currentOffset;
-            for (const auto& mark : marks)
+            tgt = _terminal->GetScrollMarkBefore(INT_MAX);
+            if (tgt && tgt->start.y <= currentOffset)
             {
-                const auto newY = mark.start.y;
-                if (newY > highest)
-                {
-                    tgt = mark;
-                    highest = newY;
-                }
+                tgt.reset();
             }
             break;
         }
         case ScrollToMarkDirection::First:
         {
-            int lowest = currentOffset;
-            for (const auto& mark : marks)
+            tgt = _terminal->GetScrollMarkAfter(INT_MIN);
+            if (tgt && tgt->start.y >= currentOffset)
             {
-                const auto newY = mark.start.y;
-                if (newY < lowest)
-                {
-                    tgt = mark;
-                    lowest = newY;
-                }
+                tgt.reset();
             }
             break;
         }
         case ScrollToMarkDirection::Next:
         {
-            int minDistance = INT_MAX;
-            for (const auto& mark : marks)
-            {
-                const auto delta = mark.start.y - currentOffset;
-                if (delta > 0 && delta < minDistance)
-                {
-                    tgt = mark;
-                    minDistance = delta;
-                }
-            }
+            tgt = _terminal->GetScrollMarkAfter(currentOffset);
             break;
         }
         case ScrollToMarkDirection::Previous:
         default:
         {
-            int minDistance = INT_MAX;
-            for (const auto& mark : marks)
-            {
-                const auto delta = currentOffset - mark.start.y;
-                if (delta > 0 && delta < minDistance)
-                {
-                    tgt = mark;
-                    minDistance = delta;
-                }
-            }
+            tgt = _terminal->GetScrollMarkBefore(currentOffset);
             break;
         }
         }
@@ -19,9 +19,11 @@
 #include "ControlSettings.h"
 #include "../../audio/midi/MidiAudio.hpp"
 #include "../../renderer/base/Renderer.hpp"
+#include "../../renderer/uia/UiaRenderer.hpp"
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../buffer/out/search.h"
 
+#include <til/spsc.h>
 #include <til/ticket_lock.h>
 
 namespace ControlUnitTests
@@ -30,6 +32,11 @@ namespace ControlUnitTests
     class ControlInteractivityTests;
 };
 
+namespace Microsoft::Console::Render
+{
+    class AtlasEngine;
+}
+
 #define RUNTIME_SETTING(type, name, setting)                      \
 private:                                                          \
     std::optional<type> _runtime##name{ std::nullopt };           \
@@ -130,6 +137,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
 #pragma endregion
 
+        com_array<Control::ScrollMarkPip> GetScrollMarkPipChanges(const bool fromScratch, int32_t& removedCount, int32_t& rowOffset);
+
 #pragma region ITerminalInput
         bool TrySendKeyEvent(const WORD vkey,
                              const WORD scanCode,
@@ -144,6 +153,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                             const short wheelDelta,
                             const ::Microsoft::Console::VirtualTerminal::TerminalInput::MouseButtonState state);
         void UserScrollViewport(const int viewTop);
+        void SetSubRowScrollOffset(const float rows);
+        float SubRowScrollOffset() const noexcept;
 
         void ClearBuffer(Control::ClearBufferType clearType);
 
@@ -167,7 +178,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void Search(const winrt::hstring& text,
                     const bool goForward,
-                    const bool caseSensitive);
+                    const bool caseSensitive,
+                    const bool regex);
+        void CancelSearch();
 
         void LeftClickOnTerminal(const til::point terminalPosition,
                                  const int numberOfClicks,
@@ -176,18 +189,27 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                  const bool isOnOriginalPosition,
                                  bool& selectionNeedsToBeCopied);
 
-        void AttachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine);
+        void AttachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine);
+        size_t GetMemoryFootprint() const;
+        size_t TrimScrollbackUnderMemoryPressure();
+        void _traceFrameTimings(const ::Microsoft::Console::Render::FrameTimings& timings);
 
         bool IsInReadOnlyMode() const;
         void ToggleReadOnlyMode();
 
         hstring ReadEntireBuffer() const;
+        Windows::Foundation::IAsyncAction ExportBufferAsync(const hstring path);
+        void PersistBuffer(const hstring& path) const;
+        void RestoreBuffer(const hstring& path);
+        hstring GetRenderTimingsSummary();
 
         static bool IsVintageOpacityAvailable() noexcept;
 
         void AdjustOpacity(const double opacity, const bool relative);
 
         void WindowVisibilityChanged(const bool showOrHide);
+        void ControlVisibilityChanged(const bool showOrHide);
+        void InteractiveResizeChanged(const bool inProgress);
 
         uint64_t OwningHwnd();
         void OwningHwnd(uint64_t owner);
@@ -216,6 +238,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TYPED_EVENT(TransparencyChanged,       IInspectable, Control::TransparencyChangedEventArgs);
         TYPED_EVENT(ReceivedOutput,            IInspectable, IInspectable);
         TYPED_EVENT(FoundMatch,                IInspectable, Control::FoundResultsArgs);
+        TYPED_EVENT(SearchProgress,            IInspectable, Control::FoundResultsArgs);
         TYPED_EVENT(ShowWindowChanged,         IInspectable, Control::ShowWindowArgs);
         TYPED_EVENT(UpdateSelectionMarkers,    IInspectable, Control::UpdateSelectionMarkersEventArgs);
         TYPED_EVENT(OpenHyperlink,             IInspectable, Control::OpenHyperlinkEventArgs);
@@ -223,12 +246,62 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     private:
         bool _initializedTerminal{ false };
+        winrt::hstring _restoreBufferPath;
         bool _closing{ false };
 
         TerminalConnection::ITerminalConnection _connection{ nullptr };
         event_token _connectionOutputEventToken;
         TerminalConnection::ITerminalConnection::StateChanged_revoker _connectionStateChangedRevoker;
 
+        // Output of ConptyConnections is handed to _outputThread through this queue,
+        // so that neither the connection's nor the UI thread wait for a long Write().
+        struct OutputChunk
+        {
+            std::wstring text;
+            std::chrono::steady_clock::time_point received;
+        };
+        std::optional<til::spsc::producer<OutputChunk>> _outputProducer;
+        std::thread _outputThread;
+        // Whether the control is hidden, see _updateBackgroundMode().
+        // Read by the output thread and the ScrollbackGovernor.
+        std::atomic<bool> _backgroundMode{ false };
+        // Set by TrimScrollbackUnderMemoryPressure, so that we can tell the user once they look at us again.
+        std::atomic<bool> _scrollbackTrimmed{ false };
+        // How many rows of scrollback TrimScrollbackUnderMemoryPressure keeps.
+        static constexpr til::CoordType _memoryPressureScrollback = 1000;
+
+        // The time at which the oldest output that wasn't presented yet was
+        // received from the connection and written into the Terminal, as well as
+        // how long it took for output to be presented since the last summary.
+        // Written by the output thread and read by the render thread.
+        struct OutputLatency
+        {
+            std::optional<std::pair<std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point>> pending;
+            ::Microsoft::Console::Render::FrameTimings::Histogram histogram{};
+            uint32_t count = 0;
+        };
+        OutputLatency _outputLatency;
+        std::mutex _outputLatencyMutex;
+
+        // Flood control, see _updateFlooding(). The settings are copied here,
+        // because the output thread can't access _settings.
+        struct FloodState
+        {
+            std::chrono::steady_clock::time_point since;
+            uint64_t chars = 0;
+            bool flooding = false;
+        };
+        FloodState _flood;
+        std::mutex _floodMutex;
+        std::atomic<uint32_t> _floodThreshold{ 0 };
+        std::atomic<til::CoordType> _floodScrollback{ 0 };
+        // Owned by ControlInteractivity, which outlives us.
+        std::atomic<::Microsoft::Console::Render::UiaEngine*> _uiaEngine{ nullptr };
+
+        // The Terminal's write statistics at the time of the last GetRenderTimingsSummary().
+        ::Microsoft::Terminal::Core::Terminal::WriteStatistics _lastWriteStatistics;
+        std::chrono::steady_clock::time_point _lastWriteStatisticsTime;
+
         winrt::com_ptr<ControlSettings> _settings{ nullptr };
 
         std::unique_ptr<::Microsoft::Terminal::Core::Terminal> _terminal{ nullptr };
@@ -239,7 +312,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // we must ensure the _renderer is deallocated first.
         // (C++ class members are destroyed in reverse order.)
         std::unique_ptr<::Microsoft::Console::Render::IRenderEngine> _renderEngine{ nullptr };
+        // Points to _renderEngine if it's an AtlasEngine, for the statistics only it offers.
+        ::Microsoft::Console::Render::AtlasEngine* _atlasEngine{ nullptr };
         std::unique_ptr<::Microsoft::Console::Render::Renderer> _renderer{ nullptr };
+        // See SetSubRowScrollOffset(). Reset from the output thread when the terminal scrolls by itself.
+        std::atomic<float> _subRowScrollOffset{ 0 };
 
         FontInfoDesired _desiredFont;
         FontInfo _actualFont;
@@ -249,6 +326,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         std::optional<wchar_t> _leadingSurrogate{ std::nullopt };
 
         std::optional<til::point> _lastHoveredCell{ std::nullopt };
+        // The pips the control was last told about, sorted by _pipKey.
+        std::vector<Control::ScrollMarkPip> _scrollMarkPips;
         // Track the last hyperlink ID we hovered over
         uint16_t _lastHoveredId{ 0 };
 
@@ -256,27 +335,72 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _lastHoveredInterval{ std::nullopt };
 
+        // The hyperlink spans of the viewport row that was last hovered, so that moving
+        // the mouse along a row doesn't need to query the buffer for every cell.
+        std::vector<::Microsoft::Terminal::Core::Terminal::HyperlinkSpan> _hoveredRowSpans;
+        ::Microsoft::Terminal::Core::Terminal::HyperlinkRowStamp _hoveredRowStamp;
+        til::CoordType _hoveredRow{ -1 };
+
         // These members represent the size of the surface that we should be
         // rendering to.
         double _panelWidth{ 0 };
         double _panelHeight{ 0 };
         double _compositionScale{ 0 };
+        bool _interactiveResizeInProgress{ false };
 
         uint64_t _owningHwnd{ 0 };
 
         winrt::Windows::System::DispatcherQueue _dispatcher{ nullptr };
         std::shared_ptr<ThrottledFuncTrailing<>> _tsfTryRedrawCanvas;
-        std::unique_ptr<til::throttled_func_trailing<>> _updatePatternLocations;
+        std::unique_ptr<til::idle_func> _updatePatternLocations;
+        std::unique_ptr<til::throttled_func_trailing<>> _floodCheck;
+        std::unique_ptr<til::throttled_func_trailing<til::size>> _resizeConnection;
+        std::shared_ptr<ThrottledFuncTrailing<>> _interactiveResize;
         std::shared_ptr<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>> _updateScrollBar;
+        std::shared_ptr<ThrottledFuncTrailing<winrt::hstring>> _updateTitle;
+        std::shared_ptr<ThrottledFuncTrailing<>> _updateTaskbarProgress;
+
+        // See _updateRenderingSuspension().
+        winrt::Windows::System::DispatcherQueueTimer _suspendRenderingTimer{ nullptr };
+        bool _windowVisible{ true };
+        bool _controlVisible{ true };
+
+        // Mouse moves that arrive less than _mouseMoveInterval after the previously sent
+        // one are merged into _pendingMouseMove, which _mouseMoveTimer sends later.
+        struct PendingMouseMove
+        {
+            til::point viewportPos;
+            ::Microsoft::Terminal::Core::ControlKeyStates states;
+            ::Microsoft::Console::VirtualTerminal::TerminalInput::MouseButtonState state;
+        };
+        std::optional<PendingMouseMove> _pendingMouseMove;
+        std::chrono::steady_clock::time_point _lastMouseMoveSent{};
+        std::chrono::milliseconds _mouseMoveInterval{ 0 };
+        winrt::Windows::System::DispatcherQueueTimer _mouseMoveTimer{ nullptr };
+        bool _renderingSuspended{ false };
+
+        // The search that's running in the background, see Search(). Guarded by the terminal lock.
+        std::shared_ptr<::Search> _pendingSearch;
 
         winrt::fire_and_forget _asyncCloseConnection();
+        static winrt::fire_and_forget _asyncTeardown(std::unique_ptr<::Microsoft::Console::Render::Renderer> renderer,
+                                                     std::unique_ptr<::Microsoft::Console::Render::IRenderEngine> renderEngine,
+                                                     std::unique_ptr<::Microsoft::Terminal::Core::Terminal> terminal);
+        winrt::fire_and_forget _searchAsync(std::shared_ptr<::Search> search);
+        void _readBufferInBatches(const std::function<void(const std::wstring_view)>& sink) const;
+        void _restoreBuffer();
 
         bool _setFontSizeUnderLock(int fontSize);
         void _updateFont(const bool initialUpdate = false);
         void _refreshSizeUnderLock();
         void _updateSelectionUI();
+        void _updateRenderingSuspension();
+        void _updateBackgroundMode();
+        void _suspendRendering();
+        void _sendPendingMouseMove();
 
         void _sendInputToConnection(std::wstring_view wstr);
+        void _predictInput(std::wstring_view wstr);
 
 #pragma region TerminalCoreCallbacks
         void _terminalCopyToClipboard(std::wstring_view wstr);
@@ -308,6 +432,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _raiseReadOnlyWarning();
         void _updateAntiAliasingMode();
         void _connectionOutputHandler(const hstring& hstr);
+        void _startOutputThread();
+        void _stopOutputThread();
+        void _writeToTerminal(const std::wstring_view text, const std::chrono::steady_clock::time_point received);
+        bool _updateFlooding(const size_t chars);
         void _updateHoveredCell(const std::optional<til::point> terminalPosition);
         void _setOpacity(const double opacity);
 
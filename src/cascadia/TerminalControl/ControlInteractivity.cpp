@@ -565,6 +565,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                                                   _core->ViewHeight(),
                                                                                   _core->BufferHeight()));
         }
+
+        // The remaining fraction of a row is scrolled by the renderer alone, which makes
+        // scrolling with precision touchpads smooth. It can't go past either end of the buffer.
+        const auto maxViewTop = _core->BufferHeight() - _core->ViewHeight();
+        const auto inRange = _internalScrollbarPosition > 0 && _internalScrollbarPosition < maxViewTop && viewTop == _core->ScrollOffset();
+        _core->SetSubRowScrollOffset(inRange ? static_cast<float>(_internalScrollbarPosition - viewTop) : 0.0f);
     }
 
     void ControlInteractivity::_hyperlinkHandler(const std::wstring_view uri)
@@ -616,8 +622,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         // Get the size of the font, which is in pixels
         const til::size fontSize{ _core->GetFont().GetSize() };
+        // While smooth scrolling, the rows are drawn shifted up by a fraction of a row.
+        const auto shift = ::base::saturated_cast<til::CoordType>(std::lround(_core->SubRowScrollOffset() * fontSize.height));
         // Convert the location in pixels to characters within the current viewport.
-        return pixelPosition / fontSize;
+        return (pixelPosition + til::point{ 0, shift }) / fontSize;
     }
 
     bool ControlInteractivity::_sendMouseEventHelper(const til::point terminalPosition,
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ScrollbackGovernor.h"
+#include "ControlCore.h"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    ScrollbackGovernor& ScrollbackGovernor::Instance()
+    {
+        // The instance is intentionally leaked. Its threadpool callbacks must not be
+        // waited for during DLL_PROCESS_DETACH and the OS cleans up after us anyways.
+        static auto instance = new ScrollbackGovernor();
+        return *instance;
+    }
+
+    ScrollbackGovernor::ScrollbackGovernor()
+    {
+        _lowMemory.reset(CreateMemoryResourceNotification(LowMemoryResourceNotification));
+        if (!_lowMemory)
+        {
+            // Without the notification we simply never trim anything.
+            LOG_LAST_ERROR();
+            return;
+        }
+
+        _wait.reset(CreateThreadpoolWait(&_lowMemoryCallback, this, nullptr));
+        _cooldownTimer.reset(CreateThreadpoolTimer(&_cooldownCallback, this, nullptr));
+        if (!_wait || !_cooldownTimer)
+        {
+            LOG_LAST_ERROR();
+            return;
+        }
+
+        SetThreadpoolWait(_wait.get(), _lowMemory.get(), nullptr);
+    }
+
+    // Method Description:
+    // - Adds the given ControlCore to the set of panes whose scrollback may be trimmed.
+    //   It counts as the most recently focused one.
+    // Arguments:
+    // - core: the ControlCore, which must call Unregister() before it's destroyed
+    // - weak: a weak reference to the core, to keep it alive while it's trimmed
+    void ScrollbackGovernor::Register(ControlCore* const core, winrt::weak_ref<ControlCore> weak)
+    {
+        const std::lock_guard lock{ _mutex };
+
+        const auto it = std::find_if(_entries.begin(), _entries.end(), [&](const auto& e) { return e.core == core; });
+        if (it == _entries.end())
+        {
+            _entries.emplace_back(Entry{ core, std::move(weak), ++_focusCounter });
+        }
+    }
+
+    void ScrollbackGovernor::Unregister(const ControlCore* const core) noexcept
+    {
+        const std::lock_guard lock{ _mutex };
+
+        std::erase_if(_entries, [&](const auto& e) { return e.core == core; });
+    }
+
+    // Method Description:
+    // - Marks the given ControlCore as the most recently focused one,
+    //   which makes its scrollback the last one to be trimmed.
+    void ScrollbackGovernor::NotifyFocused(const ControlCore* const core) noexcept
+    {
+        const std::lock_guard lock{ _mutex };
+
+        for (auto& e : _entries)
+        {
+            if (e.core == core)
+            {
+                e.lastFocused = ++_focusCounter;
+                break;
+            }
+        }
+    }
+
+    void CALLBACK ScrollbackGovernor::_lowMemoryCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WAIT /*wait*/, TP_WAIT_RESULT /*waitResult*/) noexcept
+    try
+    {
+        const auto self = static_cast<ScrollbackGovernor*>(context);
+        // Re-arm the wait only after the cooldown, see _cooldown.
+        // The FILETIME struct measures time in 100ns steps and negative values are relative.
+        auto dueTime = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(_cooldown).count();
+        SetThreadpoolTimer(self->_cooldownTimer.get(), reinterpret_cast<FILETIME*>(&dueTime), 0, 0);
+        self->_trimScrollback();
+    }
+    CATCH_LOG()
+
+    void CALLBACK ScrollbackGovernor::_cooldownCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+    {
+        const auto self = static_cast<ScrollbackGovernor*>(context);
+        SetThreadpoolWait(self->_wait.get(), self->_lowMemory.get(), nullptr);
+    }
+
+    // Method Description:
+    // - Trims the scrollback of hidden panes, least recently focused first, until
+    //   at least 1/_trimDivisor of the memory used by all buffers has been freed.
+    void ScrollbackGovernor::_trimScrollback()
+    {
+        std::vector<std::pair<uint64_t, winrt::com_ptr<ControlCore>>> cores;
+        {
+            const std::lock_guard lock{ _mutex };
+
+            cores.reserve(_entries.size());
+            for (const auto& e : _entries)
+            {
+                if (auto core = e.weak.get())
+                {
+                    cores.emplace_back(e.lastFocused, std::move(core));
+                }
+            }
+        }
+
+        std::sort(cores.begin(), cores.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        size_t total = 0;
+        for (const auto& [lastFocused, core] : cores)
+        {
+            total += core->GetMemoryFootprint();
+        }
+
+        const auto target = total / _trimDivisor;
+        size_t freed = 0;
+        size_t trimmed = 0;
+        for (const auto& [lastFocused, core] : cores)
+        {
+            if (freed >= target)
+            {
+                break;
+            }
+
+            if (const auto bytes = core->TrimScrollbackUnderMemoryPressure())
+            {
+                freed += bytes;
+                trimmed++;
+            }
+        }
+
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "ScrollbackTrimmedUnderMemoryPressure",
+                          TraceLoggingDescription("Trimmed the scrollback of hidden panes because the system ran low on memory"),
+                          TraceLoggingUInt64(total, "TotalBytes"),
+                          TraceLoggingUInt64(freed, "FreedBytes"),
+                          TraceLoggingUInt64(trimmed, "TrimmedPanes"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_INFO));
+    }
+}
@@ -0,0 +1,62 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollbackGovernor.h
+
+Abstract:
+- Keeps track of all ControlCores of the process, so that their scrollback can
+  be trimmed once the system runs low on memory. Every pane allocates its own
+  history independently, which adds up quickly with dozens of panes.
+- When the OS signals LowMemoryResourceNotification, the scrollback of hidden
+  panes is trimmed, starting with the least recently focused one, until a
+  quarter of the memory used by all buffers has been freed. Visible panes are
+  never trimmed. Each trimmed pane tells the user about it once it's shown.
+--*/
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    struct ControlCore;
+
+    class ScrollbackGovernor
+    {
+    public:
+        static ScrollbackGovernor& Instance();
+
+        void Register(ControlCore* const core, winrt::weak_ref<ControlCore> weak);
+        void Unregister(const ControlCore* const core) noexcept;
+        void NotifyFocused(const ControlCore* const core) noexcept;
+
+    private:
+        ScrollbackGovernor();
+
+        static void CALLBACK _lowMemoryCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT waitResult) noexcept;
+        static void CALLBACK _cooldownCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer) noexcept;
+        void _trimScrollback();
+
+        // How much of the total footprint a low memory notification should free.
+        static constexpr size_t _trimDivisor = 4;
+        // How long to wait before reacting to the next low memory notification. The notification
+        // stays signaled while the system is low on memory and freeing memory takes a moment to
+        // show up in the system's counters, so we'd trim everything at once otherwise.
+        static constexpr std::chrono::seconds _cooldown{ 30 };
+
+        struct Entry
+        {
+            ControlCore* core;
+            winrt::weak_ref<ControlCore> weak;
+            uint64_t lastFocused;
+        };
+
+        std::mutex _mutex;
+        std::vector<Entry> _entries;
+        uint64_t _focusCounter = 0;
+
+        wil::unique_handle _lowMemory;
+        wil::unique_threadpool_wait_nowait _wait;
+        wil::unique_threadpool_timer_nowait _cooldownTimer;
+    };
+}
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "SearchBoxControl.h"
+#include <LibraryResources.h>
 #include "SearchBoxControl.g.cpp"
 
 using namespace winrt;
@@ -22,6 +23,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _focusableElements.insert(TextBox());
         _focusableElements.insert(CloseButton());
         _focusableElements.insert(CaseSensitivityButton());
+        _focusableElements.insert(RegexButton());
         _focusableElements.insert(GoForwardButton());
         _focusableElements.insert(GoBackwardButton());
     }
@@ -50,6 +52,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return CaseSensitivityButton().IsChecked().GetBoolean();
     }
 
+    // Method Description:
+    // - Check if the query is a regular expression
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - bool: whether the query is a regular expression (regex button is checked)
+    //   or plain text
+    bool SearchBoxControl::_Regex()
+    {
+        return RegexButton().IsChecked().GetBoolean();
+    }
+
     // Method Description:
     // - Handler for pressing Enter on TextBox, trigger
     //   text search
@@ -65,16 +79,30 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             const auto state = CoreWindow::GetForCurrentThread().GetKeyState(winrt::Windows::System::VirtualKey::Shift);
             if (WI_IsFlagSet(state, CoreVirtualKeyStates::Down))
             {
-                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive(), _Regex());
             }
             else
             {
-                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
             }
             e.Handled(true);
         }
     }
 
+    // Method Description:
+    // - Handler for changes to the text of the TextBox. The results shown
+    //   so far belong to the previous text, so they're cleared.
+    // Arguments:
+    // - sender: not used
+    // - e: event data
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::TextBoxTextChanged(const winrt::Windows::Foundation::IInspectable& /*sender*/, const Controls::TextChangedEventArgs& e)
+    {
+        StatusBox().Text(L"");
+        _QueryChangedHandlers(*this, e);
+    }
+
     // Method Description:
     // - Handler for pressing "Esc" when focusing
     //   on the search dialog, this triggers close
@@ -142,6 +170,26 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return false;
     }
 
+    // Method Description:
+    // - Shows how many matches the last search found and which of them is selected
+    // Arguments:
+    // - totalMatches: the number of matches in the buffer
+    // - currentMatch: the 0-based index of the selected match, or -1 if none is selected
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::SetStatus(int32_t totalMatches, int32_t currentMatch)
+    {
+        if (totalMatches <= 0)
+        {
+            StatusBox().Text(RS_(L"SearchBox_NoResults"));
+        }
+        else
+        {
+            const auto current = currentMatch < 0 ? std::wstring{ L"?" } : std::to_wstring(currentMatch + 1);
+            StatusBox().Text(fmt::format(std::wstring_view{ RS_(L"SearchBox_StatusFormat") }, current, totalMatches));
+        }
+    }
+
     // Method Description:
     // - Handler for clicking the GoBackward button. This change the value of _goForward,
     //   mark GoBackward button as checked and ensure GoForward button
@@ -160,7 +208,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -181,7 +229,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -26,10 +26,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         SearchBoxControl();
 
         void TextBoxKeyDown(const winrt::Windows::Foundation::IInspectable& /*sender*/, const winrt::Windows::UI::Xaml::Input::KeyRoutedEventArgs& e);
+        void TextBoxTextChanged(const winrt::Windows::Foundation::IInspectable& /*sender*/, const winrt::Windows::UI::Xaml::Controls::TextChangedEventArgs& e);
 
         void SetFocusOnTextbox();
         void PopulateTextbox(const winrt::hstring& text);
         bool ContainsFocus();
+        void SetStatus(int32_t totalMatches, int32_t currentMatch);
 
         void GoBackwardClicked(const winrt::Windows::Foundation::IInspectable& /*sender*/, const winrt::Windows::UI::Xaml::RoutedEventArgs& /*e*/);
         void GoForwardClicked(const winrt::Windows::Foundation::IInspectable& /*sender*/, const winrt::Windows::UI::Xaml::RoutedEventArgs& /*e*/);
@@ -37,12 +39,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         WINRT_CALLBACK(Search, SearchHandler);
         TYPED_EVENT(Closed, Control::SearchBoxControl, Windows::UI::Xaml::RoutedEventArgs);
+        TYPED_EVENT(QueryChanged, Control::SearchBoxControl, Windows::UI::Xaml::Controls::TextChangedEventArgs);
 
     private:
         std::unordered_set<winrt::Windows::Foundation::IInspectable> _focusableElements;
 
         bool _GoForward();
         bool _CaseSensitive();
+        bool _Regex();
         void _KeyDownHandler(const winrt::Windows::Foundation::IInspectable& sender, const winrt::Windows::UI::Xaml::Input::KeyRoutedEventArgs& e);
         void _CharacterHandler(const winrt::Windows::Foundation::IInspectable& /*sender*/, const winrt::Windows::UI::Xaml::Input::CharacterReceivedRoutedEventArgs& e);
     };
@@ -108,13 +108,40 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Redraw the canvas if certain dimensions have changed since the last
-    //   redraw. This includes the Terminal cursor position, the Canvas width, and the TextBlock height.
+    // - Called when the Terminal cursor moved. Redraws the canvas if it's now
+    //   in a different place.
     // Arguments:
     // - <none>
     // Return Value:
     // - <none>
     void TSFInputControl::TryRedrawCanvas()
+    {
+        _cursorPositionValid = false;
+        _TryRedrawCanvas();
+    }
+
+    // Method Description:
+    // - Called when the font of the Terminal changed. The new font info is
+    //   requested the next time the canvas is redrawn. We can't do that here,
+    //   because the font change is announced while the terminal is locked.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TSFInputControl::NotifyFontChanged()
+    {
+        _fontInfoValid = false;
+        _cursorPositionValid = false;
+    }
+
+    // Method Description:
+    // - Redraw the canvas if certain dimensions have changed since the last
+    //   redraw. This includes the Terminal cursor position, the font, the Canvas width, and the TextBlock height.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TSFInputControl::_TryRedrawCanvas()
     try
     {
         if (!_focused || !Canvas())
@@ -122,16 +149,25 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
-        // Get the cursor position in text buffer position
-        auto cursorArgs = winrt::make_self<CursorPositionEventArgs>();
-        _CurrentCursorPositionHandlers(*this, *cursorArgs);
-        const til::point cursorPos{ til::math::flooring, cursorArgs->CurrentPosition() };
+        auto redraw = !_fontInfoValid;
+
+        if (!_cursorPositionValid)
+        {
+            // Get the cursor position in text buffer position
+            auto cursorArgs = winrt::make_self<CursorPositionEventArgs>();
+            _CurrentCursorPositionHandlers(*this, *cursorArgs);
+            const til::point cursorPos{ til::math::flooring, cursorArgs->CurrentPosition() };
+
+            _cursorPositionValid = true;
+            redraw = redraw || _currentTerminalCursorPos != cursorPos;
+            _currentTerminalCursorPos = cursorPos;
+        }
 
         const auto actualCanvasWidth{ Canvas().ActualWidth() };
         const auto actualTextBlockHeight{ TextBlock().ActualHeight() };
         const auto actualWindowBounds{ CoreWindow::GetForCurrentThread().Bounds() };
 
-        if (_currentTerminalCursorPos == cursorPos &&
+        if (!redraw &&
             _currentCanvasWidth == actualCanvasWidth &&
             _currentTextBlockHeight == actualTextBlockHeight &&
             _currentWindowBounds == actualWindowBounds)
@@ -139,7 +175,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
-        _currentTerminalCursorPos = cursorPos;
         _currentCanvasWidth = actualCanvasWidth;
         _currentTextBlockHeight = actualTextBlockHeight;
         _currentWindowBounds = actualWindowBounds;
@@ -157,11 +192,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - <none>
     void TSFInputControl::_RedrawCanvas()
     {
-        // Get Font Info as we use this is the pixel size for characters in the display
-        auto fontArgs = winrt::make_self<FontInfoEventArgs>();
-        _CurrentFontInfoHandlers(*this, *fontArgs);
+        winrt::com_ptr<FontInfoEventArgs> fontArgs;
+        if (!_fontInfoValid)
+        {
+            // Get Font Info as we use this is the pixel size for characters in the display
+            fontArgs = winrt::make_self<FontInfoEventArgs>();
+            _CurrentFontInfoHandlers(*this, *fontArgs);
 
-        const til::size fontSize{ til::math::flooring, fontArgs->FontSize() };
+            _currentFontSize = til::size{ til::math::flooring, fontArgs->FontSize() };
+            _fontInfoValid = true;
+        }
+
+        const auto fontSize = _currentFontSize;
 
         // Convert text buffer cursor position to client coordinate position
         // within the window. This point is in _pixels_
@@ -180,17 +222,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const double fontSizePx = (fontSize.height * 72) / USER_DEFAULT_SCREEN_DPI;
         const auto unscaledFontSizePx = fontSizePx / scaleFactor;
 
-        // Make sure to unscale the font size to correct for DPI! XAML needs
-        // things in DIPs, and the fontSize is in pixels.
-        TextBlock().FontSize(unscaledFontSizePx);
-        TextBlock().FontFamily(Media::FontFamily(fontArgs->FontFace()));
-        TextBlock().FontWeight(fontArgs->FontWeight());
-
-        // TextBlock's actual dimensions right after initialization is 0w x 0h. So,
-        // if an IME is displayed before TextBlock has text (like showing the emoji picker
-        // using Win+.), it'll be placed higher than intended.
-        TextBlock().MinWidth(unscaledFontSizePx);
-        TextBlock().MinHeight(unscaledFontSizePx);
+        // The font of the TextBlock only needs to be touched if it changed.
+        if (fontArgs)
+        {
+            // Make sure to unscale the font size to correct for DPI! XAML needs
+            // things in DIPs, and the fontSize is in pixels.
+            TextBlock().FontSize(unscaledFontSizePx);
+            TextBlock().FontFamily(Media::FontFamily(fontArgs->FontFace()));
+            TextBlock().FontWeight(fontArgs->FontWeight());
+
+            // TextBlock's actual dimensions right after initialization is 0w x 0h. So,
+            // if an IME is displayed before TextBlock has text (like showing the emoji picker
+            // using Win+.), it'll be placed higher than intended.
+            TextBlock().MinWidth(unscaledFontSizePx);
+            TextBlock().MinHeight(unscaledFontSizePx);
+        }
+
         _currentTextBlockHeight = std::max(unscaledFontSizePx, _currentTextBlockHeight);
 
         const auto widthToTerminalEnd = _currentCanvasWidth - clientCursorInDips.x;
@@ -249,7 +296,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         auto request = args.Request();
 
-        TryRedrawCanvas();
+        // IMEs tend to request the layout several times per keystroke. Nothing
+        // it depends on is laid out anew until the next frame, so we only
+        // check for changes on the first request in each frame.
+        if (!_layoutRequestedThisFrame)
+        {
+            _layoutRequestedThisFrame = true;
+            _renderingRevoker = Media::CompositionTarget::Rendering(winrt::auto_revoke, [weakThis = get_weak()](auto&&, auto&&) {
+                if (auto control{ weakThis.get() })
+                {
+                    control->_layoutRequestedThisFrame = false;
+                    control->_renderingRevoker.revoke();
+                }
+            });
+
+            _TryRedrawCanvas();
+        }
 
         // Set the text block bounds
         request.LayoutBounds().TextBounds(_currentTextBounds);
@@ -39,6 +39,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void NotifyFocusLeave();
         void ClearBuffer();
         void TryRedrawCanvas();
+        void NotifyFontChanged();
 
         void Close();
 
@@ -59,6 +60,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _formatUpdatingHandler(winrt::Windows::UI::Text::Core::CoreTextEditContext sender, const winrt::Windows::UI::Text::Core::CoreTextFormatUpdatingEventArgs& args);
 
         void _SendAndClearText();
+        void _TryRedrawCanvas();
         void _RedrawCanvas();
 
         winrt::Windows::UI::Text::Core::CoreTextEditContext::TextRequested_revoker _textRequestedRevoker;
@@ -70,6 +72,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::Windows::UI::Text::Core::CoreTextEditContext::LayoutRequested_revoker _layoutRequestedRevoker;
         winrt::Windows::UI::Text::Core::CoreTextEditContext::CompositionStarted_revoker _compositionStartedRevoker;
         winrt::Windows::UI::Text::Core::CoreTextEditContext::CompositionCompleted_revoker _compositionCompletedRevoker;
+        winrt::Windows::UI::Xaml::Media::CompositionTarget::Rendering_revoker _renderingRevoker;
 
         Windows::UI::Text::Core::CoreTextEditContext _editContext{ nullptr };
         std::wstring _inputBuffer;
@@ -77,8 +80,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         size_t _activeTextStart = 0;
         bool _inComposition = false;
         bool _focused = false;
+        // Layout requests are answered from _currentTextBounds/_currentControlBounds
+        // after the first one in a frame. The cursor position and font info are
+        // only fetched from the control (which locks the terminal) once they changed.
+        bool _layoutRequestedThisFrame = false;
+        bool _cursorPositionValid = false;
+        bool _fontInfoValid = false;
 
         til::point _currentTerminalCursorPos{};
+        til::size _currentFontSize{};
         double _currentCanvasWidth = 0.0;
         double _currentTextBlockHeight = 0.0;
         winrt::Windows::Foundation::Rect _currentControlBounds{};
@@ -83,6 +83,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.RaiseNotice({ this, &TermControl::_coreRaisedNotice });
         _core.HoveredHyperlinkChanged({ this, &TermControl::_hoveredHyperlinkChanged });
         _core.FoundMatch({ this, &TermControl::_coreFoundMatch });
+        _core.SearchProgress({ this, &TermControl::_coreSearchProgress });
         _core.UpdateSelectionMarkers({ this, &TermControl::_updateSelectionMarkers });
         _core.OpenHyperlink({ this, &TermControl::_HyperlinkHandler });
         _interactivity.OpenHyperlink({ this, &TermControl::_HyperlinkHandler });
@@ -160,32 +161,98 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         if (_showMarksInScrollbar)
         {
-            // Update scrollbar marks
-            ScrollBarCanvas().Children().Clear();
-            const auto marks{ _core.ScrollMarks() };
-            const auto fullHeight{ ScrollBarCanvas().ActualHeight() };
-            const auto totalBufferRows{ update.newMaximum + update.newViewportSize };
+            _updateScrollMarkPips(update.newMaximum + update.newViewportSize);
+        }
+    }
+
+    // Method Description:
+    // - Redraws the scrollbar pips. Only the pips that changed since the last
+    //   update are fetched from the core, and instead of one XAML element per
+    //   mark, they're all drawn into a single bitmap that's stretched over the
+    //   scrollbar. The bitmap is only redrawn if anything about it changed.
+    // Arguments:
+    // - totalBufferRows: the number of rows the scrollbar spans.
+    void TermControl::_updateScrollMarkPips(const double totalBufferRows)
+    {
+        const auto fromScratch = std::exchange(_scrollMarkPipsFromScratch, false);
+        int32_t removedCount = 0;
+        int32_t rowOffset = 0;
+        const auto changes = _core.GetScrollMarkPipChanges(fromScratch, removedCount, rowOffset);
+        const auto removedEnd = changes.begin() + removedCount;
+
+        if (fromScratch || !changes.empty())
+        {
+            const auto less = [](const Control::ScrollMarkPip& a, const Control::ScrollMarkPip& b) noexcept {
+                return std::pair{ a.Row, til::color{ a.Color }.abgr } < std::pair{ b.Row, til::color{ b.Color }.abgr };
+            };
 
-            for (const auto m : marks)
+            std::vector<Control::ScrollMarkPip> kept;
+            if (!fromScratch)
             {
-                Windows::UI::Xaml::Shapes::Rectangle r;
-                Media::SolidColorBrush brush{};
-                // Sneaky: technically, a mark doesn't need to have a color set,
-                // it might want to just use the color from the palette for that
-                // kind of mark. Fortunately, ControlCore is kind enough to
-                // pre-evaluate that for us, and shove the real value into the
-                // Color member, regardless if the mark has a literal value set.
-                brush.Color(static_cast<til::color>(m.Color.Color));
-                r.Fill(brush);
-                r.Width(16.0f / 3.0f); // pip width - 1/3rd of the scrollbar width.
-                r.Height(2);
-                const auto markRow = m.Start.Y;
-                const auto fractionalHeight = markRow / totalBufferRows;
-                const auto relativePos = fractionalHeight * fullHeight;
-                ScrollBarCanvas().Children().Append(r);
-                Windows::UI::Xaml::Controls::Canvas::SetTop(r, relativePos);
+                kept.reserve(_scrollMarkPips.size());
+                std::set_difference(_scrollMarkPips.begin(), _scrollMarkPips.end(), changes.begin(), removedEnd, std::back_inserter(kept), less);
             }
+            _scrollMarkPips.clear();
+            std::merge(kept.begin(), kept.end(), removedEnd, changes.end(), std::back_inserter(_scrollMarkPips), less);
+            _scrollMarkPipsDirty = true;
+        }
+
+        // The bitmap is in physical pixels, so that the pips stay crisp.
+        const auto scale = SwapChainPanel().CompositionScaleY();
+        const auto height = gsl::narrow_cast<int32_t>(std::ceil(ScrollBarPips().ActualHeight() * scale));
+        if (height <= 0 || totalBufferRows <= 0)
+        {
+            return;
+        }
+
+        if (!_scrollMarkPipsBitmap || _scrollMarkPipsBitmap.PixelHeight() != height)
+        {
+            // The bitmap is 3 pixels wide and we only draw into the first column,
+            // which makes the pips 1/3rd of the scrollbar width once it's stretched.
+            _scrollMarkPipsBitmap = Media::Imaging::WriteableBitmap{ 3, height };
+            Media::ImageBrush brush;
+            brush.ImageSource(_scrollMarkPipsBitmap);
+            brush.Stretch(Media::Stretch::Fill);
+            ScrollBarPips().Background(brush);
+            _scrollMarkPipsDirty = true;
         }
+
+        if (!_scrollMarkPipsDirty && rowOffset == _scrollMarkPipsOffset && totalBufferRows == _scrollMarkPipsRows)
+        {
+            return;
+        }
+
+        _scrollMarkPipsDirty = false;
+        _scrollMarkPipsOffset = rowOffset;
+        _scrollMarkPipsRows = totalBufferRows;
+
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+        const auto pixels = reinterpret_cast<uint32_t*>(_scrollMarkPipsBitmap.PixelBuffer().data());
+        const std::span<uint32_t> bitmap{ pixels, gsl::narrow_cast<size_t>(height) * 3 };
+        std::fill(bitmap.begin(), bitmap.end(), 0);
+
+        const auto pipHeight = std::max(1, gsl::narrow_cast<int32_t>(std::lround(2 * scale)));
+        for (const auto& pip : _scrollMarkPips)
+        {
+            // Sneaky: technically, a mark doesn't need to have a color set,
+            // it might want to just use the color from the palette for that
+            // kind of mark. Fortunately, ControlCore is kind enough to
+            // pre-evaluate that for us, so the pip always has the real value.
+            const til::color color{ pip.Color };
+            // WriteableBitmap is premultiplied BGRA.
+            const auto premultiply = [&](const uint8_t c) noexcept { return static_cast<uint32_t>(c * color.a / 255); };
+            const auto bgra = (uint32_t{ color.a } << 24) | (premultiply(color.r) << 16) | (premultiply(color.g) << 8) | premultiply(color.b);
+
+            const auto fractionalHeight = (pip.Row - rowOffset) / totalBufferRows;
+            const auto top = std::clamp(gsl::narrow_cast<int32_t>(fractionalHeight * height), 0, height - 1);
+            const auto bottom = std::min(top + pipHeight, height);
+            for (auto y = top; y < bottom; ++y)
+            {
+                til::at(bitmap, gsl::narrow_cast<size_t>(y) * 3) = bgra;
+            }
+        }
+
+        _scrollMarkPipsBitmap.Invalidate();
     }
 
     // Method Description:
@@ -233,7 +300,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
-            _core.Search(_searchBox->TextBox().Text(), goForward, false);
+            _core.Search(_searchBox->TextBox().Text(), goForward, false, false);
         }
     }
 
@@ -258,13 +325,29 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - text: the text to search
     // - goForward: boolean that represents if the current search direction is forward
     // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if text is a regular expression
     // Return Value:
     // - <none>
     void TermControl::_Search(const winrt::hstring& text,
                               const bool goForward,
-                              const bool caseSensitive)
+                              const bool caseSensitive,
+                              const bool regex)
     {
-        _core.Search(text, goForward, caseSensitive);
+        _core.Search(text, goForward, caseSensitive, regex);
+    }
+
+    // Method Description:
+    // - The handler for changes to the text in the search dialog. The search
+    //   that might still be running for the previous text is stale now.
+    // Arguments:
+    // - IInspectable: not used
+    // - TextChangedEventArgs: not used
+    // Return Value:
+    // - <none>
+    void TermControl::_SearchQueryChanged(const winrt::Windows::Foundation::IInspectable& /*sender*/,
+                                          const Windows::UI::Xaml::Controls::TextChangedEventArgs& /*args*/)
+    {
+        _core.CancelSearch();
     }
 
     // Method Description:
@@ -279,6 +362,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                              const RoutedEventArgs& /*args*/)
     {
         _searchBox->Visibility(Visibility::Collapsed);
+        _core.CancelSearch();
 
         // Set focus back to terminal control
         this->Focus(FocusState::Programmatic);
@@ -454,10 +538,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _showMarksInScrollbar = settings.ShowMarks();
         // Clear out all the current marks
-        ScrollBarCanvas().Children().Clear();
+        ScrollBarPips().Background(nullptr);
+        _scrollMarkPipsBitmap = nullptr;
+        _scrollMarkPipsFromScratch = true;
         // When we hot reload the settings, the core will send us a scrollbar
         // update. If we enabled scrollbar marks, then great, when we handle
         // that message, we'll redraw them.
+
+        // The render timings overlay is refreshed once a second while it's enabled.
+        if (settings.ShowRenderTimings())
+        {
+            if (!_renderTimingsTimer)
+            {
+                DispatcherTimer renderTimingsTimer;
+                renderTimingsTimer.Interval(std::chrono::seconds(1));
+                renderTimingsTimer.Tick({ get_weak(), &TermControl::_RenderTimingsTimerTick });
+                renderTimingsTimer.Start();
+                _renderTimingsTimer.emplace(std::move(renderTimingsTimer));
+            }
+            RenderTimingsOverlay().Visibility(Visibility::Visible);
+        }
+        else if (_renderTimingsTimer)
+        {
+            _renderTimingsTimer->Stop();
+            _renderTimingsTimer = std::nullopt;
+            RenderTimingsOverlay().Visibility(Visibility::Collapsed);
+        }
     }
 
     // Method Description:
@@ -859,11 +965,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         int blinkTime = GetCaretBlinkTime();
         if (blinkTime != INFINITE)
         {
-            // Create a timer
-            DispatcherTimer cursorTimer;
-            cursorTimer.Interval(std::chrono::milliseconds(blinkTime));
-            cursorTimer.Tick({ get_weak(), &TermControl::_CursorTimerTick });
-            _cursorTimer.emplace(std::move(cursorTimer));
+            // Create a timer. The timers are members of ours and tick on our thread, so capturing this is safe.
+            _cursorTimer.emplace(std::chrono::milliseconds(blinkTime), [this]() { _CursorTimerTick(); });
             // As of GH#6586, don't start the cursor timer immediately, and
             // don't show the cursor initially. We'll show the cursor and start
             // the timer when the control is first focused.
@@ -889,11 +992,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         if (animationsEnabled && blinkTime != INFINITE)
         {
             // Create a timer
-            DispatcherTimer blinkTimer;
-            blinkTimer.Interval(std::chrono::milliseconds(blinkTime));
-            blinkTimer.Tick({ get_weak(), &TermControl::_BlinkTimerTick });
-            blinkTimer.Start();
-            _blinkTimer.emplace(std::move(blinkTimer));
+            _blinkTimer.emplace(std::chrono::milliseconds(blinkTime), [this]() { _BlinkTimerTick(); });
+            _blinkTimer->Start();
         }
         else
         {
@@ -1759,6 +1859,48 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Event handlers for the Loaded and Unloaded events. Controls are unloaded
+    //   when they're removed from the UI tree, for instance when another tab
+    //   gets selected. The core suspends rendering of controls that stay hidden
+    //   and there's no point in blinking them either.
+    void TermControl::_LoadedHandler(const Windows::Foundation::IInspectable& /* sender */,
+                                     const RoutedEventArgs& /* args */)
+    {
+        if (!_IsClosing())
+        {
+            _core.ControlVisibilityChanged(true);
+
+            // Losing focus stopped the timers already, so only focused controls need to resume.
+            if (_cursorTimer && _focused)
+            {
+                _cursorTimer->Start();
+            }
+            if (_blinkTimer && _focused)
+            {
+                _blinkTimer->Start();
+            }
+        }
+    }
+
+    void TermControl::_UnloadedHandler(const Windows::Foundation::IInspectable& /* sender */,
+                                       const RoutedEventArgs& /* args */)
+    {
+        if (!_IsClosing())
+        {
+            _core.ControlVisibilityChanged(false);
+
+            if (_cursorTimer)
+            {
+                _cursorTimer->Stop();
+            }
+            if (_blinkTimer)
+            {
+                _blinkTimer->Stop();
+            }
+        }
+    }
+
     // Method Description:
     // - Triggered when the swapchain changes size. We use this to resize the
     //      terminal buffers to match the new visible size.
@@ -1818,11 +1960,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     // Method Description:
     // - Toggle the cursor on and off when called by the cursor blink timer.
-    // Arguments:
-    // - sender: not used
-    // - e: not used
-    void TermControl::_CursorTimerTick(const Windows::Foundation::IInspectable& /* sender */,
-                                       const Windows::Foundation::IInspectable& /* e */)
+    void TermControl::_CursorTimerTick()
     {
         if (!_IsClosing())
         {
@@ -1832,15 +1970,25 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     // Method Description:
     // - Toggle the blinking rendition state when called by the blink timer.
+    void TermControl::_BlinkTimerTick()
+    {
+        if (!_IsClosing())
+        {
+            _core.BlinkAttributeTick();
+        }
+    }
+
+    // Method Description:
+    // - Shows how long painting the frames of the last second took, see ControlCore::GetRenderTimingsSummary.
     // Arguments:
     // - sender: not used
     // - e: not used
-    void TermControl::_BlinkTimerTick(const Windows::Foundation::IInspectable& /* sender */,
-                                      const Windows::Foundation::IInspectable& /* e */)
+    void TermControl::_RenderTimingsTimerTick(const Windows::Foundation::IInspectable& /* sender */,
+                                              const Windows::Foundation::IInspectable& /* e */)
     {
         if (!_IsClosing())
         {
-            _core.BlinkAttributeTick();
+            RenderTimingsText().Text(_core.GetRenderTimingsSummary());
         }
     }
 
@@ -1982,6 +2130,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // Disconnect the TSF input control so it doesn't receive EditContext events.
             TSFInputControl().Close();
             _autoScrollTimer.Stop();
+            if (_renderTimingsTimer)
+            {
+                _renderTimingsTimer->Stop();
+            }
 
             _core.Close();
         }
@@ -2221,6 +2373,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.WindowVisibilityChanged(showOrHide);
     }
 
+    // Method Description:
+    // - Called when the user starts or stops dragging the border of the hosting
+    //   window. While that's in progress, the buffer and the swap chain are only
+    //   resized every now and then, instead of for every SizeChanged.
+    // Arguments:
+    // - inProgress: True when the resize started; false when it ended.
+    // Return Value:
+    // - <none>
+    void TermControl::InteractiveResizeChanged(const bool inProgress)
+    {
+        _core.InteractiveResizeChanged(inProgress);
+    }
+
     // Method Description:
     // - Create XAML Thickness object based on padding props provided.
     //   Used for controlling the TermControl XAML Grid container's Padding prop.
@@ -2960,6 +3125,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         scaleMarker(SelectionStartMarker());
         scaleMarker(SelectionEndMarker());
 
+        TSFInputControl().NotifyFontChanged();
+
         // Don't try to inspect the core here. The Core is raising this while
         // it's holding its write lock. If the handlers calls back to some
         // method on the TermControl on the same thread, and that _method_ calls
@@ -3029,6 +3196,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _core.ReadEntireBuffer();
     }
 
+    Windows::Foundation::IAsyncAction TermControl::ExportBufferAsync(const hstring& path) const
+    {
+        return _core.ExportBufferAsync(path);
+    }
+
+    void TermControl::PersistBuffer(const hstring& path) const
+    {
+        _core.PersistBuffer(path);
+    }
+
+    void TermControl::RestoreBuffer(const hstring& path) const
+    {
+        _core.RestoreBuffer(path);
+    }
+
     Core::Scheme TermControl::ColorScheme() const noexcept
     {
         return _core.ColorScheme();
@@ -3064,8 +3246,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - args: contains information about the results that were or were not found.
     // Return Value:
     // - <none>
-    void TermControl::_coreFoundMatch(const IInspectable& /*sender*/, const Control::FoundResultsArgs& args)
+    winrt::fire_and_forget TermControl::_coreFoundMatch(IInspectable /*sender*/, Control::FoundResultsArgs args)
     {
+        auto weakThis{ get_weak() };
+        co_await wil::resume_foreground(Dispatcher());
+        if (!weakThis.get())
+        {
+            co_return;
+        }
+
+        if (_searchBox)
+        {
+            _searchBox->SetStatus(args.TotalMatches(), args.CurrentMatch());
+        }
+
         if (auto automationPeer{ Automation::Peers::FrameworkElementAutomationPeer::FromElement(*this) })
         {
             automationPeer.RaiseNotificationEvent(
@@ -3076,6 +3270,23 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Called when the core has searched another part of the buffer while
+    //   searching in the background. Shows the number of results so far.
+    // Arguments:
+    // - args: contains the number of results found so far.
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget TermControl::_coreSearchProgress(IInspectable /*sender*/, Control::FoundResultsArgs args)
+    {
+        auto weakThis{ get_weak() };
+        co_await wil::resume_foreground(Dispatcher());
+        if (weakThis.get() && _searchBox)
+        {
+            _searchBox->SetStatus(args.TotalMatches(), args.CurrentMatch());
+        }
+    }
+
     void TermControl::OwningHwnd(uint64_t owner)
     {
         _core.OwningHwnd(owner);
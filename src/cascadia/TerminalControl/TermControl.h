@@ -12,6 +12,7 @@
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../buffer/out/search.h"
 #include "SearchBoxControl.h"
+#include "BlinkTimer.h"
 
 #include "ControlInteractivity.h"
 #include "ControlSettings.h"
@@ -47,6 +48,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         float SnapDimensionToGrid(const bool widthOrHeight, const float dimension);
 
         void WindowVisibilityChanged(const bool showOrHide);
+        void InteractiveResizeChanged(const bool inProgress);
 
 #pragma region ICoreState
         const uint64_t TaskbarState() const noexcept;
@@ -124,6 +126,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         static Windows::UI::Xaml::Thickness ParseThicknessFromPadding(const hstring padding);
 
         hstring ReadEntireBuffer() const;
+        Windows::Foundation::IAsyncAction ExportBufferAsync(const hstring& path) const;
+        void PersistBuffer(const hstring& path) const;
+        void RestoreBuffer(const hstring& path) const;
 
         winrt::Microsoft::Terminal::Core::Scheme ColorScheme() const noexcept;
         void ColorScheme(const winrt::Microsoft::Terminal::Core::Scheme& scheme) const noexcept;
@@ -162,7 +167,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // NOTE: _uiaEngine must be ordered before _core.
         //
-        // ControlCore::AttachUiaEngine receives a IRenderEngine as a raw pointer, which we own.
+        // ControlCore::AttachUiaEngine receives a UiaEngine as a raw pointer, which we own.
         // We must ensure that we first destroy the ControlCore before the UiaEngine instance
         // in order to safely resolve this unsafe pointer dependency. Otherwise a deallocated
         // IRenderEngine is accessed when ControlCore calls Renderer::TriggerTeardown.
@@ -204,11 +209,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::Windows::UI::Composition::ScalarKeyFrameAnimation _bellDarkAnimation{ nullptr };
         Windows::UI::Xaml::DispatcherTimer _bellLightTimer{ nullptr };
 
-        std::optional<Windows::UI::Xaml::DispatcherTimer> _cursorTimer;
-        std::optional<Windows::UI::Xaml::DispatcherTimer> _blinkTimer;
+        std::optional<BlinkTimer> _cursorTimer;
+        std::optional<BlinkTimer> _blinkTimer;
+        std::optional<Windows::UI::Xaml::DispatcherTimer> _renderTimingsTimer;
 
         winrt::Windows::UI::Xaml::Controls::SwapChainPanel::LayoutUpdated_revoker _layoutUpdatedRevoker;
         bool _showMarksInScrollbar{ false };
+        // The scrollbar pips, sorted by row and color, and the bitmap they're drawn into.
+        std::vector<Control::ScrollMarkPip> _scrollMarkPips;
+        Windows::UI::Xaml::Media::Imaging::WriteableBitmap _scrollMarkPipsBitmap{ nullptr };
+        int32_t _scrollMarkPipsOffset{ 0 };
+        double _scrollMarkPipsRows{ 0 };
+        bool _scrollMarkPipsFromScratch{ true };
+        bool _scrollMarkPipsDirty{ true };
 
         bool _isBackgroundLight{ false };
 
@@ -251,14 +264,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void _GotFocusHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
         void _LostFocusHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
+        void _LoadedHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
+        void _UnloadedHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
 
         winrt::fire_and_forget _DragDropHandler(Windows::Foundation::IInspectable sender, Windows::UI::Xaml::DragEventArgs e);
         void _DragOverHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::DragEventArgs& e);
 
         winrt::fire_and_forget _HyperlinkHandler(Windows::Foundation::IInspectable sender, Control::OpenHyperlinkEventArgs e);
 
-        void _CursorTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
-        void _BlinkTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
+        void _CursorTimerTick();
+        void _BlinkTimerTick();
+        void _RenderTimingsTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
         void _BellLightOff(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
 
         void _SetEndSelectionPointAtCursor(const Windows::Foundation::Point& cursorPosition);
@@ -287,7 +303,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const til::point _toTerminalOrigin(winrt::Windows::Foundation::Point cursorPosition);
         double _GetAutoScrollSpeed(double cursorDistanceFromBorder) const;
 
-        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive);
+        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive, const bool regex);
+        void _SearchQueryChanged(const winrt::Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::Controls::TextChangedEventArgs& args);
         void _CloseSearchBoxControl(const winrt::Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& args);
 
         // TSFInputControl Handlers
@@ -304,10 +321,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::fire_and_forget _coreTransparencyChanged(IInspectable sender, Control::TransparencyChangedEventArgs args);
         void _coreRaisedNotice(const IInspectable& s, const Control::NoticeEventArgs& args);
         void _coreWarningBell(const IInspectable& sender, const IInspectable& args);
-        void _coreFoundMatch(const IInspectable& sender, const Control::FoundResultsArgs& args);
+        winrt::fire_and_forget _coreFoundMatch(IInspectable sender, Control::FoundResultsArgs args);
+        winrt::fire_and_forget _coreSearchProgress(IInspectable sender, Control::FoundResultsArgs args);
 
         til::point _toPosInDips(const Core::Point terminalCellPos);
         void _throttledUpdateScrollbar(const ScrollBarUpdate& update);
+        void _updateScrollMarkPips(const double totalBufferRows);
     };
 }
 
@@ -35,6 +35,21 @@ static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& i
     return wstr;
 }
 
+// Calls func for each of the positions stored in the given mark.
+template<typename Mark, typename Func>
+static void _ForEachMarkPosition(Mark& mark, Func&& func)
+{
+    func(mark.start);
+    func(mark.end);
+    for (const auto position : { &mark.commandStart, &mark.outputStart, &mark.outputEnd })
+    {
+        if (position->has_value())
+        {
+            func(position->value());
+        }
+    }
+}
+
 #pragma warning(suppress : 26455) // default constructor is throwing, too much effort to rearrange at this time.
 Terminal::Terminal() :
     _mutableViewport{ Viewport::Empty() },
@@ -53,7 +68,11 @@ Terminal::Terminal() :
     _taskbarState{ 0 },
     _taskbarProgress{ 0 },
     _trimBlockSelection{ false },
-    _autoMarkPrompts{ false }
+    _autoMarkPrompts{ false },
+    _spillScrollbackToDisk{ false },
+    _predictiveEcho{ false },
+    _predictionRow{ 0 },
+    _predictionsSuspended{ false }
 {
     auto passAlongInput = [&](std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite) {
         if (!_pfnWriteInput)
@@ -127,6 +146,19 @@ void Terminal::UpdateSettings(ICoreSettings settings)
     _trimBlockSelection = settings.TrimBlockSelection();
     _autoMarkPrompts = settings.AutoMarkPrompts();
 
+    // The alt buffer doesn't have any scrollback that could be spilled.
+    _spillScrollbackToDisk = settings.SpillScrollbackToDisk();
+    if (_mainBuffer)
+    {
+        _mainBuffer->SetScrollbackSpill(_spillScrollbackToDisk);
+    }
+
+    _predictiveEcho = settings.PredictiveEcho();
+    if (!_predictiveEcho)
+    {
+        CancelPredictions();
+    }
+
     _terminalInput->ForceDisableWin32InputMode(settings.ForceVTInput());
 
     if (settings.TabColor() == nullptr)
@@ -250,6 +282,74 @@ void Terminal::EraseScrollback()
     engine.Dispatch().EraseInDisplay(DispatchTypes::EraseType::Scrollback);
 }
 
+// Method Description:
+// - Discards all but the last `keep` rows of the scrollback, like EraseScrollback
+//   does for all of them. Used to get rid of the bulk of an output flood.
+// - The caller must hold the write lock.
+// Arguments:
+// - keep: the number of rows of scrollback to keep
+// Return Value:
+// - <none>
+void Terminal::TrimScrollback(const til::CoordType keep)
+{
+    if (_inAltBuffer())
+    {
+        return;
+    }
+
+    const auto top = _mutableViewport.Top();
+    const auto discard = top - std::max(0, keep);
+    if (discard <= 0)
+    {
+        return;
+    }
+
+    auto& textBuffer = _activeBuffer();
+    const auto bufferSize = textBuffer.GetSize().Dimensions();
+    const auto remaining = bufferSize.Y - discard;
+    auto& cursor = textBuffer.GetCursor();
+
+    // Scroll everything from the first row we keep to the top of the buffer.
+    textBuffer.ScrollRows(discard, remaining, -discard);
+    // Clear what's left over at the bottom.
+    textBuffer.FillRect({ 0, remaining, bufferSize.X, bufferSize.Y }, L' ', {});
+    textBuffer.ResetLineRenditionRange(remaining, bufferSize.Y);
+    // These rows are all below the viewport and won't be written to until the
+    // output catches up with them. Don't let them hold on to a full row each.
+    textBuffer.FreezeRows(remaining, bufferSize.Y);
+
+    _mutableViewport = Viewport::FromDimensions({ 0, top - discard }, _mutableViewport.Dimensions());
+    cursor.SetYPosition(cursor.GetPosition().Y - discard);
+    cursor.SetHasMoved(true);
+    _scrollOffset = std::min(_scrollOffset, top - discard);
+
+    // The selection, the marks and the patterns all refer to rows that just moved.
+    _selection.reset();
+    _PruneScrollMarks(discard);
+    _patternIntervalTree = {};
+    _patternTreeVersion++;
+    _patternsGeneration = 0;
+
+    textBuffer.TriggerRedrawAll();
+    _NotifyScrollEvent();
+}
+
+// Method Description:
+// - Estimates the memory used by the text of the main and alternate buffer,
+//   see TextBuffer::GetMemoryFootprint.
+// - The caller must hold the read lock.
+// Return Value:
+// - the footprint in bytes
+size_t Terminal::GetMemoryFootprint() const noexcept
+{
+    auto bytes = _mainBuffer ? _mainBuffer->GetMemoryFootprint() : 0;
+    if (_altBuffer)
+    {
+        bytes += _altBuffer->GetMemoryFootprint();
+    }
+    return bytes;
+}
+
 bool Terminal::IsXtermBracketedPasteModeEnabled() const
 {
     return _bracketedPasteMode;
@@ -276,6 +376,9 @@ std::wstring_view Terminal::GetWorkingDirectory()
         return S_FALSE;
     }
 
+    // The predicted columns won't survive the reflow.
+    CancelPredictions();
+
     // Shortcut: if we're in the alt buffer, just resize the
     // alt buffer and put off resizing the main buffer till we switch back. Fortunately, this is easy. We don't need to
     // worry about the viewport and scrollback at all! The alt buffer never has
@@ -323,6 +426,7 @@ std::wstring_view Terminal::GetWorkingDirectory()
 
     // First allocate a new text buffer to take the place of the current one.
     std::unique_ptr<TextBuffer> newTextBuffer;
+    std::vector<til::point> markPositions;
     try
     {
         // GH#3848 - Stash away the current attributes the old text buffer is
@@ -337,6 +441,8 @@ std::wstring_view Terminal::GetWorkingDirectory()
                                                      _mainBuffer->IsActiveBuffer(),
                                                      _mainBuffer->GetRenderer());
 
+        newTextBuffer->SetScrollbackSpill(_spillScrollbackToDisk);
+
         // start defer drawing on the new buffer
         newTextBuffer->GetCursor().StartDeferDrawing();
 
@@ -354,6 +460,15 @@ std::wstring_view Terminal::GetWorkingDirectory()
         oldRows.mutableViewportTop = oldViewportTop;
         oldRows.visibleViewportTop = newVisibleTop;
 
+        // The marks have to stay on the same text, too.
+        for (const auto& m : _scrollMarks)
+        {
+            _ForEachMarkPosition(m, [&](const til::point& pos) {
+                markPositions.emplace_back(pos.x, pos.y - _scrollMarksOffset);
+            });
+        }
+        oldRows.positions = markPositions;
+
         const std::optional oldViewStart{ oldViewportTop };
         RETURN_IF_FAILED(TextBuffer::Reflow(*_mainBuffer.get(),
                                             *newTextBuffer.get(),
@@ -472,6 +587,11 @@ std::wstring_view Terminal::GetWorkingDirectory()
     _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
 
     _mainBuffer.swap(newTextBuffer);
+    try
+    {
+        _ReflowScrollMarks(markPositions);
+    }
+    CATCH_LOG();
 
     // GH#3494: Maintain scrollbar position during resize
     // Make sure that we don't scroll past the mutableViewport at the bottom of the buffer
@@ -497,12 +617,18 @@ std::wstring_view Terminal::GetWorkingDirectory()
 void Terminal::Write(std::wstring_view stringView)
 {
     auto lock = LockForWriting();
+    const auto locked = std::chrono::steady_clock::now();
 
     auto& cursor = _activeBuffer().GetCursor();
     const til::point cursorPosBefore{ cursor.GetPosition() };
 
     _stateMachine->ProcessString(stringView);
 
+    if (!_predictions.empty())
+    {
+        _ConfirmPredictions();
+    }
+
     const til::point cursorPosAfter{ cursor.GetPosition() };
 
     // Firing the CursorPositionChanged event is very expensive so we try not to
@@ -513,6 +639,186 @@ void Terminal::Write(std::wstring_view stringView)
     {
         _NotifyTerminalCursorPositionChanged();
     }
+
+    const auto held = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - locked);
+    _writeStatistics.writes++;
+    _writeStatistics.chars += stringView.size();
+    _writeStatistics.sequences = _stateMachine->GetSequenceCount();
+    _writeStatistics.lockHeldMicroseconds += held.count();
+}
+
+// Method Description:
+// - Returns how much output Write() has processed so far and how long it held
+//   the write lock for it. Only Write() changes these, so whoever calls Write()
+//   can read them without the lock. Everyone else needs to hold it.
+// Return Value:
+// - the statistics
+const Terminal::WriteStatistics& Terminal::GetWriteStatistics() const noexcept
+{
+    return _writeStatistics;
+}
+
+// Method Description:
+// - Predicts how the connected application is going to echo the given input
+//   and shows the prediction at the cursor, underlined, until the echo arrives.
+//   Over slow connections this makes typing feel as responsive as it is locally.
+// - Only the printable ASCII characters are predicted, since that's what shells echo
+//   verbatim. Backspaces undo predictions, a carriage return ends them, and any
+//   other control character cancels them. No predictions are made at all in the
+//   alternate screen buffer, where applications rarely echo anything at the cursor.
+// Arguments:
+// - text: The input that's about to be sent to the connection.
+void Terminal::PredictInput(std::wstring_view text)
+{
+    if (!_predictiveEcho)
+    {
+        return;
+    }
+
+    if (_inAltBuffer())
+    {
+        CancelPredictions();
+        return;
+    }
+
+    const auto& buffer = _activeBuffer();
+    const auto cursorPos = buffer.GetCursor().GetPosition();
+    const auto width = buffer.GetSize().Width();
+
+    // Output could have moved the cursor to another row since the last prediction.
+    if (cursorPos.y != _predictionRow)
+    {
+        CancelPredictions();
+        _predictionRow = cursorPos.y;
+    }
+
+    auto changed = false;
+
+    for (const auto ch : text)
+    {
+        if (ch == L'\r')
+        {
+            CancelPredictions();
+            _predictionsSuspended = false;
+        }
+        else if (ch == L'\b' || ch == L'\x7f')
+        {
+            // Erasing text that was already echoed isn't predicted. As long as
+            // the cursor hasn't moved back yet, predictions would be misplaced.
+            if (_predictions.empty())
+            {
+                _predictionsSuspended = true;
+            }
+            else
+            {
+                _predictions.pop_back();
+                changed = true;
+            }
+        }
+        else if (ch >= L' ' && ch < L'\x7f')
+        {
+            const auto column = _predictions.empty() ? cursorPos.x : _predictions.back().column + 1;
+            // Wrapping into the next row isn't predicted either.
+            if (!_predictionsSuspended && column < width)
+            {
+                _predictions.emplace_back(Prediction{ column, ch });
+                changed = true;
+            }
+        }
+        else
+        {
+            CancelPredictions();
+        }
+    }
+
+    if (changed)
+    {
+        _UpdatePredictionOverlay();
+    }
+}
+
+// Method Description:
+// - Discards all predictions made by PredictInput().
+void Terminal::CancelPredictions() noexcept
+{
+    if (_predictions.empty())
+    {
+        return;
+    }
+
+    _predictions.clear();
+    try
+    {
+        _UpdatePredictionOverlay();
+    }
+    CATCH_LOG();
+}
+
+// Method Description:
+// - Called after output was written to check the predictions against the echo.
+//   Every prediction the cursor has moved past is confirmed if its cell holds the
+//   predicted character. If it doesn't, the application does something else than
+//   echoing the input, so all predictions are discarded until the next prompt.
+void Terminal::_ConfirmPredictions()
+{
+    const auto& buffer = _activeBuffer();
+    const auto cursorPos = buffer.GetCursor().GetPosition();
+
+    // The input either started a full screen application or moved the cursor to another row.
+    // Either way, the remaining predictions were taken as something other than text for the prompt.
+    if (_inAltBuffer() || cursorPos.y != _predictionRow)
+    {
+        CancelPredictions();
+        return;
+    }
+
+    auto it = _predictions.begin();
+    for (; it != _predictions.end() && it->column < cursorPos.x; ++it)
+    {
+        if (*buffer.GetTextDataAt({ it->column, _predictionRow }) != std::wstring_view{ &it->ch, 1 })
+        {
+            CancelPredictions();
+            _predictionsSuspended = true;
+            return;
+        }
+    }
+
+    if (it != _predictions.begin())
+    {
+        _predictions.erase(_predictions.begin(), it);
+        _UpdatePredictionOverlay();
+    }
+}
+
+// Method Description:
+// - Rebuilds the row GetOverlays() returns for the predictions and invalidates it.
+//   The overlay is a copy of the prediction row, so that the parts of the row
+//   the renderer paints from it besides the predictions look just like the original.
+void Terminal::_UpdatePredictionOverlay()
+{
+    auto& buffer = _activeBuffer();
+    const auto width = buffer.GetSize().Width();
+
+    if (!_predictions.empty())
+    {
+        if (!_predictionBuffer || _predictionBuffer->GetSize().Width() != width)
+        {
+            _predictionBuffer = std::make_unique<TextBuffer>(til::size{ width, 1 }, TextAttribute{}, 0, false, buffer.GetRenderer());
+        }
+
+        auto& row = _predictionBuffer->GetRowByOffset(0);
+        THROW_IF_FAILED(row.CopyFrom(buffer.GetRowByOffset(_predictionRow)));
+
+        // The underline marks the predictions as tentative.
+        auto attributes = buffer.GetCurrentAttributes();
+        attributes.SetUnderlined(true);
+        for (const auto& prediction : _predictions)
+        {
+            row.FillCells(prediction.column, prediction.column + 1, prediction.ch, attributes);
+        }
+    }
+
+    buffer.TriggerRedraw(Viewport::FromDimensions({ 0, _predictionRow }, { width, 1 }));
 }
 
 void Terminal::WritePastedText(std::wstring_view stringView)
@@ -647,6 +953,82 @@ std::optional<PointTree::interval> Terminal::GetHyperlinkIntervalFromViewportPos
     return std::nullopt;
 }
 
+// Method description:
+// - Gets a snapshot of the state that the hyperlink spans of the given viewport
+//   row depend on. Callers can compare them to find out whether spans they got
+//   from GetHyperlinkSpansInViewportRow are still valid.
+// Arguments:
+// - The row relative to the viewport
+// Return value:
+// - The stamp for the row
+Terminal::HyperlinkRowStamp Terminal::GetHyperlinkRowStamp(const til::CoordType viewportRow) const noexcept
+{
+    const auto& buffer = _activeBuffer();
+    const auto bufferRow = std::clamp(_VisibleStartIndex() + viewportRow, 0, buffer.GetSize().BottomInclusive());
+    return { &buffer, bufferRow, buffer.GetRowByOffset(bufferRow).GetGeneration(), _patternTreeVersion };
+}
+
+// Method description:
+// - Splits the given viewport row into runs of cells for which
+//   GetHyperlinkIdAtViewportPosition and GetHyperlinkIntervalFromViewportPosition
+//   return the same result. This allows the hover logic to look up the
+//   hyperlink under the mouse without querying the buffer for every cell.
+// Arguments:
+// - The row relative to the viewport
+// Return value:
+// - The spans, in order, covering the entire width of the row
+std::vector<Terminal::HyperlinkSpan> Terminal::GetHyperlinkSpansInViewportRow(const til::CoordType viewportRow) const
+{
+    const auto& buffer = _activeBuffer();
+    const auto bufferRow = std::clamp(_VisibleStartIndex() + viewportRow, 0, buffer.GetSize().BottomInclusive());
+    const auto width = buffer.GetSize().Width();
+
+    // Every interval that GetHyperlinkIntervalFromViewportPosition could return for this row.
+    const auto candidates = _patternIntervalTree.findOverlapping({ std::min(1, width - 1), viewportRow }, { width - 1, viewportRow });
+    const auto intervalAt = [&](const til::CoordType x) -> std::optional<PointTree::interval> {
+        const til::point pos{ x, viewportRow };
+        const til::point next{ x + 1, viewportRow };
+        for (const auto& candidate : candidates)
+        {
+            if (candidate.value == _hyperlinkPatternId && candidate.start <= pos && candidate.stop >= next)
+            {
+                return candidate;
+            }
+        }
+        return std::nullopt;
+    };
+
+    std::vector<HyperlinkSpan> spans;
+    til::CoordType x = 0;
+    buffer.GetRowByOffset(bufferRow).GetAttrRow().ForEachRun(0, width, [&](const TextAttribute& attr, const uint16_t length) {
+        const auto id = attr.GetHyperlinkId();
+        for (const auto end = x + length; x < end; ++x)
+        {
+            auto interval = intervalAt(x);
+            if (!spans.empty() && spans.back().id == id && spans.back().interval == interval)
+            {
+                spans.back().right = x;
+            }
+            else
+            {
+                spans.push_back({ x, x, id, std::move(interval) });
+            }
+        }
+    });
+    return spans;
+}
+
+// Method Description:
+// - Invalidates the cells of the given pattern interval, for instance
+//   because it started or stopped being rendered as hovered.
+// Arguments:
+// - The interval, in viewport coordinates
+void Terminal::InvalidatePatternInterval(const PointTree::interval& interval)
+{
+    const auto vis = _VisibleStartIndex();
+    _InvalidateFromCoords({ interval.start.x, interval.start.y + vis }, { interval.stop.x, interval.stop.y + vis });
+}
+
 // Method Description:
 // - Send this particular (non-character) key event to the terminal.
 // - The terminal will translate the key and the modifiers pressed into the
@@ -828,13 +1210,9 @@ void Terminal::FocusChanged(const bool focused) noexcept
 // - The interval tree containing regions that need to be invalidated
 void Terminal::_InvalidatePatternTree(interval_tree::IntervalTree<til::point, size_t>& tree)
 {
-    const auto vis = _VisibleStartIndex();
-    auto invalidate = [=](const PointTree::interval& interval) {
-        til::point startCoord{ interval.start.x, interval.start.y + vis };
-        til::point endCoord{ interval.stop.x, interval.stop.y + vis };
-        _InvalidateFromCoords(startCoord, endCoord);
-    };
-    tree.visit_all(invalidate);
+    tree.visit_all([this](const PointTree::interval& interval) {
+        InvalidatePatternInterval(interval);
+    });
 }
 
 // Method Description:
@@ -978,19 +1356,15 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 }
 
 // Method Description:
-// - Acquire a read lock on the terminal.
+// - Acquire a read lock on the terminal. Any number of readers (the renderer,
+//   UIA, searches, ...) can hold it at the same time. _lastLocker is only
+//   tracked for writers, as concurrent readers would race on it.
 // Return Value:
 // - a shared_lock which can be used to unlock the terminal. The shared_lock
 //      will release this lock when it's destructed.
-[[nodiscard]] std::unique_lock<til::ticket_lock> Terminal::LockForReading()
+[[nodiscard]] std::shared_lock<til::shared_ticket_lock> Terminal::LockForReading()
 {
-#ifdef NDEBUG
-    return std::unique_lock{ _readWriteLock };
-#else
-    auto lock = std::unique_lock{ _readWriteLock };
-    _lastLocker = GetCurrentThreadId();
-    return lock;
-#endif
+    return std::shared_lock{ _readWriteLock };
 }
 
 // Method Description:
@@ -998,7 +1372,7 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 // Return Value:
 // - a unique_lock which can be used to unlock the terminal. The unique_lock
 //      will release this lock when it's destructed.
-[[nodiscard]] std::unique_lock<til::ticket_lock> Terminal::LockForWriting()
+[[nodiscard]] std::unique_lock<til::shared_ticket_lock> Terminal::LockForWriting()
 {
 #ifdef NDEBUG
     return std::unique_lock{ _readWriteLock };
@@ -1012,8 +1386,8 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 // Method Description:
 // - Get a reference to the terminal's read/write lock.
 // Return Value:
-// - a ticket_lock which can be used to manually lock or unlock the terminal.
-til::ticket_lock& Terminal::GetReadWriteLock() noexcept
+// - a shared_ticket_lock which can be used to manually lock or unlock the terminal.
+til::shared_ticket_lock& Terminal::GetReadWriteLock() noexcept
 {
     return _readWriteLock;
 }
@@ -1084,45 +1458,34 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
     // We can not waste time displaying a cursor event when we know more text is coming right behind it.
     cursor.StartDeferDrawing();
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    // The string is written a row segment at a time: WriteLine() writes as much of the
+    // remaining text as fits into the rest of the cursor's row and the cursor is then
+    // adjusted once for the entire segment, instead of once for every single character.
+    for (size_t i = 0; i < stringView.size();)
     {
-        const auto wch = stringView.at(i);
-        const auto cursorPosBefore = cursor.GetPosition();
-        auto proposedCursorPosition = cursorPosBefore;
+        auto proposedCursorPosition = cursor.GetPosition();
 
-        // TODO: MSFT 21006766
-        // This is not great but I need it demoable. Fix by making a buffer stream writer.
-        //
-        // If wch is a surrogate character we need to read 2 code units
-        // from the stringView to form a single code point.
-        const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
-        const auto view = stringView.substr(i, isSurrogate ? 2 : 1);
-        const OutputCellIterator it{ view, _activeBuffer().GetCurrentAttributes() };
-        const auto end = _activeBuffer().Write(it);
+        // OutputCellIterator only consumes (and measures) as many characters as
+        // WriteLine() can fit into the row, so passing the entire remainder is cheap.
+        const OutputCellIterator it{ stringView.substr(i), _activeBuffer().GetCurrentAttributes() };
+        const auto end = _activeBuffer().WriteLine(it, proposedCursorPosition);
         const auto cellDistance = end.GetCellDistance(it);
         const auto inputDistance = end.GetInputDistance(it);
 
         if (inputDistance > 0)
         {
-            // If "wch" was a surrogate character, we just consumed 2 code units above.
-            // -> Increment "i" by 1 in that case and thus by 2 in total in this iteration.
             proposedCursorPosition.X += cellDistance;
-            i += inputDistance - 1;
+            i += inputDistance;
         }
         else
         {
-            // If _WriteBuffer() is called with a consecutive string longer than the viewport/buffer width
-            // the call to _buffer->Write() will refuse to write anything on the current line.
-            // GetInputDistance() thus returns 0, which would in turn cause i to be
-            // decremented by 1 below and force the outer loop to loop forever.
-            // This if() basically behaves as if "\r\n" had been encountered above and retries the write.
+            // WriteLine() refuses to write anything if the cursor is past the end of the row, or if the
+            // next glyph is wide and doesn't fit into the last column anymore (which it pads instead).
+            // This if() basically behaves as if "\r\n" had been encountered and retries the write on the next row.
             // With well behaving shells during normal operation this safeguard should normally not be encountered.
             proposedCursorPosition.X = 0;
             proposedCursorPosition.Y++;
 
-            // Try the character again.
-            i--;
-
             // If we write the last cell of the row here, TextBuffer::Write will
             // mark this line as wrapped for us. If the next character we
             // process is a newline, the Terminal::CursorLineFeed will unmark
@@ -1192,6 +1555,8 @@ void Terminal::_AdjustCursorPosition(const til::point proposedPosition)
 
         // manually erase our pattern intervals since the locations have changed now
         _patternIntervalTree = {};
+        _patternTreeVersion++;
+        _patternsGeneration = 0;
     }
 
     // Update Cursor Position
@@ -1246,17 +1611,7 @@ void Terminal::_AdjustCursorPosition(const til::point proposedPosition)
 
     if (rowsPushedOffTopOfBuffer != 0)
     {
-        if (_scrollMarks.size() > 0)
-        {
-            for (auto& mark : _scrollMarks)
-            {
-                mark.start.y -= rowsPushedOffTopOfBuffer;
-            }
-            _scrollMarks.erase(std::remove_if(_scrollMarks.begin(),
-                                              _scrollMarks.end(),
-                                              [](const VirtualTerminal::DispatchTypes::ScrollMark& m) { return m.start.y < 0; }),
-                               _scrollMarks.end());
-        }
+        _PruneScrollMarks(rowsPushedOffTopOfBuffer);
         // We have to report the delta here because we might have circled the text buffer.
         // That didn't change the viewport and therefore the TriggerScroll(void)
         // method can't detect the delta on its own.
@@ -1404,10 +1759,31 @@ bool Terminal::IsCursorBlinkingAllowed() const noexcept
 // - INVARIANT: this function can only be called if the caller has the writing lock on the terminal
 void Terminal::UpdatePatternsUnderLock() noexcept
 {
+    const auto& buffer = _activeBuffer();
+    const auto visibleStart = _VisibleStartIndex();
+    const auto visibleEnd = _VisibleEndIndex();
+
+    // If the same rows are visible and none of them changed, the patterns
+    // are still where they were and nothing needs to be invalidated.
+    if (_patternsGeneration != 0 &&
+        &buffer == _patternsBuffer &&
+        visibleStart == _patternsVisibleStart &&
+        visibleEnd == _patternsVisibleEnd &&
+        !buffer.WereRowsModifiedSince(visibleStart, visibleEnd, _patternsGeneration))
+    {
+        return;
+    }
+
     auto oldTree = _patternIntervalTree;
-    _patternIntervalTree = _activeBuffer().GetPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _patternIntervalTree = buffer.GetPatterns(visibleStart, visibleEnd);
+    _patternTreeVersion++;
     _InvalidatePatternTree(oldTree);
     _InvalidatePatternTree(_patternIntervalTree);
+
+    _patternsGeneration = ROW::s_GetLatestGeneration();
+    _patternsBuffer = &buffer;
+    _patternsVisibleStart = visibleStart;
+    _patternsVisibleEnd = visibleEnd;
 }
 
 // Method Description:
@@ -1418,6 +1794,8 @@ void Terminal::ClearPatternTree() noexcept
 {
     auto oldTree = _patternIntervalTree;
     _patternIntervalTree = {};
+    _patternTreeVersion++;
+    _patternsGeneration = 0;
     _InvalidatePatternTree(oldTree);
 }
 
@@ -1532,7 +1910,8 @@ void Terminal::_updateUrlDetection()
     {
         // Add regex pattern recognizers to the buffer
         // For now, we only add the URI regex pattern
-        _hyperlinkPatternId = _activeBuffer().AddPatternRecognizer(linkPattern);
+        _hyperlinkPatternId = _activeBuffer().AddPatternRecognizer(TextBuffer::UrlPattern);
+        _patternsGeneration = 0;
         UpdatePatternsUnderLock();
     }
     else
@@ -1553,8 +1932,20 @@ void Terminal::AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes:
     DispatchTypes::ScrollMark m = mark;
     m.start = start;
     m.end = end;
-
-    _scrollMarks.push_back(m);
+    _ForEachMarkPosition(m, [&](til::point& pos) {
+        pos = _StoreScrollMarkPosition(pos);
+    });
+
+    // Marks are almost always added below all the others, at the cursor, which makes this an append.
+    const auto it = std::upper_bound(_scrollMarks.begin(), _scrollMarks.end(), m.start, [](const til::point& pos, const auto& other) {
+        return pos < other.start;
+    });
+    _scrollMarks.insert(it, m);
+    _scrollMarksMaxHeight = std::max(_scrollMarksMaxHeight, std::abs(end.y - start.y));
+    if (m.exitCode.value_or(0) != 0)
+    {
+        _AddFailedCommand(m.start);
+    }
 
     // Tell the control that the scrollbar has somehow changed. Used as a
     // workaround to force the control to redraw any scrollbar marks
@@ -1576,13 +1967,29 @@ void Terminal::ClearMark()
         end = til::point{ GetSelectionEnd() };
     }
 
-    _scrollMarks.erase(std::remove_if(_scrollMarks.begin(),
-                                      _scrollMarks.end(),
-                                      [&start, &end](const auto& m) {
-                                          return (m.start >= start && m.start <= end) ||
-                                                 (m.end >= start && m.end <= end);
-                                      }),
-                       _scrollMarks.end());
+    start.y += _scrollMarksOffset;
+    end.y += _scrollMarksOffset;
+
+    // Only marks that start no further than _scrollMarksMaxHeight rows away
+    // from the range can start or end within it.
+    const auto first = std::lower_bound(_scrollMarks.begin(), _scrollMarks.end(), start.y - _scrollMarksMaxHeight, [](const auto& m, const til::CoordType row) {
+        return m.start.y < row;
+    });
+    const auto last = std::upper_bound(first, _scrollMarks.end(), end.y + _scrollMarksMaxHeight, [](const til::CoordType row, const auto& m) {
+        return row < m.start.y;
+    });
+    const auto intersects = [&start, &end](const auto& m) {
+        return (m.start >= start && m.start <= end) ||
+               (m.end >= start && m.end <= end);
+    };
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->exitCode.value_or(0) != 0 && intersects(*it))
+        {
+            _RemoveFailedCommand(it->start);
+        }
+    }
+    _scrollMarks.erase(std::remove_if(first, last, intersects), last);
 
     // Tell the control that the scrollbar has somehow changed. Used as a
     // workaround to force the control to redraw any scrollbar marks
@@ -1591,19 +1998,464 @@ void Terminal::ClearMark()
 void Terminal::ClearAllMarks()
 {
     _scrollMarks.clear();
+    _failedCommands.clear();
+    _scrollMarksOffset = 0;
+    _scrollMarksMaxHeight = 0;
     // Tell the control that the scrollbar has somehow changed. Used as a
     // workaround to force the control to redraw any scrollbar marks
     _NotifyScrollEvent();
 }
 
-const std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark>& Terminal::GetScrollMarks() const
+// Method Description:
+// - Creates a binary snapshot of the main buffer's contents and marks, which
+//   can be restored with RestoreBuffer(), for instance after a restart.
+//   Everything up to the last line of text or the cursor (whichever is
+//   further down) is stored, see TextBuffer::Serialize().
+// Return Value:
+// - the snapshot
+std::vector<std::byte> Terminal::SerializeBuffer() const
+{
+    const auto viewportBottom = _mutableViewport.BottomInclusive();
+    const auto lastText = _mainBuffer->GetLastNonSpaceCharacter(Viewport::FromInclusive({ 0, 0, 0, viewportBottom }));
+    const auto cursor = _mainBuffer->GetCursor().GetPosition();
+    const auto rowCount = std::min(std::max(lastText.y, cursor.y), viewportBottom) + 1;
+
+    std::vector<std::byte> snapshot;
+    _mainBuffer->Serialize(snapshot, rowCount);
+
+    SnapshotWriter writer{ snapshot };
+    const auto marks = GetScrollMarks();
+    const auto writePoint = [&](const til::point& pos) {
+        writer.Write(pos.x);
+        writer.Write(pos.y);
+    };
+    const auto writeOptionalPoint = [&](const std::optional<til::point>& pos) {
+        writer.Write(pos.has_value());
+        writePoint(pos.value_or(til::point{}));
+    };
+
+    writer.Write(gsl::narrow<uint32_t>(std::count_if(marks.begin(), marks.end(), [&](const auto& m) { return m.start.y < rowCount; })));
+    for (const auto& m : marks)
+    {
+        if (m.start.y >= rowCount)
+        {
+            continue;
+        }
+        writer.Write(m.color.has_value());
+        writer.Write(m.color.value_or(til::color{}));
+        writePoint(m.start);
+        writePoint(m.end);
+        writer.Write(gsl::narrow_cast<uint32_t>(m.category));
+        writeOptionalPoint(m.commandStart);
+        writeOptionalPoint(m.outputStart);
+        writeOptionalPoint(m.outputEnd);
+        writer.Write(m.exitCode.has_value());
+        writer.Write(m.exitCode.value_or(0u));
+    }
+
+    return snapshot;
+}
+
+// Method Description:
+// - Restores a snapshot created by SerializeBuffer() into the main buffer, which
+//   should still be blank. The restored contents end up in the scrollback and
+//   the viewport is moved below them, so that new output starts on a clean screen.
+// Arguments:
+// - snapshot - the snapshot
+// Return Value:
+// - false if the snapshot is malformed, in which case the buffer is cleared again
+bool Terminal::RestoreBuffer(const std::span<const std::byte> snapshot)
+{
+    SnapshotReader reader{ snapshot };
+    // Leave enough room below the restored rows for a viewport.
+    const auto viewportSize = _mutableViewport.Dimensions();
+    const auto maxRows = _mainBuffer->TotalRowCount() - viewportSize.height;
+    const auto info = _mainBuffer->Deserialize(reader, maxRows);
+    if (!info)
+    {
+        _mainBuffer->Reset();
+        _mainBuffer->TriggerRedrawAll();
+        return false;
+    }
+
+    const auto readPoint = [&](til::point& pos) {
+        return reader.Read(pos.x) && reader.Read(pos.y);
+    };
+    const auto readOptionalPoint = [&](std::optional<til::point>& pos) {
+        auto hasValue = false;
+        til::point value;
+        if (!reader.Read(hasValue) || !readPoint(value))
+        {
+            return false;
+        }
+        pos = hasValue ? std::optional{ value } : std::nullopt;
+        return true;
+    };
+
+    // The marks are optional: if they're missing or malformed, we still keep the text.
+    uint32_t markCount = 0;
+    if (reader.Read(markCount))
+    {
+        for (uint32_t i = 0; i < markCount; ++i)
+        {
+            DispatchTypes::ScrollMark m;
+            auto hasColor = false;
+            til::color color;
+            uint32_t category = 0;
+            auto hasExitCode = false;
+            unsigned int exitCode = 0;
+            if (!reader.Read(hasColor) || !reader.Read(color) ||
+                !readPoint(m.start) || !readPoint(m.end) ||
+                !reader.Read(category) ||
+                !readOptionalPoint(m.commandStart) || !readOptionalPoint(m.outputStart) || !readOptionalPoint(m.outputEnd) ||
+                !reader.Read(hasExitCode) || !reader.Read(exitCode))
+            {
+                break;
+            }
+            m.color = hasColor ? std::optional{ color } : std::nullopt;
+            m.category = static_cast<DispatchTypes::MarkCategory>(std::min<uint32_t>(category, static_cast<uint32_t>(DispatchTypes::MarkCategory::Prompt)));
+            m.exitCode = hasExitCode ? std::optional{ exitCode } : std::nullopt;
+
+            _ForEachMarkPosition(m, [&](til::point& pos) {
+                pos.y -= info->skippedRows;
+            });
+            if (m.start.y >= 0 && m.end.y < info->rows)
+            {
+                AddMark(m, m.start, m.end);
+            }
+        }
+    }
+
+    const auto cursorRow = info->cursor.y - info->skippedRows;
+    const auto top = std::clamp(std::max(info->rows, cursorRow + 1), 0, maxRows);
+    _mutableViewport = Viewport::FromDimensions({ 0, top }, viewportSize);
+    _mainBuffer->GetCursor().SetPosition({ 0, top });
+    _scrollOffset = 0;
+
+    _NotifyScrollEvent();
+    _mainBuffer->TriggerRedrawAll();
+    return true;
+}
+
+std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> Terminal::GetScrollMarks() const
 {
     // TODO: GH#11000 - when the marks are stored per-buffer, get rid of this.
     // We want to return _no_ marks when we're in the alt buffer, to effectively
-    // hide them. We need to return a reference, so we can't just ctor an empty
-    // list here just for when we're in the alt buffer.
-    static std::vector<DispatchTypes::ScrollMark> _altBufferMarks{};
-    return _inAltBuffer() ? _altBufferMarks : _scrollMarks;
+    // hide them.
+    std::vector<DispatchTypes::ScrollMark> marks;
+    if (!_inAltBuffer())
+    {
+        marks.reserve(_scrollMarks.size());
+        for (const auto& m : _scrollMarks)
+        {
+            marks.emplace_back(_LoadScrollMark(m));
+        }
+    }
+    return marks;
+}
+
+// Method Description:
+// - Finds the closest mark that starts above the given row.
+// Arguments:
+// - row: the row of the buffer to search from
+// Return Value:
+// - the mark, or nullopt if there is none (or we're in the alt buffer)
+std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> Terminal::GetScrollMarkBefore(const til::CoordType row) const
+{
+    if (_inAltBuffer())
+    {
+        return std::nullopt;
+    }
+
+    const auto stored = int64_t{ row } + _scrollMarksOffset;
+    const auto it = std::lower_bound(_scrollMarks.begin(), _scrollMarks.end(), stored, [](const auto& m, const int64_t r) {
+        return m.start.y < r;
+    });
+    if (it == _scrollMarks.begin())
+    {
+        return std::nullopt;
+    }
+    return _LoadScrollMark(*std::prev(it));
+}
+
+// Method Description:
+// - Finds the closest mark that starts below the given row.
+// Arguments:
+// - row: the row of the buffer to search from
+// Return Value:
+// - the mark, or nullopt if there is none (or we're in the alt buffer)
+std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> Terminal::GetScrollMarkAfter(const til::CoordType row) const
+{
+    if (_inAltBuffer())
+    {
+        return std::nullopt;
+    }
+
+    const auto stored = int64_t{ row } + _scrollMarksOffset;
+    const auto it = std::upper_bound(_scrollMarks.begin(), _scrollMarks.end(), stored, [](const int64_t r, const auto& m) {
+        return r < m.start.y;
+    });
+    if (it == _scrollMarks.end())
+    {
+        return std::nullopt;
+    }
+    return _LoadScrollMark(*it);
+}
+
+// Method Description:
+// - Moves the marks up along with the buffer contents and drops the
+//   ones that were pushed off the top of the buffer.
+// Arguments:
+// - rowsPushedOffTopOfBuffer: the number of rows the buffer circled by
+void Terminal::_PruneScrollMarks(const til::CoordType rowsPushedOffTopOfBuffer)
+{
+    _scrollMarksOffset += rowsPushedOffTopOfBuffer;
+
+    while (!_scrollMarks.empty() && _scrollMarks.front().start.y < _scrollMarksOffset)
+    {
+        _scrollMarks.pop_front();
+    }
+    while (!_failedCommands.empty() && _failedCommands.front().y < _scrollMarksOffset)
+    {
+        _failedCommands.pop_front();
+    }
+
+    if (_scrollMarks.empty())
+    {
+        _scrollMarksOffset = 0;
+    }
+    else if (_scrollMarksOffset > std::numeric_limits<til::CoordType>::max() / 2)
+    {
+        // The marks left are all within the buffer, so moving them back to an offset
+        // of 0 keeps their rows from overflowing during a very long session.
+        for (auto& m : _scrollMarks)
+        {
+            m = _LoadScrollMark(m);
+        }
+        for (auto& pos : _failedCommands)
+        {
+            pos.y -= _scrollMarksOffset;
+        }
+        _scrollMarksOffset = 0;
+    }
+}
+
+// Method Description:
+// - Converts a mark from the way it's stored in _scrollMarks into one with rows of the buffer.
+Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark Terminal::_LoadScrollMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& stored) const noexcept
+{
+    auto m = stored;
+    _ForEachMarkPosition(m, [&](til::point& pos) {
+        pos.y -= _scrollMarksOffset;
+    });
+    return m;
+}
+
+// Method Description:
+// - Converts a position in the buffer into the way marks store it in _scrollMarks.
+til::point Terminal::_StoreScrollMarkPosition(const til::point pos) const noexcept
+{
+    return { pos.x, pos.y + _scrollMarksOffset };
+}
+
+// Method Description:
+// - Records that the command of the mark that starts at the given (stored) position failed.
+void Terminal::_AddFailedCommand(const til::point start)
+{
+    const auto it = std::upper_bound(_failedCommands.begin(), _failedCommands.end(), start);
+    _failedCommands.insert(it, start);
+}
+
+// Method Description:
+// - Forgets one failed command of a mark that starts at the given (stored) position.
+void Terminal::_RemoveFailedCommand(const til::point start)
+{
+    if (const auto it = std::lower_bound(_failedCommands.begin(), _failedCommands.end(), start); it != _failedCommands.end() && *it == start)
+    {
+        _failedCommands.erase(it);
+    }
+}
+
+// Method Description:
+// - Returns the mark shell integration is currently filling in, for the
+//   MarkCommandStart/MarkOutputStart/MarkCommandFinish sequences: the last one
+//   that starts before the cursor. If the shell didn't mark its prompt, or that
+//   mark already has the part that's about to be set, a new prompt mark is
+//   started at the cursor.
+// Arguments:
+// - part: the part of the mark that's about to be set
+// Return Value:
+// - the mark, nullptr in the alt buffer
+Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark* Terminal::_GetCurrentCommandMark(std::optional<til::point> DispatchTypes::ScrollMark::*part)
+{
+    if (_inAltBuffer())
+    {
+        return nullptr;
+    }
+
+    const til::point cursor{ _activeBuffer().GetCursor().GetPosition() };
+    const auto storedCursor = _StoreScrollMarkPosition(cursor);
+    const auto findCurrent = [&]() {
+        return std::upper_bound(_scrollMarks.begin(), _scrollMarks.end(), storedCursor, [](const til::point& pos, const auto& m) {
+            return pos < m.start;
+        });
+    };
+
+    auto it = findCurrent();
+    if (it == _scrollMarks.begin() || (std::prev(it)->*part).has_value())
+    {
+        DispatchTypes::ScrollMark mark;
+        mark.category = DispatchTypes::MarkCategory::Prompt;
+        AddMark(mark, cursor, cursor);
+        it = findCurrent();
+    }
+    return &*std::prev(it);
+}
+
+// Method Description:
+// - Finds the closest mark below the given row whose command failed.
+// Arguments:
+// - row: the row of the buffer to search from
+// Return Value:
+// - the mark, or nullopt if there is none (or we're in the alt buffer)
+std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> Terminal::GetFailedCommandAfter(const til::CoordType row) const
+{
+    if (_inAltBuffer())
+    {
+        return std::nullopt;
+    }
+
+    const auto stored = int64_t{ row } + _scrollMarksOffset;
+    const auto failed = std::upper_bound(_failedCommands.begin(), _failedCommands.end(), stored, [](const int64_t r, const til::point& pos) {
+        return r < pos.y;
+    });
+    if (failed == _failedCommands.end())
+    {
+        return std::nullopt;
+    }
+
+    const auto it = std::lower_bound(_scrollMarks.begin(), _scrollMarks.end(), *failed, [](const auto& m, const til::point& pos) {
+        return m.start < pos;
+    });
+    if (it == _scrollMarks.end())
+    {
+        return std::nullopt;
+    }
+    return _LoadScrollMark(*it);
+}
+
+// Method Description:
+// - Finds the output of the command of the given mark. Unless the shell marked the end of
+//   the output, it's considered to end where the next mark starts, or at the cursor.
+// Arguments:
+// - index: the index of the mark in GetScrollMarks()
+// Return Value:
+// - the start and end (exclusive) of the output in the buffer, or nullopt if the mark has none
+std::optional<std::pair<til::point, til::point>> Terminal::GetCommandOutput(const size_t index) const
+{
+    if (_inAltBuffer() || index >= _scrollMarks.size())
+    {
+        return std::nullopt;
+    }
+
+    const auto& mark = til::at(_scrollMarks, index);
+    if (!mark.outputStart.has_value())
+    {
+        return std::nullopt;
+    }
+
+    const auto start = *mark.outputStart;
+    auto end = _StoreScrollMarkPosition(til::point{ _activeBuffer().GetCursor().GetPosition() });
+    if (mark.outputEnd.has_value())
+    {
+        end = *mark.outputEnd;
+    }
+    else if (index + 1 < _scrollMarks.size())
+    {
+        end = til::at(_scrollMarks, index + 1).start;
+    }
+
+    if (end <= start)
+    {
+        return std::nullopt;
+    }
+    return std::pair{ til::point{ start.x, start.y - _scrollMarksOffset }, til::point{ end.x, end.y - _scrollMarksOffset } };
+}
+
+// Method Description:
+// - Selects the output of the command of the given mark, see GetCommandOutput().
+// Arguments:
+// - index: the index of the mark in GetScrollMarks()
+// Return Value:
+// - true if the mark has any output to select
+bool Terminal::SelectCommandOutput(const size_t index)
+{
+    const auto output = GetCommandOutput(index);
+    if (!output.has_value())
+    {
+        return false;
+    }
+
+    // The selection includes its end.
+    auto end = output->second;
+    _activeBuffer().GetSize().DecrementInBounds(end);
+    SelectNewRegion(output->first, end);
+    return true;
+}
+
+// Method Description:
+// - Returns the text of the output of the last command that has any, see GetCommandOutput().
+// Return Value:
+// - the text, empty if no command has any output
+std::wstring Terminal::GetLastCommandOutput() const
+{
+    for (auto index = _scrollMarks.size(); index-- > 0;)
+    {
+        if (const auto output = GetCommandOutput(index))
+        {
+            auto end = output->second;
+            _activeBuffer().GetSize().DecrementInBounds(end);
+
+            const auto rects = _activeBuffer().GetTextRects(output->first, end, false, true);
+            std::wstring text;
+            for (const auto& line : _activeBuffer().GetText(true, true, rects).text)
+            {
+                text += line;
+            }
+            return text;
+        }
+    }
+    return {};
+}
+
+// Method Description:
+// - Moves the marks to where their positions ended up after the buffer was reflowed.
+// Arguments:
+// - positions: the positions of the marks, in the order _ForEachMarkPosition enumerates
+//   them, as TextBuffer::Reflow() returned them. Marks whose start is gone are dropped.
+void Terminal::_ReflowScrollMarks(const std::span<const til::point> positions)
+{
+    auto next = positions.begin();
+    for (auto& m : _scrollMarks)
+    {
+        _ForEachMarkPosition(m, [&](til::point& pos) {
+            pos = *next++;
+        });
+    }
+    _scrollMarksOffset = 0;
+
+    std::erase_if(_scrollMarks, [](const auto& m) { return m.start.y < 0; });
+
+    _failedCommands.clear();
+    _scrollMarksMaxHeight = 0;
+    for (const auto& m : _scrollMarks)
+    {
+        _scrollMarksMaxHeight = std::max(_scrollMarksMaxHeight, std::abs(m.end.y - m.start.y));
+        if (m.exitCode.value_or(0) != 0)
+        {
+            _failedCommands.emplace_back(m.start);
+        }
+    }
 }
 
 til::color Terminal::GetColorForMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& mark) const
@@ -19,7 +19,6 @@
 
 #include <til/ticket_lock.h>
 
-static constexpr std::wstring_view linkPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
 static constexpr size_t TaskbarMinProgress{ 10 };
 
 // You have to forward decl the ICoreSettings here, instead of including the header.
@@ -81,18 +80,35 @@ public:
     void SetFontInfo(const FontInfo& fontInfo);
     void SetCursorStyle(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::CursorStyle cursorStyle);
     void EraseScrollback();
+    void TrimScrollback(const til::CoordType keep);
+    size_t GetMemoryFootprint() const noexcept;
     bool IsXtermBracketedPasteModeEnabled() const;
     std::wstring_view GetWorkingDirectory();
 
     // Write comes from the PTY and goes to our parser to be stored in the output buffer
     void Write(std::wstring_view stringView);
 
+    // How much output Write() has processed so far.
+    struct WriteStatistics
+    {
+        uint64_t writes = 0;
+        uint64_t chars = 0;
+        uint64_t sequences = 0;
+        uint64_t lockHeldMicroseconds = 0;
+    };
+    const WriteStatistics& GetWriteStatistics() const noexcept;
+
     // WritePastedText comes from our input and goes back to the PTY's input channel
     void WritePastedText(std::wstring_view stringView);
 
-    [[nodiscard]] std::unique_lock<til::ticket_lock> LockForReading();
-    [[nodiscard]] std::unique_lock<til::ticket_lock> LockForWriting();
-    til::ticket_lock& GetReadWriteLock() noexcept;
+    // PredictInput shows input at the cursor before the connection echoes it, if PredictiveEcho is enabled.
+    // Both of these have to be called with the write lock held.
+    void PredictInput(std::wstring_view text);
+    void CancelPredictions() noexcept;
+
+    [[nodiscard]] std::shared_lock<til::shared_ticket_lock> LockForReading();
+    [[nodiscard]] std::unique_lock<til::shared_ticket_lock> LockForWriting();
+    til::shared_ticket_lock& GetReadWriteLock() noexcept;
 
     til::CoordType GetBufferHeight() const noexcept;
 
@@ -102,11 +118,21 @@ public:
     RenderSettings& GetRenderSettings() noexcept { return _renderSettings; };
     const RenderSettings& GetRenderSettings() const noexcept { return _renderSettings; };
 
-    const std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark>& GetScrollMarks() const;
+    std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> GetScrollMarks() const;
+    til::CoordType GetScrollMarksOffset() const noexcept { return _scrollMarksOffset; };
+    std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> GetScrollMarkBefore(const til::CoordType row) const;
+    std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> GetScrollMarkAfter(const til::CoordType row) const;
+    std::optional<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> GetFailedCommandAfter(const til::CoordType row) const;
+    std::optional<std::pair<til::point, til::point>> GetCommandOutput(const size_t index) const;
+    bool SelectCommandOutput(const size_t index);
+    std::wstring GetLastCommandOutput() const;
     void AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& mark,
                  const til::point& start,
                  const til::point& end);
 
+    std::vector<std::byte> SerializeBuffer() const;
+    bool RestoreBuffer(const std::span<const std::byte> snapshot);
+
 #pragma region ITerminalApi
     // These methods are defined in TerminalApi.cpp
     void PrintString(const std::wstring_view string) override;
@@ -136,6 +162,9 @@ public:
     void UseMainScreenBuffer() override;
 
     void AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& mark) override;
+    void MarkCommandStart() override;
+    void MarkOutputStart() override;
+    void MarkCommandFinish(const std::optional<unsigned int> exitCode) override;
 
     bool IsConsolePty() const override;
     bool IsVtInputEnabled() const override;
@@ -166,6 +195,31 @@ public:
     std::wstring GetHyperlinkAtBufferPosition(const til::point bufferPos);
     uint16_t GetHyperlinkIdAtViewportPosition(const til::point viewportPos);
     std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> GetHyperlinkIntervalFromViewportPosition(const til::point viewportPos);
+
+    // A run of cells in a viewport row which share the same hyperlink ID and pattern interval.
+    struct HyperlinkSpan
+    {
+        til::CoordType left = 0;
+        til::CoordType right = 0; // inclusive
+        uint16_t id = 0;
+        std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> interval;
+    };
+
+    // Everything the hyperlink spans of a viewport row depend on. As long as
+    // it compares equal, the spans returned for the row are still accurate.
+    struct HyperlinkRowStamp
+    {
+        const TextBuffer* buffer = nullptr;
+        til::CoordType bufferRow = 0;
+        uint64_t rowGeneration = 0;
+        uint64_t patternTreeVersion = 0;
+
+        bool operator==(const HyperlinkRowStamp&) const noexcept = default;
+    };
+
+    HyperlinkRowStamp GetHyperlinkRowStamp(const til::CoordType viewportRow) const noexcept;
+    std::vector<HyperlinkSpan> GetHyperlinkSpansInViewportRow(const til::CoordType viewportRow) const;
+    void InvalidatePatternInterval(const interval_tree::IntervalTree<til::point, size_t>::interval& interval);
 #pragma endregion
 
 #pragma region IBaseData(base to IRenderData and IUiaData)
@@ -188,6 +242,8 @@ public:
     CursorType GetCursorStyle() const noexcept override;
     bool IsCursorDoubleWidth() const override;
     const std::vector<Microsoft::Console::Render::RenderOverlay> GetOverlays() const noexcept override;
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleSelectionRects() noexcept override;
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleHighlightRects() noexcept override;
     const bool IsGridLineDrawingAllowed() noexcept override;
     const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
@@ -206,6 +262,8 @@ public:
     const std::wstring_view GetConsoleTitle() const noexcept override;
     void ColorSelection(const til::point coordSelectionStart, const til::point coordSelectionEnd, const TextAttribute) override;
     const bool IsUiaDataInitialized() const noexcept override;
+    void LockConsoleForWriting() noexcept override;
+    void UnlockConsoleForWriting() noexcept override;
 #pragma endregion
 
     void SetWriteInputCallback(std::function<void(std::wstring_view)> pfn) noexcept;
@@ -281,6 +339,7 @@ public:
     void SwitchSelectionEndpoint();
     void ToggleMarkMode();
     void SelectHyperlink(const SearchDirection dir);
+    void SetSearchHighlights(std::vector<std::pair<til::point, til::point>> highlights) noexcept;
     bool IsTargetingUrl() const noexcept;
 
     using UpdateSelectionParams = std::optional<std::pair<SelectionDirection, SelectionExpansion>>;
@@ -289,7 +348,7 @@ public:
     til::point SelectionEndForRendering() const;
     const SelectionEndpoint SelectionEndpointTarget() const noexcept;
 
-    const TextBuffer::TextAndColor RetrieveSelectedTextFromBuffer(bool trimTrailingWhitespace);
+    const TextBuffer::TextAndColor RetrieveSelectedTextFromBuffer(bool singleLine, bool withColors = true);
 #pragma endregion
 
 private:
@@ -304,7 +363,7 @@ private:
     //
     // But we can abuse the fact that the surrounding members rarely change and are huge
     // (std::function is like 64 bytes) to create some natural padding without wasting space.
-    til::ticket_lock _readWriteLock;
+    til::shared_ticket_lock _readWriteLock;
 #ifndef NDEBUG
     DWORD _lastLocker;
 #endif
@@ -318,6 +377,7 @@ private:
     RenderSettings _renderSettings;
     std::unique_ptr<::Microsoft::Console::VirtualTerminal::StateMachine> _stateMachine;
     std::unique_ptr<::Microsoft::Console::VirtualTerminal::TerminalInput> _terminalInput;
+    WriteStatistics _writeStatistics;
 
     std::optional<std::wstring> _title;
     std::wstring _startingTitle;
@@ -331,6 +391,8 @@ private:
     bool _bracketedPasteMode;
     bool _trimBlockSelection;
     bool _autoMarkPrompts;
+    bool _spillScrollbackToDisk;
+    bool _predictiveEcho;
 
     size_t _taskbarState;
     size_t _taskbarProgress;
@@ -339,6 +401,21 @@ private:
 
     std::wstring _workingDirectory;
 
+    // The characters typed since the connection last echoed any, in the columns of
+    // _predictionRow they're expected to appear in. _predictionBuffer holds a copy of
+    // that row with the predictions written into it, which is painted as an overlay.
+    struct Prediction
+    {
+        til::CoordType column;
+        wchar_t ch;
+    };
+    std::vector<Prediction> _predictions;
+    std::unique_ptr<TextBuffer> _predictionBuffer;
+    til::CoordType _predictionRow;
+    // Set when an echo didn't match its prediction. No further predictions
+    // are made until the next carriage return, which likely starts a new prompt.
+    bool _predictionsSuspended;
+
     // This default fake font value is only used to check if the font is a raster font.
     // Otherwise, the font is changed to a real value with the renderer via TriggerFontChange.
     FontInfo _fontInfo{ DEFAULT_FONT_FACE, TMPF_TRUETYPE, 10, { 0, DEFAULT_FONT_SIZE }, CP_UTF8, false };
@@ -354,6 +431,8 @@ private:
         til::point pivot;
     };
     std::optional<SelectionAnchors> _selection;
+    // The matches of the last search, sorted by their start, with an inclusive end.
+    std::vector<std::pair<til::point, til::point>> _searchHighlights;
     bool _blockSelection;
     std::wstring _wordDelimiters;
     SelectionExpansion _multiClickSelectionMode;
@@ -365,6 +444,8 @@ private:
 
     std::unique_ptr<TextBuffer> _mainBuffer;
     std::unique_ptr<TextBuffer> _altBuffer;
+    // The alt buffer we used last time. It's reset and reused if its size still fits.
+    std::unique_ptr<TextBuffer> _spareAltBuffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     til::CoordType _scrollbackLines;
     bool _detectURLs{ false };
@@ -389,6 +470,14 @@ private:
     //      Either way, we should make this behavior controlled by a setting.
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // What _patternIntervalTree was computed from, see UpdatePatternsUnderLock.
+    // A generation of 0 means that the tree has to be recomputed.
+    uint64_t _patternsGeneration = 0;
+    const TextBuffer* _patternsBuffer = nullptr;
+    til::CoordType _patternsVisibleStart = 0;
+    til::CoordType _patternsVisibleEnd = 0;
+    // Incremented whenever _patternIntervalTree is replaced, see GetHyperlinkRowStamp.
+    uint64_t _patternTreeVersion = 0;
     void _InvalidatePatternTree(interval_tree::IntervalTree<til::point, size_t>& tree);
     void _InvalidateFromCoords(const til::point start, const til::point end);
 
@@ -400,7 +489,15 @@ private:
     };
     std::optional<KeyEventCodes> _lastKeyEventCodes;
 
-    std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> _scrollMarks;
+    // The marks are sorted by their start. Their rows are offset by _scrollMarksOffset, which grows as
+    // rows are pushed off the top of the buffer, so that the marks don't have to be moved one by one.
+    std::deque<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> _scrollMarks;
+    til::CoordType _scrollMarksOffset = 0;
+    // The most rows between the start and end of any of the marks, which limits
+    // the marks ClearMark() has to look at to those that start close to its range.
+    til::CoordType _scrollMarksMaxHeight = 0;
+    // The starts of the marks whose command failed, sorted, see GetFailedCommandAfter().
+    std::deque<til::point> _failedCommands;
 
     static WORD _ScanCodeFromVirtualKey(const WORD vkey) noexcept;
     static WORD _VirtualKeyFromScanCode(const WORD scanCode) noexcept;
@@ -424,13 +521,25 @@ private:
 
     void _NotifyTerminalCursorPositionChanged() noexcept;
 
+    void _ConfirmPredictions();
+    void _UpdatePredictionOverlay();
+
     bool _inAltBuffer() const noexcept;
     TextBuffer& _activeBuffer() const noexcept;
     void _updateUrlDetection();
 
+    void _PruneScrollMarks(const til::CoordType rowsPushedOffTopOfBuffer);
+    Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark _LoadScrollMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& stored) const noexcept;
+    til::point _StoreScrollMarkPosition(const til::point pos) const noexcept;
+    void _AddFailedCommand(const til::point start);
+    void _RemoveFailedCommand(const til::point start);
+    Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark* _GetCurrentCommandMark(std::optional<til::point> Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark::*part);
+    void _ReflowScrollMarks(const std::span<const til::point> positions);
+
 #pragma region TextSelection
     // These methods are defined in TerminalSelection.cpp
     std::vector<til::inclusive_rect> _GetSelectionRects() const noexcept;
+    std::vector<til::inclusive_rect> _GetSelectionRects(const til::CoordType firstRow, const til::CoordType lastRow) const noexcept;
     std::pair<til::point, til::point> _PivotSelection(const til::point targetPos, bool& targetStart) const;
     std::pair<til::point, til::point> _ExpandSelectionAnchors(std::pair<til::point, til::point> anchors) const;
     til::point _ConvertToBufferCell(const til::point viewportPos) const;
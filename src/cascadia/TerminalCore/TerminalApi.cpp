@@ -203,12 +203,26 @@ void Terminal::UseAlternateScreenBuffer()
     ClearSelection();
     _mainBuffer->ClearPatternRecognizers();
 
-    // Create a new alt buffer
-    _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
-                                              TextAttribute{},
-                                              cursorSize,
-                                              true,
-                                              _mainBuffer->GetRenderer());
+    // Apps like vim or less enter and exit the alt buffer a lot. Instead of allocating
+    // a new buffer every time, we reset the previous one if it still has the right size.
+    if (_spareAltBuffer && _spareAltBuffer->GetSize().Dimensions() == _altBufferSize)
+    {
+        _altBuffer = std::move(_spareAltBuffer);
+        _altBuffer->SetCurrentAttributes(TextAttribute{});
+        _altBuffer->Reset();
+        _altBuffer->GetCursor().ResetDelayEOLWrap();
+        _altBuffer->GetCursor().SetIsDouble(false);
+        _altBuffer->SetAsActiveBuffer(true);
+    }
+    else
+    {
+        _spareAltBuffer.reset();
+        _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
+                                                  TextAttribute{},
+                                                  cursorSize,
+                                                  true,
+                                                  _mainBuffer->GetRenderer());
+    }
     _mainBuffer->SetAsActiveBuffer(false);
 
     // Copy our cursor state to the new buffer's cursor
@@ -270,8 +284,9 @@ void Terminal::UseMainScreenBuffer()
     }
 
     _mainBuffer->SetAsActiveBuffer(true);
-    // destroy the alt buffer
-    _altBuffer = nullptr;
+    // keep the alt buffer around for the next UseAlternateScreenBuffer call
+    _altBuffer->SetAsActiveBuffer(false);
+    _spareAltBuffer = std::move(_altBuffer);
 
     if (_deferredResize.has_value())
     {
@@ -304,6 +319,47 @@ void Terminal::AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes:
     AddMark(mark, cursorPos, cursorPos);
 }
 
+void Terminal::MarkCommandStart()
+{
+    if (const auto mark = _GetCurrentCommandMark(&DispatchTypes::ScrollMark::commandStart))
+    {
+        mark->commandStart = _StoreScrollMarkPosition(til::point{ _activeBuffer().GetCursor().GetPosition() });
+    }
+}
+
+void Terminal::MarkOutputStart()
+{
+    if (const auto mark = _GetCurrentCommandMark(&DispatchTypes::ScrollMark::outputStart))
+    {
+        mark->outputStart = _StoreScrollMarkPosition(til::point{ _activeBuffer().GetCursor().GetPosition() });
+    }
+}
+
+// Method Description:
+// - Marks the end of the output of the current command. A failed command turns
+//   its mark into an error mark, which GetFailedCommandAfter() can find.
+// Arguments:
+// - exitCode: the exit code of the command, if the shell reported one
+void Terminal::MarkCommandFinish(const std::optional<unsigned int> exitCode)
+{
+    if (const auto mark = _GetCurrentCommandMark(&DispatchTypes::ScrollMark::outputEnd))
+    {
+        mark->outputEnd = _StoreScrollMarkPosition(til::point{ _activeBuffer().GetCursor().GetPosition() });
+        if (exitCode.has_value())
+        {
+            mark->exitCode = exitCode;
+            mark->category = *exitCode == 0 ? DispatchTypes::MarkCategory::Success : DispatchTypes::MarkCategory::Error;
+            if (*exitCode != 0)
+            {
+                _AddFailedCommand(mark->start);
+            }
+        }
+
+        // The color of the mark in the scrollbar might have changed.
+        _NotifyScrollEvent();
+    }
+}
+
 // Method Description:
 // - Reacts to a client asking us to show or hide the window.
 // Arguments:
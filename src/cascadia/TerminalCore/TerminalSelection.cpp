@@ -47,6 +47,13 @@ DEFINE_ENUM_FLAG_OPERATORS(Terminal::SelectionEndpoint);
 // Return Value:
 // - A vector of rectangles representing the regions to select, line by line. They are absolute coordinates relative to the buffer origin.
 std::vector<til::inclusive_rect> Terminal::_GetSelectionRects() const noexcept
+{
+    return _GetSelectionRects(std::numeric_limits<til::CoordType>::min(), std::numeric_limits<til::CoordType>::max());
+}
+
+// Method Description:
+// - Same as above, but only returns the rectangles for the rows from firstRow to lastRow (inclusive).
+std::vector<til::inclusive_rect> Terminal::_GetSelectionRects(const til::CoordType firstRow, const til::CoordType lastRow) const noexcept
 {
     std::vector<til::inclusive_rect> result;
 
@@ -57,7 +64,7 @@ std::vector<til::inclusive_rect> Terminal::_GetSelectionRects() const noexcept
 
     try
     {
-        return _activeBuffer().GetTextRects(_selection->start, _selection->end, _blockSelection, false);
+        return _activeBuffer().GetTextRects(_selection->start, _selection->end, _blockSelection, false, firstRow, lastRow);
     }
     CATCH_LOG();
     return result;
@@ -780,17 +787,22 @@ void Terminal::ClearSelection()
 // - get wstring text from highlighted portion of text buffer
 // Arguments:
 // - singleLine: collapse all of the text to one line
+// - withColors: whether to retrieve the colors of the text as well
 // Return Value:
 // - wstring text from buffer. If extended to multiple lines, each line is separated by \r\n
-const TextBuffer::TextAndColor Terminal::RetrieveSelectedTextFromBuffer(bool singleLine)
+const TextBuffer::TextAndColor Terminal::RetrieveSelectedTextFromBuffer(bool singleLine, bool withColors)
 {
     auto lock = LockForReading();
 
     const auto selectionRects = _GetSelectionRects();
 
-    const auto GetAttributeColors = [&](const auto& attr) {
-        return _renderSettings.GetAttributeColors(attr);
-    };
+    std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors;
+    if (withColors)
+    {
+        GetAttributeColors = [&](const auto& attr) {
+            return _renderSettings.GetAttributeColors(attr);
+        };
+    }
 
     // GH#6740: Block selection should preserve the visual structure:
     // - CRLFs need to be added - so the lines structure is preserved
@@ -77,8 +77,23 @@ bool Terminal::IsCursorDoubleWidth() const
     return IsGlyphFullWidth(*it);
 }
 
+// Method Description:
+// - Returns the predictions made by PredictInput() as an overlay of their row, if there are any.
 const std::vector<RenderOverlay> Terminal::GetOverlays() const noexcept
+try
+{
+    if (_predictions.empty() || !_predictionBuffer)
+    {
+        return {};
+    }
+
+    const til::point origin{ 0, _predictionRow - _GetVisibleViewport().Top() };
+    const auto region = Viewport::FromExclusive({ _predictions.front().column, 0, _predictions.back().column + 1, 1 });
+    return { RenderOverlay{ *_predictionBuffer, origin, region } };
+}
+catch (...)
 {
+    LOG_CAUGHT_EXCEPTION();
     return {};
 }
 
@@ -146,6 +161,77 @@ catch (...)
     return {};
 }
 
+std::vector<Microsoft::Console::Types::Viewport> Terminal::GetVisibleSelectionRects() noexcept
+try
+{
+    std::vector<Viewport> result;
+
+    const auto viewport = _GetVisibleViewport();
+    for (const auto& lineRect : _GetSelectionRects(viewport.Top(), viewport.BottomInclusive()))
+    {
+        result.emplace_back(Viewport::FromInclusive(lineRect));
+    }
+
+    return result;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
+// Method Description:
+// - Returns one rectangle per row and search match that is visible in the
+//   viewport. Matches that wrap span multiple rows.
+std::vector<Microsoft::Console::Types::Viewport> Terminal::GetVisibleHighlightRects() noexcept
+try
+{
+    std::vector<Viewport> result;
+    if (_searchHighlights.empty())
+    {
+        return result;
+    }
+
+    const auto viewport = _GetVisibleViewport();
+    const auto top = viewport.Top();
+    const auto bottom = viewport.BottomInclusive();
+    const auto width = _activeBuffer().GetSize().Width();
+
+    // The first match starting in the viewport might be preceded by
+    // matches that start above it, but wrap into it.
+    auto it = std::lower_bound(_searchHighlights.begin(), _searchHighlights.end(), til::point{ 0, top }, [](const auto& highlight, const auto& pos) {
+        return highlight.first < pos;
+    });
+    while (it != _searchHighlights.begin() && std::prev(it)->second.y >= top)
+    {
+        --it;
+    }
+
+    for (; it != _searchHighlights.end() && it->first.y <= bottom; ++it)
+    {
+        const auto& [start, end] = *it;
+        const auto lastRow = std::min(end.y, bottom);
+        for (auto y = std::max(start.y, top); y <= lastRow; ++y)
+        {
+            const auto left = y == start.y ? start.x : 0;
+            const auto right = y == end.y ? end.x : width - 1;
+            result.emplace_back(Viewport::FromInclusive({ left, y, right, y }));
+        }
+    }
+
+    return result;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
+void Terminal::SetSearchHighlights(std::vector<std::pair<til::point, til::point>> highlights) noexcept
+{
+    _searchHighlights = std::move(highlights);
+}
+
 void Terminal::SelectNewRegion(const til::point coordStart, const til::point coordEnd)
 {
 #pragma warning(push)
@@ -205,7 +291,24 @@ catch (...)
 //      operation.
 //   Callers should make sure to also call Terminal::UnlockConsole once
 //      they're done with any querying they need to do.
+// - The lock is shared, so the renderer and UIA can read at the same time.
 void Terminal::LockConsole() noexcept
+{
+    _readWriteLock.lock_shared();
+}
+
+// Method Description:
+// - Unlocks the terminal after a call to Terminal::LockConsole.
+void Terminal::UnlockConsole() noexcept
+{
+    _readWriteLock.unlock_shared();
+}
+
+// Method Description:
+// - Lock the terminal exclusively, for UIA calls that modify it, like selecting text.
+//   Callers should make sure to also call Terminal::UnlockConsoleForWriting once
+//      they're done.
+void Terminal::LockConsoleForWriting() noexcept
 {
     _readWriteLock.lock();
 #ifndef NDEBUG
@@ -214,8 +317,8 @@ void Terminal::LockConsole() noexcept
 }
 
 // Method Description:
-// - Unlocks the terminal after a call to Terminal::LockConsole.
-void Terminal::UnlockConsole() noexcept
+// - Unlocks the terminal after a call to Terminal::LockConsoleForWriting.
+void Terminal::UnlockConsoleForWriting() noexcept
 {
     _readWriteLock.unlock();
 }
@@ -58,8 +58,6 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
         _InitializeProfilesList();
 
-        _colorSchemesPageVM = winrt::make<ColorSchemesPageViewModel>(_settingsClone);
-
         Automation::AutomationProperties::SetHelpText(SaveButton(), RS_(L"Settings_SaveSettingsButton/[using:Windows.UI.Xaml.Controls]ToolTipService/ToolTip"));
         Automation::AutomationProperties::SetHelpText(ResetButton(), RS_(L"Settings_ResetSettingsButton/[using:Windows.UI.Xaml.Controls]ToolTipService/ToolTip"));
         Automation::AutomationProperties::SetHelpText(OpenJsonNavItem(), RS_(L"Nav_OpenJSON/[using:Windows.UI.Xaml.Controls]ToolTipService/ToolTip"));
@@ -129,8 +127,12 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
         // Repopulate profile-related menu items
         _InitializeProfilesList();
-        // Update the Nav State with the new version of the settings
-        _colorSchemesPageVM.UpdateSettings(_settingsClone);
+        // Update the Nav State with the new version of the settings.
+        // It's only created once the color schemes page is first visited.
+        if (_colorSchemesPageVM)
+        {
+            _colorSchemesPageVM.UpdateSettings(_settingsClone);
+        }
 
         // We'll update the profile in the _profilesNavState whenever we actually navigate to one
 
@@ -390,6 +392,11 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
         }
         else if (clickedItemTag == colorSchemesTag)
         {
+            // Creating a view model for every color scheme is only worth it once the page is actually shown.
+            if (!_colorSchemesPageVM)
+            {
+                _colorSchemesPageVM = winrt::make<ColorSchemesPageViewModel>(_settingsClone);
+            }
             contentFrame().Navigate(xaml_typename<Editor::ColorSchemes>(), _colorSchemesPageVM);
             const auto crumb = winrt::make<Breadcrumb>(box_value(clickedItemTag), RS_(L"Nav_ColorSchemes/Content"), BreadcrumbSubPage::None);
             _breadcrumbs.Append(crumb);
@@ -26,7 +26,7 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
     ProfileViewModel::ProfileViewModel(const Model::Profile& profile, const Model::CascadiaSettings& appSettings) :
         _profile{ profile },
-        _defaultAppearanceViewModel{ winrt::make<implementation::AppearanceViewModel>(profile.DefaultAppearance().try_as<AppearanceConfig>()) },
+        _defaultAppearanceViewModel{ nullptr },
         _originalProfileGuid{ profile.Guid() },
         _appSettings{ appSettings },
         _unfocusedAppearanceViewModel{ nullptr }
@@ -97,12 +97,8 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
             UpdateFontList();
         }
 
-        if (profile.HasUnfocusedAppearance())
-        {
-            _unfocusedAppearanceViewModel = winrt::make<implementation::AppearanceViewModel>(profile.UnfocusedAppearance().try_as<AppearanceConfig>());
-        }
-
-        _defaultAppearanceViewModel.IsDefault(true);
+        // The appearance view models are only needed by the appearance page and are
+        // created on first access, since MainPage creates a view model for every profile.
     }
 
     Model::TerminalSettings ProfileViewModel::TermSettings() const
@@ -250,6 +246,11 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
     Editor::AppearanceViewModel ProfileViewModel::DefaultAppearance()
     {
+        if (!_defaultAppearanceViewModel)
+        {
+            _defaultAppearanceViewModel = winrt::make<implementation::AppearanceViewModel>(_profile.DefaultAppearance().try_as<AppearanceConfig>());
+            _defaultAppearanceViewModel.IsDefault(true);
+        }
         return _defaultAppearanceViewModel;
     }
 
@@ -290,6 +291,10 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
     Editor::AppearanceViewModel ProfileViewModel::UnfocusedAppearance()
     {
+        if (!_unfocusedAppearanceViewModel && _profile.HasUnfocusedAppearance())
+        {
+            _unfocusedAppearanceViewModel = winrt::make<implementation::AppearanceViewModel>(_profile.UnfocusedAppearance().try_as<AppearanceConfig>());
+        }
         return _unfocusedAppearanceViewModel;
     }
 
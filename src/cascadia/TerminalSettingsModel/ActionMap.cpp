@@ -100,6 +100,72 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         return std::nullopt;
     }
 
+    // Method Description:
+    // - Packs a key chord into an integer, such that two chords pack into
+    //   the same value if and only if KeyChord::Equals() considers them equal.
+    uint64_t KeyChordLookup::Pack(const Control::KeyChord& keys)
+    {
+        // Chords with a vkey are compared by their vkey, the others by their scan code.
+        // Bit 32 keeps the two kinds apart and ensures that the result is never 0.
+        const auto vkey = keys.Vkey();
+        auto packed = static_cast<uint64_t>(keys.Modifiers()) << 33;
+        packed |= vkey ? static_cast<uint32_t>(vkey) : (uint64_t{ 1 } << 32 | static_cast<uint32_t>(keys.ScanCode()));
+        return packed;
+    }
+
+    KeyChordLookup::KeyChordLookup(std::unordered_map<uint64_t, std::optional<Model::Command>> entries)
+    {
+        // Keep the load factor at or below 50%, so that probe sequences stay short.
+        _slots.resize(std::max<size_t>(16, std::bit_ceil(entries.size() * 2)));
+        const auto mask = _slots.size() - 1;
+
+        for (auto& [key, cmd] : entries)
+        {
+            auto index = _Mix(key) & mask;
+            while (til::at(_slots, index).key != 0)
+            {
+                index = (index + 1) & mask;
+            }
+
+            auto& slot = til::at(_slots, index);
+            slot.key = key;
+            slot.cmd = std::move(cmd);
+        }
+    }
+
+    // Method Description:
+    // - Looks up a key chord packed with Pack().
+    // Return Value:
+    // - nullptr if the key chord isn't bound in any layer, otherwise the
+    //   (possibly explicitly unbound) result of _GetActionByKeyChordInternal.
+    const std::optional<Model::Command>* KeyChordLookup::Find(const uint64_t key) const noexcept
+    {
+        const auto mask = _slots.size() - 1;
+        for (auto index = _Mix(key) & mask;; index = (index + 1) & mask)
+        {
+            const auto& slot = til::at(_slots, index);
+            if (slot.key == key)
+            {
+                return &slot.cmd;
+            }
+            if (slot.key == 0)
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    size_t KeyChordLookup::_Mix(uint64_t key) noexcept
+    {
+        // The finalizer of murmurhash3, just like KeyChord::Hash().
+        key ^= key >> 33;
+        key *= UINT64_C(0xff51afd7ed558ccd);
+        key ^= key >> 33;
+        key *= UINT64_C(0xc4ceb9fe1a85ec53);
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
     static void RegisterShortcutAction(ShortcutAction shortcutAction, std::unordered_map<hstring, Model::ActionAndArgs>& list, std::unordered_set<InternalActionID>& visited)
     {
         const auto actionAndArgs{ make_self<ActionAndArgs>(shortcutAction) };
@@ -323,6 +389,43 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         _KeyBindingMapCache = single_threaded_map(std::move(keyBindingsMap));
         _GlobalHotkeysCache = single_threaded_map(std::move(globalHotkeys));
+
+        std::unordered_map<uint64_t, std::optional<Model::Command>> entries;
+        _PopulateKeyChordLookup(entries);
+        _KeyChordLookupCache.emplace(std::move(entries));
+    }
+
+    // Method Description:
+    // - Builds the key binding caches once the map and its parents are fully populated,
+    //   so that the first keystroke doesn't have to pay for it.
+    // - Modifying a parent afterwards won't be reflected in this map's caches.
+    void ActionMap::FinalizeKeyBindings()
+    {
+        _RefreshKeyBindingCaches();
+    }
+
+    // Method Description:
+    // - Populates the provided entries with what _GetActionByKeyChordInternal would return
+    //    for every key chord bound in this layer or its parents.
+    // - Like _GetActionByKeyChordInternal, the first layer binding a key chord wins.
+    // Arguments:
+    // - entries: a map from packed key chords (see KeyChordLookup::Pack) to commands
+    void ActionMap::_PopulateKeyChordLookup(std::unordered_map<uint64_t, std::optional<Model::Command>>& entries) const
+    {
+        for (const auto& [keys, actionID] : _KeyMap)
+        {
+            const auto packed = KeyChordLookup::Pack(keys);
+            if (entries.find(packed) == entries.end())
+            {
+                entries.emplace(packed, _GetActionByID(actionID));
+            }
+        }
+
+        assert(_parents.size() <= 1);
+        for (const auto& parent : _parents)
+        {
+            parent->_PopulateKeyChordLookup(entries);
+        }
     }
 
     // Method Description:
@@ -434,6 +537,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _NameMapCache = nullptr;
         _GlobalHotkeysCache = nullptr;
         _KeyBindingMapCache = nullptr;
+        _KeyChordLookupCache.reset();
 
         // Handle nested commands
         const auto cmdImpl{ get_self<Command>(cmd) };
@@ -727,6 +831,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - nullopt if it was not bound in this layer
     std::optional<Model::Command> ActionMap::_GetActionByKeyChordInternal(const Control::KeyChord& keys) const
     {
+        // Once our caches are built, every layer's answer is in a single table.
+        if (_KeyChordLookupCache)
+        {
+            if (const auto cmd = _KeyChordLookupCache->Find(KeyChordLookup::Pack(keys)))
+            {
+                return *cmd;
+            }
+            return std::nullopt;
+        }
+
         // Check the current layer
         if (const auto actionIDPair = _KeyMap.find(keys); actionIDPair != _KeyMap.end())
         {
@@ -47,6 +47,32 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     };
 
+    // A frozen open-addressing hash table from key chords to the result of
+    // ActionMap::_GetActionByKeyChordInternal, flattened across all layers.
+    // Keys are packed into integers, so that a lookup (which is usually a miss)
+    // doesn't need to call into any KeyChord or Command objects.
+    class KeyChordLookup
+    {
+    public:
+        static uint64_t Pack(const Control::KeyChord& keys);
+
+        explicit KeyChordLookup(std::unordered_map<uint64_t, std::optional<Model::Command>> entries);
+
+        const std::optional<Model::Command>* Find(const uint64_t key) const noexcept;
+
+    private:
+        struct Slot
+        {
+            // No packed key chord is 0, so we use it to mark empty slots.
+            uint64_t key = 0;
+            std::optional<Model::Command> cmd;
+        };
+
+        static size_t _Mix(uint64_t key) noexcept;
+
+        std::vector<Slot> _slots;
+    };
+
     struct ActionMap : ActionMapT<ActionMap>, IInheritable<ActionMap>
     {
         // views
@@ -64,6 +90,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         // population
         void AddAction(const Model::Command& cmd);
+        void FinalizeKeyBindings();
 
         // JSON
         static com_ptr<ActionMap> FromJson(const Json::Value& json);
@@ -84,6 +111,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void _PopulateNameMapWithSpecialCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateNameMapWithStandardCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateKeyBindingMapWithStandardCommands(std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>& keyBindingsMap, std::unordered_set<Control::KeyChord, KeyChordHash, KeyChordEquality>& unboundKeys) const;
+        void _PopulateKeyChordLookup(std::unordered_map<uint64_t, std::optional<Model::Command>>& entries) const;
         std::vector<Model::Command> _GetCumulativeActions() const noexcept;
 
         void _TryUpdateActionMap(const Model::Command& cmd, Model::Command& oldCmd, Model::Command& consolidatedCmd);
@@ -94,6 +122,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IMap<hstring, Model::Command> _NameMapCache{ nullptr };
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _GlobalHotkeysCache{ nullptr };
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _KeyBindingMapCache{ nullptr };
+        // Unlike the caches above, this one is only ever built by _RefreshKeyBindingCaches,
+        // because GetActionByKeyChord is also used while the map is being populated.
+        std::optional<KeyChordLookup> _KeyChordLookupCache;
 
         std::unordered_map<winrt::hstring, Model::Command> _NestedCommands;
         std::vector<Model::Command> _IterableCommands;
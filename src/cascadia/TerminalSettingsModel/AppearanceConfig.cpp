@@ -72,18 +72,42 @@ Json::Value AppearanceConfig::ToJson() const
 // - json: an object which should be a partial serialization of an AppearanceConfig object.
 void AppearanceConfig::LayerJson(const Json::Value& json)
 {
-    JsonUtils::GetValueForKey(json, ForegroundKey, _Foreground);
-    JsonUtils::GetValueForKey(json, BackgroundKey, _Background);
-    JsonUtils::GetValueForKey(json, SelectionBackgroundKey, _SelectionBackground);
-    JsonUtils::GetValueForKey(json, CursorColorKey, _CursorColor);
+    // See Profile::LayerJson.
+    static const JsonUtils::MemberParsers<AppearanceConfig> parsers{
+        { ForegroundKey, [](AppearanceConfig& a, const Json::Value& v) { JsonUtils::GetValue(v, a._Foreground); } },
+        { BackgroundKey, [](AppearanceConfig& a, const Json::Value& v) { JsonUtils::GetValue(v, a._Background); } },
+        { SelectionBackgroundKey, [](AppearanceConfig& a, const Json::Value& v) { JsonUtils::GetValue(v, a._SelectionBackground); } },
+        { CursorColorKey, [](AppearanceConfig& a, const Json::Value& v) { JsonUtils::GetValue(v, a._CursorColor); } },
+#define APPEARANCE_SETTINGS_LAYER_JSON(type, name, jsonKey, ...) \
+    { jsonKey, [](AppearanceConfig& a, const Json::Value& v) { JsonUtils::GetValue(v, a._##name); } },
+        MTSM_APPEARANCE_SETTINGS(APPEARANCE_SETTINGS_LAYER_JSON)
+#undef APPEARANCE_SETTINGS_LAYER_JSON
+    };
+    parsers.Parse(json, *this);
 
+    // The legacy key has to be parsed first, so that the new one takes precedence.
     JsonUtils::GetValueForKey(json, LegacyAcrylicTransparencyKey, _Opacity);
     JsonUtils::GetValueForKey(json, OpacityKey, _Opacity, JsonUtils::OptionalConverter<double, IntAsFloatPercentConversionTrait>{});
+}
 
-#define APPEARANCE_SETTINGS_LAYER_JSON(type, name, jsonKey, ...) \
-    JsonUtils::GetValueForKey(json, jsonKey, _##name);
-    MTSM_APPEARANCE_SETTINGS(APPEARANCE_SETTINGS_LAYER_JSON)
-#undef APPEARANCE_SETTINGS_LAYER_JSON
+// Method Description:
+// - Resolves the value of each setting, see Profile::Freeze().
+// Arguments:
+// - frozen: the flag shared by all objects frozen together
+void AppearanceConfig::Freeze(const std::shared_ptr<std::atomic<bool>>& frozen)
+{
+    _freezeForeground();
+    _freezeBackground();
+    _freezeSelectionBackground();
+    _freezeCursorColor();
+    _freezeOpacity();
+
+#define APPEARANCE_SETTINGS_FREEZE(type, name, jsonKey, ...) \
+    _freeze##name();
+    MTSM_APPEARANCE_SETTINGS(APPEARANCE_SETTINGS_FREEZE)
+#undef APPEARANCE_SETTINGS_FREEZE
+
+    _frozen = frozen;
 }
 
 winrt::Microsoft::Terminal::Settings::Model::Profile AppearanceConfig::SourceProfile()
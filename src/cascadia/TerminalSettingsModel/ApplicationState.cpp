@@ -150,6 +150,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         LOG_LAST_ERROR_IF(!DeleteFile(_sharedPath.c_str()));
         LOG_LAST_ERROR_IF(!DeleteFile(_elevatedPath.c_str()));
         *_state.lock() = {};
+        *_serialized.lock() = Json::Value{ Json::objectValue };
     }
     CATCH_LOG()
 
@@ -204,12 +205,17 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
     // Serialized this ApplicationState (in `context`) into the state.json at _path.
     // * Errors are only logged.
-    // * _state->_writeScheduled is set to false, signaling our
-    //   setters that _synchronize() needs to be called again.
+    // * Only the fields that changed since the last call are serialized, into
+    //   the JSON we wrote last time. The persisted window layouts grow with the
+    //   number of tabs, and this way the setters don't wait for us to serialize them.
     void ApplicationState::_write() const noexcept
     try
     {
         Json::StreamWriterBuilder wbuilder;
+        const auto elevated = ::Microsoft::Console::Utils::IsElevated();
+        const auto changes = _takeChanges(elevated ? FileSource::Local : FileSource::Local | FileSource::Shared);
+        const auto serialized = _serialized.lock();
+        _applyChanges(*serialized, changes);
 
         // When we're elevated, we've got to be tricky. We don't want to write
         // our window state, allowed commandlines, and other Local properties
@@ -225,7 +231,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         //
         // After that's done, we'll write our Local properties into
         // elevated-state.json.
-        if (::Microsoft::Console::Utils::IsElevated())
+        if (elevated)
         {
             std::string errs;
             std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder::CharReaderBuilder().newCharReader() };
@@ -247,16 +253,56 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             _writeSharedContents(Json::writeString(wbuilder, _toJsonWithBlob(root, FileSource::Shared)));
 
             // Finally, write our Local properties back to elevated-state.json
-            _writeLocalContents(Json::writeString(wbuilder, ToJson(FileSource::Local)));
+            _writeLocalContents(Json::writeString(wbuilder, *serialized));
         }
         else
         {
             // We're unelevated, this is easy. Just write everything back out.
-            _writeLocalContents(Json::writeString(wbuilder, ToJson(FileSource::Local | FileSource::Shared)));
+            _writeLocalContents(Json::writeString(wbuilder, *serialized));
         }
     }
     CATCH_LOG()
 
+    // Copies the fields of the given source that changed since the last call out of _state
+    // and marks them as unchanged. Copying them is cheap, unlike serializing them.
+    ApplicationState::state_t ApplicationState::_takeChanges(FileSource parseSource) const
+    {
+        state_t changes;
+        auto state = _state.lock();
+#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...)                       \
+    changes.name##Changed = WI_IsFlagSet(parseSource, source) && state->name##Changed; \
+    if (changes.name##Changed)                                                         \
+    {                                                                                  \
+        changes.name = state->name;                                                    \
+        state->name##Changed = false;                                                  \
+    }
+
+        MTSM_APPLICATION_STATE_FIELDS(MTSM_APPLICATION_STATE_GEN)
+#undef MTSM_APPLICATION_STATE_GEN
+        return changes;
+    }
+
+    // Serializes the changed fields in the given changes into root.
+    // Fields that were changed to have no value are removed.
+    void ApplicationState::_applyChanges(Json::Value& root, const state_t& changes)
+    {
+#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...) \
+    if (changes.name##Changed)                                   \
+    {                                                            \
+        if (changes.name)                                        \
+        {                                                        \
+            JsonUtils::SetValueForKey(root, key, changes.name);  \
+        }                                                        \
+        else                                                     \
+        {                                                        \
+            root.removeMember(key);                              \
+        }                                                        \
+    }
+
+        MTSM_APPLICATION_STATE_FIELDS(MTSM_APPLICATION_STATE_GEN)
+#undef MTSM_APPLICATION_STATE_GEN
+    }
+
     // Returns the application-global ApplicationState object.
     Microsoft::Terminal::Settings::Model::ApplicationState ApplicationState::SharedInstance()
     {
@@ -282,9 +328,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // GH#11222: We only load properties that are of the same type (Local or
         // Shared) which we requested. If we didn't want to load this type of
         // property, just skip it.
-#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...) \
-    if (WI_IsFlagSet(parseSource, source))                       \
-        state->name = JsonUtils::GetValueForKey<std::optional<type>>(root, key);
+#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...)                  \
+    if (WI_IsFlagSet(parseSource, source))                                        \
+    {                                                                             \
+        state->name = JsonUtils::GetValueForKey<std::optional<type>>(root, key); \
+        state->name##Changed = true;                                              \
+    }
 
         MTSM_APPLICATION_STATE_FIELDS(MTSM_APPLICATION_STATE_GEN)
 #undef MTSM_APPLICATION_STATE_GEN
@@ -328,6 +377,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         {                                                        \
             auto state = _state.lock();                          \
             state->name.emplace(value);                          \
+            state->name##Changed = true;                         \
         }                                                        \
                                                                  \
         _throttler();                                            \
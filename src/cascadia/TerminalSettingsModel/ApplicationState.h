@@ -81,11 +81,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         struct state_t
         {
-#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...) std::optional<type> name{ __VA_ARGS__ };
+            // nameChanged is set whenever name was modified since it was last serialized.
+#define MTSM_APPLICATION_STATE_GEN(source, type, name, key, ...) \
+    std::optional<type> name{ __VA_ARGS__ };                      \
+    bool name##Changed = true;
             MTSM_APPLICATION_STATE_FIELDS(MTSM_APPLICATION_STATE_GEN)
 #undef MTSM_APPLICATION_STATE_GEN
         };
         til::shared_mutex<state_t> _state;
+        // The JSON we last wrote to our local state file, which _write() only updates with the fields that changed.
+        til::shared_mutex<Json::Value> _serialized{ Json::Value{ Json::objectValue } };
         std::filesystem::path _sharedPath;
         std::filesystem::path _elevatedPath;
         til::throttled_func_trailing<> _throttler;
@@ -94,6 +99,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void _read() const noexcept;
 
         Json::Value _toJsonWithBlob(Json::Value& root, FileSource parseSource) const noexcept;
+        state_t _takeChanges(FileSource parseSource) const;
+        static void _applyChanges(Json::Value& root, const state_t& changes);
 
         std::optional<std::string> _readSharedContents() const;
         void _writeSharedContents(const std::string_view content) const;
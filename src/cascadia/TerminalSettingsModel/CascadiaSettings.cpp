@@ -136,6 +136,82 @@ Model::Profile CascadiaSettings::FindProfile(const winrt::guid& guid) const noex
     return nullptr;
 }
 
+// Appends the JSON of the given profile and everything it inherits from.
+static void _appendProfileChainJson(Profile& profile, Json::Value& json)
+{
+    json.append(profile.ToJson());
+    for (const auto& parent : profile.Parents())
+    {
+        _appendProfileChainJson(*parent, json);
+    }
+}
+
+// Method Description:
+// - Serializes the settings that affect every profile: the global settings
+//   (apart from the actions, which don't end up in a TerminalSettings), the
+//   color schemes and the profile defaults.
+Json::Value CascadiaSettings::_sharedSettingsToJson() const
+{
+    auto json{ _globals->ToJson() };
+    json.removeMember("actions");
+
+    auto& schemes = json["schemes"];
+    for (const auto& entry : _globals->ColorSchemes())
+    {
+        schemes.append(winrt::get_self<ColorScheme>(entry.Value())->ToJson());
+    }
+
+    _appendProfileChainJson(*_baseLayerProfile, json["profileDefaults"]);
+    return json;
+}
+
+// Method Description:
+// - Compares these settings to the given ones, which they are replacing, and
+//   returns the profiles whose settings changed. This lets a settings reload
+//   leave the controls of all other profiles alone.
+// - A profile is considered changed if it or any profile it inherits from
+//   serializes differently, or if it didn't exist before.
+// Arguments:
+// - previous: the settings that were loaded before
+// Return Value:
+// - the GUIDs of the changed profiles, or nullptr if settings that affect all
+//   profiles changed, in which case they all need to be updated.
+IVectorView<winrt::guid> CascadiaSettings::ProfilesChangedSince(const Model::CascadiaSettings& previous) const
+{
+    if (!previous)
+    {
+        return nullptr;
+    }
+
+    const auto previousImpl = winrt::get_self<CascadiaSettings>(previous);
+    if (_sharedSettingsToJson() != previousImpl->_sharedSettingsToJson())
+    {
+        return nullptr;
+    }
+
+    std::vector<winrt::guid> changed;
+    for (const auto& profile : _allProfiles)
+    {
+        const auto previousProfile = previousImpl->FindProfile(profile.Guid());
+        if (!previousProfile)
+        {
+            changed.emplace_back(profile.Guid());
+            continue;
+        }
+
+        Json::Value json{ Json::ValueType::arrayValue };
+        Json::Value previousJson{ Json::ValueType::arrayValue };
+        _appendProfileChainJson(*winrt::get_self<Profile>(profile), json);
+        _appendProfileChainJson(*winrt::get_self<Profile>(previousProfile), previousJson);
+        if (json != previousJson)
+        {
+            changed.emplace_back(profile.Guid());
+        }
+    }
+
+    return winrt::single_threaded_vector(std::move(changed)).GetView();
+}
+
 // Method Description:
 // - Returns an iterable collection of all of our Profiles.
 // Arguments:
@@ -76,6 +76,13 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             const Json::Value& themes;
         };
 
+        struct GeneratorResult
+        {
+            std::vector<winrt::com_ptr<implementation::Profile>> profiles;
+            // Set if the profiles were freshly generated and should be cached under this key.
+            std::string cacheKey;
+        };
+
         static std::pair<size_t, size_t> _lineAndColumnFromPosition(const std::string_view& string, const size_t position);
         static void _rethrowSerializationExceptionWithLocationInfo(const JsonUtils::DeserializationError& e, const std::string_view& settingsString);
         static Json::Value _parseJSON(const std::string_view& content);
@@ -87,9 +94,15 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static winrt::com_ptr<implementation::Profile> _parseProfile(const OriginTag origin, const winrt::hstring& source, const Json::Value& profileJson);
         void _appendProfile(winrt::com_ptr<Profile>&& profile, const winrt::guid& guid, ParsedSettings& settings);
         void _addUserProfileParent(const winrt::com_ptr<implementation::Profile>& profile);
-        void _executeGenerator(const IDynamicProfileGenerator& generator);
+        void _executeGenerator(const IDynamicProfileGenerator& generator, GeneratorResult& result) const;
+        void _mergeGeneratorResult(const IDynamicProfileGenerator& generator, GeneratorResult& result);
+        bool _loadCachedProfiles(const IDynamicProfileGenerator& generator, const std::string_view& cacheKey, std::vector<winrt::com_ptr<implementation::Profile>>& profiles) const;
+        void _storeCachedProfiles(const IDynamicProfileGenerator& generator, const std::string_view& cacheKey, const std::vector<winrt::com_ptr<implementation::Profile>>& profiles);
 
         std::unordered_set<std::wstring_view> _ignoredNamespaces;
+        // The profiles generated during the previous launch, see GenerateProfiles().
+        Json::Value _generatorCache;
+        bool _generatorCacheChanged = false;
         // See _getNonUserOriginProfiles().
         size_t _userProfileCount = 0;
     };
@@ -123,6 +136,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Model::Profile ProfileDefaults() const;
         Model::Profile CreateNewProfile();
         Model::Profile FindProfile(const winrt::guid& guid) const noexcept;
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::guid> ProfilesChangedSince(const Model::CascadiaSettings& previous) const;
         Model::ColorScheme GetColorSchemeForProfile(const Model::Profile& profile) const;
         void UpdateColorSchemeReferences(const winrt::hstring& oldName, const winrt::hstring& newName);
         Model::Profile GetProfileForArgs(const Model::NewTerminalArgs& newTerminalArgs) const;
@@ -147,11 +161,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static const std::filesystem::path& _settingsPath();
         static const std::filesystem::path& _releaseSettingsPath();
 
+        void _writeSettingsToDisk(const bool background) const;
+
         winrt::com_ptr<implementation::Profile> _createNewProfile(const std::wstring_view& name) const;
         Model::Profile _getProfileForCommandLine(const winrt::hstring& commandLine) const;
         void _refreshDefaultTerminals();
 
         void _resolveDefaultProfile() const;
+        Json::Value _sharedSettingsToJson() const;
 
         void _validateSettings();
         void _validateAllSchemesExist();
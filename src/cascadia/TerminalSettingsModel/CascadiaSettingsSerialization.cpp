@@ -34,6 +34,7 @@ using namespace winrt::Microsoft::Terminal::Settings::Model::implementation;
 
 static constexpr std::wstring_view SettingsFilename{ L"settings.json" };
 static constexpr std::wstring_view DefaultsFilename{ L"defaults.json" };
+static constexpr std::wstring_view GeneratorCacheFilename{ L"generator-cache.json" };
 
 static constexpr std::string_view ProfilesKey{ "profiles" };
 static constexpr std::string_view DefaultSettingsKey{ "defaults" };
@@ -41,6 +42,11 @@ static constexpr std::string_view ProfilesListKey{ "list" };
 static constexpr std::string_view SchemesKey{ "schemes" };
 static constexpr std::string_view ThemesKey{ "themes" };
 
+static constexpr std::string_view CacheVersionKey{ "version" };
+static constexpr std::string_view CacheGeneratorsKey{ "generators" };
+static constexpr std::string_view CacheKeyKey{ "key" };
+static constexpr std::string_view CacheProfilesKey{ "profiles" };
+
 constexpr std::wstring_view systemThemeName{ L"system" };
 constexpr std::wstring_view darkThemeName{ L"dark" };
 constexpr std::wstring_view lightThemeName{ L"light" };
@@ -141,12 +147,84 @@ SettingsLoader::SettingsLoader(const std::string_view& userJSON, const std::stri
 
 // Generate dynamic profiles and add them to the list of "inbox" profiles
 // (meaning profiles specified by the application rather by the user).
+//
+// Some generators are slow, but can cheaply tell whether their inputs changed (see
+// IDynamicProfileGenerator::GetCacheKey). Their profiles are cached in GeneratorCacheFilename
+// and only regenerated when the key changed. The cache is discarded whenever the application
+// version changes, as a different version might generate different profiles for the same inputs.
+//
+// The generators are independent of each other and spend most of their time waiting for the
+// file system, the registry or COM servers. They're run concurrently, but their profiles are
+// added in a fixed order, so that the order of the generated profiles doesn't change between launches.
 void SettingsLoader::GenerateProfiles()
 {
-    _executeGenerator(PowershellCoreProfileGenerator{});
-    _executeGenerator(WslDistroGenerator{});
-    _executeGenerator(AzureCloudShellGenerator{});
-    _executeGenerator(VisualStudioGenerator{});
+    const auto cachePath = GetBaseSettingsPath() / GeneratorCacheFilename;
+    const auto version = til::u16u8(CascadiaSettings::ApplicationVersion());
+
+    try
+    {
+        if (const auto content = ReadUTF8FileIfExists(cachePath))
+        {
+            auto cache = _parseJSON(*content);
+            const auto& cacheVersion = _getJSONValue(cache, CacheVersionKey);
+            if (cacheVersion.isString() && cacheVersion.asString() == version && _getJSONValue(cache, CacheGeneratorsKey).isObject())
+            {
+                _generatorCache = std::move(cache);
+            }
+        }
+    }
+    CATCH_LOG();
+
+    const PowershellCoreProfileGenerator powershellGenerator;
+    const WslDistroGenerator wslGenerator;
+    const AzureCloudShellGenerator azureGenerator;
+    const VisualStudioGenerator visualStudioGenerator;
+    const std::array<const IDynamicProfileGenerator*, 4> generators{ &powershellGenerator, &wslGenerator, &azureGenerator, &visualStudioGenerator };
+
+    std::array<GeneratorResult, generators.size()> results;
+    {
+        std::array<std::thread, generators.size()> threads;
+        const auto joinThreads = wil::scope_exit([&]() {
+            for (auto& thread : threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        });
+
+        for (size_t i = 0; i < generators.size(); ++i)
+        {
+            til::at(threads, i) = std::thread{ [this, generator = til::at(generators, i), result = &til::at(results, i)]() {
+                try
+                {
+                    // Generators like the VisualStudioGenerator talk to COM servers.
+                    const auto coInit = wil::CoInitializeEx(COINIT_MULTITHREADED);
+                    _executeGenerator(*generator, *result);
+                }
+                CATCH_LOG();
+            } };
+        }
+    }
+
+    for (size_t i = 0; i < generators.size(); ++i)
+    {
+        _mergeGeneratorResult(*til::at(generators, i), til::at(results, i));
+    }
+
+    if (_generatorCacheChanged)
+    {
+        try
+        {
+            _generatorCache[JsonKey(CacheVersionKey)] = version;
+
+            Json::StreamWriterBuilder wbuilder;
+            wbuilder.settings_["indentation"] = "";
+            WriteUTF8FileAtomic(cachePath, Json::writeString(wbuilder, _generatorCache));
+        }
+        CATCH_LOG();
+    }
 }
 
 // A new settings.json gets a special treatment:
@@ -746,9 +824,10 @@ void SettingsLoader::_addUserProfileParent(const winrt::com_ptr<implementation::
     }
 }
 
-// As the name implies it executes a generator.
-// Generated profiles are added to .inboxSettings. Used by GenerateProfiles().
-void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator)
+// As the name implies it executes a generator, or loads its profiles from the cache.
+// Used by GenerateProfiles(), which calls this function concurrently for all generators.
+// It must not modify anything but the given result for that reason.
+void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator, GeneratorResult& result) const
 {
     const auto generatorNamespace = generator.GetNamespace();
     if (_ignoredNamespaces.count(generatorNamespace))
@@ -756,28 +835,103 @@ void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator
         return;
     }
 
-    const auto previousSize = inboxSettings.profiles.size();
+    std::string cacheKey;
+    try
+    {
+        cacheKey = til::u16u8(generator.GetCacheKey());
+    }
+    CATCH_LOG();
+
+    if (!cacheKey.empty() && _loadCachedProfiles(generator, cacheKey, result.profiles))
+    {
+        return;
+    }
 
     try
     {
-        generator.GenerateProfiles(inboxSettings.profiles);
+        generator.GenerateProfiles(result.profiles);
+        result.cacheKey = std::move(cacheKey);
     }
     CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generatorNamespace.size()), generatorNamespace.data())
+}
+
+// Adds the profiles produced by _executeGenerator to .inboxSettings and updates the cache.
+void SettingsLoader::_mergeGeneratorResult(const IDynamicProfileGenerator& generator, GeneratorResult& result)
+{
+    if (!result.cacheKey.empty())
+    {
+        try
+        {
+            _storeCachedProfiles(generator, result.cacheKey, result.profiles);
+        }
+        CATCH_LOG();
+    }
 
     // If the generator produced some profiles we're going to give them default attributes.
     // By setting the Origin/Source/etc. here, we deduplicate some code and ensure they aren't missing accidentally.
-    if (inboxSettings.profiles.size() > previousSize)
+    if (!result.profiles.empty())
     {
-        const winrt::hstring source{ generatorNamespace };
+        const winrt::hstring source{ generator.GetNamespace() };
 
-        for (const auto& profile : gsl::span(inboxSettings.profiles).subspan(previousSize))
+        inboxSettings.profiles.reserve(inboxSettings.profiles.size() + result.profiles.size());
+        for (auto& profile : result.profiles)
         {
             profile->Origin(OriginTag::Generated);
             profile->Source(source);
+            inboxSettings.profiles.emplace_back(std::move(profile));
         }
     }
 }
 
+// Adds the profiles the given generator produced during a previous launch to the given list,
+// if they were generated with the same cache key. Returns false if they weren't.
+bool SettingsLoader::_loadCachedProfiles(const IDynamicProfileGenerator& generator, const std::string_view& cacheKey, std::vector<winrt::com_ptr<Profile>>& profiles) const
+{
+    const auto& generators = _getJSONValue(_generatorCache, CacheGeneratorsKey);
+    const auto& entry = _getJSONValue(generators, til::u16u8(generator.GetNamespace()));
+    const auto& key = _getJSONValue(entry, CacheKeyKey);
+    const auto& cachedProfiles = _getJSONValue(entry, CacheProfilesKey);
+
+    if (!key.isString() || key.asString() != cacheKey || !cachedProfiles.isArray())
+    {
+        return false;
+    }
+
+    const auto previousSize = profiles.size();
+
+    try
+    {
+        for (const auto& profileJson : cachedProfiles)
+        {
+            profiles.emplace_back(Profile::FromJson(profileJson));
+        }
+        return true;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        profiles.resize(previousSize);
+        return false;
+    }
+}
+
+// Stores the given profiles in the cache, so that _loadCachedProfiles can use them during the next launch.
+void SettingsLoader::_storeCachedProfiles(const IDynamicProfileGenerator& generator, const std::string_view& cacheKey, const std::vector<winrt::com_ptr<Profile>>& profiles)
+{
+    Json::Value profilesJson{ Json::ValueType::arrayValue };
+    for (const auto& profile : profiles)
+    {
+        profilesJson.append(profile->ToJson());
+    }
+
+    Json::Value entry{ Json::ValueType::objectValue };
+    entry[JsonKey(CacheKeyKey)] = std::string{ cacheKey };
+    entry[JsonKey(CacheProfilesKey)] = std::move(profilesJson);
+
+    _generatorCache[JsonKey(CacheGeneratorsKey)][til::u16u8(generator.GetNamespace())] = std::move(entry);
+    _generatorCacheChanged = true;
+}
+
 // Method Description:
 // - Creates a CascadiaSettings from whatever's saved on disk, or instantiates
 //      a new one with the default values. If we're running as a packaged app,
@@ -793,6 +947,9 @@ void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator
 Model::CascadiaSettings CascadiaSettings::LoadAll()
 try
 {
+    // The settings UI might have just saved the settings we're about to read.
+    FlushBackgroundWrites();
+
     auto settingsString = ReadUTF8FileIfExists(_settingsPath()).value_or(std::string{});
     auto firstTimeSetup = settingsString.empty();
 
@@ -866,7 +1023,8 @@ try
     {
         try
         {
-            settings->WriteSettingsToDisk();
+            // Synchronously, so that we can warn about failures.
+            settings->_writeSettingsToDisk(false);
         }
         catch (...)
         {
@@ -989,6 +1147,15 @@ CascadiaSettings::CascadiaSettings(SettingsLoader&& loader) :
 
     _resolveDefaultProfile();
     _validateSettings();
+
+    // Everything is loaded and validated now, so the profiles can stop
+    // looking up their settings through all of their parents.
+    const auto frozen = std::make_shared<std::atomic<bool>>(true);
+    _baseLayerProfile->Freeze(frozen);
+    for (const auto& profile : _allProfiles)
+    {
+        winrt::get_self<Profile>(profile)->Freeze(frozen);
+    }
 }
 
 // Method Description:
@@ -1054,11 +1221,24 @@ winrt::hstring CascadiaSettings::DefaultSettingsPath()
 // - Write the current state of CascadiaSettings to our settings file
 // - Create a backup file with the current contents, if one does not exist
 // - Persists the default terminal handler choice to the registry
+// - The settings are serialized right away, but the file is written on the
+//   thread pool, so that the UI thread never waits for the file system.
 // Arguments:
 // - <none>
 // Return Value:
 // - <none>
 void CascadiaSettings::WriteSettingsToDisk() const
+{
+    _writeSettingsToDisk(true);
+}
+
+// Method Description:
+// - See WriteSettingsToDisk.
+// Arguments:
+// - background: if false, the file is written before returning and errors are thrown.
+// Return Value:
+// - <none>
+void CascadiaSettings::_writeSettingsToDisk(const bool background) const
 {
     const auto settingsPath = _settingsPath();
 
@@ -1067,8 +1247,15 @@ void CascadiaSettings::WriteSettingsToDisk() const
     wbuilder.settings_["indentation"] = "    ";
     wbuilder.settings_["enableYAMLCompatibility"] = true; // suppress spaces around colons
 
-    const auto styledString{ Json::writeString(wbuilder, ToJson()) };
-    WriteUTF8FileAtomic(settingsPath, styledString);
+    auto styledString{ Json::writeString(wbuilder, ToJson()) };
+    if (background)
+    {
+        WriteUTF8FileAtomicInBackground(settingsPath, std::move(styledString));
+    }
+    else
+    {
+        WriteUTF8FileAtomic(settingsPath, styledString);
+    }
 
     // Persists the default terminal choice
     // GH#10003 - Only do this if _currentDefaultTerminal was actually initialized.
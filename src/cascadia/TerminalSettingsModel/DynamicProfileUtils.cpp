@@ -28,3 +28,16 @@ winrt::com_ptr<winrt::Microsoft::Terminal::Settings::Model::implementation::Prof
     profile->Icon(winrt::hstring{ iconPath });
     return profile;
 }
+
+// Method Description:
+// - Helper function for IDynamicProfileGenerator::GetCacheKey implementations.
+//   Appends the given path and its last write time to the key.
+// Arguments:
+// - key: the cache key to append to.
+// - path: a file or directory that the generator depends on. It doesn't need to exist.
+void AppendPathToCacheKey(std::wstring& key, const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto lastWrite = std::filesystem::last_write_time(path, ec);
+    fmt::format_to(std::back_inserter(key), L"{}:{};", path.native(), ec ? 0 : lastWrite.time_since_epoch().count());
+}
@@ -313,4 +313,88 @@ namespace winrt::Microsoft::Terminal::Settings::Model
         // but it's pretty darn close to it, so... better than nothing.
         std::filesystem::rename(tmpPath, resolvedPath);
     }
+
+    namespace
+    {
+        // Writes files on the thread pool, so that nobody has to wait for the file system,
+        // which can take a long time for profiles that are redirected to a network share.
+        // Only the latest content queued for a path is written.
+        class BackgroundWriter
+        {
+        public:
+            BackgroundWriter() :
+                _work{ CreateThreadpoolWork(&_callback, this, nullptr) }
+            {
+                THROW_LAST_ERROR_IF(!_work);
+            }
+
+            void Write(const std::filesystem::path& path, std::string content)
+            {
+                {
+                    const std::scoped_lock lock{ _pendingLock };
+                    _pending.insert_or_assign(path, std::move(content));
+                }
+                SubmitThreadpoolWork(_work.get());
+            }
+
+            void Flush() const noexcept
+            {
+                WaitForThreadpoolWorkCallbacks(_work.get(), FALSE);
+            }
+
+        private:
+            static void NTAPI _callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+            {
+                static_cast<BackgroundWriter*>(context)->_run();
+            }
+
+            void _run() noexcept
+            {
+                // Callbacks can run concurrently, but the writes for a path must happen in order.
+                // Callbacks that follow one which already took their content simply find nothing to do.
+                const std::scoped_lock writeLock{ _writeLock };
+
+                std::map<std::filesystem::path, std::string> pending;
+                {
+                    const std::scoped_lock lock{ _pendingLock };
+                    pending.swap(_pending);
+                }
+
+                for (const auto& [path, content] : pending)
+                {
+                    try
+                    {
+                        WriteUTF8FileAtomic(path, content);
+                    }
+                    CATCH_LOG();
+                }
+            }
+
+            std::mutex _writeLock;
+            std::mutex _pendingLock;
+            std::map<std::filesystem::path, std::string> _pending;
+            // Last, so that it waits for the callbacks before the rest is destroyed.
+            wil::unique_threadpool_work _work;
+        };
+
+        BackgroundWriter& backgroundWriter()
+        {
+            static BackgroundWriter writer;
+            return writer;
+        }
+    }
+
+    // Like WriteUTF8FileAtomic, but returns immediately and writes the file on the
+    // thread pool instead. Errors are only logged. If it's called again for the same
+    // path before the previous content was written, only the new content is written.
+    void WriteUTF8FileAtomicInBackground(const std::filesystem::path& path, std::string content)
+    {
+        backgroundWriter().Write(path, std::move(content));
+    }
+
+    // Waits until all writes queued with WriteUTF8FileAtomicInBackground are done.
+    void FlushBackgroundWrites()
+    {
+        backgroundWriter().Flush();
+    }
 }
@@ -9,4 +9,6 @@ namespace winrt::Microsoft::Terminal::Settings::Model
     std::optional<std::string> ReadUTF8FileIfExists(const std::filesystem::path& path, const bool elevatedOnly = false);
     void WriteUTF8File(const std::filesystem::path& path, const std::string_view& content, const bool elevatedOnly = false);
     void WriteUTF8FileAtomic(const std::filesystem::path& path, const std::string_view& content);
+    void WriteUTF8FileAtomicInBackground(const std::filesystem::path& path, std::string content);
+    void FlushBackgroundWrites();
 }
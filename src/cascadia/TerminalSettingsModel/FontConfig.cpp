@@ -83,6 +83,20 @@ bool FontConfig::HasAnyOptionSet() const
     return HasFontFace() || HasFontSize() || HasFontWeight();
 }
 
+// Method Description:
+// - Resolves the value of each setting, see Profile::Freeze().
+// Arguments:
+// - frozen: the flag shared by all objects frozen together
+void FontConfig::Freeze(const std::shared_ptr<std::atomic<bool>>& frozen)
+{
+#define FONT_SETTINGS_FREEZE(type, name, jsonKey, ...) \
+    _freeze##name();
+    MTSM_FONT_SETTINGS(FONT_SETTINGS_FREEZE)
+#undef FONT_SETTINGS_FREEZE
+
+    _frozen = frozen;
+}
+
 winrt::Microsoft::Terminal::Settings::Model::Profile FontConfig::SourceProfile()
 {
     return _sourceProfile.get();
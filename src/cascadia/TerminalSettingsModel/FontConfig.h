@@ -36,6 +36,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Json::Value ToJson() const;
         void LayerJson(const Json::Value& json);
         bool HasAnyOptionSet() const;
+        void Freeze(const std::shared_ptr<std::atomic<bool>>& frozen);
 
         Model::Profile SourceProfile();
 
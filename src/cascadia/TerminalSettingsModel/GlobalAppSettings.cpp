@@ -49,6 +49,8 @@ void GlobalAppSettings::_FinalizeInheritance()
             }
         }
     }
+
+    _actionMap->FinalizeKeyBindings();
 }
 
 winrt::com_ptr<GlobalAppSettings> GlobalAppSettings::Copy() const
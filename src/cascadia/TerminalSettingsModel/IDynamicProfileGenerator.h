@@ -31,5 +31,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model
         virtual ~IDynamicProfileGenerator(){};
         virtual std::wstring_view GetNamespace() const noexcept = 0;
         virtual void GenerateProfiles(std::vector<winrt::com_ptr<implementation::Profile>>& profiles) const = 0;
+        // Returns a string that changes whenever GenerateProfiles() would generate different profiles.
+        // If it's cheaper to compute than running the generator, the generated profiles can be
+        // cached across launches. An empty string means the generator always needs to run.
+        virtual std::wstring GetCacheKey() const
+        {
+            return {};
+        }
     };
 };
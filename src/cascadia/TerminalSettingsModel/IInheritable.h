@@ -43,16 +43,19 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         void ClearParents()
         {
+            _Thaw();
             _parents.clear();
         }
 
         void AddLeastImportantParent(com_ptr<T> parent)
         {
+            _Thaw();
             _parents.emplace_back(std::move(parent));
         }
 
         void AddMostImportantParent(com_ptr<T> parent)
         {
+            _Thaw();
             _parents.emplace(_parents.begin(), std::move(parent));
         }
 
@@ -64,6 +67,26 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     protected:
         std::vector<com_ptr<T>> _parents{};
 
+        // Once the settings are loaded, the resolved value of each setting is
+        // stored alongside it (see the _freeze<NAME>() functions), so that
+        // reading it doesn't have to walk the parents over and over.
+        // All objects frozen together share this flag. Modifying any of them
+        // clears it, as their children's resolved values might be stale now.
+        std::shared_ptr<std::atomic<bool>> _frozen;
+
+        bool _IsFrozen() const noexcept
+        {
+            return _frozen && _frozen->load(std::memory_order_relaxed);
+        }
+
+        void _Thaw() noexcept
+        {
+            if (_frozen)
+            {
+                _frozen->store(false, std::memory_order_relaxed);
+            }
+        }
+
         // Method Description:
         // - Actions to be performed after a child was created. Generally used to set
         //   any extraneous data from the parent into the child.
@@ -108,14 +131,28 @@ public:                                                                     \
     /* Clear the user set value */                                          \
     void Clear##name()                                                      \
     {                                                                       \
+        _Thaw();                                                            \
         _##name = std::nullopt;                                             \
     }                                                                       \
                                                                             \
 private:                                                                    \
     storageType _##name{ std::nullopt };                                    \
+    storageType _resolved##name{ std::nullopt };                            \
+                                                                            \
+    /* Stores the resolved value. Must be done before _frozen is set. */    \
+    void _freeze##name()                                                    \
+    {                                                                       \
+        _resolved##name = _get##name##Impl();                               \
+    }                                                                       \
                                                                             \
     storageType _get##name##Impl() const                                    \
     {                                                                       \
+        /*frozen settings have resolved their value already*/               \
+        if (_IsFrozen())                                                    \
+        {                                                                   \
+            return _resolved##name;                                         \
+        }                                                                   \
+                                                                            \
         /*return user set value*/                                           \
         if (_##name)                                                        \
         {                                                                   \
@@ -182,6 +219,7 @@ public:                                                                      \
     /* Overwrite the user set value */                                       \
     void name(const type& value)                                             \
     {                                                                        \
+        _Thaw();                                                             \
         _##name = value;                                                     \
     }
 
@@ -211,6 +249,7 @@ public:                                                                        \
     /* Overwrite the user set value */                                         \
     void name(const winrt::Windows::Foundation::IReference<type>& value)       \
     {                                                                          \
+        _Thaw();                                                               \
         if (value) /*set value is different*/                                  \
         {                                                                      \
             _##name = std::optional<type>{ value.Value() };                    \
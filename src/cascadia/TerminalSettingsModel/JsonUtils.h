@@ -207,6 +207,56 @@ namespace Microsoft::Terminal::Settings::Model::JsonUtils
         return GetValueForKey<T>(json, key, ConversionTrait<typename std::decay<T>::type>{});
     }
 
+    // MemberParsers maps the keys of a JSON object to functions that parse
+    // their values into a T. Parse() then visits each member of an object
+    // once and looks up the member's key in a hash table. This is much faster
+    // than calling GetValueForKey for every key the object could have.
+    // Most settings objects contain only a handful of the keys they support,
+    // and each of those lookups walks the object's member map.
+    // Members without a parser are ignored, just like keys nobody asks for.
+    template<typename T>
+    class MemberParsers
+    {
+    public:
+        using Parser = void (*)(T& target, const Json::Value& json);
+
+        MemberParsers(std::initializer_list<std::pair<const std::string_view, Parser>> parsers) :
+            _parsers{ parsers }
+        {
+        }
+
+        void Parse(const Json::Value& json, T& target) const
+        {
+            if (!json.isObject())
+            {
+                return;
+            }
+
+            for (auto it = json.begin(), end = json.end(); it != end; ++it)
+            {
+                const char* keyEnd = nullptr;
+                const auto keyBegin = it.memberName(&keyEnd);
+                const std::string_view key{ keyBegin, gsl::narrow_cast<size_t>(keyEnd - keyBegin) };
+
+                if (const auto found = _parsers.find(key); found != _parsers.end())
+                {
+                    try
+                    {
+                        found->second(target, *it);
+                    }
+                    catch (DeserializationError& e)
+                    {
+                        e.SetKey(key);
+                        throw; // rethrow now that it has a key
+                    }
+                }
+            }
+        }
+
+    private:
+        std::unordered_map<std::string_view, Parser> _parsers;
+    };
+
     // Get multiple values for keys (json, k, &v, k, &v, k, &v, ...).
     // Uses the default converter for each v.
     // Careful: this can cause a template explosion.
@@ -26,6 +26,13 @@ Author(s):
     X(bool, FocusFollowMouse, "focusFollowMouse", false)                                                                                                   \
     X(bool, ForceFullRepaintRendering, "experimental.rendering.forceFullRepaint", false)                                                                   \
     X(bool, SoftwareRendering, "experimental.rendering.software", false)                                                                                   \
+    X(int32_t, MaxFrameRate, "experimental.rendering.maxFrameRate", 0)                                                                                     \
+    X(bool, ReduceFrameRateOnBattery, "experimental.rendering.reduceFrameRateOnBattery", false)                                                            \
+    X(int32_t, FloodControlThreshold, "experimental.floodControl.threshold", 0)                                                                            \
+    X(int32_t, FloodControlScrollback, "experimental.floodControl.scrollback", 0)                                                                          \
+    X(int32_t, MouseMoveInterval, "experimental.input.mouseMoveInterval", 0)                                                                               \
+    X(int32_t, PooledConsoleHosts, "experimental.connection.pooledConsoleHosts", 0)                                                                        \
+    X(bool, ShowRenderTimings, "experimental.rendering.showTimings", false)                                                                                \
     X(bool, UseBackgroundImageForWindow, "experimental.useBackgroundImageForWindow", false)                                                                \
     X(bool, ForceVTInput, "experimental.input.forceVT", false)                                                                                             \
     X(bool, TrimBlockSelection, "trimBlockSelection", true)                                                                                                \
@@ -58,6 +65,7 @@ Author(s):
     X(Model::WindowingMode, WindowingBehavior, "windowingBehavior", Model::WindowingMode::UseNew)                                                          \
     X(bool, MinimizeToNotificationArea, "minimizeToNotificationArea", false)                                                                               \
     X(bool, AlwaysShowNotificationIcon, "alwaysShowNotificationIcon", false)                                                                               \
+    X(bool, PreloadWindow, "experimental.preloadWindow", false)                                                                                            \
     X(winrt::Windows::Foundation::Collections::IVector<winrt::hstring>, DisabledProfileSources, "disabledProfileSources", nullptr)                         \
     X(bool, ShowAdminShield, "showAdminShield", true)                                                                                                      \
     X(bool, TrimPaste, "trimPaste", true)
@@ -82,7 +90,9 @@ Author(s):
     X(bool, Elevate, "elevate", false)                                                                                                                         \
     X(bool, VtPassthrough, "experimental.connection.passthroughMode", false)                                                                                   \
     X(bool, AutoMarkPrompts, "experimental.autoMarkPrompts", false)                                                                                            \
-    X(bool, ShowMarks, "experimental.showMarksOnScrollbar", false)
+    X(bool, ShowMarks, "experimental.showMarksOnScrollbar", false)                                                                                             \
+    X(bool, SpillScrollbackToDisk, "experimental.spillScrollbackToDisk", false)                                                                                \
+    X(bool, PredictiveEcho, "experimental.predictiveEcho", false)
 
 // Intentionally omitted Profile settings:
 // * Name
@@ -23,6 +23,13 @@ static constexpr std::wstring_view POWERSHELL_ICON{ L"ms-appx:///ProfileIcons/pw
 static constexpr std::wstring_view POWERSHELL_PREVIEW_ICON{ L"ms-appx:///ProfileIcons/pwsh-preview.png" };
 static constexpr std::wstring_view POWERSHELL_PREFERRED_PROFILE_NAME{ L"PowerShell" };
 
+// The directories searched for PowerShell instances, see _collectPowerShellInstances().
+static constexpr std::wstring_view TRADITIONAL_DIRECTORY{ L"%ProgramFiles%\\PowerShell" };
+static constexpr std::wstring_view TRADITIONAL_WOWX86_DIRECTORY{ L"%ProgramFiles(x86)%\\PowerShell" };
+static constexpr std::wstring_view TRADITIONAL_WOWARM_DIRECTORY{ L"%ProgramFiles(Arm)%\\PowerShell" };
+static constexpr std::wstring_view DOTNET_DIRECTORY{ L"%USERPROFILE%\\.dotnet\\tools" };
+static constexpr std::wstring_view SCOOP_DIRECTORY{ L"%USERPROFILE%\\scoop\\shims" };
+
 namespace
 {
     enum PowerShellFlags
@@ -265,20 +272,20 @@ static std::vector<PowerShellInstance> _collectPowerShellInstances()
 {
     std::vector<PowerShellInstance> versions;
 
-    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(L"%ProgramFiles%\\PowerShell", PowerShellFlags::None, versions);
+    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(TRADITIONAL_DIRECTORY, PowerShellFlags::None, versions);
 
 #if defined(_M_AMD64) || defined(_M_ARM64) // No point in looking for WOW if we're not somewhere it exists
-    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(L"%ProgramFiles(x86)%\\PowerShell", PowerShellFlags::WOWx86, versions);
+    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(TRADITIONAL_WOWX86_DIRECTORY, PowerShellFlags::WOWx86, versions);
 #endif
 
 #if defined(_M_ARM64) // no point in looking for WOA if we're not on ARM64
-    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(L"%ProgramFiles(Arm)%\\PowerShell", PowerShellFlags::WOWARM, versions);
+    _accumulateTraditionalLayoutPowerShellInstancesInDirectory(TRADITIONAL_WOWARM_DIRECTORY, PowerShellFlags::WOWARM, versions);
 #endif
 
     _accumulateStorePowerShellInstances(versions);
 
-    _accumulatePwshExeInDirectory(L"%USERPROFILE%\\.dotnet\\tools", PowerShellFlags::Dotnet, versions);
-    _accumulatePwshExeInDirectory(L"%USERPROFILE%\\scoop\\shims", PowerShellFlags::Scoop, versions);
+    _accumulatePwshExeInDirectory(DOTNET_DIRECTORY, PowerShellFlags::Dotnet, versions);
+    _accumulatePwshExeInDirectory(SCOOP_DIRECTORY, PowerShellFlags::Scoop, versions);
 
     std::sort(versions.rbegin(), versions.rend()); // sort in reverse (best first)
 
@@ -294,6 +301,59 @@ std::wstring_view PowershellCoreProfileGenerator::GetNamespace() const noexcept
     return PowershellCoreGeneratorNamespace;
 }
 
+// Function Description:
+// - Appends the traditional layout directory and the executables in it to the cache key.
+static void _appendTraditionalLayoutToCacheKey(std::wstring_view directory, std::wstring& key)
+{
+    const std::filesystem::path root{ wil::ExpandEnvironmentStringsW<std::wstring>(directory.data()) };
+    AppendPathToCacheKey(key, root);
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(root, ec))
+    {
+        for (const auto& versionedDir : std::filesystem::directory_iterator(root))
+        {
+            AppendPathToCacheKey(key, versionedDir.path() / PWSH_EXE);
+        }
+    }
+}
+
+// Method Description:
+// - Builds a key from the last write times of all locations that _collectPowerShellInstances() searches.
+//   Installing or removing an instance modifies at least one of them. This avoids asking
+//   the PackageManager for the store packages, which is what makes this generator slow.
+// Return Value:
+// - the cache key
+std::wstring PowershellCoreProfileGenerator::GetCacheKey() const
+{
+    std::wstring key;
+
+    _appendTraditionalLayoutToCacheKey(TRADITIONAL_DIRECTORY, key);
+#if defined(_M_AMD64) || defined(_M_ARM64)
+    _appendTraditionalLayoutToCacheKey(TRADITIONAL_WOWX86_DIRECTORY, key);
+#endif
+#if defined(_M_ARM64)
+    _appendTraditionalLayoutToCacheKey(TRADITIONAL_WOWARM_DIRECTORY, key);
+#endif
+
+    wil::unique_cotaskmem_string localAppDataFolder;
+    THROW_IF_FAILED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &localAppDataFolder));
+
+    std::filesystem::path appExecAliasPath{ localAppDataFolder.get() };
+    appExecAliasPath /= L"Microsoft";
+    appExecAliasPath /= L"WindowsApps";
+    AppendPathToCacheKey(key, appExecAliasPath / POWERSHELL_PREVIEW_PFN);
+    AppendPathToCacheKey(key, appExecAliasPath / POWERSHELL_PFN);
+
+    for (const auto directory : { DOTNET_DIRECTORY, SCOOP_DIRECTORY })
+    {
+        const std::filesystem::path root{ wil::ExpandEnvironmentStringsW<std::wstring>(directory.data()) };
+        AppendPathToCacheKey(key, root / PWSH_EXE);
+    }
+
+    return key;
+}
+
 // Method Description:
 // - Checks if pwsh is installed, and if it is, creates a profile to launch it.
 // Arguments:
@@ -40,6 +40,8 @@ void Profile::CreateUnfocusedAppearance()
 {
     if (!_UnfocusedAppearance)
     {
+        _Thaw();
+
         auto unfocusedAppearance{ winrt::make_self<implementation::AppearanceConfig>(weak_ref<Model::Profile>(*this)) };
 
         // If an unfocused appearance is defined in this profile, any undefined parameters are
@@ -54,6 +56,7 @@ void Profile::CreateUnfocusedAppearance()
 
 void Profile::DeleteUnfocusedAppearance()
 {
+    _Thaw();
     _UnfocusedAppearance = std::nullopt;
 }
 
@@ -165,23 +168,24 @@ void Profile::LayerJson(const Json::Value& json)
     fontInfoImpl->LayerJson(json);
 
     // Profile-specific Settings
-    JsonUtils::GetValueForKey(json, NameKey, _Name);
-    JsonUtils::GetValueForKey(json, UpdatesKey, _Updates);
-    JsonUtils::GetValueForKey(json, GuidKey, _Guid);
-    JsonUtils::GetValueForKey(json, HiddenKey, _Hidden);
-    JsonUtils::GetValueForKey(json, SourceKey, _Source);
-
-    // Padding was never specified as an integer, but it was a common working mistake.
-    // Allow it to be permissive.
-    JsonUtils::GetValueForKey(json, PaddingKey, _Padding, JsonUtils::OptionalConverter<hstring, JsonUtils::PermissiveStringConverter<std::wstring>>{});
-
-    JsonUtils::GetValueForKey(json, TabColorKey, _TabColor);
-
+    // There are many more of these than a typical profile has keys, so we
+    // visit the keys that are there instead of looking up every setting.
+    static const JsonUtils::MemberParsers<Profile> parsers{
+        { NameKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Name); } },
+        { UpdatesKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Updates); } },
+        { GuidKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Guid); } },
+        { HiddenKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Hidden); } },
+        { SourceKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Source); } },
+        // Padding was never specified as an integer, but it was a common working mistake.
+        // Allow it to be permissive.
+        { PaddingKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._Padding, JsonUtils::OptionalConverter<hstring, JsonUtils::PermissiveStringConverter<std::wstring>>{}); } },
+        { TabColorKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._TabColor); } },
 #define PROFILE_SETTINGS_LAYER_JSON(type, name, jsonKey, ...) \
-    JsonUtils::GetValueForKey(json, jsonKey, _##name);
-
-    MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_LAYER_JSON)
+    { jsonKey, [](Profile& p, const Json::Value& v) { JsonUtils::GetValue(v, p._##name); } },
+        MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_LAYER_JSON)
 #undef PROFILE_SETTINGS_LAYER_JSON
+    };
+    parsers.Parse(json, *this);
 
     if (json.isMember(JsonKey(UnfocusedAppearanceKey)))
     {
@@ -338,3 +342,35 @@ Json::Value Profile::ToJson() const
 
     return json;
 }
+
+// Method Description:
+// - Resolves the value of each setting, including those of our appearances
+//   and font, so that reading them doesn't walk the parents anymore.
+// - Called once the settings are loaded. Modifying any of the objects
+//   frozen with the same flag unfreezes all of them.
+// Arguments:
+// - frozen: the flag shared by all objects frozen together
+void Profile::Freeze(const std::shared_ptr<std::atomic<bool>>& frozen)
+{
+    winrt::get_self<FontConfig>(_FontInfo)->Freeze(frozen);
+    winrt::get_self<AppearanceConfig>(_DefaultAppearance)->Freeze(frozen);
+    if (const auto unfocused = UnfocusedAppearance())
+    {
+        winrt::get_self<AppearanceConfig>(unfocused)->Freeze(frozen);
+    }
+
+    _freezeTabColor();
+    _freezeUnfocusedAppearance();
+    _freezeName();
+    _freezeSource();
+    _freezeHidden();
+    _freezeGuid();
+    _freezePadding();
+
+#define PROFILE_SETTINGS_FREEZE(type, name, jsonKey, ...) \
+    _freeze##name();
+    MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_FREEZE)
+#undef PROFILE_SETTINGS_FREEZE
+
+    _frozen = frozen;
+}
@@ -94,6 +94,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static com_ptr<Profile> FromJson(const Json::Value& json);
         void LayerJson(const Json::Value& json);
         Json::Value ToJson() const;
+        void Freeze(const std::shared_ptr<std::atomic<bool>>& frozen);
 
         hstring EvaluatedStartingDirectory() const;
 
@@ -283,6 +283,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _Elevate = profile.Elevate();
         _AutoMarkPrompts = Feature_ScrollbarMarks::IsEnabled() && profile.AutoMarkPrompts();
         _ShowMarks = Feature_ScrollbarMarks::IsEnabled() && profile.ShowMarks();
+        _SpillScrollbackToDisk = profile.SpillScrollbackToDisk();
+        _PredictiveEcho = profile.PredictiveEcho();
     }
 
     // Method Description:
@@ -301,6 +303,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _FocusFollowMouse = globalSettings.FocusFollowMouse();
         _ForceFullRepaintRendering = globalSettings.ForceFullRepaintRendering();
         _SoftwareRendering = globalSettings.SoftwareRendering();
+        _MaxFrameRate = globalSettings.MaxFrameRate();
+        _ReduceFrameRateOnBattery = globalSettings.ReduceFrameRateOnBattery();
+        _FloodControlThreshold = globalSettings.FloodControlThreshold();
+        _FloodControlScrollback = globalSettings.FloodControlScrollback();
+        _MouseMoveInterval = globalSettings.MouseMoveInterval();
+        _ShowRenderTimings = globalSettings.ShowRenderTimings();
         _UseBackgroundImageForWindow = globalSettings.UseBackgroundImageForWindow();
         _ForceVTInput = globalSettings.ForceVTInput();
         _TrimBlockSelection = globalSettings.TrimBlockSelection();
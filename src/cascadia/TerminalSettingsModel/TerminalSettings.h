@@ -151,6 +151,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         INHERITABLE_SETTING(Model::TerminalSettings, bool, RetroTerminalEffect, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, ForceFullRepaintRendering, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, SoftwareRendering, false);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, MaxFrameRate, 0);
+        INHERITABLE_SETTING(Model::TerminalSettings, bool, ReduceFrameRateOnBattery, false);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, FloodControlThreshold, 0);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, FloodControlScrollback, 0);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, MouseMoveInterval, 0);
+        INHERITABLE_SETTING(Model::TerminalSettings, bool, ShowRenderTimings, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, UseBackgroundImageForWindow, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, ForceVTInput, false);
 
@@ -160,6 +166,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         INHERITABLE_SETTING(Model::TerminalSettings, bool, AutoMarkPrompts, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, ShowMarks, false);
+        INHERITABLE_SETTING(Model::TerminalSettings, bool, SpillScrollbackToDisk, false);
+        INHERITABLE_SETTING(Model::TerminalSettings, bool, PredictiveEcho, false);
 
     private:
         std::optional<std::array<Microsoft::Terminal::Core::Color, COLOR_TABLE_SIZE>> _ColorTable;
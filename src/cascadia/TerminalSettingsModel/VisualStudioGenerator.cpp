@@ -7,6 +7,8 @@
 #include "VsDevCmdGenerator.h"
 #include "VsDevShellGenerator.h"
 
+#include <shlobj.h>
+
 using namespace winrt::Microsoft::Terminal::Settings::Model;
 
 std::wstring_view VisualStudioGenerator::GetNamespace() const noexcept
@@ -14,6 +16,43 @@ std::wstring_view VisualStudioGenerator::GetNamespace() const noexcept
     return std::wstring_view{ L"Windows.Terminal.VisualStudio" };
 }
 
+// The Visual Studio Installer keeps a state.json for each installed instance in this directory.
+// It's rewritten whenever an instance is installed, modified or updated.
+static constexpr std::wstring_view InstancesPath{ L"Microsoft\\VisualStudio\\Packages\\_Instances" };
+
+// Querying the setup configuration requires activating its COM server, which is slow.
+// Enumerating the state files of all instances is much cheaper and changes whenever the result would.
+std::wstring VisualStudioGenerator::GetCacheKey() const
+{
+    wil::unique_cotaskmem_string programData;
+    THROW_IF_FAILED(SHGetKnownFolderPath(FOLDERID_ProgramData, 0, nullptr, &programData));
+
+    std::filesystem::path instancesPath{ programData.get() };
+    instancesPath /= InstancesPath;
+
+    // If the directory doesn't exist, Visual Studio is most likely not installed and
+    // the generator won't do anything expensive. It might also have moved,
+    // in which case we can't tell whether the cached profiles are still valid.
+    std::error_code ec;
+    if (!std::filesystem::is_directory(instancesPath, ec))
+    {
+        return {};
+    }
+
+    std::wstring key;
+    for (const auto& instance : std::filesystem::directory_iterator{ instancesPath })
+    {
+        if (instance.is_directory())
+        {
+            AppendPathToCacheKey(key, instance.path() / L"state.json");
+        }
+    }
+
+    // The key must not be empty, even if there are no instances.
+    key.push_back(L'.');
+    return key;
+}
+
 void VisualStudioGenerator::GenerateProfiles(std::vector<winrt::com_ptr<implementation::Profile>>& profiles) const
 {
     const auto instances = VsSetupConfiguration::QueryInstances();
@@ -28,6 +28,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model
     public:
         std::wstring_view GetNamespace() const noexcept override;
         void GenerateProfiles(std::vector<winrt::com_ptr<implementation::Profile>>& profiles) const override;
+        std::wstring GetCacheKey() const override;
 
         class IVisualStudioProfileGenerator
         {
@@ -37,6 +37,8 @@ namespace ControlUnitTests
         TEST_METHOD(TestClearScreen);
         TEST_METHOD(TestClearAll);
 
+        TEST_METHOD(TestInteractiveResize);
+
         TEST_CLASS_SETUP(ModuleSetup)
         {
             winrt::init_apartment(winrt::apartment_type::single_threaded);
@@ -341,4 +343,28 @@ namespace ControlUnitTests
         // The ConptyRoundtripTests test the actual clearing of the contents.
     }
 
+    void ControlCoreTests::TestInteractiveResize()
+    {
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        Log::Comment(L"Outside of an interactive resize, the buffer is resized immediately");
+        core->SizeChanged(360, 420);
+        VERIFY_ARE_EQUAL(40, core->_terminal->GetViewport().Width());
+
+        Log::Comment(L"During an interactive resize, the buffer keeps its size");
+        core->InteractiveResizeChanged(true);
+        core->SizeChanged(450, 420);
+        core->SizeChanged(540, 630);
+        VERIFY_ARE_EQUAL(40, core->_terminal->GetViewport().Width());
+        VERIFY_ARE_EQUAL(20, core->_terminal->GetViewport().Height());
+
+        Log::Comment(L"Once it ends, the last size is applied");
+        core->InteractiveResizeChanged(false);
+        VERIFY_ARE_EQUAL(60, core->_terminal->GetViewport().Width());
+        VERIFY_ARE_EQUAL(30, core->_terminal->GetViewport().Height());
+    }
 }
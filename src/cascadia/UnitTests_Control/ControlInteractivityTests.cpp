@@ -42,6 +42,7 @@ namespace ControlUnitTests
 
         TEST_METHOD(GetMouseEventsInTest);
         TEST_METHOD(AltBufferClampMouse);
+        TEST_METHOD(CoalesceMouseMoves);
 
         TEST_CLASS_SETUP(ClassSetup)
         {
@@ -966,4 +967,56 @@ namespace ControlUnitTests
                                       cursorPosition1.to_core_point());
         VERIFY_ARE_EQUAL(0u, expectedOutput.size(), L"Validate we drained all the expected output");
     }
+
+    void ControlInteractivityTests::CoalesceMouseMoves()
+    {
+        WEX::TestExecution::DisableVerifyExceptions disableVerifyExceptions{};
+
+        auto [settings, conn] = _createSettingsAndConnection();
+        // Long enough that the timer sending the held back move never fires during the test.
+        settings->MouseMoveInterval(60000);
+        auto [core, interactivity] = _createCoreAndInteractivity(*settings, *conn);
+        _standardInit(core, interactivity);
+        auto& term{ *core->_terminal };
+
+        std::deque<std::wstring> expectedOutput{};
+        auto validateDrained = _addInputCallback(conn, expectedOutput);
+
+        Log::Comment(L" --- Enable any-event mouse tracking ---");
+        term.Write(L"\x1b[?1003;1006h");
+
+        const auto modifiers = ControlKeyStates();
+        const Control::MouseButtonState noMouseDown{};
+        const auto leftMouseDown{ Control::MouseButtonState::IsLeftButtonDown };
+        const til::size fontSize{ 9, 21 };
+        const auto moveTo = [&](const til::point terminalPosition) {
+            interactivity->PointerMoved(noMouseDown,
+                                        WM_MOUSEMOVE, //pointerUpdateKind
+                                        modifiers,
+                                        true, // focused,
+                                        (terminalPosition * fontSize).to_core_point(),
+                                        true);
+        };
+
+        Log::Comment(L" --- The first move is sent right away ---");
+        expectedOutput.push_back(L"\x1b[<35;2;2m");
+        moveTo({ 1, 1 });
+        VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+        Log::Comment(L" --- Moves arriving right after it are held back ---");
+        moveTo({ 2, 1 });
+        moveTo({ 3, 1 });
+        VERIFY_IS_TRUE(core->_pendingMouseMove.has_value());
+
+        Log::Comment(L" --- A click sends the latest move first ---");
+        expectedOutput.push_back(L"\x1b[<35;4;2m");
+        expectedOutput.push_back(L"\x1b[<0;4;2M");
+        interactivity->PointerPressed(leftMouseDown,
+                                      WM_LBUTTONDOWN, //pointerUpdateKind
+                                      0, // timestamp
+                                      modifiers,
+                                      (til::point{ 3, 1 } * fontSize).to_core_point());
+        VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+        VERIFY_IS_FALSE(core->_pendingMouseMove.has_value());
+    }
 }
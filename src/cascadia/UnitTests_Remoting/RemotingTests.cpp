@@ -71,6 +71,7 @@ namespace RemotingUnitTests
         winrt::hstring WindowName() DIE;
         winrt::hstring ActiveTabTitle() DIE;
         void ActiveTabTitle(const winrt::hstring& /*value*/) DIE;
+        bool Preloaded() DIE;
         uint64_t GetPID() DIE;
         bool ExecuteCommandline(const Remoting::CommandlineArgs& /*args*/) DIE;
         void ActivateWindow(const Remoting::WindowActivatedArgs& /*args*/) DIE;
@@ -90,6 +91,7 @@ namespace RemotingUnitTests
         TYPED_EVENT(IdentifyWindowsRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(DisplayWindowIdRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(RenameRequested, winrt::Windows::Foundation::IInspectable, Remoting::RenameRequestArgs);
+        TYPED_EVENT(WindowNameChanged, winrt::Windows::Foundation::IInspectable, winrt::hstring);
         TYPED_EVENT(SummonRequested, winrt::Windows::Foundation::IInspectable, Remoting::SummonWindowBehavior);
         TYPED_EVENT(ShowNotificationIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(HideNotificationIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
@@ -109,6 +111,9 @@ namespace RemotingUnitTests
         void HandleActivatePeasant(Remoting::WindowActivatedArgs /*args*/) DIE;
         void SummonWindow(Remoting::SummonWindowSelectionArgs /*args*/) DIE;
         void SignalClose(uint64_t /*peasantId*/) DIE;
+        void SetPreloadedPeasant(uint64_t /*peasantId*/) DIE;
+        bool HasPreloadedPeasant() DIE;
+        void ClearPreloadedPeasant(uint64_t /*peasantId*/) DIE;
 
         void SummonAllWindows() DIE;
         bool DoesQuakeWindowExist() DIE;
@@ -142,6 +147,8 @@ namespace RemotingUnitTests
         TEST_METHOD(ProposeCommandlineCurrentWindow);
         TEST_METHOD(ProposeCommandlineNonExistentWindow);
         TEST_METHOD(ProposeCommandlineDeadWindow);
+        TEST_METHOD(ProposeCommandlineToPreloadedWindow);
+        TEST_METHOD(ClearPreloadedWindowAfterHandoff);
 
         TEST_METHOD(MostRecentWindowSameDesktops);
         TEST_METHOD(MostRecentWindowDifferentDesktops);
@@ -152,6 +159,7 @@ namespace RemotingUnitTests
         TEST_METHOD(MostRecentIsQuake);
 
         TEST_METHOD(GetPeasantsByName);
+        TEST_METHOD(MonarchTracksPeasantNames);
         TEST_METHOD(AddNamedPeasantsToNewMonarch);
         TEST_METHOD(LookupNamedPeasantWhenOthersDied);
         TEST_METHOD(LookupNamedPeasantWhenItDied);
@@ -658,6 +666,100 @@ namespace RemotingUnitTests
         }
     }
 
+    void RemotingTests::ProposeCommandlineToPreloadedWindow()
+    {
+        Log::Comment(L"Test that a commandline for a new window is handed to the preloaded window");
+
+        const auto monarch0PID = 12345u;
+        auto m0 = make_private<Remoting::implementation::Monarch>(monarch0PID);
+        m0->FindTargetWindowRequested(&RemotingTests::_findTargetWindowHelper);
+
+        Log::Comment(L"Add a regular and a preloaded peasant");
+        const auto peasant1PID = 23456u;
+        auto p1 = make_private<Remoting::implementation::Peasant>(peasant1PID);
+        m0->AddPeasant(*p1);
+
+        const auto peasant2PID = 34567u;
+        auto p2 = make_private<Remoting::implementation::Peasant>(peasant2PID);
+        p2->Preloaded(true);
+        m0->AddPeasant(*p2);
+
+        VERIFY_IS_TRUE(m0->HasPreloadedPeasant());
+        VERIFY_ARE_EQUAL(1u, m0->GetNumberOfPeasants());
+
+        Log::Comment(L"A second preloaded peasant is told to quit");
+        const auto peasant3PID = 45678u;
+        auto p3 = make_private<Remoting::implementation::Peasant>(peasant3PID);
+        auto p3Quit = false;
+        p3->QuitRequested([&](auto&&, auto&&) { p3Quit = true; });
+        p3->Preloaded(true);
+        m0->AddPeasant(*p3);
+        VERIFY_IS_TRUE(p3Quit);
+        _closePeasant(m0, p3->GetID());
+
+        auto p2Dispatched = false;
+        p1->ExecuteCommandlineRequested([&](auto&&, auto&&) {
+            VERIFY_IS_FALSE(true, L"p1 shouldn't receive the commandline");
+        });
+        p2->ExecuteCommandlineRequested([&](auto&&, const Remoting::CommandlineArgs& cmdlineArgs) {
+            Log::Comment(L"Commandline dispatched to p2");
+            VERIFY_IS_GREATER_THAN(cmdlineArgs.Commandline().size(), 1u);
+            VERIFY_ARE_EQUAL(L"arg[1]", cmdlineArgs.Commandline().at(1));
+            p2Dispatched = true;
+        });
+
+        std::vector<winrt::hstring> args{ L"-1", L"arg[1]" };
+        Remoting::CommandlineArgs eventArgs{ { args }, { L"" } };
+
+        auto result = m0->ProposeCommandline(eventArgs);
+        VERIFY_ARE_EQUAL(false, result.ShouldCreateWindow());
+        VERIFY_IS_TRUE(p2Dispatched);
+
+        Log::Comment(L"The preloaded window is used up - the next new window is created by the caller");
+        VERIFY_IS_FALSE(m0->HasPreloadedPeasant());
+        VERIFY_ARE_EQUAL(2u, m0->GetNumberOfPeasants());
+
+        result = m0->ProposeCommandline(eventArgs);
+        VERIFY_ARE_EQUAL(true, result.ShouldCreateWindow());
+        VERIFY_ARE_EQUAL(false, (bool)result.Id());
+    }
+
+    void RemotingTests::ClearPreloadedWindowAfterHandoff()
+    {
+        Log::Comment(L"Test that a preloaded window that received a default terminal handoff becomes a regular window");
+
+        const auto monarch0PID = 12345u;
+        auto m0 = make_private<Remoting::implementation::Monarch>(monarch0PID);
+        m0->FindTargetWindowRequested(&RemotingTests::_findTargetWindowHelper);
+
+        const auto peasant1PID = 23456u;
+        auto p1 = make_private<Remoting::implementation::Peasant>(peasant1PID);
+        p1->Preloaded(true);
+        m0->AddPeasant(*p1);
+
+        VERIFY_IS_TRUE(m0->HasPreloadedPeasant());
+        VERIFY_ARE_EQUAL(0u, m0->GetNumberOfPeasants());
+
+        Log::Comment(L"Clearing another peasant doesn't affect the preloaded one");
+        m0->ClearPreloadedPeasant(p1->GetID() + 1);
+        VERIFY_IS_TRUE(m0->HasPreloadedPeasant());
+
+        m0->ClearPreloadedPeasant(p1->GetID());
+        VERIFY_IS_FALSE(m0->HasPreloadedPeasant());
+        VERIFY_ARE_EQUAL(1u, m0->GetNumberOfPeasants());
+
+        Log::Comment(L"The next new window isn't handed to the former preloaded window");
+        p1->ExecuteCommandlineRequested([&](auto&&, auto&&) {
+            VERIFY_IS_FALSE(true, L"p1 shouldn't receive the commandline");
+        });
+
+        std::vector<winrt::hstring> args{ L"-1", L"arg[1]" };
+        Remoting::CommandlineArgs eventArgs{ { args }, { L"" } };
+
+        auto result = m0->ProposeCommandline(eventArgs);
+        VERIFY_ARE_EQUAL(true, result.ShouldCreateWindow());
+    }
+
     // TODO:projects/5
     //
     // In order to test WindowingBehaviorUseExisting, we'll have to
@@ -1124,6 +1226,58 @@ namespace RemotingUnitTests
         VERIFY_ARE_EQUAL(p2->GetID(), m0->_lookupPeasantIdForName(L"foo"));
     }
 
+    void RemotingTests::MonarchTracksPeasantNames()
+    {
+        Log::Comment(L"Test that the monarch's copy of the window names follows "
+                     L"the peasants, without asking them for their names");
+
+        const auto monarch0PID = 12345u;
+        const auto peasant1PID = 23456u;
+        const auto peasant2PID = 34567u;
+
+        auto m0 = make_private<Remoting::implementation::Monarch>(monarch0PID);
+        auto p1 = make_private<Remoting::implementation::Peasant>(peasant1PID);
+        auto p2 = make_private<Remoting::implementation::Peasant>(peasant2PID);
+
+        p1->WindowName(L"one");
+
+        m0->AddPeasant(*p1);
+        m0->AddPeasant(*p2);
+
+        VERIFY_ARE_EQUAL(2u, m0->_peasantNames.size());
+        VERIFY_ARE_EQUAL(L"one", m0->_peasantNames[p1->GetID()]);
+        VERIFY_ARE_EQUAL(L"", m0->_peasantNames[p2->GetID()]);
+        VERIFY_IS_FALSE(m0->DoesQuakeWindowExist());
+
+        {
+            Log::Comment(L"rename p2 to \"_quake\"");
+            Remoting::RenameRequestArgs eventArgs{ L"_quake" };
+            p2->RequestRename(eventArgs);
+            VERIFY_IS_TRUE(eventArgs.Succeeded());
+        }
+        VERIFY_ARE_EQUAL(L"_quake", m0->_peasantNames[p2->GetID()]);
+        VERIFY_IS_TRUE(m0->DoesQuakeWindowExist());
+
+        {
+            Log::Comment(L"Try to rename p1 to \"_quake\" too, which should fail");
+            Remoting::RenameRequestArgs eventArgs{ L"_quake" };
+            p1->RequestRename(eventArgs);
+            VERIFY_IS_FALSE(eventArgs.Succeeded());
+        }
+        VERIFY_ARE_EQUAL(L"one", m0->_peasantNames[p1->GetID()]);
+
+        Log::Comment(L"Kill the _quake window. Now, there's no _quake window anymore.");
+        RemotingTests::_killPeasant(m0, p2->GetID());
+        VERIFY_IS_FALSE(m0->DoesQuakeWindowExist());
+        VERIFY_ARE_EQUAL(1u, m0->_peasants.size());
+        VERIFY_ARE_EQUAL(1u, m0->_peasantNames.size());
+
+        Log::Comment(L"Close p1. The monarch should forget its name.");
+        m0->SignalClose(p1->GetID());
+        VERIFY_ARE_EQUAL(0u, m0->_peasantNames.size());
+        VERIFY_ARE_EQUAL(0, m0->_lookupPeasantIdForName(L"one"));
+    }
+
     void RemotingTests::AddNamedPeasantsToNewMonarch()
     {
         Log::Comment(L"Test that moving peasants to a new monarch persists their original names");
@@ -1171,8 +1325,8 @@ namespace RemotingUnitTests
     void RemotingTests::LookupNamedPeasantWhenOthersDied()
     {
         Log::Comment(L"Test that looking for a peasant by name when a different"
-                     L" peasant has died cleans up the corpses of any peasants "
-                     L"we may have tripped over.");
+                     L" peasant has died doesn't need to talk to the dead one, "
+                     L"and that the corpse is cleaned up once we trip over it.");
 
         const auto monarch0PID = 12345u;
         const auto peasant1PID = 23456u;
@@ -1202,15 +1356,17 @@ namespace RemotingUnitTests
         Log::Comment(L"Kill peasant 1. Make sure that it gets removed from the monarch.");
         RemotingTests::_killPeasant(m0, p1->GetID());
 
-        // By killing 1, then looking for "two", we happen to iterate over the
-        // corpse of 1 when looking for the peasant named "two". This causes us
-        // to remove 1 while looking for "two". Technically, we shouldn't be
-        // relying on any sort of ordering for an unordered_map iterator, but
-        // this one just so happens to work.
+        // The monarch knows the names of all the peasants, so it only talks
+        // to the peasant named "two" when looking for it. The corpse of 1 is
+        // left alone, until someone actually needs it.
         VERIFY_ARE_EQUAL(p2->GetID(), m0->_lookupPeasantIdForName(L"two"));
+        VERIFY_ARE_EQUAL(2u, m0->_peasants.size());
+
+        VERIFY_ARE_EQUAL(0, m0->_lookupPeasantIdForName(L"one"));
 
         Log::Comment(L"Peasant 1 should have been pruned");
         VERIFY_ARE_EQUAL(1u, m0->_peasants.size());
+        VERIFY_ARE_EQUAL(1u, m0->_peasantNames.size());
     }
 
     void RemotingTests::LookupNamedPeasantWhenItDied()
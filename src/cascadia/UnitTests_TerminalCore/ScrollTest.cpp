@@ -104,6 +104,9 @@ class TerminalCoreUnitTests::ScrollTest final
     TEST_CLASS(ScrollTest);
 
     TEST_METHOD(TestNotifyScrolling);
+    TEST_METHOD(ScrollMarksFollowCircledBuffer);
+    TEST_METHOD(TrimScrollback);
+    TEST_METHOD(TrimScrollbackReleasesMemory);
 
     TEST_METHOD_SETUP(MethodSetup)
     {
@@ -235,3 +238,102 @@ void ScrollTest::TestNotifyScrolling()
         }
     }
 }
+
+void ScrollTest::ScrollMarksFollowCircledBuffer()
+{
+    using Microsoft::Console::VirtualTerminal::DispatchTypes::MarkCategory;
+    using Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark;
+
+    auto& termSm = *_term->_stateMachine;
+    const auto totalBufferSize = _term->_mainBuffer->GetSize().Height();
+    const auto rowsCircled = 250;
+
+    WEX::TestExecution::SetVerifyOutput settings(WEX::TestExecution::VerifyOutputSettings::LogOnlyFailures);
+
+    ScrollMark mark;
+    mark.category = MarkCategory::Prompt;
+
+    Log::Comment(L"Leave a mark on every 100th line, until the buffer circled past the first three of them.");
+    const auto lineCount = totalBufferSize + rowsCircled;
+    for (auto line = 0; line < lineCount; line++)
+    {
+        if (line % 100 == 0)
+        {
+            _term->AddMark(mark);
+        }
+        termSm.ProcessString(L"X\r\n");
+    }
+
+    // The cursor ends up on the last row, so one more row than rowsCircled was pushed off the top.
+    const auto rowsPushedOff = lineCount - (totalBufferSize - 1);
+
+    const auto marks = _term->GetScrollMarks();
+    VERIFY_ARE_EQUAL(static_cast<size_t>((lineCount - 1) / 100 - 2), marks.size());
+    auto line = 300;
+    for (const auto& m : marks)
+    {
+        VERIFY_ARE_EQUAL(line - rowsPushedOff, m.start.y);
+        VERIFY_ARE_EQUAL(m.start, m.end);
+        line += 100;
+    }
+
+    Log::Comment(L"Look up the marks around the first one.");
+    const auto firstRow = 300 - rowsPushedOff;
+    VERIFY_IS_FALSE(_term->GetScrollMarkBefore(firstRow).has_value());
+    VERIFY_ARE_EQUAL(firstRow, _term->GetScrollMarkBefore(firstRow + 1)->start.y);
+    VERIFY_ARE_EQUAL(firstRow, _term->GetScrollMarkAfter(-1)->start.y);
+    VERIFY_ARE_EQUAL(firstRow + 100, _term->GetScrollMarkAfter(firstRow)->start.y);
+    VERIFY_ARE_EQUAL(marks.back().start.y, _term->GetScrollMarkBefore(totalBufferSize)->start.y);
+    VERIFY_IS_FALSE(_term->GetScrollMarkAfter(marks.back().start.y).has_value());
+}
+
+void ScrollTest::TrimScrollback()
+{
+    auto& termSm = *_term->_stateMachine;
+    auto& tb = *_term->_mainBuffer;
+
+    Log::Comment(L"Write 200 numbered lines, which puts 169 of them into the scrollback.");
+    for (auto line = 0; line < 200; line++)
+    {
+        termSm.ProcessString(fmt::format(L"{}\r\n", line));
+    }
+    VERIFY_ARE_EQUAL(200 - (TerminalViewHeight - 1), _term->GetViewport().top);
+
+    Log::Comment(L"Keep only the last 50 lines of the scrollback.");
+    _term->TrimScrollback(50);
+
+    const auto discarded = 200 - (TerminalViewHeight - 1) - 50;
+    VERIFY_ARE_EQUAL(50, _term->GetViewport().top);
+    VERIFY_ARE_EQUAL(200 - discarded, tb.GetCursor().GetPosition().Y);
+    TestUtils::VerifyExpectedString(tb, fmt::format(L"{}", discarded), { 0, 0 });
+    TestUtils::VerifyExpectedString(tb, L"199", { 0, 199 - discarded });
+    TestUtils::VerifyExpectedString(tb, L"   ", { 0, 200 - discarded });
+
+    Log::Comment(L"Trimming to more than there is does nothing.");
+    _term->TrimScrollback(100);
+    VERIFY_ARE_EQUAL(50, _term->GetViewport().top);
+}
+
+void ScrollTest::TrimScrollbackReleasesMemory()
+{
+    auto& termSm = *_term->_stateMachine;
+
+    Log::Comment(L"Write enough lines for the oldest ones to get frozen.");
+    for (auto line = 0; line < 4000; line++)
+    {
+        termSm.ProcessString(fmt::format(L"{}\r\n", line));
+    }
+
+    const auto before = _term->GetMemoryFootprint();
+    _term->TrimScrollback(50);
+    const auto after = _term->GetMemoryFootprint();
+    Log::Comment(NoThrowString().Format(L"Footprint before: %zu, after: %zu", before, after));
+    VERIFY_IS_LESS_THAN(after, before);
+
+    Log::Comment(L"The discarded rows are thawed again once they're written to.");
+    for (auto line = 0; line < 100; line++)
+    {
+        termSm.ProcessString(fmt::format(L"{}\r\n", line));
+    }
+    TestUtils::VerifyExpectedString(*_term->_mainBuffer, L"99", { 0, _term->_mainBuffer->GetCursor().GetPosition().Y - 1 });
+}
@@ -841,5 +841,27 @@ namespace TerminalCoreUnitTests
                 ValidateSingleRowSelection(term, til::inclusive_rect({ 10, 10, 20, 10 }));
             }
         }
+
+        TEST_METHOD(HighlightRectsSplitWrappedMatches)
+        {
+            Terminal term;
+            DummyRenderer renderer{ &term };
+            term.Create({ 100, 100 }, 0, renderer);
+
+            term.SetSearchHighlights({
+                { { 95, 0 }, { 4, 1 } },
+                { { 10, 5 }, { 12, 5 } },
+                { { 0, 150 }, { 3, 150 } },
+            });
+
+            const auto rects = term.GetVisibleHighlightRects();
+            VERIFY_ARE_EQUAL(3u, rects.size());
+            VERIFY_ARE_EQUAL(til::inclusive_rect({ 95, 0, 99, 0 }), rects[0].ToInclusive());
+            VERIFY_ARE_EQUAL(til::inclusive_rect({ 0, 1, 4, 1 }), rects[1].ToInclusive());
+            VERIFY_ARE_EQUAL(til::inclusive_rect({ 10, 5, 12, 5 }), rects[2].ToInclusive());
+
+            term.SetSearchHighlights({});
+            VERIFY_ARE_EQUAL(0u, term.GetVisibleHighlightRects().size());
+        }
     };
 }
@@ -34,13 +34,21 @@ namespace TerminalCoreUnitTests
         // PrintString() is called with more code units than the buffer width.
         TEST_METHOD(PrintStringOfSurrogatePairs);
         TEST_METHOD(CheckDoubleWidthCursor);
+        TEST_METHOD(PrintStringAcrossRows);
 
         TEST_METHOD(AddHyperlink);
         TEST_METHOD(AddHyperlinkCustomId);
         TEST_METHOD(AddHyperlinkCustomIdDifferentUri);
+        TEST_METHOD(HyperlinkSpansInViewportRow);
 
         TEST_METHOD(SetTaskbarProgress);
         TEST_METHOD(SetWorkingDirectory);
+
+        TEST_METHOD(ShellIntegrationCommandBlocks);
+
+        TEST_METHOD(WriteStatistics);
+
+        TEST_METHOD(PredictiveEcho);
     };
 };
 
@@ -258,6 +266,32 @@ void TerminalApiTest::CheckDoubleWidthCursor()
     VERIFY_IS_TRUE(term.IsCursorDoubleWidth());
 }
 
+void TerminalApiTest::PrintStringAcrossRows()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 100, 100 }, 0, renderer);
+
+    auto& tbi = *(term._mainBuffer);
+    auto& cursor = tbi.GetCursor();
+
+    Log::Comment(L"A run longer than a row is written a row at a time and wraps onto the following rows.");
+    term.PrintString(std::wstring(250, L'B'));
+    VERIFY_ARE_EQUAL(til::point(50, 2), cursor.GetPosition());
+    VERIFY_ARE_EQUAL(L"B", tbi.GetCellDataAt({ 99, 1 })->Chars());
+    VERIFY_ARE_EQUAL(L"B", tbi.GetCellDataAt({ 49, 2 })->Chars());
+    VERIFY_ARE_EQUAL(L" ", tbi.GetCellDataAt({ 50, 2 })->Chars());
+
+    Log::Comment(L"A wide glyph that doesn't fit into the last column is moved to the next row.");
+    cursor.SetPosition({ 0, 3 });
+    term.PrintString(std::wstring(99, L'A') + L"我A");
+    VERIFY_ARE_EQUAL(L"A", tbi.GetCellDataAt({ 98, 3 })->Chars());
+    VERIFY_ARE_EQUAL(L" ", tbi.GetCellDataAt({ 99, 3 })->Chars());
+    VERIFY_ARE_EQUAL(L"我", tbi.GetCellDataAt({ 0, 4 })->Chars());
+    VERIFY_ARE_EQUAL(L"A", tbi.GetCellDataAt({ 2, 4 })->Chars());
+    VERIFY_ARE_EQUAL(til::point(3, 4), cursor.GetPosition());
+}
+
 void TerminalCoreUnitTests::TerminalApiTest::AddHyperlink()
 {
     // This is a nearly literal copy-paste of ScreenBufferTests::TestAddHyperlink, adapted for the Terminal
@@ -342,6 +376,42 @@ void TerminalCoreUnitTests::TerminalApiTest::AddHyperlinkCustomIdDifferentUri()
     VERIFY_ARE_NOT_EQUAL(oldAttributes.GetHyperlinkId(), tbi.GetCurrentAttributes().GetHyperlinkId());
 }
 
+void TerminalCoreUnitTests::TerminalApiTest::HyperlinkSpansInViewportRow()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 100, 100 }, 0, renderer);
+
+    auto& stateMachine = *(term._stateMachine);
+    stateMachine.ProcessString(L"ab\x1b]8;;test.url\x1b\\link\x1b]8;;\x1b\\cd");
+
+    const auto stamp = term.GetHyperlinkRowStamp(0);
+    const auto spans = term.GetHyperlinkSpansInViewportRow(0);
+    VERIFY_ARE_EQUAL(3u, spans.size());
+    VERIFY_ARE_EQUAL(0, spans[0].left);
+    VERIFY_ARE_EQUAL(1, spans[0].right);
+    VERIFY_ARE_EQUAL(2, spans[1].left);
+    VERIFY_ARE_EQUAL(5, spans[1].right);
+    VERIFY_ARE_EQUAL(6, spans[2].left);
+    VERIFY_ARE_EQUAL(99, spans[2].right);
+
+    // Every span has to agree with the per-cell queries the hover logic would otherwise use.
+    for (const auto& span : spans)
+    {
+        for (auto x = span.left; x <= span.right; ++x)
+        {
+            VERIFY_ARE_EQUAL(term.GetHyperlinkIdAtViewportPosition({ x, 0 }), span.id);
+            VERIFY_IS_TRUE(term.GetHyperlinkIntervalFromViewportPosition({ x, 0 }) == span.interval);
+        }
+    }
+    VERIFY_IS_TRUE(spans[1].id != 0);
+
+    // The stamp only changes once the row does.
+    VERIFY_IS_TRUE(stamp == term.GetHyperlinkRowStamp(0));
+    stateMachine.ProcessString(L"\x1b[1;1Hx");
+    VERIFY_IS_FALSE(stamp == term.GetHyperlinkRowStamp(0));
+}
+
 void TerminalCoreUnitTests::TerminalApiTest::SetTaskbarProgress()
 {
     Terminal term;
@@ -468,3 +538,125 @@ void TerminalCoreUnitTests::TerminalApiTest::SetWorkingDirectory()
     stateMachine.ProcessString(L"\x1b]9;9;\"\"\"\"\x1b\\");
     VERIFY_ARE_EQUAL(term.GetWorkingDirectory(), L"\"\"");
 }
+
+void TerminalCoreUnitTests::TerminalApiTest::ShellIntegrationCommandBlocks()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 80, 32 }, 100, renderer);
+
+    auto& stateMachine = *(term._stateMachine);
+
+    // This is what FTCS A, B, C and D do, minus the feature flag check.
+    const auto runCommand = [&](const std::wstring_view command, const std::wstring_view output, const unsigned int exitCode) {
+        DispatchTypes::ScrollMark prompt;
+        prompt.category = DispatchTypes::MarkCategory::Prompt;
+        term.AddMark(prompt);
+        stateMachine.ProcessString(L"PS> ");
+        term.MarkCommandStart();
+        stateMachine.ProcessString(command);
+        stateMachine.ProcessString(L"\r\n");
+        term.MarkOutputStart();
+        stateMachine.ProcessString(output);
+        term.MarkCommandFinish(exitCode);
+    };
+
+    runCommand(L"dir", L"a\r\nb\r\n", 0);
+    runCommand(L"bad", L"oops\r\n", 1);
+    runCommand(L"echo", L"hi\r\n", 0);
+    runCommand(L"worse", L"nope\r\n", 2);
+
+    const auto marks = term.GetScrollMarks();
+    VERIFY_ARE_EQUAL(4u, marks.size());
+    VERIFY_ARE_EQUAL(til::point(4, 0), marks[0].commandStart.value());
+    VERIFY_ARE_EQUAL(til::point(0, 1), marks[0].outputStart.value());
+    VERIFY_ARE_EQUAL(til::point(0, 3), marks[0].outputEnd.value());
+    VERIFY_ARE_EQUAL(DispatchTypes::MarkCategory::Success, marks[0].category);
+    VERIFY_ARE_EQUAL(1u, marks[1].exitCode.value());
+    VERIFY_ARE_EQUAL(DispatchTypes::MarkCategory::Error, marks[1].category);
+
+    const auto output = term.GetCommandOutput(0);
+    VERIFY_IS_TRUE(output.has_value());
+    VERIFY_ARE_EQUAL(til::point(0, 1), output->first);
+    VERIFY_ARE_EQUAL(til::point(0, 3), output->second);
+    VERIFY_IS_FALSE(term.GetCommandOutput(4).has_value());
+
+    VERIFY_ARE_EQUAL(L"nope", term.GetLastCommandOutput());
+
+    auto failed = term.GetFailedCommandAfter(-1);
+    VERIFY_IS_TRUE(failed.has_value());
+    VERIFY_ARE_EQUAL(3, failed->start.y);
+    failed = term.GetFailedCommandAfter(failed->start.y);
+    VERIFY_IS_TRUE(failed.has_value());
+    VERIFY_ARE_EQUAL(7, failed->start.y);
+    VERIFY_IS_FALSE(term.GetFailedCommandAfter(failed->start.y).has_value());
+
+    // Clearing a failed mark also removes it from the failed command index.
+    stateMachine.ProcessString(L"\x1b[8;1H");
+    term.ClearMark();
+    VERIFY_ARE_EQUAL(3u, term.GetScrollMarks().size());
+    VERIFY_ARE_EQUAL(3, term.GetFailedCommandAfter(-1)->start.y);
+}
+
+void TerminalCoreUnitTests::TerminalApiTest::WriteStatistics()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 100, 100 }, 0, renderer);
+
+    VERIFY_ARE_EQUAL(0u, term.GetWriteStatistics().writes);
+
+    term.Write(L"abc\r\n");
+    term.Write(L"\x1b[31mred\x1b[m");
+
+    const auto& statistics = term.GetWriteStatistics();
+    VERIFY_ARE_EQUAL(2u, statistics.writes);
+    VERIFY_ARE_EQUAL(16u, statistics.chars);
+    VERIFY_ARE_EQUAL(2u, statistics.sequences);
+}
+
+void TerminalCoreUnitTests::TerminalApiTest::PredictiveEcho()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 100, 100 }, 0, renderer);
+    term._predictiveEcho = true;
+
+    Log::Comment(L"Predictions are shown after the cursor until they're echoed.");
+    term.Write(L"$ ");
+    term.PredictInput(L"ls");
+    VERIFY_ARE_EQUAL(2u, term._predictions.size());
+
+    const auto overlays = term.GetOverlays();
+    VERIFY_ARE_EQUAL(1u, overlays.size());
+    VERIFY_ARE_EQUAL(til::point(0, 0), overlays[0].origin);
+    VERIFY_ARE_EQUAL(til::rect(2, 0, 4, 1), overlays[0].region.ToExclusive());
+    VERIFY_IS_TRUE(*overlays[0].buffer.GetTextDataAt({ 0, 0 }) == L"$");
+    VERIFY_IS_TRUE(*overlays[0].buffer.GetTextDataAt({ 3, 0 }) == L"s");
+
+    term.Write(L"l");
+    VERIFY_ARE_EQUAL(1u, term._predictions.size());
+    term.Write(L"s");
+    VERIFY_IS_TRUE(term._predictions.empty());
+    VERIFY_IS_TRUE(term.GetOverlays().empty());
+
+    Log::Comment(L"An echo that doesn't match discards the predictions until the next carriage return.");
+    term.PredictInput(L"x");
+    term.Write(L"*");
+    VERIFY_IS_TRUE(term._predictions.empty());
+    term.PredictInput(L"y");
+    VERIFY_IS_TRUE(term._predictions.empty());
+    term.PredictInput(L"\r");
+    term.Write(L"\r\n$ ");
+    term.PredictInput(L"z");
+    VERIFY_ARE_EQUAL(1u, term._predictions.size());
+
+    Log::Comment(L"Backspaces undo predictions.");
+    term.PredictInput(L"\x7f");
+    VERIFY_IS_TRUE(term._predictions.empty());
+
+    Log::Comment(L"No predictions are made in the alternate screen buffer.");
+    term.Write(L"\x1b[?1049h");
+    term.PredictInput(L"q");
+    VERIFY_IS_TRUE(term._predictions.empty());
+}
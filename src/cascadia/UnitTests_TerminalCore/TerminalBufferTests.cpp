@@ -53,6 +53,8 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestCursorNotifications);
 
+    TEST_METHOD(TestAltBufferReuse);
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -636,3 +638,33 @@ void TerminalBufferTests::TestCursorNotifications()
     VERIFY_ARE_EQUAL(0, expectedCallbacks);
     VERIFY_IS_TRUE(callbackWasCalled);
 }
+
+void TerminalBufferTests::TestAltBufferReuse()
+{
+    auto& termSm = *term->_stateMachine;
+
+    Log::Comment(L"Write some colored text into the alt buffer and leave it again");
+    termSm.ProcessString(L"\x1b[?1049h");
+    VERIFY_IS_TRUE(term->_inAltBuffer());
+    const auto firstAltBuffer = term->_altBuffer.get();
+    termSm.ProcessString(L"\x1b[31mHello\r\nWorld");
+    termSm.ProcessString(L"\x1b[?1049l");
+    VERIFY_IS_FALSE(term->_inAltBuffer());
+
+    Log::Comment(L"Entering the alt buffer again should reuse the previous buffer, but cleared");
+    termSm.ProcessString(L"\x1b[?1049h");
+    VERIFY_IS_TRUE(term->_inAltBuffer());
+    auto& altTb = *term->_altBuffer;
+    VERIFY_ARE_EQUAL(firstAltBuffer, &altTb);
+    VERIFY_ARE_EQUAL(TextAttribute{}, altTb.GetCurrentAttributes());
+    TestUtils::VerifyExpectedString(altTb, L"     ", { 0, 0 });
+    TestUtils::VerifyExpectedString(altTb, L"     ", { 0, 1 });
+    VERIFY_ARE_EQUAL(TextAttribute{}, altTb.GetRowByOffset(0).GetAttrRow().GetAttrByColumn(0));
+    termSm.ProcessString(L"\x1b[?1049l");
+
+    Log::Comment(L"After a resize the alt buffer has to be created anew");
+    VERIFY_SUCCEEDED(term->UserResize({ TerminalViewWidth + 10, TerminalViewHeight }));
+    termSm.ProcessString(L"\x1b[?1049h");
+    VERIFY_IS_TRUE(term->_inAltBuffer());
+    VERIFY_ARE_EQUAL(TerminalViewWidth + 10, term->_altBuffer->GetSize().Width());
+}
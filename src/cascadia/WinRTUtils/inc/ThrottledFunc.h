@@ -8,7 +8,7 @@
 // ThrottledFunc is a copy of til::throttled_func,
 // specialized for the use with a WinRT Dispatcher.
 template<bool leading, typename... Args>
-class ThrottledFunc : public std::enable_shared_from_this<ThrottledFunc<leading, Args...>>
+class ThrottledFunc : public std::enable_shared_from_this<ThrottledFunc<leading, Args...>>, til::details::throttled_func_timer::client
 {
 public:
     using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
@@ -27,21 +27,24 @@ public:
         winrt::Windows::System::DispatcherQueue dispatcher,
         filetime_duration delay,
         function func) :
+        _delay{ delay },
         _dispatcher{ std::move(dispatcher) },
         _func{ std::move(func) },
-        _timer{ _create_timer() }
+        _timer{ til::details::throttled_func_timer::instance() }
     {
-        const auto d = -delay.count();
-        if (d >= 0)
+        if (delay.count() <= 0)
         {
             throw std::invalid_argument("non-positive delay specified");
         }
+    }
 
-        memcpy(&_delay, &d, sizeof(d));
+    ~ThrottledFunc() override
+    {
+        _timer.cancel(*this);
     }
 
-    // ThrottledFunc uses its `this` pointer when creating _timer.
-    // Since the timer cannot be recreated, instances cannot be moved either.
+    // ThrottledFunc hands its `this` pointer to the shared timer.
+    // Instances cannot be moved, because a callback may be pending.
     ThrottledFunc(const ThrottledFunc&) = delete;
     ThrottledFunc& operator=(const ThrottledFunc&) = delete;
     ThrottledFunc(ThrottledFunc&&) = delete;
@@ -72,9 +75,9 @@ public:
     }
 
 private:
-    static void __stdcall _timer_callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+    void timer_fired() override
     {
-        static_cast<ThrottledFunc*>(context)->_trailing_edge();
+        _trailing_edge();
     }
 
     void _leading_edge()
@@ -90,13 +93,13 @@ private:
                     }
                     CATCH_LOG();
 
-                    SetThreadpoolTimerEx(self->_timer.get(), &self->_delay, 0, 0);
+                    self->_timer.schedule(*self, self->_delay);
                 }
             });
         }
         else
         {
-            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+            _timer.schedule(*this, _delay);
         }
     }
 
@@ -121,18 +124,11 @@ private:
         }
     }
 
-    inline wil::unique_threadpool_timer _create_timer()
-    {
-        wil::unique_threadpool_timer timer{ CreateThreadpoolTimer(&_timer_callback, this, nullptr) };
-        THROW_LAST_ERROR_IF(!timer);
-        return timer;
-    }
-
-    FILETIME _delay;
+    filetime_duration _delay;
     winrt::Windows::System::DispatcherQueue _dispatcher;
     function _func;
 
-    wil::unique_threadpool_timer _timer;
+    til::details::throttled_func_timer& _timer;
     til::details::throttled_func_storage<Args...> _storage;
 };
 
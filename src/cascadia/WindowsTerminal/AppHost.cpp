@@ -105,6 +105,9 @@ AppHost::AppHost() noexcept :
     _window->SetAlwaysOnTop(_logic.GetInitialAlwaysOnTop());
     _window->SetAutoHideWindow(_logic.AutoHideWindow());
 
+    // A preloaded window stays hidden until it's handed a commandline.
+    _window->SetHiddenOnCreate(_logic.IsPreloadedWindow());
+
     _window->MakeWindow();
 
     _GetWindowLayoutRequestedToken = _windowManager.GetWindowLayoutRequested([this](auto&&, const winrt::Microsoft::Terminal::Remoting::GetWindowLayoutArgs& args) {
@@ -236,24 +239,7 @@ void AppHost::_HandleCommandlineArgs()
         if (auto args{ peasant.InitialArgs() })
         {
             const auto result = _logic.SetStartupCommandline(args.Commandline());
-            const auto message = _logic.ParseCommandlineMessage();
-            if (!message.empty())
-            {
-                const auto displayHelp = result == 0;
-                const auto messageTitle = displayHelp ? IDS_HELP_DIALOG_TITLE : IDS_ERROR_DIALOG_TITLE;
-                const auto messageIcon = displayHelp ? MB_ICONWARNING : MB_ICONERROR;
-                // TODO:GH#4134: polish this dialog more, to make the text more
-                // like msiexec /?
-                MessageBoxW(nullptr,
-                            message.data(),
-                            GetStringResource(messageTitle).data(),
-                            MB_OK | messageIcon);
-
-                if (_logic.ShouldExitEarly())
-                {
-                    ExitProcess(result);
-                }
-            }
+            _DisplayCommandlineMessage(result);
         }
 
         // This is a fix for GH#12190 and hopefully GH#12169.
@@ -288,7 +274,8 @@ void AppHost::_HandleCommandlineArgs()
         {
             const auto numPeasants = _windowManager.GetNumberOfPeasants();
             const auto layouts = ApplicationState::SharedInstance().PersistedWindowLayouts();
-            if (_logic.ShouldUsePersistedLayout() &&
+            if (!_logic.IsPreloadedWindow() &&
+                _logic.ShouldUsePersistedLayout() &&
                 layouts &&
                 layouts.Size() > 0)
             {
@@ -390,6 +377,7 @@ void AppHost::Initialize()
     _window->DragRegionClicked([this]() { _logic.TitlebarClicked(); });
 
     _window->WindowVisibilityChanged([this](bool showOrHide) { _logic.WindowVisibilityChanged(showOrHide); });
+    _window->InteractiveResizeChanged([this](bool inProgress) { _logic.InteractiveResizeChanged(inProgress); });
 
     _revokers.RequestedThemeChanged = _logic.RequestedThemeChanged(winrt::auto_revoke, { this, &AppHost::_UpdateTheme });
     _revokers.FullscreenChanged = _logic.FullscreenChanged(winrt::auto_revoke, { this, &AppHost::_FullscreenChanged });
@@ -464,6 +452,45 @@ void AppHost::Initialize()
     // get cleaned up normally when our process exits.
     auto a{ _app };
     ::winrt::detach_abi(a);
+
+    // Only offer ourselves up as the preloaded window once we're all set up.
+    if (_logic.IsPreloadedWindow())
+    {
+        _windowManager.RegisterPreloadedWindow();
+    }
+}
+
+// Method Description:
+// - Displays the message the logic produced while parsing our commandline, if
+//   there is one, and exits if the logic says we should.
+//    * We display a message box because we're a Win32 application (not a
+//      console app), and the shell has undoubtedly returned to the foreground
+//      of the console. Text emitted here might mix unexpectedly with output
+//      from the shell process.
+// Arguments:
+// - result: the result of parsing the commandline
+// Return Value:
+// - <none>
+void AppHost::_DisplayCommandlineMessage(const int32_t result)
+{
+    const auto message = _logic.ParseCommandlineMessage();
+    if (!message.empty())
+    {
+        const auto displayHelp = result == 0;
+        const auto messageTitle = displayHelp ? IDS_HELP_DIALOG_TITLE : IDS_ERROR_DIALOG_TITLE;
+        const auto messageIcon = displayHelp ? MB_ICONWARNING : MB_ICONERROR;
+        // TODO:GH#4134: polish this dialog more, to make the text more
+        // like msiexec /?
+        MessageBoxW(nullptr,
+                    message.data(),
+                    GetStringResource(messageTitle).data(),
+                    MB_OK | messageIcon);
+
+        if (_logic.ShouldExitEarly())
+        {
+            ExitProcess(result);
+        }
+    }
 }
 
 // Method Description:
@@ -860,6 +887,14 @@ bool AppHost::HasWindow()
 void AppHost::_DispatchCommandline(winrt::Windows::Foundation::IInspectable sender,
                                    Remoting::CommandlineArgs args)
 {
+    // If we're the preloaded window, this is the commandline of the window
+    // we're about to become, not something to run in an existing one.
+    if (_logic.IsPreloadedWindow())
+    {
+        _LaunchPreloadedWindow(args);
+        return;
+    }
+
     const Remoting::SummonWindowBehavior summonArgs{};
     summonArgs.MoveToCurrentDesktop(false);
     summonArgs.DropdownDuration(0);
@@ -871,6 +906,72 @@ void AppHost::_DispatchCommandline(winrt::Windows::Foundation::IInspectable send
     _logic.ExecuteCommandline(args.Commandline(), args.CurrentDirectory());
 }
 
+// Method Description:
+// - Turns this preloaded window into a regular one, running the given
+//   commandline as if we had been started with it. Since the window and its
+//   XAML content already exist at this point, this is a lot quicker than
+//   starting a new process for it.
+// Arguments:
+// - args: the commandline and working directory of the new window
+// Return Value:
+// - <none>
+winrt::fire_and_forget AppHost::_LaunchPreloadedWindow(Remoting::CommandlineArgs args)
+{
+    // The peasant raises this on a background thread.
+    co_await wil::resume_foreground(_logic.GetRoot().Dispatcher());
+
+    _windowManager.UnregisterPreloadedWindow();
+
+    const auto result = _logic.SetStartupCommandline(args.Commandline());
+    _DisplayCommandlineMessage(result);
+
+    // See the GH#12190 note in _HandleCommandlineArgs. We never showed
+    // ourselves, so we can just go away instead.
+    if (_logic.ShouldImmediatelyHandoffToElevated())
+    {
+        _logic.HandoffToElevated();
+        LastTabClosed(nullptr, nullptr);
+        co_return;
+    }
+
+    _window->ShowPreloadedWindow();
+    _logic.LaunchPreloadedWindow(args.CurrentDirectory());
+
+    const Remoting::SummonWindowBehavior summonArgs{};
+    summonArgs.MoveToCurrentDesktop(false);
+    summonArgs.DropdownDuration(0);
+    summonArgs.ToMonitor(Remoting::MonitorBehavior::InPlace);
+    summonArgs.ToggleVisibility(false); // Do not toggle, just make visible.
+    _HandleSummon(nullptr, summonArgs);
+
+    // Now that we've been used up, get another window ready for next time.
+    if (_logic.GetPreloadWindow())
+    {
+        _createPreloadedWindow();
+    }
+}
+
+// Method Description:
+// - Turns this preloaded window into a regular one, after the page created a
+//   tab for a default terminal handoff in it. The handoff went straight to our
+//   handoff server, so the console host never had to wait for a new window process.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void AppHost::_ClaimPreloadedWindow()
+{
+    _windowManager.UnregisterPreloadedWindow();
+    _logic.ClaimPreloadedWindow();
+    _window->ShowPreloadedWindow();
+
+    // Now that we've been used up, get another window ready for next time.
+    if (_logic.GetPreloadWindow())
+    {
+        _createPreloadedWindow();
+    }
+}
+
 // Method Description:
 // - Asynchronously get the window layout from the current page. This is
 //   done async because we need to switch between the ui thread and the calling
@@ -999,6 +1100,8 @@ void AppHost::_BecomeMonarch(const winrt::Windows::Foundation::IInspectable& /*s
         _getWindowLayoutThrottler.emplace(std::move(std::chrono::seconds(10)), std::move([this]() { _SaveWindowLayoutsRepeat(); }));
         _getWindowLayoutThrottler.value()();
     }
+
+    _PreloadWindowIfNeeded();
 }
 
 winrt::Windows::Foundation::IAsyncAction AppHost::_SaveWindowLayouts()
@@ -1170,6 +1273,53 @@ void AppHost::_GlobalHotkeyPressed(const long hotkeyIndex)
     }
 }
 
+// Method Description:
+// - If the user asked us to keep a preloaded window around, and there isn't
+//   one yet, start one. Only the monarch does this, so that we don't end up
+//   with a preloaded window per window.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void AppHost::_PreloadWindowIfNeeded()
+{
+    if (_windowManager.IsMonarch() &&
+        _logic.GetPreloadWindow() &&
+        !_logic.IsPreloadedWindow() &&
+        !_windowManager.HasPreloadedWindow())
+    {
+        _createPreloadedWindow();
+    }
+}
+
+// Method Description:
+// - Starts a new wt.exe process with -Preload (see
+//   AppCommandlineArgs::ParseArgs), which creates a hidden window that
+//   registers itself with the monarch as the preloaded window.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+winrt::fire_and_forget AppHost::_createPreloadedWindow()
+{
+    // Hop to the BG thread
+    co_await winrt::resume_background();
+
+    // See _createNewTerminalWindow for why this is stored in a local.
+    const auto exePath{ GetWtExePath() };
+
+    SHELLEXECUTEINFOW seInfo{ 0 };
+    seInfo.cbSize = sizeof(seInfo);
+    seInfo.fMask = SEE_MASK_NOASYNC;
+    seInfo.lpVerb = L"open";
+    seInfo.lpFile = exePath.c_str();
+    seInfo.lpParameters = L"-Preload";
+    seInfo.nShow = SW_SHOWNORMAL;
+    LOG_IF_WIN32_BOOL_FALSE(ShellExecuteExW(&seInfo));
+
+    co_return;
+}
+
 // Method Description:
 // - Called when the monarch failed to summon a window for a given set of
 //   SummonWindowSelectionArgs. In this case, we should create the specified
@@ -1397,6 +1547,14 @@ void AppHost::_HandleSettingsChanged(const winrt::Windows::Foundation::IInspecta
                 _DestroyNotificationIcon();
             }
         }
+
+        _PreloadWindowIfNeeded();
+    }
+    else if (_logic.IsPreloadedWindow() && !_logic.GetPreloadWindow())
+    {
+        // The user doesn't want a preloaded window anymore.
+        LastTabClosed(nullptr, nullptr);
+        return;
     }
 
     _window->SetMinimizeToNotificationAreaBehavior(_logic.GetMinimizeToNotificationArea());
@@ -1430,6 +1588,13 @@ winrt::fire_and_forget AppHost::_QuitRequested(const winrt::Windows::Foundation:
     // Need to be on the main thread to close out all of the tabs.
     co_await wil::resume_foreground(_logic.GetRoot().Dispatcher());
 
+    // A preloaded window doesn't have any tabs to close.
+    if (_logic.IsPreloadedWindow())
+    {
+        LastTabClosed(nullptr, nullptr);
+        co_return;
+    }
+
     _logic.Quit();
 }
 
@@ -1470,6 +1635,13 @@ void AppHost::_ShowWindowChanged(const winrt::Windows::Foundation::IInspectable&
 void AppHost::_SummonWindowRequested(const winrt::Windows::Foundation::IInspectable& sender,
                                      const winrt::Windows::Foundation::IInspectable&)
 {
+    // A preloaded window is only ever summoned by the page once it received a
+    // default terminal handoff (see TerminalPage::_OnNewConnection).
+    if (_logic.IsPreloadedWindow())
+    {
+        _ClaimPreloadedWindow();
+    }
+
     const Remoting::SummonWindowBehavior summonArgs{};
     summonArgs.MoveToCurrentDesktop(false);
     summonArgs.DropdownDuration(0);
@@ -61,6 +61,11 @@ private:
 
     void _DispatchCommandline(winrt::Windows::Foundation::IInspectable sender,
                               winrt::Microsoft::Terminal::Remoting::CommandlineArgs args);
+    void _DisplayCommandlineMessage(const int32_t result);
+    winrt::fire_and_forget _LaunchPreloadedWindow(winrt::Microsoft::Terminal::Remoting::CommandlineArgs args);
+    void _ClaimPreloadedWindow();
+    void _PreloadWindowIfNeeded();
+    winrt::fire_and_forget _createPreloadedWindow();
 
     winrt::Windows::Foundation::IAsyncOperation<winrt::hstring> _GetWindowLayoutAsync();
 
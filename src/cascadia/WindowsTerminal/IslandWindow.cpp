@@ -154,10 +154,29 @@ void IslandWindow::_HandleCreateWindow(const WPARAM, const LPARAM lParam) noexce
     rc.right = rc.left + pcs->cx;
     rc.bottom = rc.top + pcs->cy;
 
+    // A preloaded window stays hidden until ShowPreloadedWindow is called.
+    // Its placement is only decided then, once we know the commandline.
+    if (!_hiddenOnCreate)
+    {
+        _showWithLaunchMode(rc);
+    }
+
+    UpdateWindowIconForActiveMetrics(_window.get());
+}
+
+// Method Description:
+// - Asks the create callback where the window should go and how, then shows
+//   the window accordingly.
+// Arguments:
+// - proposedRect: the rect the window would be placed at by default
+// Return Value:
+// - <none>
+void IslandWindow::_showWithLaunchMode(const til::rect& proposedRect) noexcept
+{
     auto launchMode = LaunchMode::DefaultMode;
     if (_pfnCreateCallback)
     {
-        _pfnCreateCallback(_window.get(), rc, launchMode);
+        _pfnCreateCallback(_window.get(), proposedRect, launchMode);
     }
 
     auto nCmdShow = SW_SHOW;
@@ -169,8 +188,38 @@ void IslandWindow::_HandleCreateWindow(const WPARAM, const LPARAM lParam) noexce
     ShowWindow(_window.get(), nCmdShow);
 
     UpdateWindow(_window.get());
+}
 
-    UpdateWindowIconForActiveMetrics(_window.get());
+// Method Description:
+// - Sets whether the window should stay hidden when it's created, rather than
+//   being shown immediately. This must be called before MakeWindow.
+// Arguments:
+// - hiddenOnCreate: true if the window should be created hidden
+// Return Value:
+// - <none>
+void IslandWindow::SetHiddenOnCreate(bool hiddenOnCreate) noexcept
+{
+    _hiddenOnCreate = hiddenOnCreate;
+}
+
+// Method Description:
+// - Shows a window that was created hidden. The create callback is called
+//   again at this point, to position the window and get its launch mode.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void IslandWindow::ShowPreloadedWindow() noexcept
+{
+    if (!_hiddenOnCreate)
+    {
+        return;
+    }
+    _hiddenOnCreate = false;
+
+    RECT rc{};
+    GetWindowRect(_window.get(), &rc);
+    _showWithLaunchMode(til::rect{ rc });
 }
 
 // Method Description:
@@ -501,6 +550,14 @@ long IslandWindow::_calculateTotalSize(const bool isWidth, const long clientSize
         }
         break;
     }
+    case WM_ENTERSIZEMOVE:
+    case WM_EXITSIZEMOVE:
+    {
+        // The user started or stopped dragging the border (or the titlebar) of the
+        // window. In between, the controls defer the expensive parts of resizing.
+        _InteractiveResizeChangedHandlers(message == WM_ENTERSIZEMOVE);
+        break;
+    }
     case WM_MOVING:
     {
         return _OnMoving(wparam, lparam);
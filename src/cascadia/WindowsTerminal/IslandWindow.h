@@ -38,6 +38,8 @@ public:
     virtual void Initialize();
 
     void SetCreateCallback(std::function<void(const HWND, const til::rect&, winrt::Microsoft::Terminal::Settings::Model::LaunchMode& launchMode)> pfn) noexcept;
+    void SetHiddenOnCreate(bool hiddenOnCreate) noexcept;
+    void ShowPreloadedWindow() noexcept;
     void SetSnapDimensionCallback(std::function<float(bool widthOrHeight, float dimension)> pfn) noexcept;
 
     void FocusModeChanged(const bool focusMode);
@@ -81,6 +83,7 @@ public:
 
     WINRT_CALLBACK(WindowMoved, winrt::delegate<void()>);
     WINRT_CALLBACK(WindowVisibilityChanged, winrt::delegate<void(bool)>);
+    WINRT_CALLBACK(InteractiveResizeChanged, winrt::delegate<void(bool)>);
 
 protected:
     void ForceResize()
@@ -145,6 +148,9 @@ protected:
     void _summonWindowRoutineBody(winrt::Microsoft::Terminal::Remoting::SummonWindowBehavior args);
 
     bool _minimizeToNotificationArea{ false };
+    bool _hiddenOnCreate{ false };
+
+    void _showWithLaunchMode(const til::rect& proposedRect) noexcept;
 
     std::unordered_map<UINT, SystemMenuItemInfo> _systemMenuItems;
     UINT _systemMenuNextItemId;
@@ -185,6 +185,12 @@ namespace Microsoft.Terminal.Wpf
         [DllImport("PublicTerminalCore.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
         public static extern void TerminalSendOutput(IntPtr terminal, string lpdata);
 
+        [DllImport("PublicTerminalCore.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint TerminalSendOutputUtf8(IntPtr terminal, byte[] data, UIntPtr length);
+
+        [DllImport("PublicTerminalCore.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint TerminalSendOutputUtf8Batch(IntPtr terminal, IntPtr[] chunks, UIntPtr[] lengths, UIntPtr count);
+
         [DllImport("PublicTerminalCore.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
         public static extern uint TerminalTriggerResize(IntPtr terminal, int width, int height, out TilSize dimensions);
 
@@ -47,7 +47,9 @@
     X(winrt::hstring, StartingTitle)                                                                              \
     X(bool, DetectURLs, true)                                                                                     \
     X(bool, VtPassthrough, false)                                                                                 \
-    X(bool, AutoMarkPrompts)
+    X(bool, AutoMarkPrompts)                                                                                      \
+    X(bool, SpillScrollbackToDisk, false)                                                                         \
+    X(bool, PredictiveEcho, false)
 
 // --------------------------- Control Settings ---------------------------
 //  All of these settings are defined in IControlSettings.
@@ -69,6 +71,12 @@
     X(winrt::Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, winrt::Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale) \
     X(bool, ForceFullRepaintRendering, false)                                                                                                            \
     X(bool, SoftwareRendering, false)                                                                                                                    \
+    X(int32_t, MaxFrameRate, 0)                                                                                                                          \
+    X(bool, ReduceFrameRateOnBattery, false)                                                                                                             \
+    X(int32_t, FloodControlThreshold, 0)                                                                                                                 \
+    X(int32_t, FloodControlScrollback, 0)                                                                                                                \
+    X(int32_t, MouseMoveInterval, 0)                                                                                                                     \
+    X(bool, ShowRenderTimings, false)                                                                                                                    \
     X(bool, UseAtlasEngine, false)                                                                                                                       \
     X(bool, UseBackgroundImageForWindow, false)                                                                                                          \
     X(bool, ShowMarks, false)
@@ -0,0 +1,56 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ReplayRecording.h
+
+Abstract:
+- The file format of the connection recordings written by the debug tap and
+  played back by ReplayConnection. A recording is a sequence of chunks, each
+  of which is a ChunkHeader followed by `length` UTF-16 code units of output.
+--*/
+
+#pragma once
+
+namespace Microsoft::Terminal::ReplayRecording
+{
+    static constexpr std::wstring_view FileExtension{ L".wtrec" };
+
+    // Chunks larger than this are assumed to be the result of a corrupted file.
+    static constexpr uint64_t MaxChunkLength{ 64 * 1024 * 1024 };
+
+    struct ChunkHeader
+    {
+        uint64_t timestamp; // in microseconds since the recording was started
+        uint64_t length; // in UTF-16 code units
+    };
+
+    // Appends a chunk of output to the given file.
+    inline void WriteChunk(const HANDLE file, const std::chrono::microseconds timestamp, const std::wstring_view text)
+    {
+        const ChunkHeader header{ gsl::narrow_cast<uint64_t>(timestamp.count()), text.size() };
+        DWORD written = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file, &header, sizeof(header), &written, nullptr));
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file, text.data(), gsl::narrow<DWORD>(text.size() * sizeof(wchar_t)), &written, nullptr));
+    }
+
+    // Reads the next chunk of output from the given file.
+    // Returns false once the end of the file was reached.
+    inline bool ReadChunk(const HANDLE file, ChunkHeader& header, std::wstring& text)
+    {
+        DWORD read = 0;
+        THROW_IF_WIN32_BOOL_FALSE(ReadFile(file, &header, sizeof(header), &read, nullptr));
+        if (read != sizeof(header))
+        {
+            return false;
+        }
+
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT), header.length > MaxChunkLength);
+
+        text.resize(gsl::narrow_cast<size_t>(header.length));
+        const auto bytes = gsl::narrow<DWORD>(text.size() * sizeof(wchar_t));
+        THROW_IF_WIN32_BOOL_FALSE(ReadFile(file, text.data(), bytes, &read, nullptr));
+        return read == bytes;
+    }
+}
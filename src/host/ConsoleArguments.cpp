@@ -25,6 +25,7 @@ const std::wstring_view ConsoleArguments::FEATURE_ARG = L"--feature";
 const std::wstring_view ConsoleArguments::FEATURE_PTY_ARG = L"pty";
 const std::wstring_view ConsoleArguments::COM_SERVER_ARG = L"-Embedding";
 const std::wstring_view ConsoleArguments::PASSTHROUGH_ARG = L"--passthrough";
+const std::wstring_view ConsoleArguments::POOLED_ARG = L"--pooled";
 // NOTE: Thinking about adding more commandline args that control conpty, for
 // the Terminal? Make sure you add them to the commandline in
 // ConsoleEstablishHandoff. We use that to initialize the ConsoleArguments for a
@@ -474,6 +475,12 @@ void ConsoleArguments::s_ConsumeArg(_Inout_ std::vector<std::wstring>& args, _In
             s_ConsumeArg(args, i);
             hr = S_OK;
         }
+        else if (arg == POOLED_ARG)
+        {
+            _pooled = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
         else if (arg.substr(0, FILEPATH_LEADER_PREFIX.length()) == FILEPATH_LEADER_PREFIX)
         {
             // beginning of command line -- includes file path
@@ -614,6 +621,69 @@ bool ConsoleArguments::IsPassthroughMode() const noexcept
     return _passthroughMode;
 }
 
+bool ConsoleArguments::IsPooled() const noexcept
+{
+    return _pooled;
+}
+
+// Routine Description:
+// - A console host started with --pooled was started by winconpty ahead of time, before
+//   anyone asked for a pseudoconsole. This blocks until winconpty hands us one over the
+//   signal pipe, which provides everything that's otherwise passed on the commandline
+//   and as standard handles. The pipes were already duplicated into our process.
+// Arguments:
+// - <none> - uses internal state
+// Return Value:
+// - S_OK if we received a handoff, or an error if the signal pipe was closed first.
+[[nodiscard]] HRESULT ConsoleArguments::WaitForPoolHandoff()
+{
+    // Keep in sync with PTY_SIGNAL_HANDOFF and PTY_HANDOFF_DATA in winconpty.h.
+    static constexpr unsigned short PtySignalHandoff = 16;
+    static constexpr DWORD PseudoconsoleInheritCursor = 0x1;
+    static constexpr DWORD PseudoconsoleResizeQuirk = 0x2;
+    static constexpr DWORD PseudoconsoleWin32InputMode = 0x4;
+    static constexpr DWORD PseudoconsolePassthroughMode = 0x8;
+
+#pragma pack(push, 1)
+    struct
+    {
+        unsigned short id;
+        unsigned short width;
+        unsigned short height;
+        DWORD flags;
+        DWORD input;
+        DWORD output;
+    } handoff{};
+#pragma pack(pop)
+
+    const auto signal = GetSignalHandle();
+    RETURN_HR_IF(E_INVALIDARG, !IsValidHandle(signal));
+
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+    const std::span buffer{ reinterpret_cast<BYTE*>(&handoff), sizeof(handoff) };
+    size_t offset = 0;
+    while (offset < buffer.size())
+    {
+        DWORD read = 0;
+        RETURN_IF_WIN32_BOOL_FALSE(ReadFile(signal, buffer.subspan(offset).data(), gsl::narrow_cast<DWORD>(buffer.size() - offset), &read, nullptr));
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_BROKEN_PIPE), read == 0);
+        offset += read;
+    }
+
+    RETURN_HR_IF(E_UNEXPECTED, handoff.id != PtySignalHandoff);
+
+    _vtInHandle = ULongToHandle(handoff.input);
+    _vtOutHandle = ULongToHandle(handoff.output);
+    _width = gsl::narrow_cast<short>(handoff.width);
+    _height = gsl::narrow_cast<short>(handoff.height);
+    _inheritCursor = WI_IsFlagSet(handoff.flags, PseudoconsoleInheritCursor);
+    _resizeQuirk = WI_IsFlagSet(handoff.flags, PseudoconsoleResizeQuirk);
+    _win32InputMode = WI_IsFlagSet(handoff.flags, PseudoconsoleWin32InputMode);
+    _passthroughMode = WI_IsFlagSet(handoff.flags, PseudoconsolePassthroughMode);
+    _pooled = false;
+    return S_OK;
+}
+
 HANDLE ConsoleArguments::GetServerHandle() const
 {
     return ULongToHandle(_serverHandle);
@@ -37,6 +37,8 @@ public:
     bool ShouldCreateServerHandle() const;
     bool ShouldRunAsComServer() const;
     bool IsPassthroughMode() const noexcept;
+    bool IsPooled() const noexcept;
+    [[nodiscard]] HRESULT WaitForPoolHandoff();
 
     HANDLE GetServerHandle() const;
     HANDLE GetVtInHandle() const;
@@ -79,6 +81,7 @@ public:
     static const std::wstring_view FEATURE_PTY_ARG;
     static const std::wstring_view COM_SERVER_ARG;
     static const std::wstring_view PASSTHROUGH_ARG;
+    static const std::wstring_view POOLED_ARG;
 
 private:
 #ifdef UNIT_TESTING
@@ -145,6 +148,7 @@ private:
     bool _inheritCursor;
     bool _resizeQuirk{ false };
     bool _win32InputMode{ false };
+    bool _pooled{ false };
 
     [[nodiscard]] HRESULT _GetClientCommandline(_Inout_ std::vector<std::wstring>& args,
                                                 const size_t index,
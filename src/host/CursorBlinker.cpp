@@ -41,10 +41,12 @@ void CursorBlinker::UpdateSystemMetrics() noexcept
     _uCaretBlinkTime = ServiceLocator::LocateSystemConfigurationProvider()->GetCaretBlinkTime();
 
     // If animations are disabled, or the blink rate is infinite, blinking is not allowed.
+    // We don't blink over remote desktop either, since every blink is a repaint sent over the wire.
     auto animationsEnabled = TRUE;
     SystemParametersInfoW(SPI_GETCLIENTAREAANIMATION, 0, &animationsEnabled, 0);
+    const auto remoteSession = ServiceLocator::LocateSystemConfigurationProvider()->IsRemoteSession();
     auto& renderSettings = ServiceLocator::LocateGlobals().getConsoleInformation().GetRenderSettings();
-    renderSettings.SetRenderMode(RenderSettings::Mode::BlinkAllowed, animationsEnabled && _uCaretBlinkTime != INFINITE);
+    renderSettings.SetRenderMode(RenderSettings::Mode::BlinkAllowed, animationsEnabled && !remoteSession && _uCaretBlinkTime != INFINITE);
 }
 
 void CursorBlinker::SettingsChanged() noexcept
@@ -138,6 +140,7 @@ void CursorBlinker::TimerRoutine(SCREEN_INFORMATION& ScreenInfo) const noexcept
 
     // Don't blink the cursor for remote sessions.
     if ((!ServiceLocator::LocateSystemConfigurationProvider()->IsCaretBlinkingEnabled() ||
+         ServiceLocator::LocateSystemConfigurationProvider()->IsRemoteSession() ||
          _uCaretBlinkTime == -1 ||
          (!cursor.IsBlinkingAllowed())) &&
         cursor.IsOn())
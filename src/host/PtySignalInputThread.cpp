@@ -149,6 +149,7 @@ void PtySignalInputThread::CreatePseudoWindow()
         {
             ResizeWindowData resizeMsg = { 0 };
             _GetData(&resizeMsg, sizeof(resizeMsg));
+            _SkipToLatestResize(resizeMsg);
 
             LockConsole();
             auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
@@ -164,6 +165,11 @@ void PtySignalInputThread::CreatePseudoWindow()
             else
             {
                 _DoResizeWindow(resizeMsg);
+
+                // More resizes are likely to follow (the user is probably dragging
+                // the window border), so let the renderer wait for them to settle.
+                auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+                gci.GetVtIo()->SetResizeInProgress();
             }
 
             break;
@@ -297,6 +303,41 @@ bool PtySignalInputThread::_GetData(_Out_writes_bytes_(cbBuffer) void* const pBu
     return true;
 }
 
+// Method Description:
+// - Resizing reflows the entire buffer, so if the terminal already sent us more
+//   resizes while we were busy, only the latest one is worth doing. This consumes
+//   the resize messages that are immediately queued up in the pipe and keeps
+//   the last size. Any other message stops the search and is processed as usual.
+// Arguments:
+// - data - The size of the resize message that was just read. Receives the latest size.
+// Return Value:
+// - <none>
+void PtySignalInputThread::_SkipToLatestResize(ResizeWindowData& data)
+{
+#pragma pack(push, 1)
+    struct ResizeMessage
+    {
+        PtySignal signal;
+        ResizeWindowData data;
+    };
+#pragma pack(pop)
+
+    for (;;)
+    {
+        ResizeMessage next{};
+        DWORD bytesRead = 0;
+        if (!PeekNamedPipe(_hFile.get(), &next, sizeof(next), &bytesRead, nullptr, nullptr) ||
+            bytesRead != sizeof(next) ||
+            next.signal != PtySignal::ResizeWindow)
+        {
+            return;
+        }
+
+        _GetData(&next, sizeof(next));
+        data = next.data;
+    }
+}
+
 // Method Description:
 // - Starts the PTY Signal input thread.
 [[nodiscard]] HRESULT PtySignalInputThread::Start() noexcept
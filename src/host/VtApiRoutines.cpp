@@ -8,24 +8,22 @@
 
 using namespace Microsoft::Console::Interactivity;
 
-// When someone attempts to use the console APIs to do a "read back"
-// of the console buffer, we have to give them **something**.
-// These two structures are just some gaudy-colored replacement character
-// text to give them data but represent they've done something that cannot
-// be supported under VT passthrough mode.
+// When someone attempts to use the console APIs to write attributes without text,
+// we have to give the terminal **something**.
+// This structure is just some gaudy-colored replacement character
+// text to represent they've done something that cannot be supported
+// under VT passthrough mode.
 // ----
-// They can't be supported because in passthrough we maintain no internal
-// buffer to answer these questions, and there is no VT sequence that lets
-// us query the final terminal's buffer state. Even if a VT sequence did exist
-// (and we personally believe it shouldn't), there's a possibility that it would
+// Reading the buffer back works differently. Text written with WriteConsole is
+// forwarded to the terminal untouched, but we remember it and replay it into our
+// buffer the next time someone reads from it. Most clients never do, so they never
+// pay for parsing their output twice. There's no VT sequence that lets us query the
+// final terminal's buffer state instead. Even if a
+// VT sequence did exist (and we personally believe it shouldn't), there's a possibility that it would
 // read a massive amount of data and cause severe perf issues as applications coded
 // to this old API are likely leaning on it heavily and asking for this data in a
 // loop via VT would be a nightmare of parsing and formatting and over-the-wire transmission.
-
-static constexpr CHAR_INFO s_readBackUnicode{
-    { UNICODE_REPLACEMENT },
-    FOREGROUND_INTENSITY | FOREGROUND_RED | BACKGROUND_GREEN
-};
+// The other output APIs on the other hand aren't replayed, so our buffer won't reflect them.
 
 static constexpr CHAR_INFO s_readBackAscii{
     { L'?' },
@@ -39,10 +37,81 @@ VtApiRoutines::VtApiRoutines() :
     m_outputMode(),
     m_pUsualRoutines(),
     m_pVtEngine(),
-    m_listeningForDSR(false)
+    m_listeningForDSR(false),
+    m_pendingOutput()
+{
+}
+
+// The output mode we replay the client's writes with. The terminal interprets all
+// of it as VT, without turning line feeds into CR/LF, and so do we.
+static constexpr ULONG s_replayOutputMode = ENABLE_PROCESSED_OUTPUT |
+                                            ENABLE_WRAP_AT_EOL_OUTPUT |
+                                            ENABLE_VIRTUAL_TERMINAL_PROCESSING |
+                                            DISABLE_NEWLINE_AUTO_RETURN;
+
+// If a client writes this much without ever reading it back, we replay it into
+// our buffer anyways, so that we don't hold on to an unbounded amount of text.
+static constexpr size_t s_maxPendingOutput = 1024 * 1024;
+
+// Routine Description:
+// - Remembers the given text so that _SynchronizeBuffer() can replay it into our buffer.
+// Arguments:
+// - text - the text the client wrote to the terminal
+void VtApiRoutines::_RecordOutput(const std::wstring_view text) noexcept
 {
+    if (m_pendingOutput.size() + text.size() > s_maxPendingOutput)
+    {
+        _SynchronizeBuffer();
+    }
+
+    try
+    {
+        m_pendingOutput.append(text);
+    }
+    catch (...)
+    {
+        // Our buffer is going to miss some text. That's unfortunate,
+        // but it only affects clients reading the buffer back.
+        LOG_CAUGHT_EXCEPTION();
+    }
 }
 
+// Routine Description:
+// - Replays any text the client wrote since the last call into our buffer,
+//   so that we can answer requests to read the buffer back.
+// - The terminal already received this text (and answered any queries in it), so the
+//   replay mustn't produce any output and mustn't respond to queries a second time.
+void VtApiRoutines::_SynchronizeBuffer() noexcept
+try
+{
+    if (m_pendingOutput.empty())
+    {
+        return;
+    }
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& screenInfo = gci.GetActiveOutputBuffer();
+
+    // Outside of replays nothing uses our buffer's output mode, since we track the
+    // client's mode in m_outputMode. That's why it's fine to never restore it.
+    screenInfo.OutputMode = s_replayOutputMode;
+
+    // Sequences conhost doesn't understand would otherwise be passed through to the terminal again.
+    screenInfo.SetTerminalConnection(nullptr);
+    m_pVtEngine->SetSynchronizingBuffer(true);
+
+    const auto restore = wil::scope_exit([&]() noexcept {
+        m_pVtEngine->SetSynchronizingBuffer(false);
+        gci.GetActiveOutputBuffer().SetTerminalConnection(m_pVtEngine);
+        m_pendingOutput.clear();
+    });
+
+    size_t read = 0;
+    std::unique_ptr<IWaitRoutine> waiter;
+    LOG_IF_FAILED(m_pUsualRoutines->WriteConsoleWImpl(screenInfo, m_pendingOutput, read, false, waiter));
+}
+CATCH_LOG()
+
 #pragma warning(push)
 #pragma warning(disable : 4100) // unreferenced param
 
@@ -202,20 +271,25 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                        size_t& read,
                                                        bool requiresVtQuirk,
                                                        std::unique_ptr<IWaitRoutine>& waiter) noexcept
+try
 {
+    const auto wstr = ConvertToW(m_outputCodepage, buffer);
+
     if (CP_UTF8 == m_outputCodepage)
     {
         (void)m_pVtEngine->WriteTerminalUtf8(buffer);
     }
     else
     {
-        (void)m_pVtEngine->WriteTerminalW(ConvertToW(m_outputCodepage, buffer));
+        (void)m_pVtEngine->WriteTerminalW(wstr);
     }
 
     (void)m_pVtEngine->_Flush();
+    _RecordOutput(wstr);
     read = buffer.size();
     return S_OK;
 }
+CATCH_RETURN()
 
 [[nodiscard]] HRESULT VtApiRoutines::WriteConsoleWImpl(IConsoleOutputObject& context,
                                                        const std::wstring_view buffer,
@@ -225,6 +299,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
 {
     (void)m_pVtEngine->WriteTerminalW(buffer);
     (void)m_pVtEngine->_Flush();
+    _RecordOutput(buffer);
     read = buffer.size();
     return S_OK;
 }
@@ -343,6 +418,8 @@ void VtApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& c
                                                      CONSOLE_SCREEN_BUFFER_INFOEX& data) noexcept
 {
     // TODO GH10001: this is technically full of potentially incorrect data. do we care? should we store it in here with set?
+    // The cursor position at least is correct once we've caught up with the client's output.
+    _SynchronizeBuffer();
     return m_pUsualRoutines->GetConsoleScreenBufferInfoExImpl(context, data);
 }
 
@@ -436,9 +513,8 @@ void VtApiRoutines::GetLargestConsoleWindowSizeImpl(const SCREEN_INFORMATION& co
                                                                     gsl::span<WORD> buffer,
                                                                     size_t& written) noexcept
 {
-    std::fill_n(buffer.data(), buffer.size(), s_readBackUnicode.Attributes); // should be same as the ascii one.
-    written = buffer.size();
-    return S_OK;
+    _SynchronizeBuffer();
+    return m_pUsualRoutines->ReadConsoleOutputAttributeImpl(context, origin, buffer, written);
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::ReadConsoleOutputCharacterAImpl(const SCREEN_INFORMATION& context,
@@ -446,9 +522,8 @@ void VtApiRoutines::GetLargestConsoleWindowSizeImpl(const SCREEN_INFORMATION& co
                                                                      gsl::span<char> buffer,
                                                                      size_t& written) noexcept
 {
-    std::fill_n(buffer.data(), buffer.size(), s_readBackAscii.Char.AsciiChar);
-    written = buffer.size();
-    return S_OK;
+    _SynchronizeBuffer();
+    return m_pUsualRoutines->ReadConsoleOutputCharacterAImpl(context, origin, buffer, written);
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::ReadConsoleOutputCharacterWImpl(const SCREEN_INFORMATION& context,
@@ -456,9 +531,8 @@ void VtApiRoutines::GetLargestConsoleWindowSizeImpl(const SCREEN_INFORMATION& co
                                                                      gsl::span<wchar_t> buffer,
                                                                      size_t& written) noexcept
 {
-    std::fill_n(buffer.data(), buffer.size(), s_readBackUnicode.Char.UnicodeChar);
-    written = buffer.size();
-    return S_OK;
+    _SynchronizeBuffer();
+    return m_pUsualRoutines->ReadConsoleOutputCharacterWImpl(context, origin, buffer, written);
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::WriteConsoleInputAImpl(InputBuffer& context,
@@ -581,9 +655,8 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                             const Microsoft::Console::Types::Viewport& sourceRectangle,
                                                             Microsoft::Console::Types::Viewport& readRectangle) noexcept
 {
-    std::fill_n(buffer.data(), buffer.size(), s_readBackAscii);
-    // TODO GH10001: do we need to constrict readRectangle to within the known buffer size... probably.
-    return S_OK;
+    _SynchronizeBuffer();
+    return m_pUsualRoutines->ReadConsoleOutputAImpl(context, buffer, sourceRectangle, readRectangle);
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::ReadConsoleOutputWImpl(const SCREEN_INFORMATION& context,
@@ -591,9 +664,8 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                             const Microsoft::Console::Types::Viewport& sourceRectangle,
                                                             Microsoft::Console::Types::Viewport& readRectangle) noexcept
 {
-    std::fill_n(buffer.data(), buffer.size(), s_readBackUnicode);
-    // TODO GH10001: do we need to constrict readRectangle to within the known buffer size... probably.
-    return S_OK;
+    _SynchronizeBuffer();
+    return m_pUsualRoutines->ReadConsoleOutputWImpl(context, buffer, sourceRectangle, readRectangle);
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::GetConsoleTitleAImpl(gsl::span<char> title,
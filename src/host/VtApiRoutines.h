@@ -389,4 +389,9 @@ public:
 
 private:
     void _SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) noexcept;
+    void _RecordOutput(const std::wstring_view text) noexcept;
+    void _SynchronizeBuffer() noexcept;
+
+    // The text the client wrote since the last time we replayed it into our buffer.
+    std::wstring m_pendingOutput;
 };
@@ -28,6 +28,7 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     _hFile{ std::move(hPipe) },
     _hThread{},
     _u8State{},
+    _buffer{ std::make_unique<char[]>(BufferSize) },
     _dwThreadId{ 0 },
     _exitRequested{ false },
     _exitResult{ S_OK },
@@ -71,14 +72,14 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
 
     try
     {
-        std::wstring wstr{};
-        auto hr = til::u8u16(u8Str, wstr, _u8State);
+        // _wstr is reused between reads, so that we don't allocate for every chunk of input.
+        auto hr = til::u8u16(u8Str, _wstr, _u8State);
         // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
         if (FAILED(hr))
         {
             return S_FALSE;
         }
-        _pInputStateMachine->ProcessString(wstr);
+        _pInputStateMachine->ProcessString(_wstr);
     }
     CATCH_RETURN();
 
@@ -98,8 +99,42 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 }
 
 // Method Description:
-// - Do a single ReadFile from our pipe, and try and handle it. If handling
-//      failed, throw or log, depending on what the caller wants.
+// - Appends any input that's already waiting in the pipe to the chunk that
+//      was just read into _buffer, until the pipe is drained or _buffer is full.
+//      This way a burst of input, like a large paste, is handled with a single
+//      console lock acquisition and a single pass through the state machine.
+//      This never blocks: it only reads what PeekNamedPipe() says is available.
+// Arguments:
+// - read: The number of bytes that are already in _buffer.
+// Return Value:
+// - The total number of bytes in _buffer.
+DWORD VtInputThread::_CoalescePendingInput(DWORD read) noexcept
+{
+    while (read < BufferSize)
+    {
+        DWORD available{};
+        if (!PeekNamedPipe(_hFile.get(), nullptr, 0, nullptr, &available, nullptr) || available == 0)
+        {
+            break;
+        }
+
+        DWORD more{};
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        if (!ReadFile(_hFile.get(), _buffer.get() + read, std::min(available, BufferSize - read), &more, nullptr))
+        {
+            // The next ReadFile() in DoReadInput will run into the same error and handle it.
+            break;
+        }
+
+        read += more;
+    }
+    return read;
+}
+
+// Method Description:
+// - Do a single ReadFile from our pipe, along with whatever else is already
+//      waiting in it, and try and handle it. If handling failed, throw or log,
+//      depending on what the caller wants.
 // Arguments:
 // - throwOnFail: If true, throw an exception if there was an error processing
 //      the input received. Otherwise, log the error.
@@ -107,9 +142,8 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 // - <none>
 void VtInputThread::DoReadInput(const bool throwOnFail)
 {
-    char buffer[256];
     DWORD dwRead = 0;
-    auto fSuccess = !!ReadFile(_hFile.get(), buffer, ARRAYSIZE(buffer), &dwRead, nullptr);
+    auto fSuccess = !!ReadFile(_hFile.get(), _buffer.get(), BufferSize, &dwRead, nullptr);
 
     // If we failed to read because the terminal broke our pipe (usually due
     //      to dying itself), close gracefully with ERROR_BROKEN_PIPE.
@@ -122,7 +156,9 @@ void VtInputThread::DoReadInput(const bool throwOnFail)
         return;
     }
 
-    auto hr = _HandleRunInput({ buffer, gsl::narrow_cast<size_t>(dwRead) });
+    dwRead = _CoalescePendingInput(dwRead);
+
+    auto hr = _HandleRunInput({ _buffer.get(), gsl::narrow_cast<size_t>(dwRead) });
     if (FAILED(hr))
     {
         if (throwOnFail)
@@ -29,8 +29,13 @@ namespace Microsoft::Console
         void SetLookingForDSR(const bool looking) noexcept;
 
     private:
+        // Large enough that a paste or a burst of win32-input-mode sequences
+        // is usually read and processed in one go.
+        static constexpr DWORD BufferSize = 16 * 1024;
+
         [[nodiscard]] HRESULT _HandleRunInput(const std::string_view u8Str);
         DWORD _InputThread();
+        DWORD _CoalescePendingInput(DWORD read) noexcept;
 
         wil::unique_hfile _hFile;
         wil::unique_handle _hThread;
@@ -43,5 +48,7 @@ namespace Microsoft::Console
 
         std::unique_ptr<Microsoft::Console::VirtualTerminal::StateMachine> _pInputStateMachine;
         til::u8state _u8State;
+        std::unique_ptr<char[]> _buffer;
+        std::wstring _wstr;
     };
 }
@@ -288,9 +288,12 @@ bool VtIo::IsUsingVt() const
 
     // MSFT: 15813316
     // If the terminal application wants us to inherit the cursor position,
-    //  we're going to emit a VT sequence to ask for the cursor position, then
-    //  read input until we get a response. Terminals who request this behavior
-    //  but don't respond will hang.
+    //  we're going to emit a VT sequence to ask for the cursor position.
+    // The response is read by the input thread like any other input, so the
+    //  client isn't kept waiting for the round trip. Until it arrives, the
+    //  VtEngine holds off painting and the client's output accumulates in the
+    //  buffer. Terminals that don't respond within _cursorInheritanceTimeout
+    //  get the output painted at (0,0) instead.
     // If we get a response, the InteractDispatch will call SetCursorPosition,
     //      which will call to our VtIo::SetCursorPosition method.
     // We need both handles for this initialization to work. If we don't have
@@ -298,12 +301,26 @@ bool VtIo::IsUsingVt() const
     //      (so they can't get the DSR) or they can't write the response to us.
     if (_lookingForCursorPosition && _pVtRenderEngine && _pVtInputThread)
     {
-        LOG_IF_FAILED(_pVtRenderEngine->RequestCursor());
-        while (_lookingForCursorPosition)
+        _cursorInheritanceTimer.reset(CreateThreadpoolTimer(&_cursorInheritanceTimeoutCallback, this, nullptr));
+        if (_cursorInheritanceTimer)
         {
-            _pVtInputThread->DoReadInput(false);
+            _pVtRenderEngine->SetAwaitingInheritedCursor(true);
+            LOG_IF_FAILED(_pVtRenderEngine->RequestCursor());
+
+            // The FILETIME struct measures time in 100ns steps and negative values are relative.
+            auto dueTime = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(_cursorInheritanceTimeout).count();
+            SetThreadpoolTimer(_cursorInheritanceTimer.get(), reinterpret_cast<FILETIME*>(&dueTime), 0, 0);
+        }
+        else
+        {
+            LOG_LAST_ERROR();
+            _StopLookingForCursorPosition();
         }
     }
+    else
+    {
+        _lookingForCursorPosition = false;
+    }
 
     if (_pVtInputThread)
     {
@@ -397,24 +414,69 @@ void VtIo::CreatePseudoWindow()
 // Method Description:
 // - Attempts to set the initial cursor position, if we're looking for it.
 //      If we're not trying to inherit the cursor, does nothing.
+//      The caller must hold the console lock.
 // Arguments:
 // - coordCursor: The initial position of the cursor.
 // Return Value:
-// - S_OK if we successfully inherited the cursor or did nothing, else an
-//      appropriate HRESULT
+// - S_OK if we successfully inherited the cursor, S_FALSE if we didn't,
+//      else an appropriate HRESULT
 [[nodiscard]] HRESULT VtIo::SetCursorPosition(const til::point coordCursor)
 {
-    auto hr = S_OK;
-    if (_lookingForCursorPosition)
+    if (!_lookingForCursorPosition)
     {
-        if (_pVtRenderEngine)
-        {
-            hr = _pVtRenderEngine->InheritCursor(coordCursor);
-        }
+        return S_FALSE;
+    }
 
-        _lookingForCursorPosition = false;
+    _StopLookingForCursorPosition();
+
+    // The client may have written output before the response arrived. That
+    // output was placed at the origin already and we can't move it around
+    // underneath the client, so we treat the response as if it timed out.
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (!_pVtRenderEngine || gci.GetActiveOutputBuffer().GetTextBuffer().GetCursor().GetPosition() != til::point{})
+    {
+        return S_FALSE;
+    }
+
+    RETURN_IF_FAILED(_pVtRenderEngine->InheritCursor(coordCursor));
+    return S_OK;
+}
+
+void CALLBACK VtIo::_cursorInheritanceTimeoutCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+{
+    const auto self = static_cast<VtIo*>(context);
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+    if (self->_lookingForCursorPosition)
+    {
+        self->_StopLookingForCursorPosition();
+    }
+}
+
+// Method Description:
+// - Stops waiting for the terminal's cursor position, either because it arrived
+//   or because it took too long. A response that arrives after this point is
+//   treated like any other input. Lets the VtEngine paint what it held back.
+//   The caller must hold the console lock.
+void VtIo::_StopLookingForCursorPosition() noexcept
+{
+    _lookingForCursorPosition = false;
+
+    if (_pVtInputThread)
+    {
+        _pVtInputThread->SetLookingForDSR(false);
+    }
+
+    if (_pVtRenderEngine)
+    {
+        _pVtRenderEngine->SetAwaitingInheritedCursor(false);
+    }
+
+    if (const auto pRender = ServiceLocator::LocateGlobals().pRender)
+    {
+        pRender->NotifyPaintFrame();
     }
-    return hr;
 }
 
 [[nodiscard]] HRESULT VtIo::SwitchScreenBuffer(const bool useAltBuffer)
@@ -515,6 +577,21 @@ void VtIo::EndResize()
     }
 }
 
+// Method Description:
+// - Tell the vt renderer that the terminal is resizing us repeatedly, so
+//   that it holds off repainting until the resizes settle down.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtIo::SetResizeInProgress() noexcept
+{
+    if (_pVtRenderEngine)
+    {
+        _pVtRenderEngine->SetResizeInProgress();
+    }
+}
+
 #ifdef UNIT_TESTING
 // Method Description:
 // - This is a test helper method. It can be used to trick VtIo into responding
@@ -547,6 +624,19 @@ bool VtIo::IsResizeQuirkEnabled() const
     return _resizeQuirk;
 }
 
+// Method Description:
+// - Returns true while passthrough mode replays the client's output into our
+//   buffer. The terminal already handled that output, so it mustn't have any
+//   effects besides updating the buffer, like responding to queries.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff our buffer is being synchronized with the terminal.
+bool VtIo::IsSynchronizingBuffer() const noexcept
+{
+    return _pVtRenderEngine && _pVtRenderEngine->IsSynchronizingBuffer();
+}
+
 // Method Description:
 // - Manually tell the renderer that it should emit a "Erase Scrollback"
 //   sequence to the connected terminal. We need to do this in certain cases
@@ -43,12 +43,14 @@ namespace Microsoft::Console::VirtualTerminal
 
         void BeginResize();
         void EndResize();
+        void SetResizeInProgress() noexcept;
 
 #ifdef UNIT_TESTING
         void EnableConptyModeForTests(std::unique_ptr<Microsoft::Console::Render::VtEngine> vtRenderEngine);
 #endif
 
         bool IsResizeQuirkEnabled() const;
+        bool IsSynchronizingBuffer() const noexcept;
 
         [[nodiscard]] HRESULT ManuallyClearScrollback() const noexcept;
 
@@ -66,8 +68,14 @@ namespace Microsoft::Console::VirtualTerminal
         bool _objectsCreated;
 
         bool _lookingForCursorPosition;
+        // How long we wait for the terminal to tell us its cursor position before we give up and start at (0,0).
+        static constexpr std::chrono::milliseconds _cursorInheritanceTimeout{ 500 };
+        wil::unique_threadpool_timer _cursorInheritanceTimer;
         std::mutex _shutdownLock;
 
+        static void CALLBACK _cursorInheritanceTimeoutCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer) noexcept;
+        void _StopLookingForCursorPosition() noexcept;
+
         bool _resizeQuirk{ false };
         bool _win32InputMode{ false };
         bool _passthroughMode{ false };
@@ -14,6 +14,7 @@
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/Viewport.hpp"
 #include "../types/inc/convert.hpp"
+#include "../types/inc/GlyphWidth.hpp"
 #include "../types/inc/Utf16Parser.hpp"
 
 #include <algorithm>
@@ -218,10 +219,8 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
 
     try
     {
-        TextAttribute useThisAttr(attribute);
-        const OutputCellIterator it(useThisAttr, lengthToWrite);
-        const auto done = screenBuffer.Write(it, startingCoordinate);
-        const auto cellsModifiedCoord = done.GetCellDistance(it);
+        const TextAttribute useThisAttr(attribute);
+        const auto cellsModifiedCoord = gsl::narrow_cast<til::CoordType>(screenBuffer.GetTextBuffer().FillCells(startingCoordinate, lengthToWrite, std::nullopt, useThisAttr));
 
         cellsModified = cellsModifiedCoord;
 
@@ -280,12 +279,22 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
     auto hr = S_OK;
     try
     {
-        const OutputCellIterator it(character, lengthToWrite);
+        til::CoordType cellsModifiedCoord;
 
-        // when writing to the buffer, specifically unset wrap if we get to the last column.
-        // a fill operation should UNSET wrap in that scenario. See GH #1126 for more details.
-        const auto done = screenInfo.Write(it, startingCoordinate, false);
-        const auto cellsModifiedCoord = done.GetInputDistance(it);
+        // Narrow characters take up exactly one cell each, so they can be filled in
+        // bulk, row by row. Everything else needs OutputCellIterator to be split up.
+        // Either way, a fill operation should UNSET wrap when it gets to the last column.
+        // See GH #1126 for more details.
+        if (!IS_HIGH_SURROGATE(character) && !IS_LOW_SURROGATE(character) && !IsGlyphFullWidth(character))
+        {
+            cellsModifiedCoord = gsl::narrow_cast<til::CoordType>(screenInfo.GetTextBuffer().FillCells(startingCoordinate, lengthToWrite, character, std::nullopt));
+        }
+        else
+        {
+            const OutputCellIterator it(character, lengthToWrite);
+            const auto done = screenInfo.Write(it, startingCoordinate, false);
+            cellsModifiedCoord = done.GetInputDistance(it);
+        }
 
         cellsModified = cellsModifiedCoord;
 
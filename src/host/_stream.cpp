@@ -388,6 +388,29 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         XPosition = cursor.GetPosition().X;
         til::CoordType i = 0;
         auto LocalBufPtr = LocalBuffer;
+        const wchar_t* RunStart = LocalBuffer;
+
+        // Fast path: a run of narrow, printable characters can be written straight from the input string,
+        // because each of these characters takes up exactly one cell and needs no translation.
+        // Anything else, like control characters or wide glyphs, goes through the loop below.
+        {
+            const auto remaining = (BufferSize - *pcb) / sizeof(WCHAR);
+            const auto columns = gsl::narrow_cast<size_t>(std::max(0, coordScreenBufferSize.X - XPosition));
+            const auto run = GetNarrowGlyphRunLength({ lpString, std::min(remaining, columns) });
+
+            if (run != 0)
+            {
+                RunStart = lpString;
+                i = gsl::narrow_cast<til::CoordType>(run);
+                XPosition += i;
+                lpString += run;
+                pwchRealUnicode += run;
+                pwchBuffer += run;
+                *pcb += run * sizeof(WCHAR);
+                goto EndWhile;
+            }
+        }
+
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.X)
         {
 #pragma prefast(suppress : 26019, "Buffer is taken in multiples of 2. Validation is ok.")
@@ -553,7 +576,7 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             }
 
             // line was wrapped if we're writing up to the end of the current row
-            OutputCellIterator it(std::wstring_view(LocalBuffer, i), Attributes);
+            OutputCellIterator it(std::wstring_view(RunStart, i), Attributes);
             const auto itEnd = screenInfo.Write(it);
 
             // Notify accessibility
@@ -568,7 +591,16 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             // WCL-NOTE: We are using the "estimated" X position delta instead of the actual delta from
             // WCL-NOTE: the iterator. It is not clear why. If they differ, the cursor ends up in the
             // WCL-NOTE: wrong place (typically inside another character).
-            CursorPosition.X = XPosition;
+            if constexpr (Feature_GraphemeClusterSegmentation::IsEnabled())
+            {
+                // Combining characters were counted as a column each above, but share the cell of the
+                // character they combine with, so the estimate is guaranteed to be off for them.
+                CursorPosition.X += itEnd.GetCellDistance(it);
+            }
+            else
+            {
+                CursorPosition.X = XPosition;
+            }
 
             // enforce a delayed newline if we're about to pass the end and the WC_DELAY_EOL_WRAP flag is set.
             if (WI_IsFlagSet(dwFlags, WC_DELAY_EOL_WRAP) && CursorPosition.X >= coordScreenBufferSize.X && fWrapAtEOL)
@@ -1146,12 +1178,25 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         auto leadByteCaptured{ false };
         auto leadByteConsumed{ false };
         std::wstring wstr{};
+        std::wstring_view text{};
         static til::u8state u8State{};
+        // UTF-8 is what most clients write in, so its conversion buffer is kept around
+        // instead of being allocated anew for every call. We're under the console lock.
+        // (If we have to wait, WriteData makes its own copy of the text.)
+        static std::wstring u8Buffer{};
 
         // Convert our input parameters to Unicode
         if (codepage == CP_UTF8)
         {
-            RETURN_IF_FAILED(til::u8u16(buffer, wstr, u8State));
+            // If we were previously called with a huge buffer, we shouldn't keep it around forever.
+            if (u8Buffer.capacity() > 64 * 1024 && (u8Buffer.capacity() >> 1) > buffer.size())
+            {
+                u8Buffer.clear();
+                u8Buffer.shrink_to_fit();
+            }
+
+            RETURN_IF_FAILED(til::u8u16(buffer, u8Buffer, u8State));
+            text = u8Buffer;
             read = buffer.size();
         }
         else
@@ -1210,7 +1255,7 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             // if the last byte in mbPtr is a lead byte for the current code page,
             // save it for the next time this function is called and we can piece it
             // back together then
-            if (mbPtrLength != 0 && CheckBisectStringA(const_cast<char*>(mbPtr), mbPtrLength, &consoleInfo.OutputCPInfo))
+            if (mbPtrLength != 0 && CheckBisectStringA(const_cast<char*>(mbPtr), mbPtrLength, consoleInfo.OutputCP))
             {
                 screenInfo.WriteConsoleDbcsLeadByte[0] = gsl::narrow_cast<byte>(mbPtr[mbPtrLength - 1]);
                 mbPtrLength--;
@@ -1228,6 +1273,7 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             }
 
             wstr.resize((dbcsLength + mbPtrLength) / sizeof(wchar_t));
+            text = wstr;
         }
 
         // Hold the specific version of the waiter locally so we can tinker with it if we have to store additional context.
@@ -1235,7 +1281,7 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 
         // Make the W version of the call
         size_t wcBufferWritten{};
-        const auto hr{ WriteConsoleWImplHelper(screenInfo, wstr, wcBufferWritten, requiresVtQuirk, writeDataWaiter) };
+        const auto hr{ WriteConsoleWImplHelper(screenInfo, text, wcBufferWritten, requiresVtQuirk, writeDataWaiter) };
 
         // If there is no waiter, process the byte count now.
         if (nullptr == writeDataWaiter.get())
@@ -15,6 +15,13 @@
 using namespace Microsoft::Console::Types;
 using Microsoft::Console::Interactivity::ServiceLocator;
 
+static bool s_AreCellsEqual(const OutputCell& a, const OutputCell& b)
+{
+    return a.Chars() == b.Chars() &&
+           a.DbcsAttr() == b.DbcsAttr() &&
+           a.TextAttr() == b.TextAttr();
+}
+
 ConversionAreaBufferInfo::ConversionAreaBufferInfo(const til::size coordBufferSize) :
     coordCaBuffer(coordBufferSize)
 {
@@ -50,7 +57,8 @@ ConversionAreaInfo::ConversionAreaInfo(const til::size bufferSize,
 ConversionAreaInfo::ConversionAreaInfo(ConversionAreaInfo&& other) :
     _caInfo(other._caInfo),
     _isHidden(other._isHidden),
-    _screenBuffer(nullptr)
+    _screenBuffer(nullptr),
+    _cells(std::move(other._cells))
 {
     std::swap(_screenBuffer, other._screenBuffer);
 }
@@ -102,16 +110,97 @@ void ConversionAreaInfo::SetAttributes(const TextAttribute& attr)
 }
 
 // Routine Description:
-// - Writes text into the conversion area. Since conversion areas are only
+// - Shows a line of text in the conversion area. Since conversion areas are only
 //   one line, you can only specify the column to write.
+// - If the area is already showing a line at the same position, only the cells that
+//   differ from it are written and redrawn. Most keystrokes only change the end of
+//   the composition or the position of the IME's cursor within it, so this keeps
+//   the cost of a keystroke independent of the length of the composition.
 // Arguments:
-// - text - Text to insert into the conversion area buffer
+// - cells - Text to show in the conversion area
 // - column - Column to start at (X position)
-void ConversionAreaInfo::WriteText(const std::vector<OutputCell>& text,
-                                   const til::CoordType column)
+// - viewPos - Position of the conversion area's origin relative to the viewport
+// Return Value:
+// - The columns of the conversion area that changed, or nullopt if none did.
+std::optional<til::inclusive_rect> ConversionAreaInfo::WriteLine(const gsl::span<const OutputCell> cells,
+                                                                 const til::CoordType column,
+                                                                 const til::point viewPos)
 {
-    gsl::span<const OutputCell> view(text.data(), text.size());
-    _screenBuffer->Write(view, { column, 0 });
+    const til::inclusive_rect region{ column, 0, gsl::narrow<til::CoordType>(column + cells.size() - 1), 0 };
+
+    // If the line moved, erase it from where it was and draw all of it anew.
+    if (IsHidden() || column != _caInfo.rcViewCaWindow.Left || viewPos != _caInfo.coordConView)
+    {
+        if (!IsHidden())
+        {
+            SetHidden(true);
+            Paint();
+        }
+
+        _screenBuffer->Write(cells, { column, 0 });
+        _cells.assign(cells.begin(), cells.end());
+
+        _caInfo.rcViewCaWindow = region;
+        _caInfo.coordConView = viewPos;
+        SetHidden(false);
+        Paint();
+        return region;
+    }
+
+    // Find the range of cells that differ from the previous line.
+    // If the length didn't change, the end might have stayed the same as well.
+    const auto common = std::min(cells.size(), _cells.size());
+    size_t first = 0;
+    while (first < common && s_AreCellsEqual(til::at(cells, first), til::at(_cells, first)))
+    {
+        ++first;
+    }
+
+    auto last = std::max(cells.size(), _cells.size());
+    if (cells.size() == _cells.size())
+    {
+        while (last > first && s_AreCellsEqual(til::at(cells, last - 1), til::at(_cells, last - 1)))
+        {
+            --last;
+        }
+    }
+
+    if (first == last)
+    {
+        return std::nullopt;
+    }
+
+    // Cells past the end of a shorter line don't need to be written, because they're
+    // outside of rcViewCaWindow now. They still need to be redrawn to reveal the buffer below.
+    const auto written = cells.subspan(first, std::min(last, cells.size()) - first);
+    if (!written.empty())
+    {
+        _screenBuffer->Write(written, { gsl::narrow<til::CoordType>(column + first), 0 });
+    }
+    _cells.resize(cells.size());
+    std::copy(written.begin(), written.end(), _cells.begin() + first);
+
+    _caInfo.rcViewCaWindow = region;
+
+    const til::inclusive_rect changed{ gsl::narrow<til::CoordType>(column + first), 0, gsl::narrow<til::CoordType>(column + last - 1), 0 };
+    _Redraw(changed);
+    return changed;
+}
+
+// Routine Description:
+// - Redraws the given region of the conversion area, as well as the text
+//   buffer below it, if the conversion area doesn't cover all of it.
+// Arguments:
+// - region - The region to redraw, relative to the conversion area
+void ConversionAreaInfo::_Redraw(const til::inclusive_rect& region) const
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& screenInfo = gci.GetActiveOutputBuffer();
+    const auto viewport = screenInfo.GetViewport();
+
+    const auto left = viewport.Left() + _caInfo.coordConView.X + region.Left;
+    const auto top = viewport.Top() + _caInfo.coordConView.Y + region.Top;
+    WriteToScreen(screenInfo, Viewport::FromInclusive({ left, top, left + region.Right - region.Left, top + region.Bottom - region.Top }));
 }
 
 // Routine Description:
@@ -147,57 +236,6 @@ void ConversionAreaInfo::ClearArea() noexcept
     return S_OK;
 }
 
-void ConversionAreaInfo::SetWindowInfo(const til::inclusive_rect& view) noexcept
-{
-    if (view.Left != _caInfo.rcViewCaWindow.Left ||
-        view.Top != _caInfo.rcViewCaWindow.Top ||
-        view.Right != _caInfo.rcViewCaWindow.Right ||
-        view.Bottom != _caInfo.rcViewCaWindow.Bottom)
-    {
-        if (!IsHidden())
-        {
-            SetHidden(true);
-            Paint();
-
-            _caInfo.rcViewCaWindow = view;
-            SetHidden(false);
-            Paint();
-        }
-        else
-        {
-            _caInfo.rcViewCaWindow = view;
-        }
-    }
-}
-
-void ConversionAreaInfo::SetViewPos(const til::point pos) noexcept
-{
-    if (IsHidden())
-    {
-        _caInfo.coordConView = pos;
-    }
-    else
-    {
-        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-
-        auto OldRegion = _caInfo.rcViewCaWindow;
-        OldRegion.Left += _caInfo.coordConView.X;
-        OldRegion.Right += _caInfo.coordConView.X;
-        OldRegion.Top += _caInfo.coordConView.Y;
-        OldRegion.Bottom += _caInfo.coordConView.Y;
-        WriteToScreen(gci.GetActiveOutputBuffer(), Viewport::FromInclusive(OldRegion));
-
-        _caInfo.coordConView = pos;
-
-        auto NewRegion = _caInfo.rcViewCaWindow;
-        NewRegion.Left += _caInfo.coordConView.X;
-        NewRegion.Right += _caInfo.coordConView.X;
-        NewRegion.Top += _caInfo.coordConView.Y;
-        NewRegion.Bottom += _caInfo.coordConView.Y;
-        WriteToScreen(gci.GetActiveOutputBuffer(), Viewport::FromInclusive(NewRegion));
-    }
-}
-
 void ConversionAreaInfo::Paint() const noexcept
 {
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
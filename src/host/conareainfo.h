@@ -57,18 +57,23 @@ public:
 
     [[nodiscard]] HRESULT Resize(const til::size newSize) noexcept;
 
-    void SetViewPos(const til::point pos) noexcept;
-    void SetWindowInfo(const til::inclusive_rect& view) noexcept;
     void Paint() const noexcept;
 
-    void WriteText(const std::vector<OutputCell>& text, const til::CoordType column);
+    std::optional<til::inclusive_rect> WriteLine(const gsl::span<const OutputCell> cells,
+                                                 const til::CoordType column,
+                                                 const til::point viewPos);
     void SetAttributes(const TextAttribute& attr);
 
     const TextBuffer& GetTextBuffer() const noexcept;
     const ConversionAreaBufferInfo& GetAreaBufferInfo() const noexcept;
 
 private:
+    void _Redraw(const til::inclusive_rect& region) const;
+
     ConversionAreaBufferInfo _caInfo;
     std::unique_ptr<SCREEN_INFORMATION> _screenBuffer;
     bool _isHidden;
+
+    // The cells WriteLine last wrote, to find out which ones the next call changes.
+    std::vector<OutputCell> _cells;
 };
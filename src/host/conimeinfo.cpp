@@ -43,7 +43,8 @@ void ConsoleImeInfo::RedrawCompMessage()
 {
     if (!_text.empty())
     {
-        ClearAllAreas();
+        // The conversion areas notice on their own whether they moved
+        // and have to be drawn anew, so there's no need to clear them first.
         _WriteUndeterminedChars(_text, _attributes, _colorArray);
     }
 }
@@ -60,8 +61,6 @@ void ConsoleImeInfo::WriteCompMessage(const std::wstring_view text,
                                       const gsl::span<const BYTE> attributes,
                                       const gsl::span<const WORD> colorArray)
 {
-    ClearAllAreas();
-
     // MSFT:29219348 only hide the cursor after the IME produces a string.
     // See notes in convarea.cpp ImeStartComposition().
     SaveCursorVisibility();
@@ -303,6 +302,7 @@ std::vector<OutputCell> ConsoleImeInfo::s_ConvertToCells(const std::wstring_view
 //       - Updated to set up the next conversion area down a line (and to the left viewport edge)
 // - view - The rectangle representing the viewable area of the screen right now to let us know how many cells can fit.
 // - screenInfo - A reference to the screen information we will use for accessibility notifications
+// - areaIndex - The index of the conversion area to use. Incremented if one was used.
 // Return Value:
 // - Updated begin position for the next call. It will normally be >begin and <= end.
 //   However, if text couldn't fit in our line (full-width character starting at the very last cell)
@@ -312,7 +312,8 @@ std::vector<OutputCell>::const_iterator ConsoleImeInfo::_WriteConversionArea(con
                                                                              const std::vector<OutputCell>::const_iterator end,
                                                                              til::point& pos,
                                                                              const Microsoft::Console::Types::Viewport view,
-                                                                             SCREEN_INFORMATION& screenInfo)
+                                                                             SCREEN_INFORMATION& screenInfo,
+                                                                             size_t& areaIndex)
 {
     // The position in the viewport where we will start inserting cells for this conversion area
     // NOTE: We might exit early if there's not enough space to fit here, so we take a copy of
@@ -358,32 +359,26 @@ std::vector<OutputCell>::const_iterator ConsoleImeInfo::_WriteConversionArea(con
         return lineEnd;
     }
 
-    // Copy out the substring into a vector.
-    const std::vector<OutputCell> lineVec(lineBegin, lineEnd);
-
-    // Add a conversion area to the internal state to hold this line.
-    THROW_IF_FAILED(_AddConversionArea());
-
-    // Get the added conversion area.
-    auto& area = ConvAreaCompStr.back();
-
-    // Write our text into the conversion area.
-    area.WriteText(lineVec, insertionPos.X);
+    // Reuse the conversion area that held this line during the previous keystroke, if there was one.
+    // Creating one allocates an entire screen buffer.
+    if (areaIndex >= ConvAreaCompStr.size())
+    {
+        THROW_IF_FAILED(_AddConversionArea());
+    }
 
-    // Set the viewport and positioning parameters for the conversion area to describe to the renderer
-    // the appropriate location to overlay this conversion area on top of the main screen buffer inside the viewport.
-    const til::inclusive_rect region{ insertionPos.X, 0, gsl::narrow<til::CoordType>(insertionPos.X + lineVec.size() - 1), 0 };
-    area.SetWindowInfo(region);
-    area.SetViewPos({ 0 - view.Left(), insertionPos.Y - view.Top() });
+    auto& area = til::at(ConvAreaCompStr, areaIndex);
+    areaIndex++;
 
-    // Make it visible and paint it.
-    area.SetHidden(false);
-    area.Paint();
+    // Write our text into the conversion area and set the positioning parameters that describe to the
+    // renderer the appropriate location to overlay it on top of the main screen buffer inside the viewport.
+    // Only the cells that differ from what the area showed before are written and redrawn.
+    const gsl::span<const OutputCell> line{ &*lineBegin, gsl::narrow_cast<size_t>(lineEnd - lineBegin) };
+    const auto changed = area.WriteLine(line, insertionPos.X, { 0 - view.Left(), insertionPos.Y - view.Top() });
 
     // Notify accessibility that we have updated the text in this display region within the viewport.
-    if (screenInfo.HasAccessibilityEventing())
+    if (changed && screenInfo.HasAccessibilityEventing())
     {
-        screenInfo.NotifyAccessibilityEventing(region.left, insertionPos.Y, region.right, insertionPos.Y);
+        screenInfo.NotifyAccessibilityEventing(changed->left, insertionPos.Y, changed->right, insertionPos.Y);
     }
 
     // Hand back the iterator representing the end of what we used to be fed into the beginning of the next call.
@@ -410,14 +405,25 @@ void ConsoleImeInfo::_WriteUndeterminedChars(const std::wstring_view text,
     // Ensure cursor is visible for prompt line
     screenInfo.MakeCurrentCursorVisible();
 
-    // Clear out existing conversion areas.
-    ConvAreaCompStr.clear();
-
     // If the text length and attribute length don't match,
     // it's a programming error on our part. We control the sizes here.
     FAIL_FAST_IF(text.size() != attributes.size());
 
-    // If we have no text, return. We've already cleared above.
+    // The conversion areas of the previous composition are reused line by line.
+    // Whichever of them this composition doesn't need anymore are hidden at the end.
+    size_t areaIndex = 0;
+    auto hideUnusedAreas = wil::scope_exit([&]() {
+        for (auto i = areaIndex; i < ConvAreaCompStr.size(); ++i)
+        {
+            auto& area = til::at(ConvAreaCompStr, i);
+            if (!area.IsHidden())
+            {
+                area.ClearArea();
+            }
+        }
+    });
+
+    // If we have no text, return. All areas are unused and get hidden on the way out.
     if (text.empty())
     {
         return;
@@ -446,7 +452,7 @@ void ConsoleImeInfo::_WriteUndeterminedChars(const std::wstring_view text,
     // Write over and over updating the beginning iterator until we reach the end.
     do
     {
-        begin = _WriteConversionArea(begin, end, pos, view, screenInfo);
+        begin = _WriteConversionArea(begin, end, pos, view, screenInfo, areaIndex);
     } while (begin < end);
 }
 
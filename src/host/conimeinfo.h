@@ -81,7 +81,8 @@ private:
                                                                  const std::vector<OutputCell>::const_iterator end,
                                                                  til::point& pos,
                                                                  const Microsoft::Console::Types::Viewport view,
-                                                                 SCREEN_INFORMATION& screenInfo);
+                                                                 SCREEN_INFORMATION& screenInfo,
+                                                                 size_t& areaIndex);
 
     bool _isSavedCursorVisible;
 
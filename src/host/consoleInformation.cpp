@@ -399,8 +399,8 @@ void CONSOLE_INFORMATION::ShutdownMidiAudio()
 {
     if (_midiAudio)
     {
-        // We lock the console here to make sure the shutdown promise is
-        // set before the audio is unlocked in the thread that is playing.
+        // We lock the console here, because the output thread
+        // might be creating the audio instance at the same time.
         LockConsole();
         _midiAudio->Shutdown();
         UnlockConsole();
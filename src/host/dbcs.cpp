@@ -18,14 +18,16 @@ using Microsoft::Console::Interactivity::ServiceLocator;
 // Arguments:
 // - pchBuf - Pointer to Ascii string buffer.
 // - cbBuf - Number of Ascii string.
+// - codepage - The codepage of the string.
 // Return Value:
 // - TRUE - Bisected character.
 // - FALSE - Correctly.
-bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const CPINFO* const pCPInfo)
+bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const UINT codepage)
 {
+    const auto& table = CodepageTable::Get(codepage);
     while (cbBuf)
     {
-        if (IsDBCSLeadByteConsole(*pchBuf, pCPInfo))
+        if (table.IsLeadByte(*pchBuf))
         {
             if (cbBuf <= 1)
             {
@@ -186,6 +188,7 @@ _Ret_range_(0, cbAnsi)
                                 _Out_ std::unique_ptr<IInputEvent>& partialEvent)
 {
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& table = CodepageTable::Get(gci.CP);
     const auto TmpUni = new (std::nothrow) WCHAR[cchUnicode];
     if (TmpUni == nullptr)
     {
@@ -200,11 +203,11 @@ _Ret_range_(0, cbAnsi)
     ULONG i, j;
     for (i = 0, j = 0; i < cchUnicode && j < cbAnsi; i++, j++)
     {
+        const auto oem = table.ToOem(TmpUni[i]);
         if (IsGlyphFullWidth(TmpUni[i]))
         {
-            const auto NumBytes = sizeof(AsciiDbcs);
-            ConvertToOem(gci.CP, &TmpUni[i], 1, (LPSTR)&AsciiDbcs[0], NumBytes);
-            if (IsDBCSLeadByteConsole(AsciiDbcs[0], &gci.CPInfo))
+            std::copy(oem.begin(), oem.end(), &AsciiDbcs[0]);
+            if (table.IsLeadByte(AsciiDbcs[0]))
             {
                 if (j < cbAnsi - 1)
                 { // -1 is safe DBCS in buffer
@@ -225,9 +228,10 @@ _Ret_range_(0, cbAnsi)
                 AsciiDbcs[1] = 0;
             }
         }
-        else
+        // Characters that convert into 2 bytes don't fit into the 1 byte we have here.
+        else if (oem.size() == 1)
         {
-            ConvertToOem(gci.CP, &TmpUni[i], 1, &pchAnsi[j], 1);
+            pchAnsi[j] = oem.front();
         }
     }
 
@@ -251,3 +255,102 @@ _Ret_range_(0, cbAnsi)
     delete[] TmpUni;
     return j;
 }
+
+// Routine Description:
+// - Returns the lookup tables for the given codepage, creating them on first use.
+// Arguments:
+// - codepage - the codepage to convert from and to
+// Return Value:
+// - The tables, which remain valid for the lifetime of the process.
+CodepageTable& CodepageTable::Get(const UINT codepage)
+{
+    // Applications rarely switch between more than a couple of codepages.
+    static std::unordered_map<UINT, std::unique_ptr<CodepageTable>> tables;
+
+    auto& table = tables[codepage];
+    if (!table)
+    {
+        table.reset(new CodepageTable(codepage));
+    }
+    return *table;
+}
+
+CodepageTable::CodepageTable(const UINT codepage) :
+    _codepage{ codepage }
+{
+    CPINFO info{};
+    if (GetCPInfo(codepage, &info))
+    {
+        // The array is guaranteed to be terminated by 2 null bytes.
+        for (auto i = 0; info.LeadByte[i]; i += 2)
+        {
+            for (UINT ch = info.LeadByte[i]; ch <= info.LeadByte[i + 1]; ++ch)
+            {
+                _leadBytes.set(ch);
+            }
+        }
+    }
+
+    for (auto i = 0; i < 256; ++i)
+    {
+        if (!_leadBytes.test(i))
+        {
+            const auto ch = gsl::narrow_cast<char>(i);
+            ConvertOutputToUnicode(codepage, &ch, 1, &til::at(_sbcsToUnicode, i), 1);
+        }
+    }
+}
+
+bool CodepageTable::IsLeadByte(const char ch) const noexcept
+{
+    return _leadBytes.test(til::bit_cast<uint8_t>(ch));
+}
+
+// Routine Description:
+// - Converts a single byte character in a buffer cell into UTF-16,
+//   just like ConvertOutputToUnicode would. It must not be a lead byte.
+wchar_t CodepageTable::OutputToUnicode(const char ch) const noexcept
+{
+    return til::at(_sbcsToUnicode, til::bit_cast<uint8_t>(ch));
+}
+
+// Routine Description:
+// - Converts a double byte character that spans 2 buffer cells into UTF-16,
+//   just like ConvertOutputToUnicode would.
+wchar_t CodepageTable::OutputToUnicode(const char lead, const char trail)
+{
+    auto& block = til::at(_dbcsToUnicode, til::bit_cast<uint8_t>(lead));
+    if (!block)
+    {
+        block = std::make_unique<std::array<wchar_t, 256>>();
+        for (auto i = 0; i < 256; ++i)
+        {
+            const char dbcs[2]{ lead, gsl::narrow_cast<char>(i) };
+            ConvertOutputToUnicode(_codepage, &dbcs[0], 2, &til::at(*block, i), 1);
+        }
+    }
+    return til::at(*block, til::bit_cast<uint8_t>(trail));
+}
+
+// Routine Description:
+// - Converts a UTF-16 character into the codepage, just like ConvertToOem
+//   would given a 2 byte buffer.
+// Return Value:
+// - The 1 or 2 bytes it converts into, or an empty string if it can't be converted.
+std::string_view CodepageTable::ToOem(const wchar_t wch)
+{
+    auto& block = til::at(_unicodeToOem, wch >> 8);
+    if (!block)
+    {
+        block = std::make_unique<std::array<OemChar, 256>>();
+        for (auto i = 0; i < 256; ++i)
+        {
+            const auto ch = gsl::narrow_cast<wchar_t>((wch & 0xff00) | i);
+            auto& oem = til::at(*block, i);
+            oem.length = gsl::narrow_cast<uint8_t>(ConvertToOem(_codepage, &ch, 1, &oem.bytes[0], 2));
+        }
+    }
+
+    const auto& oem = til::at(*block, wch & 0xff);
+    return { &oem.bytes[0], oem.length };
+}
@@ -20,7 +20,9 @@ Revision History:
 
 #include "screenInfo.hpp"
 
-bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const CPINFO* const pCPInfo);
+#include <bitset>
+
+bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const UINT codepage);
 
 DWORD UnicodeRasterFontCellMungeOnRead(const gsl::span<CHAR_INFO> buffer);
 
@@ -36,3 +38,35 @@ _Ret_range_(0, cbAnsi)
                                 _Out_writes_bytes_(cbAnsi) PCHAR pchAnsi,
                                 const ULONG cbAnsi,
                                 _Out_ std::unique_ptr<IInputEvent>& partialEvent);
+
+// Lookup tables for converting single cells between a codepage and UTF-16, which
+// the legacy A APIs do for every cell they read or write. Calling into
+// MultiByteToWideChar & co. for each of them is particularly slow for DBCS
+// codepages. The tables are filled lazily, 256 characters at a time, with the
+// results of ConvertOutputToUnicode and ConvertToOem, so they return the same thing.
+// Just like the rest of the console state, they must only be used under the console lock.
+class CodepageTable
+{
+public:
+    static CodepageTable& Get(const UINT codepage);
+
+    bool IsLeadByte(const char ch) const noexcept;
+    wchar_t OutputToUnicode(const char ch) const noexcept;
+    wchar_t OutputToUnicode(const char lead, const char trail);
+    std::string_view ToOem(const wchar_t wch);
+
+private:
+    explicit CodepageTable(const UINT codepage);
+
+    struct OemChar
+    {
+        char bytes[2];
+        uint8_t length;
+    };
+
+    UINT _codepage;
+    std::bitset<256> _leadBytes;
+    std::array<wchar_t, 256> _sbcsToUnicode{};
+    std::array<std::unique_ptr<std::array<wchar_t, 256>>, 256> _dbcsToUnicode;
+    std::array<std::unique_ptr<std::array<OemChar, 256>>, 256> _unicodeToOem;
+};
@@ -507,9 +507,25 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
     try
     {
-        auto events = IInputEvent::Create(buffer);
+        // The records are stored as they are, without creating an IInputEvent for each of them.
+        // IInputEvent::Create() used to reject unknown event types for us, so we still need to.
+        for (const auto& record : buffer)
+        {
+            switch (record.EventType)
+            {
+            case KEY_EVENT:
+            case MOUSE_EVENT:
+            case WINDOW_BUFFER_SIZE_EVENT:
+            case MENU_EVENT:
+            case FOCUS_EVENT:
+                break;
+            default:
+                return E_INVALIDARG;
+            }
+        }
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        written = append ? context.Write(buffer) : context.Prepend(buffer);
+        return S_OK;
     }
     CATCH_RETURN();
 }
@@ -529,6 +545,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
+        auto& table = CodepageTable::Get(codepage);
         const auto size = rectangle.Dimensions();
         auto outIter = buffer.begin();
 
@@ -559,7 +576,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
                         // Try to convert the unicode character (2 bytes) in the leading cell to the codepage.
                         CHAR AsciiDbcs[2]{};
-                        ConvertToOem(codepage, &in1.Char.UnicodeChar, 1, &AsciiDbcs[0], 2);
+                        const auto oem = table.ToOem(in1.Char.UnicodeChar);
+                        std::copy(oem.begin(), oem.end(), &AsciiDbcs[0]);
 
                         // Fill the 1 byte (AsciiChar) portion of the leading and trailing cells with each of the bytes returned.
                         // We have to be bit careful here not to directly write the CHARs, because CHARs are signed whereas wchar_t isn't
@@ -579,8 +597,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                 {
                     // If there are no leading/trailing pair flags, then we only have 1 ascii byte to try to fit the
                     // 2 byte UTF-16 character into. Give it a go.
-                    CHAR asciiChar{};
-                    ConvertToOem(codepage, &in1.Char.UnicodeChar, 1, &asciiChar, 1);
+                    const auto oem = table.ToOem(in1.Char.UnicodeChar);
+                    const auto asciiChar = oem.size() == 1 ? oem.front() : CHAR{};
                     in1.Char.UnicodeChar = til::bit_cast<uint8_t>(asciiChar);
                 }
             }
@@ -606,7 +624,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& table = CodepageTable::Get(codepage);
 
         const auto size = rectangle.Dimensions();
         auto outIter = buffer.begin();
@@ -620,7 +638,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                 WI_ClearAllFlags(in1.Attributes, COMMON_LVB_SBCSDBCS);
 
                 // If the 1 byte given is a lead in this codepage, we likely need two cells for the width.
-                if (IsDBCSLeadByteConsole(in1.Char.AsciiChar, &gci.OutputCPInfo))
+                if (table.IsLeadByte(in1.Char.AsciiChar))
                 {
                     // If we're not on the last column, we have two cells to use.
                     if (j < size.X - 1)
@@ -633,14 +651,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                         auto& in2 = *outIter;
                         WI_ClearAllFlags(in2.Attributes, COMMON_LVB_SBCSDBCS);
 
-                        // Grab the lead/trailing byte pair from this cell and the next one forward.
-                        CHAR AsciiDbcs[2];
-                        AsciiDbcs[0] = in1.Char.AsciiChar;
-                        AsciiDbcs[1] = in2.Char.AsciiChar;
-
-                        // Convert it to UTF-16.
-                        wchar_t wch = UNICODE_SPACE;
-                        ConvertOutputToUnicode(codepage, &AsciiDbcs[0], 2, &wch, 1);
+                        // Convert the lead/trailing byte pair from this cell and the next one forward to UTF-16.
+                        const auto wch = table.OutputToUnicode(in1.Char.AsciiChar, in2.Char.AsciiChar);
 
                         // Store the actual character in the first available position.
                         in1.Char.UnicodeChar = wch;
@@ -659,9 +671,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                 else
                 {
                     // If it's not detected as a lead byte of a pair, then just convert it in place and move on.
-                    wchar_t wch = UNICODE_SPACE;
-                    ConvertOutputToUnicode(codepage, &in1.Char.AsciiChar, 1, &wch, 1);
-                    in1.Char.UnicodeChar = wch;
+                    in1.Char.UnicodeChar = table.OutputToUnicode(in1.Char.AsciiChar);
                 }
             }
         }
@@ -728,7 +738,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer().GetTextBuffer();
         const auto storageSize = storageBuffer.GetSize().Dimensions();
 
@@ -766,41 +775,38 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        til::point targetPos;
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        const auto clippedSize = clippedRequestRectangle.Dimensions();
+
+        // Convert the clipped request a row at a time straight into the user's buffer.
+        // Cells of the target outside of the clipped request are left untouched.
+        // The legacy attributes are computed once per run of identical attributes
+        // rather than once per cell, as that mapping can be fairly expensive for RGB colors.
+        for (til::CoordType y = 0; y < clippedSize.Y; ++y)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            const auto targetOffset = gsl::narrow_cast<size_t>((targetPoint.Y + y) * targetSize.X + targetPoint.X);
+            const auto width = gsl::narrow_cast<size_t>(clippedSize.X);
+
+            // Stop once the user's buffer can't hold another row.
+            if (targetOffset + width > targetBuffer.size())
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                ++sourceIter;
+                break;
             }
 
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            ++targetIter;
+            const auto target = targetBuffer.subspan(targetOffset, width);
+            const auto& row = storageBuffer.GetRowByOffset(sourcePoint.Y + y);
+            const auto& charRow = row.GetCharRow();
+            til::CoordType x = 0;
 
-            // Increment the target
-            targetPos.X++;
-            if (targetPos.X >= targetSize.X)
-            {
-                targetPos.X = 0;
-                targetPos.Y++;
-            }
+            row.GetAttrRow().ForEachRun(sourcePoint.X, sourcePoint.X + clippedSize.X, [&](const TextAttribute& attr, const uint16_t length) {
+                const auto legacyAttributes = attr.GetLegacyAttributes();
+                for (const auto runEnd = x + length; x < runEnd; ++x)
+                {
+                    const auto column = sourcePoint.X + x;
+                    auto& ci = til::at(target, x);
+                    ci.Char.UnicodeChar = Utf16ToUcs2(charRow.GlyphViewAt(column));
+                    ci.Attributes = legacyAttributes | charRow.DbcsAttrAt(column).GeneratePublicApiAttributeFormat();
+                }
+            });
         }
 
         // Reply with the region we read out of the backing buffer (potentially clipped)
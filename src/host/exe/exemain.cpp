@@ -270,6 +270,11 @@ int CALLBACK wWinMain(
                           GetStdHandle(STD_OUTPUT_HANDLE));
 
     auto hr = args.ParseCommandline();
+    if (SUCCEEDED(hr) && args.IsPooled())
+    {
+        // We were started ahead of time and wait here until we're given a pseudoconsole.
+        hr = args.WaitForPoolHandoff();
+    }
     if (SUCCEEDED(hr))
     {
         // Only try to register as a handoff target if we are NOT a part of Windows.
@@ -13,6 +13,52 @@
 #include "../getset.h"
 #include <til/u8u16convert.h>
 
+#include <fstream>
+
+// The "slow input" mode looks for inputs that are pathologically slow instead of ones that
+// crash, like huge repeat counts or scroll margin churn. It's enabled by setting the
+// CONHOST_FUZZ_SLOW_INPUT environment variable. The inputs are then written through
+// StateMachine -> AdaptDispatch -> TextBuffer, and any input that takes longer or allocates
+// more than its budget is reported and aborts, so that libFuzzer saves (and with
+// -minimize_crash=1, minimizes) it. VTCommandFuzzer's "slow" mode generates a seed corpus.
+//
+// Without FUZZING_BUILD the inputs given on the commandline are measured instead.
+// This is how the minimized inputs in SlowInputCorpus serve as regression benchmarks.
+static constexpr std::chrono::microseconds timeBudgetBase{ 50000 };
+static constexpr std::chrono::nanoseconds timeBudgetPerByte{ 10000 };
+static constexpr size_t allocationBudgetBase = 4 * 1024 * 1024;
+static constexpr size_t allocationBudgetPerByte = 1024;
+
+static bool s_slowInputMode = false;
+static std::atomic<size_t> s_allocatedBytes{ 0 };
+
+void* __cdecl operator new(const size_t size)
+{
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void __cdecl operator delete(void* const p) noexcept
+{
+    free(p);
+}
+
+struct InputMeasurement
+{
+    std::chrono::nanoseconds duration;
+    size_t allocatedBytes;
+
+    bool IsWithinBudget(const size_t size) const noexcept
+    {
+        return duration <= timeBudgetBase + timeBudgetPerByte * size &&
+               allocatedBytes <= allocationBudgetBase + allocationBudgetPerByte * size;
+    }
+};
+
 struct NullDeviceComm : public IDeviceComm
 {
     HRESULT SetServerInformation(CD_IO_SERVER_INFORMATION* const) const override
@@ -103,6 +149,7 @@ struct NullDeviceComm : public IDeviceComm
 extern "C" __declspec(dllexport) HRESULT RunConhost()
 {
     Microsoft::Console::Interactivity::ServiceLocator::LocateGlobals().hInstance = wil::GetModuleInstanceHandle();
+    s_slowInputMode = GetEnvironmentVariableW(L"CONHOST_FUZZ_SLOW_INPUT", nullptr, 0) != 0;
 
     // passing stdin/stdout lets us drive this like conpty (!!) and test the VT renderer (!!)
     // but for now we want to drive it like conhost
@@ -117,17 +164,43 @@ extern "C" __declspec(dllexport) HRESULT RunConhost()
     return hr;
 }
 
+static InputMeasurement MeasureInput(const uint8_t* data, size_t size);
+
 #ifdef FUZZING_BUILD
 extern "C" __declspec(dllexport) int LLVMFuzzerInitialize(int* /*argc*/, char*** /*argv*/)
-#else
-int main(int /*argc*/, char** /*argv*/)
-#endif
 {
     RETURN_IF_FAILED(RunConhost());
     return 0;
 }
+#else
+int main(int argc, char** argv)
+{
+    RETURN_IF_FAILED(RunConhost());
 
-extern "C" __declspec(dllexport) int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+    auto exceeded = 0;
+    for (auto i = 1; i < argc; i++)
+    {
+        std::ifstream file{ argv[i], std::ios::binary };
+        const std::string input{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+        s_slowInputMode = true;
+        const auto measurement = MeasureInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+        const auto withinBudget = measurement.IsWithinBudget(input.size());
+        exceeded += withinBudget ? 0 : 1;
+
+        printf("%s%s: %zu bytes, %lld us, %zu bytes allocated\n",
+               withinBudget ? "" : "OVER BUDGET ",
+               argv[i],
+               input.size(),
+               std::chrono::duration_cast<std::chrono::microseconds>(measurement.duration).count(),
+               measurement.allocatedBytes);
+    }
+
+    return exceeded;
+}
+#endif
+
+static InputMeasurement MeasureInput(const uint8_t* data, size_t size)
 {
     auto& gci = Microsoft::Console::Interactivity::ServiceLocator::LocateGlobals().getConsoleInformation();
 
@@ -136,14 +209,47 @@ extern "C" __declspec(dllexport) int LLVMFuzzerTestOneInput(const uint8_t* data,
     auto sizeInBytes{ u16String.size() * 2 };
     gci.LockConsole();
     auto u = wil::scope_exit([&]() { gci.UnlockConsole(); });
-    (void)WriteCharsLegacy(gci.GetActiveOutputBuffer(),
-                           u16String.data(),
-                           u16String.data(),
-                           u16String.data(),
-                           &sizeInBytes,
-                           nullptr,
-                           0,
-                           WC_PRINTABLE_CONTROL_CHARS | WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE,
-                           &scrollY);
+    auto& screenInfo = gci.GetActiveOutputBuffer();
+
+    if (!s_slowInputMode)
+    {
+        (void)WriteCharsLegacy(screenInfo,
+                               u16String.data(),
+                               u16String.data(),
+                               u16String.data(),
+                               &sizeInBytes,
+                               nullptr,
+                               0,
+                               WC_PRINTABLE_CONTROL_CHARS | WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE,
+                               &scrollY);
+        return {};
+    }
+
+    // Every input starts from a reset terminal, so that
+    // the previous one can't blow the budget of this one.
+    auto& stateMachine = screenInfo.GetStateMachine();
+    stateMachine.ProcessString(L"\x1b\\\x1b" L"c");
+
+    const auto allocatedBefore = s_allocatedBytes.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    stateMachine.ProcessString(u16String);
+    return {
+        std::chrono::steady_clock::now() - start,
+        s_allocatedBytes.load(std::memory_order_relaxed) - allocatedBefore,
+    };
+}
+
+extern "C" __declspec(dllexport) int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    const auto measurement = MeasureInput(data, size);
+    if (s_slowInputMode && !measurement.IsWithinBudget(size))
+    {
+        fprintf(stderr,
+                "Slow input: %zu bytes took %lld us and allocated %zu bytes\n",
+                size,
+                std::chrono::duration_cast<std::chrono::microseconds>(measurement.duration).count(),
+                measurement.allocatedBytes);
+        abort();
+    }
     return 0;
 }
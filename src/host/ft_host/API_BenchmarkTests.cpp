@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+using namespace WEX::Logging;
+using namespace WEX::Common;
+using namespace WEX::TestExecution;
+
+// This class measures calls/second and latency percentiles of the
+// console APIs that legacy tools use the most. Run only these with
+//     te.exe Microsoft.Console.Host.FeatureTests.dll /select:"@IsPerfTest=true"
+// and add /p:ForceOpenConsole=true, /p:TestAsV1=true or /p:TestAsConpty=true
+// to compare OpenConsole, the inbox console and conpty (see InitTests.cpp).
+// /p:BenchmarkIterations=N changes how often each API is called.
+class BenchmarkTests
+{
+    BEGIN_TEST_CLASS(BenchmarkTests)
+        TEST_CLASS_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_CLASS()
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        VERIFY_IS_TRUE(Common::TestBufferSetup());
+
+        _iterations = 10000;
+        RuntimeParameters::TryGetValue(L"BenchmarkIterations", _iterations);
+
+        _info.cbSize = sizeof(_info);
+        VERIFY_WIN32_BOOL_SUCCEEDED(GetConsoleScreenBufferInfoEx(Common::_hConsole, &_info));
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        return Common::TestBufferCleanup();
+    }
+
+    TEST_METHOD(WriteConsoleSmall);
+    TEST_METHOD(WriteConsoleLarge);
+    TEST_METHOD(WriteConsoleOutputFrame);
+    TEST_METHOD(ReadConsoleOutputFrame);
+    TEST_METHOD(FillConsoleOutputCharacterBuffer);
+    TEST_METHOD(FillConsoleOutputAttributeBuffer);
+    TEST_METHOD(SetConsoleCursorPositionViewport);
+    TEST_METHOD(GetConsoleScreenBufferInfoExRepeated);
+
+private:
+    template<typename Call>
+    void _Measure(PCWSTR name, const int iterations, Call&& call);
+
+    SMALL_RECT _Frame() const noexcept
+    {
+        return _info.srWindow;
+    }
+
+    COORD _FrameSize() const noexcept
+    {
+        return { static_cast<SHORT>(_info.srWindow.Right - _info.srWindow.Left + 1), static_cast<SHORT>(_info.srWindow.Bottom - _info.srWindow.Top + 1) };
+    }
+
+    int _iterations = 0;
+    CONSOLE_SCREEN_BUFFER_INFOEX _info{};
+};
+
+// Routine Description:
+// - Calls the given function a tenth of the iterations to warm up, then the
+//   given number of iterations, and logs the calls/second and latency percentiles.
+template<typename Call>
+void BenchmarkTests::_Measure(PCWSTR name, const int iterations, Call&& call)
+{
+    VERIFY_IS_GREATER_THAN(iterations, 0);
+
+    for (auto i = 0; i < iterations / 10; ++i)
+    {
+        VERIFY_WIN32_BOOL_SUCCEEDED(call(i));
+    }
+
+    std::vector<std::chrono::steady_clock::duration> latencies;
+    latencies.reserve(iterations);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        const auto before = std::chrono::steady_clock::now();
+        const auto succeeded = call(i);
+        latencies.emplace_back(std::chrono::steady_clock::now() - before);
+        VERIFY_WIN32_BOOL_SUCCEEDED(succeeded);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](const size_t percent) {
+        const auto index = std::min(latencies.size() - 1, latencies.size() * percent / 100);
+        return std::chrono::duration<double, std::micro>(latencies.at(index)).count();
+    };
+
+    Log::Comment(String().Format(L"%ls: %d calls, %.0f calls/s, p50 %.1fus, p90 %.1fus, p99 %.1fus, max %.1fus",
+                                 name,
+                                 iterations,
+                                 iterations / elapsed,
+                                 percentile(50),
+                                 percentile(90),
+                                 percentile(99),
+                                 percentile(100)));
+}
+
+void BenchmarkTests::WriteConsoleSmall()
+{
+    // Like a prompt or a progress indicator: a few characters at a time.
+    static constexpr std::wstring_view text{ L"progress: 42%\r\n" };
+    _Measure(L"WriteConsoleW (15 chars)", _iterations, [&](int) {
+        DWORD written = 0;
+        return WriteConsoleW(Common::_hConsole, text.data(), gsl::narrow_cast<DWORD>(text.size()), &written, nullptr);
+    });
+}
+
+void BenchmarkTests::WriteConsoleLarge()
+{
+    // Like `type`ing a file: 32K characters of lines that don't fit the window.
+    std::wstring text;
+    for (auto i = 0; text.size() < 32768; ++i)
+    {
+        text.append(String().Format(L"line %5d: the quick brown fox jumps over the lazy dog, again and again and again\r\n", i));
+    }
+
+    _Measure(L"WriteConsoleW (32K chars)", std::max(_iterations / 100, 10), [&](int) {
+        DWORD written = 0;
+        return WriteConsoleW(Common::_hConsole, text.data(), gsl::narrow_cast<DWORD>(text.size()), &written, nullptr);
+    });
+}
+
+void BenchmarkTests::WriteConsoleOutputFrame()
+{
+    // Like a full-screen TUI redrawing every cell of the window with changing attributes.
+    const auto size = _FrameSize();
+    const auto cells = static_cast<size_t>(size.X) * size.Y;
+    std::vector<CHAR_INFO> frame(cells);
+
+    _Measure(L"WriteConsoleOutputW (window)", _iterations / 10, [&](int i) {
+        for (size_t j = 0; j < cells; ++j)
+        {
+            frame[j].Char.UnicodeChar = static_cast<wchar_t>(L'A' + (i + j) % 26);
+            frame[j].Attributes = static_cast<WORD>((i + j) % 16);
+        }
+        auto region = _Frame();
+        return WriteConsoleOutputW(Common::_hConsole, frame.data(), size, {}, &region);
+    });
+}
+
+void BenchmarkTests::ReadConsoleOutputFrame()
+{
+    const auto size = _FrameSize();
+    std::vector<CHAR_INFO> frame(static_cast<size_t>(size.X) * size.Y);
+
+    _Measure(L"ReadConsoleOutputW (window)", _iterations / 10, [&](int) {
+        auto region = _Frame();
+        return ReadConsoleOutputW(Common::_hConsole, frame.data(), size, {}, &region);
+    });
+}
+
+void BenchmarkTests::FillConsoleOutputCharacterBuffer()
+{
+    // Like `cls`: fill the entire buffer, not just the window.
+    const auto length = static_cast<DWORD>(_info.dwSize.X) * _info.dwSize.Y;
+    _Measure(L"FillConsoleOutputCharacterW (buffer)", _iterations / 10, [&](int i) {
+        DWORD written = 0;
+        return FillConsoleOutputCharacterW(Common::_hConsole, i % 2 ? L' ' : L'#', length, {}, &written);
+    });
+}
+
+void BenchmarkTests::FillConsoleOutputAttributeBuffer()
+{
+    // Like a TUI clearing the screen to its background color.
+    const auto length = static_cast<DWORD>(_info.dwSize.X) * _info.dwSize.Y;
+    _Measure(L"FillConsoleOutputAttribute (buffer)", _iterations / 10, [&](int i) {
+        DWORD written = 0;
+        return FillConsoleOutputAttribute(Common::_hConsole, i % 2 ? FOREGROUND_BLUE : BACKGROUND_BLUE, length, {}, &written);
+    });
+}
+
+void BenchmarkTests::SetConsoleCursorPositionViewport()
+{
+    // Like a TUI moving the cursor around before every write.
+    const auto size = _FrameSize();
+    _Measure(L"SetConsoleCursorPosition", _iterations, [&](int i) {
+        const COORD position{ static_cast<SHORT>(_info.srWindow.Left + (i * 7) % size.X), static_cast<SHORT>(_info.srWindow.Top + (i * 3) % size.Y) };
+        return SetConsoleCursorPosition(Common::_hConsole, position);
+    });
+}
+
+void BenchmarkTests::GetConsoleScreenBufferInfoExRepeated()
+{
+    // Many tools query the buffer before every write to find the cursor and their colors.
+    _Measure(L"GetConsoleScreenBufferInfoEx", _iterations, [&](int) {
+        CONSOLE_SCREEN_BUFFER_INFOEX info{};
+        info.cbSize = sizeof(info);
+        return GetConsoleScreenBufferInfoEx(Common::_hConsole, &info);
+    });
+}
@@ -25,6 +25,10 @@ class CursorTests
     BEGIN_TEST_METHOD(TestSetConsoleCursorPosition)
         TEST_METHOD_PROPERTY(L"HostDestructive", L"True")
     END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(PollingPerformance)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 };
 
 bool CursorTests::TestSetup()
@@ -157,3 +161,35 @@ void CursorTests::TestSetConsoleCursorPosition()
     TestSetConsoleCursorPositionImpl(sbiInitial.dwSize.X, sbiInitial.dwSize.Y, FALSE); // 1 beyond bottom right corner (the size is 1 larger than the array indices)
     TestSetConsoleCursorPositionImpl(MAXWORD, MAXWORD, FALSE); // Max values
 }
+
+// Measures the server cost of the calls progress bars and prompts make in a tight loop:
+// query the buffer, then put the cursor back where it was.
+void CursorTests::PollingPerformance()
+{
+    static constexpr auto iterations = 20000;
+
+    CONSOLE_SCREEN_BUFFER_INFOEX sbiex = { 0 };
+    sbiex.cbSize = sizeof(sbiex);
+    VERIFY_WIN32_BOOL_SUCCEEDED(GetConsoleScreenBufferInfoEx(Common::_hConsole, &sbiex));
+    const auto position = sbiex.dwCursorPosition;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        GetConsoleScreenBufferInfoEx(Common::_hConsole, &sbiex);
+    }
+    const auto infoElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        SetConsoleCursorPosition(Common::_hConsole, position);
+    }
+    const auto cursorElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WEX::Logging::Log::Comment(WEX::Common::NoThrowString().Format(L"GetConsoleScreenBufferInfoEx: %.2fus per call", infoElapsed * 1e6 / iterations));
+    WEX::Logging::Log::Comment(WEX::Common::NoThrowString().Format(L"SetConsoleCursorPosition: %.2fus per call", cursorElapsed * 1e6 / iterations));
+
+    VERIFY_WIN32_BOOL_SUCCEEDED(GetConsoleScreenBufferInfoEx(Common::_hConsole, &sbiex));
+    VERIFY_ARE_EQUAL(position, sbiex.dwCursorPosition);
+}
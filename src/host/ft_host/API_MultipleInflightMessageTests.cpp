@@ -108,4 +108,101 @@ class MultipleInflightMessageTests
 
         VERIFY_ARE_EQUAL(L"hi!\r"sv, (std::wstring_view{ buffer.data(), read }));
     }
+
+    // A ReadConsole that has to wait for input is parked in the server's wait queue,
+    // so that writes from the client's other threads are still serviced in the meantime.
+    TEST_METHOD(WriteWhileReadIsBlocked)
+    {
+        const auto inputHandle = GetStdInputHandle();
+        const auto outputHandle = GetStdOutputHandle();
+
+        DWORD originalConsoleMode{};
+        VERIFY_WIN32_BOOL_SUCCEEDED(GetConsoleMode(inputHandle, &originalConsoleMode));
+        auto restoreMode{ wil::scope_exit([=]() {
+            SetConsoleMode(inputHandle, originalConsoleMode);
+        }) };
+        VERIFY_WIN32_BOOL_SUCCEEDED(SetConsoleMode(inputHandle, 0));
+        VERIFY_WIN32_BOOL_SUCCEEDED(FlushConsoleInputBuffer(inputHandle));
+
+        std::array<wchar_t, 16> buffer;
+        DWORD read{};
+        std::thread readerThread{ [&]() {
+            WEX::TestExecution::DisableVerifyExceptions disableVerifyExceptions{};
+            VERIFY_WIN32_BOOL_SUCCEEDED(ReadConsoleW(inputHandle, buffer.data(), static_cast<DWORD>(buffer.size()), &read, nullptr));
+        } };
+        auto joinReader{ wil::scope_exit([&]() {
+            // Unblock the reader, should the test fail before it does so itself.
+            const INPUT_RECORD record{ KEY_EVENT, KEY_EVENT_RECORD{ TRUE, 1, 'x', 0, L'x', 0 } };
+            DWORD written{};
+            WriteConsoleInputW(inputHandle, &record, 1, &written);
+            readerThread.join();
+        }) };
+        Sleep(50); // Give the read a chance to arrive at the server and block.
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < 100; ++i)
+        {
+            DWORD written{};
+            VERIFY_WIN32_BOOL_SUCCEEDED(WriteConsoleW(outputHandle, L"x\b", 2, &written, nullptr));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        Log::Comment(WEX::Common::NoThrowString().Format(L"100 writes took %lldms while a read was blocked", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+        VERIFY_IS_TRUE(elapsed < std::chrono::seconds(5));
+
+        joinReader.reset();
+        VERIFY_ARE_EQUAL(1u, read);
+        VERIFY_ARE_EQUAL(L'x', buffer[0]);
+    }
+
+    // Measures how fast several threads of the same client can write to the console at once.
+    // This isn't a pass/fail test, but a benchmark for the server's message handling.
+    TEST_METHOD(ConcurrentWritersThroughput)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"Data:threadCount", L"{1, 2, 4, 8}")
+        END_TEST_METHOD_PROPERTIES()
+
+        size_t threadCount;
+        VERIFY_SUCCEEDED(WEX::TestExecution::TestData::TryGetValue(L"threadCount", threadCount));
+
+        static constexpr auto writesPerThread = 2000;
+        const auto outputHandle = GetStdOutputHandle();
+
+        // Every write carries a payload large enough to be copied separately from the message.
+        std::wstring line(512, L'x');
+        line.append(L"\r");
+
+        std::atomic<size_t> failures{ 0 };
+        std::vector<std::thread> writers;
+        writers.reserve(threadCount);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            writers.emplace_back([&]() {
+                for (auto j = 0; j < writesPerThread; ++j)
+                {
+                    DWORD written{};
+                    if (!WriteConsoleW(outputHandle, line.data(), gsl::narrow_cast<DWORD>(line.size()), &written, nullptr) || written != line.size())
+                    {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto writes = threadCount * writesPerThread;
+        Log::Comment(WEX::Common::NoThrowString().Format(L"%zu threads: %zu writes in %.3fs, %.0f writes/s, %.1f MB/s",
+                                            threadCount,
+                                            writes,
+                                            elapsed,
+                                            writes / elapsed,
+                                            writes * line.size() * sizeof(wchar_t) / elapsed / 1e6));
+        VERIFY_ARE_EQUAL(size_t{ 0 }, failures.load());
+    }
 };
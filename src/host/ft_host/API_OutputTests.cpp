@@ -37,6 +37,7 @@ class OutputTests
     TEST_METHOD(ReadConsoleOutputWWithClipping);
     TEST_METHOD(ReadConsoleOutputWNegativePositions);
     TEST_METHOD(ReadConsoleOutputWPartialUserBuffer);
+    TEST_METHOD(ReadConsoleOutputWMixedAttributes);
 
     TEST_METHOD(WriteConsoleOutputCharacterWRunoff);
 
@@ -371,6 +372,57 @@ void OutputTests::WriteConsoleOutputWNegativePositions()
     VERIFY_WIN32_BOOL_FAILED(WriteConsoleOutputW(consoleOutputHandle, buffer.data(), regionDimensions, regionOrigin, &affected));
 }
 
+void OutputTests::ReadConsoleOutputWMixedAttributes()
+{
+    SetVerifyOutput vf(VerifyOutputSettings::LogOnlyFailures);
+
+    // Get output buffer information.
+    const auto consoleOutputHandle = GetStdOutputHandle();
+    SetConsoleActiveScreenBuffer(consoleOutputHandle);
+
+    CONSOLE_SCREEN_BUFFER_INFOEX sbiex{ 0 };
+    sbiex.cbSize = sizeof(sbiex);
+
+    // Get buffer information
+    VERIFY_WIN32_BOOL_SUCCEEDED(GetConsoleScreenBufferInfoEx(consoleOutputHandle, &sbiex));
+    const auto bufferSize = sbiex.dwSize;
+
+    // Write a few rows where the color changes every 3 cells, so that the rows hold many runs of attributes.
+    const SHORT rows = 4;
+    std::vector<CHAR_INFO> source(bufferSize.X * rows);
+    for (SHORT y = 0; y < rows; y++)
+    {
+        for (SHORT x = 0; x < bufferSize.X; x++)
+        {
+            auto& ci = source[y * bufferSize.X + x];
+            ci.Char.UnicodeChar = static_cast<wchar_t>(L'A' + (x + y) % 26);
+            ci.Attributes = static_cast<WORD>((x / 3 + y) % 16);
+        }
+    }
+
+    const COORD sourceDimensions{ bufferSize.X, rows };
+    SMALL_RECT written{ 0, 0, bufferSize.X - 1, rows - 1 };
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteConsoleOutputW(consoleOutputHandle, source.data(), sourceDimensions, { 0, 0 }, &written));
+
+    // Read back a region that starts and ends in the middle of runs.
+    const SMALL_RECT region{ 4, 1, bufferSize.X - 3, rows - 1 };
+    const COORD regionDimensions{ region.Right - region.Left + 1, region.Bottom - region.Top + 1 };
+    std::vector<CHAR_INFO> buffer(regionDimensions.X * regionDimensions.Y);
+
+    auto affected = region;
+    VERIFY_WIN32_BOOL_SUCCEEDED(ReadConsoleOutputW(consoleOutputHandle, buffer.data(), regionDimensions, { 0, 0 }, &affected));
+    VERIFY_ARE_EQUAL(region, affected);
+
+    for (SHORT y = 0; y < regionDimensions.Y; y++)
+    {
+        for (SHORT x = 0; x < regionDimensions.X; x++)
+        {
+            const auto& expected = source[(region.Top + y) * bufferSize.X + region.Left + x];
+            VERIFY_ARE_EQUAL(expected, buffer[y * regionDimensions.X + x]);
+        }
+    }
+}
+
 void OutputTests::WriteConsoleOutputCharacterWRunoff()
 {
     // writes text that will not all fit on the screen to verify reported size is correct
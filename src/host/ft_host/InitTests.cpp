@@ -19,6 +19,10 @@ static PCWSTR pwszForceV2ValueName = L"ForceV2";
 wil::unique_handle hJob;
 wil::unique_process_information pi;
 
+// In conpty mode this is the write end of OpenConsole's input pipe.
+// It's kept open, because conpty exits once its input is closed.
+wil::unique_handle conptyInput;
+
 static FILE* std_out = nullptr;
 static FILE* std_in = nullptr;
 
@@ -102,6 +106,11 @@ MODULE_SETUP(ModuleSetup)
         Common::_isV2 = true;
     }
 
+    // Look up a runtime parameter to see if we want to test OpenConsole as conpty.
+    // It then renders into a pipe as VT (which we discard) instead of into a window.
+    auto testAsConpty = false;
+    RuntimeParameters::TryGetValue(L"TestAsConpty", testAsConpty);
+
     // Retrieve location of directory that the test was deployed to.
     // We're going to look for OpenConsole.exe in the same directory.
     String value;
@@ -114,6 +123,11 @@ MODULE_SETUP(ModuleSetup)
         WEX::Logging::Log::Comment(L"Launching with inbox conhost.exe");
         value = value.Append(L"Nihilist.exe");
     }
+    else if (testAsConpty)
+    {
+        WEX::Logging::Log::Comment(L"Launching with OpenConsole.exe --headless");
+        value = value.Append(L"OpenConsole.exe --headless Nihilist.exe");
+    }
     else
     {
         // If we're outside or testing V2, let's use the open console binary we built.
@@ -144,19 +158,51 @@ MODULE_SETUP(ModuleSetup)
     STARTUPINFOW si = { 0 };
     si.cb = sizeof(STARTUPINFOW);
 
+    // In conpty mode OpenConsole reads input from and writes VT to its standard handles.
+    wil::unique_handle conptyInputRead;
+    wil::unique_handle conptyOutputWrite;
+    const auto useConpty = testAsConpty && !insideWindows && !testAsV1;
+    if (useConpty)
+    {
+        SECURITY_ATTRIBUTES sa{ sizeof(sa), nullptr, TRUE };
+        wil::unique_handle conptyOutputRead;
+        VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(CreatePipe(conptyInputRead.addressof(), conptyInput.addressof(), &sa, 0));
+        VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(CreatePipe(conptyOutputRead.addressof(), conptyOutputWrite.addressof(), &sa, 0));
+        VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(SetHandleInformation(conptyInput.get(), HANDLE_FLAG_INHERIT, 0));
+        VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(SetHandleInformation(conptyOutputRead.get(), HANDLE_FLAG_INHERIT, 0));
+
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdInput = conptyInputRead.get();
+        si.hStdOutput = conptyOutputWrite.get();
+        si.hStdError = conptyOutputWrite.get();
+
+        // Nobody looks at the VT, but conpty blocks once the pipe is full, so drain it until it's broken.
+        std::thread([output = std::move(conptyOutputRead)]() {
+            char buffer[16 * 1024];
+            DWORD read = 0;
+            while (ReadFile(output.get(), &buffer[0], sizeof(buffer), &read, nullptr) && read)
+            {
+            }
+        }).detach();
+    }
+
     // We start suspended so we can put it in the job before it does anything
     // We say new console so it doesn't run in the same window as our test.
     VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(CreateProcessW(nullptr,
                                                       str,
                                                       nullptr,
                                                       nullptr,
-                                                      FALSE,
+                                                      useConpty,
                                                       CREATE_NEW_CONSOLE | CREATE_SUSPENDED,
                                                       nullptr,
                                                       nullptr,
                                                       &si,
                                                       pi.addressof()));
 
+    // OpenConsole has its own copies of these now.
+    conptyInputRead.reset();
+    conptyOutputWrite.reset();
+
     // Put the new OpenConsole process into the job. The default Job system means when OpenConsole
     // calls CreateProcess, its children will automatically join the job.
     VERIFY_WIN32_BOOL_SUCCEEDED_RETURN(AssignProcessToJobObject(hJob.get(), pi.hProcess));
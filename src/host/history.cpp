@@ -116,10 +116,14 @@ void CommandHistory::_Reset()
                 }
             }
 
+            // Make sure that _IndexInsert below can't fail after _commands was modified.
+            _prefixIndex.reserve(_commands.size() + 1);
+
             // find free record.  if all records are used, free the lru one.
             if ((SHORT)_commands.size() == _maxCommands)
             {
                 _commands.erase(_commands.cbegin());
+                _IndexErase(0);
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
@@ -134,6 +138,7 @@ void CommandHistory::_Reset()
             {
                 _commands.emplace_back(newCommand);
             }
+            _IndexInsert(gsl::narrow<SHORT>(_commands.size() - 1));
 
             if (LastDisplayed == -1 ||
                 _commands.at(LastDisplayed).size() != newCommand.size() ||
@@ -244,6 +249,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 void CommandHistory::Empty()
 {
     _commands.clear();
+    _prefixIndex.clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -285,6 +291,7 @@ void CommandHistory::Realloc(const size_t commands)
     {
         _commands.emplace_back(oldCommands[i]);
     }
+    _IndexRebuild();
 
     WI_SetFlag(Flags, CLE_RESET);
     LastDisplayed = gsl::narrow<SHORT>(_commands.size()) - 1;
@@ -297,11 +304,9 @@ void CommandHistory::s_ReallocExeToFront(const std::wstring_view appName, const
     {
         if (WI_IsFlagSet(it->Flags, CLE_ALLOCATED) && it->IsAppNameMatch(appName))
         {
-            auto backup = *it;
-            backup.Realloc(commands);
-
-            s_historyLists.erase(it);
-            s_historyLists.push_front(backup);
+            // Moving the node to the front doesn't copy the history's commands.
+            s_historyLists.splice(s_historyLists.begin(), s_historyLists, it);
+            it->Realloc(commands);
 
             return;
         }
@@ -336,19 +341,18 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     // Reuse a history buffer.  The buffer must be !CLE_ALLOCATED.
     // If possible, the buffer should have the same app name.
-    std::optional<CommandHistory> BestCandidate;
+    auto BestCandidate = s_historyLists.end();
     auto SameApp = false;
 
-    for (auto it = s_historyLists.cbegin(); it != s_historyLists.cend(); it++)
+    for (auto it = s_historyLists.begin(); it != s_historyLists.end(); it++)
     {
         if (WI_IsFlagClear(it->Flags, CLE_ALLOCATED))
         {
             // use LRU history buffer with same app name
             if (it->IsAppNameMatch(appName))
             {
-                BestCandidate = *it;
+                BestCandidate = it;
                 SameApp = true;
-                s_historyLists.erase(it);
                 break;
             }
         }
@@ -367,26 +371,26 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         History._processHandle = processHandle;
         return &s_historyLists.emplace_front(History);
     }
-    else if (!BestCandidate.has_value() && s_historyLists.size() > 0)
+    else if (BestCandidate == s_historyLists.end() && s_historyLists.size() > 0)
     {
         // If we have no candidate already and we need one, take the LRU (which is the back/last one) which isn't allocated.
-        for (auto it = s_historyLists.crbegin(); it != s_historyLists.crend(); it++)
+        for (auto it = s_historyLists.rbegin(); it != s_historyLists.rend(); it++)
         {
             if (WI_IsFlagClear(it->Flags, CLE_ALLOCATED))
             {
-                BestCandidate = *it;
-                s_historyLists.erase(std::next(it).base()); // trickery to turn reverse iterator into forward iterator for erase.
+                BestCandidate = std::next(it).base(); // trickery to turn reverse iterator into forward iterator.
                 break;
             }
         }
     }
 
     // If the app name doesn't match, copy in the new app name and free the old commands.
-    if (BestCandidate.has_value())
+    if (BestCandidate != s_historyLists.end())
     {
         if (!SameApp)
         {
             BestCandidate->_commands.clear();
+            BestCandidate->_prefixIndex.clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
         }
@@ -394,7 +398,9 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         BestCandidate->_processHandle = processHandle;
         WI_SetFlag(BestCandidate->Flags, CLE_ALLOCATED);
 
-        return &s_historyLists.emplace_front(BestCandidate.value());
+        // Moving the node to the front doesn't copy the history's commands.
+        s_historyLists.splice(s_historyLists.begin(), s_historyLists, BestCandidate);
+        return &s_historyLists.front();
     }
 
     return nullptr;
@@ -470,6 +476,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         if (iDel < iLast)
         {
             _commands.erase(_commands.cbegin() + iDel);
+            _IndexErase(iDel);
             if ((iDisp > iDel) && (iDisp <= iLast))
             {
                 _Dec(iDisp);
@@ -479,6 +486,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         else if (iFirst <= iDel)
         {
             _commands.erase(_commands.cbegin() + iDel);
+            _IndexErase(iDel);
             if ((iDisp >= iFirst) && (iDisp < iDel))
             {
                 _Inc(iDisp);
@@ -522,20 +530,42 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         return true;
     }
 
+    // LastDisplayed might not refer to any command (for instance after Remove()).
+    if (indexFound < 0 || indexFound >= gsl::narrow<SHORT>(_commands.size()))
+    {
+        return false;
+    }
+
     try
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        // The matching commands form a contiguous range in _prefixIndex.
+        const auto exactMatch = WI_IsFlagSet(options, MatchOptions::ExactMatch);
+        const auto begin = std::lower_bound(_prefixIndex.cbegin(), _prefixIndex.cend(), givenCommand, [&](const SHORT index, const std::wstring_view command) {
+            return std::wstring_view{ _commands.at(index) } < command;
+        });
+        const auto end = std::partition_point(begin, _prefixIndex.cend(), [&](const SHORT index) {
+            const auto& storedCommand = _commands.at(index);
+            return exactMatch ? storedCommand == givenCommand : til::starts_with(storedCommand, givenCommand);
+        });
+
+        // Walking backwards from indexFound, we'd first encounter the closest match
+        // at or before indexFound, or, after wrapping around, the most recent one.
+        SHORT closest = -1;
+        SHORT latest = -1;
+        for (auto it = begin; it != end; ++it)
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
+            const auto index = *it;
+            if (index <= indexFound)
             {
-                if (til::starts_with(storedCommand, givenCommand))
-                {
-                    return true;
-                }
+                closest = std::max(closest, index);
             }
+            latest = std::max(latest, index);
+        }
 
-            _Prev(indexFound);
+        if (latest != -1)
+        {
+            indexFound = closest != -1 ? closest : latest;
+            return true;
         }
     }
     CATCH_LOG();
@@ -543,6 +573,47 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
     return false;
 }
 
+// Routine Description:
+// - Adds the command at the given index in _commands to the _prefixIndex.
+// Arguments:
+// - index - the index of the command in _commands
+void CommandHistory::_IndexInsert(const SHORT index)
+{
+    const std::wstring_view command{ _commands.at(index) };
+    const auto it = std::upper_bound(_prefixIndex.cbegin(), _prefixIndex.cend(), command, [&](const std::wstring_view value, const SHORT other) {
+        return value < std::wstring_view{ _commands.at(other) };
+    });
+    _prefixIndex.insert(it, index);
+}
+
+// Routine Description:
+// - Removes the command at the given index from the _prefixIndex, after it
+//   was erased from _commands. The indices of the commands after it move down.
+// Arguments:
+// - index - the index the command had in _commands
+void CommandHistory::_IndexErase(const SHORT index) noexcept
+{
+    std::erase(_prefixIndex, index);
+    for (auto& other : _prefixIndex)
+    {
+        if (other > index)
+        {
+            --other;
+        }
+    }
+}
+
+// Routine Description:
+// - Recreates the _prefixIndex for the current contents of _commands.
+void CommandHistory::_IndexRebuild()
+{
+    _prefixIndex.resize(_commands.size());
+    std::iota(_prefixIndex.begin(), _prefixIndex.end(), SHORT{ 0 });
+    std::stable_sort(_prefixIndex.begin(), _prefixIndex.end(), [&](const SHORT a, const SHORT b) {
+        return _commands.at(a) < _commands.at(b);
+    });
+}
+
 #ifdef UNIT_TESTING
 void CommandHistory::s_ClearHistoryListStorage()
 {
@@ -558,6 +629,19 @@ void CommandHistory::s_ClearHistoryListStorage()
 void CommandHistory::Swap(const short indexA, const short indexB)
 {
     std::swap(_commands.at(indexA), _commands.at(indexB));
+
+    // The commands keep their place in the sort order, they just live elsewhere now.
+    for (auto& index : _prefixIndex)
+    {
+        if (index == indexA)
+        {
+            index = indexB;
+        }
+        else if (index == indexB)
+        {
+            index = indexA;
+        }
+    }
 }
 
 // Routine Description:
@@ -83,7 +83,15 @@ private:
     void _Dec(SHORT& ind) const;
     void _Inc(SHORT& ind) const;
 
+    void _IndexInsert(const SHORT index);
+    void _IndexErase(const SHORT index) noexcept;
+    void _IndexRebuild();
+
     std::vector<std::wstring> _commands;
+    // The indices into _commands, sorted by the commands they refer to (ordinally,
+    // like FindMatchingCommand compares them). This makes the commands that start
+    // with a given prefix a contiguous range, so they can be found by binary search.
+    std::vector<SHORT> _prefixIndex;
     SHORT _maxCommands;
 
     std::wstring _appName;
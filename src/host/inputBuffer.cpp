@@ -17,6 +17,85 @@ using Microsoft::Console::Interactivity::ServiceLocator;
 using Microsoft::Console::VirtualTerminal::TerminalInput;
 using namespace Microsoft::Console;
 
+// Routine Description:
+// - Appends a record to the end of the queue, growing the ring if it's full.
+// Arguments:
+// - record - the record to append
+// Return Value:
+// - <none>
+// Note:
+// - will throw on failure
+void InputRecordQueue::push_back(const INPUT_RECORD& record)
+{
+    if (_size == _buffer.size())
+    {
+        std::vector<INPUT_RECORD> buffer(std::max<size_t>(16, _buffer.size() * 2));
+        for (size_t i = 0; i < _size; ++i)
+        {
+            til::at(buffer, i) = (*this)[i];
+        }
+        _buffer.swap(buffer);
+        _head = 0;
+    }
+
+    ++_size;
+    back() = record;
+}
+
+// Routine Description:
+// - Removes records from the front of the queue.
+// Arguments:
+// - count - the number of records to remove. Must not be larger than size().
+// Return Value:
+// - <none>
+void InputRecordQueue::pop_front(const size_t count) noexcept
+{
+    _size -= count;
+    if (_size == 0)
+    {
+        clear();
+    }
+    else
+    {
+        _head = (_head + count) & (_buffer.size() - 1);
+    }
+}
+
+// Routine Description:
+// - Removes all records. After a large paste was read, the memory it took up is released.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputRecordQueue::clear() noexcept
+{
+    static constexpr size_t retainedCapacity = 4096;
+
+    if (_buffer.size() > retainedCapacity)
+    {
+        _buffer = {};
+    }
+    _head = 0;
+    _size = 0;
+}
+
+void InputRecordQueue::swap(InputRecordQueue& other) noexcept
+{
+    _buffer.swap(other._buffer);
+    std::swap(_head, other._head);
+    std::swap(_size, other._size);
+}
+
+static INPUT_RECORD _ToInputRecord(const std::unique_ptr<IInputEvent>& inEvent) noexcept
+{
+    return inEvent->ToInputRecord();
+}
+
+static INPUT_RECORD _ToInputRecord(const INPUT_RECORD& inRecord) noexcept
+{
+    return inRecord;
+}
+
 // Routine Description:
 // - This method creates an input buffer.
 // Arguments:
@@ -214,10 +293,9 @@ void InputBuffer::Flush()
 // - The console lock must be held when calling this routine.
 void InputBuffer::FlushAllButKeys()
 {
-    auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const std::unique_ptr<IInputEvent>& event) {
-        return event->EventType() != InputEventType::KeyEvent;
+    _storage.erase_if([](const INPUT_RECORD& record) noexcept {
+        return record.EventType != KEY_EVENT;
     });
-    _storage.erase(newEnd, _storage.end());
 }
 
 void InputBuffer::SetTerminalConnection(_In_ Render::VtEngine* const pTtyConnection)
@@ -276,10 +354,9 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
         }
 
         // read from buffer
-        std::deque<std::unique_ptr<IInputEvent>> events;
         size_t eventsRead;
         bool resetWaitEvent;
-        _ReadBuffer(events,
+        _ReadBuffer(OutEvents,
                     AmountToRead,
                     eventsRead,
                     Peek,
@@ -287,13 +364,6 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
                     Unicode,
                     Stream);
 
-        // copy events to outEvents
-        while (!events.empty())
-        {
-            OutEvents.push_back(std::move(events.front()));
-            events.pop_front();
-        }
-
         if (resetWaitEvent)
         {
             ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
@@ -379,95 +449,58 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 
     resetWaitEvent = false;
 
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
     // we need another var to keep track of how many we've read
     // because dbcs records count for two when we aren't doing a
     // unicode read but the eventsRead count should return the number
     // of events actually put into outRecords.
     size_t virtualReadCount = 0;
+    // When peeking we leave the records where they are and just read further into the buffer.
+    size_t readIndex = 0;
+    eventsRead = 0;
 
-    while (!_storage.empty() && virtualReadCount < readCount)
+    while (readIndex < _storage.size() && virtualReadCount < readCount)
     {
-        auto performNormalRead = true;
+        auto record = _storage[readIndex];
+
         // for stream reads we need to split any key events that have been coalesced
-        if (streamRead)
+        const auto split = streamRead &&
+                           record.EventType == KEY_EVENT &&
+                           record.Event.KeyEvent.wRepeatCount > 1;
+        if (split)
         {
-            if (_storage.front()->EventType() == InputEventType::KeyEvent)
-            {
-                const auto pKeyEvent = static_cast<KeyEvent* const>(_storage.front().get());
-                if (pKeyEvent->GetRepeatCount() > 1)
-                {
-                    // split the key event
-                    auto streamKeyEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                    streamKeyEvent->SetRepeatCount(1);
-                    readEvents.push_back(std::move(streamKeyEvent));
-                    pKeyEvent->SetRepeatCount(pKeyEvent->GetRepeatCount() - 1);
-                    performNormalRead = false;
-                }
-            }
+            record.Event.KeyEvent.wRepeatCount = 1;
         }
 
-        if (performNormalRead)
-        {
-            readEvents.push_back(std::move(_storage.front()));
-            _storage.pop_front();
-        }
+        outEvents.push_back(IInputEvent::Create(record));
+        ++eventsRead;
 
-        ++virtualReadCount;
-        if (!unicode)
+        if (split)
         {
-            if (readEvents.back()->EventType() == InputEventType::KeyEvent)
+            if (!peek)
             {
-                const auto pKeyEvent = static_cast<const KeyEvent* const>(readEvents.back().get());
-                if (IsGlyphFullWidth(pKeyEvent->GetCharData()))
-                {
-                    ++virtualReadCount;
-                }
+                _storage[readIndex].Event.KeyEvent.wRepeatCount--;
             }
         }
-    }
-
-    // the amount of events that were actually read
-    eventsRead = readEvents.size();
-
-    // copy the events back if we were supposed to peek
-    if (peek)
-    {
-        if (streamRead)
+        else if (peek)
         {
-            // we need to check and see if the event was split from a coalesced key event
-            // or if it was unrelated to the current front event in storage
-            if (!readEvents.empty() &&
-                !_storage.empty() &&
-                readEvents.back()->EventType() == InputEventType::KeyEvent &&
-                _storage.front()->EventType() == InputEventType::KeyEvent &&
-                _CanCoalesce(static_cast<const KeyEvent&>(*readEvents.back()),
-                             static_cast<const KeyEvent&>(*_storage.front())))
-            {
-                auto& keyEvent = static_cast<KeyEvent&>(*_storage.front());
-                keyEvent.SetRepeatCount(keyEvent.GetRepeatCount() + 1);
-            }
-            else
-            {
-                _storage.push_front(IInputEvent::Create(readEvents.back()->ToInputRecord()));
-            }
+            ++readIndex;
         }
         else
         {
-            for (auto it = readEvents.crbegin(); it != readEvents.crend(); ++it)
+            _storage.pop_front();
+        }
+
+        ++virtualReadCount;
+        if (!unicode)
+        {
+            if (record.EventType == KEY_EVENT &&
+                IsGlyphFullWidth(record.Event.KeyEvent.uChar.UnicodeChar))
             {
-                _storage.push_front(IInputEvent::Create((*it)->ToInputRecord()));
+                ++virtualReadCount;
             }
         }
     }
 
-    // move events read to proper deque
-    while (!readEvents.empty())
-    {
-        outEvents.push_back(std::move(readEvents.front()));
-        readEvents.pop_front();
-    }
-
     // signal if we emptied the buffer
     if (_storage.empty())
     {
@@ -479,12 +512,41 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 // -  Writes events to the beginning of the input buffer.
 // Arguments:
 // - inEvents - events to write to buffer.
-// - eventsWritten - The number of events written to the buffer on exit.
 // Return Value:
-// S_OK if successful.
+// - The number of events that were written to input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+{
+    const auto eventsWritten = _Prepend(inEvents);
+    inEvents.clear();
+    return eventsWritten;
+}
+
+// Routine Description:
+// -  Writes records to the beginning of the input buffer.
+// Arguments:
+// - inRecords - records to write to buffer.
+// Return Value:
+// - The number of records that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Prepend(const gsl::span<const INPUT_RECORD> inRecords)
+{
+    try
+    {
+        std::vector<INPUT_RECORD> records{ inRecords.begin(), inRecords.end() };
+        return _Prepend(records);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+template<typename T>
+size_t InputBuffer::_Prepend(_Inout_ T& inEvents)
 {
     try
     {
@@ -500,12 +562,12 @@ size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& in
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<std::unique_ptr<IInputEvent>> existingStorage;
+        InputRecordQueue existingStorage;
         existingStorage.swap(_storage);
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
-        // However, because we swapped the storage out from under it with an empty deque, it will always
-        // return true after the first one (as it is filling the newly emptied backing deque.)
+        // However, because we swapped the storage out from under it with an empty queue, it will always
+        // return true after the first one (as it is filling the newly emptied backing queue.)
         // Then after the second one, because we've inserted some input, it will always say false.
         auto unusedWaitStatus = false;
 
@@ -577,6 +639,38 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 // Note:
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+{
+    const auto eventsWritten = _Write(inEvents);
+    inEvents.clear();
+    return eventsWritten;
+}
+
+// Routine Description:
+// - Writes records to the input buffer in bulk, without turning each of them
+// into an IInputEvent first. Wakes up any readers that are waiting for
+// additional input events.
+// Arguments:
+// - inRecords - input records to store in the buffer.
+// Return Value:
+// - The number of records that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Write(const gsl::span<const INPUT_RECORD> inRecords)
+{
+    try
+    {
+        std::vector<INPUT_RECORD> records{ inRecords.begin(), inRecords.end() };
+        return _Write(records);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+template<typename T>
+size_t InputBuffer::_Write(_Inout_ T& inEvents)
 {
     try
     {
@@ -589,6 +683,7 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
         }
 
         // Write to buffer.
+        const auto storageSize = _storage.size();
         size_t EventsWritten;
         bool SetWaitEvent;
         _WriteBuffer(inEvents, EventsWritten, SetWaitEvent);
@@ -598,8 +693,12 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
             ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
         }
 
-        // Alert any writers waiting for space.
-        WakeUpReadersWaitingForData();
+        // Alert any readers waiting for data, but only those that can make use
+        // of it. The entire write is handled at once, instead of per event.
+        if (EventsWritten != 0)
+        {
+            WaitQueue.NotifyInputWaiter(_HasKeyEventsSince(storageSize));
+        }
         return EventsWritten;
     }
     catch (...)
@@ -612,7 +711,7 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Routine Description:
 // - Coalesces input events and transfers them to storage queue.
 // Arguments:
-// - inRecords - The events to store.
+// - inEvents - The events to store.
 // - eventsWritten - The number of events written since this function
 // was called.
 // - setWaitEvent - on exit, true if buffer became non-empty.
@@ -621,7 +720,8 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw on failure
-void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+template<typename T>
+void InputBuffer::_WriteBuffer(const T& inEvents,
                                _Out_ size_t& eventsWritten,
                                _Out_ bool& setWaitEvent)
 {
@@ -631,66 +731,37 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
     const auto initialInEventsSize = inEvents.size();
     const auto vtInputMode = IsInVirtualTerminalInputMode();
 
-    while (!inEvents.empty())
+    for (const auto& inEvent : inEvents)
     {
-        // Pop the next event.
         // If we're in vt mode, try and handle it with the vt input module.
         // If it was handled, do nothing else for it.
         // If there was one event passed in, try coalescing it with the previous event currently in the buffer.
         // If it's not coalesced, append it to the buffer.
-        auto inEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (vtInputMode)
+        if (vtInputMode && _HandleTerminalInput(inEvent))
         {
-            // GH#11682: TerminalInput::HandleKey can handle both KeyEvents and Focus events seamlessly
-            const auto handled = _termInput.HandleKey(inEvent.get());
-            if (handled)
-            {
-                eventsWritten++;
-                continue;
-            }
+            eventsWritten++;
+            continue;
         }
 
+        const auto inRecord = _ToInputRecord(inEvent);
+
         // we only check for possible coalescing when storing one
         // record at a time because this is the original behavior of
         // the input buffer. Changing this behavior may break stuff
         // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty())
+        //
+        // this looks kinda weird but we don't want to coalesce a
+        // mouse event and then try to coalesce a key event right after.
+        if (initialInEventsSize == 1 &&
+            !_storage.empty() &&
+            (_CoalesceMouseMovedEvents(inRecord) || _CoalesceRepeatedKeyPressEvents(inRecord)))
         {
-            // coalescing requires a deque of events, so push it back onto the front.
-            inEvents.push_front(std::move(inEvent));
-
-            auto coalesced = false;
-            // this looks kinda weird but we don't want to coalesce a
-            // mouse event and then try to coalesce a key event right after.
-            //
-            // we also pass the whole deque to the coalescing methods
-            // even though they only want one event because it should
-            // be their responsibility to maintain the correct state
-            // of the deque if they process any records in it.
-            if (_CoalesceMouseMovedEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            else if (_CoalesceRepeatedKeyPressEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            if (coalesced)
-            {
-                eventsWritten = 1;
-                return;
-            }
-            else
-            {
-                // We didn't coalesce the event. pull it from the queue again,
-                //  to keep the state consistent with the start of this block.
-                inEvent = std::move(inEvents.front());
-                inEvents.pop_front();
-            }
+            eventsWritten = 1;
+            return;
         }
+
         // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(std::move(inEvent));
+        _storage.push_back(inRecord);
         ++eventsWritten;
     }
     if (initiallyEmptyQueue && !_storage.empty())
@@ -700,44 +771,98 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
 }
 
 // Routine Description:
-// - Checks if the last saved event and the first event of inRecords are
-// both MOUSE_MOVED events. If they are, the last saved event is
-// updated with the new mouse position and the first event of inRecords is
-// dropped.
+// - Checks whether key events were written into _storage since it had the given size.
+// - A key event that was coalesced into the last record counts as written as well.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - storageSize - The size of _storage before the write.
+// Return Value:
+// - true if readers waiting for key events should be notified.
+bool InputBuffer::_HasKeyEventsSince(const size_t storageSize) const noexcept
+{
+    if (_storage.empty())
+    {
+        return false;
+    }
+
+    if (_storage.size() <= storageSize)
+    {
+        return _storage.back().EventType == KEY_EVENT;
+    }
+
+    for (auto i = storageSize; i < _storage.size(); ++i)
+    {
+        if (_storage[i].EventType == KEY_EVENT)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Routine Description:
+// - Gives the vt input module a chance to handle the given event.
+// Arguments:
+// - inEvent - The event to handle.
+// Return Value:
+// - true if the event was handled and mustn't be stored.
+bool InputBuffer::_HandleTerminalInput(const std::unique_ptr<IInputEvent>& inEvent)
+{
+    // GH#11682: TerminalInput::HandleKey can handle both KeyEvents and Focus events seamlessly
+    return _termInput.HandleKey(inEvent.get());
+}
+
+// Routine Description:
+// - Gives the vt input module a chance to handle the given record.
+// Arguments:
+// - inRecord - The record to handle.
+// Return Value:
+// - true if the record was handled and mustn't be stored.
+bool InputBuffer::_HandleTerminalInput(const INPUT_RECORD& inRecord)
+{
+    // TerminalInput::HandleKey only handles key and focus events. We create them
+    // on the stack here, instead of allocating them with IInputEvent::Create.
+    switch (inRecord.EventType)
+    {
+    case KEY_EVENT:
+    {
+        const KeyEvent keyEvent{ inRecord.Event.KeyEvent };
+        return _termInput.HandleKey(&keyEvent);
+    }
+    case FOCUS_EVENT:
+    {
+        const FocusEvent focusEvent{ inRecord.Event.FocusEvent };
+        return _termInput.HandleKey(&focusEvent);
+    }
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Checks if the last saved event and inRecord are both MOUSE_MOVED
+// events. If they are, the last saved event is updated with the new
+// mouse position and inRecord doesn't need to be stored.
+// Arguments:
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
+// - The buffer mustn't be empty.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord) noexcept
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::MouseEvent &&
-        pLastStoredEvent->EventType() == InputEventType::MouseEvent)
+    auto& lastRecord = _storage.back();
+    if (inRecord.EventType == MOUSE_EVENT &&
+        lastRecord.EventType == MOUSE_EVENT &&
+        inRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED &&
+        lastRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED)
     {
-        const auto pInMouseEvent = static_cast<const MouseEvent* const>(pFirstInEvent);
-        const auto pLastMouseEvent = static_cast<const MouseEvent* const>(pLastStoredEvent);
-
-        if (pInMouseEvent->IsMouseMoveEvent() &&
-            pLastMouseEvent->IsMouseMoveEvent())
-        {
-            // update mouse moved position
-            const auto pMouseEvent = static_cast<MouseEvent* const>(_storage.back().release());
-            pMouseEvent->SetPosition(pInMouseEvent->GetPosition());
-            std::unique_ptr<IInputEvent> tempPtr(pMouseEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
-            return true;
-        }
+        // update mouse moved position
+        lastRecord.Event.MouseEvent.dwMousePosition = inRecord.Event.MouseEvent.dwMousePosition;
+        return true;
     }
     return false;
 }
@@ -768,44 +893,35 @@ bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexc
 }
 
 // Routine Description::
-// - If the last input event saved and the first input event in inRecords
-// are both a keypress down event for the same key, update the repeat
-// count of the saved event and drop the first from inRecords.
+// - If the last input event saved and inRecord are both a keypress down
+// event for the same key, update the repeat count of the saved event
+// instead of storing inRecord.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
+// - The buffer mustn't be empty.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
-{
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::KeyEvent &&
-        pLastStoredEvent->EventType() == InputEventType::KeyEvent)
-    {
-        const auto pInKeyEvent = static_cast<const KeyEvent* const>(pFirstInEvent);
-        const auto pLastKeyEvent = static_cast<const KeyEvent* const>(pLastStoredEvent);
-
-        if (pInKeyEvent->IsKeyDown() &&
-            pLastKeyEvent->IsKeyDown() &&
-            !IsGlyphFullWidth(pInKeyEvent->GetCharData()) &&
-            _CanCoalesce(*pInKeyEvent, *pLastKeyEvent))
+bool InputBuffer::_CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord)
+{
+    auto& lastRecord = _storage.back();
+    if (inRecord.EventType == KEY_EVENT &&
+        lastRecord.EventType == KEY_EVENT)
+    {
+        const KeyEvent inKeyEvent{ inRecord.Event.KeyEvent };
+        const KeyEvent lastKeyEvent{ lastRecord.Event.KeyEvent };
+
+        if (inKeyEvent.IsKeyDown() &&
+            lastKeyEvent.IsKeyDown() &&
+            !IsGlyphFullWidth(inKeyEvent.GetCharData()) &&
+            _CanCoalesce(inKeyEvent, lastKeyEvent))
         {
             // increment repeat count
-            const auto pKeyEvent = static_cast<KeyEvent* const>(_storage.back().release());
-            WORD repeatCount = pKeyEvent->GetRepeatCount() + pInKeyEvent->GetRepeatCount();
-            pKeyEvent->SetRepeatCount(repeatCount);
-            std::unique_ptr<IInputEvent> tempPtr(pKeyEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
+            lastRecord.Event.KeyEvent.wRepeatCount = gsl::narrow_cast<WORD>(lastKeyEvent.GetRepeatCount() + inKeyEvent.GetRepeatCount());
             return true;
         }
     }
@@ -815,42 +931,37 @@ bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique
 // Routine Description:
 // - Handles records that suspend/resume the console.
 // Arguments:
-// - records - records to check for pause/unpause events
+// - inEvents - events to check for pause/unpause events
 // Return Value:
 // - None
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw exception on error
-void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+template<typename T>
+void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ T& inEvents)
 {
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
 
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    while (!inEvents.empty())
-    {
-        auto currEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (currEvent->EventType() == InputEventType::KeyEvent)
+    const auto newEnd = std::remove_if(inEvents.begin(), inEvents.end(), [&](const auto& inEvent) {
+        const auto record = _ToInputRecord(inEvent);
+        if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown)
         {
-            const auto pKeyEvent = static_cast<const KeyEvent* const>(currEvent.get());
-            if (pKeyEvent->IsKeyDown())
+            const KeyEvent keyEvent{ record.Event.KeyEvent };
+            if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
+                !IsSystemKey(keyEvent.GetVirtualKeyCode()))
             {
-                if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
-                    !IsSystemKey(pKeyEvent->GetVirtualKeyCode()))
-                {
-                    UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
-                    continue;
-                }
-                else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && pKeyEvent->IsPauseKey())
-                {
-                    WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
-                    continue;
-                }
+                UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
+                return true;
+            }
+            else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && keyEvent.IsPauseKey())
+            {
+                WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
+                return true;
             }
         }
-        outEvents.push_back(std::move(currEvent));
-    }
-    inEvents.swap(outEvents);
+        return false;
+    });
+    inEvents.erase(newEnd, inEvents.end());
 }
 
 // Routine Description:
@@ -876,12 +987,11 @@ void InputBuffer::_HandleTerminalInputCallback(std::deque<std::unique_ptr<IInput
     try
     {
         // add all input events to the storage queue
-        while (!inEvents.empty())
+        for (const auto& inEvent : inEvents)
         {
-            auto inEvent = std::move(inEvents.front());
-            inEvents.pop_front();
-            _storage.push_back(std::move(inEvent));
+            _storage.push_back(inEvent->ToInputRecord());
         }
+        inEvents.clear();
 
         if (!_vtInputShouldSuppress)
         {
@@ -899,3 +1009,6 @@ TerminalInput& InputBuffer::GetTerminalInput()
 {
     return _termInput;
 }
+
+// InputBufferTests calls this with events directly.
+template void InputBuffer::_WriteBuffer(const std::deque<std::unique_ptr<IInputEvent>>& inEvents, size_t& eventsWritten, bool& setWaitEvent);
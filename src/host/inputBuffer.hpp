@@ -33,6 +33,80 @@ namespace Microsoft::Console::Render
     class VtEngine;
 }
 
+// A FIFO of INPUT_RECORDs, stored by value in a single ring buffer. std::deque would
+// allocate every single INPUT_RECORD separately, because MSVC's deque only puts one
+// element of this size into each block. This one only allocates when it needs to grow.
+class InputRecordQueue
+{
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = INPUT_RECORD;
+        using difference_type = ptrdiff_t;
+        using pointer = const INPUT_RECORD*;
+        using reference = const INPUT_RECORD&;
+
+        const_iterator(const InputRecordQueue& queue, const size_t index) noexcept :
+            _queue{ &queue },
+            _index{ index }
+        {
+        }
+
+        reference operator*() const noexcept { return (*_queue)[_index]; }
+        pointer operator->() const noexcept { return &(*_queue)[_index]; }
+        const_iterator& operator++() noexcept
+        {
+            ++_index;
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const noexcept { return _index == other._index; }
+        bool operator!=(const const_iterator& other) const noexcept { return _index != other._index; }
+
+    private:
+        const InputRecordQueue* _queue;
+        size_t _index;
+    };
+
+    bool empty() const noexcept { return _size == 0; }
+    size_t size() const noexcept { return _size; }
+    const_iterator begin() const noexcept { return { *this, 0 }; }
+    const_iterator end() const noexcept { return { *this, _size }; }
+
+    INPUT_RECORD& operator[](const size_t index) noexcept { return til::at(_buffer, (_head + index) & (_buffer.size() - 1)); }
+    const INPUT_RECORD& operator[](const size_t index) const noexcept { return til::at(_buffer, (_head + index) & (_buffer.size() - 1)); }
+    INPUT_RECORD& front() noexcept { return (*this)[0]; }
+    const INPUT_RECORD& front() const noexcept { return (*this)[0]; }
+    INPUT_RECORD& back() noexcept { return (*this)[_size - 1]; }
+    const INPUT_RECORD& back() const noexcept { return (*this)[_size - 1]; }
+
+    void push_back(const INPUT_RECORD& record);
+    void pop_front(const size_t count = 1) noexcept;
+    void clear() noexcept;
+    void swap(InputRecordQueue& other) noexcept;
+
+    template<typename Predicate>
+    void erase_if(Predicate&& predicate) noexcept
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            if (!predicate(std::as_const((*this)[i])))
+            {
+                (*this)[kept++] = (*this)[i];
+            }
+        }
+        _size = kept;
+    }
+
+private:
+    // The capacity is always a power of two, so that indices wrap around with a mask.
+    std::vector<INPUT_RECORD> _buffer;
+    size_t _head = 0;
+    size_t _size = 0;
+};
+
 class InputBuffer final : public ConsoleObjectHeader
 {
 public:
@@ -74,9 +148,11 @@ public:
                                 const bool Stream);
 
     size_t Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Prepend(const gsl::span<const INPUT_RECORD> inRecords);
 
     size_t Write(_Inout_ std::unique_ptr<IInputEvent> inEvent);
     size_t Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Write(const gsl::span<const INPUT_RECORD> inRecords);
 
     bool IsInVirtualTerminalInputMode() const;
     Microsoft::Console::VirtualTerminal::TerminalInput& GetTerminalInput();
@@ -84,7 +160,7 @@ public:
     void PassThroughWin32MouseRequest(bool enable);
 
 private:
-    std::deque<std::unique_ptr<IInputEvent>> _storage;
+    InputRecordQueue _storage;
     std::unique_ptr<IInputEvent> _readPartialByteSequence;
     std::unique_ptr<IInputEvent> _writePartialByteSequence;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -104,14 +180,26 @@ private:
                      const bool unicode,
                      const bool streamRead);
 
-    void _WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inRecords,
+    // These are instantiated for both std::deque<std::unique_ptr<IInputEvent>>
+    // and containers of INPUT_RECORDs.
+    template<typename T>
+    size_t _Prepend(_Inout_ T& inEvents);
+    template<typename T>
+    size_t _Write(_Inout_ T& inEvents);
+    bool _HasKeyEventsSince(const size_t storageSize) const noexcept;
+    template<typename T>
+    void _WriteBuffer(const T& inEvents,
                       _Out_ size_t& eventsWritten,
                       _Out_ bool& setWaitEvent);
+    template<typename T>
+    void _HandleConsoleSuspensionEvents(_Inout_ T& inEvents);
+
+    bool _HandleTerminalInput(const std::unique_ptr<IInputEvent>& inEvent);
+    bool _HandleTerminalInput(const INPUT_RECORD& inRecord);
 
     bool _CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept;
-    bool _CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    bool _CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    void _HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    bool _CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord) noexcept;
+    bool _CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord);
 
     void _HandleTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
@@ -283,6 +283,26 @@ static void _ScrollScreen(SCREEN_INFORMATION& screenInfo, const Viewport& source
     // Get the text buffer and send it commands.
     // It will figure out whether or not we're active and where the messages need to go.
     auto& textBuffer = screenInfo.GetTextBuffer();
+
+    // If whole rows moved up or down, like they do inside of the scroll margins,
+    // renderers that are able to can move them instead of redrawing them.
+    const auto buffer = screenInfo.GetBufferSize();
+    const auto delta = target.Top() - source.Top();
+    if (source.Left() == buffer.Left() && source.Width() == buffer.Width() && target.Left() == source.Left() &&
+        delta != 0 && std::abs(delta) < source.Height())
+    {
+        const auto top = std::min(source.Top(), target.Top());
+        const auto bottom = std::max(source.BottomExclusive(), target.BottomExclusive());
+        textBuffer.TriggerScrollRegion(Viewport::FromExclusive({ buffer.Left(), top, buffer.RightExclusive(), bottom }), delta);
+
+        // Only the filled area that wasn't overwritten by the target still needs to be redrawn.
+        for (const auto& view : Viewport::Subtract(fill, target))
+        {
+            textBuffer.TriggerRedraw(view);
+        }
+        return;
+    }
+
     // Redraw anything in the target area
     textBuffer.TriggerRedraw(target);
     // Also redraw anything that was filled.
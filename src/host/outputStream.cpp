@@ -66,6 +66,13 @@ void ConhostInternalGetSet::PrintString(const std::wstring_view string)
 // - <none>
 void ConhostInternalGetSet::ReturnResponse(const std::wstring_view response)
 {
+    // In passthrough mode the terminal already responded to it. See VtApiRoutines::_SynchronizeBuffer().
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (gci.IsInVtIoMode() && gci.GetVtIo()->IsSynchronizingBuffer())
+    {
+        return;
+    }
+
     std::deque<std::unique_ptr<IInputEvent>> inEvents;
 
     // generate a paired key down and key up event for every
@@ -373,22 +380,10 @@ void ConhostInternalGetSet::SetWorkingDirectory(const std::wstring_view /*uri*/)
 // - true if successful. false otherwise.
 void ConhostInternalGetSet::PlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration)
 {
-    // We create the audio instance on demand, and lock it for the duration
-    // of the note output so it can't be destroyed while in use.
+    // We create the audio instance on demand. The note is only queued and
+    // played on the audio thread, so we can continue processing output.
     auto& midiAudio = ServiceLocator::LocateGlobals().getConsoleInformation().GetMidiAudio();
-    midiAudio.Lock();
-
-    // We then unlock the console, so the UI doesn't hang while we're busy.
-    UnlockConsole();
-
-    // This call will block for the duration, unless shutdown early.
     midiAudio.PlayNote(noteNumber, velocity, duration);
-
-    // Once complete, we reacquire the console lock and unlock the audio.
-    // If the console has shutdown in the meantime, the Unlock call
-    // will throw an exception, forcing the thread to exit ASAP.
-    LockConsole();
-    midiAudio.Unlock();
 }
 
 // Routine Description:
@@ -493,3 +488,18 @@ void ConhostInternalGetSet::AddMark(const Microsoft::Console::VirtualTerminal::D
 {
     // Not implemented for conhost.
 }
+
+void ConhostInternalGetSet::MarkCommandStart()
+{
+    // Not implemented for conhost.
+}
+
+void ConhostInternalGetSet::MarkOutputStart()
+{
+    // Not implemented for conhost.
+}
+
+void ConhostInternalGetSet::MarkCommandFinish(const std::optional<unsigned int> /*exitCode*/)
+{
+    // Not implemented for conhost.
+}
@@ -75,6 +75,9 @@ public:
     void NotifyAccessibilityChange(const til::rect& changedRect) override;
 
     void AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& mark) override;
+    void MarkCommandStart() override;
+    void MarkOutputStart() override;
+    void MarkCommandFinish(const std::optional<unsigned int> exitCode) override;
 
 private:
     Microsoft::Console::IIoProvider& _io;
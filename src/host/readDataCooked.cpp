@@ -708,29 +708,35 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             CursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
             CursorPosition.X = (til::CoordType)(CursorPosition.X + NumSpaces);
 
-            // clear the current command line from the screen
-            // clang-format off
+            // The cursor is now on the first character that changed: the one we stored or the one after those we erased.
+            const auto firstChanged = wch == UNICODE_BACKSPACE && _processedInput ? _currentPosition : _currentPosition - 1;
+
+            if (wch == UNICODE_CARRIAGERETURN || !_TryEchoChangedSuffix(firstChanged, ScrollY, status))
+            {
+                // clear the current command line from the screen
+                // clang-format off
 #pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
-            // clang-format on
-            DeleteCommandLine(*this, FALSE);
+                // clang-format on
+                DeleteCommandLine(*this, FALSE);
 
-            // write the new command line to the screen
-            NumToWrite = _bytesRead;
+                // write the new command line to the screen
+                NumToWrite = _bytesRead;
 
-            DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS;
-            if (wch == UNICODE_CARRIAGERETURN)
-            {
-                dwFlags |= WC_KEEP_CURSOR_VISIBLE;
+                DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS;
+                if (wch == UNICODE_CARRIAGERETURN)
+                {
+                    dwFlags |= WC_KEEP_CURSOR_VISIBLE;
+                }
+                status = WriteCharsLegacy(_screenInfo,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          &NumToWrite,
+                                          &_visibleCharCount,
+                                          _originalCursorPosition.X,
+                                          dwFlags,
+                                          &ScrollY);
             }
-            status = WriteCharsLegacy(_screenInfo,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      &NumToWrite,
-                                      &_visibleCharCount,
-                                      _originalCursorPosition.X,
-                                      dwFlags,
-                                      &ScrollY);
             if (!NT_SUCCESS(status))
             {
                 RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
@@ -816,6 +822,72 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
     return false;
 }
 
+// Routine Description:
+// - Redraws the edit line after an edit in the middle of it by writing only the part starting at the first
+//   changed character, instead of erasing and rewriting the whole line. Over conpty every rewritten cell
+//   turns into output, so this keeps the cost of typing independent of the length of the line.
+// - This is only done if every character of the line takes up exactly one cell. Only then we know that the
+//   screen position of each character follows from its index and didn't move due to the edit.
+// Arguments:
+// - firstChanged - index of the first character that differs from what's on the screen. The cursor must be on its cell.
+// - scrollY - receives the number of rows the buffer scrolled while writing
+// - status - receives the result of writing to the screen
+// Return Value:
+// - true if the line was redrawn (successfully or not), false if the caller needs to redraw all of it
+bool COOKED_READ_DATA::_TryEchoChangedSuffix(const size_t firstChanged, til::CoordType& scrollY, NTSTATUS& status)
+{
+    const auto cchLine = _bytesRead / sizeof(wchar_t);
+
+    // DeleteCommandLine() handles lines that have scrolled off the top of the buffer. We don't.
+    if (_originalCursorPosition.Y < 0 || firstChanged > cchLine)
+    {
+        return false;
+    }
+
+    const std::wstring_view line{ _backupLimit, cchLine };
+    const auto isSingleCell = [](const wchar_t ch) {
+        return ch >= L' ' && !IS_HIGH_SURROGATE(ch) && !IS_LOW_SURROGATE(ch) && !IsGlyphFullWidth(ch);
+    };
+    if (!std::all_of(line.begin(), line.end(), isSingleCell))
+    {
+        return false;
+    }
+
+    auto cbToWrite = (cchLine - firstChanged) * sizeof(wchar_t);
+    if (cbToWrite != 0)
+    {
+        size_t cellsWritten = 0;
+        status = WriteCharsLegacy(_screenInfo,
+                                  _backupLimit,
+                                  _backupLimit + firstChanged,
+                                  _backupLimit + firstChanged,
+                                  &cbToWrite,
+                                  &cellsWritten,
+                                  _originalCursorPosition.X,
+                                  WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS,
+                                  &scrollY);
+        if (!NT_SUCCESS(status))
+        {
+            return true;
+        }
+    }
+
+    // The cursor is now right behind the line. Blank whatever is left over of the previous, longer one.
+    if (_visibleCharCount > cchLine)
+    {
+        try
+        {
+            const auto& cursor = _screenInfo.GetTextBuffer().GetCursor();
+            _screenInfo.Write(OutputCellIterator(UNICODE_SPACE, _visibleCharCount - cchLine), cursor.GetPosition());
+        }
+        CATCH_LOG();
+    }
+
+    _visibleCharCount = cchLine;
+    status = STATUS_SUCCESS;
+    return true;
+}
+
 // Routine Description:
 // - Writes string to current position in prompt line. can overwrite text to the right of the cursor.
 // Arguments:
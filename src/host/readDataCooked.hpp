@@ -56,6 +56,8 @@ public:
                 _Out_ size_t* const pNumBytes,
                 _Out_ DWORD* const pControlKeyState,
                 _Out_ void* const pOutputData) override;
+    // GetChar() skips over all events but key events.
+    bool IsWaitingForKeyEvents() const noexcept override { return true; }
 
     gsl::span<wchar_t> SpanAtPointer();
     gsl::span<wchar_t> SpanWholeBuffer();
@@ -158,6 +160,8 @@ private:
 
     ConsoleProcessHandle* const _clientProcess;
 
+    bool _TryEchoChangedSuffix(const size_t firstChanged, til::CoordType& scrollY, NTSTATUS& status);
+
     [[nodiscard]] NTSTATUS _readCharInputLoop(const bool isUnicode, size_t& numBytes) noexcept;
 
     [[nodiscard]] NTSTATUS _handlePostCharInputLoop(const bool isUnicode, size_t& numBytes, ULONG& controlKeyState) noexcept;
@@ -44,6 +44,8 @@ public:
                 _Out_ size_t* const pNumBytes,
                 _Out_ DWORD* const pControlKeyState,
                 _Out_ void* const pOutputData) override;
+    // GetChar() skips over all events but key events.
+    bool IsWaitingForKeyEvents() const noexcept override { return true; }
 
 private:
     size_t _BufferSize;
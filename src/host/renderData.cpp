@@ -80,6 +80,37 @@ std::vector<Viewport> RenderData::GetSelectionRects() noexcept
     return result;
 }
 
+// Method Description:
+// - Same as GetSelectionRects, but only for the rows within the viewport,
+//   which is all that the renderer needs.
+// Return Value:
+// - Vector of Viewports describing the visible area selected
+std::vector<Viewport> RenderData::GetVisibleSelectionRects() noexcept
+{
+    std::vector<Viewport> result;
+
+    try
+    {
+        const auto viewport = GetViewport();
+        for (const auto& select : Selection::Instance().GetSelectionRects(viewport.Top(), viewport.BottomInclusive()))
+        {
+            result.emplace_back(Viewport::FromInclusive(select));
+        }
+    }
+    CATCH_LOG();
+
+    return result;
+}
+
+// Method Description:
+// - Conhost's find dialog selects its match, it doesn't highlight all of them.
+// Return Value:
+// - An empty vector
+std::vector<Viewport> RenderData::GetVisibleHighlightRects() noexcept
+{
+    return {};
+}
+
 // Method Description:
 // - Lock the console for reading the contents of the buffer. Ensures that the
 //      contents of the console won't be changed in the middle of a paint
@@ -98,6 +129,20 @@ void RenderData::UnlockConsole() noexcept
     ::UnlockConsole();
 }
 
+// Method Description:
+// - The console lock is exclusive anyways, so this is the same as LockConsole.
+void RenderData::LockConsoleForWriting() noexcept
+{
+    ::LockConsole();
+}
+
+// Method Description:
+// - Unlocks the console after a call to RenderData::LockConsoleForWriting.
+void RenderData::UnlockConsoleForWriting() noexcept
+{
+    ::UnlockConsole();
+}
+
 #pragma endregion
 
 #pragma region IRenderData
@@ -45,6 +45,8 @@ public:
     bool IsCursorDoubleWidth() const override;
 
     const std::vector<Microsoft::Console::Render::RenderOverlay> GetOverlays() const noexcept override;
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleSelectionRects() noexcept override;
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleHighlightRects() noexcept override;
 
     const bool IsGridLineDrawingAllowed() noexcept override;
 
@@ -66,5 +68,7 @@ public:
     const til::point GetSelectionEnd() const noexcept;
     void ColorSelection(const til::point coordSelectionStart, const til::point coordSelectionEnd, const TextAttribute attr);
     const bool IsUiaDataInitialized() const noexcept override { return true; }
+    void LockConsoleForWriting() noexcept override;
+    void UnlockConsoleForWriting() noexcept override;
 #pragma endregion
 };
@@ -42,6 +42,13 @@ Selection& Selection::Instance()
 // - Returns empty vector if no rows are selected.
 // - Throws exceptions for out of memory issues
 std::vector<til::inclusive_rect> Selection::GetSelectionRects() const
+{
+    return GetSelectionRects(std::numeric_limits<til::CoordType>::min(), std::numeric_limits<til::CoordType>::max());
+}
+
+// Routine Description:
+// - Same as above, but only returns the rectangles for the rows from firstRow to lastRow (inclusive).
+std::vector<til::inclusive_rect> Selection::GetSelectionRects(const til::CoordType firstRow, const til::CoordType lastRow) const
 {
     if (!_fSelectionVisible)
     {
@@ -58,7 +65,7 @@ std::vector<til::inclusive_rect> Selection::GetSelectionRects() const
     endSelectionAnchor.Y = (_coordSelectionAnchor.Y == _srSelectionRect.Top) ? _srSelectionRect.Bottom : _srSelectionRect.Top;
 
     const auto blockSelection = !IsLineSelection();
-    return screenInfo.GetTextBuffer().GetTextRects(_coordSelectionAnchor, endSelectionAnchor, blockSelection, false);
+    return screenInfo.GetTextBuffer().GetTextRects(_coordSelectionAnchor, endSelectionAnchor, blockSelection, false, firstRow, lastRow);
 }
 
 // Routine Description:
@@ -29,6 +29,7 @@ public:
     ~Selection() = default;
 
     std::vector<til::inclusive_rect> GetSelectionRects() const;
+    std::vector<til::inclusive_rect> GetSelectionRects(const til::CoordType firstRow, const til::CoordType lastRow) const;
 
     void ShowSelection();
     void HideSelection();
@@ -63,7 +63,8 @@ try
 
     // Check if this conhost is allowed to delegate its activities to another.
     // If so, look up the registered default console handler.
-    if (Globals.delegationPair.IsUndecided() && Microsoft::Console::Internal::DefaultApp::CheckDefaultAppPolicy())
+    // A PTY never hands off (see _shouldAttemptHandoff), so it skips the registry lookup.
+    if (Globals.delegationPair.IsUndecided() && !args->IsHeadless() && Microsoft::Console::Internal::DefaultApp::CheckDefaultAppPolicy())
     {
         Globals.delegationPair = DelegationConfig::s_GetDelegationPair();
 
@@ -81,7 +82,7 @@ try
     // If we looked up the registered defterm pair, and it was left as the default (missing or {0}),
     // AND velocity is enabled for DxD, then we switch the delegation pair to Terminal and
     // mark that we should check that class for the marker interface later.
-    if (Globals.delegationPair.IsDefault() && Microsoft::Console::Internal::DefaultApp::CheckShouldTerminalBeDefault())
+    if (Globals.delegationPair.IsDefault() && !args->IsHeadless() && Microsoft::Console::Internal::DefaultApp::CheckShouldTerminalBeDefault())
     {
         Globals.delegationPair = DelegationConfig::TerminalDelegationPair;
         Globals.defaultTerminalMarkerCheckRequired = true;
@@ -273,6 +274,32 @@ static bool s_IsOnDesktop()
 
 DWORD WINAPI ConsoleIoThread(LPVOID lpParameter);
 
+// The number of threads servicing driver messages when Feature_ConcurrentIoDispatch is enabled.
+// Messages are still dispatched one at a time and in order (see ConsoleIoThread), so more than three
+// wouldn't buy us anything: one thread dispatches, one receives the next message and one replies.
+static constexpr DWORD ConcurrentIoThreadCount = 3;
+
+// Held while receiving a message from the driver.
+static std::mutex s_receiveMutex;
+// Held while dispatching a message. Messages are dispatched in the order they were received in:
+// s_receivedCount is incremented under s_receiveMutex and s_dispatchedCount under s_dispatchMutex.
+static std::mutex s_dispatchMutex;
+static std::condition_variable s_dispatchTurn;
+static uint64_t s_receivedCount = 0;
+static uint64_t s_dispatchedCount = 0;
+
+static DWORD GetIoThreadCount() noexcept
+{
+    if constexpr (Feature_ConcurrentIoDispatch::IsEnabled())
+    {
+        return ConcurrentIoThreadCount;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
 void ConsoleCheckDebug()
 {
 #ifdef DBG
@@ -929,6 +956,10 @@ PWSTR TranslateConsoleTitle(_In_ PCWSTR pwszConsoleTitle, const BOOL fUnexpand,
 // Routine Description:
 // - This routine is the main one in the console server IO thread.
 // - It reads IO requests submitted by clients through the driver, services and completes them in a loop.
+// - There may be several of these threads (see GetIoThreadCount). Receiving a message and dispatching it
+//   happens under s_dispatchMutex, so messages are still serviced one at a time and in the order the
+//   driver handed them out, just like with a single thread. Replying to a message (which copies its output
+//   back to the client) happens outside of it, overlapping with the dispatch of the next message.
 // Arguments:
 // - lpParameter - PCONSOLE_API_MSG being handed off to us from the previous I/O.
 // Return Value:
@@ -952,34 +983,88 @@ DWORD WINAPI ConsoleIoThread(LPVOID lpParameter)
         ReceiveMsg = *capturedMessage.get();
         ReceiveMsg._pApiRoutines = globals.api;
         ReceiveMsg._pDeviceComm = globals.pDeviceComm;
+
+        const std::lock_guard guard{ s_dispatchMutex };
         IoSorter::ServiceIoOperation(&ReceiveMsg, &ReplyMsg);
     }
 
+    // Start any additional IO threads only now, so that a handed-off connect message is serviced first.
+    // Failing to start one isn't fatal, as this thread can service everything on its own.
+    static std::once_flag startAdditionalThreads;
+    std::call_once(startAdditionalThreads, [] {
+        for (DWORD i = 1; i < GetIoThreadCount(); ++i)
+        {
+            const auto hThread = CreateThread(nullptr, 0, ConsoleIoThread, nullptr, 0, nullptr);
+            if (hThread == nullptr)
+            {
+                LOG_LAST_ERROR();
+                break;
+            }
+
+            LOG_IF_FAILED(SetThreadDescription(hThread, L"Console Driver Message IO Thread"));
+            LOG_IF_WIN32_BOOL_FALSE(CloseHandle(hThread));
+        }
+    });
+
+    const auto concurrent = GetIoThreadCount() > 1;
+
     auto fShouldExit = false;
     while (!fShouldExit)
     {
         if (ReplyMsg != nullptr)
         {
             LOG_IF_FAILED(ReplyMsg->ReleaseMessageBuffers());
+
+            // With a single thread we hand the reply to ReadIo, which saves a call into the driver.
+            // With several we must not: the thread holding s_receiveMutex may wait in ReadIo
+            // for a message from the very client that is still waiting for this reply.
+            if (concurrent)
+            {
+                LOG_IF_FAILED(globals.pDeviceComm->CompleteIo(&ReplyMsg->Complete));
+                ReplyMsg = nullptr;
+            }
         }
 
-        // TODO: 9115192 correct mixed NTSTATUS/HRESULT
-        auto hr = ServiceLocator::LocateGlobals().pDeviceComm->ReadIo(ReplyMsg, &ReceiveMsg);
-        if (FAILED(hr))
+        uint64_t ticket;
         {
-            if (hr == HRESULT_FROM_WIN32(ERROR_PIPE_NOT_CONNECTED))
+            const std::lock_guard guard{ s_receiveMutex };
+
+            // TODO: 9115192 correct mixed NTSTATUS/HRESULT
+            auto hr = ServiceLocator::LocateGlobals().pDeviceComm->ReadIo(ReplyMsg, &ReceiveMsg);
+            if (FAILED(hr))
             {
-                fShouldExit = true;
+                if (hr == HRESULT_FROM_WIN32(ERROR_PIPE_NOT_CONNECTED))
+                {
+                    fShouldExit = true;
 
-                // This will not return. Terminate immediately when disconnected.
-                ServiceLocator::RundownAndExit(STATUS_SUCCESS);
+                    // This will not return. Terminate immediately when disconnected.
+                    ServiceLocator::RundownAndExit(STATUS_SUCCESS);
+                }
+                RIPMSG1(RIP_WARNING, "DeviceIoControl failed with Result 0x%x", hr);
+                ReplyMsg = nullptr;
+                continue;
             }
-            RIPMSG1(RIP_WARNING, "DeviceIoControl failed with Result 0x%x", hr);
-            ReplyMsg = nullptr;
-            continue;
+
+            ticket = s_receivedCount++;
         }
         ReceiveMsg._pApiRoutines = globals.api;
-        IoSorter::ServiceIoOperation(&ReceiveMsg, &ReplyMsg);
+
+        // While another thread is still dispatching the previous message, we can already
+        // copy this message's payload out of the client. The dispatch itself must stay
+        // in order: the API routines look up handles and screen buffers before they
+        // acquire the console lock, which is only safe as long as nothing else runs.
+        if (concurrent)
+        {
+            IoSorter::PrefetchIoOperation(&ReceiveMsg);
+        }
+
+        {
+            std::unique_lock lock{ s_dispatchMutex };
+            s_dispatchTurn.wait(lock, [&]() { return s_dispatchedCount == ticket; });
+            IoSorter::ServiceIoOperation(&ReceiveMsg, &ReplyMsg);
+            ++s_dispatchedCount;
+        }
+        s_dispatchTurn.notify_all();
     }
 
     return 0;
@@ -9,6 +9,7 @@
 #include "globals.h"
 
 #include "../interactivity/win32/Clipboard.hpp"
+#include "../interactivity/inc/EventSynthesis.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 #include "dbcs.h"
@@ -181,6 +182,22 @@ class ClipboardTests
         }
     }
 
+    TEST_METHOD(CanConvertTextToInputRecords)
+    {
+        Log::Comment(L"Linefeeds following a carriage return are skipped and the text ends at the first null character.");
+        const std::wstring_view wstr{ L"a\r\nb\0c", 6 };
+        const auto records = Clipboard::Instance().TextToInputRecords(wstr.data(), wstr.size());
+
+        std::vector<INPUT_RECORD> expected;
+        StringToInputRecords(L"a\rb", CP_USA, expected);
+
+        VERIFY_ARE_EQUAL(expected.size(), records.size());
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected[i], records[i], NoThrowString().Format(L"i == %d", i));
+        }
+    }
+
     TEST_METHOD(CanConvertUppercaseText)
     {
         std::wstring wstr = L"HeLlO WoRlD";
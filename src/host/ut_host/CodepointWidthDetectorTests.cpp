@@ -62,6 +62,19 @@ class CodepointWidthDetectorTests
         }
     }
 
+    TEST_METHOD(CanMeasureNarrowRuns)
+    {
+        CodepointWidthDetector widthDetector;
+        VERIFY_ARE_EQUAL(0u, widthDetector.GetNarrowRunLength(L""));
+        VERIFY_ARE_EQUAL(5u, widthDetector.GetNarrowRunLength(L"hello"));
+        VERIFY_ARE_EQUAL(5u, widthDetector.GetNarrowRunLength(L"hello\r\n"));
+        VERIFY_ARE_EQUAL(3u, widthDetector.GetNarrowRunLength(L"abc\x7f"));
+        VERIFY_ARE_EQUAL(4u, widthDetector.GetNarrowRunLength(L"k\xe4s!")); // U+00E4 is narrow.
+        VERIFY_ARE_EQUAL(2u, widthDetector.GetNarrowRunLength(L"ab\x306A")); // U+306A hiragana na is wide.
+        VERIFY_ARE_EQUAL(1u, widthDetector.GetNarrowRunLength(L"a\x414")); // U+0414 is ambiguous.
+        VERIFY_ARE_EQUAL(1u, widthDetector.GetNarrowRunLength(std::wstring{ L"a" }.append(emoji)));
+    }
+
     static bool FallbackMethod(const std::wstring_view glyph)
     {
         if (glyph.size() < 1)
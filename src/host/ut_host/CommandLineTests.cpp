@@ -467,6 +467,53 @@ class CommandLineTests
         VerifyPromptText(cookedReadData, L"Indestructible");
     }
 
+    TEST_METHOD(MidLineEditsRedrawTheLine)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+        auto& consoleInfo = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = consoleInfo.GetActiveOutputBuffer();
+        auto& cookedReadData = consoleInfo.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        cookedReadData.SetInsertMode(true);
+
+        const auto& cursor = screenInfo.GetTextBuffer().GetCursor();
+        const auto origin = cursor.GetPosition();
+        const auto lineText = [&]() {
+            return screenInfo.GetTextBuffer().GetRowByOffset(origin.Y).GetText().substr(origin.X, 8);
+        };
+
+        VERIFY_ARE_EQUAL(6u, cookedReadData.Write(L"abcdef"));
+
+        Log::Comment(L"Insert a character in the middle of the line.");
+        auto& commandLine = CommandLine::Instance();
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, commandLine.ProcessCommandLine(cookedReadData, VK_LEFT, 0));
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, commandLine.ProcessCommandLine(cookedReadData, VK_LEFT, 0));
+        NTSTATUS status;
+        cookedReadData.ProcessInput(L'X', 0, status);
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, status);
+        VerifyPromptText(cookedReadData, L"abcdXef");
+        VERIFY_ARE_EQUAL(L"abcdXef ", lineText());
+        VERIFY_ARE_EQUAL(origin.X + 5, cursor.GetPosition().X);
+
+        Log::Comment(L"Overwrite a character in the middle of the line.");
+        cookedReadData.SetInsertMode(false);
+        cookedReadData.ProcessInput(L'Y', 0, status);
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, status);
+        VerifyPromptText(cookedReadData, L"abcdXYf");
+        VERIFY_ARE_EQUAL(L"abcdXYf ", lineText());
+        VERIFY_ARE_EQUAL(origin.X + 6, cursor.GetPosition().X);
+
+        Log::Comment(L"Erase characters in the middle of the line. The left over cells must be blanked.");
+        cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status);
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, status);
+        cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status);
+        VERIFY_ARE_EQUAL(STATUS_SUCCESS, status);
+        VerifyPromptText(cookedReadData, L"abcdf");
+        VERIFY_ARE_EQUAL(L"abcdf   ", lineText());
+        VERIFY_ARE_EQUAL(origin.X + 4, cursor.GetPosition().X);
+    }
+
     TEST_METHOD(CmdlineCtrlHomeFullwidthChars)
     {
         Log::Comment(L"Set up buffers, create cooked read data, get screen information.");
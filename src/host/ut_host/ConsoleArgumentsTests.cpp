@@ -32,6 +32,7 @@ public:
     TEST_METHOD(HeadlessArgTests);
     TEST_METHOD(SignalHandleTests);
     TEST_METHOD(FeatureArgTests);
+    TEST_METHOD(PooledHandoffTests);
 };
 
 ConsoleArguments CreateAndParse(std::wstring& commandline, HANDLE hVtIn, HANDLE hVtOut)
@@ -1336,3 +1337,47 @@ void ConsoleArgumentsTests::FeatureArgTests()
                                     false), // passthroughMode
                    false); // successful parse?
 }
+
+void ConsoleArgumentsTests::PooledHandoffTests()
+{
+    wil::unique_handle signalRead;
+    wil::unique_handle signalWrite;
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(signalRead.addressof(), signalWrite.addressof(), nullptr, 0));
+
+    std::wstring commandline = fmt::format(L"conhost.exe --headless --pooled --signal 0x{:x} --server 0x8", HandleToULong(signalRead.get()));
+    auto args = CreateAndParse(commandline, nullptr, nullptr);
+    VERIFY_IS_TRUE(args.IsPooled());
+    VERIFY_IS_FALSE(args.HasVtHandles());
+
+#pragma pack(push, 1)
+    struct
+    {
+        unsigned short id;
+        unsigned short width;
+        unsigned short height;
+        DWORD flags;
+        DWORD input;
+        DWORD output;
+    } handoff{ 16, 120, 30, 0x1 | 0x4, 0x10, 0x24 };
+#pragma pack(pop)
+
+    // The handoff arrives in two pieces, as it might when read from a pipe.
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(signalWrite.get(), &handoff, 4, nullptr, nullptr));
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(signalWrite.get(), reinterpret_cast<const BYTE*>(&handoff) + 4, sizeof(handoff) - 4, nullptr, nullptr));
+    VERIFY_SUCCEEDED(args.WaitForPoolHandoff());
+
+    VERIFY_IS_FALSE(args.IsPooled());
+    VERIFY_ARE_EQUAL(UlongToHandle(0x10), args.GetVtInHandle());
+    VERIFY_ARE_EQUAL(UlongToHandle(0x24), args.GetVtOutHandle());
+    VERIFY_ARE_EQUAL(120, args.GetWidth());
+    VERIFY_ARE_EQUAL(30, args.GetHeight());
+    VERIFY_IS_TRUE(args.GetInheritCursor());
+    VERIFY_IS_FALSE(args.IsResizeQuirkEnabled());
+    VERIFY_IS_TRUE(args.IsWin32InputModeEnabled());
+    VERIFY_IS_FALSE(args.IsPassthroughMode());
+
+    // If the pool is shut down before the host was used, the signal pipe breaks.
+    auto unused = CreateAndParse(commandline, nullptr, nullptr);
+    signalWrite.reset();
+    VERIFY_FAILED(unused.WaitForPoolHandoff());
+}
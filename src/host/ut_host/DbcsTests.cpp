@@ -11,6 +11,7 @@
 #include "../buffer/out/textBuffer.hpp"
 
 #include "dbcs.h"
+#include "misc.h"
 
 #include "input.h"
 
@@ -87,4 +88,50 @@ class DbcsTests
             }
         }
     }
+
+    TEST_METHOD(CodepageTableMatchesConversions)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"Data:codepage", L"{437, 932, 936, 949}")
+        END_TEST_METHOD_PROPERTIES()
+
+        UINT codepage;
+        VERIFY_SUCCEEDED(TestData::TryGetValue(L"codepage", codepage));
+
+        CPINFO info{};
+        if (!GetCPInfo(codepage, &info))
+        {
+            Log::Comment(L"The codepage isn't installed.");
+            return;
+        }
+
+        auto& table = CodepageTable::Get(codepage);
+
+        for (auto i = 0; i < 256; ++i)
+        {
+            const auto ch = gsl::narrow_cast<char>(i);
+            VERIFY_ARE_EQUAL(IsDBCSLeadByteConsole(ch, &info), table.IsLeadByte(ch));
+
+            wchar_t expected = UNICODE_SPACE;
+            if (table.IsLeadByte(ch))
+            {
+                const char dbcs[2]{ ch, '\x81' };
+                ConvertOutputToUnicode(codepage, &dbcs[0], 2, &expected, 1);
+                VERIFY_ARE_EQUAL(expected, table.OutputToUnicode(dbcs[0], dbcs[1]));
+            }
+            else
+            {
+                ConvertOutputToUnicode(codepage, &ch, 1, &expected, 1);
+                VERIFY_ARE_EQUAL(expected, table.OutputToUnicode(ch));
+            }
+        }
+
+        // ASCII, box drawing and katakana, some of which take 2 bytes in DBCS codepages.
+        for (const auto wch : { L'a', L'\x2550', L'\x30AB', L'\xFF76' })
+        {
+            char expected[2]{};
+            const auto length = ConvertToOem(codepage, &wch, 1, &expected[0], 2);
+            VERIFY_IS_TRUE(std::string_view(&expected[0], length) == table.ToOem(wch));
+        }
+    }
 };
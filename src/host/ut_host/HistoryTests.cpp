@@ -242,6 +242,48 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2ul, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(FindMatchingCommand)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (const auto command : { L"dir", L"cd ..", L"dir /w", L"ping 127.0.0.1", L"dir /p" })
+        {
+            VERIFY_SUCCEEDED(history->Add(command, false));
+        }
+
+        const auto find = [&](const std::wstring_view command, const SHORT start, const CommandHistory::MatchOptions options) -> int {
+            SHORT index = -1;
+            return history->FindMatchingCommand(command, start, index, options | CommandHistory::MatchOptions::JustLooking) ? index : -1;
+        };
+        using MatchOptions = CommandHistory::MatchOptions;
+
+        Log::Comment(L"Prefix matches are found walking backwards from the starting index, wrapping around.");
+        VERIFY_ARE_EQUAL(2, find(L"dir", 4, MatchOptions::None));
+        VERIFY_ARE_EQUAL(0, find(L"dir", 2, MatchOptions::None));
+        VERIFY_ARE_EQUAL(4, find(L"dir", 0, MatchOptions::None));
+        VERIFY_ARE_EQUAL(-1, find(L"ipconfig", 4, MatchOptions::None));
+        VERIFY_ARE_EQUAL(-1, find(L"DIR", 4, MatchOptions::None), L"Matching is case-sensitive.");
+
+        Log::Comment(L"Exact matches ignore commands that merely start with the given one.");
+        VERIFY_ARE_EQUAL(0, find(L"dir", 4, MatchOptions::ExactMatch));
+
+        Log::Comment(L"The index follows the commands when they're swapped, removed or evicted.");
+        history->Swap(0, 1);
+        VERIFY_ARE_EQUAL(1, find(L"dir", 4, MatchOptions::ExactMatch));
+        VERIFY_ARE_EQUAL(String(L"dir"), String(history->Remove(1).c_str()));
+        VERIFY_ARE_EQUAL(1, find(L"dir", 3, MatchOptions::None));
+        VERIFY_ARE_EQUAL(-1, find(L"dir", 3, MatchOptions::ExactMatch));
+
+        for (UINT i = 0; i < s_BufferSize; i++)
+        {
+            VERIFY_SUCCEEDED(history->Add(L"x" + std::to_wstring(i), false));
+        }
+        VERIFY_ARE_EQUAL(-1, find(L"dir", 9, MatchOptions::None));
+        VERIFY_ARE_EQUAL(8, find(L"x", 9, MatchOptions::None));
+        VERIFY_ARE_EQUAL(3, find(L"x3", 9, MatchOptions::ExactMatch));
+    }
+
 private:
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
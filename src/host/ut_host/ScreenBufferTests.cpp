@@ -161,6 +161,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyMixedText);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -246,6 +247,8 @@ class ScreenBufferTests
     TEST_METHOD(TestReflowBiggerLongLineWithColor);
 
     TEST_METHOD(TestDeferredMainBufferResize);
+
+    TEST_METHOD(ImeCompositionReusesConversionAreas);
 };
 
 void ScreenBufferTests::SingleAlternateBufferCreationTest()
@@ -2884,6 +2887,34 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, renderSettings.GetAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyMixedText()
+{
+    // WriteCharsLegacy writes runs of printable ASCII straight from the input
+    // string. Make sure that runs of them interleaved with control characters
+    // and wide glyphs still end up in the right cells, and wrap correctly.
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const auto& tbi = si.GetTextBuffer();
+    auto& cursor = si.GetTextBuffer().GetCursor();
+    const auto width = si.GetBufferSize().Width();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, til::point(0, 0), true));
+    cursor.SetPosition({ 0, 0 });
+
+    // "ab", a tab to column 8, "cd", a wide glyph in columns 10 and 11, "e",
+    // then x's up to the last two columns, which get "yz". The "!" wraps.
+    const std::wstring xs(gsl::narrow_cast<size_t>(width - 15), L'x');
+    const auto str = L"ab\tcd\x3042e" + xs + L"yz!";
+    auto seqCb = str.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str.data(), str.data(), str.data(), &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+
+    // GetText() skips the trailing half of the wide glyph.
+    VERIFY_ARE_EQUAL(L"ab      cd\x3042e" + xs + L"yz", tbi.GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L'!', tbi.GetRowByOffset(1).GetText()[0]);
+    VERIFY_ARE_EQUAL(til::point(1, 1), cursor.GetPosition());
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -7228,3 +7259,54 @@ void ScreenBufferTests::TestDeferredMainBufferResize()
     VERIFY_ARE_EQUAL(altPostResizeView, mainPostRestoreView);
     VERIFY_ARE_EQUAL(expectedSize, mainPostRestoreView);
 }
+
+void ScreenBufferTests::ImeCompositionReusesConversionAreas()
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole(); // Lock must be taken to manipulate buffer.
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    auto& ime = gci.ConsoleIme;
+    auto cleanup = wil::scope_exit([&] {
+        ime.ClearAllAreas();
+        ime.RestoreCursorVisibility();
+    });
+
+    const std::array<WORD, CONIME_ATTRCOLOR_SIZE> colors{ 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07 };
+    const std::vector<BYTE> attributes(8, BYTE{ 0 });
+    const auto compose = [&](const std::wstring_view text) {
+        ime.WriteCompMessage(text, { attributes.data(), text.size() }, colors);
+    };
+    const auto textAt = [&](const til::CoordType column) {
+        return std::wstring{ ime.ConvAreaCompStr.front().GetTextBuffer().GetCellDataAt({ column, 0 })->Chars() };
+    };
+
+    Log::Comment(L"The first composition creates a conversion area.");
+    compose(L"abc");
+    VERIFY_ARE_EQUAL(1u, ime.ConvAreaCompStr.size());
+    const auto firstBuffer = &ime.ConvAreaCompStr.front().GetTextBuffer();
+    VERIFY_ARE_EQUAL(2, ime.ConvAreaCompStr.front().GetAreaBufferInfo().rcViewCaWindow.right);
+
+    Log::Comment(L"The next keystrokes reuse it, whether the composition grows or changes.");
+    compose(L"abcd");
+    VERIFY_ARE_EQUAL(1u, ime.ConvAreaCompStr.size());
+    VERIFY_ARE_EQUAL(firstBuffer, &ime.ConvAreaCompStr.front().GetTextBuffer());
+    VERIFY_ARE_EQUAL(3, ime.ConvAreaCompStr.front().GetAreaBufferInfo().rcViewCaWindow.right);
+    VERIFY_ARE_EQUAL(L"d", textAt(3));
+
+    compose(L"aXcd");
+    VERIFY_ARE_EQUAL(firstBuffer, &ime.ConvAreaCompStr.front().GetTextBuffer());
+    VERIFY_ARE_EQUAL(L"X", textAt(1));
+    VERIFY_ARE_EQUAL(L"c", textAt(2));
+
+    Log::Comment(L"Shrinking the composition only shrinks the visible part of the area.");
+    compose(L"aX");
+    VERIFY_ARE_EQUAL(firstBuffer, &ime.ConvAreaCompStr.front().GetTextBuffer());
+    VERIFY_ARE_EQUAL(1, ime.ConvAreaCompStr.front().GetAreaBufferInfo().rcViewCaWindow.right);
+    VERIFY_IS_FALSE(ime.ConvAreaCompStr.front().IsHidden());
+
+    Log::Comment(L"An empty composition hides the area, but keeps it around.");
+    compose(L"");
+    VERIFY_ARE_EQUAL(1u, ime.ConvAreaCompStr.size());
+    VERIFY_IS_TRUE(ime.ConvAreaCompStr.front().IsHidden());
+}
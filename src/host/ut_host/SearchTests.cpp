@@ -158,4 +158,85 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    TEST_METHOD(AllMatches)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"ab", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+        VERIFY_IS_FALSE(s.GetCurrentMatchIndex().has_value());
+
+        const auto& matches = s.GetAllMatches();
+        VERIFY_ARE_EQUAL(size_t{ 4 }, matches.size());
+        for (size_t i = 0; i < matches.size(); ++i)
+        {
+            const auto y = gsl::narrow_cast<til::CoordType>(i);
+            VERIFY_ARE_EQUAL(til::point(0, y), matches.at(i).first);
+            VERIFY_ARE_EQUAL(til::point(1, y), matches.at(i).second);
+
+            VERIFY_IS_TRUE(s.FindNext());
+            VERIFY_ARE_EQUAL(i, s.GetCurrentMatchIndex().value());
+        }
+
+        VERIFY_IS_FALSE(s.FindNext());
+        VERIFY_IS_FALSE(s.GetCurrentMatchIndex().has_value());
+    }
+
+    TEST_METHOD(ForwardAcrossWrappedLine)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto width = textBuffer.GetSize().Width();
+
+        // Put "XY" at the end of the first row and "Z" at the start of the second one.
+        auto& firstRow = textBuffer.GetRowByOffset(0);
+        firstRow.GetCharRow().GlyphAt(width - 2) = L"X";
+        firstRow.GetCharRow().GlyphAt(width - 1) = L"Y";
+        textBuffer.GetRowByOffset(1).GetCharRow().GlyphAt(0) = L"Z";
+
+        // The text only continues into the second row if the first one wrapped.
+        Search unwrapped(gci.renderData, L"XYZ", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_IS_FALSE(unwrapped.FindNext());
+
+        firstRow.SetWrapForced(true);
+
+        Search wrapped(gci.renderData, L"XYZ", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_IS_TRUE(wrapped.FindNext());
+        VERIFY_ARE_EQUAL(til::point(width - 2, 0), wrapped._coordSelStart);
+        VERIFY_ARE_EQUAL(til::point(0, 1), wrapped._coordSelEnd);
+        VERIFY_IS_FALSE(wrapped.FindNext());
+    }
+
+    TEST_METHOD(RegexMatches)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        // Each row holds "AB\x304bC\x304dDE" and the wide glyphs are seen only once by the pattern.
+        Search wide(gci.renderData, L"B\x304b.", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        VERIFY_IS_TRUE(wide.IsValid());
+        const auto& wideMatches = wide.GetAllMatches();
+        VERIFY_ARE_EQUAL(size_t{ 4 }, wideMatches.size());
+        for (size_t i = 0; i < wideMatches.size(); ++i)
+        {
+            const auto y = gsl::narrow_cast<til::CoordType>(i);
+            VERIFY_ARE_EQUAL(til::point(1, y), wideMatches.at(i).first);
+            VERIFY_ARE_EQUAL(til::point(4, y), wideMatches.at(i).second);
+        }
+
+        // The trailing half of a wide glyph is the last cell of a match that ends with it.
+        Search trailing(gci.renderData, L"c\x304d", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, Search::Mode::Regex);
+        VERIFY_IS_TRUE(trailing.FindNext());
+        VERIFY_ARE_EQUAL(til::point(4, 0), trailing._coordSelStart);
+        VERIFY_ARE_EQUAL(til::point(6, 0), trailing._coordSelEnd);
+
+        // Classes aren't affected by case folding.
+        Search insensitive(gci.renderData, L"[A-Z]{2}$|d[a-e]", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, Search::Mode::Regex);
+        VERIFY_IS_TRUE(insensitive.FindNext());
+        VERIFY_ARE_EQUAL(til::point(7, 0), insensitive._coordSelStart);
+        VERIFY_ARE_EQUAL(til::point(8, 0), insensitive._coordSelEnd);
+
+        Search invalid(gci.renderData, L"AB(", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        VERIFY_IS_FALSE(invalid.IsValid());
+        VERIFY_IS_FALSE(invalid.FindNext());
+    }
 };
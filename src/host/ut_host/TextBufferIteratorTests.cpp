@@ -11,6 +11,7 @@
 #include "../buffer/out/textBuffer.hpp"
 #include "../buffer/out/textBufferCellIterator.hpp"
 #include "../buffer/out/textBufferTextIterator.hpp"
+#include "../buffer/out/textBufferRowCursor.hpp"
 #include "../buffer/out/CharRow.hpp"
 
 #include "input.h"
@@ -315,6 +316,9 @@ class TextBufferIteratorTests
 
     TEST_METHOD(ConstructedNoLimit);
     TEST_METHOD(ConstructedLimits);
+
+    TEST_METHOD(RowCursorMatchesCellIterator);
+    TEST_METHOD(RowCursorRuns);
 };
 
 void TextBufferIteratorTests::BoolOperatorText()
@@ -582,3 +586,72 @@ void TextBufferIteratorTests::ConstructedLimits()
                            wil::ResultException,
                            [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
 }
+
+void TextBufferIteratorTests::RowCursorMatchesCellIterator()
+{
+    m_state->FillTextBuffer();
+
+    const auto& textBuffer = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetTextBuffer();
+    const auto width = textBuffer.GetSize().Width();
+
+    for (til::CoordType y = 0; y < 4; ++y)
+    {
+        const til::inclusive_rect limits{ 1, y, width - 2, y };
+        auto it = textBuffer.GetCellDataAt({ 1, y }, Viewport::FromInclusive(limits));
+        TextBufferRowCursor cursor{ textBuffer.GetRowByOffset(y), 1, width - 1 };
+
+        for (; it; ++it, ++cursor)
+        {
+            VERIFY_IS_TRUE(cursor);
+            VERIFY_ARE_EQUAL(it.Pos().X, cursor.Column());
+            VERIFY_ARE_EQUAL(String(it->Chars().data(), gsl::narrow<int>(it->Chars().size())), String(cursor.Chars().data(), gsl::narrow<int>(cursor.Chars().size())));
+            VERIFY_ARE_EQUAL(it->DbcsAttr(), cursor.DbcsAttr());
+            VERIFY_ARE_EQUAL(it->Columns(), cursor.Columns());
+            VERIFY_ARE_EQUAL(it->TextAttr(), cursor.TextAttr());
+        }
+        VERIFY_IS_FALSE(cursor);
+    }
+}
+
+void TextBufferIteratorTests::RowCursorRuns()
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+    const auto width = textBuffer.GetSize().Width();
+
+    TextAttribute red{ FOREGROUND_RED };
+    TextAttribute blue{ FOREGROUND_BLUE };
+    textBuffer.GetRowByOffset(0).Reset(red);
+    textBuffer.Write(OutputCellIterator{ L"abcd", blue }, { 4, 0 });
+
+    TextBufferRowCursor cursor{ textBuffer.GetRowByOffset(0), 2, width };
+    VERIFY_ARE_EQUAL(red, cursor.TextAttr());
+    VERIFY_ARE_EQUAL(4, cursor.RunEnd());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"  " }, cursor.RunText());
+
+    cursor.NextRun();
+    VERIFY_ARE_EQUAL(4, cursor.Column());
+    VERIFY_ARE_EQUAL(blue, cursor.TextAttr());
+    VERIFY_ARE_EQUAL(8, cursor.RunEnd());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"abcd" }, cursor.RunText());
+
+    // Moving within a run doesn't change the end of the run.
+    cursor += 2;
+    VERIFY_ARE_EQUAL(blue, cursor.TextAttr());
+    VERIFY_ARE_EQUAL(8, cursor.RunEnd());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"cd" }, cursor.RunText());
+
+    cursor.NextRun();
+    VERIFY_ARE_EQUAL(red, cursor.TextAttr());
+    VERIFY_ARE_EQUAL(width, cursor.RunEnd());
+
+    cursor.NextRun();
+    VERIFY_IS_FALSE(cursor);
+
+    // The runs are limited to the range of the cursor.
+    TextBufferRowCursor limited{ textBuffer.GetRowByOffset(0), 5, 6 };
+    VERIFY_ARE_EQUAL(6, limited.RunEnd());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"b" }, limited.RunText());
+    limited.NextRun();
+    VERIFY_IS_FALSE(limited);
+}
@@ -143,6 +143,10 @@ class TextBufferTests
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
+    TEST_METHOD(HighUnicodeShiftsFollowingColumns);
+    TEST_METHOD(FrozenRowsPreserveText);
+    TEST_METHOD(AttributeTableIsCompacted);
+    TEST_METHOD(CopiedRowsKeepTheirAttributes);
 
     TEST_METHOD(TestBurrito);
 
@@ -150,6 +154,7 @@ class TextBufferTests
 
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
     TEST_METHOD(GetWordBoundaries);
+    TEST_METHOD(GetWordBoundariesAfterModification);
     TEST_METHOD(MoveByWord);
     TEST_METHOD(GetGlyphBoundaries);
 
@@ -158,6 +163,19 @@ class TextBufferTests
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkTrimAfterOverwrite);
+
+    TEST_METHOD(GetPatternsAcrossWrappedRows);
+
+    TEST_METHOD(ConsumeDirtyRows);
+    TEST_METHOD(ScrollRowsAcrossCircularBufferEnd);
+
+    TEST_METHOD(FillRect);
+    TEST_METHOD(FillCells);
+    TEST_METHOD(ShiftCells);
+    TEST_METHOD(MeasureRightTracksWrites);
+
+    TEST_METHOD(SerializeRoundTrips);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -1842,7 +1860,7 @@ void TextBufferTests::ResizeTraditional()
 }
 
 // This tests that when buffer storage rows are rotated around during a resize traditional operation,
-// that the Unicode Storage-held high unicode items like emoji rotate properly with it.
+// that the high unicode items like emoji stored in the rows rotate properly with them.
 void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
 {
     // Set up a text buffer for us
@@ -1853,9 +1871,9 @@ void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
 
     // Get a position inside the buffer
     const til::point pos{ 2, 1 };
-    auto position = _buffer->_storage[pos.Y].GetCharRow().GlyphAt(pos.X);
+    auto position = _buffer->GetRowByOffset(pos.Y).GetCharRow().GlyphAt(pos.X);
 
-    // Fill it up with a sequence that will have to hit the high unicode storage.
+    // Fill it up with a sequence that takes up more than one code unit in the row.
     // This is the negative squared latin capital letter B emoji: 🅱
     // It's encoded in UTF-16, as needed by the buffer.
     const auto bButton = L"\xD83C\xDD71";
@@ -1884,7 +1902,7 @@ void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
 }
 
 // This tests that when buffer storage rows are rotated around during a scroll buffer operation,
-// that the Unicode Storage-held high unicode items like emoji rotate properly with it.
+// that the high unicode items like emoji stored in the rows rotate properly with them.
 void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
 {
     // Set up a text buffer for us
@@ -1895,9 +1913,9 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
 
     // Get a position inside the buffer
     const til::point pos{ 2, 1 };
-    auto position = _buffer->_storage[pos.Y].GetCharRow().GlyphAt(pos.X);
+    auto position = _buffer->GetRowByOffset(pos.Y).GetCharRow().GlyphAt(pos.X);
 
-    // Fill it up with a sequence that will have to hit the high unicode storage.
+    // Fill it up with a sequence that takes up more than one code unit in the row.
     // This is the fire emoji: 🔥
     // It's encoded in UTF-16, as needed by the buffer.
     const auto fire = L"\xD83D\xDD25";
@@ -1924,7 +1942,7 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
 }
 
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
-// characters from the Unicode Storage buffer
+// characters stored in them
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
 {
     // Set up a text buffer for us
@@ -1935,9 +1953,9 @@ void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
 
     // Get a position inside the buffer in the bottom row
     const til::point pos{ 0, bufferSize.Y - 1 };
-    auto position = _buffer->_storage[pos.Y].GetCharRow().GlyphAt(pos.X);
+    auto position = _buffer->GetRowByOffset(pos.Y).GetCharRow().GlyphAt(pos.X);
 
-    // Fill it up with a sequence that will have to hit the high unicode storage.
+    // Fill it up with a sequence that takes up more than one code unit in the row.
     // This is the eggplant emoji: 🍆
     // It's encoded in UTF-16, as needed by the buffer.
     const auto emoji = L"\xD83C\xDF46";
@@ -1948,18 +1966,20 @@ void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
-
     // Perform resize to trim off the row of the buffer that included the emoji
     til::size trimmedBufferSize{ bufferSize.X, bufferSize.Y - 1 };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    // The remaining rows must not have picked up the emoji.
+    for (til::CoordType y = 0; y < trimmedBufferSize.Y; ++y)
+    {
+        VERIFY_IS_FALSE(_buffer->GetRowByOffset(y).GetCharRow().ContainsText());
+    }
 }
 
 // This tests that columns removed from the buffer while resizing traditionally will also drop the high unicode
-// characters from the Unicode Storage buffer
+// characters stored in them
 void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
 {
     // Set up a text buffer for us
@@ -1970,9 +1990,9 @@ void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
 
     // Get a position inside the buffer in the last column
     const til::point pos{ bufferSize.X - 1, 0 };
-    auto position = _buffer->_storage[pos.Y].GetCharRow().GlyphAt(pos.X);
+    auto position = _buffer->GetRowByOffset(pos.Y).GetCharRow().GlyphAt(pos.X);
 
-    // Fill it up with a sequence that will have to hit the high unicode storage.
+    // Fill it up with a sequence that takes up more than one code unit in the row.
     // This is the peach emoji: 🍑
     // It's encoded in UTF-16, as needed by the buffer.
     const auto emoji = L"\xD83C\xDF51";
@@ -1983,14 +2003,191 @@ void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
-
     // Perform resize to trim off the column of the buffer that included the emoji
     til::size trimmedBufferSize{ bufferSize.X - 1, bufferSize.Y };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    const auto& charRow = _buffer->GetRowByOffset(pos.Y).GetCharRow();
+    VERIFY_ARE_EQUAL(trimmedBufferSize.X, charRow.size());
+    VERIFY_IS_FALSE(charRow.ContainsText());
+    VERIFY_ARE_EQUAL(std::wstring(gsl::narrow_cast<size_t>(trimmedBufferSize.X), L' '), _buffer->GetRowByOffset(pos.Y).GetText());
+}
+
+// This tests that glyphs of varying length stored in the middle of a row
+// keep the glyphs of the columns surrounding them intact.
+void TextBufferTests::HighUnicodeShiftsFollowingColumns()
+{
+    const til::size bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    auto& row = _buffer->GetRowByOffset(0);
+    auto& charRow = row.GetCharRow();
+    for (til::CoordType x = 0; x < bufferSize.X; ++x)
+    {
+        const auto wch = gsl::narrow_cast<wchar_t>(L'0' + x);
+        charRow.GlyphAt(x) = { &wch, 1 };
+    }
+
+    // Grow column 2 and 3 into surrogate pairs. This is the fire emoji: 🔥
+    const auto fire = L"\xD83D\xDD25";
+    charRow.GlyphAt(2) = fire;
+    charRow.GlyphAt(3) = fire;
+    VERIFY_ARE_EQUAL(String(L"01\xD83D\xDD25\xD83D\xDD25456789"), String(row.GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"4"), String(charRow.GlyphViewAt(4).data(), 1));
+
+    // Shrink column 2 back down and ensure the emoji in column 3 survives.
+    charRow.GlyphAt(2) = L"x";
+    VERIFY_ARE_EQUAL(String(L"01x\xD83D\xDD25456789"), String(row.GetText().c_str()));
+    VERIFY_ARE_EQUAL(2u, charRow.GlyphViewAt(3).size());
+    VERIFY_ARE_EQUAL(bufferSize.X, charRow.MeasureRight());
+
+    // Resetting the row releases all of it.
+    VERIFY_IS_TRUE(row.Reset(attr));
+    VERIFY_IS_FALSE(charRow.ContainsText());
+    VERIFY_ARE_EQUAL(1u, charRow.GlyphViewAt(3).size());
+}
+
+// This tests that rows which scrolled far enough to be frozen
+// come back with their text and double-width attributes intact,
+// both from memory and from the scrollback spill file.
+void TextBufferTests::FrozenRowsPreserveText()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:spillScrollback", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    bool spillScrollback;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"spillScrollback", spillScrollback));
+
+    const til::size bufferSize{ 20, TextBuffer::_hotRowDistance + 100 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    _buffer->SetScrollbackSpill(spillScrollback);
+
+    // Every third row gets a row full of ASCII, a surrogate pair and a double-width glyph
+    // respectively, to cover both ways a frozen row can be stored. The rest stays blank.
+    const auto fire = L"\xD83D\xDD25";
+    const auto fillRow = [&](ROW& row, const til::CoordType y) {
+        auto& charRow = row.GetCharRow();
+        const auto wch = gsl::narrow_cast<wchar_t>(L'A' + y % 26);
+        charRow.GlyphAt(0) = { &wch, 1 };
+        if (y % 3 == 1)
+        {
+            charRow.GlyphAt(1) = fire;
+        }
+        else if (y % 3 == 2)
+        {
+            charRow.GlyphAt(1) = L"\x3042";
+            charRow.GlyphAt(2) = L"\x3042";
+            charRow.DbcsAttrAt(1).SetLeading();
+            charRow.DbcsAttrAt(2).SetTrailing();
+        }
+    };
+    const auto verifyRow = [&](const ROW& row, const til::CoordType y) {
+        const auto& charRow = row.GetCharRow();
+        const auto wch = gsl::narrow_cast<wchar_t>(L'A' + y % 26);
+        VERIFY_ARE_EQUAL(String(&wch, 1), String(charRow.GlyphViewAt(0).data(), 1));
+        if (y % 3 == 1)
+        {
+            VERIFY_ARE_EQUAL(String(fire), String(charRow.GlyphViewAt(1).data(), 2));
+            VERIFY_IS_TRUE(charRow.DbcsAttrAt(1).IsSingle());
+        }
+        else if (y % 3 == 2)
+        {
+            VERIFY_IS_TRUE(charRow.DbcsAttrAt(1).IsLeading());
+            VERIFY_IS_TRUE(charRow.DbcsAttrAt(2).IsTrailing());
+        }
+        VERIFY_ARE_EQUAL(y % 3 + 1, charRow.MeasureRight());
+    };
+
+    // Fill the rows at the bottom of the buffer, where the output happens.
+    const auto written = 50;
+    const auto bottom = bufferSize.Y - written;
+    for (til::CoordType y = 0; y < written; ++y)
+    {
+        fillRow(_buffer->GetRowByOffset(bottom + y), y);
+    }
+
+    // Scroll them far enough up for all of them to freeze, without scrolling them out of the buffer.
+    const auto scrolled = TextBuffer::_hotRowDistance;
+    for (auto i = 0; i < scrolled; ++i)
+    {
+        VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    }
+    for (til::CoordType y = 0; y < written; ++y)
+    {
+        const auto& row = _buffer->_storage.at(bottom + y);
+        VERIFY_IS_TRUE(row.IsFrozen());
+        VERIFY_ARE_EQUAL(spillScrollback, row.GetSpillHandle().has_value());
+    }
+
+    // Resizing moves frozen rows without thawing them.
+    VERIFY_NT_SUCCESS(_buffer->ResizeTraditional({ bufferSize.X + 10, bufferSize.Y }));
+    const auto top = bottom - scrolled;
+    VERIFY_IS_TRUE(_buffer->_storage.at(top).IsFrozen());
+
+    for (til::CoordType y = 0; y < written; ++y)
+    {
+        const auto& row = _buffer->GetRowByOffset(top + y);
+        VERIFY_IS_FALSE(row.IsFrozen());
+        verifyRow(row, y);
+    }
+}
+
+// This tests that the attributes which were overwritten by enough others
+// are dropped from the attribute table, and that the rest survive that.
+void TextBufferTests::AttributeTableIsCompacted()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    TextAttribute kept{ 0x7f };
+    kept.SetForeground(RGB(1, 2, 3));
+    _buffer->Write(OutputCellIterator{ L"ab", kept }, { 0, 1 });
+
+    // Overwrite a single cell with a new color over and over, which needs more colors than the table holds.
+    TextAttribute overwritten{ 0x7f };
+    for (size_t i = 0; i < TextAttributeTable::Capacity + 100; ++i)
+    {
+        overwritten.SetBackground(gsl::narrow_cast<COLORREF>(i));
+        _buffer->Write(OutputCellIterator{ L"x", overwritten }, { 0, 0 });
+    }
+
+    VERIFY_IS_LESS_THAN(_buffer->GetAttributeTable().size(), TextAttributeTable::Capacity);
+    VERIFY_ARE_EQUAL(overwritten, _buffer->GetRowByOffset(0).GetAttrRow().GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(0).GetAttrRow().GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(kept, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(2));
+}
+
+// This tests that copying a row into another buffer, which has an attribute table
+// of its own, keeps the attributes of the row and not just their indices.
+void TextBufferTests::CopiedRowsKeepTheirAttributes()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto source = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    auto target = std::make_unique<TextBuffer>(bufferSize, TextAttribute{ 0x1e }, cursorSize, false, _renderer);
+
+    TextAttribute red{ 0x7f };
+    red.SetForeground(RGB(255, 0, 0));
+    source->Write(OutputCellIterator{ L"abc", red }, { 1, 0 });
+
+    VERIFY_SUCCEEDED(target->GetRowByOffset(0).CopyFrom(source->GetRowByOffset(0)));
+
+    const auto& attrRow = target->GetRowByOffset(0).GetAttrRow();
+    VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(red, attrRow.GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(red, attrRow.GetAttrByColumn(3));
+    VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(4));
+    VERIFY_IS_TRUE(source->GetRowByOffset(0).GetAttrRow() == attrRow);
 }
 
 void TextBufferTests::TestBurrito()
@@ -2177,6 +2374,28 @@ void TextBufferTests::GetWordBoundaries()
     }
 }
 
+void TextBufferTests::GetWordBoundariesAfterModification()
+{
+    til::size bufferSize{ 80, 9001 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    WriteLinesToBuffer({ L"word other" }, *_buffer);
+
+    // The delimiter classes of a row are cached, so make sure that
+    // modifying the row or using other delimiters invalidates them.
+    const std::wstring_view delimiters = L" ";
+    VERIFY_ARE_EQUAL(til::point(5, 0), _buffer->GetWordStart({ 7, 0 }, delimiters, false));
+    VERIFY_ARE_EQUAL(til::point(9, 0), _buffer->GetWordEnd({ 7, 0 }, delimiters, false));
+
+    WriteLinesToBuffer({ L"word-other" }, *_buffer);
+    VERIFY_ARE_EQUAL(til::point(0, 0), _buffer->GetWordStart({ 7, 0 }, delimiters, false));
+    VERIFY_ARE_EQUAL(til::point(5, 0), _buffer->GetWordStart({ 7, 0 }, L" -", false));
+    VERIFY_ARE_EQUAL(til::point(9, 0), _buffer->GetWordEnd({ 2, 0 }, delimiters, false));
+    VERIFY_ARE_EQUAL(til::point(3, 0), _buffer->GetWordEnd({ 2, 0 }, L" -", false));
+}
+
 void TextBufferTests::MoveByWord()
 {
     til::size bufferSize{ 80, 9001 };
@@ -2374,6 +2593,16 @@ void TextBufferTests::GetTextRects()
     {
         VERIFY_ARE_EQUAL(expected.at(i), result.at(i));
     }
+
+    Log::Comment(L"Restricting the rows must return the same rects for just those rows.");
+    const auto clipped = _buffer->GetTextRects(start, end, blockSelection, false, 2, 30);
+    VERIFY_ARE_EQUAL(3u, clipped.size());
+    for (size_t i = 0; i < clipped.size(); ++i)
+    {
+        VERIFY_ARE_EQUAL(expected.at(i + 2), clipped.at(i));
+    }
+
+    VERIFY_ARE_EQUAL(0u, _buffer->GetTextRects(start, end, blockSelection, false, 10, 20).size());
 }
 
 void TextBufferTests::GetText()
@@ -2704,3 +2933,370 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// This tests that overwriting a hyperlink in a row keeps the following
+// trimming from assuming that the row still refers to it
+void TextBufferTests::HyperlinkTrimAfterOverwrite()
+{
+    // Set up a text buffer for us
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+    static constexpr std::wstring_view customId{ L"CustomId" };
+
+    // Set the same hyperlink id in three rows
+    const auto id = _buffer->GetHyperlinkId(url, customId);
+    TextAttribute newAttr{ 0x7f };
+    newAttr.SetHyperlinkId(id);
+    _buffer->GetRowByOffset(0).GetAttrRow().SetAttrToEnd(70, newAttr);
+    _buffer->GetRowByOffset(1).GetAttrRow().SetAttrToEnd(70, newAttr);
+    _buffer->GetRowByOffset(5).GetAttrRow().Replace(70, 75, newAttr);
+    _buffer->AddHyperlinkToMap(url, id);
+
+    const auto finalCustomId = fmt::format(L"{}%{}", customId, til::hash(url));
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(id), finalCustomId);
+
+    // The other rows still refer to the hyperlink
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
+
+    // Overwrite the hyperlink in the row that moved from offset 5 to 4, so that the row at the top holds the last reference
+    _buffer->GetRowByOffset(4).GetAttrRow().Replace(70, 75, attr);
+    VERIFY_ARE_EQUAL(_buffer->GetRowByOffset(4).GetAttrRow().GetHyperlinks().size(), 0u);
+    VERIFY_ARE_EQUAL(_buffer->GetRowByOffset(0).GetAttrRow().GetHyperlinks().size(), 1u);
+    _buffer->IncrementCircularBuffer();
+
+    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.find(id), _buffer->_hyperlinkMap.end());
+    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap.find(finalCustomId), _buffer->_hyperlinkCustomIdMap.end());
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(id), std::wstring{});
+}
+
+// This tests that URLs are found even if they wrap into the next row
+// and that changing a row updates the patterns cached for it
+void TextBufferTests::GetPatternsAcrossWrappedRows()
+{
+    const til::size bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    const auto id = _buffer->AddPatternRecognizer(TextBuffer::UrlPattern);
+
+    _buffer->WriteLine(OutputCellIterator{ L"see http:/", attr }, { 0, 0 }, true);
+    _buffer->WriteLine(OutputCellIterator{ L"/a.b/c ok", attr }, { 0, 1 }, false);
+    _buffer->WriteLine(OutputCellIterator{ L"ftp://x", attr }, { 0, 3 }, false);
+
+    const auto getPatterns = [&]() {
+        auto patterns = _buffer->GetPatterns(0, bufferSize.height - 1).findOverlapping({ 0, 0 }, { bufferSize.width - 1, bufferSize.height - 1 });
+        std::sort(patterns.begin(), patterns.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.start < rhs.start;
+        });
+        return patterns;
+    };
+
+    auto patterns = getPatterns();
+    VERIFY_ARE_EQUAL(2u, patterns.size());
+    VERIFY_ARE_EQUAL(til::point(4, 0), patterns.at(0).start);
+    VERIFY_ARE_EQUAL(til::point(6, 1), patterns.at(0).stop);
+    VERIFY_ARE_EQUAL(id, patterns.at(0).value);
+    VERIFY_ARE_EQUAL(til::point(0, 3), patterns.at(1).start);
+    VERIFY_ARE_EQUAL(til::point(7, 3), patterns.at(1).stop);
+
+    Log::Comment(L"Overwriting a row has to invalidate the patterns cached for it.");
+    _buffer->WriteLine(OutputCellIterator{ L"file://y/z", attr }, { 0, 3 }, false);
+
+    patterns = getPatterns();
+    VERIFY_ARE_EQUAL(2u, patterns.size());
+    VERIFY_ARE_EQUAL(til::point(0, 3), patterns.at(1).start);
+    VERIFY_ARE_EQUAL(til::point(0, 4), patterns.at(1).stop);
+}
+
+// This tests that the buffer reports the cells modified since the renderer last asked
+void TextBufferTests::ConsumeDirtyRows()
+{
+    const til::size bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    Log::Comment(L"A new buffer is dirty in its entirety.");
+    auto dirty = _buffer->ConsumeDirtyRows(0, bufferSize.height - 1);
+    VERIFY_ARE_EQUAL(5u, dirty.size());
+    VERIFY_ARE_EQUAL(til::rect(0, 4, 10, 5), dirty.at(4));
+    VERIFY_IS_TRUE(_buffer->ConsumeDirtyRows(0, bufferSize.height - 1).empty());
+
+    Log::Comment(L"Writes accumulate until the next call.");
+    _buffer->WriteLine(OutputCellIterator{ L"abc", attr }, { 2, 1 });
+    _buffer->WriteLine(OutputCellIterator{ L"d", attr }, { 7, 1 });
+    dirty = _buffer->ConsumeDirtyRows(0, bufferSize.height - 1);
+    VERIFY_ARE_EQUAL(1u, dirty.size());
+    VERIFY_ARE_EQUAL(til::rect(2, 1, 8, 2), dirty.at(0));
+
+    Log::Comment(L"Scrolled rows are dirty where they end up.");
+    _buffer->ScrollRows(1, 2, 1);
+    dirty = _buffer->ConsumeDirtyRows(0, bufferSize.height - 1);
+    VERIFY_ARE_EQUAL(3u, dirty.size());
+    VERIFY_ARE_EQUAL(til::rect(0, 1, 10, 2), dirty.at(0));
+    VERIFY_ARE_EQUAL(til::rect(0, 3, 10, 4), dirty.at(2));
+
+    Log::Comment(L"Rows outside of the requested range are considered painted.");
+    _buffer->WriteLine(OutputCellIterator{ L"e", attr }, { 0, 4 });
+    VERIFY_IS_TRUE(_buffer->ConsumeDirtyRows(0, 3).empty());
+    VERIFY_IS_TRUE(_buffer->ConsumeDirtyRows(0, bufferSize.height - 1).empty());
+}
+
+void TextBufferTests::ScrollRowsAcrossCircularBufferEnd()
+{
+    const til::size bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // Move the first row, so that the scrolled regions below wrap around the end of the storage.
+    for (auto i = 0; i < 3; ++i)
+    {
+        _buffer->IncrementCircularBuffer();
+    }
+    VERIFY_ARE_EQUAL(3, _buffer->GetFirstRowIndex());
+
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        const wchar_t ch[2]{ gsl::narrow_cast<wchar_t>(L'A' + y), 0 };
+        _buffer->WriteLine(OutputCellIterator{ ch, attr }, { 0, y });
+    }
+
+    const auto verifyRows = [&](const std::wstring_view expected) {
+        for (til::CoordType y = 0; y < bufferSize.height; ++y)
+        {
+            const auto text = *_buffer->GetTextDataAt({ 0, y });
+            VERIFY_ARE_EQUAL(String(&til::at(expected, y), 1), String(text.data(), gsl::narrow<int>(text.size())));
+
+            const auto& row = _buffer->GetRowByOffset(y);
+            VERIFY_ARE_EQUAL((_buffer->GetFirstRowIndex() + y) % bufferSize.height, row.GetId());
+        }
+    };
+
+    Log::Comment(L"Scrolling down part of the buffer.");
+    _buffer->ScrollRows(1, 3, 1);
+    verifyRows(L"AEBCD");
+
+    Log::Comment(L"Scrolling it back up again.");
+    _buffer->ScrollRows(2, 3, -1);
+    verifyRows(L"ABCDE");
+
+    Log::Comment(L"The first row is left where it was.");
+    VERIFY_ARE_EQUAL(3, _buffer->GetFirstRowIndex());
+}
+
+void TextBufferTests::FillRect()
+{
+    const til::size bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute fillAttr{ 0x1e };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // The fire emoji takes up 2 code units, so the fill has to move the text behind it.
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->WriteLine(OutputCellIterator{ L"abcdefghij", attr }, { 0, 0 });
+    _buffer->GetRowByOffset(0).GetCharRow().GlyphAt(3) = fire;
+    _buffer->WriteLine(OutputCellIterator{ L"klmnopqrst", attr }, { 0, 1 });
+    _buffer->GetRowByOffset(1).SetWrapForced(true);
+
+    Log::Comment(L"Filling part of the rows.");
+    _buffer->FillRect({ 2, 0, 5, 2 }, L'x', fillAttr);
+    VERIFY_ARE_EQUAL(String(L"abxxxfghij"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"klxxxpqrst"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(1).WasWrapForced());
+    for (til::CoordType x = 0; x < bufferSize.width; ++x)
+    {
+        const auto expected = x >= 2 && x < 5 ? fillAttr : attr;
+        VERIFY_ARE_EQUAL(expected, _buffer->GetCellDataAt({ x, 1 })->TextAttr());
+    }
+
+    Log::Comment(L"Filling entire rows, clipped to the buffer.");
+    _buffer->FillRect({ -5, 1, 20, 10 }, L' ', fillAttr);
+    VERIFY_ARE_EQUAL(String(L"abxxxfghij"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    for (til::CoordType y = 1; y < bufferSize.height; ++y)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        VERIFY_IS_FALSE(row.GetCharRow().ContainsText());
+        VERIFY_IS_FALSE(row.WasWrapForced());
+        VERIFY_ARE_EQUAL(fillAttr, _buffer->GetCellDataAt({ 0, y })->TextAttr());
+        VERIFY_ARE_EQUAL(fillAttr, _buffer->GetCellDataAt({ bufferSize.width - 1, y })->TextAttr());
+    }
+}
+
+void TextBufferTests::FillCells()
+{
+    const til::size bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute fillAttr{ 0x1e };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    _buffer->WriteLine(OutputCellIterator{ L"abcdefghij", attr }, { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"klmnopqrst", attr }, { 0, 1 });
+    _buffer->GetRowByOffset(0).SetWrapForced(true);
+
+    Log::Comment(L"Filling only the text keeps the attributes and continues in the next row.");
+    VERIFY_ARE_EQUAL(6u, _buffer->FillCells({ 7, 0 }, 6, L'x', std::nullopt));
+    VERIFY_ARE_EQUAL(String(L"abcdefgxxx"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"xxxnopqrst"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(0).WasWrapForced());
+    VERIFY_ARE_EQUAL(attr, _buffer->GetCellDataAt({ 8, 0 })->TextAttr());
+
+    Log::Comment(L"Filling only the attributes keeps the text and the wrap status.");
+    _buffer->GetRowByOffset(1).SetWrapForced(true);
+    VERIFY_ARE_EQUAL(4u, _buffer->FillCells({ 8, 1 }, 4, std::nullopt, fillAttr));
+    VERIFY_ARE_EQUAL(String(L"xxxnopqrst"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(1).WasWrapForced());
+    VERIFY_ARE_EQUAL(attr, _buffer->GetCellDataAt({ 7, 1 })->TextAttr());
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetCellDataAt({ 8, 1 })->TextAttr());
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetCellDataAt({ 1, 2 })->TextAttr());
+    VERIFY_ARE_EQUAL(attr, _buffer->GetCellDataAt({ 2, 2 })->TextAttr());
+
+    Log::Comment(L"The run is clipped to the end of the buffer.");
+    VERIFY_ARE_EQUAL(15u, _buffer->FillCells({ 5, 1 }, 100, L' ', fillAttr));
+    VERIFY_ARE_EQUAL(String(L"xxxno     "), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(2).GetCharRow().ContainsText());
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetCellDataAt({ 9, 2 })->TextAttr());
+}
+
+void TextBufferTests::ShiftCells()
+{
+    const til::size bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute otherAttr{ 0x1e };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    _buffer->WriteLine(OutputCellIterator{ L"abcdefghij", attr }, { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"fg", otherAttr }, { 5, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"klmnopqrst", attr }, { 0, 1 });
+
+    // The cells marked with an x are expected to have otherAttr.
+    const auto verifyAttrs = [&](const std::wstring_view expectedAttrs) {
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            const auto expected = til::at(expectedAttrs, x) == L'x' ? otherAttr : attr;
+            VERIFY_ARE_EQUAL(expected, _buffer->GetCellDataAt({ x, 0 })->TextAttr());
+        }
+    };
+
+    Log::Comment(L"Moving cells to the right, like ICH does.");
+    _buffer->ShiftCells({ 1, 0, 8, 1 }, 2);
+    VERIFY_ARE_EQUAL(String(L"abcbcdefgh"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"klmnopqrst"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    verifyAttrs(L".......xx.");
+
+    Log::Comment(L"Moving cells to the left, like DCH does. Vacated cells are left alone.");
+    _buffer->ShiftCells({ 3, 0, 10, 1 }, -2);
+    VERIFY_ARE_EQUAL(String(L"abcdefghgh"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    verifyAttrs(L".....xx.x.");
+
+    Log::Comment(L"Glyphs with more than one code unit are moved as a whole.");
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->GetRowByOffset(1).GetCharRow().GlyphAt(1) = fire;
+    _buffer->ShiftCells({ 0, 1, 9, 2 }, 1);
+    VERIFY_ARE_EQUAL(String(L"kk\xD83D\xDD25mnopqrs"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    _buffer->ShiftCells({ 2, 1, 10, 2 }, -2);
+    VERIFY_ARE_EQUAL(String(L"\xD83D\xDD25mnopqrsrs"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+}
+
+void TextBufferTests::MeasureRightTracksWrites()
+{
+    const til::size bufferSize{ 10, 1 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    auto& charRow = _buffer->GetRowByOffset(0).GetCharRow();
+
+    VERIFY_IS_FALSE(charRow.ContainsText());
+    VERIFY_ARE_EQUAL(bufferSize.width, charRow.MeasureLeft());
+
+    _buffer->WriteLine(OutputCellIterator{ L"abc", attr }, { 0, 0 });
+    VERIFY_ARE_EQUAL(3, charRow.MeasureRight());
+
+    Log::Comment(L"Clearing the last glyph has to find the glyph before it.");
+    _buffer->WriteLine(OutputCellIterator{ L"x", attr }, { 7, 0 });
+    VERIFY_ARE_EQUAL(8, charRow.MeasureRight());
+    charRow.ClearGlyph(7);
+    VERIFY_ARE_EQUAL(3, charRow.MeasureRight());
+
+    Log::Comment(L"Clearing glyphs in the middle of the row leaves the end alone.");
+    _buffer->WriteLine(OutputCellIterator{ L"x", attr }, { 7, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L' ', attr, 3 }, { 0, 0 });
+    VERIFY_ARE_EQUAL(7, charRow.MeasureLeft());
+    VERIFY_ARE_EQUAL(8, charRow.MeasureRight());
+
+    Log::Comment(L"Shifted glyphs are accounted for.");
+    _buffer->WriteLine(OutputCellIterator{ L"ab", attr }, { 0, 0 });
+    _buffer->ShiftCells({ 0, 0, 8, 1 }, 2);
+    VERIFY_ARE_EQUAL(String(L"abab     x"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+    VERIFY_ARE_EQUAL(10, charRow.MeasureRight());
+
+    _buffer->GetRowByOffset(0).Reset(attr);
+    VERIFY_IS_FALSE(charRow.ContainsText());
+    VERIFY_ARE_EQUAL(0, charRow.MeasureRight());
+}
+
+void TextBufferTests::SerializeRoundTrips()
+{
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute red{ 0x4c };
+    TextBuffer source{ { 10, 4 }, attr, cursorSize, false, _renderer };
+    source.WriteLine(OutputCellIterator{ L"abcdefghij", attr }, { 0, 0 });
+    source.WriteLine(OutputCellIterator{ L"XY", red }, { 2, 0 });
+    source.GetRowByOffset(0).SetWrapForced(true);
+    source.WriteLine(OutputCellIterator{ L"second", attr }, { 0, 1 });
+    source.WriteLine(OutputCellIterator{ L"third", attr }, { 0, 2 });
+    source.GetCursor().SetPosition({ 5, 2 });
+
+    std::vector<std::byte> snapshot;
+    source.Serialize(snapshot, 3);
+
+    Log::Comment(L"Restoring into a narrower buffer truncates the rows.");
+    {
+        TextBuffer target{ { 8, 4 }, attr, cursorSize, false, _renderer };
+        SnapshotReader reader{ snapshot };
+        const auto info = target.Deserialize(reader, 4);
+        VERIFY_IS_TRUE(info.has_value());
+        VERIFY_ARE_EQUAL(3, info->rows);
+        VERIFY_ARE_EQUAL(0, info->skippedRows);
+        VERIFY_ARE_EQUAL(til::point(5, 2), info->cursor);
+        VERIFY_ARE_EQUAL(0u, reader.Remaining().size());
+
+        const auto& row = target.GetRowByOffset(0);
+        VERIFY_ARE_EQUAL(String(L"abXYefgh"), String(row.GetText().c_str()));
+        VERIFY_IS_TRUE(row.WasWrapForced());
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(1));
+        VERIFY_ARE_EQUAL(red, row.GetAttrRow().GetAttrByColumn(2));
+        VERIFY_ARE_EQUAL(red, row.GetAttrRow().GetAttrByColumn(3));
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(4));
+        VERIFY_ARE_EQUAL(String(L"third   "), String(target.GetRowByOffset(2).GetText().c_str()));
+    }
+
+    Log::Comment(L"Only the last maxRows rows are restored.");
+    {
+        TextBuffer target{ { 10, 4 }, attr, cursorSize, false, _renderer };
+        SnapshotReader reader{ snapshot };
+        const auto info = target.Deserialize(reader, 2);
+        VERIFY_IS_TRUE(info.has_value());
+        VERIFY_ARE_EQUAL(2, info->rows);
+        VERIFY_ARE_EQUAL(1, info->skippedRows);
+        VERIFY_ARE_EQUAL(String(L"second    "), String(target.GetRowByOffset(0).GetText().c_str()));
+        VERIFY_ARE_EQUAL(String(L"third     "), String(target.GetRowByOffset(1).GetText().c_str()));
+    }
+
+    Log::Comment(L"A truncated snapshot is rejected.");
+    {
+        TextBuffer target{ { 10, 4 }, attr, cursorSize, false, _renderer };
+        SnapshotReader reader{ std::span{ snapshot }.first(snapshot.size() - 1) };
+        VERIFY_IS_FALSE(target.Deserialize(reader, 4).has_value());
+    }
+}
@@ -5,6 +5,7 @@
 #include "WexTestClass.h"
 #include "../../inc/consoletaeftemplates.hpp"
 
+#include "../../types/inc/GraphemeBreak.hpp"
 #include "../../types/inc/Utf16Parser.hpp"
 
 using namespace WEX::Common;
@@ -208,4 +209,105 @@ class Utf16ParserTests
 
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(RangeWalksCodepoints)
+    {
+        std::wstring wstr{ GaelicChar.at(0) };
+        wstr += SunglassesEmoji.at(1); // a lone trailing surrogate is dropped
+        wstr += SunglassesEmoji.at(0);
+        wstr += SunglassesEmoji.at(1);
+        wstr += HiraganaChar.at(0);
+        wstr += SunglassesEmoji.at(0); // so is a lone leading one at the end
+
+        std::vector<std::wstring_view> actual;
+        for (const auto codepoint : Utf16Parser::Range<&Utf16Parser::ParseNext>{ wstr })
+        {
+            actual.emplace_back(codepoint);
+        }
+
+        VERIFY_ARE_EQUAL(3u, actual.size());
+        VERIFY_ARE_EQUAL((std::wstring_view{ GaelicChar.data(), GaelicChar.size() }), actual.at(0));
+        VERIFY_ARE_EQUAL((std::wstring_view{ SunglassesEmoji.data(), SunglassesEmoji.size() }), actual.at(1));
+        VERIFY_ARE_EQUAL((std::wstring_view{ HiraganaChar.data(), HiraganaChar.size() }), actual.at(2));
+
+        // The views point into the parsed string.
+        VERIFY_ARE_EQUAL(wstr.data() + 2, actual.at(1).data());
+    }
+
+    TEST_METHOD(RangeWalksClusters)
+    {
+        std::vector<std::wstring_view> actual;
+        for (const auto cluster : Utf16Parser::Range<&GraphemeBreak::ParseNextCluster>{ L"e\x0301a\r\n" })
+        {
+            actual.emplace_back(cluster);
+        }
+
+        VERIFY_ARE_EQUAL(3u, actual.size());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"e\x0301" }, actual.at(0));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a" }, actual.at(1));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\r\n" }, actual.at(2));
+
+        const Utf16Parser::Range<&Utf16Parser::ParseNext> empty{ L"" };
+        VERIFY_IS_TRUE(empty.begin() == empty.end());
+    }
+
+    TEST_METHOD(ParseNextClusterSplitsAscii)
+    {
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a" }, GraphemeBreak::ParseNextCluster(L"ab"));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\r\n" }, GraphemeBreak::ParseNextCluster(L"\r\nb"));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\n" }, GraphemeBreak::ParseNextCluster(L"\n\r"));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a" }, GraphemeBreak::ParseNextCluster(L"a"));
+    }
+
+    TEST_METHOD(ParseNextClusterJoinsCombiningMarks)
+    {
+        // e with acute accent and dot below
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"e\x0301\x0323" }, GraphemeBreak::ParseNextCluster(L"e\x0301\x0323" L"f"));
+        // Devanagari ka with vowel sign i (a spacing mark)
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\x0915\x093F" }, GraphemeBreak::ParseNextCluster(L"\x0915\x093F\x0915"));
+        // Combining marks don't combine with controls.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\n" }, GraphemeBreak::ParseNextCluster(L"\n\x0301"));
+    }
+
+    TEST_METHOD(ParseNextClusterJoinsEmojiSequences)
+    {
+        // man, ZWJ, woman, ZWJ, girl
+        const std::wstring_view family{ L"\xD83D\xDC68\x200D\xD83D\xDC69\x200D\xD83D\xDC67" };
+        const auto wstr = std::wstring{ family } + L"a";
+        VERIFY_ARE_EQUAL(family, GraphemeBreak::ParseNextCluster(wstr));
+
+        // A ZWJ only joins an emoji to a preceding emoji.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a\x200D" }, GraphemeBreak::ParseNextCluster(L"a\x200D\xD83D\xDC69"));
+
+        // Regional indicators pair up into flags: DE, then US.
+        const std::wstring_view flags{ L"\xD83C\xDDE9\xD83C\xDDEA\xD83C\xDDFA\xD83C\xDDF8" };
+        VERIFY_ARE_EQUAL(flags.substr(0, 4), GraphemeBreak::ParseNextCluster(flags));
+        VERIFY_ARE_EQUAL(flags.substr(4), GraphemeBreak::ParseNextCluster(flags.substr(4)));
+    }
+
+    TEST_METHOD(ParseNextClusterJoinsHangulJamo)
+    {
+        // choseong kiyeok, jungseong a, jongseong kiyeok
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\x1100\x1161\x11A8" }, GraphemeBreak::ParseNextCluster(L"\x1100\x1161\x11A8\x1100"));
+        // The LV syllable ga followed by jongseong kiyeok, but not by another syllable.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\xAC00\x11A8" }, GraphemeBreak::ParseNextCluster(L"\xAC00\x11A8\xAC00"));
+        // The LVT syllable gag can't take another jungseong.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\xAC01" }, GraphemeBreak::ParseNextCluster(L"\xAC01\x1161"));
+    }
+
+    TEST_METHOD(ParseNextClusterHandlesBadSurrogates)
+    {
+        std::wstring wstr{ L"a" };
+        wstr += SunglassesEmoji.at(1);
+
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a" }, GraphemeBreak::ParseNextCluster(wstr));
+        VERIFY_ARE_EQUAL(Utf16Parser::ParseNext(wstr.substr(1)), GraphemeBreak::ParseNextCluster(wstr.substr(1)));
+    }
+
+    TEST_METHOD(ParseNextClusterLimitsLength)
+    {
+        const auto wstr = L"e" + std::wstring(GraphemeBreak::MaxClusterSize * 2, L'\x0301');
+
+        VERIFY_ARE_EQUAL(GraphemeBreak::MaxClusterSize, GraphemeBreak::ParseNextCluster(wstr).size());
+    }
 };
@@ -335,6 +335,16 @@ public:
         return std::vector<RenderOverlay>{};
     }
 
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleSelectionRects() noexcept override
+    {
+        return std::vector<Microsoft::Console::Types::Viewport>{};
+    }
+
+    std::vector<Microsoft::Console::Types::Viewport> GetVisibleHighlightRects() noexcept override
+    {
+        return std::vector<Microsoft::Console::Types::Viewport>{};
+    }
+
     const bool IsGridLineDrawingAllowed() noexcept override
     {
         return false;
@@ -382,6 +392,14 @@ public:
         return true;
     }
 
+    void LockConsoleForWriting() noexcept override
+    {
+    }
+
+    void UnlockConsoleForWriting() noexcept override
+    {
+    }
+
     const std::wstring GetHyperlinkUri(uint16_t /*id*/) const noexcept
     {
         return {};
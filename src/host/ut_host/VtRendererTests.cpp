@@ -83,6 +83,16 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(TestSynchronizingBuffer);
+
+    TEST_METHOD(TestAwaitingInheritedCursor);
+
+    TEST_METHOD(TestResizeInProgress);
+
+    TEST_METHOD(TestShadowFrame);
+
+    TEST_METHOD(TestScrollRegion);
+
     void Test16Colors(VtEngine* engine);
 
     std::deque<std::string> qExpectedInput;
@@ -1594,3 +1604,226 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormatted(bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::TestSynchronizingBuffer()
+{
+    auto view = SetUpViewport();
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), view);
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetPassthroughMode(true);
+
+    Log::Comment(L"While the buffer is being synchronized, nothing should be written or invalidated.");
+    engine->SetSynchronizingBuffer(true);
+    VERIFY_IS_TRUE(engine->IsSynchronizingBuffer());
+
+    VERIFY_SUCCEEDED(engine->WriteTerminalW(L"\x1b[2J"));
+    VERIFY_SUCCEEDED(engine->_WriteFill(4, ' '));
+    VERIFY_SUCCEEDED(engine->InvalidateAll());
+    VERIFY_SUCCEEDED(engine->InvalidateTitle(L"title"));
+
+    const til::rect cursor{ 1, 1, 2, 2 };
+    VERIFY_SUCCEEDED(engine->InvalidateCursor(&cursor));
+
+    const til::point delta{ 0, -1 };
+    VERIFY_SUCCEEDED(engine->InvalidateScroll(&delta));
+
+    auto forcePaint = true;
+    VERIFY_SUCCEEDED(engine->InvalidateFlush(true, &forcePaint));
+    VERIFY_IS_FALSE(forcePaint);
+
+    VERIFY_IS_FALSE(engine->_invalidMap.any());
+    VERIFY_ARE_EQUAL(til::point{}, engine->_scrollDelta);
+    VERIFY_IS_FALSE(engine->_cursorMoved);
+    VERIFY_IS_FALSE(engine->_titleChanged);
+
+    Log::Comment(L"Afterwards, writes should reach the terminal again.");
+    engine->SetSynchronizingBuffer(false);
+    VERIFY_IS_FALSE(engine->IsSynchronizingBuffer());
+
+    qExpectedInput.push_back("\x1b[2J");
+    VERIFY_SUCCEEDED(engine->WriteTerminalW(L"\x1b[2J"));
+    VerifyExpectedInputsDrained();
+}
+
+void VtRendererTest::TestAwaitingInheritedCursor()
+{
+    auto view = SetUpViewport();
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), view);
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    Log::Comment(L"While we're waiting for the cursor position, nothing should be painted.");
+    engine->SetAwaitingInheritedCursor(true);
+    const til::rect invalid{ 1, 1, 2, 2 };
+    VERIFY_SUCCEEDED(engine->Invalidate(&invalid));
+    VERIFY_ARE_EQUAL(S_FALSE, engine->StartPaint());
+
+    Log::Comment(L"The invalidated region should be kept for the next frame.");
+    VERIFY_IS_TRUE(engine->_invalidMap.any());
+
+    Log::Comment(L"Inheriting the cursor should resume painting.");
+    VERIFY_SUCCEEDED(engine->InheritCursor({ 0, 1 }));
+    VERIFY_ARE_EQUAL(S_OK, engine->StartPaint());
+    VERIFY_SUCCEEDED(engine->EndPaint());
+}
+
+void VtRendererTest::TestResizeInProgress()
+{
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+
+    const auto measureWait = [&]() {
+        const auto start = std::chrono::steady_clock::now();
+        engine->WaitUntilCanRender();
+        return std::chrono::steady_clock::now() - start;
+    };
+
+    Log::Comment(L"Without a resize, painting isn't held back beyond the usual frame pacing.");
+    VERIFY_IS_TRUE(measureWait() < VtEngine::RESIZE_SETTLE_DELAY);
+
+    Log::Comment(L"After a resize, painting waits for the resize to settle.");
+    engine->SetResizeInProgress();
+    VERIFY_IS_TRUE(measureWait() >= VtEngine::RESIZE_SETTLE_DELAY / 2);
+    VERIFY_IS_TRUE(measureWait() < VtEngine::RESIZE_SETTLE_DELAY);
+
+    Log::Comment(L"A resize that keeps going doesn't hold painting back for longer than the limit.");
+    std::atomic<bool> resizing{ true };
+    std::thread resizer{ [&]() {
+        while (resizing.load())
+        {
+            engine->SetResizeInProgress();
+            Sleep(1);
+        }
+    } };
+    const auto waited = measureWait();
+    resizing.store(false);
+    resizer.join();
+    VERIFY_IS_TRUE(waited >= VtEngine::RESIZE_MAX_PAINT_DELAY);
+    VERIFY_IS_TRUE(waited < VtEngine::RESIZE_MAX_PAINT_DELAY * 4);
+}
+
+void VtRendererTest::TestShadowFrame()
+{
+    auto view = SetUpViewport();
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), view);
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    // The renderer calls UpdateViewport before the first frame, which sets up the shadow frame.
+    VERIFY_SUCCEEDED(engine->UpdateViewport(view.ToInclusive()));
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<size_t>(view.Width() * view.Height()), engine->_shadowFrame.size());
+
+    VerifyFirstPaint(*engine);
+
+    const auto paintLine = [&](const std::wstring_view line) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            clusters.emplace_back(line.substr(i, 1), 1);
+        }
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ clusters.data(), clusters.size() }, { 0, 0 }, false, false));
+    };
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"The first time around the entire line should be painted.");
+        qExpectedInput.push_back("\x1b[H");
+        VERIFY_SUCCEEDED(engine->_MoveCursor({ 0, 0 }));
+        qExpectedInput.push_back("abcdefghijklmnop");
+        paintLine(L"abcdefghijklmnop");
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Only the changed cell should be painted.");
+        qExpectedInput.push_back("\x1b[1;7H");
+        qExpectedInput.push_back("X");
+        paintLine(L"abcdefXhijklmnop");
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Nothing changed, so nothing should be painted.");
+        paintLine(L"abcdefXhijklmnop");
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"The unchanged cells between two changes should be skipped with a cursor movement.");
+        qExpectedInput.push_back("\x1b[1;2H");
+        qExpectedInput.push_back("Y");
+        qExpectedInput.push_back("\x1b[12C");
+        qExpectedInput.push_back("Z");
+        paintLine(L"aYcdefXhijklmnZp");
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"After clearing the screen we don't know anything about its contents.");
+        qExpectedInput.push_back("\x1b[2J");
+        VERIFY_SUCCEEDED(engine->_ClearScreen());
+        qExpectedInput.push_back("\x1b[H");
+        qExpectedInput.push_back("aYcdefXhijklmnZp");
+        paintLine(L"aYcdefXhijklmnZp");
+    });
+
+    VerifyExpectedInputsDrained();
+}
+
+void VtRendererTest::TestScrollRegion()
+{
+    const auto view = SetUpViewport();
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), view);
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    VerifyFirstPaint(*engine);
+
+    const til::rect region{ 0, 2, view.Width(), 6 };
+
+    Log::Comment(L"Scrolling inside of the margins should only invalidate the revealed row.");
+    VERIFY_ARE_EQUAL(S_OK, engine->InvalidateScrollRegion(region, -1));
+    TestPaint(*engine, [&]() {
+        const auto runs = engine->_invalidMap.runs();
+        VERIFY_ARE_EQUAL(1u, runs.size());
+        VERIFY_ARE_EQUAL((til::rect{ 0, 5, view.Width(), 6 }), runs.front());
+
+        qExpectedInput.push_back("\x1b[3;6r");
+        qExpectedInput.push_back("\x1b[S");
+        qExpectedInput.push_back("\x1b[r");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), engine->_lastText);
+    });
+
+    Log::Comment(L"Scrolls in the same direction add up and invalid cells move with the contents.");
+    til::rect invalid{ 0, 3, 1, 4 };
+    VERIFY_SUCCEEDED(engine->Invalidate(&invalid));
+    VERIFY_ARE_EQUAL(S_OK, engine->InvalidateScrollRegion(region, 1));
+    VERIFY_ARE_EQUAL(S_OK, engine->InvalidateScrollRegion(region, 1));
+    TestPaint(*engine, [&]() {
+        const auto runs = engine->_invalidMap.runs();
+        VERIFY_ARE_EQUAL(3u, runs.size());
+        VERIFY_ARE_EQUAL((til::rect{ 0, 2, view.Width(), 3 }), runs[0]);
+        VERIFY_ARE_EQUAL((til::rect{ 0, 3, view.Width(), 4 }), runs[1]);
+        VERIFY_ARE_EQUAL((til::rect{ 0, 5, 1, 6 }), runs[2]);
+
+        qExpectedInput.push_back("\x1b[3;6r");
+        qExpectedInput.push_back("\x1b[2T");
+        qExpectedInput.push_back("\x1b[r");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+
+    Log::Comment(L"Other regions and partial rows can't be moved in the same frame.");
+    VERIFY_ARE_EQUAL(S_OK, engine->InvalidateScrollRegion(region, -1));
+    VERIFY_ARE_EQUAL(S_FALSE, engine->InvalidateScrollRegion({ 0, 1, view.Width(), 4 }, -1));
+    VERIFY_ARE_EQUAL(S_FALSE, engine->InvalidateScrollRegion(region, 1));
+    VERIFY_ARE_EQUAL(S_FALSE, engine->InvalidateScrollRegion({ 1, 2, view.Width(), 6 }, -1));
+    TestPaint(*engine, [&]() {
+        qExpectedInput.push_back("\x1b[3;6r");
+        qExpectedInput.push_back("\x1b[S");
+        qExpectedInput.push_back("\x1b[r");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+
+    VerifyExpectedInputsDrained();
+}
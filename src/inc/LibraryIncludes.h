@@ -79,6 +79,7 @@
 
 // Boost
 #include "boost/container/small_vector.hpp"
+#include "boost/container/static_vector.hpp"
 
 // IntSafe
 #define ENABLE_INTSAFE_SIGNED_FUNCTIONS
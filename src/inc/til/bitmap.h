@@ -23,8 +23,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             using pointer = const til::rect*;
             using reference = const til::rect&;
 
-            _bitmap_const_iterator(const dynamic_bitset<unsigned long long, Allocator>& values, til::rect rc, ptrdiff_t pos) :
+            _bitmap_const_iterator(const dynamic_bitset<unsigned long long, Allocator>& values,
+                                   const dynamic_bitset<unsigned long long, Allocator>& dirtyRows,
+                                   const dynamic_bitset<unsigned long long, Allocator>& fullRows,
+                                   til::rect rc,
+                                   ptrdiff_t pos) :
                 _values(values),
+                _dirtyRows(dirtyRows),
+                _fullRows(fullRows),
                 _rc(rc),
                 _pos(pos),
                 _end(rc.size().area())
@@ -78,6 +84,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
         private:
             const dynamic_bitset<unsigned long long, Allocator>& _values;
+            const dynamic_bitset<unsigned long long, Allocator>& _dirtyRows;
+            const dynamic_bitset<unsigned long long, Allocator>& _fullRows;
             const til::rect _rc;
             size_t _pos;
             size_t _nextPos;
@@ -90,11 +98,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
                 // The following logic first finds the next set bit in this bitmap and the next unset bit past that.
                 // The area in between those positions are thus all set bits and will end up being the next _run.
-
-                // dynamic_bitset allows you to quickly find the next set bit using find_next(prev),
-                // where "prev" is the position _past_ which should be searched (i.e. excluding position "prev").
-                // If _pos is still 0, we thus need to use the counterpart find_first().
-                _nextPos = _pos == 0 ? _values.find_first() : _values.find_next(_pos - 1);
+                _nextPos = _findNextSetBit(_pos);
 
                 // If we haven't reached the end yet...
                 if (_nextPos < _end)
@@ -111,13 +115,22 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     // Find the length for the rectangle.
                     size_t runLength = 0;
 
-                    // We have at least 1 so start with a do/while.
-                    do
+                    if (_fullRows[static_cast<size_t>(runStart.y)])
                     {
-                        ++_nextPos;
-                        ++runLength;
-                    } while (_nextPos < rowEndIndex && _values[_nextPos]);
-                    // Keep going until we reach end of row, end of the buffer, or the next bit is off.
+                        // The entire row is known to be set, so we don't need to test its bits one by one.
+                        runLength = rowEndIndex - _nextPos;
+                        _nextPos = rowEndIndex;
+                    }
+                    else
+                    {
+                        // We have at least 1 so start with a do/while.
+                        do
+                        {
+                            ++_nextPos;
+                            ++runLength;
+                        } while (_nextPos < rowEndIndex && _values[_nextPos]);
+                        // Keep going until we reach end of row, end of the buffer, or the next bit is off.
+                    }
 
                     // Assemble and store that run.
                     _run = til::rect{ runStart, til::size{ base::saturated_cast<CoordType>(runLength), 1 } };
@@ -131,6 +144,33 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     _run = til::rect{};
                 }
             }
+
+            // Returns the position of the first set bit at or past pos, or a value >= _end if there's none.
+            size_t _findNextSetBit(size_t pos) const
+            {
+                if (pos >= _end)
+                {
+                    return _end;
+                }
+
+                // Rows without any set bits are skipped using the row summary,
+                // instead of scanning through all of their bits.
+                const auto width = static_cast<size_t>(_rc.width());
+                const auto row = pos / width;
+                if (!_dirtyRows[row])
+                {
+                    const auto nextRow = _dirtyRows.find_next(row);
+                    if (nextRow >= _dirtyRows.size())
+                    {
+                        return _end;
+                    }
+                    pos = nextRow * width;
+                }
+
+                // dynamic_bitset allows you to quickly find the next set bit using find_next(prev),
+                // where "prev" is the position _past_ which should be searched (i.e. excluding position "prev").
+                return _values[pos] ? pos : _values.find_next(pos);
+            }
         };
 
         template<typename Allocator = std::allocator<unsigned long long>>
@@ -149,6 +189,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{},
                 _rc{},
                 _bits{ _alloc },
+                _dirtyRows{ _alloc },
+                _fullRows{ _alloc },
                 _runs{ _alloc }
             {
             }
@@ -172,9 +214,17 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _alloc{ allocator },
                 _sz(sz),
                 _rc(sz),
-                _bits(_sz.area(), fill ? std::numeric_limits<unsigned long long>::max() : 0, _alloc),
+                _bits(_sz.area(), 0, _alloc),
+                _dirtyRows(_summarySize(_sz), 0, _alloc),
+                _fullRows(_summarySize(_sz), 0, _alloc),
                 _runs{ _alloc }
             {
+                // The init_val parameter of dynamic_bitset only initializes the first block,
+                // so we can't use it to fill bitmaps with more than 64 bits.
+                if (fill)
+                {
+                    set_all();
+                }
             }
 
             bitmap(til::size sz, bool fill) :
@@ -187,6 +237,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ other._sz },
                 _rc{ other._rc },
                 _bits{ other._bits },
+                _dirtyRows{ other._dirtyRows },
+                _fullRows{ other._fullRows },
                 _runs{ other._runs }
             {
                 // copy constructor is required to call select_on_container_copy
@@ -201,6 +253,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz = other._sz;
                 _rc = other._rc;
                 _bits = other._bits;
+                _dirtyRows = other._dirtyRows;
+                _fullRows = other._fullRows;
                 _runs = other._runs;
                 return *this;
             }
@@ -210,6 +264,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ std::move(other._sz) },
                 _rc{ std::move(other._rc) },
                 _bits{ std::move(other._bits) },
+                _dirtyRows{ std::move(other._dirtyRows) },
+                _fullRows{ std::move(other._fullRows) },
                 _runs{ std::move(other._runs) }
             {
             }
@@ -221,6 +277,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     _alloc = std::move(other._alloc);
                 }
                 _bits = std::move(other._bits);
+                _dirtyRows = std::move(other._dirtyRows);
+                _fullRows = std::move(other._fullRows);
                 _runs = std::move(other._runs);
                 _sz = std::move(other._sz);
                 _rc = std::move(other._rc);
@@ -236,6 +294,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     std::swap(_alloc, other._alloc);
                 }
                 std::swap(_bits, other._bits);
+                std::swap(_dirtyRows, other._dirtyRows);
+                std::swap(_fullRows, other._fullRows);
                 std::swap(_runs, other._runs);
                 std::swap(_sz, other._sz);
                 std::swap(_rc, other._rc);
@@ -246,7 +306,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 return _sz == other._sz &&
                        _rc == other._rc &&
                        _bits == other._bits;
-                // _runs excluded because it's a cache of generated state.
+                // _dirtyRows, _fullRows and _runs excluded because they're summaries of _bits.
             }
 
             constexpr bool operator!=(const bitmap& other) const noexcept
@@ -256,12 +316,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             const_iterator begin() const
             {
-                return const_iterator(_bits, til::rect{ _sz }, 0);
+                return const_iterator(_bits, _dirtyRows, _fullRows, til::rect{ _sz }, 0);
             }
 
             const_iterator end() const
             {
-                return const_iterator(_bits, til::rect{ _sz }, _sz.area());
+                return const_iterator(_bits, _dirtyRows, _fullRows, til::rect{ _sz }, _sz.area());
             }
 
             const gsl::span<const til::rect> runs() const
@@ -355,6 +415,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _runs.reset(); // reset cached runs on any non-const method
 
                 _bits.set(_rc.index_of(pt));
+                _dirtyRows.set(static_cast<size_t>(pt.y));
             }
 
             void set(const til::rect& rc)
@@ -362,22 +423,37 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(rc));
                 _runs.reset(); // reset cached runs on any non-const method
 
+                if (rc.empty())
+                {
+                    return;
+                }
+
                 for (auto row = rc.top; row < rc.bottom; ++row)
                 {
                     _bits.set(_rc.index_of(til::point{ rc.left, row }), rc.width(), true);
                 }
+
+                _dirtyRows.set(static_cast<size_t>(rc.top), static_cast<size_t>(rc.height()), true);
+                if (rc.left == 0 && rc.right == _sz.width)
+                {
+                    _fullRows.set(static_cast<size_t>(rc.top), static_cast<size_t>(rc.height()), true);
+                }
             }
 
             void set_all() noexcept
             {
                 _runs.reset(); // reset cached runs on any non-const method
                 _bits.set();
+                _dirtyRows.set();
+                _fullRows.set();
             }
 
             void reset_all() noexcept
             {
                 _runs.reset(); // reset cached runs on any non-const method
                 _bits.reset();
+                _dirtyRows.reset();
+                _fullRows.reset();
             }
 
             // True if we resized. False if it was the same size as before.
@@ -445,7 +521,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool none() const noexcept
             {
-                return _bits.none();
+                // Every set bit marks its row as dirty, so the row summary is enough to answer this.
+                return _dirtyRows.none();
             }
 
             constexpr bool all() const noexcept
@@ -474,6 +551,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
         private:
+            // A bitmap without columns has no bits, so its rows must not be marked dirty either.
+            static constexpr size_t _summarySize(const til::size sz) noexcept
+            {
+                return sz.width > 0 ? static_cast<size_t>(sz.height) : 0;
+            }
+
             void translate_y(ptrdiff_t delta_y, bool fill)
             {
                 if (delta_y == 0)
@@ -487,6 +570,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 // we can't depend on GSL here, so we use static_cast for explicit narrowing
 #pragma warning(disable : 26472)
                 const auto newBits = static_cast<size_t>(std::abs(bitShift));
+                const auto newRows = static_cast<size_t>(std::abs(delta_y));
 #pragma warning(pop)
                 const bool isLeftShift = bitShift > 0;
 
@@ -508,10 +592,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     // This operator doesn't modify the size of `_bits`: the
                     // new bits are set to 0.
                     _bits <<= newBits;
+                    _dirtyRows <<= newRows;
+                    _fullRows <<= newRows;
                 }
                 else
                 {
                     _bits >>= newBits;
+                    _dirtyRows >>= newRows;
+                    _fullRows >>= newRows;
                 }
 
                 if (fill)
@@ -519,10 +607,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     if (isLeftShift)
                     {
                         _bits.set(0, newBits, true);
+                        _dirtyRows.set(0, newRows, true);
+                        _fullRows.set(0, newRows, true);
                     }
                     else
                     {
                         _bits.set(_bits.size() - newBits, newBits, true);
+                        _dirtyRows.set(_dirtyRows.size() - newRows, newRows, true);
+                        _fullRows.set(_fullRows.size() - newRows, newRows, true);
                     }
                 }
 
@@ -534,6 +626,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             til::rect _rc;
             dynamic_bitset<unsigned long long, allocator_type> _bits;
 
+            // Summaries of _bits with one bit per row, which let us skip over clean rows and fully dirty rows
+            // without looking at their individual bits. A row is marked dirty if any of its bits are set.
+            // It's marked full if all of its bits were set at once, by set_all() or a rect spanning the whole row.
+            dynamic_bitset<unsigned long long, allocator_type> _dirtyRows;
+            dynamic_bitset<unsigned long long, allocator_type> _fullRows;
+
             mutable std::optional<std::vector<til::rect, run_allocator_type>> _runs;
 
 #ifdef UNIT_TESTING
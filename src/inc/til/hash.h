@@ -285,6 +285,20 @@ namespace til
         h.write(data, len);
         return h.finalize();
     }
+
+    // A hash functor for std::unordered_map/set with std::basic_string keys. Together with std::equal_to<>
+    // it allows you to look up keys via std::basic_string_view without constructing a std::basic_string first.
+    // Strings and string views with identical contents produce identical hashes.
+    template<typename T>
+    struct transparent_string_hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const std::basic_string_view<T> v) const noexcept
+        {
+            return til::hash(v);
+        }
+    };
 }
 
 #pragma warning(pop)
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <condition_variable>
+
+// til: Terminal Implementation Library. Also: "Today I Learned".
+// mpsc: Multi Producer Single Consumer. A MPSC queue/channel sends byte chunks from any number of senders to one receiver.
+//
+// Unlike til::spsc this channel doesn't hold individual items. Each push() appends a variable-sized chunk of bytes
+// to a single contiguous buffer and pop_all() swaps that buffer with the consumer's one. The consumer thus receives
+// everything that was written since the last call as one span, without copying or moving individual chunks around.
+// Chunks are never interleaved with each other, but the consumer can't tell where one chunk ends and the next begins.
+namespace til::mpsc
+{
+    namespace details
+    {
+        struct shared_state
+        {
+            explicit shared_state(size_t capacity) noexcept :
+                capacity(capacity)
+            {
+            }
+
+            std::mutex mutex;
+            // readable is signaled when data was pushed or the last producer is gone.
+            // writable is signaled when the buffer was drained or the consumer is gone.
+            std::condition_variable readable;
+            std::condition_variable writable;
+            std::vector<std::byte> buffer;
+            const size_t capacity;
+            size_t producers = 1;
+            bool consumerAlive = true;
+        };
+    }
+
+    struct producer
+    {
+        explicit producer(std::shared_ptr<details::shared_state> state) noexcept :
+            _state(std::move(state)) {}
+
+        // Unlike til::spsc::producer, this producer may be copied to get additional producers.
+        producer(const producer& other) :
+            _state(other._state)
+        {
+            if (_state)
+            {
+                std::lock_guard lock{ _state->mutex };
+                ++_state->producers;
+            }
+        }
+
+        producer& operator=(const producer& other)
+        {
+            if (this != &other)
+            {
+                auto copy{ other };
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        producer(producer&& other) noexcept :
+            _state(std::exchange(other._state, nullptr))
+        {
+        }
+
+        producer& operator=(producer&& other) noexcept
+        {
+            drop();
+            _state = std::exchange(other._state, nullptr);
+            return *this;
+        }
+
+        ~producer()
+        {
+            drop();
+        }
+
+        // push appends the given chunk to the end of the queue.
+        // If the queue is full it blocks until the consumer drained it. A chunk that is larger than the
+        // queue's capacity is accepted as soon as the queue is empty, instead of blocking forever.
+        // The return value will be false, if the consumer is gone.
+        bool push(const std::span<const std::byte> chunk) const
+        {
+            std::unique_lock lock{ _state->mutex };
+
+            _state->writable.wait(lock, [&]() {
+                const auto used = _state->buffer.size();
+                return !_state->consumerAlive || used == 0 || chunk.size() <= _state->capacity - std::min(used, _state->capacity);
+            });
+
+            if (!_state->consumerAlive)
+            {
+                return false;
+            }
+
+            const auto wasEmpty = _state->buffer.empty();
+            _state->buffer.insert(_state->buffer.end(), chunk.begin(), chunk.end());
+            lock.unlock();
+
+            // The consumer only waits while the buffer is empty,
+            // so we only need to wake it up for the first chunk of a batch.
+            if (wasEmpty)
+            {
+                _state->readable.notify_one();
+            }
+            return true;
+        }
+
+        bool push(const std::string_view chunk) const
+        {
+            return push(std::as_bytes(std::span{ chunk }));
+        }
+
+    private:
+        void drop()
+        {
+            if (!_state)
+            {
+                return;
+            }
+
+            bool last;
+            {
+                std::lock_guard lock{ _state->mutex };
+                last = --_state->producers == 0;
+            }
+
+            if (last)
+            {
+                _state->readable.notify_one();
+            }
+
+            _state.reset();
+        }
+
+        std::shared_ptr<details::shared_state> _state;
+    };
+
+    struct consumer
+    {
+        explicit consumer(std::shared_ptr<details::shared_state> state) noexcept :
+            _state(std::move(state)) {}
+
+        consumer(const consumer&) = delete;
+        consumer& operator=(const consumer&) = delete;
+
+        consumer(consumer&& other) noexcept :
+            _state(std::exchange(other._state, nullptr)),
+            _batch(std::move(other._batch))
+        {
+        }
+
+        consumer& operator=(consumer&& other) noexcept
+        {
+            drop();
+            _state = std::exchange(other._state, nullptr);
+            _batch = std::move(other._batch);
+            return *this;
+        }
+
+        ~consumer()
+        {
+            drop();
+        }
+
+        // pop_all blocks until at least one chunk was pushed and returns all chunks pushed since the last call.
+        // The returned span stays valid until the next call to pop_all()/try_pop_all().
+        // An empty span is returned once all producers are gone and the queue has been drained.
+        std::span<const std::byte> pop_all()
+        {
+            return _pop_all(true);
+        }
+
+        // try_pop_all is the non-blocking variant of pop_all() and returns an empty span if the queue is empty.
+        std::span<const std::byte> try_pop_all()
+        {
+            return _pop_all(false);
+        }
+
+    private:
+        std::span<const std::byte> _pop_all(const bool blocking)
+        {
+            // The previous batch has been consumed by now. clear() retains
+            // the allocation, which we'll hand over to the producers below.
+            _batch.clear();
+
+            {
+                std::unique_lock lock{ _state->mutex };
+
+                if (blocking)
+                {
+                    _state->readable.wait(lock, [&]() {
+                        return !_state->buffer.empty() || _state->producers == 0;
+                    });
+                }
+
+                _batch.swap(_state->buffer);
+            }
+
+            if (!_batch.empty())
+            {
+                _state->writable.notify_all();
+            }
+            return { _batch.data(), _batch.size() };
+        }
+
+        void drop()
+        {
+            if (!_state)
+            {
+                return;
+            }
+
+            {
+                std::lock_guard lock{ _state->mutex };
+                _state->consumerAlive = false;
+            }
+
+            _state->writable.notify_all();
+            _state.reset();
+        }
+
+        std::shared_ptr<details::shared_state> _state;
+        std::vector<std::byte> _batch;
+    };
+
+    // channel returns a bounded, multi-producer, single-consumer FIFO queue ("channel") of byte chunks.
+    // The capacity is the amount of bytes after which producers block until the consumer drained the queue.
+    inline std::pair<producer, consumer> channel(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument{ "invalid capacity" };
+        }
+
+        const auto state = std::make_shared<details::shared_state>(capacity);
+        state->buffer.reserve(capacity);
+        return { std::piecewise_construct, std::forward_as_tuple(state), std::forward_as_tuple(state) };
+    }
+}
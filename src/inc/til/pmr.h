@@ -70,4 +70,53 @@ namespace til::pmr
         return std::pmr::get_default_resource();
     }
 #endif
+
+    // A memory resource that forwards to another one and counts how much it
+    // allocated. It's meant to check that containers, which are supposed to
+    // be reused without reallocating, actually stop allocating eventually.
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit counting_resource(std::pmr::memory_resource* upstream = get_default_resource()) noexcept :
+            _upstream{ upstream }
+        {
+        }
+
+        // The number of allocations made so far.
+        [[nodiscard]] size_t allocations() const noexcept
+        {
+            return _allocations.load(std::memory_order_relaxed);
+        }
+
+        // The number of bytes that are currently allocated.
+        [[nodiscard]] size_t bytes() const noexcept
+        {
+            return _bytes.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void* do_allocate(const size_t bytes, const size_t align) override
+        {
+            const auto ptr = _upstream->allocate(bytes, align);
+            _allocations.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        void do_deallocate(void* const ptr, const size_t bytes, const size_t align) override
+        {
+            _upstream->deallocate(ptr, bytes, align);
+            _bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        std::pmr::memory_resource* _upstream;
+        // Only the thread using the containers changes these, but anyone may read them.
+        std::atomic<size_t> _allocations{ 0 };
+        std::atomic<size_t> _bytes{ 0 };
+    };
 }
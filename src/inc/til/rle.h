@@ -449,6 +449,35 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             return { std::move(slice), static_cast<size_type>(end_index - start_index) };
         }
 
+        // Calls func(value, length) for every run in the range [start_index, end_index),
+        // with the first and last run cut off to fit into that range.
+        // Unlike slice() this doesn't copy any runs.
+        // If end_index is larger than size() it's set to size().
+        template<typename F>
+        void for_each_run(size_type start_index, size_type end_index, F&& func) const
+        {
+            if (end_index > _total_length)
+            {
+                end_index = _total_length;
+            }
+
+            if (start_index >= end_index)
+            {
+                return;
+            }
+
+            rle_scanner scanner(_runs.begin(), _runs.end());
+            auto [it, pos] = scanner.scan(start_index);
+
+            for (auto remaining = static_cast<size_type>(end_index - start_index); remaining != 0; ++it)
+            {
+                const auto length = std::min(static_cast<size_type>(it->length - pos), remaining);
+                func(it->value, length);
+                remaining -= length;
+                pos = 0;
+            }
+        }
+
         // Replace the range [start_index, end_index) with the given value.
         // If end_index is larger than size() it's set to size().
         // start_index must be smaller or equal to end_index.
@@ -491,6 +520,18 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             _compact();
         }
 
+        // Replaces every value in this vector with func(value).
+        template<typename F>
+        void transform_values(F&& func)
+        {
+            for (auto& run : _runs)
+            {
+                run.value = func(run.value);
+            }
+
+            _compact();
+        }
+
         // Adjust the size of the vector.
         // If the size is being increased, the last run is extended to fill up the new vector size.
         // If the size is being decreased, the trailing runs are cut off to fit.
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <condition_variable>
+
 namespace til
 {
     namespace details
@@ -79,10 +81,186 @@ namespace til
         private:
             std::atomic<bool> _isPending;
         };
+
+        // Creating a threadpool timer for every throttled_func adds up once there are
+        // hundreds of them, for instance with a few for every pane. Instead, all
+        // throttled_func instances share this single timer, which keeps track of
+        // when each of them is due and invokes them on the threadpool.
+        class throttled_func_timer
+        {
+        public:
+            using clock = std::chrono::steady_clock;
+            using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+
+            class client
+            {
+            public:
+                // Low priority clients are invoked after all other pending threadpool callbacks.
+                explicit client(const bool lowPriority = false) noexcept :
+                    _lowPriority{ lowPriority }
+                {
+                }
+
+                virtual ~client() = default;
+                virtual void timer_fired() = 0;
+
+            private:
+                friend class throttled_func_timer;
+
+                const bool _lowPriority;
+                clock::time_point _due;
+                DWORD _firingThread = 0;
+                bool _scheduled = false;
+                bool _firing = false;
+                bool _canceled = false;
+            };
+
+            static throttled_func_timer& instance()
+            {
+                // Leaked on purpose, because throttled_func instances may outlive function-local statics
+                // during process exit, at which point we couldn't wait for threadpool callbacks anymore.
+                static const auto timer = new throttled_func_timer();
+                return *timer;
+            }
+
+            // Invokes c.timer_fired() on the threadpool after the given delay.
+            // If c is already scheduled, its due time is moved.
+            void schedule(client& c, const clock::duration delay)
+            {
+                const std::lock_guard guard{ _lock };
+                c._due = clock::now() + delay;
+                if (!c._scheduled)
+                {
+                    c._scheduled = true;
+                    _clients.emplace_back(&c);
+                }
+                if (c._due < _armedDue)
+                {
+                    _arm(c._due);
+                }
+            }
+
+            // Ensures that c.timer_fired() isn't going to be called anymore and waits for a running
+            // invocation to finish - unless it's called from within that invocation. Afterwards
+            // the client may be scheduled again or destroyed.
+            void cancel(client& c)
+            {
+                std::unique_lock guard{ _lock };
+                if (c._scheduled)
+                {
+                    c._scheduled = false;
+                    std::erase(_clients, &c);
+                }
+                if (c._firing && c._firingThread != GetCurrentThreadId())
+                {
+                    c._canceled = true;
+                    _idle.wait(guard, [&]() { return !c._firing; });
+                    c._canceled = false;
+                }
+            }
+
+        private:
+            throttled_func_timer() :
+                _timer{ CreateThreadpoolTimer(&_timer_callback, this, nullptr) }
+            {
+                THROW_LAST_ERROR_IF(!_timer);
+
+                InitializeThreadpoolEnvironment(&_lowPriorityEnvironment);
+                SetThreadpoolCallbackPriority(&_lowPriorityEnvironment, TP_CALLBACK_PRIORITY_LOW);
+            }
+
+            static void __stdcall _timer_callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+            try
+            {
+                static_cast<throttled_func_timer*>(context)->_submit_due_clients();
+            }
+            CATCH_LOG()
+
+            static void __stdcall _work_callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context) noexcept
+            {
+                instance()._fire(*static_cast<client*>(context));
+            }
+
+            void _submit_due_clients()
+            {
+                const std::lock_guard guard{ _lock };
+                const auto now = clock::now();
+                auto next = clock::time_point::max();
+
+                _armedDue = clock::time_point::max();
+                std::erase_if(_clients, [&](client* c) {
+                    if (c->_due > now)
+                    {
+                        next = std::min(next, c->_due);
+                        return false;
+                    }
+
+                    // Each client gets its own callback, so that a slow one can't hold up all others.
+                    c->_scheduled = false;
+                    c->_firing = true;
+                    if (!TrySubmitThreadpoolCallback(&_work_callback, c, c->_lowPriority ? &_lowPriorityEnvironment : nullptr))
+                    {
+                        LOG_LAST_ERROR();
+                        c->_firing = false;
+                    }
+                    return true;
+                });
+
+                if (next != clock::time_point::max())
+                {
+                    _arm(next);
+                }
+            }
+
+            void _fire(client& c) noexcept
+            {
+                bool canceled;
+                {
+                    const std::lock_guard guard{ _lock };
+                    canceled = c._canceled;
+                    c._firingThread = GetCurrentThreadId();
+                }
+
+                if (!canceled)
+                {
+                    try
+                    {
+                        c.timer_fired();
+                    }
+                    CATCH_LOG()
+                }
+
+                {
+                    const std::lock_guard guard{ _lock };
+                    c._firing = false;
+                    c._firingThread = 0;
+                }
+                _idle.notify_all();
+            }
+
+            void _arm(const clock::time_point due) noexcept
+            {
+                // Negative due times are relative to now. Keep it strictly negative, even if it's overdue.
+                const auto ticks = std::chrono::duration_cast<filetime_duration>(due - clock::now()).count();
+                const auto d = -std::max<int64_t>(ticks, 1);
+                FILETIME ft;
+                memcpy(&ft, &d, sizeof(d));
+
+                _armedDue = due;
+                SetThreadpoolTimerEx(_timer.get(), &ft, 0, 0);
+            }
+
+            std::mutex _lock;
+            std::condition_variable _idle;
+            std::vector<client*> _clients;
+            clock::time_point _armedDue = clock::time_point::max();
+            wil::unique_threadpool_timer _timer;
+            TP_CALLBACK_ENVIRON _lowPriorityEnvironment;
+        };
     } // namespace details
 
     template<bool leading, typename... Args>
-    class throttled_func
+    class throttled_func : details::throttled_func_timer::client
     {
     public:
         using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
@@ -98,20 +276,23 @@ namespace til
         //
         // After `func` was invoked the state is reset and this cycle is repeated again.
         throttled_func(filetime_duration delay, function func) :
+            _delay{ delay },
             _func{ std::move(func) },
-            _timer{ _createTimer() }
+            _timer{ details::throttled_func_timer::instance() }
         {
-            const auto d = -delay.count();
-            if (d >= 0)
+            if (delay.count() <= 0)
             {
                 throw std::invalid_argument("non-positive delay specified");
             }
+        }
 
-            memcpy(&_delay, &d, sizeof(d));
+        ~throttled_func() override
+        {
+            _timer.cancel(*this);
         }
 
-        // throttled_func uses its `this` pointer when creating _timer.
-        // Since the timer cannot be recreated, instances cannot be moved either.
+        // throttled_func hands its `this` pointer to the shared timer.
+        // Instances cannot be moved, because a callback may be pending.
         throttled_func(const throttled_func&) = delete;
         throttled_func& operator=(const throttled_func&) = delete;
         throttled_func(throttled_func&&) = delete;
@@ -150,7 +331,7 @@ namespace til
         //       could still be called concurrently.
         void flush()
         {
-            WaitForThreadpoolTimerCallbacks(_timer.get(), true);
+            _timer.cancel(*this);
             if (_storage)
             {
                 _trailing_edge();
@@ -158,12 +339,10 @@ namespace til
         }
 
     private:
-        static void __stdcall _timer_callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
-        try
+        void timer_fired() override
         {
-            static_cast<throttled_func*>(context)->_trailing_edge();
+            _trailing_edge();
         }
-        CATCH_LOG()
 
         void _leading_edge()
         {
@@ -172,7 +351,7 @@ namespace til
                 _func();
             }
 
-            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+            _timer.schedule(*this, _delay);
         }
 
         void _trailing_edge()
@@ -187,20 +366,105 @@ namespace til
             }
         }
 
-        inline wil::unique_threadpool_timer _createTimer()
-        {
-            wil::unique_threadpool_timer timer{ CreateThreadpoolTimer(&_timer_callback, this, nullptr) };
-            THROW_LAST_ERROR_IF(!timer);
-            return timer;
-        }
-
-        FILETIME _delay;
+        filetime_duration _delay;
         function _func;
-        wil::unique_threadpool_timer _timer;
+        details::throttled_func_timer& _timer;
         details::throttled_func_storage<Args...> _storage;
     };
 
     template<typename... Args>
     using throttled_func_trailing = throttled_func<false, Args...>;
     using throttled_func_leading = throttled_func<true>;
+
+    // Defers work that nobody is waiting for until things have calmed down.
+    //
+    // After it's been invoked, `func` runs on a low priority threadpool callback once
+    // `quiet` time has passed without any further activity - that is, calls to
+    // operator() or postpone(). Continuous activity can't defer it indefinitely:
+    // `func` runs no later than `maxDelay` after the first invocation.
+    // Like throttled_func_trailing, multiple invocations result in a single call.
+    class idle_func : details::throttled_func_timer::client
+    {
+    public:
+        using clock = details::throttled_func_timer::clock;
+        using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+        using function = std::function<void()>;
+
+        idle_func(filetime_duration quiet, filetime_duration maxDelay, function func) :
+            client{ true },
+            _quiet{ quiet },
+            _maxDelay{ maxDelay },
+            _func{ std::move(func) },
+            _timer{ details::throttled_func_timer::instance() }
+        {
+            if (quiet.count() <= 0 || maxDelay < quiet)
+            {
+                throw std::invalid_argument("invalid delay specified");
+            }
+        }
+
+        ~idle_func() override
+        {
+            _timer.cancel(*this);
+        }
+
+        // idle_func hands its `this` pointer to the shared timer.
+        // Instances cannot be moved, because a callback may be pending.
+        idle_func(const idle_func&) = delete;
+        idle_func& operator=(const idle_func&) = delete;
+        idle_func(idle_func&&) = delete;
+        idle_func& operator=(idle_func&&) = delete;
+
+        // Requests for `func` to be called, which counts as activity as well.
+        // This is cheap enough to be called for every bit of output.
+        void operator()()
+        {
+            const auto now = clock::now();
+            _lastActivity.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+
+            if (!_pending.exchange(true, std::memory_order_relaxed))
+            {
+                _deadline.store((now + _maxDelay).time_since_epoch().count(), std::memory_order_relaxed);
+                _timer.schedule(*this, _quiet);
+            }
+        }
+
+        // Records activity without requesting a call, which delays a pending one.
+        void postpone() noexcept
+        {
+            if (_pending.load(std::memory_order_relaxed))
+            {
+                _lastActivity.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        void timer_fired() override
+        {
+            const auto now = clock::now();
+            const clock::time_point lastActivity{ clock::duration{ _lastActivity.load(std::memory_order_relaxed) } };
+            const clock::time_point deadline{ clock::duration{ _deadline.load(std::memory_order_relaxed) } };
+            const auto due = std::min(lastActivity + _quiet, deadline);
+
+            // There was activity since the timer was scheduled. Wait for it to calm down.
+            if (due > now)
+            {
+                _timer.schedule(*this, due - now);
+                return;
+            }
+
+            // Reset before calling _func, so that activity during the call requests another one.
+            _pending.store(false, std::memory_order_relaxed);
+            _func();
+        }
+
+        filetime_duration _quiet;
+        filetime_duration _maxDelay;
+        function _func;
+        details::throttled_func_timer& _timer;
+        std::atomic<bool> _pending{ false };
+        // The time_since_epoch() of the respective clock::time_point.
+        std::atomic<clock::rep> _lastActivity{ 0 };
+        std::atomic<clock::rep> _deadline{ 0 };
+    };
 } // namespace til
@@ -53,4 +53,103 @@ namespace til
         std::atomic<uint32_t> _next_ticket{ 0 };
         std::atomic<uint32_t> _now_serving{ 0 };
     };
+
+    // shared_ticket_lock is a reader-writer variant of ticket_lock.
+    //
+    // Writers are served in the order they arrived, just like with ticket_lock.
+    // Readers can hold the lock concurrently, but they're writer-preferring:
+    // As soon as a writer is waiting, new readers have to wait until no writer is left.
+    // The same caveats as for ticket_lock apply, plus: The lock can't be upgraded
+    // from shared to exclusive. Trying to do so will deadlock.
+    //
+    // It satisfies the SharedMutex requirements, so it can be used with std::shared_lock.
+    struct shared_ticket_lock
+    {
+        void lock() noexcept
+        {
+            const auto ticket = _next_ticket.fetch_add(1, std::memory_order_relaxed);
+
+            for (;;)
+            {
+                const auto current = _now_serving.load(std::memory_order_acquire);
+                if (current == ticket)
+                {
+                    break;
+                }
+
+                til::atomic_wait(_now_serving, current);
+            }
+
+            // This stops any new readers from entering. The previous writer
+            // might have left the flag set for us already, see unlock().
+            _state.fetch_or(writer_flag, std::memory_order_relaxed);
+
+            // ...and then we wait for the remaining readers to leave.
+            for (;;)
+            {
+                const auto state = _state.load(std::memory_order_acquire);
+                if (state == writer_flag)
+                {
+                    break;
+                }
+
+                til::atomic_wait(_state, state);
+            }
+        }
+
+        void unlock() noexcept
+        {
+            // If more writers are queued up, we hand the lock directly to the next one
+            // without letting readers in between. That's what makes this lock writer-preferring.
+            const auto ticket = _now_serving.load(std::memory_order_relaxed);
+            if (_next_ticket.load(std::memory_order_relaxed) == ticket + 1)
+            {
+                _state.store(0, std::memory_order_release);
+                til::atomic_notify_all(_state);
+            }
+
+            _now_serving.fetch_add(1, std::memory_order_release);
+            til::atomic_notify_all(_now_serving);
+        }
+
+        void lock_shared() noexcept
+        {
+            auto state = _state.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                if (state & writer_flag)
+                {
+                    til::atomic_wait(_state, state);
+                    state = _state.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+        }
+
+        void unlock_shared() noexcept
+        {
+            const auto state = _state.fetch_sub(1, std::memory_order_release);
+
+            // The last reader to leave wakes up the writer waiting for it, if there's one.
+            if (state == (writer_flag | 1))
+            {
+                til::atomic_notify_all(_state);
+            }
+        }
+
+    private:
+        static constexpr uint32_t writer_flag = 0x80000000;
+
+        // _next_ticket and _now_serving serialize the writers like in ticket_lock.
+        std::atomic<uint32_t> _next_ticket{ 0 };
+        std::atomic<uint32_t> _now_serving{ 0 };
+        // The number of active readers, plus writer_flag if a writer is holding or waiting for the lock.
+        std::atomic<uint32_t> _state{ 0 };
+    };
 }
@@ -13,7 +13,10 @@ Tests have been made in order to investigate whether or not own algorithms
 could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
 Based on the results the decision was made to keep using the platform
-functions MultiByteToWideChar and WideCharToMultiByte.
+functions MultiByteToWideChar and WideCharToMultiByte. Runs of ASCII, which
+make up most of the VT traffic passing through here, are converted with
+vectorized code in front of those calls, since they only need to be
+widened or narrowed.
 
 Author(s):
 - Steffen Illhardt (german-one), Leonard Hecker (lhecker) 2020-2021
@@ -23,6 +26,132 @@ Author(s):
 
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+        // Routine Description:
+        // - Converts the leading ASCII characters of a UTF-8 string to UTF-16.
+        // Arguments:
+        // - in - UTF-8 string to be converted
+        // - count - number of code units in the string
+        // - out - receives the UTF-16 code units, must have room for count of them
+        // Return Value:
+        // - the number of characters converted, which stops at the first non-ASCII one
+        inline size_t u8u16_ascii(const char* const in, const size_t count, wchar_t* const out) noexcept
+        {
+            size_t i = 0;
+
+#ifdef __AVX2__
+            for (; count - i >= 32; i += 32)
+            {
+                const auto vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                if (_mm256_movemask_epi8(vec))
+                {
+                    break;
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(vec)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(vec, 1)));
+            }
+#elif _M_AMD64
+            // The same as the AVX2 code above, just with 16 instead of 32 characters at a time.
+            const auto zero = _mm_setzero_si128();
+            for (; count - i >= 16; i += 16)
+            {
+                const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                if (_mm_movemask_epi8(vec))
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(vec, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(vec, zero));
+            }
+#elif _M_ARM64
+            for (; count - i >= 16; i += 16)
+            {
+                const auto vec = vld1q_u8(reinterpret_cast<const uint8_t*>(in + i));
+                if (vmaxvq_u8(vec) >= 0x80)
+                {
+                    break;
+                }
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + i), vmovl_u8(vget_low_u8(vec)));
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + i + 8), vmovl_u8(vget_high_u8(vec)));
+            }
+#endif
+
+            for (; i < count && static_cast<uint8_t>(in[i]) < 0x80; ++i)
+            {
+                out[i] = static_cast<wchar_t>(in[i]);
+            }
+
+            return i;
+        }
+
+        // Routine Description:
+        // - Converts the leading ASCII characters of a UTF-16 string to UTF-8.
+        // Arguments:
+        // - in - UTF-16 string to be converted
+        // - count - number of code units in the string
+        // - out - receives the UTF-8 code units, must have room for count of them
+        // Return Value:
+        // - the number of characters converted, which stops at the first non-ASCII one
+        inline size_t u16u8_ascii(const wchar_t* const in, const size_t count, char* const out) noexcept
+        {
+            size_t i = 0;
+
+#ifdef __AVX2__
+            const auto nonAscii = _mm256_set1_epi16(-0x80);
+            for (; count - i >= 32; i += 32)
+            {
+                const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+                if (!_mm256_testz_si256(_mm256_or_si256(lo, hi), nonAscii))
+                {
+                    break;
+                }
+                // _mm256_packus_epi16 packs each 128-bit lane separately, which the permutation undoes.
+                const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0b11'01'10'00);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+            }
+#elif _M_AMD64
+            // The same as the AVX2 code above, just with 16 instead of 32 characters at a time.
+            const auto nonAscii = _mm_set1_epi16(-0x80);
+            const auto zero = _mm_setzero_si128();
+            for (; count - i >= 16; i += 16)
+            {
+                const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+                const auto isAscii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lo, hi), nonAscii), zero);
+                if (_mm_movemask_epi8(isAscii) != 0xffff)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+            }
+#elif _M_ARM64
+            for (; count - i >= 16; i += 16)
+            {
+                const auto lo = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i));
+                const auto hi = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i + 8));
+                if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+                {
+                    break;
+                }
+                vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+            }
+#endif
+
+            for (; i < count && in[i] < 0x80; ++i)
+            {
+                out[i] = static_cast<char>(in[i]);
+            }
+
+            return i;
+        }
+#pragma warning(pop)
+    }
+
     // state structure for maintenance of UTF-8 partials
     struct u8state
     {
@@ -70,8 +199,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
             out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(CP_UTF8, 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            const auto ascii = gsl::narrow_cast<int>(details::u8u16_ascii(in.data(), in.length(), out.data()));
+            if (ascii == lengthRequired)
+            {
+                return S_OK;
+            }
+
+            const int lengthOut = MultiByteToWideChar(CP_UTF8, 0ul, in.data() + ascii, lengthRequired - ascii, out.data() + ascii, lengthRequired - ascii);
+            out.resize(gsl::narrow_cast<size_t>(ascii) + gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
         }
@@ -156,6 +291,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
             }
 
+            if (len8)
+            {
+                const auto ascii{ gsl::narrow_cast<int>(details::u8u16_ascii(cursor8, gsl::narrow_cast<size_t>(len8), out.data() + len16)) };
+                cursor8 += ascii;
+                len8 -= ascii;
+                len16 += ascii;
+                capa16 -= ascii;
+            }
+
             if (len8)
             {
                 const auto convLen{ MultiByteToWideChar(CP_UTF8, 0UL, cursor8, len8, out.data() + len16, capa16) };
@@ -197,8 +341,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
             out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(CP_UTF8, 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            const auto ascii = gsl::narrow_cast<int>(details::u16u8_ascii(in.data(), in.length(), out.data()));
+            if (ascii == lengthIn)
+            {
+                out.resize(in.length());
+                return S_OK;
+            }
+
+            const int lengthOut = WideCharToMultiByte(CP_UTF8, 0ul, in.data() + ascii, lengthIn - ascii, out.data() + ascii, lengthRequired - ascii, nullptr, nullptr);
+            out.resize(gsl::narrow_cast<size_t>(ascii) + gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
         }
@@ -257,6 +408,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
             }
 
+            if (len16)
+            {
+                const auto ascii{ gsl::narrow_cast<int>(details::u16u8_ascii(cursor16, gsl::narrow_cast<size_t>(len16), out.data() + len8)) };
+                cursor16 += ascii;
+                len16 -= ascii;
+                len8 += ascii;
+                capa8 -= ascii;
+            }
+
             if (len16)
             {
                 const auto convLen{ WideCharToMultiByte(CP_UTF8, 0UL, cursor16, len16, out.data() + len8, capa8, nullptr, nullptr) };
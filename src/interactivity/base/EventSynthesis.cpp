@@ -70,91 +70,168 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToK
     return SynthesizeKeyboardEvents(wch, keyState);
 }
 
+static constexpr INPUT_RECORD MakeKeyRecord(const bool keyDown,
+                                            const WORD virtualKeyCode,
+                                            const WORD virtualScanCode,
+                                            const wchar_t wch,
+                                            const DWORD controlKeyState) noexcept
+{
+    INPUT_RECORD record{};
+    record.EventType = KEY_EVENT;
+    record.Event.KeyEvent.bKeyDown = keyDown;
+    record.Event.KeyEvent.wRepeatCount = 1;
+    record.Event.KeyEvent.wVirtualKeyCode = virtualKeyCode;
+    record.Event.KeyEvent.wVirtualScanCode = virtualScanCode;
+    record.Event.KeyEvent.uChar.UnicodeChar = wch;
+    record.Event.KeyEvent.dwControlKeyState = controlKeyState;
+    return record;
+}
+
 // Routine Description:
-// - converts a wchar_t into a series of KeyEvents as if it was typed
-// using the keyboard
+// - converts a wchar_t into the key events that type it on the keyboard,
+// see SynthesizeKeyboardEvents
 // Arguments:
 // - wch - the wchar_t to convert
+// - keyState - the result of VkKeyScanW for wch
+// - virtualScanCode - the scan code of the virtual key in keyState
+// - records - receives the key events
 // Return Value:
-// - deque of KeyEvents that represent the wchar_t being typed
-// Note:
-// - will throw exception on error
-std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::SynthesizeKeyboardEvents(const wchar_t wch, const short keyState)
+// - the number of records written
+static size_t SynthesizeKeyboardRecords(const wchar_t wch,
+                                        const short keyState,
+                                        const WORD virtualScanCode,
+                                        std::array<INPUT_RECORD, 4>& records) noexcept
 {
     const auto modifierState = HIBYTE(keyState);
-
-    auto altGrSet = false;
-    auto shiftSet = false;
-    std::deque<std::unique_ptr<KeyEvent>> keyEvents;
+    const auto altGrSet = WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed);
+    const auto shiftSet = !altGrSet && WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed);
+    size_t count = 0;
 
     // add modifier key event if necessary
-    if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed))
+    if (altGrSet)
     {
-        altGrSet = true;
-        keyEvents.push_back(std::make_unique<KeyEvent>(true,
-                                                       1ui16,
-                                                       static_cast<WORD>(VK_MENU),
-                                                       altScanCode,
-                                                       UNICODE_NULL,
-                                                       (ENHANCED_KEY | LEFT_CTRL_PRESSED | RIGHT_ALT_PRESSED)));
+        til::at(records, count++) = MakeKeyRecord(true, VK_MENU, altScanCode, UNICODE_NULL, ENHANCED_KEY | LEFT_CTRL_PRESSED | RIGHT_ALT_PRESSED);
     }
-    else if (WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed))
+    else if (shiftSet)
     {
-        shiftSet = true;
-        keyEvents.push_back(std::make_unique<KeyEvent>(true,
-                                                       1ui16,
-                                                       static_cast<WORD>(VK_SHIFT),
-                                                       leftShiftScanCode,
-                                                       UNICODE_NULL,
-                                                       SHIFT_PRESSED));
+        til::at(records, count++) = MakeKeyRecord(true, VK_SHIFT, leftShiftScanCode, UNICODE_NULL, SHIFT_PRESSED);
     }
 
-    const auto vk = LOBYTE(keyState);
-    const auto virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(vk, MAPVK_VK_TO_VSC));
-    KeyEvent keyEvent{ true, 1, LOBYTE(keyState), virtualScanCode, wch, 0 };
-
     // add modifier flags if necessary
+    DWORD controlKeyState = 0;
     if (WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed))
     {
-        keyEvent.ActivateModifierKey(ModifierKeyState::Shift);
+        WI_SetFlag(controlKeyState, SHIFT_PRESSED);
     }
     if (WI_IsFlagSet(modifierState, VkKeyScanModState::CtrlPressed))
     {
-        keyEvent.ActivateModifierKey(ModifierKeyState::LeftCtrl);
+        WI_SetFlag(controlKeyState, LEFT_CTRL_PRESSED);
     }
-    if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed))
+    if (altGrSet)
     {
-        keyEvent.ActivateModifierKey(ModifierKeyState::RightAlt);
+        WI_SetFlag(controlKeyState, RIGHT_ALT_PRESSED);
     }
 
     // add key event down and up
-    keyEvents.push_back(std::make_unique<KeyEvent>(keyEvent));
-    keyEvent.SetKeyDown(false);
-    keyEvents.push_back(std::make_unique<KeyEvent>(keyEvent));
+    const auto vk = LOBYTE(keyState);
+    til::at(records, count++) = MakeKeyRecord(true, vk, virtualScanCode, wch, controlKeyState);
+    til::at(records, count++) = MakeKeyRecord(false, vk, virtualScanCode, wch, controlKeyState);
 
     // add modifier key up event
     if (altGrSet)
     {
-        keyEvents.push_back(std::make_unique<KeyEvent>(false,
-                                                       1ui16,
-                                                       static_cast<WORD>(VK_MENU),
-                                                       altScanCode,
-                                                       UNICODE_NULL,
-                                                       ENHANCED_KEY));
+        til::at(records, count++) = MakeKeyRecord(false, VK_MENU, altScanCode, UNICODE_NULL, ENHANCED_KEY);
     }
     else if (shiftSet)
     {
-        keyEvents.push_back(std::make_unique<KeyEvent>(false,
-                                                       1ui16,
-                                                       static_cast<WORD>(VK_SHIFT),
-                                                       leftShiftScanCode,
-                                                       UNICODE_NULL,
-                                                       0));
+        til::at(records, count++) = MakeKeyRecord(false, VK_SHIFT, leftShiftScanCode, UNICODE_NULL, 0);
     }
 
+    return count;
+}
+
+// Routine Description:
+// - converts a wchar_t into a series of KeyEvents as if it was typed
+// using the keyboard
+// Arguments:
+// - wch - the wchar_t to convert
+// Return Value:
+// - deque of KeyEvents that represent the wchar_t being typed
+// Note:
+// - will throw exception on error
+std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::SynthesizeKeyboardEvents(const wchar_t wch, const short keyState)
+{
+    const auto virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(LOBYTE(keyState), MAPVK_VK_TO_VSC));
+
+    std::array<INPUT_RECORD, 4> records;
+    const auto count = SynthesizeKeyboardRecords(wch, keyState, virtualScanCode, records);
+
+    std::deque<std::unique_ptr<KeyEvent>> keyEvents;
+    for (size_t i = 0; i < count; ++i)
+    {
+        keyEvents.push_back(std::make_unique<KeyEvent>(til::at(records, i).Event.KeyEvent));
+    }
     return keyEvents;
 }
 
+// Routine Description:
+// - converts a string into the key events that type it, like CharToKeyEvents
+// does for a single wchar_t, and appends them to the given vector. Unlike
+// CharToKeyEvents this doesn't allocate a KeyEvent for every single record,
+// and it only asks the keyboard layout about each ASCII character once,
+// which makes it suitable for large amounts of text, like pastes.
+// Arguments:
+// - string - the text to convert
+// - codepage - the codepage to use for characters that are typed on the numpad
+// - records - receives the key events
+// Note:
+// - will throw exception on error
+void Microsoft::Console::Interactivity::StringToInputRecords(const std::wstring_view string,
+                                                            const unsigned int codepage,
+                                                            std::vector<INPUT_RECORD>& records)
+{
+    static constexpr short invalidKey = -1;
+    static constexpr short unknownKey = -2;
+
+    // The keyboard layout can't change while we're in here,
+    // so we only need to look up each ASCII character once.
+    std::array<short, 128> asciiKeyStates;
+    std::array<WORD, 128> asciiScanCodes;
+    asciiKeyStates.fill(unknownKey);
+
+    records.reserve(records.size() + string.size() * 2);
+
+    for (const auto wch : string)
+    {
+        if (wch < asciiKeyStates.size())
+        {
+            auto& keyState = til::at(asciiKeyStates, wch);
+            auto& virtualScanCode = til::at(asciiScanCodes, wch);
+            if (keyState == unknownKey)
+            {
+                keyState = VkKeyScanW(wch);
+                if (keyState != invalidKey)
+                {
+                    virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(LOBYTE(keyState), MAPVK_VK_TO_VSC));
+                }
+            }
+
+            if (keyState != invalidKey)
+            {
+                std::array<INPUT_RECORD, 4> keyRecords;
+                const auto count = SynthesizeKeyboardRecords(wch, keyState, virtualScanCode, keyRecords);
+                records.insert(records.end(), keyRecords.begin(), keyRecords.begin() + count);
+                continue;
+            }
+        }
+
+        for (const auto& keyEvent : CharToKeyEvents(wch, codepage))
+        {
+            records.emplace_back(keyEvent->ToInputRecord());
+        }
+    }
+}
+
 // Routine Description:
 // - converts a wchar_t into a series of KeyEvents as if it was typed
 // using Alt + numpad
@@ -17,6 +17,11 @@ bool SystemConfigurationProvider::IsCaretBlinkingEnabled() noexcept
     return s_DefaultIsCaretBlinkingEnabled;
 }
 
+bool SystemConfigurationProvider::IsRemoteSession() noexcept
+{
+    return false;
+}
+
 int SystemConfigurationProvider::GetNumberOfMouseButtons() noexcept
 {
     if (IsGetSystemMetricsPresent())
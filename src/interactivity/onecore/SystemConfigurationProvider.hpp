@@ -26,6 +26,7 @@ namespace Microsoft::Console::Interactivity::OneCore
     {
     public:
         bool IsCaretBlinkingEnabled() noexcept override;
+        bool IsRemoteSession() noexcept override;
 
         UINT GetCaretBlinkTime() noexcept override;
         int GetNumberOfMouseButtons() noexcept override;
@@ -11,6 +11,13 @@
 using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::Interactivity::Win32;
 
+AccessibilityNotifier::AccessibilityNotifier()
+{
+    _flush = std::make_unique<til::throttled_func_trailing<>>(FlushInterval, [this]() {
+        _FlushUpdates();
+    });
+}
+
 void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ const til::rect& rectangle)
 {
     const auto pWindow = ServiceLocator::LocateConsoleWindow();
@@ -28,6 +35,9 @@ void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ const til::rect& rectan
 
 void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ ConsoleCaretEventFlags flags, _In_ LONG position)
 {
+    // The caret moved after the text was written, so let clients know about the text first.
+    _FlushUpdates();
+
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     DWORD dwFlags = 0;
 
@@ -64,6 +74,16 @@ void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ ConsoleCaretEventFlags
 
 void AccessibilityNotifier::NotifyConsoleUpdateScrollEvent(_In_ LONG x, _In_ LONG y)
 {
+    // Clients move their copy of the contents along, including any outdated parts.
+    // The pending update is sent afterwards, so it needs to move as well.
+    {
+        const std::lock_guard lock{ _pendingLock };
+        if (!_pending.region.empty())
+        {
+            _pending.region = (_pending.region + til::point{ x, y }) & til::rect{ 0, 0, SHRT_MAX, SHRT_MAX };
+        }
+    }
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -76,30 +96,21 @@ void AccessibilityNotifier::NotifyConsoleUpdateScrollEvent(_In_ LONG x, _In_ LON
 
 void AccessibilityNotifier::NotifyConsoleUpdateSimpleEvent(_In_ LONG start, _In_ LONG charAndAttribute)
 {
-    auto pWindow = ServiceLocator::LocateConsoleWindow();
-    if (pWindow)
-    {
-        NotifyWinEvent(EVENT_CONSOLE_UPDATE_SIMPLE,
-                       pWindow->GetWindowHandle(),
-                       start,
-                       charAndAttribute);
-    }
+    const til::point position{ static_cast<SHORT>(LOWORD(start)), static_cast<SHORT>(HIWORD(start)) };
+    _QueueUpdate({ position, til::size{ 1, 1 } }, charAndAttribute);
 }
 
 void AccessibilityNotifier::NotifyConsoleUpdateRegionEvent(_In_ LONG startXY, _In_ LONG endXY)
 {
-    auto pWindow = ServiceLocator::LocateConsoleWindow();
-    if (pWindow)
-    {
-        NotifyWinEvent(EVENT_CONSOLE_UPDATE_REGION,
-                       pWindow->GetWindowHandle(),
-                       startXY,
-                       endXY);
-    }
+    const til::point start{ static_cast<SHORT>(LOWORD(startXY)), static_cast<SHORT>(HIWORD(startXY)) };
+    const til::point end{ static_cast<SHORT>(LOWORD(endXY)), static_cast<SHORT>(HIWORD(endXY)) };
+    _QueueUpdate({ start, end + til::point{ 1, 1 } }, std::nullopt);
 }
 
 void AccessibilityNotifier::NotifyConsoleLayoutEvent()
 {
+    _FlushUpdates();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -112,6 +123,8 @@ void AccessibilityNotifier::NotifyConsoleLayoutEvent()
 
 void AccessibilityNotifier::NotifyConsoleStartApplicationEvent(_In_ DWORD processId)
 {
+    _FlushUpdates();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -124,6 +137,8 @@ void AccessibilityNotifier::NotifyConsoleStartApplicationEvent(_In_ DWORD proces
 
 void AccessibilityNotifier::NotifyConsoleEndApplicationEvent(_In_ DWORD processId)
 {
+    _FlushUpdates();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -133,3 +148,64 @@ void AccessibilityNotifier::NotifyConsoleEndApplicationEvent(_In_ DWORD processI
                        0);
     }
 }
+
+// Routine Description:
+// - Adds the given change of the buffer to the pending update. Writes come in
+//   small pieces, so instead of sending a cross-process event for each of them,
+//   they're combined and sent at most once per FlushInterval.
+// Arguments:
+// - region - the buffer region that changed
+// - charAndAttribute - the contents of the cell, if a single cell changed
+void AccessibilityNotifier::_QueueUpdate(const til::rect& region, const std::optional<LONG> charAndAttribute)
+{
+    {
+        const std::lock_guard lock{ _pendingLock };
+        if (_pending.region.empty() || _pending.region == region)
+        {
+            _pending.region = region;
+            _pending.charAndAttribute = charAndAttribute;
+        }
+        else
+        {
+            _pending.region |= region;
+            _pending.charAndAttribute.reset();
+        }
+    }
+
+    (*_flush)();
+}
+
+// Routine Description:
+// - Sends the pending update, if any.
+void AccessibilityNotifier::_FlushUpdates() noexcept
+try
+{
+    PendingUpdate pending;
+    {
+        const std::lock_guard lock{ _pendingLock };
+        pending = std::exchange(_pending, {});
+    }
+
+    const auto pWindow = ServiceLocator::LocateConsoleWindow();
+    if (pending.region.empty() || !pWindow)
+    {
+        return;
+    }
+
+    const auto start = MAKELONG(pending.region.left, pending.region.top);
+    if (pending.charAndAttribute)
+    {
+        NotifyWinEvent(EVENT_CONSOLE_UPDATE_SIMPLE,
+                       pWindow->GetWindowHandle(),
+                       start,
+                       *pending.charAndAttribute);
+    }
+    else
+    {
+        NotifyWinEvent(EVENT_CONSOLE_UPDATE_REGION,
+                       pWindow->GetWindowHandle(),
+                       start,
+                       MAKELONG(pending.region.right - 1, pending.region.bottom - 1));
+    }
+}
+CATCH_LOG()
@@ -18,6 +18,8 @@ Author(s):
 
 #include "../inc/IAccessibilityNotifier.hpp"
 
+#include <til/throttled_func.h>
+
 #pragma hdrstop
 
 namespace Microsoft::Console::Interactivity::Win32
@@ -25,6 +27,10 @@ namespace Microsoft::Console::Interactivity::Win32
     class AccessibilityNotifier final : public IAccessibilityNotifier
     {
     public:
+        // Updates of the buffer are sent at most once per FlushInterval, which is about one frame.
+        static constexpr std::chrono::milliseconds FlushInterval{ 16 };
+
+        AccessibilityNotifier();
         ~AccessibilityNotifier() = default;
 
         void NotifyConsoleCaretEvent(_In_ const til::rect& rectangle);
@@ -35,5 +41,23 @@ namespace Microsoft::Console::Interactivity::Win32
         void NotifyConsoleLayoutEvent();
         void NotifyConsoleStartApplicationEvent(_In_ DWORD processId);
         void NotifyConsoleEndApplicationEvent(_In_ DWORD processId);
+
+    private:
+        void _QueueUpdate(const til::rect& region, const std::optional<LONG> charAndAttribute);
+        void _FlushUpdates() noexcept;
+
+        // The buffer region that changed since the last flush, spanning all changes.
+        // If only a single cell changed, charAndAttribute holds its contents for
+        // an EVENT_CONSOLE_UPDATE_SIMPLE instead of an EVENT_CONSOLE_UPDATE_REGION.
+        struct PendingUpdate
+        {
+            til::rect region;
+            std::optional<LONG> charAndAttribute;
+        };
+        std::mutex _pendingLock;
+        PendingUpdate _pending;
+
+        // Declared last, so that it's destroyed (and any pending callback canceled) first.
+        std::unique_ptr<til::throttled_func_trailing<>> _flush;
     };
 }
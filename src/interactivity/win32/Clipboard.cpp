@@ -108,8 +108,10 @@ void Clipboard::StringPaste(_In_reads_(cchData) const wchar_t* const pData,
 
     try
     {
-        auto inEvents = TextToKeyEvents(pData, cchData);
-        gci.pInputBuffer->Write(inEvents);
+        // Pastes can easily be megabytes large. Writing plain records in a single batch
+        // avoids allocating an IInputEvent for each of the (at least) 2 records per character.
+        const auto records = TextToInputRecords(pData, cchData);
+        gci.pInputBuffer->Write(records);
     }
     catch (...)
     {
@@ -122,21 +124,23 @@ void Clipboard::StringPaste(_In_reads_(cchData) const wchar_t* const pData,
 #pragma region Private Methods
 
 // Routine Description:
-// - converts a wchar_t* into a series of KeyEvents as if it was typed
+// - converts a wchar_t* into a series of key event records as if it was typed
 // from the keyboard
 // Arguments:
 // - pData - the text to convert
 // - cchData - the size of pData, in wchars
 // Return Value:
-// - deque of KeyEvents that represent the string passed in
+// - vector of key event records that represent the string passed in
 // Note:
 // - will throw exception on error
-std::deque<std::unique_ptr<IInputEvent>> Clipboard::TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
-                                                                    const size_t cchData)
+std::vector<INPUT_RECORD> Clipboard::TextToInputRecords(_In_reads_(cchData) const wchar_t* const pData,
+                                                        const size_t cchData)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, pData);
 
-    std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+    // The text is filtered first, so that it can be converted in one go.
+    std::wstring text;
+    text.reserve(cchData);
 
     for (size_t i = 0; i < cchData; ++i)
     {
@@ -174,15 +178,29 @@ std::deque<std::unique_ptr<IInputEvent>> Clipboard::TextToKeyEvents(_In_reads_(c
             currentChar = UNICODE_CARRIAGERETURN;
         }
 
-        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
-        auto convertedEvents = CharToKeyEvents(currentChar, codepage);
-        while (!convertedEvents.empty())
-        {
-            keyEvents.push_back(std::move(convertedEvents.front()));
-            convertedEvents.pop_front();
-        }
+        text.push_back(currentChar);
     }
-    return keyEvents;
+
+    const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+    std::vector<INPUT_RECORD> records;
+    StringToInputRecords(text, codepage, records);
+    return records;
+}
+
+// Routine Description:
+// - converts a wchar_t* into a series of KeyEvents as if it was typed
+// from the keyboard
+// Arguments:
+// - pData - the text to convert
+// - cchData - the size of pData, in wchars
+// Return Value:
+// - deque of KeyEvents that represent the string passed in
+// Note:
+// - will throw exception on error
+std::deque<std::unique_ptr<IInputEvent>> Clipboard::TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
+                                                                    const size_t cchData)
+{
+    return IInputEvent::Create(TextToInputRecords(pData, cchData));
 }
 
 // Routine Description:
@@ -209,9 +227,14 @@ void Clipboard::StoreSelectionToClipboard(const bool copyFormatting)
     const auto& buffer = gci.GetActiveOutputBuffer().GetTextBuffer();
     const auto& renderSettings = gci.GetRenderSettings();
 
-    const auto GetAttributeColors = [&](const auto& attr) {
-        return renderSettings.GetAttributeColors(attr);
-    };
+    // The colors are only needed for the HTML and RTF formats.
+    std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors;
+    if (copyFormatting)
+    {
+        GetAttributeColors = [&](const auto& attr) {
+            return renderSettings.GetAttributeColors(attr);
+        };
+    }
 
     bool includeCRLF, trimTrailingWhitespace;
     if (WI_IsFlagSet(GetKeyState(VK_SHIFT), KEY_PRESSED))
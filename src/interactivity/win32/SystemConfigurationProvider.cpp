@@ -20,6 +20,11 @@ bool SystemConfigurationProvider::IsCaretBlinkingEnabled()
     return GetSystemMetrics(SM_CARETBLINKINGENABLED) ? true : false;
 }
 
+bool SystemConfigurationProvider::IsRemoteSession()
+{
+    return GetSystemMetrics(SM_REMOTESESSION) ? true : false;
+}
+
 int SystemConfigurationProvider::GetNumberOfMouseButtons()
 {
     return GetSystemMetrics(SM_CMOUSEBUTTONS);
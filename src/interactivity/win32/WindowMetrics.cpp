@@ -50,15 +50,45 @@ til::rect WindowMetrics::GetMinClientRectInPixels()
 // - til::rect of client area positions in pixels.
 til::rect WindowMetrics::GetMaxClientRectInPixels()
 {
+    // Style changes (like scroll bars appearing) don't notify us, so they're part of the cache key instead.
+    // The generation is read first so that an invalidation racing with the computation below wins.
+    const auto generation = _maxClientRectGeneration.load(std::memory_order_acquire);
+    const auto pWindow = ServiceLocator::LocateConsoleWindow();
+    const auto hwnd = pWindow ? pWindow->GetWindowHandle() : nullptr;
+    const auto style = hwnd ? GetWindowStyle(hwnd) : CONSOLE_WINDOW_FLAGS;
+    const auto exStyle = hwnd ? GetWindowExStyle(hwnd) : CONSOLE_WINDOW_EX_FLAGS;
+    const auto dpi = ServiceLocator::LocateGlobals().dpi;
+    const auto fullscreen = pWindow && pWindow->IsInFullscreen();
+
+    if (_maxClientRect &&
+        _maxClientRect->generation == generation &&
+        _maxClientRect->style == style &&
+        _maxClientRect->exStyle == exStyle &&
+        _maxClientRect->dpi == dpi &&
+        _maxClientRect->fullscreen == fullscreen)
+    {
+        return _maxClientRect->rect;
+    }
+
     // This will retrieve the outer window rect. We need the client area to calculate characters.
     auto rc = GetMaxWindowRectInPixels();
 
     // convert to client rect
     ConvertWindowRectToClientRect(&rc);
 
+    _maxClientRect = MaxClientRectCache{ rc, style, exStyle, dpi, fullscreen, generation };
     return rc;
 }
 
+// Routine Description:
+// - Forgets the cached result of GetMaxClientRectInPixels. Call this when the window
+//   moves or the monitor configuration, work area or DPI changes.
+// - This may be called from the window thread without holding the console lock.
+void WindowMetrics::InvalidateMaxClientRect() noexcept
+{
+    _maxClientRectGeneration.fetch_add(1, std::memory_order_release);
+}
+
 // Routine Description:
 // - Gets the maximum possible window rectangle in pixels. Based on the monitor the window is on or the primary monitor if no window exists yet.
 // Arguments:
@@ -41,7 +41,24 @@ namespace Microsoft::Console::Interactivity::Win32
         void ConvertClientRectToWindowRect(_Inout_ til::rect* const prc);
         void ConvertWindowRectToClientRect(_Inout_ til::rect* const prc);
 
+        void InvalidateMaxClientRect() noexcept;
+
     private:
+        // The maximum client rect depends on the monitor the window is on, its work area,
+        // the DPI and the window style. Computing it takes several trips into the window manager,
+        // so we remember it until the window tells us that one of them might have changed.
+        struct MaxClientRectCache
+        {
+            til::rect rect;
+            DWORD style;
+            DWORD exStyle;
+            int dpi;
+            bool fullscreen;
+            uint32_t generation;
+        };
+        std::optional<MaxClientRectCache> _maxClientRect;
+        std::atomic<uint32_t> _maxClientRectGeneration{ 0 };
+
         enum ConvertRectangle
         {
             CLIENT_TO_WINDOW,
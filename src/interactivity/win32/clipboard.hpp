@@ -35,6 +35,8 @@ namespace Microsoft::Console::Interactivity::Win32
         void Paste();
 
     private:
+        std::vector<INPUT_RECORD> TextToInputRecords(_In_reads_(cchData) const wchar_t* const pData,
+                                                     const size_t cchData);
         std::deque<std::unique_ptr<IInputEvent>> TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
                                                                  const size_t cchData);
 
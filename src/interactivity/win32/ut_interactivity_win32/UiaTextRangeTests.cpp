@@ -362,15 +362,15 @@ class UiaTextRangeTests
         {
             auto& row = _pTextBuffer->GetRowByOffset(i);
             auto& charRow = row.GetCharRow();
-            for (auto& cell : charRow)
+            for (auto j = 0; j < charRow.size(); ++j)
             {
                 if (i % 2 == 0)
                 {
-                    cell.Char() = L' ';
+                    charRow.GlyphAt(j) = L" ";
                 }
                 else
                 {
-                    cell.Char() = L'X';
+                    charRow.GlyphAt(j) = L"X";
                 }
             }
         }
@@ -222,6 +222,7 @@ using namespace Microsoft::Console::Types;
     {
         _fInDPIChange = true;
         ServiceLocator::LocateGlobals().dpi = HIWORD(wParam);
+        ServiceLocator::LocateWindowMetrics<WindowMetrics>()->InvalidateMaxClientRect();
         _UpdateSystemMetrics();
         s_ReinitializeFontsForDPIChange();
 
@@ -340,6 +341,7 @@ using namespace Microsoft::Console::Types;
 
     case WM_DISPLAYCHANGE:
     {
+        ServiceLocator::LocateWindowMetrics<WindowMetrics>()->InvalidateMaxClientRect();
         _UpdateSystemMetrics();
         break;
     }
@@ -456,6 +458,9 @@ using namespace Microsoft::Console::Types;
 
     case WM_WINDOWPOSCHANGED:
     {
+        // The window might have moved onto another monitor.
+        ServiceLocator::LocateWindowMetrics<WindowMetrics>()->InvalidateMaxClientRect();
+
         // Only handle this if the DPI is the same as last time.
         // If the DPI is different, assume we're about to get a DPICHANGED notification
         // which will have a better suggested rectangle than this one.
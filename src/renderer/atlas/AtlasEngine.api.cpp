@@ -131,6 +131,17 @@ constexpr HRESULT vec2_narrow(U x, U y, AtlasEngine::vec2<T>& out) noexcept
     return S_OK;
 }
 
+[[nodiscard]] HRESULT AtlasEngine::InvalidateColorTable() noexcept
+{
+    // Cells that refer to the palette get recolored by the shader, once UpdateDrawingBrushes()
+    // picks up the new table. Only those with colors that were resolved on the CPU need repainting.
+    if (_api.paletteFallbackInUse)
+    {
+        _api.invalidatedRows = invalidatedRowsAll;
+    }
+    return S_OK;
+}
+
 [[nodiscard]] HRESULT AtlasEngine::InvalidateFlush(_In_ const bool /*circled*/, _Out_ bool* const pForcePaint) noexcept
 {
     RETURN_HR_IF_NULL(E_INVALIDARG, pForcePaint);
@@ -331,12 +342,24 @@ void AtlasEngine::SetAntialiasingMode(const D2D1_TEXT_ANTIALIAS_MODE antialiasin
     const auto mode = gsl::narrow_cast<u8>(antialiasingMode);
     if (_api.antialiasingMode != mode)
     {
+        const auto previousMode = _api.realizedAntialiasingMode;
         _api.antialiasingMode = mode;
         _resolveAntialiasingMode();
-        WI_SetFlag(_api.invalidations, ApiInvalidations::Font);
+        WI_SetFlagIf(_api.invalidations, ApiInvalidations::Font, _api.realizedAntialiasingMode != previousMode);
     }
 }
 
+// Releases the device, swap chain and glyph atlas. They're recreated
+// by the next StartPaint(), which also repaints the entire viewport.
+void AtlasEngine::ReleaseResources() noexcept
+try
+{
+    _releaseSwapChain();
+    _r = {};
+    WI_SetAllFlags(_api.invalidations, ApiInvalidations::Device | ApiInvalidations::Settings);
+}
+CATCH_LOG()
+
 void AtlasEngine::SetCallback(std::function<void()> pfn) noexcept
 {
     _api.swapChainChangedCallback = std::move(pfn);
@@ -347,9 +370,13 @@ void AtlasEngine::EnableTransparentBackground(const bool isTransparent) noexcept
     const auto mixin = !isTransparent ? 0xff000000 : 0x00000000;
     if (_api.backgroundOpaqueMixin != mixin)
     {
+        const auto previousMode = _api.realizedAntialiasingMode;
         _api.backgroundOpaqueMixin = mixin;
         _resolveAntialiasingMode();
         WI_SetFlag(_api.invalidations, ApiInvalidations::SwapChain);
+        // The glyph atlas only needs to be rasterized again if we
+        // had to switch between ClearType and grayscale antialiasing.
+        WI_SetFlagIf(_api.invalidations, ApiInvalidations::Font, _api.realizedAntialiasingMode != previousMode);
     }
 }
 
@@ -389,6 +416,11 @@ void AtlasEngine::SetSoftwareRendering(bool enable) noexcept
 {
 }
 
+void AtlasEngine::SetSubRowScrollOffset(const float rows) noexcept
+{
+    _api.subRowScrollOffset = rows;
+}
+
 void AtlasEngine::SetWarningCallback(std::function<void(HRESULT)> pfn) noexcept
 {
     _api.warningCallback = std::move(pfn);
@@ -451,6 +483,11 @@ void AtlasEngine::UpdateHyperlinkHoveredId(const uint16_t hoveredId) noexcept
 
 #pragma endregion
 
+AtlasEngine::GlyphCacheStatistics AtlasEngine::GetGlyphCacheStatistics() const noexcept
+{
+    return *_glyphCacheStatistics.lock_shared();
+}
+
 void AtlasEngine::_resolveAntialiasingMode() noexcept
 {
     // If the user asks for ClearType, but also for a transparent background
@@ -536,8 +573,24 @@ void AtlasEngine::_updateFont(const wchar_t* faceName, const FontInfoDesired& fo
         }
     }
 
+    FontMetrics fontMetrics;
+    _resolveFontMetrics(faceName, fontInfoDesired, fontInfo, &fontMetrics);
+
+    // ControlCore calls UpdateFont() whenever the settings are applied, even if the font didn't change.
+    // Since ApiInvalidations::Font throws away the entire glyph atlas, it's only set if something changed.
+    const auto featuresEqual = std::equal(fontFeatures.begin(), fontFeatures.end(), _api.fontFeatures.begin(), _api.fontFeatures.end(), [](const auto& a, const auto& b) {
+        return a.nameTag == b.nameTag && a.parameter == b.parameter;
+    });
+    const auto axesEqual = std::equal(fontAxisValues.begin(), fontAxisValues.end(), _api.fontAxisValues.begin(), _api.fontAxisValues.end(), [](const auto& a, const auto& b) {
+        return a.axisTag == b.axisTag && a.value == b.value;
+    });
+    if (featuresEqual && axesEqual && fontMetrics == _api.fontMetrics)
+    {
+        return;
+    }
+
     const auto previousCellSize = _api.fontMetrics.cellSize;
-    _resolveFontMetrics(faceName, fontInfoDesired, fontInfo, &_api.fontMetrics);
+    _api.fontMetrics = std::move(fontMetrics);
     _api.fontFeatures = std::move(fontFeatures);
     _api.fontAxisValues = std::move(fontAxisValues);
 
@@ -574,19 +627,9 @@ void AtlasEngine::_resolveFontMetrics(const wchar_t* requestedFaceName, const Fo
 
     auto fontCollection = FontCache::GetCached();
 
-    u32 index = 0;
-    BOOL exists = false;
-    THROW_IF_FAILED(fontCollection->FindFamilyName(requestedFaceName, &index, &exists));
-    THROW_HR_IF(DWRITE_E_NOFONT, !exists);
-
-    wil::com_ptr<IDWriteFontFamily> fontFamily;
-    THROW_IF_FAILED(fontCollection->GetFontFamily(index, fontFamily.addressof()));
-
-    wil::com_ptr<IDWriteFont> font;
-    THROW_IF_FAILED(fontFamily->GetFirstMatchingFont(static_cast<DWRITE_FONT_WEIGHT>(requestedWeight), DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, font.addressof()));
-
-    wil::com_ptr<IDWriteFontFace> fontFace;
-    THROW_IF_FAILED(font->CreateFontFace(fontFace.addressof()));
+    const auto resolved = FontCache::FindFontFace(fontCollection.get(), requestedFaceName, static_cast<DWRITE_FONT_WEIGHT>(requestedWeight), DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL);
+    THROW_HR_IF(DWRITE_E_NOFONT, !resolved.face);
+    const auto& fontFace = resolved.face;
 
     DWRITE_FONT_METRICS metrics;
     fontFace->GetMetrics(&metrics);
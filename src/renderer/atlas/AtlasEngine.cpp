@@ -106,14 +106,19 @@ try
         {
             _recreateFontDependentResources();
         }
+        // Settings changes (like the selection color when the focused appearance changes) only need
+        // to update the ConstBuffer. All other invalidations require the entire viewport to be redrawn.
+        if (_api.invalidations != ApiInvalidations::Settings)
+        {
+            // Equivalent to InvalidateAll().
+            _api.invalidatedRows = invalidatedRowsAll;
+        }
         if (WI_IsFlagSet(_api.invalidations, ApiInvalidations::Settings))
         {
             _r.selectionColor = _api.selectionColor;
             WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+            WI_ClearFlag(_api.invalidations, ApiInvalidations::Settings);
         }
-
-        // Equivalent to InvalidateAll().
-        _api.invalidatedRows = invalidatedRowsAll;
     }
 
 #ifndef NDEBUG
@@ -160,12 +165,21 @@ try
     }
 #endif
 
+    // Smooth scrolling shifts the rows that are already on the GPU and doesn't
+    // invalidate any of them. Only the ConstBuffer needs to be updated for it.
+    if (const auto scrollPixelOffset = gsl::narrow_cast<i32>(lroundf(_api.subRowScrollOffset * _r.fontMetrics.cellSize.y)); scrollPixelOffset != _r.scrollPixelOffset)
+    {
+        _r.scrollPixelOffset = scrollPixelOffset;
+        WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+    }
+
     if (_api.invalidatedRows == invalidatedRowsAll)
     {
         // Skip all the partial updates, since we redraw everything anyways.
         _api.invalidatedCursorArea = invalidatedAreaNone;
         _api.invalidatedRows = { 0, _api.cellCount.y };
         _api.scrollOffset = 0;
+        _api.paletteFallbackInUse = false;
     }
     else
     {
@@ -189,8 +203,6 @@ try
         if (_api.scrollOffset != 0)
         {
             const auto nothingInvalid = _api.invalidatedRows.x == _api.invalidatedRows.y;
-            const auto offset = static_cast<ptrdiff_t>(_api.scrollOffset) * _api.cellCount.x;
-            auto count = _r.cells.size();
 
             if (_api.scrollOffset < 0)
             {
@@ -198,47 +210,26 @@ try
                 const u16 endRow = _api.cellCount.y + _api.scrollOffset;
                 _api.invalidatedRows.x = nothingInvalid ? endRow : std::min<u16>(_api.invalidatedRows.x, endRow);
                 _api.invalidatedRows.y = _api.cellCount.y;
-
-                // scrollOffset/offset = -1
-                // +----------+    +----------+
-                // |          |    | xxxxxxxxx|         + dst  < beg
-                // | xxxxxxxxx| -> |xxxxxxx   |  + src  |      < beg - offset
-                // |xxxxxxx   |    |          |  |      v
-                // +----------+    +----------+  v             < end
-                {
-                    const auto beg = _r.cells.begin();
-                    const auto end = beg + count;
-                    std::move(beg - offset, end, beg);
-                }
-                {
-                    const auto beg = _r.cellGlyphMapping.begin();
-                    const auto end = beg + count;
-                    std::move(beg - offset, end, beg);
-                }
             }
             else
             {
                 // Scroll down.
                 _api.invalidatedRows.x = 0;
                 _api.invalidatedRows.y = nothingInvalid ? _api.scrollOffset : std::max<u16>(_api.invalidatedRows.y, _api.scrollOffset);
-
-                // scrollOffset/offset = 1
-                // +----------+    +----------+
-                // | xxxxxxxxx|    |          |  + src         < beg
-                // |xxxxxxx   | -> | xxxxxxxxx|  |      ^
-                // |          |    |xxxxxxx   |  v      |      < end - offset
-                // +----------+    +----------+         + dst  < end
-                {
-                    const auto beg = _r.cells.begin();
-                    const auto end = beg + count;
-                    std::move_backward(beg, end - offset, end);
-                }
-                {
-                    const auto beg = _r.cellGlyphMapping.begin();
-                    const auto end = beg + count;
-                    std::move_backward(beg, end - offset, end);
-                }
             }
+
+            // _r.cells is a ring buffer of rows, so instead of moving all cells around we simply rotate the ring.
+            // scrollOffset/cellRowOffset = -1
+            // +----------+    +----------+
+            // | aaaaaaaaa|    | aaaaaaaaa|  < physical row 0, viewport row 2 (invalid)
+            // |bbbbbbb   | -> |bbbbbbb   |  < physical row 1, viewport row 0
+            // |          |    |          |  < physical row 2, viewport row 1
+            // +----------+    +----------+
+            // The newly uncovered rows are invalid and repainted, which also uploads them in _uploadCells().
+            // The remaining rows are already on the GPU and only the cellRowOffset in the ConstBuffer changes.
+            const int rows = _r.cellCount.y;
+            _r.cellRowOffset = gsl::narrow_cast<u16>((_r.cellRowOffset - _api.scrollOffset + rows) % rows);
+            WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
         }
     }
 
@@ -280,7 +271,7 @@ try
 
             for (auto y = from; y < to; ++y)
             {
-                auto it = _r.cellGlyphMapping.data() + stride * y;
+                auto it = _getCellGlyphMapping(0, gsl::narrow_cast<u16>(y));
                 const auto end = it + stride;
                 for (; it != end; ++it)
                 {
@@ -301,7 +292,7 @@ CATCH_RETURN()
 [[nodiscard]] HRESULT AtlasEngine::EndPaint() noexcept
 try
 {
-    _flushBufferLine();
+    _flushPendingBufferLines();
 
     _api.invalidatedCursorArea = invalidatedAreaNone;
     _api.invalidatedRows = invalidatedRowsNone;
@@ -345,13 +336,25 @@ void AtlasEngine::WaitUntilCanRender() noexcept
 
 [[nodiscard]] HRESULT AtlasEngine::ResetLineTransform() noexcept
 {
-    return S_OK;
+    return PrepareLineTransform(LineRendition::SingleWidth, 0, 0);
 }
 
-[[nodiscard]] HRESULT AtlasEngine::PrepareLineTransform(const LineRendition lineRendition, const size_t targetRow, const size_t viewportLeft) noexcept
+// Unlike DxEngine we don't draw double width/height rows with a transform. Instead PaintBufferLine() places
+// their glyphs at twice the column and _drawGlyph() rasterizes them into tiles at twice the size. Such tiles
+// are keyed by AtlasKeyAttributes::lineRendition and get drawn in the same pass as all other cells.
+[[nodiscard]] HRESULT AtlasEngine::PrepareLineTransform(const LineRendition lineRendition, const size_t /*targetRow*/, const size_t /*viewportLeft*/) noexcept
+try
 {
+    if (_api.lineRendition != lineRendition)
+    {
+        // The previous row's text is only flushed once the next row is painted.
+        // It needs to be recorded with the rendition it was painted with.
+        _flushBufferLine();
+        _api.lineRendition = lineRendition;
+    }
     return S_OK;
 }
+CATCH_RETURN()
 
 [[nodiscard]] HRESULT AtlasEngine::PaintBackground() noexcept
 {
@@ -361,7 +364,9 @@ void AtlasEngine::WaitUntilCanRender() noexcept
 [[nodiscard]] HRESULT AtlasEngine::PaintBufferLine(const gsl::span<const Cluster> clusters, const til::point coord, const bool fTrimLeft, const bool lineWrapped) noexcept
 try
 {
-    const auto x = gsl::narrow_cast<u16>(clamp<int>(coord.X, 0, _api.cellCount.x));
+    // coord and the clusters are in buffer columns, which are twice as wide in double width/height rows.
+    const auto shift = _api.lineRendition != LineRendition::SingleWidth ? 1 : 0;
+    const auto x = gsl::narrow_cast<u16>(clamp<int>(coord.X << shift, 0, _api.cellCount.x));
     const auto y = gsl::narrow_cast<u16>(clamp<int>(coord.Y, 0, _api.cellCount.y));
 
     if (_api.lastPaintBufferLineCoord.y != y)
@@ -389,13 +394,13 @@ try
                 _api.bufferLineColumn.emplace_back(column);
             }
 
-            column += gsl::narrow_cast<u16>(cluster.GetColumns());
+            column += gsl::narrow_cast<u16>(cluster.GetColumns() << shift);
         }
 
         _api.bufferLineColumn.emplace_back(column);
 
         const BufferLineMetadata metadata{ _api.currentColor, _api.flags };
-        std::fill_n(_api.bufferLineMetadata.data() + x, column - x, metadata);
+        std::fill_n(_api.bufferLineMetadata.data() + x, std::min(column, _api.cellCount.x) - x, metadata);
     }
 
     return S_OK;
@@ -419,13 +424,30 @@ try
 }
 CATCH_RETURN()
 
+[[nodiscard]] HRESULT AtlasEngine::PaintBufferRow(const BufferRow& row) noexcept
+{
+    // Since AtlasEngine is final, these calls are direct and can be inlined,
+    // unlike the 3 virtual calls per run the renderer would otherwise make.
+    for (const auto& run : row.runs)
+    {
+        RETURN_IF_FAILED(UpdateDrawingBrushes(run.textAttributes, row.renderSettings, row.pData, run.usingSoftFont, false));
+        RETURN_IF_FAILED(PaintBufferLine(row.clusters.subspan(run.clustersBegin, run.clustersEnd - run.clustersBegin), run.coord, run.trimLeft, row.lineWrapped));
+
+        for (const auto& gridLines : row.gridLines.subspan(run.gridLinesBegin, run.gridLinesEnd - run.gridLinesBegin))
+        {
+            LOG_IF_FAILED(PaintBufferGridLines(gridLines.lines, gridLines.color, gridLines.cchLine, gridLines.coordTarget));
+        }
+    }
+    return S_OK;
+}
+
 [[nodiscard]] HRESULT AtlasEngine::PaintSelection(const til::rect& rect) noexcept
 try
 {
     // Unfortunately there's no step after Renderer::_PaintBufferOutput that
     // would inform us that it's done with the last AtlasEngine::PaintBufferLine.
-    // As such we got to call _flushBufferLine() here just to be sure.
-    _flushBufferLine();
+    // As such we got to call _flushPendingBufferLines() here just to be sure.
+    _flushPendingBufferLines();
 
     const u16r u16rect{
         rect.narrow_left<u16>(),
@@ -438,13 +460,34 @@ try
 }
 CATCH_RETURN()
 
+[[nodiscard]] HRESULT AtlasEngine::PaintHighlights(gsl::span<const til::rect> rects) noexcept
+try
+{
+    // See PaintSelection().
+    _flushPendingBufferLines();
+
+    // The shader tints the flagged cells with the highlightColor while it draws the frame anyways.
+    for (const auto& rect : rects)
+    {
+        const u16r u16rect{
+            rect.narrow_left<u16>(),
+            rect.narrow_top<u16>(),
+            rect.narrow_right<u16>(),
+            rect.narrow_bottom<u16>(),
+        };
+        _setCellFlags(u16rect, CellFlags::Highlighted, CellFlags::Highlighted);
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
 [[nodiscard]] HRESULT AtlasEngine::PaintCursor(const CursorOptions& options) noexcept
 try
 {
     // Unfortunately there's no step after Renderer::_PaintBufferOutput that
     // would inform us that it's done with the last AtlasEngine::PaintBufferLine.
-    // As such we got to call _flushBufferLine() here just to be sure.
-    _flushBufferLine();
+    // As such we got to call _flushPendingBufferLines() here just to be sure.
+    _flushPendingBufferLines();
 
     {
         const CachedCursorOptions cachedOptions{
@@ -509,8 +552,32 @@ try
             WI_ClearAllFlags(flags, CellFlags::UnderlineDotted | CellFlags::UnderlineDouble);
         }
 
-        const u32x2 newColors{ gsl::narrow_cast<u32>(fg), gsl::narrow_cast<u32>(bg) };
-        const AtlasKeyAttributes attributes{ 0, textAttributes.IsIntense() && renderSettings.GetRenderMode(RenderSettings::Mode::IntenseIsBold), textAttributes.IsItalic(), 0 };
+        u32x2 newColors{ gsl::narrow_cast<u32>(fg), gsl::narrow_cast<u32>(bg) };
+
+        // Cells refer to the palette where possible, so that changes to the color table
+        // only need to update the ConstBuffer instead of repainting all of the text.
+        auto [fgIndex, bgIndex] = renderSettings.GetAttributeColorIndices(textAttributes);
+        if (bgIndex && (bg >> 24) != 0xff)
+        {
+            // Only the default background may be translucent. It has its own palette entry.
+            bgIndex = *bgIndex == RenderSettings::DefaultBackgroundIndex ? std::optional{ paletteTranslucentBackgroundIndex } : std::nullopt;
+        }
+        if (fgIndex)
+        {
+            newColors.x = gsl::narrow_cast<u32>(*fgIndex);
+            WI_SetFlag(flags, CellFlags::PaletteForeground);
+        }
+        if (bgIndex)
+        {
+            newColors.y = gsl::narrow_cast<u32>(*bgIndex);
+            WI_SetFlag(flags, CellFlags::PaletteBackground);
+        }
+        if ((!fgIndex || !bgIndex) && !(textAttributes.GetForeground().IsRgb() && textAttributes.GetBackground().IsRgb()))
+        {
+            _api.paletteFallbackInUse = true;
+        }
+
+        const AtlasKeyAttributes attributes{ 0, textAttributes.IsIntense() && renderSettings.GetRenderMode(RenderSettings::Mode::IntenseIsBold), textAttributes.IsItalic(), 0, 0 };
 
         if (_api.attributes != attributes)
         {
@@ -521,10 +588,28 @@ try
         _api.attributes = attributes;
         _api.flags = flags;
     }
-    else if (textAttributes.BackgroundIsDefault() && bg != _r.backgroundColor)
+    else
     {
-        _r.backgroundColor = bg;
-        WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+        if (textAttributes.BackgroundIsDefault() && bg != _r.backgroundColor)
+        {
+            _r.backgroundColor = bg;
+            WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+        }
+
+        // This is called at the start of every frame, which makes it the place to pick up color table changes.
+        const auto& colorTable = renderSettings.GetColorTable();
+        const auto defaultBg = til::at(colorTable, renderSettings.GetColorAliasIndex(ColorAlias::DefaultBackground));
+        Palette palette{};
+        std::transform(colorTable.begin(), colorTable.end(), palette.begin(), [](const COLORREF c) noexcept { return c | 0xff000000; });
+        til::at(palette, RenderSettings::DefaultForegroundIndex) = til::at(colorTable, renderSettings.GetColorAliasIndex(ColorAlias::DefaultForeground)) | 0xff000000;
+        til::at(palette, RenderSettings::DefaultBackgroundIndex) = defaultBg | 0xff000000;
+        til::at(palette, paletteTranslucentBackgroundIndex) = defaultBg | _api.backgroundOpaqueMixin;
+
+        if (palette != _r.palette)
+        {
+            _r.palette = palette;
+            WI_SetFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+        }
     }
 
     return S_OK;
@@ -634,6 +719,18 @@ void AtlasEngine::_createResources()
         THROW_IF_FAILED(hr);
 
         _r.deviceContext = deviceContext.query<ID3D11DeviceContext1>();
+
+        // Besides the WARP fallback above, VMs without a GPU expose WARP as a "hardware"
+        // adapter as well, the "Microsoft Basic Render Driver", flagged as a software adapter.
+        if (const auto dxgiDevice = _r.device.try_query<IDXGIDevice>())
+        {
+            wil::com_ptr<IDXGIAdapter> adapter;
+            DXGI_ADAPTER_DESC1 desc{};
+            if (SUCCEEDED(dxgiDevice->GetAdapter(adapter.addressof())) && SUCCEEDED(adapter.query<IDXGIAdapter1>()->GetDesc1(&desc)))
+            {
+                _r.isWarp = WI_IsFlagSet(desc.Flags, DXGI_ADAPTER_FLAG_SOFTWARE);
+            }
+        }
     }
 
 #ifndef NDEBUG
@@ -657,11 +754,19 @@ void AtlasEngine::_createResources()
         THROW_IF_FAILED(_r.device->CreateBuffer(&desc, nullptr, _r.constantBuffer.put()));
     }
 
+    if (_r.isWarp)
+    {
+        CD3D11_RASTERIZER_DESC desc{ CD3D11_DEFAULT{} };
+        desc.ScissorEnable = TRUE;
+        THROW_IF_FAILED(_r.device->CreateRasterizerState(&desc, _r.scissorRasterizerState.put()));
+    }
+
     THROW_IF_FAILED(_r.device->CreateVertexShader(&shader_vs[0], sizeof(shader_vs), nullptr, _r.vertexShader.put()));
     THROW_IF_FAILED(_r.device->CreatePixelShader(&shader_ps[0], sizeof(shader_ps), nullptr, _r.pixelShader.put()));
 
+    // The glyph atlas lives on the device and needs to be recreated as well.
     WI_ClearFlag(_api.invalidations, ApiInvalidations::Device);
-    WI_SetAllFlags(_api.invalidations, ApiInvalidations::SwapChain);
+    WI_SetAllFlags(_api.invalidations, ApiInvalidations::SwapChain | ApiInvalidations::Font);
 }
 
 void AtlasEngine::_releaseSwapChain()
@@ -696,7 +801,8 @@ void AtlasEngine::_createSwapChain()
         desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
         desc.BufferCount = 2; // TODO: 3?
         desc.Scaling = DXGI_SCALING_NONE;
-        desc.SwapEffect = _sr.isWindows10OrGreater ? DXGI_SWAP_EFFECT_FLIP_DISCARD : DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+        // WARP only redraws the rows that changed, which requires the back buffers to retain their contents.
+        desc.SwapEffect = _sr.isWindows10OrGreater && !_r.isWarp ? DXGI_SWAP_EFFECT_FLIP_DISCARD : DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
         // * HWND swap chains can't do alpha.
         // * If our background is opaque we can enable "independent" flips by setting DXGI_SWAP_EFFECT_FLIP_DISCARD and DXGI_ALPHA_MODE_IGNORE.
         //   As our swap chain won't have to compose with DWM anymore it reduces the display latency dramatically.
@@ -745,8 +851,29 @@ void AtlasEngine::_createSwapChain()
         CATCH_LOG();
     }
 
+    // The glyph atlas doesn't depend on the swap chain and is kept, for instance when the background turns
+    // transparent. Only the swap chain's buffers and the D3D state that _releaseSwapChain() cleared are lost.
+    _updateSwapChainTransform();
+
     WI_ClearFlag(_api.invalidations, ApiInvalidations::SwapChain);
-    WI_SetAllFlags(_api.invalidations, ApiInvalidations::Size | ApiInvalidations::Font);
+    WI_SetAllFlags(_api.invalidations, ApiInvalidations::Size);
+}
+
+// D3D specifically for UpdateDpi()
+// This compensates for the built in scaling factor in a XAML SwapChainPanel (CompositionScaleX/Y).
+void AtlasEngine::_updateSwapChainTransform() const
+{
+    if (!_api.hwnd)
+    {
+        if (const auto swapChain2 = _r.swapChain.try_query<IDXGISwapChain2>())
+        {
+            const auto inverseScale = static_cast<float>(USER_DEFAULT_SCREEN_DPI) / static_cast<float>(_api.dpi);
+            DXGI_MATRIX_3X2_F matrix{};
+            matrix._11 = inverseScale;
+            matrix._22 = inverseScale;
+            THROW_IF_FAILED(swapChain2->SetMatrixTransform(&matrix));
+        }
+    }
 }
 
 void AtlasEngine::_recreateSizeDependentResources()
@@ -802,6 +929,9 @@ void AtlasEngine::_recreateSizeDependentResources()
         _r.cells = Buffer<Cell, 32>{ totalCellCount };
         _r.cellGlyphMapping = Buffer<TileHashMap::iterator>{ totalCellCount };
         _r.cellCount = _api.cellCount;
+        _r.cellRowOffset = 0;
+        _r.dirtyCellRows = Buffer<bool>{ _api.cellCount.y };
+        std::fill_n(_r.dirtyCellRows.data(), _r.dirtyCellRows.size(), true);
         _r.tileAllocator.setMaxArea(_api.sizeInPixel);
 
         // .clear() doesn't free the memory of these buffers.
@@ -810,20 +940,22 @@ void AtlasEngine::_recreateSizeDependentResources()
         _api.bufferLine.reserve(projectedTextSize);
         _api.bufferLineColumn.reserve(projectedTextSize + 1);
         _api.bufferLineMetadata = Buffer<BufferLineMetadata>{ _api.cellCount.x };
-        _api.analysisResults = {};
+        _api.pendingLines = {};
 
-        _api.clusterMap = Buffer<u16>{ projectedTextSize };
-        _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ projectedTextSize };
-        _api.glyphIndices = Buffer<u16>{ projectedGlyphSize };
-        _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ projectedGlyphSize };
-        _api.glyphAdvances = Buffer<f32>{ projectedGlyphSize };
-        _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ projectedGlyphSize };
+        if (_api.shapingScratch.empty())
+        {
+            _api.shapingScratch.emplace_back();
+        }
+        for (auto& scratch : _api.shapingScratch)
+        {
+            _resizeShapingScratch(scratch, projectedTextSize, projectedGlyphSize);
+        }
 
         D3D11_BUFFER_DESC desc;
         desc.ByteWidth = gsl::narrow<u32>(totalCellCount * sizeof(Cell)); // totalCellCount can theoretically be UINT32_MAX!
-        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.Usage = D3D11_USAGE_DEFAULT;
         desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        desc.CPUAccessFlags = 0;
         desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
         desc.StructureByteStride = sizeof(Cell);
         THROW_IF_FAILED(_r.device->CreateBuffer(&desc, nullptr, _r.cellBuffer.put()));
@@ -834,6 +966,10 @@ void AtlasEngine::_recreateSizeDependentResources()
     // This forces us to set up everything up from scratch again.
     _setShaderResources();
 
+    // The swap chain's buffers are new and both need to be drawn in full.
+    _r.frameDirtyRows = invalidatedRowsAll;
+    _r.previousFrameDirtyRows = invalidatedRowsAll;
+
     WI_ClearFlag(_api.invalidations, ApiInvalidations::Size);
     WI_SetAllFlags(_r.invalidations, RenderInvalidations::ConstBuffer);
 }
@@ -863,22 +999,11 @@ void AtlasEngine::_recreateFontDependentResources()
         _r.tileAllocator = TileAllocator{ _api.fontMetrics.cellSize, _api.sizeInPixel };
 
         _r.glyphs = {};
+        _r.shapedLines = {};
         _r.glyphQueue = {};
         _r.glyphQueue.reserve(64);
     }
-    // D3D specifically for UpdateDpi()
-    // This compensates for the built in scaling factor in a XAML SwapChainPanel (CompositionScaleX/Y).
-    if (!_api.hwnd)
-    {
-        if (const auto swapChain2 = _r.swapChain.try_query<IDXGISwapChain2>())
-        {
-            const auto inverseScale = static_cast<float>(USER_DEFAULT_SCREEN_DPI) / static_cast<float>(_api.dpi);
-            DXGI_MATRIX_3X2_F matrix{};
-            matrix._11 = inverseScale;
-            matrix._22 = inverseScale;
-            THROW_IF_FAILED(swapChain2->SetMatrixTransform(&matrix));
-        }
-    }
+    _updateSwapChainTransform();
 
     // D2D
     {
@@ -954,6 +1079,9 @@ void AtlasEngine::_recreateFontDependentResources()
         }
     }
 
+    _r.glyphAtlasKey = _getGlyphAtlasKey();
+    _seedGlyphAtlas();
+
     WI_ClearFlag(_api.invalidations, ApiInvalidations::Font);
     WI_SetAllFlags(_r.invalidations, RenderInvalidations::Cursor | RenderInvalidations::ConstBuffer);
 }
@@ -968,18 +1096,35 @@ const AtlasEngine::Buffer<DWRITE_FONT_AXIS_VALUE>& AtlasEngine::_getTextFormatAx
     return _r.textFormatAxes[italic][bold];
 }
 
+// Returns the row in _r.cells and _r.cellGlyphMapping that stores the given row of the viewport.
+u16 AtlasEngine::_getCellRow(u16 y) const noexcept
+{
+    assert(y < _r.cellCount.y);
+    const auto row = static_cast<u32>(y) + _r.cellRowOffset;
+    return gsl::narrow_cast<u16>(row >= _r.cellCount.y ? row - _r.cellCount.y : row);
+}
+
+// Marks the given [top, bottom) rows of the viewport as modified, so that _uploadCells() uploads them.
+// The rows are tracked individually, so that a change at the top and one at the bottom of
+// the viewport (the cursor and a status line for instance) don't upload everything in between.
+void AtlasEngine::_markCellRowsDirty(u16 top, u16 bottom) noexcept
+{
+    for (auto y = top; y < bottom; ++y)
+    {
+        _r.dirtyCellRows[_getCellRow(y)] = true;
+    }
+}
+
 AtlasEngine::Cell* AtlasEngine::_getCell(u16 x, u16 y) noexcept
 {
     assert(x < _r.cellCount.x);
-    assert(y < _r.cellCount.y);
-    return _r.cells.data() + static_cast<size_t>(_r.cellCount.x) * y + x;
+    return _r.cells.data() + static_cast<size_t>(_r.cellCount.x) * _getCellRow(y) + x;
 }
 
 AtlasEngine::TileHashMap::iterator* AtlasEngine::_getCellGlyphMapping(u16 x, u16 y) noexcept
 {
     assert(x < _r.cellCount.x);
-    assert(y < _r.cellCount.y);
-    return _r.cellGlyphMapping.data() + static_cast<size_t>(_r.cellCount.x) * y + x;
+    return _r.cellGlyphMapping.data() + static_cast<size_t>(_r.cellCount.x) * _getCellRow(y) + x;
 }
 
 void AtlasEngine::_setCellFlags(u16r coords, CellFlags mask, CellFlags bits) noexcept
@@ -989,15 +1134,19 @@ void AtlasEngine::_setCellFlags(u16r coords, CellFlags mask, CellFlags bits) noe
     assert(coords.right <= _r.cellCount.x);
     assert(coords.bottom <= _r.cellCount.y);
 
+    if (coords.left == coords.right)
+    {
+        return;
+    }
+
     const auto filter = ~mask;
     const auto width = static_cast<size_t>(coords.right) - coords.left;
-    const auto height = static_cast<size_t>(coords.bottom) - coords.top;
-    const auto stride = static_cast<size_t>(_r.cellCount.x);
-    auto row = _r.cells.data() + static_cast<size_t>(_r.cellCount.x) * coords.top + coords.left;
-    const auto end = row + height * stride;
 
-    for (; row != end; row += stride)
+    _markCellRowsDirty(coords.top, coords.bottom);
+
+    for (auto y = coords.top; y < coords.bottom; ++y)
     {
+        const auto row = _getCell(coords.left, y);
         const auto dataEnd = row + width;
         for (auto data = row; data != dataEnd; ++data)
         {
@@ -1007,6 +1156,75 @@ void AtlasEngine::_setCellFlags(u16r coords, CellFlags mask, CellFlags bits) noe
     }
 }
 
+// Returns a key that identifies everything that affects how our glyphs are rasterized.
+// Engines with identical keys can share their glyph atlas. See _publishGlyphAtlas().
+std::wstring AtlasEngine::_getGlyphAtlasKey() const
+{
+    std::wstring key{ _r.fontMetrics.fontName };
+    const auto append = [&](const void* data, size_t size) {
+        key.append(static_cast<const wchar_t*>(data), size / sizeof(wchar_t));
+    };
+
+    const std::array<u16, 8> metrics{
+        0, // separates the font name from the rest of the key
+        _r.fontMetrics.cellSize.x,
+        _r.fontMetrics.cellSize.y,
+        _r.fontMetrics.fontWeight,
+        _r.dpi,
+        _api.realizedAntialiasingMode,
+        gsl::narrow_cast<u16>(_api.fontFeatures.size()),
+        gsl::narrow_cast<u16>(_api.fontAxisValues.size()),
+    };
+    append(metrics.data(), sizeof(metrics));
+    append(&_r.fontMetrics.fontSizeInDIP, sizeof(_r.fontMetrics.fontSizeInDIP));
+    append(_api.fontFeatures.data(), _api.fontFeatures.size() * sizeof(DWRITE_FONT_FEATURE));
+    append(_api.fontAxisValues.data(), _api.fontAxisValues.size() * sizeof(DWRITE_FONT_AXIS_VALUE));
+    return key;
+}
+
+// If another engine published a glyph atlas with the same font settings,
+// this copies its glyphs into our (otherwise empty) _r.glyphs. The texture itself
+// is copied over the next time _adjustAtlasSize() creates our atlas texture.
+void AtlasEngine::_seedGlyphAtlas() noexcept
+try
+{
+    std::shared_ptr<const GlyphAtlasSnapshot> snapshot;
+    {
+        auto& snapshots = _getGlyphAtlasSnapshots();
+        const std::scoped_lock lock{ snapshots.mutex };
+        const auto it = std::find_if(snapshots.items.begin(), snapshots.items.end(), [&](const auto& item) {
+            return item->key == _r.glyphAtlasKey;
+        });
+        if (it == snapshots.items.end())
+        {
+            return;
+        }
+        snapshot = *it;
+    }
+
+    // Shared textures can only be opened by devices on the same adapter.
+    const auto adapterLuid = _getAdapterLuid();
+    if (adapterLuid.LowPart != snapshot->adapterLuid.LowPart || adapterLuid.HighPart != snapshot->adapterLuid.HighPart)
+    {
+        return;
+    }
+
+    // The tile allocator and seed are set first, so that we end up in a consistent state
+    // even if we fail to copy all glyphs: The missing ones just get rasterized again.
+    _r.tileAllocator = snapshot->tileAllocator;
+    _r.tileAllocator.setMaxArea(_api.sizeInPixel);
+    _r.glyphAtlasSeed = snapshot;
+
+    // TileHashMap::insert() inserts at the head of the LRU queue.
+    // Inserting from oldest to newest thus preserves the order of the snapshot.
+    for (auto it = snapshot->glyphs.rbegin(); it != snapshot->glyphs.rend(); ++it)
+    {
+        auto [key, value] = _cloneGlyph(it->first, it->second);
+        _r.glyphs.insert(std::move(key), std::move(value));
+    }
+}
+CATCH_LOG()
+
 void AtlasEngine::_flushBufferLine()
 {
     if (_api.bufferLine.empty())
@@ -1022,6 +1240,164 @@ void AtlasEngine::_flushBufferLine()
     // This would seriously blow us up otherwise.
     Expects(_api.bufferLineColumn.size() == _api.bufferLine.size() + 1);
 
+    // The line is only shaped once _flushPendingBufferLines() is called, which allows us to shape all lines
+    // of a frame in parallel. The metadata needs to be copied, because the next run of text in the same row
+    // reuses _api.bufferLineMetadata. The text buffers are simply swapped with the spare ones of the line.
+    if (_api.pendingLineCount == _api.pendingLines.size())
+    {
+        _api.pendingLines.emplace_back();
+    }
+
+    auto& line = _api.pendingLines[_api.pendingLineCount];
+    const auto [minColumn, maxColumn] = std::minmax_element(_api.bufferLineColumn.begin(), _api.bufferLineColumn.end());
+    const auto metadataBeg = _api.bufferLineMetadata.data() + *minColumn;
+    const auto metadataEnd = _api.bufferLineMetadata.data() + std::min(*maxColumn, _api.cellCount.x);
+
+    line.metadata.assign(metadataBeg, std::max(metadataBeg, metadataEnd));
+    line.metadataOffset = *minColumn;
+    line.text.clear();
+    line.text.swap(_api.bufferLine);
+    line.columns.clear();
+    line.columns.swap(_api.bufferLineColumn);
+    line.clusters.clear();
+    line.fontFaces.clear();
+    line.attributes = _api.attributes;
+    line.attributes.lineRendition = static_cast<u16>(_api.lineRendition);
+    line.y = _api.lastPaintBufferLineCoord.y;
+    line.hr = S_OK;
+    line.cached = false;
+    ++_api.pendingLineCount;
+}
+
+void AtlasEngine::_flushPendingBufferLines()
+{
+    _flushBufferLine();
+
+    const auto lineCount = _api.pendingLineCount;
+    if (!lineCount)
+    {
+        return;
+    }
+
+    const auto cleanup = wil::scope_exit([this]() noexcept {
+        _api.pendingLineCount = 0;
+    });
+
+    // Segmenting text into clusters is by far the most expensive part of a frame. It only reads shared state
+    // and is thus spread across the thread pool if there's enough of it. Turning clusters into glyphs on the
+    // other hand modifies the glyph atlas (_r.glyphs, _r.tileAllocator, _r.glyphQueue) as well as _r.cells.
+    // That part is cheap for glyphs we've already seen and remains on the render thread.
+    // Most lines of a frame are usually repainted unchanged however and can skip shaping entirely.
+    size_t uncachedCount = 0;
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        auto& line = _api.pendingLines[i];
+        line.cached = _r.shapedLines.find(line, _api.cellCount.x);
+        uncachedCount += !line.cached;
+    }
+
+    const auto workerCount = std::min({ uncachedCount / parallelShapingLinesPerWorker, parallelShapingMaxWorkers, size_t{ std::thread::hardware_concurrency() } });
+    if (workerCount > 1)
+    {
+        _shapePendingBufferLinesParallel(workerCount);
+    }
+    else if (uncachedCount)
+    {
+        _api.shapingNextLine = 0;
+        _shapePendingBufferLines(_api.shapingScratch[0]);
+    }
+
+    // Lines are processed in the order they were painted, same as if they were shaped right away.
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        const auto& line = _api.pendingLines[i];
+        THROW_IF_FAILED(line.hr);
+
+        if (!line.cached)
+        {
+            _r.shapedLines.insert(line, _api.cellCount.x);
+        }
+
+        for (const auto& cluster : line.clusters)
+        {
+            _emplaceGlyph(line, cluster.fontFace, cluster.bufferPos1, cluster.bufferPos2);
+        }
+    }
+}
+
+void AtlasEngine::_shapePendingBufferLinesParallel(const size_t workerCount)
+{
+    if (!_api.shapingWork)
+    {
+        _api.shapingWork.reset(CreateThreadpoolWork(&_shapePendingBufferLinesCallback, this, nullptr));
+        THROW_LAST_ERROR_IF(!_api.shapingWork);
+    }
+
+    if (_api.shapingScratch.size() < workerCount)
+    {
+        const auto textSize = _api.shapingScratch[0].clusterMap.size();
+        const auto glyphSize = _api.shapingScratch[0].glyphIndices.size();
+        auto i = _api.shapingScratch.size();
+
+        _api.shapingScratch.resize(workerCount);
+        for (; i < workerCount; ++i)
+        {
+            _resizeShapingScratch(_api.shapingScratch[i], textSize, glyphSize);
+        }
+    }
+
+    _api.shapingNextLine = 0;
+    _api.shapingNextScratch = 1;
+
+    for (size_t i = 1; i < workerCount; ++i)
+    {
+        SubmitThreadpoolWork(_api.shapingWork.get());
+    }
+
+    // The render thread pitches in instead of idly waiting for the workers.
+    // Errors are stored in PendingBufferLine::hr and rethrown by our caller.
+    _shapePendingBufferLines(_api.shapingScratch[0]);
+    WaitForThreadpoolWorkCallbacks(_api.shapingWork.get(), FALSE);
+}
+
+void CALLBACK AtlasEngine::_shapePendingBufferLinesCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+{
+    const auto self = static_cast<AtlasEngine*>(context);
+    const auto index = self->_api.shapingNextScratch.fetch_add(1, std::memory_order_relaxed);
+    self->_shapePendingBufferLines(self->_api.shapingScratch[index]);
+}
+
+void AtlasEngine::_shapePendingBufferLines(ShapingScratch& scratch) noexcept
+{
+    for (;;)
+    {
+        const auto index = _api.shapingNextLine.fetch_add(1, std::memory_order_relaxed);
+        if (index >= _api.pendingLineCount)
+        {
+            break;
+        }
+
+        auto& line = _api.pendingLines[index];
+        if (line.cached)
+        {
+            continue;
+        }
+
+        try
+        {
+            _shapeBufferLine(line, scratch);
+        }
+        catch (...)
+        {
+            line.hr = wil::ResultFromCaughtException();
+        }
+    }
+}
+
+// This function may be called on any thread (see _shapePendingBufferLines())
+// and must not modify any state except for that of the given line and scratch.
+void AtlasEngine::_shapeBufferLine(PendingBufferLine& line, ShapingScratch& scratch) const
+{
     // NOTE:
     // This entire function is one huge hack to see if it works.
 
@@ -1029,7 +1405,7 @@ void AtlasEngine::_flushBufferLine()
     //
     // # What do we want?
     //
-    // Segment a line of text (_api.bufferLine) into unicode "clusters".
+    // Segment a line of text (line.text) into unicode "clusters".
     // Each cluster is one "whole" glyph with diacritics, ligatures, zero width joiners
     // and whatever else, that should be cached as a whole in our texture atlas.
     //
@@ -1055,11 +1431,11 @@ void AtlasEngine::_flushBufferLine()
     //
     // Font fallback with IDWriteFontFallback::MapCharacters is very slow.
 
-    const auto textFormat = _getTextFormat(_api.attributes.bold, _api.attributes.italic);
-    const auto& textFormatAxis = _getTextFormatAxis(_api.attributes.bold, _api.attributes.italic);
+    const auto textFormat = _getTextFormat(line.attributes.bold, line.attributes.italic);
+    const auto& textFormatAxis = _getTextFormatAxis(line.attributes.bold, line.attributes.italic);
 
-    TextAnalysisSource analysisSource{ _api.bufferLine.data(), gsl::narrow<UINT32>(_api.bufferLine.size()) };
-    TextAnalysisSink analysisSink{ _api.analysisResults };
+    TextAnalysisSource analysisSource{ line.text.data(), gsl::narrow<UINT32>(line.text.size()) };
+    TextAnalysisSink analysisSink{ scratch.analysisResults };
 
     wil::com_ptr<IDWriteFontCollection> fontCollection;
     THROW_IF_FAILED(textFormat->GetFontCollection(fontCollection.addressof()));
@@ -1067,7 +1443,7 @@ void AtlasEngine::_flushBufferLine()
     wil::com_ptr<IDWriteFontFace> mappedFontFace;
 
 #pragma warning(suppress : 26494) // Variable 'mappedEnd' is uninitialized. Always initialize an object (type.5).
-    for (u32 idx = 0, mappedEnd; idx < _api.bufferLine.size(); idx = mappedEnd)
+    for (u32 idx = 0, mappedEnd; idx < line.text.size(); idx = mappedEnd)
     {
         if (_sr.systemFontFallback)
         {
@@ -1080,7 +1456,7 @@ void AtlasEngine::_flushBufferLine()
                 THROW_IF_FAILED(_sr.systemFontFallback.query<IDWriteFontFallback1>()->MapCharacters(
                     /* analysisSource */ &analysisSource,
                     /* textPosition */ idx,
-                    /* textLength */ gsl::narrow_cast<u32>(_api.bufferLine.size()) - idx,
+                    /* textLength */ gsl::narrow_cast<u32>(line.text.size()) - idx,
                     /* baseFontCollection */ fontCollection.get(),
                     /* baseFamilyName */ _api.fontMetrics.fontName.c_str(),
                     /* fontAxisValues */ textFormatAxis.data(),
@@ -1092,14 +1468,14 @@ void AtlasEngine::_flushBufferLine()
             }
             else
             {
-                const auto baseWeight = _api.attributes.bold ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_api.fontMetrics.fontWeight);
-                const auto baseStyle = _api.attributes.italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
+                const auto baseWeight = line.attributes.bold ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_api.fontMetrics.fontWeight);
+                const auto baseStyle = line.attributes.italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
                 wil::com_ptr<IDWriteFont> font;
 
                 THROW_IF_FAILED(_sr.systemFontFallback->MapCharacters(
                     /* analysisSource     */ &analysisSource,
                     /* textPosition       */ idx,
-                    /* textLength         */ gsl::narrow_cast<u32>(_api.bufferLine.size()) - idx,
+                    /* textLength         */ gsl::narrow_cast<u32>(line.text.size()) - idx,
                     /* baseFontCollection */ fontCollection.get(),
                     /* baseFamilyName     */ _api.fontMetrics.fontName.c_str(),
                     /* baseWeight         */ baseWeight,
@@ -1122,20 +1498,20 @@ void AtlasEngine::_flushBufferLine()
             {
                 // Task: Replace all characters in this range with unicode replacement characters.
                 // Input (where "n" is a narrow and "ww" is a wide character):
-                //    _api.bufferLine       = "nwwnnw"
-                //    _api.bufferLineColumn = {0, 1, 1, 3, 4, 5, 5, 6}
+                //    line.text       = "nwwnnw"
+                //    line.columns = {0, 1, 1, 3, 4, 5, 5, 6}
                 //                             n  w  w  n  n  w  w
                 // Solution:
                 //   Iterate through bufferLineColumn until the value changes, because this indicates we passed over a
                 //   complete (narrow or wide) cell. To do so we'll use col1 (previous column) and col2 (next column).
-                //   Then we emit a replacement character by telling _emplaceGlyph that this range has no font face.
+                //   Then we emit a replacement character by telling _emplaceCluster that this range has no font face.
                 auto pos1 = idx;
-                auto col1 = _api.bufferLineColumn[pos1];
+                auto col1 = line.columns[pos1];
                 for (auto pos2 = idx + 1; pos2 <= mappedEnd; ++pos2)
                 {
-                    if (const auto col2 = _api.bufferLineColumn[pos2]; col1 != col2)
+                    if (const auto col2 = line.columns[pos2]; col1 != col2)
                     {
-                        _emplaceGlyph(nullptr, pos1, pos2);
+                        _emplaceCluster(line, nullptr, pos1, pos2);
                         pos1 = pos2;
                         col1 = col2;
                     }
@@ -1148,8 +1524,8 @@ void AtlasEngine::_flushBufferLine()
         {
             if (!mappedFontFace)
             {
-                const auto baseWeight = _api.attributes.bold ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_api.fontMetrics.fontWeight);
-                const auto baseStyle = _api.attributes.italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
+                const auto baseWeight = line.attributes.bold ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_api.fontMetrics.fontWeight);
+                const auto baseStyle = line.attributes.italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
 
                 wil::com_ptr<IDWriteFontFamily> fontFamily;
                 THROW_IF_FAILED(fontCollection->GetFontFamily(0, fontFamily.addressof()));
@@ -1160,21 +1536,21 @@ void AtlasEngine::_flushBufferLine()
                 THROW_IF_FAILED(font->CreateFontFace(mappedFontFace.put()));
             }
 
-            mappedEnd = gsl::narrow_cast<u32>(_api.bufferLine.size());
+            mappedEnd = gsl::narrow_cast<u32>(line.text.size());
         }
 
         // We can reuse idx here, as it'll be reset to "idx = mappedEnd" in the outer loop anyways.
         for (u32 complexityLength = 0; idx < mappedEnd; idx += complexityLength)
         {
             BOOL isTextSimple;
-            THROW_IF_FAILED(_sr.textAnalyzer->GetTextComplexity(_api.bufferLine.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, _api.glyphIndices.data()));
+            THROW_IF_FAILED(_sr.textAnalyzer->GetTextComplexity(line.text.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, scratch.glyphIndices.data()));
 
             if (isTextSimple)
             {
                 size_t beg = 0;
                 for (size_t i = 0; i < complexityLength; ++i)
                 {
-                    if (_emplaceGlyph(mappedFontFace.get(), idx + beg, idx + i + 1))
+                    if (_emplaceCluster(line, mappedFontFace.get(), idx + beg, idx + i + 1))
                     {
                         beg = i + 1;
                     }
@@ -1182,11 +1558,11 @@ void AtlasEngine::_flushBufferLine()
             }
             else
             {
-                _api.analysisResults.clear();
+                scratch.analysisResults.clear();
                 THROW_IF_FAILED(_sr.textAnalyzer->AnalyzeScript(&analysisSource, idx, complexityLength, &analysisSink));
                 //_sr.textAnalyzer->AnalyzeBidi(&atlasAnalyzer, idx, complexityLength, &atlasAnalyzer);
 
-                for (const auto& a : _api.analysisResults)
+                for (const auto& a : scratch.analysisResults)
                 {
                     DWRITE_SCRIPT_ANALYSIS scriptAnalysis{ a.script, static_cast<DWRITE_SCRIPT_SHAPES>(a.shapes) };
                     u32 actualGlyphCount = 0;
@@ -1211,16 +1587,16 @@ void AtlasEngine::_flushBufferLine()
                         featureRanges = 1;
                     }
 
-                    if (_api.clusterMap.size() < a.textLength)
+                    if (scratch.clusterMap.size() < a.textLength)
                     {
-                        _api.clusterMap = Buffer<u16>{ a.textLength };
-                        _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
+                        scratch.clusterMap = Buffer<u16>{ a.textLength };
+                        scratch.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
                     }
 
                     for (auto retry = 0;;)
                     {
                         const auto hr = _sr.textAnalyzer->GetGlyphs(
-                            /* textString          */ _api.bufferLine.data() + a.textPosition,
+                            /* textString          */ line.text.data() + a.textPosition,
                             /* textLength          */ a.textLength,
                             /* fontFace            */ mappedFontFace.get(),
                             /* isSideways          */ false,
@@ -1231,22 +1607,22 @@ void AtlasEngine::_flushBufferLine()
                             /* features            */ &features,
                             /* featureRangeLengths */ &featureRangeLengths,
                             /* featureRanges       */ featureRanges,
-                            /* maxGlyphCount       */ gsl::narrow_cast<u32>(_api.glyphProps.size()),
-                            /* clusterMap          */ _api.clusterMap.data(),
-                            /* textProps           */ _api.textProps.data(),
-                            /* glyphIndices        */ _api.glyphIndices.data(),
-                            /* glyphProps          */ _api.glyphProps.data(),
+                            /* maxGlyphCount       */ gsl::narrow_cast<u32>(scratch.glyphProps.size()),
+                            /* clusterMap          */ scratch.clusterMap.data(),
+                            /* textProps           */ scratch.textProps.data(),
+                            /* glyphIndices        */ scratch.glyphIndices.data(),
+                            /* glyphProps          */ scratch.glyphProps.data(),
                             /* actualGlyphCount    */ &actualGlyphCount);
 
                         if (hr == HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER) && ++retry < 8)
                         {
                             // Grow factor 1.5x.
-                            auto size = _api.glyphProps.size();
+                            auto size = scratch.glyphProps.size();
                             size = size + (size >> 1);
                             // Overflow check.
-                            Expects(size > _api.glyphProps.size());
-                            _api.glyphIndices = Buffer<u16>{ size };
-                            _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>(size);
+                            Expects(size > scratch.glyphProps.size());
+                            scratch.glyphIndices = Buffer<u16>{ size };
+                            scratch.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>(size);
                             continue;
                         }
 
@@ -1254,24 +1630,24 @@ void AtlasEngine::_flushBufferLine()
                         break;
                     }
 
-                    if (_api.glyphAdvances.size() < actualGlyphCount)
+                    if (scratch.glyphAdvances.size() < actualGlyphCount)
                     {
                         // Grow the buffer by at least 1.5x and at least of `actualGlyphCount` items.
                         // The 1.5x growth ensures we don't reallocate every time we need 1 more slot.
-                        auto size = _api.glyphAdvances.size();
+                        auto size = scratch.glyphAdvances.size();
                         size = size + (size >> 1);
                         size = std::max<size_t>(size, actualGlyphCount);
-                        _api.glyphAdvances = Buffer<f32>{ size };
-                        _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
+                        scratch.glyphAdvances = Buffer<f32>{ size };
+                        scratch.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
                     }
 
                     THROW_IF_FAILED(_sr.textAnalyzer->GetGlyphPlacements(
-                        /* textString          */ _api.bufferLine.data() + a.textPosition,
-                        /* clusterMap          */ _api.clusterMap.data(),
-                        /* textProps           */ _api.textProps.data(),
+                        /* textString          */ line.text.data() + a.textPosition,
+                        /* clusterMap          */ scratch.clusterMap.data(),
+                        /* textProps           */ scratch.textProps.data(),
                         /* textLength          */ a.textLength,
-                        /* glyphIndices        */ _api.glyphIndices.data(),
-                        /* glyphProps          */ _api.glyphProps.data(),
+                        /* glyphIndices        */ scratch.glyphIndices.data(),
+                        /* glyphProps          */ scratch.glyphProps.data(),
                         /* glyphCount          */ actualGlyphCount,
                         /* fontFace            */ mappedFontFace.get(),
                         /* fontEmSize          */ _api.fontMetrics.fontSizeInDIP,
@@ -1282,17 +1658,17 @@ void AtlasEngine::_flushBufferLine()
                         /* features            */ &features,
                         /* featureRangeLengths */ &featureRangeLengths,
                         /* featureRanges       */ featureRanges,
-                        /* glyphAdvances       */ _api.glyphAdvances.data(),
-                        /* glyphOffsets        */ _api.glyphOffsets.data()));
+                        /* glyphAdvances       */ scratch.glyphAdvances.data(),
+                        /* glyphOffsets        */ scratch.glyphOffsets.data()));
 
-                    _api.textProps[a.textLength - 1].canBreakShapingAfter = 1;
+                    scratch.textProps[a.textLength - 1].canBreakShapingAfter = 1;
 
                     size_t beg = 0;
                     for (size_t i = 0; i < a.textLength; ++i)
                     {
-                        if (_api.textProps[i].canBreakShapingAfter)
+                        if (scratch.textProps[i].canBreakShapingAfter)
                         {
-                            if (_emplaceGlyph(mappedFontFace.get(), a.textPosition + beg, a.textPosition + i + 1))
+                            if (_emplaceCluster(line, mappedFontFace.get(), a.textPosition + beg, a.textPosition + i + 1))
                             {
                                 beg = i + 1;
                             }
@@ -1305,27 +1681,25 @@ void AtlasEngine::_flushBufferLine()
 }
 // ^^^ Look at that amazing 8-fold nesting level. Lovely. <3
 
-bool AtlasEngine::_emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2)
+bool AtlasEngine::_emplaceCluster(PendingBufferLine& line, IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2) const
 {
-    static constexpr auto replacement = L'\uFFFD';
-
     // This would seriously blow us up otherwise.
-    Expects(bufferPos1 < bufferPos2 && bufferPos2 <= _api.bufferLine.size());
+    Expects(bufferPos1 < bufferPos2 && bufferPos2 <= line.text.size());
 
-    // _flushBufferLine() ensures that bufferLineColumn.size() > bufferLine.size().
-    const auto x1 = _api.bufferLineColumn[bufferPos1];
-    const auto x2 = _api.bufferLineColumn[bufferPos2];
+    // _flushBufferLine() ensures that columns.size() > text.size().
+    const auto x1 = line.columns[bufferPos1];
+    const auto x2 = line.columns[bufferPos2];
 
     // x1 == x2, if our TextBuffer and DirectWrite disagree where glyph boundaries are. Example:
     // Our line of text contains a wide glyph consisting of 2 surrogate pairs "xx" and "yy".
     // If DirectWrite considers the first "xx" to be separate from the second "yy", we'll get:
-    //   _api.bufferLine       = "...xxyy..."
-    //   _api.bufferLineColumn = {01233335678}
-    //                               ^ ^
-    //                              /   \
-    //                      bufferPos1  bufferPos2
-    //   x1: _api.bufferLineColumn[bufferPos1] == 3
-    //   x1: _api.bufferLineColumn[bufferPos2] == 3
+    //   line.text    = "...xxyy..."
+    //   line.columns = {01233335678}
+    //                      ^ ^
+    //                     /   \
+    //             bufferPos1  bufferPos2
+    //   x1: line.columns[bufferPos1] == 3
+    //   x1: line.columns[bufferPos2] == 3
     // --> cellCount (which is x2 - x1) is now 0 (invalid).
     //
     // Assuming that the TextBuffer implementation doesn't have any bugs...
@@ -1337,12 +1711,110 @@ bool AtlasEngine::_emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, si
         return false;
     }
 
-    const auto chars = fontFace ? &_api.bufferLine[bufferPos1] : &replacement;
+    if (fontFace && (line.fontFaces.empty() || line.fontFaces.back().get() != fontFace))
+    {
+        line.fontFaces.emplace_back(fontFace);
+    }
+
+    line.clusters.emplace_back(ShapedCluster{ fontFace, gsl::narrow_cast<u32>(bufferPos1), gsl::narrow_cast<u32>(bufferPos2) });
+    return true;
+}
+
+// Box drawing lines (0x2500-0x257F) are described by the width of their 4 arms. They're 2 bits each
+// (0 = none, 1 = light, 2 = heavy) in the order left, up, right, down from the lowest bit upwards.
+// 0 marks characters like the dashed, double, rounded and diagonal lines, which are left to the font.
+static constexpr std::array<uint8_t, 128> builtinBoxDrawing{
+        0x11, 0x22, 0x44, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x60, 0x90, 0xa0, // U+2500
+        0x41, 0x42, 0x81, 0x82, 0x14, 0x24, 0x18, 0x28, 0x05, 0x06, 0x09, 0x0a, 0x54, 0x64, 0x58, 0x94, // U+2510
+        0x98, 0x68, 0xa4, 0xa8, 0x45, 0x46, 0x49, 0x85, 0x89, 0x4a, 0x86, 0x8a, 0x51, 0x52, 0x61, 0x62, // U+2520
+        0x91, 0x92, 0xa1, 0xa2, 0x15, 0x16, 0x25, 0x26, 0x19, 0x1a, 0x29, 0x2a, 0x55, 0x56, 0x65, 0x66, // U+2530
+        0x59, 0x95, 0x99, 0x5a, 0x69, 0x96, 0xa5, 0x6a, 0xa6, 0x9a, 0xa9, 0xaa, 0x00, 0x00, 0x00, 0x00, // U+2540
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // U+2550
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // U+2560
+        0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x10, 0x40, 0x02, 0x08, 0x20, 0x80, 0x21, 0x84, 0x12, 0x48, // U+2570
+};
+
+// See BuiltinGlyph_Rect in shader_ps.hlsl. l/t/r/b are in eighths of a cell.
+static constexpr uint32_t builtinRect(uint32_t l, uint32_t t, uint32_t r, uint32_t b, uint32_t shade = 0) noexcept
+{
+    return 1u << 30 | shade << 16 | b << 12 | r << 8 | t << 4 | l;
+}
+
+// See BuiltinGlyph_Quadrants in shader_ps.hlsl.
+static constexpr uint32_t builtinQuadrants(uint32_t mask) noexcept
+{
+    return 2u << 30 | mask;
+}
+
+// Block elements (0x2580-0x259F).
+static constexpr std::array<uint32_t, 32> builtinBlockElements{
+    builtinRect(0, 0, 8, 4), // ▀ upper half
+    builtinRect(0, 7, 8, 8), // ▁ lower 1/8
+    builtinRect(0, 6, 8, 8), // ▂
+    builtinRect(0, 5, 8, 8), // ▃
+    builtinRect(0, 4, 8, 8), // ▄ lower half
+    builtinRect(0, 3, 8, 8), // ▅
+    builtinRect(0, 2, 8, 8), // ▆
+    builtinRect(0, 1, 8, 8), // ▇
+    builtinRect(0, 0, 8, 8), // █ full block
+    builtinRect(0, 0, 7, 8), // ▉ left 7/8
+    builtinRect(0, 0, 6, 8), // ▊
+    builtinRect(0, 0, 5, 8), // ▋
+    builtinRect(0, 0, 4, 8), // ▌ left half
+    builtinRect(0, 0, 3, 8), // ▍
+    builtinRect(0, 0, 2, 8), // ▎
+    builtinRect(0, 0, 1, 8), // ▏
+    builtinRect(4, 0, 8, 8), // ▐ right half
+    builtinRect(0, 0, 8, 8, 1), // ░ light shade
+    builtinRect(0, 0, 8, 8, 2), // ▒ medium shade
+    builtinRect(0, 0, 8, 8, 3), // ▓ dark shade
+    builtinRect(0, 0, 8, 1), // ▔ upper 1/8
+    builtinRect(7, 0, 8, 8), // ▕ right 1/8
+    builtinQuadrants(0b0100), // ▖
+    builtinQuadrants(0b1000), // ▗
+    builtinQuadrants(0b0001), // ▘
+    builtinQuadrants(0b1101), // ▙
+    builtinQuadrants(0b1001), // ▚
+    builtinQuadrants(0b0111), // ▛
+    builtinQuadrants(0b1011), // ▜
+    builtinQuadrants(0b0010), // ▝
+    builtinQuadrants(0b0110), // ▞
+    builtinQuadrants(0b1110), // ▟
+};
+
+// Returns the shape the shader draws for the given character (see builtinGlyphCoverage() in shader_ps.hlsl)
+// or 0 if it's not one of the box drawing or block element characters we draw ourselves.
+AtlasEngine::u32 AtlasEngine::_getBuiltinGlyph(const wchar_t ch) noexcept
+{
+    if (ch >= 0x2500 && ch < 0x2580)
+    {
+        return builtinBoxDrawing[ch - 0x2500];
+    }
+    if (ch >= 0x2580 && ch < 0x25A0)
+    {
+        return builtinBlockElements[ch - 0x2580];
+    }
+    return 0;
+}
+
+void AtlasEngine::_emplaceGlyph(const PendingBufferLine& line, IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2)
+{
+    static constexpr auto replacement = L'\uFFFD';
+
+    // _emplaceCluster() ensured that x1 < x2 <= _api.cellCount.x.
+    const auto x1 = line.columns[bufferPos1];
+    const auto x2 = line.columns[bufferPos2];
+
+    const auto chars = fontFace ? &line.text[bufferPos1] : &replacement;
     const auto charCount = fontFace ? bufferPos2 - bufferPos1 : 1;
     const u16 cellCount = x2 - x1;
 
-    auto attributes = _api.attributes;
-    attributes.cellCount = cellCount;
+    // Box drawing and block element characters in regular rows are drawn by the shader and don't need any tiles.
+    // They still get an entry with a cellCount of 0 in _r.glyphs, because _r.cellGlyphMapping needs one.
+    const auto builtinGlyph = charCount == 1 && cellCount == 1 && line.attributes.lineRendition == 0 ? _getBuiltinGlyph(*chars) : 0;
+
+    auto attributes = line.attributes;
+    attributes.cellCount = builtinGlyph ? 0 : cellCount;
 
     AtlasKey key{ attributes, gsl::narrow<u16>(charCount), chars };
     auto it = _r.glyphs.find(key);
@@ -1368,8 +1840,8 @@ bool AtlasEngine::_emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, si
         //
         // So this is a job for future me/someone.
         // Bonus points for doing it without impacting performance.
-        auto flags = CellFlags::None;
-        if (fontFace)
+        auto flags = builtinGlyph ? CellFlags::BuiltinGlyph : CellFlags::None;
+        if (fontFace && !builtinGlyph)
         {
             const auto fontFace2 = wil::try_com_query<IDWriteFontFace2>(fontFace);
             WI_SetFlagIf(flags, CellFlags::ColoredGlyph, fontFace2 && fontFace2->IsColorFont());
@@ -1379,32 +1851,47 @@ bool AtlasEngine::_emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, si
         // of at least `cellCount` elements. I did this so that I don't have to type out
         // `value.data()->coords` again, despite the constructor having all the data necessary.
         u16x2* coords;
-        AtlasValue value{ flags, cellCount, &coords };
+        AtlasValue value{ flags, attributes.cellCount, &coords };
 
-        for (u16 i = 0; i < cellCount; ++i)
+        for (u16 i = 0; i < attributes.cellCount; ++i)
         {
             coords[i] = _r.tileAllocator.allocate(_r.glyphs);
         }
 
         it = _r.glyphs.insert(std::move(key), std::move(value));
-        _r.glyphQueue.emplace_back(&it->first, &it->second);
+        if (!builtinGlyph)
+        {
+            _r.glyphQueue.emplace_back(&it->first, &it->second);
+        }
     }
 
     const auto valueData = it->second.data();
     const auto coords = &valueData->coords[0];
-    const auto cells = _getCell(x1, _api.lastPaintBufferLineCoord.y);
-    const auto cellGlyphMappings = _getCellGlyphMapping(x1, _api.lastPaintBufferLineCoord.y);
+    const auto cells = _getCell(x1, line.y);
+    const auto cellGlyphMappings = _getCellGlyphMapping(x1, line.y);
+    _markCellRowsDirty(line.y, line.y + 1);
+    const auto metadata = line.metadata.data() + (x1 - line.metadataOffset);
 
     for (u32 i = 0; i < cellCount; ++i)
     {
-        cells[i].tileIndex = coords[i];
+        cells[i].tileIndex = builtinGlyph ? u16x2{ gsl::narrow_cast<u16>(builtinGlyph), gsl::narrow_cast<u16>(builtinGlyph >> 16) } : coords[i];
         // We should apply the column color and flags from each column (instead
         // of copying them from the x1) so that ligatures can appear in multiple
         // colors with different line styles.
-        cells[i].flags = valueData->flags | _api.bufferLineMetadata[static_cast<size_t>(x1) + i].flags;
-        cells[i].color = _api.bufferLineMetadata[static_cast<size_t>(x1) + i].colors;
+        cells[i].flags = valueData->flags | metadata[i].flags;
+        cells[i].color = metadata[i].colors;
     }
 
     std::fill_n(cellGlyphMappings, cellCount, it);
-    return true;
+}
+
+void AtlasEngine::_resizeShapingScratch(ShapingScratch& scratch, const size_t textSize, const size_t glyphSize)
+{
+    scratch.analysisResults = {};
+    scratch.clusterMap = Buffer<u16>{ textSize };
+    scratch.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ textSize };
+    scratch.glyphIndices = Buffer<u16>{ glyphSize };
+    scratch.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ glyphSize };
+    scratch.glyphAdvances = Buffer<f32>{ glyphSize };
+    scratch.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ glyphSize };
 }
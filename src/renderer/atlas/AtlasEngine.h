@@ -6,6 +6,7 @@
 #include <d2d1.h>
 #include <d3d11_1.h>
 #include <dwrite_3.h>
+#include <til/mutex.h>
 
 #include "../../renderer/inc/IRenderEngine.hpp"
 #include "DWriteTextAnalysis.h"
@@ -36,6 +37,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept override;
         [[nodiscard]] HRESULT InvalidateScroll(const til::point* pcoordDelta) noexcept override;
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
+        [[nodiscard]] HRESULT InvalidateColorTable() noexcept override;
         [[nodiscard]] HRESULT InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept override;
         [[nodiscard]] HRESULT InvalidateTitle(std::wstring_view proposedTitle) noexcept override;
         [[nodiscard]] HRESULT NotifyNewText(const std::wstring_view newText) noexcept override;
@@ -45,7 +47,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT PaintBackground() noexcept override;
         [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> clusters, til::point coord, bool fTrimLeft, bool lineWrapped) noexcept override;
         [[nodiscard]] HRESULT PaintBufferGridLines(GridLineSet lines, COLORREF color, size_t cchLine, til::point coordTarget) noexcept override;
+        [[nodiscard]] HRESULT PaintBufferRow(const BufferRow& row) noexcept override;
         [[nodiscard]] HRESULT PaintSelection(const til::rect& rect) noexcept override;
+        [[nodiscard]] HRESULT PaintHighlights(gsl::span<const til::rect> rects) noexcept override;
         [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
         [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes, const RenderSettings& renderSettings, gsl::not_null<IRenderData*> pData, bool usingSoftFont, bool isSettingDefaultBrushes) noexcept override;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo) noexcept override;
@@ -66,6 +70,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] Types::Viewport GetViewportInCharacters(const Types::Viewport& viewInPixels) const noexcept override;
         [[nodiscard]] Types::Viewport GetViewportInPixels(const Types::Viewport& viewInCharacters) const noexcept override;
         // DxRenderer - setter
+        void ReleaseResources() noexcept override;
         void SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE antialiasingMode) noexcept override;
         void SetCallback(std::function<void()> pfn) noexcept override;
         void EnableTransparentBackground(const bool isTransparent) noexcept override;
@@ -75,12 +80,17 @@ namespace Microsoft::Console::Render
         void SetRetroTerminalEffect(bool enable) noexcept override;
         void SetSelectionBackground(COLORREF color, float alpha = 0.5f) noexcept override;
         void SetSoftwareRendering(bool enable) noexcept override;
+        void SetSubRowScrollOffset(float rows) noexcept override;
         void SetWarningCallback(std::function<void(HRESULT)> pfn) noexcept override;
         [[nodiscard]] HRESULT SetWindowSize(til::size pixels) noexcept override;
         void ToggleShaderEffects() noexcept override;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& pfiFontInfoDesired, FontInfo& fiFontInfo, const std::unordered_map<std::wstring_view, uint32_t>& features, const std::unordered_map<std::wstring_view, float>& axes) noexcept override;
         void UpdateHyperlinkHoveredId(uint16_t hoveredId) noexcept override;
 
+        // AtlasEngine
+        struct GlyphCacheStatistics;
+        [[nodiscard]] GlyphCacheStatistics GetGlyphCacheStatistics() const noexcept;
+
         // Some helper classes for the implementation.
         // public because I don't want to sprinkle the code with friends.
     public:
@@ -409,7 +419,23 @@ namespace Microsoft::Console::Render
             u16 strikethroughWidth = 0;
             u16x2 doubleUnderlinePos;
             u16 thinLineWidth = 0;
-        };
+
+            bool operator==(const FontMetrics& rhs) const noexcept
+            {
+                return fontCollection == rhs.fontCollection &&
+                       fontName == rhs.fontName &&
+                       baselineInDIP == rhs.baselineInDIP &&
+                       fontSizeInDIP == rhs.fontSizeInDIP &&
+                       advanceScale == rhs.advanceScale &&
+                       cellSize == rhs.cellSize &&
+                       fontWeight == rhs.fontWeight &&
+                       underlinePos == rhs.underlinePos &&
+                       underlineWidth == rhs.underlineWidth &&
+                       strikethroughPos == rhs.strikethroughPos &&
+                       strikethroughWidth == rhs.strikethroughWidth &&
+                       doubleUnderlinePos == rhs.doubleUnderlinePos &&
+                       thinLineWidth == rhs.thinLineWidth;
+            }
 
         // These flags are shared with shader_ps.hlsl.
         // If you change this be sure to copy it over to shader_ps.hlsl.
@@ -421,6 +447,7 @@ namespace Microsoft::Console::Render
             Inlined         = 0x00000001,
 
             ColoredGlyph    = 0x00000002,
+            BuiltinGlyph    = 0x00000004,
 
             Cursor          = 0x00000008,
             Selected        = 0x00000010,
@@ -433,6 +460,11 @@ namespace Microsoft::Console::Render
             UnderlineDotted = 0x00000400,
             UnderlineDouble = 0x00000800,
             Strikethrough   = 0x00001000,
+
+            Highlighted     = 0x00002000,
+
+            PaletteForeground = 0x00004000,
+            PaletteBackground = 0x00008000,
         };
         // clang-format on
         ATLAS_FLAG_OPS(CellFlags, u32)
@@ -451,7 +483,8 @@ namespace Microsoft::Console::Render
             u16 inlined : 1;
             u16 bold : 1;
             u16 italic : 1;
-            u16 cellCount : 13;
+            u16 lineRendition : 2; // a LineRendition; the glyph is drawn at 2x width (and height) unless it's SingleWidth
+            u16 cellCount : 11;
 
             ATLAS_POD_OPS(AtlasKeyAttributes)
         };
@@ -483,8 +516,7 @@ namespace Microsoft::Console::Render
             size_t hash() const noexcept
             {
                 const auto d = data();
-#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
-                return std::_Fnv1a_append_bytes(std::_FNV_offset_basis, reinterpret_cast<const u8*>(d), dataSize(d->charCount));
+                return til::hash(d, dataSize(d->charCount));
             }
 
             bool operator==(const AtlasKey& rhs) const noexcept
@@ -575,12 +607,28 @@ namespace Microsoft::Console::Render
             }
         };
 
+        // Counted since the glyph atlas was last reset, which happens whenever the font changes.
+        struct GlyphCacheStatistics
+        {
+            uint64_t hits = 0; // glyph lookups that found an existing glyph in the atlas
+            uint64_t misses = 0; // glyph lookups that required the glyph to be rasterized
+            uint64_t evictions = 0; // glyphs whose tiles were reused for newer glyphs
+            size_t glyphCount = 0; // glyphs currently stored in the atlas
+            uint64_t lineHits = 0; // lines whose clusters were found in the ShapedLineCache
+            uint64_t lineMisses = 0; // lines that had to be shaped by DirectWrite
+        };
+
         struct TileHashMap
         {
             using iterator = std::list<std::pair<AtlasKey, AtlasValue>>::iterator;
 
             TileHashMap() noexcept = default;
 
+            iterator begin() noexcept
+            {
+                return _lru.begin();
+            }
+
             iterator end() noexcept
             {
                 return _lru.end();
@@ -593,8 +641,10 @@ namespace Microsoft::Console::Render
                 {
                     // Move the key to the head of the LRU queue.
                     makeNewest(*it);
+                    ++_statistics.hits;
                     return *it;
                 }
+                ++_statistics.misses;
                 return end();
             }
 
@@ -631,6 +681,14 @@ namespace Microsoft::Console::Render
 
                 _map.erase(it);
                 _lru.pop_back();
+                ++_statistics.evictions;
+            }
+
+            GlyphCacheStatistics statistics() const noexcept
+            {
+                auto statistics = _statistics;
+                statistics.glyphCount = _map.size();
+                return statistics;
             }
 
         private:
@@ -639,6 +697,7 @@ namespace Microsoft::Console::Render
             // prev/next linked list (it's easier than you might think!).
             std::list<std::pair<AtlasKey, AtlasValue>> _lru;
             std::unordered_set<iterator, AtlasKeyHasher, AtlasKeyEq> _map;
+            GlyphCacheStatistics _statistics;
         };
 
         // TileAllocator yields `tileSize`-sized tiles for our texture atlas.
@@ -799,6 +858,24 @@ namespace Microsoft::Console::Render
             bool _canGenerate = true;
         };
 
+        // A copy of an engine's glyph atlas that's shared process-wide, so that other engines with
+        // the same font settings can skip rasterizing the glyphs it contains. See _publishGlyphAtlas().
+        struct GlyphAtlasSnapshot
+        {
+            std::wstring key; // see _getGlyphAtlasKey()
+            LUID adapterLuid{};
+            wil::unique_handle texture; // NT handle to a texture with a keyed mutex
+            u16x2 textureSize;
+            TileAllocator tileAllocator;
+            std::vector<std::pair<AtlasKey, AtlasValue>> glyphs; // sorted from newest to oldest
+        };
+
+        struct GlyphAtlasSnapshots
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<const GlyphAtlasSnapshot>> items; // sorted from newest to oldest
+        };
+
         struct CachedCursorOptions
         {
             u32 cursorColor = INVALID_COLOR;
@@ -814,6 +891,153 @@ namespace Microsoft::Console::Render
             CellFlags flags = CellFlags::None;
         };
 
+        // A range of a PendingBufferLine that forms a single glyph in our texture atlas.
+        // A null fontFace means that no font contained the glyph and it'll be drawn as U+FFFD.
+        struct ShapedCluster
+        {
+            IDWriteFontFace* fontFace = nullptr; // owned by PendingBufferLine::fontFaces
+            u32 bufferPos1 = 0;
+            u32 bufferPos2 = 0;
+        };
+
+        // A run of text with identical attributes, recorded by _flushBufferLine()
+        // and segmented into clusters by _shapeBufferLine() at the end of the frame.
+        struct PendingBufferLine
+        {
+            std::vector<wchar_t> text;
+            std::vector<u16> columns; // columns.size() == text.size() + 1
+            std::vector<BufferLineMetadata> metadata; // metadata[0] belongs to column metadataOffset
+            std::vector<ShapedCluster> clusters;
+            std::vector<wil::com_ptr<IDWriteFontFace>> fontFaces;
+            AtlasKeyAttributes attributes{};
+            u16 metadataOffset = 0;
+            u16 y = 0;
+            HRESULT hr = S_OK;
+            size_t hash = 0; // computed by ShapedLineCache::find()
+            bool cached = false; // clusters were copied from the ShapedLineCache and the line needn't be shaped
+        };
+
+        // Remembers how the most recently shaped lines were segmented into clusters and which fonts they use,
+        // so that lines that are painted again with the same text, columns and font style skip _shapeBufferLine().
+        // The glyphs themselves are cached in TileHashMap. Like the glyph atlas it's reset whenever the font changes.
+        struct ShapedLineCache
+        {
+            static constexpr size_t capacity = 1024;
+
+            bool find(PendingBufferLine& line, const u16 cellCountX)
+            {
+                line.hash = hash(line, cellCountX);
+
+                if (const auto it = _map.find(line.hash); it != _map.end())
+                {
+                    const auto& entry = *it->second;
+                    if (entry.cellCountX == cellCountX &&
+                        entry.bold == line.attributes.bold &&
+                        entry.italic == line.attributes.italic &&
+                        entry.text == line.text &&
+                        entry.columns == line.columns)
+                    {
+                        _lru.splice(_lru.begin(), _lru, it->second);
+                        line.clusters.assign(entry.clusters.begin(), entry.clusters.end());
+                        line.fontFaces.assign(entry.fontFaces.begin(), entry.fontFaces.end());
+                        ++_hits;
+                        return true;
+                    }
+                }
+
+                ++_misses;
+                return false;
+            }
+
+            void insert(const PendingBufferLine& line, const u16 cellCountX)
+            {
+                if (const auto it = _map.find(line.hash); it != _map.end())
+                {
+                    // Either a hash collision or the same line was painted twice this frame. The newer line wins.
+                    _lru.splice(_lru.begin(), _lru, it->second);
+                }
+                else if (_map.size() < capacity)
+                {
+                    _lru.emplace_front();
+                    _map.emplace(line.hash, _lru.begin());
+                }
+                else
+                {
+                    // The oldest entry is reused, including the capacity of its vectors.
+                    _map.erase(_lru.back().hash);
+                    _lru.splice(_lru.begin(), _lru, std::prev(_lru.end()));
+                    _map.emplace(line.hash, _lru.begin());
+                }
+
+                // ShapedCluster::fontFace points into fontFaces, which holds the same
+                // font faces as line.fontFaces. The cluster pointers thus remain valid.
+                auto& entry = _lru.front();
+                entry.hash = line.hash;
+                entry.text.assign(line.text.begin(), line.text.end());
+                entry.columns.assign(line.columns.begin(), line.columns.end());
+                entry.clusters.assign(line.clusters.begin(), line.clusters.end());
+                entry.fontFaces.assign(line.fontFaces.begin(), line.fontFaces.end());
+                entry.cellCountX = cellCountX;
+                entry.bold = line.attributes.bold;
+                entry.italic = line.attributes.italic;
+            }
+
+            void statistics(GlyphCacheStatistics& statistics) const noexcept
+            {
+                statistics.lineHits = _hits;
+                statistics.lineMisses = _misses;
+            }
+
+        private:
+            struct Entry
+            {
+                size_t hash = 0;
+                std::vector<wchar_t> text;
+                std::vector<u16> columns;
+                std::vector<ShapedCluster> clusters;
+                std::vector<wil::com_ptr<IDWriteFontFace>> fontFaces;
+                u16 cellCountX = 0;
+                bool bold = false;
+                bool italic = false;
+            };
+
+            // The column of the line's last cluster is checked against the cell count in _emplaceCluster(),
+            // which is why the cell count is part of the key. Bold and italic select the font face.
+            static size_t hash(const PendingBufferLine& line, const u16 cellCountX) noexcept
+            {
+                const auto style = gsl::narrow_cast<u32>(line.attributes.bold | line.attributes.italic << 1);
+                return til::hasher{}
+                    .write(line.text.data(), line.text.size())
+                    .write(line.columns.data(), line.columns.size())
+                    .write(style << 16 | cellCountX)
+                    .finalize();
+            }
+
+            std::list<Entry> _lru;
+            std::unordered_map<size_t, std::list<Entry>::iterator> _map;
+            uint64_t _hits = 0;
+            uint64_t _misses = 0;
+        };
+
+        // Scratch buffers for _shapeBufferLine(). Each thread that shapes text needs its own.
+        struct ShapingScratch
+        {
+            std::vector<TextAnalysisSinkResult> analysisResults;
+            Buffer<u16> clusterMap;
+            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
+            Buffer<u16> glyphIndices;
+            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
+            Buffer<f32> glyphAdvances;
+            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+        };
+
+        // The palette cells flagged with CellFlags::PaletteForeground/Background refer to. It consists
+        // of the color table, followed by the entries RenderSettings::DefaultForegroundIndex and
+        // DefaultBackgroundIndex refer to and the default background with backgroundOpaqueMixin applied.
+        static constexpr size_t paletteTranslucentBackgroundIndex = TextColor::TABLE_SIZE + 2;
+        static constexpr size_t paletteSize = TextColor::TABLE_SIZE + 3;
+        using Palette = std::array<u32, (paletteSize + 3) / 4 * 4>;
+
         // NOTE: D3D constant buffers sizes must be a multiple of 16 bytes.
         struct alignas(16) ConstBuffer
         {
@@ -839,7 +1063,13 @@ namespace Microsoft::Console::Render
             alignas(sizeof(u32)) u32 backgroundColor = 0;
             alignas(sizeof(u32)) u32 cursorColor = 0;
             alignas(sizeof(u32)) u32 selectionColor = 0;
+            alignas(sizeof(u32)) u32 highlightColor = 0;
             alignas(sizeof(u32)) u32 useClearType = 0;
+            alignas(sizeof(u32)) u32 cellCountY = 0;
+            alignas(sizeof(u32)) u32 cellRowOffset = 0;
+            alignas(sizeof(i32)) i32 scrollPixelOffset = 0;
+            // Must match the size of the palette array in shader_ps.hlsl.
+            alignas(sizeof(f32x4)) Palette palette{};
 #pragma warning(suppress : 4324) // 'ConstBuffer': structure was padded due to alignment specifier
         };
 
@@ -879,15 +1109,28 @@ namespace Microsoft::Console::Render
         __declspec(noinline) void _createResources();
         void _releaseSwapChain();
         __declspec(noinline) void _createSwapChain();
+        void _updateSwapChainTransform() const;
         __declspec(noinline) void _recreateSizeDependentResources();
         __declspec(noinline) void _recreateFontDependentResources();
         IDWriteTextFormat* _getTextFormat(bool bold, bool italic) const noexcept;
         const Buffer<DWRITE_FONT_AXIS_VALUE>& _getTextFormatAxis(bool bold, bool italic) const noexcept;
+        u16 _getCellRow(u16 y) const noexcept;
+        void _markCellRowsDirty(u16 top, u16 bottom) noexcept;
         Cell* _getCell(u16 x, u16 y) noexcept;
         TileHashMap::iterator* _getCellGlyphMapping(u16 x, u16 y) noexcept;
         void _setCellFlags(u16r coords, CellFlags mask, CellFlags bits) noexcept;
+        std::wstring _getGlyphAtlasKey() const;
+        void _seedGlyphAtlas() noexcept;
         void _flushBufferLine();
-        bool _emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2);
+        void _flushPendingBufferLines();
+        void _shapePendingBufferLinesParallel(size_t workerCount);
+        static void CALLBACK _shapePendingBufferLinesCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work) noexcept;
+        void _shapePendingBufferLines(ShapingScratch& scratch) noexcept;
+        void _shapeBufferLine(PendingBufferLine& line, ShapingScratch& scratch) const;
+        bool _emplaceCluster(PendingBufferLine& line, IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2) const;
+        static u32 _getBuiltinGlyph(wchar_t ch) noexcept;
+        void _emplaceGlyph(const PendingBufferLine& line, IDWriteFontFace* fontFace, size_t bufferPos1, size_t bufferPos2);
+        static void _resizeShapingScratch(ShapingScratch& scratch, size_t textSize, size_t glyphSize);
 
         // AtlasEngine.api.cpp
         void _resolveAntialiasingMode() noexcept;
@@ -897,15 +1140,31 @@ namespace Microsoft::Console::Render
         // AtlasEngine.r.cpp
         void _setShaderResources() const;
         void _updateConstantBuffer() const noexcept;
+        void _uploadCells();
+        void _drawDirtyRowsAndPresent();
         void _adjustAtlasSize();
         void _processGlyphQueue();
         void _drawGlyph(const AtlasQueueItem& item) const;
         void _drawCursor();
+        static GlyphAtlasSnapshots& _getGlyphAtlasSnapshots() noexcept;
+        static std::pair<AtlasKey, AtlasValue> _cloneGlyph(const AtlasKey& key, const AtlasValue& value);
+        LUID _getAdapterLuid() const;
+        void _copyGlyphAtlasSeed(ID3D11Texture2D* atlasBuffer);
+        void _publishGlyphAtlas() noexcept;
 
         static constexpr bool debugGlyphGenerationPerformance = false;
         static constexpr bool debugTextParsingPerformance = false || debugGlyphGenerationPerformance;
         static constexpr bool debugGeneralPerformance = false || debugTextParsingPerformance;
 
+        // Text shaping is spread across the thread pool once a frame contains
+        // at least this many lines per worker thread (including the render thread).
+        static constexpr size_t parallelShapingLinesPerWorker = 4;
+        static constexpr size_t parallelShapingMaxWorkers = 8;
+
+        // Each published GlyphAtlasSnapshot holds a copy of the atlas texture in video memory.
+        static constexpr size_t maxGlyphAtlasSnapshots = 4;
+        static constexpr std::chrono::seconds glyphAtlasPublishInterval{ 5 };
+
         static constexpr u16 u16min = 0x0000;
         static constexpr u16 u16max = 0xffff;
         static constexpr i16 i16min = -0x8000;
@@ -942,6 +1201,7 @@ namespace Microsoft::Console::Render
             wil::com_ptr<ID3D11Buffer> constantBuffer;
             wil::com_ptr<ID3D11Buffer> cellBuffer;
             wil::com_ptr<ID3D11ShaderResourceView> cellView;
+            wil::com_ptr<ID3D11RasterizerState> scissorRasterizerState; // only used if isWarp is true
 
             // D2D resources
             wil::com_ptr<ID3D11Texture2D> atlasBuffer;
@@ -954,6 +1214,15 @@ namespace Microsoft::Console::Render
 
             Buffer<Cell, 32> cells; // invalidated by ApiInvalidations::Size
             Buffer<TileHashMap::iterator> cellGlyphMapping; // invalidated by ApiInvalidations::Size
+            // cells and cellGlyphMapping are ring buffers of rows: Row y of the viewport
+            // is stored in row (y + cellRowOffset) % cellCount.y. See _getCellRow().
+            u16 cellRowOffset = 0; // invalidated by ApiInvalidations::Size
+            i32 scrollPixelOffset = 0; // caches _api.subRowScrollOffset, but in pixels
+            Buffer<bool> dirtyCellRows; // invalidated by ApiInvalidations::Size, rows of cells (not of the viewport) that need to be uploaded by _uploadCells()
+            // [top, bottom) rows of the viewport that changed in this and in the previous frame. See _drawDirtyRowsAndPresent().
+            u16x2 frameDirtyRows = invalidatedRowsAll;
+            u16x2 previousFrameDirtyRows = invalidatedRowsAll;
+            bool isWarp = false; // the device renders on the CPU, see _drawDirtyRowsAndPresent()
             f32x2 cellSizeDIP; // invalidated by ApiInvalidations::Font, caches _api.cellSize but in DIP
             u16x2 cellCount; // invalidated by ApiInvalidations::Font|Size, caches _api.cellCount
             u16 dpi = USER_DEFAULT_SCREEN_DPI; // invalidated by ApiInvalidations::Font, caches _api.dpi
@@ -962,14 +1231,19 @@ namespace Microsoft::Console::Render
             f32 pixelPerDIP = 1.0f; // invalidated by ApiInvalidations::Font, caches _api.dpi / USER_DEFAULT_SCREEN_DPI
             u16x2 atlasSizeInPixel; // invalidated by ApiInvalidations::Font
             TileHashMap glyphs;
+            ShapedLineCache shapedLines; // invalidated by ApiInvalidations::Font
             TileAllocator tileAllocator;
             std::vector<AtlasQueueItem> glyphQueue;
+            std::wstring glyphAtlasKey; // invalidated by ApiInvalidations::Font
+            std::shared_ptr<const GlyphAtlasSnapshot> glyphAtlasSeed; // set by _seedGlyphAtlas(), consumed by _adjustAtlasSize()
+            std::chrono::steady_clock::time_point glyphAtlasPublishTime;
 
             f32 gamma = 0;
             f32 cleartypeEnhancedContrast = 0;
             f32 grayscaleEnhancedContrast = 0;
             u32 backgroundColor = 0xff000000;
             u32 selectionColor = 0x7fffffff;
+            Palette palette{};
 
             CachedCursorOptions cursorOptions;
             RenderInvalidations invalidations = RenderInvalidations::None;
@@ -990,13 +1264,12 @@ namespace Microsoft::Console::Render
             std::vector<wchar_t> bufferLine;
             std::vector<u16> bufferLineColumn;
             Buffer<BufferLineMetadata> bufferLineMetadata;
-            std::vector<TextAnalysisSinkResult> analysisResults;
-            Buffer<u16> clusterMap;
-            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
-            Buffer<u16> glyphIndices;
-            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
-            Buffer<f32> glyphAdvances;
-            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            std::vector<PendingBufferLine> pendingLines; // only [0, pendingLineCount) are in use, the rest are kept for their capacity
+            size_t pendingLineCount = 0;
+            std::vector<ShapingScratch> shapingScratch; // [0] belongs to the render thread
+            std::atomic<size_t> shapingNextLine{ 0 };
+            std::atomic<size_t> shapingNextScratch{ 0 };
+            wil::unique_threadpool_work shapingWork;
             std::vector<DWRITE_FONT_FEATURE> fontFeatures; // changes are flagged as ApiInvalidations::Font|Size
             std::vector<DWRITE_FONT_AXIS_VALUE> fontAxisValues; // changes are flagged as ApiInvalidations::Font|Size
             FontMetrics fontMetrics; // changes are flagged as ApiInvalidations::Font|Size
@@ -1010,11 +1283,18 @@ namespace Microsoft::Console::Render
             AtlasKeyAttributes attributes{};
             u16x2 lastPaintBufferLineCoord;
             CellFlags flags = CellFlags::None;
+            // Set if a cell since the last full repaint has a color that depends on the color table,
+            // but couldn't refer to the palette. InvalidateColorTable() has to repaint everything then.
+            bool paletteFallbackInUse = false;
+            // PrepareLineTransform()
+            LineRendition lineRendition = LineRendition::SingleWidth;
             // SetSelectionBackground()
             u32 selectionColor = 0x7fffffff;
             // UpdateHyperlinkHoveredId()
             u16 hyperlinkHoveredId = 0;
             bool bufferLineWasHyperlinked = false;
+            // SetSubRowScrollOffset()
+            f32 subRowScrollOffset = 0;
 
             // dirtyRect is a computed value based on invalidatedRows.
             til::rect dirtyRect;
@@ -1034,6 +1314,9 @@ namespace Microsoft::Console::Render
             ApiInvalidations invalidations = ApiInvalidations::Device;
         } _api;
 
+        // Updated by Present() and read by GetGlyphCacheStatistics(), which may be called on any thread.
+        til::shared_mutex<GlyphCacheStatistics> _glyphCacheStatistics;
+
 #undef ATLAS_POD_OPS
 #undef ATLAS_FLAG_OPS
     };
@@ -54,7 +54,16 @@ using namespace Microsoft::Console::Render;
 try
 {
     _adjustAtlasSize();
-    _processGlyphQueue();
+
+    if (!_r.glyphQueue.empty())
+    {
+        _processGlyphQueue();
+        _publishGlyphAtlas();
+    }
+
+    auto statistics = _r.glyphs.statistics();
+    _r.shapedLines.statistics(statistics);
+    *_glyphCacheStatistics.lock() = statistics;
 
     if (WI_IsFlagSet(_r.invalidations, RenderInvalidations::Cursor))
     {
@@ -67,31 +76,32 @@ try
     {
         _updateConstantBuffer();
         WI_ClearFlag(_r.invalidations, RenderInvalidations::ConstBuffer);
+        // Colors, metrics and the scroll offset apply to every pixel.
+        _r.frameDirtyRows = invalidatedRowsAll;
     }
 
-    {
-#pragma warning(suppress : 26494) // Variable 'mapped' is uninitialized. Always initialize an object (type.5).
-        D3D11_MAPPED_SUBRESOURCE mapped;
-        THROW_IF_FAILED(_r.deviceContext->Map(_r.cellBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
-        assert(mapped.RowPitch >= _r.cells.size() * sizeof(Cell));
-        memcpy(mapped.pData, _r.cells.data(), _r.cells.size() * sizeof(Cell));
-        _r.deviceContext->Unmap(_r.cellBuffer.get(), 0);
-    }
+    _uploadCells();
 
     // After Present calls, the back buffer needs to explicitly be
     // re-bound to the D3D11 immediate context before it can be used again.
     _r.deviceContext->OMSetRenderTargets(1, _r.renderTargetView.addressof(), nullptr);
-    _r.deviceContext->Draw(3, 0);
 
     // See documentation for IDXGISwapChain2::GetFrameLatencyWaitableObject method:
     // > For every frame it renders, the app should wait on this handle before starting any rendering operations.
     // > Note that this requirement includes the first frame the app renders with the swap chain.
     assert(debugGeneralPerformance || _r.frameLatencyWaitableObjectUsed);
 
+    if (_r.isWarp)
+    {
+        _drawDirtyRowsAndPresent();
+        return S_OK;
+    }
+
+    _r.deviceContext->Draw(3, 0);
+
     // > IDXGISwapChain::Present: Partial Presentation (using a dirty rects or scroll) is not supported
     // > for SwapChains created with DXGI_SWAP_EFFECT_DISCARD or DXGI_SWAP_EFFECT_FLIP_DISCARD.
-    // ---> No need to call IDXGISwapChain1::Present1.
-    //      TODO: Would IDXGISwapChain1::Present1 and its dirty rects have benefits for remote desktop?
+    // ---> No need to call IDXGISwapChain1::Present1. WARP uses it, see _drawDirtyRowsAndPresent().
     THROW_IF_FAILED(_r.swapChain->Present(1, 0));
 
     // On some GPUs with tile based deferred rendering (TBDR) architectures, binding
@@ -128,6 +138,11 @@ void AtlasEngine::_setShaderResources() const
     _r.deviceContext->IASetInputLayout(nullptr);
     _r.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
+    if (_r.scissorRasterizerState)
+    {
+        _r.deviceContext->RSSetState(_r.scissorRasterizerState.get());
+    }
+
     _r.deviceContext->PSSetConstantBuffers(0, 1, _r.constantBuffer.addressof());
 
     const std::array resources{ _r.cellView.get(), _r.atlasView.get() };
@@ -158,11 +173,101 @@ void AtlasEngine::_updateConstantBuffer() const noexcept
     data.backgroundColor = _r.backgroundColor;
     data.cursorColor = _r.cursorOptions.cursorColor;
     data.selectionColor = _r.selectionColor;
+    // Highlights are tinted in the selection color at half its opacity,
+    // so that the selection (e.g. the current search match) stands out.
+    data.highlightColor = (_r.selectionColor & 0xffffff) | (_r.selectionColor >> 25 << 24);
     data.useClearType = useClearType;
+    data.cellCountY = _r.cellCount.y;
+    data.cellRowOffset = _r.cellRowOffset;
+    data.scrollPixelOffset = _r.scrollPixelOffset;
+    data.palette = _r.palette;
 #pragma warning(suppress : 26447) // The function is declared 'noexcept' but calls function '...' which may throw exceptions (f.6).
     _r.deviceContext->UpdateSubresource(_r.constantBuffer.get(), 0, nullptr, &data, 0, 0);
 }
 
+// Uploads the rows of _r.cells that were modified since the last frame.
+// Each run of consecutive modified rows is uploaded with a single UpdateSubresource() call, so that the
+// amount of data sent to the GPU scales with the number of modified rows and not with the size of the viewport.
+// The rows are tracked in the order they're stored in _r.cells and not in the order of the viewport,
+// which means that a run never wraps around the end of the ring buffer.
+// It also accumulates the modified rows of the viewport in _r.frameDirtyRows.
+void AtlasEngine::_uploadCells()
+{
+    const u32 rows = _r.cellCount.y;
+    const u32 offset = _r.cellRowOffset;
+    const auto stride = static_cast<u32>(_r.cellCount.x) * sizeof(Cell);
+    const auto dirty = _r.dirtyCellRows.data();
+
+    for (u32 y = 0; y < rows;)
+    {
+        if (!dirty[y])
+        {
+            ++y;
+            continue;
+        }
+
+        const auto top = y;
+        for (; y < rows && dirty[y]; ++y)
+        {
+            dirty[y] = false;
+
+            const auto viewportRow = gsl::narrow_cast<u16>(y >= offset ? y - offset : y + rows - offset);
+            _r.frameDirtyRows.x = std::min(_r.frameDirtyRows.x, viewportRow);
+            _r.frameDirtyRows.y = std::max(_r.frameDirtyRows.y, gsl::narrow_cast<u16>(viewportRow + 1));
+        }
+
+        const D3D11_BOX box{ top * stride, 0, 0, y * stride, 1, 1 };
+        _r.deviceContext->UpdateSubresource(_r.cellBuffer.get(), 0, &box, _r.cells.data() + static_cast<size_t>(_r.cellCount.x) * top, 0, 0);
+    }
+}
+
+// WARP, the software rasterizer used in VMs without a GPU and in some remote desktop sessions, runs
+// our pixel shader on the CPU, where its cost is proportional to the number of pixels it's run for.
+// Instead of drawing the entire viewport each frame, we thus only draw the rows that changed and tell DXGI
+// about them via Present1(), which additionally lets remote desktop transmit just those rows.
+// The swap chain uses DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL with 2 buffers in this case, which means that the
+// back buffer still contains the frame before the previous one: We have to redraw the rows that changed in either.
+void AtlasEngine::_drawDirtyRowsAndPresent()
+{
+    const auto frameRows = _r.frameDirtyRows;
+    const auto previousFrameRows = _r.previousFrameDirtyRows;
+    _r.previousFrameDirtyRows = frameRows;
+    _r.frameDirtyRows = invalidatedRowsNone;
+
+    const auto rows = _r.cellCount.y;
+    const auto cellSize = _r.fontMetrics.cellSize;
+    const auto width = static_cast<LONG>(_r.cellCount.x) * cellSize.x;
+    // While smooth scrolling, rows aren't aligned to the cell grid. Partial redraws aren't worth the complexity then.
+    const auto full = frameRows == invalidatedRowsAll || previousFrameRows == invalidatedRowsAll || _r.scrollPixelOffset != 0;
+    const auto top = std::min(frameRows.x, previousFrameRows.x);
+    const auto bottom = std::min(std::max(frameRows.y, previousFrameRows.y), rows);
+
+    if (full)
+    {
+        static constexpr D3D11_RECT scissor{ 0, 0, D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION, D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION };
+        _r.deviceContext->RSSetScissorRects(1, &scissor);
+        _r.deviceContext->Draw(3, 0);
+    }
+    else if (top < bottom)
+    {
+        const D3D11_RECT scissor{ 0, static_cast<LONG>(top) * cellSize.y, width, static_cast<LONG>(bottom) * cellSize.y };
+        _r.deviceContext->RSSetScissorRects(1, &scissor);
+        _r.deviceContext->Draw(3, 0);
+    }
+
+    // No dirty rects means that the entire frame changed.
+    DXGI_PRESENT_PARAMETERS params{};
+    RECT dirtyRect;
+    if (!full && frameRows.x < std::min(frameRows.y, rows))
+    {
+        dirtyRect = { 0, static_cast<LONG>(frameRows.x) * cellSize.y, width, static_cast<LONG>(std::min(frameRows.y, rows)) * cellSize.y };
+        params.DirtyRectsCount = 1;
+        params.pDirtyRects = &dirtyRect;
+    }
+
+    THROW_IF_FAILED(_r.swapChain->Present1(1, 0, &params));
+}
+
 void AtlasEngine::_adjustAtlasSize()
 {
     // Only grow the atlas texture if our tileAllocator needs it to be larger.
@@ -204,6 +309,10 @@ void AtlasEngine::_adjustAtlasSize()
         box.back = 1;
         _r.deviceContext->CopySubresourceRegion1(atlasBuffer.get(), 0, 0, 0, 0, _r.atlasBuffer.get(), 0, &box, D3D11_COPY_NO_OVERWRITE);
     }
+    else if (_r.glyphAtlasSeed)
+    {
+        _copyGlyphAtlasSeed(atlasBuffer.get());
+    }
 
     _r.atlasSizeInPixel = requiredSize;
     _r.atlasBuffer = std::move(atlasBuffer);
@@ -260,6 +369,142 @@ void AtlasEngine::_processGlyphQueue()
     _r.glyphQueue.clear();
 }
 
+AtlasEngine::GlyphAtlasSnapshots& AtlasEngine::_getGlyphAtlasSnapshots() noexcept
+{
+    static GlyphAtlasSnapshots snapshots;
+    return snapshots;
+}
+
+std::pair<AtlasEngine::AtlasKey, AtlasEngine::AtlasValue> AtlasEngine::_cloneGlyph(const AtlasKey& key, const AtlasValue& value)
+{
+    const auto keyData = key.data();
+    const auto valueData = value.data();
+    const u16 cellCount = keyData->attributes.cellCount;
+
+    // The AtlasValue constructor sets the CellFlags::Inlined flag itself, depending on the cellCount.
+    u16x2* coords;
+    AtlasValue valueCopy{ valueData->flags & ~CellFlags::Inlined, cellCount, &coords };
+    std::copy_n(&valueData->coords[0], cellCount, coords);
+
+    return { AtlasKey{ keyData->attributes, keyData->charCount, &keyData->chars[0] }, std::move(valueCopy) };
+}
+
+LUID AtlasEngine::_getAdapterLuid() const
+{
+    wil::com_ptr<IDXGIAdapter> adapter;
+    THROW_IF_FAILED(_r.device.query<IDXGIDevice>()->GetAdapter(adapter.addressof()));
+
+    DXGI_ADAPTER_DESC desc;
+    THROW_IF_FAILED(adapter->GetDesc(&desc));
+    return desc.AdapterLuid;
+}
+
+// Copies the texture of the GlyphAtlasSnapshot that _seedGlyphAtlas() used into our new atlas texture.
+void AtlasEngine::_copyGlyphAtlasSeed(ID3D11Texture2D* atlasBuffer)
+{
+    const auto seed = std::exchange(_r.glyphAtlasSeed, nullptr);
+
+    const auto hr = [&]() noexcept -> HRESULT {
+        const auto device1 = _r.device.try_query<ID3D11Device1>();
+        RETURN_HR_IF_NULL(E_NOINTERFACE, device1);
+
+        wil::com_ptr<ID3D11Texture2D> texture;
+        RETURN_IF_FAILED(device1->OpenSharedResource1(seed->texture.get(), IID_PPV_ARGS(texture.addressof())));
+
+        const auto keyedMutex = texture.try_query<IDXGIKeyedMutex>();
+        RETURN_HR_IF_NULL(E_NOINTERFACE, keyedMutex);
+
+        // AcquireSync() returns WAIT_TIMEOUT, which is a success code, if it timed out.
+        const auto acquired = keyedMutex->AcquireSync(0, 100);
+        RETURN_IF_FAILED(acquired);
+        RETURN_HR_IF(HRESULT_FROM_WIN32(WAIT_TIMEOUT), acquired != S_OK);
+
+        D3D11_BOX box;
+        box.left = 0;
+        box.top = 0;
+        box.front = 0;
+        box.right = seed->textureSize.x;
+        box.bottom = seed->textureSize.y;
+        box.back = 1;
+        _r.deviceContext->CopySubresourceRegion1(atlasBuffer, 0, 0, 0, 0, texture.get(), 0, &box, D3D11_COPY_NO_OVERWRITE);
+
+        RETURN_IF_FAILED(keyedMutex->ReleaseSync(0));
+        return S_OK;
+    }();
+
+    if (FAILED(hr))
+    {
+        LOG_HR(hr);
+
+        // Our _r.glyphs already refer to tiles in the atlas texture.
+        // Since we couldn't copy them over, we need to rasterize them ourselves.
+        for (auto it = _r.glyphs.begin(); it != _r.glyphs.end(); ++it)
+        {
+            _r.glyphQueue.emplace_back(&it->first, &it->second);
+        }
+    }
+}
+
+// Shares a copy of our glyph atlas with other engines in this process, so that new tabs
+// and panes with the same font settings can skip rasterizing most glyphs on their first frame.
+// Neither the copy nor the snapshot needs to be current, which is why we only do this once
+// every glyphAtlasPublishInterval at most, right after rasterizing new glyphs.
+void AtlasEngine::_publishGlyphAtlas() noexcept
+try
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now < _r.glyphAtlasPublishTime || _r.glyphAtlasKey.empty())
+    {
+        return;
+    }
+    _r.glyphAtlasPublishTime = now + glyphAtlasPublishInterval;
+
+    auto snapshot = std::make_shared<GlyphAtlasSnapshot>();
+    snapshot->key = _r.glyphAtlasKey;
+    snapshot->adapterLuid = _getAdapterLuid();
+    snapshot->textureSize = _r.atlasSizeInPixel;
+    snapshot->tileAllocator = _r.tileAllocator;
+
+    {
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = _r.atlasSizeInPixel.x;
+        desc.Height = _r.atlasSizeInPixel.y;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        desc.SampleDesc = { 1, 0 };
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_NTHANDLE | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+        wil::com_ptr<ID3D11Texture2D> texture;
+        THROW_IF_FAILED(_r.device->CreateTexture2D(&desc, nullptr, texture.addressof()));
+
+        const auto keyedMutex = texture.query<IDXGIKeyedMutex>();
+        THROW_IF_FAILED(keyedMutex->AcquireSync(0, INFINITE));
+        _r.deviceContext->CopyResource(texture.get(), _r.atlasBuffer.get());
+        THROW_IF_FAILED(keyedMutex->ReleaseSync(0));
+
+        THROW_IF_FAILED(texture.query<IDXGIResource1>()->CreateSharedHandle(nullptr, DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE, nullptr, snapshot->texture.addressof()));
+    }
+
+    for (auto it = _r.glyphs.begin(); it != _r.glyphs.end(); ++it)
+    {
+        snapshot->glyphs.emplace_back(_cloneGlyph(it->first, it->second));
+    }
+
+    auto& snapshots = _getGlyphAtlasSnapshots();
+    const std::scoped_lock lock{ snapshots.mutex };
+    std::erase_if(snapshots.items, [&](const auto& item) {
+        return item->key == snapshot->key;
+    });
+    snapshots.items.insert(snapshots.items.begin(), std::move(snapshot));
+    if (snapshots.items.size() > maxGlyphAtlasSnapshots)
+    {
+        snapshots.items.pop_back();
+    }
+}
+CATCH_LOG()
+
 void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
 {
     const auto key = item.key->data();
@@ -269,7 +514,17 @@ void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
     const auto cellCount = static_cast<u32>(key->attributes.cellCount);
     const auto textFormat = _getTextFormat(key->attributes.bold, key->attributes.italic);
     const auto coloredGlyph = WI_IsFlagSet(value->flags, CellFlags::ColoredGlyph);
-    const f32x2 layoutBox{ cellCount * _r.cellSizeDIP.x, _r.cellSizeDIP.y };
+    const auto lineRendition = static_cast<LineRendition>(key->attributes.lineRendition);
+    // Glyphs in double width/height rows are laid out like regular ones and then stretched
+    // across their cellCount, which _emplaceGlyph() has already doubled, by renditionScale.
+    // The top and bottom half of a double height glyph are separate glyphs with their own tiles.
+    const f32x2 renditionScale{
+        lineRendition != LineRendition::SingleWidth ? 2.0f : 1.0f,
+        lineRendition >= LineRendition::DoubleHeightTop ? 2.0f : 1.0f,
+    };
+    const auto renditionOffsetY = lineRendition == LineRendition::DoubleHeightBottom ? -_r.cellSizeDIP.y : 0.0f;
+    const auto logicalCellCount = lineRendition != LineRendition::SingleWidth ? cellCount / 2 : cellCount;
+    const f32x2 layoutBox{ logicalCellCount * _r.cellSizeDIP.x, _r.cellSizeDIP.y };
 
     // See D2DFactory::DrawText
     wil::com_ptr<IDWriteTextLayout> textLayout;
@@ -393,7 +648,7 @@ void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
         // glyph advance is often slightly shorter by a fractional pixel or two compared to our terminal's cells.
         // It's a trade off that keeps most glyphs "crisp" while retaining support for things like "===".
         // At least I can't think of any better heuristic for this at the moment...
-        if (cellCount > 2)
+        if (logicalCellCount > 2)
         {
             const auto advanceScale = _r.fontMetrics.advanceScale;
             scalingRequired = true;
@@ -481,6 +736,7 @@ void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
     // where every single "=" might be blatantly misaligned vertically (same for any box drawings).
     WI_SetFlagIf(options, D2D1_DRAW_TEXT_OPTIONS_NO_SNAP, scalingRequired);
 
+    const auto transformRequired = scalingRequired || lineRendition != LineRendition::SingleWidth;
     const f32x2 inverseScale{ 1.0f - scale.x, 1.0f - scale.y };
 
     for (u32 i = 0; i < cellCount; ++i)
@@ -501,15 +757,17 @@ void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
             _r.d2dRenderTarget->PushAxisAlignedClip(&rect, D2D1_ANTIALIAS_MODE_ALIASED);
             _r.d2dRenderTarget->Clear();
         }
-        if (scalingRequired)
+        if (transformRequired)
         {
+            // This is the glyph's scaling around the center of its layout box, followed by
+            // the line rendition's scaling around the layout box's origin (its top left corner).
             const D2D1_MATRIX_3X2_F transform{
-                scale.x,
+                scale.x * renditionScale.x,
                 0,
                 0,
-                scale.y,
-                (origin.x + halfSize.x) * inverseScale.x,
-                (origin.y + halfSize.y) * inverseScale.y,
+                scale.y * renditionScale.y,
+                (origin.x + halfSize.x) * inverseScale.x * renditionScale.x + origin.x * (1.0f - renditionScale.x),
+                (origin.y + halfSize.y) * inverseScale.y * renditionScale.y + origin.y * (1.0f - renditionScale.y) + renditionOffsetY,
             };
             _r.d2dRenderTarget->SetTransform(&transform);
         }
@@ -520,7 +778,7 @@ void AtlasEngine::_drawGlyph(const AtlasQueueItem& item) const
             origin.y += offset.y;
             _r.d2dRenderTarget->DrawTextLayout(origin, textLayout.get(), _r.brush.get(), options);
         }
-        if (scalingRequired)
+        if (transformRequired)
         {
             static constexpr D2D1_MATRIX_3X2_F identity{ 1, 0, 0, 1, 0, 0 };
             _r.d2dRenderTarget->SetTransform(&identity);
@@ -8,7 +8,9 @@
 
 #include <array>
 #include <filesystem>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <sstream>
 #include <string_view>
 #include <thread>
@@ -30,6 +32,7 @@
 #include <gsl/span>
 #include <wil/com.h>
 #include <wil/filesystem.h>
+#include <wil/resource.h>
 #include <wil/result_macros.h>
 #include <wil/stl.h>
 #include <wil/win32_helpers.h>
@@ -50,3 +53,4 @@
 
 #include <til.h>
 #include <til/bit.h>
+#include <til/hash.h>
@@ -12,6 +12,7 @@
 #define CellFlags_Inlined         0x00000001
 
 #define CellFlags_ColoredGlyph    0x00000002
+#define CellFlags_BuiltinGlyph    0x00000004
 
 #define CellFlags_Cursor          0x00000008
 #define CellFlags_Selected        0x00000010
@@ -24,8 +25,18 @@
 #define CellFlags_UnderlineDotted 0x00000400
 #define CellFlags_UnderlineDouble 0x00000800
 #define CellFlags_Strikethrough   0x00001000
+
+#define CellFlags_Highlighted     0x00002000
+
+#define CellFlags_PaletteForeground 0x00004000
+#define CellFlags_PaletteBackground 0x00008000
 // clang-format on
 
+// These are the kinds of BuiltinGlyph shapes. See AtlasEngine::_getBuiltinGlyph().
+#define BuiltinGlyph_Lines     0
+#define BuiltinGlyph_Rect      1
+#define BuiltinGlyph_Quadrants 2
+
 // According to Nvidia's "Understanding Structured Buffer Performance" guide
 // one should aim for structures with sizes divisible by 128 bits (16 bytes).
 // This prevents elements from spanning cache lines.
@@ -52,7 +63,14 @@ cbuffer ConstBuffer : register(b0)
     uint backgroundColor;
     uint cursorColor;
     uint selectionColor;
+    uint highlightColor;
     uint useClearType;
+    uint cellCountY;
+    uint cellRowOffset;
+    int scrollPixelOffset;
+    // Every array element is padded to 16 bytes, which is why 4 entries are packed into each.
+    // Its size must match AtlasEngine::ConstBuffer::palette.
+    uint4 palette[68];
 };
 StructuredBuffer<Cell> cells : register(t0);
 Texture2D<float4> glyphs : register(t1);
@@ -65,6 +83,13 @@ float4 decodeRGBA(uint i)
     return c;
 }
 
+// Cells flagged with CellFlags_PaletteForeground/Background store
+// an index into the palette instead of the color itself.
+uint resolveColor(uint flags, uint paletteFlag, uint color)
+{
+    return flags & paletteFlag ? palette[color / 4][color % 4] : color;
+}
+
 uint2 decodeU16x2(uint i)
 {
     return uint2(i & 0xffff, i >> 16);
@@ -76,6 +101,50 @@ float4 alphaBlendPremultiplied(float4 bottom, float4 top)
     return bottom + top;
 }
 
+// Returns the coverage of a box drawing or block element character at cellPos, which
+// we draw ourselves instead of rasterizing it into the glyph atlas. `shape` is produced by
+// AtlasEngine::_getBuiltinGlyph() and its top 2 bits contain one of the BuiltinGlyph kinds.
+// The following <width checks rely on underflow, just like the ones for the lines in main().
+float builtinGlyphCoverage(uint shape, uint2 cellPos)
+{
+    uint kind = shape >> 30;
+
+    [branch] if (kind == BuiltinGlyph_Lines)
+    {
+        // 2 bits per arm: 0 = none, 1 = light, 2 = heavy (twice as wide).
+        uint4 widths = (shape >> uint4(0, 2, 4, 6) & 3) * thinLineWidth; // left, up, right, down
+        uint2 center = cellSize / 2;
+        // Horizontal arms reach across the vertical ones to the far side and vice versa, which closes corners.
+        // Without any arms in the other direction they end in the center, for instance for U+2574 "╴".
+        uint verticalReach = max(widths.y, widths.w);
+        uint horizontalReach = max(widths.x, widths.z);
+        uint2 nearEnd = center - uint2(verticalReach, horizontalReach) / 2;
+        uint2 farEnd = nearEnd + uint2(verticalReach, horizontalReach);
+        uint4 lineStart = uint4(center.y, center.x, center.y, center.x) - widths / 2;
+        bool4 inside = {
+            cellPos.x < farEnd.x && (cellPos.y - lineStart.x) < widths.x,
+            cellPos.y < farEnd.y && (cellPos.x - lineStart.y) < widths.y,
+            cellPos.x >= nearEnd.x && (cellPos.y - lineStart.z) < widths.z,
+            cellPos.y >= nearEnd.y && (cellPos.x - lineStart.w) < widths.w,
+        };
+        return any(inside) ? 1.0f : 0.0f;
+    }
+
+    [branch] if (kind == BuiltinGlyph_Rect)
+    {
+        // A rectangle in eighths of a cell, optionally shaded at 25%, 50% or 75%.
+        uint4 eighths = shape >> uint4(0, 4, 8, 12) & 15; // left, top, right, bottom
+        uint2 topLeft = eighths.xy * cellSize / 8;
+        uint2 bottomRight = eighths.zw * cellSize / 8;
+        uint shade = shape >> 16 & 3;
+        return all(cellPos >= topLeft && cellPos < bottomRight) ? (shade ? shade * 0.25f : 1.0f) : 0.0f;
+    }
+
+    // BuiltinGlyph_Quadrants: 1 bit per quadrant in the order top left, top right, bottom left, bottom right.
+    uint2 quadrant = cellPos >= cellSize / 2;
+    return float(shape >> (quadrant.x | quadrant.y << 1) & 1);
+}
+
 // clang-format off
 float4 main(float4 pos: SV_Position): SV_Target
 // clang-format on
@@ -87,15 +156,26 @@ float4 main(float4 pos: SV_Position): SV_Target
         return decodeRGBA(backgroundColor);
     }
 
-    uint2 viewportPos = pos.xy - viewport.xy;
+    // While smooth scrolling the rows are shifted up (or down, if negative) by scrollPixelOffset.
+    // The sliver this uncovers at the bottom (or top) belongs to a row outside of the viewport.
+    int2 shiftedPos = int2(pos.xy - viewport.xy) + int2(0, scrollPixelOffset);
+    [branch] if (shiftedPos.y < 0 || shiftedPos.y >= int(viewport.w - viewport.y))
+    {
+        return decodeRGBA(backgroundColor);
+    }
+
+    uint2 viewportPos = uint2(shiftedPos);
     uint2 cellIndex = viewportPos / cellSize;
     uint2 cellPos = viewportPos % cellSize;
-    Cell cell = cells[cellIndex.y * cellCountX + cellIndex.x];
+    // The cells are stored in a ring buffer of rows. See AtlasEngine::_getCellRow().
+    uint row = cellIndex.y + cellRowOffset;
+    row -= row >= cellCountY ? cellCountY : 0;
+    Cell cell = cells[row * cellCountX + cellIndex.x];
 
     // Layer 0:
     // The cell's background color
-    float4 color = decodeRGBA(cell.color.y);
-    float4 fg = decodeRGBA(cell.color.x);
+    float4 color = decodeRGBA(resolveColor(cell.flags, CellFlags_PaletteBackground, cell.color.y));
+    float4 fg = decodeRGBA(resolveColor(cell.flags, CellFlags_PaletteForeground, cell.color.x));
 
     // Layer 1 (optional):
     // Colored cursors are drawn "in between" the background color and the text of a cell.
@@ -126,6 +206,13 @@ float4 main(float4 pos: SV_Position): SV_Target
 
     // Layer 2:
     // Step 1: The cell's glyph, potentially drawn in the foreground color
+    [branch] if (cell.flags & CellFlags_BuiltinGlyph)
+    {
+        // These are drawn pixel-perfect at any size, so they
+        // skip the gamma and contrast adjustments for text below.
+        color = alphaBlendPremultiplied(color, fg * builtinGlyphCoverage(cell.glyphPos, cellPos));
+    }
+    else
     {
         float4 glyph = glyphs[decodeU16x2(cell.glyphPos) + cellPos];
 
@@ -191,7 +278,12 @@ float4 main(float4 pos: SV_Position): SV_Target
     }
 
     // Layer 4:
-    // The current selection is drawn semi-transparent on top.
+    // Highlights (like all matches of a search) and the current
+    // selection are drawn semi-transparent on top, in that order.
+    [branch] if (cell.flags & CellFlags_Highlighted)
+    {
+        color = alphaBlendPremultiplied(color, decodeRGBA(highlightColor));
+    }
     [branch] if (cell.flags & CellFlags_Selected)
     {
         color = alphaBlendPremultiplied(color, decodeRGBA(selectionColor));
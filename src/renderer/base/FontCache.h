@@ -5,8 +5,33 @@
 
 namespace Microsoft::Console::Render::FontCache
 {
+    struct FontFace
+    {
+        wil::com_ptr<IDWriteFontFamily> family;
+        wil::com_ptr<IDWriteFont> font;
+        wil::com_ptr<IDWriteFontFace> face;
+    };
+
     namespace details
     {
+        using FontFaceKey = std::tuple<IDWriteFontCollection*, std::wstring, DWRITE_FONT_WEIGHT, DWRITE_FONT_STRETCH, DWRITE_FONT_STYLE>;
+
+        // The font collection and the faces resolved from it are shared by all renderers in the process.
+        struct State
+        {
+            wil::srwlock lock;
+            wil::com_ptr<IDWriteFontCollection> fontCollection;
+            // The value holds a reference to the collection in the key, so that a collection
+            // that was replaced by GetFresh() can't be mistaken for a new one at the same address.
+            std::map<FontFaceKey, std::pair<wil::com_ptr<IDWriteFontCollection>, FontFace>> fontFaces;
+        };
+
+        inline State& getState()
+        {
+            static State state;
+            return state;
+        }
+
         inline const std::vector<wil::com_ptr<IDWriteFontFile>>& getNearbyFontFiles(IDWriteFactory5* factory5)
         {
             static const auto fontFiles = [=]() {
@@ -87,13 +112,75 @@ namespace Microsoft::Console::Render::FontCache
         }
     }
 
+    // Returns the system font collection, together with the fonts next to our executable.
+    // It's only built once per process, because building it is fairly expensive.
     inline wil::com_ptr<IDWriteFontCollection> GetCached()
     {
-        return details::getFontCollection(false);
+        auto& state = details::getState();
+        {
+            const auto guard = state.lock.lock_shared();
+            if (state.fontCollection)
+            {
+                return state.fontCollection;
+            }
+        }
+
+        auto fontCollection = details::getFontCollection(false);
+
+        const auto guard = state.lock.lock_exclusive();
+        if (!state.fontCollection)
+        {
+            state.fontCollection = std::move(fontCollection);
+        }
+        return state.fontCollection;
     }
 
+    // Like GetCached(), but picks up fonts that were installed in the meantime.
+    // This also replaces the collection GetCached() returns and forgets all cached font faces.
     inline wil::com_ptr<IDWriteFontCollection> GetFresh()
     {
-        return details::getFontCollection(true);
+        auto fontCollection = details::getFontCollection(true);
+
+        auto& state = details::getState();
+        const auto guard = state.lock.lock_exclusive();
+        state.fontCollection = fontCollection;
+        state.fontFaces.clear();
+        return fontCollection;
+    }
+
+    // Finds the font of the given family in the given collection that matches the given
+    // properties best, like IDWriteFontFamily::GetFirstMatchingFont. The result is
+    // cached for the whole process, so that opening another tab or moving a window to
+    // another display doesn't need to ask DirectWrite again. Font faces don't depend
+    // on the font size, which is why it isn't part of the key.
+    // Returns an empty FontFace if the family doesn't exist.
+    inline FontFace FindFontFace(IDWriteFontCollection* fontCollection, const std::wstring_view familyName, const DWRITE_FONT_WEIGHT weight, const DWRITE_FONT_STRETCH stretch, const DWRITE_FONT_STYLE style)
+    {
+        auto& state = details::getState();
+        details::FontFaceKey key{ fontCollection, familyName, weight, stretch, style };
+        {
+            const auto guard = state.lock.lock_shared();
+            if (const auto it = state.fontFaces.find(key); it != state.fontFaces.end())
+            {
+                return it->second.second;
+            }
+        }
+
+        FontFace result;
+
+        UINT32 index = 0;
+        BOOL exists = false;
+        THROW_IF_FAILED(fontCollection->FindFamilyName(std::get<std::wstring>(key).c_str(), &index, &exists));
+
+        if (exists)
+        {
+            THROW_IF_FAILED(fontCollection->GetFontFamily(index, result.family.addressof()));
+            THROW_IF_FAILED(result.family->GetFirstMatchingFont(weight, stretch, style, result.font.addressof()));
+            THROW_IF_FAILED(result.font->CreateFontFace(result.face.addressof()));
+        }
+
+        const auto guard = state.lock.lock_exclusive();
+        state.fontFaces.emplace(std::move(key), std::pair{ wil::com_ptr<IDWriteFontCollection>{ fontCollection }, result });
+        return result;
     }
 }
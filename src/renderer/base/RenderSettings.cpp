@@ -259,13 +259,44 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
             fg != bg &&
             GetRenderMode(Mode::AlwaysDistinguishableColors))
         {
-            fg = ColorFix::GetPerceivableColor(fg, bg);
+            fg = _GetPerceivableColor(fg, bg);
         }
 
         return { fg, bg };
     }
 }
 
+// Routine Description:
+// - Calls ColorFix::GetPerceivableColor, unless the result for the given pair is still cached.
+// - This is for arbitrary (truecolor or 256-color) pairs, which are too numerous to precompute.
+// Arguments:
+// - fg - The foreground color. Must differ from bg.
+// - bg - The background color.
+// Return Value:
+// - The foreground color adjusted for perceivability.
+COLORREF RenderSettings::_GetPerceivableColor(const COLORREF fg, const COLORREF bg) const noexcept
+{
+    const auto key = uint64_t{ fg } << 32 | bg;
+    const auto index = gsl::narrow_cast<size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - PerceivableColorCacheSetsLog2));
+    auto& set = til::at(_perceivableColorCache, index);
+
+    // The way at index 0 is always the most recently used one. The entries start out
+    // zeroed, and since fg != bg they can't be mistaken for a cached result.
+    if (set[0].fg == fg && set[0].bg == bg)
+    {
+        return set[0].result;
+    }
+    if (set[1].fg == fg && set[1].bg == bg)
+    {
+        std::swap(set[0], set[1]);
+        return set[0].result;
+    }
+
+    set[1] = set[0];
+    set[0] = { fg, bg, ColorFix::GetPerceivableColor(fg, bg) };
+    return set[0].result;
+}
+
 // Routine Description:
 // - Calculates the RGBA colors of a given text attribute, using the current
 //   color table configuration and active render settings. This differs from
@@ -289,6 +320,62 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColorsWithAlpha(const
     return { fg, bg };
 }
 
+// Routine Description:
+// - Returns the color table indices that GetAttributeColors() looks the colors of the given
+//   attribute up with, so that a renderer can refer to the table instead of to the resulting
+//   colors. This allows it to apply color table changes without repainting the text.
+// - Colors that aren't a plain lookup (RGB, dimmed or adjusted for distinguishability)
+//   return std::nullopt. The default colors return DefaultForegroundIndex and
+//   DefaultBackgroundIndex, which stand for the entries the color aliases refer to.
+// Arguments:
+// - attr - The TextAttribute to retrieve the color indices for.
+// Return Value:
+// - The color indices of the attribute's foreground and background.
+std::pair<std::optional<size_t>, std::optional<size_t>> RenderSettings::GetAttributeColorIndices(const TextAttribute& attr) const noexcept
+{
+    // The distinguishable colors are computed from the pair of foreground and background.
+    if (Feature_AdjustIndistinguishableText::IsEnabled() &&
+        (GetRenderMode(Mode::IndexedDistinguishableColors) || GetRenderMode(Mode::AlwaysDistinguishableColors)))
+    {
+        return {};
+    }
+
+    const auto getIndex = [](const TextColor& color, const size_t defaultIndex, const bool brighten) noexcept -> std::optional<size_t> {
+        if (color.IsRgb())
+        {
+            return std::nullopt;
+        }
+        if (color.IsDefault())
+        {
+            // TextColor::GetColor() brightens default colors by searching for them in the color
+            // table, which means that the result depends on the table's contents.
+            return brighten ? std::nullopt : std::optional{ defaultIndex };
+        }
+        if (color.IsIndex16() && brighten)
+        {
+            return size_t{ color.GetIndex() } | 8;
+        }
+        return color.GetIndex();
+    };
+
+    const auto brightenFg = attr.IsIntense() && GetRenderMode(Mode::IntenseIsBright);
+    const auto dimFg = attr.IsFaint() || (_blinkShouldBeFaint && attr.IsBlinking());
+
+    auto fg = dimFg ? std::nullopt : getIndex(attr.GetForeground(), DefaultForegroundIndex, brightenFg);
+    auto bg = getIndex(attr.GetBackground(), DefaultBackgroundIndex, false);
+
+    if (attr.IsReverseVideo() ^ GetRenderMode(Mode::ScreenReversed))
+    {
+        std::swap(fg, bg);
+    }
+    if (attr.IsInvisible())
+    {
+        fg = bg;
+    }
+
+    return { fg, bg };
+}
+
 // Routine Description:
 // - Increments the position in the blink cycle, toggling the blink rendition
 //   state on every second call, potentially triggering a redraw of the given
@@ -313,7 +400,7 @@ try
             // We reset the _blinkIsInUse flag before redrawing, so we can
             // get a fresh assessment of the current blink attribute usage.
             _blinkIsInUse = false;
-            renderer.TriggerRedrawAll();
+            renderer.TriggerRedrawBlinking();
         }
     }
 }
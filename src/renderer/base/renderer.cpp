@@ -15,6 +15,15 @@ static constexpr auto maxRetriesForRenderEngine = 3;
 // The renderer will wait this number of milliseconds * how many tries have elapsed before trying again.
 static constexpr auto renderBackoffBaseTimeMilliseconds{ 150 };
 
+// Returns the number of microseconds since start and moves start to now.
+static uint32_t lap(std::chrono::steady_clock::time_point& start) noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+    start = now;
+    return gsl::narrow_cast<uint32_t>(std::min<decltype(elapsed)>(elapsed, UINT32_MAX));
+}
+
 #define FOREACH_ENGINE(var)   \
     for (auto var : _engines) \
         if (!var)             \
@@ -58,47 +67,96 @@ Renderer::~Renderer()
 
 // Routine Description:
 // - Walks through the console data structures to compose a new frame based on the data that has changed since last call and outputs it to the connected rendering engine.
+// - If there's a second engine, it paints its frame on _paintWork at the same time,
+//   so that the frame takes as long as the slowest engine instead of all of them.
+//   This way the VtEngine's pipe write and the GdiEngine's blit don't wait on each other.
 // Arguments:
 // - <none>
 // Return Value:
 // - HRESULT S_OK, GDI error, Safe Math error, or state/argument errors.
 [[nodiscard]] HRESULT Renderer::PaintFrame()
 {
-    FOREACH_ENGINE(pEngine)
+    const auto pEngine = _engines[0];
+    if (!pEngine)
+    {
+        return S_OK;
+    }
+
+    _enginesStarted = 0;
+
+    const auto secondEngine = _engines[1];
+    const auto parallel = secondEngine && _paintWork;
+    if (parallel)
+    {
+        SubmitThreadpoolWork(_paintWork.get());
+    }
+
+    auto hr = _PaintFrameWithRetries(pEngine);
+
+    if (parallel)
     {
-        auto tries = maxRetriesForRenderEngine;
-        while (tries > 0)
+        WaitForThreadpoolWorkCallbacks(_paintWork.get(), FALSE);
+        if (hr == S_OK)
         {
-            if (_destructing)
-            {
-                return S_FALSE;
-            }
+            hr = _paintWorkResult;
+        }
+    }
+    else if (secondEngine && hr == S_OK)
+    {
+        hr = _PaintFrameWithRetries(secondEngine);
+    }
+
+    return hr;
+}
+
+// Routine Description:
+// - Paints the second engine's frame on a threadpool thread, see PaintFrame.
+void CALLBACK Renderer::s_PaintWorkCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+{
+    const auto renderer = static_cast<Renderer*>(context);
+    renderer->_paintWorkResult = renderer->_PaintFrameWithRetries(renderer->_engines[1]);
+}
+
+// Routine Description:
+// - Paints a frame with the given engine and retries a few times if the engine asks for it.
+// Arguments:
+// - pEngine - The engine to paint with
+// Return Value:
+// - S_FALSE if the renderer is shutting down or the engine kept failing, S_OK otherwise.
+[[nodiscard]] HRESULT Renderer::_PaintFrameWithRetries(_In_ IRenderEngine* const pEngine) noexcept
+{
+    auto tries = maxRetriesForRenderEngine;
+    while (tries > 0)
+    {
+        if (_destructing)
+        {
+            return S_FALSE;
+        }
 
-            const auto hr = _PaintFrameForEngine(pEngine);
-            if (E_PENDING == hr)
+        const auto hr = _PaintFrameForEngine(pEngine);
+        if (E_PENDING == hr)
+        {
+            if (--tries == 0)
             {
-                if (--tries == 0)
+                // Stop trying.
+                _pThread->DisablePainting();
+                if (_pfnRendererEnteredErrorState)
                 {
-                    // Stop trying.
-                    _pThread->DisablePainting();
-                    if (_pfnRendererEnteredErrorState)
-                    {
-                        _pfnRendererEnteredErrorState();
-                    }
-                    // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
-                    // isn't near as bad as the entire application aborting. We're a component. We shouldn't
-                    // abort applications that host us.
-                    return S_FALSE;
+                    _pfnRendererEnteredErrorState();
                 }
-
-                // Add a bit of backoff.
-                // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
-                Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
-                continue;
+                // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
+                // isn't near as bad as the entire application aborting. We're a component. We shouldn't
+                // abort applications that host us.
+                return S_FALSE;
             }
-            LOG_IF_FAILED(hr);
-            break;
+
+            // Add a bit of backoff.
+            // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
+            Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
+            continue;
         }
+        LOG_IF_FAILED(hr);
+        break;
     }
 
     return S_OK;
@@ -109,13 +167,28 @@ try
 {
     FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
 
+    // See GetFrameTimings. Reading the clock a few times per frame is cheap enough to always do it.
+    std::array<uint32_t, FrameTimings::PhaseCount> timings{};
+    const auto frameStart = std::chrono::steady_clock::now();
+    auto phaseStart = frameStart;
+
     _pData->LockConsole();
     auto unlock = wil::scope_exit([&]() {
         _pData->UnlockConsole();
     });
+    til::at(timings, FrameTimings::LockWait) = lap(phaseStart);
 
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
+    pEngine->SetSubRowScrollOffset(_subRowScrollOffset);
+
+    // Pick up the rows that were modified since the last frame. This invalidates them in all
+    // engines. The ones that have already started painting this frame need another one to show them.
+    if (_InvalidateDirtyRows() && _enginesStarted != 0)
+    {
+        NotifyPaintFrame();
+    }
+    ++_enginesStarted;
 
     // Try to start painting a frame
     const auto hr = pEngine->StartPaint();
@@ -129,6 +202,19 @@ try
         return S_OK;
     }
 
+    // Engines that paint without the console lock apply the invalidations
+    // that were deferred in the meantime once they're done with the frame.
+    std::unique_lock unlockedPaint{ _unlockedPaintMutex, std::defer_lock };
+    auto finishUnlockedPaint = wil::scope_exit([&]() {
+        if (unlockedPaint.owns_lock())
+        {
+            unlockedPaint.unlock();
+            _pData->LockConsole();
+            _ApplyDeferredInvalidations();
+            _pData->UnlockConsole();
+        }
+    });
+
     auto endPaint = wil::scope_exit([&]() {
         LOG_IF_FAILED(pEngine->EndPaint());
 
@@ -142,28 +228,49 @@ try
     });
 
     // A. Prep Colors
-    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, {}, false, true));
+    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _renderSettings, {}, false, true));
 
     // B. Perform Scroll Operations
     RETURN_IF_FAILED(_PerformScrolling(pEngine));
 
-    // C. Prepare the engine with additional information before we start drawing.
+    // C. Copy everything the rest of the frame is painted from out of the console.
+    // This must come after scrolling as that can change the dirty area.
+    _CaptureFrame(pEngine);
+    const auto overlays = _pData->GetOverlays();
+
+    // D. Prepare the engine with additional information before we start drawing.
     RETURN_IF_FAILED(_PrepareRenderInfo(pEngine));
 
+    // Engines that don't need the console lock for the rest of the frame let it go now,
+    // so that the console can keep changing while they draw. Overlays have no copy
+    // in the captured frame, which is why they still need the lock. Only one engine
+    // at a time can do so, because the invalidations are only deferred for one.
+    if (overlays.empty() && pEngine->PaintsWithoutLock() && unlockedPaint.try_lock())
+    {
+        _unlockedEngine = pEngine;
+        unlock.reset();
+    }
+
     // 1. Paint Background
     RETURN_IF_FAILED(_PaintBackground(pEngine));
 
     // 2. Paint Rows of Text
+    lap(phaseStart);
     _PaintBufferOutput(pEngine);
+    til::at(timings, FrameTimings::BufferOutput) = lap(phaseStart);
 
     // 3. Paint overlays that reside above the text buffer
-    _PaintOverlays(pEngine);
+    _PaintOverlays(pEngine, overlays);
 
-    // 4. Paint Selection
+    // 4. Paint Highlights and Selection
+    lap(phaseStart);
+    _PaintHighlights(pEngine);
     _PaintSelection(pEngine);
+    til::at(timings, FrameTimings::Selection) = lap(phaseStart);
 
     // 5. Paint Cursor
     _PaintCursor(pEngine);
+    til::at(timings, FrameTimings::Cursor) = lap(phaseStart);
 
     // 6. Paint window title
     RETURN_IF_FAILED(_PaintTitle(pEngine));
@@ -175,13 +282,154 @@ try
     unlock.reset();
 
     // Trigger out-of-lock presentation for renderers that can support it
+    lap(phaseStart);
     RETURN_IF_FAILED(pEngine->Present());
+    til::at(timings, FrameTimings::Present) = lap(phaseStart);
+
+    finishUnlockedPaint.reset();
+
+    auto totalStart = frameStart;
+    til::at(timings, FrameTimings::Total) = lap(totalStart);
+    _RecordFrameTimings(timings);
 
     // As we leave the scope, EndPaint will be called (declared above)
     return S_OK;
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Adds the timings of a frame to the statistics returned by GetFrameTimings
+//   and passes them to the frame timings callback, if any.
+// Arguments:
+// - timings - how long each phase of the frame took, in microseconds
+// Return Value:
+// - <none>
+void Renderer::_RecordFrameTimings(const std::array<uint32_t, FrameTimings::PhaseCount>& timings)
+{
+    uint32_t scratchAllocations;
+    size_t scratchBytes;
+
+    // The engines of a renderer may finish their frames at the same time, see PaintFrame.
+    {
+        const std::lock_guard guard{ _frameTimingsMutex };
+        const auto allocations = _scratchResource.allocations();
+        scratchAllocations = gsl::narrow_cast<uint32_t>(allocations - _scratchAllocationsRecorded);
+        scratchBytes = _scratchResource.bytes();
+        _scratchAllocationsRecorded = allocations;
+
+        _frameTimings.Record(timings);
+        _frameTimings.scratchAllocations += scratchAllocations;
+        _frameTimings.scratchBytes = scratchBytes;
+    }
+
+    if (_pfnFrameTimings)
+    {
+        FrameTimings frame;
+        frame.Record(timings);
+        frame.scratchAllocations = scratchAllocations;
+        frame.scratchBytes = scratchBytes;
+        _pfnFrameTimings(frame);
+    }
+}
+
+// Routine Description:
+// - Returns how long painting the frames since the last reset took.
+// - Safe to call from any thread.
+// Arguments:
+// - reset - if true, the statistics start over afterwards
+// Return Value:
+// - the timings of the last frame and histograms of all frames since the last reset
+FrameTimings Renderer::GetFrameTimings(const bool reset)
+{
+    const std::lock_guard guard{ _frameTimingsMutex };
+    auto timings = _frameTimings;
+    if (reset)
+    {
+        _frameTimings = {};
+    }
+    return timings;
+}
+
+// Method Description:
+// - Registers a callback that's called on the render thread after each frame
+//   with the timings of that frame. An application can use this to trace them.
+// Arguments:
+// - pfn: the callback
+// Return Value:
+// - <none>
+void Renderer::SetFrameTimingsCallback(std::function<void(const FrameTimings&)> pfn)
+{
+    _pfnFrameTimings = std::move(pfn);
+}
+
+// Routine Description:
+// - Adds the timings of a frame to the histograms.
+// Arguments:
+// - frame - how long each phase of the frame took, in microseconds
+// Return Value:
+// - <none>
+void FrameTimings::Record(const std::array<uint32_t, PhaseCount>& frame) noexcept
+{
+    last = frame;
+    for (size_t phase = 0; phase < PhaseCount; ++phase)
+    {
+        Record(til::at(histograms, phase), til::at(frame, phase));
+    }
+    ++frameCount;
+}
+
+// Routine Description:
+// - Adds a duration to a histogram.
+// Arguments:
+// - histogram - the histogram
+// - duration - the duration, in microseconds
+// Return Value:
+// - <none>
+void FrameTimings::Record(Histogram& histogram, const uint32_t duration) noexcept
+{
+    size_t bucket = 0;
+    for (auto d = duration; d != 0 && bucket < HistogramBuckets - 1; d >>= 1)
+    {
+        ++bucket;
+    }
+    ++til::at(histogram, bucket);
+}
+
+// Routine Description:
+// - Estimates a percentile of the durations of the given phase from its histogram.
+// Arguments:
+// - phase - the phase
+// - percent - the percentile, between 0 and 100
+// Return Value:
+// - the upper bound in microseconds of the bucket the percentile falls into
+uint32_t FrameTimings::Percentile(const Phase phase, const uint32_t percent) const noexcept
+{
+    return Percentile(til::at(histograms, phase), frameCount, percent);
+}
+
+// Routine Description:
+// - Estimates a percentile of the durations in a histogram.
+// Arguments:
+// - histogram - the histogram
+// - count - how many durations were added to it
+// - percent - the percentile, between 0 and 100
+// Return Value:
+// - the upper bound in microseconds of the bucket the percentile falls into
+uint32_t FrameTimings::Percentile(const Histogram& histogram, const uint32_t count, const uint32_t percent) noexcept
+{
+    const auto threshold = (uint64_t{ count } * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < HistogramBuckets; ++bucket)
+    {
+        seen += til::at(histogram, bucket);
+        if (seen >= threshold)
+        {
+            return 1u << bucket;
+        }
+    }
+    return 1u << (HistogramBuckets - 1);
+}
+
 void Renderer::NotifyPaintFrame() noexcept
 {
     // If we're running in the unittests, we might not have a render thread.
@@ -202,7 +450,10 @@ void Renderer::TriggerSystemRedraw(const til::rect* const prcDirtyClient)
 {
     FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
+        if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::System, *prcDirtyClient }))
+        {
+            LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
+        }
     }
 
     NotifyPaintFrame();
@@ -215,6 +466,20 @@ void Renderer::TriggerSystemRedraw(const til::rect* const prcDirtyClient)
 // Return Value:
 // - <none>
 void Renderer::TriggerRedraw(const Viewport& region)
+{
+    if (_InvalidateRegion(region))
+    {
+        NotifyPaintFrame();
+    }
+}
+
+// Routine Description:
+// - Invalidates the given region of the buffer in all engines.
+// Arguments:
+// - region - the buffer-space region that has changed
+// Return Value:
+// - true if any part of the region is visible and was invalidated
+bool Renderer::_InvalidateRegion(const Viewport& region)
 {
     auto view = _viewport;
     auto srUpdateRegion = region.ToExclusive();
@@ -236,11 +501,37 @@ void Renderer::TriggerRedraw(const Viewport& region)
         view.ConvertToOrigin(&srUpdateRegion);
         FOREACH_ENGINE(pEngine)
         {
-            LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+            if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Region, srUpdateRegion }))
+            {
+                LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+            }
         }
 
-        NotifyPaintFrame();
+        return true;
+    }
+
+    return false;
+}
+
+// Routine Description:
+// - Invalidates the visible rows of the text buffer that were modified since
+//   the last time this was called, see TextBuffer::ConsumeDirtyRows.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if anything was invalidated
+bool Renderer::_InvalidateDirtyRows()
+{
+    const auto view = _viewport.ToInclusive();
+    auto invalidated = false;
+    for (const auto& rect : _pData->GetTextBuffer().ConsumeDirtyRows(view.Top, view.Bottom))
+    {
+        if (_InvalidateRegion(Viewport::FromExclusive(rect)))
+        {
+            invalidated = true;
+        }
     }
+    return invalidated;
 }
 
 // Routine Description:
@@ -286,7 +577,10 @@ void Renderer::TriggerRedrawCursor(const til::point* const pcoord)
             const auto updateRect = view.ConvertToOrigin(cursorView).ToExclusive();
             FOREACH_ENGINE(pEngine)
             {
-                LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
+                if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Cursor, updateRect }))
+                {
+                    LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
+                }
             }
 
             NotifyPaintFrame();
@@ -294,6 +588,38 @@ void Renderer::TriggerRedrawCursor(const til::point* const pcoord)
     }
 }
 
+// Routine Description:
+// - Called when the blink rendition state changed. Only the runs of blinking
+//   cells in the viewport look any different, so only those are invalidated.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::TriggerRedrawBlinking()
+{
+    const auto& buffer = _pData->GetTextBuffer();
+    const auto view = _pData->GetViewport().ToExclusive();
+    const auto width = buffer.GetSize().Width();
+    auto invalidated = false;
+
+    for (auto y = view.Top; y < view.Bottom; ++y)
+    {
+        til::CoordType x = 0;
+        buffer.GetRowByOffset(y).GetAttrRow().ForEachRun(0, width, [&](const TextAttribute& attr, const uint16_t length) {
+            if (attr.IsBlinking())
+            {
+                invalidated |= _InvalidateRegion(Viewport::FromExclusive({ x, y, x + length, y + 1 }));
+            }
+            x += length;
+        });
+    }
+
+    if (invalidated)
+    {
+        NotifyPaintFrame();
+    }
+}
+
 // Routine Description:
 // - Called when something that changes the output state has occurred and the entire frame is now potentially invalid.
 // - NOTE: Use sparingly. Try to reduce the refresh region where possible. Only use when a global state change has occurred.
@@ -306,7 +632,42 @@ void Renderer::TriggerRedrawAll(const bool backgroundChanged, const bool frameCh
 {
     FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->InvalidateAll());
+        if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::All }))
+        {
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+        }
+    }
+
+    NotifyPaintFrame();
+
+    if (backgroundChanged && _pfnBackgroundColorChanged)
+    {
+        _pfnBackgroundColorChanged();
+    }
+
+    if (frameChanged && _pfnFrameColorChanged)
+    {
+        _pfnFrameColorChanged();
+    }
+}
+
+// Routine Description:
+// - Called when entries of the color table have changed, but nothing else that affects how
+//   the text is drawn (like the color aliases or the render modes). Unlike TriggerRedrawAll()
+//   this allows engines to only update their copy of the table.
+// Arguments:
+// - backgroundChanged - Set to true if the background color has changed.
+// - frameChanged - Set to true if the frame colors have changed.
+// Return Value:
+// - <none>
+void Renderer::TriggerColorTableChange(const bool backgroundChanged, const bool frameChanged)
+{
+    FOREACH_ENGINE(pEngine)
+    {
+        if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::ColorTable }))
+        {
+            LOG_IF_FAILED(pEngine->InvalidateColorTable());
+        }
     }
 
     NotifyPaintFrame();
@@ -372,6 +733,19 @@ void Renderer::TriggerSelection()
 
         FOREACH_ENGINE(pEngine)
         {
+            if (pEngine == _unlockedEngine)
+            {
+                for (const auto& rect : _previousSelection)
+                {
+                    _DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Selection, rect });
+                }
+                for (const auto& rect : rects)
+                {
+                    _DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Selection, rect });
+                }
+                continue;
+            }
+
             LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
             LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
         }
@@ -408,6 +782,12 @@ bool Renderer::_CheckViewportAndScroll()
 
     FOREACH_ENGINE(engine)
     {
+        if (_DeferInvalidation(engine, { DeferredInvalidation::Kind::Viewport, {}, {}, srNewViewport }))
+        {
+            _DeferInvalidation(engine, { DeferredInvalidation::Kind::Scroll, {}, coordDelta });
+            continue;
+        }
+
         LOG_IF_FAILED(engine->UpdateViewport(srNewViewport));
         LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
     }
@@ -444,7 +824,10 @@ void Renderer::TriggerScroll(const til::point* const pcoordDelta)
 {
     FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
+        if (!_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Scroll, {}, *pcoordDelta }))
+        {
+            LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
+        }
     }
 
     _ScrollPreviousSelection(*pcoordDelta);
@@ -452,6 +835,47 @@ void Renderer::TriggerScroll(const til::point* const pcoordDelta)
     NotifyPaintFrame();
 }
 
+// Routine Description:
+// - Called when the whole rows of a region of the buffer moved up or down, for
+//   instance inside of the scroll margins. Engines that can move the rows
+//   themselves don't need to repaint them. All others get the region invalidated.
+// Arguments:
+// - region - the buffer-space region whose rows moved
+// - delta - the number of rows the contents moved down. Negative if they moved up.
+// Return Value:
+// - <none>
+void Renderer::TriggerScrollRegion(const Viewport& region, const til::CoordType delta)
+{
+    const auto view = _viewport;
+    if (!view.IsInBounds(region) || region.Left() != view.Left() || region.Width() != view.Width())
+    {
+        TriggerRedraw(region);
+        return;
+    }
+
+    auto srUpdateRegion = region.ToExclusive();
+    view.ConvertToOrigin(&srUpdateRegion);
+    FOREACH_ENGINE(pEngine)
+    {
+        if (_DeferInvalidation(pEngine, { DeferredInvalidation::Kind::Region, srUpdateRegion }))
+        {
+            continue;
+        }
+
+        const auto hr = pEngine->InvalidateScrollRegion(srUpdateRegion, delta);
+        if (hr == S_FALSE)
+        {
+            LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+        }
+        else
+        {
+            LOG_IF_FAILED(hr);
+        }
+    }
+
+    NotifyPaintFrame();
+}
+
 // Routine Description:
 // - Called when the text buffer is about to circle its backing buffer.
 //      A renderer might want to get painted before that happens.
@@ -461,6 +885,10 @@ void Renderer::TriggerScroll(const til::point* const pcoordDelta)
 // - <none>
 void Renderer::TriggerFlush(const bool circling)
 {
+    // Flushing might paint a frame right here, which would overwrite the one
+    // that's being painted without the console lock.
+    _WaitForUnlockedPaint();
+
     const auto rects = _GetSelectionRects();
 
     FOREACH_ENGINE(pEngine)
@@ -487,6 +915,8 @@ void Renderer::TriggerFlush(const bool circling)
 // - <none>
 void Renderer::TriggerTitleChange()
 {
+    _WaitForUnlockedPaint();
+
     const auto newTitle = _pData->GetConsoleTitle();
     FOREACH_ENGINE(pEngine)
     {
@@ -497,6 +927,8 @@ void Renderer::TriggerTitleChange()
 
 void Renderer::TriggerNewTextNotification(const std::wstring_view newText)
 {
+    _WaitForUnlockedPaint();
+
     FOREACH_ENGINE(pEngine)
     {
         LOG_IF_FAILED(pEngine->NotifyNewText(newText));
@@ -511,8 +943,19 @@ void Renderer::TriggerNewTextNotification(const std::wstring_view newText)
 // - the HRESULT of the underlying engine's UpdateTitle call.
 HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 {
-    const auto newTitle = _pData->GetConsoleTitle();
-    return pEngine->UpdateTitle(newTitle);
+    return pEngine->UpdateTitle(_GetCapturedFrame(pEngine).title);
+}
+
+// Routine Description:
+// - Each engine captures its own frame, because they can paint at the same time.
+// Arguments:
+// - pEngine - one of the _engines
+// Return Value:
+// - the frame captured for the engine
+Renderer::CapturedFrame& Renderer::_GetCapturedFrame(const IRenderEngine* const pEngine) noexcept
+{
+    const auto index = std::find(_engines.begin(), _engines.end(), pEngine) - _engines.begin();
+    return til::at(_capturedFrames, gsl::narrow_cast<size_t>(index));
 }
 
 // Routine Description:
@@ -525,6 +968,8 @@ HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 // - <none>
 void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo)
 {
+    _WaitForUnlockedPaint();
+
     FOREACH_ENGINE(pEngine)
     {
         LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
@@ -544,6 +989,21 @@ void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfo
 // - <none>
 void Renderer::UpdateSoftFont(const gsl::span<const uint16_t> bitPattern, const til::size cellSize, const size_t centeringHint)
 {
+    // Applications tend to download the same font over and over again, for example
+    // whenever they redraw their screen. Since the engines have to rasterize the
+    // font again on every update, we skip anything that wouldn't change the output.
+    if (cellSize == _softFontCellSize && centeringHint == _softFontCenteringHint &&
+        std::equal(bitPattern.begin(), bitPattern.end(), _softFontBitPattern.begin(), _softFontBitPattern.end()))
+    {
+        return;
+    }
+
+    _WaitForUnlockedPaint();
+
+    _softFontBitPattern.assign(bitPattern.begin(), bitPattern.end());
+    _softFontCellSize = cellSize;
+    _softFontCenteringHint = centeringHint;
+
     // We reserve PUA code points U+EF20 to U+EF7F for soft fonts, but the range
     // that we test for in _IsSoftFontChar will depend on the size of the active
     // bitPattern. If it's empty (i.e. no soft font is set), then nothing will
@@ -581,6 +1041,7 @@ bool Renderer::s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSo
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
+    _WaitForUnlockedPaint();
     FOREACH_ENGINE(pEngine)
     {
         const auto hr = LOG_IF_FAILED(pEngine->GetProposedFont(FontInfoDesired, FontInfo, iDpi));
@@ -612,6 +1073,7 @@ bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
+    _WaitForUnlockedPaint();
     FOREACH_ENGINE(pEngine)
     {
         const auto hr = LOG_IF_FAILED(pEngine->IsGlyphWideByFont(glyph, &fIsFullWidth));
@@ -669,30 +1131,177 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
 }
 
 // Routine Description:
-// - Paint helper to copy the primary console buffer text onto the screen.
+// - Queues up an invalidation for the engine that is painting without the console
+//   lock, because we can't call into it until it's done with the frame.
+// - Like all the other Trigger*() callers, this must be called with the console lock held.
+// Arguments:
+// - pEngine - The engine that is being invalidated
+// - invalidation - The invalidation
+// Return Value:
+// - true if the invalidation was deferred, false if the engine can be called right away.
+bool Renderer::_DeferInvalidation(const IRenderEngine* const pEngine, const DeferredInvalidation& invalidation)
+{
+    if (pEngine != _unlockedEngine)
+    {
+        return false;
+    }
+
+    _deferredInvalidations.emplace_back(invalidation);
+    return true;
+}
+
+// Routine Description:
+// - Hands the invalidations that were deferred by _DeferInvalidation() to their
+//   engine, after it's done painting without the console lock.
+// - Must be called with the console lock held, but without _unlockedPaintMutex.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_ApplyDeferredInvalidations() noexcept
+{
+    const auto pEngine = std::exchange(_unlockedEngine, nullptr);
+    if (!pEngine || _deferredInvalidations.empty())
+    {
+        return;
+    }
+
+    for (const auto& invalidation : _deferredInvalidations)
+    {
+        switch (invalidation.kind)
+        {
+        case DeferredInvalidation::Kind::Region:
+            LOG_IF_FAILED(pEngine->Invalidate(&invalidation.rect));
+            break;
+        case DeferredInvalidation::Kind::Cursor:
+            LOG_IF_FAILED(pEngine->InvalidateCursor(&invalidation.rect));
+            break;
+        case DeferredInvalidation::Kind::System:
+            LOG_IF_FAILED(pEngine->InvalidateSystem(&invalidation.rect));
+            break;
+        case DeferredInvalidation::Kind::Selection:
+            try
+            {
+                LOG_IF_FAILED(pEngine->InvalidateSelection({ invalidation.rect }));
+            }
+            CATCH_LOG();
+            break;
+        case DeferredInvalidation::Kind::Scroll:
+            LOG_IF_FAILED(pEngine->InvalidateScroll(&invalidation.delta));
+            break;
+        case DeferredInvalidation::Kind::Viewport:
+            LOG_IF_FAILED(pEngine->UpdateViewport(invalidation.viewport));
+            break;
+        case DeferredInvalidation::Kind::ColorTable:
+            LOG_IF_FAILED(pEngine->InvalidateColorTable());
+            break;
+        case DeferredInvalidation::Kind::All:
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+            break;
+        }
+    }
+
+    _deferredInvalidations.clear();
+    NotifyPaintFrame();
+}
+
+// Routine Description:
+// - Blocks until the engine that is painting without the console lock is done,
+//   for those calls into the engines that can't be deferred.
+// - Must be called with the console lock held.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_WaitForUnlockedPaint()
+{
+    if (_unlockedEngine)
+    {
+        const std::lock_guard lock{ _unlockedPaintMutex };
+        _ApplyDeferredInvalidations();
+    }
+}
+
+// Routine Description:
+// - Copies everything that's needed to paint the rest of the frame out of the console,
+//   so that engines can paint it without holding the console lock.
+// Arguments:
+// - pEngine - The engine the frame is for. Its dirty area decides which rows are captured.
+// Return Value:
+// - <none>
+void Renderer::_CaptureFrame(_In_ IRenderEngine* const pEngine)
+{
+    auto& frame = _GetCapturedFrame(pEngine);
+    frame.renderSettings = _renderSettings;
+    frame.text.clear();
+    frame.clusters.clear();
+    frame.runs.clear();
+    frame.gridLines.clear();
+    frame.rows.clear();
+
+    _CaptureBufferOutput(pEngine);
+
+    // The clusters were captured while the text was still growing, so they
+    // can only point into it now that it isn't going to be reallocated anymore.
+    const std::wstring_view text{ frame.text };
+    size_t offset = 0;
+    for (auto& cluster : frame.clusters)
+    {
+        const auto length = cluster.GetText().size();
+        cluster = Cluster{ text.substr(offset, length), cluster.GetColumns() };
+        offset += length;
+    }
+
+    // GetAttributeColors() is how the settings learn that there's blinking text on the
+    // screen (see ToggleBlinkRendition()), but the runs are painted with the copy.
+    for (const auto& run : frame.runs)
+    {
+        if (run.textAttributes.IsBlinking())
+        {
+            _renderSettings.GetAttributeColors(run.textAttributes);
+            break;
+        }
+    }
+
+    frame.cursorInfo = _GetCursorInfo();
+    frame.title = _pData->GetConsoleTitle();
+
+    frame.selection.clear();
+    try
+    {
+        _GetSelectionRects(frame.selection);
+    }
+    CATCH_LOG();
+
+    frame.highlights.clear();
+    try
+    {
+        _GetHighlightRects(frame.highlights);
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Capture helper to copy the primary console buffer text into the captured frame.
 // - This portion primarily handles figuring the current viewport, comparing it/trimming it versus the invalid portion of the frame, and queuing up, row by row, which pieces of text need to be further processed.
 // - See also: Helper functions that separate out each complexity of text rendering.
 // Arguments:
-// - <none>
+// - pEngine - The engine whose dirty area is captured.
 // Return Value:
 // - <none>
-void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+void Renderer::_CaptureBufferOutput(_In_ IRenderEngine* const pEngine)
 {
     // This is the subsection of the entire screen buffer that is currently being presented.
     // It can move left/right or top/bottom depending on how the viewport is scrolled
     // relative to the entire buffer.
     const auto view = _pData->GetViewport();
+    auto& frame = _GetCapturedFrame(pEngine);
 
     // This is effectively the number of cells on the visible screen that need to be redrawn.
     // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
     gsl::span<const til::rect> dirtyAreas;
     LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
-    // This is to make sure any transforms are reset when this paint is finished.
-    auto resetLineTransform = wil::scope_exit([&]() {
-        LOG_IF_FAILED(pEngine->ResetLineTransform());
-    });
-
     for (const auto& dirtyRect : dirtyAreas)
     {
         if (!dirtyRect)
@@ -733,59 +1342,124 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
             // of the backing buffer to fill in line 1 of the screen.
             const auto screenPosition = bufferLine.Origin() - til::point{ 0, view.Top() };
 
-            // Retrieve the cell information iterator limited to just this line we want to redraw.
-            auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
+            // Retrieve a cursor over just the part of this line we want to redraw.
+            const TextBufferRowCursor cursor{ buffer.GetRowByOffset(bufferLine.Top()), bufferLine.Left(), bufferLine.RightExclusive() };
 
             // Calculate if two things are true:
             // 1. this row wrapped
             // 2. We're painting the last col of the row.
-            // In that case, set lineWrapped=true for the _PaintBufferOutputHelper call.
+            // In that case, set lineWrapped=true for the PaintBufferLine calls.
             const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().Y).WasWrapForced()) &&
                                      (bufferLine.RightExclusive() == buffer.GetSize().Width());
 
-            // Prepare the appropriate line transform for the current row and viewport offset.
-            LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.Y, view.Left()));
-
-            // Ask the helper to paint through this specific line.
-            _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+            // Ask the helper to assemble this specific line and keep it, together
+            // with what the appropriate line transform needs to know about it.
+            _PaintBufferOutputHelper(cursor, screenPosition);
+            _CaptureBufferRow(frame, lineRendition, screenPosition.Y, view.Left(), lineWrapped);
         }
     }
 }
 
+// Routine Description:
+// - Appends the line that _PaintBufferOutputHelper assembled to the captured frame.
+// Arguments:
+// - frame - The frame to append the line to
+// - lineRendition - The line rendition of the row
+// - targetRow - The row on the screen it is painted at
+// - viewportLeft - The left edge of the viewport
+// - lineWrapped - Whether the line wrapped and the last column is painted
+// Return Value:
+// - <none>
+void Renderer::_CaptureBufferRow(CapturedFrame& frame, const LineRendition lineRendition, const til::CoordType targetRow, const til::CoordType viewportLeft, const bool lineWrapped)
+{
+    // The cluster texts are copied here, but they still point into the
+    // text buffer until _CaptureFrame() is done capturing all the lines.
+    for (const auto& cluster : _clusterBuffer)
+    {
+        frame.text.append(cluster.GetText());
+    }
+
+    frame.clusters.insert(frame.clusters.end(), _clusterBuffer.begin(), _clusterBuffer.end());
+    frame.runs.insert(frame.runs.end(), _bufferRowRuns.begin(), _bufferRowRuns.end());
+    frame.gridLines.insert(frame.gridLines.end(), _bufferRowGridLines.begin(), _bufferRowGridLines.end());
+    frame.rows.push_back({ lineRendition, targetRow, viewportLeft, lineWrapped, frame.clusters.size(), frame.runs.size(), frame.gridLines.size() });
+}
+
+// Routine Description:
+// - Paint helper to copy the captured lines of text onto the screen.
+// Arguments:
+// - pEngine - The engine to paint with
+// Return Value:
+// - <none>
+void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+{
+    const auto& frame = _GetCapturedFrame(pEngine);
+    const gsl::span<const Cluster> clusters{ frame.clusters };
+    const gsl::span<const IRenderEngine::BufferRowRun> runs{ frame.runs };
+    const gsl::span<const IRenderEngine::BufferRowGridLines> gridLines{ frame.gridLines };
+    size_t clustersBegin = 0;
+    size_t runsBegin = 0;
+    size_t gridLinesBegin = 0;
+
+    // This is to make sure any transforms are reset when this paint is finished.
+    auto resetLineTransform = wil::scope_exit([&]() {
+        LOG_IF_FAILED(pEngine->ResetLineTransform());
+    });
+
+    for (const auto& row : frame.rows)
+    {
+        // Prepare the appropriate line transform for the current row and viewport offset.
+        LOG_IF_FAILED(pEngine->PrepareLineTransform(row.lineRendition, row.targetRow, row.viewportLeft));
+
+        const IRenderEngine::BufferRow bufferRow{
+            clusters.subspan(clustersBegin, row.clustersEnd - clustersBegin),
+            runs.subspan(runsBegin, row.runsEnd - runsBegin),
+            gridLines.subspan(gridLinesBegin, row.gridLinesEnd - gridLinesBegin),
+            frame.renderSettings,
+            _pData,
+            row.lineWrapped,
+        };
+        _PaintBufferRow(pEngine, bufferRow);
+
+        clustersBegin = row.clustersEnd;
+        runsBegin = row.runsEnd;
+        gridLinesBegin = row.gridLinesEnd;
+    }
+}
+
 static bool _IsAllSpaces(const std::wstring_view v)
 {
     // first non-space char is not found (is npos)
     return v.find_first_not_of(L' ') == decltype(v)::npos;
 }
 
-void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
-                                        const til::point target,
-                                        const bool lineWrapped)
+void Renderer::_PaintBufferOutputHelper(TextBufferRowCursor cursor,
+                                        const til::point target)
 {
     auto globalInvert{ _renderSettings.GetRenderMode(RenderSettings::Mode::ScreenReversed) };
 
+    // The entire line is assembled first and then handed to the engine in one go, see _PaintBufferRow().
+    _clusterBuffer.clear();
+    _bufferRowRuns.clear();
+    _bufferRowGridLines.clear();
+
     // If we have valid data, let's figure out how to draw it.
-    if (it)
+    if (cursor)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
         til::CoordType cols = 0;
 
         // Retrieve the first color.
-        auto color = it->TextAttr();
+        auto color = cursor.TextAttr();
         // Retrieve the first pattern id
         auto patternIds = _pData->GetPatternId(target);
         // Determine whether we're using a soft font.
-        auto usingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
+        auto usingSoftFont = s_IsSoftFontChar(cursor.Chars(), _firstSoftFontChar, _lastSoftFontChar);
 
         // And hold the point where we should start drawing.
         auto screenPoint = target;
 
         // This outer loop will continue until we reach the end of the text we are trying to draw.
-        while (it)
+        while (cursor)
         {
             // Hold onto the current run color right here for the length of the outer loop.
             // We'll be changing the persistent one as we run through the inner loops to detect
@@ -793,23 +1467,22 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             // when we go to draw gridlines for the length of the run.
             const auto currentRunColor = color;
 
-            // Hold onto the current pattern id as well
+            // Hold onto the current pattern id and font usage as well
             const auto currentPatternId = patternIds;
-
-            // Update the drawing brushes with our color and font usage.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
+            const auto currentRunUsingSoftFont = usingSoftFont;
 
             // Advance the point by however many columns we've just outputted and reset the accumulator.
             screenPoint.X += cols;
             cols = 0;
 
-            // Hold onto the start of this run iterator and the target location where we started
+            // Hold onto the start of this run and the target location where we started
             // in case we need to do some special work to paint the line drawing characters.
-            const auto currentRunItStart = it;
+            const auto currentRunItStart = cursor;
             const auto currentRunTargetStart = screenPoint;
 
-            // Ensure that our cluster vector is clear.
-            _clusterBuffer.clear();
+            // This run's clusters start after those of the previous runs.
+            const auto clustersBegin = _clusterBuffer.size();
+            const auto gridLinesBegin = _bufferRowGridLines.size();
 
             // Reset our flag to know when we're in the special circumstance
             // of attempting to draw only the right-half of a two-column character
@@ -826,14 +1499,15 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             {
                 til::point thisPoint{ screenPoint.X + cols, screenPoint.Y };
                 const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
-                const auto thisUsingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
+                const auto chars = cursor.Chars();
+                const auto thisUsingSoftFont = s_IsSoftFontChar(chars, _firstSoftFontChar, _lastSoftFontChar);
                 const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
-                if (color != it->TextAttr() || changedPatternOrFont)
+                if (color != cursor.TextAttr() || changedPatternOrFont)
                 {
-                    auto newAttr{ it->TextAttr() };
+                    const auto& newAttr = cursor.TextAttr();
                     // foreground doesn't matter for runs of spaces (!)
                     // if we trick it . . . we call Paint far fewer times for cmatrix
-                    if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
+                    if (!_IsAllSpaces(chars) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
                     {
                         color = newAttr;
                         patternIds = thisPointPatterns;
@@ -844,11 +1518,12 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
                 // Walk through the text data and turn it into rendering clusters.
                 // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
-                auto columnCount = it->Columns();
+                const auto cellColumns = cursor.Columns();
+                auto columnCount = cellColumns;
 
                 // If we're on the first cluster to be added and it's marked as "trailing"
                 // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr().IsTrailing())
+                if (_clusterBuffer.size() == clustersBegin && cursor.DbcsAttr().IsTrailing())
                 {
                     // Move left to the one so the whole character can be struck correctly.
                     --screenPoint.X;
@@ -864,14 +1539,11 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                 }
 
                 // Advance the cluster and column counts.
-                _clusterBuffer.emplace_back(it->Chars(), columnCount);
-                it += std::max(it->Columns(), 1); // prevent infinite loop for no visible columns
+                _clusterBuffer.emplace_back(chars, columnCount);
+                cursor += cellColumns;
                 cols += columnCount;
 
-            } while (it);
-
-            // Do the painting.
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
+            } while (cursor);
 
             // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
             // We're only allowed to draw the grid lines under certain circumstances.
@@ -896,16 +1568,56 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     // Do that in the future if some WPR trace points you to this spot as super bad.
                     for (til::CoordType colsPainted = 0; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.X)
                     {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
+                        const auto& lines = lineIt.TextAttr();
+                        _PaintBufferOutputGridLineHelper(lines, 1, lineTarget);
                     }
                 }
                 else
                 {
                     // If nothing exciting is going on, draw the lines in bulk.
-                    _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
+                    _PaintBufferOutputGridLineHelper(currentRunColor, cols, screenPoint);
                 }
             }
+
+            _bufferRowRuns.push_back({ currentRunColor, currentRunUsingSoftFont, trimLeft, screenPoint, clustersBegin, _clusterBuffer.size(), gridLinesBegin, _bufferRowGridLines.size() });
+        }
+    }
+}
+
+// Routine Description:
+// - Paints a captured line, either all at once, or one run
+//   at a time if the engine doesn't implement PaintBufferRow().
+// Arguments:
+// - pEngine - the engine to paint with
+// - row - the line to paint
+// Return Value:
+// - <none>
+void Renderer::_PaintBufferRow(_In_ IRenderEngine* const pEngine, const IRenderEngine::BufferRow& row)
+{
+    if (row.runs.empty())
+    {
+        return;
+    }
+
+    const auto hr = pEngine->PaintBufferRow(row);
+    THROW_IF_FAILED(hr);
+    if (hr != S_FALSE)
+    {
+        return;
+    }
+
+    for (const auto& run : row.runs)
+    {
+        // Update the drawing brushes with our color and font usage.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, row.renderSettings, run.textAttributes, run.usingSoftFont, false));
+
+        // Do the painting.
+        THROW_IF_FAILED(pEngine->PaintBufferLine(row.clusters.subspan(run.clustersBegin, run.clustersEnd - run.clustersBegin), run.coord, run.trimLeft, row.lineWrapped));
+
+        for (auto i = run.gridLinesBegin; i < run.gridLinesEnd; ++i)
+        {
+            const auto& gridLines = til::at(row.gridLines, i);
+            LOG_IF_FAILED(pEngine->PaintBufferGridLines(gridLines.lines, gridLines.color, gridLines.cchLine, gridLines.coordTarget));
         }
     }
 }
@@ -967,6 +1679,7 @@ IRenderEngine::GridLineSet Renderer::s_GetGridlines(const TextAttribute& textAtt
 // Routine Description:
 // - Paint helper for primary buffer output function.
 // - This particular helper sets up the various box drawing lines that can be inscribed around any character in the buffer (left, right, top, underline).
+//   They're painted along with the rest of the line by _PaintBufferRow.
 // - See also: All related helpers and buffer output functions.
 // Arguments:
 // - textAttribute - The line/box drawing attributes to use for this particular run.
@@ -974,8 +1687,7 @@ IRenderEngine::GridLineSet Renderer::s_GetGridlines(const TextAttribute& textAtt
 // - coordTarget - The X/Y coordinate position in the buffer which we're attempting to start rendering from.
 // Return Value:
 // - <none>
-void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine,
-                                                const TextAttribute textAttribute,
+void Renderer::_PaintBufferOutputGridLineHelper(const TextAttribute textAttribute,
                                                 const size_t cchLine,
                                                 const til::point coordTarget)
 {
@@ -1003,8 +1715,8 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     {
         // Get the current foreground color to render the lines.
         const auto rgb = _renderSettings.GetAttributeColors(textAttribute).first;
-        // Draw the lines
-        LOG_IF_FAILED(pEngine->PaintBufferGridLines(lines, rgb, cchLine, coordTarget));
+        // Queue up the lines
+        _bufferRowGridLines.push_back({ lines, rgb, cchLine, coordTarget });
     }
 }
 
@@ -1080,7 +1792,7 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
 // - <none>
 void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 {
-    const auto cursorInfo = _GetCursorInfo();
+    const auto& cursorInfo = _GetCapturedFrame(pEngine).cursorInfo;
     if (cursorInfo.has_value())
     {
         LOG_IF_FAILED(pEngine->PaintCursor(cursorInfo.value()));
@@ -1101,7 +1813,7 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 [[nodiscard]] HRESULT Renderer::_PrepareRenderInfo(_In_ IRenderEngine* const pEngine)
 {
     RenderFrameInfo info;
-    info.cursorInfo = _GetCursorInfo();
+    info.cursorInfo = _GetCapturedFrame(pEngine).cursorInfo;
     return pEngine->PrepareRenderInfo(info);
 }
 
@@ -1137,9 +1849,11 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
                     const til::point target{ viewDirty.Left, iRow };
                     const auto source = target - overlay.origin;
 
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
+                    const TextBufferRowCursor cursor{ overlay.buffer.GetRowByOffset(source.Y), source.X, overlay.buffer.GetSize().Width() };
 
-                    _PaintBufferOutputHelper(&engine, it, target, false);
+                    // Overlays are only ever painted under the console lock, straight from the text buffer.
+                    _PaintBufferOutputHelper(cursor, target);
+                    _PaintBufferRow(&engine, { _clusterBuffer, _bufferRowRuns, _bufferRowGridLines, _renderSettings, _pData, false });
                 }
             }
         }
@@ -1155,12 +1869,10 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
 // - <none>
 // Return Value:
 // - <none>
-void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
+void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine, const std::vector<RenderOverlay>& overlays)
 {
     try
     {
-        const auto overlays = _pData->GetOverlays();
-
         for (const auto& overlay : overlays)
         {
             _PaintOverlay(*pEngine, overlay);
@@ -1169,6 +1881,48 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
     CATCH_LOG();
 }
 
+// Routine Description:
+// - Paint helper to draw the highlighted areas of the window, like all matches of a search.
+// - Unlike the selection, the highlights are handed to the engine all at once.
+//   There may be thousands of them, even if only the visible ones are captured.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_PaintHighlights(_In_ IRenderEngine* const pEngine)
+{
+    try
+    {
+        const auto& highlights = _GetCapturedFrame(pEngine).highlights;
+        if (highlights.empty())
+        {
+            return;
+        }
+
+        gsl::span<const til::rect> dirtyAreas;
+        LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
+
+        std::pmr::vector<til::rect> rects{ til::pmr::get_default_resource() };
+        rects.reserve(highlights.size());
+        for (const auto& rect : highlights)
+        {
+            for (const auto& dirtyRect : dirtyAreas)
+            {
+                if (const auto rectCopy = rect & dirtyRect)
+                {
+                    rects.emplace_back(rectCopy);
+                }
+            }
+        }
+
+        if (!rects.empty())
+        {
+            LOG_IF_FAILED(pEngine->PaintHighlights({ rects.data(), rects.size() }));
+        }
+    }
+    CATCH_LOG();
+}
+
 // Routine Description:
 // - Paint helper to draw the selected area of the window.
 // Arguments:
@@ -1182,9 +1936,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
         gsl::span<const til::rect> dirtyAreas;
         LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
-        // Get selection rectangles
-        const auto rectangles = _GetSelectionRects();
-        for (const auto& rect : rectangles)
+        for (const auto& rect : _GetCapturedFrame(pEngine).selection)
         {
             for (auto& dirtyRect : dirtyAreas)
             {
@@ -1202,6 +1954,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 // - Helper to convert the text attributes to actual RGB colors and update the rendering pen/brush within the rendering engine before the next draw operation.
 // Arguments:
 // - pEngine - Which engine is being updated
+// - renderSettings - The settings to get the colors from
 // - textAttributes - The 16 color foreground/background combination to set
 // - usingSoftFont - Whether we're rendering characters from a soft font
 // - isSettingDefaultBrushes - Alerts that the default brushes are being set which will
@@ -1211,13 +1964,14 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 // Return Value:
 // - <none>
 [[nodiscard]] HRESULT Renderer::_UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine,
+                                                      const RenderSettings& renderSettings,
                                                       const TextAttribute textAttributes,
                                                       const bool usingSoftFont,
                                                       const bool isSettingDefaultBrushes)
 {
     // The last color needs to be each engine's responsibility. If it's local to this function,
     //      then on the next engine we might not update the color.
-    return pEngine->UpdateDrawingBrushes(textAttributes, _renderSettings, _pData, usingSoftFont, isSettingDefaultBrushes);
+    return pEngine->UpdateDrawingBrushes(textAttributes, renderSettings, _pData, usingSoftFont, isSettingDefaultBrushes);
 }
 
 // Routine Description:
@@ -1234,17 +1988,55 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 }
 
 // Routine Description:
-// - Helper to determine the selected region of the buffer.
+// - Helper to determine the selected region of the buffer within the viewport.
 // Return Value:
 // - A vector of rectangles representing the regions to select, line by line.
 std::vector<til::rect> Renderer::_GetSelectionRects() const
+{
+    std::pmr::vector<til::rect> result{ til::pmr::get_default_resource() };
+    _GetSelectionRects(result);
+    return { result.begin(), result.end() };
+}
+
+// Routine Description:
+// - Same as above, but writes the rectangles into an existing vector, which the
+//   frame capture uses to reuse its memory.
+// Arguments:
+// - result - receives the rectangles
+// Return Value:
+// - <none>
+void Renderer::_GetSelectionRects(std::pmr::vector<til::rect>& result) const
+{
+    // Only the visible part of the selection is ever painted,
+    // so don't bother with the rest, even if everything is selected.
+    _ConvertToViewportRects(_pData->GetVisibleSelectionRects(), result);
+}
+
+// Routine Description:
+// - Helper to determine the highlighted regions of the buffer within the viewport.
+// Arguments:
+// - result - receives the rectangles, line by line
+// Return Value:
+// - <none>
+void Renderer::_GetHighlightRects(std::pmr::vector<til::rect>& result) const
+{
+    _ConvertToViewportRects(_pData->GetVisibleHighlightRects(), result);
+}
+
+// Routine Description:
+// - Converts rectangles in buffer coordinates into the screen cells of the viewport.
+// Arguments:
+// - rects - the rectangles, one per row
+// - result - receives the rectangles, relative to the viewport
+// Return Value:
+// - <none>
+void Renderer::_ConvertToViewportRects(const std::vector<Viewport>& rects, std::pmr::vector<til::rect>& result) const
 {
     const auto& buffer = _pData->GetTextBuffer();
-    auto rects = _pData->GetSelectionRects();
     // Adjust rectangles to viewport
     auto view = _pData->GetViewport();
 
-    std::vector<til::rect> result;
+    result.clear();
     result.reserve(rects.size());
 
     for (auto rect : rects)
@@ -1255,8 +2047,6 @@ std::vector<til::rect> Renderer::_GetSelectionRects() const
         rect = Viewport::FromInclusive(BufferToScreenLine(rect.ToInclusive(), lineRendition));
         result.emplace_back(view.ConvertToOrigin(rect).ToExclusive());
     }
-
-    return result;
 }
 
 // Method Description:
@@ -1264,20 +2054,29 @@ std::vector<til::rect> Renderer::_GetSelectionRects() const
 //   as the previously selected area. If the whole viewport scrolls,
 //   we need to scroll these areas also to ensure they're invalidated
 //   properly when the selection further changes.
+// - Since we only hold onto the visible part of the selection, the rows that
+//   scrolled into view (and will be painted as selected) are added as well.
 // Arguments:
 // - delta - The scroll delta
 // Return Value:
 // - <none> - Updates internal state instead.
 void Renderer::_ScrollPreviousSelection(const til::point delta)
+try
 {
     if (delta != til::point{ 0, 0 })
     {
-        for (auto& rc : _previousSelection)
-        {
+        const til::rect viewport{ _pData->GetViewport().Dimensions() };
+        std::erase_if(_previousSelection, [&](auto& rc) {
             rc += delta;
-        }
+            rc &= viewport;
+            return rc.empty();
+        });
+
+        const auto rects = _GetSelectionRects();
+        _previousSelection.insert(_previousSelection.end(), rects.begin(), rects.end());
     }
 }
+CATCH_LOG()
 
 // Method Description:
 // - Adds another Render engine to this renderer. Future rendering calls will
@@ -1297,6 +2096,19 @@ void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
         if (!p)
         {
             p = pEngine;
+
+            // A second engine paints its frames concurrently with the first one, see PaintFrame.
+            if (&p != &_engines[0] && !_paintWork)
+            {
+                _paintWork.reset(CreateThreadpoolWork(&s_PaintWorkCallback, this, nullptr));
+                LOG_LAST_ERROR_IF(!_paintWork);
+            }
+
+            // Engines that are added later on still need to know about the active soft font.
+            if (!_softFontBitPattern.empty())
+            {
+                LOG_IF_FAILED(pEngine->UpdateSoftFont(_softFontBitPattern, _softFontCellSize, _softFontCenteringHint));
+            }
             return;
         }
     }
@@ -1304,6 +2116,20 @@ void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
     THROW_HR_MSG(E_UNEXPECTED, "engines array is full");
 }
 
+// Routine Description:
+// - Removes a render engine from our collection, so that the caller may destroy it
+//   before the renderer. Painting must be disabled while this is called.
+// Arguments:
+// - pEngine: The render engine to be removed
+// Return Value:
+// - <none>
+void Renderer::RemoveRenderEngine(_In_ IRenderEngine* const pEngine) noexcept
+{
+    // FOREACH_ENGINE stops at the first empty slot, so the remaining engines must be shifted down.
+    const auto end = std::remove(_engines.begin(), _engines.end(), pEngine);
+    std::fill(end, _engines.end(), nullptr);
+}
+
 // Method Description:
 // - Registers a callback for when the background color is changed
 // Arguments:
@@ -1338,6 +2164,67 @@ void Renderer::SetRendererEnteredErrorStateCallback(std::function<void()> pfn)
     _pfnRendererEnteredErrorState = std::move(pfn);
 }
 
+// Method Description:
+// - Limits how often the render thread paints frames, see RenderThread::SetFramePacing.
+// Arguments:
+// - maxFrameRate: the maximum number of frames per second, or 0 for no limit
+// - reduceFrameRateOnBattery: whether to paint fewer frames while on battery
+// Return Value:
+// - <none>
+void Renderer::SetFramePacing(const uint32_t maxFrameRate, const bool reduceFrameRateOnBattery) noexcept
+{
+    // If we're running in the unittests, we might not have a render thread.
+    if (_pThread)
+    {
+        _pThread->SetFramePacing(maxFrameRate, reduceFrameRateOnBattery);
+    }
+}
+
+// Method Description:
+// - Holds off painting while an application draws a frame, see RenderThread::SetSynchronizedOutput.
+// Arguments:
+// - enabled: whether the application started (true) or finished (false) drawing a frame
+// Return Value:
+// - <none>
+void Renderer::SetSynchronizedOutput(const bool enabled) noexcept
+{
+    // If we're running in the unittests, we might not have a render thread.
+    if (_pThread)
+    {
+        _pThread->SetSynchronizedOutput(enabled);
+    }
+}
+
+// Method Description:
+// - Paints fewer frames while the output is flooding, see RenderThread::SetFlooding.
+// Arguments:
+// - flooding: whether the output is flooding
+// Return Value:
+// - <none>
+void Renderer::SetFlooding(const bool flooding) noexcept
+{
+    // If we're running in the unittests, we might not have a render thread.
+    if (_pThread)
+    {
+        _pThread->SetFlooding(flooding);
+    }
+}
+
+// Method Description:
+// - Lowers the priority of the render thread, see RenderThread::SetBackgroundMode.
+// Arguments:
+// - background: whether the terminal is in the background
+// Return Value:
+// - <none>
+void Renderer::SetBackgroundMode(const bool background) noexcept
+{
+    // If we're running in the unittests, we might not have a render thread.
+    if (_pThread)
+    {
+        _pThread->SetBackgroundMode(background);
+    }
+}
+
 // Method Description:
 // - Attempts to restart the renderer.
 void Renderer::ResetErrorStateAndResume()
@@ -1351,6 +2238,22 @@ void Renderer::UpdateLastHoveredInterval(const std::optional<PointTree::interval
     _hoveredInterval = newInterval;
 }
 
+// Method Description:
+// - Sets the fraction of a row by which the viewport is scrolled past its top row,
+//   for smooth scrolling. Engines that support it shift the rows they already
+//   painted by that amount, which doesn't require reading from the buffer.
+//   Call this while holding the console lock, like any of the Trigger*() methods.
+// Arguments:
+// - rows - the offset in rows, in the range (-1, 1). Positive values shift the contents up.
+void Renderer::SetSubRowScrollOffset(const float rows)
+{
+    if (_subRowScrollOffset != rows)
+    {
+        _subRowScrollOffset = rows;
+        NotifyPaintFrame();
+    }
+}
+
 // Method Description:
 // - Blocks until the engines are able to render without blocking.
 void Renderer::WaitUntilCanRender()
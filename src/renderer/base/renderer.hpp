@@ -23,6 +23,7 @@ Author(s):
 
 #include "../../buffer/out/textBuffer.hpp"
 #include "../../buffer/out/CharRow.hpp"
+#include "../../buffer/out/textBufferRowCursor.hpp"
 
 // fwdecl unittest classes
 #ifdef UNIT_TESTING
@@ -34,6 +35,41 @@ namespace TerminalCoreUnitTests
 
 namespace Microsoft::Console::Render
 {
+    // How long the parts of painting a frame took, see Renderer::GetFrameTimings.
+    struct FrameTimings
+    {
+        enum Phase : size_t
+        {
+            LockWait,
+            BufferOutput,
+            Selection,
+            Cursor,
+            Present,
+            Total,
+            PhaseCount
+        };
+
+        // Bucket i counts the frames that took [2^(i-1), 2^i) microseconds, the last one anything longer.
+        static constexpr size_t HistogramBuckets = 16;
+        using Histogram = std::array<uint32_t, HistogramBuckets>;
+
+        // The durations of the last frame, in microseconds.
+        std::array<uint32_t, PhaseCount> last{};
+        std::array<Histogram, PhaseCount> histograms{};
+        uint32_t frameCount = 0;
+        // How often the renderer's scratch buffers allocated memory during these
+        // frames and how much they hold. Once they're large enough, this stays 0.
+        uint32_t scratchAllocations = 0;
+        size_t scratchBytes = 0;
+
+        void Record(const std::array<uint32_t, PhaseCount>& frame) noexcept;
+        uint32_t Percentile(const Phase phase, const uint32_t percent) const noexcept;
+
+        // The same for any other durations someone wants to keep a histogram of.
+        static void Record(Histogram& histogram, const uint32_t duration) noexcept;
+        static uint32_t Percentile(const Histogram& histogram, const uint32_t count, const uint32_t percent) noexcept;
+    };
+
     class Renderer
     {
     public:
@@ -52,12 +88,15 @@ namespace Microsoft::Console::Render
         void TriggerRedraw(const Microsoft::Console::Types::Viewport& region);
         void TriggerRedraw(const til::point* const pcoord);
         void TriggerRedrawCursor(const til::point* const pcoord);
+        void TriggerRedrawBlinking();
         void TriggerRedrawAll(const bool backgroundChanged = false, const bool frameChanged = false);
+        void TriggerColorTableChange(const bool backgroundChanged = false, const bool frameChanged = false);
         void TriggerTeardown() noexcept;
 
         void TriggerSelection();
         void TriggerScroll();
         void TriggerScroll(const til::point* const pcoordDelta);
+        void TriggerScrollRegion(const Microsoft::Console::Types::Viewport& region, const til::CoordType delta);
 
         void TriggerFlush(const bool circling);
         void TriggerTitleChange();
@@ -83,31 +122,119 @@ namespace Microsoft::Console::Render
         void WaitUntilCanRender();
 
         void AddRenderEngine(_In_ IRenderEngine* const pEngine);
+        void RemoveRenderEngine(_In_ IRenderEngine* const pEngine) noexcept;
 
         void SetBackgroundColorChangedCallback(std::function<void()> pfn);
         void SetFrameColorChangedCallback(std::function<void()> pfn);
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
+        void SetFramePacing(const uint32_t maxFrameRate, const bool reduceFrameRateOnBattery) noexcept;
+        void SetSynchronizedOutput(const bool enabled) noexcept;
+        void SetFlooding(const bool flooding) noexcept;
+        void SetBackgroundMode(const bool background) noexcept;
+
+        FrameTimings GetFrameTimings(const bool reset);
+        void SetFrameTimingsCallback(std::function<void(const FrameTimings&)> pfn);
         void ResetErrorStateAndResume();
 
         void UpdateLastHoveredInterval(const std::optional<interval_tree::IntervalTree<til::point, size_t>::interval>& newInterval);
+        void SetSubRowScrollOffset(const float rows);
 
     private:
+        // An invalidation of the engine that was painting without the console lock at the time.
+        // They're applied in order once it's done, see _ApplyDeferredInvalidations().
+        struct DeferredInvalidation
+        {
+            enum class Kind
+            {
+                Region,
+                Cursor,
+                System,
+                Selection,
+                Scroll,
+                Viewport,
+                ColorTable,
+                All
+            };
+
+            Kind kind;
+            til::rect rect{};
+            til::point delta{};
+            til::inclusive_rect viewport{};
+        };
+
+        // A line of text captured by _CaptureFrame(). Its clusters, runs and grid lines
+        // follow those of the previous line in CapturedFrame and end at the given indices.
+        struct CapturedRow
+        {
+            LineRendition lineRendition;
+            til::CoordType targetRow;
+            til::CoordType viewportLeft;
+            bool lineWrapped;
+            size_t clustersEnd;
+            size_t runsEnd;
+            size_t gridLinesEnd;
+        };
+
+        // Everything needed to paint a frame after the console lock was released.
+        // The containers are reused from frame to frame, see _scratchResource.
+        struct CapturedFrame
+        {
+            explicit CapturedFrame(std::pmr::memory_resource* resource) :
+                text{ resource },
+                clusters{ resource },
+                runs{ resource },
+                gridLines{ resource },
+                rows{ resource },
+                selection{ resource },
+                title{ resource }
+            {
+            }
+
+            RenderSettings renderSettings;
+            std::pmr::wstring text;
+            std::pmr::vector<Cluster> clusters;
+            std::pmr::vector<IRenderEngine::BufferRowRun> runs;
+            std::pmr::vector<IRenderEngine::BufferRowGridLines> gridLines;
+            std::pmr::vector<CapturedRow> rows;
+            std::optional<CursorOptions> cursorInfo;
+            std::pmr::vector<til::rect> selection;
+            std::pmr::vector<til::rect> highlights;
+            std::pmr::wstring title;
+        };
+
         static IRenderEngine::GridLineSet s_GetGridlines(const TextAttribute& textAttribute) noexcept;
         static bool s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSoftFontChar, const size_t lastSoftFontChar);
 
+        static void CALLBACK s_PaintWorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work) noexcept;
+        [[nodiscard]] HRESULT _PaintFrameWithRetries(_In_ IRenderEngine* const pEngine) noexcept;
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
+        void _RecordFrameTimings(const std::array<uint32_t, FrameTimings::PhaseCount>& timings);
         bool _CheckViewportAndScroll();
+        bool _InvalidateRegion(const Microsoft::Console::Types::Viewport& region);
+        bool _InvalidateDirtyRows();
+        bool _DeferInvalidation(const IRenderEngine* const pEngine, const DeferredInvalidation& invalidation);
+        void _ApplyDeferredInvalidations() noexcept;
+        void _WaitForUnlockedPaint();
+        void _CaptureFrame(_In_ IRenderEngine* const pEngine);
+        void _CaptureBufferOutput(_In_ IRenderEngine* const pEngine);
+        CapturedFrame& _GetCapturedFrame(const IRenderEngine* const pEngine) noexcept;
+        void _CaptureBufferRow(CapturedFrame& frame, const LineRendition lineRendition, const til::CoordType targetRow, const til::CoordType viewportLeft, const bool lineWrapped);
         [[nodiscard]] HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
-        void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine, TextBufferCellIterator it, const til::point target, const bool lineWrapped);
-        void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine, const TextAttribute textAttribute, const size_t cchLine, const til::point coordTarget);
+        void _PaintBufferOutputHelper(TextBufferRowCursor cursor, const til::point target);
+        void _PaintBufferOutputGridLineHelper(const TextAttribute textAttribute, const size_t cchLine, const til::point coordTarget);
+        void _PaintBufferRow(_In_ IRenderEngine* const pEngine, const IRenderEngine::BufferRow& row);
+        void _PaintHighlights(_In_ IRenderEngine* const pEngine);
         void _PaintSelection(_In_ IRenderEngine* const pEngine);
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
-        void _PaintOverlays(_In_ IRenderEngine* const pEngine);
+        void _PaintOverlays(_In_ IRenderEngine* const pEngine, const std::vector<RenderOverlay>& overlays);
         void _PaintOverlay(IRenderEngine& engine, const RenderOverlay& overlay);
-        [[nodiscard]] HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute attr, const bool usingSoftFont, const bool isSettingDefaultBrushes);
+        [[nodiscard]] HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const RenderSettings& renderSettings, const TextAttribute attr, const bool usingSoftFont, const bool isSettingDefaultBrushes);
         [[nodiscard]] HRESULT _PerformScrolling(_In_ IRenderEngine* const pEngine);
         std::vector<til::rect> _GetSelectionRects() const;
+        void _GetSelectionRects(std::pmr::vector<til::rect>& result) const;
+        void _GetHighlightRects(std::pmr::vector<til::rect>& result) const;
+        void _ConvertToViewportRects(const std::vector<Microsoft::Console::Types::Viewport>& rects, std::pmr::vector<til::rect>& result) const;
         void _ScrollPreviousSelection(const til::point delta);
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
         [[nodiscard]] std::optional<CursorOptions> _GetCursorInfo();
@@ -119,15 +246,41 @@ namespace Microsoft::Console::Render
         std::unique_ptr<RenderThread> _pThread;
         static constexpr size_t _firstSoftFontChar = 0xEF20;
         size_t _lastSoftFontChar = 0;
+        std::vector<uint16_t> _softFontBitPattern;
+        til::size _softFontCellSize;
+        size_t _softFontCenteringHint = 0;
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
+        float _subRowScrollOffset = 0;
         Microsoft::Console::Types::Viewport _viewport;
-        std::vector<Cluster> _clusterBuffer;
+        // The buffers below are filled anew each frame, but keep their capacity.
+        // This counts how often they still need to allocate, see FrameTimings.
+        til::pmr::counting_resource _scratchResource;
+        size_t _scratchAllocationsRecorded = 0;
+        std::pmr::vector<Cluster> _clusterBuffer{ &_scratchResource };
+        std::pmr::vector<IRenderEngine::BufferRowRun> _bufferRowRuns{ &_scratchResource };
+        std::pmr::vector<IRenderEngine::BufferRowGridLines> _bufferRowGridLines{ &_scratchResource };
+        std::array<CapturedFrame, 2> _capturedFrames{ { CapturedFrame{ &_scratchResource }, CapturedFrame{ &_scratchResource } } };
+        // How many engines have picked up the dirty rows during this PaintFrame().
+        std::atomic<size_t> _enginesStarted{ 0 };
+        // The engine that is painting its captured frame without the console lock, if any. It's
+        // only changed under the console lock, while _unlockedPaintMutex is held for the painting.
+        IRenderEngine* _unlockedEngine = nullptr;
+        std::mutex _unlockedPaintMutex;
+        std::vector<DeferredInvalidation> _deferredInvalidations;
         std::vector<til::rect> _previousSelection;
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
+        std::function<void(const FrameTimings&)> _pfnFrameTimings;
+        // Written by the render thread, read by whoever calls GetFrameTimings.
+        FrameTimings _frameTimings;
+        std::mutex _frameTimingsMutex;
         bool _destructing = false;
         bool _forceUpdateViewport = true;
+        // Paints the frames of _engines[1], see PaintFrame. Declared last, because its
+        // destructor waits for the callback, which accesses all the other members.
+        HRESULT _paintWorkResult = S_OK;
+        wil::unique_threadpool_work _paintWork;
 
 #ifdef UNIT_TESTING
         friend class ConptyOutputTests;
@@ -5,6 +5,7 @@
 #include "thread.hpp"
 
 #include "renderer.hpp"
+#include "../../types/inc/utils.hpp"
 
 #pragma hdrstop
 
@@ -15,10 +16,20 @@ RenderThread::RenderThread() :
     _hThread(nullptr),
     _hEvent(nullptr),
     _hPaintCompletedEvent(nullptr),
+    _hSynchronizedOutputEvent(nullptr),
     _fKeepRunning(true),
     _hPaintEnabledEvent(nullptr),
     _fNextFrameRequested(false),
-    _fWaiting(false)
+    _fWaiting(false),
+    _fThreadStarted(false),
+    _maxFrameRate(0),
+    _reduceFrameRateOnBattery(false),
+    _flooding(false),
+    _backgroundMode(false),
+    _lastFrame(),
+    _lastPowerStatusCheck(0),
+    _onBattery(false),
+    _synchronizedOutputDeadline(0)
 {
 }
 
@@ -51,17 +62,23 @@ RenderThread::~RenderThread()
         CloseHandle(_hPaintCompletedEvent);
         _hPaintCompletedEvent = nullptr;
     }
+
+    if (_hSynchronizedOutputEvent)
+    {
+        CloseHandle(_hSynchronizedOutputEvent);
+        _hSynchronizedOutputEvent = nullptr;
+    }
 }
 
 // Method Description:
-// - Create all of the Events we'll need, and the actual thread we'll be doing
-//      work on.
+// - Create all of the Events we'll need. The actual thread we'll be doing
+//      work on is only started once painting is enabled, see EnablePainting.
 // Arguments:
 // - pRendererParent: the Renderer that owns this thread, and which we should
 //      trigger frames for.
 // Return Value:
 // - S_OK if we succeeded, else an HRESULT corresponding to a failure to create
-//      an Event or Thread.
+//      an Event.
 [[nodiscard]] HRESULT RenderThread::Initialize(Renderer* const pRendererParent) noexcept
 {
     _pRenderer = pRendererParent;
@@ -122,35 +139,53 @@ RenderThread::~RenderThread()
 
     if (SUCCEEDED(hr))
     {
-        auto hThread = CreateThread(nullptr, // non-inheritable security attributes
-                                    0, // use default stack size
-                                    s_ThreadProc,
-                                    this,
-                                    0, // create immediately
-                                    nullptr // we don't need the thread ID
-        );
+        auto hSynchronizedOutputEvent = CreateEventW(nullptr,
+                                                     TRUE, // manual reset event
+                                                     TRUE, // initially signaled
+                                                     nullptr);
 
-        if (hThread == nullptr)
+        if (hSynchronizedOutputEvent == nullptr)
         {
             hr = HRESULT_FROM_WIN32(GetLastError());
         }
         else
         {
-            _hThread = hThread;
-
-            // SetThreadDescription only works on 1607 and higher. If we cannot find it,
-            // then it's no big deal. Just skip setting the description.
-            auto func = GetProcAddressByFunctionDeclaration(GetModuleHandleW(L"kernel32.dll"), SetThreadDescription);
-            if (func)
-            {
-                LOG_IF_FAILED(func(hThread, L"Rendering Output Thread"));
-            }
+            _hSynchronizedOutputEvent = hSynchronizedOutputEvent;
         }
     }
 
     return hr;
 }
 
+// Method Description:
+// - Creates the actual thread we'll be doing work on.
+// Return Value:
+// - S_OK if we succeeded, else an HRESULT corresponding to a failure to create
+//      the Thread.
+[[nodiscard]] HRESULT RenderThread::_StartThread() noexcept
+{
+    auto hThread = CreateThread(nullptr, // non-inheritable security attributes
+                                0, // use default stack size
+                                s_ThreadProc,
+                                this,
+                                0, // create immediately
+                                nullptr // we don't need the thread ID
+    );
+    RETURN_LAST_ERROR_IF_NULL(hThread);
+
+    _hThread = hThread;
+
+    // SetThreadDescription only works on 1607 and higher. If we cannot find it,
+    // then it's no big deal. Just skip setting the description.
+    auto func = GetProcAddressByFunctionDeclaration(GetModuleHandleW(L"kernel32.dll"), SetThreadDescription);
+    if (func)
+    {
+        LOG_IF_FAILED(func(hThread, L"Rendering Output Thread"));
+    }
+
+    return S_OK;
+}
+
 DWORD WINAPI RenderThread::s_ThreadProc(_In_ LPVOID lpParameter)
 {
     const auto pContext = static_cast<RenderThread*>(lpParameter);
@@ -167,10 +202,20 @@ DWORD WINAPI RenderThread::s_ThreadProc(_In_ LPVOID lpParameter)
 
 DWORD WINAPI RenderThread::_ThreadProc()
 {
+    auto backgroundMode = false;
+
     while (_fKeepRunning)
     {
         WaitForSingleObject(_hPaintEnabledEvent, INFINITE);
 
+        // We apply the background mode ourselves, because the thread handle
+        // only exists once painting was enabled for the first time.
+        if (const auto background = _backgroundMode.load(std::memory_order_relaxed); background != backgroundMode)
+        {
+            backgroundMode = background;
+            Microsoft::Console::Utils::SetThreadBackgroundMode(GetCurrentThread(), background);
+        }
+
         if (!_fNextFrameRequested.exchange(false, std::memory_order_acq_rel))
         {
             // <--
@@ -208,6 +253,8 @@ DWORD WINAPI RenderThread::_ThreadProc()
             ResetEvent(_hEvent);
         }
 
+        _WaitForNextFrame();
+
         ResetEvent(_hPaintCompletedEvent);
 
         _pRenderer->WaitUntilCanRender();
@@ -231,8 +278,154 @@ void RenderThread::NotifyPaint() noexcept
     }
 }
 
+// Method Description:
+// - Limits how often frames are painted. Invalidations that arrive in the
+//   meantime aren't lost, they accumulate and get painted in a single frame.
+// - The engines that present through a swap chain additionally wait for
+//   the display in WaitUntilCanRender, so this only matters below the refresh rate.
+// Arguments:
+// - maxFrameRate - the maximum number of frames per second, or 0 for no limit
+// - reduceFrameRateOnBattery - if true, paint at most _batteryFrameRate frames
+//   per second while the system is running on battery or in battery saver mode
+// Return Value:
+// - <none>
+void RenderThread::SetFramePacing(const uint32_t maxFrameRate, const bool reduceFrameRateOnBattery) noexcept
+{
+    _maxFrameRate.store(maxFrameRate, std::memory_order_relaxed);
+    _reduceFrameRateOnBattery.store(reduceFrameRateOnBattery, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Holds off painting while an application is in the middle of drawing a
+//   frame (synchronized output, DECSET 2026), so that we don't paint the
+//   intermediate states in between. If the application doesn't finish the
+//   frame within _synchronizedOutputTimeout, we paint anyway.
+// Arguments:
+// - enabled - true when the application starts drawing a frame, false when it's done
+// Return Value:
+// - <none>
+void RenderThread::SetSynchronizedOutput(const bool enabled) noexcept
+{
+    if (enabled)
+    {
+        _synchronizedOutputDeadline.store(GetTickCount64() + _synchronizedOutputTimeout, std::memory_order_relaxed);
+        ResetEvent(_hSynchronizedOutputEvent);
+    }
+    else
+    {
+        _synchronizedOutputDeadline.store(0, std::memory_order_relaxed);
+        SetEvent(_hSynchronizedOutputEvent);
+    }
+}
+
+// Method Description:
+// - Drops the frame rate to _floodFrameRate while there's more output than
+//   anyone could read. Each frame still shows the latest state of the buffer,
+//   we just spend less time painting states that were never going to be seen.
+// Arguments:
+// - flooding - whether the output is flooding
+// Return Value:
+// - <none>
+void RenderThread::SetFlooding(const bool flooding) noexcept
+{
+    _flooding.store(flooding, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Lowers the priority of the render thread while nobody can see the
+//   terminal, see Utils::SetThreadBackgroundMode. The change is picked
+//   up before the next frame is painted.
+// Arguments:
+// - background - whether the terminal is in the background
+// Return Value:
+// - <none>
+void RenderThread::SetBackgroundMode(const bool background) noexcept
+{
+    _backgroundMode.store(background, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Sleeps until enough time has passed since the last frame to stay
+//   within the frame rate limit, see SetFramePacing, and until
+//   the application finished its frame, see SetSynchronizedOutput.
+void RenderThread::_WaitForNextFrame() noexcept
+{
+    const auto deadline = _synchronizedOutputDeadline.load(std::memory_order_relaxed);
+    if (deadline != 0)
+    {
+        const auto now = GetTickCount64();
+        if (now < deadline)
+        {
+            WaitForSingleObject(_hSynchronizedOutputEvent, gsl::narrow_cast<DWORD>(deadline - now));
+        }
+    }
+
+    const auto frameRate = _GetFrameRateLimit();
+    if (frameRate != 0)
+    {
+        const auto interval = std::chrono::microseconds{ 1000000 / frameRate };
+        const auto remaining = _lastFrame + interval - std::chrono::steady_clock::now();
+        if (remaining > std::chrono::steady_clock::duration::zero())
+        {
+            Sleep(gsl::narrow_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count()));
+        }
+    }
+
+    _lastFrame = std::chrono::steady_clock::now();
+}
+
+// Method Description:
+// - Returns the current frame rate limit. While on battery this includes
+//   the battery saver policy. The power status is cached for _powerStatusInterval.
+//   While the output is flooding, this is at most _floodFrameRate.
+// Return Value:
+// - the maximum number of frames per second, or 0 for no limit
+uint32_t RenderThread::_GetFrameRateLimit() noexcept
+{
+    auto frameRate = _maxFrameRate.load(std::memory_order_relaxed);
+
+    if (_flooding.load(std::memory_order_relaxed) && (frameRate == 0 || frameRate > _floodFrameRate))
+    {
+        return _floodFrameRate;
+    }
+
+    if (_reduceFrameRateOnBattery.load(std::memory_order_relaxed))
+    {
+        const auto now = GetTickCount64();
+        if (now - _lastPowerStatusCheck >= _powerStatusInterval)
+        {
+            _lastPowerStatusCheck = now;
+
+            SYSTEM_POWER_STATUS status{};
+            // ACLineStatus is 0 when offline and SystemStatusFlag is 1 when battery saver is on.
+            _onBattery = GetSystemPowerStatus(&status) && (status.ACLineStatus == 0 || status.SystemStatusFlag == 1);
+        }
+
+        if (_onBattery && (frameRate == 0 || frameRate > _batteryFrameRate))
+        {
+            frameRate = _batteryFrameRate;
+        }
+    }
+
+    return frameRate;
+}
+
 void RenderThread::EnablePainting() noexcept
 {
+    // Until painting is enabled the thread would do nothing but wait for
+    // _hPaintEnabledEvent. Starting it this late saves a thread for each
+    // renderer that never gets to paint, like those of terminal tabs that
+    // were created in the background and haven't been shown yet.
+    if (!_fThreadStarted.exchange(true, std::memory_order_relaxed))
+    {
+        const auto hr = _StartThread();
+        if (FAILED(hr))
+        {
+            LOG_HR(hr);
+            _fThreadStarted.store(false, std::memory_order_relaxed);
+        }
+    }
+
     SetEvent(_hPaintEnabledEvent);
 }
 
@@ -30,21 +30,51 @@ namespace Microsoft::Console::Render
         void EnablePainting() noexcept;
         void DisablePainting() noexcept;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noexcept;
+        void SetFramePacing(const uint32_t maxFrameRate, const bool reduceFrameRateOnBattery) noexcept;
+        void SetSynchronizedOutput(const bool enabled) noexcept;
+        void SetFlooding(const bool flooding) noexcept;
+        void SetBackgroundMode(const bool background) noexcept;
 
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
+        [[nodiscard]] HRESULT _StartThread() noexcept;
+        void _WaitForNextFrame() noexcept;
+        uint32_t _GetFrameRateLimit() noexcept;
+
+        // The frame rate we drop to while running on battery, if enabled.
+        static constexpr uint32_t _batteryFrameRate = 30;
+        // The frame rate we drop to while the output is flooding, see SetFlooding.
+        static constexpr uint32_t _floodFrameRate = 10;
+        // How often the power status is checked, in milliseconds.
+        static constexpr ULONGLONG _powerStatusInterval = 1000;
+        // How long we hold off painting for an application that enabled synchronized output, in milliseconds.
+        static constexpr ULONGLONG _synchronizedOutputTimeout = 100;
 
         HANDLE _hThread;
         HANDLE _hEvent;
 
         HANDLE _hPaintEnabledEvent;
         HANDLE _hPaintCompletedEvent;
+        HANDLE _hSynchronizedOutputEvent;
 
         Renderer* _pRenderer; // Non-ownership pointer
 
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+        std::atomic<bool> _fThreadStarted;
+
+        // Frame pacing, see SetFramePacing. A rate of 0 means unlimited.
+        std::atomic<uint32_t> _maxFrameRate;
+        std::atomic<bool> _reduceFrameRateOnBattery;
+        std::atomic<bool> _flooding;
+        std::atomic<bool> _backgroundMode;
+        std::chrono::steady_clock::time_point _lastFrame;
+        ULONGLONG _lastPowerStatusCheck;
+        bool _onBattery;
+
+        // The tick count until which painting is held off, see SetSynchronizedOutput. 0 if it isn't.
+        std::atomic<ULONGLONG> _synchronizedOutputDeadline;
     };
 }
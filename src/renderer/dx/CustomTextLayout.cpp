@@ -162,21 +162,65 @@ try
     _formatInUse = _fontRenderData->TextFormatWithAttribute(weight, style, stretch).Get();
     _fontInUse = _fontRenderData->FontFaceWithAttribute(weight, style, stretch).Get();
 
-    RETURN_IF_FAILED(_AnalyzeTextComplexity());
-    RETURN_IF_FAILED(_AnalyzeRuns());
-    RETURN_IF_FAILED(_ShapeGlyphRuns());
-    RETURN_IF_FAILED(_CorrectGlyphRuns());
-    // Correcting box drawing has to come after both font fallback and
-    // the glyph run advance correction (which will apply a font size scaling factor).
-    // We need to know all the proposed X and Y dimension metrics to get this right.
-    RETURN_IF_FAILED(_CorrectBoxDrawing());
+    const auto key = uint64_t{ til::bit_cast<uint32_t>(originX) } << 32 | til::bit_cast<uint32_t>(originY);
+    if (_shapedTextCache.size() >= _shapedTextCacheLimit && _shapedTextCache.find(key) == _shapedTextCache.end())
+    {
+        _shapedTextCache.clear();
+    }
 
-    RETURN_IF_FAILED(_DrawGlyphRuns(clientDrawingContext, renderer, { originX, originY }));
+    auto& shaped = _shapedTextCache[key];
+    const auto cached = shaped.format == _formatInUse && shaped.font == _fontInUse && shaped.text == _text && shaped.textClusterColumns == _textClusterColumns;
+
+    if (cached)
+    {
+        _SwapShapedText(shaped);
+    }
+    else
+    {
+        RETURN_IF_FAILED(_AnalyzeTextComplexity());
+        RETURN_IF_FAILED(_AnalyzeRuns());
+        RETURN_IF_FAILED(_ShapeGlyphRuns());
+        RETURN_IF_FAILED(_CorrectGlyphRuns());
+        // Correcting box drawing has to come after both font fallback and
+        // the glyph run advance correction (which will apply a font size scaling factor).
+        // We need to know all the proposed X and Y dimension metrics to get this right.
+        RETURN_IF_FAILED(_CorrectBoxDrawing());
+
+        shaped.text = _text;
+        shaped.textClusterColumns = _textClusterColumns;
+        shaped.format = _formatInUse;
+        shaped.font = _fontInUse;
+    }
+
+    // Either way the results go (back) into the cache. The layout
+    // is Reset() before it's used again, so we don't need them.
+    const auto hr = _DrawGlyphRuns(clientDrawingContext, renderer, { originX, originY });
+    _SwapShapedText(shaped);
+    RETURN_IF_FAILED(hr);
 
     return S_OK;
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Exchanges the analysis and shaping results of this layout with the given ones.
+// Arguments:
+// - shaped - The shaping results to swap with
+// Return Value:
+// - <none>
+void CustomTextLayout::_SwapShapedText(ShapedText& shaped) noexcept
+{
+    std::swap(_runs, shaped.runs);
+    std::swap(_breakpoints, shaped.breakpoints);
+    std::swap(_isEntireTextSimple, shaped.isEntireTextSimple);
+    std::swap(_glyphOffsets, shaped.glyphOffsets);
+    std::swap(_glyphClusters, shaped.glyphClusters);
+    std::swap(_glyphIndices, shaped.glyphIndices);
+    std::swap(_glyphDesignUnitAdvances, shaped.glyphDesignUnitAdvances);
+    std::swap(_glyphAdvances, shaped.glyphAdvances);
+    std::swap(_glyphScaleCorrections, shaped.glyphScaleCorrections);
+}
+
 // Routine Description:
 // - Uses the internal text information and the analyzers/font information from construction
 //   to determine the complexity of the text. If the text is determined to be entirely simple,
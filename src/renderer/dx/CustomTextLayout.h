@@ -206,6 +206,34 @@ namespace Microsoft::Console::Render
         // These are used to further break the runs apart and adjust the font size so glyphs fit inside the cells.
         std::vector<ScaleCorrection> _glyphScaleCorrections;
 
+        // The result of analyzing and shaping a line of text, along with what it was computed from.
+        struct ShapedText
+        {
+            std::wstring text;
+            std::vector<UINT16> textClusterColumns;
+            IDWriteTextFormat* format = nullptr;
+            IDWriteFontFace1* font = nullptr;
+
+            std::vector<LinkedRun> runs;
+            std::vector<DWRITE_LINE_BREAKPOINT> breakpoints;
+            bool isEntireTextSimple = false;
+            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            std::vector<UINT16> glyphClusters;
+            std::vector<UINT16> glyphIndices;
+            std::vector<INT32> glyphDesignUnitAdvances;
+            std::vector<float> glyphAdvances;
+            std::vector<ScaleCorrection> glyphScaleCorrections;
+        };
+
+        void _SwapShapedText(ShapedText& shaped) noexcept;
+
+        // Most lines are repainted without having changed, for instance when the cursor
+        // blinks or the selection changes. Draw() keeps the shaped text it drew at each
+        // origin and reuses it as long as the text and font didn't change. A new font
+        // creates a new CustomTextLayout, which is what invalidates this cache.
+        std::unordered_map<uint64_t, ShapedText> _shapedTextCache;
+        static constexpr size_t _shapedTextCacheLimit = 1024;
+
 #ifdef UNIT_TESTING
     public:
         CustomTextLayout() = default;
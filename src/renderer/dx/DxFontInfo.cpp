@@ -7,6 +7,8 @@
 #include <unicode.hpp>
 #include <VersionHelpers.h>
 
+#include "../base/FontCache.h"
+
 static constexpr std::wstring_view FALLBACK_FONT_FACES[] = { L"Consolas", L"Lucida Console", L"Courier New" };
 
 using namespace Microsoft::Console::Render;
@@ -193,31 +195,19 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
 {
     Microsoft::WRL::ComPtr<IDWriteFontFace1> fontFace;
 
-    UINT32 familyIndex;
-    BOOL familyExists;
-
-    THROW_IF_FAILED(fontCollection->FindFamilyName(_familyName.data(), &familyIndex, &familyExists));
+    const auto resolved = FontCache::FindFontFace(fontCollection, _familyName, GetWeight(), GetStretch(), GetStyle());
 
-    if (familyExists)
+    if (resolved.face)
     {
-        Microsoft::WRL::ComPtr<IDWriteFontFamily> fontFamily;
-        THROW_IF_FAILED(fontCollection->GetFontFamily(familyIndex, &fontFamily));
-
-        Microsoft::WRL::ComPtr<IDWriteFont> font;
-        THROW_IF_FAILED(fontFamily->GetFirstMatchingFont(GetWeight(), GetStretch(), GetStyle(), &font));
-
-        Microsoft::WRL::ComPtr<IDWriteFontFace> fontFace0;
-        THROW_IF_FAILED(font->CreateFontFace(&fontFace0));
-
-        THROW_IF_FAILED(fontFace0.As(&fontFace));
+        THROW_IF_FAILED(resolved.face->QueryInterface(IID_PPV_ARGS(&fontFace)));
 
         // Retrieve metrics in case the font we created was different than what was requested.
-        _weight = font->GetWeight();
-        _stretch = font->GetStretch();
-        _style = font->GetStyle();
+        _weight = resolved.font->GetWeight();
+        _stretch = resolved.font->GetStretch();
+        _style = resolved.font->GetStyle();
 
         // Dig the family name out at the end to return it.
-        _familyName = _GetFontFamilyName(fontFamily.Get(), localeName);
+        _familyName = _GetFontFamilyName(resolved.family.get(), localeName);
     }
 
     return fontFace;
@@ -16,6 +16,7 @@
 #include "ScreenVertexShader.h"
 #include <DirectXMath.h>
 #include <d3dcompiler.h>
+#include <til/hash.h>
 #include <DirectXColors.h>
 
 using namespace DirectX;
@@ -79,6 +80,8 @@ DxEngine::DxEngine() :
     _presentScroll{ 0 },
     _presentDirty{ 0 },
     _presentOffset{ 0 },
+    _presentScrolled{ false },
+    _frameDamage{ &_pool },
     _isEnabled{ false },
     _isPainting{ false },
     _displaySizePixels{},
@@ -197,6 +200,8 @@ DxEngine::~DxEngine()
 // - entry - Entry function of shader
 // Return Value:
 // - Compiled binary. Errors are thrown and logged.
+static constexpr UINT s_shaderCompileFlags = D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_OPTIMIZATION_LEVEL3;
+
 static Microsoft::WRL::ComPtr<ID3DBlob> _CompileShader(const std::string_view& source, const char* target)
 {
 #if !TIL_FEATURE_DXENGINESHADERSUPPORT_ENABLED
@@ -214,7 +219,7 @@ static Microsoft::WRL::ComPtr<ID3DBlob> _CompileShader(const std::string_view& s
         nullptr,
         "main",
         target,
-        D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_OPTIMIZATION_LEVEL3,
+        s_shaderCompileFlags,
         0,
         &code,
         &error);
@@ -234,6 +239,170 @@ static Microsoft::WRL::ComPtr<ID3DBlob> _CompileShader(const std::string_view& s
 #endif
 }
 
+#if TIL_FEATURE_DXENGINESHADERSUPPORT_ENABLED
+// Routine Description:
+// - Checks whether the given bytes look like a complete DXBC container: the magic
+//   number followed by a checksum, a version and the total size of the container.
+//   The runtime verifies the checksum itself once the shader is created.
+static bool _IsShaderBytecode(const std::span<const uint8_t> bytes) noexcept
+{
+    if (bytes.size() < 28 || memcmp(bytes.data(), "DXBC", 4) != 0)
+    {
+        return false;
+    }
+
+    uint32_t size;
+    memcpy(&size, bytes.data() + 24, sizeof(size));
+    return size == bytes.size();
+}
+
+// Routine Description:
+// - Reads a compiled shader from the on-disk cache.
+// Return Value:
+// - The bytecode, or an empty vector if it isn't cached or the file is invalid.
+static std::vector<uint8_t> _ReadShaderCacheFile(const std::filesystem::path& path)
+{
+    wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (!file)
+    {
+        return {};
+    }
+
+    LARGE_INTEGER fileSize;
+    // Shaders are a few KB in size. Anything larger than this is not one of ours.
+    if (!GetFileSizeEx(file.get(), &fileSize) || fileSize.QuadPart > 16 * 1024 * 1024)
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> bytes(gsl::narrow_cast<size_t>(fileSize.QuadPart));
+    DWORD read = 0;
+    if (!ReadFile(file.get(), bytes.data(), gsl::narrow_cast<DWORD>(bytes.size()), &read, nullptr) || read != bytes.size() || !_IsShaderBytecode(bytes))
+    {
+        return {};
+    }
+
+    return bytes;
+}
+
+// Routine Description:
+// - Writes a compiled shader into the on-disk cache. The file is written under
+//   a temporary name first, so that other processes never see a partial file.
+static void _WriteShaderCacheFile(const std::filesystem::path& path, const std::span<const uint8_t> bytes)
+{
+    std::filesystem::create_directories(path.parent_path());
+
+    auto tempPath = path;
+    tempPath += fmt::format(L".{}.tmp", GetCurrentProcessId());
+
+    {
+        wil::unique_hfile file{ CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        DWORD written = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), bytes.data(), gsl::narrow_cast<DWORD>(bytes.size()), &written, nullptr));
+    }
+
+    if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        const auto hr = HRESULT_FROM_WIN32(GetLastError());
+        DeleteFileW(tempPath.c_str());
+        THROW_HR(hr);
+    }
+}
+#endif
+
+// Routine Description:
+// - Like _CompileShader, but the compiled shaders are cached, keyed by a hash of the
+//   source, the target and the compiler. A custom pixel shader would otherwise be recompiled
+//   for every control and every time the device is recreated, which takes the HLSL compiler
+//   hundreds of milliseconds. The cache is kept in memory for the lifetime of the process
+//   and in the temp directory across processes. Failing to use the latter is not an error.
+// Arguments:
+// - source - Shader source
+// - target - What kind of shader this is
+// Return Value:
+// - Compiled binary. Errors are thrown and logged.
+static Microsoft::WRL::ComPtr<ID3DBlob> _CompileShaderCached(const std::string_view& source, const char* target)
+{
+#if !TIL_FEATURE_DXENGINESHADERSUPPORT_ENABLED
+    return _CompileShader(source, target);
+#else
+    static std::mutex s_lock;
+    static std::unordered_map<size_t, std::vector<uint8_t>> s_shaders;
+
+    static constexpr UINT compilerVersion = D3D_COMPILER_VERSION;
+    const std::string_view targetView{ target };
+    const auto key = til::hasher{}
+                         .write(source.data(), source.size())
+                         .write(targetView.data(), targetView.size())
+                         .write(&s_shaderCompileFlags, 1)
+                         .write(&compilerVersion, 1)
+                         .finalize();
+
+    const auto toBlob = [](const std::span<const uint8_t> bytes) {
+        Microsoft::WRL::ComPtr<ID3DBlob> blob;
+        THROW_IF_FAILED(D3DCreateBlob(bytes.size(), &blob));
+        memcpy(blob->GetBufferPointer(), bytes.data(), bytes.size());
+        return blob;
+    };
+
+    {
+        const std::lock_guard guard{ s_lock };
+        if (const auto it = s_shaders.find(key); it != s_shaders.end())
+        {
+            return toBlob(it->second);
+        }
+    }
+
+    std::filesystem::path path;
+    try
+    {
+        std::array<wchar_t, MAX_PATH + 1> tempPath;
+        const auto length = GetTempPathW(gsl::narrow_cast<DWORD>(tempPath.size()), tempPath.data());
+        if (length != 0 && length < tempPath.size())
+        {
+            // The source size is part of the name to make a collision of the hashes even less likely.
+            path = std::filesystem::path{ std::wstring_view{ tempPath.data(), length } } / L"DxEngineShaderCache" / fmt::format(L"{:016x}-{}.cso", key, source.size());
+        }
+    }
+    CATCH_LOG();
+
+    std::vector<uint8_t> bytes;
+    if (!path.empty())
+    {
+        try
+        {
+            bytes = _ReadShaderCacheFile(path);
+        }
+        CATCH_LOG();
+    }
+
+    if (bytes.empty())
+    {
+        const auto code = _CompileShader(source, target);
+        const auto data = static_cast<const uint8_t*>(code->GetBufferPointer());
+        bytes.assign(data, data + code->GetBufferSize());
+
+        if (!path.empty())
+        {
+            try
+            {
+                _WriteShaderCacheFile(path, bytes);
+            }
+            CATCH_LOG();
+        }
+    }
+
+    auto blob = toBlob(bytes);
+    {
+        const std::lock_guard guard{ s_lock };
+        s_shaders.emplace(key, std::move(bytes));
+    }
+    return blob;
+#endif
+}
+
 // Routine Description:
 // - Checks if terminal effects are enabled.
 // Arguments:
@@ -376,14 +545,14 @@ HRESULT DxEngine::_SetupTerminalEffects()
     }
 
     // Prepare shaders.
-    auto vertexBlob = _CompileShader(&screenVertexShaderString[0], shaderTargetVS);
+    auto vertexBlob = _CompileShaderCached(&screenVertexShaderString[0], shaderTargetVS);
     Microsoft::WRL::ComPtr<ID3DBlob> pixelBlob;
     // As the pixel shader source is user provided it's possible there's a problem with it
     //  so load it inside a try catch, on any error log and fallback on the error pixel shader
     //  If even the error pixel shader fails to load rely on standard exception handling
     try
     {
-        pixelBlob = _CompileShader(pixelShaderSource, shaderTargetPS);
+        pixelBlob = _CompileShaderCached(pixelShaderSource, shaderTargetPS);
     }
     catch (...)
     {
@@ -630,7 +799,7 @@ try
         _swapChainDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
         _swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
         _swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
-        _swapChainDesc.BufferCount = 2;
+        _swapChainDesc.BufferCount = _swapChainBufferCount;
         _swapChainDesc.SampleDesc.Count = 1;
         _swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
         _swapChainDesc.Scaling = DXGI_SCALING_NONE;
@@ -996,6 +1165,14 @@ try
 }
 CATCH_RETURN();
 
+// Routine Description:
+// - Releases all device resources, including the swap chain. They're
+//   recreated by the next StartPaint(), which repaints the entire viewport.
+void DxEngine::ReleaseResources() noexcept
+{
+    _ReleaseDeviceResources();
+}
+
 void DxEngine::SetCallback(std::function<void()> pfn) noexcept
 {
     _pfn = std::move(pfn);
@@ -1198,6 +1375,7 @@ try
 {
     _invalidMap.set_all();
     _allInvalid = true;
+    _damageHistory.clear();
 
     // Since everything is invalidated here, mark this as a "first frame", so
     // that we won't use incremental drawing on it. The caller of this intended
@@ -1324,7 +1502,7 @@ try
             _d2dBitmap.Reset();
 
             // Change the buffer size and recreate the render target (and surface)
-            RETURN_IF_FAILED(_dxgiSwapChain->ResizeBuffers(2, clientSize.narrow_width<UINT>(), clientSize.narrow_height<UINT>(), _swapChainDesc.Format, _swapChainDesc.Flags));
+            RETURN_IF_FAILED(_dxgiSwapChain->ResizeBuffers(_swapChainBufferCount, clientSize.narrow_width<UINT>(), clientSize.narrow_height<UINT>(), _swapChainDesc.Format, _swapChainDesc.Flags));
             RETURN_IF_FAILED(_PrepareRenderTarget());
 
             // OK we made it past the parts that can cause errors. We can release our failure handler.
@@ -1340,6 +1518,32 @@ try
             RETURN_IF_FAILED(InvalidateAll());
         }
 
+        _frameDamage = _invalidMap;
+        if (!_firstFrame && !_FullRepaintNeeded())
+        {
+            if (_invalidScroll != til::point{ 0, 0 })
+            {
+                // Present1() scrolls relative to the previous frame,
+                // so the back buffer needs to hold exactly that frame.
+                if (!_damageHistory.empty())
+                {
+                    RETURN_IF_FAILED(_CopyFrontToBack());
+                    _damageHistory.clear();
+                }
+            }
+            else
+            {
+                // Catch the back buffer up on what the frames since it was presented changed.
+                for (const auto& damage : _damageHistory)
+                {
+                    for (const auto& rect : damage.runs())
+                    {
+                        _invalidMap.set(rect);
+                    }
+                }
+            }
+        }
+
         _d2dDeviceContext->BeginDraw();
         _isPainting = true;
 
@@ -1390,16 +1594,27 @@ try
 
         if (SUCCEEDED(hr))
         {
-            if (_invalidScroll != til::point{ 0, 0 })
-            {
-                // Copy `til::rects` into RECT map.
-                _presentDirty.assign(_invalidMap.begin(), _invalidMap.end());
+            // Copy `til::rects` into RECT map.
+            _presentDirty.assign(_invalidMap.begin(), _invalidMap.end());
 
-                // Scale all dirty rectangles into pixels
-                std::transform(_presentDirty.begin(), _presentDirty.end(), _presentDirty.begin(), [&](const til::rect& rc) {
-                    return rc.scale_up(_fontRenderData->GlyphCell());
-                });
+            // Scale all dirty rectangles into pixels
+            std::transform(_presentDirty.begin(), _presentDirty.end(), _presentDirty.begin(), [&](const til::rect& rc) {
+                return rc.scale_up(_fontRenderData->GlyphCell());
+            });
+
+            // Everything outside of the dirty rectangles is identical to the previous
+            // frame (see StartPaint), which allows DWM to only compose what changed.
+            _presentParams.DirtyRectsCount = gsl::narrow<UINT>(_presentDirty.size());
 
+            // It's not nice to use reinterpret_cast between til::rect and RECT,
+            // but to be honest... it does save a ton of type juggling.
+            static_assert(sizeof(decltype(_presentDirty)::value_type) == sizeof(RECT));
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+            _presentParams.pDirtyRects = reinterpret_cast<RECT*>(_presentDirty.data());
+
+            _presentScrolled = _invalidScroll != til::point{ 0, 0 };
+            if (_presentScrolled)
+            {
                 // Invalid scroll is in characters, convert it to pixels.
                 const auto scrollPixels = (_invalidScroll * _fontRenderData->GlyphCell());
 
@@ -1418,15 +1633,6 @@ try
                 // Pass the offset.
                 _presentOffset = scrollPixels.to_win32_point();
 
-                // Now fill up the parameters structure from the member variables.
-                _presentParams.DirtyRectsCount = gsl::narrow<UINT>(_presentDirty.size());
-
-                // It's not nice to use reinterpret_cast between til::rect and RECT,
-                // but to be honest... it does save a ton of type juggling.
-                static_assert(sizeof(decltype(_presentDirty)::value_type) == sizeof(RECT));
-#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
-                _presentParams.pDirtyRects = reinterpret_cast<RECT*>(_presentDirty.data());
-
                 _presentParams.pScrollOffset = &_presentOffset;
                 _presentParams.pScrollRect = &_presentScroll;
 
@@ -1545,6 +1751,7 @@ void DxEngine::WaitUntilCanRender() noexcept
             auto hr = S_OK;
 
             auto recreate = false;
+            const auto fullPresent = _firstFrame;
 
             // On anything but the first frame, try partial presentation.
             // We'll do it first because if it fails, we'll try again with full presentation.
@@ -1596,13 +1803,27 @@ void DxEngine::WaitUntilCanRender() noexcept
                 }
             }
 
-            // If we are doing full repaints we don't need to copy front buffer to back buffer
+            // If we are doing full repaints we don't need to track what the back buffer is missing
             if (!_FullRepaintNeeded())
             {
-                // Finally copy the front image (being presented now) onto the backing buffer
-                // (where we are about to draw the next frame) so we can draw only the differences
-                // next frame.
-                RETURN_IF_FAILED(_CopyFrontToBack());
+                if (fullPresent || _presentScrolled || _frameDamage.all())
+                {
+                    // The next frame needs to start from exactly this frame anyways, so copy the
+                    // front image (being presented now) onto the backing buffer (where we are
+                    // about to draw the next frame) so we can draw only the differences next frame.
+                    RETURN_IF_FAILED(_CopyFrontToBack());
+                    _damageHistory.clear();
+                }
+                else
+                {
+                    // Otherwise the back buffer shows an older frame and all we need
+                    // to remember is what the frames since then changed.
+                    if (_damageHistory.size() >= _swapChainBufferCount - 1)
+                    {
+                        _damageHistory.erase(_damageHistory.begin());
+                    }
+                    _damageHistory.emplace_back(_frameDamage);
+                }
             }
 
             _presentReady = false;
@@ -1611,6 +1832,7 @@ void DxEngine::WaitUntilCanRender() noexcept
             _presentOffset = { 0 };
             _presentScroll = { 0 };
             _presentParams = { 0 };
+            _presentScrolled = false;
         }
         CATCH_RETURN();
     }
@@ -1860,6 +2082,36 @@ try
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Paints an overlay tint on the highlighted portions of the frame, like all matches of a search.
+//   They're tinted in the selection color at half its opacity, so that the selection stands out.
+// Arguments:
+//  - rects - Rectangles to tint
+// Return Value:
+// - S_OK or relevant DirectX error.
+[[nodiscard]] HRESULT DxEngine::PaintHighlights(gsl::span<const til::rect> rects) noexcept
+try
+{
+    // If a clip rectangle is in place from drawing the text layer, remove it here.
+    LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
+
+    const auto existingColor = _d2dBrushForeground->GetColor();
+
+    auto color = _selectionBackground;
+    color.a /= 2;
+    _d2dBrushForeground->SetColor(color);
+    const auto resetColorOnExit = wil::scope_exit([&]() noexcept { _d2dBrushForeground->SetColor(existingColor); });
+
+    const auto glyphCell = _fontRenderData->GlyphCell();
+    for (const auto& rect : rects)
+    {
+        _d2dDeviceContext->FillRectangle(rect.scale_up(glyphCell).to_d2d_rect(), _d2dBrushForeground.Get());
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
 // Routine Description:
 // - Does nothing. Our cursor is drawn in CustomTextRenderer::DrawGlyphRun,
 //   either above or below the text.
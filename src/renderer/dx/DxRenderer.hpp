@@ -57,6 +57,8 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT SetWindowSize(const til::size pixels) noexcept override;
 
+        void ReleaseResources() noexcept override;
+
         void SetCallback(std::function<void()> pfn) noexcept override;
         void SetWarningCallback(std::function<void(const HRESULT)> pfn) noexcept override;
 
@@ -111,6 +113,7 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT PaintBufferGridLines(GridLineSet const lines, COLORREF const color, size_t const cchLine, til::point const coordTarget) noexcept override;
         [[nodiscard]] HRESULT PaintSelection(const til::rect& rect) noexcept override;
+        [[nodiscard]] HRESULT PaintHighlights(gsl::span<const til::rect> rects) noexcept override;
 
         [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
 
@@ -193,6 +196,14 @@ namespace Microsoft::Console::Render
         RECT _presentScroll;
         POINT _presentOffset;
         DXGI_PRESENT_PARAMETERS _presentParams;
+        bool _presentScrolled;
+
+        // Flip model swap chains hand us the buffer we presented _swapChainBufferCount - 1 frames ago
+        // to draw on. _damageHistory holds what each frame since then changed, so that we only
+        // redraw that much. _frameDamage is what the frame that's being painted changes itself.
+        static constexpr UINT _swapChainBufferCount = 2;
+        til::pmr::bitmap _frameDamage;
+        std::vector<til::pmr::bitmap> _damageHistory;
 
         static std::atomic<size_t> _tracelogCount;
 
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "fontcache.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+static constexpr auto CacheKeyName = L"Console";
+static constexpr auto CacheValueName = L"GdiFontCache";
+
+// The keys whose last write time invalidates the cache. Fonts installed by the
+// user (instead of for the machine) are listed in the same key under HKCU.
+static constexpr std::pair<HKEY, const wchar_t*> FontListKeys[]{
+    { HKEY_LOCAL_MACHINE, LR"(SOFTWARE\Microsoft\Windows NT\CurrentVersion\Fonts)" },
+    { HKEY_CURRENT_USER, LR"(SOFTWARE\Microsoft\Windows NT\CurrentVersion\Fonts)" },
+    { HKEY_LOCAL_MACHINE, LR"(SOFTWARE\Microsoft\Windows NT\CurrentVersion\FontSubstitutes)" },
+};
+
+wil::srwlock GdiFontCache::s_lock;
+std::vector<GdiFontCache::Entry> GdiFontCache::s_entries;
+GdiFontCache::Stamp GdiFontCache::s_stamp{};
+bool GdiFontCache::s_loaded = false;
+
+bool GdiFontCache::Key::operator==(const Key& other) const noexcept
+{
+    return wcsncmp(faceName, other.faceName, LF_FACESIZE) == 0 &&
+           height == other.height &&
+           width == other.width &&
+           weight == other.weight &&
+           charSet == other.charSet &&
+           dpi == other.dpi;
+}
+
+// Routine Description:
+// - Looks up what GDI resolved the given font request to the last time it was made.
+// Arguments:
+// - key - The font request.
+// Return Value:
+// - The resolved face and cell size, or nullopt if the request isn't cached
+//   or the installed fonts changed since it was.
+std::optional<GdiFontCache::Metrics> GdiFontCache::Lookup(const Key& key) noexcept
+try
+{
+    const auto lock = s_lock.lock_exclusive();
+    s_Load();
+
+    for (const auto& entry : s_entries)
+    {
+        if (entry.key == key)
+        {
+            return entry.metrics;
+        }
+    }
+
+    return std::nullopt;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Remembers what GDI resolved the given font request to, for this
+//   and all future console windows, and persists it to the registry.
+// Arguments:
+// - key - The font request.
+// - metrics - The resolved face and cell size.
+// Return Value:
+// - <none>
+void GdiFontCache::Store(const Key& key, const Metrics& metrics) noexcept
+try
+{
+    const auto lock = s_lock.lock_exclusive();
+    s_Load();
+
+    for (auto& entry : s_entries)
+    {
+        if (entry.key == key)
+        {
+            entry.metrics = metrics;
+            s_Save();
+            return;
+        }
+    }
+
+    // Evict the oldest entry to keep the value in the registry small.
+    if (s_entries.size() >= s_maxEntries)
+    {
+        s_entries.erase(s_entries.begin());
+    }
+
+    s_entries.emplace_back(Entry{ key, metrics });
+    s_Save();
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Reads the persisted cache from the registry, once per process.
+//   The cache is left empty if it's missing, malformed or stale.
+// - The lock must be held.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void GdiFontCache::s_Load()
+{
+    if (s_loaded)
+    {
+        return;
+    }
+
+    s_loaded = true;
+    s_stamp = s_GetStamp();
+
+    DWORD size = 0;
+    if (RegGetValueW(HKEY_CURRENT_USER, CacheKeyName, CacheValueName, RRF_RT_REG_BINARY, nullptr, nullptr, &size) != ERROR_SUCCESS ||
+        size < sizeof(Header) ||
+        size > sizeof(Header) + s_maxEntries * sizeof(Entry))
+    {
+        return;
+    }
+
+    std::vector<BYTE> data(size);
+    if (RegGetValueW(HKEY_CURRENT_USER, CacheKeyName, CacheValueName, RRF_RT_REG_BINARY, nullptr, data.data(), &size) != ERROR_SUCCESS ||
+        size < sizeof(Header))
+    {
+        return;
+    }
+
+    Header header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    if (header.version != s_version ||
+        header.count > s_maxEntries ||
+        size != sizeof(Header) + header.count * sizeof(Entry) ||
+        memcmp(header.stamp.data(), s_stamp.data(), sizeof(Stamp)) != 0)
+    {
+        return;
+    }
+
+    s_entries.resize(header.count);
+    memcpy(s_entries.data(), data.data() + sizeof(Header), header.count * sizeof(Entry));
+
+    // Don't trust the face names to be null-terminated.
+    for (auto& entry : s_entries)
+    {
+        entry.key.faceName[LF_FACESIZE - 1] = L'\0';
+        entry.metrics.faceName[LF_FACESIZE - 1] = L'\0';
+    }
+}
+
+// Routine Description:
+// - Writes the cache to the registry, together with the stamp it's valid for.
+// - The lock must be held.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void GdiFontCache::s_Save()
+{
+    const Header header{ s_version, s_stamp, gsl::narrow_cast<uint32_t>(s_entries.size()) };
+
+    std::vector<BYTE> data(sizeof(Header) + s_entries.size() * sizeof(Entry));
+    memcpy(data.data(), &header, sizeof(header));
+    memcpy(data.data() + sizeof(Header), s_entries.data(), s_entries.size() * sizeof(Entry));
+
+    LOG_IF_WIN32_ERROR(RegSetKeyValueW(HKEY_CURRENT_USER,
+                                       CacheKeyName,
+                                       CacheValueName,
+                                       REG_BINARY,
+                                       data.data(),
+                                       gsl::narrow_cast<DWORD>(data.size())));
+}
+
+// Routine Description:
+// - Gets the last write times of the registry keys that list the installed fonts
+//   and the font substitutes. Installing, removing or substituting a font changes
+//   them, which the cache uses to notice that the font mapper might decide differently.
+// Arguments:
+// - <none>
+// Return Value:
+// - The last write times. Keys that don't exist are reported as 0.
+GdiFontCache::Stamp GdiFontCache::s_GetStamp() noexcept
+{
+    Stamp stamp{};
+
+    for (size_t i = 0; i < stamp.size(); ++i)
+    {
+        wil::unique_hkey key;
+        if (RegOpenKeyExW(FontListKeys[i].first, FontListKeys[i].second, 0, KEY_QUERY_VALUE, key.put()) == ERROR_SUCCESS)
+        {
+            LOG_IF_WIN32_ERROR(RegQueryInfoKeyW(key.get(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &til::at(stamp, i)));
+        }
+    }
+
+    return stamp;
+}
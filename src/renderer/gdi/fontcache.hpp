@@ -0,0 +1,83 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- fontcache.hpp
+
+Abstract:
+- A persisted cache of the fonts the GDI font mapper resolved for a font request.
+- On machines with a lot of installed fonts, mapping a request to a font (in particular
+  one for a face that isn't installed) can take a noticeable amount of time, and the
+  console does it several times before the window is first shown. The requests and the
+  resolved face names and cell sizes are stored in the registry, so that later console
+  windows can skip the measurements and ask GDI for the resolved face directly.
+- The cache is discarded whenever the installed fonts or the font substitutes change.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class GdiFontCache final
+    {
+    public:
+        // The LOGFONT the engine asks GDI for, in pixels at the given DPI.
+        struct Key
+        {
+            wchar_t faceName[LF_FACESIZE];
+            LONG height;
+            LONG width;
+            LONG weight;
+            BYTE charSet;
+            int dpi;
+
+            bool operator==(const Key& other) const noexcept;
+        };
+
+        // What GDI resolved the Key to.
+        struct Metrics
+        {
+            wchar_t faceName[LF_FACESIZE];
+            BYTE pitchAndFamily;
+            UINT weight;
+            til::CoordType cellWidth;
+            til::CoordType cellHeight;
+        };
+
+        static std::optional<Metrics> Lookup(const Key& key) noexcept;
+        static void Store(const Key& key, const Metrics& metrics) noexcept;
+
+    private:
+        struct Entry
+        {
+            Key key;
+            Metrics metrics;
+        };
+
+        // The last write times of the registry keys listing the installed fonts
+        // and the font substitutes. If any of them changes, the cache is stale.
+        using Stamp = std::array<FILETIME, 3>;
+
+        struct Header
+        {
+            uint32_t version;
+            Stamp stamp;
+            uint32_t count;
+        };
+
+        static constexpr uint32_t s_version = 1;
+        // The number of requests worth remembering is small: a few
+        // font sizes of the one or two faces the user picked, per DPI.
+        static constexpr size_t s_maxEntries = 32;
+
+        static void s_Load();
+        static void s_Save();
+        static Stamp s_GetStamp() noexcept;
+
+        static wil::srwlock s_lock;
+        static std::vector<Entry> s_entries;
+        static Stamp s_stamp;
+        static bool s_loaded;
+    };
+}
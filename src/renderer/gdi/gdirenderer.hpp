@@ -35,6 +35,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
 
+        void WaitUntilCanRender() noexcept override;
+        [[nodiscard]] bool PaintsWithoutLock() noexcept override;
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
@@ -94,6 +96,11 @@ namespace Microsoft::Console::Render
 
         bool _fPaintStarted;
 
+        // Over remote desktop we avoid ScrollWindowEx and paint at a lower frame rate,
+        // so that the client receives fewer, larger bitmap updates.
+        bool _isRemoteSession = false;
+        static constexpr DWORD s_RemoteFrameIntervalMs = 25;
+
         til::rect _invalidCharacters;
         PAINTSTRUCT _psInvalidData;
         HDC _hdcMemoryContext;
@@ -104,9 +111,6 @@ namespace Microsoft::Console::Render
         TEXTMETRICW _tmFontMetrics;
         FontResource _softFont;
 
-        static const size_t s_cPolyTextCache = 80;
-        POLYTEXTW _pPolyText[s_cPolyTextCache];
-        size_t _cPolyText;
         [[nodiscard]] HRESULT _FlushBufferLines() noexcept;
 
         std::vector<RECT> cursorInvertRects;
@@ -156,9 +160,16 @@ namespace Microsoft::Console::Render
         // frequently created and dropped.
         // It's important the pool is first so it can be given to the others on construction.
         std::pmr::unsynchronized_pool_resource _pool;
+        // The lines PaintBufferLine() queued up for _FlushBufferLines(). The lpstr and pdx
+        // members of _polyText are only pointed at _polyStrings and _polyWidths when flushing,
+        // since the strings may move around while the vectors grow.
+        std::pmr::vector<POLYTEXTW> _polyText;
         std::pmr::vector<std::pmr::wstring> _polyStrings;
         std::pmr::vector<std::pmr::basic_string<int>> _polyWidths;
 
+        // The results of IsGlyphWideByFont() for the current font.
+        std::unordered_map<wchar_t, bool> _glyphWidthCache;
+
         [[nodiscard]] HRESULT _InvalidCombine(const til::rect* const prc) noexcept;
         [[nodiscard]] HRESULT _InvalidOffset(const til::point* const ppt) noexcept;
         [[nodiscard]] HRESULT _InvalidRestrict() noexcept;
@@ -40,6 +40,15 @@ using namespace Microsoft::Console::Render;
     if (glyph.size() == 1)
     {
         const auto wch = glyph.front();
+
+        // Every measurement is a GDI call, but it's usually the same few glyphs being asked about.
+        if (const auto it = _glyphWidthCache.find(wch); it != _glyphWidthCache.end())
+        {
+            *pResult = it->second;
+            return S_OK;
+        }
+
+        auto measured = false;
         if (_IsFontTrueType())
         {
             ABC abc;
@@ -48,6 +57,7 @@ using namespace Microsoft::Console::Render;
                 const int totalWidth = abc.abcA + abc.abcB + abc.abcC;
 
                 isFullWidth = totalWidth > _GetFontSize().X;
+                measured = true;
             }
         }
         else
@@ -56,7 +66,17 @@ using namespace Microsoft::Console::Render;
             if (GetCharWidth32W(_hdcMemoryContext, wch, wch, &cpxWidth))
             {
                 isFullWidth = cpxWidth > _GetFontSize().X;
+                measured = true;
+            }
+        }
+
+        if (measured)
+        {
+            try
+            {
+                _glyphWidthCache.emplace(wch, isFullWidth);
             }
+            CATCH_LOG();
         }
     }
     else
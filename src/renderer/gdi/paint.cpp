@@ -20,6 +20,24 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
            (glyphs[0] != 0xFFFF && glyphs[1] != 0xFFFF && glyphs[2] != 0xFFFF && glyphs[3] != 0xFFFF);
 }
 
+// Method Description:
+// - Throttles the render loop. Over remote desktop every frame turns into a
+//   bitmap update sent to the client, so we wait a little longer there to
+//   let more invalidations accumulate into the next frame.
+void GdiEngine::WaitUntilCanRender() noexcept
+{
+    _isRemoteSession = GetSystemMetrics(SM_REMOTESESSION) != 0;
+    Sleep(_isRemoteSession ? s_RemoteFrameIntervalMs : 8);
+}
+
+// Method Description:
+// - All of our calls come from the renderer and we don't need the console
+//   data to draw a line of text, so we can paint without the console lock.
+[[nodiscard]] bool GdiEngine::PaintsWithoutLock() noexcept
+{
+    return true;
+}
+
 // Routine Description:
 // - Prepares internal structures for a painting operation.
 // Arguments:
@@ -40,7 +58,9 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
     RETURN_HR_IF(S_FALSE, (!IsWindowVisible(_hwndTargetWindow) && !_titleChanged));
 
     // At the beginning of a new frame, we have 0 lines ready for painting in PolyTextOut
-    _cPolyText = 0;
+    _polyText.clear();
+    _polyStrings.clear();
+    _polyWidths.clear();
 
     // Prepare our in-memory bitmap for double-buffered composition.
     RETURN_IF_FAILED(_PrepareMemoryBitmap(_hwndTargetWindow));
@@ -126,18 +146,29 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
     RETURN_IF_FAILED(LongSub(_szMemorySurface.cy, szGutter.cy, &rcScrollLimit.bottom));
 
     // Scroll real window and memory buffer in-sync.
-    LOG_LAST_ERROR_IF(!ScrollWindowEx(_hwndTargetWindow,
-                                      _szInvalidScroll.cx,
-                                      _szInvalidScroll.cy,
-                                      &rcScrollLimit,
-                                      &rcScrollLimit,
-                                      nullptr,
-                                      nullptr,
-                                      0));
+    // Over remote desktop the window isn't scrolled. Instead the entire scrolled area
+    // is invalidated, so that EndPaint() blits it from the memory buffer in one go,
+    // which the remote desktop client handles a lot better than a scroll.
+    if (!_isRemoteSession)
+    {
+        LOG_LAST_ERROR_IF(!ScrollWindowEx(_hwndTargetWindow,
+                                          _szInvalidScroll.cx,
+                                          _szInvalidScroll.cy,
+                                          &rcScrollLimit,
+                                          &rcScrollLimit,
+                                          nullptr,
+                                          nullptr,
+                                          0));
+    }
 
     til::rect rcUpdate;
     LOG_HR_IF(E_FAIL, !(ScrollDC(_hdcMemoryContext, _szInvalidScroll.cx, _szInvalidScroll.cy, &rcScrollLimit, &rcScrollLimit, nullptr, rcUpdate.as_win32_rect())));
 
+    if (_isRemoteSession)
+    {
+        rcUpdate = til::rect{ rcScrollLimit };
+    }
+
     LOG_IF_FAILED(_InvalidCombine(&rcUpdate));
 
     // update invalid rect for the remainder of paint functions
@@ -336,14 +367,12 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
 
         const auto ptDraw = coord * _GetFontSize();
 
-        const auto pPolyTextLine = &_pPolyText[_cPolyText];
-
-        auto& polyString = _polyStrings.emplace_back();
+        std::pmr::wstring polyString{ &_pool };
         polyString.reserve(cchLine);
 
         const auto coordFontSize = _GetFontSize();
 
-        auto& polyWidth = _polyWidths.emplace_back();
+        std::pmr::basic_string<int> polyWidth{ &_pool };
         polyWidth.reserve(cchLine);
 
         // If we have a soft font, we only use the character's lower 7 bits.
@@ -411,27 +440,45 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
         const auto topOffset = _currentLineRendition == LineRendition::DoubleHeightBottom ? halfHeight : 0;
         const auto bottomOffset = _currentLineRendition == LineRendition::DoubleHeightTop ? halfHeight : 0;
 
-        pPolyTextLine->lpstr = polyString.data();
-        pPolyTextLine->n = gsl::narrow<UINT>(polyString.size());
-        pPolyTextLine->x = ptDraw.x;
-        pPolyTextLine->y = ptDraw.y;
-        pPolyTextLine->uiFlags = ETO_OPAQUE | ETO_CLIPPED;
-        pPolyTextLine->rcl.left = pPolyTextLine->x;
-        pPolyTextLine->rcl.top = pPolyTextLine->y + topOffset;
-        pPolyTextLine->rcl.right = pPolyTextLine->rcl.left + (til::CoordType)cchCharWidths;
-        pPolyTextLine->rcl.bottom = pPolyTextLine->y + coordFontSize.Y - bottomOffset;
-        pPolyTextLine->pdx = polyWidth.data();
+        const auto top = ptDraw.y + topOffset;
+        const auto bottom = ptDraw.y + coordFontSize.Y - bottomOffset;
+        const auto right = ptDraw.x + gsl::narrow_cast<til::CoordType>(cchCharWidths);
 
-        if (trimLeft)
+        // The renderer splits rows into runs of identical attributes, but many of them are drawn
+        // identically (see UpdateDrawingBrushes). If this run continues the previous one, we
+        // extend the previous line instead, which turns most rows into a single ExtTextOutW().
+        // Raster font conversions may change the number of characters, which would misalign the widths.
+        if (!trimLeft && !_polyText.empty() && polyString.size() == polyWidth.size())
         {
-            pPolyTextLine->rcl.left += coordFontSize.X;
+            auto& previous = _polyText.back();
+            if (previous.n == _polyWidths.back().size() && previous.y == ptDraw.y && previous.rcl.right == ptDraw.x && previous.rcl.top == top && previous.rcl.bottom == bottom)
+            {
+                auto& previousString = _polyStrings.back();
+                previousString += polyString;
+                _polyWidths.back() += polyWidth;
+                previous.n = gsl::narrow<UINT>(previousString.size());
+                previous.rcl.right = right;
+                return S_OK;
+            }
         }
 
-        _cPolyText++;
+        const auto n = gsl::narrow<UINT>(polyString.size());
+        _polyStrings.emplace_back(std::move(polyString));
+        _polyWidths.emplace_back(std::move(polyWidth));
 
-        if (_cPolyText >= s_cPolyTextCache)
+        auto& polyTextLine = _polyText.emplace_back();
+        polyTextLine.n = n;
+        polyTextLine.x = ptDraw.x;
+        polyTextLine.y = ptDraw.y;
+        polyTextLine.uiFlags = ETO_OPAQUE | ETO_CLIPPED;
+        polyTextLine.rcl.left = ptDraw.x;
+        polyTextLine.rcl.top = top;
+        polyTextLine.rcl.right = right;
+        polyTextLine.rcl.bottom = bottom;
+
+        if (trimLeft)
         {
-            LOG_IF_FAILED(_FlushBufferLines());
+            polyTextLine.rcl.left += coordFontSize.X;
         }
 
         return S_OK;
@@ -450,11 +497,13 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
 {
     auto hr = S_OK;
 
-    if (_cPolyText > 0)
+    if (!_polyText.empty())
     {
-        for (size_t i = 0; i != _cPolyText; ++i)
+        for (size_t i = 0; i != _polyText.size(); ++i)
         {
-            const auto& t = _pPolyText[i];
+            auto& t = til::at(_polyText, i);
+            t.lpstr = til::at(_polyStrings, i).data();
+            t.pdx = til::at(_polyWidths, i).data();
 
             // The following if/else replicates the essentials of how ExtTextOutW() without ETO_IGNORELANGUAGE works.
             // See InternalTextOut().
@@ -494,12 +543,9 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
             }
         }
 
+        _polyText.clear();
         _polyStrings.clear();
         _polyWidths.clear();
-
-        ZeroMemory(_pPolyText, sizeof(_pPolyText));
-
-        _cPolyText = 0;
     }
 
     RETURN_HR(hr);
@@ -4,6 +4,7 @@
 #include "precomp.h"
 
 #include "gdirenderer.hpp"
+#include "fontcache.hpp"
 #include "../../inc/conattrs.hpp"
 #include <winuserp.h> // for GWL_CONSOLE_BKCOLOR
 #include "../../interactivity/win32/CustomWindowMessages.h"
@@ -25,7 +26,6 @@ GdiEngine::GdiEngine() :
 #endif
     _iCurrentDpi(s_iBaseDpi),
     _hbitmapMemorySurface(nullptr),
-    _cPolyText(0),
     _fInvalidRectUsed(false),
     _lastFg(INVALID_COLOR),
     _lastBg(INVALID_COLOR),
@@ -37,11 +37,10 @@ GdiEngine::GdiEngine() :
     _hfont(nullptr),
     _hfontItalic(nullptr),
     _pool{ til::pmr::get_default_resource() }, // It's important the pool is first so it can be given to the others on construction.
+    _polyText{ &_pool },
     _polyStrings{ &_pool },
     _polyWidths{ &_pool }
 {
-    ZeroMemory(_pPolyText, sizeof(POLYTEXTW) * s_cPolyTextCache);
-
     _hdcMemoryContext = CreateCompatibleDC(nullptr);
     THROW_HR_IF_NULL(E_FAIL, _hdcMemoryContext);
 
@@ -76,14 +75,6 @@ GdiEngine::GdiEngine() :
 // - <none>
 GdiEngine::~GdiEngine()
 {
-    for (size_t iPoly = 0; iPoly < _cPolyText; iPoly++)
-    {
-        if (_pPolyText[iPoly].lpstr != nullptr)
-        {
-            delete[] _pPolyText[iPoly].lpstr;
-        }
-    }
-
     if (_hbitmapMemorySurface != nullptr)
     {
         LOG_HR_IF(E_FAIL, !(DeleteObject(_hbitmapMemorySurface)));
@@ -269,13 +260,23 @@ GdiEngine::~GdiEngine()
                                                       const bool usingSoftFont,
                                                       const bool isSettingDefaultBrushes) noexcept
 {
-    RETURN_IF_FAILED(_FlushBufferLines());
-
     RETURN_HR_IF_NULL(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), _hdcMemoryContext);
 
     // Set the colors for painting text
     const auto [colorForeground, colorBackground] = renderSettings.GetAttributeColors(textAttributes);
 
+    const auto usingItalicFont = textAttributes.IsItalic();
+    const auto fontType = usingSoftFont   ? FontType::Soft :
+                          usingItalicFont ? FontType::Italic :
+                                            FontType::Default;
+
+    // Attributes often change without changing how the text is drawn (hyperlinks, underlines, etc.).
+    // The queued lines only need to be flushed if they'd get drawn differently.
+    if (colorForeground != _lastFg || colorBackground != _lastBg || fontType != _lastFontType)
+    {
+        RETURN_IF_FAILED(_FlushBufferLines());
+    }
+
     if (colorForeground != _lastFg)
     {
         RETURN_HR_IF(E_FAIL, CLR_INVALID == SetTextColor(_hdcMemoryContext, colorForeground));
@@ -297,10 +298,6 @@ GdiEngine::~GdiEngine()
     }
 
     // If the font type has changed, select an appropriate font variant or soft font.
-    const auto usingItalicFont = textAttributes.IsItalic();
-    const auto fontType = usingSoftFont   ? FontType::Soft :
-                          usingItalicFont ? FontType::Italic :
-                                            FontType::Default;
     if (fontType != _lastFontType)
     {
         switch (fontType)
@@ -427,6 +424,8 @@ GdiEngine::~GdiEngine()
     // Inform the soft font of the change in size.
     _softFont.SetTargetSize(_GetFontSize());
 
+    _glyphWidthCache.clear();
+
     LOG_IF_FAILED(InvalidateAll());
 
     return S_OK;
@@ -532,12 +531,12 @@ GdiEngine::~GdiEngine()
                                                   _Inout_ wil::unique_hfont& hFont,
                                                   _Inout_ wil::unique_hfont& hFontItalic) noexcept
 {
-    wil::unique_hdc hdcTemp(CreateCompatibleDC(_hdcMemoryContext));
-    RETURN_HR_IF_NULL(E_FAIL, hdcTemp.get());
-
     // Get a special engine size because TT fonts can't specify X or we'll get weird scaling under some circumstances.
     auto coordFontRequested = FontDesired.GetEngineSize();
 
+    // The request as it's handed to GDI, if it's one that can be cached.
+    std::optional<GdiFontCache::Key> cacheKey;
+
     // First, check to see if we're asking for the default raster font.
     if (FontDesired.IsDefaultRasterFont())
     {
@@ -604,6 +603,44 @@ GdiEngine::~GdiEngine()
 
         FontDesired.FillLegacyNameBuffer(lf.lfFaceName);
 
+        cacheKey.emplace();
+        wmemcpy(cacheKey->faceName, lf.lfFaceName, LF_FACESIZE);
+        cacheKey->height = lf.lfHeight;
+        cacheKey->width = lf.lfWidth;
+        cacheKey->weight = lf.lfWeight;
+        cacheKey->charSet = lf.lfCharSet;
+        cacheKey->dpi = iDpi;
+
+        // If an earlier console resolved the same request (and the installed fonts
+        // didn't change since), we can ask GDI for the face it ended up with and
+        // skip measuring it. Requests for faces that aren't installed in particular
+        // make the font mapper weigh every installed font, which is slow when there are many.
+        if (const auto cached = GdiFontCache::Lookup(*cacheKey))
+        {
+            wmemcpy(lf.lfFaceName, cached->faceName, LF_FACESIZE);
+
+            hFont.reset(CreateFontIndirectW(&lf));
+            RETURN_HR_IF_NULL(E_FAIL, hFont.get());
+
+            lf.lfItalic = TRUE;
+            hFontItalic.reset(CreateFontIndirectW(&lf));
+            RETURN_HR_IF_NULL(E_FAIL, hFontItalic.get());
+
+            const til::size coordFont{ cached->cellWidth, cached->cellHeight };
+            if (coordFontRequested.X == 0)
+            {
+                coordFontRequested.X = s_ShrinkByDpi(coordFont.X, iDpi);
+            }
+
+            Font.SetFromEngine(cached->faceName,
+                               cached->pitchAndFamily,
+                               cached->weight,
+                               false,
+                               coordFont,
+                               coordFontRequested);
+            return S_OK;
+        }
+
         // Create font.
         hFont.reset(CreateFontIndirectW(&lf));
         RETURN_HR_IF_NULL(E_FAIL, hFont.get());
@@ -614,6 +651,9 @@ GdiEngine::~GdiEngine()
         RETURN_HR_IF_NULL(E_FAIL, hFontItalic.get());
     }
 
+    wil::unique_hdc hdcTemp(CreateCompatibleDC(_hdcMemoryContext));
+    RETURN_HR_IF_NULL(E_FAIL, hdcTemp.get());
+
     // Select into DC
     wil::unique_hfont hFontOld(SelectFont(hdcTemp.get(), hFont.get()));
     RETURN_HR_IF_NULL(E_FAIL, hFontOld.get());
@@ -673,6 +713,17 @@ GdiEngine::~GdiEngine()
                            FontDesired.IsDefaultRasterFont(),
                            coordFont,
                            coordFontRequested);
+
+        if (cacheKey && currentFaceName.size() < LF_FACESIZE)
+        {
+            GdiFontCache::Metrics metrics{};
+            wmemcpy(metrics.faceName, currentFaceName.data(), currentFaceName.size());
+            metrics.pitchAndFamily = tm.tmPitchAndFamily;
+            metrics.weight = gsl::narrow_cast<unsigned int>(tm.tmWeight);
+            metrics.cellWidth = coordFont.X;
+            metrics.cellHeight = coordFont.Y;
+            GdiFontCache::Store(*cacheKey, metrics);
+        }
     }
 
     return S_OK;
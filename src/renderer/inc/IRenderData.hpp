@@ -56,6 +56,12 @@ namespace Microsoft::Console::Render
 
         virtual const std::vector<RenderOverlay> GetOverlays() const noexcept = 0;
 
+        // Like GetSelectionRects(), but only for the rows inside GetViewport().
+        virtual std::vector<Microsoft::Console::Types::Viewport> GetVisibleSelectionRects() noexcept = 0;
+        // The highlighted ranges (like all matches of a search) of the rows inside GetViewport(),
+        // with one rectangle per row, just like GetVisibleSelectionRects().
+        virtual std::vector<Microsoft::Console::Types::Viewport> GetVisibleHighlightRects() noexcept = 0;
+
         virtual const bool IsGridLineDrawingAllowed() noexcept = 0;
         virtual const std::wstring_view GetConsoleTitle() const noexcept = 0;
 
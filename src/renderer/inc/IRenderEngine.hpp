@@ -49,6 +49,42 @@ namespace Microsoft::Console::Render
         };
         using GridLineSet = til::enumset<GridLines>;
 
+        // The arguments of a PaintBufferGridLines() call.
+        struct BufferRowGridLines
+        {
+            GridLineSet lines;
+            COLORREF color;
+            size_t cchLine;
+            til::point coordTarget;
+        };
+
+        // A run of clusters sharing the same drawing brushes: the arguments of one
+        // UpdateDrawingBrushes() call, followed by one PaintBufferLine() call and the
+        // PaintBufferGridLines() calls of its grid lines. The clusters and grid lines
+        // are given as the ranges [begin, end) of BufferRow::clusters and BufferRow::gridLines.
+        struct BufferRowRun
+        {
+            TextAttribute textAttributes;
+            bool usingSoftFont;
+            bool trimLeft;
+            til::point coord;
+            size_t clustersBegin;
+            size_t clustersEnd;
+            size_t gridLinesBegin;
+            size_t gridLinesEnd;
+        };
+
+        // An entire line of text that the renderer assembled for PaintBufferRow().
+        struct BufferRow
+        {
+            gsl::span<const Cluster> clusters;
+            gsl::span<const BufferRowRun> runs;
+            gsl::span<const BufferRowGridLines> gridLines;
+            const RenderSettings& renderSettings;
+            gsl::not_null<IRenderData*> pData;
+            bool lineWrapped;
+        };
+
 #pragma warning(suppress : 26432) // If you define or delete any default operation in the type '...', define or delete them all (c.21).
         virtual ~IRenderEngine()
         {
@@ -57,6 +93,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT StartPaint() noexcept = 0;
         [[nodiscard]] virtual HRESULT EndPaint() noexcept = 0;
         [[nodiscard]] virtual bool RequiresContinuousRedraw() noexcept = 0;
+        // Engines that return true only hold the console lock while the renderer captures the frame and paint
+        // it without the lock, so they must not use the IRenderData given to UpdateDrawingBrushes and PaintBufferRow.
+        [[nodiscard]] virtual bool PaintsWithoutLock() noexcept { return false; }
         virtual void WaitUntilCanRender() noexcept = 0;
         [[nodiscard]] virtual HRESULT Present() noexcept = 0;
         [[nodiscard]] virtual HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept = 0;
@@ -66,7 +105,13 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT InvalidateSystem(const til::rect* prcDirtyClient) noexcept = 0;
         [[nodiscard]] virtual HRESULT InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept = 0;
         [[nodiscard]] virtual HRESULT InvalidateScroll(const til::point* pcoordDelta) noexcept = 0;
+        // Notifies the engine that the whole rows of the given viewport-relative region moved by delta rows.
+        // Engines that return S_FALSE get the region invalidated instead.
+        [[nodiscard]] virtual HRESULT InvalidateScrollRegion(const til::rect& /*region*/, const til::CoordType /*delta*/) noexcept { return S_FALSE; }
         [[nodiscard]] virtual HRESULT InvalidateAll() noexcept = 0;
+        // Notifies the engine that only the contents of the color table have changed.
+        // Engines that resolve the table when drawing may avoid repainting the text.
+        [[nodiscard]] virtual HRESULT InvalidateColorTable() noexcept { return InvalidateAll(); }
         [[nodiscard]] virtual HRESULT InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept = 0;
         [[nodiscard]] virtual HRESULT InvalidateTitle(std::wstring_view proposedTitle) noexcept = 0;
         [[nodiscard]] virtual HRESULT NotifyNewText(const std::wstring_view newText) noexcept = 0;
@@ -76,7 +121,13 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT PaintBackground() noexcept = 0;
         [[nodiscard]] virtual HRESULT PaintBufferLine(gsl::span<const Cluster> clusters, til::point coord, bool fTrimLeft, bool lineWrapped) noexcept = 0;
         [[nodiscard]] virtual HRESULT PaintBufferGridLines(GridLineSet lines, COLORREF color, size_t cchLine, til::point coordTarget) noexcept = 0;
+        // Paints an entire line at once. Engines that return S_FALSE get the runs of the line
+        // one call at a time through UpdateDrawingBrushes, PaintBufferLine and PaintBufferGridLines instead.
+        [[nodiscard]] virtual HRESULT PaintBufferRow(const BufferRow& row) noexcept { return S_FALSE; }
         [[nodiscard]] virtual HRESULT PaintSelection(const til::rect& rect) noexcept = 0;
+        // Paints the highlighted ranges of the frame (like all matches of a search) as a tint below the
+        // selection. They're passed all at once, so that engines can draw them in a single pass.
+        [[nodiscard]] virtual HRESULT PaintHighlights(gsl::span<const til::rect> rects) noexcept { return S_OK; }
         [[nodiscard]] virtual HRESULT PaintCursor(const CursorOptions& options) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes, const RenderSettings& renderSettings, gsl::not_null<IRenderData*> pData, bool usingSoftFont, bool isSettingDefaultBrushes) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo) noexcept = 0;
@@ -104,6 +155,7 @@ namespace Microsoft::Console::Render
         virtual [[nodiscard]] Types::Viewport GetViewportInCharacters(const Types::Viewport& viewInPixels) const noexcept { return Types::Viewport::Empty(); }
         virtual [[nodiscard]] Types::Viewport GetViewportInPixels(const Types::Viewport& viewInCharacters) const noexcept { return Types::Viewport::Empty(); }
         // DxRenderer - setter
+        virtual void ReleaseResources() noexcept {}
         virtual void SetAntialiasingMode(const D2D1_TEXT_ANTIALIAS_MODE antialiasingMode) noexcept {}
         virtual void SetCallback(std::function<void()> pfn) noexcept {}
         virtual void EnableTransparentBackground(const bool isTransparent) noexcept {}
@@ -113,6 +165,7 @@ namespace Microsoft::Console::Render
         virtual void SetRetroTerminalEffect(bool enable) noexcept {}
         virtual void SetSelectionBackground(const COLORREF color, const float alpha = 0.5f) noexcept {}
         virtual void SetSoftwareRendering(bool enable) noexcept {}
+        virtual void SetSubRowScrollOffset(const float rows) noexcept {}
         virtual void SetWarningCallback(std::function<void(HRESULT)> pfn) noexcept {}
         virtual [[nodiscard]] HRESULT SetWindowSize(const til::size pixels) noexcept { return E_NOTIMPL; }
         virtual void ToggleShaderEffects() noexcept {}
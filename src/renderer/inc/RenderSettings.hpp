@@ -28,6 +28,11 @@ namespace Microsoft::Console::Render
             ScreenReversed
         };
 
+        // The indices GetAttributeColorIndices() returns for the default colors. They're placed
+        // past the end of the color table, since the entries they refer to depend on the aliases.
+        static constexpr size_t DefaultForegroundIndex = TextColor::TABLE_SIZE;
+        static constexpr size_t DefaultBackgroundIndex = TextColor::TABLE_SIZE + 1;
+
         RenderSettings() noexcept;
         void SetRenderMode(const Mode mode, const bool enabled) noexcept;
         bool GetRenderMode(const Mode mode) const noexcept;
@@ -42,13 +47,27 @@ namespace Microsoft::Console::Render
         size_t GetColorAliasIndex(const ColorAlias alias) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColorsWithAlpha(const TextAttribute& attr) const noexcept;
+        std::pair<std::optional<size_t>, std::optional<size_t>> GetAttributeColorIndices(const TextAttribute& attr) const noexcept;
         void ToggleBlinkRendition(class Renderer& renderer) noexcept;
 
     private:
+        COLORREF _GetPerceivableColor(const COLORREF fg, const COLORREF bg) const noexcept;
+
+        // A 2-way set associative LRU cache of ColorFix::GetPerceivableColor results
+        // for the color pairs that _adjustedForegroundColors doesn't cover.
+        struct PerceivableColorCacheEntry
+        {
+            COLORREF fg = 0;
+            COLORREF bg = 0;
+            COLORREF result = 0;
+        };
+        static constexpr size_t PerceivableColorCacheSetsLog2 = 8;
+
         til::enumset<Mode> _renderMode{ Mode::BlinkAllowed, Mode::IntenseIsBright };
         std::array<COLORREF, TextColor::TABLE_SIZE> _colorTable;
         std::array<size_t, static_cast<size_t>(ColorAlias::ENUM_COUNT)> _colorAliasIndices;
         std::array<std::array<COLORREF, 19>, 19> _adjustedForegroundColors;
+        mutable std::array<std::array<PerceivableColorCacheEntry, 2>, size_t{ 1 } << PerceivableColorCacheSetsLog2> _perceivableColorCache{};
         size_t _blinkCycle = 0;
         mutable bool _blinkIsInUse = false;
         bool _blinkShouldBeFaint = false;
@@ -13,7 +13,11 @@ using namespace Microsoft::Console::Types;
 // Routine Description:
 // - Constructs a UIA engine for console text
 //   which primarily notifies automation clients of any activity
-UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
+// Arguments:
+// - dispatcher - receives the events we raise
+// - notificationInterval - the events and output of all frames within this
+//   interval are merged, so that streaming output doesn't flood automation clients
+UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher, const std::chrono::milliseconds notificationInterval) :
     _dispatcher{ THROW_HR_IF_NULL(E_INVALIDARG, dispatcher) },
     _isPainting{ false },
     _selectionChanged{ false },
@@ -24,6 +28,9 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     _prevCursorRegion{},
     RenderEngineBase()
 {
+    _notify = std::make_unique<til::throttled_func_trailing<>>(notificationInterval, [this]() {
+        _FlushNotifications();
+    });
 }
 
 // Routine Description:
@@ -50,6 +57,18 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     return S_OK;
 }
 
+// Routine Description:
+// - Suspends or resumes presentation. Unlike Disable() this is independent
+//   of the focus and the new output isn't even collected while suspended.
+// Arguments:
+// - suspended - whether to suspend presentation
+// Return Value:
+// - <none>
+void UiaEngine::Suspend(const bool suspended) noexcept
+{
+    _isSuspended.store(suspended, std::memory_order_relaxed);
+}
+
 // Routine Description:
 // - Notifies us that the console has changed the character region specified.
 // - NOTE: This typically triggers on cursor or text buffer changes
@@ -171,7 +190,7 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT UiaEngine::NotifyNewText(const std::wstring_view newText) noexcept
 try
 {
-    if (!newText.empty())
+    if (!newText.empty() && !_isSuspended.load(std::memory_order_relaxed))
     {
         _newOutput.append(newText);
         _newOutput.push_back(L'\n');
@@ -202,7 +221,7 @@ CATCH_LOG_RETURN_HR(E_FAIL);
 // - S_OK if we started to paint. S_FALSE if we didn't need to paint.
 [[nodiscard]] HRESULT UiaEngine::StartPaint() noexcept
 {
-    RETURN_HR_IF(S_FALSE, !_isEnabled);
+    RETURN_HR_IF(S_FALSE, !_isEnabled || _isSuspended.load(std::memory_order_relaxed));
 
     // add more events here
     const auto somethingToDo = _selectionChanged || _textBufferChanged || _cursorChanged || !_queuedOutput.empty();
@@ -244,17 +263,57 @@ void UiaEngine::WaitUntilCanRender() noexcept
 // Routine Description:
 // - Used to perform longer running presentation steps outside the lock so the
 //      other threads can continue.
-// - Not currently used by UiaEngine.
+// - Merges this frame's events and output into the pending notification,
+//   which _FlushNotifications() dispatches once the notification interval expired.
 // Arguments:
 // - <none>
 // Return Value:
-// - S_FALSE since we do nothing.
+// - S_OK
 [[nodiscard]] HRESULT UiaEngine::Present() noexcept
 {
     RETURN_HR_IF(S_FALSE, !_isEnabled);
 
+    try
+    {
+        {
+            const std::lock_guard lock{ _pendingLock };
+            _pending.selectionChanged |= _selectionChanged;
+            _pending.textBufferChanged |= _textBufferChanged;
+            // Intermediate cursor positions are of no interest, since
+            // clients query the cursor's location once they're signaled.
+            _pending.cursorChanged |= _cursorChanged;
+            _pending.output.append(_queuedOutput);
+        }
+        (*_notify)();
+    }
+    CATCH_LOG();
+
+    _selectionChanged = false;
+    _textBufferChanged = false;
+    _cursorChanged = false;
+    _isPainting = false;
+    _queuedOutput.clear();
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Dispatches the events and output Present() collected since the last notification.
+//   Called on the threadpool at most once per notification interval.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void UiaEngine::_FlushNotifications() noexcept
+{
+    PendingNotifications pending;
+    {
+        const std::lock_guard lock{ _pendingLock };
+        pending = std::exchange(_pending, {});
+    }
+
     // Fire UIA Events here
-    if (_selectionChanged)
+    if (pending.selectionChanged)
     {
         try
         {
@@ -262,7 +321,7 @@ void UiaEngine::WaitUntilCanRender() noexcept
         }
         CATCH_LOG();
     }
-    if (_textBufferChanged)
+    if (pending.textBufferChanged)
     {
         try
         {
@@ -270,7 +329,7 @@ void UiaEngine::WaitUntilCanRender() noexcept
         }
         CATCH_LOG();
     }
-    if (_cursorChanged)
+    if (pending.cursorChanged)
     {
         try
         {
@@ -284,21 +343,13 @@ void UiaEngine::WaitUntilCanRender() noexcept
         // Break up the output into 1000 character chunks to ensure
         // the output isn't cut off.
         static constexpr size_t sapiLimit{ 1000 };
-        const std::wstring_view output{ _queuedOutput };
+        const std::wstring_view output{ pending.output };
         for (size_t offset = 0; offset < output.size(); offset += sapiLimit)
         {
             _dispatcher->NotifyNewOutput(output.substr(offset, sapiLimit));
         }
     }
     CATCH_LOG();
-
-    _selectionChanged = false;
-    _textBufferChanged = false;
-    _cursorChanged = false;
-    _isPainting = false;
-    _queuedOutput.clear();
-
-    return S_OK;
 }
 
 // Routine Description:
@@ -17,6 +17,8 @@ Author(s):
 
 #include "../../renderer/inc/RenderEngineBase.hpp"
 
+#include <til/throttled_func.h>
+
 #include "../../types/IUiaEventDispatcher.h"
 #include "../../types/inc/Viewport.hpp"
 
@@ -25,7 +27,11 @@ namespace Microsoft::Console::Render
     class UiaEngine final : public RenderEngineBase
     {
     public:
-        UiaEngine(Microsoft::Console::Types::IUiaEventDispatcher* dispatcher);
+        // Present() raises events and announces new output at most once per notificationInterval.
+        static constexpr std::chrono::milliseconds DefaultNotificationInterval{ 100 };
+
+        UiaEngine(Microsoft::Console::Types::IUiaEventDispatcher* dispatcher,
+                  const std::chrono::milliseconds notificationInterval = DefaultNotificationInterval);
 
         // Only one UiaEngine may present information at a time.
         // This ensures that an automation client isn't overwhelmed
@@ -33,6 +39,10 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT Enable() noexcept override;
         [[nodiscard]] HRESULT Disable() noexcept;
 
+        // While suspended, e.g. while the output is flooding, nothing is announced.
+        // The changes made in the meantime are announced once it's resumed.
+        void Suspend(const bool suspended) noexcept;
+
         // IRenderEngine Members
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
@@ -66,6 +76,7 @@ namespace Microsoft::Console::Render
 
     private:
         bool _isEnabled;
+        std::atomic<bool> _isSuspended{ false };
         bool _isPainting;
         bool _selectionChanged;
         bool _textBufferChanged;
@@ -77,5 +88,22 @@ namespace Microsoft::Console::Render
 
         std::vector<til::rect> _prevSelection;
         til::rect _prevCursorRegion;
+
+        // The events and output of all frames since the last notification.
+        // Present() adds to them and _FlushNotifications() dispatches them.
+        struct PendingNotifications
+        {
+            bool selectionChanged = false;
+            bool textBufferChanged = false;
+            bool cursorChanged = false;
+            std::wstring output;
+        };
+        std::mutex _pendingLock;
+        PendingNotifications _pending;
+
+        void _FlushNotifications() noexcept;
+
+        // Declared last, so that it's destroyed (and any pending callback canceled) first.
+        std::unique_ptr<til::throttled_func_trailing<>> _notify;
     };
 }
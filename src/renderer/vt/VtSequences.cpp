@@ -106,6 +106,7 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_ClearScreen() noexcept
 {
+    _InvalidateShadowFrame();
     return _Write("\x1b[2J");
 }
 
@@ -160,6 +161,53 @@ using namespace Microsoft::Console::Render;
     return _InsertDeleteLine(sLines, true);
 }
 
+// Method Description:
+// - Formats and writes a sequence to scroll the contents of the scroll
+//      margins up (SU) or down (SD) by a number of lines.
+// Arguments:
+// - sLines: a number of lines to scroll
+// - fScrollUp: true iff we should scroll up, false to scroll down.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT VtEngine::_ScrollUpDown(const til::CoordType sLines, const bool fScrollUp) noexcept
+{
+    if (sLines <= 0)
+    {
+        return S_OK;
+    }
+    if (sLines == 1)
+    {
+        return _Write(fScrollUp ? "\x1b[S" : "\x1b[T");
+    }
+
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}{}"), sLines, fScrollUp ? 'S' : 'T');
+}
+
+// Method Description:
+// - Formats and writes a sequence to set the top and bottom scroll margins
+//      (DECSTBM). This also moves the cursor to the home position.
+// Arguments:
+// - top: the first row inside of the margins, where origin=0.
+// - bottom: the row below the last row inside of the margins.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT VtEngine::_SetTopBottomMargins(const til::CoordType top, const til::CoordType bottom) noexcept
+{
+    return _WriteFormatted(FMT_COMPILE("\x1b[{};{}r"), top + 1, bottom);
+}
+
+// Method Description:
+// - Writes a sequence to reset the scroll margins to the whole screen (DECSTBM).
+//      This also moves the cursor to the home position.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT VtEngine::_ResetTopBottomMargins() noexcept
+{
+    return _Write("\x1b[r");
+}
+
 // Method Description:
 // - Formats and writes a sequence to move the cursor to the specified
 //      coordinate position. The input coord should be in console coordinates,
@@ -447,6 +495,7 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_SwitchScreenBuffer(const bool useAltBuffer) noexcept
 {
+    _InvalidateShadowFrame();
     return _Write(useAltBuffer ? "\x1b[?1049h" : "\x1b[?1049l");
 }
 
@@ -351,6 +351,9 @@ try
 {
     _trace.TraceScrollFrame(_scrollDelta);
 
+    // Rows that moved inside of the scroll margins moved before anything else.
+    RETURN_IF_FAILED(_ScrollRegionFrame());
+
     if (_scrollDelta.x != 0)
     {
         // No easy way to shift left-right. Everything needs repainting.
@@ -398,6 +401,8 @@ try
         RETURN_IF_FAILED(_InsertLine(absDy));
     }
 
+    _ScrollShadowFrame(dy, 0, _lastViewport.Height());
+
     // Restore our wrap state.
     _wrappedRow = oldWrappedRow;
     _delayedEolWrap = oldDelayedEolWrap;
@@ -461,6 +466,101 @@ try
 }
 CATCH_RETURN();
 
+// Routine Description:
+// - Moves the rows that scrolled inside of the scroll margins this frame, by
+//      temporarily setting the terminal's margins to them and scrolling them
+//      with SU/SD. The revealed rows were marked invalid by
+//      InvalidateScrollRegion, so they will later be written by PaintBufferLine.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT XtermEngine::_ScrollRegionFrame() noexcept
+{
+    if (_scrollRegionDelta == 0)
+    {
+        return S_OK;
+    }
+
+    RETURN_IF_FAILED(_SetTopBottomMargins(_scrollRegion.top, _scrollRegion.bottom));
+    RETURN_IF_FAILED(_ScrollUpDown(std::abs(_scrollRegionDelta), _scrollRegionDelta < 0));
+    RETURN_IF_FAILED(_ResetTopBottomMargins());
+
+    _ScrollShadowFrame(_scrollRegionDelta, _scrollRegion.top, _scrollRegion.bottom);
+
+    // Setting the margins moved the cursor home. This also cancels any
+    // delayed wrap, so we need to move the cursor explicitly from now on.
+    _lastText = { 0, 0 };
+    _trace.TraceLastText(_lastText);
+    _wrappedRow = std::nullopt;
+    _delayedEolWrap = false;
+    _scrollRegionDelta = 0;
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Notifies us that the console moved the rows of the given region, as
+//      applications like vim or tmux do it inside of their scroll margins.
+//      Instead of repainting all the rows, ScrollFrame will move them.
+//      The rows below and above the region are left untouched.
+// Arguments:
+// - region - the viewport-relative rows that moved. Spans the whole width.
+// - delta - the number of rows the contents moved down. Negative if they moved up.
+// Return Value:
+// - S_OK if we'll move the rows, S_FALSE if they need to be invalidated instead.
+[[nodiscard]] HRESULT XtermEngine::InvalidateScrollRegion(const til::rect& region, const til::CoordType delta) noexcept
+try
+{
+    if (delta == 0 || _synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
+    // We can only move whole rows and only one region per frame. Once the whole
+    // viewport scrolled this frame, ScrollFrame would move the rows in the wrong order.
+    const auto viewport = _lastViewport.ToOrigin().ToExclusive();
+    if (region.left != viewport.left || region.right != viewport.right ||
+        region.top < viewport.top || region.bottom > viewport.bottom ||
+        std::abs(delta) >= region.height() ||
+        _scrollDelta != til::point{ 0, 0 } ||
+        (_scrollRegionDelta != 0 && (region != _scrollRegion || (delta < 0) != (_scrollRegionDelta < 0))))
+    {
+        return S_FALSE;
+    }
+
+    // Rows that were invalid before move along with the contents.
+    const til::rect above{ viewport.left, viewport.top, viewport.right, region.top };
+    const til::rect below{ viewport.left, region.bottom, viewport.right, viewport.bottom };
+    til::pmr::bitmap invalidMap{ _invalidMap.size(), false, &_pool };
+    for (const auto run : _invalidMap)
+    {
+        invalidMap.set(run & above);
+        invalidMap.set(run & below);
+
+        if (const auto inside = run & region; !inside.empty())
+        {
+            invalidMap.set((inside + til::point{ 0, delta }) & region);
+        }
+    }
+
+    // And the revealed rows need to be painted anew.
+    if (delta < 0)
+    {
+        invalidMap.set({ region.left, region.bottom + delta, region.right, region.bottom });
+    }
+    else
+    {
+        invalidMap.set({ region.left, region.top, region.right, region.top + delta });
+    }
+
+    _invalidMap.swap(invalidMap);
+    _scrollRegion = region;
+    _scrollRegionDelta += delta;
+    return S_OK;
+}
+CATCH_RETURN();
+
 // Routine Description:
 // - Notifies us that the console is attempting to scroll the existing screen
 //      area. Add the top or bottom rows to the invalid region, and update the
@@ -475,7 +575,7 @@ try
 {
     const auto delta{ *pcoordDelta };
 
-    if (delta != til::point{ 0, 0 })
+    if (delta != til::point{ 0, 0 } && !_synchronizingBuffer)
     {
         _trace.TraceInvalidateScroll(delta);
 
@@ -523,6 +623,9 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr) noexcept
 {
+    // We don't know what this string is going to do to the terminal's contents.
+    _InvalidateShadowFrame();
+
     RETURN_IF_FAILED(_fUseAsciiOnly ?
                          VtEngine::_WriteTerminalAscii(wstr) :
                          VtEngine::_WriteTerminalUtf8(wstr));
@@ -49,6 +49,11 @@ using namespace Microsoft::Console::Render;
 [[nodiscard]] HRESULT VtEngine::Invalidate(const til::rect* const psrRegion) noexcept
 try
 {
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
     _trace.TraceInvalidate(*psrRegion);
     _invalidMap.set(*psrRegion);
     return S_OK;
@@ -63,6 +68,11 @@ CATCH_RETURN();
 // - S_OK
 [[nodiscard]] HRESULT VtEngine::InvalidateCursor(const til::rect* const psrRegion) noexcept
 {
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
     // If we just inherited the cursor, we're going to get an InvalidateCursor
     //      for both where the old cursor was, and where the new cursor is
     //      (the inherited location). (See Cursor.cpp:Cursor::SetPosition)
@@ -90,6 +100,11 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::InvalidateAll() noexcept
 try
 {
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
     _trace.TraceInvalidateAll(_lastViewport.ToOrigin().ToExclusive());
     _invalidMap.set_all();
     return S_OK;
@@ -107,7 +122,8 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept
 {
     // If we're in the middle of a resize request, don't try to immediately start a frame.
-    if (_inResizeRequest)
+    // The same goes for the replay of the client's output in passthrough mode.
+    if (_inResizeRequest || _synchronizingBuffer)
     {
         *pForcePaint = false;
     }
@@ -125,6 +141,23 @@ CATCH_RETURN();
     return S_OK;
 }
 
+// Method Description:
+// - Notifies us that the console has changed its title. While passthrough mode
+//   replays the client's output into our buffer, the terminal already knows it.
+// Arguments:
+// - proposedTitle - the new title of the console
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT VtEngine::InvalidateTitle(const std::wstring_view proposedTitle) noexcept
+{
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
+    return RenderEngineBase::InvalidateTitle(proposedTitle);
+}
+
 // Method Description:
 // - Notifies us that we're about to be torn down. This gives us a last chance
 //      to force a repaint before the buffer contents are lost. The VT renderer
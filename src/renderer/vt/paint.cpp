@@ -25,13 +25,24 @@ using namespace Microsoft::Console::Types;
         return S_FALSE;
     }
 
+    // We're waiting for the terminal's cursor position (see VtIo::StartIfNeeded).
+    // EndPaint() isn't called for this frame, which keeps the invalid regions
+    // around until we're allowed to paint again.
+    if (_awaitingInheritedCursor)
+    {
+        return S_FALSE;
+    }
+
     // If there's nothing to do, quick return
     auto somethingToDo = _invalidMap.any() ||
                          _scrollDelta != til::point{ 0, 0 } ||
+                         _scrollRegionDelta != 0 ||
                          _cursorMoved ||
                          _titleChanged;
 
     _quickReturn = !somethingToDo;
+    // Hold off on flushing until EndPaint, so that the frame is written in one go.
+    _inFrame = somethingToDo;
     _trace.TraceStartPaint(_quickReturn,
                            _invalidMap,
                            _lastViewport.ToExclusive(),
@@ -55,9 +66,11 @@ using namespace Microsoft::Console::Types;
 {
     _trace.TraceEndPaint();
 
+    _inFrame = false;
     _invalidMap.reset_all();
 
     _scrollDelta = { 0, 0 };
+    _scrollRegionDelta = 0;
     _clearedAllThisFrame = false;
     _cursorMoved = false;
     _firstPaint = false;
@@ -356,6 +369,7 @@ using namespace Microsoft::Console::Types;
         }
 
         RETURN_IF_FAILED(VtEngine::_WriteTerminalAscii(_bufferLine));
+        _ForgetShadowCells(coord, totalWidth);
 
         // Update our internal tracker of the cursor's position
         _lastText.X += totalWidth;
@@ -382,6 +396,70 @@ using namespace Microsoft::Console::Types;
         return S_OK;
     }
 
+    // Only paint the clusters the terminal doesn't already display. Unchanged
+    // clusters at the start and end of the run are always skipped, while those
+    // in between are only skipped if moving the cursor across them is shorter.
+    // Each remaining part of the run is painted by calling ourselves again, which
+    // ends up here with the whole run having to be painted.
+    if (!_passthrough && !_shadowFrame.empty())
+    {
+        // If the previous line wrapped, the terminal places the first cluster of this line
+        // right after it. If this line wraps, its last cluster puts the terminal into that state.
+        const auto firstRequired = coord.X == 0 && _wrappedRow.has_value() && coord.Y == _wrappedRow.value() + 1;
+        const auto lastRequired = lineWrapped;
+
+        size_t runBegin = 0;
+        size_t runEnd = 0;
+        til::CoordType runX = 0;
+        auto hasRun = false;
+        auto column = coord.X;
+        til::CoordType shadowedColumns = 0;
+
+        const auto paintRun = [&]() {
+            const auto last = runEnd == clusters.size();
+            return _PaintUtf8BufferLine(clusters.subspan(runBegin, runEnd - runBegin), { runX, coord.Y }, lineWrapped && last);
+        };
+
+        for (size_t i = 0; i < clusters.size(); ++i)
+        {
+            const auto& cluster = til::at(clusters, i);
+            const auto required = (i == 0 && firstRequired) || (i == clusters.size() - 1 && lastRequired);
+
+            if (!required && _IsShadowedCluster(cluster, { column, coord.Y }))
+            {
+                shadowedColumns += cluster.GetColumns();
+            }
+            else
+            {
+                if (!hasRun)
+                {
+                    hasRun = true;
+                    runBegin = i;
+                    runX = column;
+                }
+                else if (shadowedColumns > CURSOR_FORWARD_STRING_LENGTH)
+                {
+                    RETURN_IF_FAILED(paintRun());
+                    runBegin = i;
+                    runX = column;
+                }
+                runEnd = i + 1;
+                shadowedColumns = 0;
+            }
+
+            column += cluster.GetColumns();
+        }
+
+        if (!hasRun)
+        {
+            return S_OK;
+        }
+        if (runBegin != 0 || runEnd != clusters.size())
+        {
+            return paintRun();
+        }
+    }
+
     _bufferLine.clear();
     _bufferLine.reserve(clusters.size());
     til::CoordType totalWidth = 0;
@@ -463,6 +541,12 @@ using namespace Microsoft::Console::Types;
                                    (totalWidth - numSpaces) :
                                    totalWidth;
 
+    // Whether the terminal is going to display the spaces at the end of this run
+    // with our current attributes, even if we don't actually write them.
+    auto spacesDisplayed = !removeSpaces ||
+                           useEraseChar ||
+                           (_clearedAllThisFrame && _lastTextAttributes == defaultAttrs);
+
     if (cchActual == 0)
     {
         // If the previous row wrapped, but this line is empty, then we actually
@@ -564,9 +648,20 @@ using namespace Microsoft::Console::Types;
             RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8(spaces));
 
             _lastText.X += numSpaces;
+            spacesDisplayed = true;
         }
     }
 
+    if (spacesDisplayed)
+    {
+        _UpdateShadowFrame(clusters, coord, totalWidth);
+    }
+    else
+    {
+        _UpdateShadowFrame(clusters, coord, columnsActual);
+        _ForgetShadowCells({ coord.X + columnsActual, coord.Y }, totalWidth - columnsActual);
+    }
+
     // If we printed to the bottom line, and we previously thought that this was
     // a new bottom line, it certainly isn't new any longer.
     if (printingBottomLine)
@@ -591,3 +686,179 @@ using namespace Microsoft::Console::Types;
 {
     return S_OK;
 }
+
+// Method Description:
+// - Resizes the shadow frame to the given size of the viewport.
+//   We don't know anything about the terminal's contents afterwards.
+// Arguments:
+// - size - the new size of the viewport
+void VtEngine::_ResizeShadowFrame(const til::size size) noexcept
+try
+{
+    _shadowFrame.clear();
+    _shadowFrame.resize(gsl::narrow<size_t>(size.area()));
+}
+catch (...)
+{
+    // Without a shadow frame we simply paint everything we're asked to.
+    LOG_CAUGHT_EXCEPTION();
+    _shadowFrame.clear();
+}
+
+// Method Description:
+// - Forgets all we know about the terminal's contents.
+void VtEngine::_InvalidateShadowFrame() noexcept
+{
+    std::fill(_shadowFrame.begin(), _shadowFrame.end(), ShadowCell{});
+}
+
+// Method Description:
+// - Scrolls the shadow frame along with the terminal's contents.
+// Arguments:
+// - delta - the number of rows the contents moved down. Negative if they moved up.
+// - top, bottom - the range of rows [top, bottom) that moved.
+void VtEngine::_ScrollShadowFrame(const til::CoordType delta, const til::CoordType top, const til::CoordType bottom) noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(_lastViewport.Width());
+    const auto height = gsl::narrow_cast<size_t>(_lastViewport.Height());
+    const auto rows = gsl::narrow_cast<size_t>(std::abs(delta));
+
+    if (_shadowFrame.size() != width * height || top < 0 || bottom > _lastViewport.Height() || rows >= gsl::narrow_cast<size_t>(std::max(0, bottom - top)))
+    {
+        _InvalidateShadowFrame();
+        return;
+    }
+
+    const auto begin = _shadowFrame.begin() + gsl::narrow_cast<ptrdiff_t>(top * width);
+    const auto end = _shadowFrame.begin() + gsl::narrow_cast<ptrdiff_t>(bottom * width);
+    const auto offset = gsl::narrow_cast<ptrdiff_t>(rows * width);
+    if (delta < 0)
+    {
+        std::move(begin + offset, end, begin);
+        std::fill(end - offset, end, ShadowCell{});
+    }
+    else
+    {
+        std::move_backward(begin, end - offset, end);
+        std::fill(begin, begin + offset, ShadowCell{});
+    }
+}
+
+// Method Description:
+// - Returns the shadow of the given cell of the viewport.
+// Arguments:
+// - coord - the viewport-relative position of the cell
+// Return Value:
+// - the cell, or nullptr if it's outside of the shadow frame
+VtEngine::ShadowCell* VtEngine::_GetShadowCell(const til::point coord) noexcept
+{
+    const auto width = _lastViewport.Width();
+    const auto height = _lastViewport.Height();
+    if (coord.X < 0 || coord.Y < 0 || coord.X >= width || coord.Y >= height ||
+        _shadowFrame.size() != gsl::narrow_cast<size_t>(width) * gsl::narrow_cast<size_t>(height))
+    {
+        return nullptr;
+    }
+    return &til::at(_shadowFrame, gsl::narrow_cast<size_t>(coord.Y) * gsl::narrow_cast<size_t>(width) + gsl::narrow_cast<size_t>(coord.X));
+}
+
+// Method Description:
+// - Checks whether the terminal already displays the given cluster
+//   at the given position with our current attributes.
+// Arguments:
+// - cluster - the cluster we're asked to paint
+// - coord - the viewport-relative position of the cluster
+// Return Value:
+// - true if we don't need to paint the cluster
+bool VtEngine::_IsShadowedCluster(const Cluster& cluster, const til::point coord) noexcept
+{
+    const auto text = cluster.GetText();
+    const auto columns = cluster.GetColumns();
+    if (text.size() > 2 || columns < 1 || columns > 2)
+    {
+        return false;
+    }
+
+    const auto cell = _GetShadowCell(coord);
+    if (!cell || cell->columns != columns || cell->length != text.size() ||
+        !std::equal(text.begin(), text.end(), cell->text.begin()) ||
+        cell->attributes != _lastTextAttributes)
+    {
+        return false;
+    }
+
+    if (columns == 2)
+    {
+        const auto trailer = _GetShadowCell({ coord.X + 1, coord.Y });
+        return trailer && trailer->columns == 2 && trailer->length == 0 && trailer->attributes == _lastTextAttributes;
+    }
+
+    return true;
+}
+
+// Method Description:
+// - Remembers that the terminal now displays the given clusters with our current attributes.
+//   Any columns beyond the clusters are filled with spaces.
+// Arguments:
+// - clusters - the clusters we just painted
+// - coord - the viewport-relative position of the first cluster
+// - columns - the number of columns we painted
+void VtEngine::_UpdateShadowFrame(const gsl::span<const Cluster> clusters, const til::point coord, const til::CoordType columns) noexcept
+{
+    static constexpr Cluster space{ L" ", 1 };
+
+    auto x = coord.X;
+    const auto end = coord.X + columns;
+    auto it = clusters.begin();
+
+    while (x < end)
+    {
+        const auto& cluster = it != clusters.end() ? *it++ : space;
+        const auto text = cluster.GetText();
+        const auto width = std::max(cluster.GetColumns(), 1);
+        const auto cell = _GetShadowCell({ x, coord.Y });
+
+        if (cell)
+        {
+            if (text.size() > 2 || width > 2 || x + width > end)
+            {
+                *cell = {};
+            }
+            else
+            {
+                std::copy(text.begin(), text.end(), cell->text.begin());
+                cell->length = gsl::narrow_cast<uint8_t>(text.size());
+                cell->columns = gsl::narrow_cast<uint8_t>(width);
+                cell->attributes = _lastTextAttributes;
+
+                if (width == 2)
+                {
+                    if (const auto trailer = _GetShadowCell({ x + 1, coord.Y }))
+                    {
+                        *trailer = {};
+                        trailer->columns = 2;
+                        trailer->attributes = _lastTextAttributes;
+                    }
+                }
+            }
+        }
+
+        x += width;
+    }
+}
+
+// Method Description:
+// - Forgets what the terminal displays in the given cells.
+// Arguments:
+// - coord - the viewport-relative position of the first cell
+// - columns - the number of cells
+void VtEngine::_ForgetShadowCells(const til::point coord, const til::CoordType columns) noexcept
+{
+    for (auto x = coord.X; x < coord.X + columns; ++x)
+    {
+        if (const auto cell = _GetShadowCell({ x, coord.Y }))
+        {
+            *cell = {};
+        }
+    }
+}
@@ -34,6 +34,7 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     _pool(til::pmr::get_default_resource()),
     _invalidMap(initialViewport.Dimensions(), false, &_pool),
     _scrollDelta(0, 0),
+    _scrollRegionDelta(0),
     _quickReturn(false),
     _clearedAllThisFrame(false),
     _cursorMoved(false),
@@ -65,11 +66,21 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 #endif
 }
 
+VtEngine::~VtEngine()
+{
+    _StopWriterThread();
+}
+
 // Method Description:
 // - Writes a fill of characters to our file handle (repeat of same character over and over)
 [[nodiscard]] HRESULT VtEngine::_WriteFill(const size_t n, const char c) noexcept
 try
 {
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
     _trace.TraceStringFill(n, c);
 #ifdef UNIT_TESTING
     if (_usingTestCallback)
@@ -106,6 +117,11 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::_Write(std::string_view const str) noexcept
 {
+    if (_synchronizingBuffer)
+    {
+        return S_OK;
+    }
+
     _trace.TraceString(str);
 #ifdef UNIT_TESTING
     if (_usingTestCallback)
@@ -134,6 +150,17 @@ CATCH_RETURN();
     CATCH_RETURN();
 }
 
+// Method Description:
+// - Hands everything we've written so far to the writer thread, which sends it
+//      to the terminal. While we're painting a frame this does nothing: the
+//      whole frame is flushed at once in EndPaint, so mid-frame requests don't
+//      split it up into several writes.
+// - This only blocks if the writer thread is more than MAX_PENDING_WRITE_SIZE
+//      behind, which means the terminal isn't keeping up with us.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK, or the error with which writing to the pipe failed.
 [[nodiscard]] HRESULT VtEngine::_Flush() noexcept
 {
 #ifdef UNIT_TESTING
@@ -144,29 +171,164 @@ CATCH_RETURN();
     }
 #endif
 
-    if (!_pipeBroken)
+    if (_pipeBroken || _inFrame || _buffer.empty())
+    {
+        return S_OK;
+    }
+
+    if (!_writerThread)
+    {
+        RETURN_IF_FAILED(_StartWriterThread());
+    }
+
+    auto hr = S_OK;
     {
-        auto fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
-        _buffer.clear();
-        if (!fSuccess)
+        std::unique_lock lock{ _writerMutex };
+        _writerCondition.wait(lock, [&]() noexcept {
+            return _writerBuffer.size() < MAX_PENDING_WRITE_SIZE || FAILED(_writerResult);
+        });
+
+        hr = _writerResult;
+        if (SUCCEEDED(hr))
         {
-            _exitResult = HRESULT_FROM_WIN32(GetLastError());
-            _pipeBroken = true;
-            if (_terminalOwner)
+            if (_writerBuffer.empty())
             {
-                _terminalOwner->CloseOutput();
+                // The writer thread is done with its last buffer, so we might as
+                // well give it ours and take its (now empty) allocation in return.
+                _writerBuffer.swap(_buffer);
+            }
+            else
+            {
+                try
+                {
+                    _writerBuffer.append(_buffer);
+                }
+                CATCH_RETURN();
             }
-            return _exitResult;
         }
     }
+    _buffer.clear();
 
+    if (FAILED(hr))
+    {
+        _exitResult = hr;
+        _pipeBroken = true;
+        if (_terminalOwner)
+        {
+            _terminalOwner->CloseOutput();
+        }
+        return _exitResult;
+    }
+
+    _writerCondition.notify_all();
+    return S_OK;
+}
+
+// Method Description:
+// - Starts the thread that writes our output to the pipe.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK, or an appropriate HRESULT if the thread couldn't be created.
+[[nodiscard]] HRESULT VtEngine::_StartWriterThread() noexcept
+{
+    _writerThread.reset(CreateThread(nullptr, 0, VtEngine::s_WriterThreadProc, this, 0, nullptr));
+    RETURN_LAST_ERROR_IF(!_writerThread);
+    LOG_IF_FAILED(SetThreadDescription(_writerThread.get(), L"ConPTY Output Writer Thread"));
     return S_OK;
 }
 
+// Method Description:
+// - Stops the writer thread, after it's written what's still pending. If the
+//      terminal doesn't read that within a second, we give up on it.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_StopWriterThread() noexcept
+{
+    if (!_writerThread)
+    {
+        return;
+    }
+
+    {
+        const std::lock_guard lock{ _writerMutex };
+        _writerShutdown = true;
+    }
+    _writerCondition.notify_all();
+
+    if (WaitForSingleObject(_writerThread.get(), 1000) != WAIT_OBJECT_0)
+    {
+        // CancelSynchronousIo fails if the thread isn't in a WriteFile call at the
+        // moment. In that case it's just about to exit or to start one, so we try again.
+        while (!CancelSynchronousIo(_writerThread.get()) && WaitForSingleObject(_writerThread.get(), 10) != WAIT_OBJECT_0)
+        {
+        }
+        WaitForSingleObject(_writerThread.get(), INFINITE);
+    }
+
+    _writerThread.reset();
+}
+
+DWORD WINAPI VtEngine::s_WriterThreadProc(_In_ LPVOID lpParameter) noexcept
+{
+    const auto pEngine = static_cast<VtEngine*>(lpParameter);
+    pEngine->_WriterThread();
+    return 0;
+}
+
+// Method Description:
+// - The body of the writer thread. Writes whatever _Flush handed us to the pipe
+//      until we're told to shut down or the pipe breaks. In the latter case the
+//      error is reported to the next _Flush.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_WriterThread() noexcept
+{
+    std::string buffer;
+
+    for (;;)
+    {
+        {
+            std::unique_lock lock{ _writerMutex };
+            _writerCondition.wait(lock, [&]() noexcept {
+                return !_writerBuffer.empty() || _writerShutdown;
+            });
+
+            if (_writerBuffer.empty())
+            {
+                return;
+            }
+
+            buffer.clear();
+            buffer.swap(_writerBuffer);
+        }
+        // _Flush might be waiting for us to make room.
+        _writerCondition.notify_all();
+
+        if (!WriteFile(_hFile.get(), buffer.data(), gsl::narrow_cast<DWORD>(buffer.size()), nullptr, nullptr))
+        {
+            const auto hr = HRESULT_FROM_WIN32(GetLastError());
+            {
+                const std::lock_guard lock{ _writerMutex };
+                _writerResult = hr;
+                _writerBuffer.clear();
+            }
+            _writerCondition.notify_all();
+            return;
+        }
+    }
+}
+
 // Method Description:
 // - Wrapper for _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
 {
+    // We don't know what this is going to do to the terminal's contents.
+    _InvalidateShadowFrame();
     return _Write(str);
 }
 
@@ -280,9 +442,22 @@ CATCH_RETURN();
             }
         }
 
+        // The rows we were going to move might not be where they were anymore.
+        if (_scrollRegionDelta != 0)
+        {
+            _scrollRegionDelta = 0;
+            LOG_IF_FAILED(InvalidateAll());
+        }
+
         _resized = true;
     }
 
+    // The terminal probably reflowed its contents if its size changed.
+    if (oldSize != newSize || _shadowFrame.empty())
+    {
+        _ResizeShadowFrame(newSize);
+    }
+
     // See MSFT:19408543
     // Always clear the suppression request, even if the new size was the same
     //      as the last size. We're always going to get a UpdateViewport call
@@ -388,9 +563,21 @@ bool VtEngine::_AllIsInvalid() const
     _skipCursor = true;
     // Prevent us from clearing the entire viewport on the first paint
     _firstPaint = false;
+    _awaitingInheritedCursor = false;
     return S_OK;
 }
 
+// Method Description:
+// - Holds off painting while we're waiting for the terminal to tell us its
+//   cursor position. Invalidations accumulate in the meantime, so anything
+//   the client wrote is painted as soon as the wait is over.
+// Arguments:
+// - awaiting: true to hold off painting, false to resume.
+void VtEngine::SetAwaitingInheritedCursor(const bool awaiting) noexcept
+{
+    _awaitingInheritedCursor = awaiting;
+}
+
 void VtEngine::SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner)
 {
     _terminalOwner = terminalOwner;
@@ -456,6 +643,47 @@ void VtEngine::EndResizeRequest()
     _inResizeRequest = false;
 }
 
+// Method Description:
+// - Tell the vt renderer that the terminal is in the middle of resizing us, for
+//   instance because the user is dragging the window border. Every resize reflows
+//   the buffer and invalidates it, so instead of repainting the whole buffer for
+//   every intermediate size, WaitUntilCanRender holds off the next frame until
+//   the resizes have settled down. The invalidations accumulate in the meantime.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::SetResizeInProgress() noexcept
+{
+    _resizeInProgressUntil.store(std::chrono::steady_clock::now() + RESIZE_SETTLE_DELAY, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Blocks until the engine is able to render. On top of the default frame
+//   pacing this waits for an ongoing resize to settle. See SetResizeInProgress.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::WaitUntilCanRender() noexcept
+{
+    RenderEngineBase::WaitUntilCanRender();
+
+    // The deadline is pushed back by each resize, but a resize that never
+    // ends mustn't keep the client's output from the terminal forever.
+    const auto start = std::chrono::steady_clock::now();
+    const auto limit = start + RESIZE_MAX_PAINT_DELAY;
+    for (auto now = start;; now = std::chrono::steady_clock::now())
+    {
+        const auto until = std::min(_resizeInProgressUntil.load(std::memory_order_relaxed), limit);
+        if (now >= until)
+        {
+            break;
+        }
+        Sleep(gsl::narrow_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(until - now).count()));
+    }
+}
+
 // Method Description:
 // - Configure the renderer for the resize quirk. This changes the behavior of
 //   conpty to _not_ InvalidateAll the entire viewport on a resize operation.
@@ -485,6 +713,23 @@ void VtEngine::SetPassthroughMode(const bool passthrough) noexcept
     _passthrough = passthrough;
 }
 
+// Method Description:
+// - In passthrough mode the client's output is replayed into the buffer only
+//   when someone reads it back. The terminal already received that output, so
+//   while the replay is going on we ignore all changes to the buffer and don't
+//   write anything to the terminal.
+// Arguments:
+// - synchronizing - True while the buffer is being synchronized. False otherwise.
+void VtEngine::SetSynchronizingBuffer(const bool synchronizing) noexcept
+{
+    _synchronizingBuffer = synchronizing;
+}
+
+bool VtEngine::IsSynchronizingBuffer() const noexcept
+{
+    return _synchronizingBuffer;
+}
+
 void VtEngine::SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept
 {
     _pfnSetLookingForDSR = pfnLooking;
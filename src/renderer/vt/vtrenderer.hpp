@@ -20,6 +20,7 @@ Author(s):
 #include "tracing.hpp"
 #include <string>
 #include <functional>
+#include <condition_variable>
 
 // fwdecl unittest classes
 #ifdef UNIT_TESTING
@@ -42,10 +43,13 @@ namespace Microsoft::Console::Render
     public:
         // See _PaintUtf8BufferLine for explanation of this value.
         static const size_t ERASE_CHARACTER_STRING_LENGTH = 8;
+        // _PaintUtf8BufferLine only skips over unchanged cells if that's shorter than repainting them.
+        static constexpr til::CoordType CURSOR_FORWARD_STRING_LENGTH = 4;
         static const til::point INVALID_COORDS;
 
         VtEngine(_In_ wil::unique_hfile hPipe,
                  const Microsoft::Console::Types::Viewport initialViewport);
+        ~VtEngine() override;
 
         // IRenderEngine
         [[nodiscard]] HRESULT StartPaint() noexcept override;
@@ -58,6 +62,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept override;
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept override;
+        [[nodiscard]] HRESULT InvalidateTitle(const std::wstring_view proposedTitle) noexcept override;
         [[nodiscard]] HRESULT PaintBackground() noexcept override;
         [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> clusters, til::point coord, bool fTrimLeft, bool lineWrapped) noexcept override;
         [[nodiscard]] HRESULT PaintBufferGridLines(GridLineSet lines, COLORREF color, size_t cchLine, til::point coordTarget) noexcept override;
@@ -70,18 +75,23 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT GetDirtyArea(gsl::span<const til::rect>& area) noexcept override;
         [[nodiscard]] HRESULT GetFontSize(_Out_ til::size* pFontSize) noexcept override;
         [[nodiscard]] HRESULT IsGlyphWideByFont(std::wstring_view glyph, _Out_ bool* pResult) noexcept override;
+        void WaitUntilCanRender() noexcept override;
 
         // VtEngine
         [[nodiscard]] HRESULT SuppressResizeRepaint() noexcept;
         [[nodiscard]] HRESULT RequestCursor() noexcept;
         [[nodiscard]] HRESULT InheritCursor(const til::point coordCursor) noexcept;
+        void SetAwaitingInheritedCursor(const bool awaiting) noexcept;
         [[nodiscard]] HRESULT WriteTerminalUtf8(const std::string_view str) noexcept;
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str) noexcept = 0;
         void SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner);
         void BeginResizeRequest();
         void EndResizeRequest();
+        void SetResizeInProgress() noexcept;
         void SetResizeQuirk(const bool resizeQuirk);
         void SetPassthroughMode(const bool passthrough) noexcept;
+        void SetSynchronizingBuffer(const bool synchronizing) noexcept;
+        bool IsSynchronizingBuffer() const noexcept;
         void SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept;
         void SetTerminalCursorTextPosition(const til::point coordCursor) noexcept;
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
@@ -90,9 +100,29 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT SwitchScreenBuffer(const bool useAltBuffer) noexcept;
 
     protected:
+        // Past this much output the writer thread is so far behind the terminal
+        // that _Flush waits for it to catch up, instead of buffering even more.
+        static constexpr size_t MAX_PENDING_WRITE_SIZE = 4 * 1024 * 1024;
+
+        // While the terminal keeps resizing us, painting is held back until no resize
+        // arrived for RESIZE_SETTLE_DELAY, but at most for RESIZE_MAX_PAINT_DELAY.
+        static constexpr auto RESIZE_SETTLE_DELAY = std::chrono::milliseconds(50);
+        static constexpr auto RESIZE_MAX_PAINT_DELAY = std::chrono::milliseconds(250);
+
         wil::unique_hfile _hFile;
         std::string _buffer;
 
+        // _Flush hands the contents of _buffer to a background thread, which writes
+        // them to the pipe. That way a terminal that's slow to read our output
+        // doesn't stall the render thread (and the console lock it's holding).
+        wil::unique_handle _writerThread;
+        std::mutex _writerMutex;
+        std::condition_variable _writerCondition;
+        std::string _writerBuffer; // guarded by _writerMutex
+        HRESULT _writerResult{ S_OK }; // guarded by _writerMutex
+        bool _writerShutdown{ false }; // guarded by _writerMutex
+        bool _inFrame{ false };
+
         std::string _formatBuffer;
         std::string _conversionBuffer;
 
@@ -107,6 +137,10 @@ namespace Microsoft::Console::Render
 
         til::point _lastText;
         til::point _scrollDelta;
+        // The rows that moved by _scrollRegionDelta this frame inside of the
+        // scroll margins, see XtermEngine::InvalidateScrollRegion().
+        til::rect _scrollRegion;
+        til::CoordType _scrollRegionDelta;
 
         bool _quickReturn;
         bool _clearedAllThisFrame;
@@ -118,6 +152,7 @@ namespace Microsoft::Console::Render
         til::CoordType _virtualTop;
         bool _circled;
         bool _firstPaint;
+        bool _awaitingInheritedCursor{ false };
         bool _skipCursor;
         bool _newBottomLine;
         til::point _deferredCursorPos;
@@ -128,6 +163,8 @@ namespace Microsoft::Console::Render
 
         Microsoft::Console::VirtualTerminal::RenderTracing _trace;
         bool _inResizeRequest{ false };
+        // Written under the console lock, but read by the render thread in WaitUntilCanRender.
+        std::atomic<std::chrono::steady_clock::time_point> _resizeInProgressUntil{};
 
         std::optional<til::CoordType> _wrappedRow{ std::nullopt };
 
@@ -135,11 +172,16 @@ namespace Microsoft::Console::Render
 
         bool _resizeQuirk{ false };
         bool _passthrough{ false };
+        bool _synchronizingBuffer{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
         [[nodiscard]] HRESULT _WriteFill(const size_t n, const char c) noexcept;
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
         [[nodiscard]] HRESULT _Flush() noexcept;
+        [[nodiscard]] HRESULT _StartWriterThread() noexcept;
+        void _StopWriterThread() noexcept;
+        static DWORD WINAPI s_WriterThreadProc(_In_ LPVOID lpParameter) noexcept;
+        void _WriterThread() noexcept;
 
         template<typename S, typename... Args>
         [[nodiscard]] HRESULT _WriteFormatted(S&& format, Args&&... args)
@@ -162,6 +204,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _InsertDeleteLine(const til::CoordType sLines, const bool fInsertLine) noexcept;
         [[nodiscard]] HRESULT _DeleteLine(const til::CoordType sLines) noexcept;
         [[nodiscard]] HRESULT _InsertLine(const til::CoordType sLines) noexcept;
+        [[nodiscard]] HRESULT _ScrollUpDown(const til::CoordType sLines, const bool fScrollUp) noexcept;
+        [[nodiscard]] HRESULT _SetTopBottomMargins(const til::CoordType top, const til::CoordType bottom) noexcept;
+        [[nodiscard]] HRESULT _ResetTopBottomMargins() noexcept;
         [[nodiscard]] HRESULT _CursorForward(const til::CoordType chars) noexcept;
         [[nodiscard]] HRESULT _EraseCharacter(const til::CoordType chars) noexcept;
         [[nodiscard]] HRESULT _CursorPosition(const til::point coord) noexcept;
@@ -212,6 +257,27 @@ namespace Microsoft::Console::Render
         // buffer space for these two functions to build their lines
         // so they don't have to alloc/free in a tight loop
         std::wstring _bufferLine;
+
+        // What we believe the terminal displays in each cell of our viewport,
+        // so that we can avoid sending it cells it already displays.
+        // A cell with 0 columns is one we don't know the contents of.
+        // The second cell of a wide glyph has 2 columns but no text.
+        struct ShadowCell
+        {
+            std::array<wchar_t, 2> text{};
+            uint8_t length = 0;
+            uint8_t columns = 0;
+            TextAttribute attributes;
+        };
+        std::vector<ShadowCell> _shadowFrame;
+
+        void _ResizeShadowFrame(const til::size size) noexcept;
+        void _InvalidateShadowFrame() noexcept;
+        void _ScrollShadowFrame(const til::CoordType delta, const til::CoordType top, const til::CoordType bottom) noexcept;
+        ShadowCell* _GetShadowCell(const til::point coord) noexcept;
+        bool _IsShadowedCluster(const Cluster& cluster, const til::point coord) noexcept;
+        void _UpdateShadowFrame(const gsl::span<const Cluster> clusters, const til::point coord, const til::CoordType columns) noexcept;
+        void _ForgetShadowCells(const til::point coord, const til::CoordType columns) noexcept;
         [[nodiscard]] HRESULT _PaintUtf8BufferLine(const gsl::span<const Cluster> clusters,
                                                    const til::point coord,
                                                    const bool lineWrapped) noexcept;
@@ -31,6 +31,7 @@ _CONSOLE_API_MSG& _CONSOLE_API_MSG::operator=(const _CONSOLE_API_MSG& other)
     _pApiRoutines = other._pApiRoutines;
     _inputBuffer = other._inputBuffer;
     _outputBuffer = other._outputBuffer;
+    _prefetchedReadOffset = other._prefetchedReadOffset;
 
     // Since this struct uses anonymous unions and thus cannot
     // explicitly reference it, we have to a bit cheeky to copy it.
@@ -49,7 +50,8 @@ _CONSOLE_API_MSG& _CONSOLE_API_MSG::operator=(const _CONSOLE_API_MSG& other)
 
     if (Complete.Write.Data)
     {
-        Complete.Write.Data = &u;
+        // ReleaseMessageBuffers might have pointed the completion at our output buffer.
+        Complete.Write.Data = other.Complete.Write.Data == other._outputBuffer.data() ? static_cast<PVOID>(_outputBuffer.data()) : &u;
     }
 
     return *this;
@@ -106,16 +108,21 @@ try
 
         const auto cbReadSize = Descriptor.InputSize - State.ReadOffset;
 
-        // If we were previously called with a huge buffer we have an equally large _inputBuffer.
-        // We shouldn't just keep this huge buffer around, if no one needs it anymore.
-        if (_inputBuffer.capacity() > 16 * 1024 && (_inputBuffer.capacity() >> 1) > cbReadSize)
+        // The payload might've been read already, while the previous message was being dispatched.
+        if (_prefetchedReadOffset != State.ReadOffset)
         {
-            _inputBuffer.shrink_to_fit();
-        }
+            // If we were previously called with a huge buffer we have an equally large _inputBuffer.
+            // We shouldn't just keep this huge buffer around, if no one needs it anymore.
+            if (_inputBuffer.capacity() > 16 * 1024 && (_inputBuffer.capacity() >> 1) > cbReadSize)
+            {
+                _inputBuffer.shrink_to_fit();
+            }
 
-        _inputBuffer.resize(cbReadSize);
+            _inputBuffer.resize(cbReadSize);
 
-        RETURN_IF_FAILED(ReadMessageInput(0, _inputBuffer.data(), cbReadSize));
+            RETURN_IF_FAILED(ReadMessageInput(0, _inputBuffer.data(), cbReadSize));
+        }
+        _prefetchedReadOffset.reset();
 
         State.InputBuffer = _inputBuffer.data();
         State.InputBufferSize = cbReadSize;
@@ -129,6 +136,40 @@ try
 }
 CATCH_RETURN();
 
+// Routine Description:
+// - This routine reads the input payload of this message ahead of its dispatch, so that
+//   GetInputBuffer can return it right away, as long as it's called with the same ReadOffset.
+// - This can be called outside of the console lock, as it only touches this message.
+// Arguments:
+// - cbReadOffset - Supplies the ReadOffset the message's dispatcher is going to use.
+// Return Value:
+// - HRESULT indicating if the payload was successfully read.
+[[nodiscard]] HRESULT _CONSOLE_API_MSG::PrefetchInputBuffer(const ULONG cbReadOffset)
+try
+{
+    _prefetchedReadOffset.reset();
+    RETURN_HR_IF(E_FAIL, cbReadOffset > Descriptor.InputSize);
+
+    const auto cbReadSize = Descriptor.InputSize - cbReadOffset;
+    if (_inputBuffer.capacity() > 16 * 1024 && (_inputBuffer.capacity() >> 1) > cbReadSize)
+    {
+        _inputBuffer.shrink_to_fit();
+    }
+
+    _inputBuffer.resize(cbReadSize);
+
+    CD_IO_OPERATION IoOperation;
+    IoOperation.Identifier = Descriptor.Identifier;
+    IoOperation.Buffer.Offset = cbReadOffset;
+    IoOperation.Buffer.Data = _inputBuffer.data();
+    IoOperation.Buffer.Size = cbReadSize;
+    RETURN_IF_FAILED(_pDeviceComm->ReadInput(&IoOperation));
+
+    _prefetchedReadOffset = cbReadOffset;
+    return S_OK;
+}
+CATCH_RETURN();
+
 // Routine Description:
 // - This routine retrieves the output buffer associated with this message. It will allocate one if needed.
 //   The allocated will be bigger than the actual output size by the requested factor.
@@ -196,6 +237,9 @@ CATCH_RETURN();
 //   during the processing of the given message. If the current completion status
 //   of the message indicates success, this routine also writes the output buffer
 //   (if any) to the message.
+// - Small output buffers that directly follow the data the completion writes back anyway
+//   are instead appended to it, so that the driver copies them while completing the message.
+//   In that case the output buffer stays allocated until the next message is processed.
 // Arguments:
 // - <none>
 // Return Value:
@@ -204,27 +248,54 @@ CATCH_RETURN();
 {
     auto hr = S_OK;
 
-    if (State.InputBuffer != nullptr)
+    if (State.InputBuffer != nullptr || _prefetchedReadOffset)
     {
         _inputBuffer.clear();
+        _prefetchedReadOffset.reset();
         State.InputBuffer = nullptr;
         State.InputBufferSize = 0;
     }
 
     if (State.OutputBuffer != nullptr)
     {
+        auto keepOutputBuffer = false;
+
         if (NT_SUCCESS(Complete.IoStatus.Status))
         {
-            CD_IO_OPERATION IoOperation;
-            IoOperation.Identifier = Descriptor.Identifier;
-            IoOperation.Buffer.Offset = State.WriteOffset;
-            IoOperation.Buffer.Data = State.OutputBuffer;
-            IoOperation.Buffer.Size = (ULONG)Complete.IoStatus.Information;
-
-            LOG_IF_FAILED(_pDeviceComm->WriteOutput(&IoOperation));
+            const auto cbWritten = (ULONG)Complete.IoStatus.Information;
+
+            // Complete.Write is copied to the start of the client's output (usually it's the API descriptor).
+            // If our output follows right after it, we can append it and save a separate call into the driver.
+            if (Complete.Write.Size == State.WriteOffset &&
+                cbWritten <= MaxCompletionPayloadSize &&
+                cbWritten <= _outputBuffer.size() &&
+                State.WriteOffset <= Descriptor.OutputSize &&
+                cbWritten <= Descriptor.OutputSize - State.WriteOffset)
+            {
+                const auto prefix = static_cast<const BYTE*>(Complete.Write.Data);
+                _outputBuffer.resize(cbWritten);
+                _outputBuffer.insert(_outputBuffer.begin(), prefix, prefix + Complete.Write.Size);
+
+                Complete.Write.Data = _outputBuffer.data();
+                Complete.Write.Size = gsl::narrow_cast<ULONG>(_outputBuffer.size());
+                keepOutputBuffer = true;
+            }
+            else
+            {
+                CD_IO_OPERATION IoOperation;
+                IoOperation.Identifier = Descriptor.Identifier;
+                IoOperation.Buffer.Offset = State.WriteOffset;
+                IoOperation.Buffer.Data = State.OutputBuffer;
+                IoOperation.Buffer.Size = cbWritten;
+
+                LOG_IF_FAILED(_pDeviceComm->WriteOutput(&IoOperation));
+            }
         }
 
-        _outputBuffer.clear();
+        if (!keepOutputBuffer)
+        {
+            _outputBuffer.clear();
+        }
         State.OutputBuffer = nullptr;
         State.OutputBufferSize = 0;
     }
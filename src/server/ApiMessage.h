@@ -44,12 +44,16 @@ typedef struct _CONSOLE_API_MSG
                                                    _Out_ PULONG pcbSize);
     [[nodiscard]] HRESULT GetOutputBuffer(_Outptr_result_bytebuffer_(*pcbSize) void** const ppvBuffer, _Out_ ULONG* const pcbSize);
     [[nodiscard]] HRESULT GetInputBuffer(_Outptr_result_bytebuffer_(*pcbSize) void** const ppvBuffer, _Out_ ULONG* const pcbSize);
+    [[nodiscard]] HRESULT PrefetchInputBuffer(const ULONG cbReadOffset);
 
     [[nodiscard]] HRESULT ReleaseMessageBuffers();
 
     void SetReplyStatus(const NTSTATUS Status);
     void SetReplyInformation(const ULONG_PTR pInformation);
 
+    // The largest output ReleaseMessageBuffers will append to the completion instead of writing it separately.
+    static constexpr ULONG MaxCompletionPayloadSize = 16 * 1024;
+
     // DO NOT PUT ACCESS SPECIFIERS HERE.
     // The tail end of this structure is overwritten with console driver packet.
     // It's important that we have a deterministic, C-like field ordering
@@ -64,6 +68,8 @@ typedef struct _CONSOLE_API_MSG
 
     boost::container::small_vector<BYTE, 128> _inputBuffer;
     boost::container::small_vector<BYTE, 128> _outputBuffer;
+    // The ReadOffset PrefetchInputBuffer read the payload in _inputBuffer from, if it did.
+    std::optional<ULONG> _prefetchedReadOffset;
 
     // From here down is the actual packet data sent/received.
     CD_IO_DESCRIPTOR Descriptor;
@@ -46,6 +46,13 @@ public:
                         _Out_ DWORD* const pControlKeyState,
                         _Out_ void* const pOutputData) = 0;
 
+    // Returns true if this waiter can only make progress once key events have been written
+    // to the input buffer, for instance because it reads characters and skips all other events.
+    virtual bool IsWaitingForKeyEvents() const noexcept
+    {
+        return false;
+    }
+
     ReplyDataType GetReplyType() const noexcept
     {
         return _ReplyType;
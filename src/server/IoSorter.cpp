@@ -98,3 +98,35 @@ void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
         *ReplyMsg = pMsg;
     }
 }
+
+// Routine Description:
+// - Reads the payload of large writes ahead of their dispatch. This lets the IO threads
+//   copy one message's payload out of the client while another message is being dispatched.
+// - Messages are still dispatched one at a time and in order. See ConsoleIoThread.
+// Arguments:
+// - pMsg - a message that was just received from the driver and will be passed to ServiceIoOperation next
+void IoSorter::PrefetchIoOperation(_In_ CONSOLE_API_MSG* const pMsg) noexcept
+{
+    switch (pMsg->Descriptor.Function)
+    {
+    case CONSOLE_IO_RAW_WRITE:
+        // ServiceIoOperation reads raw writes from the start of the payload.
+        LOG_IF_FAILED(pMsg->PrefetchInputBuffer(0));
+        break;
+
+    case CONSOLE_IO_USER_DEFINED:
+        // ApiSorter::ConsoleDispatchRequest reads the payload from right after the API descriptor.
+        // If this message turns out to be malformed, the dispatcher rejects it as usual.
+        if (pMsg->Descriptor.InputSize >= sizeof(CONSOLE_MSG_HEADER) &&
+            pMsg->msgHeader.ApiNumber == API_NUMBER_WRITECONSOLE &&
+            pMsg->msgHeader.ApiDescriptorSize <= sizeof(pMsg->u) &&
+            pMsg->msgHeader.ApiDescriptorSize <= pMsg->Descriptor.InputSize - sizeof(CONSOLE_MSG_HEADER))
+        {
+            LOG_IF_FAILED(pMsg->PrefetchInputBuffer(pMsg->msgHeader.ApiDescriptorSize + gsl::narrow_cast<ULONG>(sizeof(CONSOLE_MSG_HEADER))));
+        }
+        break;
+
+    default:
+        break;
+    }
+}
@@ -25,4 +25,5 @@ public:
     // TODO: MSFT: 9115192 - probably not void.
     static void ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
                                    _Out_ CONSOLE_API_MSG** ReplyMsg);
+    static void PrefetchIoOperation(_In_ CONSOLE_API_MSG* const pMsg) noexcept;
 };
@@ -58,14 +58,25 @@ using namespace Microsoft::Console::Interactivity;
 
     try
     {
+        // Reserve space in the group first, so that adding the process to it below can't fail.
+        auto& group = _processesByGroupId[ulProcessGroupId];
+        group.reserve(group.size() + 1);
+
         pProcessData = new ConsoleProcessHandle(dwProcessId,
                                                 dwThreadId,
                                                 ulProcessGroupId);
+        auto deleteProcessData = wil::scope_exit([&]() noexcept { delete pProcessData; });
 
         // Some applications, when reading the process list through the GetConsoleProcessList API, are expecting
         // the returned list of attached process IDs to be from newest to oldest.
         // As such, we have to put the newest process into the head of the list.
         _processes.push_front(pProcessData);
+        auto popProcess = wil::scope_exit([&]() noexcept { _processes.pop_front(); });
+        _processesById.emplace(dwProcessId, _processes.begin());
+        popProcess.release();
+        deleteProcessData.release();
+
+        group.push_back(pProcessData);
 
         if (nullptr != ppProcessData)
         {
@@ -87,10 +98,22 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
 {
     FAIL_FAST_IF(!(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked()));
 
-    // Assert that the item exists in the list. If it doesn't exist, the end/last will be returned.
-    FAIL_FAST_IF(!(_processes.cend() != std::find(_processes.cbegin(), _processes.cend(), pProcessData)));
+    // Assert that the item exists in the list.
+    const auto it = _processesById.find(pProcessData->dwProcessId);
+    FAIL_FAST_IF(!(it != _processesById.end() && *it->second == pProcessData));
+
+    _processes.erase(it->second);
+    _processesById.erase(it);
 
-    _processes.remove(pProcessData);
+    if (const auto groupIt = _processesByGroupId.find(pProcessData->_ulProcessGroupId); groupIt != _processesByGroupId.end())
+    {
+        auto& group = groupIt->second;
+        std::erase(group, pProcessData);
+        if (group.empty())
+        {
+            _processesByGroupId.erase(groupIt);
+        }
+    }
 
     delete pProcessData;
 }
@@ -104,31 +127,15 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
 // - Pointer to the process handle information or nullptr if no match was found.
 ConsoleProcessHandle* ConsoleProcessList::FindProcessInList(const DWORD dwProcessId) const
 {
-    auto it = _processes.cbegin();
-
-    while (it != _processes.cend())
+    if (ROOT_PROCESS_ID != dwProcessId)
     {
-        const auto pProcessHandleRecord = *it;
-
-        if (ROOT_PROCESS_ID != dwProcessId)
-        {
-            if (pProcessHandleRecord->dwProcessId == dwProcessId)
-            {
-                return pProcessHandleRecord;
-            }
-        }
-        else
-        {
-            if (pProcessHandleRecord->fRootProcess)
-            {
-                return pProcessHandleRecord;
-            }
-        }
-
-        it = std::next(it);
+        const auto it = _processesById.find(dwProcessId);
+        return it != _processesById.end() ? *it->second : nullptr;
     }
 
-    return nullptr;
+    // The root process is flagged by its owner after it was allocated, so it isn't indexed.
+    const auto it = std::find_if(_processes.cbegin(), _processes.cend(), [](const auto p) { return p->fRootProcess; });
+    return it != _processes.cend() ? *it : nullptr;
 }
 
 // Routine Description:
@@ -139,20 +146,9 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessInList(const DWORD dwProces
 // - Pointer to first matching process handle with given group ID. nullptr if no match was found.
 ConsoleProcessHandle* ConsoleProcessList::FindProcessByGroupId(_In_ ULONG ulProcessGroupId) const
 {
-    auto it = _processes.cbegin();
-
-    while (it != _processes.cend())
-    {
-        const auto pProcessHandleRecord = *it;
-        if (pProcessHandleRecord->_ulProcessGroupId == ulProcessGroupId)
-        {
-            return pProcessHandleRecord;
-        }
-
-        it = std::next(it);
-    }
-
-    return nullptr;
+    // The first match in _processes is the newest member of the group.
+    const auto it = _processesByGroupId.find(ulProcessGroupId);
+    return it != _processesByGroupId.end() && !it->second.empty() ? it->second.back() : nullptr;
 }
 
 // Routine Description:
@@ -219,41 +215,44 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessByGroupId(_In_ ULONG ulProc
     {
         std::deque<std::unique_ptr<ConsoleProcessTerminationRecord>> TermRecords;
 
-        // Dig through known processes looking for a match
-        auto it = _processes.cbegin();
-        while (it != _processes.cend())
-        {
-            const auto pProcessHandleRecord = *it;
+        const auto addRecord = [&](ConsoleProcessHandle* const pProcessHandleRecord) {
+            auto pNewRecord = std::make_unique<ConsoleProcessTerminationRecord>();
 
-            // If no limit was specified OR if we have a match, generate a new termination record.
-            if (0 == dwLimitingProcessId ||
-                pProcessHandleRecord->_ulProcessGroupId == dwLimitingProcessId)
-            {
-                auto pNewRecord = std::make_unique<ConsoleProcessTerminationRecord>();
+            // If the duplicate failed, the best we can do is to skip including the process in the list and hope it goes away.
+            LOG_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(),
+                                                    pProcessHandleRecord->_hProcess.get(),
+                                                    GetCurrentProcess(),
+                                                    &pNewRecord->hProcess,
+                                                    0,
+                                                    0,
+                                                    DUPLICATE_SAME_ACCESS));
 
-                // If the duplicate failed, the best we can do is to skip including the process in the list and hope it goes away.
-                LOG_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(),
-                                                        pProcessHandleRecord->_hProcess.get(),
-                                                        GetCurrentProcess(),
-                                                        &pNewRecord->hProcess,
-                                                        0,
-                                                        0,
-                                                        DUPLICATE_SAME_ACCESS));
+            pNewRecord->dwProcessID = pProcessHandleRecord->dwProcessId;
 
-                pNewRecord->dwProcessID = pProcessHandleRecord->dwProcessId;
+            // If we're hard closing the window, increment the counter.
+            if (fCtrlClose)
+            {
+                pProcessHandleRecord->_ulTerminateCount++;
+            }
 
-                // If we're hard closing the window, increment the counter.
-                if (fCtrlClose)
-                {
-                    pProcessHandleRecord->_ulTerminateCount++;
-                }
+            pNewRecord->ulTerminateCount = pProcessHandleRecord->_ulTerminateCount;
 
-                pNewRecord->ulTerminateCount = pProcessHandleRecord->_ulTerminateCount;
+            TermRecords.push_back(std::move(pNewRecord));
+        };
 
-                TermRecords.push_back(std::move(pNewRecord));
+        if (0 == dwLimitingProcessId)
+        {
+            // If no limit was specified, generate a termination record for every process.
+            for (const auto pProcessHandleRecord : _processes)
+            {
+                addRecord(pProcessHandleRecord);
             }
-
-            it = std::next(it);
+        }
+        else if (const auto it = _processesByGroupId.find(dwLimitingProcessId); it != _processesByGroupId.end())
+        {
+            // Otherwise only for the members of the group, newest to oldest, just like in _processes.
+            const auto& group = it->second;
+            std::for_each(group.rbegin(), group.rend(), addRecord);
         }
 
         // From all found matches, convert to C-style array to return
@@ -59,7 +59,13 @@ public:
     bool IsEmpty() const;
 
 private:
+    // _processes is ordered from newest to oldest. The indexes below allow the frequent lookups
+    // on connect/disconnect to avoid walking the list, which can grow to hundreds of entries
+    // when a build attaches lots of short-lived processes to the same console.
     std::list<ConsoleProcessHandle*> _processes;
+    std::unordered_map<DWORD, std::list<ConsoleProcessHandle*>::iterator> _processesById;
+    // Each group is ordered from oldest to newest, the opposite of _processes.
+    std::unordered_map<ULONG, std::vector<ConsoleProcessHandle*>> _processesByGroupId;
 
     void _ModifyProcessForegroundRights(const HANDLE hProcess, const bool fForeground) const;
 };
@@ -120,6 +120,13 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
     return S_OK;
 }
 
+// Routine Description:
+// - Returns true if the waiting routine can only make progress once key events are available.
+bool ConsoleWaitBlock::IsWaitingForKeyEvents() const noexcept
+{
+    return _pWaiter->IsWaitingForKeyEvents();
+}
+
 // Routine Description:
 // - Used to trigger the callback routine inside this wait block.
 // Arguments:
@@ -31,6 +31,7 @@ public:
     ~ConsoleWaitBlock();
 
     bool Notify(const WaitTerminationReason TerminationReason);
+    bool IsWaitingForKeyEvents() const noexcept;
 
     [[nodiscard]] static HRESULT s_CreateWait(_Inout_ CONSOLE_API_MSG* const pWaitReplymessage,
                                               _In_ IWaitRoutine* const pWaiter);
@@ -103,6 +103,28 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
     return fResult;
 }
 
+// Routine Description:
+// - Instructs this queue to callback the first waiting request that can make progress with newly written input.
+// - Requests that only consume key events are skipped if the input contained none. Otherwise a blocked
+//   ReadConsole call would be retried for every mouse move or focus change, only to find nothing to read.
+// Arguments:
+// - fKeyEventsAvailable - True if the newly written input contains key events.
+// Return Value:
+// - True if a block was successfully notified. False if it still needs to wait or if no block was notified.
+bool ConsoleWaitQueue::NotifyInputWaiter(const bool fKeyEventsAvailable)
+{
+    for (const auto WaitBlock : _blocks)
+    {
+        if (fKeyEventsAvailable || !WaitBlock->IsWaitingForKeyEvents())
+        {
+            // _NotifyBlock might erase the block from _blocks, so we must not continue iterating.
+            return _NotifyBlock(WaitBlock, WaitTerminationReason::NoReason);
+        }
+    }
+
+    return false;
+}
+
 // Routine Description:
 // - A helper to delete successfully notified callbacks
 // Arguments:
@@ -393,6 +393,7 @@ namespace Microsoft::Console::VirtualTerminal::DispatchTypes
         ALTERNATE_SCROLL = DECPrivateMode(1007),
         ASB_AlternateScreenBuffer = DECPrivateMode(1049),
         XTERM_BracketedPasteMode = DECPrivateMode(2004),
+        SO_SynchronizedOutput = DECPrivateMode(2026),
         W32IM_Win32InputMode = DECPrivateMode(9001),
     };
 
@@ -511,6 +512,13 @@ namespace Microsoft::Console::VirtualTerminal::DispatchTypes
         til::point start;
         til::point end; // exclusive
         MarkCategory category{ MarkCategory::Info };
+        // Shell integration marks (FTCS) turn a prompt mark into the block of a
+        // command: where the command line starts, where its output starts and ends
+        // (exclusive), and with which exit code the command finished.
+        std::optional<til::point> commandStart;
+        std::optional<til::point> outputStart;
+        std::optional<til::point> outputEnd;
+        std::optional<unsigned int> exitCode;
         // Other things we may want to think about in the future are listed in
         // GH#11000
     };
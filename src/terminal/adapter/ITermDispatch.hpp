@@ -23,7 +23,25 @@ namespace Microsoft::Console::VirtualTerminal
 class Microsoft::Console::VirtualTerminal::ITermDispatch
 {
 public:
-    using StringHandler = std::function<bool(const wchar_t)>;
+    // See IStateMachineEngine::StringHandler.
+    using StringHandler = std::function<bool(const std::wstring_view)>;
+
+    // Adapts a handler that processes the data string one character at a time.
+    // Unlike a per-character StringHandler it only costs an indirect call per run.
+    template<typename T>
+    static StringHandler CharacterStringHandler(T&& handler)
+    {
+        return [handler = std::forward<T>(handler)](const std::wstring_view run) mutable {
+            for (const auto ch : run)
+            {
+                if (!handler(ch))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
 
 #pragma warning(push)
 #pragma warning(disable : 26432) // suppress rule of 5 violation on interface because tampering with this is fraught with peril
@@ -82,6 +100,7 @@ public:
     virtual bool EnableFocusEventMode(const bool enabled) = 0; // ?1004
     virtual bool EnableAlternateScroll(const bool enabled) = 0; // ?1007
     virtual bool EnableXtermBracketedPasteMode(const bool enabled) = 0; // ?2004
+    virtual bool EnableSynchronizedOutput(const bool enabled) = 0; // ?2026
     virtual bool SetColorTableEntry(const size_t tableIndex, const DWORD color) = 0; // OSCColorTable
     virtual bool SetDefaultForeground(const DWORD color) = 0; // OSCDefaultForeground
     virtual bool SetDefaultBackground(const DWORD color) = 0; // OSCDefaultBackground
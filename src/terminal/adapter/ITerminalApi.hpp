@@ -78,5 +78,8 @@ namespace Microsoft::Console::VirtualTerminal
         virtual void NotifyAccessibilityChange(const til::rect& changedRect) = 0;
 
         virtual void AddMark(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& mark) = 0;
+        virtual void MarkCommandStart() = 0;
+        virtual void MarkOutputStart() = 0;
+        virtual void MarkCommandFinish(const std::optional<unsigned int> exitCode) = 0;
     };
 }
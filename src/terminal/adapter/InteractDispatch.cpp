@@ -45,6 +45,19 @@ bool InteractDispatch::WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inpu
     return true;
 }
 
+// Method Description:
+// - Writes a collection of input records to the host, in one go.
+// Arguments:
+// - records: The records to write.
+// Return Value:
+// - True.
+bool InteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> records)
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.GetActiveInputBuffer()->Write(records);
+    return true;
+}
+
 // Method Description:
 // - Writes a key event to the host in a fashion that will enable the host to
 //   process special keys such as Ctrl-C or Ctrl+Break. The host will then
@@ -62,7 +75,7 @@ bool InteractDispatch::WriteCtrlKey(const KeyEvent& event)
 
 // Method Description:
 // - Writes a string of input to the host. The string is converted to keystrokes
-//      that will faithfully represent the input by CharToKeyEvents.
+//      that will faithfully represent the input by StringToInputRecords.
 // Arguments:
 // - string : a string to write to the console.
 // Return Value:
@@ -71,19 +84,12 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
 {
     if (!string.empty())
     {
+        // Pastes can easily be megabytes large, so the keystrokes are
+        // synthesized as plain records and written in a single batch.
         const auto codepage = _api.GetConsoleOutputCP();
-        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
-
-        for (const auto& wch : string)
-        {
-            auto convertedEvents = CharToKeyEvents(wch, codepage);
-
-            std::move(convertedEvents.begin(),
-                      convertedEvents.end(),
-                      std::back_inserter(keyEvents));
-        }
-
-        WriteInput(keyEvents);
+        std::vector<INPUT_RECORD> records;
+        StringToInputRecords(string, codepage, records);
+        WriteInput(records);
     }
     return true;
 }
@@ -142,6 +148,10 @@ bool InteractDispatch::WindowManipulation(const DispatchTypes::WindowManipulatio
 // - True.
 bool InteractDispatch::MoveCursor(const VTInt row, const VTInt col)
 {
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole();
+    auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
     // First retrieve some information about the buffer
     const auto viewport = _api.GetViewport();
 
@@ -151,9 +161,18 @@ bool InteractDispatch::MoveCursor(const VTInt row, const VTInt col)
     coordCursor.Y = std::clamp(coordCursor.Y, viewport.Top, viewport.Bottom);
     coordCursor.X = std::clamp(coordCursor.X, viewport.Left, viewport.Right);
 
+    // MSFT: 15813316 - This is the response to the cursor position request conpty
+    // sends on startup. VtIo may decide not to inherit it after all, for instance
+    // because the client already wrote output at the origin. The cursor stays put then.
+    const auto hr = gci.GetVtIo()->SetCursorPosition(coordCursor);
+    if (hr != S_OK)
+    {
+        return SUCCEEDED(hr);
+    }
+
     // Finally, attempt to set the adjusted cursor position back into the console.
     const auto api = gsl::not_null{ ServiceLocator::LocateGlobals().api };
-    auto& info = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    auto& info = gci.GetActiveOutputBuffer();
     return SUCCEEDED(api->SetConsoleCursorPositionImpl(info, coordCursor));
 }
 
@@ -56,13 +56,7 @@ void AdaptDispatch::PrintString(const std::wstring_view string)
 {
     if (_termOutput.NeedToTranslate())
     {
-        std::wstring buffer;
-        buffer.reserve(string.size());
-        for (auto& wch : string)
-        {
-            buffer.push_back(_termOutput.TranslateKey(wch));
-        }
-        _api.PrintString(buffer);
+        _api.PrintString(_termOutput.TranslateString(string, _translationBuffer));
     }
     else
     {
@@ -439,8 +433,8 @@ void AdaptDispatch::_ScrollRectVertically(TextBuffer& textBuffer, const til::rec
         const auto top = delta > 0 ? scrollRect.top : scrollRect.top + absoluteDelta;
         const auto height = scrollRect.height() - absoluteDelta;
         const auto actualDelta = delta > 0 ? absoluteDelta : -absoluteDelta;
+        // ScrollRows marks the rows it moved as dirty, so they're repainted without an explicit redraw.
         textBuffer.ScrollRows(top, height, actualDelta);
-        textBuffer.TriggerRedraw(Viewport::FromExclusive(scrollRect));
     }
 
     // Rows revealed by the scroll are filled with standard erase attributes.
@@ -469,22 +463,10 @@ void AdaptDispatch::_ScrollRectHorizontally(TextBuffer& textBuffer, const til::r
     if (absoluteDelta < scrollRect.width())
     {
         const auto left = delta > 0 ? scrollRect.left : (scrollRect.left + absoluteDelta);
-        const auto top = scrollRect.top;
         const auto width = scrollRect.width() - absoluteDelta;
-        const auto height = scrollRect.height();
         const auto actualDelta = delta > 0 ? absoluteDelta : -absoluteDelta;
 
-        const auto source = Viewport::FromDimensions({ left, top }, width, height);
-        const auto target = Viewport::Offset(source, { actualDelta, 0 });
-        const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
-        auto sourcePos = source.GetWalkOrigin(walkDirection);
-        auto targetPos = target.GetWalkOrigin(walkDirection);
-        do
-        {
-            const auto data = OutputCell(*textBuffer.GetCellDataAt(sourcePos));
-            textBuffer.Write(OutputCellIterator({ &data, 1 }), targetPos);
-            source.WalkInBounds(sourcePos, walkDirection);
-        } while (target.WalkInBounds(targetPos, walkDirection));
+        textBuffer.ShiftCells({ left, scrollRect.top, left + width, scrollRect.bottom }, actualDelta);
     }
 
     // Columns revealed by the scroll are filled with standard erase attributes.
@@ -551,13 +533,7 @@ void AdaptDispatch::_FillRect(TextBuffer& textBuffer, const til::rect& fillRect,
 {
     if (fillRect.left < fillRect.right && fillRect.top < fillRect.bottom)
     {
-        const auto fillWidth = gsl::narrow_cast<size_t>(fillRect.right - fillRect.left);
-        const auto fillData = OutputCellIterator{ fillChar, fillAttrs, fillWidth };
-        const auto col = fillRect.left;
-        for (auto row = fillRect.top; row < fillRect.bottom; row++)
-        {
-            textBuffer.WriteLine(fillData, { col, row }, false);
-        }
+        textBuffer.FillRect(fillRect, fillChar, fillAttrs);
         _api.NotifyAccessibilityChange(fillRect);
     }
 }
@@ -1068,6 +1044,9 @@ bool AdaptDispatch::_ModeParamsHelper(const DispatchTypes::ModeParams param, con
     case DispatchTypes::ModeParams::W32IM_Win32InputMode:
         success = EnableWin32InputMode(enable);
         break;
+    case DispatchTypes::ModeParams::SO_SynchronizedOutput:
+        success = EnableSynchronizedOutput(enable);
+        break;
     default:
         // If no functions to call, overall dispatch was a failure.
         success = false;
@@ -2121,6 +2100,21 @@ bool AdaptDispatch::EnableXtermBracketedPasteMode(const bool enabled)
     return true;
 }
 
+//Routine Description:
+// Enable synchronized output - While enabled, the application is drawing a
+//      frame, and we don't paint until it's done (or a timeout passed).
+//Arguments:
+// - enabled - true to enable, false to disable.
+// Return value:
+// True if handled successfully. False otherwise.
+bool AdaptDispatch::EnableSynchronizedOutput(const bool enabled)
+{
+    _renderer.SetSynchronizedOutput(enabled);
+    // Return false to also forward the mode to the hosting terminal,
+    // so that it doesn't paint the frame in pieces either.
+    return !_api.IsConsolePty();
+}
+
 //Routine Description:
 // Set Cursor Style - Changes the cursor's style to match the given Dispatch
 //      cursor style. Unix styles are a combination of the shape and the blinking state.
@@ -2247,7 +2241,7 @@ bool AdaptDispatch::SetColorTableEntry(const size_t tableIndex, const DWORD dwCo
 
     // Update the screen colors if we're not a pty
     // No need to force a redraw in pty mode.
-    _renderer.TriggerRedrawAll(backgroundChanged, frameChanged);
+    _renderer.TriggerColorTableChange(backgroundChanged, frameChanged);
     return true;
 }
 
@@ -2311,7 +2305,7 @@ bool AdaptDispatch::AssignColor(const DispatchTypes::ColorItem item, const VTInt
     {
         const auto backgroundChanged = item == DispatchTypes::ColorItem::NormalText;
         const auto frameChanged = item == DispatchTypes::ColorItem::WindowFrame;
-        _renderer.TriggerRedrawAll(backgroundChanged, frameChanged);
+        _renderer.TriggerColorTableChange(backgroundChanged, frameChanged);
     }
     return !inPtyMode;
 }
@@ -2523,12 +2517,14 @@ bool AdaptDispatch::DoITerm2Action(const std::wstring_view string)
 // - Performs a FinalTerm action
 // - Currently, the actions we support are:
 //   * `OSC133;A`: mark a line as a prompt line
+//   * `OSC133;B`: mark the start of the command line
+//   * `OSC133;C`: mark the start of the command's output
+//   * `OSC133;D[;exitCode]`: mark the end of the command's output
 // - Not actually used in conhost
-// - The remainder of the FTCS prompt sequences are tracked in GH#11000
 // Arguments:
 // - string: contains the parameters that define which action we do
 // Return Value:
-// - false in conhost, true for the SetMark action, otherwise false.
+// - false in conhost, true for the supported actions, otherwise false.
 bool AdaptDispatch::DoFinalTermAction(const std::wstring_view string)
 {
     // This is not implemented in conhost.
@@ -2561,11 +2557,31 @@ bool AdaptDispatch::DoFinalTermAction(const std::wstring_view string)
         _api.AddMark(mark);
         return true;
     }
+    else if (action == L"B") // FTCS_COMMAND_START
+    {
+        _api.MarkCommandStart();
+        return true;
+    }
+    else if (action == L"C") // FTCS_COMMAND_EXECUTED
+    {
+        _api.MarkOutputStart();
+        return true;
+    }
+    else if (action == L"D") // FTCS_COMMAND_FINISHED
+    {
+        std::optional<unsigned int> exitCode;
+        if (parts.size() >= 2)
+        {
+            const auto value = til::to_ulong(til::at(parts, 1), 10);
+            if (value != til::to_ulong_error)
+            {
+                exitCode = gsl::narrow_cast<unsigned int>(value);
+            }
+        }
+        _api.MarkCommandFinish(exitCode);
+        return true;
+    }
 
-    // When we add the rest of the FTCS sequences (GH#11000), we should add a
-    // simple state machine here to track the most recently emitted mark from
-    // this set of sequences, and which sequence was emitted last, so we can
-    // modify the state of that mark as we go.
     return false;
 }
 
@@ -2620,7 +2636,7 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
         return nullptr;
     }
 
-    return [=](const auto ch) {
+    return CharacterStringHandler([=](const auto ch) {
         // We pass the data string straight through to the font buffer class
         // until we receive an ESC, indicating the end of the string. At that
         // point we can finalize the buffer, and if valid, update the renderer
@@ -2648,7 +2664,7 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
             _renderer.UpdateSoftFont(bitPattern, cellSize, centeringHint);
         }
         return true;
-    };
+    });
 }
 
 // Method Description:
@@ -2689,7 +2705,7 @@ ITermDispatch::StringHandler AdaptDispatch::_RestoreColorTable()
         return _CreatePassthroughHandler();
     }
 
-    return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const auto ch) mutable {
+    return CharacterStringHandler([this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const auto ch) mutable {
         if (ch >= L'0' && ch <= L'9')
         {
             parameter *= 10;
@@ -2728,7 +2744,7 @@ ITermDispatch::StringHandler AdaptDispatch::_RestoreColorTable()
             parameter = 0;
         }
         return (ch != AsciiChars::ESC);
-    };
+    });
 }
 
 // Method Description:
@@ -2748,7 +2764,7 @@ ITermDispatch::StringHandler AdaptDispatch::RequestSetting()
     // say that 0 is for a valid response, and 1 is for an error. The correct
     // interpretation is documented in the DEC STD 070 reference.
     const auto idBuilder = std::make_shared<VTIDBuilder>();
-    return [=](const auto ch) {
+    return CharacterStringHandler([=](const auto ch) {
         if (ch >= '\x40' && ch <= '\x7e')
         {
             const auto id = idBuilder->Finalize(ch);
@@ -2774,7 +2790,7 @@ ITermDispatch::StringHandler AdaptDispatch::RequestSetting()
             }
             return true;
         }
-    };
+    });
 }
 
 // Method Description:
@@ -2922,13 +2938,13 @@ ITermDispatch::StringHandler AdaptDispatch::_CreatePassthroughHandler()
         // And finally we create a StringHandler to receive the rest of the
         // sequence data, and pass it through to the connected terminal.
         auto& engine = stateMachine.Engine();
-        return [&, buffer = std::wstring{}](const auto ch) mutable {
+        return [&, buffer = std::wstring{}](const std::wstring_view run) mutable {
             // To make things more efficient, we buffer the string data before
             // passing it through, only flushing if the buffer gets too large,
             // or we're dealing with the last character in the current output
             // fragment, or we've reached the end of the string.
-            const auto endOfString = ch == AsciiChars::ESC;
-            buffer += ch;
+            const auto endOfString = !run.empty() && run.back() == AsciiChars::ESC;
+            buffer += run;
             if (buffer.length() >= 4096 || stateMachine.IsProcessingLastCharacter() || endOfString)
             {
                 // The end of the string is signaled with an escape, but for it
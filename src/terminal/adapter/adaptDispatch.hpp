@@ -110,6 +110,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool EnableFocusEventMode(const bool enabled) override; // ?1004
         bool EnableAlternateScroll(const bool enabled) override; // ?1007
         bool EnableXtermBracketedPasteMode(const bool enabled) override; // ?2004
+        bool EnableSynchronizedOutput(const bool enabled) override; // ?2026
         bool SetCursorStyle(const DispatchTypes::CursorStyle cursorStyle) override; // DECSCUSR
         bool SetCursorColor(const COLORREF cursorColor) override;
 
@@ -219,6 +220,7 @@ namespace Microsoft::Console::VirtualTerminal
         RenderSettings& _renderSettings;
         TerminalInput& _terminalInput;
         TerminalOutput _termOutput;
+        std::wstring _translationBuffer;
         std::unique_ptr<FontBuffer> _fontBuffer;
         std::optional<unsigned int> _initialCodePage;
 
@@ -238,6 +240,19 @@ namespace Microsoft::Console::VirtualTerminal
 
         SgrStack _sgrStack;
 
+        // A small direct-mapped cache of SGR results, see SetGraphicsRendition.
+        struct SgrCacheEntry
+        {
+            static constexpr size_t MaxOptions = 8;
+
+            std::array<VTInt, MaxOptions> options{};
+            size_t optionCount = 0;
+            TextAttribute before;
+            TextAttribute after;
+        };
+        std::array<SgrCacheEntry, 16> _sgrCache;
+
+        void _ApplyGraphicsRendition(const VTParameters options, TextAttribute& attr) noexcept;
         size_t _SetRgbColorsHelper(const VTParameters options,
                                    TextAttribute& attr,
                                    const bool isForeground) noexcept;
@@ -74,8 +74,58 @@ size_t AdaptDispatch::_SetRgbColorsHelper(const VTParameters options,
 // - True.
 bool AdaptDispatch::SetGraphicsRendition(const VTParameters options)
 {
-    auto attr = _api.GetTextBuffer().GetCurrentAttributes();
+    const auto before = _api.GetTextBuffer().GetCurrentAttributes();
+    auto attr = before;
 
+    // Colored output (ls, compiler diagnostics, diffs) repeats the same few
+    // SGR sequences over and over, mostly starting from the same attributes.
+    // The result only depends on those two, so we remember it.
+    const auto optionCount = options.size();
+    if (optionCount <= SgrCacheEntry::MaxOptions)
+    {
+        auto hash = optionCount;
+        for (size_t i = 0; i < optionCount; i++)
+        {
+            hash = hash * 31 + gsl::narrow_cast<size_t>(options.at(i).value());
+        }
+
+        auto& entry = til::at(_sgrCache, hash % _sgrCache.size());
+        auto hit = entry.optionCount == optionCount && entry.before == before;
+        for (size_t i = 0; hit && i < optionCount; i++)
+        {
+            hit = til::at(entry.options, i) == options.at(i).value();
+        }
+
+        if (!hit)
+        {
+            _ApplyGraphicsRendition(options, attr);
+            for (size_t i = 0; i < optionCount; i++)
+            {
+                til::at(entry.options, i) = options.at(i).value();
+            }
+            entry.optionCount = optionCount;
+            entry.before = before;
+            entry.after = attr;
+        }
+
+        _api.SetTextAttributes(entry.after);
+        return true;
+    }
+
+    _ApplyGraphicsRendition(options, attr);
+    _api.SetTextAttributes(attr);
+    return true;
+}
+
+// Routine Description:
+// - Applies the given SGR options to the given attributes, see SetGraphicsRendition.
+// Arguments:
+// - options - An array of options that will be applied from 0 to N, in order.
+// - attr - The attributes to modify.
+// Return Value:
+// - <none>
+void AdaptDispatch::_ApplyGraphicsRendition(const VTParameters options, TextAttribute& attr) noexcept
+{
     // Run through the graphics options and apply them
     for (size_t i = 0; i < options.size(); i++)
     {
@@ -254,9 +304,6 @@ bool AdaptDispatch::SetGraphicsRendition(const VTParameters options)
             break;
         }
     }
-    _api.SetTextAttributes(attr);
-
-    return true;
 }
 
 // Method Description:
@@ -20,6 +20,7 @@ TerminalOutput::TerminalOutput() noexcept
     _gsetTranslationTables.at(1) = Ascii;
     _gsetTranslationTables.at(2) = Ascii;
     _gsetTranslationTables.at(3) = Ascii;
+    _UpdateTranslationTable();
 }
 
 bool TerminalOutput::Designate94Charset(size_t gsetNumber, const VTID charset)
@@ -60,6 +61,7 @@ bool TerminalOutput::LockingShift(const size_t gsetNumber)
     {
         _glTranslationTable = {};
     }
+    _UpdateTranslationTable();
     return true;
 }
 
@@ -73,6 +75,7 @@ bool TerminalOutput::LockingShiftRight(const size_t gsetNumber)
     {
         _grTranslationTable = {};
     }
+    _UpdateTranslationTable();
     return true;
 }
 
@@ -122,18 +125,53 @@ wchar_t TerminalOutput::TranslateKey(const wchar_t wch) const noexcept
         }
         _ssTranslationTable = {};
     }
-    else
+    else if (wch < _translationTable.size())
     {
-        if (wch - 0x20u < _glTranslationTable.size())
-        {
-            wchFound = _glTranslationTable.at(wch - 0x20u);
-        }
-        else if (wch - 0xA0u < _grTranslationTable.size())
+        wchFound = til::at(_translationTable, wch);
+    }
+    return wchFound;
+}
+
+// Routine Description:
+// - Translates an entire string with the active G-sets, like calling
+//   TranslateKey for each of its characters.
+// Arguments:
+// - string - the string to translate
+// - buffer - receives the translated string, if anything had to be translated.
+//   Its capacity is reused between calls.
+// Return Value:
+// - the translated string. If none of the characters change, this is the given
+//   string itself and buffer is left untouched. Otherwise it refers to buffer.
+std::wstring_view TerminalOutput::TranslateString(const std::wstring_view string, std::wstring& buffer) const
+{
+    if (string.empty())
+    {
+        return string;
+    }
+
+    // A single shift only applies to the first character, which TranslateKey takes care of.
+    const auto first = TranslateKey(string.front());
+
+    const auto needsTranslation = [&](const wchar_t wch) noexcept {
+        return wch < _translationTable.size() && til::at(_translationTable, wch) != wch;
+    };
+    const auto it = std::find_if(string.begin() + 1, string.end(), needsTranslation);
+    if (it == string.end() && first == string.front())
+    {
+        return string;
+    }
+
+    buffer.assign(string);
+    buffer.front() = first;
+    for (auto i = gsl::narrow_cast<size_t>(it - string.begin()); i < buffer.size(); ++i)
+    {
+        const auto wch = buffer[i];
+        if (wch < _translationTable.size())
         {
-            wchFound = _grTranslationTable.at(wch - 0xA0u);
+            buffer[i] = til::at(_translationTable, wch);
         }
     }
-    return wchFound;
+    return buffer;
 }
 
 const std::wstring_view TerminalOutput::_LookupTranslationTable94(const VTID charset) const
@@ -239,6 +277,16 @@ const std::wstring_view TerminalOutput::_LookupTranslationTable96(const VTID cha
     }
 }
 
+// Routine Description:
+// - Combines the active GL and GR tables into _translationTable, so that
+//   translating a character is a single lookup.
+void TerminalOutput::_UpdateTranslationTable() noexcept
+{
+    std::iota(_translationTable.begin(), _translationTable.end(), L'\0');
+    std::copy(_glTranslationTable.begin(), _glTranslationTable.end(), _translationTable.begin() + 0x20);
+    std::copy(_grTranslationTable.begin(), _grTranslationTable.end(), _translationTable.begin() + 0xA0);
+}
+
 bool TerminalOutput::_SetTranslationTable(const size_t gsetNumber, const std::wstring_view translationTable)
 {
     _gsetTranslationTables.at(gsetNumber) = translationTable;
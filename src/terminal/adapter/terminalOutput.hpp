@@ -26,6 +26,7 @@ namespace Microsoft::Console::VirtualTerminal
         TerminalOutput() noexcept;
 
         wchar_t TranslateKey(const wchar_t wch) const noexcept;
+        std::wstring_view TranslateString(const std::wstring_view string, std::wstring& buffer) const;
         bool Designate94Charset(const size_t gsetNumber, const VTID charset);
         bool Designate96Charset(const size_t gsetNumber, const VTID charset);
         void SetDrcs94Designation(const VTID charset);
@@ -41,12 +42,15 @@ namespace Microsoft::Console::VirtualTerminal
         const std::wstring_view _LookupTranslationTable96(const VTID charset) const;
         bool _SetTranslationTable(const size_t gsetNumber, const std::wstring_view translationTable);
         void _ReplaceDrcsTable(const std::wstring_view oldTable, const std::wstring_view newTable);
+        void _UpdateTranslationTable() noexcept;
 
         std::array<std::wstring_view, 4> _gsetTranslationTables;
         size_t _glSetNumber = 0;
         size_t _grSetNumber = 2;
         std::wstring_view _glTranslationTable;
         std::wstring_view _grTranslationTable;
+        // The combination of the GL and GR tables, indexed by the untranslated character.
+        std::array<wchar_t, 256> _translationTable{};
         mutable std::wstring_view _ssTranslationTable;
         boolean _grTranslationEnabled = false;
         VTID _drcsId = 0;
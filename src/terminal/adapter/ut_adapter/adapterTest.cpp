@@ -60,8 +60,9 @@ using namespace Microsoft::Console::VirtualTerminal;
 class TestGetSet final : public ITerminalApi
 {
 public:
-    void PrintString(const std::wstring_view /*string*/) override
+    void PrintString(const std::wstring_view string) override
     {
+        _printed += string;
     }
 
     void ReturnResponse(const std::wstring_view response) override
@@ -242,6 +243,21 @@ public:
         Log::Comment(L"AddMark MOCK called...");
     }
 
+    void MarkCommandStart() override
+    {
+        Log::Comment(L"MarkCommandStart MOCK called...");
+    }
+
+    void MarkOutputStart() override
+    {
+        Log::Comment(L"MarkOutputStart MOCK called...");
+    }
+
+    void MarkCommandFinish(const std::optional<unsigned int> /*exitCode*/) override
+    {
+        Log::Comment(L"MarkCommandFinish MOCK called...");
+    }
+
     void PrepData()
     {
         PrepData(CursorDirection::UP); // if called like this, the cursor direction doesn't matter.
@@ -367,6 +383,7 @@ public:
 
     std::wstring _response;
     bool _retainResponse{ false };
+    std::wstring _printed;
 
     auto EnableInputRetentionInScope()
     {
@@ -1354,6 +1371,45 @@ public:
         VERIFY_IS_TRUE(_testGetSet->_textBuffer->GetCurrentAttributes().IsIntense());
     }
 
+    TEST_METHOD(GraphicsRepeatedOptionsTests)
+    {
+        Log::Comment(L"Starting test...");
+
+        _testGetSet->PrepData();
+
+        VTParameter rgOptions[16];
+        size_t cOptions = 5;
+        rgOptions[0] = DispatchTypes::GraphicsOptions::ForegroundExtended;
+        rgOptions[1] = DispatchTypes::GraphicsOptions::RGBColorOrFaint;
+        rgOptions[2] = 12;
+        rgOptions[3] = 34;
+        rgOptions[4] = 56;
+
+        Log::Comment(L"Test 1: Apply an RGB foreground to the default attributes, twice");
+        _testGetSet->_textBuffer->SetCurrentAttributes({});
+        _testGetSet->_expectedAttribute = {};
+        _testGetSet->_expectedAttribute.SetForeground(RGB(12, 34, 56));
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+        _testGetSet->_textBuffer->SetCurrentAttributes({});
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+
+        Log::Comment(L"Test 2: The same options starting from other attributes keep those attributes");
+        TextAttribute otherAttribute{};
+        otherAttribute.SetIndexedBackground(TextColor::DARK_RED);
+        otherAttribute.SetUnderlined(true);
+        _testGetSet->_textBuffer->SetCurrentAttributes(otherAttribute);
+        _testGetSet->_expectedAttribute = otherAttribute;
+        _testGetSet->_expectedAttribute.SetForeground(RGB(12, 34, 56));
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+
+        Log::Comment(L"Test 3: Options that only differ in a parameter value give different results");
+        rgOptions[4] = 57;
+        _testGetSet->_textBuffer->SetCurrentAttributes({});
+        _testGetSet->_expectedAttribute = {};
+        _testGetSet->_expectedAttribute.SetForeground(RGB(12, 34, 57));
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+    }
+
     TEST_METHOD(DeviceStatusReportTests)
     {
         Log::Comment(L"Starting test...");
@@ -1519,9 +1575,9 @@ public:
             const auto stringHandler = _pDispatch->RequestSetting();
             for (auto ch : settingId)
             {
-                stringHandler(ch);
+                stringHandler({ &ch, 1 });
             }
-            stringHandler(L'\033'); // String terminator
+            stringHandler(L"\033"); // String terminator
         };
 
         Log::Comment(L"Requesting DECSTBM margins (5 to 10).");
@@ -1696,6 +1752,24 @@ public:
         VERIFY_IS_FALSE(_testGetSet->_textBuffer->GetCursor().IsBlinkingAllowed());
     }
 
+    TEST_METHOD(SynchronizedOutputTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        _testGetSet->PrepData();
+
+        Log::Comment(L"Test 1: the mode is handled by the console itself");
+        _testGetSet->_isPty = false;
+        VERIFY_IS_TRUE(_pDispatch->SetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+        VERIFY_IS_TRUE(_pDispatch->ResetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+
+        Log::Comment(L"Test 2: conpty also passes the mode through to the terminal");
+        _testGetSet->_isPty = true;
+        VERIFY_IS_FALSE(_pDispatch->SetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+        VERIFY_IS_FALSE(_pDispatch->ResetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+        _testGetSet->_isPty = false;
+    }
+
     TEST_METHOD(ScrollMarginsTest)
     {
         Log::Comment(L"Starting test...");
@@ -2252,6 +2326,34 @@ public:
         VERIFY_IS_FALSE(_stateMachine->GetParserMode(StateMachine::Mode::AcceptC1));
     }
 
+    TEST_METHOD(PrintStringTranslation)
+    {
+        const auto print = [&](const std::wstring_view string) {
+            _testGetSet->_printed.clear();
+            _pDispatch->PrintString(string);
+            return _testGetSet->_printed;
+        };
+
+        Log::Comment(L"1. Nothing is translated with the default character sets");
+        VERIFY_ARE_EQUAL(L"lqk x", print(L"lqk x"));
+
+        Log::Comment(L"2. Line drawing characters are translated in DEC Special Graphics");
+        VERIFY_IS_TRUE(_pDispatch->Designate94Charset(0, VTID("0")));
+        VERIFY_ARE_EQUAL(L"\u250c\u2500\u2510 \u2502", print(L"lqk x"));
+
+        Log::Comment(L"3. Strings without any characters in need of translation are passed through");
+        VERIFY_ARE_EQUAL(L"ABC", print(L"ABC"));
+
+        Log::Comment(L"4. A single shift only applies to the first character");
+        VERIFY_IS_TRUE(_pDispatch->Designate94Charset(0, VTID("B")));
+        VERIFY_IS_TRUE(_pDispatch->Designate94Charset(2, VTID("0")));
+        VERIFY_IS_TRUE(_pDispatch->SingleShift(2));
+        VERIFY_ARE_EQUAL(L"\u2500q", print(L"qq"));
+        VERIFY_IS_TRUE(_pDispatch->SingleShift(2));
+        VERIFY_ARE_EQUAL(L"AB", print(L"AB"));
+        VERIFY_ARE_EQUAL(L"q", print(L"q"));
+    }
+
 private:
     TerminalInput _terminalInput{ nullptr };
     std::unique_ptr<TestGetSet> _testGetSet;
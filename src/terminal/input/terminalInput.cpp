@@ -241,6 +241,53 @@ static constexpr std::array<TermKeyMap, 14> s_simpleModifiedKeyMapping{
     // TermKeyMap{ VK_ESCAPE, ALT_PRESSED, L""}, This is another Windows system shortcut for switching windows.
 };
 
+// A direct-indexed view of one of the modifier-independent TermKeyMap tables above.
+// HandleKey translates every single keypress, so instead of scanning the tables for
+// the virtual key code we look its entry up in a 256 byte index built at compile time.
+struct TermKeyMapTable
+{
+    template<size_t N>
+    constexpr TermKeyMapTable(const std::array<TermKeyMap, N>& keyMapping) noexcept :
+        _keyMapping{ keyMapping.data() }
+    {
+        static_assert(N < UINT8_MAX);
+
+        _index.fill(UINT8_MAX);
+        // Iterate backwards so that the first entry for any given vkey wins, just like a linear search would.
+        for (auto i = N; i-- > 0;)
+        {
+            _index.at(keyMapping[i].vkey) = gsl::narrow_cast<uint8_t>(i);
+        }
+    }
+
+    constexpr const TermKeyMap* lookup(const WORD vkey) const noexcept
+    {
+        if (vkey >= _index.size() || _index[vkey] == UINT8_MAX)
+        {
+            return nullptr;
+        }
+        return &_keyMapping[_index[vkey]];
+    }
+
+private:
+    const TermKeyMap* _keyMapping;
+    std::array<uint8_t, 256> _index{};
+};
+
+static constexpr TermKeyMapTable s_cursorKeysNormalTable{ s_cursorKeysNormalMapping };
+static constexpr TermKeyMapTable s_cursorKeysApplicationTable{ s_cursorKeysApplicationMapping };
+static constexpr TermKeyMapTable s_cursorKeysVt52Table{ s_cursorKeysVt52Mapping };
+static constexpr TermKeyMapTable s_keypadNumericTable{ s_keypadNumericMapping };
+static constexpr TermKeyMapTable s_keypadApplicationTable{ s_keypadApplicationMapping };
+static constexpr TermKeyMapTable s_keypadVt52Table{ s_keypadVt52Mapping };
+static constexpr TermKeyMapTable s_modifierKeyTable{ s_modifierKeyMapping };
+
+// _searchWithModifier formats the s_modifierKeyMapping sequences into a stack buffer of this size.
+static constexpr size_t s_modifierKeySequenceMaxLength = 8;
+static_assert(std::all_of(s_modifierKeyMapping.begin(), s_modifierKeyMapping.end(), [](const auto& map) {
+    return map.sequence.size() >= 2 && map.sequence.size() <= s_modifierKeySequenceMaxLength;
+}));
+
 const wchar_t* const CTRL_SLASH_SEQUENCE = L"\x1f";
 const wchar_t* const CTRL_QUESTIONMARK_SEQUENCE = L"\x7F";
 const wchar_t* const CTRL_ALT_SLASH_SEQUENCE = L"\x1b\x1f";
@@ -277,10 +324,10 @@ void TerminalInput::ForceDisableWin32InputMode(const bool win32InputMode) noexce
     _forceDisableWin32InputMode = win32InputMode;
 }
 
-static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent,
-                                                        const bool ansiMode,
-                                                        const bool cursorApplicationMode,
-                                                        const bool keypadApplicationMode) noexcept
+static const TermKeyMapTable& _getKeyMapping(const KeyEvent& keyEvent,
+                                             const bool ansiMode,
+                                             const bool cursorApplicationMode,
+                                             const bool keypadApplicationMode) noexcept
 {
     if (ansiMode)
     {
@@ -288,22 +335,22 @@ static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent
         {
             if (cursorApplicationMode)
             {
-                return { s_cursorKeysApplicationMapping.data(), s_cursorKeysApplicationMapping.size() };
+                return s_cursorKeysApplicationTable;
             }
             else
             {
-                return { s_cursorKeysNormalMapping.data(), s_cursorKeysNormalMapping.size() };
+                return s_cursorKeysNormalTable;
             }
         }
         else
         {
             if (keypadApplicationMode)
             {
-                return { s_keypadApplicationMapping.data(), s_keypadApplicationMapping.size() };
+                return s_keypadApplicationTable;
             }
             else
             {
-                return { s_keypadNumericMapping.data(), s_keypadNumericMapping.size() };
+                return s_keypadNumericTable;
             }
         }
     }
@@ -311,11 +358,11 @@ static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent
     {
         if (keyEvent.IsCursorKey())
         {
-            return { s_cursorKeysVt52Mapping.data(), s_cursorKeysVt52Mapping.size() };
+            return s_cursorKeysVt52Table;
         }
         else
         {
-            return { s_keypadVt52Mapping.data(), s_keypadVt52Mapping.size() };
+            return s_keypadVt52Table;
         }
     }
 }
@@ -371,25 +418,21 @@ typedef std::function<void(const std::wstring_view)> InputSender;
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully modified and sent it to the input
-static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
+static bool _searchWithModifier(const KeyEvent& keyEvent, const InputSender& sender)
 {
     auto success = false;
 
-    const auto match = _searchKeyMapping(keyEvent,
-                                         { s_modifierKeyMapping.data(), s_modifierKeyMapping.size() });
-    if (match)
+    if (const auto match = s_modifierKeyTable.lookup(keyEvent.GetVirtualKeyCode()))
     {
-        const auto& v = match.value();
-        if (!v.sequence.empty())
-        {
-            std::wstring modified{ v.sequence }; // Make a copy so we can modify it.
-            const auto shift = keyEvent.IsShiftPressed();
-            const auto alt = keyEvent.IsAltPressed();
-            const auto ctrl = keyEvent.IsCtrlPressed();
-            modified.at(modified.size() - 2) = L'1' + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
-            sender(modified);
-            success = true;
-        }
+        // Make a copy on the stack so we can modify it.
+        std::array<wchar_t, s_modifierKeySequenceMaxLength> modified;
+        const auto length = match->sequence.copy(modified.data(), modified.size());
+        const auto shift = keyEvent.IsShiftPressed();
+        const auto alt = keyEvent.IsAltPressed();
+        const auto ctrl = keyEvent.IsCtrlPressed();
+        til::at(modified, length - 2) = L'1' + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
+        sender({ modified.data(), length });
+        success = true;
     }
     else
     {
@@ -483,23 +526,23 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
 }
 
 // Routine Description:
-// - Searches the input array of mappings, and sends it to the input if a match was found.
+// - Looks up the key in the given table of mappings, and sends it to the input if a match was found.
 // Arguments:
 // - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
+// - keyMapping - Table of key mappings to search
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully sent it to the input
 static bool _translateDefaultMapping(const KeyEvent& keyEvent,
-                                     const gsl::span<const TermKeyMap> keyMapping,
-                                     InputSender sender)
+                                     const TermKeyMapTable& keyMapping,
+                                     const InputSender& sender)
 {
-    const auto match = _searchKeyMapping(keyEvent, keyMapping);
+    const auto match = keyMapping.lookup(keyEvent.GetVirtualKeyCode());
     if (match)
     {
         sender(match->sequence);
     }
-    return match.has_value();
+    return match != nullptr;
 }
 
 // Routine Description:
@@ -613,7 +656,7 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
         }
     }
 
-    const auto senderFunc = [this](const std::wstring_view seq) noexcept {
+    const InputSender senderFunc = [this](const std::wstring_view seq) noexcept {
         _SendInputSequence(seq);
     };
 
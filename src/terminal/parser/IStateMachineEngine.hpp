@@ -20,7 +20,9 @@ namespace Microsoft::Console::VirtualTerminal
     class IStateMachineEngine
     {
     public:
-        using StringHandler = std::function<bool(const wchar_t)>;
+        // Receives the data string of a DCS sequence in runs of characters. The end of the
+        // string is signaled by a run holding a single ESC. Returning false ignores the rest.
+        using StringHandler = std::function<bool(const std::wstring_view)>;
 
         virtual ~IStateMachineEngine() = 0;
         IStateMachineEngine(const IStateMachineEngine&) = default;
@@ -50,6 +52,10 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) = 0;
 
+        // Called once the state machine has finished processing a string,
+        // so that engines can dispatch anything they've been batching up.
+        virtual void DispatchPending() = 0;
+
     protected:
         IStateMachineEngine() = default;
     };
@@ -115,6 +115,7 @@ void InputStateMachineEngine::SetLookingForDSR(const bool looking) noexcept
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
+    _WritePendingWin32Keys();
     return _DoControlCharacter(wch, false);
 }
 
@@ -219,6 +220,8 @@ bool InputStateMachineEngine::_DoControlCharacter(const wchar_t wch, const bool
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 {
+    _WritePendingWin32Keys();
+
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -236,6 +239,8 @@ bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 {
+    _WritePendingWin32Keys();
+
     short vkey = 0;
     DWORD modifierState = 0;
     auto success = _GenerateKeyFromChar(wch, vkey, modifierState);
@@ -255,6 +260,8 @@ bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 {
+    _WritePendingWin32Keys();
+
     if (string.empty())
     {
         return true;
@@ -271,6 +278,8 @@ bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view string)
 {
+    _WritePendingWin32Keys();
+
     if (_pDispatch->IsVtInputEnabled())
     {
         // Synthesize string into key events that we'll write to the buffer
@@ -298,6 +307,8 @@ bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view st
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
+    _WritePendingWin32Keys();
+
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -371,9 +382,15 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         id != CsiActionCodes::FocusIn &&
         id != CsiActionCodes::FocusOut)
     {
+        _WritePendingWin32Keys();
         return _pfnFlushToInputQueue();
     }
 
+    if (id != CsiActionCodes::Win32KeyboardInput)
+    {
+        _WritePendingWin32Keys();
+    }
+
     DWORD modifierState = 0;
     short vkey = 0;
 
@@ -439,11 +456,23 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         break;
     case CsiActionCodes::Win32KeyboardInput:
     {
-        // Use WriteCtrlKey here, even for keys that _aren't_ control keys,
-        // because that will take extra steps to make sure things like
-        // Ctrl+C, Ctrl+Break are handled correctly.
         const auto key = _GenerateWin32Key(parameters);
-        success = _pDispatch->WriteCtrlKey(key);
+        if (key.IsKeyDown() && (key.IsCtrlPressed() || key.IsAltPressed()))
+        {
+            // Use WriteCtrlKey for keys that could be control keys, because
+            // that will take extra steps to make sure things like Ctrl+C,
+            // Ctrl+Break are handled correctly.
+            _WritePendingWin32Keys();
+            success = _pDispatch->WriteCtrlKey(key);
+        }
+        else
+        {
+            // All other keys are simply written to the input buffer. When a
+            // lot of them arrive at once (like a paste), we collect them and
+            // write them all at once in DispatchPending.
+            _pendingWin32Keys.emplace_back(key.ToInputRecord());
+            success = true;
+        }
         break;
     }
     default:
@@ -480,6 +509,8 @@ IStateMachineEngine::StringHandler InputStateMachineEngine::ActionDcsDispatch(co
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParameters /*parameters*/)
 {
+    _WritePendingWin32Keys();
+
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -500,6 +531,18 @@ bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParam
     return success;
 }
 
+// Method Description:
+// - Called once the state machine has finished processing a string.
+//      Writes the win32-input-mode keys we've collected while doing so.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputStateMachineEngine::DispatchPending()
+{
+    _WritePendingWin32Keys();
+}
+
 // Method Description:
 // - Triggers the Clear action to indicate that the state machine should erase
 //      all internal state.
@@ -686,6 +729,22 @@ void InputStateMachineEngine::_GetSingleKeypress(const wchar_t wch,
     input.push_back(rec);
 }
 
+// Method Description:
+// - Writes the win32-input-mode keys we've collected to the input callback, all at once.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputStateMachineEngine::_WritePendingWin32Keys()
+{
+    if (!_pendingWin32Keys.empty())
+    {
+        _pDispatch->WriteInput(_pendingWin32Keys);
+        // clear() retains the capacity for the next batch.
+        _pendingWin32Keys.clear();
+    }
+}
+
 // Method Description:
 // - Writes a sequence of keypresses to the input callback based on the wch,
 //      vkey and modifiers passed in. Will create both the appropriate key downs
@@ -162,18 +162,24 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override;
 
+        void DispatchPending() override;
+
         void SetFlushToInputQueueCallback(std::function<bool()> pfnFlushToInputQueue);
 
     private:
         const std::unique_ptr<IInteractDispatch> _pDispatch;
         std::function<bool()> _pfnFlushToInputQueue;
-        bool _lookingForDSR;
+        // Cleared by conpty's startup timeout on a threadpool thread, see VtIo::StartIfNeeded.
+        std::atomic<bool> _lookingForDSR;
         DWORD _mouseButtonState = 0;
         std::chrono::milliseconds _doubleClickTime;
         std::optional<til::point> _lastMouseClickPos{};
         std::optional<std::chrono::steady_clock::time_point> _lastMouseClickTime{};
         std::optional<size_t> _lastMouseClickButton{};
 
+        // win32-input-mode keys that haven't been written yet, see DispatchPending.
+        std::vector<INPUT_RECORD> _pendingWin32Keys;
+
         DWORD _GetCursorKeysModifierState(const VTParameters parameters, const VTID id) noexcept;
         DWORD _GetGenericKeysModifierState(const VTParameters parameters) noexcept;
         DWORD _GetSGRMouseModifierState(const size_t modifierParam) noexcept;
@@ -190,6 +196,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool _GetCursorKeysVkey(const VTID id, short& vkey) const;
         bool _GetSs3KeysVkey(const wchar_t wch, short& vkey) const;
 
+        void _WritePendingWin32Keys();
         bool _WriteSingleKey(const short vkey, const DWORD modifierState);
         bool _WriteSingleKey(const wchar_t wch, const short vkey, const DWORD modifierState);
 
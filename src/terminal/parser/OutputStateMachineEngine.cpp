@@ -416,15 +416,18 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 }
 
 // Routine Description:
-// - Triggers the CsiDispatch action to indicate that the listener should handle
-//      a control sequence. These sequences perform various API-type commands
-//      that can include many parameters.
+// - Dispatches the control sequences that make up the bulk of real traffic:
+//      SGR, cursor movement and positioning, and erasing. Their identifiers
+//      consist of the final character alone, so this small switch compiles
+//      into a direct jump instead of a search through all the identifiers
+//      handled in ActionCsiDispatch.
 // Arguments:
 // - id - Identifier of the control sequence to dispatch.
 // - parameters - set of numeric parameters collected while parsing the sequence.
 // Return Value:
-// - true iff we successfully dispatched the sequence.
-bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
+// - std::nullopt if id isn't one of these sequences, otherwise
+//      true iff we successfully dispatched the sequence.
+std::optional<bool> OutputStateMachineEngine::_DispatchFrequentCsi(const VTID id, const VTParameters parameters)
 {
     auto success = false;
 
@@ -446,48 +449,11 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
         success = _dispatch->CursorBackward(parameters.at(0));
         TermTelemetry::Instance().Log(TermTelemetry::Codes::CUB);
         break;
-    case CsiActionCodes::CNL_CursorNextLine:
-        success = _dispatch->CursorNextLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CNL);
-        break;
-    case CsiActionCodes::CPL_CursorPrevLine:
-        success = _dispatch->CursorPrevLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CPL);
-        break;
-    case CsiActionCodes::CHA_CursorHorizontalAbsolute:
-    case CsiActionCodes::HPA_HorizontalPositionAbsolute:
-        success = _dispatch->CursorHorizontalPositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHA);
-        break;
-    case CsiActionCodes::VPA_VerticalLinePositionAbsolute:
-        success = _dispatch->VerticalLinePositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPA);
-        break;
-    case CsiActionCodes::HPR_HorizontalPositionRelative:
-        success = _dispatch->HorizontalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::HPR);
-        break;
-    case CsiActionCodes::VPR_VerticalPositionRelative:
-        success = _dispatch->VerticalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPR);
-        break;
     case CsiActionCodes::CUP_CursorPosition:
     case CsiActionCodes::HVP_HorizontalVerticalPosition:
         success = _dispatch->CursorPosition(parameters.at(0), parameters.at(1));
         TermTelemetry::Instance().Log(TermTelemetry::Codes::CUP);
         break;
-    case CsiActionCodes::DECSTBM_SetScrollingRegion:
-        success = _dispatch->SetTopBottomScrollingMargins(parameters.at(0).value_or(0), parameters.at(1).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTBM);
-        break;
-    case CsiActionCodes::ICH_InsertCharacter:
-        success = _dispatch->InsertCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ICH);
-        break;
-    case CsiActionCodes::DCH_DeleteCharacter:
-        success = _dispatch->DeleteCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DCH);
-        break;
     case CsiActionCodes::ED_EraseDisplay:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->EraseInDisplay(eraseType);
@@ -500,134 +466,201 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
         });
         TermTelemetry::Instance().Log(TermTelemetry::Codes::EL);
         break;
-    case CsiActionCodes::DECSET_PrivateModeSet:
-        success = parameters.for_each([&](const auto mode) {
-            return _dispatch->SetMode(DispatchTypes::DECPrivateMode(mode));
-        });
-        //TODO: MSFT:6367459 Add specific logging for each of the DECSET/DECRST codes
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSET);
-        break;
-    case CsiActionCodes::DECRST_PrivateModeReset:
-        success = parameters.for_each([&](const auto mode) {
-            return _dispatch->ResetMode(DispatchTypes::DECPrivateMode(mode));
-        });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRST);
-        break;
     case CsiActionCodes::SGR_SetGraphicsRendition:
         success = _dispatch->SetGraphicsRendition(parameters);
         TermTelemetry::Instance().Log(TermTelemetry::Codes::SGR);
         break;
-    case CsiActionCodes::DSR_DeviceStatusReport:
-        success = _dispatch->DeviceStatusReport(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DSR);
-        break;
-    case CsiActionCodes::DA_DeviceAttributes:
-        success = parameters.at(0).value_or(0) == 0 && _dispatch->DeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
-        break;
-    case CsiActionCodes::DA2_SecondaryDeviceAttributes:
-        success = parameters.at(0).value_or(0) == 0 && _dispatch->SecondaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA2);
-        break;
-    case CsiActionCodes::DA3_TertiaryDeviceAttributes:
-        success = parameters.at(0).value_or(0) == 0 && _dispatch->TertiaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA3);
-        break;
-    case CsiActionCodes::DECREQTPARM_RequestTerminalParameters:
-        success = _dispatch->RequestTerminalParameters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECREQTPARM);
-        break;
-    case CsiActionCodes::SU_ScrollUp:
-        success = _dispatch->ScrollUp(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SU);
-        break;
-    case CsiActionCodes::SD_ScrollDown:
-        success = _dispatch->ScrollDown(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SD);
-        break;
-    case CsiActionCodes::ANSISYSSC_CursorSave:
-        success = parameters.empty() && _dispatch->CursorSaveState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSSC);
-        break;
-    case CsiActionCodes::ANSISYSRC_CursorRestore:
-        success = parameters.empty() && _dispatch->CursorRestoreState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSRC);
-        break;
-    case CsiActionCodes::IL_InsertLine:
-        success = _dispatch->InsertLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::IL);
-        break;
-    case CsiActionCodes::DL_DeleteLine:
-        success = _dispatch->DeleteLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DL);
-        break;
-    case CsiActionCodes::CHT_CursorForwardTab:
-        success = _dispatch->ForwardTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHT);
-        break;
-    case CsiActionCodes::CBT_CursorBackTab:
-        success = _dispatch->BackwardsTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CBT);
-        break;
-    case CsiActionCodes::TBC_TabClear:
-        success = parameters.for_each([&](const auto clearType) {
-            return _dispatch->TabClear(clearType);
-        });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::TBC);
-        break;
-    case CsiActionCodes::ECH_EraseCharacters:
-        success = _dispatch->EraseCharacters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ECH);
-        break;
-    case CsiActionCodes::DTTERM_WindowManipulation:
-        success = _dispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DTTERM_WM);
-        break;
-    case CsiActionCodes::REP_RepeatCharacter:
-        // Handled w/o the dispatch. This function is unique in that way
-        // If this were in the ITerminalDispatch, then each
-        // implementation would effectively be the same, calling only
-        // functions that are already part of the interface.
-        // Print the last graphical character a number of times.
-        if (_lastPrintedChar != AsciiChars::NUL)
+    default:
+        return std::nullopt;
+    }
+
+    return success;
+}
+
+// Routine Description:
+// - Triggers the CsiDispatch action to indicate that the listener should handle
+//      a control sequence. These sequences perform various API-type commands
+//      that can include many parameters.
+// Arguments:
+// - id - Identifier of the control sequence to dispatch.
+// - parameters - set of numeric parameters collected while parsing the sequence.
+// Return Value:
+// - true iff we successfully dispatched the sequence.
+bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
+{
+    auto success = false;
+
+    // The sequences that dominate real traffic are tried first, see _DispatchFrequentCsi.
+    if (const auto frequent = _DispatchFrequentCsi(id, parameters))
+    {
+        success = *frequent;
+    }
+    else
+    {
+        switch (id)
         {
-            const size_t repeatCount = parameters.at(0);
-            std::wstring wstr(repeatCount, _lastPrintedChar);
-            _dispatch->PrintString(wstr);
+        case CsiActionCodes::CNL_CursorNextLine:
+            success = _dispatch->CursorNextLine(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::CNL);
+            break;
+        case CsiActionCodes::CPL_CursorPrevLine:
+            success = _dispatch->CursorPrevLine(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::CPL);
+            break;
+        case CsiActionCodes::CHA_CursorHorizontalAbsolute:
+        case CsiActionCodes::HPA_HorizontalPositionAbsolute:
+            success = _dispatch->CursorHorizontalPositionAbsolute(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::CHA);
+            break;
+        case CsiActionCodes::VPA_VerticalLinePositionAbsolute:
+            success = _dispatch->VerticalLinePositionAbsolute(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::VPA);
+            break;
+        case CsiActionCodes::HPR_HorizontalPositionRelative:
+            success = _dispatch->HorizontalPositionRelative(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::HPR);
+            break;
+        case CsiActionCodes::VPR_VerticalPositionRelative:
+            success = _dispatch->VerticalPositionRelative(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::VPR);
+            break;
+        case CsiActionCodes::DECSTBM_SetScrollingRegion:
+            success = _dispatch->SetTopBottomScrollingMargins(parameters.at(0).value_or(0), parameters.at(1).value_or(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTBM);
+            break;
+        case CsiActionCodes::ICH_InsertCharacter:
+            success = _dispatch->InsertCharacter(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::ICH);
+            break;
+        case CsiActionCodes::DCH_DeleteCharacter:
+            success = _dispatch->DeleteCharacter(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DCH);
+            break;
+        case CsiActionCodes::DECSET_PrivateModeSet:
+            success = parameters.for_each([&](const auto mode) {
+                return _dispatch->SetMode(DispatchTypes::DECPrivateMode(mode));
+            });
+            //TODO: MSFT:6367459 Add specific logging for each of the DECSET/DECRST codes
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSET);
+            break;
+        case CsiActionCodes::DECRST_PrivateModeReset:
+            success = parameters.for_each([&](const auto mode) {
+                return _dispatch->ResetMode(DispatchTypes::DECPrivateMode(mode));
+            });
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRST);
+            break;
+        case CsiActionCodes::DSR_DeviceStatusReport:
+            success = _dispatch->DeviceStatusReport(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DSR);
+            break;
+        case CsiActionCodes::DA_DeviceAttributes:
+            success = parameters.at(0).value_or(0) == 0 && _dispatch->DeviceAttributes();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
+            break;
+        case CsiActionCodes::DA2_SecondaryDeviceAttributes:
+            success = parameters.at(0).value_or(0) == 0 && _dispatch->SecondaryDeviceAttributes();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DA2);
+            break;
+        case CsiActionCodes::DA3_TertiaryDeviceAttributes:
+            success = parameters.at(0).value_or(0) == 0 && _dispatch->TertiaryDeviceAttributes();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DA3);
+            break;
+        case CsiActionCodes::DECREQTPARM_RequestTerminalParameters:
+            success = _dispatch->RequestTerminalParameters(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECREQTPARM);
+            break;
+        case CsiActionCodes::SU_ScrollUp:
+            success = _dispatch->ScrollUp(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::SU);
+            break;
+        case CsiActionCodes::SD_ScrollDown:
+            success = _dispatch->ScrollDown(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::SD);
+            break;
+        case CsiActionCodes::ANSISYSSC_CursorSave:
+            success = parameters.empty() && _dispatch->CursorSaveState();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSSC);
+            break;
+        case CsiActionCodes::ANSISYSRC_CursorRestore:
+            success = parameters.empty() && _dispatch->CursorRestoreState();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSRC);
+            break;
+        case CsiActionCodes::IL_InsertLine:
+            success = _dispatch->InsertLine(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::IL);
+            break;
+        case CsiActionCodes::DL_DeleteLine:
+            success = _dispatch->DeleteLine(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DL);
+            break;
+        case CsiActionCodes::CHT_CursorForwardTab:
+            success = _dispatch->ForwardTab(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::CHT);
+            break;
+        case CsiActionCodes::CBT_CursorBackTab:
+            success = _dispatch->BackwardsTab(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::CBT);
+            break;
+        case CsiActionCodes::TBC_TabClear:
+            success = parameters.for_each([&](const auto clearType) {
+                return _dispatch->TabClear(clearType);
+            });
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::TBC);
+            break;
+        case CsiActionCodes::ECH_EraseCharacters:
+            success = _dispatch->EraseCharacters(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::ECH);
+            break;
+        case CsiActionCodes::DTTERM_WindowManipulation:
+            success = _dispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DTTERM_WM);
+            break;
+        case CsiActionCodes::REP_RepeatCharacter:
+            // Handled w/o the dispatch. This function is unique in that way
+            // If this were in the ITerminalDispatch, then each
+            // implementation would effectively be the same, calling only
+            // functions that are already part of the interface.
+            // Print the last graphical character a number of times.
+            if (_lastPrintedChar != AsciiChars::NUL)
+            {
+                const size_t repeatCount = parameters.at(0);
+                std::wstring wstr(repeatCount, _lastPrintedChar);
+                _dispatch->PrintString(wstr);
+            }
+            success = true;
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::REP);
+            break;
+        case CsiActionCodes::DECSCUSR_SetCursorStyle:
+            success = _dispatch->SetCursorStyle(parameters.at(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSCUSR);
+            break;
+        case CsiActionCodes::DECSTR_SoftReset:
+            success = _dispatch->SoftReset();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTR);
+            break;
+        case CsiActionCodes::XT_PushSgr:
+        case CsiActionCodes::XT_PushSgrAlias:
+            success = _dispatch->PushGraphicsRendition(parameters);
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPUSHSGR);
+            break;
+        case CsiActionCodes::XT_PopSgr:
+        case CsiActionCodes::XT_PopSgrAlias:
+            success = _dispatch->PopGraphicsRendition();
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPOPSGR);
+            break;
+        case CsiActionCodes::DECAC_AssignColor:
+            success = _dispatch->AssignColor(parameters.at(0), parameters.at(1).value_or(0), parameters.at(2).value_or(0));
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECAC);
+            break;
+        case CsiActionCodes::DECPS_PlaySound:
+            success = _dispatch->PlaySounds(parameters);
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::DECPS);
+            break;
+        default:
+            // If no functions to call, overall dispatch was a failure.
+            success = false;
+            break;
         }
-        success = true;
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::REP);
-        break;
-    case CsiActionCodes::DECSCUSR_SetCursorStyle:
-        success = _dispatch->SetCursorStyle(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSCUSR);
-        break;
-    case CsiActionCodes::DECSTR_SoftReset:
-        success = _dispatch->SoftReset();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTR);
-        break;
-    case CsiActionCodes::XT_PushSgr:
-    case CsiActionCodes::XT_PushSgrAlias:
-        success = _dispatch->PushGraphicsRendition(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPUSHSGR);
-        break;
-    case CsiActionCodes::XT_PopSgr:
-    case CsiActionCodes::XT_PopSgrAlias:
-        success = _dispatch->PopGraphicsRendition();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPOPSGR);
-        break;
-    case CsiActionCodes::DECAC_AssignColor:
-        success = _dispatch->AssignColor(parameters.at(0), parameters.at(1).value_or(0), parameters.at(2).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECAC);
-        break;
-    case CsiActionCodes::DECPS_PlaySound:
-        success = _dispatch->PlaySounds(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECPS);
-        break;
-    default:
-        // If no functions to call, overall dispatch was a failure.
-        success = false;
-        break;
     }
 
     // If we were unable to process the string, and there's a TTY attached to us,
@@ -881,6 +914,17 @@ bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/, const VT
     return false;
 }
 
+// Routine Description:
+// - Called once the state machine has finished processing a string.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void OutputStateMachineEngine::DispatchPending() noexcept
+{
+    // The output engine dispatches everything immediately.
+}
+
 // Routine Description:
 // - Null terminates, then returns, the string that we've collected as part of the OSC string.
 // Arguments:
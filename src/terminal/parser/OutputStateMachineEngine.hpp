@@ -55,6 +55,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) noexcept override;
 
+        void DispatchPending() noexcept override;
+
         void SetTerminalConnection(Microsoft::Console::Render::VtEngine* const pTtyConnection,
                                    std::function<bool()> pfnFlushToTerminal);
 
@@ -192,6 +194,8 @@ namespace Microsoft::Console::VirtualTerminal
             ITerm2Action = 1337,
         };
 
+        std::optional<bool> _DispatchFrequentCsi(const VTID id, const VTParameters parameters);
+
         bool _GetOscTitle(const std::wstring_view string,
                           std::wstring& title) const;
 
@@ -41,6 +41,12 @@ static std::string GenerateOscColorTableToken();
 static std::string GenerateVt52Token();
 static std::string GenerateVt52CursorAddressToken();
 static std::string GenerateOscHyperlinkToken();
+static std::string GenerateMarginChurnToken();
+static std::string GenerateMaxRepeatToken();
+static std::string GenerateGiantOscToken();
+static std::string GenerateParameterFloodToken();
+static std::string GenerateResizeToken();
+static std::string GenerateTabStopToken();
 
 const fuzz::_fuzz_type_entry<BYTE> g_repeatMap[] = {
     { 4, [](BYTE) { return CFuzzChance::GetRandom<BYTE>(2, 0xF); } },
@@ -67,6 +73,18 @@ const std::function<std::string()> g_tokenGenerators[] = {
     GenerateOscHyperlinkToken
 };
 
+// These produce sequences that are cheap to send, but might be expensive to process.
+// They're used for the "slow" mode, which looks for inputs that take too long or
+// allocate too much per byte instead of ones that crash. See Host.FuzzWrapper.
+const std::function<std::string()> g_slowTokenGenerators[] = {
+    GenerateMarginChurnToken,
+    GenerateMaxRepeatToken,
+    GenerateGiantOscToken,
+    GenerateParameterFloodToken,
+    GenerateResizeToken,
+    GenerateTabStopToken
+};
+
 std::string GenerateTokenLowProbability()
 {
     const _fuzz_type_entry<std::string> tokenGeneratorMap[] = {
@@ -93,6 +111,18 @@ std::string GenerateToken()
     return (std::string)ft;
 }
 
+std::string GenerateSlowToken()
+{
+    const _fuzz_type_entry<std::string> tokenGeneratorMap[] = {
+        { 10, [](std::string) { return GenerateTextToken(); } },
+        { 85, [&](std::string) { return CFuzzChance::SelectOne(g_slowTokenGenerators, ARRAYSIZE(g_slowTokenGenerators))(); } },
+        { 5, [&](std::string) { return CFuzzChance::SelectOne(g_tokenGenerators, ARRAYSIZE(g_tokenGenerators))(); } }
+    };
+    CFuzzType<std::string> ft(FUZZ_MAP(tokenGeneratorMap), std::string(""));
+
+    return (std::string)ft;
+}
+
 std::string GenerateWhiteSpaceToken()
 {
     const _fuzz_type_entry<DWORD> ftMap[] = {
@@ -602,11 +632,106 @@ std::string GenerateOscHyperlinkToken()
     return GenerateFuzzedOscToken(FUZZ_MAP(map), tokens, ARRAYSIZE(tokens));
 }
 
+// Sets the scrolling margins over and over and scrolls within them, which
+// moves every row between the margins each time.
+std::string GenerateMarginChurnToken()
+{
+    const LPCSTR scrolls[] = { "S", "T", "L", "M" };
+    const LPCSTR moves[] = { "\x1bD", "\x1bM", "\n" };
+
+    std::string s;
+    const auto count = CFuzzChance::GetRandom<USHORT>(16, 1024);
+    for (USHORT i = 0; i < count; i++)
+    {
+        AppendFormat(s, "%s%d;%dr", CSI, CFuzzChance::GetRandom<BYTE>(), CFuzzChance::GetRandom<BYTE>());
+        if (CFuzzChance::GetRandom<BYTE>(0, 1))
+        {
+            AppendFormat(s, "%s%d%s", CSI, CFuzzChance::GetRandom<USHORT>(), CFuzzChance::SelectOne(scrolls, ARRAYSIZE(scrolls)));
+        }
+        else
+        {
+            s.append(CFuzzChance::SelectOne(moves, ARRAYSIZE(moves)));
+        }
+    }
+    return s;
+}
+
+// Sequences that repeat their work as often as their parameter says,
+// with parameters at or near the largest value the parser accepts.
+std::string GenerateMaxRepeatToken()
+{
+    const LPCSTR tokens[] = { "b", "@", "P", "X", "L", "M", "S", "T", "I", "Z", "E", "F", "J", "K" };
+    const _fuzz_type_entry<DWORD> ftMap[] = {
+        { 50, [](DWORD) { return 65535ul; } },
+        { 25, [](DWORD) { return CFuzzChance::GetRandom<DWORD>(); } },
+        { 25, [](DWORD) { return CFuzzChance::GetRandom<DWORD>(0x1000, 0xFFFF); } }
+    };
+    CFuzzType<DWORD> ft(FUZZ_MAP(ftMap), 0);
+
+    // REP repeats the last printed character, so there needs to be one.
+    std::string s("x");
+    AppendFormat(s, "%s%lu%s", CSI, (DWORD)ft, CFuzzChance::SelectOne(tokens, ARRAYSIZE(tokens)));
+    return s;
+}
+
+// OSC strings as long as the parser permits and then some.
+std::string GenerateGiantOscToken()
+{
+    const LPCSTR prefixes[] = { "0;", "2;", "4;1;", "8;;", "8;id=", "9;9;", "10;", "52;c;", "133;A" };
+    const LPCSTR terminators[] = { "\x07", "\x1b\\", "" };
+
+    std::string s(OSC);
+    s.append(CFuzzChance::SelectOne(prefixes, ARRAYSIZE(prefixes)));
+    s.append(CFuzzChance::GetRandom<DWORD>(0x1000, 0x40000), static_cast<char>(CFuzzChance::GetRandom<BYTE>(0x20, 0x7e)));
+    s.append(CFuzzChance::SelectOne(terminators, ARRAYSIZE(terminators)));
+    return s;
+}
+
+// Far more parameters and sub-parameters than any sequence takes.
+std::string GenerateParameterFloodToken()
+{
+    const LPCSTR tokens[] = { "m", "H", "r", "h", "l", "t", "$x" };
+    const LPCSTR separators[] = { ";", ":" };
+
+    std::string s(CSI);
+    const auto count = CFuzzChance::GetRandom<USHORT>(32, 4096);
+    for (USHORT i = 0; i < count; i++)
+    {
+        AppendFormat(s, "%d%s", CFuzzChance::GetRandom<USHORT>(), CFuzzChance::SelectOne(separators, ARRAYSIZE(separators)));
+    }
+    s.append(CFuzzChance::SelectOne(tokens, ARRAYSIZE(tokens)));
+    return s;
+}
+
+// Resizes the buffer, possibly to its maximum size, and fills all of it.
+std::string GenerateResizeToken()
+{
+    std::string s;
+    AppendFormat(s, "%s8;%d;%dt", CSI, CFuzzChance::GetRandom<USHORT>(), CFuzzChance::GetRandom<USHORT>());
+    const LPCSTR fills[] = { "\x1b#8", "\x1b[?3h", "\x1b[?3l", "\x1b[2J", "\x1b[3J" };
+    s.append(CFuzzChance::SelectOne(fills, ARRAYSIZE(fills)));
+    return s;
+}
+
+// Sets a tab stop in every column and jumps across all of them.
+std::string GenerateTabStopToken()
+{
+    std::string s;
+    const auto count = CFuzzChance::GetRandom<USHORT>(16, 1024);
+    for (USHORT i = 0; i < count; i++)
+    {
+        s.append(" \x1bH");
+    }
+    AppendFormat(s, "%s%dI%s%dZ", CSI, CFuzzChance::GetRandom<USHORT>(), CSI, CFuzzChance::GetRandom<USHORT>());
+    return s;
+}
+
 int __cdecl wmain(int argc, WCHAR* argv[])
 {
-    if (argc != 3)
+    const auto slow = argc == 4 && _wcsicmp(argv[3], L"slow") == 0;
+    if (argc != 3 && !slow)
     {
-        wprintf(L"Usage: <file count> <output directory>");
+        wprintf(L"Usage: <file count> <output directory> [slow]");
         return -1;
     }
 
@@ -634,7 +759,7 @@ int __cdecl wmain(int argc, WCHAR* argv[])
                 std::string text;
                 for (auto j = 0; j < CFuzzChance::GetRandom<BYTE>(); j++)
                 {
-                    text.append(GenerateToken());
+                    text.append(slow ? GenerateSlowToken() : GenerateToken());
                 }
 
                 wil::com_ptr<IStream> spStream;
@@ -18,9 +18,11 @@ StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine, const bo
     _parameters{},
     _parameterLimitReached(false),
     _oscString{},
-    _cachedSequence{ std::nullopt },
+    _oscStringLimitReached(false),
+    _cachedSequence{},
     _processingIndividually(false)
 {
+    _oscString.reserve(OSC_STRING_INITIAL_CAPACITY);
     _ActionClear();
 }
 
@@ -379,6 +381,138 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 
 #pragma warning(pop)
 
+// Routine Description:
+// - Finds the next character that _isActionableFromGround, starting at the given offset.
+//   This is the hot loop when printing plain text, so it checks 16 (AVX2) or 8 (SSE2, NEON)
+//   characters at once. The actionable characters form just 2 ranges:
+//   * 0x00-0x1F: C0 control characters, including ESC
+//   * 0x7F-0x9F: DEL and the C1 control characters
+//   Using unsigned saturating subtraction, a character is <= N if subs(wch, N) == 0.
+//   The second range is checked the same way after shifting it down by 0x7F.
+// Arguments:
+// - string - The string to search.
+// - offset - The index to start searching at.
+// Return Value:
+// - The index of the first actionable character, or string.size() if there is none.
+static size_t _findActionableFromGround(const std::wstring_view string, const size_t offset) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    const auto beg = string.data();
+    const auto end = beg + string.size();
+    auto it = beg + offset;
+
+#ifdef __AVX2__
+    const auto c0Max = _mm256_set1_epi16(0x1F);
+    const auto c1Min = _mm256_set1_epi16(0x7F);
+    const auto c1Range = _mm256_set1_epi16(0x9F - 0x7F);
+    const auto zero = _mm256_setzero_si256();
+
+    for (; end - it >= 16; it += 16)
+    {
+        const auto wch = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const auto isC0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(wch, c0Max), zero);
+        const auto isC1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(wch, c1Min), c1Range), zero);
+        // _mm256_movemask_epi8 yields 2 bits per wchar_t --> the index must be divided by 2.
+        const auto mask = gsl::narrow_cast<unsigned long>(_mm256_movemask_epi8(_mm256_or_si256(isC0, isC1)));
+        unsigned long index;
+        if (_BitScanForward(&index, mask))
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + index / 2;
+        }
+    }
+#elif _M_AMD64
+    // The same as the AVX2 code above, just with 8 instead of 16 characters at a time.
+    const auto c0Max = _mm_set1_epi16(0x1F);
+    const auto c1Min = _mm_set1_epi16(0x7F);
+    const auto c1Range = _mm_set1_epi16(0x9F - 0x7F);
+    const auto zero = _mm_setzero_si128();
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto isC0 = _mm_cmpeq_epi16(_mm_subs_epu16(wch, c0Max), zero);
+        const auto isC1 = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(wch, c1Min), c1Range), zero);
+        const auto mask = gsl::narrow_cast<unsigned long>(_mm_movemask_epi8(_mm_or_si128(isC0, isC1)));
+        unsigned long index;
+        if (_BitScanForward(&index, mask))
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + index / 2;
+        }
+    }
+#elif _M_ARM64
+    // NEON has unsigned comparisons, but no movemask. If any of the 8 characters
+    // is actionable we leave the loop and let the scalar loop below find it.
+    const auto c0Max = vdupq_n_u16(0x1F);
+    const auto c1Min = vdupq_n_u16(0x7F);
+    const auto c1Range = vdupq_n_u16(0x9F - 0x7F);
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto wch = vld1q_u16(reinterpret_cast<const uint16_t*>(it));
+        const auto isC0 = vcleq_u16(wch, c0Max);
+        const auto isC1 = vcleq_u16(vsubq_u16(wch, c1Min), c1Range);
+        if (vmaxvq_u16(vorrq_u16(isC0, isC1)))
+        {
+            break;
+        }
+    }
+#endif
+
+    for (; it < end && !_isActionableFromGround(*it); ++it)
+    {
+    }
+
+    return gsl::narrow_cast<size_t>(it - beg);
+#pragma warning(pop)
+}
+
+// Routine Description:
+// - Finds the end of the run of characters starting at the given offset, that
+//   _EventDcsPassThrough would hand to the string handler unmodified.
+//   This excludes ESC, CAN and SUB, which end the data string.
+// Arguments:
+// - string - The string to search.
+// - offset - The index to start searching at.
+// Return Value:
+// - The index of the first character that isn't part of the run, or string.size().
+static size_t _findDcsPassThroughRunEnd(const std::wstring_view string, size_t offset) noexcept
+{
+    for (; offset < string.size(); ++offset)
+    {
+        const auto wch = til::at(string, offset);
+        if (!_isC0Code(wch) && !_isDcsPassThroughValid(wch))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
+// Routine Description:
+// - Finds the end of the run of characters starting at the given offset, that
+//   _EventOscString would store in the OSC string. This excludes all C0 and
+//   C1 control characters, since they either terminate the string, are ignored,
+//   or are handled by ProcessCharacter before _EventOscString sees them.
+// Arguments:
+// - string - The string to search.
+// - offset - The index to start searching at.
+// Return Value:
+// - The index of the first character that isn't part of the run, or string.size().
+static size_t _findOscStringRunEnd(const std::wstring_view string, size_t offset) noexcept
+{
+    for (; offset < string.size(); ++offset)
+    {
+        const auto wch = til::at(string, offset);
+        if (wch < AsciiChars::SPC || _isC1ControlCharacter(wch))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should immediately respond to a C0 control character.
 // Arguments:
@@ -563,6 +697,7 @@ void StateMachine::_ActionClear()
 
     _oscString.clear();
     _oscParameter = 0;
+    _oscStringLimitReached = false;
 
     _dcsStringHandler = nullptr;
 
@@ -594,7 +729,7 @@ void StateMachine::_ActionInterrupt()
     if (_state == VTStates::DcsPassThrough)
     {
         // The ESC signals the end of the data string.
-        _dcsStringHandler(AsciiChars::ESC);
+        _dcsStringHandler(L"\x1b");
         _dcsStringHandler = nullptr;
     }
 }
@@ -622,7 +757,26 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    _ActionOscPutString({ &wch, 1 });
+}
+
+// Routine Description:
+// - Stores a run of characters as part of the OSC string, unless that would
+//   exceed OSC_STRING_MAX_LENGTH, in which case the sequence is ignored.
+// Arguments:
+// - run - Characters to store.
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscPutString(const std::wstring_view run)
+{
+    if (_oscStringLimitReached || run.size() > OSC_STRING_MAX_LENGTH - _oscString.size())
+    {
+        _oscStringLimitReached = true;
+        _oscString.clear();
+        return;
+    }
+
+    _oscString.append(run);
 }
 
 // Routine Description:
@@ -635,6 +789,11 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscDispatch");
+    if (_oscStringLimitReached)
+    {
+        _ActionIgnore();
+        return;
+    }
     _trace.DispatchSequenceTrace(_SafeExecuteWithLog(wch, [=]() {
         return _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
     }));
@@ -699,7 +858,7 @@ void StateMachine::_ActionDcsDispatch(const wchar_t wch)
 void StateMachine::_EnterGround() noexcept
 {
     _state = VTStates::Ground;
-    _cachedSequence.reset(); // entering ground means we've completed the pending sequence
+    _cachedSequence.clear(); // entering ground means we've completed the pending sequence
     _trace.TraceStateChange(L"Ground");
 }
 
@@ -919,7 +1078,7 @@ void StateMachine::_EnterDcsParam() noexcept
 void StateMachine::_EnterDcsIgnore() noexcept
 {
     _state = VTStates::DcsIgnore;
-    _cachedSequence.reset();
+    _cachedSequence.clear();
     _trace.TraceStateChange(L"DcsIgnore");
 }
 
@@ -951,7 +1110,7 @@ void StateMachine::_EnterDcsIntermediate() noexcept
 void StateMachine::_EnterDcsPassThrough() noexcept
 {
     _state = VTStates::DcsPassThrough;
-    _cachedSequence.reset();
+    _cachedSequence.clear();
     _trace.TraceStateChange(L"DcsPassThrough");
 }
 
@@ -968,7 +1127,7 @@ void StateMachine::_EnterDcsPassThrough() noexcept
 void StateMachine::_EnterSosPmApcString() noexcept
 {
     _state = VTStates::SosPmApcString;
-    _cachedSequence.reset();
+    _cachedSequence.clear();
     _trace.TraceStateChange(L"SosPmApcString");
 }
 
@@ -1660,10 +1819,7 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     _trace.TraceOnEvent(L"DcsPassThrough");
     if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
     {
-        if (!_dcsStringHandler(wch))
-        {
-            _EnterDcsIgnore();
-        }
+        _ActionDcsPassThroughString({ &wch, 1 });
     }
     else
     {
@@ -1671,6 +1827,22 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     }
 }
 
+// Routine Description:
+// - Hands a run of DCS data string characters to the string handler. Outside of
+//   _EventDcsPassThrough this is used by ProcessString to skip the per-character
+//   state machine for runs of characters that _EventDcsPassThrough would accept.
+// Arguments:
+// - run - Characters that are part of the data string
+// Return Value:
+// - <none>
+void StateMachine::_ActionDcsPassThroughString(const std::wstring_view run)
+{
+    if (!_dcsStringHandler(run))
+    {
+        _EnterDcsIgnore();
+    }
+}
+
 // Routine Description:
 // - Handle SOS/PM/APC string.
 //   In this state the entire string is ignored.
@@ -1793,15 +1965,15 @@ bool StateMachine::FlushToTerminal()
 {
     auto success{ true };
 
-    if (success && _cachedSequence.has_value())
+    if (success && !_cachedSequence.empty())
     {
         // Flush the partial sequence to the terminal before we flush the rest of it.
         // We always want to clear the sequence, even if we failed, so we don't accumulate bad state
         // and dump it out elsewhere later.
         success = _SafeExecute([=]() {
-            return _engine->ActionPassThroughString(*_cachedSequence);
+            return _engine->ActionPassThroughString(_cachedSequence);
         });
-        _cachedSequence.reset();
+        _cachedSequence.clear();
     }
 
     if (success)
@@ -1829,6 +2001,8 @@ bool StateMachine::FlushToTerminal()
 // - <none>
 void StateMachine::ProcessString(const std::wstring_view string)
 {
+    _trace.UpdateEnabled();
+
     size_t start = 0;
     auto current = start;
 
@@ -1846,6 +2020,33 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         if (_processingIndividually)
         {
+            // DCS data strings can be large (e.g. DECDLD soft fonts) and are handed
+            // over in runs up to the next character that needs the state machine.
+            if (_state == VTStates::DcsPassThrough)
+            {
+                const auto end = _findDcsPassThroughRunEnd(string, current);
+                if (end != current)
+                {
+                    _trace.TraceOnEvent(L"DcsPassThrough");
+                    _processingLastCharacter = end >= string.size();
+                    _ActionDcsPassThroughString(string.substr(current, end - current));
+                    current = end;
+                    continue;
+                }
+            }
+            // The same applies to OSC strings (e.g. OSC 52 clipboard writes).
+            else if (_state == VTStates::OscString)
+            {
+                const auto end = _findOscStringRunEnd(string, current);
+                if (end != current)
+                {
+                    _trace.TraceOnEvent(L"OscString");
+                    _ActionOscPutString(string.substr(current, end - current));
+                    current = end;
+                    continue;
+                }
+            }
+
             // Note whether we're dealing with the last character in the buffer.
             _processingLastCharacter = (current + 1 >= string.size());
             // If we're processing characters individually, send it to the state machine.
@@ -1876,7 +2077,9 @@ void StateMachine::ProcessString(const std::wstring_view string)
             }
             else
             {
-                ++current; // Otherwise, add this char to the current run to be printed.
+                // Otherwise, add this char and all printable ones following it to the current run.
+                // If we find an actionable character, it'll be handled by the branch above in the next iteration.
+                current = _findActionableFromGround(string, current + 1);
             }
         }
     }
@@ -1972,15 +2175,11 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // thing to the terminal later. There is no need to do this if we've
             // reached one of the string processing states, though, since that data
             // will be dealt with as soon as it is received.
-            if (!_cachedSequence)
-            {
-                _cachedSequence.emplace(std::wstring{});
-            }
-
-            auto& cachedSequence = *_cachedSequence;
-            cachedSequence.append(run);
+            _cachedSequence.append(run);
         }
     }
+
+    _engine->DispatchPending();
 }
 
 // Routine Description:
@@ -1996,6 +2195,18 @@ bool StateMachine::IsProcessingLastCharacter() const noexcept
     return _processingLastCharacter;
 }
 
+// Routine Description:
+// - Returns how many escape and control sequences were dispatched since the
+//   state machine was created, whether the engine handled them or not.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of dispatched sequences.
+size_t StateMachine::GetSequenceCount() const noexcept
+{
+    return _sequenceCount;
+}
+
 // Routine Description:
 // - Wherever the state machine is, whatever it's going, go back to ground.
 //     This is used by conhost to "jiggle the handle" - when VT support is
@@ -2051,6 +2262,8 @@ catch (...)
 template<typename TLambda>
 bool StateMachine::_SafeExecuteWithLog(const wchar_t wch, TLambda&& lambda)
 {
+    // This is what every one of the sequence dispatch actions goes through.
+    ++_sequenceCount;
     const bool success = _SafeExecute(std::forward<TLambda>(lambda));
     if (!success)
     {
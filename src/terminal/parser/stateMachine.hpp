@@ -32,6 +32,14 @@ namespace Microsoft::Console::VirtualTerminal
     // that number.
     constexpr size_t MAX_PARAMETER_COUNT = 32;
 
+    // OSC strings up to this length (window titles, hyperlinks, working
+    // directories and the like) are collected without allocating.
+    constexpr size_t OSC_STRING_INITIAL_CAPACITY = 512;
+
+    // OSC strings longer than this are ignored instead of being dispatched. The biggest
+    // legitimate ones are OSC 52 clipboard writes, which are base64 encoded.
+    constexpr size_t OSC_STRING_MAX_LENGTH = 16 * 1024 * 1024;
+
     class StateMachine final
     {
 #ifdef UNIT_TESTING
@@ -59,6 +67,7 @@ namespace Microsoft::Console::VirtualTerminal
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
         bool IsProcessingLastCharacter() const noexcept;
+        size_t GetSequenceCount() const noexcept;
 
         void ResetState() noexcept;
 
@@ -86,6 +95,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
         void _ActionOscPut(const wchar_t wch);
+        void _ActionOscPutString(const std::wstring_view run);
         void _ActionOscDispatch(const wchar_t wch);
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsDispatch(const wchar_t wch);
@@ -132,6 +142,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventDcsIntermediate(const wchar_t wch);
         void _EventDcsParam(const wchar_t wch);
         void _EventDcsPassThrough(const wchar_t wch);
+        void _ActionDcsPassThroughString(const std::wstring_view run);
         void _EventSosPmApcString(const wchar_t wch) noexcept;
 
         void _AccumulateTo(const wchar_t wch, VTInt& value) noexcept;
@@ -177,6 +188,9 @@ namespace Microsoft::Console::VirtualTerminal
         size_t _runOffset;
         size_t _runSize;
 
+        // The number of escape and control sequences that were dispatched so far.
+        size_t _sequenceCount = 0;
+
         // Construct current run.
         //
         // Note: We intentionally use this method to create the run lazily for better performance.
@@ -187,15 +201,18 @@ namespace Microsoft::Console::VirtualTerminal
         }
 
         VTIDBuilder _identifier;
-        std::vector<VTParameter> _parameters;
+        boost::container::static_vector<VTParameter, MAX_PARAMETER_COUNT> _parameters;
         bool _parameterLimitReached;
 
         std::wstring _oscString;
         VTInt _oscParameter;
+        bool _oscStringLimitReached;
 
         IStateMachineEngine::StringHandler _dcsStringHandler;
 
-        std::optional<std::wstring> _cachedSequence;
+        // Empty if there's no partial sequence. Cleared rather than destroyed,
+        // so that its storage is reused for the next partial sequence.
+        std::wstring _cachedSequence;
 
         // This is tracked per state machine instance so that separate calls to Process*
         //   can start and finish a sequence.
@@ -10,7 +10,7 @@ using namespace Microsoft::Console::VirtualTerminal;
 #pragma warning(disable : 26447) // The function is declared 'noexcept' but calls function '_tlgWrapBinary<wchar_t>()' which may throw exceptions
 #pragma warning(disable : 26477) // Use 'nullptr' rather than 0 or NULL
 
-void ParserTracing::TraceStateChange(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_TraceStateChange(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_EnterState",
@@ -19,7 +19,7 @@ void ParserTracing::TraceStateChange(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnAction(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_TraceOnAction(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_Action",
@@ -28,7 +28,7 @@ void ParserTracing::TraceOnAction(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnExecute(const wchar_t wch) const noexcept
+void ParserTracing::_TraceOnExecute(const wchar_t wch) const noexcept
 {
     const auto sch = gsl::narrow_cast<INT16>(wch);
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
@@ -39,7 +39,7 @@ void ParserTracing::TraceOnExecute(const wchar_t wch) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
+void ParserTracing::_TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
 {
     const auto sch = gsl::narrow_cast<INT16>(wch);
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
@@ -50,7 +50,7 @@ void ParserTracing::TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_Event",
@@ -59,10 +59,8 @@ void ParserTracing::TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceCharInput(const wchar_t wch)
+void ParserTracing::_TraceCharInput(const wchar_t wch) const noexcept
 {
-    AddSequenceTrace(wch);
-
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_NewChar",
                       TraceLoggingWChar(wch),
@@ -74,7 +72,7 @@ void ParserTracing::TraceCharInput(const wchar_t wch)
 void ParserTracing::AddSequenceTrace(const wchar_t wch)
 {
     // Don't waste time storing this if no one is listening.
-    if (TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+    if (_enabled)
     {
         _sequenceTrace.push_back(wch);
     }
@@ -108,7 +106,7 @@ void ParserTracing::ClearSequenceTrace() noexcept
 }
 
 // NOTE: I'm expecting this to not be null terminated
-void ParserTracing::DispatchPrintRunTrace(const std::wstring_view& string) const
+void ParserTracing::_DispatchPrintRunTrace(const std::wstring_view& string) const
 {
     if (string.size() == 1)
     {
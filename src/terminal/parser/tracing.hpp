@@ -34,19 +34,100 @@ namespace Microsoft::Console::VirtualTerminal
         // C-strings is more ergonomic instead and fits the need for
         // high performance in this particular code.
 
-        void TraceStateChange(_In_z_ const wchar_t* name) const noexcept;
-        void TraceOnAction(_In_z_ const wchar_t* name) const noexcept;
-        void TraceOnExecute(const wchar_t wch) const noexcept;
-        void TraceOnExecuteFromEscape(const wchar_t wch) const noexcept;
-        void TraceOnEvent(_In_z_ const wchar_t* name) const noexcept;
-        void TraceCharInput(const wchar_t wch);
+        //
+        // The trace methods are called for every character the state machine
+        // processes. They're inline and only test a flag, which UpdateEnabled()
+        // sets once per string, because even the enabled check inside of
+        // TraceLoggingWrite adds up at that rate. The per-character events are
+        // only of use when debugging the parser itself and are compiled out of
+        // release builds entirely.
+
+        void UpdateEnabled() noexcept
+        {
+            _enabled = TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+        }
+
+        void TraceStateChange(_In_z_ const wchar_t* name) const noexcept
+        {
+            if (_tracesCharacters && _enabled)
+            {
+                _TraceStateChange(name);
+            }
+        }
+
+        void TraceOnAction(_In_z_ const wchar_t* name) const noexcept
+        {
+            if (_tracesCharacters && _enabled)
+            {
+                _TraceOnAction(name);
+            }
+        }
+
+        void TraceOnExecute(const wchar_t wch) const noexcept
+        {
+            if (_tracesCharacters && _enabled)
+            {
+                _TraceOnExecute(wch);
+            }
+        }
+
+        void TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
+        {
+            if (_tracesCharacters && _enabled)
+            {
+                _TraceOnExecuteFromEscape(wch);
+            }
+        }
+
+        void TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
+        {
+            if (_tracesCharacters && _enabled)
+            {
+                _TraceOnEvent(name);
+            }
+        }
+
+        void TraceCharInput(const wchar_t wch)
+        {
+            if (_enabled)
+            {
+                AddSequenceTrace(wch);
+
+                if constexpr (_tracesCharacters)
+                {
+                    _TraceCharInput(wch);
+                }
+            }
+        }
 
         void AddSequenceTrace(const wchar_t wch);
         void DispatchSequenceTrace(const bool fSuccess) noexcept;
         void ClearSequenceTrace() noexcept;
-        void DispatchPrintRunTrace(const std::wstring_view& string) const;
+
+        void DispatchPrintRunTrace(const std::wstring_view& string) const
+        {
+            if (_enabled)
+            {
+                _DispatchPrintRunTrace(string);
+            }
+        }
 
     private:
+#ifdef NDEBUG
+        static constexpr bool _tracesCharacters = false;
+#else
+        static constexpr bool _tracesCharacters = true;
+#endif
+
+        void _TraceStateChange(_In_z_ const wchar_t* name) const noexcept;
+        void _TraceOnAction(_In_z_ const wchar_t* name) const noexcept;
+        void _TraceOnExecute(const wchar_t wch) const noexcept;
+        void _TraceOnExecuteFromEscape(const wchar_t wch) const noexcept;
+        void _TraceOnEvent(_In_z_ const wchar_t* name) const noexcept;
+        void _TraceCharInput(const wchar_t wch) const noexcept;
+        void _DispatchPrintRunTrace(const std::wstring_view& string) const;
+
         std::wstring _sequenceTrace;
+        bool _enabled = false;
     };
 }
@@ -276,6 +276,8 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
+    TEST_METHOD(TestWin32InputBatching);
+    TEST_METHOD(TestStringToInputRecords);
 
     friend class TestInteractDispatch;
 };
@@ -319,6 +321,7 @@ public:
     TestInteractDispatch(_In_ std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> pfn,
                          _In_ TestState* testState);
     virtual bool WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
+    virtual bool WriteInput(const gsl::span<const INPUT_RECORD> records) override;
 
     virtual bool WriteCtrlKey(const KeyEvent& event) override;
     virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
@@ -351,6 +354,12 @@ bool TestInteractDispatch::WriteInput(_In_ std::deque<std::unique_ptr<IInputEven
     return true;
 }
 
+bool TestInteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> records)
+{
+    auto inputEvents = IInputEvent::Create(records);
+    return WriteInput(inputEvents);
+}
+
 bool TestInteractDispatch::WriteCtrlKey(const KeyEvent& event)
 {
     VERIFY_IS_TRUE(_testState->_expectSendCtrlC);
@@ -1615,3 +1624,64 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::TestWin32InputBatching()
+{
+    std::vector<std::vector<INPUT_RECORD>> writes;
+    auto pfn = [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        writes.emplace_back(IInputEvent::ToInputRecords(inEvents));
+    };
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+
+    Log::Comment(L"Plain keys are written in a single batch, at the end of the string.");
+    stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[65;30;97;0;0;1_\x1b[66;48;98;1;0;1_\x1b[66;48;98;0;0;1_");
+    VERIFY_ARE_EQUAL(1u, writes.size());
+    VERIFY_ARE_EQUAL(4u, writes.at(0).size());
+    VERIFY_ARE_EQUAL(L'a', writes.at(0).at(0).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_IS_TRUE(writes.at(0).at(0).Event.KeyEvent.bKeyDown);
+    VERIFY_IS_FALSE(writes.at(0).at(1).Event.KeyEvent.bKeyDown);
+    VERIFY_ARE_EQUAL(L'b', writes.at(0).at(2).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(static_cast<WORD>(0x42), writes.at(0).at(3).Event.KeyEvent.wVirtualKeyCode);
+
+    Log::Comment(L"Other input flushes the batch first, to preserve the order.");
+    writes.clear();
+    stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[A");
+    VERIFY_ARE_EQUAL(2u, writes.size());
+    VERIFY_ARE_EQUAL(1u, writes.at(0).size());
+    VERIFY_ARE_EQUAL(L'a', writes.at(0).at(0).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(static_cast<WORD>(VK_UP), writes.at(1).back().Event.KeyEvent.wVirtualKeyCode);
+}
+
+void InputEngineTest::TestStringToInputRecords()
+{
+    Log::Comment(L"StringToInputRecords must produce the same keystrokes as CharToKeyEvents.");
+    const std::wstring_view string{ L"Hello, World!\r\n~|\x00e9\x20ac\x3042 AAA" };
+
+    std::vector<INPUT_RECORD> expected;
+    for (const auto wch : string)
+    {
+        for (const auto& keyEvent : Microsoft::Console::Interactivity::CharToKeyEvents(wch, CP_USA))
+        {
+            expected.emplace_back(keyEvent->ToInputRecord());
+        }
+    }
+
+    std::vector<INPUT_RECORD> actual;
+    Microsoft::Console::Interactivity::StringToInputRecords(string, CP_USA, actual);
+
+    VERIFY_ARE_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        const auto& e = expected.at(i).Event.KeyEvent;
+        const auto& a = actual.at(i).Event.KeyEvent;
+        VERIFY_ARE_EQUAL(expected.at(i).EventType, actual.at(i).EventType);
+        VERIFY_ARE_EQUAL(e.bKeyDown, a.bKeyDown);
+        VERIFY_ARE_EQUAL(e.wRepeatCount, a.wRepeatCount);
+        VERIFY_ARE_EQUAL(e.wVirtualKeyCode, a.wVirtualKeyCode);
+        VERIFY_ARE_EQUAL(e.wVirtualScanCode, a.wVirtualScanCode);
+        VERIFY_ARE_EQUAL(e.uChar.UnicodeChar, a.uChar.UnicodeChar);
+        VERIFY_ARE_EQUAL(e.dwControlKeyState, a.dwControlKeyState);
+    }
+}
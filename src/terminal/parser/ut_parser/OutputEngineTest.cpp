@@ -259,6 +259,23 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
 
+    TEST_METHOD(TestSequenceCount)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        VERIFY_ARE_EQUAL(0u, mach.GetSequenceCount());
+
+        // Printable text and C0 controls aren't sequences.
+        mach.ProcessString(L"abc\r\n");
+        VERIFY_ARE_EQUAL(0u, mach.GetSequenceCount());
+
+        // An ESC, a CSI and an OSC sequence.
+        mach.ProcessString(L"\x1b7\x1b[1;2H\x1b]0;title\x07");
+        VERIFY_ARE_EQUAL(3u, mach.GetSequenceCount());
+    }
+
     TEST_METHOD(TestC1CsiEntry)
     {
         auto dispatch = std::make_unique<DummyDispatch>();
@@ -548,6 +565,43 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
 
+    TEST_METHOD(TestOscStringSplitAcrossWrites)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        // Control characters that are invalid in OSC strings are ignored, even in between runs.
+        mach.ProcessString(L"\x1b]0;some\x01 te");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::OscString);
+        mach.ProcessString(L"xt");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::OscString);
+        VERIFY_ARE_EQUAL(L"some text", mach._oscString);
+        mach.ProcessString(L"\x1b\\");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+    }
+
+    TEST_METHOD(TestOscStringLimit)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        mach.ProcessString(L"\x1b]52;c;");
+        mach.ProcessString(std::wstring(OSC_STRING_MAX_LENGTH, L'A'));
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::OscString);
+        VERIFY_IS_TRUE(mach._oscStringLimitReached);
+        VERIFY_ARE_EQUAL(0u, mach._oscString.size());
+
+        // The rest of the sequence is ignored, but it still has to be terminated.
+        mach.ProcessString(L"AAAA\x07");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+        VERIFY_ARE_EQUAL(0u, mach._oscString.size());
+
+        mach.ProcessString(L"\x1b]0;title\x07");
+        VERIFY_IS_FALSE(mach._oscStringLimitReached);
+    }
+
     TEST_METHOD(NormalTestOscParam)
     {
         auto dispatch = std::make_unique<DummyDispatch>();
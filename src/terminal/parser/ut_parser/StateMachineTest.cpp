@@ -82,6 +82,8 @@ public:
 
     bool ActionSs3Dispatch(const wchar_t /* wch */, const VTParameters /* parameters */) override { return true; };
 
+    void DispatchPending() override{};
+
     // ActionCsiDispatch is the only method that's actually implemented.
     bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override
     {
@@ -110,7 +112,8 @@ public:
             dcsParams.push_back(parameters.at(i).value_or(0));
         }
         dcsDataString.clear();
-        return [=](const auto ch) { dcsDataString += ch; return true; };
+        dcsRunCount = 0;
+        return [=](const auto run) { dcsDataString += run; ++dcsRunCount; return true; };
     }
 
     // These will only be populated if ActionCsiDispatch is called.
@@ -133,6 +136,7 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+    size_t dcsRunCount = 0;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -154,9 +158,11 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(BulkTextPrintWithControlCharacters);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+    TEST_METHOD(DcsDataStringsReceivedInRuns);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachOther()
@@ -229,6 +235,42 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::BulkTextPrintWithControlCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The boundaries of the ranges that the vectorized ground state scan looks for.
+    // 0x20, 0x7E and 0xA0 are printable, while 0x1F and 0x7F must be executed.
+    const std::wstring_view printable{ L"\x20\x7e\xa0\xffff" };
+    const std::wstring_view executable{ L"\x00\x1f\x7f", 3 };
+
+    // Place the control character at every offset within (and beyond) a vector,
+    // to test both the vectorized loop and the scalar remainder.
+    for (size_t offset = 0; offset < 40; ++offset)
+    {
+        for (const auto wch : executable)
+        {
+            std::wstring text;
+            for (size_t i = 0; i < offset; ++i)
+            {
+                text += til::at(printable, i % printable.size());
+            }
+            const auto expectedPrinted = text + text;
+            text += wch;
+            text += expectedPrinted.substr(offset);
+
+            engine.ResetTestState();
+            machine.ProcessString(text);
+
+            VERIFY_ARE_EQUAL(expectedPrinted, engine.printed);
+            VERIFY_ARE_EQUAL(std::wstring(1, wch), engine.executed);
+        }
+    }
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
@@ -337,3 +379,21 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::DcsDataStringsReceivedInRuns()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // DEL and non-ASCII characters are ignored in the data string and split it into runs.
+    machine.ProcessString(L"\033P1;2;3|data\x7fstring");
+    machine.ProcessString(L" split\u00e9across writes");
+    machine.ProcessString(L"\033\\");
+
+    VERIFY_ARE_EQUAL(VTID("|"), engine.dcsId);
+    VERIFY_ARE_EQUAL(L"datastring splitacross writes\033", engine.dcsDataString);
+    // "data", "string", " split", "across writes" and the ESC.
+    VERIFY_ARE_EQUAL(5u, engine.dcsRunCount);
+}
@@ -1099,4 +1099,79 @@ class BitmapTests
         }
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(SizeConstructWithFillLarge)
+    {
+        Log::Comment(L"Filling has to cover bitmaps larger than a single 64-bit block.");
+        const til::size sz{ 100, 50 };
+        const til::bitmap bitmap{ sz, true };
+        VERIFY_IS_TRUE(bitmap.all());
+
+        std::vector<til::rect> expected;
+        for (auto row = 0; row < sz.height; ++row)
+        {
+            expected.emplace_back(til::point{ 0, row }, til::size{ sz.width, 1 });
+        }
+        const std::vector<til::rect> actual{ bitmap.begin(), bitmap.end() };
+        VERIFY_ARE_EQUAL(expected, actual);
+    }
+
+    TEST_METHOD(RunsAcrossRowSummaries)
+    {
+        // Rows are tracked as either clean, dirty or full, which lets the
+        // iterator skip clean rows and emit full rows without testing their bits.
+        // This map --> Those runs
+        // 0 0 0 0 0      _ _ _ _ _
+        // 1 1 1 1 1      A A A A A
+        // 0 0 0 0 0      _ _ _ _ _
+        // 0 1 1 0 1      _ B B _ C
+        // 1 1 1 1 1      D D D D D
+        // 0 0 0 0 0      _ _ _ _ _
+        til::bitmap map{ til::size{ 5, 6 } };
+        VERIFY_IS_TRUE(map.none());
+
+        map.set(til::rect{ til::point{ 0, 1 }, til::size{ 5, 1 } });
+        map.set(til::rect{ til::point{ 1, 3 }, til::size{ 2, 1 } });
+        map.set(til::point{ 4, 3 });
+        // A row that's dirty, but not known to be full, as it's assembled from individual points.
+        for (auto x = 0; x < 5; ++x)
+        {
+            map.set(til::point{ x, 4 });
+        }
+        VERIFY_IS_TRUE(map.any());
+
+        const std::vector<til::rect> expected{
+            til::rect{ til::point{ 0, 1 }, til::size{ 5, 1 } },
+            til::rect{ til::point{ 1, 3 }, til::size{ 2, 1 } },
+            til::rect{ til::point{ 4, 3 }, til::size{ 1, 1 } },
+            til::rect{ til::point{ 0, 4 }, til::size{ 5, 1 } },
+        };
+        std::vector<til::rect> actual{ map.begin(), map.end() };
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        Log::Comment(L"Translating moves the row summaries along with the bits.");
+        map.translate(til::point{ 0, -1 });
+        const std::vector<til::rect> expectedUp{
+            til::rect{ til::point{ 0, 0 }, til::size{ 5, 1 } },
+            til::rect{ til::point{ 1, 2 }, til::size{ 2, 1 } },
+            til::rect{ til::point{ 4, 2 }, til::size{ 1, 1 } },
+            til::rect{ til::point{ 0, 3 }, til::size{ 5, 1 } },
+        };
+        actual.assign(map.begin(), map.end());
+        VERIFY_ARE_EQUAL(expectedUp, actual);
+
+        Log::Comment(L"Translating everything out of the bitmap leaves nothing behind.");
+        map.translate(til::point{ 0, 6 });
+        VERIFY_IS_TRUE(map.none());
+        VERIFY_IS_TRUE(map.begin() == map.end());
+    }
+
+    TEST_METHOD(NoneWithoutColumns)
+    {
+        Log::Comment(L"A bitmap without any columns has no bits to set.");
+        til::bitmap bitmap{ til::size{ 0, 5 }, true };
+        VERIFY_IS_TRUE(bitmap.none());
+        bitmap.set_all();
+        VERIFY_IS_TRUE(bitmap.none());
+    }
 };
@@ -43,4 +43,19 @@ class HashTests
 #endif
         }
     }
+
+    TEST_METHOD(TransparentStringHash)
+    {
+        std::unordered_map<std::wstring, int, til::transparent_string_hash<wchar_t>, std::equal_to<>> map;
+        map.emplace(L"foo", 1);
+        map.emplace(L"foobar", 2);
+
+        const std::wstring_view view{ L"foobarbaz" };
+        VERIFY_ARE_EQUAL(til::transparent_string_hash<wchar_t>{}(std::wstring{ L"foo" }), til::transparent_string_hash<wchar_t>{}(view.substr(0, 3)));
+
+        const auto it = map.find(view.substr(0, 6));
+        VERIFY_IS_TRUE(it != map.end());
+        VERIFY_ARE_EQUAL(2, it->second);
+        VERIFY_IS_TRUE(map.find(view) == map.end());
+    }
 };
@@ -295,6 +295,44 @@ class RunLengthEncodingTests
         VERIFY_ARE_EQUAL("3|2|1 1"sv, rle.slice(2, 6));
     }
 
+    TEST_METHOD(ForEachRun)
+    {
+        rle_vector rle{
+            {
+                { 1, 1 },
+                { 3, 2 },
+                { 2, 1 },
+                { 1, 3 },
+                { 5, 2 },
+            }
+        };
+
+        // for_each_run() should visit the same runs that slice() returns.
+        const auto runs = [&](size_type start_index, size_type end_index) {
+            rle_container container;
+            rle.for_each_run(start_index, end_index, [&](const value_type value, const size_type length) {
+                container.emplace_back(value, length);
+            });
+            return rle_vector{ std::move(container) };
+        };
+
+        // empty
+        VERIFY_ARE_EQUAL(""sv, runs(0, 0)); // begin
+        VERIFY_ARE_EQUAL(""sv, runs(2, 2)); // within a run
+        VERIFY_ARE_EQUAL(""sv, runs(rle.size(), rle.size())); // end
+        VERIFY_ARE_EQUAL(""sv, runs(5, 0)); // end_index > begin_index
+        VERIFY_ARE_EQUAL(""sv, runs(1000, 900)); // end_index > begin_index
+        // full range
+        VERIFY_ARE_EQUAL("1|3 3|2|1 1 1|5 5"sv, runs(0, rle.size()));
+        VERIFY_ARE_EQUAL("1|3 3|2|1 1 1|5 5"sv, runs(0, 1000));
+        // between two runs -> within a run
+        VERIFY_ARE_EQUAL("3 3|2|1"sv, runs(1, 5));
+        // within a run -> between two runs
+        VERIFY_ARE_EQUAL("3|2|1 1 1"sv, runs(2, 7));
+        // within a run -> within the same run
+        VERIFY_ARE_EQUAL("1"sv, runs(5, 6));
+    }
+
     TEST_METHOD(Replace)
     {
         struct TestCase
@@ -4,6 +4,7 @@
 #include "precomp.h"
 #include "WexTestClass.h"
 
+#include <til/mpsc.h>
 #include <til/spsc.h>
 
 using namespace WEX::Common;
@@ -57,8 +58,23 @@ class SPSCTests
     TEST_METHOD(DropSameRevolutionTest);
     TEST_METHOD(DropDifferentRevolutionTest);
     TEST_METHOD(IntegrationTest);
+    TEST_METHOD(Benchmark);
+
+    TEST_METHOD(MPSCSmokeTest);
+    TEST_METHOD(MPSCDropTest);
+    TEST_METHOD(MPSCIntegrationTest);
+    TEST_METHOD(MPSCBenchmark);
 };
 
+static constexpr size_t benchmarkChunkSize = 256;
+static constexpr size_t benchmarkChunkCount = 64 * 1024;
+
+static void logThroughput(const wchar_t* name, std::chrono::steady_clock::duration elapsed, size_t bytes)
+{
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    Log::Comment(NoThrowString().Format(L"%s: %.1f MB/s", name, bytes / seconds / 1e6));
+}
+
 void SPSCTests::SmokeTest()
 {
     // This test mostly ensures that the API wasn't broken.
@@ -227,3 +243,184 @@ void SPSCTests::IntegrationTest()
 
     t.join();
 }
+
+void SPSCTests::Benchmark()
+{
+    // Not a correctness test: it logs the throughput of byte-sized items pushed in chunks,
+    // so that it can be compared against MPSCBenchmark, which pushes the same chunks.
+    auto [tx, rx] = til::spsc::channel<char>(64 * 1024);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread t([tx = std::move(tx)]() {
+        std::array<char, benchmarkChunkSize> chunk{};
+        for (size_t i = 0; i < benchmarkChunkCount; ++i)
+        {
+            tx.push(chunk.begin(), chunk.end());
+        }
+    });
+
+    std::array<char, 4096> buffer{};
+    size_t total = 0;
+    for (;;)
+    {
+        const auto [count, ok] = rx.pop_n(til::spsc::block_initially, buffer.data(), buffer.size());
+        total += count;
+        if (!ok)
+        {
+            break;
+        }
+    }
+
+    t.join();
+    logThroughput(L"spsc", std::chrono::steady_clock::now() - start, total);
+    VERIFY_ARE_EQUAL(benchmarkChunkSize * benchmarkChunkCount, total);
+}
+
+void SPSCTests::MPSCSmokeTest()
+{
+    // This test mostly ensures that the API wasn't broken.
+
+    // construction
+    auto [tx, rx] = til::mpsc::channel(32);
+    std::array<std::byte, 3> data{};
+
+    // copy and move constructor
+    auto tx2(tx);
+    auto tx3(std::move(tx2));
+    auto rx2(std::move(rx));
+
+    // copy and move assignment operator
+    tx2 = tx3;
+    tx2 = std::move(tx3);
+    rx = std::move(rx2);
+
+    // push
+    VERIFY_IS_TRUE(tx.push(data));
+    VERIFY_IS_TRUE(tx2.push(std::string_view{ "abcd" }));
+
+    // pop
+    const auto batch = rx.pop_all();
+    VERIFY_ARE_EQUAL(7u, batch.size());
+    VERIFY_ARE_EQUAL(std::byte{ 'a' }, batch[3]);
+    VERIFY_IS_TRUE(rx.try_pop_all().empty());
+
+    // A chunk larger than the capacity is accepted into an empty queue.
+    const std::string large(64, 'x');
+    VERIFY_IS_TRUE(tx.push(large));
+    VERIFY_ARE_EQUAL(64u, rx.try_pop_all().size());
+}
+
+void SPSCTests::MPSCDropTest()
+{
+    {
+        auto [tx, rx] = til::mpsc::channel(32);
+        auto tx2 = tx;
+
+        tx.push(std::string_view{ "ab" });
+        drop(tx);
+        tx2.push(std::string_view{ "cd" });
+        drop(tx2);
+
+        // The consumer receives everything that was pushed before the last producer is gone...
+        VERIFY_ARE_EQUAL(4u, rx.pop_all().size());
+        // ...and doesn't block afterwards.
+        VERIFY_IS_TRUE(rx.pop_all().empty());
+    }
+    {
+        auto [tx, rx] = til::mpsc::channel(32);
+        drop(rx);
+        VERIFY_IS_FALSE(tx.push(std::string_view{ "ab" }));
+    }
+}
+
+void SPSCTests::MPSCIntegrationTest()
+{
+    struct chunk
+    {
+        uint32_t producer;
+        uint32_t sequence;
+    };
+
+    static constexpr uint32_t producerCount = 4;
+    static constexpr uint32_t chunkCount = 10000;
+
+    // The capacity is deliberately small to exercise the blocking path in push().
+    auto [tx, rx] = til::mpsc::channel(sizeof(chunk) * 16);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < producerCount; ++i)
+    {
+        threads.emplace_back([tx = tx, i]() {
+            for (uint32_t j = 0; j < chunkCount; ++j)
+            {
+                const chunk c{ i, j };
+                tx.push(std::as_bytes(std::span{ &c, 1 }));
+            }
+        });
+    }
+    drop(tx);
+
+    std::array<uint32_t, producerCount> expected{};
+    for (auto batch = rx.pop_all(); !batch.empty(); batch = rx.pop_all())
+    {
+        // Chunks are never interleaved with each other.
+        VERIFY_ARE_EQUAL(0u, batch.size() % sizeof(chunk));
+
+        for (size_t offset = 0; offset < batch.size(); offset += sizeof(chunk))
+        {
+            chunk c;
+            memcpy(&c, batch.data() + offset, sizeof(chunk));
+            VERIFY_IS_LESS_THAN(c.producer, producerCount);
+            // Chunks of a single producer arrive in order.
+            VERIFY_ARE_EQUAL(expected[c.producer], c.sequence);
+            ++expected[c.producer];
+        }
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (const auto count : expected)
+    {
+        VERIFY_ARE_EQUAL(chunkCount, count);
+    }
+}
+
+void SPSCTests::MPSCBenchmark()
+{
+    // See Benchmark(). The chunks are spread over multiple producers,
+    // but the total amount of data is the same.
+    static constexpr size_t producerCount = 4;
+
+    auto [tx, rx] = til::mpsc::channel(64 * 1024);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < producerCount; ++i)
+    {
+        threads.emplace_back([tx = tx]() {
+            std::array<std::byte, benchmarkChunkSize> chunk{};
+            for (size_t j = 0; j < benchmarkChunkCount / producerCount; ++j)
+            {
+                tx.push(chunk);
+            }
+        });
+    }
+    drop(tx);
+
+    size_t total = 0;
+    for (auto batch = rx.pop_all(); !batch.empty(); batch = rx.pop_all())
+    {
+        total += batch.size();
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    logThroughput(L"mpsc", std::chrono::steady_clock::now() - start, total);
+    VERIFY_ARE_EQUAL(benchmarkChunkSize * benchmarkChunkCount, total);
+}
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/pmr.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class PmrTests
+{
+    TEST_CLASS(PmrTests);
+
+    TEST_METHOD(CountingResourceCountsAllocations)
+    {
+        til::pmr::counting_resource resource;
+        VERIFY_ARE_EQUAL(0u, resource.allocations());
+        VERIFY_ARE_EQUAL(0u, resource.bytes());
+
+        {
+            std::pmr::vector<int> vec{ &resource };
+            vec.reserve(16);
+            VERIFY_ARE_EQUAL(1u, resource.allocations());
+            VERIFY_ARE_EQUAL(16 * sizeof(int), resource.bytes());
+
+            // A container that stays within its capacity doesn't allocate anymore.
+            for (auto round = 0; round < 3; ++round)
+            {
+                vec.clear();
+                vec.insert(vec.end(), 16, round);
+            }
+            VERIFY_ARE_EQUAL(1u, resource.allocations());
+        }
+
+        // The bytes are given back, but the allocation count stays.
+        VERIFY_ARE_EQUAL(1u, resource.allocations());
+        VERIFY_ARE_EQUAL(0u, resource.bytes());
+    }
+};
@@ -39,4 +39,105 @@ class ThrottledFuncTests
 
         latch.wait();
     }
+
+    TEST_METHOD(ManyInstances)
+    {
+        using namespace std::chrono_literals;
+        using throttled_func = til::throttled_func_trailing<>;
+
+        // All instances share a single timer. Those with shorter delays must
+        // not wait for the ones with longer delays and vice versa.
+        static constexpr size_t count = 256;
+        til::latch latch{ count };
+        std::atomic<size_t> calls{ 0 };
+
+        std::vector<std::unique_ptr<throttled_func>> tfs;
+        for (size_t i = 0; i < count; ++i)
+        {
+            tfs.emplace_back(std::make_unique<throttled_func>(std::chrono::milliseconds{ 1 + i % 16 }, [&]() {
+                calls.fetch_add(1, std::memory_order_relaxed);
+                latch.count_down();
+            }));
+        }
+        for (const auto& tf : tfs)
+        {
+            tf->operator()();
+            tf->operator()();
+        }
+
+        latch.wait();
+        VERIFY_ARE_EQUAL(count, calls.load());
+    }
+
+    TEST_METHOD(DestructionCancels)
+    {
+        using namespace std::chrono_literals;
+        using throttled_func = til::throttled_func_trailing<>;
+
+        std::atomic<bool> called{ false };
+        til::latch latch{ 1 };
+
+        auto canceled = std::make_unique<throttled_func>(10ms, [&]() {
+            called.store(true);
+        });
+        throttled_func other{ 50ms, [&]() {
+            latch.count_down();
+        } };
+
+        canceled->operator()();
+        other();
+        canceled.reset();
+
+        latch.wait();
+        VERIFY_IS_FALSE(called.load());
+    }
+
+    TEST_METHOD(IdleFuncWaitsForQuiet)
+    {
+        using namespace std::chrono_literals;
+        using clock = std::chrono::steady_clock;
+
+        til::latch latch{ 1 };
+        std::atomic<clock::rep> calledAt{ 0 };
+
+        til::idle_func idle{ 20ms, 10s, [&]() {
+                                calledAt.store(clock::now().time_since_epoch().count());
+                                latch.count_down();
+                            } };
+
+        // Keep it busy for a while. Neither kind of activity may let it run in between.
+        clock::time_point lastActivity;
+        for (auto i = 0; i < 10; ++i)
+        {
+            lastActivity = clock::now();
+            idle();
+            idle.postpone();
+            Sleep(5);
+        }
+
+        latch.wait();
+        const clock::time_point called{ clock::duration{ calledAt.load() } };
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(called - lastActivity, clock::duration{ 20ms });
+    }
+
+    TEST_METHOD(IdleFuncMaxDelay)
+    {
+        using namespace std::chrono_literals;
+        using clock = std::chrono::steady_clock;
+
+        std::atomic<bool> called{ false };
+        til::idle_func idle{ 50ms, 100ms, [&]() {
+                                called.store(true);
+                            } };
+
+        // Activity that never stops must not defer it indefinitely.
+        const auto start = clock::now();
+        while (!called.load() && clock::now() - start < 5s)
+        {
+            idle();
+            Sleep(5);
+        }
+
+        VERIFY_IS_TRUE(called.load());
+    }
 };
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/ticket_lock.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TicketLockTests
+{
+    BEGIN_TEST_CLASS(TicketLockTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(SharedReadersDontBlockEachOther)
+    {
+        til::shared_ticket_lock lock;
+
+        std::shared_lock reader1{ lock };
+
+        // If readers excluded each other, this would hang until the test times out.
+        std::thread thread{ [&]() {
+            std::shared_lock reader2{ lock };
+        } };
+        thread.join();
+    }
+
+    TEST_METHOD(WriterExcludesReaders)
+    {
+        til::shared_ticket_lock lock;
+        std::atomic<bool> readerEntered{ false };
+
+        std::unique_lock writer{ lock };
+
+        std::thread thread{ [&]() {
+            std::shared_lock reader{ lock };
+            readerEntered.store(true);
+        } };
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        VERIFY_IS_FALSE(readerEntered.load());
+
+        writer.unlock();
+        thread.join();
+        VERIFY_IS_TRUE(readerEntered.load());
+    }
+
+    TEST_METHOD(WaitingWriterBlocksNewReaders)
+    {
+        til::shared_ticket_lock lock;
+        std::atomic<int> order{ 0 };
+        int writerOrder = 0;
+        int readerOrder = 0;
+
+        std::shared_lock reader1{ lock };
+
+        std::thread writer{ [&]() {
+            std::unique_lock lock2{ lock };
+            writerOrder = ++order;
+        } };
+
+        // Give the writer a chance to queue up behind reader1.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::thread reader2{ [&]() {
+            std::shared_lock lock2{ lock };
+            readerOrder = ++order;
+        } };
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        VERIFY_ARE_EQUAL(0, order.load());
+
+        reader1.unlock();
+        writer.join();
+        reader2.join();
+
+        Log::Comment(L"The writer should've been served before the reader that came after it.");
+        VERIFY_ARE_EQUAL(1, writerOrder);
+        VERIFY_ARE_EQUAL(2, readerOrder);
+    }
+
+    TEST_METHOD(WritersAreMutuallyExclusive)
+    {
+        til::shared_ticket_lock lock;
+        auto counter = 0;
+
+        const auto increment = [&]() {
+            for (auto i = 0; i < 10000; ++i)
+            {
+                std::unique_lock writer{ lock };
+                ++counter;
+            }
+        };
+
+        std::thread thread1{ increment };
+        std::thread thread2{ increment };
+        thread1.join();
+        thread2.join();
+
+        VERIFY_ARE_EQUAL(20000, counter);
+    }
+};
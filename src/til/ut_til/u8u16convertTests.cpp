@@ -17,6 +17,7 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestAsciiRuns);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +192,48 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestAsciiRuns()
+{
+    // The leading ASCII characters of a string are converted by vectorized code.
+    // Place a non-ASCII character at every position of strings around the vector
+    // widths, to test the transition from the ASCII fast path to the platform functions.
+    for (size_t length = 1; length <= 80; ++length)
+    {
+        for (size_t position = 0; position <= length; ++position)
+        {
+            std::string u8String;
+            std::wstring u16String;
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (i == position)
+                {
+                    u8String.append("\xC3\xB6"); // LATIN SMALL LETTER O WITH DIAERESIS (2 bytes)
+                    u16String.push_back(gsl::narrow_cast<wchar_t>(0x00f6U));
+                }
+                else
+                {
+                    const auto ch = gsl::narrow_cast<char>('a' + i % 26);
+                    u8String.push_back(ch);
+                    u16String.push_back(ch);
+                }
+            }
+
+            std::wstring u16Out{};
+            VERIFY_SUCCEEDED(til::u8u16(u8String, u16Out));
+            VERIFY_ARE_EQUAL(u16String, u16Out);
+
+            std::string u8Out{};
+            VERIFY_SUCCEEDED(til::u16u8(u16String, u8Out));
+            VERIFY_ARE_EQUAL(u8String, u8Out);
+
+            til::u8state u8State{};
+            VERIFY_SUCCEEDED(til::u8u16(u8String, u16Out, u8State));
+            VERIFY_ARE_EQUAL(u16String, u16Out);
+
+            til::u16state u16State{};
+            VERIFY_SUCCEEDED(til::u16u8(u16String, u8Out, u16State));
+            VERIFY_ARE_EQUAL(u8String, u8Out);
+        }
+    }
+}
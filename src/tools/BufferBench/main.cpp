@@ -0,0 +1,724 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL BufferBench
+// Performance tests for the TextBuffer.
+//
+// The "glyph storage" tests compare the row-local storage of multi code unit
+// glyphs in CharRow with the buffer-wide std::unordered_map that UnicodeStorage
+// used before. The latter is reproduced below as MapGlyphStorage, so that both
+// designs run the same emoji-dense workload: fill every row, scroll a region
+// (forcing UnicodeStorage::Remap in the old design) and read every cell back.
+//
+// The "attribute runs" test writes lines whose color changes every few cells
+// and copies them back out with their colors, which exercises the run-wise
+// ATTR_ROW operations used by ROW::WriteCells and TextBuffer::GetText.
+//
+// The remaining benchmarks measure the individual operations of the buffer layer:
+// * write/*:        TextBuffer::Write of ASCII, CJK and emoji text across the entire buffer
+// * circular/*:     IncrementCircularBuffer with various amounts of history
+// * scroll-rows/*:  ScrollRows within scroll margins, like a status line app or a pager causes them
+// * reflow/*:       Reflow of 10k to 1M rows into a narrower and a wider buffer
+// * get-text/*:     GetText of the entire buffer, with colors, and GenHTML of the result
+// * get-patterns/*: GetPatterns for URLs, with and without the per-line pattern cache
+// * search/*:       Search::GetAllMatches in plain text and regex mode
+// They report the average time, number of allocations and allocated bytes per operation,
+// and the working set of the process after the last operation. The reflow/1000000 ones
+// need a few GB of memory.
+//
+// Usage: BufferBench [filter...]
+// Only the benchmarks whose group name (glyph-storage, attribute-runs, write, circular, ...)
+// contains one of the filters are run. By default all of them are.
+
+#include <LibraryIncludes.h>
+#include <psapi.h>
+
+#include "../../buffer/out/search.h"
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+#include "../../renderer/inc/FontInfo.hpp"
+
+static std::atomic<size_t> g_allocations{ 0 };
+static std::atomic<size_t> g_allocatedBytes{ 0 };
+
+void* __cdecl operator new(const size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void __cdecl operator delete(void* const p) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    constexpr til::size bufferSize{ 300, 1000 };
+    constexpr int iterations = 20;
+
+    // A pair of emoji, each a surrogate pair rendered 2 columns wide: 🔥🍆
+    constexpr std::wstring_view emoji{ L"\xD83D\xDD25\xD83C\xDF46" };
+
+    using clock = std::chrono::steady_clock;
+
+    struct Result
+    {
+        clock::duration fill{};
+        clock::duration scroll{};
+        clock::duration read{};
+        size_t checksum = 0;
+    };
+
+    std::wstring makeEmojiLine()
+    {
+        std::wstring line;
+        while (line.size() < static_cast<size_t>(bufferSize.X))
+        {
+            line.append(emoji);
+        }
+        return line;
+    }
+
+    struct PointHash
+    {
+        size_t operator()(const til::point point) const noexcept
+        {
+            return til::hash(point);
+        }
+    };
+
+    // The design that was replaced: one code unit per cell and a hash map
+    // keyed by the cell position for everything longer than that.
+    class MapGlyphStorage
+    {
+    public:
+        MapGlyphStorage() :
+            _rows(static_cast<size_t>(bufferSize.Y), std::vector<Cell>(static_cast<size_t>(bufferSize.X)))
+        {
+        }
+
+        void Write(const til::CoordType y, const std::wstring_view line)
+        {
+            auto& row = _rows.at(static_cast<size_t>(y));
+            til::CoordType x = 0;
+            for (size_t i = 0; i < line.size() && x + 1 < bufferSize.X; i += 2, x += 2)
+            {
+                const auto glyph = line.substr(i, 2);
+                // Just like DbcsAttribute::SetGlyphStored, leading and trailing half both store the glyph.
+                for (const auto column : { x, x + 1 })
+                {
+                    auto& cell = row.at(static_cast<size_t>(column));
+                    cell.ch = glyph.front();
+                    cell.stored = true;
+                    _map.insert_or_assign(til::point{ column, y }, std::vector<wchar_t>{ glyph.begin(), glyph.end() });
+                }
+            }
+        }
+
+        void ScrollRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta)
+        {
+            std::rotate(_rows.begin() + firstRow + delta, _rows.begin() + firstRow, _rows.begin() + firstRow + size);
+
+            // This mirrors what TextBuffer::_RefreshRowIDs and UnicodeStorage::Remap used to do.
+            std::unordered_map<til::CoordType, til::CoordType> rowMap;
+            for (til::CoordType i = 0; i < bufferSize.Y; ++i)
+            {
+                auto oldId = i;
+                if (i >= firstRow + delta && i < firstRow + size + delta)
+                {
+                    oldId = (i - firstRow - delta + size - delta) % size + firstRow;
+                }
+                rowMap.emplace(oldId, i);
+            }
+
+            std::unordered_map<til::point, std::vector<wchar_t>, PointHash> newMap;
+            for (const auto& [key, value] : _map)
+            {
+                const auto it = rowMap.find(key.Y);
+                if (it != rowMap.end())
+                {
+                    newMap.emplace(til::point{ key.X, it->second }, value);
+                }
+            }
+            _map.swap(newMap);
+        }
+
+        size_t Read() const
+        {
+            size_t checksum = 0;
+            til::CoordType y = 0;
+            for (const auto& row : _rows)
+            {
+                til::CoordType x = 0;
+                for (const auto& cell : row)
+                {
+                    checksum += cell.stored ? _map.at({ x, y }).size() : 1;
+                    ++x;
+                }
+                ++y;
+            }
+            return checksum;
+        }
+
+    private:
+        struct Cell
+        {
+            wchar_t ch = L' ';
+            bool stored = false;
+        };
+
+        std::vector<std::vector<Cell>> _rows;
+        std::unordered_map<til::point, std::vector<wchar_t>, PointHash> _map;
+    };
+
+    Result runMapDesign(const std::wstring& line)
+    {
+        Result result;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            MapGlyphStorage storage;
+
+            auto start = clock::now();
+            for (til::CoordType y = 0; y < bufferSize.Y; ++y)
+            {
+                storage.Write(y, line);
+            }
+            result.fill += clock::now() - start;
+
+            start = clock::now();
+            // Scroll everything but the first row up by one, like a status line app would.
+            storage.ScrollRows(2, bufferSize.Y - 2, -1);
+            result.scroll += clock::now() - start;
+
+            start = clock::now();
+            result.checksum += storage.Read();
+            result.read += clock::now() - start;
+        }
+        return result;
+    }
+
+    Result runRowDesign(const std::wstring& line)
+    {
+        DummyRenderer renderer;
+        Result result;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            TextBuffer buffer{ bufferSize, TextAttribute{ 0x7 }, 0, false, renderer };
+
+            auto start = clock::now();
+            for (til::CoordType y = 0; y < bufferSize.Y; ++y)
+            {
+                buffer.WriteLine(OutputCellIterator{ line }, { 0, y });
+            }
+            result.fill += clock::now() - start;
+
+            start = clock::now();
+            buffer.ScrollRows(2, bufferSize.Y - 2, -1);
+            result.scroll += clock::now() - start;
+
+            start = clock::now();
+            for (til::CoordType y = 0; y < bufferSize.Y; ++y)
+            {
+                for (auto it = buffer.GetCellLineDataAt({ 0, y }); it; ++it)
+                {
+                    result.checksum += it->Chars().size();
+                }
+            }
+            result.read += clock::now() - start;
+        }
+        return result;
+    }
+
+    std::vector<CHAR_INFO> makeColorfulLine(const til::CoordType width)
+    {
+        std::vector<CHAR_INFO> line(static_cast<size_t>(width));
+        for (size_t i = 0; i < line.size(); ++i)
+        {
+            line[i].Char.UnicodeChar = static_cast<wchar_t>(L'a' + i % 26);
+            line[i].Attributes = static_cast<WORD>(i / 4 % 16);
+        }
+        return line;
+    }
+
+    Result runAttributeRuns(const std::vector<CHAR_INFO>& line)
+    {
+        DummyRenderer renderer;
+        Result result;
+
+        std::vector<til::inclusive_rect> rects;
+        for (til::CoordType y = 0; y < bufferSize.Y; ++y)
+        {
+            rects.push_back({ 0, y, bufferSize.X - 1, y });
+        }
+        const auto getColors = [](const TextAttribute& attr) {
+            return std::pair<COLORREF, COLORREF>{ attr.GetLegacyAttributes(), 0 };
+        };
+
+        for (auto i = 0; i < iterations; ++i)
+        {
+            TextBuffer buffer{ bufferSize, TextAttribute{ 0x7 }, 0, false, renderer };
+
+            auto start = clock::now();
+            for (til::CoordType y = 0; y < bufferSize.Y; ++y)
+            {
+                buffer.WriteLine(OutputCellIterator{ gsl::span{ line } }, { 0, y });
+            }
+            result.fill += clock::now() - start;
+
+            start = clock::now();
+            const auto text = buffer.GetText(true, false, rects, getColors);
+            result.read += clock::now() - start;
+
+            for (const auto& row : text.FgAttr)
+            {
+                result.checksum += row.size();
+            }
+        }
+        return result;
+    }
+
+    void printResult(const char* name, const Result& result)
+    {
+        const auto ms = [](const clock::duration d) {
+            return std::chrono::duration<double, std::milli>(d).count() / iterations;
+        };
+        printf("%-24s fill %8.3fms  scroll %8.3fms  read %8.3fms  (checksum %zu)\n", name, ms(result.fill), ms(result.scroll), ms(result.read), result.checksum);
+    }
+
+    void runGlyphStorage()
+    {
+        const auto line = makeEmojiLine();
+
+        printf("glyph storage, %dx%d cells of emoji, average of %d runs\n", bufferSize.X, bufferSize.Y, iterations);
+        printResult("unordered_map (old)", runMapDesign(line));
+        printResult("row-local (CharRow)", runRowDesign(line));
+    }
+
+    void runAttributeRuns()
+    {
+        printf("attribute runs, %dx%d cells with a new color every 4 cells, average of %d runs\n", bufferSize.X, bufferSize.Y, iterations);
+        printResult("WriteLine/GetText", runAttributeRuns(makeColorfulLine(bufferSize.X)));
+    }
+
+    // What follows are the benchmarks of the individual buffer operations.
+
+    constexpr til::CoordType width = 120;
+
+    struct Sample
+    {
+        clock::duration duration{};
+        size_t allocations = 0;
+        size_t allocatedBytes = 0;
+
+        Sample& operator+=(const Sample& other) noexcept
+        {
+            duration += other.duration;
+            allocations += other.allocations;
+            allocatedBytes += other.allocatedBytes;
+            return *this;
+        }
+    };
+
+    // Returns how long func() took and what it allocated.
+    template<typename Func>
+    Sample measure(Func&& func)
+    {
+        const auto allocations = g_allocations.load(std::memory_order_relaxed);
+        const auto allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+        const auto start = clock::now();
+        func();
+        const auto duration = clock::now() - start;
+        return {
+            duration,
+            g_allocations.load(std::memory_order_relaxed) - allocations,
+            g_allocatedBytes.load(std::memory_order_relaxed) - allocatedBytes,
+        };
+    }
+
+    size_t residentBytes() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        counters.cb = sizeof(counters);
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+    }
+
+    void printHeader()
+    {
+        printf("%-40s %8s %14s %12s %14s %10s\n", "benchmark", "ops", "time/op", "allocs/op", "bytes/op", "resident");
+    }
+
+    // Prints the averages of the given total over ops operations. The resident memory is
+    // the working set of the process at the time of the call, which includes the buffers.
+    void report(const std::string& name, const Sample& total, const size_t ops)
+    {
+        const auto us = std::chrono::duration<double, std::micro>(total.duration).count() / ops;
+        printf("%-40s %8zu %12.1fus %12.1f %14.1f %8.1fMB\n",
+               name.c_str(),
+               ops,
+               us,
+               static_cast<double>(total.allocations) / ops,
+               static_cast<double>(total.allocatedBytes) / ops,
+               residentBytes() / (1024.0 * 1024.0));
+    }
+
+    std::unique_ptr<TextBuffer> makeBuffer(Microsoft::Console::Render::Renderer& renderer, const til::size size)
+    {
+        return std::make_unique<TextBuffer>(size, TextAttribute{ 0x7 }, 0, false, renderer);
+    }
+
+    std::wstring makeAsciiLine()
+    {
+        std::wstring line;
+        for (til::CoordType i = 0; i < width; ++i)
+        {
+            line.push_back(static_cast<wchar_t>(L'!' + i % 94));
+        }
+        return line;
+    }
+
+    // Every character is 2 columns wide.
+    std::wstring makeCjkLine()
+    {
+        std::wstring line;
+        for (til::CoordType i = 0; i < width / 2; ++i)
+        {
+            line.push_back(static_cast<wchar_t>(0x4E00 + i));
+        }
+        return line;
+    }
+
+    std::wstring makeEmojiRow()
+    {
+        std::wstring line;
+        for (til::CoordType i = 0; i < width / 4; ++i)
+        {
+            line.append(emoji);
+        }
+        return line;
+    }
+
+    // Writes line into every row. Unless it's every 4th row, the row is marked as wrapped,
+    // so that the buffer consists of lines that span 4 rows, which is what Reflow has to join.
+    void fill(TextBuffer& buffer, const std::wstring_view line)
+    {
+        const auto height = buffer.GetSize().Height();
+        for (til::CoordType y = 0; y < height; ++y)
+        {
+            buffer.WriteLine(OutputCellIterator{ line }, { 0, y }, y % 4 != 3);
+        }
+    }
+
+    void runWrite()
+    {
+        static constexpr til::CoordType rows = 1000;
+        static constexpr size_t ops = 20;
+        const std::pair<const char*, std::wstring> texts[]{
+            { "ascii", makeAsciiLine() },
+            { "cjk", makeCjkLine() },
+            { "emoji", makeEmojiRow() },
+        };
+
+        DummyRenderer renderer;
+        const auto buffer = makeBuffer(renderer, { width, rows });
+
+        for (const auto& [name, line] : texts)
+        {
+            std::wstring text;
+            for (til::CoordType y = 0; y < rows; ++y)
+            {
+                text.append(line);
+            }
+
+            Sample total;
+            for (size_t i = 0; i < ops; ++i)
+            {
+                total += measure([&]() { buffer->Write(OutputCellIterator{ text }, { 0, 0 }); });
+            }
+            report(fmt::format("write/{} ({}x{})", name, width, rows), total, ops);
+        }
+    }
+
+    void runCircularBuffer()
+    {
+        static constexpr size_t ops = 10000;
+        const auto line = makeAsciiLine();
+
+        for (const til::CoordType history : { 1000, 10000, 100000 })
+        {
+            DummyRenderer renderer;
+            const auto buffer = makeBuffer(renderer, { width, history });
+            fill(*buffer, line);
+
+            const auto total = measure([&]() {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    buffer->IncrementCircularBuffer();
+                }
+            });
+            report(fmt::format("circular/history={}", history), total, ops);
+        }
+    }
+
+    void runScrollRows()
+    {
+        static constexpr size_t ops = 10000;
+        // The arguments of ScrollRows, which moves the rows [firstRow, firstRow + size) by delta.
+        struct Scroll
+        {
+            const char* name;
+            til::CoordType height;
+            til::CoordType firstRow;
+            til::CoordType size;
+            til::CoordType delta;
+        };
+        static constexpr Scroll scrolls[]{
+            // Margins that exclude a status line at the top and bottom of a 50 row viewport.
+            { "status-lines/up", 50, 2, 47, -1 },
+            { "status-lines/down", 50, 1, 47, 1 },
+            // A pager above a prompt line, scrolling by half a page.
+            { "pager/half-page", 50, 25, 24, -25 },
+            { "full-buffer/up", 9001, 1, 9000, -1 },
+        };
+
+        const auto line = makeAsciiLine();
+
+        for (const auto& scroll : scrolls)
+        {
+            DummyRenderer renderer;
+            const auto buffer = makeBuffer(renderer, { width, scroll.height });
+            fill(*buffer, line);
+
+            const auto total = measure([&]() {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    buffer->ScrollRows(scroll.firstRow, scroll.size, scroll.delta);
+                }
+            });
+            report(fmt::format("scroll-rows/{}", scroll.name), total, ops);
+        }
+    }
+
+    void runReflow()
+    {
+        const auto line = makeAsciiLine();
+
+        for (const til::CoordType rows : { 10000, 100000, 1000000 })
+        {
+            DummyRenderer renderer;
+            const auto oldBuffer = makeBuffer(renderer, { width, rows });
+            fill(*oldBuffer, line);
+
+            for (const til::CoordType newWidth : { 80, 200 })
+            {
+                const size_t ops = rows >= 1000000 ? 1 : 5;
+                Sample total;
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    auto newBuffer = makeBuffer(renderer, { newWidth, rows });
+                    total += measure([&]() { THROW_IF_FAILED(TextBuffer::Reflow(*oldBuffer, *newBuffer, std::nullopt, std::nullopt)); });
+                }
+                report(fmt::format("reflow/{} ({}->{} columns)", rows, width, newWidth), total, ops);
+            }
+        }
+    }
+
+    void runGetText()
+    {
+        static constexpr til::CoordType rows = 10000;
+        static constexpr size_t ops = 5;
+        const auto line = makeColorfulLine(width);
+
+        DummyRenderer renderer;
+        const auto buffer = makeBuffer(renderer, { width, rows });
+        for (til::CoordType y = 0; y < rows; ++y)
+        {
+            buffer->WriteLine(OutputCellIterator{ gsl::span{ line } }, { 0, y });
+        }
+
+        std::vector<til::inclusive_rect> rects;
+        for (til::CoordType y = 0; y < rows; ++y)
+        {
+            rects.push_back({ 0, y, width - 1, y });
+        }
+        const auto getColors = [](const TextAttribute& attr) {
+            const auto legacy = attr.GetLegacyAttributes();
+            return std::pair<COLORREF, COLORREF>{ RGB((legacy & 0xf) * 16, 0, 0), RGB(0, (legacy >> 4) * 16, 0) };
+        };
+
+        TextBuffer::TextAndColor text;
+        Sample total;
+        for (size_t i = 0; i < ops; ++i)
+        {
+            total += measure([&]() { text = buffer->GetText(true, true, rects, getColors); });
+        }
+        report(fmt::format("get-text/colors ({}x{})", width, rows), total, ops);
+
+        total = {};
+        size_t size = 0;
+        for (size_t i = 0; i < ops; ++i)
+        {
+            total += measure([&]() { size += TextBuffer::GenHTML(text, 12, L"Cascadia Mono", RGB(0, 0, 0)).size(); });
+        }
+        report(fmt::format("get-text/html ({}x{})", width, rows), total, ops);
+    }
+
+    void runGetPatterns()
+    {
+        static constexpr til::CoordType rows = 1000;
+        static constexpr size_t ops = 20;
+        const auto line = makeAsciiLine();
+
+        DummyRenderer renderer;
+        const auto buffer = makeBuffer(renderer, { width, rows });
+        for (til::CoordType y = 0; y < rows; ++y)
+        {
+            const auto text = y % 4 ? std::wstring_view{ line } : L"see https://github.com/microsoft/terminal/issues/12345 for details";
+            buffer->WriteLine(OutputCellIterator{ text }, { 0, y });
+        }
+
+        Sample cold;
+        Sample cached;
+        for (size_t i = 0; i < ops; ++i)
+        {
+            // Adding a recognizer clears the pattern cache.
+            buffer->ClearPatternRecognizers();
+            buffer->AddPatternRecognizer(TextBuffer::UrlPattern);
+            cold += measure([&]() { std::ignore = buffer->GetPatterns(0, rows - 1); });
+            cached += measure([&]() { std::ignore = buffer->GetPatterns(0, rows - 1); });
+        }
+        report(fmt::format("get-patterns/cold ({} rows)", rows), cold, ops);
+        report(fmt::format("get-patterns/cached ({} rows)", rows), cached, ops);
+    }
+
+    // Search only needs the buffer, the rest is unused.
+    class BufferUiaData final : public Microsoft::Console::Types::IUiaData
+    {
+    public:
+        explicit BufferUiaData(const TextBuffer& buffer) noexcept :
+            _buffer{ buffer }
+        {
+        }
+
+        Microsoft::Console::Types::Viewport GetViewport() noexcept override { return _buffer.GetSize(); }
+        til::point GetTextBufferEndPosition() const noexcept override { return { _buffer.GetSize().Width() - 1, _buffer.GetSize().Height() - 1 }; }
+        const TextBuffer& GetTextBuffer() const noexcept override { return _buffer; }
+        const FontInfo& GetFontInfo() const noexcept override { return _fontInfo; }
+        std::vector<Microsoft::Console::Types::Viewport> GetSelectionRects() noexcept override { return {}; }
+        void LockConsole() noexcept override {}
+        void UnlockConsole() noexcept override {}
+        std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute&) const noexcept override { return {}; }
+        const bool IsSelectionActive() const override { return false; }
+        const bool IsBlockSelection() const override { return false; }
+        void ClearSelection() override {}
+        void SelectNewRegion(const til::point, const til::point) override {}
+        const til::point GetSelectionAnchor() const noexcept override { return {}; }
+        const til::point GetSelectionEnd() const noexcept override { return {}; }
+        void ColorSelection(const til::point, const til::point, const TextAttribute) override {}
+        const bool IsUiaDataInitialized() const noexcept override { return true; }
+        void LockConsoleForWriting() noexcept override {}
+        void UnlockConsoleForWriting() noexcept override {}
+
+    private:
+        const TextBuffer& _buffer;
+        FontInfo _fontInfo{ L"Consolas", 0, FW_NORMAL, { 8, 16 }, CP_UTF8 };
+    };
+
+    void runSearch()
+    {
+        static constexpr til::CoordType rows = 10000;
+        static constexpr size_t ops = 10;
+        struct Query
+        {
+            const char* name;
+            std::wstring_view needle;
+            Search::Sensitivity sensitivity;
+            Search::Mode mode;
+        };
+        static constexpr Query queries[]{
+            { "plain", L"needle", Search::Sensitivity::CaseSensitive, Search::Mode::PlainText },
+            { "plain/ignore-case", L"needle", Search::Sensitivity::CaseInsensitive, Search::Mode::PlainText },
+            { "regex", L"ne+dle\\d*", Search::Sensitivity::CaseSensitive, Search::Mode::Regex },
+        };
+
+        const auto line = makeAsciiLine();
+        DummyRenderer renderer;
+        const auto buffer = makeBuffer(renderer, { width, rows });
+        fill(*buffer, line);
+        // A match every 10 rows.
+        for (til::CoordType y = 0; y < rows; y += 10)
+        {
+            buffer->WriteLine(OutputCellIterator{ std::wstring_view{ L"needle42" } }, { y % (width - 8), y }, y % 4 != 3);
+        }
+
+        BufferUiaData uiaData{ *buffer };
+        for (const auto& query : queries)
+        {
+            Sample total;
+            size_t matches = 0;
+            for (size_t i = 0; i < ops; ++i)
+            {
+                total += measure([&]() {
+                    Search search{ uiaData, std::wstring{ query.needle }, Search::Direction::Forward, query.sensitivity, query.mode };
+                    matches += search.GetAllMatches().size();
+                });
+            }
+            report(fmt::format("search/{} ({} rows, {} matches)", query.name, rows, matches / ops), total, ops);
+        }
+    }
+
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)();
+        // The suite of per-operation benchmarks shares a table.
+        bool reportsOperations;
+    };
+
+    constexpr Benchmark benchmarks[]{
+        { "glyph-storage", runGlyphStorage, false },
+        { "attribute-runs", runAttributeRuns, false },
+        { "write", runWrite, true },
+        { "circular", runCircularBuffer, true },
+        { "scroll-rows", runScrollRows, true },
+        { "reflow", runReflow, true },
+        { "get-text", runGetText, true },
+        { "get-patterns", runGetPatterns, true },
+        { "search", runSearch, true },
+    };
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    const std::vector<std::wstring_view> filters(argv + 1, argv + argc);
+    const auto selected = [&](const std::string_view name) {
+        const std::wstring wide(name.begin(), name.end());
+        return filters.empty() || std::any_of(filters.begin(), filters.end(), [&](const auto& filter) { return wide.find(filter) != std::wstring::npos; });
+    };
+
+    auto headerPrinted = false;
+    for (const auto& benchmark : benchmarks)
+    {
+        if (!selected(benchmark.name))
+        {
+            continue;
+        }
+        if (benchmark.reportsOperations && !std::exchange(headerPrinted, true))
+        {
+            printHeader();
+        }
+        benchmark.run();
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL ConptyBench
+// Startup latency of a pseudoconsole.
+//
+// Every iteration creates a pseudoconsole, starts a client in it and measures:
+// * "create": how long ConptyCreatePseudoConsole took.
+// * "first byte": the time from calling ConptyCreatePseudoConsole until the client's
+//   output arrives on the output pipe. This is what a user perceives when opening a tab.
+//
+// Usage: ConptyBench [--pool <count>] [--iterations <count>] [--interval <ms>] [-- <client commandline>]
+// --pool starts the given number of console hosts ahead of time (ConptySetPseudoConsolePoolSize).
+// The interval between iterations gives the pool time to refill, so measurements with and
+// without a pool are comparable. The default client is `cmd.exe /c echo ConptyBench`.
+
+#include <LibraryIncludes.h>
+#include <conpty-static.h>
+
+namespace
+{
+    constexpr std::string_view marker = "ConptyBench";
+
+    struct Options
+    {
+        DWORD pool = 0;
+        int iterations = 20;
+        DWORD interval = 500;
+        std::wstring commandline = L"cmd.exe /c echo ConptyBench";
+    };
+
+    struct Sample
+    {
+        double create = 0;
+        double firstByte = 0;
+    };
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Sample runOnce(const Options& options)
+    {
+        wil::unique_hfile inputRead, inputWrite, outputRead, outputWrite;
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(inputRead.addressof(), inputWrite.addressof(), nullptr, 0));
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(outputRead.addressof(), outputWrite.addressof(), nullptr, 0));
+
+        Sample sample;
+        const auto start = std::chrono::steady_clock::now();
+
+        HPCON hPC = nullptr;
+        THROW_IF_FAILED(ConptyCreatePseudoConsole({ 120, 30 }, inputRead.get(), outputWrite.get(), 0, &hPC));
+        auto closePseudoConsole = wil::scope_exit([&]() {
+            ConptyClosePseudoConsole(hPC);
+        });
+        sample.create = millisecondsSince(start);
+
+        // The pseudoconsole holds its own copies of these.
+        inputRead.reset();
+        outputWrite.reset();
+
+        SIZE_T size = 0;
+        InitializeProcThreadAttributeList(nullptr, 1, 0, &size);
+        const auto attributeListBuffer = std::make_unique<std::byte[]>(size);
+        const auto attributeList = reinterpret_cast<PPROC_THREAD_ATTRIBUTE_LIST>(attributeListBuffer.get());
+        THROW_IF_WIN32_BOOL_FALSE(InitializeProcThreadAttributeList(attributeList, 1, 0, &size));
+        const auto deleteAttributeList = wil::scope_exit([&]() {
+            DeleteProcThreadAttributeList(attributeList);
+        });
+        THROW_IF_WIN32_BOOL_FALSE(UpdateProcThreadAttribute(attributeList, 0, PROC_THREAD_ATTRIBUTE_PSEUDOCONSOLE, hPC, sizeof(hPC), nullptr, nullptr));
+
+        STARTUPINFOEXW siEx{};
+        siEx.StartupInfo.cb = sizeof(siEx);
+        siEx.lpAttributeList = attributeList;
+
+        auto commandline = options.commandline;
+        wil::unique_process_information pi;
+        THROW_IF_WIN32_BOOL_FALSE(CreateProcessW(nullptr, commandline.data(), nullptr, nullptr, FALSE, EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr, &siEx.StartupInfo, pi.addressof()));
+
+        // The console host emits a few VT sequences of its own before the client's output.
+        std::string output;
+        char buffer[4096];
+        while (output.find(marker) == std::string::npos)
+        {
+            DWORD read = 0;
+            THROW_IF_WIN32_BOOL_FALSE(ReadFile(outputRead.get(), &buffer[0], sizeof(buffer), &read, nullptr));
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_BROKEN_PIPE), read == 0);
+            output.append(&buffer[0], read);
+        }
+        sample.firstByte = millisecondsSince(start);
+
+        // Closing the pseudoconsole waits for the console host to flush its output, so we need to keep draining it.
+        std::thread drain{ [&]() {
+            DWORD read = 0;
+            while (ReadFile(outputRead.get(), &buffer[0], sizeof(buffer), &read, nullptr) && read)
+            {
+            }
+        } };
+        WaitForSingleObject(pi.hProcess, INFINITE);
+        closePseudoConsole.reset();
+        drain.join();
+        return sample;
+    }
+
+    double percentile(std::vector<double> values, const size_t percent)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, values.size() * percent / 100)];
+    }
+
+    void printResult(const char* name, const std::vector<double>& values)
+    {
+        printf("%-12s min %7.2f ms   p50 %7.2f ms   p90 %7.2f ms\n", name, percentile(values, 0), percentile(values, 50), percentile(values, 90));
+    }
+
+    Options parseOptions(const int argc, const wchar_t* argv[])
+    {
+        Options options;
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::wstring_view arg{ argv[i] };
+            if (arg == L"--" && i + 1 < argc)
+            {
+                options.commandline.clear();
+                for (++i; i < argc; ++i)
+                {
+                    options.commandline.append(argv[i]);
+                    options.commandline.push_back(L' ');
+                }
+                options.commandline.pop_back();
+            }
+            else if (arg == L"--pool" && i + 1 < argc)
+            {
+                options.pool = std::wcstoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == L"--iterations" && i + 1 < argc)
+            {
+                options.iterations = std::max(1, _wtoi(argv[++i]));
+            }
+            else if (arg == L"--interval" && i + 1 < argc)
+            {
+                options.interval = std::wcstoul(argv[++i], nullptr, 10);
+            }
+            else
+            {
+                THROW_HR(E_INVALIDARG);
+            }
+        }
+        return options;
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    const auto options = parseOptions(argc, argv);
+
+    // The client's output has to contain the marker we're waiting for.
+    if (options.commandline.find(L"ConptyBench") == std::wstring::npos)
+    {
+        printf("the client's output must contain \"ConptyBench\"\n");
+        return 1;
+    }
+
+    THROW_IF_FAILED(ConptySetPseudoConsolePoolSize(options.pool));
+
+    // The first pseudoconsole pays for loading the console host image from disk and is excluded.
+    Sleep(options.interval);
+    runOnce(options);
+
+    std::vector<double> create;
+    std::vector<double> firstByte;
+    for (auto i = 0; i < options.iterations; ++i)
+    {
+        Sleep(options.interval);
+        const auto sample = runOnce(options);
+        create.emplace_back(sample.create);
+        firstByte.emplace_back(sample.firstByte);
+    }
+
+    printf("%d pseudoconsoles, %lu pooled console hosts, %lu ms apart\n", options.iterations, options.pool, options.interval);
+    printResult("create", create);
+    printResult("first byte", firstByte);
+
+    THROW_IF_FAILED(ConptySetPseudoConsolePoolSize(0));
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
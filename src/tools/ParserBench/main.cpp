@@ -0,0 +1,360 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL ParserBench
+// Throughput tests for the VT parser.
+//
+// Every corpus is replayed twice:
+// * "parse": StateMachine + OutputStateMachineEngine with a dispatch that does nothing.
+//   This measures the parser alone.
+// * "buffer": StateMachine + OutputStateMachineEngine + AdaptDispatch writing into a real TextBuffer.
+//   This measures the entire output path short of the renderer.
+// For each phase the tool reports MB/s (of UTF-16 input) and heap allocations per MB.
+// Allocations are counted after a warm-up pass, so they reflect the steady state.
+//
+// Without arguments a built-in set of synthetic corpora is used. Any arguments are
+// treated as paths to recorded UTF-8 VT streams (for instance from `script` or a
+// conpty debug tap), which are then replayed instead.
+//
+// To measure the cost of the parser's tracing, compare a run with one where the
+// parser's provider is being recorded, for instance with:
+//   tracelog -start parser -guid #c9ba2a84-d3ca-5e19-2bd6-776a0910cb9d -level 5 -flag 0x100000000 -f parser.etl
+// The tool prints whether it found the provider enabled.
+
+#include <LibraryIncludes.h>
+
+#include "../../terminal/adapter/adaptDispatch.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../terminal/parser/telemetry.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+
+// Counts every heap allocation made by this process. The benchmark is single threaded,
+// but the counter is atomic anyways, in case the code under test ever spins up threads.
+static std::atomic<size_t> g_allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    constexpr til::CoordType bufferWidth = 120;
+    constexpr til::CoordType bufferHeight = 30;
+    constexpr size_t corpusSize = 8 * 1024 * 1024; // in wchar_t
+    constexpr int iterations = 5;
+
+    struct Corpus
+    {
+        std::string name;
+        std::wstring text;
+    };
+
+    // Repeats the string returned by the generator until the corpus has the target size.
+    template<typename Generator>
+    std::wstring repeat(Generator&& generator)
+    {
+        std::wstring text;
+        text.reserve(corpusSize + 4096);
+        for (size_t i = 0; text.size() < corpusSize; ++i)
+        {
+            text.append(generator(i));
+        }
+        return text;
+    }
+
+    // Like `cat`ing a large log file.
+    std::wstring makeAscii()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"2022-06-01 12:{:02}:{:02}.{:03} [INFO] worker {:3} processed request {} in {}ms\r\n"), i / 60 % 60, i % 60, i % 1000, i % 128, i, i % 97);
+        });
+    }
+
+    // Like `ls --color` or a colored compiler log: a SGR sequence for every few characters.
+    std::wstring makeSgr()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"\x1b[0m\x1b[01;34mdirectory{}\x1b[0m  \x1b[01;32mexecutable{}\x1b[0m  \x1b[38;5;{}mindexed\x1b[0m  \x1b[38;2;{};{};{}mtruecolor\x1b[0m\r\n"), i, i, i % 256, i % 256, (i * 7) % 256, (i * 13) % 256);
+        });
+    }
+
+    // Like colored gcc/clang diagnostics: the same handful of SGR sequences on every line.
+    std::wstring makeDiagnostics()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"\x1b[01m\x1b[Ksrc/module{}.cpp:{}:{}:\x1b[m\x1b[K \x1b[01;35m\x1b[Kwarning: \x1b[m\x1b[Kunused variable '\x1b[01m\x1b[Kvalue{}\x1b[m\x1b[K' [\x1b[01;35m\x1b[K-Wunused-variable\x1b[m\x1b[K]\r\n"), i % 32, i % 1000, i % 80, i);
+        });
+    }
+
+    // Text in scripts with wide glyphs and surrogate pairs.
+    std::wstring makeUnicode()
+    {
+        return repeat([](size_t i) {
+            std::wstring line{ L"\x65e5\x672c\x8a9e\x306e\x30c6\x30ad\x30b9\x30c8 \xd55c\xad6d\xc5b4 \x4e2d\x6587 " };
+            line.append(i % 2 ? L"\xD83D\xDE00\xD83D\xDC4D\xD83C\xDF89" : L"\xD83D\xDD25\xD83C\xDF46\xD83E\xDD14");
+            line.append(L" caf\x00e9 na\x00efve \x03b1\x03b2\x03b3\r\n");
+            return line;
+        });
+    }
+
+    // Like `htop` or `vim`: absolutely positioned, colored updates of the whole viewport.
+    std::wstring makeTui()
+    {
+        return repeat([](size_t i) {
+            std::wstring frame{ L"\x1b[?25l\x1b[H" };
+            for (til::CoordType y = 1; y <= bufferHeight; ++y)
+            {
+                const auto percent = (i * 31 + y * 17) % 100;
+                const std::wstring bar(percent / 2, L'|');
+                const std::wstring padding(50 - percent / 2, L' ');
+                fmt::format_to(std::back_inserter(frame), FMT_COMPILE(L"\x1b[{};1H\x1b[K\x1b[1;36m{:3}\x1b[0m \x1b[32m[\x1b[{}m{}\x1b[0m{}\x1b[32m]\x1b[0m \x1b[7m{:3}%\x1b[27m"), y, y, percent > 80 ? 31 : 32, bar, padding, percent);
+            }
+            frame.append(L"\x1b[30;1H\x1b[?25h");
+            return frame;
+        });
+    }
+
+    // Like `ls --hyperlink` within a shell that reports its prompt and working directory.
+    std::wstring makeOsc()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"\x1b]0;~/src/project{}\x07\x1b]9;9;C:\\src\\project{}\x1b\\\x1b]8;id={};file:///C:/src/project{}/file{}.txt\x1b\\file{}.txt\x1b]8;;\x1b\\\r\n"), i % 16, i % 16, i, i % 16, i, i);
+        });
+    }
+
+    std::vector<Corpus> makeCorpora()
+    {
+        std::vector<Corpus> corpora;
+        corpora.push_back({ "ascii", makeAscii() });
+        corpora.push_back({ "sgr", makeSgr() });
+        corpora.push_back({ "diagnostics", makeDiagnostics() });
+        corpora.push_back({ "unicode", makeUnicode() });
+        corpora.push_back({ "tui", makeTui() });
+        corpora.push_back({ "osc", makeOsc() });
+        return corpora;
+    }
+
+    std::vector<Corpus> loadCorpora(const int argc, const wchar_t* argv[])
+    {
+        std::vector<Corpus> corpora;
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::filesystem::path path{ til::at(argv, i) };
+            std::ifstream file{ path, std::ios::binary };
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !file);
+            const std::string bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+            corpora.push_back({ path.filename().string(), til::u8u16(bytes) });
+        }
+        return corpora;
+    }
+
+    // A dispatch that ignores everything, so that only the parser itself is measured.
+    class NullDispatch final : public TermDispatch
+    {
+    public:
+        void Print(const wchar_t /*wchPrintable*/) override
+        {
+        }
+
+        void PrintString(const std::wstring_view /*string*/) override
+        {
+        }
+    };
+
+    // The smallest ITerminalApi that lets AdaptDispatch write into a TextBuffer,
+    // modelled after the way Terminal::_WriteBuffer and Terminal::LineFeed work.
+    class BenchTerminal final : public ITerminalApi
+    {
+    public:
+        BenchTerminal(Microsoft::Console::Render::Renderer& renderer) :
+            _textBuffer{ { bufferWidth, bufferHeight }, TextAttribute{ 0x7 }, 0, true, renderer }
+        {
+        }
+
+        void SetStateMachine(StateMachine* stateMachine) noexcept
+        {
+            _stateMachine = stateMachine;
+        }
+
+        void PrintString(const std::wstring_view string) override
+        {
+            auto& cursor = _textBuffer.GetCursor();
+            OutputCellIterator it{ string, _textBuffer.GetCurrentAttributes() };
+            while (it)
+            {
+                const auto start = it;
+                it = _textBuffer.WriteLine(it, cursor.GetPosition(), true);
+                const auto position = cursor.GetPosition();
+                const auto x = position.X + it.GetCellDistance(start);
+                if (x >= bufferWidth || (it && it.GetCellDistance(start) == 0))
+                {
+                    LineFeed(true);
+                }
+                else
+                {
+                    cursor.SetXPosition(x);
+                }
+            }
+        }
+
+        void ReturnResponse(const std::wstring_view /*response*/) override {}
+        StateMachine& GetStateMachine() override { return *_stateMachine; }
+        TextBuffer& GetTextBuffer() override { return _textBuffer; }
+        til::rect GetViewport() const override { return { 0, 0, bufferWidth, bufferHeight }; }
+        void SetViewportPosition(const til::point /*position*/) override {}
+        bool IsVtInputEnabled() const override { return false; }
+        void SetTextAttributes(const TextAttribute& attrs) override { _textBuffer.SetCurrentAttributes(attrs); }
+        void SetAutoWrapMode(const bool /*wrapAtEOL*/) override {}
+        void SetScrollingRegion(const til::inclusive_rect& /*scrollMargins*/) override {}
+        void WarningBell() override {}
+        bool GetLineFeedMode() const override { return false; }
+
+        void LineFeed(const bool withReturn) override
+        {
+            auto& cursor = _textBuffer.GetCursor();
+            auto position = cursor.GetPosition();
+            if (withReturn)
+            {
+                position.X = 0;
+            }
+            if (position.Y + 1 >= bufferHeight)
+            {
+                _textBuffer.IncrementCircularBuffer();
+            }
+            else
+            {
+                ++position.Y;
+            }
+            cursor.SetPosition(position);
+        }
+
+        void SetWindowTitle(const std::wstring_view /*title*/) override {}
+        void UseAlternateScreenBuffer() override {}
+        void UseMainScreenBuffer() override {}
+        CursorType GetUserDefaultCursorStyle() const override { return CursorType::Legacy; }
+        void ShowWindow(bool /*showOrHide*/) override {}
+        void SetConsoleOutputCP(const unsigned int /*codepage*/) override {}
+        unsigned int GetConsoleOutputCP() const override { return CP_UTF8; }
+        void EnableXtermBracketedPasteMode(const bool /*enabled*/) override {}
+        void CopyToClipboard(const std::wstring_view /*content*/) override {}
+        void SetTaskbarProgress(const DispatchTypes::TaskbarState /*state*/, const size_t /*progress*/) override {}
+        void SetWorkingDirectory(const std::wstring_view /*uri*/) override {}
+        void PlayMidiNote(const int /*noteNumber*/, const int /*velocity*/, const std::chrono::microseconds /*duration*/) override {}
+        bool ResizeWindow(const til::CoordType /*width*/, const til::CoordType /*height*/) override { return false; }
+        bool IsConsolePty() const override { return false; }
+        void NotifyAccessibilityChange(const til::rect& /*changedRect*/) override {}
+        void AddMark(const DispatchTypes::ScrollMark& /*mark*/) override {}
+        void MarkCommandStart() override {}
+        void MarkOutputStart() override {}
+        void MarkCommandFinish(const std::optional<unsigned int> /*exitCode*/) override {}
+
+    private:
+        TextBuffer _textBuffer;
+        StateMachine* _stateMachine = nullptr;
+    };
+
+    struct Result
+    {
+        double megabytesPerSecond = 0;
+        double allocationsPerMegabyte = 0;
+    };
+
+    // Feeds the corpus into the state machine in 4KB chunks, which is roughly what conhost gets per WriteFile.
+    Result replay(StateMachine& stateMachine, const std::wstring_view text)
+    {
+        constexpr size_t chunkSize = 4096;
+
+        // Let the state machine and the buffer grow whatever storage they keep around.
+        for (size_t offset = 0; offset < text.size(); offset += chunkSize)
+        {
+            stateMachine.ProcessString(text.substr(offset, chunkSize));
+        }
+
+        const auto allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+
+        for (auto i = 0; i < iterations; ++i)
+        {
+            for (size_t offset = 0; offset < text.size(); offset += chunkSize)
+            {
+                stateMachine.ProcessString(text.substr(offset, chunkSize));
+            }
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        const auto allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+        const auto megabytes = static_cast<double>(text.size() * sizeof(wchar_t)) * iterations / (1024.0 * 1024.0);
+        const auto seconds = std::chrono::duration<double>(end - start).count();
+        return { megabytes / seconds, static_cast<double>(allocations) / megabytes };
+    }
+
+    Result runParse(const std::wstring_view text)
+    {
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>());
+        StateMachine stateMachine{ std::move(engine) };
+        return replay(stateMachine, text);
+    }
+
+    Result runBuffer(const std::wstring_view text)
+    {
+        DummyRenderer renderer;
+        TerminalInput terminalInput{ nullptr };
+        BenchTerminal terminal{ renderer };
+        auto dispatch = std::make_unique<AdaptDispatch>(terminal, renderer, renderer._renderSettings, terminalInput);
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine stateMachine{ std::move(engine) };
+        terminal.SetStateMachine(&stateMachine);
+        return replay(stateMachine, text);
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    const auto corpora = argc > 1 ? loadCorpora(argc, argv) : makeCorpora();
+
+    // The parser's provider is registered along with its telemetry.
+    TermTelemetry::Instance();
+    const auto tracing = TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+    printf("parser tracing: %s\n", tracing ? "enabled" : "disabled");
+
+    printf("%-16s %10s %12s %14s %12s %14s\n", "corpus", "size", "parse MB/s", "parse allocs", "buffer MB/s", "buffer allocs");
+    for (const auto& corpus : corpora)
+    {
+        const auto parse = runParse(corpus.text);
+        const auto buffer = runBuffer(corpus.text);
+        printf("%-16s %8.1fMB %12.1f %12.1f/MB %12.1f %12.1f/MB\n",
+               corpus.name.c_str(),
+               static_cast<double>(corpus.text.size() * sizeof(wchar_t)) / (1024.0 * 1024.0),
+               parse.megabytesPerSecond,
+               parse.allocationsPerMegabyte,
+               buffer.megabytesPerSecond,
+               buffer.allocationsPerMegabyte);
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL RenderBench
+// Per-frame cost of the render engines on synthetic worst-case frames.
+//
+// For every engine (AtlasEngine, DxEngine, GdiEngine), window size, DPI and scenario
+// the tool creates a window, fills a Terminal's viewport with the scenario's contents
+// and then times Renderer::PaintFrame(), which includes the engine's Present(), for a
+// number of frames. Every frame is a full redraw, because that's the worst case and
+// because it makes the numbers comparable between engines, which invalidate differently.
+// For each run the tool reports the average frame rate, the p50/p99 frame duration
+// and the p50 of the Present phase, as measured by Renderer::GetFrameTimings.
+//
+// The scenarios are:
+// * ascii:      every cell a printable ASCII character
+// * truecolor:  every cell a different foreground and background color
+// * cjk:        every cell half of a wide glyph
+// * emoji:      every cell half of an emoji outside of the BMP
+// * ligatures:  programming ligatures, as drawn by Cascadia Code
+// * renditions: alternating single, double width and double height lines
+// * selected:   ascii, with the entire buffer selected
+//
+// The window has to be visible: swap chains of occluded windows are throttled.
+
+#define BLOCK_TIL
+#include <LibraryIncludes.h>
+
+#include <d2d1.h>
+#include <d3d11_1.h>
+#include <dwrite_3.h>
+#include <dxgi1_3.h>
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Microsoft.Terminal.Core.h>
+#include <til.h>
+
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/atlas/AtlasEngine.h"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/dx/DxRenderer.hpp"
+#include "../../renderer/gdi/gdirenderer.hpp"
+
+using namespace Microsoft::Console::Render;
+
+namespace
+{
+    constexpr int warmupFrames = 10;
+    constexpr int measuredFrames = 200;
+    constexpr auto fontFace = L"Cascadia Code";
+    constexpr til::CoordType fontHeight = 16; // in pixels at 96 DPI
+    constexpr std::array<til::size, 3> windowSizes{ { { 800, 600 }, { 1920, 1080 }, { 3840, 2160 } } };
+    constexpr std::array<int, 3> dpis{ USER_DEFAULT_SCREEN_DPI, USER_DEFAULT_SCREEN_DPI * 3 / 2, USER_DEFAULT_SCREEN_DPI * 2 };
+
+    struct Engine
+    {
+        const char* name;
+        std::unique_ptr<IRenderEngine> (*create)();
+    };
+
+    const std::array<Engine, 3> engines{ {
+        { "atlas", []() -> std::unique_ptr<IRenderEngine> { return std::make_unique<AtlasEngine>(); } },
+        { "dx", []() -> std::unique_ptr<IRenderEngine> { return std::make_unique<DxEngine>(); } },
+        { "gdi", []() -> std::unique_ptr<IRenderEngine> { return std::make_unique<GdiEngine>(); } },
+    } };
+
+    struct Scenario
+    {
+        const char* name;
+        // Returns the VT that fills the given viewport.
+        std::wstring (*generate)(til::size viewport);
+        bool selectAll = false;
+    };
+
+    // Calls the generator for every row and positions the cursor at its start.
+    // The generator has to return exactly one row worth of cells, so that nothing scrolls.
+    template<typename Generator>
+    std::wstring fill(const til::size viewport, Generator&& generator)
+    {
+        std::wstring text{ L"\x1b[?25l\x1b[H\x1b[2J" };
+        for (til::CoordType y = 0; y < viewport.height; ++y)
+        {
+            fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\x1b[{};1H"), y + 1);
+            generator(text, y, viewport.width);
+        }
+        return text;
+    }
+
+    std::wstring makeAscii(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            for (til::CoordType x = 0; x < width; ++x)
+            {
+                text.push_back(static_cast<wchar_t>(L'!' + (x + y) % 94));
+            }
+        });
+    }
+
+    std::wstring makeTruecolor(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            for (til::CoordType x = 0; x < width; ++x)
+            {
+                const auto i = static_cast<unsigned>(y * width + x);
+                fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\x1b[38;2;{};{};{};48;2;{};{};{}m{}"), i % 256, i * 7 % 256, i * 13 % 256, 255 - i % 256, i * 3 % 256, i * 11 % 256, static_cast<wchar_t>(L'A' + i % 26));
+            }
+            text.append(L"\x1b[m");
+        });
+    }
+
+    std::wstring makeCjk(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            for (til::CoordType x = 0; x + 1 < width; x += 2)
+            {
+                text.push_back(static_cast<wchar_t>(0x4e00 + (x + y * width) % 0x5000));
+            }
+        });
+    }
+
+    std::wstring makeEmoji(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            for (til::CoordType x = 0; x + 1 < width; x += 2)
+            {
+                // U+1F600 to U+1F64F (emoticons)
+                const auto ch = 0x1f600 + (x + y) % 0x50;
+                text.push_back(static_cast<wchar_t>(0xd800 + ((ch - 0x10000) >> 10)));
+                text.push_back(static_cast<wchar_t>(0xdc00 + ((ch - 0x10000) & 0x3ff)));
+            }
+        });
+    }
+
+    std::wstring makeLigatures(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            static constexpr std::wstring_view ligatures{ L"=> != === -> <= >= :: /* */ www <!-- --> |> <| ++ && || " };
+            for (til::CoordType x = 0; x < width; ++x)
+            {
+                text.push_back(ligatures[(x + y * 3) % ligatures.size()]);
+            }
+        });
+    }
+
+    std::wstring makeRenditions(const til::size viewport)
+    {
+        return fill(viewport, [](std::wstring& text, til::CoordType y, til::CoordType width) {
+            // DECSWL, DECDWL, DECDHL top and DECDHL bottom half.
+            static constexpr std::array<std::wstring_view, 4> renditions{ L"\x1b#5", L"\x1b#6", L"\x1b#3", L"\x1b#4" };
+            const auto rendition = y % 4;
+            text.append(til::at(renditions, rendition));
+            const auto cells = rendition ? width / 2 : width;
+            for (til::CoordType x = 0; x < cells; ++x)
+            {
+                text.push_back(static_cast<wchar_t>(L'a' + (x + y) % 26));
+            }
+        });
+    }
+
+    const std::array<Scenario, 7> scenarios{ {
+        { "ascii", &makeAscii },
+        { "truecolor", &makeTruecolor },
+        { "cjk", &makeCjk },
+        { "emoji", &makeEmoji },
+        { "ligatures", &makeLigatures },
+        { "renditions", &makeRenditions },
+        { "selected", &makeAscii, true },
+    } };
+
+    wil::unique_hwnd createWindow(const til::size clientSize, const int dpi)
+    {
+        static const auto windowClass = []() {
+            WNDCLASSEXW wc{};
+            wc.cbSize = sizeof(wc);
+            wc.lpfnWndProc = DefWindowProcW;
+            wc.hInstance = GetModuleHandleW(nullptr);
+            wc.hCursor = LoadCursorW(nullptr, IDC_ARROW);
+            wc.lpszClassName = L"RenderBench";
+            THROW_LAST_ERROR_IF(!RegisterClassExW(&wc));
+            return wc.lpszClassName;
+        }();
+
+        RECT rect{ 0, 0, clientSize.width, clientSize.height };
+        THROW_IF_WIN32_BOOL_FALSE(AdjustWindowRectExForDpi(&rect, WS_OVERLAPPEDWINDOW, FALSE, 0, dpi));
+
+        wil::unique_hwnd hwnd{ CreateWindowExW(0, windowClass, L"RenderBench", WS_OVERLAPPEDWINDOW | WS_VISIBLE, 0, 0, rect.right - rect.left, rect.bottom - rect.top, nullptr, nullptr, GetModuleHandleW(nullptr), nullptr) };
+        THROW_LAST_ERROR_IF(!hwnd);
+        return hwnd;
+    }
+
+    void pumpMessages() noexcept
+    {
+        MSG msg;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    // Returns the given percentile of the (unsorted) durations in microseconds.
+    double percentile(std::vector<std::chrono::steady_clock::duration>& durations, const size_t percent)
+    {
+        const auto index = std::min(durations.size() - 1, durations.size() * percent / 100);
+        std::nth_element(durations.begin(), durations.begin() + index, durations.end());
+        return std::chrono::duration<double, std::micro>(durations[index]).count();
+    }
+
+    void run(const Engine& engineInfo, const til::size windowSize, const int dpi)
+    {
+        const auto hwnd = createWindow(windowSize, dpi);
+        const auto engine = engineInfo.create();
+        THROW_IF_FAILED(engine->SetHwnd(hwnd.get()));
+        // GdiEngine takes its size from the window instead.
+        if (const auto hr = engine->SetWindowSize(windowSize); hr != E_NOTIMPL)
+        {
+            THROW_IF_FAILED(hr);
+        }
+
+        Microsoft::Terminal::Core::Terminal terminal;
+        Renderer renderer{ terminal.GetRenderSettings(), &terminal, nullptr, 0, nullptr };
+        renderer.AddRenderEngine(engine.get());
+
+        const FontInfoDesired desiredFont{ fontFace, 0, DWRITE_FONT_WEIGHT_NORMAL, { 0, fontHeight }, CP_UTF8 };
+        FontInfo actualFont{ fontFace, 0, DWRITE_FONT_WEIGHT_NORMAL, { 0, fontHeight }, CP_UTF8, false };
+        renderer.TriggerFontChange(dpi, desiredFont, actualFont);
+        THROW_IF_FAILED(engine->Enable());
+
+        const auto cellSize = actualFont.GetSize();
+        const til::size viewport{ std::max(1, windowSize.width / cellSize.width), std::max(1, windowSize.height / cellSize.height) };
+        terminal.Create(viewport, 0, renderer);
+        terminal.SetFontInfo(actualFont);
+
+        for (const auto& scenario : scenarios)
+        {
+            {
+                const auto lock = terminal.LockForWriting();
+                terminal.ClearSelection();
+                terminal.Write(scenario.generate(viewport));
+                if (scenario.selectAll)
+                {
+                    terminal.SelectAll();
+                }
+            }
+
+            std::vector<std::chrono::steady_clock::duration> frames;
+            frames.reserve(measuredFrames);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (auto i = 0; i < warmupFrames + measuredFrames; ++i)
+            {
+                if (i == warmupFrames)
+                {
+                    renderer.GetFrameTimings(true);
+                }
+
+                renderer.TriggerRedrawAll();
+                renderer.WaitUntilCanRender();
+
+                const auto before = std::chrono::steady_clock::now();
+                LOG_IF_FAILED(renderer.PaintFrame());
+                if (i >= warmupFrames)
+                {
+                    frames.emplace_back(std::chrono::steady_clock::now() - before);
+                }
+
+                pumpMessages();
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const auto timings = renderer.GetFrameTimings(true);
+            printf("%-6s %5dx%-5d %4d %4dx%-4d %-11s %8.1f %9.0fus %9.0fus %9uus\n",
+                   engineInfo.name,
+                   windowSize.width,
+                   windowSize.height,
+                   dpi,
+                   viewport.width,
+                   viewport.height,
+                   scenario.name,
+                   (warmupFrames + measuredFrames) / elapsed,
+                   percentile(frames, 50),
+                   percentile(frames, 99),
+                   timings.Percentile(FrameTimings::Present, 50));
+        }
+    }
+}
+
+int wmain(int /*argc*/, const wchar_t* /*argv*/[])
+try
+{
+    SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+
+    printf("%-6s %11s %4s %9s %-11s %8s %11s %11s %11s\n", "engine", "window", "dpi", "cells", "scenario", "fps", "frame p50", "frame p99", "present p50");
+    for (const auto& engine : engines)
+    {
+        for (const auto windowSize : windowSizes)
+        {
+            for (const auto dpi : dpis)
+            {
+                run(engine, windowSize, dpi);
+            }
+        }
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
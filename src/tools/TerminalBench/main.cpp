@@ -0,0 +1,405 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL TerminalBench
+// End-to-end throughput tests for the Terminal's output path, without a window or a GPU.
+//
+// A real Microsoft::Terminal::Core::Terminal is hooked up to a real Renderer, whose only
+// engine counts what it's asked to draw instead of drawing it. Every corpus is then written
+// into the Terminal at full speed for a number of scrollback sizes, painting a frame every
+// so often, like the render thread would if it couldn't keep up. For each run the tool reports:
+// * "parse": StateMachine + OutputStateMachineEngine with a dispatch that does nothing.
+//   This is the same for every scrollback size and is what the other numbers are compared against.
+// * "write": Terminal::Write() under the write lock, i.e. parsing and writing into the TextBuffer.
+//   "buffer" is the time spent in "write" that isn't spent in "parse".
+// * "paint": the p50/p99 duration of Renderer::PaintFrame() and of its buffer walk.
+// * "memory": the highest private commit of the process during the run,
+//   relative to what the process used before the Terminal was created.
+//   TextBuffer commits its rows with VirtualAlloc, so a heap counter wouldn't see them.
+//
+// Without arguments a built-in set of synthetic corpora is used. Any arguments are
+// treated as paths to recorded UTF-8 VT streams (for instance from `script` or a
+// conpty debug tap), which are then replayed instead.
+
+#define BLOCK_TIL
+#include <LibraryIncludes.h>
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Microsoft.Terminal.Core.h>
+#include <til.h>
+
+#include <psapi.h>
+
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/inc/RenderEngineBase.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::VirtualTerminal;
+
+namespace
+{
+    constexpr til::CoordType viewportWidth = 120;
+    constexpr til::CoordType viewportHeight = 30;
+    constexpr size_t corpusSize = 8 * 1024 * 1024; // in wchar_t
+    constexpr size_t chunkSize = 4096; // roughly what a single read from conpty returns
+    constexpr size_t charsPerFrame = 256 * 1024; // how much output arrives between two frames
+    constexpr std::array<til::CoordType, 4> scrollbackSizes{ 1'000, 10'000, 100'000, 1'000'000 };
+
+    struct Corpus
+    {
+        std::string name;
+        std::wstring text;
+    };
+
+    // Repeats the string returned by the generator until the corpus has the target size.
+    template<typename Generator>
+    std::wstring repeat(Generator&& generator)
+    {
+        std::wstring text;
+        text.reserve(corpusSize + 4096);
+        for (size_t i = 0; text.size() < corpusSize; ++i)
+        {
+            text.append(generator(i));
+        }
+        return text;
+    }
+
+    // Like `cat`ing a large log file.
+    std::wstring makeAscii()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"2022-06-01 12:{:02}:{:02}.{:03} [INFO] worker {:3} processed request {} in {}ms\r\n"), i / 60 % 60, i % 60, i % 1000, i % 128, i, i % 97);
+        });
+    }
+
+    // Like `ls --color` or a colored compiler log: a SGR sequence for every few characters.
+    std::wstring makeSgr()
+    {
+        return repeat([](size_t i) {
+            return fmt::format(FMT_COMPILE(L"\x1b[0m\x1b[01;34mdirectory{}\x1b[0m  \x1b[01;32mexecutable{}\x1b[0m  \x1b[38;5;{}mindexed\x1b[0m  \x1b[38;2;{};{};{}mtruecolor\x1b[0m\r\n"), i, i, i % 256, i % 256, (i * 7) % 256, (i * 13) % 256);
+        });
+    }
+
+    // Text in scripts with wide glyphs and surrogate pairs.
+    std::wstring makeUnicode()
+    {
+        return repeat([](size_t i) {
+            std::wstring line{ L"\x65e5\x672c\x8a9e\x306e\x30c6\x30ad\x30b9\x30c8 \xd55c\xad6d\xc5b4 \x4e2d\x6587 " };
+            line.append(i % 2 ? L"\xD83D\xDE00\xD83D\xDC4D\xD83C\xDF89" : L"\xD83D\xDD25\xD83C\xDF46\xD83E\xDD14");
+            line.append(L" caf\x00e9 na\x00efve \x03b1\x03b2\x03b3\r\n");
+            return line;
+        });
+    }
+
+    // Like `htop` or `vim`: absolutely positioned, colored updates of the whole viewport.
+    std::wstring makeTui()
+    {
+        return repeat([](size_t i) {
+            std::wstring frame{ L"\x1b[?25l\x1b[H" };
+            for (til::CoordType y = 1; y <= viewportHeight; ++y)
+            {
+                const auto percent = (i * 31 + y * 17) % 100;
+                const std::wstring bar(percent / 2, L'|');
+                const std::wstring padding(50 - percent / 2, L' ');
+                fmt::format_to(std::back_inserter(frame), FMT_COMPILE(L"\x1b[{};1H\x1b[K\x1b[1;36m{:3}\x1b[0m \x1b[32m[\x1b[{}m{}\x1b[0m{}\x1b[32m]\x1b[0m \x1b[7m{:3}%\x1b[27m"), y, y, percent > 80 ? 31 : 32, bar, padding, percent);
+            }
+            frame.append(L"\x1b[30;1H\x1b[?25h");
+            return frame;
+        });
+    }
+
+    std::vector<Corpus> makeCorpora()
+    {
+        std::vector<Corpus> corpora;
+        corpora.push_back({ "ascii", makeAscii() });
+        corpora.push_back({ "sgr", makeSgr() });
+        corpora.push_back({ "unicode", makeUnicode() });
+        corpora.push_back({ "tui", makeTui() });
+        return corpora;
+    }
+
+    std::vector<Corpus> loadCorpora(const int argc, const wchar_t* argv[])
+    {
+        std::vector<Corpus> corpora;
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::filesystem::path path{ til::at(argv, i) };
+            std::ifstream file{ path, std::ios::binary };
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !file);
+            const std::string bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+            corpora.push_back({ path.filename().string(), til::u8u16(bytes) });
+        }
+        return corpora;
+    }
+
+    // A dispatch that ignores everything, so that only the parser itself is measured.
+    class NullDispatch final : public TermDispatch
+    {
+    public:
+        void Print(const wchar_t /*wchPrintable*/) override
+        {
+        }
+
+        void PrintString(const std::wstring_view /*string*/) override
+        {
+        }
+    };
+
+    // An engine that draws nothing. It keeps track of what's invalidated like a real engine
+    // would, so that the Renderer walks as much of the buffer as it would for a real one.
+    class CountingRenderEngine final : public RenderEngineBase
+    {
+    public:
+        size_t lines = 0;
+        size_t clusters = 0;
+
+        HRESULT StartPaint() noexcept override
+        {
+            return _dirty ? S_OK : S_FALSE;
+        }
+        HRESULT EndPaint() noexcept override
+        {
+            _dirty = {};
+            return S_OK;
+        }
+        HRESULT Present() noexcept override { return S_OK; }
+        HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept override
+        {
+            *pForcePaint = false;
+            return S_OK;
+        }
+        HRESULT ScrollFrame() noexcept override { return S_OK; }
+        HRESULT Invalidate(const til::rect* psrRegion) noexcept override
+        {
+            _dirty |= *psrRegion & _viewport;
+            return S_OK;
+        }
+        HRESULT InvalidateCursor(const til::rect* psrRegion) noexcept override { return Invalidate(psrRegion); }
+        HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept override { return InvalidateAll(); }
+        HRESULT InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept override
+        {
+            for (const auto& rect : rectangles)
+            {
+                _dirty |= rect & _viewport;
+            }
+            return S_OK;
+        }
+        HRESULT InvalidateScroll(const til::point* /*pcoordDelta*/) noexcept override { return InvalidateAll(); }
+        HRESULT InvalidateAll() noexcept override
+        {
+            _dirty = _viewport;
+            return S_OK;
+        }
+        HRESULT PaintBackground() noexcept override { return S_OK; }
+        HRESULT PaintBufferLine(gsl::span<const Cluster> bufferLine, til::point /*coord*/, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept override
+        {
+            ++lines;
+            clusters += bufferLine.size();
+            return S_OK;
+        }
+        HRESULT PaintBufferGridLines(GridLineSet /*lines*/, COLORREF /*color*/, size_t /*cchLine*/, til::point /*coordTarget*/) noexcept override { return S_OK; }
+        HRESULT PaintSelection(const til::rect& /*rect*/) noexcept override { return S_OK; }
+        HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept override { return S_OK; }
+        HRESULT UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/, const RenderSettings& /*renderSettings*/, gsl::not_null<IRenderData*> /*pData*/, bool /*usingSoftFont*/, bool /*isSettingDefaultBrushes*/) noexcept override { return S_OK; }
+        HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept override { return S_OK; }
+        HRESULT UpdateDpi(int /*iDpi*/) noexcept override { return S_OK; }
+        HRESULT UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept override
+        {
+            _viewport = { 0, 0, srNewViewport.right - srNewViewport.left + 1, srNewViewport.bottom - srNewViewport.top + 1 };
+            _dirty = _viewport;
+            return S_OK;
+        }
+        HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, int /*iDpi*/) noexcept override { return S_OK; }
+        HRESULT GetDirtyArea(gsl::span<const til::rect>& area) noexcept override
+        {
+            area = { &_dirty, 1 };
+            return S_OK;
+        }
+        HRESULT GetFontSize(_Out_ til::size* pFontSize) noexcept override
+        {
+            *pFontSize = { 1, 1 };
+            return S_OK;
+        }
+        HRESULT IsGlyphWideByFont(std::wstring_view /*glyph*/, _Out_ bool* pResult) noexcept override
+        {
+            *pResult = false;
+            return S_OK;
+        }
+
+    protected:
+        HRESULT _DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept override { return S_OK; }
+
+    private:
+        til::rect _viewport{ 0, 0, viewportWidth, viewportHeight };
+        til::rect _dirty;
+    };
+
+    size_t privateBytes() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS_EX counters{};
+        counters.cb = sizeof(counters);
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        {
+            return 0;
+        }
+        return counters.PrivateUsage;
+    }
+
+    double megabytes(const size_t bytes) noexcept
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    double seconds(const std::chrono::steady_clock::duration duration) noexcept
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // Returns the given percentile of the (unsorted) durations in microseconds.
+    double percentile(std::vector<std::chrono::steady_clock::duration>& durations, const size_t percent)
+    {
+        if (durations.empty())
+        {
+            return 0;
+        }
+        const auto index = std::min(durations.size() - 1, durations.size() * percent / 100);
+        std::nth_element(durations.begin(), durations.begin() + index, durations.end());
+        return std::chrono::duration<double, std::micro>(durations[index]).count();
+    }
+
+    std::chrono::steady_clock::duration runParse(const std::wstring_view text)
+    {
+        StateMachine stateMachine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>()) };
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < text.size(); offset += chunkSize)
+        {
+            stateMachine.ProcessString(text.substr(offset, chunkSize));
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    struct Result
+    {
+        std::chrono::steady_clock::duration fill{};
+        std::chrono::steady_clock::duration write{};
+        std::vector<std::chrono::steady_clock::duration> paints;
+        uint32_t walkP50 = 0;
+        uint32_t walkP99 = 0;
+        size_t lines = 0;
+        size_t peakBytes = 0;
+    };
+
+    Result runTerminal(const std::wstring_view text, const til::CoordType scrollback)
+    {
+        Result result;
+        const auto baseline = privateBytes();
+        const auto sample = [&]() noexcept {
+            result.peakBytes = std::max(result.peakBytes, privateBytes() - std::min(privateBytes(), baseline));
+        };
+
+        {
+            CountingRenderEngine engine;
+            Microsoft::Terminal::Core::Terminal terminal;
+            Renderer renderer{ terminal.GetRenderSettings(), &terminal, nullptr, 0, nullptr };
+            renderer.AddRenderEngine(&engine);
+            terminal.Create({ viewportWidth, viewportHeight }, scrollback, renderer);
+
+            // Fill the scrollback first, so that the corpus is written into
+            // a circular buffer that's as full as it'll be in practice.
+            {
+                std::wstring lines;
+                for (til::CoordType i = 0; i < 1024; ++i)
+                {
+                    fmt::format_to(std::back_inserter(lines), FMT_COMPILE(L"scrollback line {:>100}\r\n"), i);
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                for (til::CoordType row = 0; row < scrollback + viewportHeight; row += 1024)
+                {
+                    const auto lock = terminal.LockForWriting();
+                    terminal.Write(lines);
+                }
+                result.fill = std::chrono::steady_clock::now() - start;
+                sample();
+            }
+
+            renderer.GetFrameTimings(true);
+            engine.lines = 0;
+
+            auto untilPaint = charsPerFrame;
+            for (size_t offset = 0; offset < text.size(); offset += chunkSize)
+            {
+                const auto chunk = text.substr(offset, chunkSize);
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    const auto lock = terminal.LockForWriting();
+                    terminal.Write(chunk);
+                    result.write += std::chrono::steady_clock::now() - start;
+                }
+
+                if (chunk.size() >= untilPaint || offset + chunkSize >= text.size())
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    LOG_IF_FAILED(renderer.PaintFrame());
+                    result.paints.emplace_back(std::chrono::steady_clock::now() - start);
+                    untilPaint = charsPerFrame;
+                    sample();
+                }
+                else
+                {
+                    untilPaint -= chunk.size();
+                }
+            }
+
+            const auto timings = renderer.GetFrameTimings(true);
+            result.walkP50 = timings.Percentile(FrameTimings::BufferOutput, 50);
+            result.walkP99 = timings.Percentile(FrameTimings::BufferOutput, 99);
+            result.lines = engine.lines;
+            sample();
+        }
+
+        return result;
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    const auto corpora = argc > 1 ? loadCorpora(argc, argv) : makeCorpora();
+
+    printf("%-12s %10s %10s %8s %11s %11s %10s %14s %14s %13s %10s\n", "corpus", "scrollback", "parse MB/s", "fill s", "write MB/s", "buffer MB/s", "frames", "paint p50/p99", "walk p50/p99", "lines/frame", "memory");
+    for (const auto& corpus : corpora)
+    {
+        const auto size = megabytes(corpus.text.size() * sizeof(wchar_t));
+        const auto parse = runParse(corpus.text);
+
+        for (const auto scrollback : scrollbackSizes)
+        {
+            auto result = runTerminal(corpus.text, scrollback);
+            const auto buffer = result.write > parse ? result.write - parse : std::chrono::steady_clock::duration{ 1 };
+            const auto frames = result.paints.size();
+            printf("%-12s %10d %10.1f %8.2f %11.1f %11.1f %10zu %6.0f/%5.0fus %6u/%5uus %13.1f %8.1fMB\n",
+                   corpus.name.c_str(),
+                   scrollback,
+                   size / seconds(parse),
+                   seconds(result.fill),
+                   size / seconds(result.write),
+                   size / seconds(buffer),
+                   frames,
+                   percentile(result.paints, 50),
+                   percentile(result.paints, 99),
+                   result.walkP50,
+                   result.walkP99,
+                   frames ? static_cast<double>(result.lines) / frames : 0.0,
+                   megabytes(result.peakBytes));
+        }
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "inc/CodepointWidthDetector.hpp"
+#include "inc/Utf16Parser.hpp"
 
 namespace
 {
@@ -14,11 +15,6 @@ namespace
         CodepointWidth width;
     };
 
-    static bool operator<(const UnicodeRange& range, const unsigned int searchTerm) noexcept
-    {
-        return range.upperBound < searchTerm;
-    }
-
     // Generated by Generate-CodepointWidthsFromUCD.ps1 -Pack:True -Full:False -NoOverrides:False
     // on 6/13/2022 8:57:08 PM (UTC) from Unicode 14.0.0.
     // 321259 (0x4E6EB) codepoints covered.
@@ -326,6 +322,161 @@ namespace
         UnicodeRange{ 0xf0000, 0xffffd, CodepointWidth::Ambiguous },
         UnicodeRange{ 0x100000, 0x10fffd, CodepointWidth::Ambiguous },
     };
+
+    // s_wideAndAmbiguousTable is turned into a two-stage lookup table at compile time,
+    // so that looking up a codepoint doesn't need a binary search:
+    // The codepoint space is split into blocks of 256 codepoints. stage1 maps each block to one of the
+    // blocks in stage2, which store the width of every codepoint in them as 2 bits.
+    // Most blocks are made up of codepoints with the same width, so stage2 starts with one such block
+    // for each width. Only the few remaining blocks get a stage2 block of their own.
+    constexpr unsigned int BlockShift = 8;
+    constexpr unsigned int BlockSize = 1u << BlockShift;
+    constexpr unsigned int BlockCount = 0x110000 >> BlockShift;
+    constexpr size_t UniformBlockCount = 3; // Narrow, Wide and Ambiguous
+
+    using WidthBlock = std::array<uint64_t, BlockSize * 2 / 64>;
+
+    // Returns a word of WidthBlock with every codepoint set to the given width.
+    constexpr uint64_t widthPattern(const CodepointWidth width) noexcept
+    {
+        return 0x5555555555555555 * static_cast<uint64_t>(width);
+    }
+
+    // Calls func(block, width, range) for each block that contains codepoints from s_wideAndAmbiguousTable,
+    // where width is the width shared by all the codepoints of the block, or CodepointWidth::Invalid if they differ.
+    // range is the index of the first entry of s_wideAndAmbiguousTable that overlaps with the block.
+    // Blocks that aren't visited are entirely narrow.
+    template<typename T>
+    constexpr void classifyBlocks(T&& func)
+    {
+        size_t range = 0;
+        unsigned int block = 0;
+        while (block < BlockCount)
+        {
+            const auto lo = block << BlockShift;
+            const auto hi = lo + BlockSize - 1;
+
+            while (range < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[range].upperBound < lo)
+            {
+                ++range;
+            }
+            if (range == s_wideAndAmbiguousTable.size())
+            {
+                break;
+            }
+
+            const auto& r = s_wideAndAmbiguousTable[range];
+            if (r.lowerBound > hi)
+            {
+                // Skip ahead to the block containing the next range.
+                block = r.lowerBound >> BlockShift;
+                continue;
+            }
+
+            func(block, r.lowerBound <= lo && r.upperBound >= hi ? r.width : CodepointWidth::Invalid, range);
+            ++block;
+        }
+    }
+
+    constexpr size_t countMixedBlocks()
+    {
+        size_t count = 0;
+        classifyBlocks([&](unsigned int, CodepointWidth width, size_t) {
+            count += width == CodepointWidth::Invalid;
+        });
+        return count;
+    }
+
+    template<size_t Stage2Size>
+    struct WidthTable
+    {
+        std::array<uint8_t, BlockCount> stage1{};
+        std::array<WidthBlock, Stage2Size> stage2{};
+
+        constexpr CodepointWidth Lookup(const unsigned int codepoint) const noexcept
+        {
+            if (codepoint >= BlockCount << BlockShift)
+            {
+                return CodepointWidth::Narrow;
+            }
+
+            const auto& block = til::at(stage2, til::at(stage1, codepoint >> BlockShift));
+            const auto index = codepoint & (BlockSize - 1);
+            return static_cast<CodepointWidth>((til::at(block, index / 32) >> (index % 32 * 2)) & 3);
+        }
+    };
+
+    constexpr auto buildWidthTable()
+    {
+        constexpr auto stage2Size = UniformBlockCount + countMixedBlocks();
+        static_assert(stage2Size <= 256, "stage1 stores indices into stage2 as uint8_t");
+
+        WidthTable<stage2Size> table;
+
+        // The uniform blocks are at the index of the width they represent.
+        for (const auto width : { CodepointWidth::Wide, CodepointWidth::Ambiguous })
+        {
+            for (auto& word : table.stage2[static_cast<size_t>(width)])
+            {
+                word = widthPattern(width);
+            }
+        }
+
+        auto next = UniformBlockCount;
+        classifyBlocks([&](unsigned int block, CodepointWidth width, size_t range) {
+            if (width != CodepointWidth::Invalid)
+            {
+                table.stage1[block] = static_cast<uint8_t>(width);
+                return;
+            }
+
+            table.stage1[block] = static_cast<uint8_t>(next);
+            auto& dst = table.stage2[next++];
+
+            const auto lo = block << BlockShift;
+            const auto hi = lo + BlockSize - 1;
+            for (; range < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[range].lowerBound <= hi; ++range)
+            {
+                // Set the codepoints [beg, end] of the block, 32 per word.
+                const auto& r = s_wideAndAmbiguousTable[range];
+                const auto beg = std::max(r.lowerBound, lo) - lo;
+                const auto end = std::min(r.upperBound, hi) - lo;
+                for (auto word = beg / 32; word <= end / 32; ++word)
+                {
+                    const auto first = std::max(beg, word * 32) % 32;
+                    const auto last = std::min(end, word * 32 + 31) % 32;
+                    const auto mask = (~uint64_t{ 0 } >> (62 - last * 2)) & (~uint64_t{ 0 } << (first * 2));
+                    dst[word] |= widthPattern(r.width) & mask;
+                }
+            }
+        });
+
+        return table;
+    }
+
+    static constexpr auto s_widthTable = buildWidthTable();
+
+    // Checks the edges of every range in s_wideAndAmbiguousTable,
+    // which is where a mistake in building s_widthTable would show.
+    constexpr bool widthTableMatchesRanges()
+    {
+        unsigned int previousUpperBound = 0;
+        for (const auto& r : s_wideAndAmbiguousTable)
+        {
+            if (s_widthTable.Lookup(r.lowerBound) != r.width || s_widthTable.Lookup(r.upperBound) != r.width)
+            {
+                return false;
+            }
+            if (r.lowerBound > previousUpperBound + 1 && s_widthTable.Lookup(r.lowerBound - 1) != CodepointWidth::Narrow)
+            {
+                return false;
+            }
+            previousUpperBound = r.upperBound;
+        }
+        return true;
+    }
+
+    static_assert(widthTableMatchesRanges());
 }
 
 // Routine Description:
@@ -421,17 +572,34 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view
         return CodepointWidth::Invalid;
     }
 
-    const auto codepoint = _extractCodepoint(glyph);
-    const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
+    return s_widthTable.Lookup(_extractCodepoint(glyph));
+}
 
-    // For characters that are not _in_ the table, lower_bound will return the nearest item that is.
-    // We must check its bounds to make sure that our hit was a true hit.
-    if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
+// Routine Description:
+// - measures the run of narrow, printable characters at the start of the given text, so that
+//   callers can write it without measuring each of them. The run ends at the first control character,
+//   surrogate or character that isn't narrow according to the Unicode standard (ambiguous ones included,
+//   as the font fallback might consider them wide).
+// Arguments:
+// - text - the utf16 encoded text to measure
+// Return Value:
+// - the number of characters in the run, each of which takes up exactly one cell
+size_t CodepointWidthDetector::GetNarrowRunLength(const std::wstring_view text) const noexcept
+{
+    size_t length = 0;
+    for (const auto wch : text)
     {
-        return it->width;
+        if (wch < L' ' || wch == L'\x7f' || (wch >= 0xD800 && wch <= 0xDFFF))
+        {
+            break;
+        }
+        if (wch >= 0x80 && s_widthTable.Lookup(wch) != CodepointWidth::Narrow)
+        {
+            break;
+        }
+        ++length;
     }
-
-    return CodepointWidth::Narrow;
+    return length;
 }
 
 // Routine Description:
@@ -481,14 +649,12 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidthWithCache(const std::wst
 // - true if codepoint is wide or false if it is narrow
 bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyph) const
 {
-    const std::wstring findMe{ glyph };
-
     // TODO: Cache needs to be emptied when font changes.
-    const auto it = _fallbackCache.find(findMe);
+    const auto it = _fallbackCache.find(glyph);
     if (it == _fallbackCache.end())
     {
         auto result = _pfnFallbackMethod(glyph);
-        _fallbackCache.insert_or_assign(findMe, result);
+        _fallbackCache.insert_or_assign(std::wstring{ glyph }, result);
         return result;
     }
     else
@@ -505,7 +671,8 @@ bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyp
 // - the codepoint being stored
 unsigned int CodepointWidthDetector::_extractCodepoint(const std::wstring_view glyph) noexcept
 {
-    if (glyph.size() == 1)
+    // A grapheme cluster is measured by its first codepoint.
+    if (glyph.size() == 1 || !Utf16Parser::IsLeadingSurrogate(glyph.front()))
     {
         return static_cast<unsigned int>(glyph.front());
     }
@@ -22,6 +22,21 @@ static constexpr double rad180 = 3.141592653589793238;
 static constexpr double rad275 = 4.799655442984406336;
 static constexpr double rad360 = 6.283185307179586476;
 
+// pow(25.0, 7)
+static constexpr double pow25To7 = 6103515625.0;
+
+// pow() with an integral exponent is much slower than the equivalent multiplications.
+static constexpr double square(const double x) noexcept
+{
+    return x * x;
+}
+
+static constexpr double pow7(const double x) noexcept
+{
+    const auto x3 = x * x * x;
+    return x3 * x3 * x;
+}
+
 ColorFix::ColorFix(COLORREF color) noexcept
 {
     rgb = color;
@@ -61,23 +76,25 @@ double ColorFix::_GetDeltaE(ColorFix x1, ColorFix x2) noexcept
     const auto lBar = (x1.L + x2.L) / 2;
 
     // C1 & C2
-    const auto c1 = sqrt(pow(x1.A, 2) + pow(x1.B, 2));
-    const auto c2 = sqrt(pow(x2.A, 2) + pow(x2.B, 2));
+    const auto c1 = sqrt(square(x1.A) + square(x1.B));
+    const auto c2 = sqrt(square(x2.A) + square(x2.B));
 
     // C Bar
     const auto cBar = (c1 + c2) / 2;
+    const auto cBar7 = pow7(cBar);
+    const auto g = 1 - sqrt(cBar7 / (cBar7 + pow25To7));
 
     // A Prime 1
-    const auto aPrime1 = x1.A + (x1.A / 2) * (1 - sqrt(pow(cBar, 7) / (pow(cBar, 7) + pow(25.0, 7))));
+    const auto aPrime1 = x1.A + (x1.A / 2) * g;
 
     // A Prime 2
-    const auto aPrime2 = x2.A + (x2.A / 2) * (1 - sqrt(pow(cBar, 7) / (pow(cBar, 7) + pow(25.0, 7))));
+    const auto aPrime2 = x2.A + (x2.A / 2) * g;
 
     // C Prime 1
-    const auto cPrime1 = sqrt(pow(aPrime1, 2) + pow(x1.B, 2));
+    const auto cPrime1 = sqrt(square(aPrime1) + square(x1.B));
 
     // C Prime 2
-    const auto cPrime2 = sqrt(pow(aPrime2, 2) + pow(x2.B, 2));
+    const auto cPrime2 = sqrt(square(aPrime2) + square(x2.B));
 
     // C Bar Prime
     const auto cBarPrime = (cPrime1 + cPrime2) / 2;
@@ -86,7 +103,8 @@ double ColorFix::_GetDeltaE(ColorFix x1, ColorFix x2) noexcept
     const auto deltaCPrime = cPrime2 - cPrime1;
 
     // S sub L
-    const auto sSubL = 1 + ((0.015 * pow(lBar - 50, 2)) / sqrt(20 + pow(lBar - 50, 2)));
+    const auto lBarMinus50Squared = square(lBar - 50);
+    const auto sSubL = 1 + ((0.015 * lBarMinus50Squared) / sqrt(20 + lBarMinus50Squared));
 
     // S sub C
     const auto sSubC = 1 + 0.045 * cBarPrime;
@@ -110,14 +128,15 @@ double ColorFix::_GetDeltaE(ColorFix x1, ColorFix x2) noexcept
     const auto sSubH = 1 + 0.015 * cBarPrime * t;
 
     // R sub T
-    const auto rSubT = -2 * sqrt(pow(cBarPrime, 7) / (pow(cBarPrime, 7) + pow(25.0, 7))) * sin(rad060 * exp(-pow((hBarPrime - rad275) / rad025, 2)));
+    const auto cBarPrime7 = pow7(cBarPrime);
+    const auto rSubT = -2 * sqrt(cBarPrime7 / (cBarPrime7 + pow25To7)) * sin(rad060 * exp(-square((hBarPrime - rad275) / rad025)));
 
     // Put it all together!
     const auto lightness = deltaLPrime / (kSubL * sSubL);
     const auto chroma = deltaCPrime / (kSubC * sSubC);
     const auto hue = deltaHPrime / (kSubH * sSubH);
 
-    return sqrt(pow(lightness, 2) + pow(chroma, 2) + pow(hue, 2) + rSubT * chroma * hue);
+    return sqrt(square(lightness) + square(chroma) + square(hue) + rSubT * chroma * hue);
 }
 
 // Method Description:
@@ -166,9 +185,12 @@ void ColorFix::_ToRGB()
     auto var_X = A / 500. + var_Y;
     auto var_Z = var_Y - B / 200.;
 
-    var_Y = (pow(var_Y, 3) > 0.008856) ? pow(var_Y, 3) : (var_Y - 16. / 116.) / 7.787;
-    var_X = (pow(var_X, 3) > 0.008856) ? pow(var_X, 3) : (var_X - 16. / 116.) / 7.787;
-    var_Z = (pow(var_Z, 3) > 0.008856) ? pow(var_Z, 3) : (var_Z - 16. / 116.) / 7.787;
+    const auto var_Y3 = var_Y * var_Y * var_Y;
+    const auto var_X3 = var_X * var_X * var_X;
+    const auto var_Z3 = var_Z * var_Z * var_Z;
+    var_Y = (var_Y3 > 0.008856) ? var_Y3 : (var_Y - 16. / 116.) / 7.787;
+    var_X = (var_X3 > 0.008856) ? var_X3 : (var_X - 16. / 116.) / 7.787;
+    var_Z = (var_Z3 > 0.008856) ? var_Z3 : (var_Z - 16. / 116.) / 7.787;
 
     const auto X = 95.047 * var_X; //ref_X =  95.047     (Observer= 2 degrees, Illuminant= D65)
     const auto Y = 100.000 * var_Y; //ref_Y = 100.000
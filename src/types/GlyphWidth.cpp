@@ -25,6 +25,14 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return widthDetector.IsWide(wch);
 }
 
+// Function Description:
+// - measures the run of narrow, printable characters at the start of the text.
+//      See CodepointWidthDetector::GetNarrowRunLength
+size_t GetNarrowGlyphRunLength(const std::wstring_view text) noexcept
+{
+    return widthDetector.GetNarrowRunLength(text);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
@@ -0,0 +1,981 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "inc/GraphemeBreak.hpp"
+#include "inc/Utf16Parser.hpp"
+
+namespace
+{
+    // The Grapheme_Cluster_Break property of a codepoint, with Extended_Pictographic
+    // folded in as a value of its own (those codepoints are all Grapheme_Cluster_Break=Other).
+    enum class GraphemeBreakProperty : uint8_t
+    {
+        Other = 0,
+        CR,
+        LF,
+        Control,
+        Extend,
+        ZWJ,
+        RegionalIndicator,
+        Prepend,
+        SpacingMark,
+        L,
+        V,
+        T,
+        LV,
+        LVT,
+        ExtendedPictographic,
+    };
+
+    struct GraphemeRange final
+    {
+        unsigned int lowerBound;
+        unsigned int upperBound;
+        GraphemeBreakProperty property;
+    };
+
+    // Generated from GraphemeBreakProperty and emoji-data as shipped with ICU 73.1 (Unicode 15.0.0).
+    // Codepoints that aren't listed are Other.
+    // The Hangul syllables U+AC00-U+D7A3 alternate between LV and LVT and aren't listed either,
+    // as Lookup() computes their property instead.
+    static constexpr std::array<GraphemeRange, 651> s_graphemeBreakTable{
+        GraphemeRange{ 0x0, 0x9, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xa, 0xa, GraphemeBreakProperty::LF },
+        GraphemeRange{ 0xb, 0xc, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xd, 0xd, GraphemeBreakProperty::CR },
+        GraphemeRange{ 0xe, 0x1f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x7f, 0x9f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xa9, 0xa9, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0xad, 0xad, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xae, 0xae, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x300, 0x36f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x483, 0x489, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x591, 0x5bd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x5bf, 0x5bf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x5c1, 0x5c2, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x5c4, 0x5c5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x5c7, 0x5c7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x600, 0x605, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x610, 0x61a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x61c, 0x61c, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x64b, 0x65f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x670, 0x670, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x6d6, 0x6dc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x6dd, 0x6dd, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x6df, 0x6e4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x6e7, 0x6e8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x6ea, 0x6ed, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x70f, 0x70f, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x711, 0x711, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x730, 0x74a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x7a6, 0x7b0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x7eb, 0x7f3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x7fd, 0x7fd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x816, 0x819, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x81b, 0x823, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x825, 0x827, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x829, 0x82d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x859, 0x85b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x890, 0x891, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x898, 0x89f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x8ca, 0x8e1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x8e2, 0x8e2, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x8e3, 0x902, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x903, 0x903, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x93a, 0x93a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x93b, 0x93b, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x93c, 0x93c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x93e, 0x940, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x941, 0x948, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x949, 0x94c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x94d, 0x94d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x94e, 0x94f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x951, 0x957, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x962, 0x963, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x981, 0x981, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x982, 0x983, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x9bc, 0x9bc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9be, 0x9be, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9bf, 0x9c0, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x9c1, 0x9c4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9c7, 0x9c8, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x9cb, 0x9cc, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x9cd, 0x9cd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9d7, 0x9d7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9e2, 0x9e3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x9fe, 0x9fe, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa01, 0xa02, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa03, 0xa03, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa3c, 0xa3c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa3e, 0xa40, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa41, 0xa42, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa47, 0xa48, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa4b, 0xa4d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa51, 0xa51, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa70, 0xa71, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa75, 0xa75, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa81, 0xa82, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa83, 0xa83, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xabc, 0xabc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xabe, 0xac0, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xac1, 0xac5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xac7, 0xac8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xac9, 0xac9, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xacb, 0xacc, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xacd, 0xacd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xae2, 0xae3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xafa, 0xaff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb01, 0xb01, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb02, 0xb03, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xb3c, 0xb3c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb3e, 0xb3f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb40, 0xb40, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xb41, 0xb44, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb47, 0xb48, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xb4b, 0xb4c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xb4d, 0xb4d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb55, 0xb57, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb62, 0xb63, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xb82, 0xb82, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xbbe, 0xbbe, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xbbf, 0xbbf, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xbc0, 0xbc0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xbc1, 0xbc2, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xbc6, 0xbc8, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xbca, 0xbcc, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xbcd, 0xbcd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xbd7, 0xbd7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc00, 0xc00, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc01, 0xc03, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xc04, 0xc04, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc3c, 0xc3c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc3e, 0xc40, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc41, 0xc44, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xc46, 0xc48, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc4a, 0xc4d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc55, 0xc56, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc62, 0xc63, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc81, 0xc81, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xc82, 0xc83, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xcbc, 0xcbc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcbe, 0xcbe, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xcbf, 0xcbf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcc0, 0xcc1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xcc2, 0xcc2, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcc3, 0xcc4, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xcc6, 0xcc6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcc7, 0xcc8, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xcca, 0xccb, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xccc, 0xccd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcd5, 0xcd6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xce2, 0xce3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xcf3, 0xcf3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xd00, 0xd01, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd02, 0xd03, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xd3b, 0xd3c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd3e, 0xd3e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd3f, 0xd40, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xd41, 0xd44, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd46, 0xd48, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xd4a, 0xd4c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xd4d, 0xd4d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd4e, 0xd4e, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0xd57, 0xd57, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd62, 0xd63, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd81, 0xd81, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd82, 0xd83, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xdca, 0xdca, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xdcf, 0xdcf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xdd0, 0xdd1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xdd2, 0xdd4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xdd6, 0xdd6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xdd8, 0xdde, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xddf, 0xddf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xdf2, 0xdf3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xe31, 0xe31, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xe33, 0xe33, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xe34, 0xe3a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xe47, 0xe4e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xeb1, 0xeb1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xeb3, 0xeb3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xeb4, 0xebc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xec8, 0xece, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf18, 0xf19, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf35, 0xf35, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf37, 0xf37, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf39, 0xf39, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf3e, 0xf3f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xf71, 0xf7e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf7f, 0xf7f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xf80, 0xf84, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf86, 0xf87, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf8d, 0xf97, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xf99, 0xfbc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xfc6, 0xfc6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x102d, 0x1030, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1031, 0x1031, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1032, 0x1037, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1039, 0x103a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x103b, 0x103c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x103d, 0x103e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1056, 0x1057, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1058, 0x1059, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x105e, 0x1060, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1071, 0x1074, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1082, 0x1082, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1084, 0x1084, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1085, 0x1086, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x108d, 0x108d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x109d, 0x109d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1100, 0x115f, GraphemeBreakProperty::L },
+        GraphemeRange{ 0x1160, 0x11a7, GraphemeBreakProperty::V },
+        GraphemeRange{ 0x11a8, 0x11ff, GraphemeBreakProperty::T },
+        GraphemeRange{ 0x135d, 0x135f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1712, 0x1714, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1715, 0x1715, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1732, 0x1733, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1734, 0x1734, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1752, 0x1753, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1772, 0x1773, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x17b4, 0x17b5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x17b6, 0x17b6, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x17b7, 0x17bd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x17be, 0x17c5, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x17c6, 0x17c6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x17c7, 0x17c8, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x17c9, 0x17d3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x17dd, 0x17dd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x180b, 0x180d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x180e, 0x180e, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x180f, 0x180f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1885, 0x1886, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x18a9, 0x18a9, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1920, 0x1922, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1923, 0x1926, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1927, 0x1928, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1929, 0x192b, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1930, 0x1931, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1932, 0x1932, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1933, 0x1938, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1939, 0x193b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a17, 0x1a18, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a19, 0x1a1a, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1a1b, 0x1a1b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a55, 0x1a55, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1a56, 0x1a56, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a57, 0x1a57, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1a58, 0x1a5e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a60, 0x1a60, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a62, 0x1a62, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a65, 0x1a6c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a6d, 0x1a72, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1a73, 0x1a7c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1a7f, 0x1a7f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1ab0, 0x1ace, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b00, 0x1b03, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b04, 0x1b04, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1b34, 0x1b3a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b3b, 0x1b3b, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1b3c, 0x1b3c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b3d, 0x1b41, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1b42, 0x1b42, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b43, 0x1b44, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1b6b, 0x1b73, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b80, 0x1b81, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1b82, 0x1b82, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1ba1, 0x1ba1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1ba2, 0x1ba5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1ba6, 0x1ba7, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1ba8, 0x1ba9, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1baa, 0x1baa, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1bab, 0x1bad, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1be6, 0x1be6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1be7, 0x1be7, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1be8, 0x1be9, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1bea, 0x1bec, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1bed, 0x1bed, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1bee, 0x1bee, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1bef, 0x1bf1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1bf2, 0x1bf3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1c24, 0x1c2b, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1c2c, 0x1c33, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1c34, 0x1c35, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1c36, 0x1c37, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1cd0, 0x1cd2, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1cd4, 0x1ce0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1ce1, 0x1ce1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1ce2, 0x1ce8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1ced, 0x1ced, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1cf4, 0x1cf4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1cf7, 0x1cf7, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1cf8, 0x1cf9, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1dc0, 0x1dff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x200b, 0x200b, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x200c, 0x200c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x200d, 0x200d, GraphemeBreakProperty::ZWJ },
+        GraphemeRange{ 0x200e, 0x200f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x2028, 0x202e, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x203c, 0x203c, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2049, 0x2049, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2060, 0x206f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x20d0, 0x20f0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x2122, 0x2122, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2139, 0x2139, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2194, 0x2199, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x21a9, 0x21aa, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x231a, 0x231b, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2328, 0x2328, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2388, 0x2388, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x23cf, 0x23cf, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x23e9, 0x23f3, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x23f8, 0x23fa, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x24c2, 0x24c2, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x25aa, 0x25ab, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x25b6, 0x25b6, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x25c0, 0x25c0, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x25fb, 0x25fe, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2600, 0x2605, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2607, 0x2612, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2614, 0x2685, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2690, 0x2705, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2708, 0x2712, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2714, 0x2714, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2716, 0x2716, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x271d, 0x271d, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2721, 0x2721, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2728, 0x2728, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2733, 0x2734, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2744, 0x2744, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2747, 0x2747, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x274c, 0x274c, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x274e, 0x274e, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2753, 0x2755, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2757, 0x2757, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2763, 0x2767, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2795, 0x2797, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x27a1, 0x27a1, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x27b0, 0x27b0, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x27bf, 0x27bf, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2934, 0x2935, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2b05, 0x2b07, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2b1b, 0x2b1c, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2b50, 0x2b50, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2b55, 0x2b55, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x2cef, 0x2cf1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x2d7f, 0x2d7f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x2de0, 0x2dff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x302a, 0x302f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x3030, 0x3030, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x303d, 0x303d, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x3099, 0x309a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x3297, 0x3297, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x3299, 0x3299, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0xa66f, 0xa672, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa674, 0xa67d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa69e, 0xa69f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa6f0, 0xa6f1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa802, 0xa802, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa806, 0xa806, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa80b, 0xa80b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa823, 0xa824, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa825, 0xa826, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa827, 0xa827, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa82c, 0xa82c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa880, 0xa881, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa8b4, 0xa8c3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa8c4, 0xa8c5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa8e0, 0xa8f1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa8ff, 0xa8ff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa926, 0xa92d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa947, 0xa951, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa952, 0xa953, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa960, 0xa97c, GraphemeBreakProperty::L },
+        GraphemeRange{ 0xa980, 0xa982, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa983, 0xa983, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa9b3, 0xa9b3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa9b4, 0xa9b5, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa9b6, 0xa9b9, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa9ba, 0xa9bb, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa9bc, 0xa9bd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xa9be, 0xa9c0, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xa9e5, 0xa9e5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa29, 0xaa2e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa2f, 0xaa30, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaa31, 0xaa32, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa33, 0xaa34, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaa35, 0xaa36, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa43, 0xaa43, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa4c, 0xaa4c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaa4d, 0xaa4d, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaa7c, 0xaa7c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaab0, 0xaab0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaab2, 0xaab4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaab7, 0xaab8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaabe, 0xaabf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaac1, 0xaac1, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaaeb, 0xaaeb, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaaec, 0xaaed, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xaaee, 0xaaef, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaaf5, 0xaaf5, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xaaf6, 0xaaf6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xabe3, 0xabe4, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xabe5, 0xabe5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xabe6, 0xabe7, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xabe8, 0xabe8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xabe9, 0xabea, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xabec, 0xabec, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0xabed, 0xabed, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xd7b0, 0xd7c6, GraphemeBreakProperty::V },
+        GraphemeRange{ 0xd7cb, 0xd7fb, GraphemeBreakProperty::T },
+        GraphemeRange{ 0xfb1e, 0xfb1e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xfe00, 0xfe0f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xfe20, 0xfe2f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xfeff, 0xfeff, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xff9e, 0xff9f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xfff0, 0xfffb, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x101fd, 0x101fd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x102e0, 0x102e0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10376, 0x1037a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10a01, 0x10a03, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10a05, 0x10a06, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10a0c, 0x10a0f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10a38, 0x10a3a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10a3f, 0x10a3f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10ae5, 0x10ae6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10d24, 0x10d27, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10eab, 0x10eac, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10efd, 0x10eff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10f46, 0x10f50, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x10f82, 0x10f85, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11000, 0x11000, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11001, 0x11001, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11002, 0x11002, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11038, 0x11046, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11070, 0x11070, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11073, 0x11074, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1107f, 0x11081, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11082, 0x11082, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x110b0, 0x110b2, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x110b3, 0x110b6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x110b7, 0x110b8, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x110b9, 0x110ba, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x110bd, 0x110bd, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x110c2, 0x110c2, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x110cd, 0x110cd, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11100, 0x11102, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11127, 0x1112b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1112c, 0x1112c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1112d, 0x11134, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11145, 0x11146, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11173, 0x11173, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11180, 0x11181, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11182, 0x11182, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x111b3, 0x111b5, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x111b6, 0x111be, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x111bf, 0x111c0, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x111c2, 0x111c3, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x111c9, 0x111cc, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x111ce, 0x111ce, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x111cf, 0x111cf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1122c, 0x1122e, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1122f, 0x11231, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11232, 0x11233, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11234, 0x11234, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11235, 0x11235, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11236, 0x11237, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1123e, 0x1123e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11241, 0x11241, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x112df, 0x112df, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x112e0, 0x112e2, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x112e3, 0x112ea, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11300, 0x11301, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11302, 0x11303, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1133b, 0x1133c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1133e, 0x1133e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1133f, 0x1133f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11340, 0x11340, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11341, 0x11344, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11347, 0x11348, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1134b, 0x1134d, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11357, 0x11357, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11362, 0x11363, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11366, 0x1136c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11370, 0x11374, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11435, 0x11437, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11438, 0x1143f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11440, 0x11441, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11442, 0x11444, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11445, 0x11445, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11446, 0x11446, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1145e, 0x1145e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114b0, 0x114b0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114b1, 0x114b2, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x114b3, 0x114b8, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114b9, 0x114b9, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x114ba, 0x114ba, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114bb, 0x114bc, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x114bd, 0x114bd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114be, 0x114be, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x114bf, 0x114c0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x114c1, 0x114c1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x114c2, 0x114c3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x115af, 0x115af, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x115b0, 0x115b1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x115b2, 0x115b5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x115b8, 0x115bb, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x115bc, 0x115bd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x115be, 0x115be, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x115bf, 0x115c0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x115dc, 0x115dd, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11630, 0x11632, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11633, 0x1163a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1163b, 0x1163c, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1163d, 0x1163d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1163e, 0x1163e, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1163f, 0x11640, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x116ab, 0x116ab, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x116ac, 0x116ac, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x116ad, 0x116ad, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x116ae, 0x116af, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x116b0, 0x116b5, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x116b6, 0x116b6, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x116b7, 0x116b7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1171d, 0x1171f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11722, 0x11725, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11726, 0x11726, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11727, 0x1172b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1182c, 0x1182e, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1182f, 0x11837, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11838, 0x11838, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11839, 0x1183a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11930, 0x11930, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11931, 0x11935, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11937, 0x11938, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1193b, 0x1193c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1193d, 0x1193d, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1193e, 0x1193e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1193f, 0x1193f, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11940, 0x11940, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11941, 0x11941, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11942, 0x11942, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11943, 0x11943, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x119d1, 0x119d3, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x119d4, 0x119d7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x119da, 0x119db, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x119dc, 0x119df, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x119e0, 0x119e0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x119e4, 0x119e4, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11a01, 0x11a0a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a33, 0x11a38, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a39, 0x11a39, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11a3a, 0x11a3a, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11a3b, 0x11a3e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a47, 0x11a47, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a51, 0x11a56, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a57, 0x11a58, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11a59, 0x11a5b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a84, 0x11a89, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11a8a, 0x11a96, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11a97, 0x11a97, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11a98, 0x11a99, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11c2f, 0x11c2f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11c30, 0x11c36, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11c38, 0x11c3d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11c3e, 0x11c3e, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11c3f, 0x11c3f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11c92, 0x11ca7, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11ca9, 0x11ca9, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11caa, 0x11cb0, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11cb1, 0x11cb1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11cb2, 0x11cb3, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11cb4, 0x11cb4, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11cb5, 0x11cb6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d31, 0x11d36, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d3a, 0x11d3a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d3c, 0x11d3d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d3f, 0x11d45, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d46, 0x11d46, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11d47, 0x11d47, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d8a, 0x11d8e, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11d90, 0x11d91, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d93, 0x11d94, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11d95, 0x11d95, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11d96, 0x11d96, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11d97, 0x11d97, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11ef3, 0x11ef4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11ef5, 0x11ef6, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11f00, 0x11f01, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11f02, 0x11f02, GraphemeBreakProperty::Prepend },
+        GraphemeRange{ 0x11f03, 0x11f03, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11f34, 0x11f35, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11f36, 0x11f3a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11f3e, 0x11f3f, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11f40, 0x11f40, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x11f41, 0x11f41, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x11f42, 0x11f42, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x13430, 0x1343f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x13440, 0x13440, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x13447, 0x13455, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16af0, 0x16af4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16b30, 0x16b36, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16f4f, 0x16f4f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16f51, 0x16f87, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x16f8f, 0x16f92, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16fe4, 0x16fe4, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x16ff0, 0x16ff1, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1bc9d, 0x1bc9e, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1bca0, 0x1bca3, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x1cf00, 0x1cf2d, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1cf30, 0x1cf46, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d165, 0x1d165, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d166, 0x1d166, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1d167, 0x1d169, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d16d, 0x1d16d, GraphemeBreakProperty::SpacingMark },
+        GraphemeRange{ 0x1d16e, 0x1d172, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d173, 0x1d17a, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0x1d17b, 0x1d182, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d185, 0x1d18b, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d1aa, 0x1d1ad, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1d242, 0x1d244, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1da00, 0x1da36, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1da3b, 0x1da6c, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1da75, 0x1da75, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1da84, 0x1da84, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1da9b, 0x1da9f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1daa1, 0x1daaf, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e000, 0x1e006, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e008, 0x1e018, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e01b, 0x1e021, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e023, 0x1e024, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e026, 0x1e02a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e08f, 0x1e08f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e130, 0x1e136, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e2ae, 0x1e2ae, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e2ec, 0x1e2ef, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e4ec, 0x1e4ef, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e8d0, 0x1e8d6, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1e944, 0x1e94a, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1f000, 0x1f0ff, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f10d, 0x1f10f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f12f, 0x1f12f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f16c, 0x1f171, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f17e, 0x1f17f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f18e, 0x1f18e, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f191, 0x1f19a, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f1ad, 0x1f1e5, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f1e6, 0x1f1ff, GraphemeBreakProperty::RegionalIndicator },
+        GraphemeRange{ 0x1f201, 0x1f20f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f21a, 0x1f21a, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f22f, 0x1f22f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f232, 0x1f23a, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f23c, 0x1f23f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f249, 0x1f3fa, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f3fb, 0x1f3ff, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0x1f400, 0x1f53d, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f546, 0x1f64f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f680, 0x1f6ff, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f774, 0x1f77f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f7d5, 0x1f7ff, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f80c, 0x1f80f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f848, 0x1f84f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f85a, 0x1f85f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f888, 0x1f88f, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f8ae, 0x1f8ff, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f90c, 0x1f93a, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f93c, 0x1f945, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1f947, 0x1faff, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0x1fc00, 0x1fffd, GraphemeBreakProperty::ExtendedPictographic },
+        GraphemeRange{ 0xe0000, 0xe001f, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xe0020, 0xe007f, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xe0080, 0xe00ff, GraphemeBreakProperty::Control },
+        GraphemeRange{ 0xe0100, 0xe01ef, GraphemeBreakProperty::Extend },
+        GraphemeRange{ 0xe01f0, 0xe0fff, GraphemeBreakProperty::Control },
+    };
+
+    // s_graphemeBreakTable is turned into a two-stage lookup table at compile time, the same way
+    // CodepointWidthDetector does it, except that stage2 stores the property of each codepoint as 4 bits.
+    constexpr unsigned int BlockShift = 8;
+    constexpr unsigned int BlockSize = 1u << BlockShift;
+    constexpr unsigned int BlockCount = 0x110000 >> BlockShift;
+    constexpr size_t UniformBlockCount = static_cast<size_t>(GraphemeBreakProperty::ExtendedPictographic) + 1;
+
+    using PropertyBlock = std::array<uint64_t, BlockSize * 4 / 64>;
+
+    // Returns a word of PropertyBlock with every codepoint set to the given property.
+    constexpr uint64_t propertyPattern(const GraphemeBreakProperty property) noexcept
+    {
+        return 0x1111111111111111 * static_cast<uint64_t>(property);
+    }
+
+    // Calls func(block, uniform, range) for each block that contains codepoints from s_graphemeBreakTable,
+    // where uniform is true if all the codepoints of the block share the property of s_graphemeBreakTable[range].
+    // range is the index of the first entry of s_graphemeBreakTable that overlaps with the block.
+    // Blocks that aren't visited are entirely Other.
+    template<typename T>
+    constexpr void classifyBlocks(T&& func)
+    {
+        size_t range = 0;
+        unsigned int block = 0;
+        while (block < BlockCount)
+        {
+            const auto lo = block << BlockShift;
+            const auto hi = lo + BlockSize - 1;
+
+            while (range < s_graphemeBreakTable.size() && s_graphemeBreakTable[range].upperBound < lo)
+            {
+                ++range;
+            }
+            if (range == s_graphemeBreakTable.size())
+            {
+                break;
+            }
+
+            const auto& r = s_graphemeBreakTable[range];
+            if (r.lowerBound > hi)
+            {
+                // Skip ahead to the block containing the next range.
+                block = r.lowerBound >> BlockShift;
+                continue;
+            }
+
+            func(block, r.lowerBound <= lo && r.upperBound >= hi, range);
+            ++block;
+        }
+    }
+
+    constexpr size_t countMixedBlocks()
+    {
+        size_t count = 0;
+        classifyBlocks([&](unsigned int, bool uniform, size_t) {
+            count += !uniform;
+        });
+        return count;
+    }
+
+    template<size_t Stage2Size>
+    struct PropertyTable
+    {
+        std::array<uint8_t, BlockCount> stage1{};
+        std::array<PropertyBlock, Stage2Size> stage2{};
+
+        constexpr GraphemeBreakProperty Lookup(const unsigned int codepoint) const noexcept
+        {
+            if (codepoint >= 0xAC00 && codepoint <= 0xD7A3)
+            {
+                return (codepoint - 0xAC00) % 28 ? GraphemeBreakProperty::LVT : GraphemeBreakProperty::LV;
+            }
+            if (codepoint >= BlockCount << BlockShift)
+            {
+                return GraphemeBreakProperty::Other;
+            }
+
+            const auto& block = til::at(stage2, til::at(stage1, codepoint >> BlockShift));
+            const auto index = codepoint & (BlockSize - 1);
+            return static_cast<GraphemeBreakProperty>((til::at(block, index / 16) >> (index % 16 * 4)) & 15);
+        }
+    };
+
+    constexpr auto buildPropertyTable()
+    {
+        constexpr auto stage2Size = UniformBlockCount + countMixedBlocks();
+        static_assert(stage2Size <= 256, "stage1 stores indices into stage2 as uint8_t");
+
+        PropertyTable<stage2Size> table;
+
+        // The uniform blocks are at the index of the property they represent.
+        for (size_t i = 1; i < UniformBlockCount; ++i)
+        {
+            for (auto& word : table.stage2[i])
+            {
+                word = propertyPattern(static_cast<GraphemeBreakProperty>(i));
+            }
+        }
+
+        auto next = UniformBlockCount;
+        classifyBlocks([&](unsigned int block, bool uniform, size_t range) {
+            if (uniform)
+            {
+                table.stage1[block] = static_cast<uint8_t>(s_graphemeBreakTable[range].property);
+                return;
+            }
+
+            table.stage1[block] = static_cast<uint8_t>(next);
+            auto& dst = table.stage2[next++];
+
+            const auto lo = block << BlockShift;
+            const auto hi = lo + BlockSize - 1;
+            for (; range < s_graphemeBreakTable.size() && s_graphemeBreakTable[range].lowerBound <= hi; ++range)
+            {
+                // Set the codepoints [beg, end] of the block, 16 per word.
+                const auto& r = s_graphemeBreakTable[range];
+                const auto beg = std::max(r.lowerBound, lo) - lo;
+                const auto end = std::min(r.upperBound, hi) - lo;
+                for (auto word = beg / 16; word <= end / 16; ++word)
+                {
+                    const auto first = std::max(beg, word * 16) % 16;
+                    const auto last = std::min(end, word * 16 + 15) % 16;
+                    const auto mask = (~uint64_t{ 0 } >> (60 - last * 4)) & (~uint64_t{ 0 } << (first * 4));
+                    dst[word] |= propertyPattern(r.property) & mask;
+                }
+            }
+        });
+
+        return table;
+    }
+
+    static constexpr auto s_propertyTable = buildPropertyTable();
+
+    // Checks the edges of every range in s_graphemeBreakTable,
+    // which is where a mistake in building s_propertyTable would show.
+    constexpr bool propertyTableMatchesRanges()
+    {
+        unsigned int previousUpperBound = 0;
+        for (const auto& r : s_graphemeBreakTable)
+        {
+            if (s_propertyTable.Lookup(r.lowerBound) != r.property || s_propertyTable.Lookup(r.upperBound) != r.property)
+            {
+                return false;
+            }
+            if (r.lowerBound > previousUpperBound + 1 && s_propertyTable.Lookup(r.lowerBound - 1) != GraphemeBreakProperty::Other)
+            {
+                return false;
+            }
+            previousUpperBound = r.upperBound;
+        }
+        return true;
+    }
+
+    static_assert(propertyTableMatchesRanges());
+
+    constexpr GraphemeBreakProperty lookupProperty(const std::wstring_view codepoint) noexcept
+    {
+        auto value = static_cast<unsigned int>(codepoint.front());
+        if (codepoint.size() == 2)
+        {
+            value = ((value & 0x3FF) << 10 | (codepoint.back() & 0x3FF)) + 0x10000;
+        }
+        return s_propertyTable.Lookup(value);
+    }
+
+    constexpr bool isControl(const GraphemeBreakProperty property) noexcept
+    {
+        return property == GraphemeBreakProperty::Control || property == GraphemeBreakProperty::CR || property == GraphemeBreakProperty::LF;
+    }
+
+    // Where we are in an emoji sequence, which GB11 needs to know.
+    enum class PictographicState
+    {
+        None,
+        Pictographic, // after Extended_Pictographic Extend*
+        Joiner, // after Extended_Pictographic Extend* ZWJ
+    };
+
+    // Returns whether there's no boundary between previous and current.
+    // regionalIndicators is the number of consecutive regional indicators up to and including previous.
+    constexpr bool continuesCluster(const GraphemeBreakProperty previous, const GraphemeBreakProperty current, const PictographicState state, const size_t regionalIndicators) noexcept
+    {
+        using P = GraphemeBreakProperty;
+
+        if (previous == P::CR && current == P::LF)
+        {
+            return true; // GB3
+        }
+        if (isControl(previous) || isControl(current))
+        {
+            return false; // GB4, GB5
+        }
+        if (previous == P::L && (current == P::L || current == P::V || current == P::LV || current == P::LVT))
+        {
+            return true; // GB6
+        }
+        if ((previous == P::LV || previous == P::V) && (current == P::V || current == P::T))
+        {
+            return true; // GB7
+        }
+        if ((previous == P::LVT || previous == P::T) && current == P::T)
+        {
+            return true; // GB8
+        }
+        if (current == P::Extend || current == P::ZWJ || current == P::SpacingMark || previous == P::Prepend)
+        {
+            return true; // GB9, GB9a, GB9b
+        }
+        if (current == P::ExtendedPictographic && state == PictographicState::Joiner)
+        {
+            return true; // GB11
+        }
+        if (previous == P::RegionalIndicator && current == P::RegionalIndicator)
+        {
+            return regionalIndicators % 2 == 1; // GB12, GB13
+        }
+        return false; // GB999
+    }
+
+    constexpr PictographicState nextPictographicState(const PictographicState state, const GraphemeBreakProperty current) noexcept
+    {
+        switch (current)
+        {
+        case GraphemeBreakProperty::ExtendedPictographic:
+            return PictographicState::Pictographic;
+        case GraphemeBreakProperty::Extend:
+            return state == PictographicState::Pictographic ? state : PictographicState::None;
+        case GraphemeBreakProperty::ZWJ:
+            return state == PictographicState::Pictographic ? PictographicState::Joiner : PictographicState::None;
+        default:
+            return PictographicState::None;
+        }
+    }
+}
+
+// Routine Description:
+// - Finds the extended grapheme cluster at the start of the given UTF-16 string, following
+//   the rules GB3 through GB13 of UAX #29 (https://www.unicode.org/reports/tr29/).
+// - Invalid surrogates are handled like Utf16Parser::ParseNext does and are never part of a cluster.
+// Arguments:
+// - wstr - The UTF-16 string to parse.
+// Return Value:
+// - A view into the string given of just the next cluster, at most MaxClusterSize long.
+std::wstring_view GraphemeBreak::ParseNextCluster(const std::wstring_view wstr) noexcept
+{
+    // ASCII characters only ever combine with ASCII characters as CR LF.
+    // This makes the common case of plain text skip the tables entirely.
+    if (wstr.size() >= 2 && wstr[0] < 0x80 && wstr[1] < 0x80)
+    {
+        return wstr.substr(0, wstr[0] == L'\r' && wstr[1] == L'\n' ? 2 : 1);
+    }
+
+    const auto first = Utf16Parser::ParseNext(wstr);
+    if (first.data() != wstr.data())
+    {
+        return first;
+    }
+
+    auto previous = lookupProperty(first);
+    auto state = nextPictographicState(PictographicState::None, previous);
+    size_t regionalIndicators = previous == GraphemeBreakProperty::RegionalIndicator;
+
+    auto end = first.size();
+    while (end < wstr.size())
+    {
+        const auto codepoint = Utf16Parser::ParseNext(wstr.substr(end));
+        if (codepoint.data() != wstr.data() + end || end + codepoint.size() > MaxClusterSize)
+        {
+            break;
+        }
+
+        const auto current = lookupProperty(codepoint);
+        if (!continuesCluster(previous, current, state, regionalIndicators))
+        {
+            break;
+        }
+
+        state = nextPictographicState(state, current);
+        regionalIndicators = current == GraphemeBreakProperty::RegionalIndicator ? regionalIndicators + 1 : 0;
+        previous = current;
+        end += codepoint.size();
+    }
+
+    return wstr.substr(0, end);
+}
@@ -42,6 +42,10 @@ namespace Microsoft::Console::Types
         virtual const til::point GetSelectionEnd() const noexcept = 0;
         virtual void ColorSelection(const til::point coordSelectionStart, const til::point coordSelectionEnd, const TextAttribute attr) = 0;
         virtual const bool IsUiaDataInitialized() const noexcept = 0;
+
+        // LockConsole() only protects readers. Use these around calls that modify the data.
+        virtual void LockConsoleForWriting() noexcept = 0;
+        virtual void UnlockConsoleForWriting() noexcept = 0;
     };
 
     // See docs/virtual-dtors.md for an explanation of why this is weird.
@@ -5,6 +5,7 @@
 #include "UiaTextRangeBase.hpp"
 #include "ScreenInfoUiaProviderBase.h"
 #include "../buffer/out/search.h"
+#include "../buffer/out/textBufferRowCursor.hpp"
 #include "UiaTracing.h"
 
 using namespace Microsoft::Console::Types;
@@ -823,17 +824,23 @@ try
         const auto height{ std::abs(inclusiveEnd.Y - _start.Y + 1) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
+    // Walk from _start up to (but not including) inclusiveEnd, row by row within viewportRange.
+    // The attribute is the same for an entire run, so it only needs to be verified once per run.
+    for (auto y = _start.Y; y <= inclusiveEnd.Y; ++y)
     {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
+        const auto beginColumn = y == _start.Y ? _start.X : viewportRange.Left();
+        const auto endColumn = y == inclusiveEnd.Y ? inclusiveEnd.X : viewportRange.RightExclusive();
+        for (TextBufferRowCursor cursor{ buffer.GetRowByOffset(y), beginColumn, endColumn }; cursor; cursor.NextRun())
         {
-            // The value of the specified attribute varies over the text range
-            // return UiaGetReservedMixedAttributeValue.
-            // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
-            pRetVal->vt = VT_UNKNOWN;
-            UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
-            return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
+            if (!_verifyAttr(attributeId, *pRetVal, cursor.TextAttr()).value())
+            {
+                // The value of the specified attribute varies over the text range
+                // return UiaGetReservedMixedAttributeValue.
+                // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
+                pRetVal->vt = VT_UNKNOWN;
+                UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
+                return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
+            }
         }
     }
 
@@ -986,6 +993,7 @@ CATCH_RETURN();
 std::wstring UiaTextRangeBase::_getTextValue(til::CoordType maxLength) const
 {
     std::wstring textData{};
+    const auto maxSize = maxLength >= 0 ? gsl::narrow_cast<size_t>(maxLength) : SIZE_MAX;
     if (!IsDegenerate())
     {
         const auto& buffer = _pData->GetTextBuffer();
@@ -1001,21 +1009,30 @@ std::wstring UiaTextRangeBase::_getTextValue(til::CoordType maxLength) const
         bufferSize.DecrementInBounds(inclusiveEnd, true);
 
         const auto textRects = buffer.GetTextRects(_start, inclusiveEnd, _blockRange, true);
-        const auto bufferData = buffer.GetText(true,
-                                               false,
-                                               textRects);
 
-        const size_t textDataSize = bufferData.text.size() * bufferSize.Width();
-        textData.reserve(textDataSize);
-        for (const auto& text : bufferData.text)
+        // Screen readers like to ask for the entire document with a small maxLength.
+        // Instead of rendering every row up front we render them in batches and stop
+        // as soon as we've got enough text. Each batch includes the first row of the
+        // next one, so that GetText() still terminates the batch's last row with CRLF.
+        textData.reserve(std::min(maxSize, textRects.size() * (gsl::narrow_cast<size_t>(bufferSize.Width()) + 2)));
+        for (size_t begin = 0; begin < textRects.size() && textData.size() < maxSize; begin += TextBatchRows)
         {
-            textData += text;
+            const auto end = std::min(begin + TextBatchRows, textRects.size());
+            const auto more = end < textRects.size();
+            const std::vector<til::inclusive_rect> batchRects{ textRects.begin() + begin, textRects.begin() + end + (more ? 1 : 0) };
+            const auto bufferData = buffer.GetText(true, false, batchRects, nullptr);
+
+            const auto count = bufferData.text.size() - (more ? 1 : 0);
+            for (size_t i = 0; i < count && textData.size() < maxSize; ++i)
+            {
+                textData += til::at(bufferData.text, i);
+            }
         }
     }
 
-    if (maxLength >= 0)
+    if (textData.size() > maxSize)
     {
-        textData.resize(maxLength);
+        textData.resize(maxSize);
     }
 
     return textData;
@@ -1182,9 +1199,9 @@ CATCH_RETURN();
 IFACEMETHODIMP UiaTextRangeBase::Select() noexcept
 try
 {
-    _pData->LockConsole();
+    _pData->LockConsoleForWriting();
     auto Unlock = wil::scope_exit([&]() noexcept {
-        _pData->UnlockConsole();
+        _pData->UnlockConsoleForWriting();
     });
     RETURN_HR_IF(E_FAIL, !_pData->IsUiaDataInitialized());
 
@@ -50,6 +50,9 @@ namespace Microsoft::Console::Types
         // The default word delimiter for UiaTextRanges
         static constexpr std::wstring_view DefaultWordDelimiter{ &UNICODE_SPACE, 1 };
 
+        // the number of rows _getTextValue() retrieves from the buffer at once
+        static constexpr size_t TextBatchRows = 64;
+
         // degenerate range
         virtual HRESULT RuntimeClassInitialize(_In_ IUiaData* pData,
                                                _In_ IRawElementProviderSimple* const pProvider,
@@ -15,6 +15,7 @@ Author:
 
 #include "convert.hpp"
 #include <functional>
+#include <til/hash.h>
 
 static_assert(sizeof(unsigned int) == sizeof(wchar_t) * 2,
               "UnicodeRange expects to be able to store a unicode codepoint in an unsigned int");
@@ -33,6 +34,7 @@ public:
     CodepointWidth GetWidth(const std::wstring_view glyph) const;
     bool IsWide(const std::wstring_view glyph) const;
     bool IsWide(const wchar_t wch) const noexcept;
+    size_t GetNarrowRunLength(const std::wstring_view text) const noexcept;
     void SetFallbackMethod(std::function<bool(const std::wstring_view)> pfnFallback);
     void NotifyFontChanged() const noexcept;
 
@@ -46,6 +48,7 @@ private:
     bool _checkFallbackViaCache(const std::wstring_view glyph) const;
     static unsigned int _extractCodepoint(const std::wstring_view glyph) noexcept;
 
-    mutable std::unordered_map<std::wstring, bool> _fallbackCache;
+    // Allows looking up glyphs in _fallbackCache without turning them into a std::wstring first.
+    mutable std::unordered_map<std::wstring, bool, til::transparent_string_hash<wchar_t>, std::equal_to<>> _fallbackCache;
     std::function<bool(std::wstring_view)> _pfnFallbackMethod;
 };
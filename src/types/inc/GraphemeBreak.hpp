@@ -0,0 +1,22 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- GraphemeBreak.hpp
+
+Abstract:
+- Splits UTF-16 text into extended grapheme clusters according to UAX #29,
+  so that a base character and everything combining with it can be stored in one cell.
+--*/
+
+#pragma once
+
+class GraphemeBreak final
+{
+public:
+    // Clusters longer than this are split, so that a flood of combining marks can't grow a row without bounds.
+    static constexpr size_t MaxClusterSize = 32;
+
+    static std::wstring_view ParseNextCluster(const std::wstring_view wstr) noexcept;
+};
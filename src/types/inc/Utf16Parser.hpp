@@ -14,6 +14,9 @@ Author(s):
 
 #pragma once
 
+#include <functional>
+#include <iterator>
+#include <string_view>
 #include <vector>
 
 class Utf16Parser final
@@ -43,4 +46,107 @@ public:
     {
         return wch >= 0xDC00 && wch <= 0xDFFF;
     }
+
+    // A range over the units of a string that ParseNext (or a function like it, for
+    // instance GraphemeBreak::ParseNextCluster) returns one after another. Unlike Parse(),
+    // walking it doesn't allocate. Just like Parse(), it drops invalid surrogates.
+    template<std::wstring_view (*Next)(std::wstring_view) noexcept>
+    class Range final
+    {
+    public:
+        class iterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::wstring_view;
+            using difference_type = ptrdiff_t;
+            using pointer = const std::wstring_view*;
+            using reference = const std::wstring_view&;
+
+            constexpr iterator() noexcept = default;
+
+            explicit iterator(const std::wstring_view wstr) noexcept :
+                _remaining{ wstr }
+            {
+                _advance();
+            }
+
+            reference operator*() const noexcept
+            {
+                return _current;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &_current;
+            }
+
+            iterator& operator++() noexcept
+            {
+                _advance();
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                auto tmp = *this;
+                _advance();
+                return tmp;
+            }
+
+            bool operator==(const iterator& other) const noexcept
+            {
+                return _current.data() == other._current.data();
+            }
+
+            bool operator!=(const iterator& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+            void _advance() noexcept
+            {
+                if (!_remaining.empty())
+                {
+                    const auto next = Next(_remaining);
+                    const auto beg = _remaining.data();
+                    const auto end = beg + _remaining.size();
+
+                    // Next() returns a replacement character that isn't part of the
+                    // string if there's nothing but invalid surrogates left.
+                    if (!std::less<>{}(next.data(), beg) && std::less<>{}(next.data(), end))
+                    {
+                        _current = next;
+                        _remaining = _remaining.substr(static_cast<size_t>(next.data() - beg) + next.size());
+                        return;
+                    }
+                }
+
+                _current = {};
+                _remaining = {};
+            }
+
+            std::wstring_view _remaining;
+            std::wstring_view _current;
+        };
+
+        explicit constexpr Range(const std::wstring_view wstr) noexcept :
+            _wstr{ wstr }
+        {
+        }
+
+        iterator begin() const noexcept
+        {
+            return iterator{ _wstr };
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        std::wstring_view _wstr;
+    };
 };
@@ -98,6 +98,8 @@ namespace Microsoft::Console::Utils
 
     bool IsElevated();
 
+    void SetThreadBackgroundMode(const HANDLE thread, const bool background) noexcept;
+
     // This function is only ever used by the ConPTY connection in
     // TerminalConnection. However, that library does not have a good system of
     // tests set up. Since this function has a plethora of edge cases that would
@@ -683,6 +683,29 @@ bool Utils::IsElevated()
     return isElevated;
 }
 
+// Function Description:
+// - Moves a thread in or out of the background. Background threads run at a
+//   lower priority and opt into EcoQoS ("efficiency mode"), which lets the OS
+//   schedule them on efficiency cores and at lower clock speeds. Foreground
+//   threads explicitly opt out of power throttling, so that the OS doesn't
+//   decide on its own that a terminal we're looking at is unimportant.
+// - This is only ever a hint, so failures don't get reported to the caller.
+// Arguments:
+// - thread: the thread to update, for instance GetCurrentThread()
+// - background: whether the thread should be moved into the background
+void Utils::SetThreadBackgroundMode(const HANDLE thread, const bool background) noexcept
+{
+    LOG_IF_WIN32_BOOL_FALSE(SetThreadPriority(thread, background ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_NORMAL));
+
+    THREAD_POWER_THROTTLING_STATE state{};
+    state.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+    state.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+    state.StateMask = background ? THREAD_POWER_THROTTLING_EXECUTION_SPEED : 0;
+    // Windows versions before 1709 don't know about ThreadPowerThrottling and fail
+    // with ERROR_INVALID_PARAMETER. That's expected and not worth logging.
+    std::ignore = SetThreadInformation(thread, ThreadPowerThrottling, &state, sizeof(state));
+}
+
 // Function Description:
 // - Promotes a starting directory provided to a WSL invocation to a commandline argument.
 //   This is necessary because WSL has some modicum of support for linux-side directories (!) which
@@ -93,21 +93,40 @@ static bool _HandleIsValid(HANDLE h) noexcept
     return (h != INVALID_HANDLE_VALUE) && (h != nullptr);
 }
 
-HRESULT _CreatePseudoConsole(const HANDLE hToken,
-                             const COORD size,
-                             const HANDLE hInput,
-                             const HANDLE hOutput,
-                             const DWORD dwFlags,
-                             _Inout_ PseudoConsole* pPty)
+// Function Description:
+// - Returns whether the console host we use understands --pooled. Outside of Windows we
+//   might've fallen back to an inbox conhost.exe (see _ConsoleHostPath), which may not.
+static bool _ConsoleHostSupportsPooling()
 {
-    if (pPty == nullptr)
-    {
-        return E_INVALIDARG;
-    }
-    if (size.X == 0 || size.Y == 0)
-    {
-        return E_INVALIDARG;
-    }
+#if defined(__INSIDE_WINDOWS)
+    return true;
+#else
+    static const auto supported = wcscmp(_ConsoleHostPath(), _InboxConsoleHostPath().get()) != 0;
+    return supported;
+#endif // __INSIDE_WINDOWS
+}
+
+// Function Description:
+// - Starts a console host for a pseudoconsole.
+// Arguments:
+// - hToken: The user to start the console host as, or INVALID_HANDLE_VALUE for the current one.
+// - size: The initial size of the pseudoconsole. Unused if pooled is true.
+// - hInput, hOutput: The (inheritable) pipes of the pseudoconsole. Unused if pooled is true.
+// - dwFlags: PSEUDOCONSOLE_* flags. Unused if pooled is true.
+// - pooled: If true, the console host waits for a PTY_SIGNAL_HANDOFF, which
+//   provides the pipes, size and flags, before it starts serving its client.
+// - pHost: Receives the signal pipe, the server handle and the console host process.
+// Return Value:
+// - S_OK if the console host was started.
+static HRESULT _StartConsoleHost(const HANDLE hToken,
+                                 const COORD size,
+                                 const HANDLE hInput,
+                                 const HANDLE hOutput,
+                                 const DWORD dwFlags,
+                                 const bool pooled,
+                                 _Out_ PooledConsoleHost* pHost)
+{
+    *pHost = {};
 
     wil::unique_handle serverHandle;
     RETURN_IF_NTSTATUS_FAILED(CreateServerHandle(serverHandle.addressof(), TRUE));
@@ -124,41 +143,57 @@ HRESULT _CreatePseudoConsole(const HANDLE hToken,
     RETURN_IF_WIN32_BOOL_FALSE(CreatePipe(signalPipeConhostSide.addressof(), signalPipeOurSide.addressof(), &sa, 0));
     RETURN_IF_WIN32_BOOL_FALSE(SetHandleInformation(signalPipeConhostSide.get(), HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT));
 
-    // GH4061: Ensure that the path to executable in the format is escaped so C:\Program.exe cannot collide with C:\Program Files
-    auto pwszFormat = L"\"%s\" --headless %s%s%s%s--width %hu --height %hu --signal 0x%x --server 0x%x";
     // This is plenty of space to hold the formatted string
     wchar_t cmd[MAX_PATH]{};
-    const BOOL bInheritCursor = (dwFlags & PSEUDOCONSOLE_INHERIT_CURSOR) == PSEUDOCONSOLE_INHERIT_CURSOR;
-    const BOOL bResizeQuirk = (dwFlags & PSEUDOCONSOLE_RESIZE_QUIRK) == PSEUDOCONSOLE_RESIZE_QUIRK;
-    const BOOL bWin32InputMode = (dwFlags & PSEUDOCONSOLE_WIN32_INPUT_MODE) == PSEUDOCONSOLE_WIN32_INPUT_MODE;
-    const BOOL bPassthroughMode = (dwFlags & PSEUDOCONSOLE_PASSTHROUGH_MODE) == PSEUDOCONSOLE_PASSTHROUGH_MODE;
-    swprintf_s(cmd,
-               MAX_PATH,
-               pwszFormat,
-               _ConsoleHostPath(),
-               bInheritCursor ? L"--inheritcursor " : L"",
-               bWin32InputMode ? L"--win32input " : L"",
-               bResizeQuirk ? L"--resizeQuirk " : L"",
-               bPassthroughMode ? L"--passthrough " : L"",
-               size.X,
-               size.Y,
-               signalPipeConhostSide.get(),
-               serverHandle.get());
+    if (pooled)
+    {
+        swprintf_s(cmd,
+                   MAX_PATH,
+                   L"\"%s\" --headless --pooled --signal 0x%x --server 0x%x",
+                   _ConsoleHostPath(),
+                   signalPipeConhostSide.get(),
+                   serverHandle.get());
+    }
+    else
+    {
+        // GH4061: Ensure that the path to executable in the format is escaped so C:\Program.exe cannot collide with C:\Program Files
+        auto pwszFormat = L"\"%s\" --headless %s%s%s%s--width %hu --height %hu --signal 0x%x --server 0x%x";
+        const BOOL bInheritCursor = (dwFlags & PSEUDOCONSOLE_INHERIT_CURSOR) == PSEUDOCONSOLE_INHERIT_CURSOR;
+        const BOOL bResizeQuirk = (dwFlags & PSEUDOCONSOLE_RESIZE_QUIRK) == PSEUDOCONSOLE_RESIZE_QUIRK;
+        const BOOL bWin32InputMode = (dwFlags & PSEUDOCONSOLE_WIN32_INPUT_MODE) == PSEUDOCONSOLE_WIN32_INPUT_MODE;
+        const BOOL bPassthroughMode = (dwFlags & PSEUDOCONSOLE_PASSTHROUGH_MODE) == PSEUDOCONSOLE_PASSTHROUGH_MODE;
+        swprintf_s(cmd,
+                   MAX_PATH,
+                   pwszFormat,
+                   _ConsoleHostPath(),
+                   bInheritCursor ? L"--inheritcursor " : L"",
+                   bWin32InputMode ? L"--win32input " : L"",
+                   bResizeQuirk ? L"--resizeQuirk " : L"",
+                   bPassthroughMode ? L"--passthrough " : L"",
+                   size.X,
+                   size.Y,
+                   signalPipeConhostSide.get(),
+                   serverHandle.get());
+    }
 
     STARTUPINFOEXW siEx{ 0 };
     siEx.StartupInfo.cb = sizeof(STARTUPINFOEXW);
-    siEx.StartupInfo.hStdInput = hInput;
-    siEx.StartupInfo.hStdOutput = hOutput;
-    siEx.StartupInfo.hStdError = hOutput;
-    siEx.StartupInfo.dwFlags |= STARTF_USESTDHANDLES;
 
     // Only pass the handles we actually want the conhost to know about to it:
-    const size_t INHERITED_HANDLES_COUNT = 4;
-    HANDLE inheritedHandles[INHERITED_HANDLES_COUNT];
-    inheritedHandles[0] = serverHandle.get();
-    inheritedHandles[1] = hInput;
-    inheritedHandles[2] = hOutput;
-    inheritedHandles[3] = signalPipeConhostSide.get();
+    HANDLE inheritedHandles[4];
+    size_t inheritedHandlesCount = 0;
+    inheritedHandles[inheritedHandlesCount++] = serverHandle.get();
+    if (!pooled)
+    {
+        siEx.StartupInfo.hStdInput = hInput;
+        siEx.StartupInfo.hStdOutput = hOutput;
+        siEx.StartupInfo.hStdError = hOutput;
+        siEx.StartupInfo.dwFlags |= STARTF_USESTDHANDLES;
+
+        inheritedHandles[inheritedHandlesCount++] = hInput;
+        inheritedHandles[inheritedHandlesCount++] = hOutput;
+    }
+    inheritedHandles[inheritedHandlesCount++] = signalPipeConhostSide.get();
 
     // Get the size of the attribute list. We need one attribute, the handle list.
     SIZE_T listSize = 0;
@@ -181,7 +216,7 @@ HRESULT _CreatePseudoConsole(const HANDLE hToken,
                                                          0,
                                                          PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
                                                          inheritedHandles,
-                                                         (INHERITED_HANDLES_COUNT * sizeof(HANDLE)),
+                                                         (inheritedHandlesCount * sizeof(HANDLE)),
                                                          nullptr,
                                                          nullptr));
     wil::unique_process_information pi;
@@ -226,17 +261,256 @@ HRESULT _CreatePseudoConsole(const HANDLE hToken,
         }
     }
 
-    // Move the process handle out of the PROCESS_INFORMATION into out Pseudoconsole
-    pPty->hConPtyProcess = pi.hProcess;
+    // Move the process handle out of the PROCESS_INFORMATION into the host
+    pHost->hProcess = pi.hProcess;
     pi.hProcess = nullptr;
+    pHost->hServer = serverHandle.release();
+    pHost->hSignal = signalPipeOurSide.release();
+
+    return S_OK;
+}
+
+// Function Description:
+// - Closes the handles of a console host that didn't make it into a PseudoConsole.
+//   Breaking the signal pipe makes the console host exit, which we make sure of.
+static void _CloseConsoleHost(_Inout_ PooledConsoleHost* pHost) noexcept
+{
+    if (_HandleIsValid(pHost->hSignal))
+    {
+        CloseHandle(pHost->hSignal);
+        pHost->hSignal = nullptr;
+    }
+    if (_HandleIsValid(pHost->hServer))
+    {
+        CloseHandle(pHost->hServer);
+        pHost->hServer = nullptr;
+    }
+    if (_HandleIsValid(pHost->hProcess))
+    {
+        TerminateProcess(pHost->hProcess, 0);
+        CloseHandle(pHost->hProcess);
+        pHost->hProcess = nullptr;
+    }
+}
+
+// The pool of console hosts that were started ahead of time, so that creating a pseudoconsole
+// doesn't have to wait for a new process to start. Its size is 0 unless someone opts in by
+// calling ConptySetPseudoConsolePoolSize. Whenever a host is taken from the pool, a thread
+// pool callback starts a new one in its place.
+static SRWLOCK _poolLock = SRWLOCK_INIT;
+static PooledConsoleHost _pool[PSEUDOCONSOLE_POOL_MAX];
+static DWORD _poolCount = 0; // the number of hosts in _pool
+static DWORD _poolSize = 0; // the number of hosts _pool should hold
+static bool _poolRefilling = false; // true while _RefillPseudoConsolePoolCallback is queued or running
+
+static void CALLBACK _RefillPseudoConsolePoolCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID /*context*/) noexcept
+{
+    for (;;)
+    {
+        {
+            auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+            if (_poolCount >= _poolSize)
+            {
+                _poolRefilling = false;
+                return;
+            }
+        }
+
+        PooledConsoleHost host{};
+        if (FAILED_LOG(_StartConsoleHost(INVALID_HANDLE_VALUE, {}, nullptr, nullptr, 0, true, &host)))
+        {
+            // We'll try again the next time a host is taken from the pool.
+            auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+            _poolRefilling = false;
+            return;
+        }
+
+        {
+            auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+            // The pool may have been shrunk while we started the host.
+            if (_poolCount < _poolSize)
+            {
+                _pool[_poolCount++] = host;
+                host = {};
+            }
+        }
+
+        _CloseConsoleHost(&host);
+    }
+}
+
+static void _RefillPseudoConsolePool() noexcept
+{
+    auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+    if (_poolRefilling || _poolCount >= _poolSize)
+    {
+        return;
+    }
+
+    _poolRefilling = TrySubmitThreadpoolCallback(&_RefillPseudoConsolePoolCallback, nullptr, nullptr) != FALSE;
+}
+
+// Function Description:
+// - Removes a console host from the pool, if there is one.
+// Arguments:
+// - pHost: Receives the console host.
+// Return Value:
+// - true if a console host was taken from the pool.
+static bool _TakePooledConsoleHost(_Out_ PooledConsoleHost* pHost) noexcept
+{
+    *pHost = {};
+
+    {
+        auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+        if (_poolCount == 0)
+        {
+            return false;
+        }
+
+        *pHost = _pool[--_poolCount];
+        _pool[_poolCount] = {};
+    }
+
+    _RefillPseudoConsolePool();
+    return true;
+}
+
+// Function Description:
+// - Gives a pooled console host the pipes, size and flags of a new pseudoconsole.
+//   This is the first message it receives over its signal pipe.
+// Arguments:
+// - pHost: A console host taken from the pool.
+// - size, hInput, hOutput, dwFlags: See _CreatePseudoConsole.
+// Return Value:
+// - S_OK if the console host received the handoff.
+static HRESULT _HandOffToPooledConsoleHost(_In_ const PooledConsoleHost* pHost,
+                                           const COORD size,
+                                           const HANDLE hInput,
+                                           const HANDLE hOutput,
+                                           const DWORD dwFlags)
+{
+    HANDLE remoteInput = nullptr;
+    HANDLE remoteOutput = nullptr;
+    // On failure the handles we duplicated into the console host are closed again.
+    auto closeRemoteHandles = wil::scope_exit([&]() noexcept {
+        if (remoteInput)
+        {
+            DuplicateHandle(pHost->hProcess, remoteInput, nullptr, nullptr, 0, FALSE, DUPLICATE_CLOSE_SOURCE);
+        }
+        if (remoteOutput)
+        {
+            DuplicateHandle(pHost->hProcess, remoteOutput, nullptr, nullptr, 0, FALSE, DUPLICATE_CLOSE_SOURCE);
+        }
+    });
+
+    if (_HandleIsValid(hInput))
+    {
+        RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), hInput, pHost->hProcess, &remoteInput, 0, FALSE, DUPLICATE_SAME_ACCESS));
+    }
+    if (_HandleIsValid(hOutput))
+    {
+        RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), hOutput, pHost->hProcess, &remoteOutput, 0, FALSE, DUPLICATE_SAME_ACCESS));
+    }
+
+#pragma pack(push, 1)
+    struct _signal
+    {
+        const unsigned short id;
+        const PTY_HANDOFF_DATA handoff;
+    } data{ PTY_SIGNAL_HANDOFF, { (unsigned short)size.X, (unsigned short)size.Y, dwFlags, HandleToULong(remoteInput), HandleToULong(remoteOutput) } };
+#pragma pack(pop)
+
+    RETURN_IF_WIN32_BOOL_FALSE(WriteFile(pHost->hSignal, &data, sizeof(data), nullptr, nullptr));
+
+    closeRemoteHandles.release();
+    return S_OK;
+}
+
+HRESULT _CreatePseudoConsole(const HANDLE hToken,
+                             const COORD size,
+                             const HANDLE hInput,
+                             const HANDLE hOutput,
+                             const DWORD dwFlags,
+                             _Inout_ PseudoConsole* pPty)
+{
+    if (pPty == nullptr)
+    {
+        return E_INVALIDARG;
+    }
+    if (size.X == 0 || size.Y == 0)
+    {
+        return E_INVALIDARG;
+    }
+
+    PooledConsoleHost host{};
+    auto closeHost = wil::scope_exit([&]() noexcept {
+        _CloseConsoleHost(&host);
+    });
+
+    // Pooled console hosts run as the current user and can't be used for another one.
+    auto pooled = !_HandleIsValid(hToken) && _TakePooledConsoleHost(&host);
+    if (pooled && FAILED_LOG(_HandOffToPooledConsoleHost(&host, size, hInput, hOutput, dwFlags)))
+    {
+        // The console host might have exited in the meantime. Start a new one instead.
+        _CloseConsoleHost(&host);
+        pooled = false;
+    }
+    if (!pooled)
+    {
+        RETURN_IF_FAILED(_StartConsoleHost(hToken, size, hInput, hOutput, dwFlags, false, &host));
+    }
 
     RETURN_IF_NTSTATUS_FAILED(CreateClientHandle(&pPty->hPtyReference,
-                                                 serverHandle.get(),
+                                                 host.hServer,
                                                  L"\\Reference",
                                                  FALSE));
 
-    pPty->hSignal = signalPipeOurSide.release();
+    // Move the process and signal handles into our Pseudoconsole. The server handle is closed.
+    pPty->hConPtyProcess = host.hProcess;
+    host.hProcess = nullptr;
+    pPty->hSignal = host.hSignal;
+    host.hSignal = nullptr;
+
+    return S_OK;
+}
+
+// Function Description:
+// - Sets the number of console hosts that are started ahead of time, so that
+//   creating a pseudoconsole can hand its pipes to one that's already running.
+// Arguments:
+// - count: The number of console hosts to keep ready, at most PSEUDOCONSOLE_POOL_MAX. 0 disables the pool.
+// Return Value:
+// - S_OK if the call succeeded, S_FALSE if the console host doesn't support
+//   pooling, else E_INVALIDARG if count is too large.
+HRESULT _SetPseudoConsolePoolSize(const DWORD count)
+{
+    if (count > PSEUDOCONSOLE_POOL_MAX)
+    {
+        return E_INVALIDARG;
+    }
+    if (count != 0 && !_ConsoleHostSupportsPooling())
+    {
+        return S_FALSE;
+    }
+
+    PooledConsoleHost excess[PSEUDOCONSOLE_POOL_MAX]{};
+    DWORD excessCount = 0;
+    {
+        auto lock = wil::AcquireSRWLockExclusive(&_poolLock);
+        _poolSize = count;
+        while (_poolCount > count)
+        {
+            excess[excessCount++] = _pool[--_poolCount];
+            _pool[_poolCount] = {};
+        }
+    }
 
+    for (DWORD i = 0; i < excessCount; ++i)
+    {
+        _CloseConsoleHost(&excess[i]);
+    }
+
+    _RefillPseudoConsolePool();
     return S_OK;
 }
 
@@ -584,4 +858,16 @@ extern "C" HRESULT WINAPI ConptyPackPseudoConsole(_In_ HANDLE hProcess,
     return S_OK;
 }
 
+// NOTE: This one is not defined in the Windows headers either.
+
+// Function Description:
+// Sets the number of console hosts that are kept running in the background,
+//      ready to be used by the next ConptyCreatePseudoConsole calls. This is
+//      opt-in, because every pooled console host is an idle process.
+//      Pseudoconsoles created for another user never use a pooled host.
+extern "C" HRESULT WINAPI ConptySetPseudoConsolePoolSize(_In_ DWORD count)
+{
+    return _SetPseudoConsolePoolSize(count);
+}
+
 #pragma warning(pop)
@@ -14,6 +14,17 @@ typedef struct _PseudoConsole
     HANDLE hConPtyProcess;
 } PseudoConsole;
 
+// A console host that was started ahead of time (see ConptySetPseudoConsolePoolSize)
+// and waits for _CreatePseudoConsole to hand it the pipes of a new pseudoconsole.
+typedef struct _PooledConsoleHost
+{
+    HANDLE hSignal;
+    HANDLE hServer;
+    HANDLE hProcess;
+} PooledConsoleHost;
+
+#define PSEUDOCONSOLE_POOL_MAX (4u)
+
 // Signals
 // These are not defined publicly, but are used for controlling the conpty via
 //      the signal pipe.
@@ -21,6 +32,20 @@ typedef struct _PseudoConsole
 #define PTY_SIGNAL_CLEAR_WINDOW (2u)
 #define PTY_SIGNAL_REPARENT_WINDOW (3u)
 #define PTY_SIGNAL_RESIZE_WINDOW (8u)
+// Only ever sent as the first message to a console host started with --pooled.
+// It's followed by a PTY_HANDOFF_DATA. Keep it in sync with ConsoleArguments::WaitForPoolHandoff.
+#define PTY_SIGNAL_HANDOFF (16u)
+
+#pragma pack(push, 1)
+typedef struct _PTY_HANDOFF_DATA
+{
+    unsigned short width;
+    unsigned short height;
+    DWORD flags; // PSEUDOCONSOLE_* flags
+    DWORD input; // handle values in the console host process
+    DWORD output;
+} PTY_HANDOFF_DATA;
+#pragma pack(pop)
 
 // CreatePseudoConsole Flags
 // The other flag (PSEUDOCONSOLE_INHERIT_CURSOR) is actually defined in consoleapi.h in the OS repo
@@ -43,6 +68,7 @@ HRESULT _ShowHidePseudoConsole(_In_ const PseudoConsole* const pPty, const bool
 HRESULT _ReparentPseudoConsole(_In_ const PseudoConsole* const pPty, _In_ const HWND newParent);
 void _ClosePseudoConsoleMembers(_In_ PseudoConsole* pPty);
 VOID _ClosePseudoConsole(_In_ PseudoConsole* pPty);
+HRESULT _SetPseudoConsolePoolSize(const DWORD count);
 
 HRESULT ConptyCreatePseudoConsoleAsUser(_In_ HANDLE hToken,
                                         _In_ COORD size,